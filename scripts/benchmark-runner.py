@@ -14,19 +14,40 @@
 # limitations under the License.
 
 import argparse
+import datetime
 import json
+import math
 import os
+import platform
+import re
+import socket
+import statistics
 import subprocess
 import sys
+import tempfile
 
 
 _FIND_BINARIES_CMD = "find %s -maxdepth 1 -type f -executable"
+_FIND_ALL_BINARIES_CMD = "find %s -type f -executable -name '*benchmark*'"
 _FIND_JSON_CMD = "find %s -maxdepth 1 -name '*.json' -type f"
-_BENCHMARK_CMD = "%s --bm_max_secs 10 --bm_max_trials 1000000"
+_BENCHMARK_CMD = "%s --bm_max_secs %d --bm_max_trials 1000000"
 _BENCHMARK_WITH_DUMP_CMD = _BENCHMARK_CMD + " --bm_json_verbose %s"
 
+# Benchmarks that need input data or external services and are skipped by
+# default when searching a whole build tree.
+_DEFAULT_EXCLUDES = [
+    "velox_tpch_benchmark",
+    "velox_tpcds_benchmark",
+    "velox_read_benchmark",
+    "velox_s3read_benchmark",
+]
+
 _OUTPUT_NUM_COLS = 100
 
+# Version of the dump format written by 'run'. Dumps without a version are
+# the plain folly --bm_json_verbose output of a single repetition.
+_DUMP_FORMAT_VERSION = 1
+
 
 # Cosmetic helper functions.
 def color_red(text) -> str:
@@ -65,34 +86,138 @@ def execute(cmd, print_stdout=False):
     return result
 
 
+def read_file(path):
+    try:
+        with open(path) as f:
+            return f.read()
+    except OSError:
+        return None
+
+
+def git_revision():
+    try:
+        revision = execute("git rev-parse HEAD 2>/dev/null")[0]
+        dirty = bool(execute("git status --porcelain --untracked-files=no"))
+        return revision, dirty
+    except (subprocess.SubprocessError, IndexError):
+        return None, None
+
+
+def machine_metadata():
+    """
+    Describes the machine and the source revision of a run, so that a
+    comparison can tell whether two runs are comparable.
+    """
+    cpu_model = platform.processor()
+    cpuinfo = read_file("/proc/cpuinfo") or ""
+    match = re.search(r"^model name\s*:\s*(.*)$", cpuinfo, re.MULTILINE)
+    if match:
+        cpu_model = match.group(1)
+
+    memory_bytes = None
+    match = re.search(r"^MemTotal:\s*(\d+) kB", read_file("/proc/meminfo") or "")
+    if match:
+        memory_bytes = int(match.group(1)) * 1024
+
+    governor = read_file("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor")
+    revision, dirty = git_revision()
+    return {
+        "hostname": socket.gethostname(),
+        "system": platform.system(),
+        "kernel": platform.release(),
+        "machine": platform.machine(),
+        "cpu_model": cpu_model,
+        "num_cpus": os.cpu_count(),
+        "memory_bytes": memory_bytes,
+        "cpu_governor": governor.strip() if governor else None,
+        "git_revision": revision,
+        "git_dirty": dirty,
+        "timestamp": datetime.datetime.now(datetime.timezone.utc).isoformat(),
+    }
+
+
+def find_binaries(args):
+    files = []
+    for path in args.path:
+        if args.recursive:
+            files += execute(_FIND_ALL_BINARIES_CMD % path)
+        else:
+            files += execute(_FIND_BINARIES_CMD % path)
+
+    excludes = args.exclude if args.exclude is not None else _DEFAULT_EXCLUDES
+    files = [f for f in files if os.path.basename(f) not in excludes]
+    if args.filter:
+        files = [f for f in files if re.search(args.filter, os.path.basename(f))]
+    return sorted(files)
+
+
+def run_repetitions(args, file_path):
+    """
+    Runs 'file_path' args.repetitions times. Returns a map from benchmark name
+    to the list of its times in nanoseconds per iteration, one per repetition.
+    """
+    results = {}
+    with tempfile.TemporaryDirectory() as temp_dir:
+        for repetition in range(args.repetitions):
+            json_file_name = os.path.join(temp_dir, "%d.json" % repetition)
+            cmd = _BENCHMARK_WITH_DUMP_CMD % (
+                file_path,
+                args.bm_max_secs,
+                json_file_name,
+            )
+            print("$ %s" % cmd)
+            execute(cmd, print_stdout=True)
+            with open(json_file_name) as f:
+                for row in json.load(f):
+                    # Folly benchmark exports line separators by mistake as an
+                    # entry on the json file.
+                    if row[1] == "-":
+                        continue
+                    name = get_benchmark_handle(file_path, row[1])
+                    results.setdefault(name, []).append(row[2])
+    return results
+
+
 def run(args):
-    files = execute(_FIND_BINARIES_CMD % args.path)
+    files = find_binaries(args)
 
     if not files:
-        print("No benchmark binaries found in path '%s'. Aborting..." % args.path)
+        print(
+            "No benchmark binaries found in path '%s'. Aborting..."
+            % ", ".join(args.path)
+        )
         return 1
 
     if args.dump_path:
         os.makedirs(args.dump_path, exist_ok=True)
+        metadata = machine_metadata()
     print("Benchmark-runner found %i benchmarks binaries to execute." % len(files))
 
     # Execute and dump results for each benchmark file.
     for file_path in files:
         file_name = os.path.basename(file_path)
 
-        if args.dump_path:
-            json_file_name = os.path.join(args.dump_path, "%s.json" % file_name)
-            print(
-                "Executing and dumping results for '%s' to '%s':"
-                % (file_name, json_file_name)
-            )
-            cmd = _BENCHMARK_WITH_DUMP_CMD % (file_path, json_file_name)
-        else:
+        if not args.dump_path:
             print("Executing '%s':" % file_name)
-            cmd = _BENCHMARK_CMD % file_path
+            cmd = _BENCHMARK_CMD % (file_path, args.bm_max_secs)
+            print("$ %s" % cmd)
+            execute(cmd, print_stdout=True)
+            print()
+            continue
 
-        print("$ %s" % cmd)
-        execute(cmd, print_stdout=True)
+        json_file_name = os.path.join(args.dump_path, "%s.json" % file_name)
+        print(
+            "Executing %d repetitions and dumping results for '%s' to '%s':"
+            % (args.repetitions, file_name, json_file_name)
+        )
+        dump = {
+            "version": _DUMP_FORMAT_VERSION,
+            "metadata": metadata,
+            "repetitions": args.repetitions,
+            "benchmarks": run_repetitions(args, file_path),
+        }
+        with open(json_file_name, "w") as f:
+            json.dump(dump, f, indent=2)
         print()
 
     return 0
@@ -115,24 +240,87 @@ def fmt_runtime(time_ns):
         return "{:.2f}ms".format(time_usec / 1000)
 
 
-def compare_file(args, target_data, baseline_data):
-    baseline_map = {}
-    for row in baseline_data:
-        baseline_map[get_benchmark_handle(row[0], row[1])] = row[2]
+def load_dump(path):
+    """
+    Reads a dump written by 'run' or by folly's --bm_json_verbose. Returns the
+    metadata, or None for folly dumps, and a map from benchmark name to the
+    list of its times in nanoseconds.
+    """
+    with open(path) as f:
+        data = json.load(f)
 
-    passes = []
-    faster = []
-    failures = []
+    if isinstance(data, dict):
+        return data.get("metadata"), data["benchmarks"]
 
-    for row in target_data:
+    results = {}
+    for row in data:
         # Folly benchmark exports line separators by mistake as an entry on
         # the json file.
         if row[1] == "-":
             continue
+        results.setdefault(get_benchmark_handle(row[0], row[1]), []).append(row[2])
+    return None, results
+
+
+def mann_whitney_p_value(first, second):
+    """
+    Returns the two-sided p-value of the Mann-Whitney U test of the samples
+    'first' and 'second', using the normal approximation with a correction
+    for ties. A small value means that the samples are unlikely to come from
+    the same distribution. The test makes no assumption on the shape of the
+    distribution, which suits benchmark times with their long tail of slow
+    runs.
+    """
+    n1 = len(first)
+    n2 = len(second)
+    values = sorted([(v, 0) for v in first] + [(v, 1) for v in second])
+
+    # Assigns the average rank to each group of ties.
+    rank_sum = 0.0
+    tie_correction = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j < len(values) and values[j][0] == values[i][0]:
+            j += 1
+        rank = (i + j + 1) / 2.0
+        rank_sum += rank * sum(1 for k in range(i, j) if values[k][1] == 0)
+        tie_correction += (j - i) ** 3 - (j - i)
+        i = j
+
+    u = rank_sum - n1 * (n1 + 1) / 2.0
+    n = n1 + n2
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_correction / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    z = (abs(u - n1 * n2 / 2.0) - 0.5) / math.sqrt(variance)
+    return min(1.0, math.erfc(max(z, 0.0) / math.sqrt(2)))
+
+
+def relative_deviation(samples):
+    """
+    Returns the median absolute deviation of 'samples' relative to their
+    median, a measure of the noise that is robust to outliers.
+    """
+    median = statistics.median(samples)
+    if len(samples) < 2 or median == 0:
+        return 0.0
+    return statistics.median([abs(s - median) for s in samples]) / median
+
+
+def compare_file(args, target_results, baseline_results):
+    passes = []
+    faster = []
+    failures = []
+
+    for benchmark_handle, target_samples in target_results.items():
+        if benchmark_handle not in baseline_results:
+            print("    %s: %s" % (color_yellow("? New"), benchmark_handle))
+            continue
 
-        benchmark_handle = get_benchmark_handle(row[0], row[1])
-        baseline_result = baseline_map[benchmark_handle]
-        target_result = row[2]
+        baseline_samples = baseline_results[benchmark_handle]
+        baseline_result = statistics.median(baseline_samples)
+        target_result = statistics.median(target_samples)
 
         if baseline_result == 0 or target_result == 0:
             delta = 0
@@ -141,7 +329,21 @@ def compare_file(args, target_data, baseline_data):
         else:
             delta = (1 - (baseline_result / target_result)) * -1
 
-        if abs(delta) > args.threshold:
+        # With repetitions on both sides, a change is only reported if it is
+        # also unlikely to be noise. Single runs fall back to the threshold.
+        significant = True
+        p_value = None
+        if (
+            len(baseline_samples) >= args.min_repetitions
+            and len(target_samples) >= args.min_repetitions
+        ):
+            p_value = mann_whitney_p_value(baseline_samples, target_samples)
+            significant = p_value < args.alpha
+
+        noise = max(
+            relative_deviation(baseline_samples), relative_deviation(target_samples)
+        )
+        if significant and abs(delta) > max(args.threshold, noise):
             if delta > 0:
                 status = color_green("✓ Pass")
                 passes.append(benchmark_handle)
@@ -156,6 +358,8 @@ def compare_file(args, target_data, baseline_data):
         suffix = "({} vs {}) {:+.2f}%".format(
             fmt_runtime(baseline_result), fmt_runtime(target_result), delta * 100
         )
+        if p_value is not None:
+            suffix += " ±{:.1f}% p={:.3f}".format(noise * 100, p_value)
 
         # Prefix length is 12 bytes (considering utf8 and invisible chars).
         spacing = " " * (_OUTPUT_NUM_COLS - (12 + len(benchmark_handle) + len(suffix)))
@@ -164,6 +368,19 @@ def compare_file(args, target_data, baseline_data):
     return passes, faster, failures
 
 
+def warn_if_not_comparable(baseline_metadata, target_metadata):
+    if not baseline_metadata or not target_metadata:
+        return
+    for key in ["cpu_model", "num_cpus", "memory_bytes", "cpu_governor"]:
+        if baseline_metadata.get(key) != target_metadata.get(key):
+            print(
+                color_yellow(
+                    "WARNING: baseline and target differ in %s: '%s' vs '%s'."
+                    % (key, baseline_metadata.get(key), target_metadata.get(key))
+                )
+            )
+
+
 def compare(args):
     print(
         "=> Starting comparison using {} ({}%) as threshold.".format(
@@ -195,13 +412,13 @@ def compare(args):
             continue
 
         # Open and read each file.
-        with open(target_path) as f:
-            target_data = json.load(f)
+        target_metadata, target_results = load_dump(target_path)
+        baseline_metadata, baseline_results = load_dump(baseline_map[file_name])
+        warn_if_not_comparable(baseline_metadata, target_metadata)
 
-        with open(baseline_map[file_name]) as f:
-            baseline_data = json.load(f)
-
-        passes, faster, failures = compare_file(args, target_data, baseline_data)
+        passes, faster, failures = compare_file(
+            args, target_results, baseline_results
+        )
         all_passes += passes
         all_faster += faster
         all_failures += failures
@@ -234,7 +451,42 @@ def parse_args():
 
     parser_run = subparsers.add_parser("run", help="Run benchmarks and dump results.")
     parser_run.add_argument(
-        "--path", required=True, help="Path containing the benchmark binaries."
+        "--path",
+        required=True,
+        action="append",
+        help="Path containing the benchmark binaries. May be repeated.",
+    )
+    parser_run.add_argument(
+        "--recursive",
+        action="store_true",
+        help="Search the paths recursively for executables named "
+        "'*benchmark*', e.g. to run all benchmarks of a build tree.",
+    )
+    parser_run.add_argument(
+        "--filter",
+        default=None,
+        help="Only run the binaries whose name matches this regular expression.",
+    )
+    parser_run.add_argument(
+        "--exclude",
+        action="append",
+        default=None,
+        help="Name of a binary to skip. May be repeated. By default skips "
+        "the benchmarks that need input data: %s." % ", ".join(_DEFAULT_EXCLUDES),
+    )
+    parser_run.add_argument(
+        "--repetitions",
+        type=int,
+        default=1,
+        help="Number of times each binary is run when dumping results. The "
+        "comparison uses the median and tests the significance of changes when "
+        "there are enough repetitions. Default 1.",
+    )
+    parser_run.add_argument(
+        "--bm-max-secs",
+        type=int,
+        default=10,
+        help="Maximum seconds spent on each benchmark. Default 10.",
     )
     parser_run.add_argument(
         "--dump-path",
@@ -266,6 +518,21 @@ def parse_args():
         "Variations larger than this threshold will be reported as failures. "
         "Default 0.2 (20%%).",
     )
+    parser_compare.add_argument(
+        "--alpha",
+        type=float,
+        default=0.05,
+        help="Significance level of the Mann-Whitney U test of the repetitions. "
+        "Variations with a larger p-value are considered noise. Default 0.05.",
+    )
+    parser_compare.add_argument(
+        "--min-repetitions",
+        type=int,
+        default=5,
+        help="Minimum number of repetitions on both sides for the significance "
+        "test. Benchmarks with fewer runs are compared on the threshold only. "
+        "Fewer than 5 cannot reach a p-value of 0.05. Default 5.",
+    )
     return parser.parse_args()
 
 
@@ -0,0 +1,491 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/connectors/tpcds/TpcdsConnector.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/Split.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/parse/TypeResolver.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+using facebook::velox::tpcds::Table;
+
+DEFINE_int32(scale_factor, 1, "TPC-DS scale factor of the generated data");
+DEFINE_int32(num_drivers, 4, "Number of drivers");
+DEFINE_int32(
+    num_splits,
+    16,
+    "Number of splits of each scanned table. The splits are generated in "
+    "parallel by the drivers of the scan");
+DEFINE_int32(
+    run_query_verbose,
+    -1,
+    "Run a given query and print execution statistics. The queries are 3, "
+    "7, 19, 42, 52, 55 and 98");
+DEFINE_bool(
+    include_custom_stats,
+    false,
+    "Include custom statistics along with execution statistics");
+DEFINE_bool(include_results, false, "Include results in the output");
+
+// Runs a subset of the TPC-DS queries over the store sales star schema, with
+// the data generated on the fly by the TPC-DS connector. The plans are the
+// ones of the queries with the joins in the order of the FROM clauses and
+// the fact table on the probe side. The connector does not push down
+// filters, so each scan is followed by a FilterNode.
+namespace {
+
+// The id PlanBuilder::tableScan(tpcds::Table...) uses.
+const std::string kTpcdsConnectorId = "test-tpcds";
+
+// The queries of the benchmark. These are the TPC-DS queries that read only
+// the store sales star schema, which is all the connector generates.
+const std::vector<int> kQueryIds = {3, 7, 19, 42, 52, 55, 98};
+
+struct TpcdsPlan {
+  core::PlanNodePtr plan;
+  // The TableScan nodes. Each gets --num_splits splits.
+  std::vector<core::PlanNodeId> scanNodeIds;
+};
+
+std::vector<std::string> concat(
+    std::vector<std::string> first,
+    const std::vector<std::string>& second) {
+  first.insert(first.end(), second.begin(), second.end());
+  return first;
+}
+
+class TpcdsQueryBuilder {
+ public:
+  explicit TpcdsQueryBuilder(size_t scaleFactor) : scaleFactor_(scaleFactor) {}
+
+  TpcdsPlan getQueryPlan(int queryId) {
+    planNodeIdGenerator_ = std::make_shared<PlanNodeIdGenerator>();
+    scanNodeIds_.clear();
+    core::PlanNodePtr plan;
+    switch (queryId) {
+      case 3:
+        plan = getQ3Plan();
+        break;
+      case 7:
+        plan = getQ7Plan();
+        break;
+      case 19:
+        plan = getQ19Plan();
+        break;
+      case 42:
+        plan = getQ42Plan();
+        break;
+      case 52:
+        plan = getQ52Plan();
+        break;
+      case 55:
+        plan = getQ55Plan();
+        break;
+      case 98:
+        plan = getQ98Plan();
+        break;
+      default:
+        VELOX_USER_FAIL(
+            "TPC-DS query {} is not in the benchmark. The queries are {}",
+            queryId,
+            folly::join(", ", kQueryIds));
+    }
+    return {std::move(plan), scanNodeIds_};
+  }
+
+ private:
+  // Returns a scan of 'columns' of 'table' followed by 'filter' if not empty.
+  PlanBuilder scan(
+      Table table,
+      std::vector<std::string> columns,
+      const std::string& filter = "") {
+    PlanBuilder builder(planNodeIdGenerator_);
+    builder.tableScan(table, std::move(columns), scaleFactor_);
+    scanNodeIds_.push_back(builder.planNode()->id());
+    if (!filter.empty()) {
+      builder.filter(filter);
+    }
+    return builder;
+  }
+
+  // Returns 'salesColumns' of the store sales of the dates that pass
+  // 'dateFilter' and of the items that pass 'itemFilter', with 'dateColumns'
+  // and 'itemColumns'. The filters may only reference these columns.
+  PlanBuilder salesOfDatesAndItems(
+      const std::vector<std::string>& salesColumns,
+      const std::string& dateFilter,
+      const std::vector<std::string>& dateColumns,
+      const std::string& itemFilter,
+      const std::vector<std::string>& itemColumns) {
+    auto dates = scan(
+                     Table::TBL_DATE_DIM,
+                     concat({"d_date_sk"}, dateColumns),
+                     dateFilter)
+                     .planNode();
+    auto items =
+        scan(Table::TBL_ITEM, concat({"i_item_sk"}, itemColumns), itemFilter)
+            .planNode();
+    auto builder = scan(
+        Table::TBL_STORE_SALES,
+        concat({"ss_sold_date_sk", "ss_item_sk"}, salesColumns));
+    builder
+        .hashJoin(
+            {"ss_sold_date_sk"},
+            {"d_date_sk"},
+            dates,
+            "",
+            concat(concat({"ss_item_sk"}, salesColumns), dateColumns))
+        .hashJoin(
+            {"ss_item_sk"},
+            {"i_item_sk"},
+            items,
+            "",
+            concat(concat(salesColumns, dateColumns), itemColumns));
+    return builder;
+  }
+
+  // Returns the sum of ss_ext_sales_price as ext_price by d_year and
+  // 'itemColumns' of the sales of the dates that pass 'dateFilter' and of the
+  // items that pass 'itemFilter', as in Q3, Q42, Q52 and Q55.
+  PlanBuilder salesByYearAndItem(
+      const std::string& itemFilter,
+      const std::vector<std::string>& itemColumns,
+      const std::string& dateFilter) {
+    auto builder = salesOfDatesAndItems(
+        {"ss_ext_sales_price"},
+        dateFilter,
+        {"d_year", "d_moy"},
+        itemFilter,
+        itemColumns);
+    builder
+        .partialAggregation(
+            concat({"d_year"}, itemColumns),
+            {"sum(ss_ext_sales_price) AS ext_price"})
+        .localPartition({})
+        .finalAggregation();
+    return builder;
+  }
+
+  core::PlanNodePtr getQ3Plan() {
+    return salesByYearAndItem(
+               "i_manufact_id = 128",
+               {"i_brand_id", "i_brand", "i_manufact_id"},
+               "d_moy = 11")
+        .project({"d_year", "i_brand_id", "i_brand", "ext_price"})
+        .topN({"d_year", "ext_price DESC", "i_brand_id"}, 100, false)
+        .planNode();
+  }
+
+  core::PlanNodePtr getQ7Plan() {
+    auto demographics = scan(
+                            Table::TBL_CUSTOMER_DEMOGRAPHICS,
+                            {"cd_demo_sk",
+                             "cd_gender",
+                             "cd_marital_status",
+                             "cd_education_status"},
+                            "cd_gender = 'M' AND cd_marital_status = 'S' "
+                            "AND cd_education_status = 'College'")
+                            .planNode();
+    auto promotions = scan(
+                          Table::TBL_PROMOTION,
+                          {"p_promo_sk", "p_channel_email", "p_channel_event"},
+                          "p_channel_email = 'N' OR p_channel_event = 'N'")
+                          .planNode();
+    const std::vector<std::string> measures = {
+        "ss_quantity", "ss_list_price", "ss_coupon_amt", "ss_sales_price"};
+    return salesOfDatesAndItems(
+               concat({"ss_cdemo_sk", "ss_promo_sk"}, measures),
+               "d_year = 2000",
+               {"d_year"},
+               "",
+               {"i_item_id"})
+        .hashJoin(
+            {"ss_cdemo_sk"},
+            {"cd_demo_sk"},
+            demographics,
+            "",
+            concat({"ss_promo_sk", "i_item_id"}, measures))
+        .hashJoin(
+            {"ss_promo_sk"},
+            {"p_promo_sk"},
+            promotions,
+            "",
+            concat({"i_item_id"}, measures))
+        .partialAggregation(
+            {"i_item_id"},
+            {"avg(ss_quantity) AS agg1",
+             "avg(ss_list_price) AS agg2",
+             "avg(ss_coupon_amt) AS agg3",
+             "avg(ss_sales_price) AS agg4"})
+        .localPartition({})
+        .finalAggregation()
+        .topN({"i_item_id"}, 100, false)
+        .planNode();
+  }
+
+  core::PlanNodePtr getQ19Plan() {
+    const std::vector<std::string> itemColumns = {
+        "i_brand_id", "i_brand", "i_manufact_id", "i_manufact"};
+    auto customers =
+        scan(Table::TBL_CUSTOMER, {"c_customer_sk", "c_current_addr_sk"})
+            .hashJoin(
+                {"c_current_addr_sk"},
+                {"ca_address_sk"},
+                scan(Table::TBL_CUSTOMER_ADDRESS, {"ca_address_sk", "ca_zip"})
+                    .planNode(),
+                "",
+                {"c_customer_sk", "ca_zip"})
+            .planNode();
+    auto stores = scan(Table::TBL_STORE, {"s_store_sk", "s_zip"}).planNode();
+    return salesOfDatesAndItems(
+               {"ss_customer_sk", "ss_store_sk", "ss_ext_sales_price"},
+               "d_moy = 11 AND d_year = 1998",
+               {"d_year", "d_moy"},
+               "i_manager_id = 8",
+               concat(itemColumns, {"i_manager_id"}))
+        .hashJoin(
+            {"ss_customer_sk"},
+            {"c_customer_sk"},
+            customers,
+            "",
+            concat(
+                {"ss_store_sk", "ss_ext_sales_price", "ca_zip"}, itemColumns))
+        .hashJoin(
+            {"ss_store_sk"},
+            {"s_store_sk"},
+            stores,
+            "substr(ca_zip, 1, 5) <> substr(s_zip, 1, 5)",
+            concat({"ss_ext_sales_price"}, itemColumns))
+        .partialAggregation(
+            itemColumns, {"sum(ss_ext_sales_price) AS ext_price"})
+        .localPartition({})
+        .finalAggregation()
+        .topN(
+            {"ext_price DESC",
+             "i_brand",
+             "i_brand_id",
+             "i_manufact_id",
+             "i_manufact"},
+            100,
+            false)
+        .planNode();
+  }
+
+  core::PlanNodePtr getQ42Plan() {
+    return salesByYearAndItem(
+               "i_manager_id = 1",
+               {"i_category_id", "i_category", "i_manager_id"},
+               "d_moy = 11 AND d_year = 2000")
+        .project({"d_year", "i_category_id", "i_category", "ext_price"})
+        .topN(
+            {"ext_price DESC", "d_year", "i_category_id", "i_category"},
+            100,
+            false)
+        .planNode();
+  }
+
+  core::PlanNodePtr getQ52Plan() {
+    return salesByYearAndItem(
+               "i_manager_id = 1",
+               {"i_brand_id", "i_brand", "i_manager_id"},
+               "d_moy = 11 AND d_year = 2000")
+        .project({"d_year", "i_brand_id", "i_brand", "ext_price"})
+        .topN({"d_year", "ext_price DESC", "i_brand_id"}, 100, false)
+        .planNode();
+  }
+
+  core::PlanNodePtr getQ55Plan() {
+    return salesByYearAndItem(
+               "i_manager_id = 28",
+               {"i_brand_id", "i_brand", "i_manager_id"},
+               "d_moy = 11 AND d_year = 1999")
+        .project({"i_brand_id", "i_brand", "ext_price"})
+        .topN({"ext_price DESC", "i_brand_id"}, 100, false)
+        .planNode();
+  }
+
+  core::PlanNodePtr getQ98Plan() {
+    const std::vector<std::string> itemColumns = {
+        "i_item_id", "i_item_desc", "i_category", "i_class", "i_current_price"};
+    // The final aggregation and the window are partitioned on i_class, which
+    // is a grouping key.
+    return salesOfDatesAndItems(
+               {"ss_ext_sales_price"},
+               "d_date BETWEEN '1999-02-22'::DATE AND '1999-03-24'::DATE",
+               {"d_date"},
+               "i_category IN ('Sports', 'Books', 'Home')",
+               itemColumns)
+        .partialAggregation(
+            itemColumns, {"sum(ss_ext_sales_price) AS itemrevenue"})
+        .localPartition({"i_class"})
+        .finalAggregation()
+        .window({"i_class"}, {}, {"sum(itemrevenue) AS classrevenue"})
+        .project(concat(
+            itemColumns,
+            {"itemrevenue",
+             "itemrevenue * 100.0 / classrevenue AS revenueratio"}))
+        .localPartition({})
+        .orderBy(
+            {"i_category",
+             "i_class",
+             "i_item_id",
+             "i_item_desc",
+             "revenueratio"},
+            false)
+        .planNode();
+  }
+
+  const size_t scaleFactor_;
+  std::shared_ptr<PlanNodeIdGenerator> planNodeIdGenerator_;
+  std::vector<core::PlanNodeId> scanNodeIds_;
+};
+
+void printResults(const std::vector<RowVectorPtr>& results) {
+  std::cout << "Results:" << std::endl;
+  bool printType = true;
+  for (const auto& vector : results) {
+    // Print RowType only once.
+    if (printType) {
+      std::cout << vector->type()->asRow().toString() << std::endl;
+      printType = false;
+    }
+    for (size_t i = 0; i < vector->size(); ++i) {
+      std::cout << vector->toString(i) << std::endl;
+    }
+  }
+}
+} // namespace
+
+class TpcdsBenchmark {
+ public:
+  void initialize() {
+    functions::prestosql::registerAllScalarFunctions();
+    parse::registerTypeResolver();
+    auto tpcdsConnector =
+        connector::getConnectorFactory(
+            connector::tpcds::TpcdsConnectorFactory::kTpcdsConnectorName)
+            ->newConnector(kTpcdsConnectorId, nullptr);
+    connector::registerConnector(tpcdsConnector);
+  }
+
+  std::pair<std::unique_ptr<TaskCursor>, std::vector<RowVectorPtr>> run(
+      const TpcdsPlan& tpcdsPlan) {
+    CursorParameters params;
+    params.maxDrivers = FLAGS_num_drivers;
+    params.planNode = tpcdsPlan.plan;
+    const size_t numSplits = FLAGS_num_splits;
+
+    bool noMoreSplits = false;
+    auto addSplits = [&](exec::Task* task) {
+      if (!noMoreSplits) {
+        for (const auto& scanNodeId : tpcdsPlan.scanNodeIds) {
+          for (size_t i = 0; i < numSplits; ++i) {
+            task->addSplit(
+                scanNodeId,
+                exec::Split(
+                    std::make_shared<connector::tpcds::TpcdsConnectorSplit>(
+                        kTpcdsConnectorId, numSplits, i)));
+          }
+          task->noMoreSplits(scanNodeId);
+        }
+      }
+      noMoreSplits = true;
+    };
+    return readCursor(params, addSplits);
+  }
+};
+
+TpcdsBenchmark benchmark;
+std::shared_ptr<TpcdsQueryBuilder> queryBuilder;
+
+BENCHMARK(q3) {
+  const auto planContext = queryBuilder->getQueryPlan(3);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q7) {
+  const auto planContext = queryBuilder->getQueryPlan(7);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q19) {
+  const auto planContext = queryBuilder->getQueryPlan(19);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q42) {
+  const auto planContext = queryBuilder->getQueryPlan(42);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q52) {
+  const auto planContext = queryBuilder->getQueryPlan(52);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q55) {
+  const auto planContext = queryBuilder->getQueryPlan(55);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q98) {
+  const auto planContext = queryBuilder->getQueryPlan(98);
+  benchmark.run(planContext);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, false);
+  benchmark.initialize();
+  queryBuilder = std::make_shared<TpcdsQueryBuilder>(FLAGS_scale_factor);
+  if (FLAGS_run_query_verbose == -1) {
+    folly::runBenchmarks();
+  } else {
+    const auto queryPlan = queryBuilder->getQueryPlan(FLAGS_run_query_verbose);
+    const auto [cursor, actualResults] = benchmark.run(queryPlan);
+    auto task = cursor->task();
+    VELOX_CHECK(waitForTaskCompletion(task.get()));
+    if (FLAGS_include_results) {
+      printResults(actualResults);
+      std::cout << std::endl;
+    }
+    const auto stats = task->taskStats();
+    std::cout << fmt::format(
+                     "Execution time: {}",
+                     succinctMillis(
+                         stats.executionEndTimeMs - stats.executionStartTimeMs))
+              << std::endl;
+    std::cout << fmt::format(
+                     "Splits total: {}, finished: {}",
+                     stats.numTotalSplits,
+                     stats.numFinishedSplits)
+              << std::endl;
+    std::cout << printPlanWithStats(
+                     *queryPlan.plan, stats, FLAGS_include_custom_stats)
+              << std::endl;
+  }
+}
@@ -15,12 +15,16 @@
  */
 
 #include <folly/Benchmark.h>
+#include <folly/String.h>
 #include <folly/init/Init.h>
+#include <folly/json.h>
 #include <gflags/gflags.h>
+#include <fstream>
 
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/core/QueryCtx.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/parquet/RegisterParquetReader.h"
 #include "velox/exec/PlanNodeStats.h"
@@ -72,9 +76,69 @@ void printResults(const std::vector<RowVectorPtr>& results) {
     }
   }
 }
+
+std::vector<std::string> splitList(const std::string& list) {
+  std::vector<std::string> items;
+  folly::split(',', list, items, true);
+  return items;
+}
+
+folly::dynamic toJson(const PlanNodeStats& stats, bool includeCustomStats) {
+  auto toInt = [](uint64_t value) { return static_cast<int64_t>(value); };
+  folly::dynamic json = folly::dynamic::object("inputRows", stats.inputRows)(
+      "inputBytes", toInt(stats.inputBytes))(
+      "rawInputRows", stats.rawInputRows)(
+      "rawInputBytes", toInt(stats.rawInputBytes))(
+      "outputRows", stats.outputRows)(
+      "outputBytes", toInt(stats.outputBytes))(
+      "cpuNanos", toInt(stats.cpuWallTiming.cpuNanos))(
+      "wallNanos", toInt(stats.cpuWallTiming.wallNanos))(
+      "blockedWallNanos", toInt(stats.blockedWallNanos))(
+      "peakMemoryBytes", toInt(stats.peakMemoryBytes))(
+      "allocatedBytes", toInt(stats.allocatedBytes))(
+      "numDrivers", stats.numDrivers)("numSplits", stats.numSplits);
+  if (!stats.perfEventCounts.empty()) {
+    const auto& counts = stats.perfEventCounts;
+    json["perfEventCounts"] = folly::dynamic::object(
+        "cycles", toInt(counts.cycles))(
+        "instructions", toInt(counts.instructions))(
+        "llcMisses", toInt(counts.llcMisses))(
+        "branchMisses", toInt(counts.branchMisses))(
+        "dtlbMisses", toInt(counts.dtlbMisses));
+  }
+  if (includeCustomStats) {
+    folly::dynamic customStats = folly::dynamic::object;
+    for (const auto& [name, metric] : stats.customStats) {
+      customStats[name] = folly::dynamic::object("sum", metric.sum)(
+          "count", metric.count)("min", metric.min)("max", metric.max);
+    }
+    json["customStats"] = std::move(customStats);
+  }
+  if (stats.isMultiOperatorNode()) {
+    folly::dynamic operators = folly::dynamic::object;
+    for (const auto& [name, operatorStats] : stats.operatorStats) {
+      operators[name] = toJson(*operatorStats, includeCustomStats);
+    }
+    json["operators"] = std::move(operators);
+  }
+  return json;
+}
+
+void addPlanNodeNames(
+    const core::PlanNode& node,
+    std::unordered_map<core::PlanNodeId, std::string>& names) {
+  names[node.id()] = std::string(node.name());
+  for (const auto& source : node.sources()) {
+    addPlanNodeNames(*source, names);
+  }
+}
 } // namespace
 
-DEFINE_string(data_path, "", "Root path of TPC-H data");
+DEFINE_string(
+    data_path,
+    "",
+    "Root path of TPC-H data. With --json_output, a comma separated list of "
+    "roots, e.g. one per scale factor");
 DEFINE_int32(
     run_query_verbose,
     -1,
@@ -87,6 +151,28 @@ DEFINE_bool(include_results, false, "Include results in the output");
 DEFINE_int32(num_drivers, 4, "Number of drivers");
 DEFINE_string(data_format, "parquet", "Data format");
 DEFINE_int32(num_splits_per_file, 10, "Number of splits per file");
+DEFINE_string(
+    json_output,
+    "",
+    "If set, runs --queries on each of --data_path with each of "
+    "--num_drivers_sweep and writes the timings and the plan node statistics "
+    "of every run to this file as JSON");
+DEFINE_string(
+    queries,
+    "",
+    "Comma separated TPC-H query numbers to run with --json_output. All 22 "
+    "queries by default");
+DEFINE_string(
+    num_drivers_sweep,
+    "",
+    "Comma separated numbers of drivers to run with --json_output. "
+    "--num_drivers by default");
+DEFINE_int32(num_repeats, 3, "Number of runs of each query with --json_output");
+DEFINE_bool(
+    perf_events,
+    false,
+    "Count the hardware events of each operator with perf_event_open() and "
+    "include them in the execution statistics");
 
 DEFINE_validator(data_path, &notEmpty);
 DEFINE_validator(data_format, &validateDataFormat);
@@ -107,10 +193,17 @@ class TpchBenchmark {
   }
 
   std::pair<std::unique_ptr<TaskCursor>, std::vector<RowVectorPtr>> run(
-      const TpchPlan& tpchPlan) {
+      const TpchPlan& tpchPlan,
+      int32_t numDrivers = FLAGS_num_drivers) {
     CursorParameters params;
-    params.maxDrivers = FLAGS_num_drivers;
+    params.maxDrivers = numDrivers;
     params.planNode = tpchPlan.plan;
+    if (FLAGS_perf_events) {
+      params.queryCtx = core::QueryCtx::createForTest(
+          std::make_shared<core::MemConfig>(
+              std::unordered_map<std::string, std::string>{
+                  {core::QueryConfig::kPerfEventsEnabled, "true"}}));
+    }
     const int numSplitsPerFile = FLAGS_num_splits_per_file;
 
     bool noMoreSplits = false;
@@ -131,6 +224,82 @@ class TpchBenchmark {
     };
     return readCursor(params, addSplits);
   }
+
+  // Returns the JSON of one run of 'queryId' with 'numDrivers'.
+  folly::dynamic runToJson(
+      const TpchQueryBuilder& queryBuilder,
+      int queryId,
+      int32_t numDrivers) {
+    const auto queryPlan = queryBuilder.getQueryPlan(queryId);
+    const auto [cursor, results] = run(queryPlan, numDrivers);
+    auto task = cursor->task();
+    ensureTaskCompletion(task.get());
+    const auto stats = task->taskStats();
+
+    std::unordered_map<core::PlanNodeId, std::string> names;
+    addPlanNodeNames(*queryPlan.plan, names);
+    folly::dynamic planNodes = folly::dynamic::array;
+    for (const auto& [id, planStats] : toPlanStats(stats)) {
+      auto json = toJson(planStats, FLAGS_include_custom_stats);
+      json["id"] = id;
+      json["name"] = names[id];
+      planNodes.push_back(std::move(json));
+    }
+    vector_size_t numRows = 0;
+    for (const auto& vector : results) {
+      numRows += vector->size();
+    }
+    return folly::dynamic::object("query", queryId)("numDrivers", numDrivers)(
+        "executionMillis",
+        static_cast<int64_t>(
+            stats.executionEndTimeMs - stats.executionStartTimeMs))(
+        "numSplits", stats.numTotalSplits)("numResultRows", numRows)(
+        "planNodes", std::move(planNodes));
+  }
+
+  // Runs the queries and driver counts of the flags on each data path and
+  // writes the results to --json_output.
+  void runToJsonFile() {
+    std::vector<int> queryIds;
+    for (const auto& query : splitList(FLAGS_queries)) {
+      queryIds.push_back(folly::to<int>(query));
+    }
+    if (queryIds.empty()) {
+      for (auto i = 1; i <= 22; ++i) {
+        queryIds.push_back(i);
+      }
+    }
+    std::vector<int32_t> driverCounts;
+    for (const auto& count : splitList(FLAGS_num_drivers_sweep)) {
+      driverCounts.push_back(folly::to<int32_t>(count));
+    }
+    if (driverCounts.empty()) {
+      driverCounts.push_back(FLAGS_num_drivers);
+    }
+
+    folly::dynamic dataSets = folly::dynamic::array;
+    for (const auto& dataPath : splitList(FLAGS_data_path)) {
+      TpchQueryBuilder queryBuilder(toFileFormat(FLAGS_data_format));
+      queryBuilder.initialize(dataPath);
+      folly::dynamic runs = folly::dynamic::array;
+      for (auto queryId : queryIds) {
+        for (auto numDrivers : driverCounts) {
+          for (auto i = 0; i < FLAGS_num_repeats; ++i) {
+            runs.push_back(runToJson(queryBuilder, queryId, numDrivers));
+          }
+        }
+      }
+      dataSets.push_back(folly::dynamic::object("dataPath", dataPath)(
+          "runs", std::move(runs)));
+    }
+    folly::dynamic json = folly::dynamic::object(
+        "dataFormat", FLAGS_data_format)(
+        "numSplitsPerFile", FLAGS_num_splits_per_file)(
+        "dataSets", std::move(dataSets));
+    std::ofstream out(FLAGS_json_output);
+    out << folly::toPrettyJson(json) << std::endl;
+    VELOX_CHECK(out.good(), "Failed to write {}", FLAGS_json_output);
+  }
 };
 
 TpchBenchmark benchmark;
@@ -141,11 +310,21 @@ BENCHMARK(q1) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q2) {
+  const auto planContext = queryBuilder->getQueryPlan(2);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q3) {
   const auto planContext = queryBuilder->getQueryPlan(3);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q4) {
+  const auto planContext = queryBuilder->getQueryPlan(4);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q5) {
   const auto planContext = queryBuilder->getQueryPlan(5);
   benchmark.run(planContext);
@@ -156,24 +335,93 @@ BENCHMARK(q6) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q7) {
+  const auto planContext = queryBuilder->getQueryPlan(7);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q8) {
+  const auto planContext = queryBuilder->getQueryPlan(8);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q9) {
+  const auto planContext = queryBuilder->getQueryPlan(9);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q10) {
   const auto planContext = queryBuilder->getQueryPlan(10);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q11) {
+  const auto planContext = queryBuilder->getQueryPlan(11);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q12) {
+  const auto planContext = queryBuilder->getQueryPlan(12);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q13) {
   const auto planContext = queryBuilder->getQueryPlan(13);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q14) {
+  const auto planContext = queryBuilder->getQueryPlan(14);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q15) {
+  const auto planContext = queryBuilder->getQueryPlan(15);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q16) {
+  const auto planContext = queryBuilder->getQueryPlan(16);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q17) {
+  const auto planContext = queryBuilder->getQueryPlan(17);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q18) {
   const auto planContext = queryBuilder->getQueryPlan(18);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q19) {
+  const auto planContext = queryBuilder->getQueryPlan(19);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q20) {
+  const auto planContext = queryBuilder->getQueryPlan(20);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q21) {
+  const auto planContext = queryBuilder->getQueryPlan(21);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q22) {
+  const auto planContext = queryBuilder->getQueryPlan(22);
+  benchmark.run(planContext);
+}
+
 int main(int argc, char** argv) {
   folly::init(&argc, &argv, false);
   benchmark.initialize();
+  if (!FLAGS_json_output.empty()) {
+    benchmark.runToJsonFile();
+    return 0;
+  }
   queryBuilder =
       std::make_shared<TpchQueryBuilder>(toFileFormat(FLAGS_data_format));
   queryBuilder->initialize(FLAGS_data_path);
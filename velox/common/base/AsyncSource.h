@@ -22,6 +22,7 @@
 #include <functional>
 #include <memory>
 
+#include "velox/common/base/Exceptions.h"
 #include "velox/common/future/VeloxPromise.h"
 
 namespace facebook::velox {
@@ -95,6 +96,28 @@ class AsyncSource {
     return std::move(item_);
   }
 
+  // Drops the item or the function to make it and waits for a make in
+  // progress on the executor to finish. Called before destroying the state
+  // that making the item refers to. Must not run concurrently with move().
+  void close() {
+    ContinueFuture wait;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      make_ = nullptr;
+      if (!making_) {
+        item_ = nullptr;
+        return;
+      }
+      VELOX_CHECK_NULL(promise_);
+      promise_ = std::make_unique<ContinuePromise>();
+      wait = promise_->getSemiFuture();
+    }
+    auto& exec = folly::QueuedImmediateExecutor::instance();
+    std::move(wait).via(&exec).wait();
+    std::lock_guard<std::mutex> l(mutex_);
+    item_ = nullptr;
+  }
+
   // If true, move() will not block. But there is no guarantee that somebody
   // else will not get the item first.
   bool hasValue() const {
@@ -34,6 +34,11 @@ namespace facebook::velox {
 template <bool hashInput = true>
 class BloomFilter {
  public:
+  BloomFilter() = default;
+
+  // Makes a filter with the 'bits()' of another.
+  explicit BloomFilter(std::vector<uint64_t> bits) : bits_(std::move(bits)) {}
+
   // Prepares 'this' for use with an expected 'capacity'
   // entries. Drops any prior content.
   void reset(int32_t capacity) {
@@ -56,6 +61,10 @@ class BloomFilter {
         hashInput ? folly::hasher<uint64_t>()(value) : value);
   }
 
+  const std::vector<uint64_t>& bits() const {
+    return bits_;
+  }
+
  private:
   // We use 4 independent hash functions by taking 24 bits of
   // the hash code and breaking these up into 4 groups of 6 bits. Each group
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace facebook::velox {
+
+// Sort kernels for fixed width values, e.g. the elements of an array or a
+// single fixed width sort key. Large ranges are sorted with an LSD radix
+// sort over the bytes of an unsigned image of the values that has the
+// same order as the values. Small ranges use std::sort, which is faster
+// when the counting passes of the radix sort do not pay off.
+
+// Number of values from which sortFixedWidth() uses a radix sort.
+constexpr int32_t kMinRadixSortSize = 256;
+
+// Returns an unsigned integer that orders like 'value'. Negative floating
+// point values order before -0.0, which orders before 0.0. NaN has no
+// place in this order, see sortFixedWidth().
+template <typename T>
+inline auto radixSortKey(T value) {
+  static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+  if constexpr (std::is_floating_point_v<T>) {
+    using U = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+    constexpr U kSign = U(1) << (sizeof(U) * 8 - 1);
+    U bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // Flips all bits of negative values and the sign of positive ones.
+    return (bits & kSign) ? static_cast<U>(~bits)
+                          : static_cast<U>(bits | kSign);
+  } else {
+    using U = std::make_unsigned_t<T>;
+    constexpr U kSign = std::is_signed_v<T> ? U(1) << (sizeof(U) * 8 - 1) : 0;
+    return static_cast<U>(static_cast<U>(value) ^ kSign);
+  }
+}
+
+// Sorts [begin, end) in ascending order of 'key(item)', which returns an
+// unsigned integer. The sort is stable. Makes one pass over the items to
+// count all digits and one pass per byte of the key, skipping the bytes in
+// which all keys are the same. 'scratch' is resized to the number of
+// items and can be reused between calls.
+template <typename Item, typename KeyFunc>
+void radixSortBy(
+    Item* begin,
+    Item* end,
+    KeyFunc key,
+    std::vector<Item>& scratch) {
+  using Key = decltype(key(*begin));
+  static_assert(std::is_unsigned_v<Key>);
+  constexpr int32_t kNumDigits = sizeof(Key);
+  const auto numItems = end - begin;
+  if (numItems < 2) {
+    return;
+  }
+  std::array<std::array<uint32_t, 256>, kNumDigits> counts{};
+  for (auto i = 0; i < numItems; ++i) {
+    const auto itemKey = key(begin[i]);
+    for (auto digit = 0; digit < kNumDigits; ++digit) {
+      ++counts[digit][(itemKey >> (digit * 8)) & 0xff];
+    }
+  }
+  scratch.resize(numItems);
+  Item* from = begin;
+  Item* to = scratch.data();
+  const auto firstKey = key(*begin);
+  for (auto digit = 0; digit < kNumDigits; ++digit) {
+    auto& count = counts[digit];
+    const auto shift = digit * 8;
+    if (count[(firstKey >> shift) & 0xff] == numItems) {
+      continue;
+    }
+    uint32_t offset = 0;
+    for (auto& bucket : count) {
+      const auto bucketSize = bucket;
+      bucket = offset;
+      offset += bucketSize;
+    }
+    for (auto i = 0; i < numItems; ++i) {
+      to[count[(key(from[i]) >> shift) & 0xff]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != begin) {
+    std::copy(from, from + numItems, begin);
+  }
+}
+
+// Sorts the fixed width values in [begin, end). NaNs are larger than all
+// other values, as in Presto and Spark. Picks a radix sort or std::sort by
+// the number of values. 'scratch' is as in radixSortBy().
+template <typename T>
+void sortFixedWidth(T* begin, T* end, bool ascending, std::vector<T>& scratch) {
+  auto sortEnd = end;
+  if constexpr (std::is_floating_point_v<T>) {
+    sortEnd =
+        std::partition(begin, end, [](T value) { return !std::isnan(value); });
+  }
+  if (sortEnd - begin < kMinRadixSortSize) {
+    std::sort(begin, sortEnd);
+  } else {
+    radixSortBy(
+        begin, sortEnd, [](T value) { return radixSortKey(value); }, scratch);
+  }
+  if (!ascending) {
+    std::reverse(begin, end);
+  }
+}
+
+} // namespace facebook::velox
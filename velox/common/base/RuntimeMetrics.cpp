@@ -18,13 +18,77 @@
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SuccinctPrinter.h"
 
+#include <cmath>
+
 namespace facebook::velox {
 
+// static
+int32_t RuntimeHistogram::bucketIndex(int64_t value) {
+  if (value < 2 * kSubBuckets) {
+    return std::max<int64_t>(0, value);
+  }
+  // The position of the highest bit, at least kSubBucketBits + 1.
+  const int32_t exponent = 63 - __builtin_clzll(value);
+  const int32_t subBucket =
+      (value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+  return (exponent - kSubBucketBits + 1) * kSubBuckets + subBucket;
+}
+
+// static
+int64_t RuntimeHistogram::bucketUpperBound(int32_t index) {
+  if (index < 2 * kSubBuckets) {
+    return index;
+  }
+  const int32_t exponent = index / kSubBuckets + kSubBucketBits - 1;
+  const int64_t subBucket = index % kSubBuckets;
+  const int32_t shift = exponent - kSubBucketBits;
+  const int64_t lowerBound = (kSubBuckets + subBucket) << shift;
+  return lowerBound + ((1LL << shift) - 1);
+}
+
+void RuntimeHistogram::add(int64_t value) {
+  const auto index = bucketIndex(value);
+  if (index >= buckets_.size()) {
+    buckets_.resize(index + 1);
+  }
+  ++buckets_[index];
+  ++count_;
+}
+
+void RuntimeHistogram::merge(const RuntimeHistogram& other) {
+  if (other.buckets_.size() > buckets_.size()) {
+    buckets_.resize(other.buckets_.size());
+  }
+  for (auto i = 0; i < other.buckets_.size(); ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+}
+
+int64_t RuntimeHistogram::quantile(double quantile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  // The rank of the quantile, rounded up and at least 1.
+  const auto rank = std::max<int64_t>(1, std::ceil(count_ * quantile));
+  int64_t seen = 0;
+  for (auto i = 0; i < buckets_.size(); ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return bucketUpperBound(i);
+    }
+  }
+  return bucketUpperBound(buckets_.size() - 1);
+}
+
 void RuntimeMetric::addValue(int64_t value) {
   sum += value;
   count++;
   min = std::min(min, value);
   max = std::max(max, value);
+  if (histogram) {
+    histogram->add(value);
+  }
 }
 
 void RuntimeMetric::merge(const RuntimeMetric& other) {
@@ -33,6 +97,12 @@ void RuntimeMetric::merge(const RuntimeMetric& other) {
   count += other.count;
   min = std::min(min, other.min);
   max = std::max(max, other.max);
+  if (other.histogram) {
+    if (!histogram) {
+      histogram.emplace();
+    }
+    histogram->merge(*other.histogram);
+  }
 }
 
 void RuntimeMetric::printMetric(std::stringstream& stream) const {
@@ -52,5 +122,28 @@ void RuntimeMetric::printMetric(std::stringstream& stream) const {
       stream << " sum: " << sum << ", count: " << count << ", min: " << min
              << ", max: " << max;
   }
+  if (histogram && histogram->count() > 0) {
+    // A bucket bound may exceed the largest value.
+    auto percentile = [&](double quantile) {
+      return std::min(max, histogram->quantile(quantile));
+    };
+    auto print = [&](const char* name, int64_t value) {
+      stream << ", " << name << ": ";
+      switch (unit) {
+        case RuntimeCounter::Unit::kNanos:
+          stream << succinctNanos(value);
+          break;
+        case RuntimeCounter::Unit::kBytes:
+          stream << succinctBytes(value);
+          break;
+        case RuntimeCounter::Unit::kNone:
+        default:
+          stream << value;
+      }
+    };
+    print("p50", percentile(0.5));
+    print("p99", percentile(0.99));
+    print("p999", percentile(0.999));
+  }
 }
 } // namespace facebook::velox
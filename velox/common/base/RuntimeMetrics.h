@@ -16,8 +16,11 @@
 
 #pragma once
 
+#include <cstdint>
 #include <limits>
+#include <optional>
 #include <sstream>
+#include <vector>
 
 namespace facebook::velox {
 
@@ -25,9 +28,49 @@ struct RuntimeCounter {
   enum class Unit { kNone, kNanos, kBytes };
   int64_t value;
   Unit unit{Unit::kNone};
+  // If true, the RuntimeMetric the counter is added to keeps a histogram of
+  // the values, e.g. for the percentiles of a latency.
+  bool histogram{false};
 
-  explicit RuntimeCounter(int64_t _value, Unit _unit = Unit::kNone)
-      : value(_value), unit(_unit) {}
+  explicit RuntimeCounter(
+      int64_t _value,
+      Unit _unit = Unit::kNone,
+      bool _histogram = false)
+      : value(_value), unit(_unit), histogram(_histogram) {}
+};
+
+// Mergeable histogram of non-negative values with log-linear buckets as in
+// HdrHistogram. Values below 2 * kSubBuckets have a bucket each. Above that,
+// each power of 2 is split into kSubBuckets buckets of equal width, so that
+// a quantile is within 1 / kSubBuckets of the true value. Buckets are
+// allocated up to the largest value seen, e.g. 2KB for values up to 10s in
+// nanoseconds.
+class RuntimeHistogram {
+ public:
+  static constexpr int32_t kSubBucketBits = 3;
+  static constexpr int32_t kSubBuckets = 1 << kSubBucketBits;
+
+  // Negative values count as 0.
+  void add(int64_t value);
+
+  void merge(const RuntimeHistogram& other);
+
+  // Returns the upper bound of the bucket of the value at 'quantile', e.g.
+  // 0.99 for p99. 0 if empty.
+  int64_t quantile(double quantile) const;
+
+  int64_t count() const {
+    return count_;
+  }
+
+  static int32_t bucketIndex(int64_t value);
+
+  // Returns the largest value of bucket 'index'.
+  static int64_t bucketUpperBound(int32_t index);
+
+ private:
+  std::vector<int64_t> buckets_;
+  int64_t count_{0};
 };
 
 struct RuntimeMetric {
@@ -37,10 +80,18 @@ struct RuntimeMetric {
   int64_t count{0};
   int64_t min{std::numeric_limits<int64_t>::max()};
   int64_t max{std::numeric_limits<int64_t>::min()};
+  // The distribution of the values if the metric was created with a
+  // histogram. printMetric() then shows p50, p99 and p999.
+  std::optional<RuntimeHistogram> histogram;
 
   explicit RuntimeMetric(
-      RuntimeCounter::Unit _unit = RuntimeCounter::Unit::kNone)
-      : unit(_unit) {}
+      RuntimeCounter::Unit _unit = RuntimeCounter::Unit::kNone,
+      bool withHistogram = false)
+      : unit(_unit) {
+    if (withHistogram) {
+      histogram.emplace();
+    }
+  }
 
   void addValue(int64_t value);
 
@@ -164,6 +164,27 @@ struct BitMask<T, A, 8> {
   }
 };
 
+#if XSIMD_WITH_AVX512F
+// Writes the positions of the set bits of 'word' plus 'row' to 'result' with
+// VPCOMPRESSD, 16 bits at a time. Returns the number of positions.
+inline int32_t compressSetBits(uint64_t word, int32_t row, int32_t* result) {
+  const auto iota = _mm512_setr_epi32(
+      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  int32_t count = 0;
+  for (auto i = 0; i < 4; ++i) {
+    const __mmask16 mask = word >> (i * 16);
+    if (mask) {
+      _mm512_mask_compressstoreu_epi32(
+          result + count,
+          mask,
+          _mm512_add_epi32(iota, _mm512_set1_epi32(row + i * 16)));
+      count += __builtin_popcount(mask);
+    }
+  }
+  return count;
+}
+#endif
+
 } // namespace detail
 
 template <typename A>
@@ -208,7 +229,14 @@ int32_t indicesOfSetBits(
         word = word & (word - 1);
       } while (word);
       row += 64;
-    } else {
+    }
+#if XSIMD_WITH_AVX512F
+    else if constexpr (std::is_base_of_v<xsimd::avx512f, A>) {
+      result += detail::compressSetBits(word, row, result);
+      row += 64;
+    }
+#endif
+    else {
       for (auto byteCnt = 0; byteCnt < 8; ++byteCnt) {
         uint8_t byte = word;
         word = word >> 8;
@@ -46,7 +46,8 @@ bool initializeSimdUtil();
 // Returns positions of set bits in 'bits' in 'indices'. Bits from
 // 'begin' to 'end' are considered and the return value is the number
 // of found set bits. For bits 0xff and begin 2 and end 5 we have a return value
-// of 3 and indices is set to {2, 3, 4}.
+// of 3 and indices is set to {2, 3, 4}. With AVX-512 the dense words are
+// expanded with VPCOMPRESSD, otherwise with a lookup table per byte.
 template <typename A = xsimd::default_arch>
 int32_t indicesOfSetBits(
     const uint64_t* bits,
@@ -44,6 +44,10 @@
 ///   REPORT_ADD_STAT_VALUE("my_stat1");
 ///   REPORT_ADD_STAT_VALUE("my_stat2", 10);
 ///   REPORT_ADD_STAT_VALUE("my_stat1", numOfFailures);
+///
+/// A stat of type HISTOGRAM gets one value per event, e.g. the latency of a
+/// load, and should be exported as percentiles, at least p50, p99 and p999.
+/// The bucketing is up to the reporter, e.g. folly::TimeseriesHistogram.
 
 namespace facebook::velox {
 
@@ -52,6 +56,7 @@ enum class StatType {
   SUM,
   RATE,
   COUNT,
+  HISTOGRAM,
 };
 
 // This is the base stats reporter interface that should be extended by
@@ -20,6 +20,7 @@
 #include <optional>
 
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/SimdUtil.h"
 DECLARE_bool(bmi2); // NOLINT
 
 namespace facebook {
@@ -186,6 +187,69 @@ BENCHMARK_RELATIVE_MULTI(forEachBitFirstBitFalse) {
   return kNumRuns;
 }
 
+// Masks of 'numBits' bits with every 64th bit set if sparse and all but
+// every 8th bit set if dense.
+std::vector<uint64_t> makeMask(bool dense) {
+  std::vector<uint64_t> mask(bits::nwords(numBits));
+  for (auto i = 0; i < numBits; ++i) {
+    bits::setBit(mask.data(), i, dense ? i % 8 != 0 : i % 64 == 0);
+  }
+  return mask;
+}
+
+void forEachSetBitMask(uint32_t iterations, bool dense) {
+  folly::BenchmarkSuspender suspender;
+  auto mask = makeMask(dense);
+  suspender.dismiss();
+
+  for (uint32_t i = 0; i < iterations; ++i) {
+    int64_t sum = 0;
+    bits::forEachSetBit(
+        mask.data(), 0, numBits, [&](auto row) { sum += row; });
+    folly::doNotOptimizeAway(sum);
+  }
+}
+
+void indicesOfSetBitsMask(uint32_t iterations, bool dense) {
+  folly::BenchmarkSuspender suspender;
+  auto mask = makeMask(dense);
+  // The dense paths may write a full batch past the last index.
+  std::vector<int32_t> indices(numBits + simd::kPadding);
+  suspender.dismiss();
+
+  for (uint32_t i = 0; i < iterations; ++i) {
+    int64_t sum = 0;
+    auto numIndices =
+        simd::indicesOfSetBits(mask.data(), 0, numBits, indices.data());
+    for (auto j = 0; j < numIndices; ++j) {
+      sum += indices[j];
+    }
+    folly::doNotOptimizeAway(sum);
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_MULTI(forEachSetBitSparse) {
+  forEachSetBitMask(kNumRuns, false);
+  return kNumRuns;
+}
+
+BENCHMARK_RELATIVE_MULTI(indicesOfSetBitsSparse) {
+  indicesOfSetBitsMask(kNumRuns, false);
+  return kNumRuns;
+}
+
+BENCHMARK_MULTI(forEachSetBitDense) {
+  forEachSetBitMask(kNumRuns, true);
+  return kNumRuns;
+}
+
+BENCHMARK_RELATIVE_MULTI(indicesOfSetBitsDense) {
+  indicesOfSetBitsMask(kNumRuns, true);
+  return kNumRuns;
+}
+
 } // namespace test
 } // namespace velox
 } // namespace facebook
@@ -113,3 +113,36 @@ TEST(CoalesceIoTest, basic) {
   EXPECT_EQ(1, ioGroups[2].size());
   EXPECT_EQ(1, ioGroups[3].size());
 }
+
+TEST(CoalesceIoTest, maxIoBytes) {
+  // 10 units of 100 bytes 10 bytes apart. An IO covers at most 350 bytes,
+  // i.e. 3 units.
+  std::vector<IoUnit> data;
+  for (auto i = 0; i < 10; ++i) {
+    data.emplace_back(i * 110, 100, 1);
+  }
+  std::vector<int64_t> offsets;
+  auto stats = coalesceIo<IoUnit, Range>(
+      data,
+      1000,
+      100,
+      [&](int32_t index) { return data[index].offset; },
+      [&](int32_t index) { return data[index].size; },
+      [&](int32_t /*index*/) { return 1; },
+      [&](const IoUnit& item, std::vector<Range>& ranges) {
+        ranges.emplace_back(item.size, 1);
+      },
+      [&](int32_t skip, std::vector<Range>& ranges) {
+        ranges.emplace_back(skip, 0);
+      },
+      [&](const std::vector<IoUnit>& /*items*/,
+          int32_t /*begin*/,
+          int32_t /*end*/,
+          uint64_t offset,
+          const std::vector<Range>& /*ranges*/) { offsets.push_back(offset); },
+      350);
+  EXPECT_EQ(4, stats.numIos);
+  EXPECT_EQ(60, stats.extraBytes);
+  std::vector<int64_t> expectedOffsets{0, 330, 660, 990};
+  EXPECT_EQ(expectedOffsets, offsets);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/RadixSort.h"
+#include <folly/Random.h>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+
+namespace {
+
+template <typename T>
+void testSort(std::vector<T> values) {
+  std::vector<T> scratch;
+  for (auto ascending : {true, false}) {
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    if (!ascending) {
+      std::reverse(expected.begin(), expected.end());
+    }
+    auto actual = values;
+    sortFixedWidth(
+        actual.data(), actual.data() + actual.size(), ascending, scratch);
+    EXPECT_EQ(expected, actual);
+  }
+}
+
+template <typename T>
+std::vector<T> randomValues(
+    int32_t size,
+    folly::Random::DefaultGenerator& rng) {
+  std::vector<T> values(size);
+  for (auto& value : values) {
+    value = static_cast<T>(folly::Random::rand64(rng));
+  }
+  return values;
+}
+
+} // namespace
+
+TEST(RadixSortTest, integers) {
+  folly::Random::DefaultGenerator rng(1);
+  for (auto size : {0, 1, 10, kMinRadixSortSize, 10'000}) {
+    testSort(randomValues<int8_t>(size, rng));
+    testSort(randomValues<int16_t>(size, rng));
+    testSort(randomValues<int32_t>(size, rng));
+    testSort(randomValues<int64_t>(size, rng));
+    testSort(randomValues<uint64_t>(size, rng));
+  }
+  // Keys that differ only in their high bytes skip the passes of the low
+  // bytes.
+  std::vector<int64_t> values;
+  for (auto i = 0; i < 1'000; ++i) {
+    values.push_back(static_cast<int64_t>(1'000 - i) << 40);
+  }
+  testSort(values);
+}
+
+TEST(RadixSortTest, floatingPoint) {
+  folly::Random::DefaultGenerator rng(1);
+  std::vector<double> doubles;
+  std::vector<float> floats;
+  for (auto i = 0; i < 1'000; ++i) {
+    doubles.push_back(folly::Random::randDouble(-1e10, 1e10, rng));
+    floats.push_back(folly::Random::randDouble(-1e5, 1e5, rng));
+  }
+  doubles.push_back(std::numeric_limits<double>::infinity());
+  doubles.push_back(-std::numeric_limits<double>::infinity());
+  doubles.push_back(std::numeric_limits<double>::lowest());
+  doubles.push_back(std::numeric_limits<double>::denorm_min());
+  doubles.push_back(0);
+  testSort(doubles);
+  testSort(floats);
+
+  // NaNs are larger than all other values.
+  std::vector<double> scratch;
+  const auto nan = std::numeric_limits<double>::quiet_NaN();
+  auto withNans = doubles;
+  withNans[10] = nan;
+  withNans[500] = -nan;
+  sortFixedWidth(
+      withNans.data(), withNans.data() + withNans.size(), true, scratch);
+  EXPECT_TRUE(std::isnan(withNans[withNans.size() - 1]));
+  EXPECT_TRUE(std::isnan(withNans[withNans.size() - 2]));
+  EXPECT_TRUE(std::is_sorted(withNans.begin(), withNans.end() - 2));
+  sortFixedWidth(
+      withNans.data(), withNans.data() + withNans.size(), false, scratch);
+  EXPECT_TRUE(std::isnan(withNans[0]));
+  EXPECT_TRUE(std::isnan(withNans[1]));
+  EXPECT_TRUE(std::is_sorted(withNans.rbegin(), withNans.rend() - 2));
+}
+
+TEST(RadixSortTest, stable) {
+  // Sorts pairs by their first member. The second members of equal keys
+  // keep their order.
+  std::vector<std::pair<uint16_t, int32_t>> items;
+  for (auto i = 0; i < 1'000; ++i) {
+    items.emplace_back(i * 7 % 13, i);
+  }
+  auto expected = items;
+  std::stable_sort(expected.begin(), expected.end(), [](auto a, auto b) {
+    return a.first < b.first;
+  });
+  std::vector<std::pair<uint16_t, int32_t>> scratch;
+  radixSortBy(
+      items.data(),
+      items.data() + items.size(),
+      [](const auto& item) { return item.first; },
+      scratch);
+  EXPECT_EQ(expected, items);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/RuntimeMetrics.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+
+TEST(RuntimeMetricsTest, histogramBuckets) {
+  // Buckets are exact below 16 and then 8 per power of 2.
+  for (int64_t value = 0; value < 16; ++value) {
+    EXPECT_EQ(value, RuntimeHistogram::bucketIndex(value));
+    EXPECT_EQ(value, RuntimeHistogram::bucketUpperBound(value));
+  }
+  EXPECT_EQ(16, RuntimeHistogram::bucketIndex(16));
+  EXPECT_EQ(16, RuntimeHistogram::bucketIndex(17));
+  EXPECT_EQ(17, RuntimeHistogram::bucketUpperBound(16));
+  EXPECT_EQ(23, RuntimeHistogram::bucketIndex(31));
+  EXPECT_EQ(24, RuntimeHistogram::bucketIndex(32));
+  EXPECT_EQ(35, RuntimeHistogram::bucketUpperBound(24));
+  EXPECT_EQ(0, RuntimeHistogram::bucketIndex(-5));
+
+  // Consecutive buckets cover all values without gaps.
+  for (int32_t index = 1; index < 488; ++index) {
+    const auto lowerBound = RuntimeHistogram::bucketUpperBound(index - 1) + 1;
+    EXPECT_EQ(index, RuntimeHistogram::bucketIndex(lowerBound));
+    EXPECT_EQ(
+        index,
+        RuntimeHistogram::bucketIndex(
+            RuntimeHistogram::bucketUpperBound(index)));
+  }
+  EXPECT_EQ(
+      std::numeric_limits<int64_t>::max(),
+      RuntimeHistogram::bucketUpperBound(
+          RuntimeHistogram::bucketIndex(std::numeric_limits<int64_t>::max())));
+}
+
+TEST(RuntimeMetricsTest, histogramQuantiles) {
+  RuntimeHistogram histogram;
+  EXPECT_EQ(0, histogram.quantile(0.5));
+  for (int64_t i = 1; i <= 10'000; ++i) {
+    histogram.add(i * 1'000);
+  }
+  EXPECT_EQ(10'000, histogram.count());
+  for (auto quantile : {0.5, 0.9, 0.99, 0.999}) {
+    const double expected = quantile * 10'000'000;
+    const auto actual = histogram.quantile(quantile);
+    EXPECT_GE(actual, expected);
+    EXPECT_LE(actual, expected * (1 + 1.0 / RuntimeHistogram::kSubBuckets));
+  }
+
+  RuntimeHistogram other;
+  other.add(1LL << 40);
+  other.add(1LL << 40);
+  histogram.merge(other);
+  EXPECT_EQ(10'002, histogram.count());
+  EXPECT_GE(histogram.quantile(1), 1LL << 40);
+  EXPECT_LT(histogram.quantile(0.99), 1LL << 40);
+}
+
+TEST(RuntimeMetricsTest, metricWithHistogram) {
+  RuntimeMetric metric(RuntimeCounter::Unit::kNone, true);
+  for (auto i = 1; i <= 100; ++i) {
+    metric.addValue(i);
+  }
+  std::stringstream out;
+  metric.printMetric(out);
+  EXPECT_EQ(
+      " sum: 5050, count: 100, min: 1, max: 100, p50: 51, p99: 100, "
+      "p999: 100",
+      out.str());
+
+  RuntimeMetric plain;
+  plain.addValue(7);
+  EXPECT_FALSE(plain.histogram.has_value());
+  plain.merge(metric);
+  ASSERT_TRUE(plain.histogram.has_value());
+  EXPECT_EQ(100, plain.histogram->count());
+  EXPECT_EQ(101, plain.count);
+}
@@ -62,10 +62,12 @@ TEST_F(StatsReporterTest, trivialReporter) {
   REPORT_ADD_STAT_EXPORT_TYPE("key1", StatType::COUNT);
   REPORT_ADD_STAT_EXPORT_TYPE("key2", StatType::SUM);
   REPORT_ADD_STAT_EXPORT_TYPE("key3", StatType::RATE);
+  REPORT_ADD_STAT_EXPORT_TYPE("key5", StatType::HISTOGRAM);
 
   EXPECT_EQ(StatType::COUNT, reporter->counterTypeMap["key1"]);
   EXPECT_EQ(StatType::SUM, reporter->counterTypeMap["key2"]);
   EXPECT_EQ(StatType::RATE, reporter->counterTypeMap["key3"]);
+  EXPECT_EQ(StatType::HISTOGRAM, reporter->counterTypeMap["key5"]);
   EXPECT_TRUE(
       reporter->counterTypeMap.find("key4") == reporter->counterTypeMap.end());
 
@@ -18,8 +18,16 @@
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
 
+#include <folly/executors/InlineExecutor.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/io/Compression.h>
+#include <folly/io/IOBuf.h>
 #include "velox/common/caching/FileIds.h"
+#include "velox/common/time/Timer.h"
+
+#include <fstream>
+#include <map>
+#include <unordered_set>
 
 namespace facebook::velox::cache {
 
@@ -50,13 +58,24 @@ void AsyncDataCacheEntry::setExclusiveToShared() {
     hook(*this);
   }
 
-  if (!ssdFile_ && shard_->cache()->ssdCache()) {
-    auto ssdCache = shard_->cache()->ssdCache();
-    assert(ssdCache); // for lint only.
-    if (ssdCache->groupStats().shouldSaveToSsd(groupId_, trackingId_)) {
-      ssdSaveable_ = true;
-      shard_->cache()->possibleSsdSave(size_);
-    }
+  checkSsdSaveable();
+}
+
+void AsyncDataCacheEntry::checkSsdSaveable() {
+  auto ssdCache = shard_->cache()->ssdCache();
+  if (ssdFile_ || ssdSaveable_ || !ssdCache || !isAdmitted_ ||
+      !key_.fileNum.hasValue()) {
+    return;
+  }
+  if (minSsdHits_ &&
+      shard_->estimateFrequency({key_.fileNum.id(), key_.offset}) <
+          minSsdHits_) {
+    // Rechecked on later hits.
+    return;
+  }
+  if (ssdCache->groupStats().shouldSaveToSsd(groupId_, trackingId_)) {
+    ssdSaveable_ = true;
+    shard_->cache()->possibleSsdSave(size_);
   }
 }
 
@@ -77,6 +96,9 @@ void AsyncDataCacheEntry::release() {
   } else {
     auto oldPins = numPins_.fetch_add(-1);
     VELOX_CHECK_LE(1, oldPins, "pin count goes negative");
+    if (oldPins == 1 && !isAdmitted_ && !isPrefetch_) {
+      shard_->removeRejected(this);
+    }
   }
 }
 
@@ -96,7 +118,17 @@ void AsyncDataCacheEntry::initialize(FileCacheKey key) {
   VELOX_CHECK(isExclusive());
   setSsdFile(nullptr, 0);
   accessStats_.reset();
+  compressedSize_ = 0;
+  numIdleRounds_ = 0;
+  isIncompressible_ = false;
   key_ = std::move(key);
+  // Removing 'this' with the key, also when allocateData() fails,
+  // subtracts the size.
+  shard_->cache()->incrementPoolBytes(poolId_, size_);
+  allocateData();
+}
+
+void AsyncDataCacheEntry::allocateData() {
   auto cache = shard_->cache();
   ClockTimer t(shard_->allocClocks());
   if (size_ < AsyncDataCacheEntry::kTinyDataSize) {
@@ -123,6 +155,112 @@ void AsyncDataCacheEntry::initialize(FileCacheKey key) {
   }
 }
 
+namespace {
+// Returns an IOBuf chain referencing the first 'size' bytes of 'data'.
+std::unique_ptr<folly::IOBuf> wrapAllocation(
+    const MappedMemory::Allocation& data,
+    uint64_t size) {
+  std::unique_ptr<folly::IOBuf> chain;
+  for (auto i = 0; i < data.numRuns() && size > 0; ++i) {
+    auto run = data.runAt(i);
+    auto bytes = std::min<uint64_t>(run.numBytes(), size);
+    auto buffer = folly::IOBuf::wrapBuffer(run.data<char>(), bytes);
+    if (chain) {
+      chain->prependChain(std::move(buffer));
+    } else {
+      chain = std::move(buffer);
+    }
+    size -= bytes;
+  }
+  return chain;
+}
+
+// Copies the bytes of 'chain' to the start of 'data'.
+void copyToAllocation(
+    const folly::IOBuf& chain,
+    MappedMemory::Allocation& data) {
+  int32_t runIndex = 0;
+  uint64_t offsetInRun = 0;
+  for (auto& range : chain) {
+    auto source = range.data();
+    auto size = range.size();
+    while (size > 0) {
+      auto run = data.runAt(runIndex);
+      auto bytes = std::min<uint64_t>(run.numBytes() - offsetInRun, size);
+      memcpy(run.data<uint8_t>() + offsetInRun, source, bytes);
+      source += bytes;
+      size -= bytes;
+      offsetInRun += bytes;
+      if (offsetInRun == run.numBytes()) {
+        ++runIndex;
+        offsetInRun = 0;
+      }
+    }
+  }
+}
+} // namespace
+
+bool AsyncDataCacheEntry::compress() {
+  VELOX_CHECK(isExclusive());
+  VELOX_CHECK(!isCompressed());
+  auto cache = shard_->cache();
+  auto codec = folly::io::getCodec(folly::io::CodecType::LZ4);
+  std::unique_ptr<folly::IOBuf> compressed;
+  try {
+    compressed = codec->compress(wrapAllocation(data_, size_).get());
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Error in compressing cache entry: " << e.what();
+    isIncompressible_ = true;
+    return true;
+  }
+  auto compressedSize = compressed->computeChainDataLength();
+  auto numPages = data_.numPages();
+  auto compressedPages =
+      bits::roundUp(compressedSize, MappedMemory::kPageSize) /
+      MappedMemory::kPageSize;
+  if (compressedPages > numPages / 4 * 3) {
+    isIncompressible_ = true;
+    return true;
+  }
+  ClockTimer t(shard_->allocClocks());
+  // The original is freed first so that the smaller copy fits without
+  // evicting.
+  cache->free(data_);
+  cache->incrementCachedPages(-numPages);
+  if (!cache->allocateWithoutEvict(compressedPages, data_)) {
+    return false;
+  }
+  cache->incrementCachedPages(data_.numPages());
+  copyToAllocation(*compressed, data_);
+  compressedSize_ = compressedSize;
+  return true;
+}
+
+void AsyncDataCacheEntry::decompress() {
+  VELOX_CHECK(isExclusive());
+  VELOX_CHECK(isCompressed());
+  auto cache = shard_->cache();
+  std::unique_ptr<folly::IOBuf> uncompressed;
+  try {
+    auto codec = folly::io::getCodec(folly::io::CodecType::LZ4);
+    uncompressed = codec->uncompress(
+        wrapAllocation(data_, compressedSize_).get(), size_);
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Error in decompressing cache entry: " << e.what();
+    shard_->removeEntry(this);
+    release();
+    throw;
+  }
+  cache->incrementCachedPages(-data_.numPages());
+  {
+    ClockTimer t(shard_->allocClocks());
+    cache->free(data_);
+  }
+  compressedSize_ = 0;
+  allocateData();
+  copyToAllocation(*uncompressed, data_);
+}
+
 std::string AsyncDataCacheEntry::toString() const {
   return fmt::format(
       "<entry key:{}:{} size {} pins {}>",
@@ -147,13 +285,24 @@ std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntryWithSize(
 CachePin CacheShard::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    const CacheAdmission& admission) {
+  auto hash = std::hash<RawFileCacheKey>()(key);
+  frequencies_.increment(hash);
+  auto hitPin = findWithoutLock(key, size);
+  if (!hitPin.empty()) {
+    if (hitPin.checkedEntry()->minSsdHits_) {
+      hitPin.checkedEntry()->checkSsdSaveable();
+    }
+    return hitPin;
+  }
   AsyncDataCacheEntry* entryToInit = nullptr;
+  AsyncDataCacheEntry* entryToDecompress = nullptr;
   {
     std::lock_guard<std::mutex> l(mutex_);
     ++eventCounter_;
     auto it = entryMap_.find(key);
-    if (it != entryMap_.end()) {
+    if (it != entryMap_.cend()) {
       auto found = it->second;
       if (found->isExclusive()) {
         ++numWaitExclusive_;
@@ -166,52 +315,154 @@ CachePin CacheShard::findOrCreate(
       if (found->size() >= size) {
         found->touch();
         // The entry is in a readable state. Add a pin.
+        // A hit shows that a rejected entry is reused after all. The first
+        // use of a prefetched entry is not a reuse.
         if (found->isPrefetch_) {
           found->isFirstUse_ = true;
           found->setPrefetch(false);
         } else {
+          found->isAdmitted_ = true;
           ++numHit_;
+          cache_->incrementPoolHits(found->poolId_);
         }
-        ++found->numPins_;
-        CachePin pin;
-        pin.setEntry(found);
-        return pin;
+        if (found->isCompressed()) {
+          // Compressed entries are unpinned. Other readers wait until the
+          // entry is decompressed outside of 'mutex_'. findWithoutLock()
+          // may hold a pin for the time of checking the entry.
+          while (!tryMakeExclusive(*found)) {
+            std::this_thread::yield();
+          }
+          entryToDecompress = found;
+          ++numDecompress_;
+        } else {
+          ++found->numPins_;
+          hitPin.setEntry(found);
+        }
+      } else {
+        // This can happen if different load quanta apply to access via
+        // different connectors. This is not an error but still worth
+        // logging.
+        LOG_EVERY_N(INFO, 100) << "Requested larger entry. Found size "
+                               << found->size() << " requested size " << size;
+        // The old entry is superseded. Possible readers of the old
+        // entry still retain a valid read pin.
+        granules_.add(key.fileNum, key.offset, -found->size_);
+        found->key_.fileNum.clear();
+        cache_->incrementPoolBytes(found->poolId_, -found->size_);
       }
-      // This can happen if different load quanta apply to access via
-      // different connectors. This is not an error but still worth
-      // logging.
-      LOG_EVERY_N(INFO, 100) << "Requested larger entry. Found size "
-                             << found->size() << " requested size " << size;
-      // The old entry is superseded. Possible readers of the old
-      // entry still retain a valid read pin.
-      found->key_.fileNum.clear();
-    }
-    auto newEntry = getFreeEntryWithSize(size);
-    // Initialize the members that must be set inside 'mutex_'.
-    newEntry->numPins_ = AsyncDataCacheEntry::kExclusive;
-    newEntry->promise_ = nullptr;
-    entryToInit = newEntry.get();
-    entryMap_[key] = newEntry.get();
-    if (emptySlots_.empty()) {
-      entries_.push_back(std::move(newEntry));
-    } else {
-      auto index = emptySlots_.back();
-      emptySlots_.pop_back();
-      entries_[index] = std::move(newEntry);
     }
-    ++numNew_;
-    // Inside the shard mutex.
-    VELOX_CHECK_EQ(0, entryToInit->size_);
-    entryToInit->size_ = size;
-    entryToInit->isFirstUse_ = true;
+    if (hitPin.empty() && !entryToDecompress) {
+      auto newEntry = getFreeEntryWithSize(size);
+      // Initialize the members that must be set inside 'mutex_'.
+      newEntry->numPins_ = AsyncDataCacheEntry::kExclusive;
+      newEntry->promise_ = nullptr;
+      newEntry->isAdmitted_ = !admission.frequencyFilter ||
+          !cache_->nearCapacity() || !isVictimMoreFrequentLocked(hash);
+      if (!newEntry->isAdmitted_) {
+        ++numRejected_;
+      }
+      newEntry->minSsdHits_ = admission.minSsdHits;
+      newEntry->poolId_ = admission.poolId;
+      cache_->incrementPoolNew(admission.poolId);
+      granules_.add(key.fileNum, key.offset, size);
+      entryToInit = newEntry.get();
+      entryMap_.insert_or_assign(key, newEntry.get());
+      if (emptySlots_.empty()) {
+        entries_.push_back(std::move(newEntry));
+      } else {
+        auto index = emptySlots_.back();
+        emptySlots_.pop_back();
+        entries_[index] = std::move(newEntry);
+      }
+      ++numNew_;
+      // Inside the shard mutex.
+      VELOX_CHECK_EQ(0, entryToInit->size_);
+      entryToInit->size_ = size;
+      entryToInit->isFirstUse_ = true;
+    }
+  }
+  if (entryToDecompress) {
+    // Throws and removes the entry if there is no memory.
+    entryToDecompress->decompress();
+    entryToDecompress->setExclusiveToShared();
+    hitPin.setEntry(entryToDecompress);
+  }
+  if (!hitPin.empty()) {
+    if (hitPin.checkedEntry()->minSsdHits_) {
+      // Outside of 'mutex_'. The hit may qualify the entry for SSD.
+      hitPin.checkedEntry()->checkSsdSaveable();
+    }
+    return hitPin;
   }
   return initEntry(key, entryToInit);
 }
 
-bool CacheShard::exists(RawFileCacheKey key) const {
+int32_t CacheShard::estimateFrequency(RawFileCacheKey key) const {
+  auto hash = std::hash<RawFileCacheKey>()(key);
   std::lock_guard<std::mutex> l(mutex_);
+  return frequencies_.estimate(hash);
+}
+
+bool CacheShard::isVictimMoreFrequentLocked(uint64_t hash) {
+  auto size = entries_.size();
+  for (auto i = 1; i <= std::min<int32_t>(kNumVictimChecks, size); ++i) {
+    auto* candidate = entries_[(clockHand_ + i) % size].get();
+    if (candidate && candidate->numPins_ == 0 &&
+        candidate->key_.fileNum.hasValue()) {
+      auto victimHash = std::hash<RawFileCacheKey>()(
+          {candidate->key_.fileNum.id(), candidate->key_.offset});
+      return frequencies_.estimate(victimHash) > frequencies_.estimate(hash);
+    }
+  }
+  return false;
+}
+
+CachePin CacheShard::findWithoutLock(RawFileCacheKey key, uint64_t size) {
+  AsyncDataCacheEntry* entry;
+  {
+    auto it = entryMap_.find(key);
+    if (it == entryMap_.cend()) {
+      return CachePin();
+    }
+    entry = it->second;
+  }
+  // Prefetched, rejected and compressed entries change state on hit.
+  auto isReadable = [&]() {
+    return !entry->isPrefetch_ && entry->isAdmitted_ &&
+        !entry->isCompressed() && entry->size_ >= size;
+  };
+  if (!isReadable()) {
+    return CachePin();
+  }
+  auto numPins = entry->numPins_.load();
+  do {
+    if (numPins < 0) {
+      return CachePin();
+    }
+  } while (!entry->numPins_.compare_exchange_weak(numPins, numPins + 1));
+  // The entry may have been evicted or reused for another key between
+  // the lookup and the pin. The pin keeps the key and data from changing.
+  if (!entry->key_.fileNum.hasValue() ||
+      entry->key_.fileNum.id() != key.fileNum ||
+      entry->key_.offset != key.offset || !isReadable()) {
+    // The entry is as it was before the pin, so this does not release()
+    // it.
+    --entry->numPins_;
+    return CachePin();
+  }
+  // The access stats are approximate. Concurrent hits may lose updates.
+  entry->touch();
+  ++eventCounter_;
+  ++numHit_;
+  cache_->incrementPoolHits(entry->poolId_);
+  CachePin pin;
+  pin.setEntry(entry);
+  return pin;
+}
+
+bool CacheShard::exists(RawFileCacheKey key) const {
   auto it = entryMap_.find(key);
-  if (it != entryMap_.end()) {
+  if (it != entryMap_.cend()) {
     it->second->touch();
     return true;
   }
@@ -262,13 +513,7 @@ bool CoalescedLoad::loadOrFuture(folly::SemiFuture<bool>* wait) {
   // Outside of 'mutex_'.
   try {
     auto pins = loadData(!wait);
-    for (auto& pin : pins) {
-      auto entry = pin.checkedEntry();
-      VELOX_CHECK(entry->key().fileNum.hasValue());
-      VELOX_CHECK(entry->isExclusive());
-      entry->setExclusiveToShared();
-    }
-    setEndState(LoadState::kLoaded);
+    finishLoad(pins);
   } catch (std::exception& e) {
     try {
       setEndState(LoadState::kCancelled);
@@ -280,6 +525,68 @@ bool CoalescedLoad::loadOrFuture(folly::SemiFuture<bool>* wait) {
   return true;
 }
 
+folly::SemiFuture<bool> CoalescedLoad::loadAsync() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (state_ == LoadState::kCancelled || state_ == LoadState::kLoaded) {
+      return folly::makeSemiFuture(true);
+    }
+    if (state_ == LoadState::kLoading) {
+      if (!promise_) {
+        promise_ = std::make_unique<folly::SharedPromise<bool>>();
+      }
+      return promise_->getSemiFuture();
+    }
+    VELOX_CHECK_EQ(LoadState::kPlanned, state_);
+    state_ = LoadState::kLoading;
+  }
+  folly::SemiFuture<std::vector<CachePin>> load =
+      folly::SemiFuture<std::vector<CachePin>>::makeEmpty();
+  try {
+    load = loadDataAsync(true);
+  } catch (std::exception& e) {
+    setEndState(LoadState::kCancelled);
+    return folly::makeSemiFuture<bool>(e);
+  }
+  // The continuation runs on the thread that completes the IO.
+  return std::move(load)
+      .via(&folly::InlineExecutor::instance())
+      .thenTry([this](folly::Try<std::vector<CachePin>>&& pins) {
+        if (pins.hasValue()) {
+          try {
+            finishLoad(pins.value());
+            return true;
+          } catch (std::exception& e) {
+            LOG(WARNING) << "Error finishing prefetch: " << e.what();
+          }
+        } else {
+          LOG(WARNING) << "Error in prefetch: " << pins.exception().what();
+        }
+        setEndState(LoadState::kCancelled);
+        return false;
+      })
+      .semi();
+}
+
+folly::SemiFuture<std::vector<CachePin>> CoalescedLoad::loadDataAsync(
+    bool isPrefetch) {
+  try {
+    return folly::makeSemiFuture(loadData(isPrefetch));
+  } catch (std::exception& e) {
+    return folly::makeSemiFuture<std::vector<CachePin>>(e);
+  }
+}
+
+void CoalescedLoad::finishLoad(std::vector<CachePin>& pins) {
+  for (auto& pin : pins) {
+    auto entry = pin.checkedEntry();
+    VELOX_CHECK(entry->key().fileNum.hasValue());
+    VELOX_CHECK(entry->isExclusive());
+    entry->setExclusiveToShared();
+  }
+  setEndState(LoadState::kLoaded);
+}
+
 void CoalescedLoad::setEndState(LoadState endState) {
   std::lock_guard<std::mutex> l(mutex_);
   state_ = endState;
@@ -294,14 +601,28 @@ void CacheShard::removeEntry(AsyncDataCacheEntry* entry) {
   removeEntryLocked(entry);
 }
 
+void CacheShard::removeRejected(AsyncDataCacheEntry* entry) {
+  std::lock_guard<std::mutex> l(mutex_);
+  // The entry may have been pinned or hit again after its last pin was
+  // released.
+  if (!entry->isAdmitted_ && !entry->isPrefetch_ && tryMakeExclusive(*entry)) {
+    // The entry stays in 'entries_' without a key and is reused by
+    // evict().
+    removeEntryLocked(entry);
+    entry->numPins_ = 0;
+  }
+}
+
 void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
   if (entry->key_.fileNum.hasValue()) {
-    auto removeIter = entryMap_.find(
+    auto numErased = entryMap_.erase(
         RawFileCacheKey{entry->key_.fileNum.id(), entry->key_.offset});
-    VELOX_CHECK(removeIter != entryMap_.end());
-    entryMap_.erase(removeIter);
+    VELOX_CHECK_EQ(1, numErased);
+    granules_.add(entry->key_.fileNum.id(), entry->key_.offset, -entry->size_);
     entry->key_.fileNum.clear();
+    cache_->incrementPoolBytes(entry->poolId_, -entry->size_);
     entry->setSsdFile(nullptr, 0);
+    entry->compressedSize_ = 0;
     if (entry->isPrefetch()) {
       entry->setPrefetch(false);
     }
@@ -324,7 +645,15 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   auto ssdCache = cache_->ssdCache();
   bool skipSsdSaveable = ssdCache && ssdCache->writeInProgress();
   auto now = accessTime();
+  auto compressAfterRounds = cache_->compressAfterRounds();
+  // Estimated bytes freed by compressing the entries in 'toCompress'.
+  int64_t compressFreed = 0;
   std::vector<MappedMemory::Allocation> toFree;
+  std::vector<AsyncDataCacheEntry*> toCompress;
+  // Entries of pools within their share are retained while another pool
+  // is over its share.
+  const auto poolsOverShare =
+      evictAllUnpinned ? 0 : cache_->poolsOverShare();
   {
     std::lock_guard<std::mutex> l(mutex_);
     int size = entries_.size();
@@ -358,13 +687,41 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
         eventCounter_ = 0;
       }
       int32_t score = 0;
+      // Unpinned entries rejected by the frequency filter go first
+      // unless they are prefetched and not yet used.
       if (candidate->numPins_ == 0 &&
           (!candidate->key_.fileNum.hasValue() || evictAllUnpinned ||
+           (!candidate->isAdmitted_ && !candidate->isPrefetch_) ||
            (score = candidate->score(now)) >= evictionThreshold_)) {
         if (skipSsdSaveable && candidate->ssdSaveable_ && !evictAllUnpinned) {
           ++evictSaveableSkipped;
           continue;
         }
+        if (poolsOverShare && candidate->key_.fileNum.hasValue() &&
+            !(poolsOverShare & (1u << candidate->poolId_))) {
+          continue;
+        }
+        if (!tryMakeExclusive(*candidate)) {
+          // Pinned by a concurrent hit.
+          continue;
+        }
+        if (compressAfterRounds && !evictAllUnpinned &&
+            candidate->numIdleRounds_ >= compressAfterRounds &&
+            candidate->key_.fileNum.hasValue() && candidate->isAdmitted_ &&
+            !candidate->isCompressed() && !candidate->isIncompressible_ &&
+            !candidate->ssdSaveable_ && candidate->data_.numPages() > 0) {
+          // Compressed outside of 'mutex_'. Readers wait until done.
+          toCompress.push_back(candidate);
+          // Assumes LZ4 halves the size.
+          compressFreed += candidate->data_.byteSize() / 2;
+          if (largeFreed + tinyFreed + compressFreed > bytesToFree) {
+            break;
+          }
+          continue;
+        }
+        if (candidate->key_.fileNum.hasValue()) {
+          cache_->incrementPoolEvicts(candidate->poolId_);
+        }
         largeFreed += candidate->data_.byteSize();
         toFree.push_back(std::move(candidate->data()));
         removeEntryLocked(candidate);
@@ -377,16 +734,25 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
         if (score) {
           sumEvictScore_ += score;
         }
-        if (largeFreed + tinyFreed > bytesToFree) {
+        if (largeFreed + tinyFreed + compressFreed > bytesToFree) {
           break;
         }
+      } else if (
+          compressAfterRounds && candidate->numPins_ == 0 &&
+          candidate->numIdleRounds_ < compressAfterRounds) {
+        ++candidate->numIdleRounds_;
       }
     }
   }
-  ClockTimer t(allocClocks_);
-  toFree.clear();
+  {
+    ClockTimer t(allocClocks_);
+    toFree.clear();
+  }
   cache_->incrementCachedPages(
       -largeFreed / static_cast<int32_t>(MappedMemory::kPageSize));
+  if (!toCompress.empty()) {
+    compressEntries(toCompress);
+  }
   if (evictSaveableSkipped && ssdCache && ssdCache->startWrite()) {
     // Rare. May occur if SSD is unusually slow. Useful for  diagnostics.
     LOG(INFO) << "SSDCA: Start save for old saveable, skipped "
@@ -398,6 +764,27 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   }
 }
 
+void CacheShard::compressEntries(
+    const std::vector<AsyncDataCacheEntry*>& entries) {
+  for (auto* entry : entries) {
+    auto hasData = entry->compress();
+    std::unique_ptr<folly::SharedPromise<bool>> promise;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (!hasData) {
+        removeEntryLocked(entry);
+      } else if (entry->isCompressed()) {
+        ++numCompress_;
+      }
+      entry->numPins_ = 0;
+      promise = std::move(entry->promise_);
+    }
+    if (promise) {
+      promise->setValue(true);
+    }
+  }
+}
+
 void CacheShard::calibrateThreshold() {
   auto numSamples = std::min<int32_t>(10, entries_.size());
   auto now = accessTime();
@@ -439,8 +826,15 @@ void CacheShard::updateStats(CacheStats& stats) {
     ++stats.numEntries;
     stats.tinySize += entry->tinyData_.size();
     stats.tinyPadding += entry->tinyData_.capacity() - entry->tinyData_.size();
-    stats.largeSize += entry->size_;
-    stats.largePadding += entry->data_.byteSize() - entry->size_;
+    if (entry->isCompressed()) {
+      ++stats.numCompressed;
+      stats.compressedSize += entry->compressedSize_;
+      stats.largeSize += entry->compressedSize_;
+      stats.largePadding += entry->data_.byteSize() - entry->compressedSize_;
+    } else {
+      stats.largeSize += entry->size_;
+      stats.largePadding += entry->data_.byteSize() - entry->size_;
+    }
   }
   stats.numHit += numHit_;
   stats.numNew += numNew_;
@@ -448,6 +842,9 @@ void CacheShard::updateStats(CacheStats& stats) {
   stats.numEvictChecks += numEvictChecks_;
   stats.numWaitExclusive += numWaitExclusive_;
   stats.sumEvictScore += sumEvictScore_;
+  stats.numRejected += numRejected_;
+  stats.numCompress += numCompress_;
+  stats.numDecompress += numDecompress_;
   stats.allocClocks += allocClocks_;
 }
 
@@ -460,7 +857,7 @@ void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
   VELOX_CHECK(cache_->ssdCache()->writeInProgress());
   for (auto& entry : entries_) {
     if (entry && !entry->ssdFile_ && !entry->isExclusive() &&
-        entry->ssdSaveable_) {
+        !entry->isCompressed() && entry->ssdSaveable_) {
       CachePin pin;
       ++entry->numPins_;
       pin.setEntry(entry.get());
@@ -474,6 +871,38 @@ void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
   }
 }
 
+void CacheShard::appendHotSet(
+    AccessTime now,
+    std::vector<HotSetEntry>& entries) {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& entry : entries_) {
+    if (entry && entry->key_.fileNum.hasValue() && entry->ssdFile_ &&
+        !entry->isExclusive() && entry->accessStats_.numUses > 0) {
+      entries.push_back(
+          {entry->key_.fileNum.id(),
+           static_cast<uint64_t>(entry->key_.offset),
+           entry->size_,
+           entry->accessStats_.numUses,
+           entry->score(now)});
+    }
+  }
+}
+
+uint64_t CacheShard::cachedBytes(
+    uint64_t fileNum,
+    uint64_t offset,
+    uint64_t size) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return granules_.bytesIn(fileNum, offset, size);
+}
+
+void CacheShard::addGranules(GranuleBytes& granules) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  granules_.forEach([&](auto fileNum, auto granule, auto bytes) {
+    granules.add(fileNum, granule << GranuleBytes::kGranuleBits, bytes);
+  });
+}
+
 AsyncDataCache::AsyncDataCache(
     const std::shared_ptr<MappedMemory>& mappedMemory,
     uint64_t maxBytes,
@@ -487,12 +916,20 @@ AsyncDataCache::AsyncDataCache(
   }
 }
 
+AsyncDataCache::~AsyncDataCache() {
+  while (isEvicting_) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1)); // NOLINT
+  }
+}
+
 CachePin AsyncDataCache::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    const CacheAdmission& admission) {
+  VELOX_DCHECK_LT(admission.poolId, kMaxPools);
   int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->findOrCreate(key, size, wait);
+  return shards_[shard]->findOrCreate(key, size, wait, admission);
 }
 
 bool AsyncDataCache::exists(RawFileCacheKey key) const {
@@ -541,6 +978,7 @@ bool AsyncDataCache::makeSpace(
           if (isCounted) {
             --numThreadsInAllocate_;
           }
+          maybeEvictInBackground();
           return true;
         }
       } catch (const std::exception& e) {
@@ -581,6 +1019,49 @@ bool AsyncDataCache::makeSpace(
   return false;
 }
 
+void AsyncDataCache::maybeEvictInBackground() {
+  if (!evictExecutor_) {
+    return;
+  }
+  auto maxPages = maxBytes_ / MappedMemory::kPageSize;
+  if (mappedMemory_->numAllocated() <
+      maxPages / 100 * (100 - kEvictHeadroomPercent)) {
+    return;
+  }
+  if (isEvicting_.exchange(true)) {
+    return;
+  }
+  evictExecutor_->add([this]() {
+    try {
+      evictInBackground();
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Error in background eviction: " << e.what();
+    }
+    isEvicting_ = false;
+  });
+}
+
+void AsyncDataCache::evictInBackground() {
+  auto maxPages = maxBytes_ / MappedMemory::kPageSize;
+  auto targetPages = maxPages / 100 * (100 - 2 * kEvictHeadroomPercent);
+  // Each round evicts a headroom's worth spread over the shards. Stops if
+  // a round frees nothing, e.g. when the rest is pinned.
+  auto bytesPerShard = maxBytes_ / 100 * kEvictHeadroomPercent / kNumShards;
+  for (auto round = 0; round < 100; ++round) {
+    auto numAllocated = mappedMemory_->numAllocated();
+    if (numAllocated <= targetPages) {
+      break;
+    }
+    for (auto& shard : shards_) {
+      shard->evict(bytesPerShard, false);
+    }
+    ++numBackgroundEvicts_;
+    if (mappedMemory_->numAllocated() >= numAllocated) {
+      break;
+    }
+  }
+}
+
 void AsyncDataCache::backoff(int32_t counter) {
   size_t seed = folly::hasher<uint16_t>()(++backoffCounter_);
   auto usec = (seed & 0xfff) * (counter & 0x1f);
@@ -652,14 +1133,326 @@ void AsyncDataCache::saveToSsd() {
   ssdCache_->write(std::move(pins));
 }
 
+namespace {
+template <typename T>
+inline char* asChar(T ptr) {
+  return reinterpret_cast<char*>(ptr);
+}
+
+template <typename T>
+inline const char* asChar(const T* ptr) {
+  return reinterpret_cast<const char*>(ptr);
+}
+
+template <typename T>
+T readNumber(std::ifstream& stream) {
+  T data;
+  stream.read(asChar(&data), sizeof(T));
+  return data;
+}
+} // namespace
+
+std::string AsyncDataCache::hotSetPath() const {
+  return ssdCache_->filePrefix() + ".hot";
+}
+
+void AsyncDataCache::saveHotSet(int32_t maxEntries) {
+  if (!ssdCache_) {
+    return;
+  }
+  std::vector<HotSetEntry> entries;
+  auto now = accessTime();
+  for (auto& shard : shards_) {
+    shard->appendHotSet(now, entries);
+  }
+  if (entries.size() > maxEntries) {
+    std::nth_element(
+        entries.begin(),
+        entries.begin() + maxEntries,
+        entries.end(),
+        [](auto& left, auto& right) { return left.score < right.score; });
+    entries.resize(maxEntries);
+  }
+  std::sort(entries.begin(), entries.end(), [](auto& left, auto& right) {
+    return left.score < right.score;
+  });
+  try {
+    std::ofstream state;
+    state.exceptions(std::ofstream::failbit);
+    state.open(hotSetPath(), std::ios_base::out | std::ios_base::trunc);
+    // The hot set file contains:
+    // int32_t The 4 bytes of kHotSetMagic,
+    // {fileId, fileName} pairs,
+    // kHotSetMapMarker,
+    // {fileId, offset, size, numUses} in descending order of value,
+    // kHotSetEndMarker.
+    state.write(kHotSetMagic, sizeof(int32_t));
+    std::unordered_set<uint64_t> fileNums;
+    for (auto& entry : entries) {
+      if (fileNums.insert(entry.fileNum).second) {
+        state.write(asChar(&entry.fileNum), sizeof(entry.fileNum));
+        auto name = fileIds().string(entry.fileNum);
+        int32_t length = name.size();
+        state.write(asChar(&length), sizeof(length));
+        state.write(name.data(), length);
+      }
+    }
+    const auto mapMarker = kHotSetMapMarker;
+    state.write(asChar(&mapMarker), sizeof(mapMarker));
+    for (auto& entry : entries) {
+      state.write(asChar(&entry.fileNum), sizeof(entry.fileNum));
+      state.write(asChar(&entry.offset), sizeof(entry.offset));
+      state.write(asChar(&entry.size), sizeof(entry.size));
+      state.write(asChar(&entry.numUses), sizeof(entry.numUses));
+    }
+    const auto endMarker = kHotSetEndMarker;
+    state.write(asChar(&endMarker), sizeof(endMarker));
+    state.close();
+    LOG(INFO) << "Saved hot set of " << entries.size() << " entries";
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Error in saving hot set: " << e.what();
+    unlink(hotSetPath().c_str());
+  }
+}
+
+folly::SemiFuture<uint64_t> AsyncDataCache::loadHotSet(
+    uint64_t maxBytesPerSecond) {
+  if (!ssdCache_) {
+    return folly::makeSemiFuture<uint64_t>(0);
+  }
+  auto promise = std::make_shared<folly::Promise<uint64_t>>();
+  auto future = promise->getSemiFuture();
+  ssdCache_->executor()->add([this, promise, maxBytesPerSecond]() {
+    uint64_t bytes = 0;
+    try {
+      std::ifstream state(hotSetPath());
+      if (!state.is_open()) {
+        LOG(INFO) << "Starting without hot set";
+        promise->setValue(0);
+        return;
+      }
+      state.exceptions(std::ifstream::failbit);
+      char magic[4];
+      state.read(magic, sizeof(magic));
+      VELOX_CHECK(strncmp(magic, kHotSetMagic, 4) == 0);
+      // The leases keep the ids of the file names while loading.
+      std::unordered_map<uint64_t, StringIdLease> idMap;
+      for (;;) {
+        auto id = readNumber<uint64_t>(state);
+        if (id == kHotSetMapMarker) {
+          break;
+        }
+        std::string name;
+        name.resize(readNumber<int32_t>(state));
+        state.read(name.data(), name.size());
+        idMap[id] = StringIdLease(fileIds(), name);
+      }
+      std::vector<HotSetEntry> entries;
+      for (;;) {
+        auto fileNum = readNumber<uint64_t>(state);
+        if (fileNum == kHotSetEndMarker) {
+          break;
+        }
+        auto offset = readNumber<uint64_t>(state);
+        auto size = readNumber<int32_t>(state);
+        auto numUses = readNumber<int32_t>(state);
+        // The file may have a different id on restore.
+        auto it = idMap.find(fileNum);
+        VELOX_CHECK(it != idMap.end());
+        entries.push_back({it->second.id(), offset, size, numUses, 0});
+      }
+      bytes = loadHotSetEntries(entries, maxBytesPerSecond);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Error in loading hot set: " << e.what();
+    }
+    promise->setValue(bytes);
+  });
+  return future;
+}
+
+uint64_t AsyncDataCache::loadHotSetEntries(
+    const std::vector<HotSetEntry>& entries,
+    uint64_t maxBytesPerSecond) {
+  struct Load {
+    SsdPin ssdPin;
+    CachePin pin;
+    int32_t numUses;
+  };
+  uint64_t bytes = 0;
+  uint64_t startMicros = getCurrentTimeMicro();
+  bool full = false;
+  for (auto start = 0; start < entries.size() && !full;
+       start += kHotSetBatch) {
+    auto end = std::min<int32_t>(start + kHotSetBatch, entries.size());
+    // Makes the pins per SSD file. SsdFile::load() coalesces reads of
+    // entries in ascending order of offset.
+    std::map<SsdFile*, std::vector<Load>> loads;
+    for (auto i = start; i < end; ++i) {
+      if (nearCapacity()) {
+        full = true;
+        break;
+      }
+      auto& entry = entries[i];
+      RawFileCacheKey key{entry.fileNum, entry.offset};
+      auto& file = ssdCache_->file(entry.fileNum);
+      auto ssdPin = file.find(key);
+      if (ssdPin.empty() || ssdPin.run().size() != entry.size) {
+        continue;
+      }
+      auto pin = findOrCreate(key, entry.size, nullptr);
+      if (pin.empty() || pin.checkedEntry()->isShared()) {
+        continue;
+      }
+      pin.checkedEntry()->setPrefetch();
+      loads[&file].push_back(
+          {std::move(ssdPin), std::move(pin), entry.numUses});
+    }
+    for (auto& [file, fileLoads] : loads) {
+      std::sort(
+          fileLoads.begin(), fileLoads.end(), [](auto& left, auto& right) {
+            return left.ssdPin.run().offset() < right.ssdPin.run().offset();
+          });
+      std::vector<SsdPin> ssdPins;
+      std::vector<CachePin> pins;
+      for (auto& load : fileLoads) {
+        ssdPins.push_back(std::move(load.ssdPin));
+        pins.push_back(std::move(load.pin));
+      }
+      try {
+        file->load(ssdPins, pins);
+      } catch (const std::exception& e) {
+        // The exclusive pins are dropped without data.
+        LOG(WARNING) << "Error in loading hot set from SSD: " << e.what();
+        continue;
+      }
+      for (auto i = 0; i < pins.size(); ++i) {
+        auto entry = pins[i].checkedEntry();
+        entry->setExclusiveToShared();
+        entry->restoreNumUses(fileLoads[i].numUses);
+        bytes += entry->size();
+      }
+    }
+    // Sleeps as long as the bytes so far are ahead of the rate.
+    if (maxBytesPerSecond) {
+      auto targetMicros = bytes * 1'000'000 / maxBytesPerSecond;
+      auto elapsedMicros = getCurrentTimeMicro() - startMicros;
+      if (targetMicros > elapsedMicros) {
+        std::this_thread::sleep_for(
+            std::chrono::microseconds(targetMicros - elapsedMicros)); // NOLINT
+      }
+    }
+  }
+  LOG(INFO) << fmt::format(
+      "Loaded {}MB of hot set from SSD in {}ms",
+      bytes >> 20,
+      (getCurrentTimeMicro() - startMicros) / 1000);
+  return bytes;
+}
+
+void AsyncDataCache::shutdown() {
+  if (!ssdCache_) {
+    return;
+  }
+  // Entries not written because a write is in progress are not in the
+  // hot set.
+  if (ssdCache_->startWrite()) {
+    saveToSsd();
+  }
+  ssdCache_->shutdown();
+  saveHotSet();
+}
+
+CacheResidency AsyncDataCache::residency(
+    const std::vector<FileByteRange>& ranges) const {
+  CacheResidency residency;
+  for (auto& range : ranges) {
+    residency.bytes += range.size;
+    auto fileNum = fileIds().id(range.fileName);
+    if (fileNum == StringIdMap::kNoId) {
+      continue;
+    }
+    uint64_t ramBytes = 0;
+    for (auto& shard : shards_) {
+      ramBytes += shard->cachedBytes(fileNum, range.offset, range.size);
+    }
+    residency.ramBytes += std::min(ramBytes, range.size);
+    if (ssdCache_) {
+      residency.ssdBytes +=
+          ssdCache_->cachedBytes(fileNum, range.offset, range.size);
+    }
+  }
+  return residency;
+}
+
+CacheLocalitySummary AsyncDataCache::localitySummary(uint64_t minBytes) const {
+  GranuleBytes granules;
+  for (auto& shard : shards_) {
+    shard->addGranules(granules);
+  }
+  if (ssdCache_) {
+    ssdCache_->addGranules(granules);
+  }
+  std::vector<std::pair<uint64_t, uint64_t>> warm;
+  granules.forEach([&](auto fileNum, auto granule, auto bytes) {
+    if (static_cast<uint64_t>(bytes) >= minBytes) {
+      warm.emplace_back(fileNum, granule);
+    }
+  });
+  CacheLocalitySummary summary(warm.size());
+  for (auto& [fileNum, granule] : warm) {
+    auto name = fileIds().string(fileNum);
+    if (!name.empty()) {
+      summary.add(name, granule);
+    }
+  }
+  return summary;
+}
+
 CacheStats AsyncDataCache::refreshStats() const {
   CacheStats stats;
   for (auto& shard : shards_) {
     shard->updateStats(stats);
   }
+  for (auto i = 0; i < kMaxPools; ++i) {
+    auto& pool = pools_[i];
+    if (!pool.sharePercent && !pool.numNew) {
+      continue;
+    }
+    CachePoolStats poolStats;
+    poolStats.poolId = i;
+    poolStats.sharePercent = pool.sharePercent;
+    poolStats.cachedBytes = pool.cachedBytes;
+    poolStats.numHit = pool.numHit;
+    poolStats.numNew = pool.numNew;
+    poolStats.numEvict = pool.numEvict;
+    stats.pools.push_back(poolStats);
+  }
   return stats;
 }
 
+void AsyncDataCache::setPoolShare(int32_t poolId, int32_t sharePercent) {
+  VELOX_CHECK_GE(poolId, 0);
+  VELOX_CHECK_LT(poolId, kMaxPools);
+  VELOX_CHECK_GE(sharePercent, 0);
+  VELOX_CHECK_LE(sharePercent, 100);
+  pools_[poolId].sharePercent = sharePercent;
+  hasPoolShares_ = true;
+}
+
+uint32_t AsyncDataCache::poolsOverShare() const {
+  if (!hasPoolShares_) {
+    return 0;
+  }
+  uint32_t mask = 0;
+  for (auto i = 0; i < kMaxPools; ++i) {
+    auto& pool = pools_[i];
+    if (pool.cachedBytes > maxBytes_ / 100 * pool.sharePercent) {
+      mask |= 1u << i;
+    }
+  }
+  return mask;
+}
+
 void AsyncDataCache::clear() {
   for (auto& shard : shards_) {
     shard->evict(std::numeric_limits<int32_t>::max(), true);
@@ -674,12 +1467,21 @@ std::string AsyncDataCache::toString() const {
           stats.largePadding
       << " / " << maxBytes_ << " bytes\n"
       << "Miss: " << stats.numNew << " Hit " << stats.numHit << " evict "
-      << stats.numEvict << "\n"
+      << stats.numEvict << " rejected " << stats.numRejected << " compress "
+      << stats.numCompress << " decompress " << stats.numDecompress << " ("
+      << stats.numCompressed << " compressed entries, "
+      << (stats.compressedSize >> 20) << "MB)\n"
       << " read pins " << stats.numShared << " write pins "
       << stats.numExclusive << " unused prefetch " << stats.numPrefetch
       << " Alloc Megaclocks " << (stats.allocClocks >> 20)
       << " allocated pages " << numAllocated() << " cached pages "
       << cachedPages_;
+  for (auto& pool : stats.pools) {
+    out << "\nPool " << pool.poolId << ": share " << pool.sharePercent
+        << "% " << (pool.cachedBytes >> 20) << "MB hit " << pool.numHit
+        << " miss " << pool.numNew << " evict " << pool.numEvict;
+  }
+  out << "\n" << accessStats_.toString(5);
   out << "\nBacking: " << mappedMemory_->toString();
   if (ssdCache_) {
     out << "\nSSD: " << ssdCache_->toString();
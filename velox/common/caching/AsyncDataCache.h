@@ -16,15 +16,21 @@
 
 #pragma once
 
+#include <array>
 #include <deque>
 
 #include <fmt/format.h>
+#include <folly/Executor.h>
 #include <folly/chrono/Hardware.h>
+#include <folly/concurrency/ConcurrentHashMap.h>
 #include <folly/futures/SharedPromise.h>
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CoalesceIo.h"
 #include "velox/common/base/SelectivityInfo.h"
+#include "velox/common/caching/CacheAccessStats.h"
+#include "velox/common/caching/CacheResidency.h"
 #include "velox/common/caching/FileGroupStats.h"
+#include "velox/common/caching/FrequencySketch.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/caching/StringIdMap.h"
 #include "velox/common/file/File.h"
@@ -34,6 +40,7 @@ namespace facebook::velox::cache {
 
 class AsyncDataCache;
 class CacheShard;
+class PrefetchScheduler;
 class SsdCache;
 class SsdFile;
 
@@ -119,6 +126,28 @@ struct hash<::facebook::velox::cache::RawFileCacheKey> {
 
 namespace facebook::velox::cache {
 
+// Per-query policy for admitting new entries into the RAM and SSD tiers
+// of the cache. The default admits every entry to RAM and leaves SSD
+// admission to FileGroupStats.
+struct CacheAdmission {
+  // If true and the cache is near capacity, a new entry whose estimated
+  // access frequency is below that of the next eviction candidate is
+  // rejected: it is loaded and read as usual but is dropped when its last
+  // pin is released, unless it is hit again before that. A prefetched
+  // entry is dropped after its first use. This keeps one-off scans from
+  // flushing frequently used data.
+  bool frequencyFilter{false};
+
+  // Estimated number of accesses an entry needs before it is written to
+  // SSD. 0 means no minimum.
+  int32_t minSsdHits{0};
+
+  // Cache pool, e.g. tenant, that new entries are accounted to. See
+  // AsyncDataCache::setPoolShare(). Must be less than
+  // AsyncDataCache::kMaxPools.
+  int32_t poolId{0};
+};
+
 // Represents a contiguous range of bytes cached from a file. This
 // is the primary unit of access. These are typically owned via
 // CachePin and can be in shared or exclusive mode. 'numPins_'
@@ -129,7 +158,9 @@ namespace facebook::velox::cache {
 // time. The CacheShard serializes the mapping from a key to the
 // entry and the setting entries to exclusive mode. An unpinned
 // entry is evictable. CacheShard decides the eviction policy and
-// serializes eviction with other access.
+// serializes eviction with other access. A hit may add a shared pin
+// without the shard mutex, so the transition from unpinned to
+// exclusive is a compare and swap of 'numPins_'.
 class AsyncDataCacheEntry {
  public:
   static constexpr int32_t kExclusive = -10000;
@@ -172,6 +203,7 @@ class AsyncDataCacheEntry {
 
   void touch() {
     accessStats_.touch();
+    numIdleRounds_ = 0;
   }
 
   int32_t score(AccessTime now) const {
@@ -186,6 +218,12 @@ class AsyncDataCacheEntry {
     return numPins_ == kExclusive;
   }
 
+  // True if 'data_' holds the LZ4 compressed contents. A pinned entry is
+  // never compressed.
+  bool isCompressed() const {
+    return compressedSize_ != 0;
+  }
+
   int32_t numPins() const {
     return numPins_;
   }
@@ -231,12 +269,48 @@ class AsyncDataCacheEntry {
     groupId_ = groupId;
   }
 
+  // The cache pool of the query that created 'this'. See
+  // CacheAdmission::poolId.
+  int32_t poolId() const {
+    return poolId_;
+  }
+
+  // False if the admission filter rejected 'this'. See CacheAdmission.
+  bool isAdmitted() const {
+    return isAdmitted_;
+  }
+
+  // Sets the use count to one saved before a restart. The last use is
+  // now. See AsyncDataCache::loadHotSet().
+  void restoreNumUses(int32_t numUses) {
+    accessStats_.lastUse = accessTime();
+    accessStats_.numUses = numUses;
+  }
+
   std::string toString() const;
 
  private:
   void release();
   void addReference();
 
+  // Allocates 'data_' or 'tinyData_' for 'size_' bytes. On failure, removes
+  // 'this' from 'shard_', unpins and throws kNoCacheSpace.
+  void allocateData();
+
+  // Replaces 'data_' with an LZ4 compressed copy if this saves at least a
+  // quarter of the pages. 'this' must be exclusive. Returns false if
+  // 'data_' could not be reallocated and the contents are lost.
+  bool compress();
+
+  // Restores the contents of a compressed 'this'. 'this' must be
+  // exclusive. Throws like allocateData().
+  void decompress();
+
+  // Marks 'this' for saving to SSD if it is not already there and
+  // the SSD admission criteria are met. Must be called outside of the
+  // mutex of 'shard_'.
+  void checkSsdSaveable();
+
   // Returns a future that will be realized when a caller can retry
   // getting 'this'. Must be called inside the mutex of 'shard_'.
   folly::SemiFuture<bool> getFuture() {
@@ -295,6 +369,25 @@ class AsyncDataCacheEntry {
   // True if this should be saved to SSD.
   bool ssdSaveable_{false};
 
+  // False if the frequency filter rejected 'this' at creation. Set to
+  // true on the next hit.
+  bool isAdmitted_{true};
+
+  // See CacheAdmission::minSsdHits.
+  int32_t minSsdHits_{0};
+
+  // See CacheAdmission::poolId.
+  int32_t poolId_{0};
+
+  // Size of the LZ4 compressed contents in 'data_' if compressed, else 0.
+  int32_t compressedSize_{0};
+
+  // Passes of the eviction clock over 'this' since the last touch().
+  int32_t numIdleRounds_{0};
+
+  // True if compress() did not make 'this' smaller.
+  bool isIncompressible_{false};
+
   friend class CacheShard;
   friend class CachePin;
 };
@@ -400,6 +493,12 @@ class CoalescedLoad {
   // the other thread to be done if 'wait' is true.
   bool loadOrFuture(folly::SemiFuture<bool>* FOLLY_NULLABLE wait);
 
+  // Starts a prefetch with loadDataAsync() and returns without waiting for
+  // the IO if the storage supports asynchronous reads. The SemiFuture is
+  // realized when the load is finished or cancelled. The caller must keep
+  // 'this' alive until then.
+  folly::SemiFuture<bool> loadAsync();
+
   LoadState state() const {
     return state_;
   }
@@ -408,6 +507,15 @@ class CoalescedLoad {
     setEndState(LoadState::kCancelled);
   }
 
+  // Total bytes of the entries of 'this'.
+  int64_t size() const {
+    int64_t size = 0;
+    for (auto entrySize : sizes_) {
+      size += entrySize;
+    }
+    return size;
+  }
+
   virtual std::string toString() const {
     return "<CoalescedLoad>";
   }
@@ -422,6 +530,14 @@ class CoalescedLoad {
   // users of the cache.
   virtual std::vector<CachePin> loadData(bool isPrefetch) = 0;
 
+  // Like loadData() but the returned pins may still be loading. They are
+  // valid when the SemiFuture is realized. The default is synchronous.
+  virtual folly::SemiFuture<std::vector<CachePin>> loadDataAsync(
+      bool isPrefetch);
+
+  // Makes the exclusive 'pins' shared and sets the end state.
+  void finishLoad(std::vector<CachePin>& pins);
+
   // Sets a final state and resumes waiting threads.
   void setEndState(LoadState endState);
 
@@ -437,6 +553,21 @@ class CoalescedLoad {
   std::vector<int32_t> sizes_;
 };
 
+// Counters of a cache pool. See AsyncDataCache::setPoolShare().
+struct CachePoolStats {
+  int32_t poolId{};
+  // Share of the cache capacity in percent. 0 if not set.
+  int32_t sharePercent{};
+  // Total size of the entries of the pool.
+  int64_t cachedBytes{};
+  // Number of hits on entries of the pool.
+  int64_t numHit{};
+  // Number of entries created for the pool.
+  int64_t numNew{};
+  // Number of entries of the pool evicted to make space.
+  int64_t numEvict{};
+};
+
 // Struct for CacheShard stats. Stats from all shards are added into
 // this struct to provide a snapshot of state.
 struct CacheStats {
@@ -479,7 +610,33 @@ struct CacheStats {
   // Sum of scores of evicted entries. This serves to infer an average
   // lifetime for entries in cache.
   int64_t sumEvictScore{};
+  // Number of new entries rejected by the frequency filter.
+  int64_t numRejected{};
+  // Number of entries held LZ4 compressed.
+  int32_t numCompressed{};
+  // Total compressed size of the compressed entries.
+  int64_t compressedSize{};
+  // Number of times an entry was compressed instead of evicted.
+  int64_t numCompress{};
+  // Number of hits that decompressed an entry.
+  int64_t numDecompress{};
+  // Stats of the pools that have a share or have had entries. Set by
+  // AsyncDataCache::refreshStats().
+  std::vector<CachePoolStats> pools;
 };
+
+// An SSD backed entry of the hot set of AsyncDataCache. See
+// AsyncDataCache::saveHotSet().
+struct HotSetEntry {
+  uint64_t fileNum;
+  uint64_t offset;
+  int32_t size;
+  int32_t numUses;
+  // Retention score at the time of collection. Not persisted since
+  // access times are not comparable across restarts.
+  int32_t score;
+};
+
 // Collection of cache entries whose key hashes to the same shard of
 // the hash number space.  The cache population is divided into shards
 // to decrease contention on the mutex for the key to entry mapping
@@ -490,11 +647,16 @@ class CacheShard {
 
   explicit CacheShard(AsyncDataCache* FOLLY_NONNULL cache) : cache_(cache) {}
 
-  // See AsyncDataCache::findOrCreate.
+  // See AsyncDataCache::findOrCreate. Hits on entries that are
+  // ready for reading do not take 'mutex_'.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* FOLLY_NULLABLE readyFuture);
+      folly::SemiFuture<bool>* FOLLY_NULLABLE readyFuture,
+      const CacheAdmission& admission);
+
+  // Returns the estimated number of recent accesses to 'key'.
+  int32_t estimateFrequency(RawFileCacheKey key) const;
 
   // Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
@@ -516,6 +678,10 @@ class CacheShard {
   // Removes 'entry' from 'this'.
   void removeEntry(AsyncDataCacheEntry* FOLLY_NONNULL entry);
 
+  // Removes 'entry' if it is unpinned and was rejected by the frequency
+  // filter. Called when the last pin of 'entry' is released.
+  void removeRejected(AsyncDataCacheEntry* FOLLY_NONNULL entry);
+
   // Adds the stats of 'this' to 'stats'.
   void updateStats(CacheStats& stats);
 
@@ -526,13 +692,54 @@ class CacheShard {
   // calling this a second time.
   void appendSsdSaveable(std::vector<CachePin>& pins);
 
+  // Appends the unpinned or shared SSD backed entries that have been hit
+  // at least once to 'entries'.
+  void appendHotSet(AccessTime now, std::vector<HotSetEntry>& entries);
+
+  // Returns the bytes of the entries of 'this' in the granules of
+  // [offset, offset + size) of 'fileNum'. See GranuleBytes.
+  uint64_t cachedBytes(uint64_t fileNum, uint64_t offset, uint64_t size)
+      const;
+
+  // Adds the bytes by granule of 'this' to 'granules'.
+  void addGranules(GranuleBytes& granules) const;
+
   auto& allocClocks() {
     return allocClocks_;
   }
 
  private:
   static constexpr int32_t kNoThreshold = std::numeric_limits<int32_t>::max();
+  // Counters in 'frequencies_'. 4 bits each.
+  static constexpr int32_t kNumFrequencyCounters = 64 << 10;
+  // Number of entries after the clock hand checked for an eviction
+  // candidate to compare a new entry to.
+  static constexpr int32_t kNumVictimChecks = 8;
+
   void calibrateThreshold();
+
+  // Returns a shared pin on the entry of 'key' without taking 'mutex_'
+  // if the entry is readable, has at least 'size' bytes and needs no
+  // state change on hit. Returns an empty pin otherwise.
+  CachePin findWithoutLock(RawFileCacheKey key, uint64_t size);
+
+  // Sets an unpinned 'entry' to exclusive. Returns false if 'entry' is
+  // pinned, possibly by a concurrent findWithoutLock().
+  static bool tryMakeExclusive(AsyncDataCacheEntry& entry) {
+    int32_t expected = 0;
+    return entry.numPins_.compare_exchange_strong(
+        expected, AsyncDataCacheEntry::kExclusive);
+  }
+
+  // Returns true if the next eviction candidate has a higher estimated
+  // frequency than 'hash'.
+  bool isVictimMoreFrequentLocked(uint64_t hash);
+
+  // Compresses 'entries' outside of 'mutex_' and makes them unpinned. The
+  // entries are exclusive. Entries whose contents are lost are removed.
+  void compressEntries(
+      const std::vector<AsyncDataCacheEntry * FOLLY_NONNULL>& entries);
+
   void removeEntryLocked(AsyncDataCacheEntry* FOLLY_NONNULL entry);
   // Returns an unused entry if found. 'size' is a hint for selecting an entry
   // that already has the right amount of memory associated with it.
@@ -542,7 +749,11 @@ class CacheShard {
       AsyncDataCacheEntry* FOLLY_NONNULL entry);
 
   mutable std::mutex mutex_;
-  folly::F14FastMap<RawFileCacheKey, AsyncDataCacheEntry * FOLLY_NONNULL>
+  // Modified inside 'mutex_' and read without. An entry found here may
+  // have been evicted or reused for another key unless pinned.
+  folly::ConcurrentHashMap<
+      RawFileCacheKey,
+      AsyncDataCacheEntry * FOLLY_NONNULL>
       entryMap_;
   // Entries associated to a key.
   std::deque<std::unique_ptr<AsyncDataCacheEntry>> entries_;
@@ -555,11 +766,11 @@ class CacheShard {
   // Index in 'entries_' for the next eviction candidate.
   uint32_t clockHand_{};
   // Number of gets  since last stats sampling.
-  uint32_t eventCounter_{};
+  std::atomic<uint32_t> eventCounter_{};
   // Maximum retainable entry score(). Anything above this is evictable.
   int32_t evictionThreshold_{kNoThreshold};
   // Cumulative count of cache hits.
-  uint64_t numHit_{};
+  std::atomic<uint64_t> numHit_{};
   // Cumulative count of hits on entries held in exclusive mode.
   uint64_t numWaitExclusive_{};
   // Cumulative count of new entry creation.
@@ -575,15 +786,32 @@ class CacheShard {
   // Tracker of time spent in allocating/freeing MappedMemory space
   // for backing cached data.
   std::atomic<uint64_t> allocClocks_;
+  // Access frequencies of keys that hash to 'this', including keys that
+  // are not or no longer cached.
+  FrequencySketch frequencies_{kNumFrequencyCounters};
+  // Count of new entries rejected by the frequency filter.
+  uint64_t numRejected_{};
+  // Count of entries compressed instead of evicted.
+  uint64_t numCompress_{};
+  // Count of hits on compressed entries.
+  uint64_t numDecompress_{};
+  // Sizes of the entries with a key by file granule.
+  GranuleBytes granules_;
 };
 
 class AsyncDataCache : public memory::MappedMemory {
  public:
+  // Number of cache pools. See setPoolShare().
+  static constexpr int32_t kMaxPools = 32;
+
   AsyncDataCache(
       const std::shared_ptr<memory::MappedMemory>& mappedMemory,
       uint64_t maxBytes,
       std::unique_ptr<SsdCache> ssdCache = nullptr);
 
+  // Waits for a background eviction to finish.
+  ~AsyncDataCache() override;
+
   // Finds or creates a cache entry corresponding to 'key'. The entry
   // is returned in 'pin'. If the entry is new, it is pinned in
   // exclusive mode and its 'data_' has uninitialized space for at
@@ -594,11 +822,13 @@ class AsyncDataCache : public memory::MappedMemory {
   // future that is realized when the pin is no longer exclusive. When
   // the future is realized, the caller may retry findOrCreate().
   // runtime error with code kNoCacheSpace if there is no space to create the
-  // new entry after evicting any unpinned content.
+  // new entry after evicting any unpinned content. 'admission' decides
+  // whether a new entry is retained and saved to SSD.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* FOLLY_NULLABLE waitFuture = nullptr);
+      folly::SemiFuture<bool>* FOLLY_NULLABLE waitFuture = nullptr,
+      const CacheAdmission& admission = CacheAdmission());
 
   // Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
@@ -658,10 +888,99 @@ class AsyncDataCache : public memory::MappedMemory {
     return maxBytes_;
   }
 
+  // True if the cached data fills at least 90% of 'maxBytes_'. The
+  // frequency filter applies only then.
+  bool nearCapacity() const {
+    return cachedPages_ * memory::MappedMemory::kPageSize >=
+        maxBytes_ / 10 * 9;
+  }
+
   SsdCache* FOLLY_NULLABLE ssdCache() const {
     return ssdCache_.get();
   }
 
+  // Sets the number of passes of the eviction clock without a hit after
+  // which an entry that is due for eviction is compressed with LZ4
+  // instead. Compressed entries are decompressed when hit and evicted
+  // when due for eviction again. 0 disables compression.
+  void setCompressAfterRounds(int32_t numRounds) {
+    compressAfterRounds_ = numRounds;
+  }
+
+  int32_t compressAfterRounds() const {
+    return compressAfterRounds_;
+  }
+
+  // Sets an executor for evicting ahead of need. When an allocation
+  // leaves less than kEvictHeadroomPercent of 'maxBytes_' free, a batch
+  // on 'executor' evicts from all shards until twice that is free.
+  // Allocation still evicts on the allocating thread if the background
+  // falls behind. 'executor' must outlive 'this'.
+  void setEvictExecutor(folly::Executor* FOLLY_NULLABLE executor) {
+    evictExecutor_ = executor;
+  }
+
+  // Number of background eviction batches. For testing.
+  uint64_t numBackgroundEvicts() const {
+    return numBackgroundEvicts_;
+  }
+
+  // Sets the share of 'maxBytes_' in percent that pool 'poolId' keeps
+  // under eviction. Entries belong to the pool of the CacheAdmission they
+  // were created with. While any pool holds more than its share, eviction
+  // passes over the entries of the pools within their share, so that a
+  // heavy pool evicts its own entries before the hot set of another. Pools
+  // without a share have a share of 0. If no pool has a share, eviction
+  // disregards pools. Allocation failures evict regardless of pools.
+  void setPoolShare(int32_t poolId, int32_t sharePercent);
+
+  // Returns a bit mask of the pools holding more than their share. 0 if no
+  // pool has a share.
+  uint32_t poolsOverShare() const;
+
+  // Counters of the entries of 'poolId', see CachePoolStats.
+  void incrementPoolBytes(int32_t poolId, int64_t bytes) {
+    pools_[poolId].cachedBytes += bytes;
+  }
+
+  void incrementPoolHits(int32_t poolId) {
+    ++pools_[poolId].numHit;
+  }
+
+  void incrementPoolNew(int32_t poolId) {
+    ++pools_[poolId].numNew;
+  }
+
+  void incrementPoolEvicts(int32_t poolId) {
+    ++pools_[poolId].numEvict;
+  }
+
+  // Hits and misses by file group and stream, recorded by the readers of
+  // 'this'.
+  CacheAccessStats& accessStats() {
+    return accessStats_;
+  }
+
+  // Sets a node wide scheduler that starts the prefetches of all readers
+  // of 'this' within a common budget of IO in flight. If not set, readers
+  // start their prefetches directly on their executor. 'scheduler' must
+  // outlive the readers of 'this'.
+  void setPrefetchScheduler(PrefetchScheduler* FOLLY_NULLABLE scheduler) {
+    prefetchScheduler_ = scheduler;
+  }
+
+  PrefetchScheduler* FOLLY_NULLABLE prefetchScheduler() const {
+    return prefetchScheduler_;
+  }
+
+  // Allocates from the backing MappedMemory without evicting. Used for
+  // replacing the data of an entry with a smaller copy during eviction.
+  bool allocateWithoutEvict(
+      memory::MachinePageCount numPages,
+      Allocation& out) {
+    return mappedMemory_->allocate(numPages, CacheShard::kCacheOwner, out);
+  }
+
   // Updates stats for creation of a new cache entry of 'size' bytes,
   // i.e. a cache miss. Periodically updates SSD admission criteria,
   // i.e. reconsider criteria every half cache capacity worth of misses.
@@ -692,9 +1011,10 @@ class AsyncDataCache : public memory::MappedMemory {
   void makePins(
       const std::vector<RawFileCacheKey>& keys,
       SizeFunc sizeFunc,
-      ProcessPin processPin) {
+      ProcessPin processPin,
+      const CacheAdmission& admission = CacheAdmission()) {
     for (auto i = 0; i < keys.size(); ++i) {
-      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr);
+      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr, admission);
       if (pin.empty() || pin.checkedEntry()->isShared()) {
         continue;
       }
@@ -708,6 +1028,36 @@ class AsyncDataCache : public memory::MappedMemory {
   // Saves all entries with 'ssdSaveable_' to 'ssdCache_'.
   void saveToSsd();
 
+  // Writes the keys and use counts of the at most 'maxEntries' most
+  // valuable SSD backed entries to the hot set file next to the files
+  // of 'ssdCache_'. A restarted process that recovers the SSD cache from
+  // checkpoint brings these back to RAM with loadHotSet(). No-op
+  // without 'ssdCache_'.
+  void saveHotSet(int32_t maxEntries = kDefaultHotSetEntries);
+
+  // Loads the entries of the hot set saved by saveHotSet() from SSD to
+  // RAM in the background, most valuable first, reading at most
+  // 'maxBytesPerSecond'. Entries no longer on SSD are skipped and
+  // loading stops before the cache would have to evict. The returned
+  // future is realized with the loaded bytes when done. A server should
+  // wait for this before accepting queries.
+  folly::SemiFuture<uint64_t> loadHotSet(uint64_t maxBytesPerSecond);
+
+  // Writes pending SSD saveable entries, waits for the writes to
+  // finish, checkpoints 'ssdCache_' and saves the hot set.
+  void shutdown();
+
+  // Returns how much of 'ranges' is cached in RAM and on SSD. The
+  // accounting is by 8MB granules of the files, see GranuleBytes, so that
+  // the cost is a few hash lookups per granule of 'ranges' and not
+  // proportional to the number of cached entries.
+  CacheResidency residency(const std::vector<FileByteRange>& ranges) const;
+
+  // Returns a summary of the granules that have at least 'minBytes' cached
+  // in RAM or on SSD. A node can publish this periodically for soft
+  // affinity scheduling. Visits all granules of the cache.
+  CacheLocalitySummary localitySummary(uint64_t minBytes) const;
+
   int32_t& numSkippedSaves() {
     return numSkippedSaves_;
   }
@@ -716,13 +1066,40 @@ class AsyncDataCache : public memory::MappedMemory {
     return mappedMemory_->stats();
   }
 
+  void flushThreadCache() override {
+    mappedMemory_->flushThreadCache();
+  }
+
  private:
   static constexpr int32_t kNumShards = 4; // Must be power of 2.
   static constexpr int32_t kShardMask = kNumShards - 1;
+  static constexpr int32_t kDefaultHotSetEntries = 100000;
+  static constexpr int32_t kEvictHeadroomPercent = 2;
+  // Entries loaded from SSD by one loadHotSet() batch.
+  static constexpr int32_t kHotSetBatch = 64;
+  // 4 first bytes of a hot set file.
+  static constexpr const char* FOLLY_NONNULL kHotSetMagic = "HOT1";
+  static constexpr uint64_t kHotSetMapMarker = 0xfffffffffffffffe;
+  static constexpr uint64_t kHotSetEndMarker = 0xcbedf11e;
+
+  // Path of the hot set file.
+  std::string hotSetPath() const;
+
+  // Loads 'entries' from 'ssdCache_'. See loadHotSet().
+  uint64_t loadHotSetEntries(
+      const std::vector<HotSetEntry>& entries,
+      uint64_t maxBytesPerSecond);
 
   // Waits a pseudorandom delay times 'counter'.
   void backoff(int32_t counter);
 
+  // Schedules a background eviction on 'evictExecutor_' if the free
+  // space is under the headroom and no eviction is running.
+  void maybeEvictInBackground();
+
+  // Evicts from all shards until twice the headroom is free.
+  void evictInBackground();
+
   // Calls 'allocate' until this returns true. Returns true if
   // allocate returns true. and Tries to evict at least 'numPages' of
   // cache after each failed call to 'allocate'.  May pause to wait
@@ -770,6 +1147,34 @@ class AsyncDataCache : public memory::MappedMemory {
   // Counter of threads competing for allocation in makeSpace(). Used
   // for setting staggered backoff. Mutexes are not allowed for this.
   std::atomic<int32_t> numThreadsInAllocate_{0};
+
+  // See setCompressAfterRounds().
+  std::atomic<int32_t> compressAfterRounds_{0};
+
+  // See setEvictExecutor().
+  folly::Executor* FOLLY_NULLABLE evictExecutor_{nullptr};
+  // True while a background eviction is scheduled or running.
+  std::atomic<bool> isEvicting_{false};
+  std::atomic<uint64_t> numBackgroundEvicts_{0};
+
+  // See setPrefetchScheduler().
+  PrefetchScheduler* FOLLY_NULLABLE prefetchScheduler_{nullptr};
+
+  // See accessStats().
+  CacheAccessStats accessStats_;
+
+  struct PoolCounters {
+    std::atomic<int32_t> sharePercent{0};
+    std::atomic<int64_t> cachedBytes{0};
+    std::atomic<int64_t> numHit{0};
+    std::atomic<int64_t> numNew{0};
+    std::atomic<int64_t> numEvict{0};
+  };
+
+  // Indexed by pool id. See setPoolShare().
+  std::array<PoolCounters, kMaxPools> pools_;
+  // True after the first setPoolShare().
+  std::atomic<bool> hasPoolShares_{false};
 };
 
 // Samples a set of values T from 'numSamples' calls of
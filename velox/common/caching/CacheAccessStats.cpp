@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/CacheAccessStats.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include <fmt/format.h>
+#include "velox/common/base/StatsReporter.h"
+
+namespace facebook::velox::cache {
+
+namespace {
+constexpr folly::StringPiece kRamHitBytes{"velox.cache_ram_hit_bytes"};
+constexpr folly::StringPiece kSsdHitBytes{"velox.cache_ssd_hit_bytes"};
+constexpr folly::StringPiece kStorageReadBytes{
+    "velox.cache_storage_read_bytes"};
+constexpr folly::StringPiece kNumRamHits{"velox.cache_num_ram_hits"};
+constexpr folly::StringPiece kNumSsdHits{"velox.cache_num_ssd_hits"};
+constexpr folly::StringPiece kNumStorageReads{"velox.cache_num_storage_reads"};
+constexpr folly::StringPiece kSsdLatencyP50{"velox.cache_ssd_latency_us_p50"};
+constexpr folly::StringPiece kSsdLatencyP99{"velox.cache_ssd_latency_us_p99"};
+constexpr folly::StringPiece kStorageLatencyP50{
+    "velox.cache_storage_latency_us_p50"};
+constexpr folly::StringPiece kStorageLatencyP99{
+    "velox.cache_storage_latency_us_p99"};
+// Histograms of the latency of each load.
+constexpr folly::StringPiece kSsdLatency{"velox.cache_ssd_latency_us"};
+constexpr folly::StringPiece kStorageLatency{"velox.cache_storage_latency_us"};
+
+void registerStats() {
+  for (auto key :
+       {kRamHitBytes,
+        kSsdHitBytes,
+        kStorageReadBytes,
+        kNumRamHits,
+        kNumSsdHits,
+        kNumStorageReads}) {
+    REPORT_ADD_STAT_EXPORT_TYPE(key, StatType::SUM);
+  }
+  for (auto key :
+       {kSsdLatencyP50,
+        kSsdLatencyP99,
+        kStorageLatencyP50,
+        kStorageLatencyP99}) {
+    REPORT_ADD_STAT_EXPORT_TYPE(key, StatType::AVG);
+  }
+  for (auto key : {kSsdLatency, kStorageLatency}) {
+    REPORT_ADD_STAT_EXPORT_TYPE(key, StatType::HISTOGRAM);
+  }
+}
+
+void ensureStatsRegistered() {
+  static std::once_flag registered;
+  std::call_once(registered, registerStats);
+}
+} // namespace
+
+void LatencyHistogram::record(uint64_t micros) {
+  int32_t bucket =
+      micros ? std::min<int32_t>(kNumBuckets - 1, 64 - __builtin_clzll(micros))
+             : 0;
+  ++buckets[bucket];
+  ++count;
+  sumMicros += micros;
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other) {
+  for (auto i = 0; i < kNumBuckets; ++i) {
+    buckets[i] += other.buckets[i];
+  }
+  count += other.count;
+  sumMicros += other.sumMicros;
+}
+
+void LatencyHistogram::subtract(const LatencyHistogram& other) {
+  for (auto i = 0; i < kNumBuckets; ++i) {
+    buckets[i] -= other.buckets[i];
+  }
+  count -= other.count;
+  sumMicros -= other.sumMicros;
+}
+
+uint64_t LatencyHistogram::percentile(int32_t pct) const {
+  if (!count) {
+    return 0;
+  }
+  // The rank of the percentile, rounded up and at least 1.
+  auto rank = std::max<uint64_t>(1, (count * pct + 99) / 100);
+  uint64_t seen = 0;
+  for (auto i = 0; i < kNumBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return i ? 1UL << i : 0;
+    }
+  }
+  return 1UL << (kNumBuckets - 1);
+}
+
+void CacheAccessCounters::add(const CacheAccessCounters& other) {
+  numRam += other.numRam;
+  ramBytes += other.ramBytes;
+  numSsd += other.numSsd;
+  ssdBytes += other.ssdBytes;
+  numStorage += other.numStorage;
+  storageBytes += other.storageBytes;
+  ssdLatency.add(other.ssdLatency);
+  storageLatency.add(other.storageLatency);
+}
+
+void CacheAccessCounters::subtract(const CacheAccessCounters& other) {
+  numRam -= other.numRam;
+  ramBytes -= other.ramBytes;
+  numSsd -= other.numSsd;
+  ssdBytes -= other.ssdBytes;
+  numStorage -= other.numStorage;
+  storageBytes -= other.storageBytes;
+  ssdLatency.subtract(other.ssdLatency);
+  storageLatency.subtract(other.storageLatency);
+}
+
+void CacheAccessStats::record(
+    uint64_t groupId,
+    TrackingId trackingId,
+    CacheSource source,
+    uint64_t bytes,
+    uint64_t latencyMicros) {
+  if (source != CacheSource::kRam) {
+    ensureStatsRegistered();
+  }
+  if (source == CacheSource::kSsd) {
+    REPORT_ADD_STAT_VALUE(kSsdLatency, latencyMicros);
+  } else if (source == CacheSource::kStorage) {
+    REPORT_ADD_STAT_VALUE(kStorageLatency, latencyMicros);
+  }
+  Key key{groupId, trackingId.id()};
+  auto& shard = shards_[KeyHasher()(key) % kNumShards];
+  std::lock_guard<std::mutex> l(shard.mutex);
+  auto& counters = shard.counters[key];
+  switch (source) {
+    case CacheSource::kRam:
+      ++counters.numRam;
+      counters.ramBytes += bytes;
+      break;
+    case CacheSource::kSsd:
+      ++counters.numSsd;
+      counters.ssdBytes += bytes;
+      counters.ssdLatency.record(latencyMicros);
+      break;
+    case CacheSource::kStorage:
+      ++counters.numStorage;
+      counters.storageBytes += bytes;
+      counters.storageLatency.record(latencyMicros);
+      break;
+  }
+}
+
+std::vector<CacheAccessStats::Entry> CacheAccessStats::snapshot() const {
+  std::vector<Entry> entries;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> l(shard.mutex);
+    for (auto& [key, counters] : shard.counters) {
+      entries.push_back({key.groupId, TrackingId(key.trackingId), counters});
+    }
+  }
+  return entries;
+}
+
+CacheAccessCounters CacheAccessStats::groupCounters(uint64_t groupId) const {
+  CacheAccessCounters sum;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> l(shard.mutex);
+    for (auto& [key, counters] : shard.counters) {
+      if (key.groupId == groupId) {
+        sum.add(counters);
+      }
+    }
+  }
+  return sum;
+}
+
+CacheAccessCounters CacheAccessStats::total() const {
+  CacheAccessCounters sum;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> l(shard.mutex);
+    for (auto& [key, counters] : shard.counters) {
+      sum.add(counters);
+    }
+  }
+  return sum;
+}
+
+void CacheAccessStats::clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> l(shard.mutex);
+    shard.counters.clear();
+  }
+  std::lock_guard<std::mutex> l(reportMutex_);
+  reported_ = CacheAccessCounters();
+}
+
+void CacheAccessStats::reportStats() {
+  ensureStatsRegistered();
+  auto current = total();
+  CacheAccessCounters delta = current;
+  {
+    std::lock_guard<std::mutex> l(reportMutex_);
+    // A clear() since the last report starts the deltas over.
+    if (current.numRam >= reported_.numRam &&
+        current.numSsd >= reported_.numSsd &&
+        current.numStorage >= reported_.numStorage) {
+      delta.subtract(reported_);
+    }
+    reported_ = current;
+  }
+  REPORT_ADD_STAT_VALUE(kRamHitBytes, delta.ramBytes);
+  REPORT_ADD_STAT_VALUE(kSsdHitBytes, delta.ssdBytes);
+  REPORT_ADD_STAT_VALUE(kStorageReadBytes, delta.storageBytes);
+  REPORT_ADD_STAT_VALUE(kNumRamHits, delta.numRam);
+  REPORT_ADD_STAT_VALUE(kNumSsdHits, delta.numSsd);
+  REPORT_ADD_STAT_VALUE(kNumStorageReads, delta.numStorage);
+  if (delta.ssdLatency.count) {
+    REPORT_ADD_STAT_VALUE(kSsdLatencyP50, delta.ssdLatency.percentile(50));
+    REPORT_ADD_STAT_VALUE(kSsdLatencyP99, delta.ssdLatency.percentile(99));
+  }
+  if (delta.storageLatency.count) {
+    REPORT_ADD_STAT_VALUE(
+        kStorageLatencyP50, delta.storageLatency.percentile(50));
+    REPORT_ADD_STAT_VALUE(
+        kStorageLatencyP99, delta.storageLatency.percentile(99));
+  }
+}
+
+std::string CacheAccessStats::toString(int32_t maxEntries) const {
+  auto entries = snapshot();
+  CacheAccessCounters sum;
+  for (auto& entry : entries) {
+    sum.add(entry.counters);
+  }
+  auto format = [](const CacheAccessCounters& counters) {
+    return fmt::format(
+        "{} bytes ram {:.1f}% ssd {:.1f}% of misses, ssd p50/p99 {}/{}us "
+        "storage p50/p99 {}/{}us",
+        counters.totalBytes(),
+        counters.ramHitPct(),
+        counters.ssdHitPct(),
+        counters.ssdLatency.percentile(50),
+        counters.ssdLatency.percentile(99),
+        counters.storageLatency.percentile(50),
+        counters.storageLatency.percentile(99));
+  };
+  std::stringstream out;
+  out << "Cache access: " << format(sum);
+  std::sort(entries.begin(), entries.end(), [](auto& left, auto& right) {
+    return left.counters.totalBytes() > right.counters.totalBytes();
+  });
+  for (auto i = 0; i < entries.size() && i < maxEntries; ++i) {
+    out << "\n group " << entries[i].groupId << " stream "
+        << entries[i].trackingId.id() << ": " << format(entries[i].counters);
+  }
+  return out.str();
+}
+
+} // namespace facebook::velox::cache
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
+#include "velox/common/caching/ScanTracker.h"
+
+namespace facebook::velox::cache {
+
+// Log2 histogram of latencies in microseconds. Bucket i counts latencies
+// in [2^(i-1), 2^i) with bucket 0 for 0 and the last bucket open ended.
+struct LatencyHistogram {
+  static constexpr int32_t kNumBuckets = 26;
+
+  void record(uint64_t micros);
+
+  void add(const LatencyHistogram& other);
+
+  // Removes the counts of 'other', which must be an earlier state of
+  // 'this'.
+  void subtract(const LatencyHistogram& other);
+
+  // Returns the upper bound of the bucket that contains the 'pct'th
+  // percentile, 0 if empty.
+  uint64_t percentile(int32_t pct) const;
+
+  uint64_t count{0};
+  uint64_t sumMicros{0};
+  std::array<uint64_t, kNumBuckets> buckets{};
+};
+
+// Where the data of a cache access came from.
+enum class CacheSource { kRam, kSsd, kStorage };
+
+// Counts of cache accesses by source for one file group and stream.
+struct CacheAccessCounters {
+  uint64_t numRam{0};
+  uint64_t ramBytes{0};
+  uint64_t numSsd{0};
+  uint64_t ssdBytes{0};
+  uint64_t numStorage{0};
+  uint64_t storageBytes{0};
+  // Latency of loads from SSD and storage. A coalesced load is recorded
+  // once for each of its entries.
+  LatencyHistogram ssdLatency;
+  LatencyHistogram storageLatency;
+
+  void add(const CacheAccessCounters& other);
+
+  void subtract(const CacheAccessCounters& other);
+
+  uint64_t totalBytes() const {
+    return ramBytes + ssdBytes + storageBytes;
+  }
+
+  // Percentage of bytes found in RAM.
+  double ramHitPct() const {
+    return totalBytes() ? 100.0 * ramBytes / totalBytes() : 0;
+  }
+
+  // Percentage of bytes not found in RAM that were found on SSD.
+  double ssdHitPct() const {
+    auto missBytes = ssdBytes + storageBytes;
+    return missBytes ? 100.0 * ssdBytes / missBytes : 0;
+  }
+};
+
+// Cache hits and misses with load latencies broken down by file group and
+// stream, as given by the groupId and TrackingId of the reading
+// ScanTracker. Thread safe.
+class CacheAccessStats {
+ public:
+  struct Entry {
+    uint64_t groupId;
+    TrackingId trackingId;
+    CacheAccessCounters counters;
+  };
+
+  // Records an access of 'bytes' served from 'source'. 'latencyMicros' is
+  // the time of the load for SSD and storage.
+  void record(
+      uint64_t groupId,
+      TrackingId trackingId,
+      CacheSource source,
+      uint64_t bytes,
+      uint64_t latencyMicros = 0);
+
+  // Returns the counters of all groups and streams.
+  std::vector<Entry> snapshot() const;
+
+  // Returns the counters of all streams of 'groupId' added together.
+  CacheAccessCounters groupCounters(uint64_t groupId) const;
+
+  CacheAccessCounters total() const;
+
+  void clear();
+
+  // Adds the totals accumulated since the previous call to the
+  // StatsReporter of the process. The breakdown by group and stream is
+  // available from snapshot().
+  void reportStats();
+
+  // Returns totals followed by the 'maxEntries' group and stream pairs
+  // with the most bytes.
+  std::string toString(int32_t maxEntries = 10) const;
+
+ private:
+  static constexpr int32_t kNumShards = 16;
+
+  struct Key {
+    uint64_t groupId;
+    int32_t trackingId;
+
+    bool operator==(const Key& other) const {
+      return groupId == other.groupId && trackingId == other.trackingId;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const {
+      return folly::hash::hash_combine(key.groupId, key.trackingId);
+    }
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    folly::F14FastMap<Key, CacheAccessCounters, KeyHasher> counters;
+  };
+
+  std::array<Shard, kNumShards> shards_;
+
+  // Totals at the last reportStats().
+  std::mutex reportMutex_;
+  CacheAccessCounters reported_;
+};
+
+} // namespace facebook::velox::cache
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/CacheResidency.h"
+
+namespace facebook::velox::cache {
+
+void GranuleBytes::add(uint64_t fileNum, uint64_t offset, int64_t bytes) {
+  auto it = bytes_.try_emplace({fileNum, offset >> kGranuleBits}, 0).first;
+  it->second += bytes;
+  if (it->second <= 0) {
+    bytes_.erase(it);
+  }
+}
+
+uint64_t GranuleBytes::bytesIn(uint64_t fileNum, uint64_t offset, uint64_t size)
+    const {
+  if (size == 0 || bytes_.empty()) {
+    return 0;
+  }
+  uint64_t total = 0;
+  const auto last = (offset + size - 1) >> kGranuleBits;
+  for (auto granule = offset >> kGranuleBits; granule <= last; ++granule) {
+    auto it = bytes_.find({fileNum, granule});
+    if (it != bytes_.end()) {
+      total += it->second;
+    }
+  }
+  return std::min(total, size);
+}
+
+// static
+uint64_t CacheLocalitySummary::hash(
+    std::string_view fileName,
+    uint64_t granule) {
+  // FNV is stable across processes and builds, unlike std::hash.
+  return folly::hash::hash_128_to_64(
+      folly::hash::fnv64_buf(fileName.data(), fileName.size()), granule);
+}
+
+} // namespace facebook::velox::cache
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
+
+#include "velox/common/base/BloomFilter.h"
+
+namespace facebook::velox::cache {
+
+// A byte range of a file, e.g. of a split. See AsyncDataCache::residency().
+struct FileByteRange {
+  std::string fileName;
+  uint64_t offset;
+  uint64_t size;
+};
+
+// Bytes of a set of FileByteRanges cached on a node. Data that is both in
+// RAM and on SSD counts in both.
+struct CacheResidency {
+  uint64_t bytes{0};
+  uint64_t ramBytes{0};
+  uint64_t ssdBytes{0};
+
+  double ramFraction() const {
+    return bytes ? static_cast<double>(ramBytes) / bytes : 0;
+  }
+
+  double ssdFraction() const {
+    return bytes ? static_cast<double>(ssdBytes) / bytes : 0;
+  }
+};
+
+// Cached bytes per granule of kGranuleSize bytes of each file. An entry
+// counts in the granule of its first byte. Answers residency queries
+// without visiting the cache entries. Not thread safe.
+class GranuleBytes {
+ public:
+  static constexpr int32_t kGranuleBits = 23;
+  static constexpr uint64_t kGranuleSize = 1UL << kGranuleBits;
+
+  // Adds 'bytes', which may be negative, to the granule of 'offset'.
+  void add(uint64_t fileNum, uint64_t offset, int64_t bytes);
+
+  // Returns the bytes cached in the granules of [offset, offset + size),
+  // at most 'size'.
+  uint64_t bytesIn(uint64_t fileNum, uint64_t offset, uint64_t size) const;
+
+  // Calls 'func(fileNum, granule, bytes)' for each granule with bytes.
+  template <typename Func>
+  void forEach(Func func) const {
+    for (auto& [key, bytes] : bytes_) {
+      func(key.first, key.second, bytes);
+    }
+  }
+
+  void clear() {
+    bytes_.clear();
+  }
+
+ private:
+  // Keyed on file number and granule.
+  folly::F14FastMap<std::pair<uint64_t, uint64_t>, int64_t> bytes_;
+};
+
+// Bloom filter of the warm granules of a node for soft affinity
+// scheduling. Made by AsyncDataCache::localitySummary() and shipped to a
+// scheduler as bits(), which reconstructs the summary from the bits and
+// routes a split to the nodes that may have its granules cached. The hash
+// of a granule depends only on the file name and the granule number, so
+// summaries of different nodes are comparable.
+class CacheLocalitySummary {
+ public:
+  // Makes an empty summary for about 'capacity' granules.
+  explicit CacheLocalitySummary(int32_t capacity) {
+    filter_.reset(capacity);
+  }
+
+  explicit CacheLocalitySummary(std::vector<uint64_t> bits)
+      : filter_(std::move(bits)) {}
+
+  void add(std::string_view fileName, uint64_t granule) {
+    filter_.insert(hash(fileName, granule));
+  }
+
+  // Returns false if the granule of 'offset' of 'fileName' is not warm on
+  // the node of 'this'.
+  bool mayBeCached(std::string_view fileName, uint64_t offset) const {
+    return filter_.mayContain(
+        hash(fileName, offset >> GranuleBytes::kGranuleBits));
+  }
+
+  const std::vector<uint64_t>& bits() const {
+    return filter_.bits();
+  }
+
+  static uint64_t hash(std::string_view fileName, uint64_t granule);
+
+ private:
+  BloomFilter<false> filter_;
+};
+
+} // namespace facebook::velox::cache
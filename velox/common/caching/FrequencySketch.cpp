@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/FrequencySketch.h"
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+
+#include <algorithm>
+
+namespace facebook::velox::cache {
+
+namespace {
+int64_t roundedNumCounters(int32_t numCounters) {
+  VELOX_CHECK_GT(numCounters, 0);
+  return std::max<int64_t>(16, bits::nextPowerOfTwo(numCounters));
+}
+} // namespace
+
+FrequencySketch::FrequencySketch(int32_t numCounters)
+    : table_(roundedNumCounters(numCounters) / kCountersPerWord),
+      counterMask_(roundedNumCounters(numCounters) - 1),
+      samplePeriod_(roundedNumCounters(numCounters) * 10) {}
+
+uint64_t FrequencySketch::counterIndex(uint64_t hash, int32_t nth) const {
+  // Each counter of a key comes from a different remix of the hash.
+  return bits::hashMix(hash, nth) & counterMask_;
+}
+
+void FrequencySketch::increment(uint64_t hash) {
+  for (auto i = 0; i < kNumHashes; ++i) {
+    auto index = counterIndex(hash, i);
+    auto shift = index % kCountersPerWord * 4;
+    auto& word = table_[index / kCountersPerWord];
+    auto value = word.load(std::memory_order_relaxed);
+    // Retries if another counter of the word changed concurrently.
+    while (((value >> shift) & kMaxCount) < kMaxCount &&
+           !word.compare_exchange_weak(
+               value, value + (1UL << shift), std::memory_order_relaxed)) {
+    }
+  }
+  // Only the thread that completes the sample period halves.
+  if (numIncrements_.fetch_add(1, std::memory_order_relaxed) + 1 ==
+      samplePeriod_) {
+    halve();
+  }
+}
+
+int32_t FrequencySketch::estimate(uint64_t hash) const {
+  int32_t count = kMaxCount;
+  for (auto i = 0; i < kNumHashes; ++i) {
+    count = std::min(count, counterAt(counterIndex(hash, i)));
+  }
+  return count;
+}
+
+void FrequencySketch::halve() {
+  // Shifts each 4 bit counter right by one and clears the bit that comes
+  // in from the next counter.
+  for (auto& word : table_) {
+    auto value = word.load(std::memory_order_relaxed);
+    while (!word.compare_exchange_weak(
+        value,
+        (value >> 1) & 0x7777777777777777UL,
+        std::memory_order_relaxed)) {
+    }
+  }
+  numIncrements_.fetch_sub(samplePeriod_ / 2, std::memory_order_relaxed);
+  ++numResets_;
+}
+
+} // namespace facebook::velox::cache
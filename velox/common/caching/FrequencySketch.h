@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace facebook::velox::cache {
+
+// Approximate access counts of cache keys for frequency based admission,
+// as in TinyLFU. This is a count-min sketch of 4 bit counters with 4
+// counters per key. After a sample period of 10 increments per counter,
+// all counters are halved so that old history ages out. Thread safe.
+// Counters are updated with relaxed atomics, so concurrent increments
+// and halving may lose a count, which is within the sketch's error.
+class FrequencySketch {
+ public:
+  static constexpr int32_t kMaxCount = 15;
+
+  // Makes a sketch with at least 'numCounters' counters, rounded up to a
+  // power of two.
+  explicit FrequencySketch(int32_t numCounters);
+
+  // Records an access to the key with 'hash'.
+  void increment(uint64_t hash);
+
+  // Returns the estimated number of accesses to the key with 'hash' since
+  // the counts were last halved, at most kMaxCount.
+  int32_t estimate(uint64_t hash) const;
+
+  // Number of times the counts have been halved. For testing.
+  int64_t numResets() const {
+    return numResets_;
+  }
+
+ private:
+  static constexpr int32_t kNumHashes = 4;
+  static constexpr int32_t kCountersPerWord = 16;
+
+  // Returns the index of the 'nth' counter of 'hash'.
+  uint64_t counterIndex(uint64_t hash, int32_t nth) const;
+
+  int32_t counterAt(uint64_t index) const {
+    return (table_[index / kCountersPerWord].load(std::memory_order_relaxed) >>
+            (index % kCountersPerWord * 4)) &
+        kMaxCount;
+  }
+
+  // Halves all counters.
+  void halve();
+
+  // 16 counters per word.
+  std::vector<std::atomic<uint64_t>> table_;
+  const uint64_t counterMask_;
+  const int64_t samplePeriod_;
+  std::atomic<int64_t> numIncrements_{0};
+  std::atomic<int64_t> numResets_{0};
+};
+
+} // namespace facebook::velox::cache
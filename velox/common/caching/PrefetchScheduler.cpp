@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/PrefetchScheduler.h"
+
+#include <folly/executors/InlineExecutor.h>
+#include <thread>
+#include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
+
+namespace facebook::velox::cache {
+
+PrefetchScheduler::PrefetchScheduler(
+    folly::Executor* executor,
+    uint64_t maxInflightBytes,
+    uint64_t scanBytesPerSecond)
+    : executor_(executor),
+      maxInflightBytes_(maxInflightBytes),
+      scanBytesPerSecond_(scanBytesPerSecond) {
+  VELOX_CHECK_NOT_NULL(executor_);
+  VELOX_CHECK_GT(scanBytesPerSecond_, 0);
+}
+
+PrefetchScheduler::~PrefetchScheduler() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    queue_.clear();
+  }
+  while (numInflight_ > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1)); // NOLINT
+  }
+}
+
+uint64_t PrefetchScheduler::expectedUseMicros(uint64_t bytesAhead) const {
+  return getCurrentTimeMicro() + bytesAhead * 1'000'000 / scanBytesPerSecond_;
+}
+
+void PrefetchScheduler::schedule(
+    std::shared_ptr<CoalescedLoad> load,
+    uint64_t expectedUseMicros,
+    GroupId group) {
+  auto bytes = load->size();
+  std::vector<Pending> toStart;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++stats_.numScheduled;
+    queue_.emplace(
+        std::make_pair(expectedUseMicros, ++sequence_),
+        Pending{std::move(load), static_cast<uint64_t>(bytes), group});
+    takeStartableLocked(toStart);
+  }
+  start(toStart);
+}
+
+void PrefetchScheduler::cancel(GroupId group) {
+  // The dropped loads are freed outside of 'mutex_'.
+  std::vector<std::shared_ptr<CoalescedLoad>> dropped;
+  std::vector<Pending> toStart;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      if (it->second.group == group) {
+        dropped.push_back(std::move(it->second.load));
+        it = queue_.erase(it);
+        ++stats_.numCancelled;
+      } else {
+        ++it;
+      }
+    }
+    takeStartableLocked(toStart);
+  }
+  start(toStart);
+}
+
+PrefetchScheduler::Stats PrefetchScheduler::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto stats = stats_;
+  stats.inflightBytes = inflightBytes_;
+  stats.numQueued = queue_.size();
+  return stats;
+}
+
+void PrefetchScheduler::takeStartableLocked(std::vector<Pending>& toStart) {
+  while (!queue_.empty()) {
+    auto it = queue_.begin();
+    auto& pending = it->second;
+    if (pending.load->state() != LoadState::kPlanned) {
+      ++stats_.numSkipped;
+      queue_.erase(it);
+      continue;
+    }
+    if (inflightBytes_ > 0 &&
+        inflightBytes_ + pending.bytes > maxInflightBytes_) {
+      // Later loads wait even if they would fit so that the load needed
+      // first is not starved by smaller ones.
+      return;
+    }
+    inflightBytes_ += pending.bytes;
+    ++stats_.numStarted;
+    toStart.push_back(std::move(pending));
+    queue_.erase(it);
+  }
+}
+
+void PrefetchScheduler::start(std::vector<Pending>& loads) {
+  for (auto& pending : loads) {
+    ++numInflight_;
+    auto bytes = pending.bytes;
+    executor_->add([this, load = std::move(pending.load), bytes]() {
+      process::TraceContext trace("Read Ahead");
+      // The continuation keeps 'load' alive until the IO completes.
+      load->loadAsync()
+          .via(&folly::InlineExecutor::instance())
+          .thenTry([this, load, bytes](auto&& /*unused*/) {
+            finished(bytes);
+          });
+    });
+  }
+}
+
+void PrefetchScheduler::finished(uint64_t bytes) {
+  std::vector<Pending> toStart;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    inflightBytes_ -= bytes;
+    takeStartableLocked(toStart);
+  }
+  start(toStart);
+  --numInflight_;
+}
+
+} // namespace facebook::velox::cache
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <folly/Executor.h>
+#include "velox/common/caching/AsyncDataCache.h"
+
+namespace facebook::velox::cache {
+
+// Node wide scheduler for the prefetches of all scans reading through an
+// AsyncDataCache. Prefetches are queued with the time their data is
+// expected to be read and started in that order while the bytes of
+// started and unfinished loads stay within a budget. A reader that gets
+// to a load before the scheduler loads it on its own thread and the
+// scheduler then skips it. Loads are queued in groups, e.g. one per
+// reader of a file, and the queued loads of a group are dropped together
+// when the reader no longer needs them. Thread safe.
+class PrefetchScheduler {
+ public:
+  using GroupId = uint64_t;
+
+  struct Stats {
+    uint64_t numScheduled{0};
+    uint64_t numStarted{0};
+    // Loads that were loaded or cancelled by their reader before they were
+    // started.
+    uint64_t numSkipped{0};
+    // Loads dropped by cancel().
+    uint64_t numCancelled{0};
+    uint64_t inflightBytes{0};
+    int32_t numQueued{0};
+  };
+
+  // Starts loads on 'executor', keeping at most 'maxInflightBytes' in
+  // flight. A load that alone exceeds the budget starts when nothing else
+  // is in flight. 'scanBytesPerSecond' is the assumed rate at which a
+  // scan consumes its data, see expectedUseMicros().
+  PrefetchScheduler(
+      folly::Executor* FOLLY_NONNULL executor,
+      uint64_t maxInflightBytes,
+      uint64_t scanBytesPerSecond = kDefaultScanBytesPerSecond);
+
+  // Drops the queued loads and waits for the started ones to finish.
+  ~PrefetchScheduler();
+
+  // Returns a new id for a group of loads.
+  GroupId newGroup() {
+    return ++groupCounter_;
+  }
+
+  // Returns the getCurrentTimeMicro() at which a scan is expected to read
+  // data that is 'bytesAhead' bytes after the data it is reading now.
+  uint64_t expectedUseMicros(uint64_t bytesAhead) const;
+
+  // Queues 'load' to start after the loads expected to be used before
+  // 'expectedUseMicros'.
+  void schedule(
+      std::shared_ptr<CoalescedLoad> load,
+      uint64_t expectedUseMicros,
+      GroupId group);
+
+  // Drops the loads of 'group' that have not started. Started loads
+  // finish.
+  void cancel(GroupId group);
+
+  Stats stats() const;
+
+ private:
+  static constexpr uint64_t kDefaultScanBytesPerSecond = 256UL << 20;
+
+  struct Pending {
+    std::shared_ptr<CoalescedLoad> load;
+    uint64_t bytes;
+    GroupId group;
+  };
+
+  // Moves the loads that fit in the budget from the head of 'queue_' to
+  // 'toStart'.
+  void takeStartableLocked(std::vector<Pending>& toStart);
+
+  // Starts 'loads' on 'executor_'. Called outside of 'mutex_'.
+  void start(std::vector<Pending>& loads);
+
+  // Called when a started load of 'bytes' is finished.
+  void finished(uint64_t bytes);
+
+  folly::Executor* const FOLLY_NONNULL executor_;
+  const uint64_t maxInflightBytes_;
+  const uint64_t scanBytesPerSecond_;
+
+  std::atomic<GroupId> groupCounter_{0};
+
+  mutable std::mutex mutex_;
+  // Queued loads ordered on expected time of use and then on arrival.
+  std::map<std::pair<uint64_t, uint64_t>, Pending> queue_;
+  // Count of schedule() calls. Orders loads with the same expected time.
+  uint64_t sequence_{0};
+  uint64_t inflightBytes_{0};
+  Stats stats_;
+
+  // Started loads that are not finished.
+  std::atomic<int32_t> numInflight_{0};
+};
+
+} // namespace facebook::velox::cache
@@ -67,6 +67,19 @@ class SsdCache {
   // Returns  stats aggregated from all shards.
   SsdCacheStats stats() const;
 
+  // See SsdFile::cachedBytes().
+  uint64_t cachedBytes(uint64_t fileNum, uint64_t offset, uint64_t size)
+      const {
+    return files_[fileNum % numShards_]->cachedBytes(fileNum, offset, size);
+  }
+
+  // Adds the bytes by granule of all files to 'granules'.
+  void addGranules(GranuleBytes& granules) const {
+    for (auto& file : files_) {
+      file->addGranules(granules);
+    }
+  }
+
   FileGroupStats& groupStats() const {
     return *groupStats_;
   }
@@ -85,6 +98,14 @@ class SsdCache {
 
   std::string toString() const;
 
+  const std::string& filePrefix() const {
+    return filePrefix_;
+  }
+
+  folly::Executor* FOLLY_NONNULL executor() const {
+    return executor_;
+  }
+
  private:
   const std::string filePrefix_;
   const int32_t numShards_;
@@ -29,6 +29,10 @@
 
 DEFINE_bool(ssd_odirect, true, "Use O_DIRECT for SSD cache IO");
 DEFINE_bool(ssd_verify_write, false, "Read back data after writing to SSD");
+DEFINE_bool(
+    ssd_io_uring,
+    false,
+    "Use io_uring for SSD cache IO if Velox is built with io_uring");
 
 namespace facebook::velox::cache {
 
@@ -88,7 +92,10 @@ SsdFile::SsdFile(
     LOG(ERROR) << "Cannot open or create " << filename << " error " << errno;
     exit(1);
   }
-  readFile_ = std::make_unique<LocalReadFile>(fd_);
+  if (FLAGS_ssd_io_uring) {
+    ioUring_ = IoUring::instance();
+  }
+  readFile_ = std::make_unique<LocalReadFile>(fd_, ioUring_);
   uint64_t size = lseek(fd_, 0, SEEK_END);
   numRegions_ = size / kRegionSize;
   if (numRegions_ > maxRegions_) {
@@ -170,13 +177,90 @@ bool SsdFile::erase(RawFileCacheKey key) {
   if (it == entries_.end()) {
     return false;
   }
-  entries_.erase(it);
+  eraseEntryLocked(it);
   return true;
 }
 
+void SsdFile::setEntryLocked(FileCacheKey key, SsdRun run) {
+  granules_.add(key.fileNum.id(), key.offset, run.size());
+  auto [it, inserted] = entries_.try_emplace(std::move(key), run);
+  if (!inserted) {
+    granules_.add(
+        it->first.fileNum.id(),
+        it->first.offset,
+        -static_cast<int64_t>(it->second.size()));
+    it->second = run;
+  }
+}
+
+folly::F14FastMap<FileCacheKey, SsdRun>::iterator SsdFile::eraseEntryLocked(
+    folly::F14FastMap<FileCacheKey, SsdRun>::iterator it) {
+  granules_.add(
+      it->first.fileNum.id(),
+      it->first.offset,
+      -static_cast<int64_t>(it->second.size()));
+  return entries_.erase(it);
+}
+
+uint64_t
+SsdFile::cachedBytes(uint64_t fileNum, uint64_t offset, uint64_t size) {
+  std::lock_guard<std::mutex> l(mutex_);
+  return granules_.bytesIn(fileNum, offset, size);
+}
+
+void SsdFile::addGranules(GranuleBytes& granules) {
+  std::lock_guard<std::mutex> l(mutex_);
+  granules_.forEach([&](auto fileNum, auto granule, auto bytes) {
+    granules.add(fileNum, granule << GranuleBytes::kGranuleBits, bytes);
+  });
+}
+
 CoalesceIoStats SsdFile::load(
     const std::vector<SsdPin>& ssdPins,
     const std::vector<CachePin>& pins) {
+  auto stats = readRuns(
+      ssdPins,
+      pins,
+      [&](uint64_t offset, const std::vector<folly::Range<char*>>& buffers) {
+        read(offset, buffers);
+      });
+  for (auto i = 0; i < ssdPins.size(); ++i) {
+    pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
+  }
+  return stats;
+}
+
+folly::SemiFuture<CoalesceIoStats> SsdFile::loadAsync(
+    const std::vector<SsdPin>& ssdPins,
+    const std::vector<CachePin>& pins) {
+  std::vector<folly::SemiFuture<uint64_t>> reads;
+  auto stats = readRuns(
+      ssdPins,
+      pins,
+      [&](uint64_t offset, const std::vector<folly::Range<char*>>& buffers) {
+        reads.push_back(readFile_->preadvAsync(offset, buffers));
+      });
+  return folly::collectAll(std::move(reads))
+      .deferValue([this, stats, &ssdPins, &pins](
+                      std::vector<folly::Try<uint64_t>>&& results) {
+        for (auto& result : results) {
+          // Rethrows the first error. The entries stay exclusive and are
+          // not made visible.
+          result.throwUnlessValue();
+        }
+        for (auto i = 0; i < ssdPins.size(); ++i) {
+          pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
+        }
+        return stats;
+      });
+}
+
+CoalesceIoStats SsdFile::readRuns(
+    const std::vector<SsdPin>& ssdPins,
+    const std::vector<CachePin>& pins,
+    std::function<void(
+        uint64_t offset,
+        const std::vector<folly::Range<char*>>& buffers)> readFunc) {
   VELOX_CHECK_EQ(ssdPins.size(), pins.size());
   if (pins.empty()) {
     return CoalesceIoStats();
@@ -201,7 +285,7 @@ CoalesceIoStats SsdFile::load(
   // Do coalesced IO for the pins. For short payloads, the break-even
   // between discrete pread calls and a single preadv that discards
   // gaps is ~25K per gap. For longer payloads this is ~50-100K.
-  auto stats = readPins(
+  return readPins(
       pins,
       payloadTotal / pins.size() < 10000 ? 25000 : 50000,
       // Max ranges in one preadv call. Longest gap + longest cache
@@ -214,13 +298,8 @@ CoalesceIoStats SsdFile::load(
           int32_t /*end*/,
           uint64_t offset,
           const std::vector<folly::Range<char*>>& buffers) {
-        read(offset, buffers);
+        readFunc(offset, buffers);
       });
-
-  for (auto i = 0; i < ssdPins.size(); ++i) {
-    pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
-  }
-  return stats;
 }
 
 void SsdFile::read(
@@ -302,7 +381,7 @@ void SsdFile::clearRegionEntriesLocked(
     auto region = regionIndex(it->second.offset());
     if (std::find(regionIndices.begin(), regionIndices.end(), region) !=
         regionIndices.end()) {
-      it = entries_.erase(it);
+      it = eraseEntryLocked(it);
     } else {
       ++it;
     }
@@ -349,7 +428,13 @@ void SsdFile::write(std::vector<CachePin>& pins) {
       ++numWritten;
     }
     VELOX_CHECK_GE(fileSize_, offset + bytes);
-    auto rc = folly::pwritev(fd_, iovecs.data(), iovecs.size(), offset);
+    int64_t rc;
+    if (ioUring_) {
+      auto result = ioUring_->pwritev(fd_, offset, std::move(iovecs)).getTry();
+      rc = result.hasValue() ? result.value() : -1;
+    } else {
+      rc = folly::pwritev(fd_, iovecs.data(), iovecs.size(), offset);
+    }
     if (rc != bytes) {
       LOG(ERROR) << "Failed to write to SSD " << errno;
       // If the write fails we return without adding the pins to the cache. The
@@ -364,7 +449,7 @@ void SsdFile::write(std::vector<CachePin>& pins) {
         auto size = entry->size();
         FileCacheKey key = {
             entry->key().fileNum, static_cast<uint64_t>(entry->offset())};
-        entries_[std::move(key)] = SsdRun(offset, size);
+        setEntryLocked(std::move(key), SsdRun(offset, size));
         if (FLAGS_ssd_verify_write) {
           verifyWrite(*entry, SsdRun(offset, size));
         }
@@ -439,6 +524,7 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
 void SsdFile::clear() {
   std::lock_guard<std::mutex> l(mutex_);
   entries_.clear();
+  granules_.clear();
   std::fill(regionSize_.begin(), regionSize_.end(), 0);
   writableRegions_.resize(numRegions_);
   std::iota(writableRegions_.begin(), writableRegions_.end(), 0);
@@ -631,6 +717,7 @@ void SsdFile::initializeCheckpoint() {
       LOG(ERROR) << "Error recovering from checkpoint " << e.what()
                  << ": Starting without checkpoint";
       entries_.clear();
+      granules_.clear();
       deleteCheckpoint(true);
     } catch (const std::exception& e) {
     }
@@ -691,7 +778,7 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
       auto it = idMap.find(fileNum);
       VELOX_CHECK(it != idMap.end());
       FileCacheKey key{it->second, offset};
-      entries_[std::move(key)] = run;
+      setEntryLocked(std::move(key), run);
     }
   }
   // The state is successfully read. Install the access frequency scores and
@@ -19,6 +19,7 @@
 #include "velox/common/caching/AsyncDataCache.h"
 #include "velox/common/caching/SsdFileTracker.h"
 #include "velox/common/file/File.h"
+#include "velox/common/file/IoUring.h"
 
 #include <gflags/gflags.h>
 
@@ -167,6 +168,18 @@ class SsdFile {
       const std::vector<SsdPin>& ssdPins,
       const std::vector<CachePin>& pins);
 
+  // Like load() but returns after submitting the reads if
+  // hasAsyncLoad(). The SemiFuture is realized when the data is in
+  // 'pins'. 'ssdPins' and 'pins' must stay alive until then.
+  folly::SemiFuture<CoalesceIoStats> loadAsync(
+      const std::vector<SsdPin>& ssdPins,
+      const std::vector<CachePin>& pins);
+
+  // True if loadAsync() does not block for the IO.
+  bool hasAsyncLoad() const {
+    return readFile_->hasPreadvAsync();
+  }
+
   // Increments the pin count of the region of 'offset'.
   void pinRegion(uint64_t offset);
 
@@ -204,6 +217,13 @@ class SsdFile {
   // Resets this' to a post-construction empty state. See SsdCache::clear().
   void clear();
 
+  // Returns the bytes of the entries in the granules of [offset, offset +
+  // size) of 'fileNum'. See GranuleBytes.
+  uint64_t cachedBytes(uint64_t fileNum, uint64_t offset, uint64_t size);
+
+  // Adds the bytes by granule of 'this' to 'granules'.
+  void addGranules(GranuleBytes& granules);
+
   // Deletes the backing file. Used in testing.
   void deleteFile();
 
@@ -223,6 +243,15 @@ class SsdFile {
   // Magic number at end of completed checkpoint file.
   static constexpr int64_t kCheckpointEndMarker = 0xcbedf11e;
 
+  // Sets the entry of 'key' in 'entries_' and 'granules_' to 'run'.
+  // Caller must hold 'mutex_'.
+  void setEntryLocked(FileCacheKey key, SsdRun run);
+
+  // Erases 'it' from 'entries_' and 'granules_' and returns the next
+  // iterator. Caller must hold 'mutex_'.
+  folly::F14FastMap<FileCacheKey, SsdRun>::iterator eraseEntryLocked(
+      folly::F14FastMap<FileCacheKey, SsdRun>::iterator it);
+
   // Increments the pin count of the region of 'offset'. Caller must hold
   // 'mutex_'.
   void pinRegionLocked(uint64_t offset) {
@@ -249,6 +278,15 @@ class SsdFile {
   // Reads the backing file with ReadFile::preadv().
   void read(uint64_t offset, const std::vector<folly::Range<char*>>& buffers);
 
+  // Checks and accounts for reading 'ssdPins' into 'pins' and calls
+  // 'readFunc' for each coalesced read. Used by load() and loadAsync().
+  CoalesceIoStats readRuns(
+      const std::vector<SsdPin>& ssdPins,
+      const std::vector<CachePin>& pins,
+      std::function<void(
+          uint64_t offset,
+          const std::vector<folly::Range<char*>>& buffers)> readFunc);
+
   // Verifies that 'entry' has the data at 'run'.
   void verifyWrite(AsyncDataCacheEntry& entry, SsdRun run);
 
@@ -315,6 +353,9 @@ class SsdFile {
   // Map of file number and offset to location in file.
   folly::F14FastMap<FileCacheKey, SsdRun> entries_;
 
+  // Sizes of 'entries_' by file granule.
+  GranuleBytes granules_;
+
   // Name of backing file.
   const std::string filename_;
 
@@ -327,6 +368,10 @@ class SsdFile {
   // ReadFile made from 'fd_'.
   std::unique_ptr<ReadFile> readFile_;
 
+  // Process wide io_uring for reads and writes of 'fd_' if
+  // FLAGS_ssd_io_uring is set and io_uring is available, else nullptr.
+  IoUring* FOLLY_NULLABLE ioUring_{nullptr};
+
   // Counters.
   SsdCacheStats stats_;
 
@@ -17,6 +17,7 @@
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
 #include "velox/common/memory/MmapAllocator.h"
+#include "velox/common/time/Timer.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 #include <folly/executors/IOThreadPoolExecutor.h>
@@ -584,6 +585,245 @@ TEST_F(AsyncDataCacheTest, outOfCapacity) {
   EXPECT_EQ(4092, cache_->numAllocated());
 }
 
+TEST_F(AsyncDataCacheTest, admission) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  // 15/16 of the capacity.
+  constexpr int32_t kNumHot = 240;
+  initializeCache(kMaxBytes);
+  CacheAdmission admission;
+  admission.frequencyFilter = true;
+  // Reads the entry at 'offset' and returns true if it is admitted.
+  auto read = [&](uint64_t offset) {
+    RawFileCacheKey key{filenames_[0].id(), offset};
+    auto pin = cache_->findOrCreate(key, kSize, nullptr, admission);
+    EXPECT_FALSE(pin.empty());
+    if (pin.checkedEntry()->isExclusive()) {
+      pin.checkedEntry()->setExclusiveToShared();
+    }
+    return pin.checkedEntry()->isAdmitted();
+  };
+
+  // Entries that fill the cache are admitted while there is space.
+  for (auto round = 0; round < 4; ++round) {
+    for (auto i = 0; i < kNumHot; ++i) {
+      EXPECT_TRUE(read(i * kSize));
+    }
+  }
+  EXPECT_TRUE(cache_->nearCapacity());
+
+  // A scan of 10x the cache size is rejected and does not displace the
+  // frequently read entries.
+  constexpr int32_t kNumScan = 10 * kMaxBytes / kSize;
+  for (auto i = 0; i < kNumScan; ++i) {
+    EXPECT_FALSE(read((kNumHot + i) * kSize));
+  }
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(kNumScan, stats.numRejected);
+  EXPECT_EQ(0, stats.numEvict);
+  for (auto i = 0; i < kNumHot; ++i) {
+    EXPECT_TRUE(cache_->exists({filenames_[0].id(), i * kSize}));
+  }
+
+  // An entry that keeps being read gets as frequent as the resident
+  // entries and is admitted.
+  bool admitted = false;
+  for (auto i = 0; i < 20 && !admitted; ++i) {
+    admitted = read(kNumHot * kSize);
+  }
+  EXPECT_TRUE(admitted);
+
+  // Without the filter, new entries are admitted.
+  admission.frequencyFilter = false;
+  EXPECT_TRUE(read((kNumHot + kNumScan) * kSize));
+}
+
+TEST_F(AsyncDataCacheTest, poolShares) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  // 6.4MB, within the 50% share of pool 1.
+  constexpr int32_t kNumHot = 100;
+  initializeCache(kMaxBytes);
+  cache_->setPoolShare(1, 50);
+  auto read = [&](uint64_t offset, int32_t poolId) {
+    CacheAdmission admission;
+    admission.poolId = poolId;
+    RawFileCacheKey key{filenames_[0].id(), offset};
+    auto pin = cache_->findOrCreate(key, kSize, nullptr, admission);
+    ASSERT_FALSE(pin.empty());
+    if (pin.checkedEntry()->isExclusive()) {
+      pin.checkedEntry()->setExclusiveToShared();
+    }
+    EXPECT_EQ(poolId, pin.checkedEntry()->poolId());
+  };
+
+  for (auto round = 0; round < 2; ++round) {
+    for (auto i = 0; i < kNumHot; ++i) {
+      read(i * kSize, 1);
+    }
+  }
+  // A scan of pool 2 of 10x the cache size evicts its own entries.
+  constexpr int32_t kNumScan = 10 * kMaxBytes / kSize;
+  for (auto i = 0; i < kNumScan; ++i) {
+    read((kNumHot + i) * kSize, 2);
+  }
+  for (auto i = 0; i < kNumHot; ++i) {
+    EXPECT_TRUE(cache_->exists({filenames_[0].id(), i * kSize}));
+  }
+
+  auto stats = cache_->refreshStats();
+  ASSERT_EQ(2, stats.pools.size());
+  auto& hot = stats.pools[0];
+  EXPECT_EQ(1, hot.poolId);
+  EXPECT_EQ(50, hot.sharePercent);
+  EXPECT_EQ(kNumHot * kSize, hot.cachedBytes);
+  EXPECT_EQ(kNumHot, hot.numHit);
+  EXPECT_EQ(kNumHot, hot.numNew);
+  EXPECT_EQ(0, hot.numEvict);
+  auto& scan = stats.pools[1];
+  EXPECT_EQ(2, scan.poolId);
+  EXPECT_EQ(0, scan.sharePercent);
+  EXPECT_EQ(kNumScan, scan.numNew);
+  EXPECT_LT(0, scan.numEvict);
+  EXPECT_EQ(
+      scan.cachedBytes,
+      static_cast<int64_t>(kNumScan - scan.numEvict) * kSize);
+  EXPECT_EQ(stats.numEvict, scan.numEvict);
+
+  // Clearing the cache returns the bytes of all pools.
+  cache_->clear();
+  stats = cache_->refreshStats();
+  EXPECT_EQ(0, stats.pools[0].cachedBytes);
+  EXPECT_EQ(0, stats.pools[1].cachedBytes);
+}
+
+TEST_F(AsyncDataCacheTest, residency) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 128 << 10;
+  constexpr uint64_t kGranule = GranuleBytes::kGranuleSize;
+  initializeCache(kMaxBytes);
+  auto fileName = fileIds().string(filenames_[0].id());
+  // 2MB in granule 0 and 1MB in granule 2.
+  std::vector<uint64_t> offsets;
+  for (auto i = 0; i < 16; ++i) {
+    offsets.push_back(i * kSize);
+  }
+  for (auto i = 0; i < 8; ++i) {
+    offsets.push_back(2 * kGranule + i * kSize);
+  }
+  for (auto offset : offsets) {
+    auto pin = cache_->findOrCreate(
+        RawFileCacheKey{filenames_[0].id(), offset}, kSize, nullptr);
+    ASSERT_FALSE(pin.empty());
+    pin.checkedEntry()->setExclusiveToShared();
+  }
+
+  auto residency = cache_->residency({{fileName, 0, kGranule}});
+  EXPECT_EQ(kGranule, residency.bytes);
+  EXPECT_EQ(2 << 20, residency.ramBytes);
+  EXPECT_EQ(0.25, residency.ramFraction());
+  EXPECT_EQ(0, residency.ssdBytes);
+  residency = cache_->residency(
+      {{fileName, kGranule, kGranule}, {"unknown", 0, kGranule}});
+  EXPECT_EQ(2 * kGranule, residency.bytes);
+  EXPECT_EQ(0, residency.ramBytes);
+  residency = cache_->residency({{fileName, 0, 3 * kGranule}});
+  EXPECT_EQ(3 << 20, residency.ramBytes);
+  // A range within a granule counts the granule's bytes up to its size.
+  residency = cache_->residency({{fileName, 2 * kGranule, 1000}});
+  EXPECT_EQ(1000, residency.ramBytes);
+
+  auto summary = cache_->localitySummary(2 << 20);
+  EXPECT_TRUE(summary.mayBeCached(fileName, 100));
+  // A summary made from the bits of another answers the same.
+  CacheLocalitySummary copy(summary.bits());
+  EXPECT_TRUE(copy.mayBeCached(fileName, kGranule - 1));
+  summary = cache_->localitySummary(1);
+  EXPECT_TRUE(summary.mayBeCached(fileName, 2 * kGranule));
+
+  cache_->clear();
+  residency = cache_->residency({{fileName, 0, 3 * kGranule}});
+  EXPECT_EQ(0, residency.ramBytes);
+}
+
+TEST_F(AsyncDataCacheTest, compression) {
+  constexpr uint64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  constexpr int32_t kNumEntries = kMaxBytes / kSize;
+  initializeCache(kMaxBytes);
+  cache_->setCompressAfterRounds(1);
+  // Each entry is filled with a byte that depends on its offset.
+  auto fillByte = [](uint64_t offset) {
+    return static_cast<uint8_t>(offset / kSize % 251);
+  };
+  auto read = [&](uint64_t offset) {
+    RawFileCacheKey key{filenames_[0].id(), offset};
+    auto pin = cache_->findOrCreate(key, kSize, nullptr);
+    ASSERT_FALSE(pin.empty());
+    auto entry = pin.checkedEntry();
+    auto& data = entry->data();
+    if (entry->isExclusive()) {
+      for (auto i = 0; i < data.numRuns(); ++i) {
+        auto run = data.runAt(i);
+        memset(run.data(), fillByte(offset), run.numBytes());
+      }
+      entry->setExclusiveToShared();
+      return;
+    }
+    // A hit sees the uncompressed contents.
+    EXPECT_FALSE(entry->isCompressed());
+    int64_t remaining = kSize;
+    for (auto i = 0; i < data.numRuns() && remaining > 0; ++i) {
+      auto run = data.runAt(i);
+      auto bytes = std::min<int64_t>(run.numBytes(), remaining);
+      for (auto j = 0; j < bytes; ++j) {
+        ASSERT_EQ(fillByte(offset), run.data<uint8_t>()[j]);
+      }
+      remaining -= bytes;
+    }
+  };
+
+  for (auto i = 0; i < kNumEntries; ++i) {
+    read(i * kSize);
+  }
+  // New entries make space by evicting and by compressing entries that
+  // survived a pass of the clock.
+  for (auto i = kNumEntries; i < 2 * kNumEntries; ++i) {
+    read(i * kSize);
+  }
+  auto stats = cache_->refreshStats();
+  EXPECT_LT(0, stats.numCompress);
+  EXPECT_LT(0, stats.numCompressed);
+  EXPECT_GT(stats.numCompressed * kSize / 4, stats.compressedSize);
+
+  // Hits on compressed entries decompress them.
+  for (auto i = 0; i < 2 * kNumEntries; ++i) {
+    read(i * kSize);
+  }
+  stats = cache_->refreshStats();
+  EXPECT_LT(0, stats.numDecompress);
+  EXPECT_EQ(0, stats.numShared);
+  EXPECT_EQ(0, stats.numExclusive);
+}
+
+TEST_F(AsyncDataCacheTest, concurrentHitsAndEvicts) {
+  constexpr uint64_t kRamBytes = 16 << 20;
+  initializeCache(kRamBytes);
+  cache_->setVerifyHook(
+      [&](const AsyncDataCacheEntry& entry) { checkContents(entry); });
+  cache_->setEvictExecutor(executor());
+  // The threads hit the same entries without the shard mutex while new
+  // entries evict in the background and on the allocating threads. Hits
+  // check the contents.
+  runThreads(16, [&](int32_t /*i*/) { loadLoop(0, kRamBytes * 4); });
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(0, stats.numShared);
+  EXPECT_EQ(0, stats.numExclusive);
+  EXPECT_LT(0, stats.numHit);
+  EXPECT_LT(0, stats.numEvict);
+  EXPECT_LT(0, cache_->numBackgroundEvicts());
+}
+
 namespace {
 // Cuts off the last 1/10th of file at 'path'.
 void corruptFile(const std::string& path) {
@@ -667,3 +907,44 @@ TEST_F(AsyncDataCacheTest, ssd) {
   // a safe bet.
   EXPECT_LT(kSsdBytes / 2, stats.bytesRead);
 }
+
+TEST_F(AsyncDataCacheTest, hotSet) {
+  constexpr uint64_t kRamBytes = 32 << 20;
+  constexpr uint64_t kSsdBytes = 512UL << 20;
+  initializeCache(kRamBytes, kSsdBytes);
+  // Each entry is created and then hit once.
+  loadLoop(0, kRamBytes / 2);
+  // Saves the RAM contents to SSD, checkpoints and saves the hot set.
+  cache_->shutdown();
+  EXPECT_EQ(0, cache_->refreshStats().numExclusive);
+
+  // A restarted cache recovers SSD from checkpoint and gets the hot set
+  // back to RAM. The verify hook checks the loaded data.
+  initializeCache(kRamBytes, kSsdBytes);
+  cache_->setVerifyHook(
+      [&](const AsyncDataCacheEntry& entry) { checkContents(entry); });
+  auto hotBytes = cache_->loadHotSet(0).get();
+  EXPECT_LT(kRamBytes / 4, hotBytes);
+  EXPECT_GE(kRamBytes / 2, hotBytes);
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(0, stats.numShared);
+  EXPECT_EQ(0, stats.numExclusive);
+  auto bytesRead = cache_->ssdCache()->stats().bytesRead;
+  EXPECT_LE(hotBytes, bytesRead);
+
+  // The hot set is hit from RAM.
+  loadLoop(0, kRamBytes / 2);
+  EXPECT_GT(
+      hotBytes / 10, cache_->ssdCache()->stats().bytesRead - bytesRead);
+
+  // Loading is rate limited to 32MB/s.
+  constexpr uint64_t kBytesPerSecond = 32 << 20;
+  cache_->shutdown();
+  initializeCache(kRamBytes, kSsdBytes);
+  auto startMicros = getCurrentTimeMicro();
+  hotBytes = cache_->loadHotSet(kBytesPerSecond).get();
+  EXPECT_LT(0, hotBytes);
+  EXPECT_LE(
+      hotBytes * 1'000'000 / kBytesPerSecond * 9 / 10,
+      getCurrentTimeMicro() - startMicros);
+}
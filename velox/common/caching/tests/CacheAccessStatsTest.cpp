@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/CacheAccessStats.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::cache;
+
+TEST(CacheAccessStatsTest, latencyHistogram) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.percentile(50));
+  for (auto i = 0; i < 90; ++i) {
+    histogram.record(100);
+  }
+  for (auto i = 0; i < 10; ++i) {
+    histogram.record(5000);
+  }
+  EXPECT_EQ(100, histogram.count);
+  EXPECT_EQ(90 * 100 + 10 * 5000, histogram.sumMicros);
+  // 100us is in [64, 128) and 5000us in [4096, 8192).
+  EXPECT_EQ(128, histogram.percentile(50));
+  EXPECT_EQ(128, histogram.percentile(90));
+  EXPECT_EQ(8192, histogram.percentile(99));
+  // Very long latencies go to the last bucket.
+  histogram.record(1UL << 40);
+  EXPECT_EQ(
+      1UL << (LatencyHistogram::kNumBuckets - 1), histogram.percentile(100));
+}
+
+TEST(CacheAccessStatsTest, breakdown) {
+  CacheAccessStats stats;
+  TrackingId column1(1 << 5);
+  TrackingId column2(2 << 5);
+  stats.record(1, column1, CacheSource::kRam, 1000);
+  stats.record(1, column1, CacheSource::kRam, 1000);
+  stats.record(1, column1, CacheSource::kSsd, 1000, 200);
+  stats.record(1, column2, CacheSource::kStorage, 3000, 10000);
+  stats.record(2, column1, CacheSource::kStorage, 1000, 20000);
+  stats.record(2, column1, CacheSource::kSsd, 1000, 300);
+
+  auto entries = stats.snapshot();
+  EXPECT_EQ(3, entries.size());
+  for (auto& entry : entries) {
+    if (entry.groupId == 1 && entry.trackingId == column1) {
+      EXPECT_EQ(2, entry.counters.numRam);
+      EXPECT_EQ(1, entry.counters.numSsd);
+      EXPECT_EQ(0, entry.counters.numStorage);
+      EXPECT_NEAR(66.7, entry.counters.ramHitPct(), 0.1);
+      EXPECT_EQ(100, entry.counters.ssdHitPct());
+      EXPECT_EQ(256, entry.counters.ssdLatency.percentile(50));
+    }
+  }
+
+  auto group1 = stats.groupCounters(1);
+  EXPECT_EQ(6000, group1.totalBytes());
+  EXPECT_EQ(2000, group1.ramBytes);
+  EXPECT_EQ(25, group1.ssdHitPct());
+  EXPECT_EQ(1, group1.storageLatency.count);
+
+  auto total = stats.total();
+  EXPECT_EQ(8000, total.totalBytes());
+  EXPECT_EQ(2, total.ssdLatency.count);
+  EXPECT_EQ(2, total.storageLatency.count);
+  EXPECT_EQ(32768, total.storageLatency.percentile(100));
+
+  auto text = stats.toString(1);
+  EXPECT_NE(std::string::npos, text.find("8000 bytes"));
+  // Only the largest group and stream pair is listed.
+  EXPECT_NE(std::string::npos, text.find("group 1 stream"));
+  EXPECT_EQ(std::string::npos, text.find("group 2"));
+
+  stats.clear();
+  EXPECT_TRUE(stats.snapshot().empty());
+  EXPECT_EQ(0, stats.total().totalBytes());
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/FrequencySketch.h"
+
+#include <folly/hash/Hash.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace facebook::velox::cache;
+
+TEST(FrequencySketchTest, estimate) {
+  FrequencySketch sketch(1 << 12);
+  auto hash = [](int32_t key) { return folly::hasher<int32_t>()(key); };
+  for (auto key = 0; key < 100; ++key) {
+    for (auto i = 0; i < key % 10; ++i) {
+      sketch.increment(hash(key));
+    }
+  }
+  // The counts are exact or overestimated by collisions.
+  int32_t numExact = 0;
+  for (auto key = 0; key < 100; ++key) {
+    auto estimate = sketch.estimate(hash(key));
+    EXPECT_LE(key % 10, estimate);
+    numExact += estimate == key % 10;
+  }
+  EXPECT_LE(90, numExact);
+  EXPECT_EQ(0, sketch.estimate(hash(1000)));
+
+  // Counts saturate at kMaxCount.
+  for (auto i = 0; i < 100; ++i) {
+    sketch.increment(hash(1000));
+  }
+  EXPECT_EQ(FrequencySketch::kMaxCount, sketch.estimate(hash(1000)));
+}
+
+TEST(FrequencySketchTest, aging) {
+  constexpr int32_t kNumCounters = 1 << 10;
+  FrequencySketch sketch(kNumCounters);
+  auto hash = [](int32_t key) { return folly::hasher<int32_t>()(key); };
+  for (auto i = 0; i < 8; ++i) {
+    sketch.increment(hash(-1));
+  }
+  EXPECT_EQ(8, sketch.estimate(hash(-1)));
+  // Accesses to another key fill the sample period and halve all counts.
+  for (auto i = 0; i < kNumCounters * 10 - 8; ++i) {
+    sketch.increment(hash(1));
+  }
+  EXPECT_EQ(1, sketch.numResets());
+  EXPECT_LE(4, sketch.estimate(hash(-1)));
+  EXPECT_GE(FrequencySketch::kMaxCount / 2, sketch.estimate(hash(-1)));
+  EXPECT_EQ(FrequencySketch::kMaxCount / 2, sketch.estimate(hash(1)));
+}
+
+TEST(FrequencySketchTest, concurrent) {
+  constexpr int32_t kNumCounters = 1 << 10;
+  constexpr int32_t kNumThreads = 8;
+  FrequencySketch sketch(kNumCounters);
+  auto hash = [](int32_t key) { return folly::hasher<int32_t>()(key); };
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kNumThreads; ++i) {
+    threads.push_back(std::thread([&]() {
+      for (auto j = 0; j < kNumCounters; ++j) {
+        sketch.increment(hash(j % 4));
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // Fewer increments than a sample period. The hot keys saturate.
+  EXPECT_EQ(0, sketch.numResets());
+  for (auto key = 0; key < 4; ++key) {
+    EXPECT_EQ(FrequencySketch::kMaxCount, sketch.estimate(hash(key)));
+  }
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/PrefetchScheduler.h"
+
+#include <folly/executors/InlineExecutor.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::cache;
+
+namespace {
+// A load of 'size' bytes whose IO is finished by the test.
+class TestingLoad : public CoalescedLoad {
+ public:
+  TestingLoad(int32_t id, int32_t size, std::vector<int32_t>& started)
+      : CoalescedLoad({}, {size}), id_(id), started_(started) {}
+
+  // Completes the IO started by the scheduler.
+  void finish() {
+    promise_.setValue(std::vector<CachePin>());
+  }
+
+ protected:
+  std::vector<CachePin> loadData(bool /*isPrefetch*/) override {
+    return {};
+  }
+
+  folly::SemiFuture<std::vector<CachePin>> loadDataAsync(
+      bool /*isPrefetch*/) override {
+    started_.push_back(id_);
+    return promise_.getSemiFuture();
+  }
+
+ private:
+  const int32_t id_;
+  std::vector<int32_t>& started_;
+  folly::Promise<std::vector<CachePin>> promise_;
+};
+} // namespace
+
+TEST(PrefetchSchedulerTest, budgetAndOrder) {
+  std::vector<int32_t> started;
+  PrefetchScheduler scheduler(&folly::InlineExecutor::instance(), 100);
+  auto group = scheduler.newGroup();
+  auto first = std::make_shared<TestingLoad>(1, 60, started);
+  auto second = std::make_shared<TestingLoad>(2, 60, started);
+  auto third = std::make_shared<TestingLoad>(3, 30, started);
+  scheduler.schedule(first, 300, group);
+  // 'third' would fit in the budget but waits for 'second', which is
+  // expected to be used first.
+  scheduler.schedule(third, 200, group);
+  scheduler.schedule(second, 100, group);
+  EXPECT_EQ(std::vector<int32_t>({1}), started);
+  EXPECT_EQ(60, scheduler.stats().inflightBytes);
+  EXPECT_EQ(2, scheduler.stats().numQueued);
+
+  first->finish();
+  EXPECT_EQ(std::vector<int32_t>({1, 2, 3}), started);
+  EXPECT_EQ(90, scheduler.stats().inflightBytes);
+  EXPECT_EQ(LoadState::kLoaded, first->state());
+
+  // A load larger than the budget starts when nothing is in flight.
+  auto large = std::make_shared<TestingLoad>(4, 200, started);
+  scheduler.schedule(large, 0, group);
+  second->finish();
+  third->finish();
+  EXPECT_EQ(std::vector<int32_t>({1, 2, 3, 4}), started);
+  large->finish();
+
+  auto stats = scheduler.stats();
+  EXPECT_EQ(4, stats.numScheduled);
+  EXPECT_EQ(4, stats.numStarted);
+  EXPECT_EQ(0, stats.inflightBytes);
+  EXPECT_EQ(0, stats.numQueued);
+}
+
+TEST(PrefetchSchedulerTest, cancelAndSkip) {
+  std::vector<int32_t> started;
+  PrefetchScheduler scheduler(&folly::InlineExecutor::instance(), 100);
+  auto group = scheduler.newGroup();
+  auto droppedGroup = scheduler.newGroup();
+  auto first = std::make_shared<TestingLoad>(1, 100, started);
+  auto dropped = std::make_shared<TestingLoad>(2, 50, started);
+  auto loadedByReader = std::make_shared<TestingLoad>(3, 50, started);
+  auto last = std::make_shared<TestingLoad>(4, 50, started);
+  scheduler.schedule(first, 100, group);
+  scheduler.schedule(dropped, 200, droppedGroup);
+  scheduler.schedule(loadedByReader, 300, group);
+  scheduler.schedule(last, 400, group);
+  EXPECT_EQ(3, scheduler.stats().numQueued);
+
+  // The reader of 'droppedGroup' goes away and the reader of
+  // 'loadedByReader' reads it on its own thread before the scheduler gets
+  // to it.
+  scheduler.cancel(droppedGroup);
+  EXPECT_TRUE(loadedByReader->loadOrFuture(nullptr));
+  EXPECT_EQ(2, scheduler.stats().numQueued);
+
+  first->finish();
+  EXPECT_EQ(std::vector<int32_t>({1, 4}), started);
+  last->finish();
+
+  auto stats = scheduler.stats();
+  EXPECT_EQ(4, stats.numScheduled);
+  EXPECT_EQ(2, stats.numStarted);
+  EXPECT_EQ(1, stats.numSkipped);
+  EXPECT_EQ(1, stats.numCancelled);
+  EXPECT_EQ(0, stats.numQueued);
+  EXPECT_EQ(LoadState::kPlanned, dropped->state());
+}
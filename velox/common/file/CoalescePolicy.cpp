@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/file/CoalescePolicy.h"
+
+#include <algorithm>
+
+namespace facebook::velox {
+
+CoalescePolicy::CoalescePolicy(CoalescePolicyOptions options)
+    : options_(options), maxDistance_(options.maxDistance) {}
+
+void CoalescePolicy::recordIo(uint64_t bytes, uint64_t micros) {
+  if (!options_.autoTune) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  Sample sample{static_cast<double>(bytes), static_cast<double>(micros)};
+  if (samples_.size() < kMaxSamples) {
+    samples_.push_back(sample);
+  } else {
+    samples_[nextSample_] = sample;
+    nextSample_ = (nextSample_ + 1) % kMaxSamples;
+  }
+  if (++numNewSamples_ >= kUpdateInterval) {
+    numNewSamples_ = 0;
+    update();
+  }
+}
+
+void CoalescePolicy::update() {
+  // Least squares fit of micros = latency + bytes * slope.
+  const double n = samples_.size();
+  double sumBytes = 0;
+  double sumMicros = 0;
+  for (auto& sample : samples_) {
+    sumBytes += sample.bytes;
+    sumMicros += sample.micros;
+  }
+  const double meanBytes = sumBytes / n;
+  const double meanMicros = sumMicros / n;
+  double covariance = 0;
+  double variance = 0;
+  for (auto& sample : samples_) {
+    covariance += (sample.bytes - meanBytes) * (sample.micros - meanMicros);
+    variance += (sample.bytes - meanBytes) * (sample.bytes - meanBytes);
+  }
+  if (variance == 0 || covariance <= 0) {
+    // The sizes do not vary enough to tell latency from transfer time.
+    return;
+  }
+  const double slope = covariance / variance;
+  const double latency = meanMicros - slope * meanBytes;
+  if (latency <= 0) {
+    return;
+  }
+  latencyUs_ = latency;
+  bytesPerUs_ = 1 / slope;
+  maxDistance_ = std::clamp<double>(
+      latency / slope, options_.minDistance, options_.maxTunedDistance);
+}
+
+// static
+CoalescePolicyOptions CoalescePolicy::localOptions() {
+  CoalescePolicyOptions options;
+  options.maxDistance = 20'000;
+  options.maxRangesPerIo = 40;
+  options.maxIoBytes = 1 << 20;
+  return options;
+}
+
+// static
+CoalescePolicyOptions CoalescePolicy::objectStoreOptions() {
+  CoalescePolicyOptions options;
+  options.maxDistance = 1 << 20;
+  options.maxRangesPerIo = 1000;
+  options.maxIoBytes = 16 << 20;
+  options.autoTune = true;
+  options.minDistance = 64 << 10;
+  options.maxTunedDistance = 8 << 20;
+  return options;
+}
+
+} // namespace facebook::velox
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace facebook::velox {
+
+struct CoalescePolicyOptions {
+  // Ranges separated by at most this many bytes are read by one IO and the
+  // bytes in between are dropped.
+  int32_t maxDistance{512 << 10};
+
+  // A coalesced IO covers at most this many ranges.
+  int32_t maxRangesPerIo{40};
+
+  // A coalesced IO covers at most this many bytes, including the gaps.
+  int64_t maxIoBytes{16 << 20};
+
+  // If true, 'maxDistance' follows the measured latency and bandwidth of the
+  // IOs, bounded by 'minDistance' and 'maxTunedDistance'.
+  bool autoTune{false};
+  int32_t minDistance{4 << 10};
+  int32_t maxTunedDistance{8 << 20};
+};
+
+// Decides how nearby reads of the files of a file system are merged into
+// fewer IOs. Object stores have a high per-request latency and want large
+// merged reads, local NVMe wants small precise reads. One CoalescePolicy is
+// shared by the files of a file system.
+//
+// With auto tuning, the policy fits 'latency + bytes / bandwidth' to the
+// recent IOs recorded with recordIo(). Reading a gap costs gap / bandwidth
+// and a separate IO costs the latency, so the break-even distance is
+// latency * bandwidth.
+class CoalescePolicy {
+ public:
+  explicit CoalescePolicy(CoalescePolicyOptions options);
+
+  int32_t maxDistance() const {
+    return maxDistance_;
+  }
+
+  int32_t maxRangesPerIo() const {
+    return options_.maxRangesPerIo;
+  }
+
+  int64_t maxIoBytes() const {
+    return options_.maxIoBytes;
+  }
+
+  // Records an IO of 'bytes' that took 'micros'. Does nothing unless auto
+  // tuning.
+  void recordIo(uint64_t bytes, uint64_t micros);
+
+  // Returns the fitted per-IO latency in microseconds and bandwidth in
+  // bytes per microsecond. 0 until the first fit.
+  double latencyUs() const {
+    return latencyUs_;
+  }
+
+  double bytesPerUs() const {
+    return bytesPerUs_;
+  }
+
+  // Options for local NVMe: short gaps and IOs.
+  static CoalescePolicyOptions localOptions();
+
+  // Options for object stores like S3: large merged IOs, auto tuned.
+  static CoalescePolicyOptions objectStoreOptions();
+
+ private:
+  static constexpr int32_t kMaxSamples = 256;
+  // Refits after this many new samples.
+  static constexpr int32_t kUpdateInterval = 32;
+
+  struct Sample {
+    double bytes;
+    double micros;
+  };
+
+  // Fits latency and bandwidth to 'samples_' and updates 'maxDistance_'.
+  void update();
+
+  const CoalescePolicyOptions options_;
+  std::atomic<int32_t> maxDistance_;
+  std::atomic<double> latencyUs_{0};
+  std::atomic<double> bytesPerUs_{0};
+
+  std::mutex mutex_;
+  // Ring of the most recent IOs.
+  std::vector<Sample> samples_;
+  int32_t nextSample_{0};
+  int32_t numNewSamples_{0};
+};
+
+} // namespace facebook::velox
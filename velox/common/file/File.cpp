@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/file/File.h"
+#include "velox/common/file/IoUring.h"
 
 #include <fmt/format.h>
 #include <glog/logging.h>
@@ -22,6 +23,9 @@
 #include <stdexcept>
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <folly/portability/SysUio.h>
 
 namespace facebook::velox {
@@ -72,7 +76,8 @@ LocalReadFile::LocalReadFile(std::string_view path) {
   VELOX_CHECK_GE(fd_, 0, "open failure in LocalReadFile constructor, {}.", fd_);
 }
 
-LocalReadFile::LocalReadFile(int32_t fd) : fd_(fd) {}
+LocalReadFile::LocalReadFile(int32_t fd, IoUring* ioUring)
+    : fd_(fd), ioUring_(ioUring) {}
 
 void LocalReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
@@ -122,6 +127,19 @@ uint64_t LocalReadFile::preadv(
   return folly::preadv(fd_, iovecs.data(), iovecs.size(), offset);
 }
 
+folly::SemiFuture<uint64_t> LocalReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  if (!ioUring_) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  try {
+    return ioUring_->preadv(fd_, offset, buffers);
+  } catch (const std::exception& e) {
+    return folly::makeSemiFuture<uint64_t>(e);
+  }
+}
+
 uint64_t LocalReadFile::size() const {
   if (size_ != -1) {
     return size_;
@@ -132,6 +150,15 @@ uint64_t LocalReadFile::size() const {
   return size_;
 }
 
+std::optional<uint64_t> LocalReadFile::modificationTime() const {
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    return std::nullopt;
+  }
+  return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1'000'000'000 +
+      st.st_mtim.tv_nsec;
+}
+
 uint64_t LocalReadFile::memoryUsage() const {
   // TODO: does FILE really not use any more memory? From the stdio.h
   // source code it looks like it has only a single integer? Probably
@@ -140,6 +167,109 @@ uint64_t LocalReadFile::memoryUsage() const {
   return sizeof(FILE);
 }
 
+MappedReadFile::MappedReadFile(std::string_view path) {
+  const std::string pathString(path);
+  fd_ = open(pathString.c_str(), O_RDONLY);
+  VELOX_CHECK_GE(
+      fd_, 0, "open failure in MappedReadFile constructor, {}.", path);
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    ::close(fd_);
+    VELOX_FAIL("fstat failure in MappedReadFile constructor, {}.", path);
+  }
+  size_ = st.st_size;
+  if (size_ == 0) {
+    return;
+  }
+  auto* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+  if (data == MAP_FAILED) {
+    ::close(fd_);
+    VELOX_FAIL(
+        "mmap failure in MappedReadFile constructor, {}, errno {}.",
+        path,
+        errno);
+  }
+  data_ = static_cast<char*>(data);
+}
+
+MappedReadFile::~MappedReadFile() {
+  if (data_) {
+    munmap(data_, size_);
+  }
+  ::close(fd_);
+}
+
+void MappedReadFile::checkRange(uint64_t offset, uint64_t length) const {
+  VELOX_CHECK_LE(
+      offset + length,
+      size_,
+      "Read past the end of MappedReadFile, offset {}, length {}.",
+      offset,
+      length);
+}
+
+std::string_view
+MappedReadFile::pread(uint64_t offset, uint64_t length, void* buf) const {
+  checkRange(offset, length);
+  bytesRead_ += length;
+  memcpy(buf, data_ + offset, length);
+  return {static_cast<char*>(buf), length};
+}
+
+std::string MappedReadFile::pread(uint64_t offset, uint64_t length) const {
+  checkRange(offset, length);
+  bytesRead_ += length;
+  return std::string(data_ + offset, length);
+}
+
+uint64_t MappedReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  uint64_t numRead = 0;
+  for (auto& range : buffers) {
+    if (offset >= size_) {
+      break;
+    }
+    auto copySize = std::min<size_t>(range.size(), size_ - offset);
+    if (range.data()) {
+      memcpy(range.data(), data_ + offset, copySize);
+    }
+    offset += copySize;
+    numRead += copySize;
+  }
+  bytesRead_ += numRead;
+  return numRead;
+}
+
+std::optional<uint64_t> MappedReadFile::modificationTime() const {
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    return std::nullopt;
+  }
+  return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1'000'000'000 +
+      st.st_mtim.tv_nsec;
+}
+
+std::optional<std::string_view> MappedReadFile::mappedRange(
+    uint64_t offset,
+    uint64_t length) const {
+  checkRange(offset, length);
+  bytesRead_ += length;
+  return std::string_view(data_ + offset, length);
+}
+
+void MappedReadFile::willNeed(uint64_t offset, uint64_t length) const {
+  if (!data_ || offset >= size_) {
+    return;
+  }
+  // madvise takes a page aligned address.
+  static const uint64_t kPageSize = sysconf(_SC_PAGESIZE);
+  const auto begin = offset & ~(kPageSize - 1);
+  const auto end = std::min<uint64_t>(offset + length, size_);
+  // The advice is a hint, so that a failure is not an error.
+  madvise(data_ + begin, end - begin, MADV_WILLNEED);
+}
+
 LocalWriteFile::LocalWriteFile(std::string_view path) {
   std::unique_ptr<char[]> buf(new char[path.size() + 1]);
   buf[path.size()] = 0;
@@ -30,6 +30,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -37,9 +38,12 @@
 #include <folly/futures/Future.h>
 
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/file/CoalescePolicy.h"
 
 namespace facebook::velox {
 
+class IoUring;
+
 // A read-only file.
 class ReadFile {
  public:
@@ -91,6 +95,12 @@ class ReadFile {
   // An estimate for the total amount of memory *this uses.
   virtual uint64_t memoryUsage() const = 0;
 
+  // Last modification time of the file in nanoseconds since the epoch, or
+  // std::nullopt if the file system does not report it.
+  virtual std::optional<uint64_t> modificationTime() const {
+    return std::nullopt;
+  }
+
   // The total number of bytes *this had been used to read since creation or
   // the last resetBytesRead. We sum all the |length| variables passed to
   // preads, not the actual amount of bytes read (which might be less).
@@ -102,8 +112,33 @@ class ReadFile {
     bytesRead_ = 0;
   }
 
+  // Returns the 'length' bytes at 'offset' without a copy if the file is
+  // mapped in memory. The view is valid for the lifetime of 'this'. Returns
+  // std::nullopt if the file is not mapped.
+  virtual std::optional<std::string_view> mappedRange(
+      uint64_t /*offset*/,
+      uint64_t /*length*/) const {
+    return std::nullopt;
+  }
+
+  // Hints that the range will be read soon. The default does nothing.
+  virtual void willNeed(uint64_t /*offset*/, uint64_t /*length*/) const {}
+
+  // Returns the policy for coalescing reads of 'this', nullptr if the
+  // reader should use its defaults. Set from the file system of the file.
+  CoalescePolicy* FOLLY_NULLABLE coalescePolicy() const {
+    return coalescePolicy_.get();
+  }
+
+  void setCoalescePolicy(std::shared_ptr<CoalescePolicy> policy) {
+    coalescePolicy_ = std::move(policy);
+  }
+
  protected:
   mutable std::atomic<uint64_t> bytesRead_ = 0;
+
+ private:
+  std::shared_ptr<CoalescePolicy> coalescePolicy_;
 };
 
 // A write-only file. Nothing written to the file should be read back until it
@@ -193,7 +228,11 @@ class LocalReadFile final : public ReadFile {
  public:
   explicit LocalReadFile(std::string_view path);
 
-  explicit LocalReadFile(int32_t fd);
+  // If 'ioUring' is given, preadvAsync() reads through it. 'ioUring' must
+  // outlive 'this'.
+  explicit LocalReadFile(
+      int32_t fd,
+      IoUring* FOLLY_NULLABLE ioUring = nullptr);
 
   std::string_view
   pread(uint64_t offset, uint64_t length, void* FOLLY_NONNULL buf) const final;
@@ -206,8 +245,18 @@ class LocalReadFile final : public ReadFile {
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const final;
 
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final {
+    return ioUring_ != nullptr;
+  }
+
   uint64_t memoryUsage() const final;
 
+  std::optional<uint64_t> modificationTime() const final;
+
   bool shouldCoalesce() const final {
     return false;
   }
@@ -217,9 +266,57 @@ class LocalReadFile final : public ReadFile {
       const;
 
   int32_t fd_;
+  IoUring* FOLLY_NULLABLE const ioUring_{nullptr};
   mutable long size_ = -1;
 };
 
+// Reads a local file through a read-only mapping of the whole file. pread()
+// copies from the mapping and mappedRange() returns views into it, so that
+// readers can decode uncompressed data from the page cache in place.
+// willNeed() tells the kernel to read the range ahead with MADV_WILLNEED.
+class MappedReadFile final : public ReadFile {
+ public:
+  explicit MappedReadFile(std::string_view path);
+
+  ~MappedReadFile() override;
+
+  std::string_view
+  pread(uint64_t offset, uint64_t length, void* FOLLY_NONNULL buf) const final;
+
+  std::string pread(uint64_t offset, uint64_t length) const final;
+
+  uint64_t preadv(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  uint64_t size() const final {
+    return size_;
+  }
+
+  uint64_t memoryUsage() const final {
+    return sizeof(*this);
+  }
+
+  std::optional<uint64_t> modificationTime() const final;
+
+  bool shouldCoalesce() const final {
+    return false;
+  }
+
+  std::optional<std::string_view> mappedRange(uint64_t offset, uint64_t length)
+      const final;
+
+  void willNeed(uint64_t offset, uint64_t length) const final;
+
+ private:
+  void checkRange(uint64_t offset, uint64_t length) const;
+
+  int32_t fd_;
+  uint64_t size_{0};
+  // nullptr for an empty file.
+  char* FOLLY_NULLABLE data_{nullptr};
+};
+
 class LocalWriteFile final : public WriteFile {
  public:
   // An error is thrown is a file already exists at |path|.
@@ -67,7 +67,12 @@ folly::once_flag localFSInstantiationFlag;
 class LocalFileSystem : public FileSystem {
  public:
   explicit LocalFileSystem(std::shared_ptr<const Config> config)
-      : FileSystem(config) {}
+      : FileSystem(config),
+        mmapRead_(
+            config_ && config_->get<bool>(kLocalFileSystemMmapRead, false)) {
+    coalescePolicy_ =
+        std::make_shared<CoalescePolicy>(CoalescePolicy::localOptions());
+  }
 
   ~LocalFileSystem() override {}
 
@@ -77,7 +82,10 @@ class LocalFileSystem : public FileSystem {
 
   std::unique_ptr<ReadFile> openFileForRead(std::string_view path) override {
     if (path.find(kFileScheme) == 0) {
-      return std::make_unique<LocalReadFile>(path.substr(kFileScheme.length()));
+      path = path.substr(kFileScheme.length());
+    }
+    if (mmapRead_) {
+      return std::make_unique<MappedReadFile>(path);
     }
     return std::make_unique<LocalReadFile>(path);
   }
@@ -120,6 +128,9 @@ class LocalFileSystem : public FileSystem {
       return lfs;
     };
   }
+
+ private:
+  const bool mmapRead_;
 };
 } // namespace
 
@@ -22,6 +22,7 @@
 #include <string_view>
 
 namespace facebook::velox {
+class CoalescePolicy;
 class Config;
 class ReadFile;
 class WriteFile;
@@ -46,8 +47,16 @@ class FileSystem {
   // Deletes the file at 'path'. Throws on error.
   virtual void remove(std::string_view path) = 0;
 
+  // Returns the policy for coalescing reads of the files of 'this'. nullptr
+  // means the readers' defaults.
+  const std::shared_ptr<CoalescePolicy>& coalescePolicy() const {
+    return coalescePolicy_;
+  }
+
  protected:
   std::shared_ptr<const Config> config_;
+  // Set by the subclass.
+  std::shared_ptr<CoalescePolicy> coalescePolicy_;
 };
 
 std::shared_ptr<FileSystem> getFileSystem(
@@ -64,6 +73,12 @@ void registerFileSystem(
     std::function<std::shared_ptr<FileSystem>(std::shared_ptr<const Config>)>
         fileSystemGenerator);
 
+// Config property of the local filesystem. If true, files are opened for
+// read as MappedReadFile, which reads them without a copy through a memory
+// mapping. The local filesystem is one instance per process, configured by
+// the config of its first use.
+constexpr const char* kLocalFileSystemMmapRead = "local.mmap-read-enabled";
+
 // Register the local filesystem.
 void registerLocalFileSystem();
 
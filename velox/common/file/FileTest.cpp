@@ -16,8 +16,13 @@
 
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/file/HedgedRead.h"
+#include "velox/common/file/IoUring.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
 
+#include <fcntl.h>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 using namespace facebook::velox;
@@ -68,6 +73,26 @@ void readData(ReadFile* readFile) {
   ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccddddd");
 }
 
+TEST(MappedFile, writeAndRead) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  MappedReadFile readFile(filename);
+  readData(&readFile);
+  readFile.willNeed(3, kOneMB);
+  auto range = readFile.mappedRange(kOneMB, 15);
+  ASSERT_TRUE(range.has_value());
+  ASSERT_EQ(range.value(), "ccccccccccddddd");
+  EXPECT_THROW(readFile.mappedRange(kOneMB, 16), VeloxRuntimeError);
+
+  LocalReadFile localFile(filename);
+  EXPECT_FALSE(localFile.mappedRange(0, 5).has_value());
+}
+
 // We could template this test, but that's kinda overkill for how simple it is.
 
 TEST(InMemoryFile, writeAndRead) {
@@ -108,3 +133,148 @@ TEST(LocalFile, viaRegistry) {
   ASSERT_EQ(readFile->pread(0, 5, &buffer1), "snarf");
   lfs->remove(filename);
 }
+
+TEST(LocalFile, ioUring) {
+  auto ring = IoUring::create(64);
+  if (!ring) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  auto fd = open(filename, O_RDONLY);
+  ASSERT_GE(fd, 0);
+  LocalReadFile readFile(fd, ring.get());
+  ASSERT_TRUE(readFile.hasPreadvAsync());
+
+  char head[12];
+  char tail[7];
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head, sizeof(head)),
+      folly::Range<char*>(
+          nullptr,
+          (char*)(uint64_t)(15 + kOneMB - sizeof(head) - sizeof(tail))),
+      folly::Range<char*>(tail, sizeof(tail))};
+  ASSERT_EQ(15 + kOneMB, readFile.preadvAsync(0, buffers).get());
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccddddd");
+
+  // Two reads in one submission, the second into a registered buffer.
+  std::string registered(100, 0);
+  ring->registerBuffers({folly::Range<char*>(registered.data(), 100)});
+  char first[5];
+  std::vector<IoUring::Request> requests;
+  requests.push_back({fd, 0, {{first, sizeof(first)}}});
+  requests.push_back({fd, 10 + kOneMB, {{registered.data() + 10, 5}}});
+  auto numSubmits = ring->numSubmits();
+  auto futures = ring->submit(std::move(requests));
+  EXPECT_EQ(numSubmits + 1, ring->numSubmits());
+  EXPECT_EQ(5, std::move(futures[0]).get());
+  EXPECT_EQ(5, std::move(futures[1]).get());
+  EXPECT_EQ(std::string_view(first, 5), "aaaaa");
+  EXPECT_EQ(registered.substr(10, 5), "ddddd");
+
+  // A read past the end of the file is short and fails.
+  char pastEnd[10];
+  EXPECT_THROW(
+      readFile.preadvAsync(10 + kOneMB, {{pastEnd, sizeof(pastEnd)}}).get(),
+      std::exception);
+  ring->unregisterBuffers();
+  close(fd);
+}
+
+TEST(HedgedReader, hedgeSlowAndFailedReads) {
+  HedgedReadOptions options;
+  options.minSamples = 10;
+  options.minDelayUs = 1000;
+  options.numThreads = 4;
+  HedgedReader reader(options);
+  std::string data = "abcdefgh";
+  auto copyData = [&](char* dest) { memcpy(dest, data.data(), data.size()); };
+  char buffer[8];
+
+  // Fast reads establish the latency distribution.
+  for (auto i = 0; i < 64; ++i) {
+    reader.read(
+        data.size(),
+        buffer,
+        [&](int32_t attempt, char* dest, const std::atomic<bool>&) {
+          EXPECT_EQ(0, attempt);
+          copyData(dest);
+        });
+  }
+  EXPECT_LE(1000, reader.delayUs());
+  auto before = HedgedReader::threadStats();
+
+  // The first request is slow and loses to the duplicate.
+  std::atomic<bool> firstCancelled{false};
+  memset(buffer, 0, sizeof(buffer));
+  reader.read(
+      data.size(),
+      buffer,
+      [&](int32_t attempt, char* dest, const std::atomic<bool>& cancelled) {
+        if (attempt == 0) {
+          while (!cancelled) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+          firstCancelled = true;
+          return;
+        }
+        copyData(dest);
+      });
+  EXPECT_EQ(data, std::string(buffer, sizeof(buffer)));
+  EXPECT_EQ(before.numHedged + 1, HedgedReader::threadStats().numHedged);
+  EXPECT_EQ(before.numHedgeWins + 1, HedgedReader::threadStats().numHedgeWins);
+  while (!firstCancelled) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // A failed first request is retried by the duplicate.
+  memset(buffer, 0, sizeof(buffer));
+  reader.read(
+      data.size(),
+      buffer,
+      [&](int32_t attempt, char* dest, const std::atomic<bool>&) {
+        if (attempt == 0) {
+          throw std::runtime_error("first request failed");
+        }
+        copyData(dest);
+      });
+  EXPECT_EQ(data, std::string(buffer, sizeof(buffer)));
+
+  // The error is thrown if both requests fail.
+  EXPECT_THROW(
+      reader.read(
+          data.size(),
+          buffer,
+          [&](int32_t, char*, const std::atomic<bool>&) {
+            throw std::runtime_error("request failed");
+          }),
+      std::runtime_error);
+}
+
+TEST(CoalescePolicy, autoTune) {
+  // IOs take 1ms plus 1us per 100 bytes, so gaps under 100KB are cheaper to
+  // read than to skip with a separate IO.
+  auto options = CoalescePolicy::objectStoreOptions();
+  CoalescePolicy policy(options);
+  EXPECT_EQ(options.maxDistance, policy.maxDistance());
+  for (auto i = 0; i < 64; ++i) {
+    const uint64_t bytes = (i % 16 + 1) * 64 << 10;
+    policy.recordIo(bytes, 1'000 + bytes / 100);
+  }
+  EXPECT_NEAR(1'000, policy.latencyUs(), 1);
+  EXPECT_NEAR(100, policy.bytesPerUs(), 1);
+  EXPECT_NEAR(100'000, policy.maxDistance(), 2'000);
+
+  // Without auto tuning the distance stays.
+  CoalescePolicy local(CoalescePolicy::localOptions());
+  for (auto i = 0; i < 64; ++i) {
+    local.recordIo(i << 10, 1'000);
+  }
+  EXPECT_EQ(20'000, local.maxDistance());
+}
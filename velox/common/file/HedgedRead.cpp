@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/common/file/HedgedRead.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+
+namespace facebook::velox {
+
+namespace {
+uint64_t nowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// State shared by the requests of a hedged read. Outlives the read if the
+// losing request is still running.
+struct HedgeState {
+  explicit HedgeState(uint64_t length) : length(length) {}
+
+  const uint64_t length;
+  std::mutex mutex;
+  std::condition_variable finished;
+  std::atomic<bool> cancelled{false};
+  // Destination of each request.
+  std::unique_ptr<char[]> data[2];
+  // Index of the first request to succeed, -1 if none has.
+  int32_t winner{-1};
+  int32_t numFailed{0};
+  std::exception_ptr error;
+};
+} // namespace
+
+HedgedReader::HedgedReader(HedgedReadOptions options) : options_(options) {
+  if (options_.percentile > 0 && options_.numThreads > 0) {
+    executor_ =
+        std::make_unique<folly::CPUThreadPoolExecutor>(options_.numThreads);
+  }
+}
+
+// static
+HedgedReader::Stats& HedgedReader::threadStats() {
+  thread_local Stats stats;
+  return stats;
+}
+
+void HedgedReader::read(uint64_t length, char* buffer, const ReadFunc& read) {
+  ++threadStats().numReads;
+  if (!executor_ || delayUs_ == 0) {
+    std::atomic<bool> cancelled{false};
+    auto start = nowUs();
+    read(0, buffer, cancelled);
+    recordLatency(nowUs() - start);
+    return;
+  }
+  hedgedRead(length, buffer, read);
+}
+
+void HedgedReader::hedgedRead(
+    uint64_t length,
+    char* buffer,
+    const ReadFunc& read) {
+  // The requests read into their own memory because the losing request may
+  // still write after this returns.
+  auto state = std::make_shared<HedgeState>(length);
+  auto start = nowUs();
+  auto launch = [&](int32_t attempt) {
+    state->data[attempt].reset(new char[length]);
+    executor_->add([state, attempt, read]() {
+      if (state->cancelled) {
+        return;
+      }
+      std::exception_ptr error;
+      try {
+        read(attempt, state->data[attempt].get(), state->cancelled);
+      } catch (const std::exception&) {
+        error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> l(state->mutex);
+      if (state->winner >= 0) {
+        return;
+      }
+      if (error) {
+        ++state->numFailed;
+        state->error = error;
+      } else {
+        state->winner = attempt;
+        state->cancelled = true;
+      }
+      state->finished.notify_all();
+    });
+  };
+  launch(0);
+  int32_t numLaunched = 1;
+  std::unique_lock<std::mutex> l(state->mutex);
+  auto done = [&]() {
+    return state->winner >= 0 || state->numFailed == numLaunched;
+  };
+  if (!state->finished.wait_for(
+          l, std::chrono::microseconds(delayUs_.load()), done) ||
+      (state->winner < 0 && numLaunched == 1)) {
+    // Slow or failed: the duplicate is also a retry.
+    ++threadStats().numHedged;
+    l.unlock();
+    launch(1);
+    l.lock();
+    numLaunched = 2;
+  }
+  state->finished.wait(l, done);
+  if (state->winner < 0) {
+    std::rethrow_exception(state->error);
+  }
+  if (state->winner == 1) {
+    ++threadStats().numHedgeWins;
+  }
+  auto winner = state->winner;
+  l.unlock();
+  std::memcpy(buffer, state->data[winner].get(), length);
+  recordLatency(nowUs() - start);
+}
+
+void HedgedReader::recordLatency(uint64_t latencyUs) {
+  if (options_.percentile <= 0) {
+    return;
+  }
+  std::vector<uint64_t> samples;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (latencies_.size() < kMaxSamples) {
+      latencies_.push_back(latencyUs);
+    } else {
+      latencies_[nextSample_] = latencyUs;
+      nextSample_ = (nextSample_ + 1) % kMaxSamples;
+    }
+    if (latencies_.size() < static_cast<size_t>(options_.minSamples) ||
+        ++numNewSamples_ < kUpdateInterval) {
+      return;
+    }
+    numNewSamples_ = 0;
+    samples = latencies_;
+  }
+  auto index = std::min<size_t>(
+      samples.size() - 1, samples.size() * options_.percentile);
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  delayUs_ = std::max(options_.minDelayUs, samples[index]);
+}
+
+} // namespace facebook::velox
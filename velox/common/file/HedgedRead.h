@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace facebook::velox {
+
+struct HedgedReadOptions {
+  // Percentile of recent read latencies after which a duplicate request is
+  // issued. 0 disables hedging.
+  double percentile{0.95};
+
+  // Reads are not hedged before this many latencies have been recorded.
+  int32_t minSamples{100};
+
+  // Lower bound for the delay before a duplicate request.
+  uint64_t minDelayUs{1000};
+
+  // Threads running the requests of hedged reads.
+  int32_t numThreads{16};
+};
+
+// Mitigates tail latency of remote storage by issuing a duplicate request
+// for a read that takes longer than a percentile of the recent reads of
+// the same file system. The first request to finish provides the data and
+// the other is cancelled. One HedgedReader is shared by the files of a
+// file system.
+class HedgedReader {
+ public:
+  // Reads the range of an attempt into 'dest'. 'attempt' is 0 for the first
+  // request and 1 for the duplicate, which the implementation may send to
+  // another replica or connection. The read should stop early if
+  // 'cancelled' becomes true. Throws on error.
+  using ReadFunc = std::function<void(
+      int32_t attempt, char* dest, const std::atomic<bool>& cancelled)>;
+
+  // Counters of the reads issued by the calling thread.
+  struct Stats {
+    uint64_t numReads{0};
+    // Reads that issued a duplicate request.
+    uint64_t numHedged{0};
+    // Hedged reads where the duplicate finished first.
+    uint64_t numHedgeWins{0};
+  };
+
+  explicit HedgedReader(HedgedReadOptions options);
+
+  // Reads 'length' bytes into 'buffer' with 'read'. Until enough latencies
+  // are known, 'read' runs on the calling thread directly into 'buffer'.
+  void read(uint64_t length, char* buffer, const ReadFunc& read);
+
+  // Returns the delay after which a read is hedged, 0 if reads are not
+  // hedged yet.
+  uint64_t delayUs() const {
+    return delayUs_;
+  }
+
+  // Returns the counters for the reads made by the calling thread. Callers
+  // attribute hedging to a query by comparing the counters before and after
+  // a read.
+  static Stats& threadStats();
+
+ private:
+  static constexpr int32_t kMaxSamples = 1024;
+  // Recomputes the delay after this many new latencies.
+  static constexpr int32_t kUpdateInterval = 64;
+
+  void recordLatency(uint64_t latencyUs);
+
+  void hedgedRead(uint64_t length, char* buffer, const ReadFunc& read);
+
+  const HedgedReadOptions options_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+  std::atomic<uint64_t> delayUs_{0};
+
+  std::mutex mutex_;
+  // Ring of the most recent latencies in microseconds.
+  std::vector<uint64_t> latencies_;
+  int32_t nextSample_{0};
+  int32_t numNewSamples_{0};
+};
+
+} // namespace facebook::velox
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/file/IoUring.h"
+#include "velox/common/base/Exceptions.h"
+
+#include <fmt/format.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+
+#ifdef VELOX_ENABLE_IO_URING
+#include <liburing.h>
+#endif
+
+namespace facebook::velox {
+
+#ifdef VELOX_ENABLE_IO_URING
+
+namespace {
+// Maximum iovecs of one readv or writev submission queue entry.
+constexpr int32_t kMaxIovecs = 1024;
+
+// A range of iovecs of a request that is one submission queue entry.
+struct Entry {
+  int32_t firstIovec;
+  int32_t numIovecs;
+  uint64_t offset;
+  // Index of the registered buffer containing the single iovec of the
+  // entry, -1 for a readv or writev.
+  int32_t bufferIndex;
+};
+} // namespace
+
+std::unique_ptr<IoUring> IoUring::create(int32_t queueDepth) {
+  auto ring = std::make_unique<io_uring>();
+  auto rc = io_uring_queue_init(queueDepth, ring.get(), 0);
+  if (rc < 0) {
+    LOG(WARNING) << "io_uring is not available: " << folly::errnoStr(-rc);
+    return nullptr;
+  }
+  return std::unique_ptr<IoUring>(new IoUring(ring.release()));
+}
+
+IoUring::IoUring(io_uring* ring) : ring_(ring) {
+  completionThread_ = std::thread([this]() { reapCompletions(); });
+}
+
+IoUring::~IoUring() {
+  {
+    std::lock_guard<std::mutex> l(submitMutex_);
+    stopping_ = true;
+    // A no-op with no Pending wakes up the completion thread.
+    auto sqe = io_uring_get_sqe(ring_);
+    while (!sqe) {
+      io_uring_submit(ring_);
+      std::this_thread::yield();
+      sqe = io_uring_get_sqe(ring_);
+    }
+    io_uring_prep_nop(sqe);
+    io_uring_sqe_set_data(sqe, nullptr);
+    io_uring_submit(ring_);
+  }
+  completionThread_.join();
+  io_uring_queue_exit(ring_);
+  delete ring_;
+}
+
+std::vector<folly::SemiFuture<uint64_t>> IoUring::submit(
+    std::vector<Request> requests) {
+  std::vector<folly::SemiFuture<uint64_t>> futures;
+  futures.reserve(requests.size());
+  std::lock_guard<std::mutex> l(submitMutex_);
+  VELOX_CHECK(!stopping_);
+  int32_t numQueued = 0;
+  for (auto& request : requests) {
+    auto pending = std::make_unique<Pending>();
+    pending->iovecs = std::move(request.iovecs);
+    futures.push_back(pending->promise.getSemiFuture());
+    // Plans all entries before queueing any so that 'numUnfinished' is
+    // final before the first completion can arrive.
+    std::vector<Entry> entries;
+    auto offset = request.offset;
+    auto& iovecs = pending->iovecs;
+    for (int32_t i = 0; i < iovecs.size(); ++i) {
+      auto bufferIndex = registeredBufferIndex(iovecs[i]);
+      if (bufferIndex >= 0) {
+        entries.push_back({i, 1, offset, bufferIndex});
+      } else if (
+          entries.empty() || entries.back().bufferIndex >= 0 ||
+          entries.back().numIovecs == kMaxIovecs) {
+        entries.push_back({i, 1, offset, -1});
+      } else {
+        ++entries.back().numIovecs;
+      }
+      offset += iovecs[i].iov_len;
+    }
+    pending->size = offset - request.offset;
+    if (entries.empty()) {
+      pending->promise.setValue(0);
+      continue;
+    }
+    pending->numUnfinished = entries.size();
+    auto* rawPending = pending.release();
+    for (auto& entry : entries) {
+      auto sqe = io_uring_get_sqe(ring_);
+      while (!sqe) {
+        // The submission queue is full. Hands the queued entries to the
+        // kernel to make space.
+        io_uring_submit(ring_);
+        ++numSubmits_;
+        numQueued = 0;
+        std::this_thread::yield();
+        sqe = io_uring_get_sqe(ring_);
+      }
+      auto* iovec = &rawPending->iovecs[entry.firstIovec];
+      if (entry.bufferIndex >= 0) {
+        if (request.isWrite) {
+          io_uring_prep_write_fixed(
+              sqe,
+              request.fd,
+              iovec->iov_base,
+              iovec->iov_len,
+              entry.offset,
+              entry.bufferIndex);
+        } else {
+          io_uring_prep_read_fixed(
+              sqe,
+              request.fd,
+              iovec->iov_base,
+              iovec->iov_len,
+              entry.offset,
+              entry.bufferIndex);
+        }
+        ++numFixedBufferIos_;
+      } else if (request.isWrite) {
+        io_uring_prep_writev(
+            sqe, request.fd, iovec, entry.numIovecs, entry.offset);
+      } else {
+        io_uring_prep_readv(
+            sqe, request.fd, iovec, entry.numIovecs, entry.offset);
+      }
+      io_uring_sqe_set_data(sqe, rawPending);
+      ++numQueued;
+    }
+    ++numRequests_;
+  }
+  if (numQueued) {
+    io_uring_submit(ring_);
+    ++numSubmits_;
+  }
+  return futures;
+}
+
+folly::SemiFuture<uint64_t> IoUring::preadv(
+    int32_t fd,
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) {
+  // Skipped ranges are read into 'droppedBytes'. The contents are never
+  // used so concurrent reads may share it.
+  static char droppedBytes[16 * 1024];
+  std::vector<iovec> iovecs;
+  iovecs.reserve(buffers.size());
+  for (auto& range : buffers) {
+    if (!range.data()) {
+      auto skipSize = range.size();
+      while (skipSize) {
+        auto bytes = std::min<size_t>(sizeof(droppedBytes), skipSize);
+        iovecs.push_back({droppedBytes, bytes});
+        skipSize -= bytes;
+      }
+    } else {
+      iovecs.push_back({range.data(), range.size()});
+    }
+  }
+  std::vector<Request> requests;
+  requests.push_back({fd, offset, std::move(iovecs), false});
+  return std::move(submit(std::move(requests))[0]);
+}
+
+folly::SemiFuture<uint64_t>
+IoUring::pwritev(int32_t fd, uint64_t offset, std::vector<iovec> iovecs) {
+  std::vector<Request> requests;
+  requests.push_back({fd, offset, std::move(iovecs), true});
+  return std::move(submit(std::move(requests))[0]);
+}
+
+void IoUring::registerBuffers(
+    const std::vector<folly::Range<char*>>& buffers) {
+  std::lock_guard<std::mutex> l(submitMutex_);
+  if (!registeredBuffers_.empty()) {
+    io_uring_unregister_buffers(ring_);
+    registeredBuffers_.clear();
+  }
+  std::vector<iovec> iovecs;
+  iovecs.reserve(buffers.size());
+  for (auto& buffer : buffers) {
+    iovecs.push_back({buffer.data(), buffer.size()});
+  }
+  std::sort(iovecs.begin(), iovecs.end(), [](auto& left, auto& right) {
+    return left.iov_base < right.iov_base;
+  });
+  auto rc = io_uring_register_buffers(ring_, iovecs.data(), iovecs.size());
+  if (rc < 0) {
+    // Registration fails if the memory exceeds RLIMIT_MEMLOCK. IO then
+    // goes through the unregistered path.
+    LOG(WARNING) << "io_uring buffer registration failed: "
+                 << folly::errnoStr(-rc);
+    return;
+  }
+  registeredBuffers_ = std::move(iovecs);
+}
+
+void IoUring::unregisterBuffers() {
+  std::lock_guard<std::mutex> l(submitMutex_);
+  if (!registeredBuffers_.empty()) {
+    io_uring_unregister_buffers(ring_);
+    registeredBuffers_.clear();
+  }
+}
+
+int32_t IoUring::registeredBufferIndex(const iovec& range) const {
+  if (registeredBuffers_.empty()) {
+    return -1;
+  }
+  auto start = reinterpret_cast<char*>(range.iov_base);
+  auto it = std::upper_bound(
+      registeredBuffers_.begin(),
+      registeredBuffers_.end(),
+      start,
+      [](char* address, const iovec& buffer) {
+        return address < reinterpret_cast<char*>(buffer.iov_base);
+      });
+  if (it == registeredBuffers_.begin()) {
+    return -1;
+  }
+  --it;
+  auto bufferStart = reinterpret_cast<char*>(it->iov_base);
+  if (start + range.iov_len > bufferStart + it->iov_len) {
+    return -1;
+  }
+  return it - registeredBuffers_.begin();
+}
+
+void IoUring::reapCompletions() {
+  for (;;) {
+    io_uring_cqe* cqe;
+    auto rc = io_uring_wait_cqe(ring_, &cqe);
+    if (rc == -EINTR) {
+      continue;
+    }
+    VELOX_CHECK_EQ(rc, 0, "io_uring_wait_cqe failed: {}", folly::errnoStr(-rc));
+    auto* pending = reinterpret_cast<Pending*>(io_uring_cqe_get_data(cqe));
+    auto result = cqe->res;
+    io_uring_cqe_seen(ring_, cqe);
+    if (!pending) {
+      if (stopping_) {
+        return;
+      }
+      continue;
+    }
+    if (result < 0) {
+      if (!pending->error) {
+        pending->error = result;
+      }
+    } else {
+      pending->transferred += result;
+    }
+    if (--pending->numUnfinished > 0) {
+      continue;
+    }
+    std::unique_ptr<Pending> finished(pending);
+    if (finished->error) {
+      finished->promise.setException(std::runtime_error(fmt::format(
+          "io_uring IO failed: {}", folly::errnoStr(-finished->error))));
+    } else if (finished->transferred != finished->size) {
+      finished->promise.setException(std::runtime_error(fmt::format(
+          "io_uring IO transferred {} of {} bytes",
+          finished->transferred,
+          finished->size)));
+    } else {
+      finished->promise.setValue(finished->transferred);
+    }
+  }
+}
+
+#else
+
+std::unique_ptr<IoUring> IoUring::create(int32_t /*queueDepth*/) {
+  return nullptr;
+}
+
+IoUring::IoUring(io_uring* ring) : ring_(ring) {}
+
+IoUring::~IoUring() {}
+
+std::vector<folly::SemiFuture<uint64_t>> IoUring::submit(
+    std::vector<Request> /*requests*/) {
+  VELOX_UNSUPPORTED("Velox is not built with io_uring");
+}
+
+folly::SemiFuture<uint64_t> IoUring::preadv(
+    int32_t /*fd*/,
+    uint64_t /*offset*/,
+    const std::vector<folly::Range<char*>>& /*buffers*/) {
+  VELOX_UNSUPPORTED("Velox is not built with io_uring");
+}
+
+folly::SemiFuture<uint64_t> IoUring::pwritev(
+    int32_t /*fd*/,
+    uint64_t /*offset*/,
+    std::vector<iovec> /*iovecs*/) {
+  VELOX_UNSUPPORTED("Velox is not built with io_uring");
+}
+
+void IoUring::registerBuffers(
+    const std::vector<folly::Range<char*>>& /*buffers*/) {
+  VELOX_UNSUPPORTED("Velox is not built with io_uring");
+}
+
+void IoUring::unregisterBuffers() {}
+
+int32_t IoUring::registeredBufferIndex(const iovec& /*range*/) const {
+  return -1;
+}
+
+void IoUring::reapCompletions() {}
+
+#endif
+
+// static
+IoUring* IoUring::instance() {
+  static auto ring = create();
+  return ring.get();
+}
+
+} // namespace facebook::velox
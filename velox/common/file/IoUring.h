@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <folly/Range.h>
+#include <folly/futures/Future.h>
+#include <sys/uio.h>
+
+struct io_uring;
+
+namespace facebook::velox {
+
+// Asynchronous file IO over a Linux io_uring. Requests are submitted on
+// the calling thread and a background thread reaps the completions and
+// fulfills the SemiFutures of the requests. Available only if built with
+// VELOX_ENABLE_IO_URING and the kernel supports io_uring. Thread safe.
+class IoUring {
+ public:
+  // A read or write of 'iovecs' at 'offset' of 'fd'.
+  struct Request {
+    int32_t fd;
+    uint64_t offset;
+    std::vector<iovec> iovecs;
+    bool isWrite{false};
+  };
+
+  // Returns a ring with 'queueDepth' submission queue entries or nullptr
+  // if io_uring is not available.
+  static std::unique_ptr<IoUring> create(int32_t queueDepth = 256);
+
+  // Returns a process wide ring or nullptr if io_uring is not available.
+  static IoUring* FOLLY_NULLABLE instance();
+
+  ~IoUring();
+
+  // Submits 'requests' with a single system call. Each SemiFuture gets the
+  // bytes transferred by its request or the error. A request that moves
+  // fewer bytes than the size of its iovecs is an error.
+  std::vector<folly::SemiFuture<uint64_t>> submit(
+      std::vector<Request> requests);
+
+  // Reads 'fd' from 'offset' into the memory referenced by 'buffers' like
+  // ReadFile::preadv(). A buffer with nullptr data skips its size worth of
+  // bytes.
+  folly::SemiFuture<uint64_t> preadv(
+      int32_t fd,
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers);
+
+  folly::SemiFuture<uint64_t>
+  pwritev(int32_t fd, uint64_t offset, std::vector<iovec> iovecs);
+
+  // Registers 'buffers' with the kernel, replacing any previous
+  // registration. Reads into memory that is entirely inside one registered
+  // buffer, and writes from such memory, skip the per-request page mapping
+  // in the kernel. Registration pins the memory. The buffers must stay
+  // valid until they are unregistered or 'this' is destroyed. Must not be
+  // called while IO on registered buffers is in progress.
+  void registerBuffers(const std::vector<folly::Range<char*>>& buffers);
+
+  void unregisterBuffers();
+
+  // Number of submission system calls and requests. For testing.
+  uint64_t numSubmits() const {
+    return numSubmits_;
+  }
+
+  uint64_t numRequests() const {
+    return numRequests_;
+  }
+
+  // Number of reads and writes of registered buffers. For testing.
+  uint64_t numFixedBufferIos() const {
+    return numFixedBufferIos_;
+  }
+
+ private:
+  // The state of one Request. A request may need several submission queue
+  // entries.
+  struct Pending {
+    folly::Promise<uint64_t> promise;
+    // Expected bytes of the whole request.
+    uint64_t size{0};
+    // Bytes transferred so far.
+    uint64_t transferred{0};
+    // Submission queue entries that have not completed.
+    int32_t numUnfinished{0};
+    // Negative errno of the first failed entry, 0 if none.
+    int32_t error{0};
+    std::vector<iovec> iovecs;
+  };
+
+  explicit IoUring(io_uring* FOLLY_NONNULL ring);
+
+  // Returns the index of the registered buffer containing 'range', -1 if
+  // none.
+  int32_t registeredBufferIndex(const iovec& range) const;
+
+  // Reaps completions until 'this' is destroyed.
+  void reapCompletions();
+
+  // Owned. Released in the destructor.
+  io_uring* FOLLY_NONNULL ring_;
+
+  // Serializes submission.
+  std::mutex submitMutex_;
+
+  // Registered buffers, sorted on address.
+  std::vector<iovec> registeredBuffers_;
+
+  std::atomic<bool> stopping_{false};
+  std::thread completionThread_;
+
+  std::atomic<uint64_t> numSubmits_{0};
+  std::atomic<uint64_t> numRequests_{0};
+  std::atomic<uint64_t> numFixedBufferIos_{0};
+};
+
+} // namespace facebook::velox
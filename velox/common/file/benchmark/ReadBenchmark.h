@@ -46,7 +46,7 @@ DECLARE_int32(measurement_size);
 
 namespace facebook::velox {
 
-enum class Mode { Pread = 0, Preadv = 1, Multiple = 2 };
+enum class Mode { Pread = 0, Preadv = 1, Multiple = 2, PreadvAsync = 3 };
 
 // Struct to read data into. If we read contiguous and then copy to
 // non-contiguous buffers, we read to 'buffer' and copy to
@@ -142,6 +142,7 @@ class ReadBenchmark {
     clearCache();
     std::vector<folly::Promise<bool>> promises;
     std::vector<folly::SemiFuture<bool>> futures;
+    std::vector<folly::SemiFuture<folly::Unit>> asyncReads;
     uint64_t usec = 0;
     std::string label;
     {
@@ -256,8 +257,28 @@ class ReadBenchmark {
             }
             break;
           }
+          case Mode::PreadvAsync: {
+            // The reads of all repeats are in flight at the same time. Each
+            // repeat reads into its own scratch.
+            label = "async preadv";
+            auto scratch = std::make_shared<std::string>(rangeSize, 0);
+            std::vector<folly::Range<char*>> ranges;
+            for (auto start = 0; start < rangeSize; start += size + gap) {
+              ranges.push_back(
+                  folly::Range<char*>(scratch->data() + start, size));
+              if (gap && start + gap < rangeSize) {
+                ranges.push_back(folly::Range<char*>(nullptr, gap));
+              }
+            }
+            asyncReads.push_back(readFile_->preadvAsync(offset, ranges)
+                                     .deferValue([scratch](uint64_t) {}));
+            break;
+          }
         }
       }
+      for (auto& read : asyncReads) {
+        std::move(read).get();
+      }
       if (parallel) {
         auto& exec = folly::QueuedImmediateExecutor::instance();
         for (int32_t i = futures.size() - 1; i >= 0; --i) {
@@ -289,6 +310,9 @@ class ReadBenchmark {
     randomReads(size, gap, count, repeats, Mode::Pread, true);
     randomReads(size, gap, count, repeats, Mode::Preadv, true);
     randomReads(size, gap, count, repeats, Mode::Multiple, true);
+    if (readFile_->hasPreadvAsync()) {
+      randomReads(size, gap, count, repeats, Mode::PreadvAsync, false);
+    }
   }
 
   void run();
@@ -79,6 +79,29 @@ void AllocationPool::newRunImpl(memory::MachinePageCount numPages) {
   currentOffset_ = 0;
 }
 
+void AllocationPool::truncate(int32_t numAllocations) {
+  VELOX_CHECK_GT(numAllocations, 0);
+  VELOX_CHECK_LE(numAllocations, numSmallAllocations());
+  if (numAllocations == numSmallAllocations()) {
+    return;
+  }
+  {
+    // Trigger Allocation's destructor to free allocated memory
+    auto copy = std::move(allocation_);
+  }
+  allocation_ = std::move(*allocations_[numAllocations - 1]);
+  allocations_.resize(numAllocations - 1);
+  currentRun_ = allocation_.numRuns() - 1;
+  currentOffset_ = currentRun().numBytes();
+}
+
+int64_t AllocationPool::freeAllocation(int32_t index) {
+  VELOX_CHECK_GE(index, 0);
+  VELOX_CHECK_LT(
+      index, allocations_.size(), "Cannot free the current allocation");
+  return mappedMemory_->free(*allocations_[index]);
+}
+
 void AllocationPool::newRun(int32_t preferredSize) {
   auto numPages =
       bits::roundUp(preferredSize, memory::MappedMemory::kPageSize) /
@@ -41,6 +41,15 @@ class AllocationPool {
 
   char* allocateFixed(uint64_t bytes);
 
+  // Frees the small allocations after the first 'numAllocations'. The last
+  // remaining allocation becomes the current one with all its runs in use.
+  void truncate(int32_t numAllocations);
+
+  // Frees the small allocation at 'index' and returns the number of bytes
+  // freed. The allocation stays in place with no runs, so that the indices of
+  // the others do not change. The current allocation cannot be freed.
+  int64_t freeAllocation(int32_t index);
+
   // Starts a new run for variable length allocation. The actual size
   // is at least one machine page. Throws std::bad_alloc if no space.
   void newRun(int32_t preferredSize);
@@ -112,6 +112,18 @@ class ByteStream {
   void resetInput(std::vector<ByteRange>&& ranges) {
     ranges_ = std::move(ranges);
     current_ = &ranges_[0];
+    inputOwner_ = nullptr;
+  }
+
+  // Sets the owner of the memory of the input ranges. Readers that
+  // reference the input in place instead of copying it hold a reference
+  // to 'owner' for as long as they reference the input.
+  void setInputOwner(std::shared_ptr<void> owner) {
+    inputOwner_ = std::move(owner);
+  }
+
+  const std::shared_ptr<void>& inputOwner() const {
+    return inputOwner_;
   }
 
   void setRange(ByteRange range) {
@@ -252,6 +264,22 @@ class ByteStream {
         reinterpret_cast<char*>(current_->buffer) + position, viewSize);
   }
 
+  // Returns a pointer to the next 'size' bytes of input and advances
+  // past them if they are within one range and start at a multiple of
+  // 'alignment'. Returns nullptr and does not advance otherwise.
+  const uint8_t* readInPlace(int32_t size, int32_t alignment = 1) {
+    if (current_->position == current_->size && current_ != &ranges_.back()) {
+      next();
+    }
+    auto data = current_->buffer + current_->position;
+    if (current_->position + size > current_->size ||
+        reinterpret_cast<uintptr_t>(data) % alignment != 0) {
+      return nullptr;
+    }
+    current_->position += size;
+    return data;
+  }
+
   void skip(int32_t size) {
     for (;;) {
       int32_t available = current_->size - current_->position;
@@ -368,6 +396,9 @@ class ByteStream {
   std::vector<ByteRange> ranges_;
   // Pointer to the current element of 'ranges_'.
   ByteRange* current_ = nullptr;
+  // Keeps the memory of the input ranges alive for readers that
+  // reference it in place. nullptr if the input must be copied.
+  std::shared_ptr<void> inputOwner_;
 
   // Number of bits/bytes that have been written in the last element
   // of 'ranges_'. In a write situation, all non-last ranges are full
@@ -395,6 +395,150 @@ void HashStringAllocator::ensureAvailable(int32_t bytes, Position& position) {
   position = seek(position.header, fromHeader);
 }
 
+char* HashStringAllocator::Relocation::newAddress(const char* address) const {
+  auto it = std::upper_bound(
+      moves_.begin(),
+      moves_.end(),
+      address,
+      [](const char* value, const Move& move) { return value < move.from; });
+  if (it == moves_.begin()) {
+    return const_cast<char*>(address);
+  }
+  --it;
+  if (address >= it->from + it->size) {
+    return const_cast<char*>(address);
+  }
+  return it->to + (address - it->from);
+}
+
+void HashStringAllocator::Relocation::update(Position& position) const {
+  if (!position.header) {
+    return;
+  }
+  auto offset = position.position - reinterpret_cast<char*>(position.header);
+  position.header = newHeader(position.header);
+  position.position = reinterpret_cast<char*>(position.header) + offset;
+}
+
+int64_t HashStringAllocator::compact(
+    const std::function<void(const Relocation&)>& updatePointers) {
+  VELOX_CHECK(
+      !currentHeader_, "Do not call compact() when a write is in progress");
+  VELOX_CHECK_EQ(pool_.numLargeAllocations(), 0);
+  if (!numFree_) {
+    return 0;
+  }
+
+  // The slabs in allocation order. A slab ends at its kArenaEnd marker.
+  struct Slab {
+    char* begin;
+    char* end;
+    int32_t allocationIndex;
+  };
+  std::vector<Slab> slabs;
+  const auto numAllocations = pool_.numSmallAllocations();
+  for (auto i = 0; i < numAllocations; ++i) {
+    auto allocation = pool_.allocationAt(i);
+    int32_t numRuns = allocation->numRuns();
+    if (i == numAllocations - 1) {
+      // The runs after the current one are not in use yet.
+      numRuns = std::min(numRuns, pool_.currentRunIndex() + 1);
+    }
+    for (auto runIndex = 0; runIndex < numRuns; ++runIndex) {
+      auto run = allocation->runAt(runIndex);
+      slabs.push_back(
+          {run.data<char>(),
+           run.data<char>() + run.numBytes() - sizeof(Header),
+           i});
+    }
+  }
+
+  // Slides the allocated blocks towards the first slab. A block that does
+  // not fit in the rest of the destination slab goes to the next one. The
+  // rest of a slab is left either empty or large enough for a free block.
+  // The destination is never after the block, so that only blocks that are
+  // already moved are overwritten.
+  constexpr int32_t kMinBlock = sizeof(Header) + kMinAlloc;
+  Relocation relocation;
+  // First unused byte of each slab after compaction.
+  std::vector<char*> fill(slabs.size());
+  int32_t destSlab = 0;
+  char* dest = slabs[0].begin;
+  for (auto i = 0; i < slabs.size(); ++i) {
+    auto header = reinterpret_cast<Header*>(slabs[i].begin);
+    while (reinterpret_cast<char*>(header) != slabs[i].end) {
+      auto next = reinterpret_cast<Header*>(header->end());
+      if (!header->isFree()) {
+        const int32_t size = sizeof(Header) + header->size();
+        for (;;) {
+          auto available = slabs[destSlab].end - dest;
+          if (size == available || size + kMinBlock <= available) {
+            break;
+          }
+          VELOX_CHECK_LT(destSlab, i);
+          fill[destSlab++] = dest;
+          dest = slabs[destSlab].begin;
+        }
+        header->clearPreviousFree();
+        if (dest != reinterpret_cast<char*>(header)) {
+          relocation.moves_.push_back(
+              {reinterpret_cast<char*>(header), dest, size});
+          memmove(dest, header, size);
+        }
+        dest += size;
+      }
+      header = next;
+    }
+  }
+  fill[destSlab] = dest;
+  for (auto i = destSlab + 1; i < slabs.size(); ++i) {
+    fill[i] = slabs[i].begin;
+  }
+  std::sort(
+      relocation.moves_.begin(),
+      relocation.moves_.end(),
+      [](const Relocation::Move& left, const Relocation::Move& right) {
+        return left.from < right.from;
+      });
+
+  // Updates the continue pointers of the blocks in their new place.
+  for (auto i = 0; i <= destSlab; ++i) {
+    for (auto header = reinterpret_cast<Header*>(slabs[i].begin);
+         reinterpret_cast<char*>(header) != fill[i];
+         header = reinterpret_cast<Header*>(header->end())) {
+      if (header->isContinued()) {
+        auto continued =
+            reinterpret_cast<Header**>(header->end() - sizeof(void*));
+        *continued = relocation.newHeader(*continued);
+      }
+    }
+  }
+
+  // Frees the allocations after the one of the last used slab and makes a
+  // free block of the rest of each remaining slab.
+  const auto numKept = slabs[destSlab].allocationIndex + 1;
+  const auto bytesBefore = pool_.allocatedBytes();
+  pool_.truncate(numKept);
+  new (&free_) CompactDoubleList();
+  numFree_ = 0;
+  freeBytes_ = 0;
+  for (auto i = 0; i < slabs.size() && slabs[i].allocationIndex < numKept;
+       ++i) {
+    if (fill[i] == slabs[i].end) {
+      continue;
+    }
+    auto header =
+        new (fill[i]) Header(slabs[i].end - fill[i] - sizeof(Header));
+    header->setFree();
+    free_.insert(reinterpret_cast<CompactDoubleList*>(header->begin()));
+    ++numFree_;
+    freeBytes_ += sizeof(Header) + header->size();
+  }
+
+  updatePointers(relocation);
+  return bytesBefore - pool_.allocatedBytes();
+}
+
 void HashStringAllocator::checkConsistency() const {
   uint64_t numFree = 0;
   uint64_t freeBytes = 0;
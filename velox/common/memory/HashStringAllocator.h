@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <functional>
+
 #include "velox/common/memory/AllocationPool.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/common/memory/CompactDoubleList.h"
@@ -129,6 +131,46 @@ class HashStringAllocator : public StreamArena {
     char* FOLLY_NULLABLE position;
   };
 
+  // Maps the old addresses of the blocks moved by compact() to their new
+  // addresses. Owners of pointers into a HashStringAllocator use this to
+  // update their pointers after compaction.
+  class Relocation {
+   public:
+    // Returns the new address of 'address', which is the Header or a byte
+    // of the payload of a block. Returns 'address' if the block did not
+    // move.
+    char* FOLLY_NONNULL newAddress(const char* FOLLY_NONNULL address) const;
+
+    Header* FOLLY_NONNULL newHeader(Header* FOLLY_NONNULL header) const {
+      return reinterpret_cast<Header*>(
+          newAddress(reinterpret_cast<char*>(header)));
+    }
+
+    // Updates 'position' to point to the same byte of the moved
+    // block. 'position' may point to the end of the block. Does nothing if
+    // 'position' has no header.
+    void update(Position& position) const;
+
+    int32_t numMoves() const {
+      return moves_.size();
+    }
+
+   private:
+    friend class HashStringAllocator;
+
+    struct Move {
+      // Old address of the Header.
+      const char* FOLLY_NONNULL from;
+      // New address of the Header.
+      char* FOLLY_NONNULL to;
+      // Size of the block, including the Header.
+      int32_t size;
+    };
+
+    // Sorted on 'from'.
+    std::vector<Move> moves_;
+  };
+
   explicit HashStringAllocator(memory::MappedMemory* FOLLY_NONNULL mappedMemory)
       : StreamArena(mappedMemory),
         pool_(mappedMemory, AllocationPool::kHashTableOwner) {}
@@ -261,6 +303,28 @@ class HashStringAllocator : public StreamArena {
     return minFree;
   }
 
+  // Returns the number of bytes in free blocks, including their Headers.
+  uint64_t freeBytes() const {
+    return freeBytes_;
+  }
+
+  // Returns the number of free blocks. Many free blocks for the same
+  // freeBytes() mean that the free space is fragmented.
+  uint64_t numFreeBlocks() const {
+    return numFree_;
+  }
+
+  // Moves the allocated blocks next to each other at the start of the slabs
+  // of 'this', so that the free space is in a single block at the end of
+  // each slab, and frees the allocations whose slabs become empty. Calls
+  // 'updatePointers' with the new addresses of the moved blocks. This must
+  // update all pointers into 'this' that are held outside of
+  // 'this'. Updates the continue pointers of multipart allocations. Must
+  // not be called while a write is in progress. Returns the number of
+  // bytes given back to MappedMemory.
+  int64_t compact(
+      const std::function<void(const Relocation&)>& updatePointers);
+
   // Frees all memory associated with 'this' and leaves 'this' ready for reuse.
   void clear() {
     numFree_ = 0;
@@ -495,6 +495,10 @@ Stats Stats::operator-(const Stats& other) const {
     result.sizes[i] = sizes[i] - other.sizes[i];
   }
   result.numAdvise = numAdvise - other.numAdvise;
+  result.numHugePages = numHugePages - other.numHugePages;
+  result.numNumaLocalPages = numNumaLocalPages - other.numNumaLocalPages;
+  result.numCacheHits = numCacheHits - other.numCacheHits;
+  result.numCacheMisses = numCacheMisses - other.numCacheMisses;
   return result;
 }
 
@@ -507,10 +511,15 @@ std::string Stats::toString() const {
     totalBytes += sizes[i].totalBytes;
   }
   out << fmt::format(
-      "Alloc: {}MB {} Gigaclocks, {}MB advised\n",
+      "Alloc: {}MB {} Gigaclocks, {}MB advised, {}MB huge pages, "
+      "{}MB NUMA local, {} thread cache hits, {} misses\n",
       totalBytes >> 20,
       totalClocks >> 30,
-      numAdvise >> 8);
+      numAdvise >> 8,
+      numHugePages >> 8,
+      numNumaLocalPages >> 8,
+      numCacheHits,
+      numCacheMisses);
 
   // Sort the size classes by decreasing clocks.
   std::vector<int32_t> indices(sizes.size());
@@ -137,6 +137,20 @@ struct Stats {
 
   /// Cumulative count of pages advised away, if the allocator exposes this.
   int64_t numAdvise{0};
+
+  /// Cumulative count of pages in contiguous allocations advised to be
+  /// backed by huge pages, if the allocator exposes this. Memory with random
+  /// access that is not backed by huge pages is prone to TLB misses.
+  int64_t numHugePages{0};
+
+  /// Cumulative count of pages in contiguous allocations bound to the NUMA
+  /// node of the thread touching them, if the allocator exposes this.
+  int64_t numNumaLocalPages{0};
+
+  /// Cumulative count of size class pages served from and not found in
+  /// per-thread caches of freed pages, if the allocator has these.
+  int64_t numCacheHits{0};
+  int64_t numCacheMisses{0};
 };
 
 class ScopedMappedMemory;
@@ -456,6 +470,11 @@ class MappedMemory : public std::enable_shared_from_this<MappedMemory> {
     return Stats();
   }
 
+  // Returns the freed pages the calling thread keeps for reuse to the memory
+  // shared by all threads. Called when a thread stops allocating from 'this'
+  // for a while, e.g. at Driver exit.
+  virtual void flushThreadCache() {}
+
   virtual std::string toString() const;
 
  protected:
@@ -581,6 +600,10 @@ class ScopedMappedMemory final : public MappedMemory {
     return parent_->stats();
   }
 
+  void flushThreadCache() override {
+    parent_->flushThreadCache();
+  }
+
  private:
   std::shared_ptr<MappedMemory> parentPtr_;
   MappedMemory* FOLLY_NONNULL parent_;
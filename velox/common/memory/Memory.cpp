@@ -67,6 +67,23 @@ void MemoryAllocator::free(void* FOLLY_NULLABLE p, int64_t /* size */) {
   std::free(p);
 }
 
+MemoryUsageSnapshot MemoryPool::getMemoryUsageSnapshot() const {
+  MemoryUsageSnapshot snapshot;
+  const auto& tracker = getMemoryUsageTracker();
+  if (tracker) {
+    snapshot = MemoryUsageSnapshot::fromTracker(getName(), *tracker);
+  } else {
+    snapshot.name = getName();
+    snapshot.currentBytes = getCurrentBytes();
+    snapshot.peakBytes = getMaxBytes();
+  }
+  // The usage of 'this' includes the subtree.
+  visitChildren([&](MemoryPool* child) {
+    snapshot.addChild(child->getMemoryUsageSnapshot(), false);
+  });
+  return snapshot;
+}
+
 MemoryPoolBase::MemoryPoolBase(
     const std::string& name,
     std::weak_ptr<MemoryPool> parent)
@@ -134,6 +134,11 @@ class MemoryPool : public AbstractMemoryPool {
   // reference to self would be invalid after this call. This will also drop the
   // entire subtree.
   virtual void removeSelf() = 0;
+
+  // Returns a snapshot of the usage of 'this' and its subtree. Nodes with a
+  // MemoryUsageTracker report the usage of the tracker, others
+  // getCurrentBytes() and getMaxBytes().
+  MemoryUsageSnapshot getMemoryUsageSnapshot() const;
 };
 
 namespace detail {
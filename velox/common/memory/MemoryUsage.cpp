@@ -20,7 +20,14 @@ namespace facebook {
 namespace velox {
 namespace memory {
 void MemoryUsage::incrementCurrentBytes(int64_t size) {
-  setCurrentBytes(currentBytes_.load(std::memory_order_relaxed) + size);
+  // Atomic so that concurrent allocations from one pool do not lose updates.
+  auto current =
+      currentBytes_.fetch_add(size, std::memory_order_relaxed) + size;
+  auto previousMaxBytes = maxBytes_.load(std::memory_order_relaxed);
+  while (current > previousMaxBytes &&
+         !maxBytes_.compare_exchange_weak(
+             previousMaxBytes, current, std::memory_order_relaxed)) {
+  }
 }
 
 void MemoryUsage::setCurrentBytes(int64_t size) {
@@ -16,6 +16,10 @@
 
 #include "velox/common/memory/MemoryUsageTracker.h"
 
+#include <sstream>
+
+#include "velox/common/base/SuccinctPrinter.h"
+
 namespace facebook::velox::memory {
 std::shared_ptr<MemoryUsageTracker> MemoryUsageTracker::create(
     const std::shared_ptr<MemoryUsageTracker>& parent,
@@ -108,7 +112,10 @@ bool MemoryUsageTracker::maybeReserve(int64_t increment) {
       candidate = candidate->parent_.get();
       continue;
     }
-    if (limit - candidate->getCurrentTotalBytes() > addedReservation) {
+    // A GrowCallback may raise the limit of 'candidate', e.g. when a memory
+    // arbitrator manages the limit.
+    if (limit - candidate->getCurrentTotalBytes() > addedReservation ||
+        candidate->growCallback_) {
       try {
         reserve(addedReservation);
       } catch (const std::exception& e) {
@@ -121,4 +128,87 @@ bool MemoryUsageTracker::maybeReserve(int64_t increment) {
   return false;
 }
 
+
+// static
+MemoryUsageSnapshot MemoryUsageSnapshot::fromTracker(
+    const std::string& name,
+    const MemoryUsageTracker& tracker) {
+  MemoryUsageSnapshot snapshot;
+  snapshot.name = name;
+  snapshot.currentBytes = tracker.getCurrentTotalBytes();
+  snapshot.peakBytes = tracker.getPeakTotalBytes();
+  snapshot.allocatedBytes = tracker.getAllocatedBytes();
+  snapshot.sizeHistogram = tracker.getAllocationSizeHistogram();
+  return snapshot;
+}
+
+void MemoryUsageSnapshot::addChild(MemoryUsageSnapshot child, bool addUsage) {
+  if (addUsage) {
+    currentBytes += child.currentBytes;
+    peakBytes += child.peakBytes;
+  }
+  allocatedBytes += child.allocatedBytes;
+  for (auto i = 0; i < sizeHistogram.size(); ++i) {
+    sizeHistogram[i] += child.sizeHistogram[i];
+  }
+  children.push_back(std::move(child));
+}
+
+namespace {
+void collectLeaves(
+    const MemoryUsageSnapshot& snapshot,
+    const std::string& path,
+    std::vector<std::pair<std::string, const MemoryUsageSnapshot*>>& leaves) {
+  if (snapshot.children.empty()) {
+    leaves.emplace_back(path, &snapshot);
+    return;
+  }
+  for (const auto& child : snapshot.children) {
+    collectLeaves(child, path + "/" + child.name, leaves);
+  }
+}
+
+void appendSnapshot(
+    const MemoryUsageSnapshot& snapshot,
+    int32_t indent,
+    std::stringstream& out) {
+  out << std::string(indent, ' ') << snapshot.name << ": "
+      << succinctBytes(snapshot.currentBytes) << " current, "
+      << succinctBytes(snapshot.peakBytes) << " peak, "
+      << succinctBytes(snapshot.allocatedBytes) << " allocated in";
+  for (auto i = 0; i < snapshot.sizeHistogram.size(); ++i) {
+    if (snapshot.sizeHistogram[i] == 0) {
+      continue;
+    }
+    // The last bucket has the sizes above the limit of the one before it.
+    const bool last = i == snapshot.sizeHistogram.size() - 1;
+    out << " " << snapshot.sizeHistogram[i] << " x " << (last ? ">" : "<=")
+        << succinctBytes(4096L << (last ? i - 1 : i));
+  }
+  out << std::endl;
+  for (const auto& child : snapshot.children) {
+    appendSnapshot(child, indent + 2, out);
+  }
+}
+} // namespace
+
+std::vector<std::pair<std::string, const MemoryUsageSnapshot*>>
+MemoryUsageSnapshot::topConsumers(int32_t n) const {
+  std::vector<std::pair<std::string, const MemoryUsageSnapshot*>> leaves;
+  collectLeaves(*this, name, leaves);
+  std::sort(
+      leaves.begin(), leaves.end(), [](const auto& left, const auto& right) {
+        return left.second->currentBytes > right.second->currentBytes;
+      });
+  if (leaves.size() > n) {
+    leaves.resize(n);
+  }
+  return leaves;
+}
+
+std::string MemoryUsageSnapshot::toString() const {
+  std::stringstream out;
+  appendSnapshot(*this, 0, out);
+  return out.str();
+}
 } // namespace facebook::velox::memory
@@ -20,6 +20,8 @@
 #include <atomic>
 #include <memory>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
@@ -94,6 +96,11 @@ class MemoryUsageTracker
  public:
   enum class UsageType : int { kUserMem = 0, kSystemMem = 1, kTotalMem = 2 };
 
+  // Number of buckets in the histogram of allocation sizes. Bucket 0 counts
+  // the allocations up to 4KB, bucket i the ones up to 4KB << i and the last
+  // bucket all larger allocations.
+  static constexpr int32_t kNumSizeBuckets = 16;
+
   // Function to increase a MemoryUsageTracker's limits. This is called when an
   // allocation would exceed the tracker's size limit. The usage in
   // 'tracker' at the time of call is as if the allocation had
@@ -183,6 +190,8 @@ class MemoryUsageTracker
       }
       checkAndPropagateReservationIncrement(increment, false);
       usedReservation_.fetch_add(size);
+      ++allocationSizes_[sizeBucket(size)];
+      allocatedBytes_ += size;
       return;
     }
     // Decreasing usage. See if need to propagate upward.
@@ -235,6 +244,34 @@ class MemoryUsageTracker
     return total(cumulativeBytes_);
   }
 
+  // Returns the total of the sizes passed to update() for allocation. Unlike
+  // getCumulativeBytes(), this does not include the usage of children and is
+  // not rounded up to reservation sizes.
+  int64_t getAllocatedBytes() const {
+    return allocatedBytes_;
+  }
+
+  // Returns the count of allocations passed to update() for each bucket of
+  // sizes. See kNumSizeBuckets.
+  std::array<int64_t, kNumSizeBuckets> getAllocationSizeHistogram() const {
+    std::array<int64_t, kNumSizeBuckets> histogram;
+    for (auto i = 0; i < kNumSizeBuckets; ++i) {
+      histogram[i] = allocationSizes_[i];
+    }
+    return histogram;
+  }
+
+  // Returns the bucket of 'size' in the histogram of allocation sizes.
+  static int32_t sizeBucket(int64_t size) {
+    constexpr int32_t kSmallestBucketShift = 12;
+    if (size <= (1 << kSmallestBucketShift)) {
+      return 0;
+    }
+    return std::min<int32_t>(
+        kNumSizeBuckets - 1,
+        64 - __builtin_clzll((size - 1) >> kSmallestBucketShift));
+  }
+
   // Returns the total size including unused reservation.
   int64_t totalReservedBytes() {
     return user(currentUsageInBytes_) + system(currentUsageInBytes_);
@@ -276,7 +313,8 @@ class MemoryUsageTracker
   /// Checks if it is likely that the reservation on 'this' can be
   /// incremented by 'increment'. Returns false if this seems
   /// unlikely. Otherwise attempts the reservation increment and returns
-  /// true if succeeded.
+  /// true if succeeded. The increment is always attempted when reaching a
+  /// limited tracker with a GrowCallback on the path to the root.
   bool maybeReserve(int64_t increment);
 
  private:
@@ -385,6 +423,9 @@ class MemoryUsageTracker
   int64_t minReservation_{0};
   std::atomic<int64_t> usedReservation_{};
 
+  std::array<std::atomic<int64_t>, kNumSizeBuckets> allocationSizes_{};
+  std::atomic<int64_t> allocatedBytes_{0};
+
   GrowCallback growCallback_{};
 
   explicit MemoryUsageTracker(
@@ -432,4 +473,41 @@ class MemoryUsageTracker
     }
   }
 };
+
+// Snapshot of the memory usage of a component and its parts, e.g. a query,
+// its tasks, their pipelines and operators.
+struct MemoryUsageSnapshot {
+  std::string name;
+
+  // Current and peak usage including the children.
+  int64_t currentBytes{0};
+  int64_t peakBytes{0};
+
+  // Allocated bytes and count of allocations by size including the children.
+  // See MemoryUsageTracker::getAllocatedBytes() and kNumSizeBuckets.
+  int64_t allocatedBytes{0};
+  std::array<int64_t, MemoryUsageTracker::kNumSizeBuckets> sizeHistogram{};
+
+  std::vector<MemoryUsageSnapshot> children;
+
+  // Returns the usage recorded in 'tracker' without children.
+  static MemoryUsageSnapshot fromTracker(
+      const std::string& name,
+      const MemoryUsageTracker& tracker);
+
+  // Appends 'child' and adds its allocation counters to 'this'. Adds its
+  // current and peak usage if 'addUsage' is true, i.e. if 'this' is not made
+  // from a tracker that already includes the usage of 'child'. The sum of peaks
+  // assumes that the children peaked at the same time.
+  void addChild(MemoryUsageSnapshot child, bool addUsage);
+
+  // Returns the paths from 'this' to the 'n' leaves with the largest current
+  // usage, e.g. query/task/pipeline/operator, together with the leaves. The
+  // pointers are valid as long as 'this' is not changed.
+  std::vector<std::pair<std::string, const MemoryUsageSnapshot*>>
+  topConsumers(int32_t n) const;
+
+  // Returns an indented tree of the usage of 'this' and its children.
+  std::string toString() const;
+};
 } // namespace facebook::velox::memory
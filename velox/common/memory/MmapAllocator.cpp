@@ -18,9 +18,26 @@
 #include "velox/common/base/BitUtil.h"
 
 #include <sys/mman.h>
+#include <algorithm>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace facebook::velox::memory {
 
+namespace {
+#ifdef __linux__
+// MPOL_LOCAL from linux/mempolicy.h: Allocates on the node of the CPU that
+// triggers the page fault.
+constexpr int kMpolLocal = 4;
+#endif
+
+std::atomic<uint64_t> nextAllocatorId{0};
+} // namespace
+
+thread_local MmapAllocator::ThreadCacheMap MmapAllocator::threadCaches_;
+
 MmapAllocator::MmapAllocator(const MmapAllocatorOptions& options)
     : MappedMemory(),
       numAllocated_(0),
@@ -28,12 +45,29 @@ MmapAllocator::MmapAllocator(const MmapAllocatorOptions& options)
 
       capacity_(bits::roundUp(
           options.capacity / kPageSize,
-          64 * sizeClassSizes_.back())) {
+          64 * sizeClassSizes_.back())),
+      id_(nextAllocatorId++),
+      threadCacheBytes_(options.threadCacheBytes),
+      useHugePages_(options.useHugePages),
+      numaLocal_(options.numaLocal) {
   for (int size : sizeClassSizes_) {
     sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
   }
 }
 
+MmapAllocator::~MmapAllocator() {
+  std::lock_guard<std::mutex> l(threadCachesMutex_);
+  for (auto& cache : allThreadCaches_) {
+    // The cached pages go away with the size classes.
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+    cache->allocator = nullptr;
+    for (auto& pages : cache->pages) {
+      pages.clear();
+    }
+    cache->numBytes = 0;
+  }
+}
+
 bool MmapAllocator::allocate(
     MachinePageCount numPages,
     int32_t owner,
@@ -46,7 +80,11 @@ bool MmapAllocator::allocate(
   }
   auto mix = allocationSize(numPages, minSizeClass);
   if (numAllocated_ + mix.totalPages > capacity_) {
-    return false;
+    // Pages cached by threads count as allocated. Try again without them.
+    if (flushAllThreadCaches() == 0 ||
+        numAllocated_ + mix.totalPages > capacity_) {
+      return false;
+    }
   }
   if (numAllocated_.fetch_add(mix.totalPages) + mix.totalPages > capacity_) {
     numAllocated_.fetch_sub(mix.totalPages);
@@ -63,20 +101,29 @@ bool MmapAllocator::allocate(
     }
   }
   MachinePageCount newMapsNeeded = 0;
+  auto* cache = threadCacheBytes_ > 0 ? threadCache() : nullptr;
   for (int i = 0; i < mix.numSizes; ++i) {
+    ClassPageCount numClassPages = mix.sizeCounts[i];
+    if (cache) {
+      numClassPages -=
+          allocateFromCache(*cache, mix.sizeIndices[i], numClassPages, out);
+      if (numClassPages == 0) {
+        continue;
+      }
+    }
     bool success;
     stats_.recordAllocate(
         sizeClassSizes_[mix.sizeIndices[i]] * kPageSize,
-        mix.sizeCounts[i],
+        numClassPages,
         [&]() {
           success = sizeClasses_[mix.sizeIndices[i]]->allocate(
-              mix.sizeCounts[i], owner, newMapsNeeded, out);
+              numClassPages, owner, newMapsNeeded, out);
         });
     if (!success) {
       // This does not normally happen since any size class can accommodate
       // all the capacity. 'allocatedPages_' must be out of sync.
       LOG(WARNING) << "Failed allocation in size class " << i << " for "
-                   << mix.sizeCounts[i] << " pages";
+                   << numClassPages << " pages";
       auto failedPages = mix.totalPages - out.numPages();
       free(out);
       numAllocated_.fetch_sub(failedPages);
@@ -109,6 +156,10 @@ bool MmapAllocator::ensureEnoughMappedPages(int32_t newMappedNeeded) {
   // We need to advise away a number of pages or we fail the alloc.
   int target = totalMaps - capacity_;
   int numAdvised = adviseAway(target);
+  if (numAdvised < target && flushAllThreadCaches() > 0) {
+    // Cached pages are allocated and cannot be advised away while cached.
+    numAdvised += adviseAway(target - numAdvised);
+  }
   numAdvisedPages_ += numAdvised;
   if (numAdvised >= target) {
     numMapped_.fetch_sub(numAdvised);
@@ -119,9 +170,138 @@ bool MmapAllocator::ensureEnoughMappedPages(int32_t newMappedNeeded) {
 }
 
 int64_t MmapAllocator::free(Allocation& allocation) {
+  MachinePageCount numCached = 0;
+  if (threadCacheBytes_ > 0) {
+    numCached = cacheFreed(allocation);
+  }
   auto numFreed = freeInternal(allocation);
   numAllocated_.fetch_sub(numFreed);
-  return numFreed * kPageSize;
+  return (numFreed + numCached) * kPageSize;
+}
+
+MmapAllocator::ThreadCache* MmapAllocator::threadCache() {
+  auto& cache = threadCaches_.caches[id_];
+  if (!cache) {
+    cache = std::make_shared<ThreadCache>();
+    cache->allocator = this;
+    std::lock_guard<std::mutex> l(threadCachesMutex_);
+    // Drops the caches of exited threads, which are referenced only from here.
+    allThreadCaches_.erase(
+        std::remove_if(
+            allThreadCaches_.begin(),
+            allThreadCaches_.end(),
+            [](const auto& other) { return other.use_count() == 1; }),
+        allThreadCaches_.end());
+    allThreadCaches_.push_back(cache);
+  }
+  return cache.get();
+}
+
+MachinePageCount MmapAllocator::cacheFreed(Allocation& allocation) {
+  if (allocation.numRuns() == 0) {
+    return 0;
+  }
+  auto* cache = threadCache();
+  MachinePageCount numCached = 0;
+  // Runs or parts of runs that do not fit in 'cache'.
+  std::vector<std::pair<uint8_t*, int32_t>> remaining;
+  std::lock_guard<std::mutex> l(cache->mutex);
+  for (auto i = 0; i < allocation.numRuns(); ++i) {
+    auto run = allocation.runAt(i);
+    int32_t sizeIndex = 0;
+    while (!sizeClasses_[sizeIndex]->isInRange(run.data())) {
+      ++sizeIndex;
+      VELOX_CHECK_LT(
+          sizeIndex, sizeClasses_.size(), "Freeing a run not in a size class");
+    }
+    const auto unitSize = sizeClassSizes_[sizeIndex];
+    for (auto page = 0; page < run.numPages(); page += unitSize) {
+      auto* address = run.data() + page * kPageSize;
+      if (cache->numBytes + unitSize * kPageSize > threadCacheBytes_) {
+        remaining.emplace_back(address, run.numPages() - page);
+        break;
+      }
+      cache->pages[sizeIndex].push_back(address);
+      cache->numBytes += unitSize * kPageSize;
+      numCached += unitSize;
+    }
+  }
+  allocation.clear();
+  for (auto& [address, numPages] : remaining) {
+    allocation.append(address, numPages);
+  }
+  return numCached;
+}
+
+ClassPageCount MmapAllocator::allocateFromCache(
+    ThreadCache& cache,
+    int32_t sizeIndex,
+    ClassPageCount numPages,
+    Allocation& out) {
+  const auto unitSize = sizeClassSizes_[sizeIndex];
+  std::lock_guard<std::mutex> l(cache.mutex);
+  auto& pages = cache.pages[sizeIndex];
+  const ClassPageCount numHits =
+      std::min<ClassPageCount>(numPages, pages.size());
+  for (auto i = 0; i < numHits; ++i) {
+    out.append(pages.back(), unitSize);
+    pages.pop_back();
+  }
+  cache.numBytes -= numHits * unitSize * kPageSize;
+  numCacheHits_ += numHits;
+  numCacheMisses_ += numPages - numHits;
+  return numHits;
+}
+
+MachinePageCount MmapAllocator::flushLocked(ThreadCache& cache) {
+  MachinePageCount numFreed = 0;
+  for (auto i = 0; i < cache.pages.size(); ++i) {
+    if (cache.pages[i].empty()) {
+      continue;
+    }
+    // One Allocation per size class so that runs of adjacent size classes do
+    // not merge.
+    Allocation allocation(this);
+    for (auto* address : cache.pages[i]) {
+      allocation.append(address, sizeClassSizes_[i]);
+    }
+    cache.pages[i].clear();
+    numFreed += freeInternal(allocation);
+  }
+  cache.numBytes = 0;
+  numAllocated_.fetch_sub(numFreed);
+  return numFreed;
+}
+
+MachinePageCount MmapAllocator::flushAllThreadCaches() {
+  if (threadCacheBytes_ == 0) {
+    return 0;
+  }
+  MachinePageCount numFreed = 0;
+  std::lock_guard<std::mutex> l(threadCachesMutex_);
+  for (auto& cache : allThreadCaches_) {
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+    numFreed += flushLocked(*cache);
+  }
+  return numFreed;
+}
+
+void MmapAllocator::flushThreadCache() {
+  auto it = threadCaches_.caches.find(id_);
+  if (it == threadCaches_.caches.end()) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(it->second->mutex);
+  flushLocked(*it->second);
+}
+
+MmapAllocator::ThreadCacheMap::~ThreadCacheMap() {
+  for (auto& [id, cache] : caches) {
+    std::lock_guard<std::mutex> l(cache->mutex);
+    if (cache->allocator) {
+      cache->allocator->flushLocked(*cache);
+    }
+  }
 }
 MachinePageCount MmapAllocator::freeInternal(Allocation& allocation) {
   if (allocation.numRuns() == 0) {
@@ -249,13 +429,7 @@ bool MmapAllocator::allocateContiguousImpl(
     injectedFailure_ = Failure::kNone;
     data = nullptr;
   } else {
-    data = mmap(
-        nullptr,
-        numPages * kPageSize,
-        PROT_READ | PROT_WRITE,
-        MAP_PRIVATE | MAP_ANONYMOUS,
-        -1,
-        0);
+    data = mapContiguous(numPages);
   }
   if (!data) {
     // If the mmap failed, we have unmapped former 'allocation' and
@@ -268,6 +442,52 @@ bool MmapAllocator::allocateContiguousImpl(
   return true;
 }
 
+void* MmapAllocator::mapContiguous(MachinePageCount numPages) {
+  const uint64_t size = numPages * kPageSize;
+  const bool hugePages = useHugePages_ && size >= kHugePageSize;
+  // Maps an extra huge page worth of address space to align the start.
+  const uint64_t mapSize = hugePages ? size + kHugePageSize : size;
+  void* data = mmap(
+      nullptr,
+      mapSize,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0);
+  if (data == MAP_FAILED || !data) {
+    return nullptr;
+  }
+  if (hugePages) {
+    auto address = reinterpret_cast<uint64_t>(data);
+    auto aligned = bits::roundUp(address, kHugePageSize);
+    if (aligned > address) {
+      munmap(data, aligned - address);
+    }
+    auto end = aligned + size;
+    if (end < address + mapSize) {
+      munmap(reinterpret_cast<void*>(end), address + mapSize - end);
+    }
+    data = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    if (madvise(data, size, MADV_HUGEPAGE) == 0) {
+      numHugePages_ += numPages;
+    } else {
+      LOG(WARNING) << "madvise MADV_HUGEPAGE got errno " << errno;
+    }
+#endif
+  }
+#ifdef __linux__
+  if (numaLocal_) {
+    if (syscall(SYS_mbind, data, size, kMpolLocal, nullptr, 0, 0) == 0) {
+      numNumaLocalPages_ += numPages;
+    } else {
+      LOG(WARNING) << "mbind MPOL_LOCAL got errno " << errno;
+    }
+  }
+#endif
+  return data;
+}
+
 void MmapAllocator::freeContiguousImpl(ContiguousAllocation& allocation) {
   if (allocation.data() && allocation.size()) {
     if (munmap(allocation.data(), allocation.size()) < 0) {
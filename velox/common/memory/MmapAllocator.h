@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "velox/common/base/BitUtil.h"
@@ -35,6 +36,23 @@ using ClassPageCount = int32_t;
 struct MmapAllocatorOptions {
   //  Capacity in bytes, default 512MB
   uint64_t capacity = 1L << 29;
+
+  // If true, contiguous allocations of at least kHugePageSize, e.g. hash
+  // tables, are aligned to kHugePageSize and advised to be backed by
+  // transparent huge pages. This cuts TLB misses for random access over
+  // large tables.
+  bool useHugePages = false;
+
+  // If true, contiguous allocations are bound to the NUMA node of the thread
+  // that first touches the pages, regardless of the memory policy of the
+  // process.
+  bool numaLocal = false;
+
+  // Upper bound in bytes of the freed size class pages each thread keeps for
+  // its next allocations. Allocations served from the calling thread's cache
+  // do not contend for the size class mutexes. The cached pages count as
+  // allocated. 0 disables the caches.
+  uint64_t threadCacheBytes = 0;
 };
 // Implementation of MappedMemory with mmap and madvise. Each size
 // class is mmapped for the whole capacity. Each size class has a
@@ -52,8 +70,13 @@ class MmapAllocator : public MappedMemory {
  public:
   enum class Failure { kNone, kMadvise, kMmap };
 
+  // Size of a transparent huge page on x86_64 and aarch64 with 4K pages.
+  static constexpr uint64_t kHugePageSize = 2 << 20;
+
   explicit MmapAllocator(const MmapAllocatorOptions& options);
 
+  ~MmapAllocator() override;
+
   bool allocate(
       MachinePageCount numPages,
       int32_t owner,
@@ -113,9 +136,15 @@ class MmapAllocator : public MappedMemory {
   Stats stats() const override {
     auto stats = stats_;
     stats.numAdvise = numAdvisedPages_;
+    stats.numHugePages = numHugePages_;
+    stats.numNumaLocalPages = numNumaLocalPages_;
+    stats.numCacheHits = numCacheHits_;
+    stats.numCacheMisses = numCacheMisses_;
     return stats;
   }
 
+  void flushThreadCache() override;
+
  private:
   static constexpr uint64_t kAllSet = 0xffffffffffffffff;
 
@@ -251,6 +280,10 @@ class MmapAllocator : public MappedMemory {
 
   void freeContiguousImpl(ContiguousAllocation& allocation);
 
+  // Maps 'numPages' for a contiguous allocation and applies the huge page
+  // and NUMA options. Returns nullptr on failure.
+  void* FOLLY_NULLABLE mapContiguous(MachinePageCount numPages);
+
   // Ensures that there are at least 'newMappedNeeded' pages that are
   // not backing any existing allocation. If capacity_ - numMapped_ <
   // newMappedNeeded, advises away enough pages backing freed slots in
@@ -266,6 +299,55 @@ class MmapAllocator : public MappedMemory {
 
   void markAllMapped(const Allocation& allocation);
 
+  // Freed class pages kept for reuse by one thread.
+  struct ThreadCache {
+    // Serializes access from the owning thread and from flushes by other
+    // threads.
+    std::mutex mutex;
+
+    // The allocator of the pages. nullptr after the allocator is destroyed.
+    MmapAllocator* FOLLY_NULLABLE allocator;
+
+    // Class page addresses for each index in 'sizeClassSizes_'.
+    std::array<std::vector<uint8_t*>, kMaxSizeClasses> pages;
+
+    // Total size of 'pages'.
+    uint64_t numBytes{0};
+  };
+
+  // The caches of one thread, keyed on 'id_'. Flushes the caches on thread
+  // exit.
+  struct ThreadCacheMap {
+    ~ThreadCacheMap();
+
+    std::unordered_map<uint64_t, std::shared_ptr<ThreadCache>> caches;
+  };
+
+  // Returns the cache of the calling thread, making it on first use.
+  ThreadCache* FOLLY_NONNULL threadCache();
+
+  // Moves class pages of 'allocation' to the calling thread's cache while
+  // they fit and returns the number of machine pages moved. The pages that do
+  // not fit are left in 'allocation'.
+  MachinePageCount cacheFreed(Allocation& allocation);
+
+  // Appends up to 'numPages' class pages of 'sizeClassSizes_[sizeIndex]' from
+  // 'cache' to 'out' and returns their number.
+  ClassPageCount allocateFromCache(
+      ThreadCache& cache,
+      int32_t sizeIndex,
+      ClassPageCount numPages,
+      Allocation& out);
+
+  // Frees the pages in 'cache' and returns their number. Must be called
+  // inside 'cache.mutex'.
+  MachinePageCount flushLocked(ThreadCache& cache);
+
+  // Flushes the caches of all threads and returns the number of freed pages.
+  // Called when an allocation would fail because of pages that other threads
+  // keep cached.
+  MachinePageCount flushAllThreadCaches();
+
   // Finds at least  'target' unallocated pages in different size classes and
   // advises them away. Returns the number of pages advised away.
   MachinePageCount adviseAway(MachinePageCount target);
@@ -293,10 +375,30 @@ class MmapAllocator : public MappedMemory {
 
   std::vector<std::unique_ptr<SizeClass>> sizeClasses_;
 
+  // Distinguishes 'this' from other instances in 'threadCaches_'. Not an
+  // address since an address may be reused after destruction.
+  const uint64_t id_;
+
+  const uint64_t threadCacheBytes_;
+
+  // Serializes access to 'allThreadCaches_'.
+  std::mutex threadCachesMutex_;
+
+  // The caches of all threads that have freed memory of 'this'.
+  std::vector<std::shared_ptr<ThreadCache>> allThreadCaches_;
+
+  static thread_local ThreadCacheMap threadCaches_;
+
   // Statistics. Not atomic.
   uint64_t numAllocations_ = 0;
   uint64_t numAllocatedPages_ = 0;
   uint64_t numAdvisedPages_ = 0;
+  uint64_t numHugePages_ = 0;
+  uint64_t numNumaLocalPages_ = 0;
+  uint64_t numCacheHits_ = 0;
+  uint64_t numCacheMisses_ = 0;
+  const bool useHugePages_;
+  const bool numaLocal_;
   Failure injectedFailure_{Failure::kNone};
   Stats stats_;
 };
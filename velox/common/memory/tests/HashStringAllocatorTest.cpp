@@ -158,6 +158,81 @@ TEST_F(HashStringAllocatorTest, multipart) {
   instance_->checkConsistency();
 }
 
+TEST_F(HashStringAllocatorTest, compact) {
+  constexpr int32_t kNumSamples = 10'000;
+  std::vector<Multipart> data(kNumSamples);
+  auto append = [&](Multipart& item) {
+    auto chars = randomString();
+    ByteStream stream(instance_.get(), false, false);
+    if (item.start.header) {
+      instance_->extendWrite(item.current, stream);
+    } else {
+      item.start = instance_->newWrite(stream, chars.size());
+    }
+    stream.appendStringPiece(folly::StringPiece(chars.data(), chars.size()));
+    item.current = instance_->finishWrite(stream, 0);
+    item.reference.insert(item.reference.end(), chars.begin(), chars.end());
+  };
+  auto compact = [&]() {
+    return instance_->compact(
+        [&](const HashStringAllocator::Relocation& relocation) {
+          for (auto& item : data) {
+            relocation.update(item.start);
+            relocation.update(item.current);
+          }
+        });
+  };
+
+  for (auto count = 0; count < 2; ++count) {
+    for (auto& item : data) {
+      append(item);
+    }
+  }
+  // Frees 3 of 4 values and leaves the remaining spread over all slabs.
+  for (auto i = 0; i < kNumSamples; ++i) {
+    if (i % 4 != 0) {
+      checkAndFree(data[i]);
+    }
+  }
+  instance_->checkConsistency();
+  auto retainedSize = instance_->retainedSize();
+  auto numFreeBlocks = instance_->numFreeBlocks();
+
+  auto freedBytes = compact();
+  instance_->checkConsistency();
+  EXPECT_LT(0, freedBytes);
+  EXPECT_EQ(retainedSize - freedBytes, instance_->retainedSize());
+  EXPECT_GT(numFreeBlocks / 10, instance_->numFreeBlocks());
+  for (auto& item : data) {
+    if (item.start.header) {
+      checkMultipart(item);
+    }
+  }
+
+  // The moved values can be extended.
+  for (auto i = 0; i < kNumSamples; i += 4) {
+    append(data[i]);
+  }
+  instance_->checkConsistency();
+  for (auto& item : data) {
+    if (item.start.header) {
+      checkMultipart(item);
+    }
+  }
+
+  // Nothing moves when there is no free space before allocated blocks.
+  compact();
+  EXPECT_EQ(0, compact());
+  instance_->checkConsistency();
+
+  for (auto& item : data) {
+    if (item.start.header) {
+      checkAndFree(item);
+    }
+  }
+  instance_->checkConsistency();
+}
+
 TEST_F(HashStringAllocatorTest, rewrite) {
   ByteStream stream(instance_.get());
   auto header = instance_->allocate(5);
@@ -610,6 +610,89 @@ TEST_P(MappedMemoryTest, allocContiguousFail) {
   EXPECT_TRUE(instance->checkConsistency());
 }
 
+TEST_P(MappedMemoryTest, hugePagesAndNumaLocal) {
+  if (!useMmap_) {
+    return;
+  }
+  MmapAllocatorOptions options = {kMaxMappedMemory};
+  options.useHugePages = true;
+  options.numaLocal = true;
+  MmapAllocator instance(options);
+  constexpr int32_t kNumPages = 3 * MmapAllocator::kHugePageSize /
+      MappedMemory::kPageSize;
+  {
+    MappedMemory::ContiguousAllocation large;
+    ASSERT_TRUE(instance.allocateContiguous(kNumPages, nullptr, large));
+    EXPECT_EQ(
+        0,
+        reinterpret_cast<uint64_t>(large.data()) %
+            MmapAllocator::kHugePageSize);
+    EXPECT_EQ(kNumPages * MappedMemory::kPageSize, large.size());
+    memset(large.data(), 1, large.size());
+    instance.freeContiguous(large);
+  }
+  // The kernel may not support transparent huge pages or NUMA policies.
+  auto stats = instance.stats();
+  EXPECT_TRUE(stats.numHugePages == 0 || stats.numHugePages == kNumPages);
+  EXPECT_TRUE(
+      stats.numNumaLocalPages == 0 || stats.numNumaLocalPages == kNumPages);
+
+  // A contiguous allocation below the huge page size uses small pages.
+  MappedMemory::ContiguousAllocation small;
+  ASSERT_TRUE(instance.allocateContiguous(16, nullptr, small));
+  EXPECT_EQ(stats.numHugePages, instance.stats().numHugePages);
+  instance.freeContiguous(small);
+  EXPECT_EQ(0, instance.numAllocated());
+  EXPECT_TRUE(instance.checkConsistency());
+}
+
+TEST_P(MappedMemoryTest, threadCache) {
+  if (!useMmap_) {
+    return;
+  }
+  MmapAllocatorOptions options = {kMaxMappedMemory};
+  options.threadCacheBytes = 64 * MappedMemory::kPageSize;
+  MmapAllocator instance(options);
+  MappedMemory::Allocation allocation(&instance);
+  ASSERT_TRUE(instance.allocate(16, 0, allocation));
+  auto* address = allocation.runAt(0).data();
+  EXPECT_EQ(16 * MappedMemory::kPageSize, instance.free(allocation));
+  // The freed pages stay with this thread and count as allocated.
+  EXPECT_EQ(16, instance.numAllocated());
+  ASSERT_TRUE(instance.allocate(16, 0, allocation));
+  EXPECT_EQ(address, allocation.runAt(0).data());
+  EXPECT_EQ(1, instance.stats().numCacheHits);
+  EXPECT_EQ(1, instance.stats().numCacheMisses);
+  instance.free(allocation);
+  instance.flushThreadCache();
+  EXPECT_EQ(0, instance.numAllocated());
+
+  // A free that does not fit in the cache goes to the size classes.
+  ASSERT_TRUE(instance.allocate(128, 0, allocation));
+  instance.free(allocation);
+  EXPECT_EQ(0, instance.numAllocated());
+
+  // The cache of a thread is flushed when the thread exits.
+  std::thread([&]() {
+    MappedMemory::Allocation threadAllocation(&instance);
+    ASSERT_TRUE(instance.allocate(8, 0, threadAllocation));
+  }).join();
+  EXPECT_EQ(0, instance.numAllocated());
+
+  // An allocation of the whole capacity succeeds after flushing the caches
+  // of other threads.
+  ASSERT_TRUE(instance.allocate(16, 0, allocation));
+  instance.free(allocation);
+  std::thread([&]() {
+    MappedMemory::Allocation threadAllocation(&instance);
+    ASSERT_TRUE(instance.allocate(instance.capacity(), 0, threadAllocation));
+    instance.free(threadAllocation);
+    instance.flushThreadCache();
+  }).join();
+  EXPECT_EQ(0, instance.numAllocated());
+  EXPECT_TRUE(instance.checkConsistency());
+}
+
 TEST_P(MappedMemoryTest, allocateBytes) {
   constexpr int32_t kNumAllocs = 50;
   // Different sizes, including below minimum and above largest size class.
@@ -203,3 +203,59 @@ TEST(MemoryUsageTrackerTest, maybeReserve) {
   EXPECT_EQ(8 * kMB, child->getAvailableReservation());
   EXPECT_EQ(8 * kMB, parent->getCurrentUserBytes());
 }
+
+TEST(MemoryUsageTrackerTest, allocationSizeHistogram) {
+  constexpr int64_t kMB = 1 << 20;
+  EXPECT_EQ(0, MemoryUsageTracker::sizeBucket(1));
+  EXPECT_EQ(0, MemoryUsageTracker::sizeBucket(4096));
+  EXPECT_EQ(1, MemoryUsageTracker::sizeBucket(4097));
+  EXPECT_EQ(8, MemoryUsageTracker::sizeBucket(kMB));
+  EXPECT_EQ(
+      MemoryUsageTracker::kNumSizeBuckets - 1,
+      MemoryUsageTracker::sizeBucket(1L << 40));
+
+  auto parent = MemoryUsageTracker::create();
+  auto child = parent->addChild();
+  child->update(100);
+  child->update(200);
+  child->update(kMB);
+  child->update(-kMB);
+  auto histogram = child->getAllocationSizeHistogram();
+  EXPECT_EQ(2, histogram[0]);
+  EXPECT_EQ(1, histogram[8]);
+  EXPECT_EQ(kMB + 300, child->getAllocatedBytes());
+  // Allocations are recorded where they are made.
+  EXPECT_EQ(0, parent->getAllocatedBytes());
+  child->update(-300);
+}
+
+TEST(MemoryUsageTrackerTest, snapshot) {
+  constexpr int64_t kMB = 1 << 20;
+  auto query = MemoryUsageTracker::create();
+  auto small = query->addChild();
+  auto large = query->addChild();
+  small->update(1000);
+  large->update(10 * kMB);
+
+  auto snapshot = MemoryUsageSnapshot::fromTracker("query", *query);
+  snapshot.addChild(MemoryUsageSnapshot::fromTracker("small", *small), false);
+  snapshot.addChild(MemoryUsageSnapshot::fromTracker("large", *large), false);
+  EXPECT_EQ(query->getCurrentTotalBytes(), snapshot.currentBytes);
+  EXPECT_EQ(10 * kMB + 1000, snapshot.allocatedBytes);
+  EXPECT_EQ(1, snapshot.sizeHistogram[0]);
+
+  auto top = snapshot.topConsumers(1);
+  ASSERT_EQ(1, top.size());
+  EXPECT_EQ("query/large", top[0].first);
+  EXPECT_EQ(large->getCurrentTotalBytes(), top[0].second->currentBytes);
+  EXPECT_EQ(2, snapshot.topConsumers(10).size());
+  EXPECT_NE(std::string::npos, snapshot.toString().find("  small: "));
+
+  // A node without a tracker of its own sums up its children.
+  MemoryUsageSnapshot pipeline;
+  pipeline.addChild(MemoryUsageSnapshot::fromTracker("small", *small), true);
+  pipeline.addChild(MemoryUsageSnapshot::fromTracker("large", *large), true);
+  EXPECT_EQ(snapshot.currentBytes, pipeline.currentBytes);
+  small->update(-1000);
+  large->update(-10 * kMB);
+}
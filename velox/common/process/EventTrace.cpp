@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/process/EventTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#include <fmt/format.h>
+#include <folly/dynamic.h>
+#include <folly/json.h>
+
+namespace facebook::velox::process {
+
+namespace {
+// Track ids of lanes in the Chrome trace start here, above the thread
+// indices.
+constexpr int64_t kFirstLaneTid = 1'000'000;
+
+struct ThreadBuffer {
+  explicit ThreadBuffer(int32_t index)
+      : threadIndex(index), events(EventTrace::kBufferSize) {}
+
+  const int32_t threadIndex;
+  // Taken by the owning thread on record and by readers on export.
+  std::mutex mutex;
+  std::vector<TraceEvent> events;
+  uint64_t numRecorded{0};
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& registry() {
+  static Registry* instance = new Registry();
+  return *instance;
+}
+
+ThreadBuffer& threadBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (!buffer) {
+    auto& instance = registry();
+    std::lock_guard<std::mutex> l(instance.mutex);
+    buffer = std::make_shared<ThreadBuffer>(instance.buffers.size());
+    instance.buffers.push_back(buffer);
+  }
+  return *buffer;
+}
+
+thread_local uint64_t threadTraceId = 0;
+} // namespace
+
+void TraceEvent::setName(std::initializer_list<std::string_view> parts) {
+  int32_t size = 0;
+  for (auto part : parts) {
+    if (size > 0 && size < kMaxName) {
+      name[size++] = '.';
+    }
+    const auto numCopied = std::min<int32_t>(part.size(), kMaxName - size);
+    std::memcpy(name + size, part.data(), numCopied);
+    size += numCopied;
+  }
+  name[size] = '\0';
+}
+
+// static
+uint64_t EventTrace::newTraceId() {
+  static std::atomic<uint64_t> lastId{0};
+  return ++lastId;
+}
+
+// static
+uint64_t EventTrace::currentTraceId() {
+  return threadTraceId;
+}
+
+// static
+uint64_t EventTrace::nowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// static
+void EventTrace::record(TraceEvent& event) {
+  auto& buffer = threadBuffer();
+  event.threadIndex = buffer.threadIndex;
+  std::lock_guard<std::mutex> l(buffer.mutex);
+  buffer.events[buffer.numRecorded % kBufferSize] = event;
+  ++buffer.numRecorded;
+}
+
+// static
+std::vector<TraceEvent> EventTrace::events(uint64_t traceId) {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    auto& instance = registry();
+    std::lock_guard<std::mutex> l(instance.mutex);
+    buffers = instance.buffers;
+  }
+  std::vector<TraceEvent> result;
+  for (auto& buffer : buffers) {
+    std::lock_guard<std::mutex> l(buffer->mutex);
+    const auto numEvents =
+        std::min<uint64_t>(buffer->numRecorded, kBufferSize);
+    for (uint64_t i = 0; i < numEvents; ++i) {
+      if (buffer->events[i].traceId == traceId) {
+        result.push_back(buffer->events[i]);
+      }
+    }
+  }
+  std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+    return a.startMicros < b.startMicros;
+  });
+  return result;
+}
+
+// static
+std::string EventTrace::toChromeTrace(
+    const std::vector<TraceEvent>& events,
+    const std::string& processName,
+    std::string (*laneName)(int32_t lane)) {
+  auto metadata = [](const std::string& kind, int64_t tid, std::string name) {
+    return folly::dynamic::object("name", kind)("ph", "M")("pid", 0)(
+        "tid", tid)("args", folly::dynamic::object("name", std::move(name)));
+  };
+  auto traceEvents =
+      folly::dynamic::array(metadata("process_name", 0, processName));
+  std::vector<int32_t> threads;
+  std::vector<int32_t> lanes;
+  for (const auto& event : events) {
+    const bool isLane = event.lane >= 0;
+    const int64_t tid =
+        isLane ? kFirstLaneTid + event.lane : event.threadIndex;
+    traceEvents.push_back(folly::dynamic::object("name", event.name)(
+        "cat", event.category)("ph", "X")(
+        "ts", static_cast<int64_t>(event.startMicros))(
+        "dur", static_cast<int64_t>(event.durationMicros))("pid", 0)(
+        "tid", tid));
+    if (isLane) {
+      lanes.push_back(event.lane);
+    } else {
+      threads.push_back(event.threadIndex);
+    }
+  }
+  auto addTrackNames = [&](std::vector<int32_t>& ids, bool isLane) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    for (auto id : ids) {
+      if (isLane) {
+        traceEvents.push_back(metadata(
+            "thread_name",
+            kFirstLaneTid + id,
+            laneName ? laneName(id) : fmt::format("Lane {}", id)));
+      } else {
+        traceEvents.push_back(
+            metadata("thread_name", id, fmt::format("Thread {}", id)));
+      }
+    }
+  };
+  addTrackNames(threads, false);
+  addTrackNames(lanes, true);
+  return folly::toJson(folly::dynamic::object("traceEvents", traceEvents)(
+      "displayTimeUnit", "ms"));
+}
+
+ScopedTraceId::ScopedTraceId(uint64_t traceId) : previous_(threadTraceId) {
+  threadTraceId = traceId;
+}
+
+ScopedTraceId::~ScopedTraceId() {
+  threadTraceId = previous_;
+}
+
+void TraceSpan::start(
+    const char* category,
+    std::initializer_list<std::string_view> nameParts) {
+  event_.category = category;
+  event_.setName(nameParts);
+  event_.traceId = EventTrace::currentTraceId();
+  event_.startMicros = EventTrace::nowMicros();
+}
+
+void TraceSpan::finish() {
+  event_.durationMicros = EventTrace::nowMicros() - event_.startMicros;
+  EventTrace::record(event_);
+}
+
+} // namespace facebook::velox::process
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace facebook::velox::process {
+
+/// A time span recorded by EventTrace, e.g. an operator call or the wait of
+/// a blocked Driver.
+struct TraceEvent {
+  static constexpr int32_t kMaxName = 63;
+
+  /// Static string, e.g. "operator", "blocked", "io" or "spill".
+  const char* category{nullptr};
+  /// Copy of the parts given to setName(), joined by '.', truncated to
+  /// kMaxName characters.
+  char name[kMaxName + 1]{};
+  /// The traced unit of work, e.g. a Task. See EventTrace::newTraceId().
+  uint64_t traceId{0};
+  /// Microseconds of EventTrace::nowMicros().
+  uint64_t startMicros{0};
+  uint64_t durationMicros{0};
+  /// The index of the recording thread in order of first record.
+  int32_t threadIndex{0};
+  /// If set, the span belongs to this lane, e.g. a Driver, instead of the
+  /// recording thread. Spans of a lane must not overlap.
+  int32_t lane{-1};
+
+  void setName(std::initializer_list<std::string_view> parts);
+};
+
+/// Records TraceEvents in a ring buffer per thread. Recording takes an
+/// uncontended lock of the thread's buffer and a copy of the event. When a
+/// buffer is full, its oldest events are overwritten. The buffers are
+/// allocated on the first record of a thread and live for the process, so
+/// that the events of exited threads can still be exported.
+class EventTrace {
+ public:
+  /// Events per thread. A buffer takes under 1MB.
+  static constexpr int32_t kBufferSize = 8 * 1024;
+
+  /// Returns a new non-zero trace id.
+  static uint64_t newTraceId();
+
+  /// Returns the trace id scoped to the calling thread by ScopedTraceId or 0
+  /// if the thread is not tracing.
+  static uint64_t currentTraceId();
+
+  /// Monotonic clock of the events.
+  static uint64_t nowMicros();
+
+  /// Adds 'event' to the buffer of the calling thread. Sets its threadIndex.
+  static void record(TraceEvent& event);
+
+  /// Returns the events of 'traceId' still in the buffers, ordered by start.
+  static std::vector<TraceEvent> events(uint64_t traceId);
+
+  /// Returns 'events' as a Chrome trace, which chrome://tracing and
+  /// ui.perfetto.dev open. The spans of a thread and of a lane are on
+  /// separate tracks. 'laneName' gives the track name of a lane.
+  static std::string toChromeTrace(
+      const std::vector<TraceEvent>& events,
+      const std::string& processName,
+      std::string (*laneName)(int32_t lane) = nullptr);
+};
+
+/// Sets the trace id of the calling thread for the life of 'this', so that
+/// TraceSpans deeper in the stack, e.g. in IO, are attributed to it. A
+/// traceId of 0 leaves tracing off.
+class ScopedTraceId {
+ public:
+  explicit ScopedTraceId(uint64_t traceId);
+  ~ScopedTraceId();
+
+ private:
+  const uint64_t previous_;
+};
+
+/// Records the time between construction and destruction as a TraceEvent of
+/// the current trace id. Does nothing if the thread is not tracing.
+class TraceSpan {
+ public:
+  TraceSpan(
+      const char* category,
+      std::initializer_list<std::string_view> nameParts) {
+    if (EventTrace::currentTraceId() != 0) {
+      start(category, nameParts);
+    }
+  }
+
+  ~TraceSpan() {
+    if (event_.traceId != 0) {
+      finish();
+    }
+  }
+
+ private:
+  void start(
+      const char* category,
+      std::initializer_list<std::string_view> nameParts);
+
+  void finish();
+
+  TraceEvent event_;
+};
+
+} // namespace facebook::velox::process
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/process/PerfEvents.h"
+
+#include <glog/logging.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+#include <vector>
+#endif
+
+namespace facebook::velox::process {
+
+#ifdef __linux__
+namespace {
+
+// Returns the config of read misses of 'cache'.
+constexpr uint64_t cacheReadMisses(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+struct Event {
+  uint32_t type;
+  uint64_t config;
+  uint64_t PerfEventCounts::*count;
+};
+
+constexpr std::array<Event, 5> kEvents = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, &PerfEventCounts::cycles},
+    {PERF_TYPE_HARDWARE,
+     PERF_COUNT_HW_INSTRUCTIONS,
+     &PerfEventCounts::instructions},
+    {PERF_TYPE_HW_CACHE,
+     cacheReadMisses(PERF_COUNT_HW_CACHE_LL),
+     &PerfEventCounts::llcMisses},
+    {PERF_TYPE_HARDWARE,
+     PERF_COUNT_HW_BRANCH_MISSES,
+     &PerfEventCounts::branchMisses},
+    {PERF_TYPE_HW_CACHE,
+     cacheReadMisses(PERF_COUNT_HW_CACHE_DTLB),
+     &PerfEventCounts::dtlbMisses},
+}};
+
+// The counters of one thread. The first event that opens is the group leader
+// and the others are its members, so that one read() returns all counts.
+class ThreadPerfEvents {
+ public:
+  ThreadPerfEvents() {
+    for (const auto& event : kEvents) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = event.type;
+      attr.config = event.config;
+      // The members follow the leader, which is enabled after all opens.
+      attr.disabled = leaderFd_ < 0;
+      // Counting user mode only is allowed with the default
+      // kernel.perf_event_paranoid of 2.
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      const int fd = syscall(
+          __NR_perf_event_open, &attr, 0, -1, leaderFd_, PERF_FLAG_FD_CLOEXEC);
+      if (fd < 0) {
+        continue;
+      }
+      if (leaderFd_ < 0) {
+        leaderFd_ = fd;
+      } else {
+        memberFds_.push_back(fd);
+      }
+      counts_.push_back(event.count);
+    }
+    if (leaderFd_ < 0) {
+      LOG_FIRST_N(WARNING, 1)
+          << "perf_event_open() failed, hardware counters are not available: "
+          << std::strerror(errno);
+      return;
+    }
+    ioctl(leaderFd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  ~ThreadPerfEvents() {
+    for (auto fd : memberFds_) {
+      close(fd);
+    }
+    if (leaderFd_ >= 0) {
+      close(leaderFd_);
+    }
+  }
+
+  bool valid() const {
+    return leaderFd_ >= 0;
+  }
+
+  PerfEventCounts read() const {
+    // The number of events followed by their counts in the order of opening.
+    std::array<uint64_t, kEvents.size() + 1> buffer;
+    const auto size = (counts_.size() + 1) * sizeof(uint64_t);
+    PerfEventCounts counts;
+    if (::read(leaderFd_, buffer.data(), size) != static_cast<ssize_t>(size)) {
+      return counts;
+    }
+    for (auto i = 0; i < counts_.size(); ++i) {
+      counts.*counts_[i] = buffer[i + 1];
+    }
+    return counts;
+  }
+
+ private:
+  int leaderFd_{-1};
+  std::vector<int> memberFds_;
+  std::vector<uint64_t PerfEventCounts::*> counts_;
+};
+
+} // namespace
+
+std::optional<PerfEventCounts> readThreadPerfEvents() {
+  thread_local ThreadPerfEvents events;
+  if (!events.valid()) {
+    return std::nullopt;
+  }
+  return events.read();
+}
+#else
+std::optional<PerfEventCounts> readThreadPerfEvents() {
+  return std::nullopt;
+}
+#endif
+
+PerfEventTimer::PerfEventTimer(PerfEventCounts* counts) : counts_(counts) {
+  if (!counts_) {
+    return;
+  }
+  if (auto start = readThreadPerfEvents()) {
+    start_ = *start;
+  } else {
+    counts_ = nullptr;
+  }
+}
+
+PerfEventTimer::~PerfEventTimer() {
+  if (!counts_) {
+    return;
+  }
+  if (auto end = readThreadPerfEvents()) {
+    counts_->cycles += end->cycles - start_.cycles;
+    counts_->instructions += end->instructions - start_.instructions;
+    counts_->llcMisses += end->llcMisses - start_.llcMisses;
+    counts_->branchMisses += end->branchMisses - start_.branchMisses;
+    counts_->dtlbMisses += end->dtlbMisses - start_.dtlbMisses;
+  }
+}
+
+} // namespace facebook::velox::process
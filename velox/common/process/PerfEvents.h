@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+namespace facebook::velox::process {
+
+/// Counts of hardware events, e.g. of the time a Driver spends in an
+/// operator.
+struct PerfEventCounts {
+  uint64_t cycles{0};
+  uint64_t instructions{0};
+  uint64_t llcMisses{0};
+  uint64_t branchMisses{0};
+  uint64_t dtlbMisses{0};
+
+  void add(const PerfEventCounts& other) {
+    cycles += other.cycles;
+    instructions += other.instructions;
+    llcMisses += other.llcMisses;
+    branchMisses += other.branchMisses;
+    dtlbMisses += other.dtlbMisses;
+  }
+
+  void clear() {
+    cycles = 0;
+    instructions = 0;
+    llcMisses = 0;
+    branchMisses = 0;
+    dtlbMisses = 0;
+  }
+
+  bool empty() const {
+    return cycles == 0 && instructions == 0 && llcMisses == 0 &&
+        branchMisses == 0 && dtlbMisses == 0;
+  }
+};
+
+/// Returns the counts of hardware events of the calling thread in user mode
+/// since the first call on the thread. The counters are opened with
+/// perf_event_open() on the first call and stay open for the life of the
+/// thread. They form one group, so that they are counted over the same
+/// intervals. Events the CPU or hypervisor does not support count 0. Returns
+/// std::nullopt if no counter can be opened, e.g. outside of Linux, with a
+/// restrictive kernel.perf_event_paranoid or in a container whose seccomp
+/// profile denies perf_event_open().
+std::optional<PerfEventCounts> readThreadPerfEvents();
+
+/// Adds the hardware events of the calling thread between construction and
+/// destruction to 'counts'. Does nothing if 'counts' is nullptr or if the
+/// counters are not available.
+class PerfEventTimer {
+ public:
+  explicit PerfEventTimer(PerfEventCounts* counts);
+  ~PerfEventTimer();
+
+ private:
+  PerfEventCounts* counts_;
+  PerfEventCounts start_;
+};
+
+} // namespace facebook::velox::process
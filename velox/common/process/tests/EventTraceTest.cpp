@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/process/EventTrace.h"
+
+#include <fmt/format.h>
+#include <folly/json.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+using namespace facebook::velox::process;
+
+TEST(EventTraceTest, spans) {
+  const auto traceId = EventTrace::newTraceId();
+  {
+    TraceSpan untraced("operator", {"Untraced"});
+  }
+  {
+    ScopedTraceId scopedTraceId(traceId);
+    EXPECT_EQ(traceId, EventTrace::currentTraceId());
+    TraceSpan outer("driver", {"Driver", "run"});
+    TraceSpan inner("operator", {"FilterProject", "1", "getOutput"});
+  }
+  EXPECT_EQ(0, EventTrace::currentTraceId());
+
+  std::thread([&]() {
+    ScopedTraceId scopedTraceId(traceId);
+    TraceSpan span("io", {"read"});
+  }).join();
+
+  auto events = EventTrace::events(traceId);
+  ASSERT_EQ(3, events.size());
+  EXPECT_STREQ("Driver.run", events[0].name);
+  EXPECT_STREQ("driver", events[0].category);
+  EXPECT_STREQ("FilterProject.1.getOutput", events[1].name);
+  EXPECT_GE(events[1].startMicros, events[0].startMicros);
+  EXPECT_LE(events[1].durationMicros, events[0].durationMicros);
+  EXPECT_EQ(events[0].threadIndex, events[1].threadIndex);
+  EXPECT_STREQ("read", events[2].name);
+  EXPECT_NE(events[0].threadIndex, events[2].threadIndex);
+}
+
+TEST(EventTraceTest, ringBuffer) {
+  const auto traceId = EventTrace::newTraceId();
+  ScopedTraceId scopedTraceId(traceId);
+  for (auto i = 0; i < EventTrace::kBufferSize + 10; ++i) {
+    TraceSpan span("operator", {"op"});
+  }
+  EXPECT_EQ(EventTrace::kBufferSize, EventTrace::events(traceId).size());
+}
+
+TEST(EventTraceTest, truncatedName) {
+  TraceEvent event;
+  const std::string longName(100, 'x');
+  event.setName({"Operator", longName});
+  EXPECT_EQ(TraceEvent::kMaxName, strlen(event.name));
+  EXPECT_EQ(0, strncmp("Operator.xxx", event.name, 12));
+}
+
+TEST(EventTraceTest, chromeTrace) {
+  const auto traceId = EventTrace::newTraceId();
+  TraceEvent blocked;
+  blocked.category = "blocked";
+  blocked.setName({"Exchange", "kWaitForExchange"});
+  blocked.traceId = traceId;
+  blocked.startMicros = EventTrace::nowMicros();
+  blocked.durationMicros = 10;
+  blocked.lane = 3;
+  EventTrace::record(blocked);
+  {
+    ScopedTraceId scopedTraceId(traceId);
+    TraceSpan span("operator", {"Exchange", "0", "getOutput"});
+  }
+
+  auto trace = folly::parseJson(EventTrace::toChromeTrace(
+      EventTrace::events(traceId), "task", [](int32_t lane) {
+        return fmt::format("Driver {}", lane);
+      }));
+  std::unordered_map<std::string, const folly::dynamic*> spans;
+  std::vector<std::string> trackNames;
+  for (const auto& event : trace["traceEvents"]) {
+    if (event["ph"] == "X") {
+      spans[event["name"].asString()] = &event;
+    } else {
+      trackNames.push_back(event["args"]["name"].asString());
+    }
+  }
+  ASSERT_EQ(2, spans.size());
+  auto& blockedSpan = *spans["Exchange.kWaitForExchange"];
+  EXPECT_EQ("blocked", blockedSpan["cat"]);
+  EXPECT_EQ(10, blockedSpan["dur"].asInt());
+  EXPECT_EQ(1'000'003, blockedSpan["tid"].asInt());
+  EXPECT_EQ("operator", (*spans["Exchange.0.getOutput"])["cat"]);
+  ASSERT_EQ(3, trackNames.size());
+  EXPECT_EQ("task", trackNames[0]);
+  EXPECT_EQ("Driver 3", trackNames[2]);
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/process/PerfEvents.h"
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::process;
+
+namespace {
+uint64_t spin(int32_t numIterations) {
+  uint64_t sum = 0;
+  for (int32_t i = 0; i < numIterations; ++i) {
+    sum = sum * 31 + i;
+  }
+  return sum;
+}
+} // namespace
+
+TEST(PerfEventsTest, addAndClear) {
+  PerfEventCounts counts;
+  EXPECT_TRUE(counts.empty());
+  counts.add({10, 20, 1, 2, 3});
+  counts.add({1, 2, 0, 0, 1});
+  EXPECT_EQ(11, counts.cycles);
+  EXPECT_EQ(22, counts.instructions);
+  EXPECT_EQ(1, counts.llcMisses);
+  EXPECT_EQ(2, counts.branchMisses);
+  EXPECT_EQ(4, counts.dtlbMisses);
+  counts.clear();
+  EXPECT_TRUE(counts.empty());
+}
+
+TEST(PerfEventsTest, timer) {
+  // A timer without counts does nothing.
+  { PerfEventTimer timer(nullptr); }
+
+  if (!readThreadPerfEvents().has_value()) {
+    GTEST_SKIP() << "perf_event_open() is not available";
+  }
+  PerfEventCounts counts;
+  {
+    PerfEventTimer timer(&counts);
+    EXPECT_NE(0, spin(1'000'000));
+  }
+  EXPECT_GT(counts.instructions, 1'000'000);
+  auto previous = counts;
+  {
+    PerfEventTimer timer(&counts);
+    EXPECT_NE(0, spin(1'000'000));
+  }
+  EXPECT_GT(counts.instructions, previous.instructions + 1'000'000);
+}
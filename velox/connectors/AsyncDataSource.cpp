@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/AsyncDataSource.h"
+
+#include <algorithm>
+
+#include <folly/executors/InlineExecutor.h>
+
+namespace facebook::velox::connector {
+
+AsyncDataSource::AsyncDataSource(const ConnectorQueryCtx& connectorQueryCtx)
+    : maxPendingBatches_(std::max(1, connectorQueryCtx.maxPendingBatches())),
+      state_(std::make_shared<State>(connectorQueryCtx.preserveBatchOrder())) {
+}
+
+AsyncDataSource::~AsyncDataSource() {
+  // Unblocks a waiting caller. The requests in flight complete into
+  // 'state_', which they keep alive.
+  std::optional<ContinuePromise> promise;
+  {
+    std::lock_guard<std::mutex> l(state_->mutex);
+    promise = std::move(state_->promise);
+    state_->promise.reset();
+  }
+  if (promise.has_value()) {
+    promise->setValue();
+  }
+}
+
+void AsyncDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
+  VELOX_CHECK(
+      noMoreBatches_ && numPendingBatches() == 0,
+      "Previous split has not been fully processed");
+  noMoreBatches_ = false;
+  startSplit(std::move(split));
+}
+
+// static
+void AsyncDataSource::setResult(
+    const std::shared_ptr<State>& state,
+    const std::shared_ptr<Batch>& batch,
+    folly::Try<RowVectorPtr>&& result) {
+  std::optional<ContinuePromise> promise;
+  {
+    std::lock_guard<std::mutex> l(state->mutex);
+    batch->result = std::move(result);
+    batch->ready = true;
+    if (state->promise.has_value() &&
+        (!state->preserveOrder || state->batches.front() == batch)) {
+      promise = std::move(state->promise);
+      state->promise.reset();
+    }
+  }
+  if (promise.has_value()) {
+    promise->setValue();
+  }
+}
+
+void AsyncDataSource::fetchBatches(uint64_t size) {
+  while (!noMoreBatches_ && numPendingBatches() < maxPendingBatches_) {
+    auto request = fetchBatch(size);
+    if (!request.has_value()) {
+      noMoreBatches_ = true;
+      return;
+    }
+    auto batch = std::make_shared<Batch>();
+    {
+      std::lock_guard<std::mutex> l(state_->mutex);
+      state_->batches.push_back(batch);
+    }
+    // The callback runs on the thread that completes the request, or here
+    // if it is already complete.
+    std::move(*request)
+        .via(&folly::InlineExecutor::instance())
+        .thenTry([state = state_, batch](folly::Try<RowVectorPtr>&& result) {
+          setResult(state, batch, std::move(result));
+        });
+  }
+}
+
+std::optional<RowVectorPtr> AsyncDataSource::next(
+    uint64_t size,
+    ContinueFuture& future) {
+  for (;;) {
+    fetchBatches(size);
+    folly::Try<RowVectorPtr> result;
+    {
+      std::lock_guard<std::mutex> l(state_->mutex);
+      auto& batches = state_->batches;
+      if (batches.empty()) {
+        VELOX_CHECK(noMoreBatches_);
+        return nullptr;
+      }
+      auto it = state_->preserveOrder
+          ? batches.begin()
+          : std::find_if(batches.begin(), batches.end(), [](const auto& b) {
+              return b->ready;
+            });
+      if (it == batches.end() || !(*it)->ready) {
+        auto [promise, waitFuture] =
+            makeVeloxContinuePromiseContract("AsyncDataSource::next");
+        state_->promise = std::move(promise);
+        future = std::move(waitFuture);
+        return std::nullopt;
+      }
+      result = std::move((*it)->result);
+      batches.erase(it);
+    }
+    // Throws the error of the request, if any.
+    auto& batch = result.value();
+    if (!batch) {
+      noMoreBatches_ = true;
+      continue;
+    }
+    if (batch->size() > 0) {
+      return batch;
+    }
+  }
+}
+
+} // namespace facebook::velox::connector
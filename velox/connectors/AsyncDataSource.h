@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include "velox/connectors/Connector.h"
+
+namespace facebook::velox::connector {
+
+// Base of DataSources that fetch batches with asynchronous requests, e.g.
+// to a key-value store or an HTTP service, where the latency of a request
+// is hidden by keeping several of them in flight. next() keeps up to
+// ConnectorQueryCtx::maxPendingBatches() requests of the current split
+// outstanding and returns their batches as they complete. The batches are
+// returned in the order of their requests unless
+// ConnectorQueryCtx::preserveBatchOrder() is false, in which case any
+// completed batch is returned first. If no batch is complete, next()
+// returns std::nullopt and a future that is realized when one completes.
+//
+// A subclass implements startSplit() and fetchBatch(). An error of a
+// request is thrown from the next() that would return its batch.
+class AsyncDataSource : public DataSource {
+ public:
+  explicit AsyncDataSource(const ConnectorQueryCtx& connectorQueryCtx);
+
+  ~AsyncDataSource() override;
+
+  void addSplit(std::shared_ptr<ConnectorSplit> split) final;
+
+  std::optional<RowVectorPtr> next(uint64_t size, ContinueFuture& future)
+      final;
+
+  // Returns the number of requests in flight.
+  int32_t numPendingBatches() const {
+    std::lock_guard<std::mutex> l(state_->mutex);
+    return state_->batches.size();
+  }
+
+ protected:
+  // Starts reading 'split'. Called from addSplit() after the batches of
+  // the previous split have all been returned.
+  virtual void startSplit(std::shared_ptr<ConnectorSplit> split) = 0;
+
+  // Starts a request for the next batch of up to 'size' rows of the
+  // current split. Returns std::nullopt if all batches of the split have
+  // been requested. If the end of the split is known only from a response,
+  // the request may produce nullptr, after which no more batches are
+  // requested; the requests already in flight are still awaited and
+  // their batches returned. An empty batch is skipped. The future may be
+  // realized on any thread.
+  virtual std::optional<folly::SemiFuture<RowVectorPtr>> fetchBatch(
+      uint64_t size) = 0;
+
+ private:
+  struct Batch {
+    bool ready{false};
+    folly::Try<RowVectorPtr> result;
+  };
+
+  // Shared with the callbacks of the requests, which may outlive 'this'.
+  struct State {
+    explicit State(bool _preserveOrder) : preserveOrder(_preserveOrder) {}
+
+    const bool preserveOrder;
+    mutable std::mutex mutex;
+    // The requests in flight or completed but not returned, in request
+    // order.
+    std::deque<std::shared_ptr<Batch>> batches;
+    // Set while next() waits for a batch.
+    std::optional<ContinuePromise> promise;
+  };
+
+  static void setResult(
+      const std::shared_ptr<State>& state,
+      const std::shared_ptr<Batch>& batch,
+      folly::Try<RowVectorPtr>&& result);
+
+  // Requests batches of 'size' rows until 'maxPendingBatches_' are in
+  // flight or the split has no more.
+  void fetchBatches(uint64_t size);
+
+  const int32_t maxPendingBatches_;
+  const std::shared_ptr<State> state_;
+
+  // True after fetchBatch() returned std::nullopt or a request produced
+  // nullptr for the current split.
+  bool noMoreBatches_{true};
+};
+
+} // namespace facebook::velox::connector
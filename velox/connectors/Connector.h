@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include "velox/common/base/AsyncSource.h"
+#include "velox/common/base/CompareFlags.h"
 #include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/future/VeloxPromise.h"
@@ -34,6 +36,8 @@ class ExprSet;
 }
 namespace facebook::velox::connector {
 
+class DataSource;
+
 // A split represents a chunk of data that a connector should load and return
 // as a RowVectorPtr, potentially after processing pushdowns.
 struct ConnectorSplit {
@@ -43,6 +47,11 @@ struct ConnectorSplit {
   // async prefetch for the split.
   bool cancelled{false};
 
+  // A DataSource to which 'this' has been added in the background
+  // before 'this' is scheduled. Set by TableScan for connectors that
+  // support split preload, see DataSource::setFromDataSource().
+  std::shared_ptr<AsyncSource<std::shared_ptr<DataSource>>> dataSource;
+
   explicit ConnectorSplit(const std::string& _connectorId)
       : connectorId(_connectorId) {}
 
@@ -51,11 +60,34 @@ struct ConnectorSplit {
   virtual std::string toString() const {
     return fmt::format("[split: {}]", connectorId);
   }
+
+  // Divides 'this' so that several Drivers can read it. Returns a split of
+  // the first 'size' bytes of 'this' followed by a split of the rest, or an
+  // empty vector if 'this' is not larger or cannot be divided. Together the
+  // two must produce the rows of 'this'.
+  virtual std::vector<std::shared_ptr<ConnectorSplit>> divide(
+      uint64_t /*size*/) const {
+    return {};
+  }
+
+  // Returns a string that identifies the data of 'this' and changes whenever
+  // the data changes, e.g. the path, range and modification time of a file.
+  // std::nullopt if the connector cannot tell. Used to reuse results computed
+  // from the same data, see HashTableCache.
+  virtual std::optional<std::string> dataVersion() const {
+    return std::nullopt;
+  }
 };
 
 class ColumnHandle {
  public:
   virtual ~ColumnHandle() = default;
+
+  // Returns a description that identifies the column within its table, or
+  // an empty string if the connector has none.
+  virtual std::string toString() const {
+    return "";
+  }
 };
 
 class ConnectorTableHandle {
@@ -97,9 +129,29 @@ class DataSink {
   // TODO maybe at some point we want to make it async
   virtual void appendData(VectorPtr input) = 0;
 
+  // Declares that the rows are appended in the order of 'sortingColumns',
+  // which are names of columns of the written type, collated by
+  // 'sortingFlags'. Called before the first appendData(). Connectors may
+  // record the order in the written files. The default ignores it.
+  virtual void setSortOrder(
+      const std::vector<std::string>& /*sortingColumns*/,
+      const std::vector<CompareFlags>& /*sortingFlags*/) {}
+
   virtual void close() = 0;
 };
 
+// An aggregate that a DataSource computes over the rows of its splits in
+// place of returning the rows. See DataSource::pushdownAggregates().
+struct PushdownAggregate {
+  enum class Kind { kCount, kMin, kMax };
+
+  Kind kind;
+
+  // The aggregated column as an index into the output type of the
+  // DataSource. Not set for count(*).
+  std::optional<column_index_t> channel;
+};
+
 class DataSource {
  public:
   static constexpr int64_t kUnknownRowSize = -1;
@@ -115,7 +167,8 @@ class DataSource {
   // processed. Returns std::nullopt and sets the 'future' if started
   // asynchronous work and needs to wait for it to complete to continue
   // processing. The caller will wait for the 'future' to complete before
-  // calling 'next' again.
+  // calling 'next' again. AsyncDataSource implements this over several
+  // requests in flight.
   virtual std::optional<RowVectorPtr> next(
       uint64_t size,
       velox::ContinueFuture& future) = 0;
@@ -145,6 +198,38 @@ class DataSource {
   virtual int64_t estimatedRowSize() {
     return kUnknownRowSize;
   }
+
+  // Makes the split that was added to 'source' the current split of
+  // 'this'. 'source' comes from the same Connector::createDataSource()
+  // arguments as 'this' and has had addSplit() called in the
+  // background, so that the file is open and the first IO is scheduled
+  // by the time 'this' gets to the split. Dynamic filters added to
+  // 'this' are not transferred to the state taken from 'source'; the
+  // caller adds them again. Only called if the connector returns true
+  // from supportsSplitPreload().
+  virtual void setFromDataSource(std::shared_ptr<DataSource> /*source*/) {
+    VELOX_UNSUPPORTED("setFromDataSource");
+  }
+
+  // Tells 'this' that the caller needs no more than 'numRows' more rows,
+  // e.g. below a LIMIT, so that it can avoid reading ahead past them.
+  // Applies to the splits added after this. next() may still return more
+  // rows. The default ignores the limit.
+  virtual void setRowLimit(uint64_t /*numRows*/) {}
+
+  // Makes next() return one row per split instead of the rows of the split.
+  // The row has a column per element of 'aggregates', of the type in
+  // 'resultType', which is the partial result of the aggregate over the rows
+  // of the split that pass the filters: count is a BIGINT, min and max have
+  // the type of their column and are null if the column has no non-null
+  // value. Called before the first addSplit(). Returns false if the
+  // DataSource cannot compute 'aggregates'. Only called if the connector
+  // returns true from supportsAggregationPushdown().
+  virtual bool pushdownAggregates(
+      const std::vector<PushdownAggregate>& /*aggregates*/,
+      const RowTypePtr& /*resultType*/) {
+    return false;
+  }
 };
 
 // Exposes expression evaluation functionality of the engine to the connector.
@@ -174,12 +259,18 @@ class ConnectorQueryCtx {
       Config* config,
       ExpressionEvaluator* expressionEvaluator,
       memory::MappedMemory* mappedMemory,
-      const std::string& scanId)
+      const std::string& scanId,
+      bool adaptiveFilterReorderingEnabled = true,
+      int32_t maxPendingBatches = 1,
+      bool preserveBatchOrder = true)
       : pool_(pool),
         config_(config),
         expressionEvaluator_(expressionEvaluator),
         mappedMemory_(mappedMemory),
-        scanId_(scanId) {}
+        scanId_(scanId),
+        adaptiveFilterReorderingEnabled_(adaptiveFilterReorderingEnabled),
+        maxPendingBatches_(maxPendingBatches),
+        preserveBatchOrder_(preserveBatchOrder) {}
 
   memory::MemoryPool* memoryPool() const {
     return pool_;
@@ -208,12 +299,32 @@ class ConnectorQueryCtx {
     return scanId_;
   }
 
+  // True if pushed down filters may be reordered based on their observed
+  // cost and selectivity.
+  bool adaptiveFilterReorderingEnabled() const {
+    return adaptiveFilterReorderingEnabled_;
+  }
+
+  // Number of batch requests a DataSource may keep in flight. Used by
+  // AsyncDataSource.
+  int32_t maxPendingBatches() const {
+    return maxPendingBatches_;
+  }
+
+  // False if the DataSource may return the batches of a split out of order.
+  bool preserveBatchOrder() const {
+    return preserveBatchOrder_;
+  }
+
  private:
   memory::MemoryPool* pool_;
   Config* config_;
   ExpressionEvaluator* expressionEvaluator_;
   memory::MappedMemory* mappedMemory_;
   std::string scanId_;
+  const bool adaptiveFilterReorderingEnabled_;
+  const int32_t maxPendingBatches_;
+  const bool preserveBatchOrder_;
 };
 
 class Connector {
@@ -239,6 +350,27 @@ class Connector {
     return false;
   }
 
+  // Returns true if DataSources of this connector can take over a split
+  // added to another DataSource in the background, see
+  // DataSource::setFromDataSource(). The preload runs on executor().
+  virtual bool supportsSplitPreload() {
+    return false;
+  }
+
+  // Returns true if DataSources of this connector may compute count, min and
+  // max over the scanned rows, see DataSource::pushdownAggregates(). A
+  // planner may then replace a partial global aggregation over a scan with
+  // a TableScanNode that has the aggregates.
+  virtual bool supportsAggregationPushdown() const {
+    return false;
+  }
+
+  // Returns the executor for background work of the connector, nullptr
+  // if there is none.
+  virtual folly::Executor* FOLLY_NULLABLE executor() const {
+    return nullptr;
+  }
+
   virtual std::shared_ptr<DataSource> createDataSource(
       const RowTypePtr& outputType,
       const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
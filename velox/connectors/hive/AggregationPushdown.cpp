@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/connectors/hive/AggregationPushdown.h"
+
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::connector::hive {
+
+template <typename T>
+class ColumnAggregator::Hook final : public ValueHook {
+ public:
+  explicit Hook(ColumnAggregator& aggregator) : aggregator_(aggregator) {}
+
+  void addValue(vector_size_t /*row*/, const void* value) override {
+    aggregator_.add(*reinterpret_cast<const T*>(value));
+  }
+
+  void addValues(
+      const vector_size_t* /*rows*/,
+      const void* values,
+      vector_size_t size,
+      uint8_t /*valueWidth*/) override {
+    auto* typedValues = reinterpret_cast<const T*>(values);
+    for (auto i = 0; i < size; ++i) {
+      aggregator_.add(typedValues[i]);
+    }
+  }
+
+ private:
+  ColumnAggregator& aggregator_;
+};
+
+// Counts the values without looking at them.
+class ColumnAggregator::CountHook final : public ValueHook {
+ public:
+  explicit CountHook(ColumnAggregator& aggregator) : aggregator_(aggregator) {}
+
+  void addValue(vector_size_t /*row*/, const void* /*value*/) override {
+    ++aggregator_.numValues_;
+  }
+
+  void addValues(
+      const vector_size_t* /*rows*/,
+      const void* /*values*/,
+      vector_size_t size,
+      uint8_t /*valueWidth*/) override {
+    aggregator_.numValues_ += size;
+  }
+
+ private:
+  ColumnAggregator& aggregator_;
+};
+
+ColumnAggregator::ColumnAggregator(TypePtr type, bool needsMinMax)
+    : type_(std::move(type)), needsMinMax_(needsMinMax) {
+  VELOX_CHECK(!needsMinMax_ || supportsMinMax(type_));
+}
+
+// static
+bool ColumnAggregator::supportsMinMax(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::VARCHAR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool ColumnAggregator::hasStatistics(
+    const dwio::common::ColumnStatistics* stats) const {
+  if (!stats || !stats->getNumberOfValues().has_value()) {
+    return false;
+  }
+  if (!needsMinMax_ || stats->getNumberOfValues().value() == 0) {
+    return true;
+  }
+  switch (type_->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT: {
+      auto* intStats =
+          dynamic_cast<const dwio::common::IntegerColumnStatistics*>(stats);
+      return intStats && intStats->getMinimum().has_value() &&
+          intStats->getMaximum().has_value();
+    }
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE: {
+      auto* doubleStats =
+          dynamic_cast<const dwio::common::DoubleColumnStatistics*>(stats);
+      return doubleStats && doubleStats->getMinimum().has_value() &&
+          doubleStats->getMaximum().has_value();
+    }
+    case TypeKind::VARCHAR: {
+      auto* stringStats =
+          dynamic_cast<const dwio::common::StringColumnStatistics*>(stats);
+      return stringStats && stringStats->getMinimum().has_value() &&
+          stringStats->getMaximum().has_value();
+    }
+    default:
+      return false;
+  }
+}
+
+void ColumnAggregator::addStatistics(
+    const dwio::common::ColumnStatistics& stats) {
+  const auto numValues = stats.getNumberOfValues().value();
+  const auto previousNumValues = numValues_;
+  if (!needsMinMax_ || numValues == 0) {
+    numValues_ += numValues;
+    return;
+  }
+  switch (type_->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT: {
+      auto& intStats =
+          dynamic_cast<const dwio::common::IntegerColumnStatistics&>(stats);
+      add(intStats.getMinimum().value());
+      add(intStats.getMaximum().value());
+      break;
+    }
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE: {
+      auto& doubleStats =
+          dynamic_cast<const dwio::common::DoubleColumnStatistics&>(stats);
+      add(doubleStats.getMinimum().value());
+      add(doubleStats.getMaximum().value());
+      break;
+    }
+    case TypeKind::VARCHAR: {
+      auto& stringStats =
+          dynamic_cast<const dwio::common::StringColumnStatistics&>(stats);
+      const auto& minimum = stringStats.getMinimum().value();
+      const auto& maximum = stringStats.getMaximum().value();
+      add(StringView(minimum));
+      add(StringView(maximum));
+      break;
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+  // The add() calls above count the minimum and maximum as values.
+  numValues_ = previousNumValues + numValues;
+}
+
+template <typename T>
+void ColumnAggregator::addDecoded(const BaseVector& column, RowSet rows) {
+  DecodedVector decoded(column, SelectivityVector(rows.back() + 1));
+  for (auto row : rows) {
+    if (decoded.isNullAt(row)) {
+      continue;
+    }
+    if (needsMinMax_) {
+      add(decoded.valueAt<T>(row));
+    } else {
+      ++numValues_;
+    }
+  }
+}
+
+template <typename T>
+void ColumnAggregator::loadWithHook(const LazyVector& column, RowSet rows) {
+  if (needsMinMax_) {
+    Hook<T> hook(*this);
+    column.load(rows, &hook);
+  } else {
+    CountHook hook(*this);
+    column.load(rows, &hook);
+  }
+}
+
+void ColumnAggregator::addValues(const VectorPtr& column, RowSet rows) {
+  if (rows.empty()) {
+    return;
+  }
+  const bool lazy = isLazyNotLoaded(*column);
+  switch (type_->kind()) {
+#define AGGREGATE_VALUES(kind, T)                                \
+  case TypeKind::kind:                                           \
+    if (lazy) {                                                  \
+      loadWithHook<T>(*column->asUnchecked<LazyVector>(), rows); \
+    } else {                                                     \
+      addDecoded<T>(*column, rows);                              \
+    }                                                            \
+    break
+    AGGREGATE_VALUES(BOOLEAN, bool);
+    AGGREGATE_VALUES(TINYINT, int8_t);
+    AGGREGATE_VALUES(SMALLINT, int16_t);
+    AGGREGATE_VALUES(INTEGER, int32_t);
+    AGGREGATE_VALUES(BIGINT, int64_t);
+    AGGREGATE_VALUES(REAL, float);
+    AGGREGATE_VALUES(DOUBLE, double);
+    AGGREGATE_VALUES(VARCHAR, StringView);
+    AGGREGATE_VALUES(VARBINARY, StringView);
+#undef AGGREGATE_VALUES
+    default: {
+      // Counts the non-null values of other types from the loaded vector.
+      VELOX_CHECK(!needsMinMax_);
+      DecodedVector decoded(*column, SelectivityVector(rows.back() + 1));
+      for (auto row : rows) {
+        numValues_ += !decoded.isNullAt(row);
+      }
+    }
+  }
+}
+
+VectorPtr ColumnAggregator::makeResult(bool isMin, memory::MemoryPool* pool)
+    const {
+  if (!hasMinMax_) {
+    return BaseVector::createNullConstant(type_, 1, pool);
+  }
+  const auto intValue = isMin ? minInt_ : maxInt_;
+  const auto doubleValue = isMin ? minDouble_ : maxDouble_;
+  variant value;
+  switch (type_->kind()) {
+    case TypeKind::TINYINT:
+      value = variant(static_cast<int8_t>(intValue));
+      break;
+    case TypeKind::SMALLINT:
+      value = variant(static_cast<int16_t>(intValue));
+      break;
+    case TypeKind::INTEGER:
+      value = variant(static_cast<int32_t>(intValue));
+      break;
+    case TypeKind::BIGINT:
+      value = variant(intValue);
+      break;
+    case TypeKind::REAL:
+      value = variant(static_cast<float>(doubleValue));
+      break;
+    case TypeKind::DOUBLE:
+      value = variant(doubleValue);
+      break;
+    case TypeKind::VARCHAR:
+      value = variant(isMin ? minString_ : maxString_);
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+  return BaseVector::createConstant(value, 1, pool);
+}
+
+VectorPtr ColumnAggregator::min(memory::MemoryPool* pool) const {
+  return makeResult(true, pool);
+}
+
+VectorPtr ColumnAggregator::max(memory::MemoryPool* pool) const {
+  return makeResult(false, pool);
+}
+
+void ColumnAggregator::clear() {
+  numValues_ = 0;
+  hasMinMax_ = false;
+  minString_.clear();
+  maxString_.clear();
+}
+
+bool allValuesPass(
+    const common::Filter& filter,
+    const dwio::common::ColumnStatistics* stats,
+    uint64_t numRows) {
+  if (!stats || !stats->getNumberOfValues().has_value()) {
+    return false;
+  }
+  const auto numValues = stats->getNumberOfValues().value();
+  if (numValues < numRows && !filter.testNull()) {
+    return false;
+  }
+  if (numValues == 0) {
+    return true;
+  }
+  // The values between the minimum and the maximum pass a range if both
+  // ends do.
+  switch (filter.kind()) {
+    case common::FilterKind::kAlwaysTrue:
+      return true;
+    case common::FilterKind::kIsNotNull:
+      return numValues == numRows;
+    case common::FilterKind::kBigintRange: {
+      auto* intStats =
+          dynamic_cast<const dwio::common::IntegerColumnStatistics*>(stats);
+      return intStats && intStats->getMinimum().has_value() &&
+          intStats->getMaximum().has_value() &&
+          filter.testInt64(intStats->getMinimum().value()) &&
+          filter.testInt64(intStats->getMaximum().value());
+    }
+    case common::FilterKind::kDoubleRange:
+    case common::FilterKind::kFloatRange: {
+      auto* doubleStats =
+          dynamic_cast<const dwio::common::DoubleColumnStatistics*>(stats);
+      if (!doubleStats || !doubleStats->getMinimum().has_value() ||
+          !doubleStats->getMaximum().has_value()) {
+        return false;
+      }
+      const auto minimum = doubleStats->getMinimum().value();
+      const auto maximum = doubleStats->getMaximum().value();
+      if (filter.kind() == common::FilterKind::kFloatRange) {
+        return filter.testFloat(minimum) && filter.testFloat(maximum);
+      }
+      return filter.testDouble(minimum) && filter.testDouble(maximum);
+    }
+    case common::FilterKind::kBytesRange: {
+      auto* stringStats =
+          dynamic_cast<const dwio::common::StringColumnStatistics*>(stats);
+      if (!stringStats || !stringStats->getMinimum().has_value() ||
+          !stringStats->getMaximum().has_value()) {
+        return false;
+      }
+      const auto& minimum = stringStats->getMinimum().value();
+      const auto& maximum = stringStats->getMaximum().value();
+      return filter.testBytes(minimum.data(), minimum.size()) &&
+          filter.testBytes(maximum.data(), maximum.size());
+    }
+    default:
+      return false;
+  }
+}
+
+bool constantPasses(const common::Filter& filter, const BaseVector& constant) {
+  if (constant.isNullAt(0)) {
+    return filter.testNull();
+  }
+  switch (constant.typeKind()) {
+    case TypeKind::BOOLEAN:
+      return filter.testBool(constant.as<SimpleVector<bool>>()->valueAt(0));
+    case TypeKind::TINYINT:
+      return filter.testInt64(constant.as<SimpleVector<int8_t>>()->valueAt(0));
+    case TypeKind::SMALLINT:
+      return filter.testInt64(
+          constant.as<SimpleVector<int16_t>>()->valueAt(0));
+    case TypeKind::INTEGER:
+      return filter.testInt64(
+          constant.as<SimpleVector<int32_t>>()->valueAt(0));
+    case TypeKind::BIGINT:
+      return filter.testInt64(
+          constant.as<SimpleVector<int64_t>>()->valueAt(0));
+    case TypeKind::REAL:
+      return filter.testFloat(constant.as<SimpleVector<float>>()->valueAt(0));
+    case TypeKind::DOUBLE:
+      return filter.testDouble(
+          constant.as<SimpleVector<double>>()->valueAt(0));
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY: {
+      auto value = constant.as<SimpleVector<StringView>>()->valueAt(0);
+      return filter.testBytes(value.data(), value.size());
+    }
+    default:
+      return false;
+  }
+}
+
+} // namespace facebook::velox::connector::hive
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/dwio/common/Statistics.h"
+#include "velox/type/Filter.h"
+#include "velox/vector/LazyVector.h"
+
+namespace facebook::velox::connector::hive {
+
+// Computes count, min and max of one column for
+// HiveDataSource::pushdownAggregates(). The values come from file
+// statistics when all rows of a file pass the filters and otherwise from the
+// scanned batches. A column that is a LazyVector is loaded with a ValueHook
+// that updates 'this', so that the column is not materialized.
+class ColumnAggregator {
+ public:
+  // 'needsMinMax' is false if only the count of non-null values is needed.
+  ColumnAggregator(TypePtr type, bool needsMinMax);
+
+  // Returns true if min and max of 'type' can be computed.
+  static bool supportsMinMax(const TypePtr& type);
+
+  // Returns true if 'stats' of a file have what addStatistics() needs.
+  bool hasStatistics(const dwio::common::ColumnStatistics* stats) const;
+
+  // Adds the values summarized by 'stats'. hasStatistics() must be true.
+  void addStatistics(const dwio::common::ColumnStatistics& stats);
+
+  // Adds the non-null values of 'column' at 'rows'.
+  void addValues(const VectorPtr& column, RowSet rows);
+
+  int64_t count() const {
+    return numValues_;
+  }
+
+  // Returns a single row vector with the minimum or maximum value, null if
+  // there have been no values.
+  VectorPtr min(memory::MemoryPool* pool) const;
+  VectorPtr max(memory::MemoryPool* pool) const;
+
+  void clear();
+
+ private:
+  template <typename T>
+  class Hook;
+
+  class CountHook;
+
+  template <typename T>
+  FOLLY_ALWAYS_INLINE void add(T value) {
+    ++numValues_;
+    if constexpr (std::is_same_v<T, StringView>) {
+      if (!hasMinMax_ || value < StringView(minString_)) {
+        minString_ = value.str();
+      }
+      if (!hasMinMax_ || StringView(maxString_) < value) {
+        maxString_ = value.str();
+      }
+    } else if constexpr (std::is_floating_point_v<T>) {
+      minDouble_ = hasMinMax_ ? std::min<double>(minDouble_, value) : value;
+      maxDouble_ = hasMinMax_ ? std::max<double>(maxDouble_, value) : value;
+    } else {
+      minInt_ = hasMinMax_ ? std::min<int64_t>(minInt_, value) : value;
+      maxInt_ = hasMinMax_ ? std::max<int64_t>(maxInt_, value) : value;
+    }
+    hasMinMax_ = true;
+  }
+
+  template <typename T>
+  void addDecoded(const BaseVector& column, RowSet rows);
+
+  template <typename T>
+  void loadWithHook(const LazyVector& column, RowSet rows);
+
+  VectorPtr makeResult(bool isMin, memory::MemoryPool* pool) const;
+
+  const TypePtr type_;
+  const bool needsMinMax_;
+  int64_t numValues_{0};
+  bool hasMinMax_{false};
+  // The minimum and maximum of integer, floating point and string columns.
+  int64_t minInt_{0};
+  int64_t maxInt_{0};
+  double minDouble_{0};
+  double maxDouble_{0};
+  std::string minString_;
+  std::string maxString_;
+};
+
+// Returns true if all the 'numRows' rows of a column with 'stats' pass
+// 'filter'. Only range filters are checked against the minimum and maximum,
+// other filters return false.
+bool allValuesPass(
+    const common::Filter& filter,
+    const dwio::common::ColumnStatistics* stats,
+    uint64_t numRows);
+
+// Returns true if the value in row 0 of 'constant' passes 'filter'.
+bool constantPasses(const common::Filter& filter, const BaseVector& constant);
+
+} // namespace facebook::velox::connector::hive
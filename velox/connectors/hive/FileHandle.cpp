@@ -39,8 +39,9 @@ std::string groupName(const std::string& filename) {
 std::unique_ptr<FileHandle> FileHandleGenerator::operator()(
     const std::string& filename) {
   auto fileHandle = std::make_unique<FileHandle>();
-  fileHandle->file = filesystems::getFileSystem(filename, properties_)
-                         ->openFileForRead(filename);
+  auto fileSystem = filesystems::getFileSystem(filename, properties_);
+  fileHandle->file = fileSystem->openFileForRead(filename);
+  fileHandle->file->setCoalescePolicy(fileSystem->coalescePolicy());
   fileHandle->uuid = StringIdLease(fileIds(), filename);
   fileHandle->groupId = StringIdLease(fileIds(), groupName(filename));
   VLOG(1) << "Generating file handle for: " << filename
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/connectors/hive/FileStatisticsCache.h"
+
+#include <gflags/gflags.h>
+
+DEFINE_int32(
+    file_statistics_cache_entries,
+    10'000,
+    "Number of files whose footer statistics are kept for split pruning.");
+
+namespace facebook::velox::connector::hive {
+
+// static
+std::shared_ptr<const FileStatistics> FileStatistics::create(
+    const dwio::common::Reader& reader) {
+  auto numRows = reader.numberOfRows();
+  if (!numRows.has_value()) {
+    return nullptr;
+  }
+  auto statistics = std::make_shared<FileStatistics>();
+  statistics->numRows = numRows.value();
+  statistics->rowType = reader.rowType();
+  const auto& typeWithId = reader.typeWithId();
+  statistics->columns.reserve(typeWithId->size());
+  for (auto i = 0; i < typeWithId->size(); ++i) {
+    statistics->columns.push_back(
+        reader.columnStatistics(typeWithId->childAt(i)->id));
+  }
+  return statistics;
+}
+
+std::shared_ptr<const FileStatistics> FileStatisticsCache::find(
+    const std::string& path,
+    uint64_t modificationTime,
+    uint64_t fileSize) {
+  auto key = makeKey(path, modificationTime, fileSize);
+  return cache_.withWLock(
+      [&](auto& cache) -> std::shared_ptr<const FileStatistics> {
+        auto entry = cache.get(key);
+        if (!entry) {
+          return nullptr;
+        }
+        auto statistics = *entry;
+        cache.release(key);
+        return statistics;
+      });
+}
+
+void FileStatisticsCache::insert(
+    const std::string& path,
+    uint64_t modificationTime,
+    uint64_t fileSize,
+    std::shared_ptr<const FileStatistics> statistics) {
+  auto entry =
+      std::make_unique<std::shared_ptr<const FileStatistics>>(statistics);
+  cache_.withWLock([&](auto& cache) {
+    if (cache.add(
+            makeKey(path, modificationTime, fileSize), entry.get(), 1)) {
+      entry.release();
+    }
+  });
+}
+
+// static
+FileStatisticsCache& FileStatisticsCache::instance() {
+  static FileStatisticsCache cache(FLAGS_file_statistics_cache_entries);
+  return cache;
+}
+
+} // namespace facebook::velox::connector::hive
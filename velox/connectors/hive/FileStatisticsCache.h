@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <fmt/format.h>
+#include <folly/Synchronized.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/dwio/common/Reader.h"
+
+namespace facebook::velox::connector::hive {
+
+// Footer level statistics of a file. These decide whether a split of the
+// file can match the filters of a scan.
+struct FileStatistics {
+  // Returns the row count, schema and top level column statistics of the
+  // file opened by 'reader'. Returns nullptr if the file does not record
+  // its row count.
+  static std::shared_ptr<const FileStatistics> create(
+      const dwio::common::Reader& reader);
+
+  uint64_t numRows;
+  RowTypePtr rowType;
+  // Statistics of the columns of 'rowType', in order. An element is
+  // nullptr if the file has no statistics for the column.
+  std::vector<std::unique_ptr<dwio::common::ColumnStatistics>> columns;
+};
+
+// Process wide cache of FileStatistics. A file is identified by its path,
+// modification time and size, so that a rewritten file gets a new entry.
+// Lets a scan drop splits whose statistics exclude its filters without
+// reading the file again.
+class FileStatisticsCache {
+ public:
+  explicit FileStatisticsCache(int32_t maxEntries) : cache_(maxEntries) {}
+
+  // Returns the statistics of the version of the file at 'path' that was
+  // modified at 'modificationTime' and has 'fileSize' bytes. Returns
+  // nullptr if they are not cached.
+  std::shared_ptr<const FileStatistics> find(
+      const std::string& path,
+      uint64_t modificationTime,
+      uint64_t fileSize);
+
+  void insert(
+      const std::string& path,
+      uint64_t modificationTime,
+      uint64_t fileSize,
+      std::shared_ptr<const FileStatistics> statistics);
+
+  static FileStatisticsCache& instance();
+
+ private:
+  static std::string makeKey(
+      const std::string& path,
+      uint64_t modificationTime,
+      uint64_t fileSize) {
+    return fmt::format("{}:{}:{}", path, modificationTime, fileSize);
+  }
+
+  folly::Synchronized<
+      SimpleLRUCache<std::string, std::shared_ptr<const FileStatistics>>>
+      cache_;
+};
+
+} // namespace facebook::velox::connector::hive
@@ -15,8 +15,12 @@
  */
 #include "velox/connectors/hive/HiveConnector.h"
 
+#include <folly/String.h>
+#include <filesystem>
 #include <memory>
+#include <numeric>
 
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/dwrf/reader/SelectiveColumnReader.h"
 #include "velox/expression/FieldReference.h"
@@ -78,30 +82,375 @@ std::string HiveTableHandle::toString() const {
   return out.str();
 }
 
+namespace {
+// Escapes the characters that Hive escapes in partition directory names.
+std::string escapePathName(const std::string& name) {
+  static const std::string_view kEscaped = "\"#%'*/:=?\\\x7f{[]^";
+  std::string escaped;
+  escaped.reserve(name.size());
+  for (auto c : name) {
+    if (static_cast<unsigned char>(c) < 0x20 ||
+        kEscaped.find(c) != std::string_view::npos) {
+      escaped += fmt::format("%{:02X}", static_cast<unsigned char>(c));
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+// Creates the parent directories of 'path' if it is a local file.
+void createParentDirectories(const std::string& path) {
+  if (path.find("://") != std::string::npos) {
+    return;
+  }
+  std::string_view localPath = path;
+  if (localPath.substr(0, 5) == "file:") {
+    localPath.remove_prefix(5);
+  }
+  std::filesystem::create_directories(
+      std::filesystem::path(localPath).parent_path());
+}
+} // namespace
+
 HiveDataSink::HiveDataSink(
     std::shared_ptr<const RowType> inputType,
     const std::string& filePath,
+    velox::memory::MemoryPool* memoryPool,
+    dwio::common::FileFormat fileFormat)
+    : HiveDataSink(
+          std::move(inputType),
+          std::make_shared<HiveInsertTableHandle>(filePath, fileFormat),
+          memoryPool) {}
+
+HiveDataSink::HiveDataSink(
+    std::shared_ptr<const RowType> inputType,
+    std::shared_ptr<const HiveInsertTableHandle> insertTableHandle,
     velox::memory::MemoryPool* memoryPool)
-    : inputType_(inputType) {
+    : inputType_(std::move(inputType)),
+      pool_(memoryPool),
+      insertTableHandle_(std::move(insertTableHandle)) {
+  const auto fileFormat = insertTableHandle_->fileFormat();
+  if (!insertTableHandle_->isMultiFile()) {
+    const auto& filePath = insertTableHandle_->filePath();
+    if (fileFormat != dwio::common::FileFormat::DWRF) {
+      formatWriter_ =
+          dwio::common::getWriterFactory(fileFormat)
+              ->createWriter(
+                  dwio::common::DataSink::create(filePath),
+                  inputType_,
+                  *pool_);
+      return;
+    }
+    writer_ = createWriter(filePath, inputType_);
+    return;
+  }
+
+  VELOX_USER_CHECK(
+      fileFormat == dwio::common::FileFormat::DWRF,
+      "Partitioned, bucketed or rolled Hive writes support only DWRF");
+  std::unordered_set<column_index_t> partitionChannels;
+  for (const auto& name : insertTableHandle_->partitionedBy()) {
+    partitionChannels_.push_back(inputType_->getChildIdx(name));
+    partitionChannels.insert(partitionChannels_.back());
+  }
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (column_index_t i = 0; i < inputType_->size(); ++i) {
+    if (partitionChannels.count(i) == 0) {
+      dataChannels_.push_back(i);
+      names.push_back(inputType_->nameOf(i));
+      types.push_back(inputType_->childAt(i));
+    }
+  }
+  VELOX_USER_CHECK(
+      !dataChannels_.empty(), "A Hive write needs a non-partition column");
+  dataType_ = ROW(std::move(names), std::move(types));
+
+  if (const auto& bucketProperty = insertTableHandle_->bucketProperty()) {
+    VELOX_USER_CHECK_GT(bucketProperty->bucketCount, 0);
+    std::vector<column_index_t> bucketChannels;
+    for (const auto& name : bucketProperty->bucketedBy) {
+      bucketChannels.push_back(inputType_->getChildIdx(name));
+    }
+    std::vector<int> bucketToPartition(bucketProperty->bucketCount);
+    std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+    bucketFunction_ = std::make_unique<HivePartitionFunction>(
+        bucketProperty->bucketCount,
+        std::move(bucketToPartition),
+        std::move(bucketChannels));
+  }
+}
+
+HiveDataSink::~HiveDataSink() = default;
+
+std::unique_ptr<Writer> HiveDataSink::createWriter(
+    const std::string& filePath,
+    const std::shared_ptr<const RowType>& type) {
   auto config = std::make_shared<WriterConfig>();
   // TODO: Wire up serde properties to writer configs.
 
+  // The size of a file is checked after a stripe is written, so that a
+  // stripe no larger than the target keeps the files close to the target.
+  const auto targetFileSize = insertTableHandle_->targetFileSize();
+  if (targetFileSize > 0 &&
+      targetFileSize < config->get(WriterConfig::STRIPE_SIZE)) {
+    config->set(WriterConfig::STRIPE_SIZE, targetFileSize);
+  }
+
   facebook::velox::dwrf::WriterOptions options;
   options.config = config;
-  options.schema = inputType;
+  options.schema = type;
   // Without explicitly setting flush policy, the default memory based flush
   // policy is used.
 
+  if (insertTableHandle_->isMultiFile()) {
+    createParentDirectories(filePath);
+  }
   auto sink = facebook::velox::dwio::common::DataSink::create(filePath);
-  writer_ = std::make_unique<Writer>(options, std::move(sink), *memoryPool);
+  auto writer = std::make_unique<Writer>(options, std::move(sink), *pool_);
+  if (!sortOrder_.empty()) {
+    writer->addUserMetadata(kSortOrderMetadataKey, sortOrder_);
+  }
+  return writer;
 }
 
 void HiveDataSink::appendData(VectorPtr input) {
-  writer_->write(input);
+  if (formatWriter_) {
+    formatWriter_->write(input);
+    return;
+  }
+  if (writer_) {
+    writer_->write(input);
+    return;
+  }
+
+  const auto& rowInput = *input->as<RowVector>();
+  const auto numRows = rowInput.size();
+  if (numRows == 0) {
+    return;
+  }
+  computeWriters(rowInput);
+
+  std::vector<vector_size_t> numWriterRows(partitionWriters_.size(), 0);
+  for (auto row = 0; row < numRows; ++row) {
+    ++numWriterRows[rowWriters_[row]];
+  }
+  std::vector<VectorPtr> children(dataChannels_.size());
+  if (numWriterRows[rowWriters_[0]] == numRows) {
+    for (auto i = 0; i < dataChannels_.size(); ++i) {
+      children[i] = rowInput.childAt(dataChannels_[i]);
+    }
+    write(
+        partitionWriters_[rowWriters_[0]],
+        std::make_shared<RowVector>(
+            pool_, dataType_, nullptr, numRows, std::move(children)));
+  } else {
+    // Wraps the columns in dictionaries over the rows of each writer.
+    std::vector<BufferPtr> indices(partitionWriters_.size());
+    std::vector<vector_size_t*> rawIndices(partitionWriters_.size());
+    for (auto i = 0; i < partitionWriters_.size(); ++i) {
+      if (numWriterRows[i] > 0) {
+        indices[i] = allocateIndices(numWriterRows[i], pool_);
+        rawIndices[i] = indices[i]->asMutable<vector_size_t>();
+      }
+    }
+    for (auto row = 0; row < numRows; ++row) {
+      *rawIndices[rowWriters_[row]]++ = row;
+    }
+    for (auto i = 0; i < partitionWriters_.size(); ++i) {
+      if (numWriterRows[i] == 0) {
+        continue;
+      }
+      for (auto j = 0; j < dataChannels_.size(); ++j) {
+        children[j] = BaseVector::wrapInDictionary(
+            nullptr,
+            indices[i],
+            numWriterRows[i],
+            rowInput.childAt(dataChannels_[j]));
+      }
+      write(
+          partitionWriters_[i],
+          std::make_shared<RowVector>(
+              pool_, dataType_, nullptr, numWriterRows[i], children));
+    }
+  }
+  flushLargestWriters();
+}
+
+void HiveDataSink::computeWriters(const RowVector& input) {
+  const auto numRows = input.size();
+  if (bucketFunction_) {
+    bucketFunction_->partition(input, buckets_);
+  } else {
+    buckets_.assign(numRows, 0);
+  }
+  SelectivityVector rows(numRows);
+  decodedPartitionColumns_.resize(partitionChannels_.size());
+  for (auto i = 0; i < partitionChannels_.size(); ++i) {
+    decodedPartitionColumns_[i].decode(
+        *input.childAt(partitionChannels_[i]), rows);
+  }
+
+  const auto numBuckets = bucketFunction_
+      ? insertTableHandle_->bucketProperty()->bucketCount
+      : 1;
+  rowWriters_.resize(numRows);
+  std::vector<int32_t>* partitionIndices = nullptr;
+  std::string directory;
+  for (auto row = 0; row < numRows; ++row) {
+    // Rows of the same partition usually come together.
+    if (row == 0 || !samePartition(row, row - 1)) {
+      directory = partitionDirectory(row);
+      auto it = writerIndices_.find(directory);
+      if (it == writerIndices_.end()) {
+        it = writerIndices_
+                 .emplace(directory, std::vector<int32_t>(numBuckets, -1))
+                 .first;
+      }
+      partitionIndices = &it->second;
+    }
+    const auto bucket = buckets_[row];
+    auto& index = (*partitionIndices)[bucket];
+    if (index < 0) {
+      index = partitionWriters_.size();
+      partitionWriters_.push_back(PartitionWriter{directory, bucket});
+    }
+    rowWriters_[row] = index;
+  }
+}
+
+std::string HiveDataSink::partitionDirectory(vector_size_t row) const {
+  std::string directory = insertTableHandle_->filePath();
+  for (auto i = 0; i < partitionChannels_.size(); ++i) {
+    const auto& decoded = decodedPartitionColumns_[i];
+    directory += '/';
+    directory += escapePathName(inputType_->nameOf(partitionChannels_[i]));
+    directory += '=';
+    directory += decoded.isNullAt(row)
+        ? kDefaultPartitionName
+        : escapePathName(decoded.base()->toString(decoded.index(row)));
+  }
+  return directory;
+}
+
+bool HiveDataSink::samePartition(vector_size_t row, vector_size_t other)
+    const {
+  for (const auto& decoded : decodedPartitionColumns_) {
+    if (decoded.isNullAt(row) || decoded.isNullAt(other)) {
+      if (decoded.isNullAt(row) != decoded.isNullAt(other)) {
+        return false;
+      }
+      continue;
+    }
+    if (!decoded.base()->equalValueAt(
+            decoded.base(), decoded.index(row), decoded.index(other))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HiveDataSink::write(
+    PartitionWriter& partitionWriter,
+    const VectorPtr& data) {
+  if (!partitionWriter.writer) {
+    partitionWriter.filePath = fmt::format(
+        "{}/{:06d}_{}",
+        partitionWriter.directory,
+        partitionWriter.bucket,
+        partitionWriter.fileNumber++);
+    partitionWriter.writer = createWriter(partitionWriter.filePath, dataType_);
+  }
+  partitionWriter.writer->write(data);
+  const auto targetFileSize = insertTableHandle_->targetFileSize();
+  if (targetFileSize > 0 &&
+      partitionWriter.writer->getSink().size() >= targetFileSize) {
+    closeWriter(partitionWriter);
+  }
+}
+
+void HiveDataSink::flushLargestWriters() {
+  const auto maxWriterMemory = insertTableHandle_->maxWriterMemory();
+  std::vector<std::pair<int64_t, PartitionWriter*>> writerBytes;
+  int64_t totalBytes = 0;
+  for (auto& partitionWriter : partitionWriters_) {
+    if (partitionWriter.writer) {
+      const auto bytes =
+          partitionWriter.writer->getContext().getTotalMemoryUsage();
+      totalBytes += bytes;
+      writerBytes.emplace_back(bytes, &partitionWriter);
+    }
+  }
+  if (totalBytes <= maxWriterMemory) {
+    return;
+  }
+  std::sort(
+      writerBytes.begin(),
+      writerBytes.end(),
+      [](const auto& left, const auto& right) {
+        return left.first > right.first;
+      });
+  const auto targetFileSize = insertTableHandle_->targetFileSize();
+  for (auto& [bytes, partitionWriter] : writerBytes) {
+    if (totalBytes <= maxWriterMemory) {
+      break;
+    }
+    auto& writer = partitionWriter->writer;
+    writer->flush();
+    if (targetFileSize > 0 && writer->getSink().size() >= targetFileSize) {
+      closeWriter(*partitionWriter);
+      totalBytes -= bytes;
+    } else {
+      totalBytes -= bytes - writer->getContext().getTotalMemoryUsage();
+    }
+  }
+}
+
+void HiveDataSink::closeWriter(PartitionWriter& partitionWriter) {
+  if (!partitionWriter.writer) {
+    return;
+  }
+  partitionWriter.writer->close();
+  partitionWriter.writer.reset();
+  writtenFiles_.push_back(partitionWriter.filePath);
+}
+
+void HiveDataSink::setSortOrder(
+    const std::vector<std::string>& sortingColumns,
+    const std::vector<CompareFlags>& sortingFlags) {
+  VELOX_CHECK_EQ(sortingColumns.size(), sortingFlags.size());
+  if (formatWriter_) {
+    return;
+  }
+  std::vector<std::string> keys;
+  keys.reserve(sortingColumns.size());
+  for (auto i = 0; i < sortingColumns.size(); ++i) {
+    keys.push_back(fmt::format(
+        "{} {} NULLS {}",
+        sortingColumns[i],
+        sortingFlags[i].ascending ? "ASC" : "DESC",
+        sortingFlags[i].nullsFirst ? "FIRST" : "LAST"));
+  }
+  sortOrder_ = folly::join(",", keys);
+  if (writer_) {
+    writer_->addUserMetadata(kSortOrderMetadataKey, sortOrder_);
+  }
 }
 
 void HiveDataSink::close() {
-  writer_->close();
+  if (formatWriter_) {
+    formatWriter_->close();
+    return;
+  }
+  if (writer_) {
+    writer_->close();
+    writtenFiles_.push_back(insertTableHandle_->filePath());
+    return;
+  }
+  for (auto& partitionWriter : partitionWriters_) {
+    closeWriter(partitionWriter);
+  }
 }
 
 namespace {
@@ -195,7 +544,12 @@ HiveDataSource::HiveDataSource(
     ExpressionEvaluator* expressionEvaluator,
     memory::MappedMemory* mappedMemory,
     const std::string& scanId,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    cache::CacheAdmission cacheAdmission,
+    int32_t decodeStripesAhead,
+    bool adaptiveFilterReorderingEnabled,
+    uint64_t groupedFileReadSize,
+    bool biasVectors)
     : outputType_(outputType),
       fileHandleFactory_(fileHandleFactory),
       pool_(pool),
@@ -203,7 +557,9 @@ HiveDataSource::HiveDataSource(
       expressionEvaluator_(expressionEvaluator),
       mappedMemory_(mappedMemory),
       scanId_(scanId),
-      executor_(executor) {
+      executor_(executor),
+      cacheAdmission_(cacheAdmission),
+      groupedFileReadSize_(groupedFileReadSize) {
   // Column handled keyed on the column alias, the name used in the query.
   for (const auto& [canonicalizedName, columnHandle] : columnHandles) {
     auto handle = std::dynamic_pointer_cast<HiveColumnHandle>(columnHandle);
@@ -271,7 +627,20 @@ HiveDataSource::HiveDataSource(
     readerOutputType_ = ROW(std::move(names), std::move(types));
   }
 
+  // 'scanSpec_' lives as long as 'this', so the filter order adapts over
+  // all the splits of the data source. The conjuncts of the remaining
+  // filter are likewise reordered inside 'remainingFilterExprSet_'. The
+  // remaining filter always runs after all the subfield filters, which
+  // the readers evaluate while decoding.
+  scanSpec_->setEnableFilterReorder(adaptiveFilterReorderingEnabled);
   rowReaderOpts_.setScanSpec(scanSpec_);
+  rowReaderOpts_.setReturnBiasVectors(biasVectors);
+  if (executor_ && decodeStripesAhead > 0) {
+    // The executor outlives the connector and thus 'this'.
+    rowReaderOpts_.setDecodingExecutor(std::shared_ptr<folly::Executor>(
+        executor_, [](folly::Executor* /*unused*/) {}));
+    rowReaderOpts_.setDecodeStripesAhead(decodeStripesAhead);
+  }
 
   ioStats_ = std::make_shared<dwio::common::IoStatistics>();
 }
@@ -279,11 +648,9 @@ HiveDataSource::HiveDataSource(
 namespace {
 bool testFilters(
     common::ScanSpec* scanSpec,
-    dwio::common::Reader* reader,
+    const FileStatistics& statistics,
     const std::string& filePath) {
-  auto totalRows = reader->numberOfRows();
-  const auto& fileTypeWithId = reader->typeWithId();
-  const auto& rowType = reader->rowType();
+  const auto& rowType = statistics.rowType;
   for (const auto& child : scanSpec->children()) {
     if (child->filter()) {
       const auto& name = child->fieldName();
@@ -294,13 +661,13 @@ bool testFilters(
           return false;
         }
       } else {
-        const auto& typeWithId = fileTypeWithId->childByName(name);
-        auto columnStats = reader->columnStatistics(typeWithId->id);
-        if (!testFilter(
+        auto& columnStats = statistics.columns[rowType->getChildIdx(name)];
+        if (columnStats &&
+            !testFilter(
                 child->filter(),
                 columnStats.get(),
-                totalRows.value(),
-                typeWithId->type)) {
+                statistics.numRows,
+                rowType->findChild(name))) {
           VLOG(1) << "Skipping " << filePath
                   << " based on stats and filter for column "
                   << child->fieldName();
@@ -369,23 +736,87 @@ void HiveDataSource::addDynamicFilter(
     fieldSpec.setFilter(filter->clone());
   }
   scanSpec_->resetCachedValues();
+  // The row limit of the current RowReader no longer bounds the rows that
+  // pass.
+  if (rowReader_ && rowReaderLimited_) {
+    rowReader_->resetFilterCaches();
+    rowReaderLimited_ = false;
+  }
+  // The new filter may exclude the rest of the current split. Dropping its
+  // RowReader cancels the prefetches queued for it.
+  if (split_ && rowReader_ && !emptySplit_ && fileStatistics_ &&
+      !testFilters(scanSpec_.get(), *fileStatistics_, split_->filePath)) {
+    emptySplit_ = true;
+    ++runtimeStats_.skippedSplits;
+    runtimeStats_.skippedSplitBytes += split_->length;
+    rowReader_.reset();
+  }
 }
 
 void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   VELOX_CHECK(
       split_ == nullptr,
       "Previous split has not been processed yet. Call next to process the split.");
-  split_ = std::dynamic_pointer_cast<HiveConnectorSplit>(split);
-  VELOX_CHECK(split_, "Wrong type of split");
+  auto hiveSplit = std::dynamic_pointer_cast<HiveConnectorSplit>(split);
+  VELOX_CHECK(hiveSplit, "Wrong type of split");
 
-  VLOG(1) << "Adding split " << split_->toString();
+  VLOG(1) << "Adding split " << hiveSplit->toString();
+
+  if (!hiveSplit->groupedSplits.empty()) {
+    groupedSplit_ = hiveSplit;
+    nextGroupedFile_ = 0;
+  }
+  addFile(std::move(hiveSplit));
+}
 
+void HiveDataSource::addFile(std::shared_ptr<HiveConnectorSplit> split) {
+  split_ = std::move(split);
+  checkAggregateStatistics_ = !aggregates_.empty();
   fileHandle_ = fileHandleFactory_->generate(split_->filePath);
+  // If an earlier split of the same file recorded its statistics, a split
+  // that cannot match is dropped without reading the file. Files that do
+  // not report a modification time are not cached.
+  auto modificationTime = fileHandle_->file->modificationTime();
+  auto fileSize = fileHandle_->file->size();
+  if (modificationTime.has_value()) {
+    fileStatistics_ = FileStatisticsCache::instance().find(
+        split_->filePath, modificationTime.value(), fileSize);
+  }
+  if (fileStatistics_ &&
+      (fileStatistics_->numRows == 0 ||
+       !testFilters(scanSpec_.get(), *fileStatistics_, split_->filePath))) {
+    emptySplit_ = true;
+    ++numPrunedSplits_;
+    if (fileStatistics_->numRows > 0) {
+      ++runtimeStats_.skippedSplits;
+      runtimeStats_.skippedSplitBytes += split_->length;
+    }
+    return;
+  }
+
   // For DataCache and no cache, the stream keeps track of IO.
   auto asyncCache = dynamic_cast<cache::AsyncDataCache*>(mappedMemory_);
-  // Decide between AsyncDataCache, legacy DataCache and no cache. All
-  // three are supported to enable comparison.
-  if (asyncCache) {
+  std::unique_ptr<dwio::common::InputStream> input;
+  if (groupedSplit_ && fileSize > 0 && fileSize <= groupedFileReadSize_) {
+    // A small file of a grouped split is read with one IO. The reader
+    // then reads the footer and the stripes from memory.
+    std::string data(fileSize, '\0');
+    dwio::common::ReadFileInputStream(
+        fileHandle_->file.get(),
+        dwio::common::MetricsLog::voidLog(),
+        ioStats_.get())
+        .read(
+            data.data(),
+            fileSize,
+            0,
+            dwio::common::MetricsLog::MetricsType::FILE);
+    wholeFile_ = std::make_unique<InMemoryReadFile>(std::move(data));
+    readerOpts_.setBufferedInputFactory(nullptr);
+    input = std::make_unique<dwio::common::ReadFileInputStream>(
+        wholeFile_.get(), dwio::common::MetricsLog::voidLog(), nullptr);
+  } else if (asyncCache) {
+    // Decide between AsyncDataCache, legacy DataCache and no cache. All
+    // three are supported to enable comparison.
     readerOpts_.setFileNum(fileHandle_->uuid.id());
     bufferedInputFactory_ =
         std::make_unique<dwio::common::CachedBufferedInputFactory>(
@@ -397,9 +828,16 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
             },
             ioStats_,
             executor_,
-            readerOpts_);
+            readerOpts_,
+            cacheAdmission_);
     readerOpts_.setBufferedInputFactory(bufferedInputFactory_);
   }
+  if (!input) {
+    input = std::make_unique<dwio::common::ReadFileInputStream>(
+        fileHandle_->file.get(),
+        dwio::common::MetricsLog::voidLog(),
+        asyncCache ? nullptr : ioStats_.get());
+  }
 
   if (readerOpts_.getFileFormat() != dwio::common::FileFormat::UNKNOWN) {
     VELOX_CHECK(
@@ -410,16 +848,29 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   } else {
     readerOpts_.setFileFormat(split_->fileFormat);
   }
+  // Reopening a file whose footer is in FileTailCache costs no IO.
+  std::string fileTailCacheKey;
+  if (modificationTime.has_value()) {
+    fileTailCacheKey = fmt::format(
+        "{}:{}:{}", split_->filePath, modificationTime.value(), fileSize);
+  }
+  readerOpts_.setFileTailCacheKey(std::move(fileTailCacheKey));
 
   // We run with the default BufferedInputFactory and no DataCacheConfig if
   // there is no DataCache and the MappedMemory is not an AsyncDataCache.
   reader_ = dwio::common::getReaderFactory(readerOpts_.getFileFormat())
-                ->createReader(
-                    std::make_unique<dwio::common::ReadFileInputStream>(
-                        fileHandle_->file.get(),
-                        dwio::common::MetricsLog::voidLog(),
-                        asyncCache ? nullptr : ioStats_.get()),
-                    readerOpts_);
+                ->createReader(std::move(input), readerOpts_);
+
+  if (!fileStatistics_) {
+    fileStatistics_ = FileStatistics::create(*reader_);
+    if (fileStatistics_ && modificationTime.has_value()) {
+      FileStatisticsCache::instance().insert(
+          split_->filePath,
+          modificationTime.value(),
+          fileSize,
+          fileStatistics_);
+    }
+  }
 
   emptySplit_ = false;
   if (reader_->numberOfRows() == 0) {
@@ -428,7 +879,8 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   }
 
   // Check filters and see if the whole split can be skipped
-  if (!testFilters(scanSpec_.get(), reader_.get(), split_->filePath)) {
+  if (fileStatistics_ &&
+      !testFilters(scanSpec_.get(), *fileStatistics_, split_->filePath)) {
     emptySplit_ = true;
     ++runtimeStats_.skippedSplits;
     runtimeStats_.skippedSplitBytes += split_->length;
@@ -494,6 +946,10 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
     cs = std::make_shared<dwio::common::ColumnSelector>(fileType, columnNames);
   }
 
+  rowReaderLimited_ = !remainingFilterExprSet_ && aggregates_.empty() &&
+      rowLimit_ != std::numeric_limits<uint64_t>::max();
+  rowReaderOpts_.setRowLimit(
+      rowReaderLimited_ ? rowLimit_ : std::numeric_limits<uint64_t>::max());
   rowReader_ = reader_->createRowReader(
       rowReaderOpts_.select(cs).range(split_->start, split_->length));
 }
@@ -501,10 +957,24 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
 std::optional<RowVectorPtr> HiveDataSource::next(
     uint64_t size,
     velox::ContinueFuture& /*future*/) {
+  if (aggregatesReturned_) {
+    aggregatesReturned_ = false;
+    return nullptr;
+  }
   VELOX_CHECK(split_ != nullptr, "No split to process. Call addSplit first.");
+  if (checkAggregateStatistics_) {
+    checkAggregateStatistics_ = false;
+    if (!emptySplit_ && aggregateFromStatistics()) {
+      ++numAggregatedFiles_;
+      emptySplit_ = true;
+      rowReader_.reset();
+    }
+  }
   if (emptySplit_) {
-    resetSplit();
-    return nullptr;
+    if (addNextGroupedFile()) {
+      return RowVector::createEmpty(outputType_, pool_);
+    }
+    return finishSplit();
   }
 
   if (!output_) {
@@ -548,6 +1018,11 @@ std::optional<RowVectorPtr> HiveDataSource::next(
       }
     }
 
+    if (!aggregates_.empty()) {
+      aggregate(*rowVector, rowsRemaining, remainingIndices);
+      return RowVector::createEmpty(outputType_, pool_);
+    }
+
     if (outputType_->size() == 0) {
       return exec::wrap(rowsRemaining, remainingIndices, rowVector);
     }
@@ -565,8 +1040,167 @@ std::optional<RowVectorPtr> HiveDataSource::next(
 
   rowReader_->updateRuntimeStats(runtimeStats_);
 
+  if (addNextGroupedFile()) {
+    return RowVector::createEmpty(outputType_, pool_);
+  }
+  return finishSplit();
+}
+
+RowVectorPtr HiveDataSource::finishSplit() {
   resetSplit();
-  return nullptr;
+  if (aggregates_.empty()) {
+    return nullptr;
+  }
+  aggregatesReturned_ = true;
+  return finishAggregates();
+}
+
+bool HiveDataSource::pushdownAggregates(
+    const std::vector<PushdownAggregate>& aggregates,
+    const RowTypePtr& resultType) {
+  VELOX_CHECK(split_ == nullptr, "Aggregates must be set before any split");
+  VELOX_CHECK_EQ(aggregates.size(), resultType->size());
+  std::vector<std::unique_ptr<ColumnAggregator>> aggregators(
+      outputType_->size());
+  std::vector<bool> needsMinMax(outputType_->size(), false);
+  for (const auto& aggregate : aggregates) {
+    if (!aggregate.channel.has_value()) {
+      continue;
+    }
+    const auto channel = aggregate.channel.value();
+    VELOX_CHECK_LT(channel, outputType_->size());
+    const auto& name = readerOutputType_->nameOf(channel);
+    if (partitionKeys_.count(name) || name == kPath || name == kBucket) {
+      return false;
+    }
+    if (aggregate.kind != PushdownAggregate::Kind::kCount) {
+      if (!ColumnAggregator::supportsMinMax(outputType_->childAt(channel))) {
+        return false;
+      }
+      needsMinMax[channel] = true;
+    }
+  }
+  for (const auto& aggregate : aggregates) {
+    if (aggregate.channel.has_value()) {
+      const auto channel = aggregate.channel.value();
+      aggregators[channel] = std::make_unique<ColumnAggregator>(
+          outputType_->childAt(channel), needsMinMax[channel]);
+    }
+  }
+  aggregates_ = aggregates;
+  aggregatesType_ = resultType;
+  aggregators_ = std::move(aggregators);
+  return true;
+}
+
+bool HiveDataSource::aggregateFromStatistics() {
+  if (!fileStatistics_ || remainingFilterExprSet_) {
+    return false;
+  }
+  // The statistics describe the whole file.
+  if (split_->start > 0 ||
+      split_->start + split_->length < fileHandle_->file->size()) {
+    return false;
+  }
+  const auto& rowType = fileStatistics_->rowType;
+  const auto numRows = fileStatistics_->numRows;
+  for (const auto& child : scanSpec_->children()) {
+    if (!child->hasFilter()) {
+      continue;
+    }
+    if (!child->filter()) {
+      // A filter on a subfield.
+      return false;
+    }
+    if (child->isConstant()) {
+      if (!constantPasses(*child->filter(), *child->constantValue())) {
+        return false;
+      }
+      continue;
+    }
+    auto index = rowType->getChildIdxIfExists(child->fieldName());
+    if (!index.has_value() ||
+        !allValuesPass(
+            *child->filter(),
+            fileStatistics_->columns[index.value()].get(),
+            numRows)) {
+      return false;
+    }
+  }
+  // Columns missing from the file have no values.
+  std::vector<const dwio::common::ColumnStatistics*> stats(
+      aggregators_.size(), nullptr);
+  for (auto channel = 0; channel < aggregators_.size(); ++channel) {
+    if (!aggregators_[channel]) {
+      continue;
+    }
+    auto index =
+        rowType->getChildIdxIfExists(readerOutputType_->nameOf(channel));
+    if (!index.has_value()) {
+      continue;
+    }
+    stats[channel] = fileStatistics_->columns[index.value()].get();
+    if (!aggregators_[channel]->hasStatistics(stats[channel])) {
+      return false;
+    }
+  }
+  aggregatedRows_ += numRows;
+  for (auto channel = 0; channel < aggregators_.size(); ++channel) {
+    if (stats[channel]) {
+      aggregators_[channel]->addStatistics(*stats[channel]);
+    }
+  }
+  return true;
+}
+
+void HiveDataSource::aggregate(
+    const RowVector& rowVector,
+    vector_size_t numRows,
+    const BufferPtr& indices) {
+  aggregatedRows_ += numRows;
+  if (!indices && allRows_.size() < numRows) {
+    allRows_.resize(numRows);
+    std::iota(allRows_.begin(), allRows_.end(), 0);
+  }
+  RowSet rows(
+      indices ? indices->as<vector_size_t>() : allRows_.data(), numRows);
+  for (auto channel = 0; channel < aggregators_.size(); ++channel) {
+    if (aggregators_[channel]) {
+      aggregators_[channel]->addValues(rowVector.childAt(channel), rows);
+    }
+  }
+}
+
+RowVectorPtr HiveDataSource::finishAggregates() {
+  std::vector<VectorPtr> children;
+  children.reserve(aggregates_.size());
+  for (const auto& aggregate : aggregates_) {
+    auto* aggregator = aggregate.channel.has_value()
+        ? aggregators_[aggregate.channel.value()].get()
+        : nullptr;
+    switch (aggregate.kind) {
+      case PushdownAggregate::Kind::kCount:
+        children.push_back(BaseVector::createConstant(
+            variant(aggregator ? aggregator->count() : aggregatedRows_),
+            1,
+            pool_));
+        break;
+      case PushdownAggregate::Kind::kMin:
+        children.push_back(aggregator->min(pool_));
+        break;
+      case PushdownAggregate::Kind::kMax:
+        children.push_back(aggregator->max(pool_));
+        break;
+    }
+  }
+  aggregatedRows_ = 0;
+  for (auto& aggregator : aggregators_) {
+    if (aggregator) {
+      aggregator->clear();
+    }
+  }
+  return std::make_shared<RowVector>(
+      pool_, aggregatesType_, BufferPtr(nullptr), 1, std::move(children));
 }
 
 void HiveDataSource::resetSplit() {
@@ -575,6 +1209,59 @@ void HiveDataSource::resetSplit() {
   // creation, e.g. destroy RowReader first, then destroy Reader.
   rowReader_.reset();
   reader_.reset();
+  wholeFile_.reset();
+  preloadedSource_.reset();
+  fileStatistics_.reset();
+  groupedSplit_.reset();
+}
+
+bool HiveDataSource::addNextGroupedFile() {
+  if (!groupedSplit_ ||
+      nextGroupedFile_ >= groupedSplit_->groupedSplits.size()) {
+    return false;
+  }
+  rowReader_.reset();
+  reader_.reset();
+  wholeFile_.reset();
+  preloadedSource_.reset();
+  fileStatistics_.reset();
+  split_.reset();
+  addFile(groupedSplit_->groupedSplits[nextGroupedFile_++]);
+  return true;
+}
+
+void HiveDataSource::setFromDataSource(std::shared_ptr<DataSource> source) {
+  auto* other = dynamic_cast<HiveDataSource*>(source.get());
+  VELOX_CHECK(other, "Bad DataSource type");
+  VELOX_CHECK(
+      split_ == nullptr,
+      "Previous split has not been processed yet. Call next to process the split.");
+  VELOX_CHECK(other->split_, "DataSource has no preloaded split");
+  split_ = std::move(other->split_);
+  groupedSplit_ = std::move(other->groupedSplit_);
+  nextGroupedFile_ = other->nextGroupedFile_;
+  emptySplit_ = other->emptySplit_;
+  rowReaderLimited_ = other->rowReaderLimited_;
+  checkAggregateStatistics_ = !aggregates_.empty();
+  numPrunedSplits_ += other->numPrunedSplits_;
+  runtimeStats_.skippedSplits += other->runtimeStats_.skippedSplits;
+  runtimeStats_.skippedSplitBytes += other->runtimeStats_.skippedSplitBytes;
+  // The IO of the preloaded split is counted in the IoStatistics of
+  // 'other'. Continue on those with the balance of 'this' added.
+  other->ioStats_->merge(*ioStats_);
+  ioStats_ = other->ioStats_;
+  fileHandle_ = std::move(other->fileHandle_);
+  fileStatistics_ = std::move(other->fileStatistics_);
+  if (!other->reader_) {
+    return;
+  }
+  // The RowReader reads by the ScanSpec of 'other', which has the
+  // constants of the split. Later splits are set up on the same one.
+  scanSpec_ = other->scanSpec_;
+  rowReaderOpts_.setScanSpec(scanSpec_);
+  reader_ = std::move(other->reader_);
+  rowReader_ = std::move(other->rowReader_);
+  preloadedSource_ = std::move(source);
 }
 
 vector_size_t HiveDataSource::evaluateRemainingFilter(RowVectorPtr& rowVector) {
@@ -615,7 +1302,9 @@ void HiveDataSource::setPartitionValue(
 std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
   auto res = runtimeStats_.toMap();
   res.insert(
-      {{"numPrefetch", RuntimeCounter(ioStats_->prefetch().count())},
+      {{"prunedSplits", RuntimeCounter(numPrunedSplits_)},
+       {"aggregatedFiles", RuntimeCounter(numAggregatedFiles_)},
+       {"numPrefetch", RuntimeCounter(ioStats_->prefetch().count())},
        {"prefetchBytes",
         RuntimeCounter(
             ioStats_->prefetch().bytes(), RuntimeCounter::Unit::kBytes)},
@@ -629,7 +1318,15 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
        {"numRamRead", RuntimeCounter(ioStats_->ramHit().count())},
        {"ramReadBytes",
         RuntimeCounter(
-            ioStats_->ramHit().bytes(), RuntimeCounter::Unit::kBytes)}});
+            ioStats_->ramHit().bytes(), RuntimeCounter::Unit::kBytes)},
+       {"coalescedGapBytes",
+        RuntimeCounter(
+            ioStats_->rawOverreadBytes(), RuntimeCounter::Unit::kBytes)}});
+  if (ioStats_->numHedgedReads()) {
+    res.insert(
+        {{"numHedgedReads", RuntimeCounter(ioStats_->numHedgedReads())},
+         {"numHedgeWins", RuntimeCounter(ioStats_->numHedgeWins())}});
+  }
   return res;
 }
 
@@ -15,17 +15,21 @@
  */
 #pragma once
 
+#include "velox/connectors/hive/AggregationPushdown.h"
 #include "velox/connectors/hive/FileHandle.h"
+#include "velox/connectors/hive/FileStatisticsCache.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/common/WriterFactory.h"
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/expression/Expr.h"
 #include "velox/type/Filter.h"
 #include "velox/type/Subfield.h"
+#include "velox/vector/DecodedVector.h"
 
 namespace facebook::velox::connector::hive {
 
@@ -51,6 +55,14 @@ class HiveColumnHandle : public ColumnHandle {
     return dataType_;
   }
 
+  std::string toString() const override {
+    return fmt::format(
+        "{} {} {}",
+        name_,
+        static_cast<int>(columnType_),
+        dataType_ ? dataType_->toString() : "");
+  }
+
  private:
   const std::string name_;
   const ColumnType columnType_;
@@ -95,35 +107,186 @@ class HiveTableHandle : public ConnectorTableHandle {
 /**
  * Represents a request for Hive write
  */
+/// Bucketing of written rows. The bucket of a row is the Hive hash of the
+/// 'bucketedBy' columns modulo 'bucketCount', see HivePartitionFunction.
+struct HiveBucketProperty {
+  int32_t bucketCount;
+  std::vector<std::string> bucketedBy;
+};
+
 class HiveInsertTableHandle : public ConnectorInsertTableHandle {
  public:
-  explicit HiveInsertTableHandle(const std::string& filePath)
-      : filePath_(filePath) {}
+  static constexpr uint64_t kDefaultMaxWriterMemory = 256UL << 20;
+
+  /// Writes one file at 'filePath' unless there are 'partitionedBy' columns,
+  /// a 'bucketProperty' or a 'targetFileSize'. 'filePath' is then a
+  /// directory with a subdirectory <column>=<value>/... per partition, in
+  /// which each bucket has files named <bucket>_<sequence number>, e.g.
+  /// ds=2022-10-01/000003_0. The partition columns are not written to the
+  /// files. A new file of a bucket is started once the current one has
+  /// 'targetFileSize' bytes. The writers of the partitions and buckets share
+  /// 'maxWriterMemory' of buffered data. Writing to more than one file
+  /// requires DWRF.
+  explicit HiveInsertTableHandle(
+      const std::string& filePath,
+      dwio::common::FileFormat fileFormat = dwio::common::FileFormat::DWRF,
+      std::vector<std::string> partitionedBy = {},
+      std::optional<HiveBucketProperty> bucketProperty = std::nullopt,
+      uint64_t targetFileSize = 0,
+      uint64_t maxWriterMemory = kDefaultMaxWriterMemory)
+      : filePath_(filePath),
+        fileFormat_(fileFormat),
+        partitionedBy_(std::move(partitionedBy)),
+        bucketProperty_(std::move(bucketProperty)),
+        targetFileSize_(targetFileSize),
+        maxWriterMemory_(maxWriterMemory) {}
 
   const std::string& filePath() const {
     return filePath_;
   }
 
+  dwio::common::FileFormat fileFormat() const {
+    return fileFormat_;
+  }
+
+  const std::vector<std::string>& partitionedBy() const {
+    return partitionedBy_;
+  }
+
+  const std::optional<HiveBucketProperty>& bucketProperty() const {
+    return bucketProperty_;
+  }
+
+  uint64_t targetFileSize() const {
+    return targetFileSize_;
+  }
+
+  uint64_t maxWriterMemory() const {
+    return maxWriterMemory_;
+  }
+
+  /// True if 'filePath' is a directory of possibly many files.
+  bool isMultiFile() const {
+    return !partitionedBy_.empty() || bucketProperty_.has_value() ||
+        targetFileSize_ > 0;
+  }
+
   virtual ~HiveInsertTableHandle() {}
 
  private:
   const std::string filePath_;
+  const dwio::common::FileFormat fileFormat_;
+  const std::vector<std::string> partitionedBy_;
+  const std::optional<HiveBucketProperty> bucketProperty_;
+  const uint64_t targetFileSize_;
+  const uint64_t maxWriterMemory_;
 };
 
+class HivePartitionFunction;
+
 class HiveDataSink : public DataSink {
  public:
   explicit HiveDataSink(
       std::shared_ptr<const RowType> inputType,
       const std::string& filePath,
+      velox::memory::MemoryPool* FOLLY_NONNULL memoryPool,
+      dwio::common::FileFormat fileFormat = dwio::common::FileFormat::DWRF);
+
+  HiveDataSink(
+      std::shared_ptr<const RowType> inputType,
+      std::shared_ptr<const HiveInsertTableHandle> insertTableHandle,
       velox::memory::MemoryPool* FOLLY_NONNULL memoryPool);
 
+  ~HiveDataSink() override;
+
+  // Value of a null partition column in partition directory names.
+  static constexpr const char* kDefaultPartitionName =
+      "__HIVE_DEFAULT_PARTITION__";
+
+  // Key of the DWRF file metadata entry that holds the sort order, e.g.
+  // "a ASC NULLS LAST,b DESC NULLS FIRST".
+  static constexpr const char* kSortOrderMetadataKey = "velox.sort_order";
+
   void appendData(VectorPtr input) override;
 
+  // Records the order in the metadata of DWRF files. Other formats ignore
+  // it.
+  void setSortOrder(
+      const std::vector<std::string>& sortingColumns,
+      const std::vector<CompareFlags>& sortingFlags) override;
+
   void close() override;
 
+  // Returns the paths of the files closed so far. All files after close().
+  const std::vector<std::string>& writtenFiles() const {
+    return writtenFiles_;
+  }
+
  private:
+  // Writer of one bucket of one partition of a multi-file write.
+  struct PartitionWriter {
+    // Path of the directory of the files.
+    std::string directory;
+    uint32_t bucket;
+    // Sequence number of the current or next file.
+    int32_t fileNumber{0};
+    // Path of the current file.
+    std::string filePath;
+    // Null between rolling over to a new file and the next write.
+    std::unique_ptr<facebook::velox::dwrf::Writer> writer;
+  };
+
+  std::unique_ptr<facebook::velox::dwrf::Writer> createWriter(
+      const std::string& filePath,
+      const std::shared_ptr<const RowType>& type);
+
+  // Sets 'rowWriters_' to the index in 'partitionWriters_' of the writer of
+  // each row of 'input', adding writers for new partitions and buckets.
+  void computeWriters(const RowVector& input);
+
+  // Returns the partition directory of 'row' of the input decoded in
+  // 'decodedPartitionColumns_'.
+  std::string partitionDirectory(vector_size_t row) const;
+
+  // True if rows 'row' and 'other' have the same partition column values.
+  bool samePartition(vector_size_t row, vector_size_t other) const;
+
+  void write(PartitionWriter& partitionWriter, const VectorPtr& data);
+
+  // Flushes the stripes of the writers that use the most memory until the
+  // total is within 'maxWriterMemory_'.
+  void flushLargestWriters();
+
+  void closeWriter(PartitionWriter& partitionWriter);
+
   const std::shared_ptr<const RowType> inputType_;
+  velox::memory::MemoryPool* const FOLLY_NONNULL pool_;
   std::unique_ptr<facebook::velox::dwrf::Writer> writer_;
+  // Writer of formats other than DWRF, created by the WriterFactory
+  // registered for the format.
+  std::unique_ptr<dwio::common::Writer> formatWriter_;
+
+  // Members of multi-file writes.
+  std::shared_ptr<const HiveInsertTableHandle> insertTableHandle_;
+  // Type of the files, i.e. 'inputType_' without the partition columns.
+  std::shared_ptr<const RowType> dataType_;
+  // Channels of the partition columns and of the other columns in
+  // 'inputType_'.
+  std::vector<column_index_t> partitionChannels_;
+  std::vector<column_index_t> dataChannels_;
+  std::unique_ptr<HivePartitionFunction> bucketFunction_;
+  std::vector<PartitionWriter> partitionWriters_;
+  // Index in 'partitionWriters_' by partition directory and bucket.
+  std::unordered_map<std::string, std::vector<int32_t>> writerIndices_;
+  // The value of the metadata key kSortOrderMetadataKey, if set.
+  std::string sortOrder_;
+
+  // Reusable memory.
+  std::vector<uint32_t> buckets_;
+  std::vector<int32_t> rowWriters_;
+  std::vector<DecodedVector> decodedPartitionColumns_;
+
+  std::vector<std::string> writtenFiles_;
 };
 
 class HiveConnector;
@@ -141,7 +304,12 @@ class HiveDataSource : public DataSource {
       ExpressionEvaluator* FOLLY_NONNULL expressionEvaluator,
       memory::MappedMemory* FOLLY_NONNULL mappedMemory,
       const std::string& scanId,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      cache::CacheAdmission cacheAdmission = cache::CacheAdmission(),
+      int32_t decodeStripesAhead = 0,
+      bool adaptiveFilterReorderingEnabled = true,
+      uint64_t groupedFileReadSize = 0,
+      bool biasVectors = false);
 
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
@@ -164,6 +332,31 @@ class HiveDataSource : public DataSource {
 
   int64_t estimatedRowSize() override;
 
+  void setFromDataSource(std::shared_ptr<DataSource> source) override;
+
+  // Passes the limit to the RowReader of the next split unless there is a
+  // remaining filter or aggregates, since the reader counts rows before
+  // these are applied.
+  void setRowLimit(uint64_t numRows) override {
+    rowLimit_ = numRows;
+  }
+
+  // Returns the ScanSpec that the readers of all splits share. Used for
+  // testing.
+  const common::ScanSpec& scanSpec() const {
+    return *scanSpec_;
+  }
+
+  // Supports count(*) and count, min and max of regular columns. Min and max
+  // are limited to integer, floating point and VARCHAR columns. A file whose
+  // statistics show that all its rows pass the filters is answered from the
+  // statistics without reading it, provided the split covers the whole file
+  // and there is no remaining filter. Other files are read and the
+  // aggregated columns are loaded with a ValueHook.
+  bool pushdownAggregates(
+      const std::vector<PushdownAggregate>& aggregates,
+      const RowTypePtr& resultType) override;
+
  private:
   // Evaluates remainingFilter_ on the specified vector. Returns number of rows
   // passed. Populates filterEvalCtx_.selectedIndices and selectedBits if only
@@ -187,6 +380,31 @@ class HiveDataSource : public DataSource {
   /// Clear split_, reader_ and rowReader_ after split has been fully processed.
   void resetSplit();
 
+  // Opens the file of 'split' and sets up 'rowReader_' for it.
+  void addFile(std::shared_ptr<HiveConnectorSplit> split);
+
+  // Replaces the file of 'split_' with the next file of 'groupedSplit_'.
+  // Returns false if there are no more files.
+  bool addNextGroupedFile();
+
+  // Adds the statistics of the file of 'split_' to the aggregates if all
+  // its rows pass the filters. Returns false if the file must be read.
+  bool aggregateFromStatistics();
+
+  // Adds 'numRows' rows of 'rowVector' to the aggregates. These are the
+  // rows at 'indices' or the first 'numRows' rows if 'indices' is nullptr.
+  void aggregate(
+      const RowVector& rowVector,
+      vector_size_t numRows,
+      const BufferPtr& indices);
+
+  // Returns the row of aggregates of the split and clears the aggregates.
+  RowVectorPtr finishAggregates();
+
+  // Resets the finished split. Returns the row of aggregates if there are
+  // aggregates, nullptr otherwise.
+  RowVectorPtr finishSplit();
+
   const std::shared_ptr<const RowType> outputType_;
   // Column handles for the partition key columns keyed on partition key column
   // name.
@@ -197,16 +415,34 @@ class HiveDataSource : public DataSource {
   std::shared_ptr<dwio::common::IoStatistics> ioStats_;
   std::shared_ptr<dwio::common::BufferedInputFactory> bufferedInputFactory_;
   std::shared_ptr<common::ScanSpec> scanSpec_;
+  // The file being read. This is 'groupedSplit_' or one of its
+  // 'groupedSplits' for a grouped split.
   std::shared_ptr<HiveConnectorSplit> split_;
+  // The split added by addSplit() if it has grouped files.
+  std::shared_ptr<HiveConnectorSplit> groupedSplit_;
+  // Index in 'groupedSplit_->groupedSplits' of the file to read next.
+  size_t nextGroupedFile_{0};
   dwio::common::ReaderOptions readerOpts_;
   dwio::common::RowReaderOptions rowReaderOpts_;
+  // The DataSource that prepared 'split_' in the background, if
+  // any. 'reader_' refers to its ReaderOptions, so this is kept until
+  // the split is finished.
+  std::shared_ptr<DataSource> preloadedSource_;
+  // The contents of the file of 'split_' if it is a grouped file that
+  // was read with a single IO. Read by 'reader_'.
+  std::unique_ptr<InMemoryReadFile> wholeFile_;
   std::unique_ptr<dwio::common::Reader> reader_;
   std::unique_ptr<dwio::common::RowReader> rowReader_;
+  // Statistics of the file of 'split_'.
+  std::shared_ptr<const FileStatistics> fileStatistics_;
   std::unique_ptr<exec::ExprSet> remainingFilterExprSet_;
   std::shared_ptr<const RowType> readerOutputType_;
   bool emptySplit_;
 
   dwio::common::RuntimeStatistics runtimeStats_;
+  // Number of splits dropped based on cached file statistics without
+  // opening a reader.
+  int64_t numPrunedSplits_ = 0;
 
   VectorPtr output_;
   FileHandleCachedPtr fileHandle_;
@@ -221,10 +457,68 @@ class HiveDataSource : public DataSource {
   memory::MappedMemory* const FOLLY_NONNULL mappedMemory_;
   const std::string& scanId_;
   folly::Executor* FOLLY_NULLABLE executor_;
+  // Admission policy for the data this brings into AsyncDataCache.
+  const cache::CacheAdmission cacheAdmission_;
+  // Files of grouped splits up to this size are read whole.
+  const uint64_t groupedFileReadSize_;
+
+  // See setRowLimit().
+  uint64_t rowLimit_{std::numeric_limits<uint64_t>::max()};
+  // True if the RowReader of the current split got 'rowLimit_'.
+  bool rowReaderLimited_{false};
+
+  // Aggregates returned in place of the rows, see pushdownAggregates().
+  std::vector<PushdownAggregate> aggregates_;
+  RowTypePtr aggregatesType_;
+  // Aggregators by output channel, nullptr for columns without aggregates.
+  std::vector<std::unique_ptr<ColumnAggregator>> aggregators_;
+  // count(*) of the current split.
+  int64_t aggregatedRows_{0};
+  // 0, 1, 2, ... for loading all rows of a batch into the aggregators.
+  std::vector<vector_size_t> allRows_;
+  // True until the statistics of the current file have been checked for
+  // aggregates.
+  bool checkAggregateStatistics_{false};
+  // True after next() has returned the aggregates of a split. The next call
+  // returns nullptr.
+  bool aggregatesReturned_{false};
+  // Number of files whose aggregates came from their statistics.
+  int64_t numAggregatedFiles_{0};
 };
 
 class HiveConnector final : public Connector {
  public:
+  // Session properties for the admission of scanned data into
+  // AsyncDataCache, see cache::CacheAdmission. Setting these for
+  // ad-hoc queries keeps their one-off scans from flushing the cache.
+
+  // If true, rejects new entries that are less frequently accessed
+  // than the entries they would replace.
+  static constexpr const char* FOLLY_NONNULL kCacheFrequencyFilter =
+      "cache_frequency_filter";
+  // Number of accesses an entry needs before it is written to SSD.
+  static constexpr const char* FOLLY_NONNULL kCacheMinSsdHits =
+      "cache_min_ssd_hits";
+  // Cache pool, e.g. tenant, of the scanned data. See
+  // AsyncDataCache::setPoolShare().
+  static constexpr const char* FOLLY_NONNULL kCachePool = "cache_pool";
+
+  // Number of stripes of a split to decode ahead on the connector's
+  // executor. 0 decodes on the driver thread.
+  static constexpr const char* FOLLY_NONNULL kDecodeStripesAhead =
+      "decode_stripes_ahead";
+
+  // Files of a grouped split, see HiveConnectorSplit::groupedSplits, up
+  // to this many bytes are read with a single IO into memory instead of
+  // through AsyncDataCache. 0 reads them like any other file.
+  static constexpr const char* FOLLY_NONNULL kGroupedFileReadSize =
+      "grouped_file_read_size";
+  static constexpr uint64_t kDefaultGroupedFileReadSize = 8 << 20;
+
+  // If true, integer columns whose values in a batch span a narrow range are
+  // returned as BiasVectors of 8, 16 or 32 bit values.
+  static constexpr const char* FOLLY_NONNULL kBiasVectors = "bias_vectors";
+
   explicit HiveConnector(
       const std::string& id,
       std::shared_ptr<const Config> properties,
@@ -250,7 +544,13 @@ class HiveConnector final : public Connector {
         connectorQueryCtx->expressionEvaluator(),
         connectorQueryCtx->mappedMemory(),
         connectorQueryCtx->scanId(),
-        executor_);
+        executor_,
+        cacheAdmission(connectorQueryCtx->config()),
+        connectorQueryCtx->config()->get<int32_t>(kDecodeStripesAhead, 0),
+        connectorQueryCtx->adaptiveFilterReorderingEnabled(),
+        connectorQueryCtx->config()->get<uint64_t>(
+            kGroupedFileReadSize, kDefaultGroupedFileReadSize),
+        connectorQueryCtx->config()->get<bool>(kBiasVectors, false));
   }
 
   std::shared_ptr<DataSink> createDataSink(
@@ -263,16 +563,37 @@ class HiveConnector final : public Connector {
         hiveInsertHandle != nullptr,
         "Hive connector expecting hive write handle!");
     return std::make_shared<HiveDataSink>(
-        inputType,
-        hiveInsertHandle->filePath(),
-        connectorQueryCtx->memoryPool());
+        inputType, hiveInsertHandle, connectorQueryCtx->memoryPool());
+  }
+
+  bool supportsSplitPreload() override {
+    return true;
   }
 
-  folly::Executor* FOLLY_NULLABLE executor() {
+  bool supportsAggregationPushdown() const override {
+    return true;
+  }
+
+  folly::Executor* FOLLY_NULLABLE executor() const override {
     return executor_;
   }
 
  private:
+  static cache::CacheAdmission cacheAdmission(
+      const Config* FOLLY_NONNULL config) {
+    cache::CacheAdmission admission;
+    admission.frequencyFilter = config->get<bool>(kCacheFrequencyFilter, false);
+    admission.minSsdHits = config->get<int32_t>(kCacheMinSsdHits, 0);
+    admission.poolId = config->get<int32_t>(kCachePool, 0);
+    VELOX_USER_CHECK(
+        admission.poolId >= 0 &&
+            admission.poolId < cache::AsyncDataCache::kMaxPools,
+        "{} must be in [0, {})",
+        kCachePool,
+        cache::AsyncDataCache::kMaxPools);
+    return admission;
+  }
+
   FileHandleFactory fileHandleFactory_;
   folly::Executor* FOLLY_NULLABLE executor_;
 
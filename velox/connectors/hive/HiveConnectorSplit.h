@@ -17,6 +17,7 @@
 
 #include <optional>
 #include <unordered_map>
+#include <vector>
 #include "velox/connectors/Connector.h"
 #include "velox/dwio/common/Options.h"
 
@@ -31,6 +32,17 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
       partitionKeys;
   std::optional<int32_t> tableBucketNumber;
 
+  // Files read after 'filePath' as part of the same split. They have the
+  // same format and columns as 'filePath' but may have their own
+  // partition keys. Grouping many small files into one split lets them
+  // share the DataSource state and a single IO per file, see
+  // HiveConnector::kGroupedFileReadSize.
+  std::vector<std::shared_ptr<HiveConnectorSplit>> groupedSplits;
+
+  // Version of the contents of 'filePath', e.g. its modification time or
+  // etag, if known. Without it the data of 'this' has no version.
+  std::optional<std::string> fileVersion;
+
   HiveConnectorSplit(
       const std::string& connectorId,
       const std::string& _filePath,
@@ -49,6 +61,14 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
         tableBucketNumber(_tableBucketNumber) {}
 
   std::string toString() const override {
+    if (!groupedSplits.empty()) {
+      return fmt::format(
+          "[file {} {} - {} and {} more files]",
+          filePath,
+          start,
+          length,
+          groupedSplits.size());
+    }
     if (tableBucketNumber.has_value()) {
       return fmt::format(
           "[file {} {} - {} {}]",
@@ -59,6 +79,51 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
     }
     return fmt::format("[file {} {} - {}]", filePath, start, length);
   }
+
+  std::optional<std::string> dataVersion() const override {
+    if (!fileVersion.has_value()) {
+      return std::nullopt;
+    }
+    auto version = fmt::format(
+        "{} {} {} {}", filePath, start, length, fileVersion.value());
+    for (const auto& split : groupedSplits) {
+      auto groupedVersion = split->dataVersion();
+      if (!groupedVersion.has_value()) {
+        return std::nullopt;
+      }
+      version += "; " + groupedVersion.value();
+    }
+    return version;
+  }
+
+  // A byte range of a file has the stripes or row groups that start in it.
+  // The length of a split of a whole file is not known.
+  std::vector<std::shared_ptr<ConnectorSplit>> divide(
+      uint64_t size) const override {
+    if (!groupedSplits.empty() ||
+        length == std::numeric_limits<uint64_t>::max() || length <= size) {
+      return {};
+    }
+    auto first = std::make_shared<HiveConnectorSplit>(
+        connectorId,
+        filePath,
+        fileFormat,
+        start,
+        size,
+        partitionKeys,
+        tableBucketNumber);
+    first->fileVersion = fileVersion;
+    auto rest = std::make_shared<HiveConnectorSplit>(
+        connectorId,
+        filePath,
+        fileFormat,
+        start + size,
+        length - size,
+        partitionKeys,
+        tableBucketNumber);
+    rest->fileVersion = fileVersion;
+    return {std::move(first), std::move(rest)};
+  }
 };
 
 } // namespace facebook::velox::connector::hive
@@ -36,6 +36,23 @@ void abstractHashTyped(
     bool mix,
     Func&& hashOne,
     std::vector<uint32_t>& hashes) {
+  if constexpr (!std::is_same_v<T, bool>) {
+    // Flat values without nulls are hashed in loops without branches, which
+    // the compiler vectorizes for the fixed width types.
+    if (values.isIdentityMapping() && !values.mayHaveNulls()) {
+      const auto* rawValues = values.data<T>();
+      if (mix) {
+        for (auto i = 0; i < size; ++i) {
+          hashes[i] = hashes[i] * 31 + hashOne(rawValues[i]);
+        }
+      } else {
+        for (auto i = 0; i < size; ++i) {
+          hashes[i] = hashOne(rawValues[i]);
+        }
+      }
+      return;
+    }
+  }
   for (auto i = 0; i < size; ++i) {
     const uint32_t hash =
         (values.isNullAt(i)) ? 0 : hashOne(values.valueAt<T>(i));
@@ -209,6 +226,13 @@ void hashPrecomputed(
     hashes[i] = mix ? hashes[i] * 31 + precomputedHash : precomputedHash;
   }
 }
+
+// Returns the hash of the first row of 'values'.
+uint32_t hashFirst(const DecodedVector& values, TypeKind typeKind) {
+  std::vector<uint32_t> hashes(1);
+  hash(values, typeKind, 1, false, hashes);
+  return hashes[0];
+}
 } // namespace
 
 HivePartitionFunction::HivePartitionFunction(
@@ -234,33 +258,85 @@ void HivePartitionFunction::partition(
     std::vector<uint32_t>& partitions) {
   const auto numRows = input.size();
 
+  rows_.resize(numRows);
+  rows_.setAll();
   if (numRows > hashes_.size()) {
-    rows_.resize(numRows);
-    rows_.setAll();
     hashes_.resize(numRows);
   }
 
   partitions.resize(numRows);
+  if (numRows == 0) {
+    return;
+  }
+
+  // A single key that is constant or a dictionary over fewer values than the
+  // rows gets its partitions from the distinct values without hashing each
+  // row.
+  const bool singleKey = keyChannels_.size() == 1;
   for (auto i = 0; i < keyChannels_.size(); ++i) {
-    if (keyChannels_[i] != kConstantChannel) {
-      const auto& keyVector = input.childAt(keyChannels_[i]);
-      decodedVectors_[i].decode(*keyVector, rows_);
-      hash(
-          decodedVectors_[i],
-          keyVector->typeKind(),
-          keyVector->size(),
-          i > 0,
-          hashes_);
-    } else {
+    if (keyChannels_[i] == kConstantChannel) {
+      if (singleKey) {
+        std::fill(
+            partitions.begin(),
+            partitions.end(),
+            toPartition(precomputedHashes_[i]));
+        return;
+      }
       hashPrecomputed(precomputedHashes_[i], numRows, i > 0, hashes_);
+      continue;
     }
-  }
 
-  static const int32_t kInt32Max = std::numeric_limits<int32_t>::max();
+    const auto& keyVector = input.childAt(keyChannels_[i]);
+    auto& decoded = decodedVectors_[i];
+    decoded.decode(*keyVector, rows_);
+    if (decoded.isConstantMapping()) {
+      const auto keyHash = hashFirst(decoded, keyVector->typeKind());
+      if (singleKey) {
+        std::fill(partitions.begin(), partitions.end(), toPartition(keyHash));
+        return;
+      }
+      hashPrecomputed(keyHash, numRows, i > 0, hashes_);
+    } else if (
+        !decoded.isIdentityMapping() && decoded.base()->size() < numRows) {
+      hashDictionary(decoded, keyVector->typeKind(), i > 0);
+      if (singleKey) {
+        const auto nullPartition = toPartition(0);
+        for (auto& hash : baseHashes_) {
+          hash = toPartition(hash);
+        }
+        for (auto row = 0; row < numRows; ++row) {
+          partitions[row] = decoded.isNullAt(row)
+              ? nullPartition
+              : baseHashes_[decoded.index(row)];
+        }
+        return;
+      }
+    } else {
+      hash(decoded, keyVector->typeKind(), numRows, i > 0, hashes_);
+    }
+  }
 
   for (auto i = 0; i < numRows; ++i) {
-    partitions[i] =
-        bucketToPartition_[((hashes_[i] & kInt32Max) % numBuckets_)];
+    partitions[i] = toPartition(hashes_[i]);
+  }
+}
+
+void HivePartitionFunction::hashDictionary(
+    const DecodedVector& decoded,
+    TypeKind typeKind,
+    bool mix) {
+  const auto* base = decoded.base();
+  const SelectivityVector baseRows(base->size());
+  const DecodedVector decodedBase(*base, baseRows);
+  baseHashes_.resize(base->size());
+  hash(decodedBase, typeKind, base->size(), false, baseHashes_);
+  if (keyChannels_.size() == 1) {
+    return;
+  }
+  for (auto row = 0; row < decoded.size(); ++row) {
+    const uint32_t hash =
+        decoded.isNullAt(row) ? 0 : baseHashes_[decoded.index(row)];
+    hashes_[row] = mix ? hashes_[row] * 31 + hash : hash;
   }
 }
 
@@ -274,10 +350,8 @@ void HivePartitionFunction::precompute(
 
   const SelectivityVector rows(1, true);
   decodedVectors_[channelIndex].decode(value, rows);
-
-  std::vector<uint32_t> hashes{1};
-  hash(decodedVectors_[channelIndex], value.typeKind(), 1, false, hashes);
-  precomputedHashes_[channelIndex] = hashes[0];
+  precomputedHashes_[channelIndex] =
+      hashFirst(decodedVectors_[channelIndex], value.typeKind());
 }
 
 } // namespace facebook::velox::connector::hive
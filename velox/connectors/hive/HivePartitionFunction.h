@@ -37,6 +37,19 @@ class HivePartitionFunction : public core::PartitionFunction {
   // Precompute single value hive hash for a constant partition key.
   void precompute(const BaseVector& value, size_t column_index_t);
 
+  // Sets 'baseHashes_' to the hashes of the base of the dictionary encoded
+  // key 'decoded' and mixes them into 'hashes_' unless the key is the only
+  // one.
+  void hashDictionary(
+      const DecodedVector& decoded,
+      TypeKind typeKind,
+      bool mix);
+
+  uint32_t toPartition(uint32_t hash) const {
+    static constexpr int32_t kInt32Max = std::numeric_limits<int32_t>::max();
+    return bucketToPartition_[(hash & kInt32Max) % numBuckets_];
+  }
+
   const int numBuckets_;
   const std::vector<int> bucketToPartition_;
   const std::vector<column_index_t> keyChannels_;
@@ -47,5 +60,7 @@ class HivePartitionFunction : public core::PartitionFunction {
   std::vector<DecodedVector> decodedVectors_;
   // Precomputed hashes for constant partition keys (one per key).
   std::vector<uint32_t> precomputedHashes_;
+  // Hashes, or for a single key partitions, of the base of a dictionary key.
+  std::vector<uint32_t> baseHashes_;
 };
 } // namespace facebook::velox::connector::hive
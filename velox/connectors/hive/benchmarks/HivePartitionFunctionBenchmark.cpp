@@ -53,9 +53,24 @@ class HivePartitionFunctionBenchmark
     opts.stringLength = 20;
     VectorFuzzer fuzzer(opts, pool(), FLAGS_fuzzer_seed);
     VectorMaker vm{pool_.get()};
+    // The dictionaries have 100 distinct values.
+    VectorFuzzer::Options baseOpts = opts;
+    baseOpts.vectorSize = 100;
+    VectorFuzzer baseFuzzer(baseOpts, pool(), FLAGS_fuzzer_seed);
+    auto indices = AlignedBuffer::allocate<vector_size_t>(vectorSize, pool());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < vectorSize; ++i) {
+      rawIndices[i] = (i * 37) % baseOpts.vectorSize;
+    }
     for (auto typeKind : kSupportedTypes) {
-      auto flatVector = fuzzer.fuzzFlat(createScalarType(typeKind));
+      auto type = createScalarType(typeKind);
+      auto flatVector = fuzzer.fuzzFlat(type);
       rowVectors_[typeKind] = vm.rowVector({flatVector});
+      dictionaryRowVectors_[typeKind] =
+          vm.rowVector({BaseVector::wrapInDictionary(
+              nullptr, indices, vectorSize, baseFuzzer.fuzzFlat(type))});
+      constantRowVectors_[typeKind] =
+          vm.rowVector({BaseVector::wrapInConstant(vectorSize, 0, flatVector)});
     }
 
     // Prepare HivePartitionFunction
@@ -75,6 +90,16 @@ class HivePartitionFunctionBenchmark
     run<KIND>(manyBucketsFunction_.get());
   }
 
+  template <TypeKind KIND>
+  void runDictionary() {
+    manyBucketsFunction_->partition(*dictionaryRowVectors_[KIND], partitions_);
+  }
+
+  template <TypeKind KIND>
+  void runConstant() {
+    manyBucketsFunction_->partition(*constantRowVectors_[KIND], partitions_);
+  }
+
  private:
   std::unique_ptr<HivePartitionFunction> createHivePartitionFunction(
       size_t bucketCount) {
@@ -96,6 +121,8 @@ class HivePartitionFunctionBenchmark
   }
 
   std::unordered_map<TypeKind, RowVectorPtr> rowVectors_;
+  std::unordered_map<TypeKind, RowVectorPtr> dictionaryRowVectors_;
+  std::unordered_map<TypeKind, RowVectorPtr> constantRowVectors_;
   std::unique_ptr<HivePartitionFunction> fewBucketsFunction_;
   std::unique_ptr<HivePartitionFunction> manyBucketsFunction_;
   std::vector<uint32_t> partitions_;
@@ -192,6 +219,14 @@ BENCHMARK_RELATIVE(bigintManyRowsManyBuckets) {
   benchmarkMany->runMany<TypeKind::BIGINT>();
 }
 
+BENCHMARK_RELATIVE(bigintManyRowsDictionary) {
+  benchmarkMany->runDictionary<TypeKind::BIGINT>();
+}
+
+BENCHMARK_RELATIVE(bigintManyRowsConstant) {
+  benchmarkMany->runConstant<TypeKind::BIGINT>();
+}
+
 BENCHMARK_DRAW_LINE();
 
 BENCHMARK(realFewRowsFewBuckets) {
@@ -246,6 +281,14 @@ BENCHMARK_RELATIVE(varcharManyRowsManyBuckets) {
   benchmarkMany->runMany<TypeKind::VARCHAR>();
 }
 
+BENCHMARK_RELATIVE(varcharManyRowsDictionary) {
+  benchmarkMany->runDictionary<TypeKind::VARCHAR>();
+}
+
+BENCHMARK_RELATIVE(varcharManyRowsConstant) {
+  benchmarkMany->runConstant<TypeKind::VARCHAR>();
+}
+
 BENCHMARK_DRAW_LINE();
 
 BENCHMARK(timestampFewRowsFewBuckets) {
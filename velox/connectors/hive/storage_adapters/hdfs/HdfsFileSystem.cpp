@@ -35,9 +35,13 @@ class HdfsFileSystem::Impl {
         hdfsClient_,
         "Unable to connect to HDFS, got error: {}.",
         hdfsGetLastError())
+    hedgedReader_ =
+        std::make_unique<HedgedReader>(getHedgedReadOptions(config));
   }
 
   ~Impl() {
+    // Waits for the requests of hedged reads that use 'hdfsClient_'.
+    hedgedReader_.reset();
     LOG(INFO) << "Disconnecting HDFS file system";
     int disconnectResult = hdfsDisconnect(hdfsClient_);
     if (disconnectResult != 0) {
@@ -59,12 +63,26 @@ class HdfsFileSystem::Impl {
     return endpoint;
   }
 
+  static HedgedReadOptions getHedgedReadOptions(const Config* config) {
+    HedgedReadOptions options;
+    options.percentile =
+        config->get("hive.hdfs.hedged-read-percentile", options.percentile);
+    options.numThreads =
+        config->get("hive.hdfs.hedged-read-threads", options.numThreads);
+    return options;
+  }
+
   hdfsFS hdfsClient() {
     return hdfsClient_;
   }
 
+  HedgedReader* hedgedReader() {
+    return hedgedReader_.get();
+  }
+
  private:
   hdfsFS hdfsClient_;
+  std::unique_ptr<HedgedReader> hedgedReader_;
 };
 
 HdfsFileSystem::HdfsFileSystem(const std::shared_ptr<const Config>& config)
@@ -85,7 +103,8 @@ std::unique_ptr<ReadFile> HdfsFileSystem::openFileForRead(
     path.remove_prefix(index);
   }
 
-  return std::make_unique<HdfsReadFile>(impl_->hdfsClient(), path);
+  return std::make_unique<HdfsReadFile>(
+      impl_->hdfsClient(), path, impl_->hedgedReader());
 }
 
 std::unique_ptr<WriteFile> HdfsFileSystem::openFileForWrite(
@@ -20,47 +20,84 @@
 
 namespace facebook::velox {
 
-HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
-    : hdfsClient_(hdfs), filePath_(path) {
-  fileInfo_ = hdfsGetPathInfo(hdfsClient_, filePath_.data());
-  VELOX_CHECK_NOT_NULL(
-      fileInfo_,
-      "Unable to get file path info for file: {}. got error: {}",
-      filePath_,
-      hdfsGetLastError());
+namespace {
+void seekToPosition(
+    hdfsFS hdfsClient,
+    hdfsFile file,
+    const std::string& filePath,
+    uint64_t offset) {
+  auto seekStatus = hdfsSeek(hdfsClient, file, offset);
+  VELOX_CHECK_EQ(
+      seekStatus,
+      0,
+      "Cannot seek through HDFS file: {}, error: {}",
+      filePath,
+      std::string(hdfsGetLastError()));
 }
 
-void HdfsReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
-    const {
-  checkFileReadParameters(offset, length);
-  auto file = hdfsOpenFile(hdfsClient_, filePath_.data(), O_RDONLY, 0, 0, 0);
+// Reads [offset, offset + length) of 'filePath' into 'pos' through a file
+// opened for the read. Stops early if 'cancelled' is set. Does not reference
+// the HdfsReadFile since a cancelled hedged read may outlive it.
+void readRange(
+    hdfsFS hdfsClient,
+    const std::string& filePath,
+    uint64_t offset,
+    uint64_t length,
+    char* pos,
+    const std::atomic<bool>& cancelled) {
+  auto file = hdfsOpenFile(hdfsClient, filePath.data(), O_RDONLY, 0, 0, 0);
   VELOX_CHECK_NOT_NULL(
       file,
       "Unable to open file {}. got error: {}",
-      filePath_,
+      filePath,
       hdfsGetLastError());
-  seekToPosition(file, offset);
+  seekToPosition(hdfsClient, file, filePath, offset);
   uint64_t totalBytesRead = 0;
-  while (totalBytesRead < length) {
-    auto bytesRead = hdfsRead(hdfsClient_, file, pos, length - totalBytesRead);
+  while (totalBytesRead < length && !cancelled) {
+    auto bytesRead = hdfsRead(hdfsClient, file, pos, length - totalBytesRead);
     VELOX_CHECK(bytesRead >= 0, "Read failure in HDFSReadFile::preadInternal.")
     totalBytesRead += bytesRead;
     pos += bytesRead;
   }
 
-  if (hdfsCloseFile(hdfsClient_, file) == -1) {
+  if (hdfsCloseFile(hdfsClient, file) == -1) {
     LOG(ERROR) << "Unable to close file, errno: " << errno;
   }
 }
+} // namespace
 
-void HdfsReadFile::seekToPosition(hdfsFile file, uint64_t offset) const {
-  auto seekStatus = hdfsSeek(hdfsClient_, file, offset);
-  VELOX_CHECK_EQ(
-      seekStatus,
-      0,
-      "Cannot seek through HDFS file: {}, error: {}",
+HdfsReadFile::HdfsReadFile(
+    hdfsFS hdfs,
+    const std::string_view path,
+    HedgedReader* hedgedReader)
+    : hdfsClient_(hdfs), filePath_(path), hedgedReader_(hedgedReader) {
+  fileInfo_ = hdfsGetPathInfo(hdfsClient_, filePath_.data());
+  VELOX_CHECK_NOT_NULL(
+      fileInfo_,
+      "Unable to get file path info for file: {}. got error: {}",
       filePath_,
-      std::string(hdfsGetLastError()));
+      hdfsGetLastError());
+}
+
+void HdfsReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
+    const {
+  checkFileReadParameters(offset, length);
+  if (!hedgedReader_) {
+    std::atomic<bool> cancelled{false};
+    readRange(hdfsClient_, filePath_, offset, length, pos, cancelled);
+    return;
+  }
+  // Each request opens the file anew, so the duplicate of a slow read may be
+  // served by another datanode.
+  hedgedReader_->read(
+      length,
+      pos,
+      [hdfsClient = hdfsClient_, filePath = filePath_, offset, length](
+          int32_t /*attempt*/,
+          char* dest,
+          const std::atomic<bool>& cancelled) {
+        readRange(hdfsClient, filePath, offset, length, dest, cancelled);
+      });
 }
 
 std::string_view
@@ -16,12 +16,17 @@
 
 #include <hdfs/hdfs.h>
 #include "velox/common/file/File.h"
+#include "velox/common/file/HedgedRead.h"
 
 namespace facebook::velox {
 
 class HdfsReadFile final : public ReadFile {
  public:
-  explicit HdfsReadFile(hdfsFS hdfs, std::string_view path);
+  // Reads through 'hedgedReader' if given. It must outlive 'this'.
+  explicit HdfsReadFile(
+      hdfsFS hdfs,
+      std::string_view path,
+      HedgedReader* hedgedReader = nullptr);
 
   std::string_view pread(uint64_t offset, uint64_t length, void* buf)
       const final;
@@ -36,10 +41,10 @@ class HdfsReadFile final : public ReadFile {
 
  private:
   void preadInternal(uint64_t offset, uint64_t length, char* pos) const;
-  void seekToPosition(hdfsFile file, uint64_t offset) const;
   void checkFileReadParameters(uint64_t offset, uint64_t length) const;
   hdfsFS hdfsClient_;
   hdfsFileInfo* fileInfo_;
   std::string filePath_;
+  HedgedReader* const hedgedReader_;
 };
 } // namespace facebook::velox
@@ -15,12 +15,17 @@
  */
 
 #include "velox/connectors/hive/storage_adapters/s3fs/S3FileSystem.h"
+#include "velox/common/base/CoalesceIo.h"
 #include "velox/common/file/File.h"
+#include "velox/common/file/HedgedRead.h"
 #include "velox/connectors/hive/storage_adapters/s3fs/S3Util.h"
 #include "velox/core/Context.h"
 
 #include <fmt/format.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
 #include <glog/logging.h>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 
@@ -59,10 +64,30 @@ Aws::IOStreamFactory AwsWriteableStreamFactory(void* data, int64_t nbytes) {
   return [=]() { return Aws::New<StringViewStream>("", data, nbytes); };
 }
 
+// Options for the parallel ranged GETs of S3ReadFile::preadvAsync().
+struct S3ReadOptions {
+  // Ranges separated by at most this many bytes are read in one GET.
+  int32_t maxCoalesceDistance{512 << 10};
+
+  // A GET reads at most this many bytes. Larger coalesced reads are split
+  // into parts that are read in parallel.
+  uint64_t partSize{8 << 20};
+};
+
 class S3ReadFile final : public ReadFile {
  public:
-  S3ReadFile(const std::string& path, Aws::S3::S3Client* client)
-      : client_(client) {
+  // If 'executor' is given, preadvAsync() issues its GETs on it. GETs go
+  // through 'hedgedReader' if given. Both must outlive 'this'.
+  S3ReadFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      folly::Executor* executor = nullptr,
+      S3ReadOptions options = {},
+      HedgedReader* hedgedReader = nullptr)
+      : client_(client),
+        executor_(executor),
+        options_(options),
+        hedgedReader_(hedgedReader) {
     bucketAndKeyFromS3Path(path, bucket_, key_);
   }
 
@@ -111,6 +136,10 @@ class S3ReadFile final : public ReadFile {
     for (const auto range : buffers) {
       length += range.size();
     }
+    if (buffers.size() == 1 && buffers[0].data()) {
+      preadInternal(offset, length, buffers[0].data());
+      return length;
+    }
     // TODO: allocate from a memory pool
     std::string result(length, 0);
     preadInternal(offset, length, static_cast<char*>(result.data()));
@@ -124,6 +153,66 @@ class S3ReadFile final : public ReadFile {
     return length;
   }
 
+  // Reads the ranges of 'buffers' with parallel GETs on 'executor_'. Ranges
+  // closer than 'maxCoalesceDistance' are read by one GET and GETs larger
+  // than 'partSize' are split into parts. The file must stay live until the
+  // result is realized.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override {
+    if (!executor_) {
+      return ReadFile::preadvAsync(offset, buffers);
+    }
+    struct Item {
+      uint64_t offset;
+      folly::Range<char*> buffer;
+    };
+    std::vector<Item> items;
+    uint64_t length = 0;
+    for (auto& range : buffers) {
+      if (range.data() && !range.empty()) {
+        items.push_back({offset + length, range});
+      }
+      length += range.size();
+    }
+    std::vector<folly::SemiFuture<folly::Unit>> reads;
+    if (!items.empty()) {
+      coalesceIo<Item, folly::Range<char*>>(
+          items,
+          options_.maxCoalesceDistance,
+          std::numeric_limits<int32_t>::max(),
+          [&](int32_t index) { return items[index].offset; },
+          [&](int32_t index) { return items[index].buffer.size(); },
+          [&](int32_t /*index*/) { return 1; },
+          [&](const Item& item, std::vector<folly::Range<char*>>& ranges) {
+            ranges.push_back(item.buffer);
+          },
+          [&](int64_t gap, std::vector<folly::Range<char*>>& ranges) {
+            ranges.push_back(folly::Range<char*>(nullptr, gap));
+          },
+          [&](const std::vector<Item>& /*items*/,
+              int32_t /*begin*/,
+              int32_t /*end*/,
+              uint64_t ioOffset,
+              const std::vector<folly::Range<char*>>& ranges) {
+            readParts(ioOffset, ranges, reads);
+          });
+    }
+    // Waits for all GETs even if one fails so that none writes into
+    // 'buffers' after the result is realized.
+    return folly::collectAll(std::move(reads))
+        .deferValue([length](auto&& results) {
+          for (auto& result : results) {
+            result.value();
+          }
+          return length;
+        });
+  }
+
+  bool hasPreadvAsync() const override {
+    return executor_ != nullptr;
+  }
+
   uint64_t size() const override {
     return length_;
   }
@@ -139,25 +228,102 @@ class S3ReadFile final : public ReadFile {
   }
 
  private:
+  // Splits the coalesced read of 'ranges' at 'offset' into GETs of at most
+  // 'partSize' bytes and adds a future for each to 'reads'.
+  void readParts(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& ranges,
+      std::vector<folly::SemiFuture<folly::Unit>>& reads) const {
+    std::vector<folly::Range<char*>> part;
+    uint64_t partOffset = offset;
+    uint64_t partBytes = 0;
+    auto flushPart = [&]() {
+      auto nextOffset = partOffset + partBytes;
+      while (!part.empty() && !part.back().data()) {
+        part.pop_back();
+      }
+      if (!part.empty()) {
+        reads.push_back(
+            folly::via(
+                executor_,
+                [this, partOffset, part = std::move(part)]() {
+                  preadv(partOffset, part);
+                })
+                .semi());
+      }
+      part.clear();
+      partOffset = nextOffset;
+      partBytes = 0;
+    };
+    for (auto range : ranges) {
+      while (!range.empty()) {
+        if (part.empty() && !range.data()) {
+          // A part does not start with a gap.
+          partOffset += range.size();
+          break;
+        }
+        auto bytes = std::min<uint64_t>(
+            range.size(), options_.partSize - partBytes);
+        part.push_back(folly::Range<char*>(range.data(), bytes));
+        partBytes += bytes;
+        range = folly::Range<char*>(
+            range.data() ? range.data() + bytes : nullptr,
+            range.size() - bytes);
+        if (partBytes == options_.partSize) {
+          flushPart();
+        }
+      }
+    }
+    flushPart();
+  }
+
   // The assumption here is that "position" has space for at least "length"
   // bytes.
   void preadInternal(uint64_t offset, uint64_t length, char* position) const {
-    // Read the desired range of bytes.
+    if (!hedgedReader_) {
+      getObject(client_, bucket_, key_, offset, length, position);
+      return;
+    }
+    // A duplicate GET goes over another pooled connection. It is not
+    // interrupted when cancelled.
+    hedgedReader_->read(
+        length,
+        position,
+        [client = client_, bucket = bucket_, key = key_, offset, length](
+            int32_t /*attempt*/,
+            char* dest,
+            const std::atomic<bool>& /*cancelled*/) {
+          getObject(client, bucket, key, offset, length, dest);
+        });
+  }
+
+  // Reads the desired range of bytes. Does not reference the S3ReadFile
+  // since a cancelled hedged read may outlive it.
+  static void getObject(
+      Aws::S3::S3Client* client,
+      const std::string& bucket,
+      const std::string& key,
+      uint64_t offset,
+      uint64_t length,
+      char* position) {
     Aws::S3::Model::GetObjectRequest request;
     Aws::S3::Model::GetObjectResult result;
 
-    request.SetBucket(awsString(bucket_));
-    request.SetKey(awsString(key_));
+    request.SetBucket(awsString(bucket));
+    request.SetKey(awsString(key));
     std::stringstream ss;
     ss << "bytes=" << offset << "-" << offset + length - 1;
     request.SetRange(awsString(ss.str()));
     request.SetResponseStreamFactory(
         AwsWriteableStreamFactory(position, length));
-    auto outcome = client_->GetObject(request);
-    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket_, key_);
+    auto outcome = client->GetObject(request);
+    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket, key);
   }
 
   Aws::S3::S3Client* client_;
+  folly::Executor* const executor_;
+  const S3ReadOptions options_;
+  HedgedReader* const hedgedReader_;
   std::string bucket_;
   std::string key_;
   int64_t length_ = -1;
@@ -209,6 +375,46 @@ class S3Config {
     return {};
   }
 
+  // Number of threads issuing the GETs of asynchronous reads. 0 makes
+  // preadvAsync() synchronous.
+  int32_t readThreads() const {
+    return config_->get("hive.s3.read-threads", 16);
+  }
+
+  // Maximum number of HTTP connections the S3 client keeps open for reuse.
+  int32_t maxConnections() const {
+    return config_->get("hive.s3.max-connections", 25);
+  }
+
+  HedgedReadOptions hedgedReadOptions() const {
+    HedgedReadOptions options;
+    options.percentile =
+        config_->get("hive.s3.hedged-read-percentile", options.percentile);
+    options.numThreads =
+        config_->get("hive.s3.hedged-read-threads", options.numThreads);
+    return options;
+  }
+
+  CoalescePolicyOptions coalescePolicyOptions() const {
+    auto options = CoalescePolicy::objectStoreOptions();
+    options.maxDistance = config_->get(
+        "hive.s3.coalesce-policy.max-distance", options.maxDistance);
+    options.maxIoBytes = config_->get(
+        "hive.s3.coalesce-policy.max-io-bytes", options.maxIoBytes);
+    options.autoTune =
+        config_->get("hive.s3.coalesce-policy.auto-tune", options.autoTune);
+    return options;
+  }
+
+  S3ReadOptions readOptions() const {
+    S3ReadOptions options;
+    options.maxCoalesceDistance = config_->get(
+        "hive.s3.max-coalesce-distance", options.maxCoalesceDistance);
+    options.partSize =
+        config_->get("hive.s3.read-part-size", options.partSize);
+    return options;
+  }
+
   std::string iamRoleSessionName() const {
     return config_->get(
         "hive.s3.iam-role-session-name", std::string("velox-session"));
@@ -313,6 +519,11 @@ class S3FileSystem::Impl {
       clientConfig.scheme = Aws::Http::Scheme::HTTP;
     }
 
+    // Pooled connections are reused by the GETs of all files. Keeps at least
+    // one per read thread so that parallel GETs do not reconnect.
+    clientConfig.maxConnections =
+        std::max(s3Config_.maxConnections(), s3Config_.readThreads());
+
     auto credentialsProvider = getCredentialsProvider();
 
     client_ = std::make_shared<Aws::S3::S3Client>(
@@ -320,6 +531,13 @@ class S3FileSystem::Impl {
         clientConfig,
         Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
         s3Config_.useVirtualAddressing());
+
+    hedgedReader_ =
+        std::make_unique<HedgedReader>(s3Config_.hedgedReadOptions());
+    if (s3Config_.readThreads() > 0) {
+      readExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(
+          s3Config_.readThreads());
+    }
   }
 
   // Make it clear that the S3FileSystem instance owns the S3Client.
@@ -329,9 +547,26 @@ class S3FileSystem::Impl {
     return client_.get();
   }
 
+  folly::Executor* readExecutor() const {
+    return readExecutor_.get();
+  }
+
+  HedgedReader* hedgedReader() const {
+    return hedgedReader_.get();
+  }
+
+  const S3Config& s3Config() const {
+    return s3Config_;
+  }
+
  private:
   const S3Config s3Config_;
   std::shared_ptr<Aws::S3::S3Client> client_;
+  // The members below are declared after 'client_' so that the GETs in
+  // flight finish before the client is destroyed. The reads on
+  // 'readExecutor_' may use 'hedgedReader_'.
+  std::unique_ptr<HedgedReader> hedgedReader_;
+  std::unique_ptr<folly::IOThreadPoolExecutor> readExecutor_;
   static std::atomic<size_t> initCounter_;
 };
 
@@ -341,6 +576,8 @@ folly::once_flag S3FSInstantiationFlag;
 S3FileSystem::S3FileSystem(std::shared_ptr<const Config> config)
     : FileSystem(config) {
   impl_ = std::make_shared<Impl>(config.get());
+  coalescePolicy_ = std::make_shared<CoalescePolicy>(
+      impl_->s3Config().coalescePolicyOptions());
 }
 
 void S3FileSystem::initializeClient() {
@@ -349,7 +586,12 @@ void S3FileSystem::initializeClient() {
 
 std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(std::string_view path) {
   const std::string file = s3Path(path);
-  auto s3file = std::make_unique<S3ReadFile>(file, impl_->s3Client());
+  auto s3file = std::make_unique<S3ReadFile>(
+      file,
+      impl_->s3Client(),
+      impl_->readExecutor(),
+      impl_->s3Config().readOptions(),
+      impl_->hedgedReader());
   s3file->initialize();
   return s3file;
 }
@@ -152,6 +152,48 @@ TEST_F(S3FileSystemTest, fileHandle) {
   readData(fileHandle->file.get());
 }
 
+TEST_F(S3FileSystemTest, preadvAsync) {
+  const char* bucketName = "data4";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  // Small parts and coalescing distance split the reads into several GETs.
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.read-part-size", "100000"},
+       {"hive.s3.max-coalesce-distance", "1000"},
+       {"hive.s3.read-threads", "4"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto readFile = s3fs.openFileForRead(s3File);
+  ASSERT_TRUE(readFile->hasPreadvAsync());
+
+  std::string head(12, 0);
+  std::string near(4, 0);
+  std::string large(kOneMB - 10000, 0);
+  std::string tail(7, 0);
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head.data(), head.size()),
+      folly::Range<char*>(nullptr, 100),
+      folly::Range<char*>(near.data(), near.size()),
+      folly::Range<char*>(nullptr, 5000),
+      folly::Range<char*>(large.data(), large.size()),
+      folly::Range<char*>(
+          nullptr,
+          15 + kOneMB - head.size() - 100 - near.size() - 5000 - large.size() -
+              tail.size()),
+      folly::Range<char*>(tail.data(), tail.size())};
+  ASSERT_EQ(15 + kOneMB, readFile->preadvAsync(0, buffers).get());
+  ASSERT_EQ(head, "aaaaabbbbbcc");
+  ASSERT_EQ(near, "cccc");
+  ASSERT_EQ(large, std::string(large.size(), 'c'));
+  ASSERT_EQ(tail, "ccddddd");
+}
+
 TEST_F(S3FileSystemTest, invalidCredentialsConfig) {
   {
     const std::unordered_map<std::string, std::string> config(
@@ -264,3 +264,48 @@ TEST_F(HivePartitionFunctionTest, date) {
   assertPartitionsWithConstChannel(values, 500);
   assertPartitionsWithConstChannel(values, 997);
 }
+
+TEST_F(HivePartitionFunctionTest, encodings) {
+  const vector_size_t size = 1'000;
+  auto base = vm_.flatVectorNullable<int64_t>(
+      {1, std::nullopt, 123'456'789'012LL, -7, 42});
+  auto indices = AlignedBuffer::allocate<vector_size_t>(size, pool_.get());
+  auto nulls = AlignedBuffer::allocate<bool>(size, pool_.get());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  auto* rawNulls = nulls->asMutable<uint64_t>();
+  for (auto i = 0; i < size; ++i) {
+    rawIndices[i] = (i * 7) % base->size();
+    bits::setNull(rawNulls, i, i % 11 == 0);
+  }
+  auto dictionary = BaseVector::wrapInDictionary(nulls, indices, size, base);
+  auto constant = BaseVector::wrapInConstant(size, 2, base);
+  auto other = vm_.flatVector<int32_t>(size, [](auto row) { return row; });
+
+  // Flat copies of the keys must land in the same partitions.
+  auto assertSamePartitions = [&](const std::vector<VectorPtr>& keys) {
+    std::vector<VectorPtr> flatKeys;
+    std::vector<column_index_t> keyChannels;
+    for (auto i = 0; i < keys.size(); ++i) {
+      auto flat = BaseVector::create(keys[i]->type(), size, pool_.get());
+      flat->copy(keys[i].get(), 0, 0, size);
+      flatKeys.push_back(flat);
+      keyChannels.push_back(i);
+    }
+    std::vector<int> bucketToPartition(997);
+    std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+    connector::hive::HivePartitionFunction partitionFunction(
+        997, bucketToPartition, keyChannels);
+
+    std::vector<uint32_t> expected;
+    partitionFunction.partition(*vm_.rowVector(flatKeys), expected);
+    std::vector<uint32_t> partitions;
+    partitionFunction.partition(*vm_.rowVector(keys), partitions);
+    EXPECT_EQ(expected, partitions);
+  };
+
+  assertSamePartitions({dictionary});
+  assertSamePartitions({constant});
+  assertSamePartitions({dictionary, other});
+  assertSamePartitions({other, constant});
+  assertSamePartitions({constant, dictionary});
+}
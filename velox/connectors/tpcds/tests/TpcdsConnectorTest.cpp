@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/tpcds/TpcdsConnector.h"
+#include <folly/init/Init.h>
+#include "gtest/gtest.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+namespace {
+
+using namespace facebook::velox;
+using namespace facebook::velox::connector::tpcds;
+
+using facebook::velox::exec::test::PlanBuilder;
+using facebook::velox::tpcds::Table;
+
+class TpcdsConnectorTest : public exec::test::OperatorTestBase {
+ public:
+  const std::string kTpcdsConnectorId = "test-tpcds";
+
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    auto tpcdsConnector =
+        connector::getConnectorFactory(
+            connector::tpcds::TpcdsConnectorFactory::kTpcdsConnectorName)
+            ->newConnector(kTpcdsConnectorId, nullptr);
+    connector::registerConnector(tpcdsConnector);
+  }
+
+  void TearDown() override {
+    connector::unregisterConnector(kTpcdsConnectorId);
+    OperatorTestBase::TearDown();
+  }
+
+  exec::Split makeTpcdsSplit(size_t totalParts = 1, size_t partNumber = 0)
+      const {
+    return exec::Split(std::make_shared<TpcdsConnectorSplit>(
+        kTpcdsConnectorId, totalParts, partNumber));
+  }
+
+  RowVectorPtr getResults(
+      const core::PlanNodePtr& planNode,
+      std::vector<exec::Split>&& splits) {
+    return exec::test::AssertQueryBuilder(planNode)
+        .splits(std::move(splits))
+        .copyResults(pool());
+  }
+};
+
+// Simple scan of the first 3 rows of "date_dim".
+TEST_F(TpcdsConnectorTest, simple) {
+  auto plan = PlanBuilder()
+                  .tableScan(
+                      Table::TBL_DATE_DIM,
+                      {"d_date_sk", "d_date", "d_year", "d_day_name"})
+                  .limit(0, 3, false)
+                  .planNode();
+
+  auto output = getResults(plan, {makeTpcdsSplit()});
+  auto expected = makeRowVector({
+      makeFlatVector<int64_t>({2'415'022, 2'415'023, 2'415'024}),
+      makeFlatVector<Date>({Date(-25'566), Date(-25'565), Date(-25'564)}),
+      makeFlatVector<int64_t>({1900, 1900, 1900}),
+      makeFlatVector<StringView>({"Tuesday", "Wednesday", "Thursday"}),
+  });
+  test::assertEqualVectors(expected, output);
+}
+
+TEST_F(TpcdsConnectorTest, unknownColumn) {
+  EXPECT_THROW(
+      {
+        PlanBuilder()
+            .tableScan(Table::TBL_STORE, {"does_not_exist"})
+            .planNode();
+      },
+      VeloxUserError);
+}
+
+// Ensures that splits broken down using different configurations return the
+// same dataset in the end.
+TEST_F(TpcdsConnectorTest, multipleSplits) {
+  auto plan = PlanBuilder()
+                  .tableScan(
+                      Table::TBL_PROMOTION,
+                      {"p_promo_sk", "p_promo_id", "p_channel_email"})
+                  .planNode();
+
+  auto fullResult = getResults(plan, {makeTpcdsSplit()});
+  EXPECT_EQ(300, fullResult->size());
+
+  for (size_t totalParts : {2, 7, 64, 301}) {
+    std::vector<exec::Split> splits;
+    for (size_t i = 0; i < totalParts; ++i) {
+      splits.emplace_back(makeTpcdsSplit(totalParts, i));
+    }
+    auto output = getResults(plan, std::move(splits));
+    test::assertEqualVectors(fullResult, output);
+  }
+}
+
+// Joins the store sales with the stores of the scale factor.
+TEST_F(TpcdsConnectorTest, join) {
+  auto planNodeIdGenerator =
+      std::make_shared<exec::test::PlanNodeIdGenerator>();
+  core::PlanNodeId salesScanId;
+  core::PlanNodeId storeScanId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(Table::TBL_STORE_SALES, {"ss_store_sk"})
+                  .capturePlanNodeId(salesScanId)
+                  .hashJoin(
+                      {"ss_store_sk"},
+                      {"s_store_sk"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .tableScan(Table::TBL_STORE, {"s_store_sk"})
+                          .capturePlanNodeId(storeScanId)
+                          .planNode(),
+                      "",
+                      {"s_store_sk"})
+                  .singleAggregation(
+                      {}, {"count(1)", "min(s_store_sk)", "max(s_store_sk)"})
+                  .planNode();
+
+  std::vector<exec::Split> salesSplits;
+  for (size_t i = 0; i < 8; ++i) {
+    salesSplits.emplace_back(makeTpcdsSplit(8, i));
+  }
+  auto output = exec::test::AssertQueryBuilder(plan)
+                    .splits(salesScanId, std::move(salesSplits))
+                    .split(storeScanId, makeTpcdsSplit())
+                    .copyResults(pool());
+
+  auto expected = makeRowVector({
+      makeFlatVector<int64_t>(std::vector<int64_t>{2'880'404}),
+      makeFlatVector<int64_t>(std::vector<int64_t>{1}),
+      makeFlatVector<int64_t>(std::vector<int64_t>{12}),
+  });
+  test::assertEqualVectors(expected, output);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, false);
+  return RUN_ALL_TESTS();
+}
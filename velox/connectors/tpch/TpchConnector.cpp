@@ -15,7 +15,11 @@
  */
 
 #include "velox/connectors/tpch/TpchConnector.h"
+
+#include <numeric>
+
 #include "velox/tpch/gen/TpchGen.h"
+#include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::connector::tpch {
 
@@ -28,28 +32,74 @@ RowVectorPtr getTpchData(
     size_t maxRows,
     size_t offset,
     size_t scaleFactor,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const std::vector<column_index_t>* columns) {
   switch (table) {
     case Table::TBL_PART:
-      return velox::tpch::genTpchPart(maxRows, offset, scaleFactor, pool);
+      return velox::tpch::genTpchPart(
+          maxRows, offset, scaleFactor, pool, columns);
     case Table::TBL_SUPPLIER:
-      return velox::tpch::genTpchSupplier(maxRows, offset, scaleFactor, pool);
+      return velox::tpch::genTpchSupplier(
+          maxRows, offset, scaleFactor, pool, columns);
     case Table::TBL_PARTSUPP:
-      return velox::tpch::genTpchPartSupp(maxRows, offset, scaleFactor, pool);
+      return velox::tpch::genTpchPartSupp(
+          maxRows, offset, scaleFactor, pool, columns);
     case Table::TBL_CUSTOMER:
-      return velox::tpch::genTpchCustomer(maxRows, offset, scaleFactor, pool);
+      return velox::tpch::genTpchCustomer(
+          maxRows, offset, scaleFactor, pool, columns);
     case Table::TBL_ORDERS:
-      return velox::tpch::genTpchOrders(maxRows, offset, scaleFactor, pool);
+      return velox::tpch::genTpchOrders(
+          maxRows, offset, scaleFactor, pool, columns);
     case Table::TBL_LINEITEM:
-      return velox::tpch::genTpchLineItem(maxRows, offset, scaleFactor, pool);
+      return velox::tpch::genTpchLineItem(
+          maxRows, offset, scaleFactor, pool, columns);
     case Table::TBL_NATION:
-      return velox::tpch::genTpchNation(maxRows, offset, scaleFactor, pool);
+      return velox::tpch::genTpchNation(
+          maxRows, offset, scaleFactor, pool, columns);
     case Table::TBL_REGION:
-      return velox::tpch::genTpchRegion(maxRows, offset, scaleFactor, pool);
+      return velox::tpch::genTpchRegion(
+          maxRows, offset, scaleFactor, pool, columns);
   }
   return nullptr;
 }
 
+// Returns the number of rows the parts of splits of 'table' are made of.
+// Lineitem is generated by orders.
+size_t getSplitRowCount(Table table, size_t scaleFactor) {
+  return getRowCount(
+      table == Table::TBL_LINEITEM ? Table::TBL_ORDERS : table, scaleFactor);
+}
+
+template <typename T>
+FOLLY_ALWAYS_INLINE bool testValue(const common::Filter& filter, T value) {
+  if constexpr (std::is_same_v<T, StringView>) {
+    return filter.testBytes(value.data(), value.size());
+  } else if constexpr (std::is_same_v<T, double>) {
+    return filter.testDouble(value);
+  } else {
+    return filter.testInt64(value);
+  }
+}
+
+// Keeps the first 'numRows' of 'rows' that pass 'filter' on the flat
+// 'vector'. Returns their number.
+template <typename T>
+vector_size_t filterRows(
+    const common::Filter& filter,
+    const BaseVector& vector,
+    vector_size_t numRows,
+    vector_size_t* rows) {
+  const auto* values = vector.asUnchecked<FlatVector<T>>()->rawValues();
+  vector_size_t numPassed = 0;
+  for (auto i = 0; i < numRows; ++i) {
+    const auto row = rows[i];
+    if (testValue(filter, values[row])) {
+      rows[numPassed++] = row;
+    }
+  }
+  return numPassed;
+}
+
 } // namespace
 
 std::string TpchTableHandle::toString() const {
@@ -71,7 +121,7 @@ TpchDataSource::TpchDataSource(
       tpchTableHandle, "TableHandle must be an instance of TpchTableHandle");
   tpchTable_ = tpchTableHandle->getTable();
   scaleFactor_ = tpchTableHandle->getScaleFactor();
-  tpchTableRowCount_ = getRowCount(tpchTable_, scaleFactor_);
+  tpchTableRowCount_ = getSplitRowCount(tpchTable_, scaleFactor_);
 
   auto tpchTableSchema = getTableSchema(tpchTableHandle->getTable());
   VELOX_CHECK_NOT_NULL(tpchTableSchema, "TpchSchema can't be null.");
@@ -101,24 +151,103 @@ TpchDataSource::TpchDataSource(
         handle->name(),
         toTableName(tpchTable_));
     outputColumnMappings_.emplace_back(*idx);
+    generatedColumns_.push_back(*idx);
   }
   outputType_ = outputType;
+
+  for (const auto& [name, filter] : tpchTableHandle->filters()) {
+    auto idx = tpchTableSchema->getChildIdxIfExists(name);
+    VELOX_USER_CHECK(
+        idx != std::nullopt,
+        "Filtered column '{}' not found on TPC-H table '{}'.",
+        name,
+        toTableName(tpchTable_));
+    addFilter(*idx, filter);
+  }
+}
+
+void TpchDataSource::addFilter(
+    column_index_t column,
+    std::shared_ptr<common::Filter> filter) {
+  for (auto& [filteredColumn, existing] : filters_) {
+    if (filteredColumn == column) {
+      existing = existing->mergeWith(filter.get());
+      return;
+    }
+  }
+  filters_.emplace_back(column, std::move(filter));
+  if (std::find(
+          generatedColumns_.begin(), generatedColumns_.end(), column) ==
+      generatedColumns_.end()) {
+    generatedColumns_.push_back(column);
+  }
+}
+
+void TpchDataSource::addDynamicFilter(
+    column_index_t outputChannel,
+    const std::shared_ptr<common::Filter>& filter) {
+  VELOX_CHECK_LT(outputChannel, outputColumnMappings_.size());
+  addFilter(outputColumnMappings_[outputChannel], filter);
+}
+
+vector_size_t TpchDataSource::applyFilters(const RowVector& vector) {
+  const auto size = vector.size();
+  if (!passingRows_ ||
+      passingRows_->capacity() < size * sizeof(vector_size_t)) {
+    passingRows_ = allocateIndices(size, pool_);
+  }
+  auto* rows = passingRows_->asMutable<vector_size_t>();
+  std::iota(rows, rows + size, 0);
+  vector_size_t numPassed = size;
+  for (const auto& [column, filter] : filters_) {
+    const auto& values = *vector.childAt(column);
+    switch (values.typeKind()) {
+      case TypeKind::BIGINT:
+        numPassed = filterRows<int64_t>(*filter, values, numPassed, rows);
+        break;
+      case TypeKind::INTEGER:
+        numPassed = filterRows<int32_t>(*filter, values, numPassed, rows);
+        break;
+      case TypeKind::DOUBLE:
+        numPassed = filterRows<double>(*filter, values, numPassed, rows);
+        break;
+      case TypeKind::VARCHAR:
+        numPassed = filterRows<StringView>(*filter, values, numPassed, rows);
+        break;
+      default:
+        VELOX_UNSUPPORTED(
+            "Filter on TPC-H column of type {}", values.type()->toString());
+    }
+    if (numPassed == 0) {
+      break;
+    }
+  }
+  return numPassed;
 }
 
-RowVectorPtr TpchDataSource::projectOutputColumns(RowVectorPtr inputVector) {
+RowVectorPtr TpchDataSource::projectOutputColumns(
+    const RowVectorPtr& inputVector,
+    vector_size_t numRows) {
   std::vector<VectorPtr> children;
   children.reserve(outputColumnMappings_.size());
 
+  const bool allRows = numRows == inputVector->size();
+  BufferPtr indices;
+  if (!allRows && !outputColumnMappings_.empty()) {
+    // The output vectors keep the indices.
+    indices = std::move(passingRows_);
+  }
   for (const auto channel : outputColumnMappings_) {
-    children.emplace_back(inputVector->childAt(channel));
+    if (allRows) {
+      children.emplace_back(inputVector->childAt(channel));
+    } else {
+      children.emplace_back(BaseVector::wrapInDictionary(
+          nullptr, indices, numRows, inputVector->childAt(channel)));
+    }
   }
 
   return std::make_shared<RowVector>(
-      pool_,
-      outputType_,
-      BufferPtr(),
-      inputVector->size(),
-      std::move(children));
+      pool_, outputType_, BufferPtr(), numRows, std::move(children));
 }
 
 void TpchDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
@@ -143,8 +272,13 @@ std::optional<RowVectorPtr> TpchDataSource::next(
       currentSplit_, "No split to process. Call addSplit() first.");
 
   size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
-  auto outputVector =
-      getTpchData(tpchTable_, maxRows, splitOffset_, scaleFactor_, pool_);
+  auto outputVector = getTpchData(
+      tpchTable_,
+      maxRows,
+      splitOffset_,
+      scaleFactor_,
+      pool_,
+      &generatedColumns_);
 
   // If the split is exhausted.
   if (!outputVector || outputVector->size() == 0) {
@@ -159,7 +293,28 @@ std::optional<RowVectorPtr> TpchDataSource::next(
   completedRows_ += outputVector->size();
   completedBytes_ += outputVector->retainedSize();
 
-  return projectOutputColumns(outputVector);
+  const auto numPassed =
+      filters_.empty() ? outputVector->size() : applyFilters(*outputVector);
+  filteredRows_ += outputVector->size() - numPassed;
+  return projectOutputColumns(outputVector, numPassed);
+}
+
+std::vector<std::shared_ptr<TpchConnectorSplit>> makeTpchSplits(
+    const std::string& connectorId,
+    Table table,
+    size_t scaleFactor,
+    size_t rowsPerSplit) {
+  VELOX_CHECK_GT(rowsPerSplit, 0);
+  const auto rowCount = getSplitRowCount(table, scaleFactor);
+  const auto numSplits =
+      std::max<size_t>(1, (rowCount + rowsPerSplit - 1) / rowsPerSplit);
+  std::vector<std::shared_ptr<TpchConnectorSplit>> splits;
+  splits.reserve(numSplits);
+  for (size_t i = 0; i < numSplits; ++i) {
+    splits.push_back(
+        std::make_shared<TpchConnectorSplit>(connectorId, numSplits, i));
+  }
+  return splits;
 }
 
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<TpchConnectorFactory>())
@@ -18,6 +18,7 @@
 #include "velox/connectors/Connector.h"
 #include "velox/connectors/tpch/TpchConnectorSplit.h"
 #include "velox/tpch/gen/TpchGen.h"
+#include "velox/type/Filter.h"
 
 namespace facebook::velox::connector::tpch {
 
@@ -37,16 +38,24 @@ class TpchColumnHandle : public ColumnHandle {
   const std::string name_;
 };
 
+// Filters on TPC-H columns by column name.
+using TpchColumnFilters =
+    std::unordered_map<std::string, std::shared_ptr<common::Filter>>;
+
 // TPC-H table handle uses the underlying enum to describe the target table.
+// The rows that do not pass 'filters' are dropped right after generation.
+// The filtered columns need not be projected.
 class TpchTableHandle : public ConnectorTableHandle {
  public:
   explicit TpchTableHandle(
       std::string connectorId,
       velox::tpch::Table table,
-      size_t scaleFactor = 1)
+      size_t scaleFactor = 1,
+      TpchColumnFilters filters = {})
       : ConnectorTableHandle(std::move(connectorId)),
         table_(table),
-        scaleFactor_(scaleFactor) {}
+        scaleFactor_(scaleFactor),
+        filters_(std::move(filters)) {}
 
   ~TpchTableHandle() override {}
 
@@ -60,11 +69,23 @@ class TpchTableHandle : public ConnectorTableHandle {
     return scaleFactor_;
   }
 
+  const TpchColumnFilters& filters() const {
+    return filters_;
+  }
+
  private:
   const velox::tpch::Table table_;
   size_t scaleFactor_;
+  const TpchColumnFilters filters_;
 };
 
+// Generates the columns of the table that are projected or filtered and drops
+// the rows that fail the filters of the table handle or the dynamic filters,
+// so that only the surviving rows of the projected columns are returned.
+// DBGEN keeps its random seeds in globals, so that the batches of the
+// concurrent splits of a table are generated one at a time. Copying the
+// values into vectors for the generated columns happens under the same lease,
+// filtering and projection run in parallel.
 class TpchDataSource : public DataSource {
  public:
   TpchDataSource(
@@ -78,10 +99,8 @@ class TpchDataSource : public DataSource {
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
   void addDynamicFilter(
-      column_index_t /*outputChannel*/,
-      const std::shared_ptr<common::Filter>& /*filter*/) override {
-    VELOX_NYI("Dynamic filters not supported by TpchConnector.");
-  }
+      column_index_t outputChannel,
+      const std::shared_ptr<common::Filter>& filter) override;
 
   std::optional<RowVectorPtr> next(uint64_t size, velox::ContinueFuture& future)
       override;
@@ -95,12 +114,26 @@ class TpchDataSource : public DataSource {
   }
 
   std::unordered_map<std::string, RuntimeCounter> runtimeStats() override {
-    // TODO: Which stats do we want to expose here?
-    return {};
+    return {
+        {"generatedRows", RuntimeCounter(completedRows_)},
+        {"filteredRows", RuntimeCounter(filteredRows_)}};
   }
 
  private:
-  RowVectorPtr projectOutputColumns(RowVectorPtr vector);
+  // Adds 'filter' on column 'column' of the table schema, merging it with an
+  // existing filter on the column.
+  void addFilter(column_index_t column, std::shared_ptr<common::Filter> filter);
+
+  // Returns the number of rows of 'vector' that pass all filters and sets
+  // the first elements of 'passingRows_' to them.
+  vector_size_t applyFilters(const RowVector& vector);
+
+  // Returns the output columns of the first 'numRows' rows in
+  // 'passingRows_' of 'vector' or of all rows if 'numRows' is the size of
+  // 'vector'.
+  RowVectorPtr projectOutputColumns(
+      const RowVectorPtr& vector,
+      vector_size_t numRows);
 
   velox::tpch::Table tpchTable_;
   size_t scaleFactor_{1};
@@ -111,6 +144,17 @@ class TpchDataSource : public DataSource {
   // dbgen generated datasets.
   std::vector<column_index_t> outputColumnMappings_;
 
+  // Indices in the table schema of the columns to generate, i.e. the output
+  // and filtered columns.
+  std::vector<column_index_t> generatedColumns_;
+
+  // Filters by index in the table schema.
+  std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>
+      filters_;
+
+  // Rows that pass the filters. Passed to the output vectors as indices.
+  BufferPtr passingRows_;
+
   std::shared_ptr<TpchConnectorSplit> currentSplit_;
 
   // First (splitOffset_) and last (splitEnd_) row number that should be
@@ -120,6 +164,7 @@ class TpchDataSource : public DataSource {
 
   size_t completedRows_{0};
   size_t completedBytes_{0};
+  size_t filteredRows_{0};
 
   memory::MemoryPool* FOLLY_NONNULL pool_;
 };
@@ -146,6 +191,10 @@ class TpchConnector final : public Connector {
         connectorQueryCtx->memoryPool());
   }
 
+  bool canAddDynamicFilter() const override {
+    return true;
+  }
+
   std::shared_ptr<DataSink> createDataSink(
       std::shared_ptr<const RowType> /*inputType*/,
       std::shared_ptr<
@@ -155,6 +204,16 @@ class TpchConnector final : public Connector {
   }
 };
 
+// Returns splits that divide 'table' at 'scaleFactor' into parts of about
+// 'rowsPerSplit' rows each. The splits are independent and run in parallel
+// on the Drivers of a TableScan. The parts of lineitem are ranges of orders,
+// so that its splits have about four times 'rowsPerSplit' rows.
+std::vector<std::shared_ptr<TpchConnectorSplit>> makeTpchSplits(
+    const std::string& connectorId,
+    velox::tpch::Table table,
+    size_t scaleFactor,
+    size_t rowsPerSplit);
+
 class TpchConnectorFactory : public ConnectorFactory {
  public:
   static constexpr const char* FOLLY_NONNULL kTpchConnectorName{"tpch"};
@@ -43,6 +43,12 @@ DEFINE_int32(
     1,
     "Number of splits to generate for a particular TPC-H table scan.");
 
+DEFINE_int32(
+    rows_per_split,
+    0,
+    "If non-zero, splits the table into splits of this many rows (orders "
+    "for lineitem) instead of using --num_splits.");
+
 DEFINE_int32(
     max_drivers,
     1,
@@ -95,7 +101,7 @@ class TpchSpeedTest {
     taskCursor.start();
 
     auto task = taskCursor.task();
-    addSplits(*task, scanId, numSplits);
+    addSplits(*task, table, scaleFactor, scanId, numSplits);
 
     while (taskCursor.moveNext()) {
       processBatch(taskCursor.current());
@@ -110,15 +116,32 @@ class TpchSpeedTest {
     LOG(INFO) << "\tTotal rows generated: " << totalRows_;
     LOG(INFO) << "\tTotal bytes generated: " << totalBytes_;
     LOG(INFO) << "\tTotal time spent: " << elapsed.count() << "s";
+    LOG(INFO) << "\tAverage throughput: "
+              << static_cast<size_t>(totalRows_ / elapsed.count())
+              << " rows/s with " << FLAGS_max_drivers << " driver(s).";
   }
 
  private:
-  void addSplits(exec::Task& task, core::PlanNodeId scanId, size_t numSplits) {
-    for (size_t i = 0; i < numSplits; ++i) {
-      task.addSplit(
-          scanId,
-          exec::Split(std::make_shared<connector::tpch::TpchConnectorSplit>(
-              kTpchConnectorId_, numSplits, i)));
+  void addSplits(
+      exec::Task& task,
+      tpch::Table table,
+      size_t scaleFactor,
+      core::PlanNodeId scanId,
+      size_t numSplits) {
+    if (FLAGS_rows_per_split > 0) {
+      auto splits = connector::tpch::makeTpchSplits(
+          kTpchConnectorId_, table, scaleFactor, FLAGS_rows_per_split);
+      numSplits = splits.size();
+      for (auto& split : splits) {
+        task.addSplit(scanId, exec::Split(std::move(split)));
+      }
+    } else {
+      for (size_t i = 0; i < numSplits; ++i) {
+        task.addSplit(
+            scanId,
+            exec::Split(std::make_shared<connector::tpch::TpchConnectorSplit>(
+                kTpchConnectorId_, numSplits, i)));
+      }
     }
 
     task.noMoreSplits(scanId);
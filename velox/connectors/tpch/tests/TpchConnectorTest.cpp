@@ -211,6 +211,52 @@ TEST_F(TpchConnectorTest, multipleSplits) {
   }
 }
 
+// Filters on projected and non-projected columns.
+TEST_F(TpchConnectorTest, filterPushdown) {
+  auto plan = PlanBuilder()
+                  .tableScan(
+                      Table::TBL_NATION,
+                      {"n_name"},
+                      1,
+                      {"n_regionkey = 1", "n_nationkey < 20"})
+                  .planNode();
+  auto output = getResults(
+      plan, {makeTpchSplit(3, 0), makeTpchSplit(3, 1), makeTpchSplit(3, 2)});
+  auto expected = makeRowVector({makeFlatVector<StringView>({
+      "ARGENTINA",
+      "BRAZIL",
+      "CANADA",
+      "PERU",
+  })});
+  test::assertEqualVectors(expected, output);
+
+  // Filters that no row passes.
+  plan = PlanBuilder()
+             .tableScan(Table::TBL_NATION, {"n_name"}, 1, {"n_regionkey = 7"})
+             .planNode();
+  EXPECT_EQ(0, getResults(plan, {makeTpchSplit()})->size());
+}
+
+// Lineitem splits are ranges of orders, so that the last of many splits
+// still has rows.
+TEST_F(TpchConnectorTest, lineitemSplits) {
+  auto splits =
+      makeTpchSplits(kTpchConnectorId, Table::TBL_LINEITEM, 1, 10'000);
+  const auto numOrders = tpch::getRowCount(Table::TBL_ORDERS, 1);
+  ASSERT_EQ((numOrders + 9'999) / 10'000, splits.size());
+
+  auto plan = PlanBuilder()
+                  .tableScan(Table::TBL_LINEITEM, {"l_orderkey"})
+                  .singleAggregation({"l_orderkey"}, {})
+                  .singleAggregation({}, {"count(1)"})
+                  .planNode();
+  auto output = getResults(plan, {exec::Split(splits.back())});
+  auto expected = makeRowVector({makeFlatVector<int64_t>(
+      std::vector<int64_t>{static_cast<int64_t>(
+          numOrders - 10'000 * (splits.size() - 1))})});
+  test::assertEqualVectors(expected, output);
+}
+
 // Join nation and region.
 TEST_F(TpchConnectorTest, join) {
   auto planNodeIdGenerator =
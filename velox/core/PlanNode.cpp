@@ -64,6 +64,29 @@ AggregationNode::AggregationNode(
     const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
     bool ignoreNullKeys,
     PlanNodePtr source)
+    : AggregationNode(
+          id,
+          step,
+          groupingKeys,
+          preGroupedKeys,
+          aggregateNames,
+          aggregates,
+          aggregateMasks,
+          {},
+          ignoreNullKeys,
+          std::move(source)) {}
+
+AggregationNode::AggregationNode(
+    const PlanNodeId& id,
+    Step step,
+    const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+    const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+    const std::vector<std::string>& aggregateNames,
+    const std::vector<CallTypedExprPtr>& aggregates,
+    const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+    const std::vector<bool>& distinctAggregates,
+    bool ignoreNullKeys,
+    PlanNodePtr source)
     : PlanNode(id),
       step_(step),
       groupingKeys_(groupingKeys),
@@ -71,6 +94,7 @@ AggregationNode::AggregationNode(
       aggregateNames_(aggregateNames),
       aggregates_(aggregates),
       aggregateMasks_(aggregateMasks),
+      distinctAggregates_(distinctAggregates),
       ignoreNullKeys_(ignoreNullKeys),
       sources_{source},
       outputType_(getAggregationOutputType(
@@ -98,6 +122,27 @@ AggregationNode::AggregationNode(
         "Pre-grouped key must be one of the grouping keys: {}.",
         key->name());
   }
+
+  if (!distinctAggregates_.empty()) {
+    VELOX_CHECK_EQ(
+        distinctAggregates_.size(),
+        aggregates_.size(),
+        "Distinct flags must be given for all or none of the aggregates");
+    for (auto i = 0; i < aggregates_.size(); ++i) {
+      if (!distinctAggregates_[i]) {
+        continue;
+      }
+      VELOX_CHECK(
+          step_ == Step::kSingle,
+          "Distinct aggregates are supported only in single aggregation: {}",
+          aggregates_[i]->toString());
+      VELOX_CHECK_EQ(
+          aggregates_[i]->inputs().size(),
+          1,
+          "Distinct aggregates must have a single argument: {}",
+          aggregates_[i]->toString());
+    }
+  }
 }
 
 namespace {
@@ -145,7 +190,11 @@ void AggregationNode::addDetails(std::stringstream& stream) const {
     if (i > 0) {
       stream << ", ";
     }
-    stream << aggregateNames_[i] << " := " << aggregates_[i]->toString();
+    stream << aggregateNames_[i] << " := ";
+    if (isDistinct(i)) {
+      stream << "DISTINCT ";
+    }
+    stream << aggregates_[i]->toString();
   }
 }
 
@@ -248,6 +297,33 @@ const std::vector<PlanNodePtr>& TableScanNode::sources() const {
 
 void TableScanNode::addDetails(std::stringstream& stream) const {
   stream << tableHandle_->toString();
+  if (aggregates_.empty()) {
+    return;
+  }
+  stream << ", aggregates: ";
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    const auto& aggregate = aggregates_[i];
+    if (i > 0) {
+      stream << ", ";
+    }
+    stream << outputType_->nameOf(i) << " := ";
+    switch (aggregate.kind) {
+      case connector::PushdownAggregate::Kind::kCount:
+        stream << "count";
+        break;
+      case connector::PushdownAggregate::Kind::kMin:
+        stream << "min";
+        break;
+      case connector::PushdownAggregate::Kind::kMax:
+        stream << "max";
+        break;
+    }
+    stream << "("
+           << (aggregate.channel.has_value()
+                   ? scanType_->nameOf(aggregate.channel.value())
+                   : "*")
+           << ")";
+  }
 }
 
 const std::vector<PlanNodePtr>& ArrowStreamNode::sources() const {
@@ -399,13 +475,74 @@ CrossJoinNode::CrossJoinNode(
     const PlanNodeId& id,
     PlanNodePtr left,
     PlanNodePtr right,
-    RowTypePtr outputType)
+    RowTypePtr outputType,
+    TypedExprPtr filter)
     : PlanNode(id),
       sources_({std::move(left), std::move(right)}),
-      outputType_(std::move(outputType)) {}
+      outputType_(std::move(outputType)),
+      filter_(std::move(filter)) {
+  if (filter_) {
+    VELOX_CHECK(
+        filter_->type()->isBoolean(),
+        "Cross join filter must be a boolean expression, got {}",
+        filter_->type()->toString());
+  }
+}
 
-void CrossJoinNode::addDetails(std::stringstream& /* stream */) const {
-  // Nothing to add.
+void CrossJoinNode::addDetails(std::stringstream& stream) const {
+  if (filter_) {
+    stream << "filter: " << filter_->toString();
+  }
+}
+
+RangeJoinNode::RangeJoinNode(
+    const PlanNodeId& id,
+    FieldAccessTypedExprPtr probeKey,
+    FieldAccessTypedExprPtr lowerKey,
+    FieldAccessTypedExprPtr upperKey,
+    TypedExprPtr filter,
+    PlanNodePtr left,
+    PlanNodePtr right,
+    RowTypePtr outputType)
+    : CrossJoinNode(
+          id,
+          std::move(left),
+          std::move(right),
+          std::move(outputType),
+          std::move(filter)),
+      probeKey_(std::move(probeKey)),
+      lowerKey_(std::move(lowerKey)),
+      upperKey_(std::move(upperKey)) {
+  const auto& leftType = sources()[0]->outputType();
+  const auto& rightType = sources()[1]->outputType();
+  VELOX_CHECK(
+      leftType->containsChild(probeKey_->name()),
+      "Range join probe key not found in left side output: {}",
+      probeKey_->name());
+  for (const auto& bound : {lowerKey_, upperKey_}) {
+    VELOX_CHECK(
+        rightType->containsChild(bound->name()),
+        "Range join bound not found in right side output: {}",
+        bound->name());
+    VELOX_CHECK(
+        probeKey_->type()->kind() == bound->type()->kind(),
+        "Range join bound {} must have the type of the probe key, {} vs. {}",
+        bound->name(),
+        bound->type()->toString(),
+        probeKey_->type()->toString());
+  }
+  VELOX_CHECK(
+      probeKey_->type()->isPrimitiveType(),
+      "Range join key must be of a primitive type: {}",
+      probeKey_->type()->toString());
+}
+
+void RangeJoinNode::addDetails(std::stringstream& stream) const {
+  stream << lowerKey_->name() << " <= " << probeKey_->name()
+         << " <= " << upperKey_->name();
+  if (filter()) {
+    stream << ", filter: " << filter()->toString();
+  }
 }
 
 AssignUniqueIdNode::AssignUniqueIdNode(
@@ -477,10 +614,6 @@ WindowNode::WindowNode(
       "Number of sorting keys must be equal to the number of sorting orders");
 }
 
-void WindowNode::addDetails(std::stringstream& stream) const {
-  VELOX_NYI();
-}
-
 namespace {
 void addSortingKeys(
     std::stringstream& stream,
@@ -499,8 +632,12 @@ void LocalMergeNode::addDetails(std::stringstream& stream) const {
   addSortingKeys(stream, sortingKeys_, sortingOrders_);
 }
 
-void TableWriteNode::addDetails(std::stringstream& /* stream */) const {
+void TableWriteNode::addDetails(std::stringstream& stream) const {
   // TODO Add connector details.
+  if (!sortingKeys_.empty()) {
+    stream << "SORTED BY ";
+    addSortingKeys(stream, sortingKeys_, sortingOrders_);
+  }
 }
 
 void MergeExchangeNode::addDetails(std::stringstream& stream) const {
@@ -537,6 +674,11 @@ void PartitionedOutputNode::addDetails(std::stringstream& stream) const {
   if (replicateNullsAndAny_) {
     stream << " replicate nulls and any";
   }
+
+  if (skewMode_ != SkewMode::kNone) {
+    stream << (skewMode_ == SkewMode::kSplit ? " split " : " replicate ")
+           << hotKeyHashes_.size() << " hot keys";
+  }
 }
 
 void TopNNode::addDetails(std::stringstream& stream) const {
@@ -565,6 +707,57 @@ void OrderByNode::addDetails(std::stringstream& stream) const {
   addSortingKeys(stream, sortingKeys_, sortingOrders_);
 }
 
+namespace {
+const char* boundTypeName(WindowNode::BoundType type) {
+  switch (type) {
+    case WindowNode::BoundType::kUnboundedPreceding:
+      return "UNBOUNDED PRECEDING";
+    case WindowNode::BoundType::kPreceding:
+      return "PRECEDING";
+    case WindowNode::BoundType::kCurrentRow:
+      return "CURRENT ROW";
+    case WindowNode::BoundType::kFollowing:
+      return "FOLLOWING";
+    case WindowNode::BoundType::kUnboundedFollowing:
+      return "UNBOUNDED FOLLOWING";
+  }
+  VELOX_UNREACHABLE();
+}
+
+void addFrameBound(
+    std::stringstream& stream,
+    WindowNode::BoundType type,
+    const TypedExprPtr& value) {
+  if (value) {
+    stream << value->toString() << " ";
+  }
+  stream << boundTypeName(type);
+}
+} // namespace
+
+void WindowNode::addDetails(std::stringstream& stream) const {
+  stream << "partition by [";
+  addFields(stream, partitionKeys_);
+  stream << "] order by [";
+  addSortingKeys(stream, sortingKeys_, sortingOrders_);
+  stream << "] ";
+
+  auto numInputColumns = sources_[0]->outputType()->size();
+  for (auto i = 0; i < windowFunctions_.size(); ++i) {
+    if (i > 0) {
+      stream << ", ";
+    }
+    const auto& function = windowFunctions_[i];
+    stream << outputType_->nameOf(numInputColumns + i)
+           << " := " << function.functionCall->toString() << " "
+           << (function.frame.type == WindowType::kRange ? "RANGE" : "ROWS")
+           << " between ";
+    addFrameBound(stream, function.frame.startType, function.frame.startValue);
+    stream << " and ";
+    addFrameBound(stream, function.frame.endType, function.frame.endValue);
+  }
+}
+
 void PlanNode::toString(
     std::stringstream& stream,
     bool detailed,
@@ -376,7 +376,36 @@ class TableScanNode : public PlanNode {
       : PlanNode(id),
         outputType_(outputType),
         tableHandle_(tableHandle),
-        assignments_(assignments) {}
+        assignments_(assignments),
+        scanType_(outputType) {}
+
+  // A scan that produces the partial results of 'aggregates' over the
+  // columns in 'scanType' instead of the columns. 'outputType' has a column
+  // per aggregate. The channels of 'aggregates' are indices into 'scanType',
+  // whose names are keys of 'assignments'. Each split produces one row. The
+  // connector must support aggregation pushdown.
+  TableScanNode(
+      const PlanNodeId& id,
+      const RowTypePtr& outputType,
+      const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
+      const std::unordered_map<
+          std::string,
+          std::shared_ptr<connector::ColumnHandle>>& assignments,
+      const RowTypePtr& scanType,
+      std::vector<connector::PushdownAggregate> aggregates)
+      : PlanNode(id),
+        outputType_(outputType),
+        tableHandle_(tableHandle),
+        assignments_(assignments),
+        scanType_(scanType),
+        aggregates_(std::move(aggregates)) {
+    VELOX_CHECK_EQ(outputType_->size(), aggregates_.size());
+    for (const auto& aggregate : aggregates_) {
+      if (aggregate.channel.has_value()) {
+        VELOX_CHECK_LT(aggregate.channel.value(), scanType_->size());
+      }
+    }
+  }
 
   const std::vector<PlanNodePtr>& sources() const override;
 
@@ -384,6 +413,16 @@ class TableScanNode : public PlanNode {
     return outputType_;
   }
 
+  // The columns read from the connector. The output type unless the scan
+  // has aggregates.
+  const RowTypePtr& scanType() const {
+    return scanType_;
+  }
+
+  const std::vector<connector::PushdownAggregate>& aggregates() const {
+    return aggregates_;
+  }
+
   bool requiresSplits() const override {
     return true;
   }
@@ -410,6 +449,8 @@ class TableScanNode : public PlanNode {
   const std::
       unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
           assignments_;
+  const RowTypePtr scanType_;
+  const std::vector<connector::PushdownAggregate> aggregates_;
 };
 
 class TableWriteNode : public PlanNode {
@@ -420,17 +461,31 @@ class TableWriteNode : public PlanNode {
       const std::vector<std::string>& columnNames,
       const std::shared_ptr<InsertTableHandle>& insertTableHandle,
       const RowTypePtr& outputType,
-      const PlanNodePtr& source)
+      const PlanNodePtr& source,
+      const std::vector<FieldAccessTypedExprPtr>& sortingKeys = {},
+      const std::vector<SortOrder>& sortingOrders = {})
       : PlanNode(id),
         sources_{source},
         columns_{columns},
         columnNames_{columnNames},
         insertTableHandle_(insertTableHandle),
-        outputType_(outputType) {
+        outputType_(outputType),
+        sortingKeys_(sortingKeys),
+        sortingOrders_(sortingOrders) {
     VELOX_CHECK_EQ(columns->size(), columnNames.size());
     for (const auto& column : columns->names()) {
       VELOX_CHECK(source->outputType()->containsChild(column));
     }
+    VELOX_CHECK_EQ(
+        sortingKeys.size(),
+        sortingOrders.size(),
+        "Number of sorting keys and sorting orders in TableWrite must be the same");
+    for (const auto& key : sortingKeys) {
+      VELOX_CHECK(
+          columns->containsChild(key->name()),
+          "TableWrite sorting key must be a written column: {}",
+          key->name());
+    }
   }
 
   const std::vector<PlanNodePtr>& sources() const override {
@@ -457,6 +512,16 @@ class TableWriteNode : public PlanNode {
     return insertTableHandle_;
   }
 
+  // Keys to sort the rows on before writing them. The keys are columns of
+  // 'columns'. Empty if the rows are written in input order.
+  const std::vector<FieldAccessTypedExprPtr>& sortingKeys() const {
+    return sortingKeys_;
+  }
+
+  const std::vector<SortOrder>& sortingOrders() const {
+    return sortingOrders_;
+  }
+
   std::string_view name() const override {
     return "TableWrite";
   }
@@ -469,6 +534,8 @@ class TableWriteNode : public PlanNode {
   const std::vector<std::string> columnNames_;
   const std::shared_ptr<InsertTableHandle> insertTableHandle_;
   const RowTypePtr outputType_;
+  const std::vector<FieldAccessTypedExprPtr> sortingKeys_;
+  const std::vector<SortOrder> sortingOrders_;
 };
 
 class AggregationNode : public PlanNode {
@@ -518,6 +585,24 @@ class AggregationNode : public PlanNode {
       bool ignoreNullKeys,
       PlanNodePtr source);
 
+  /**
+   * @param distinctAggregates Empty or one flag per aggregate. True if the
+   * aggregate is applied to the distinct values of its single argument, e.g.
+   * count(DISTINCT x). Distinct aggregates are supported only in single
+   * aggregations.
+   */
+  AggregationNode(
+      const PlanNodeId& id,
+      Step step,
+      const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+      const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+      const std::vector<std::string>& aggregateNames,
+      const std::vector<CallTypedExprPtr>& aggregates,
+      const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+      const std::vector<bool>& distinctAggregates,
+      bool ignoreNullKeys,
+      PlanNodePtr source);
+
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
   }
@@ -550,6 +635,15 @@ class AggregationNode : public PlanNode {
     return aggregateMasks_;
   }
 
+  const std::vector<bool>& distinctAggregates() const {
+    return distinctAggregates_;
+  }
+
+  bool isDistinct(size_t aggregateIndex) const {
+    return aggregateIndex < distinctAggregates_.size() &&
+        distinctAggregates_[aggregateIndex];
+  }
+
   bool ignoreNullKeys() const {
     return ignoreNullKeys_;
   }
@@ -569,6 +663,9 @@ class AggregationNode : public PlanNode {
   // Keeps mask/'no mask' for every aggregation. Mask, if given, is a reference
   // to a boolean projection column, used to mask out rows for the aggregation.
   const std::vector<FieldAccessTypedExprPtr> aggregateMasks_;
+  // Empty or a flag per aggregation. True if the aggregation is over distinct
+  // values.
+  const std::vector<bool> distinctAggregates_;
   const bool ignoreNullKeys_;
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
@@ -864,8 +961,70 @@ class LocalPartitionNode : public PlanNode {
   const RowTypePtr inputTypeFromSource_;
 };
 
+enum class JoinType { kInner, kLeft, kRight, kFull, kLeftSemi, kAnti };
+
+inline const char* joinTypeName(JoinType joinType) {
+  switch (joinType) {
+    case JoinType::kInner:
+      return "INNER";
+    case JoinType::kLeft:
+      return "LEFT";
+    case JoinType::kRight:
+      return "RIGHT";
+    case JoinType::kFull:
+      return "FULL";
+    case JoinType::kLeftSemi:
+      return "LEFT SEMI";
+    case JoinType::kAnti:
+      return "ANTI";
+  }
+  VELOX_UNREACHABLE();
+}
+
+inline bool isInnerJoin(JoinType joinType) {
+  return joinType == JoinType::kInner;
+}
+
+inline bool isLeftJoin(JoinType joinType) {
+  return joinType == JoinType::kLeft;
+}
+
+inline bool isRightJoin(JoinType joinType) {
+  return joinType == JoinType::kRight;
+}
+
+inline bool isFullJoin(JoinType joinType) {
+  return joinType == JoinType::kFull;
+}
+
+inline bool isLeftSemiJoin(JoinType joinType) {
+  return joinType == JoinType::kLeftSemi;
+}
+
+inline bool isAntiJoin(JoinType joinType) {
+  return joinType == JoinType::kAnti;
+}
+
 class PartitionedOutputNode : public PlanNode {
  public:
+  /// Routing of the rows whose keys are in 'hotKeyHashes'. A skewed join
+  /// partitions the probe side with kSplit and the build side with
+  /// kReplicate, so that each destination joins a share of the hot probe
+  /// rows with all the matching build rows. The build side of a right or
+  /// full join cannot be replicated since each destination would produce
+  /// the unmatched build rows. Neither can the build side of an anti join,
+  /// which needs replicateNullsAndAny.
+  enum class SkewMode {
+    // Hot keys are partitioned like the other keys.
+    kNone,
+    // Rows with hot keys are spread round-robin across all destinations.
+    kSplit,
+    // Rows with hot keys are sent to all destinations.
+    kReplicate
+  };
+
+  /// 'skewedJoinType' is the type of the join that consumes the output when
+  /// 'skewMode' is not kNone.
   PartitionedOutputNode(
       const PlanNodeId& id,
       const std::vector<TypedExprPtr>& keys,
@@ -874,7 +1033,10 @@ class PartitionedOutputNode : public PlanNode {
       bool replicateNullsAndAny,
       PartitionFunctionFactory partitionFunctionFactory,
       RowTypePtr outputType,
-      PlanNodePtr source)
+      PlanNodePtr source,
+      SkewMode skewMode = SkewMode::kNone,
+      std::vector<uint64_t> hotKeyHashes = {},
+      JoinType skewedJoinType = JoinType::kInner)
       : PlanNode(id),
         sources_{{std::move(source)}},
         keys_(keys),
@@ -882,7 +1044,9 @@ class PartitionedOutputNode : public PlanNode {
         broadcast_(broadcast),
         replicateNullsAndAny_(replicateNullsAndAny),
         partitionFunctionFactory_(std::move(partitionFunctionFactory)),
-        outputType_(std::move(outputType)) {
+        outputType_(std::move(outputType)),
+        skewMode_(skewMode),
+        hotKeyHashes_(std::move(hotKeyHashes)) {
     VELOX_CHECK(numPartitions > 0, "numPartitions must be greater than zero");
     if (numPartitions == 1) {
       VELOX_CHECK(
@@ -894,6 +1058,21 @@ class PartitionedOutputNode : public PlanNode {
           keys_.empty(),
           "Broadcast partitioning doesn't allow for partitioning keys");
     }
+    if (skewMode_ != SkewMode::kNone) {
+      VELOX_CHECK(
+          numPartitions > 1 && !keys_.empty(),
+          "Hot key routing requires hash partitioning");
+      VELOX_CHECK(
+          !replicateNullsAndAny_,
+          "Hot key routing is not supported with replicateNullsAndAny");
+      VELOX_CHECK(
+          skewMode_ != SkewMode::kReplicate ||
+              !(isRightJoin(skewedJoinType) || isFullJoin(skewedJoinType) ||
+                isAntiJoin(skewedJoinType)),
+          "Hot key replication is not supported for the build side of {} join",
+          joinTypeName(skewedJoinType));
+      std::sort(hotKeyHashes_.begin(), hotKeyHashes_.end());
+    }
   }
 
   static std::shared_ptr<PartitionedOutputNode> broadcast(
@@ -967,6 +1146,15 @@ class PartitionedOutputNode : public PlanNode {
     return partitionFunctionFactory_;
   }
 
+  SkewMode skewMode() const {
+    return skewMode_;
+  }
+
+  /// Sorted hashes of the hot keys, see PartitionedOutput::hashKeys().
+  const std::vector<uint64_t>& hotKeyHashes() const {
+    return hotKeyHashes_;
+  }
+
   std::string_view name() const override {
     return "PartitionedOutput";
   }
@@ -981,52 +1169,10 @@ class PartitionedOutputNode : public PlanNode {
   const bool replicateNullsAndAny_;
   const PartitionFunctionFactory partitionFunctionFactory_;
   const RowTypePtr outputType_;
+  const SkewMode skewMode_;
+  std::vector<uint64_t> hotKeyHashes_;
 };
 
-enum class JoinType { kInner, kLeft, kRight, kFull, kLeftSemi, kAnti };
-
-inline const char* joinTypeName(JoinType joinType) {
-  switch (joinType) {
-    case JoinType::kInner:
-      return "INNER";
-    case JoinType::kLeft:
-      return "LEFT";
-    case JoinType::kRight:
-      return "RIGHT";
-    case JoinType::kFull:
-      return "FULL";
-    case JoinType::kLeftSemi:
-      return "LEFT SEMI";
-    case JoinType::kAnti:
-      return "ANTI";
-  }
-  VELOX_UNREACHABLE();
-}
-
-inline bool isInnerJoin(JoinType joinType) {
-  return joinType == JoinType::kInner;
-}
-
-inline bool isLeftJoin(JoinType joinType) {
-  return joinType == JoinType::kLeft;
-}
-
-inline bool isRightJoin(JoinType joinType) {
-  return joinType == JoinType::kRight;
-}
-
-inline bool isFullJoin(JoinType joinType) {
-  return joinType == JoinType::kFull;
-}
-
-inline bool isLeftSemiJoin(JoinType joinType) {
-  return joinType == JoinType::kLeftSemi;
-}
-
-inline bool isAntiJoin(JoinType joinType) {
-  return joinType == JoinType::kAnti;
-}
-
 /// Abstract class representing inner/outer/semi/anti joins. Used as a base
 /// class for specific join implementations, e.g. hash and merge joins.
 class AbstractJoinNode : public PlanNode {
@@ -1164,14 +1310,15 @@ class MergeJoinNode : public AbstractJoinNode {
   }
 };
 
-// Cross join.
+// Cross join with an optional filter over the columns of both inputs.
 class CrossJoinNode : public PlanNode {
  public:
   CrossJoinNode(
       const PlanNodeId& id,
       PlanNodePtr left,
       PlanNodePtr right,
-      RowTypePtr outputType);
+      RowTypePtr outputType,
+      TypedExprPtr filter = nullptr);
 
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
@@ -1185,11 +1332,63 @@ class CrossJoinNode : public PlanNode {
     return "CrossJoin";
   }
 
+  const TypedExprPtr& filter() const {
+    return filter_;
+  }
+
  private:
   void addDetails(std::stringstream& stream) const override;
 
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
+  // Optional join filter, nullptr if absent. Only the pairs of rows for which
+  // this is true are returned.
+  const TypedExprPtr filter_;
+};
+
+/// Inner join that pairs each left row with the right rows whose range
+/// contains it, i.e. lowerKey <= probeKey <= upperKey, e.g. a band join on
+/// 'a.ts BETWEEN b.start AND b.end'. Rows with a null key or bound never
+/// match. The optional filter applies to the pairs within range. This is a
+/// cross join with a range condition and runs on the same build side, which
+/// sorts the right rows by 'lowerKey'.
+class RangeJoinNode : public CrossJoinNode {
+ public:
+  RangeJoinNode(
+      const PlanNodeId& id,
+      FieldAccessTypedExprPtr probeKey,
+      FieldAccessTypedExprPtr lowerKey,
+      FieldAccessTypedExprPtr upperKey,
+      TypedExprPtr filter,
+      PlanNodePtr left,
+      PlanNodePtr right,
+      RowTypePtr outputType);
+
+  std::string_view name() const override {
+    return "RangeJoin";
+  }
+
+  /// Column of the left side.
+  const FieldAccessTypedExprPtr& probeKey() const {
+    return probeKey_;
+  }
+
+  /// Inclusive lower bound of the range, a column of the right side.
+  const FieldAccessTypedExprPtr& lowerKey() const {
+    return lowerKey_;
+  }
+
+  /// Inclusive upper bound of the range, a column of the right side.
+  const FieldAccessTypedExprPtr& upperKey() const {
+    return upperKey_;
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const FieldAccessTypedExprPtr probeKey_;
+  const FieldAccessTypedExprPtr lowerKey_;
+  const FieldAccessTypedExprPtr upperKey_;
 };
 
 // Represents the 'SortBy' node in the plan.
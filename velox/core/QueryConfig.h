@@ -58,6 +58,27 @@ class QueryConfig {
   static constexpr const char* kExprTrackCpuUsage =
       "expression.track_cpu_usage";
 
+  // Whether the drivers of a query share the VectorFunctions and the folded
+  // constants of compiled expressions, see exec::ExprCompileCache. False by
+  // default.
+  static constexpr const char* kExprCompileCacheEnabled =
+      "expression.compile_cache_enabled";
+
+  // Whether Drivers count the hardware events (cycles, instructions, LLC,
+  // branch and dTLB misses) of the operator calls with perf_event_open(). The
+  // counts are in OperatorStats::perfEventCounts. False by default. Each
+  // operator call adds two read() system calls.
+  static constexpr const char* kPerfEventsEnabled = "perf_events_enabled";
+
+  // Whether Tasks record the Driver run slices, operator calls, blocked time,
+  // IO waits and spills of their Drivers in process::EventTrace, see
+  // Task::toChromeTrace(). False by default.
+  static constexpr const char* kEventTraceEnabled = "event_trace_enabled";
+
+  // Whether Tasks add a JSON profile of their stats and memory to
+  // exec::TaskProfileStore on completion. False by default.
+  static constexpr const char* kTaskProfileEnabled = "task_profile_enabled";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied
@@ -77,14 +98,104 @@ class QueryConfig {
   static constexpr const char* kMaxPartialAggregationMemory =
       "max_partial_aggregation_memory";
 
+  /// Minimum number of input rows a partial aggregation must see before it
+  /// may switch to passing its input through without grouping.
+  static constexpr const char* kAbandonPartialAggregationMinRows =
+      "abandon_partial_aggregation_min_rows";
+
+  /// Partial aggregation switches to passing its input through when the
+  /// number of groups is at least this percentage of the number of input rows.
+  /// A value over 100 disables the switch.
+  static constexpr const char* kAbandonPartialAggregationMinPct =
+      "abandon_partial_aggregation_min_pct";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "driver.max-page-partitioning-buffer-size";
 
+  /// CPU time in milliseconds a Driver may run on an executor thread before
+  /// it yields the thread to other queued Drivers. Checked between operator
+  /// calls. 0 means no limit.
+  static constexpr const char* kDriverCpuTimeSliceMs =
+      "driver.cpu_time_slice_ms";
+
+  /// Scheduling priority of the Drivers of the query on a DriverExecutor,
+  /// from 0 to DriverExecutor::kNumPriorities - 1. Each priority level gets
+  /// twice the share of the threads of the level below it.
+  static constexpr const char* kDriverPriority = "driver.priority";
+
+  /// If true, the Drivers of a partial OrderBy that feeds a LocalMerge on the
+  /// same keys each merge one key range of the sorted runs of all Drivers.
+  /// The range boundaries are sampled from the runs. The LocalMerge then
+  /// concatenates the ranges instead of merging the runs on one thread. Not
+  /// used if spilling is enabled.
+  static constexpr const char* kOrderByRangeMerge = "order_by_range_merge";
+
+  /// If greater than 0, PartitionedOutput reports the partitioning keys
+  /// that appear in more than this fraction of its input rows as hot keys.
+  /// The fraction is estimated from a sample of the rows.
+  static constexpr const char* kPartitionedOutputHotKeyFraction =
+      "partitioned_output_hot_key_fraction";
+
+  /// If true, hash join tables keep the tags of 16 slots and their row
+  /// pointers in one 128 byte bucket instead of in separate arrays.
+  static constexpr const char* kHashJoinInterleavedBuckets =
+      "hash_join_interleaved_buckets";
+
+  /// If true, an inner hash join without a filter and without spilling
+  /// swaps its build and probe sides when the build side has more than
+  /// kHashJoinSwapRatio times the rows of the probe side. The HashProbes
+  /// buffer up to kHashJoinSwapMaxProbeRows rows of probe input each to find
+  /// out. The join is not swapped if any of them sees more. The join is also
+  /// not swapped if an operator on the probe side, e.g. TableScan, accepts
+  /// dynamic filters on the join keys, since these filters need the build
+  /// side to be complete before the probe input is read.
+  static constexpr const char* kHashJoinAdaptiveSwapEnabled =
+      "hash_join_adaptive_swap_enabled";
+
+  static constexpr const char* kHashJoinSwapRatio = "hash_join_swap_ratio";
+
+  static constexpr const char* kHashJoinSwapMaxProbeRows =
+      "hash_join_swap_max_probe_rows";
+
+  /// Comma separated ids of the HashJoin plan nodes with a broadcast build
+  /// side. All the tasks of a stage that run in one process build the same
+  /// table for these. The first task to reach the join builds the table and
+  /// the others of the same query and stage probe it. See SharedHashTables.
+  static constexpr const char* kSharedHashTableJoinIds =
+      "shared_hash_table_join_ids";
+
+  /// Comma separated ids of the HashJoin plan nodes whose build side table
+  /// is kept in HashTableCache for later queries with the same build side
+  /// over the same data. For slowly changing dimension tables joined by many
+  /// queries.
+  static constexpr const char* kHashTableCacheJoinIds =
+      "hash_table_cache_join_ids";
+
+  /// If true, sum, min and max over fixed width types in a group by keep
+  /// their accumulators in arrays indexed by group number instead of in the
+  /// group rows. Does not apply to aggregations that may spill.
+  static constexpr const char* kAggregationColumnarAccumulators =
+      "aggregation_columnar_accumulators";
+
+  /// If true, a GroupId followed by an aggregation on all its outputs runs
+  /// as one operator that aggregates each input batch into every grouping
+  /// set without repeating the batch per grouping set.
+  static constexpr const char* kGroupingSetsFusion = "grouping_sets_fusion";
+
   /// Preffered number of rows to be returned by operators from
   /// Operator::getOutput.
   static constexpr const char* kPreferredOutputBatchSize =
       "preferred_output_batch_size";
 
+  /// Preferred size in bytes of the batches of operators that adapt their
+  /// row count to the width of their rows. Applies only if
+  /// kPreferredOutputBatchSize is not set.
+  static constexpr const char* kPreferredOutputBatchBytes =
+      "preferred_output_batch_bytes";
+
+  /// Max number of rows of the batches sized by kPreferredOutputBatchBytes.
+  static constexpr const char* kMaxOutputBatchRows = "max_output_batch_rows";
+
   static constexpr const char* kHashAdaptivityEnabled =
       "driver.hash_adaptivity_enabled";
 
@@ -93,15 +204,81 @@ class QueryConfig {
 
   static constexpr const char* kCreateEmptyFiles = "driver.create_empty_files";
 
+  /// Number of splits queued for a table scan that a driver opens in the
+  /// background when it takes a split, so that their file footers are
+  /// read and their first IO is issued ahead of use. 0 disables preload.
+  static constexpr const char* kMaxSplitPreloadPerDriver =
+      "max_split_preload_per_driver";
+
+  /// Number of batch requests an asynchronous connector DataSource keeps in
+  /// flight per driver. See connector::AsyncDataSource.
+  static constexpr const char* kMaxPendingConnectorBatches =
+      "max_pending_connector_batches";
+
+  /// If false, an asynchronous connector DataSource may return the batches
+  /// of a split in the order they complete instead of the order they were
+  /// requested. Set this only if the plan above the scan does not depend on
+  /// the order of rows within a split.
+  static constexpr const char* kPreserveConnectorBatchOrder =
+      "preserve_connector_batch_order";
+
+  /// If greater than 0, a table scan split of more than this many bytes is
+  /// divided when a driver takes it. The driver reads the first part and the
+  /// remainder goes back to the front of the queue, where an idle driver of
+  /// the scan can take it. 0 disables the division.
+  static constexpr const char* kTableScanSplitChunkBytes =
+      "table_scan_split_chunk_bytes";
+
   static constexpr const char* kSpillPath = "spiller-spill-path";
 
   static constexpr const char* kTestingSpillPct = "testing.spill-pct";
 
+  /// Codec for compressing spill files, one of "none", "lz4" or "zstd".
+  static constexpr const char* kSpillCompressionCodec =
+      "spill_compression_codec";
+
+  /// Maximum number of spill files merged at a time when reading back a
+  /// spilled aggregation. Each file being merged holds a read buffer. A
+  /// partition with more files is repartitioned on more bits of the hash
+  /// number before it is read.
+  static constexpr const char* kMaxSpillMergeFanIn = "max_spill_merge_fan_in";
+
+  /// Codec for compressing the pages a query exchanges between tasks, one
+  /// of "none", "lz4" or "zstd". Must be the same on the sending and the
+  /// receiving side.
+  static constexpr const char* kExchangeCompressionCodec =
+      "exchange_compression_codec";
+
+  /// If true, the PartitionedOutput of a task with a "local://" id hands
+  /// RowVectors to its consumers instead of serialized pages. The
+  /// consumers of such tasks are in the same process.
+  static constexpr const char* kLocalExchangeVectors = "local_exchange_vectors";
+
+  /// If true, FilterProject computes comparisons of a lazy column of the
+  /// table scan with a constant and floating point arithmetic with a
+  /// constant while the column is read, without materializing the column.
+  static constexpr const char* kProjectionPushdown = "projection_pushdown";
+
+  /// If greater than 0, FilterProject copies the rows that pass the filter
+  /// to dense vectors before evaluating the projections when no more than
+  /// this fraction of the rows of a batch pass. The projections are then
+  /// flat and the output is not wrapped in a dictionary. 0 disables.
+  static constexpr const char* kFilterProjectCompactionSelectivity =
+      "filter_project_compaction_selectivity";
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
   }
 
+  int32_t abandonPartialAggregationMinRows() const {
+    return get<int32_t>(kAbandonPartialAggregationMinRows, 100'000);
+  }
+
+  int32_t abandonPartialAggregationMinPct() const {
+    return get<int32_t>(kAbandonPartialAggregationMinPct, 80);
+  }
+
   // Returns the target size for a Task's buffered output. The
   // producer Drivers are blocked when the buffered size exceeds
   // this. The Drivers are resumed when the buffered size goes below
@@ -116,10 +293,71 @@ class QueryConfig {
     return get<uint64_t>(kMaxLocalExchangeBufferSize, kDefault);
   }
 
+  uint32_t driverCpuTimeSliceMs() const {
+    return get<uint32_t>(kDriverCpuTimeSliceMs, 0);
+  }
+
+  int32_t driverPriority() const {
+    return get<int32_t>(kDriverPriority, 0);
+  }
+
+  bool orderByRangeMerge() const {
+    return get<bool>(kOrderByRangeMerge, false);
+  }
+
+  double partitionedOutputHotKeyFraction() const {
+    return get<double>(kPartitionedOutputHotKeyFraction, 0);
+  }
+
+  bool hashJoinInterleavedBuckets() const {
+    return get<bool>(kHashJoinInterleavedBuckets, false);
+  }
+
+  bool hashJoinAdaptiveSwapEnabled() const {
+    return get<bool>(kHashJoinAdaptiveSwapEnabled, false);
+  }
+
+  double hashJoinSwapRatio() const {
+    return get<double>(kHashJoinSwapRatio, 10);
+  }
+
+  uint64_t hashJoinSwapMaxProbeRows() const {
+    return get<uint64_t>(kHashJoinSwapMaxProbeRows, 100'000);
+  }
+
+  std::string sharedHashTableJoinIds() const {
+    return get<std::string>(kSharedHashTableJoinIds, "");
+  }
+
+  std::string hashTableCacheJoinIds() const {
+    return get<std::string>(kHashTableCacheJoinIds, "");
+  }
+
+  bool aggregationColumnarAccumulators() const {
+    return get<bool>(kAggregationColumnarAccumulators, false);
+  }
+
+  bool groupingSetsFusion() const {
+    return get<bool>(kGroupingSetsFusion, true);
+  }
+
   uint32_t preferredOutputBatchSize() const {
     return get<uint32_t>(kPreferredOutputBatchSize, 1024);
   }
 
+  bool isPreferredOutputBatchSizeSet() const {
+    return get<uint32_t>(kPreferredOutputBatchSize).has_value();
+  }
+
+  uint64_t preferredOutputBatchBytes() const {
+    static constexpr uint64_t kDefault = 10UL << 20;
+    return get<uint64_t>(kPreferredOutputBatchBytes, kDefault);
+  }
+
+  uint32_t maxOutputBatchRows() const {
+    return get<uint32_t>(kMaxOutputBatchRows, 10'000);
+  }
+
   bool hashAdaptivityEnabled() const {
     return get<bool>(kHashAdaptivityEnabled, true);
   }
@@ -177,8 +415,12 @@ class QueryConfig {
   /// Returns a path for writing spill files. If empty, spilling is
   /// disabled. The path should be interpretable by
   /// filesystems::getFileSystem and may refer to any writable
-  /// location. Actual file names are composed by appending '/' and a
-  /// filename composed of Task id and serial numbers. The files are
+  /// location. This may be a comma separated list of such paths, e.g.
+  /// on different disks, each optionally followed by ':' and the number
+  /// of bytes of spill files it may hold. The spill files are then
+  /// spread over the paths by free space and the number of files being
+  /// written to each. Actual file names are composed by appending '/'
+  /// and a filename composed of Task id and serial numbers. The files are
   /// automatically deleted when no longer needed. Files may be left
   /// behind after crashes but are identifiable based on the Task id in
   /// the name.
@@ -192,10 +434,66 @@ class QueryConfig {
     return get<int32_t>(kTestingSpillPct, 0);
   }
 
+  std::string spillCompressionCodec() const {
+    return get<std::string>(kSpillCompressionCodec, "none");
+  }
+
+  int32_t maxSpillMergeFanIn() const {
+    return get<int32_t>(kMaxSpillMergeFanIn, 128);
+  }
+
+  std::string exchangeCompressionCodec() const {
+    return get<std::string>(kExchangeCompressionCodec, "none");
+  }
+
+  bool localExchangeVectors() const {
+    return get<bool>(kLocalExchangeVectors, false);
+  }
+
+  bool projectionPushdown() const {
+    return get<bool>(kProjectionPushdown, true);
+  }
+
+  double filterProjectCompactionSelectivity() const {
+    return get<double>(kFilterProjectCompactionSelectivity, 0.1);
+  }
+
+  int32_t maxSplitPreloadPerDriver() const {
+    return get<int32_t>(kMaxSplitPreloadPerDriver, 2);
+  }
+
+  int32_t maxPendingConnectorBatches() const {
+    return get<int32_t>(kMaxPendingConnectorBatches, 4);
+  }
+
+  bool preserveConnectorBatchOrder() const {
+    return get<bool>(kPreserveConnectorBatchOrder, true);
+  }
+
+  uint64_t tableScanSplitChunkBytes() const {
+    return get<uint64_t>(kTableScanSplitChunkBytes, 0);
+  }
+
   bool exprTrackCpuUsage() const {
     return get<bool>(kExprTrackCpuUsage, false);
   }
 
+  bool exprCompileCacheEnabled() const {
+    return get<bool>(kExprCompileCacheEnabled, false);
+  }
+
+  bool perfEventsEnabled() const {
+    return get<bool>(kPerfEventsEnabled, false);
+  }
+
+  bool eventTraceEnabled() const {
+    return get<bool>(kEventTraceEnabled, false);
+  }
+
+  bool taskProfileEnabled() const {
+    return get<bool>(kTaskProfileEnabled, false);
+  }
+
   template <typename T>
   T get(const std::string& key, const T& defaultValue) const {
     return config_->get<T>(key, defaultValue);
@@ -17,11 +17,17 @@
 
 #include <folly/Executor.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
+#include <mutex>
 #include "velox/common/memory/MappedMemory.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/core/Context.h"
 #include "velox/core/QueryConfig.h"
 #include "velox/vector/DecodedVector.h"
+#include "velox/vector/VectorPool.h"
+
+namespace facebook::velox::exec {
+class ExprCompileCache;
+} // namespace facebook::velox::exec
 
 namespace facebook::velox::core {
 
@@ -132,6 +138,17 @@ class QueryCtx : public Context {
     return spillExecutor_.get();
   }
 
+  // Returns the cache of compiled expressions shared by the drivers of the
+  // query. 'make' creates it on first use.
+  std::shared_ptr<exec::ExprCompileCache> exprCompileCache(
+      const std::function<std::shared_ptr<exec::ExprCompileCache>()>& make) {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!exprCompileCache_) {
+      exprCompileCache_ = make();
+    }
+    return exprCompileCache_;
+  }
+
  private:
   static Config* FOLLY_NONNULL getEmptyConfig() {
     static const std::unique_ptr<Config> kEmptyConfig =
@@ -157,6 +174,10 @@ class QueryCtx : public Context {
   folly::Executor::KeepAlive<> executorKeepalive_;
   QueryConfig config_;
   std::shared_ptr<folly::Executor> spillExecutor_;
+
+  std::mutex mutex_;
+  // Holds vectors allocated from 'pool_', so it is declared after it.
+  std::shared_ptr<exec::ExprCompileCache> exprCompileCache_;
 };
 
 // Represents the state of one thread of query execution.
@@ -165,7 +186,10 @@ class ExecCtx : public Context {
   ExecCtx(
       memory::MemoryPool* FOLLY_NONNULL pool,
       QueryCtx* FOLLY_NULLABLE queryCtx)
-      : Context{ContextScope::QUERY}, pool_(pool), queryCtx_(queryCtx) {}
+      : Context{ContextScope::QUERY},
+        pool_(pool),
+        queryCtx_(queryCtx),
+        vectorPool_(pool) {}
 
   velox::memory::MemoryPool* FOLLY_NONNULL pool() const {
     return pool_;
@@ -220,6 +244,22 @@ class ExecCtx : public Context {
     decodedVectorPool_.push_back(std::move(vector));
   }
 
+  /// Returns a flat vector of 'type' and 'size', reusing one passed to
+  /// 'releaseVector' that is no longer referenced elsewhere if possible.
+  VectorPtr getVector(const TypePtr& type, vector_size_t size) {
+    return vectorPool_.get(type, size);
+  }
+
+  /// Keeps 'vector' for reuse by 'getVector' once the other references to it
+  /// are gone. See VectorPool.
+  bool releaseVector(VectorPtr vector) {
+    return vectorPool_.release(std::move(vector));
+  }
+
+  const VectorPool& vectorPool() const {
+    return vectorPool_;
+  }
+
  private:
   // Pool for all Buffers for this thread
   memory::MemoryPool* FOLLY_NONNULL pool_;
@@ -229,6 +269,9 @@ class ExecCtx : public Context {
   // A pool of preallocated SelectivityVectors for use by expressions
   // and operators.
   std::vector<std::unique_ptr<SelectivityVector>> selectivityVectorPool_;
+  // A pool of flat vectors produced by the operator or expressions owning
+  // 'this' for reuse in later batches.
+  VectorPool vectorPool_;
 };
 
 } // namespace facebook::velox::core
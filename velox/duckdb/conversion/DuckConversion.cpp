@@ -51,8 +51,12 @@ LogicalType fromVeloxType(TypeKind kind) {
       return LogicalType::DOUBLE;
     case TypeKind::VARCHAR:
       return LogicalType::VARCHAR;
+    case TypeKind::VARBINARY:
+      return LogicalType::BLOB;
     case TypeKind::TIMESTAMP:
       return LogicalType::TIMESTAMP;
+    case TypeKind::DATE:
+      return LogicalType::DATE;
     default:
       throw std::runtime_error(
           "unsupported type for velox -> DuckDB conversion: " +
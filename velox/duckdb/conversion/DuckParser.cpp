@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "velox/duckdb/conversion/DuckParser.h"
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
 #include "velox/common/base/Exceptions.h"
 #include "velox/core/PlanNode.h"
 #include "velox/duckdb/conversion/DuckConversion.h"
@@ -37,6 +39,7 @@ using ::duckdb::FunctionExpression;
 using ::duckdb::LogicalTypeId;
 using ::duckdb::LogicalTypeIdToString;
 using ::duckdb::OperatorExpression;
+using ::duckdb::ParameterExpression;
 using ::duckdb::ParsedExpression;
 using ::duckdb::Parser;
 using ::duckdb::ParserOptions;
@@ -147,6 +150,13 @@ std::shared_ptr<const core::IExpr> parseColumnRefExpr(ParsedExpression& expr) {
               colRefExpr.GetTableName(), std::nullopt)});
 }
 
+// Parse a parameter placeholder ($1, ?) into a root column "$1".
+std::shared_ptr<const core::IExpr> parseParameterExpr(ParsedExpression& expr) {
+  const auto& parameterExpr = dynamic_cast<ParameterExpression&>(expr);
+  return std::make_shared<const core::FieldAccessExpr>(
+      fmt::format("${}", parameterExpr.parameter_nr), getAlias(expr));
+}
+
 // Parse a function call (avg(a), func(1, b), etc).
 // Arithmetic operators also follow this path (a + b, a * b, etc).
 std::shared_ptr<const core::IExpr> parseFunctionExpr(ParsedExpression& expr) {
@@ -395,6 +405,9 @@ std::shared_ptr<const core::IExpr> parseExpr(ParsedExpression& expr) {
     case ExpressionClass::CAST:
       return parseCastExpr(expr);
 
+    case ExpressionClass::PARAMETER:
+      return parseParameterExpr(expr);
+
     default:
       throw std::invalid_argument(
           "Unsupported expression type for DuckDB -> velox conversion: " +
@@ -413,9 +426,49 @@ std::vector<std::unique_ptr<::duckdb::ParsedExpression>> parseExpression(
     VELOX_FAIL("Cannot parse expression: {}. {}", exprString, e.what());
   }
 }
+// Returns the number of the parameter placeholder 'expr' or 0 if 'expr' is
+// not one.
+size_t parameterNumber(const core::IExpr& expr) {
+  auto field = dynamic_cast<const core::FieldAccessExpr*>(&expr);
+  if (!field || !field->isRootColumn()) {
+    return 0;
+  }
+  const auto& name = field->getFieldName();
+  if (name.size() < 2 || name[0] != '$') {
+    return 0;
+  }
+  size_t number = 0;
+  for (size_t i = 1; i < name.size(); ++i) {
+    if (!std::isdigit(static_cast<unsigned char>(name[i]))) {
+      return 0;
+    }
+    number = number * 10 + (name[i] - '0');
+  }
+  return number;
+}
+
+// The parsed expressions by text. Dropped all at once when full.
+constexpr size_t kMaxCachedExprs = 10'000;
+
+using ParseExprCache = folly::Synchronized<
+    folly::F14FastMap<std::string, std::shared_ptr<const core::IExpr>>>;
+
+ParseExprCache& parseExprCache() {
+  static ParseExprCache cache;
+  return cache;
+}
 } // namespace
 
 std::shared_ptr<const core::IExpr> parseExpr(const std::string& exprString) {
+  auto cached = parseExprCache().withRLock(
+      [&](const auto& cache) -> std::shared_ptr<const core::IExpr> {
+        auto it = cache.find(exprString);
+        return it == cache.end() ? nullptr : it->second;
+      });
+  if (cached) {
+    return cached;
+  }
+
   auto parsedExpressions = parseExpression(exprString);
   if (parsedExpressions.size() != 1) {
     throw std::invalid_argument(folly::sformat(
@@ -423,7 +476,68 @@ std::shared_ptr<const core::IExpr> parseExpr(const std::string& exprString) {
         parsedExpressions.size()));
   }
 
-  return parseExpr(*parsedExpressions.front());
+  auto expr = parseExpr(*parsedExpressions.front());
+  parseExprCache().withWLock([&](auto& cache) {
+    if (cache.size() >= kMaxCachedExprs) {
+      cache.clear();
+    }
+    cache.emplace(exprString, expr);
+  });
+  return expr;
+}
+
+std::shared_ptr<const core::IExpr> bindParameters(
+    const std::shared_ptr<const core::IExpr>& expr,
+    const std::vector<variant>& parameters) {
+  if (auto number = parameterNumber(*expr)) {
+    VELOX_USER_CHECK_LE(
+        number, parameters.size(), "No value for parameter ${}", number);
+    return std::make_shared<const core::ConstantExpr>(
+        parameters[number - 1], expr->alias());
+  }
+
+  bool changed = false;
+  std::vector<std::shared_ptr<const core::IExpr>> inputs;
+  inputs.reserve(expr->getInputs().size());
+  for (const auto& input : expr->getInputs()) {
+    inputs.push_back(bindParameters(input, parameters));
+    changed |= inputs.back() != input;
+  }
+  if (!changed) {
+    return expr;
+  }
+  // CastExpr::withInputs() keeps the original input.
+  if (auto cast = dynamic_cast<const core::CastExpr*>(expr.get())) {
+    return std::make_shared<const core::CastExpr>(
+        cast->type(), inputs[0], cast->nullOnFailure(), cast->alias());
+  }
+  return expr->withInputs(std::move(inputs));
+}
+
+std::shared_ptr<const core::IExpr> parseExpr(
+    const std::string& exprString,
+    const std::vector<variant>& parameters) {
+  return bindParameters(parseExpr(exprString), parameters);
+}
+
+void clearParseExprCache() {
+  parseExprCache().wlock()->clear();
+}
+
+AggregateExpr parseAggregateExpr(const std::string& exprString) {
+  auto parsedExpressions = parseExpression(exprString);
+  if (parsedExpressions.size() != 1) {
+    throw std::invalid_argument(folly::sformat(
+        "Expecting exactly one input expression, found {}.",
+        parsedExpressions.size()));
+  }
+
+  auto& parsedExpr = *parsedExpressions.front();
+  bool distinct = false;
+  if (parsedExpr.GetExpressionClass() == ExpressionClass::FUNCTION) {
+    distinct = dynamic_cast<FunctionExpression&>(parsedExpr).distinct;
+  }
+  return {parseExpr(parsedExpr), distinct};
 }
 
 namespace {
@@ -17,6 +17,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+
+#include "velox/type/Variant.h"
 
 namespace facebook::velox::core {
 class IExpr;
@@ -32,8 +35,39 @@ namespace facebook::velox::duckdb {
 // are lower-cased, what prevents you to use functions and column names
 // containing upper case letters (e.g: "concatRow" will be parsed as
 // "concatrow").
+//
+// The results are cached by 'exprString', so that harnesses building many
+// plans from the same strings parse each string once. The returned trees are
+// immutable and shared between callers.
+//
+// Parameter placeholders $1, $2, ... or ? are parsed as root columns named
+// "$1", "$2", ... and are replaced with constants by bindParameters().
 std::shared_ptr<const core::IExpr> parseExpr(const std::string& exprString);
 
+// Returns 'expr' with parameter placeholder $i replaced by a constant
+// 'parameters[i - 1]'. Throws if a placeholder has no value.
+std::shared_ptr<const core::IExpr> bindParameters(
+    const std::shared_ptr<const core::IExpr>& expr,
+    const std::vector<variant>& parameters);
+
+// Parses 'exprString' and binds 'parameters' to its placeholders.
+std::shared_ptr<const core::IExpr> parseExpr(
+    const std::string& exprString,
+    const std::vector<variant>& parameters);
+
+// Drops the cached results of parseExpr(). For testing.
+void clearParseExprCache();
+
+// An aggregate function call, e.g. count(DISTINCT a) AS c.
+struct AggregateExpr {
+  std::shared_ptr<const core::IExpr> expr;
+  // True for count(DISTINCT a) and the like.
+  bool distinct{false};
+};
+
+// Parses an aggregate function call, possibly with DISTINCT.
+AggregateExpr parseAggregateExpr(const std::string& exprString);
+
 // Parses an ORDER BY clause using DuckDB's internal postgresql-based parser,
 // converting it to a pair of an IExpr tree and a core::SortOrder. Uses ASC
 // NULLS LAST as the default sort order.
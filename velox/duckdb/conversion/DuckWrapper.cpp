@@ -32,17 +32,21 @@ using ::duckdb::QueryResult;
 
 namespace {
 
+// Keeps the data of a DuckDB vector alive. 'auxiliary' is the string heap of
+// a VARCHAR vector.
 class DuckDBBufferReleaser {
  public:
   explicit DuckDBBufferReleaser(
-      ::duckdb::buffer_ptr<::duckdb::VectorBuffer> buffer)
-      : buffer_(std::move(buffer)) {}
+      ::duckdb::buffer_ptr<::duckdb::VectorBuffer> buffer,
+      ::duckdb::buffer_ptr<::duckdb::VectorBuffer> auxiliary = nullptr)
+      : buffer_(std::move(buffer)), auxiliary_(std::move(auxiliary)) {}
 
   void addRef() const {}
   void release() const {}
 
  private:
   const ::duckdb::buffer_ptr<::duckdb::VectorBuffer> buffer_;
+  const ::duckdb::buffer_ptr<::duckdb::VectorBuffer> auxiliary_;
 };
 
 class DuckDBValidityReleaser {
@@ -57,6 +61,12 @@ class DuckDBValidityReleaser {
   const ::duckdb::ValidityMask validity_;
 };
 
+// DuckDB's string_t and StringView have the same layout: a 4 byte size, then
+// 12 inlined bytes or a 4 byte prefix and a pointer.
+static_assert(sizeof(::duckdb::string_t) == sizeof(StringView));
+static_assert(::duckdb::string_t::INLINE_LENGTH == StringView::kInlineSize);
+static_assert(::duckdb::string_t::PREFIX_LENGTH == StringView::kPrefixSize);
+
 } // namespace
 
 DuckDBWrapper::DuckDBWrapper(core::ExecCtx* context, const char* path)
@@ -163,9 +173,43 @@ VectorPtr convert(
       auto* duckData =
           ::duckdb::FlatVector::GetData<typename OP::DUCK_TYPE>(duckVector);
 
-      // Some DuckDB vectors have different internal layout and cannot be
-      // trivially copied.
-      if (!isZeroCopyEligible(duckVector.GetType())) {
+      if constexpr (std::is_same_v<OP, DuckStringConversion>) {
+        // Copies the string headers in bulk. The StringViews point to the
+        // string heap of 'duckVector', which the result keeps alive. Null and
+        // unused rows get empty strings since their DuckDB headers are not
+        // initialized.
+        auto values = AlignedBuffer::allocate<StringView>(size, pool);
+        auto* rawValues = values->asMutable<StringView>();
+        memcpy(rawValues, duckData, size * sizeof(StringView));
+        BufferPtr nulls;
+        if (!duckValidity.AllValid()) {
+          nulls = AlignedBuffer::allocate<bool>(size, pool);
+          memcpy(
+              nulls->asMutable<uint8_t>(),
+              duckValidity.GetData(),
+              bits::nbytes(size));
+        }
+        for (auto i = 0; i < size; i++) {
+          if (!duckValidity.RowIsValid(i) ||
+              (validity && !bits::isBitSet(validity, i))) {
+            rawValues[i] = StringView();
+          }
+        }
+        auto heap = BufferView<DuckDBBufferReleaser>::create(
+            reinterpret_cast<const uint8_t*>(duckData),
+            size * sizeof(StringView),
+            DuckDBBufferReleaser(
+                duckVector.GetBuffer(), duckVector.GetAuxiliary()));
+        result = std::make_shared<FlatVector<StringView>>(
+            pool,
+            veloxType,
+            std::move(nulls),
+            size,
+            std::move(values),
+            std::vector<BufferPtr>{std::move(heap)});
+      } else if (!isZeroCopyEligible(duckVector.GetType())) {
+        // Some DuckDB vectors have different internal layout and cannot be
+        // trivially copied.
         // TODO Figure out how to perform a zero-copy conversion.
         result = BaseVector::create(veloxType, size, pool);
         auto flatResult = result->as<FlatVector<typename OP::VELOX_TYPE>>();
@@ -329,6 +329,45 @@ TEST(DuckParserTest, orderBy) {
   EXPECT_EQ("\"c1\" DESC NULLS LAST", parse("c1 DESC NULLS LAST"));
 }
 
+TEST(DuckParserTest, cache) {
+  clearParseExprCache();
+  auto expr = parseExpr("c0 + 1");
+  EXPECT_EQ(expr.get(), parseExpr("c0 + 1").get());
+  EXPECT_NE(expr.get(), parseExpr("c0 + 2").get());
+
+  clearParseExprCache();
+  EXPECT_NE(expr.get(), parseExpr("c0 + 1").get());
+  EXPECT_EQ(expr->toString(), parseExpr("c0 + 1")->toString());
+}
+
+TEST(DuckParserTest, parameters) {
+  auto expr = parseExpr("c0 > $1 AND c1 = $2");
+  EXPECT_EQ(
+      "and(gt(\"c0\",\"$1\"),eq(\"c1\",\"$2\"))", expr->toString());
+
+  EXPECT_EQ(
+      "and(gt(\"c0\",10),eq(\"c1\",\"abc\"))",
+      bindParameters(expr, {variant(10), variant("abc")})->toString());
+  EXPECT_EQ(
+      "and(gt(\"c0\",20),eq(\"c1\",null))",
+      parseExpr(
+          "c0 > $1 AND c1 = $2",
+          {variant(20), variant::null(TypeKind::VARCHAR)})
+          ->toString());
+
+  // The cached tree is not modified.
+  EXPECT_EQ(expr.get(), parseExpr("c0 > $1 AND c1 = $2").get());
+  EXPECT_EQ(
+      "and(gt(\"c0\",\"$1\"),eq(\"c1\",\"$2\"))", expr->toString());
+
+  EXPECT_EQ(
+      "cast(plus(\"c0\",5), DOUBLE) AS x",
+      parseExpr("cast(c0 + $1 as double) AS x", {variant(5)})->toString());
+
+  VELOX_ASSERT_THROW(
+      parseExpr("c0 + $2", {variant(1)}), "No value for parameter $2");
+}
+
 TEST(DuckParserTest, invalidExpression) {
   VELOX_ASSERT_THROW(
       parseExpr("func(a b)"),
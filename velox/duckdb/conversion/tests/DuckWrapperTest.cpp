@@ -331,3 +331,27 @@ TEST_F(BaseDuckWrapperTest, dictConversion) {
     ASSERT_TRUE(expected->equalValueAt(actual.get(), i, i));
   }
 }
+
+TEST_F(BaseDuckWrapperTest, stringsOutliveResult) {
+  VectorPtr strings;
+  {
+    auto result = db_->execute(
+        "SELECT * FROM (VALUES ('short'), (NULL), "
+        "('this is a long, non-inlined, example string')) tbl(s)");
+    ASSERT_TRUE(result->success()) << result->errorMessage();
+    ASSERT_TRUE(result->next());
+    strings = result->getVector()->childAt(0);
+  }
+
+  // The strings reference the DuckDB string heap, which the vector keeps
+  // alive.
+  auto flat = strings->asFlatVector<StringView>();
+  ASSERT_NE(flat, nullptr);
+  ASSERT_EQ(1, flat->stringBuffers().size());
+  EXPECT_EQ(3 * sizeof(StringView), flat->stringBuffers()[0]->size());
+  EXPECT_EQ(StringView("short"), flat->valueAt(0));
+  EXPECT_TRUE(flat->isNullAt(1));
+  EXPECT_EQ(
+      StringView("this is a long, non-inlined, example string"),
+      flat->valueAt(2));
+}
@@ -71,6 +71,15 @@ std::unique_ptr<SeekableInputStream> BufferedInput::enqueue(
         static_cast<const char*>(nullptr), 0);
   }
 
+  // A mapped file is read in place. The kernel is asked to read the region
+  // ahead of use.
+  if (auto mapped = input_.mappedRange(
+          region.offset, region.length, LogType::STREAM)) {
+    input_.willNeed(region.offset, region.length);
+    return std::make_unique<SeekableArrayInputStream>(
+        mapped->data(), mapped->size());
+  }
+
   // if the region is already in buffer - such as metadata
   auto ret = readBuffer(region.offset, region.length);
   if (ret) {
@@ -107,9 +116,12 @@ void BufferedInput::loadWithAction(
 bool BufferedInput::tryMerge(Region& first, const Region& second) {
   DWIO_ENSURE_GE(second.offset, first.offset, "regions should be sorted.");
   int64_t gap = second.offset - first.offset - first.length;
+  auto* policy = input_.coalescePolicy();
+  const int64_t maxDistance =
+      policy ? policy->maxDistance() : kMaxMergeDistance;
 
   // compare with 0 since it's comparison in different types
-  if (gap < 0 || gap <= kMaxMergeDistance) {
+  if (gap < 0 || gap <= maxDistance) {
     // ensure try merge will handle duplicate regions (extension==0)
     int64_t extension = gap + second.length;
 
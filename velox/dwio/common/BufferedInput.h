@@ -57,6 +57,11 @@ class BufferedInput {
 
   virtual std::unique_ptr<SeekableInputStream>
   read(uint64_t offset, uint64_t length, LogType logType) const {
+    // A mapped file is read in place.
+    if (auto mapped = input_.mappedRange(offset, length, logType)) {
+      return std::make_unique<SeekableArrayInputStream>(
+          mapped->data(), mapped->size());
+    }
     std::unique_ptr<SeekableInputStream> ret = readBuffer(offset, length);
     if (!ret) {
       VLOG(1) << "Unplanned read. Offset: " << offset << ", Length: " << length;
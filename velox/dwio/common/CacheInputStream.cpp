@@ -16,6 +16,7 @@
 
 #include <folly/executors/QueuedImmediateExecutor.h>
 
+#include "velox/common/process/EventTrace.h"
 #include "velox/common/process/TraceContext.h"
 #include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
@@ -141,13 +142,15 @@ void CacheInputStream::loadSync(Region region) {
     folly::SemiFuture<bool> wait(false);
     cache::RawFileCacheKey key{fileNum_, region.offset};
     pin_.clear();
-    pin_ = cache_->findOrCreate(key, region.length, &wait);
+    pin_ = cache_->findOrCreate(
+        key, region.length, &wait, bufferedInput_->admission());
     if (pin_.empty()) {
       VELOX_CHECK(wait.valid());
       auto& exec = folly::QueuedImmediateExecutor::instance();
       uint64_t usec = 0;
       {
         MicrosecondTimer timer(&usec);
+        process::TraceSpan span("io", {"waitForLoad"});
         std::move(wait).via(&exec).wait();
       }
       ioStats_->queryThreadIoLatency().increment(usec);
@@ -164,14 +167,24 @@ void CacheInputStream::loadSync(Region region) {
       uint64_t usec = 0;
       {
         MicrosecondTimer timer(&usec);
+        process::TraceSpan span("io", {"read"});
+        HedgedReadRecorder recorder(ioStats_);
         input_.read(ranges, region.offset, LogType::FILE);
       }
       ioStats_->read().increment(region.length);
       ioStats_->queryThreadIoLatency().increment(usec);
+      cache_->accessStats().record(
+          groupId_,
+          trackingId_,
+          cache::CacheSource::kStorage,
+          region.length,
+          usec);
       entry->setExclusiveToShared();
     } else {
       if (!entry->getAndClearFirstUseFlag()) {
         ioStats_->ramHit().increment(entry->size());
+        cache_->accessStats().record(
+            groupId_, trackingId_, cache::CacheSource::kRam, entry->size());
       }
       return;
     }
@@ -208,6 +221,7 @@ bool CacheInputStream::loadFromSsd(
   pins.push_back(std::move(pin_));
   try {
     MicrosecondTimer timer(&usec);
+    process::TraceSpan span("io", {"ssdRead"});
     file.load(ssdPins, pins);
   } catch (const std::exception& e) {
     try {
@@ -230,6 +244,8 @@ bool CacheInputStream::loadFromSsd(
   pin_ = std::move(pins[0]);
   ioStats_->ssdRead().increment(entry.size());
   ioStats_->queryThreadIoLatency().increment(usec);
+  cache_->accessStats().record(
+      groupId_, trackingId_, cache::CacheSource::kSsd, entry.size(), usec);
   entry.setExclusiveToShared();
   return true;
 }
@@ -243,6 +259,7 @@ void CacheInputStream::loadPosition() {
       uint64_t usec = 0;
       {
         MicrosecondTimer timer(&usec);
+        process::TraceSpan span("io", {"coalescedLoad"});
         try {
           if (!load->loadOrFuture(&waitFuture)) {
             auto& exec = folly::QueuedImmediateExecutor::instance();
@@ -15,7 +15,10 @@
  */
 
 #include "velox/dwio/common/CachedBufferedInput.h"
+#include <folly/executors/InlineExecutor.h>
+#include <limits>
 #include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
 
 DEFINE_int32(
@@ -207,7 +210,9 @@ void CachedBufferedInput::makeLoads(
     return;
   }
   bool isSsd = !requests[0]->ssdPin.empty();
-  int32_t maxDistance = isSsd ? 20000 : maxCoalesceDistance_;
+  // The policy of the file system applies to storage reads.
+  auto* policy = isSsd ? nullptr : input_.coalescePolicy();
+  int32_t maxDistance = isSsd ? 20000 : storageCoalesceDistance();
   std::sort(
       requests.begin(),
       requests.end(),
@@ -221,12 +226,13 @@ void CachedBufferedInput::makeLoads(
   // Combine adjacent short reads.
 
   int32_t numNewLoads = 0;
+  auto firstNewLoad = allCoalescedLoads_.size();
 
   coalesceIo<CacheRequest*, CacheRequest*>(
       requests,
       maxDistance,
       // Break batches up. Better load more short ones i parallel.
-      40,
+      policy ? policy->maxRangesPerIo() : 40,
       [&](int32_t index) {
         return isSsd ? requests[index]->ssdPin.run().offset()
                      : requests[index]->key.offset;
@@ -245,17 +251,50 @@ void CachedBufferedInput::makeLoads(
           uint64_t /*offset*/,
           const std::vector<CacheRequest*>& ranges) {
         ++numNewLoads;
+        if (!isSsd) {
+          // Starts the kernel readahead of a mapped file.
+          const auto begin = ranges.front()->key.offset;
+          input_.willNeed(
+              begin, ranges.back()->key.offset + ranges.back()->size - begin);
+        }
         readRegion(ranges, prefetch);
-      });
+      },
+      policy ? policy->maxIoBytes() : std::numeric_limits<int64_t>::max());
   if (prefetch && executor_) {
-    for (auto& load : allCoalescedLoads_) {
-      if (load->state() == LoadState::kPlanned) {
-        executor_->add([pendingLoad = load]() {
-          process::TraceContext trace("Read Ahead");
-          pendingLoad->loadOrFuture(nullptr);
-        });
+    // Loads made by earlier calls are already started or queued.
+    startPrefetch(std::vector<std::shared_ptr<cache::CoalescedLoad>>(
+        allCoalescedLoads_.begin() + firstNewLoad, allCoalescedLoads_.end()));
+  }
+}
+
+void CachedBufferedInput::startPrefetch(
+    const std::vector<std::shared_ptr<cache::CoalescedLoad>>& loads) {
+  auto scheduler = cache_->prefetchScheduler();
+  // Bytes to be read before the load being scheduled. The loads are in
+  // file order, which approximates the order of reading.
+  uint64_t bytesAhead = 0;
+  for (auto& load : loads) {
+    if (load->state() != LoadState::kPlanned) {
+      continue;
+    }
+    if (scheduler) {
+      if (!prefetchGroup_) {
+        prefetchGroup_ = scheduler->newGroup();
       }
+      scheduler->schedule(
+          load, scheduler->expectedUseMicros(bytesAhead), prefetchGroup_);
+      bytesAhead += load->size();
+      continue;
     }
+    executor_->add([pendingLoad = load]() {
+      process::TraceContext trace("Read Ahead");
+      // Returns when the IO is submitted if the storage reads
+      // asynchronously. The continuation keeps 'pendingLoad' alive
+      // until the IO completes.
+      pendingLoad->loadAsync()
+          .via(&folly::InlineExecutor::instance())
+          .thenTry([pendingLoad](auto&& /*unused*/) {});
+    });
   }
 }
 
@@ -267,11 +306,13 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
-      std::vector<CacheRequest*> requests)
+      std::vector<CacheRequest*> requests,
+      cache::CacheAdmission admission)
       : CoalescedLoad(makeKeys(requests), makeSizes(requests)),
         cache_(cache),
         ioStats_(std::move(ioStats)),
-        groupId_(groupId) {
+        groupId_(groupId),
+        admission_(admission) {
     for (auto& request : requests) {
       requests_.push_back(std::move(*request));
     }
@@ -311,6 +352,20 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
     }
   }
 
+  // Records the loads of 'pins' in the access stats of 'cache_'.
+  // 'trackingIds' has the TrackingId of each pin.
+  void recordAccess(
+      const std::vector<CachePin>& pins,
+      const std::vector<TrackingId>& trackingIds,
+      cache::CacheSource source,
+      uint64_t usec) {
+    auto& accessStats = cache_.accessStats();
+    for (auto i = 0; i < pins.size(); ++i) {
+      accessStats.record(
+          groupId_, trackingIds[i], source, pins[i].entry()->size(), usec);
+    }
+  }
+
   static std::vector<RawFileCacheKey> makeKeys(
       std::vector<CacheRequest*>& requests) {
     std::vector<RawFileCacheKey> keys;
@@ -334,6 +389,7 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
   std::vector<CacheRequest> requests_;
   std::shared_ptr<IoStatistics> ioStats_;
   const uint64_t groupId_;
+  const cache::CacheAdmission admission_;
 };
 
 // Represents a CoalescedLoad from ReadFile, e.g. disagg disk.
@@ -345,24 +401,36 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
       std::vector<CacheRequest*> requests,
-      int32_t maxCoalesceDistance)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)),
+      int32_t maxCoalesceDistance,
+      cache::CacheAdmission admission)
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            std::move(requests),
+            admission),
         input_(std::move(input)),
         maxCoalesceDistance_(maxCoalesceDistance) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     auto& stream = input_->get();
     std::vector<CachePin> pins;
+    std::vector<TrackingId> trackingIds;
     pins.reserve(keys_.size());
     cache_.makePins(
         keys_,
         [&](int32_t index) { return sizes_[index]; },
-        [&](int32_t /*index*/, CachePin pin) {
+        [&](int32_t index, CachePin pin) {
           pins.push_back(std::move(pin));
-        });
+          trackingIds.push_back(requests_[index].trackingId);
+        },
+        admission_);
     if (pins.empty()) {
       return pins;
     }
+    auto startMicros = getCurrentTimeMicro();
+    HedgedReadRecorder recorder(ioStats_.get());
+    auto* policy = stream.coalescePolicy();
     auto stats = cache::readPins(
         pins,
         maxCoalesceDistance_,
@@ -373,9 +441,22 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             int32_t /*end*/,
             uint64_t offset,
             const std::vector<folly::Range<char*>>& buffers) {
+          const auto ioStartMicros = getCurrentTimeMicro();
           stream.read(buffers, offset, LogType::FILE);
+          if (policy) {
+            uint64_t bytes = 0;
+            for (auto& buffer : buffers) {
+              bytes += buffer.size();
+            }
+            policy->recordIo(bytes, getCurrentTimeMicro() - ioStartMicros);
+          }
         });
     updateStats(stats, isPrefetch, false);
+    recordAccess(
+        pins,
+        trackingIds,
+        cache::CacheSource::kStorage,
+        getCurrentTimeMicro() - startMicros);
     return pins;
   }
 
@@ -390,27 +471,86 @@ class SsdLoad : public DwioCoalescedLoadBase {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
-      std::vector<CacheRequest*> requests)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)) {}
+      std::vector<CacheRequest*> requests,
+      cache::CacheAdmission admission)
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            std::move(requests),
+            admission) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<SsdPin> ssdPins;
     std::vector<CachePin> pins;
+    std::vector<TrackingId> trackingIds;
     cache_.makePins(
         keys_,
         [&](int32_t index) { return sizes_[index]; },
         [&](int32_t index, CachePin pin) {
           pins.push_back(std::move(pin));
           ssdPins.push_back(std::move(requests_[index].ssdPin));
-        });
+          trackingIds.push_back(requests_[index].trackingId);
+        },
+        admission_);
     if (pins.empty()) {
       return pins;
     }
     assert(!ssdPins.empty()); // for lint.
+    auto startMicros = getCurrentTimeMicro();
     auto stats = ssdPins[0].file()->load(ssdPins, pins);
     updateStats(stats, isPrefetch, true);
+    recordAccess(
+        pins,
+        trackingIds,
+        cache::CacheSource::kSsd,
+        getCurrentTimeMicro() - startMicros);
     return pins;
   }
+
+  folly::SemiFuture<std::vector<CachePin>> loadDataAsync(
+      bool isPrefetch) override {
+    auto ssdPins = std::make_shared<std::vector<SsdPin>>();
+    auto pins = std::make_shared<std::vector<CachePin>>();
+    auto trackingIds = std::make_shared<std::vector<TrackingId>>();
+    cache_.makePins(
+        keys_,
+        [&](int32_t index) { return sizes_[index]; },
+        [&](int32_t index, CachePin pin) {
+          pins->push_back(std::move(pin));
+          ssdPins->push_back(std::move(requests_[index].ssdPin));
+          trackingIds->push_back(requests_[index].trackingId);
+        },
+        admission_);
+    if (pins->empty()) {
+      return folly::makeSemiFuture(std::vector<CachePin>());
+    }
+    auto* file = (*ssdPins)[0].file();
+    auto startMicros = getCurrentTimeMicro();
+    if (!file->hasAsyncLoad()) {
+      auto stats = file->load(*ssdPins, *pins);
+      updateStats(stats, isPrefetch, true);
+      recordAccess(
+          *pins,
+          *trackingIds,
+          cache::CacheSource::kSsd,
+          getCurrentTimeMicro() - startMicros);
+      return folly::makeSemiFuture(std::move(*pins));
+    }
+    // 'ssdPins' and 'pins' are captured to stay alive until the reads
+    // complete.
+    return file->loadAsync(*ssdPins, *pins)
+        .deferValue([this, isPrefetch, ssdPins, pins, trackingIds, startMicros](
+                        CoalesceIoStats stats) {
+          updateStats(stats, isPrefetch, true);
+          recordAccess(
+              *pins,
+              *trackingIds,
+              cache::CacheSource::kSsd,
+              getCurrentTimeMicro() - startMicros);
+          return std::move(*pins);
+        });
+  }
 };
 
 } // namespace
@@ -423,7 +563,8 @@ void CachedBufferedInput::readRegion(
   }
   std::shared_ptr<cache::CoalescedLoad> load;
   if (!requests[0]->ssdPin.empty()) {
-    load = std::make_shared<SsdLoad>(*cache_, ioStats_, groupId_, requests);
+    load = std::make_shared<SsdLoad>(
+        *cache_, ioStats_, groupId_, requests, admission_);
   } else {
     load = std::make_shared<DwioCoalescedLoad>(
         *cache_,
@@ -431,7 +572,8 @@ void CachedBufferedInput::readRegion(
         ioStats_,
         groupId_,
         requests,
-        maxCoalesceDistance_);
+        storageCoalesceDistance(),
+        admission_);
   }
   allCoalescedLoads_.push_back(load);
   coalescedLoads_.withWLock([&](auto& loads) {
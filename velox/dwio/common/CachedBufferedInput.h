@@ -19,6 +19,7 @@
 #include <folly/Executor.h>
 
 #include "velox/common/caching/FileGroupStats.h"
+#include "velox/common/caching/PrefetchScheduler.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/caching/SsdCache.h"
 #include "velox/dwio/common/BufferedInput.h"
@@ -84,7 +85,8 @@ class CachedBufferedInput : public BufferedInput {
       std::shared_ptr<IoStatistics> ioStats,
       folly::Executor* FOLLY_NULLABLE executor,
       int32_t loadQuantum,
-      int32_t maxCoalesceDistance)
+      int32_t maxCoalesceDistance,
+      cache::CacheAdmission admission = cache::CacheAdmission())
       : BufferedInput(input, pool),
         cache_(cache),
         fileNum_(fileNum),
@@ -95,9 +97,13 @@ class CachedBufferedInput : public BufferedInput {
         executor_(executor),
         fileSize_(input.getLength()),
         loadQuantum_(loadQuantum),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        admission_(admission) {}
 
   ~CachedBufferedInput() override {
+    if (prefetchGroup_) {
+      cache_->prefetchScheduler()->cancel(prefetchGroup_);
+    }
     for (auto& load : allCoalescedLoads_) {
       load->cancel();
     }
@@ -135,6 +141,10 @@ class CachedBufferedInput : public BufferedInput {
     return cache_;
   }
 
+  const cache::CacheAdmission& admission() const {
+    return admission_;
+  }
+
   // Returns the CoalescedLoad that contains the correlated loads for
   // 'stream' or nullptr if none. Returns nullptr on all but first
   // call for 'stream' since the load is to be triggered by the first
@@ -147,6 +157,11 @@ class CachedBufferedInput : public BufferedInput {
   // is true, starts background loading.
   void makeLoads(std::vector<CacheRequest*> requests, bool prefetch);
 
+  // Starts the prefetch of 'loads' on the prefetch scheduler of 'cache_'
+  // if there is one and otherwise on 'executor_'.
+  void startPrefetch(
+      const std::vector<std::shared_ptr<cache::CoalescedLoad>>& loads);
+
   // Makes a CoalescedLoad for 'requests' to be read together, coalescing
   // IO is appropriate. If 'prefetch' is set, schedules the CoalescedLoad
   // on 'executor_'. Links the CoalescedLoad  to all CacheInputStreams that it
@@ -154,6 +169,13 @@ class CachedBufferedInput : public BufferedInput {
 
   void readRegion(std::vector<CacheRequest*> requests, bool prefetch);
 
+  // Returns the coalescing distance of storage reads, from the policy of the
+  // file system of 'input_' if it has one.
+  int32_t storageCoalesceDistance() const {
+    auto* policy = input_.coalescePolicy();
+    return policy ? policy->maxDistance() : maxCoalesceDistance_;
+  }
+
   cache::AsyncDataCache* FOLLY_NONNULL cache_;
   const uint64_t fileNum_;
   std::shared_ptr<cache::ScanTracker> tracker_;
@@ -174,9 +196,14 @@ class CachedBufferedInput : public BufferedInput {
   // Distinct coalesced loads in 'coalescedLoads_'.
   std::vector<std::shared_ptr<cache::CoalescedLoad>> allCoalescedLoads_;
 
+  // Group of the loads of 'this' queued on the prefetch scheduler of
+  // 'cache_'. 0 if none is queued.
+  cache::PrefetchScheduler::GroupId prefetchGroup_{0};
+
   const uint64_t fileSize_;
   const int32_t loadQuantum_;
   const int32_t maxCoalesceDistance_;
+  const cache::CacheAdmission admission_;
 };
 
 class CachedBufferedInputFactory : public BufferedInputFactory {
@@ -188,7 +215,8 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
       StreamSource streamSource,
       std::shared_ptr<IoStatistics> ioStats,
       folly::Executor* FOLLY_NULLABLE executor,
-      const ReaderOptions& readerOpts)
+      const ReaderOptions& readerOpts,
+      cache::CacheAdmission admission = cache::CacheAdmission())
       : cache_(cache),
         tracker_(std::move(tracker)),
         groupId_(groupId),
@@ -196,7 +224,8 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
         ioStats_(ioStats),
         executor_(executor),
         loadQuantum_(readerOpts.loadQuantum()),
-        maxCoalesceDistance_(readerOpts.maxCoalesceDistance()) {}
+        maxCoalesceDistance_(readerOpts.maxCoalesceDistance()),
+        admission_(admission) {}
 
   std::unique_ptr<BufferedInput> create(
       InputStream& input,
@@ -213,7 +242,8 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
         ioStats_,
         executor_,
         loadQuantum_,
-        maxCoalesceDistance_);
+        maxCoalesceDistance_,
+        admission_);
   }
 
   std::string toString() const {
@@ -236,5 +266,6 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
   folly::Executor* FOLLY_NULLABLE executor_;
   int32_t loadQuantum_;
   int32_t maxCoalesceDistance_;
+  cache::CacheAdmission admission_;
 };
 } // namespace facebook::velox::dwio::common
@@ -35,6 +35,15 @@
 
 namespace facebook::velox::dwio::common {
 
+HedgedReadRecorder::~HedgedReadRecorder() {
+  const auto& after = HedgedReader::threadStats();
+  if (stats_ && after.numHedged != before_.numHedged) {
+    stats_->incHedgedReads(
+        after.numHedged - before_.numHedged,
+        after.numHedgeWins - before_.numHedgeWins);
+  }
+}
+
 folly::SemiFuture<uint64_t> InputStream::readAsync(
     const std::vector<folly::Range<char*>>& buffers,
     uint64_t offset,
@@ -154,7 +163,11 @@ void ReadFileInputStream::read(
     throw std::invalid_argument("Buffer is null");
   }
   logRead(offset, length, purpose);
-  std::string_view data_read = readFile_->pread(offset, length, buf);
+  std::string_view data_read;
+  {
+    HedgedReadRecorder recorder(stats_);
+    data_read = readFile_->pread(offset, length, buf);
+  }
   if (stats_) {
     stats_->incRawBytesRead(length);
   }
@@ -181,7 +194,11 @@ void ReadFileInputStream::read(
     bufferSize += buffer.size();
   }
   logRead(offset, bufferSize, logType);
-  auto size = readFile_->preadv(offset, buffers);
+  uint64_t size;
+  {
+    HedgedReadRecorder recorder(stats_);
+    size = readFile_->preadv(offset, buffers);
+  }
   DWIO_ENSURE_EQ(
       size,
       bufferSize,
@@ -211,6 +228,17 @@ bool ReadFileInputStream::hasReadAsync() const {
   return readFile_->hasPreadvAsync();
 }
 
+std::optional<std::string_view> ReadFileInputStream::mappedRange(
+    uint64_t offset,
+    uint64_t length,
+    LogType logType) {
+  auto range = readFile_->mappedRange(offset, length);
+  if (range.has_value()) {
+    logRead(offset, length, logType);
+  }
+  return range;
+}
+
 bool Region::operator<(const Region& other) const {
   return offset < other.offset ||
       (offset == other.offset && length < other.length);
@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "velox/common/file/File.h"
+#include "velox/common/file/HedgedRead.h"
 #include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/MetricsLog.h"
 
@@ -125,6 +126,24 @@ class InputStream {
     return false;
   }
 
+  /// Returns the 'length' bytes at 'offset' without a copy if the file is
+  /// mapped in memory, std::nullopt otherwise. See ReadFile::mappedRange().
+  virtual std::optional<std::string_view> mappedRange(
+      uint64_t /*offset*/,
+      uint64_t /*length*/,
+      LogType /*logType*/) {
+    return std::nullopt;
+  }
+
+  /// Hints that the range will be read soon. See ReadFile::willNeed().
+  virtual void willNeed(uint64_t /*offset*/, uint64_t /*length*/) {}
+
+  /// Returns the policy for coalescing reads, nullptr for the defaults of
+  /// the reader. See ReadFile::coalescePolicy().
+  virtual CoalescePolicy* FOLLY_NULLABLE coalescePolicy() const {
+    return nullptr;
+  }
+
   /**
    * Take advantage of vectorized read API provided by some file system.
    * Allow file system to do optimzied reading plan to disk to minimize
@@ -183,6 +202,21 @@ class FileInputStream : public InputStream {
 };
 
 // An input stream that reads from an already opened ReadFile.
+// Adds the hedged reads that the calling thread makes during the lifetime of
+// 'this' to 'stats'. Hedging happens inside ReadFile implementations, which
+// do not know the IoStatistics of the query.
+class HedgedReadRecorder {
+ public:
+  explicit HedgedReadRecorder(IoStatistics* FOLLY_NULLABLE stats)
+      : stats_(stats), before_(HedgedReader::threadStats()) {}
+
+  ~HedgedReadRecorder();
+
+ private:
+  IoStatistics* FOLLY_NULLABLE const stats_;
+  const HedgedReader::Stats before_;
+};
+
 class ReadFileInputStream final : public InputStream {
  public:
   // Does not take ownership of |readFile|.
@@ -216,6 +250,17 @@ class ReadFileInputStream final : public InputStream {
 
   bool hasReadAsync() const override;
 
+  std::optional<std::string_view>
+  mappedRange(uint64_t offset, uint64_t length, LogType logType) override;
+
+  void willNeed(uint64_t offset, uint64_t length) override {
+    readFile_->willNeed(offset, length);
+  }
+
+  CoalescePolicy* FOLLY_NULLABLE coalescePolicy() const override {
+    return readFile_->coalescePolicy();
+  }
+
  private:
   velox::ReadFile* FOLLY_NONNULL readFile_;
 };
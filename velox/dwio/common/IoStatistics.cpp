@@ -96,6 +96,8 @@ void IoStatistics::merge(const IoStatistics& other) {
   ramHit_.merge(other.ramHit_);
   ssdRead_.merge(other.ssdRead_);
   queryThreadIoLatency_.merge(other.queryThreadIoLatency_);
+  numHedgedReads_ += other.numHedgedReads_;
+  numHedgeWins_ += other.numHedgeWins_;
   std::lock_guard<std::mutex> l(operationStatsMutex_);
   for (auto& item : other.operationStats_) {
     operationStats_[item.first].merge(item.second);
@@ -97,6 +97,22 @@ class IoStatistics {
     return queryThreadIoLatency_;
   }
 
+  // Number of storage reads that issued a duplicate request because they
+  // were slower than the hedging threshold of their file system.
+  uint64_t numHedgedReads() const {
+    return numHedgedReads_;
+  }
+
+  // Number of hedged reads where the duplicate request finished first.
+  uint64_t numHedgeWins() const {
+    return numHedgeWins_;
+  }
+
+  void incHedgedReads(uint64_t numHedged, uint64_t numWins) {
+    numHedgedReads_ += numHedged;
+    numHedgeWins_ += numWins;
+  }
+
   void incOperationCounters(
       const std::string& operation,
       const uint64_t resourceThrottleCount,
@@ -136,6 +152,9 @@ class IoStatistics {
   // issued IO or for an in-progress read-ahead to finish.
   IoCounter queryThreadIoLatency_;
 
+  std::atomic<uint64_t> numHedgedReads_{0};
+  std::atomic<uint64_t> numHedgeWins_{0};
+
   std::unordered_map<std::string, OperationCounters> operationStats_;
   mutable std::mutex operationStatsMutex_;
 };
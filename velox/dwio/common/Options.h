@@ -93,6 +93,8 @@ class RowReaderOptions {
   bool preloadStripe;
   bool projectSelectedType;
   bool returnFlatVector_ = false;
+  bool returnSequenceVectors_ = false;
+  bool returnBiasVectors_ = false;
   ErrorTolerance errorTolerance_;
   std::shared_ptr<ColumnSelector> selector_;
   std::shared_ptr<velox::common::ScanSpec> scanSpec_ = nullptr;
@@ -104,6 +106,11 @@ class RowReaderOptions {
   // operations.
   std::shared_ptr<folly::Executor> decodingExecutor_;
   std::shared_ptr<folly::Executor> ioExecutor_;
+  // Number of stripes to decode ahead on 'decodingExecutor_'. 0 decodes
+  // on the calling thread.
+  int32_t decodeStripesAhead_{0};
+  // Number of rows the caller needs from the start of the range.
+  uint64_t rowLimit_{std::numeric_limits<uint64_t>::max()};
 
  public:
   RowReaderOptions(const RowReaderOptions& other) {
@@ -115,7 +122,13 @@ class RowReaderOptions {
     selector_ = other.selector_;
     scanSpec_ = other.scanSpec_;
     returnFlatVector_ = other.returnFlatVector_;
+    returnSequenceVectors_ = other.returnSequenceVectors_;
+    returnBiasVectors_ = other.returnBiasVectors_;
     flatmapNodeIdAsStruct_ = other.flatmapNodeIdAsStruct_;
+    decodingExecutor_ = other.decodingExecutor_;
+    ioExecutor_ = other.ioExecutor_;
+    decodeStripesAhead_ = other.decodeStripesAhead_;
+    rowLimit_ = other.rowLimit_;
   }
 
   RowReaderOptions() noexcept
@@ -206,6 +219,28 @@ class RowReaderOptions {
     returnFlatVector_ = value;
   }
 
+  // Run length encoded integer columns may be returned as SequenceVectors
+  bool getReturnSequenceVectors() const {
+    return returnSequenceVectors_;
+  }
+
+  // Allow integer columns with long runs to be returned as SequenceVectors,
+  // so that expressions over them are evaluated once per run
+  void setReturnSequenceVectors(bool value) {
+    returnSequenceVectors_ = value;
+  }
+
+  // Integer columns of narrow range may be returned as BiasVectors
+  bool getReturnBiasVectors() const {
+    return returnBiasVectors_;
+  }
+
+  // Allow the selective readers to return integer columns as BiasVectors of
+  // 8, 16 or 32 bit values if the range of a batch allows
+  void setReturnBiasVectors(bool value) {
+    returnBiasVectors_ = value;
+  }
+
   /**
    * Request that the selected type be projected.
    */
@@ -274,6 +309,32 @@ class RowReaderOptions {
   const std::shared_ptr<folly::Executor>& getIOExecutor() const {
     return ioExecutor_;
   }
+
+  // Decodes up to 'numStripes' stripes after the one being returned on the
+  // decoding executor. Each of these stripes is read to completion by a
+  // separate reader with a copy of the ScanSpec, so the decoded batches of
+  // at most 'numStripes' stripes are held in memory. Filters added to the
+  // ScanSpec after a stripe is started do not apply to that stripe. The
+  // batches are read with the size of the first next().
+  void setDecodeStripesAhead(int32_t numStripes) {
+    decodeStripesAhead_ = numStripes;
+  }
+
+  int32_t getDecodeStripesAhead() const {
+    return decodeStripesAhead_;
+  }
+
+  // Tells the reader that no more than 'numRows' rows from the start of the
+  // range will be read, e.g. below a LIMIT. A reader without filters then
+  // does not load, prefetch or decode ahead the stripes past the one that
+  // has the last of these rows. Rows past the limit may still be returned.
+  void setRowLimit(uint64_t numRows) {
+    rowLimit_ = numRows;
+  }
+
+  uint64_t getRowLimit() const {
+    return rowLimit_;
+  }
 };
 
 /**
@@ -326,6 +387,7 @@ class ReaderOptions {
   uint64_t fileNum;
   std::shared_ptr<encryption::DecrypterFactory> decrypterFactory_;
   std::shared_ptr<BufferedInputFactory> bufferedInputFactory_;
+  std::string fileTailCacheKey_;
 
  public:
   static constexpr int32_t kDefaultLoadQuantum = 8 << 20; // 8MB
@@ -358,6 +420,7 @@ class ReaderOptions {
     fileNum = other.fileNum;
     decrypterFactory_ = other.decrypterFactory_;
     bufferedInputFactory_ = other.bufferedInputFactory_;
+    fileTailCacheKey_ = other.fileTailCacheKey_;
     return *this;
   }
 
@@ -387,6 +450,15 @@ class ReaderOptions {
     return *this;
   }
 
+  /**
+   * Set the key of the file in the process wide cache of file footers, e.g.
+   * its path, modification time and size. Empty does not use the cache.
+   */
+  ReaderOptions& setFileTailCacheKey(std::string key) {
+    fileTailCacheKey_ = std::move(key);
+    return *this;
+  }
+
   /**
    * Set the schema of the file (a Type tree).
    * For "dwrf" format, a default schema is derived from the file.
@@ -481,6 +553,10 @@ class ReaderOptions {
     return fileNum;
   }
 
+  const std::string& getFileTailCacheKey() const {
+    return fileTailCacheKey_;
+  }
+
   /**
    * Get the file format.
    */
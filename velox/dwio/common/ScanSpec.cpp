@@ -33,7 +33,9 @@ ScanSpec* ScanSpec::getOrCreateChild(const Subfield& subfield) {
       }
     }
     if (!found) {
-      container->children_.push_back(std::make_unique<ScanSpec>(*element));
+      auto child = std::make_unique<ScanSpec>(*element);
+      child->enableFilterReorder_ = container->enableFilterReorder_;
+      container->children_.push_back(std::move(child));
       container = container->children_.back().get();
     }
   }
@@ -291,6 +293,37 @@ bool testFilter(
   return true;
 }
 
+std::unique_ptr<ScanSpec> ScanSpec::clone() const {
+  auto copy = std::make_unique<ScanSpec>(fieldName_);
+  copy->subscript_ = subscript_;
+  copy->channel_ = channel_;
+  copy->constantValue_ = constantValue_;
+  copy->projectOut_ = projectOut_;
+  copy->extractValues_ = extractValues_;
+  copy->makeFlat_ = makeFlat_;
+  copy->filter_ = filter_ ? filter_->clone() : nullptr;
+  copy->selectivity_ = selectivity_;
+  copy->enableFilterReorder_ = enableFilterReorder_;
+  copy->valueHook_ = valueHook_;
+  copy->children_.reserve(children_.size());
+  for (auto& child : children_) {
+    copy->children_.push_back(child->clone());
+  }
+  return copy;
+}
+
+bool ScanSpec::hasValueHook() const {
+  if (valueHook_) {
+    return true;
+  }
+  for (auto& child : children_) {
+    if (child->hasValueHook()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 ScanSpec& ScanSpec::getChildByChannel(column_index_t channel) {
   for (auto& child : children_) {
     if (child->channel_ == channel) {
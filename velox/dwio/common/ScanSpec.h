@@ -41,12 +41,27 @@ class ScanSpec {
   static constexpr column_index_t kNoChannel = ~0;
 
   explicit ScanSpec(const Subfield::PathElement& element) {
-    if (element.kind() == kNestedField) {
-      auto field = reinterpret_cast<const Subfield::NestedField*>(&element);
-      fieldName_ = field->name();
-
-    } else {
-      VELOX_CHECK(false, "Only nested fields are supported");
+    switch (element.kind()) {
+      case kNestedField:
+        fieldName_ =
+            reinterpret_cast<const Subfield::NestedField*>(&element)->name();
+        break;
+      // Map subscripts describe the value of one key of a flat map. The
+      // key is also kept as 'fieldName_' so that integer and string keys
+      // are looked up the same way.
+      case kLongSubscript:
+        subscript_ =
+            reinterpret_cast<const Subfield::LongSubscript*>(&element)->index();
+        fieldName_ = std::to_string(subscript_);
+        break;
+      case kStringSubscript:
+        fieldName_ =
+            reinterpret_cast<const Subfield::StringSubscript*>(&element)
+                ->index();
+        break;
+      default:
+        VELOX_CHECK(
+            false, "Only nested fields and map subscripts are supported");
     }
   }
 
@@ -244,13 +259,29 @@ class ScanSpec {
     reorder();
   }
 
+  // Enables or disables reordering filters of 'this' and its descendants by
+  // their observed cost and selectivity. If disabled, filters are ordered by
+  // kind. Children added later by getOrCreateChild() inherit the setting.
   void setEnableFilterReorder(bool enableFilterReorder) {
     enableFilterReorder_ = enableFilterReorder;
+    for (auto& child : children_) {
+      child->setEnableFilterReorder(enableFilterReorder);
+    }
   }
 
   // Returns the child which produces values for 'channel'. Throws if not found.
   ScanSpec& getChildByChannel(column_index_t channel);
 
+  // Returns a deep copy of 'this' with copies of the filters and
+  // children. The copy has no read history but starts with the filter
+  // cost and selectivity observed so far, so that it begins with the
+  // current filter order. Readers of different parts of a file running on
+  // different threads each need their own ScanSpec.
+  std::unique_ptr<ScanSpec> clone() const;
+
+  // True if this or a descendant has a ValueHook.
+  bool hasValueHook() const;
+
   std::string toString() const;
 
  private:
@@ -57,7 +57,9 @@ class SeekableInputStream : public google::protobuf::io::ZeroCopyInputStream {
   // ORC/DWRF stream address.
   virtual size_t positionSize() = 0;
 
-  void readFully(char* buffer, size_t bufferSize);
+  // Reads 'bufferSize' bytes into 'buffer'. Streams that decode their
+  // data may override this to decode directly into 'buffer'.
+  virtual void readFully(char* buffer, size_t bufferSize);
 };
 
 /**
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox::dwio::common {
+
+/**
+ * Writer interface of a file format. Writers are created by the
+ * WriterFactory registered for the format.
+ */
+class Writer {
+ public:
+  virtual ~Writer() = default;
+
+  /**
+   * Appends the rows of 'data' to the file. 'data' must be a RowVector of
+   * the schema the writer was created with.
+   */
+  virtual void write(const VectorPtr& data) = 0;
+
+  /**
+   * Writes out the buffered rows.
+   */
+  virtual void flush() = 0;
+
+  /**
+   * Flushes and finishes the file. No writes are allowed after close.
+   */
+  virtual void close() = 0;
+};
+
+} // namespace facebook::velox::dwio::common
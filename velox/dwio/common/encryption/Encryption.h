@@ -89,6 +89,20 @@ class Decrypter {
   virtual std::unique_ptr<folly::IOBuf> decrypt(
       folly::StringPiece input) const = 0;
 
+  // True if the plaintext has the length of the ciphertext, as with a stream
+  // cipher like AES-CTR. decryptInto() is then supported.
+  virtual bool isLengthPreserving() const {
+    return false;
+  }
+
+  // Decrypts 'input' into the input.size() bytes at 'output'. 'output' may be
+  // input.data() for decrypting in place. This saves allocating and copying
+  // the result of decrypt() for each block.
+  virtual void decryptInto(folly::StringPiece /* input */, char* /* output */)
+      const {
+    DWIO_RAISE("Decrypter does not support decryptInto");
+  }
+
   virtual std::unique_ptr<Decrypter> clone() const = 0;
 };
 
@@ -101,6 +101,90 @@ class TestDecrypter : public TestEncryption, public Decrypter {
   }
 };
 
+// Length preserving encryption that XORs the input with a keystream made of
+// the key and the position, like a stream cipher.
+class TestStreamEncryption {
+ public:
+  void setKey(const std::string& key) {
+    key_ = key;
+  }
+
+  const std::string& getKey() const {
+    return key_;
+  }
+
+  void transform(folly::StringPiece input, char* output) const {
+    ++count_;
+    for (size_t i = 0; i < input.size(); ++i) {
+      const char key = key_.empty() ? 0 : key_[i % key_.size()];
+      output[i] = input[i] ^ key ^ static_cast<char>(i * 37);
+    }
+  }
+
+  std::unique_ptr<folly::IOBuf> transform(folly::StringPiece input) const {
+    auto result = folly::IOBuf::create(input.size());
+    transform(input, reinterpret_cast<char*>(result->writableData()));
+    result->append(input.size());
+    return result;
+  }
+
+  size_t getCount() const {
+    return count_;
+  }
+
+ private:
+  std::string key_;
+  mutable size_t count_{0};
+};
+
+class TestStreamEncrypter : public TestStreamEncryption, public Encrypter {
+ public:
+  const std::string& getKey() const override {
+    return TestStreamEncryption::getKey();
+  }
+
+  std::unique_ptr<folly::IOBuf> encrypt(
+      folly::StringPiece input) const override {
+    return transform(input);
+  }
+
+  std::unique_ptr<Encrypter> clone() const override {
+    auto encrypter = std::make_unique<TestStreamEncrypter>();
+    encrypter->setKey(getKey());
+    return encrypter;
+  }
+};
+
+class TestStreamDecrypter : public TestStreamEncryption, public Decrypter {
+ public:
+  void setKey(const std::string& key) override {
+    TestStreamEncryption::setKey(key);
+  }
+
+  bool isKeyLoaded() const override {
+    return !getKey().empty();
+  }
+
+  std::unique_ptr<folly::IOBuf> decrypt(
+      folly::StringPiece input) const override {
+    return transform(input);
+  }
+
+  bool isLengthPreserving() const override {
+    return true;
+  }
+
+  void decryptInto(folly::StringPiece input, char* output) const override {
+    transform(input, output);
+  }
+
+  std::unique_ptr<Decrypter> clone() const override {
+    auto decrypter = std::make_unique<TestStreamDecrypter>();
+    decrypter->setKey(getKey());
+    return decrypter;
+  }
+};
+
 class TestEncryptionProperties : public EncryptionProperties {
  public:
   TestEncryptionProperties(const std::string& key) : key_{key} {}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/ScanSpec.h"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace facebook::velox;
+using namespace facebook::velox::common;
+
+namespace {
+
+// Makes a spec with filters on 'a' and 'b' and on the same fields of the
+// struct 's'. Without history the integer filters go first.
+std::unique_ptr<ScanSpec> makeSpec() {
+  auto spec = std::make_unique<ScanSpec>("root");
+  for (auto prefix : {"", "s."}) {
+    spec->getOrCreateChild(Subfield(fmt::format("{}a", prefix)))
+        ->setFilter(std::make_unique<BigintRange>(0, 10, false));
+    spec->getOrCreateChild(Subfield(fmt::format("{}b", prefix)))
+        ->setFilter(std::make_unique<BytesRange>(
+            "a", false, false, "b", false, false, false));
+  }
+  return spec;
+}
+
+// Records a filter on 'numIn' values passing 'numOut'. Every call takes
+// about the same time, so the filter that drops the most values is the
+// cheapest per dropped value.
+void addStats(ScanSpec& spec, uint64_t numIn, uint64_t numOut) {
+  {
+    SelectivityTimer timer(spec.selectivity(), numIn);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  spec.selectivity().addOutput(numOut);
+}
+
+std::vector<std::string> childNames(const ScanSpec& spec) {
+  std::vector<std::string> names;
+  for (auto& child : spec.children()) {
+    names.push_back(child->fieldName());
+  }
+  return names;
+}
+
+using Names = std::vector<std::string>;
+
+} // namespace
+
+TEST(ScanSpecTest, reorderBySelectivity) {
+  auto spec = makeSpec();
+  auto nested = spec->childByName("s");
+  spec->newRead();
+  nested->newRead();
+  EXPECT_EQ(childNames(*spec), (Names{"a", "b", "s"}));
+  EXPECT_EQ(childNames(*nested), (Names{"a", "b"}));
+
+  // 'b' drops almost all values in the time 'a' takes to drop one.
+  addStats(*spec->childByName("a"), 1'000, 999);
+  addStats(*spec->childByName("b"), 1'000, 1);
+  addStats(*nested->childByName("a"), 1'000, 999);
+  addStats(*nested->childByName("b"), 1'000, 1);
+  spec->newRead();
+  nested->newRead();
+  EXPECT_EQ(childNames(*spec), (Names{"b", "a", "s"}));
+  EXPECT_EQ(childNames(*nested), (Names{"b", "a"}));
+}
+
+TEST(ScanSpecTest, disableReorder) {
+  auto spec = makeSpec();
+  spec->setEnableFilterReorder(false);
+  auto nested = spec->childByName("s");
+  // A child added after disabling does not reorder either.
+  nested->getOrCreateChild(Subfield("c"))
+      ->setFilter(std::make_unique<DoubleRange>(
+          0, false, false, 1, false, false, false));
+  spec->newRead();
+  nested->newRead();
+
+  addStats(*spec->childByName("a"), 1'000, 999);
+  addStats(*spec->childByName("b"), 1'000, 1);
+  addStats(*nested->childByName("a"), 1'000, 999);
+  addStats(*nested->childByName("b"), 1'000, 1);
+  addStats(*nested->childByName("c"), 1'000, 0);
+  for (auto i = 0; i < 2; ++i) {
+    spec->newRead();
+    nested->newRead();
+    EXPECT_EQ(childNames(*spec), (Names{"a", "b", "s"}));
+    EXPECT_EQ(childNames(*nested), (Names{"a", "c", "b"}));
+  }
+
+  auto copy = spec->clone();
+  copy->newRead();
+  copy->childByName("s")->newRead();
+  EXPECT_EQ(childNames(*copy), (Names{"a", "b", "s"}));
+  EXPECT_EQ(childNames(*copy->childByName("s")), (Names{"a", "c", "b"}));
+}
+
+TEST(ScanSpecTest, cloneKeepsSelectivity) {
+  auto spec = makeSpec();
+  auto nested = spec->childByName("s");
+  spec->newRead();
+  nested->newRead();
+  addStats(*spec->childByName("a"), 1'000, 999);
+  addStats(*spec->childByName("b"), 1'000, 1);
+  addStats(*nested->childByName("a"), 1'000, 999);
+  addStats(*nested->childByName("b"), 1'000, 1);
+
+  // The copy has no read history, so its first read orders the filters by
+  // the statistics it copied.
+  auto copy = spec->clone();
+  auto copyNested = copy->childByName("s");
+  EXPECT_EQ(copy->childByName("b")->selectivity().numIn(), 1'000);
+  EXPECT_EQ(copy->childByName("b")->selectivity().numOut(), 1);
+  EXPECT_EQ(copyNested->childByName("a")->selectivity().numIn(), 1'000);
+  EXPECT_EQ(copyNested->childByName("a")->selectivity().numOut(), 999);
+  copy->newRead();
+  copyNested->newRead();
+  EXPECT_EQ(childNames(*copy), (Names{"b", "a", "s"}));
+  EXPECT_EQ(childNames(*copyNested), (Names{"b", "a"}));
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/dwio/dwrf/common/AsyncDecompressor.h"
+
+#include <folly/Synchronized.h>
+
+namespace facebook::velox::dwrf {
+
+namespace {
+folly::Synchronized<std::shared_ptr<AsyncDecompressor>>& engineHolder() {
+  static folly::Synchronized<std::shared_ptr<AsyncDecompressor>> engine;
+  return engine;
+}
+} // namespace
+
+void registerAsyncDecompressor(std::shared_ptr<AsyncDecompressor> engine) {
+  *engineHolder().wlock() = std::move(engine);
+}
+
+std::shared_ptr<AsyncDecompressor> asyncDecompressor() {
+  return *engineHolder().rlock();
+}
+
+} // namespace facebook::velox::dwrf
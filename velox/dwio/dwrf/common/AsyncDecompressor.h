@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include "velox/dwio/common/Common.h"
+
+#include <folly/futures/Future.h>
+
+#include <optional>
+#include <vector>
+
+namespace facebook::velox::dwrf {
+
+/// Decompresses DWRF compression blocks on an offload engine, e.g. Intel
+/// QAT or IAA. Blocks are submitted in batches so that the engine can
+/// decompress many blocks in parallel while the CPU continues decoding.
+/// A block is in the format of its codec without the DWRF block header,
+/// e.g. raw deflate for ZLIB.
+class AsyncDecompressor {
+ public:
+  struct Block {
+    const char* input;
+    uint64_t inputLength;
+    char* output;
+    uint64_t outputCapacity;
+  };
+
+  virtual ~AsyncDecompressor() = default;
+
+  /// Returns true if 'this' can decompress blocks of 'kind'.
+  virtual bool supports(dwio::common::CompressionKind kind) const = 0;
+
+  /// Starts decompressing 'blocks'. The input and output memory must stay
+  /// live until the future is realized. The result has the uncompressed
+  /// size of each block or std::nullopt for a block the engine could not
+  /// decompress. The caller decompresses such blocks in software, as well
+  /// as all blocks if the future has an error.
+  virtual folly::SemiFuture<std::vector<std::optional<uint64_t>>> submit(
+      dwio::common::CompressionKind kind,
+      const std::vector<Block>& blocks) = 0;
+};
+
+/// Registers the process-wide offload engine used by createDecompressor
+/// and decompressBlocks. nullptr unregisters it.
+void registerAsyncDecompressor(std::shared_ptr<AsyncDecompressor> engine);
+
+/// Returns the registered offload engine or nullptr if there is none.
+std::shared_ptr<AsyncDecompressor> asyncDecompressor();
+
+} // namespace facebook::velox::dwrf
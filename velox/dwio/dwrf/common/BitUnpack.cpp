@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/BitUnpack.h"
+
+#include <folly/Bits.h>
+#include <xsimd/xsimd.hpp>
+
+namespace facebook::velox::dwrf {
+
+namespace {
+
+// Unpacks 4 values per iteration with a gather of the 64 bit big endian
+// words that contain each value. Handles widths where a value with its
+// leading bit offset fits in a word. Returns the number of values unpacked.
+#if XSIMD_WITH_AVX2
+uint64_t unpackAvx2(
+    const uint8_t* input,
+    uint64_t bitOffset,
+    int32_t bitWidth,
+    uint64_t numValues,
+    uint64_t* output) {
+  if (bitWidth > 56) {
+    return 0;
+  }
+  const auto byteSwap = _mm256_setr_epi8(
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  const auto lowBits = _mm256_set1_epi64x(7);
+  const auto step = _mm256_set1_epi64x(4 * bitWidth);
+  const auto rightShift = _mm_cvtsi32_si128(64 - bitWidth);
+  auto bits = _mm256_setr_epi64x(
+      bitOffset,
+      bitOffset + bitWidth,
+      bitOffset + 2 * bitWidth,
+      bitOffset + 3 * bitWidth);
+  uint64_t i = 0;
+  for (; i + 4 <= numValues; i += 4) {
+    auto words = _mm256_i64gather_epi64(
+        reinterpret_cast<const long long*>(input),
+        _mm256_srli_epi64(bits, 3),
+        1);
+    words = _mm256_shuffle_epi8(words, byteSwap);
+    words = _mm256_sllv_epi64(words, _mm256_and_si256(bits, lowBits));
+    words = _mm256_srl_epi64(words, rightShift);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), words);
+    bits = _mm256_add_epi64(bits, step);
+  }
+  return i;
+}
+#endif
+
+} // namespace
+
+void unpackBitsBigEndian(
+    const uint8_t* input,
+    uint64_t bitOffset,
+    int32_t bitWidth,
+    uint64_t numValues,
+    uint64_t* output) {
+  uint64_t i = 0;
+#if XSIMD_WITH_AVX2
+  i = unpackAvx2(input, bitOffset, bitWidth, numValues, output);
+#endif
+  for (; i < numValues; ++i) {
+    const auto bit = bitOffset + i * bitWidth;
+    const auto* bytes = input + (bit >> 3);
+    const auto shift = bit & 7;
+    auto word = folly::Endian::big(folly::loadUnaligned<uint64_t>(bytes));
+    word <<= shift;
+    if (shift + bitWidth > 64) {
+      // The value straddles 9 bytes.
+      word |= bytes[8] >> (8 - shift);
+    }
+    output[i] = word >> (64 - bitWidth);
+  }
+}
+
+} // namespace facebook::velox::dwrf
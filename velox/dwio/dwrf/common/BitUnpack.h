@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace facebook::velox::dwrf {
+
+// Padding that must be readable after the last byte of packed values given
+// to unpackBitsBigEndian().
+constexpr int32_t kBitUnpackPadding = 8;
+
+// Unpacks 'numValues' values of 'bitWidth' bits, 1 <= bitWidth <= 64, into
+// 'output'. The values are packed most significant bit first as in RLEv2
+// DIRECT and PATCHED_BASE runs and the first value starts 'bitOffset' bits
+// into 'input'. Reads up to kBitUnpackPadding bytes past the last packed
+// byte.
+void unpackBitsBigEndian(
+    const uint8_t* input,
+    uint64_t bitOffset,
+    int32_t bitWidth,
+    uint64_t numValues,
+    uint64_t* output);
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "velox/dwio/common/exception/Exception.h"
+
+namespace facebook::velox::dwrf {
+
+namespace {
+uint64_t rotateLeft(uint64_t value, int32_t shift) {
+  return (value << shift) | (value >> (64 - shift));
+}
+
+// Arithmetic right shift as in Java.
+uint64_t shiftRight(uint64_t value, int32_t shift) {
+  return static_cast<uint64_t>(static_cast<int64_t>(value) >> shift);
+}
+
+uint64_t fmix64(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+constexpr uint64_t kC1 = 0x87c37b91114253d5ULL;
+constexpr uint64_t kC2 = 0x4cf5ad432745937fULL;
+constexpr uint64_t kSeed = 104729;
+} // namespace
+
+BloomFilter::BloomFilter(uint64_t expectedEntries, double fpp) {
+  DWIO_ENSURE_GT(expectedEntries, 0);
+  DWIO_ENSURE(fpp > 0.0 && fpp < 1.0, "Invalid bloom filter fpp ", fpp);
+  auto numBits = static_cast<uint64_t>(
+      -static_cast<double>(expectedEntries) * std::log(fpp) /
+      (std::log(2.0) * std::log(2.0)));
+  // The bits are stored in 64 bit words.
+  bits_.resize(std::max<uint64_t>(1, (numBits + 63) / 64));
+  numHashFunctions_ = std::max<int32_t>(
+      1,
+      std::round(
+          static_cast<double>(bits_.size() * 64) / expectedEntries *
+          std::log(2.0)));
+}
+
+BloomFilter::BloomFilter(const proto::BloomFilter& proto)
+    : numHashFunctions_(proto.numhashfunctions()) {
+  if (proto.bitset_size() > 0) {
+    bits_.assign(proto.bitset().begin(), proto.bitset().end());
+  } else {
+    // The words are little endian.
+    const auto& bytes = proto.utf8bitset();
+    bits_.resize(bytes.size() / 8);
+    memcpy(bits_.data(), bytes.data(), bits_.size() * 8);
+  }
+  DWIO_ENSURE(!bits_.empty(), "Empty bloom filter");
+  DWIO_ENSURE_GT(numHashFunctions_, 0);
+}
+
+void BloomFilter::reset() {
+  std::fill(bits_.begin(), bits_.end(), 0);
+}
+
+void BloomFilter::toProto(proto::BloomFilter& proto) const {
+  proto.set_numhashfunctions(numHashFunctions_);
+  proto.mutable_bitset()->Reserve(bits_.size());
+  for (auto word : bits_) {
+    proto.add_bitset(word);
+  }
+}
+
+// static
+uint64_t BloomFilter::longHash(int64_t value) {
+  uint64_t key = value;
+  key = ~key + (key << 21);
+  key = key ^ shiftRight(key, 24);
+  key = key + (key << 3) + (key << 8);
+  key = key ^ shiftRight(key, 14);
+  key = key + (key << 2) + (key << 4);
+  key = key ^ shiftRight(key, 28);
+  key = key + (key << 31);
+  return key;
+}
+
+// static
+uint64_t BloomFilter::murmur3Hash64(const char* data, int32_t size) {
+  auto bytes = reinterpret_cast<const uint8_t*>(data);
+  uint64_t hash = kSeed;
+  auto numBlocks = size / 8;
+  for (auto i = 0; i < numBlocks; ++i) {
+    uint64_t k;
+    memcpy(&k, bytes + i * 8, sizeof(k));
+    k *= kC1;
+    k = rotateLeft(k, 31);
+    k *= kC2;
+    hash ^= k;
+    hash = rotateLeft(hash, 27) * 5 + 0x52dce729;
+  }
+  auto tail = bytes + numBlocks * 8;
+  auto tailSize = size - numBlocks * 8;
+  if (tailSize > 0) {
+    uint64_t k = 0;
+    for (auto i = tailSize - 1; i >= 0; --i) {
+      k ^= static_cast<uint64_t>(tail[i]) << (i * 8);
+    }
+    k *= kC1;
+    k = rotateLeft(k, 31);
+    k *= kC2;
+    hash ^= k;
+  }
+  hash ^= size;
+  return fmix64(hash);
+}
+
+void BloomFilter::addHash(uint64_t hash) {
+  uint32_t hash1 = hash;
+  uint32_t hash2 = hash >> 32;
+  auto numBits = bits_.size() * 64;
+  for (auto i = 1; i <= numHashFunctions_; ++i) {
+    auto combined = static_cast<int32_t>(hash1 + i * hash2);
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    auto bit = combined % numBits;
+    bits_[bit / 64] |= 1ULL << (bit % 64);
+  }
+}
+
+bool BloomFilter::testHash(uint64_t hash) const {
+  uint32_t hash1 = hash;
+  uint32_t hash2 = hash >> 32;
+  auto numBits = bits_.size() * 64;
+  for (auto i = 1; i <= numHashFunctions_; ++i) {
+    auto combined = static_cast<int32_t>(hash1 + i * hash2);
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    auto bit = combined % numBits;
+    if ((bits_[bit / 64] & (1ULL << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace facebook::velox::dwrf
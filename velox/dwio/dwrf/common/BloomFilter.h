@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
+
+namespace facebook::velox::dwrf {
+
+/// Bloom filter of the values of a column in one row index stride, stored
+/// in the BLOOM_FILTER_UTF8 stream. The layout and hashing follow the ORC
+/// and DWRF Java writers: integers are hashed with Thomas Wang's 64 bit
+/// integer hash, strings with 64 bit Murmur3 of their bytes, and the bit
+/// positions are derived from the two 32 bit halves of the hash.
+class BloomFilter {
+ public:
+  /// Makes an empty filter sized for 'expectedEntries' distinct values at a
+  /// false positive probability of 'fpp'.
+  BloomFilter(uint64_t expectedEntries, double fpp);
+
+  /// Makes a filter from the serialized 'proto'.
+  explicit BloomFilter(const proto::BloomFilter& proto);
+
+  void addLong(int64_t value) {
+    addHash(longHash(value));
+  }
+
+  void addBytes(const char* data, int32_t size) {
+    addHash(murmur3Hash64(data, size));
+  }
+
+  /// Returns false if 'value' was definitely not added.
+  bool testLong(int64_t value) const {
+    return testHash(longHash(value));
+  }
+
+  bool testBytes(const char* data, int32_t size) const {
+    return testHash(murmur3Hash64(data, size));
+  }
+
+  /// Removes all values.
+  void reset();
+
+  void toProto(proto::BloomFilter& proto) const;
+
+  int32_t numHashFunctions() const {
+    return numHashFunctions_;
+  }
+
+  uint64_t numBits() const {
+    return bits_.size() * 64;
+  }
+
+  static uint64_t longHash(int64_t value);
+
+  static uint64_t murmur3Hash64(const char* data, int32_t size);
+
+ private:
+  void addHash(uint64_t hash);
+
+  bool testHash(uint64_t hash) const;
+
+  int32_t numHashFunctions_;
+  std::vector<uint64_t> bits_;
+};
+
+} // namespace facebook::velox::dwrf
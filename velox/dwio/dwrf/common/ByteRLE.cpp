@@ -389,66 +389,66 @@ void ByteRleDecoder::skip(uint64_t numValues) {
   }
 }
 
-void ByteRleDecoder::next(
-    char* data,
-    uint64_t numValues,
-    const uint64_t* nulls) {
-  uint64_t position = 0;
-  // skip over null values
-  while (nulls && position < numValues && bits::isBitNull(nulls, position)) {
-    position += 1;
+namespace {
+// Returns the first position in [begin, end) where the bit in 'nulls' is
+// 'value', or 'end' if there is none.
+template <bool value>
+uint64_t findNextBit(const uint64_t* nulls, uint64_t begin, uint64_t end) {
+  while (begin < end) {
+    uint64_t word = value ? nulls[begin / 64] : ~nulls[begin / 64];
+    word &= ~0ULL << (begin % 64);
+    if (word) {
+      return std::min(end, (begin & ~63ULL) + __builtin_ctzll(word));
+    }
+    begin = (begin | 63) + 1;
   }
-  while (position < numValues) {
-    // if we are out of values, read more
+  return end;
+}
+} // namespace
+
+void ByteRleDecoder::readValues(char* data, uint64_t numValues) {
+  while (numValues > 0) {
     if (remainingValues == 0) {
       readHeader();
     }
-    // how many do we read out of this block?
-    size_t count =
-        std::min(static_cast<size_t>(numValues - position), remainingValues);
-    uint64_t consumed = 0;
+    uint64_t count = std::min<uint64_t>(numValues, remainingValues);
     if (repeating) {
-      if (nulls) {
-        for (uint64_t i = 0; i < count; ++i) {
-          if (!bits::isBitNull(nulls, position + i)) {
-            data[position + i] = value;
-            consumed += 1;
-          }
-        }
-      } else {
-        memset(data + position, value, count);
-        consumed = count;
-      }
+      memset(data, value, count);
     } else {
-      if (nulls) {
-        for (uint64_t i = 0; i < count; ++i) {
-          if (!bits::isBitNull(nulls, position + i)) {
-            data[position + i] = readByte();
-            consumed += 1;
-          }
-        }
-      } else {
-        uint64_t i = 0;
-        while (i < count) {
-          if (bufferStart == bufferEnd) {
-            nextBuffer();
-          }
-          uint64_t copyBytes = std::min(
-              static_cast<uint64_t>(count - i),
-              static_cast<uint64_t>(bufferEnd - bufferStart));
-          std::copy(bufferStart, bufferStart + copyBytes, data + position + i);
-          bufferStart += copyBytes;
-          i += copyBytes;
+      uint64_t i = 0;
+      while (i < count) {
+        if (bufferStart == bufferEnd) {
+          nextBuffer();
         }
-        consumed = count;
+        uint64_t copyBytes = std::min(
+            static_cast<uint64_t>(count - i),
+            static_cast<uint64_t>(bufferEnd - bufferStart));
+        memcpy(data + i, bufferStart, copyBytes);
+        bufferStart += copyBytes;
+        i += copyBytes;
       }
     }
-    remainingValues -= consumed;
-    position += count;
-    // skip over any null values
-    while (nulls && position < numValues && bits::isBitNull(nulls, position)) {
-      position += 1;
-    }
+    remainingValues -= count;
+    data += count;
+    numValues -= count;
+  }
+}
+
+void ByteRleDecoder::next(
+    char* data,
+    uint64_t numValues,
+    const uint64_t* nulls) {
+  if (!nulls) {
+    readValues(data, numValues);
+    return;
+  }
+  // Reads each range of non-null positions in one call, so that runs are
+  // set and literals copied a range at a time.
+  uint64_t position = findNextBit<true>(nulls, 0, numValues);
+  while (position < numValues) {
+    auto end = findNextBit<false>(nulls, position, numValues);
+    readValues(data + position, end - position);
+    position = findNextBit<true>(nulls, end, numValues);
   }
 }
 
@@ -197,6 +197,9 @@ class ByteRleDecoder {
  protected:
   void nextBuffer();
 
+  // Reads the next 'numValues' values into consecutive bytes of 'data'.
+  void readValues(char* data, uint64_t numValues);
+
   inline signed char readByte() {
     if (bufferStart == bufferEnd) {
       nextBuffer();
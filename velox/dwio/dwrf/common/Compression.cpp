@@ -431,8 +431,234 @@ bool ZlibDecompressionStream::Next(const void** data, int32_t* size) {
   return true;
 }
 
+// Decompresses zstd blocks that span several ranges of the input stream
+// by streaming the ranges through a ZSTD_DCtx instead of first copying the
+// block into a contiguous input buffer. Blocks within one range are
+// decompressed by PagedInputStream.
+class ZstdDecompressionStream : public PagedInputStream {
+ public:
+  ZstdDecompressionStream(
+      std::unique_ptr<dwio::common::SeekableInputStream> inStream,
+      uint64_t blockSize,
+      MemoryPool& pool,
+      const std::string& streamDebugInfo)
+      : PagedInputStream{
+            std::move(inStream),
+            pool,
+            std::make_unique<ZstdDecompressor>(blockSize, streamDebugInfo),
+            nullptr,
+            streamDebugInfo},
+        blockSize_{blockSize},
+        context_{ZSTD_createDCtx()} {
+    DWIO_ENSURE_NOT_NULL(context_, "Failed to create ZSTD_DCtx");
+  }
+
+  ~ZstdDecompressionStream() override {
+    ZSTD_freeDCtx(context_);
+  }
+
+  bool Next(const void** data, int32_t* size) override;
+
+ private:
+  // Decompresses the current block, starting with the 'availSize' bytes at
+  // 'inputBufferPtr_', into 'outputBuffer_'. Returns the decompressed size.
+  uint64_t decompressRanges(size_t availSize);
+
+  const uint64_t blockSize_;
+  ZSTD_DCtx* context_;
+};
+
+bool ZstdDecompressionStream::Next(const void** data, int32_t* size) {
+  if (outputBufferLength_) {
+    return PagedInputStream::Next(data, size);
+  }
+  if (state_ == State::HEADER || remainingLength_ == 0) {
+    readHeader();
+  }
+  if (state_ != State::START) {
+    return PagedInputStream::Next(data, size);
+  }
+  if (inputBufferPtr_ == inputBufferPtrEnd_) {
+    readBuffer(true);
+  }
+  size_t availSize = std::min(
+      static_cast<size_t>(inputBufferPtrEnd_ - inputBufferPtr_),
+      remainingLength_);
+  if (availSize == remainingLength_) {
+    return PagedInputStream::Next(data, size);
+  }
+  prepareOutputBuffer(
+      decompressor_->getUncompressedLength(inputBufferPtr_, availSize));
+  auto length = decompressRanges(availSize);
+  outputBufferPtr_ = outputBuffer_->data();
+  *data = outputBufferPtr_;
+  *size = static_cast<int32_t>(length);
+  outputBufferPtr_ += length;
+  outputBufferLength_ = 0;
+  bytesReturned_ += length;
+  return true;
+}
+
+uint64_t ZstdDecompressionStream::decompressRanges(size_t availSize) {
+  auto ret = ZSTD_DCtx_reset(context_, ZSTD_reset_session_only);
+  DWIO_ENSURE(
+      !ZSTD_isError(ret),
+      "ZSTD returned an error: ",
+      ZSTD_getErrorName(ret),
+      " in ",
+      getName());
+  ZSTD_outBuffer output{outputBuffer_->data(), outputBuffer_->capacity(), 0};
+  for (;;) {
+    ZSTD_inBuffer input{inputBufferPtr_, availSize, 0};
+    while (input.pos < input.size) {
+      DWIO_ENSURE_LT(
+          output.pos,
+          output.size,
+          "Insufficient buffer size in ",
+          getName(),
+          " block size: ",
+          blockSize_);
+      ret = ZSTD_decompressStream(context_, &output, &input);
+      DWIO_ENSURE(
+          !ZSTD_isError(ret),
+          "ZSTD returned an error: ",
+          ZSTD_getErrorName(ret),
+          " in ",
+          getName());
+    }
+    inputBufferPtr_ += availSize;
+    remainingLength_ -= availSize;
+    if (remainingLength_ == 0) {
+      break;
+    }
+    readBuffer(true);
+    availSize = std::min(
+        static_cast<size_t>(inputBufferPtrEnd_ - inputBufferPtr_),
+        remainingLength_);
+  }
+  DWIO_ENSURE_EQ(ret, 0, "Truncated ZSTD frame in ", getName());
+  return output.pos;
+}
+
+// Decompresses the blocks the offload engine did not decompress.
+std::vector<uint64_t> decompressRemaining(
+    Decompressor& software,
+    const std::vector<AsyncDecompressor::Block>& blocks,
+    const std::vector<std::optional<uint64_t>>& offloadedLengths) {
+  std::vector<uint64_t> lengths(blocks.size());
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (i < offloadedLengths.size() && offloadedLengths[i].has_value()) {
+      lengths[i] = offloadedLengths[i].value();
+      continue;
+    }
+    auto& block = blocks[i];
+    lengths[i] = software.decompress(
+        block.input, block.inputLength, block.output, block.outputCapacity);
+  }
+  return lengths;
+}
+
+folly::SemiFuture<std::vector<uint64_t>> offloadBlocks(
+    AsyncDecompressor& engine,
+    dwio::common::CompressionKind kind,
+    std::vector<AsyncDecompressor::Block> blocks,
+    std::shared_ptr<Decompressor> software) {
+  folly::SemiFuture<std::vector<std::optional<uint64_t>>> offloaded =
+      folly::SemiFuture<std::vector<std::optional<uint64_t>>>::makeEmpty();
+  try {
+    offloaded = engine.submit(kind, blocks);
+  } catch (const std::exception& e) {
+    XLOG_EVERY_N(WARNING, 1000)
+        << "Decompression offload failed, using software: " << e.what();
+    return folly::makeSemiFuture(decompressRemaining(*software, blocks, {}));
+  }
+  return std::move(offloaded).deferTry(
+      [software = std::move(software), blocks = std::move(blocks)](
+          folly::Try<std::vector<std::optional<uint64_t>>>&& lengths) {
+        if (lengths.hasException()) {
+          XLOG_EVERY_N(WARNING, 1000)
+              << "Decompression offload failed, using software: "
+              << lengths.exception().what();
+          return decompressRemaining(*software, blocks, {});
+        }
+        return decompressRemaining(*software, blocks, lengths.value());
+      });
+}
+
+// Decompresses each block on an offload engine and falls back to software
+// for the blocks the engine fails.
+class OffloadDecompressor : public Decompressor {
+ public:
+  OffloadDecompressor(
+      dwio::common::CompressionKind kind,
+      std::shared_ptr<AsyncDecompressor> engine,
+      std::unique_ptr<Decompressor> software,
+      uint64_t blockSize,
+      const std::string& streamDebugInfo)
+      : Decompressor{blockSize, streamDebugInfo},
+        kind_{kind},
+        engine_{std::move(engine)},
+        software_{std::move(software)} {}
+
+  uint64_t getUncompressedLength(const char* src, uint64_t srcLength)
+      const override {
+    return software_->getUncompressedLength(src, srcLength);
+  }
+
+  uint64_t decompress(
+      const char* src,
+      uint64_t srcLength,
+      char* dest,
+      uint64_t destLength) override {
+    auto lengths =
+        offloadBlocks(
+            *engine_, kind_, {{src, srcLength, dest, destLength}}, software_)
+            .get();
+    return lengths[0];
+  }
+
+ private:
+  const dwio::common::CompressionKind kind_;
+  const std::shared_ptr<AsyncDecompressor> engine_;
+  const std::shared_ptr<Decompressor> software_;
+};
+
 } // namespace
 
+std::unique_ptr<Decompressor> createBlockDecompressor(
+    dwio::common::CompressionKind kind,
+    uint64_t blockSize,
+    const std::string& streamDebugInfo) {
+  switch (static_cast<int64_t>(kind)) {
+    case dwio::common::CompressionKind_ZLIB:
+      return std::make_unique<ZlibDecompressor>(blockSize, streamDebugInfo);
+    case dwio::common::CompressionKind_SNAPPY:
+      return std::make_unique<SnappyDecompressor>(blockSize, streamDebugInfo);
+    case dwio::common::CompressionKind_LZO:
+      return std::make_unique<LzoDecompressor>(blockSize, streamDebugInfo);
+    case dwio::common::CompressionKind_LZ4:
+      return std::make_unique<Lz4Decompressor>(blockSize, streamDebugInfo);
+    case dwio::common::CompressionKind_ZSTD:
+      return std::make_unique<ZstdDecompressor>(blockSize, streamDebugInfo);
+    default:
+      DWIO_RAISE("Unknown compression codec ", kind);
+  }
+}
+
+folly::SemiFuture<std::vector<uint64_t>> decompressBlocks(
+    dwio::common::CompressionKind kind,
+    std::vector<AsyncDecompressor::Block> blocks,
+    uint64_t blockSize,
+    const std::string& streamDebugInfo) {
+  std::shared_ptr<Decompressor> software =
+      createBlockDecompressor(kind, blockSize, streamDebugInfo);
+  auto engine = asyncDecompressor();
+  if (!engine || !engine->supports(kind)) {
+    return folly::makeSemiFuture(decompressRemaining(*software, blocks, {}));
+  }
+  return offloadBlocks(*engine, kind, std::move(blocks), std::move(software));
+}
+
 std::unique_ptr<BufferedOutputStream> createCompressor(
     dwio::common::CompressionKind kind,
     CompressionBufferPool& bufferPool,
@@ -480,6 +706,8 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     MemoryPool& pool,
     const std::string& streamDebugInfo,
     const Decrypter* decrypter) {
+  auto engine = asyncDecompressor();
+  const bool offload = engine && engine->supports(kind);
   std::unique_ptr<Decompressor> decompressor;
   switch (static_cast<int64_t>(kind)) {
     case dwio::common::CompressionKind_NONE:
@@ -489,33 +717,32 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
       // decompressor remain as nullptr
       break;
     case dwio::common::CompressionKind_ZLIB:
-      if (!decrypter) {
+      if (!decrypter && !offload) {
         // When file is not encrypted, we can use zlib streaming codec to avoid
         // copying data
         return std::make_unique<ZlibDecompressionStream>(
             std::move(input), blockSize, pool, streamDebugInfo);
       }
-      decompressor =
-          std::make_unique<ZlibDecompressor>(blockSize, streamDebugInfo);
-      break;
-    case dwio::common::CompressionKind_SNAPPY:
-      decompressor =
-          std::make_unique<SnappyDecompressor>(blockSize, streamDebugInfo);
-      break;
-    case dwio::common::CompressionKind_LZO:
-      decompressor =
-          std::make_unique<LzoDecompressor>(blockSize, streamDebugInfo);
-      break;
-    case dwio::common::CompressionKind_LZ4:
-      decompressor =
-          std::make_unique<Lz4Decompressor>(blockSize, streamDebugInfo);
+      decompressor = createBlockDecompressor(kind, blockSize, streamDebugInfo);
       break;
     case dwio::common::CompressionKind_ZSTD:
-      decompressor =
-          std::make_unique<ZstdDecompressor>(blockSize, streamDebugInfo);
+      if (!decrypter && !offload) {
+        // Streams blocks that span input ranges without copying them.
+        return std::make_unique<ZstdDecompressionStream>(
+            std::move(input), blockSize, pool, streamDebugInfo);
+      }
+      decompressor = createBlockDecompressor(kind, blockSize, streamDebugInfo);
       break;
     default:
-      DWIO_RAISE("Unknown compression codec ", kind);
+      decompressor = createBlockDecompressor(kind, blockSize, streamDebugInfo);
+  }
+  if (decompressor && offload) {
+    decompressor = std::make_unique<OffloadDecompressor>(
+        kind,
+        std::move(engine),
+        std::move(decompressor),
+        blockSize,
+        streamDebugInfo);
   }
   return std::make_unique<PagedInputStream>(
       std::move(input),
@@ -18,6 +18,7 @@
 
 #include "velox/dwio/common/Common.h"
 #include "velox/dwio/common/SeekableInputStream.h"
+#include "velox/dwio/dwrf/common/AsyncDecompressor.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/common/CompressionBufferPool.h"
 #include "velox/dwio/dwrf/common/Config.h"
@@ -66,7 +67,29 @@ class Decompressor {
 };
 
 /**
- * Create a decompressor for the given compression kind.
+ * Create the software decompressor for blocks of the given compression kind.
+ */
+std::unique_ptr<Decompressor> createBlockDecompressor(
+    dwio::common::CompressionKind kind,
+    uint64_t blockSize,
+    const std::string& streamDebugInfo);
+
+/**
+ * Decompress a batch of blocks of the given compression kind. The blocks are
+ * submitted to the registered AsyncDecompressor if it supports the kind, and
+ * the blocks it fails are decompressed in software. The future gives the
+ * uncompressed size of each block.
+ */
+folly::SemiFuture<std::vector<uint64_t>> decompressBlocks(
+    dwio::common::CompressionKind kind,
+    std::vector<AsyncDecompressor::Block> blocks,
+    uint64_t blockSize,
+    const std::string& streamDebugInfo);
+
+/**
+ * Create a decompressor for the given compression kind. Compressed blocks
+ * are decompressed on the registered AsyncDecompressor if it supports the
+ * kind.
  * @param kind the compression type to implement
  * @param input the input stream that is the underlying source
  * @param bufferSize the maximum size of the buffer
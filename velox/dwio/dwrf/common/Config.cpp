@@ -104,6 +104,13 @@ Config::Entry<uint32_t> Config::ENTROPY_STRING_THRESHOLD{
     "hive.exec.orc.entropy.string.threshold",
     20};
 
+// If true, integer and string columns choose between dictionary and direct
+// encoding from the estimated size of their streams in the first stripe
+// instead of the key size and entropy thresholds.
+Config::Entry<bool> Config::ENCODING_COST_BASED_SELECTION{
+    "orc.encoding.cost.based.selection",
+    false};
+
 Config::Entry<uint32_t> Config::STRING_STATS_LIMIT(
     "hive.orc.string.stats.limit",
     64);
@@ -122,24 +129,32 @@ Config::Entry<bool> Config::MAP_FLAT_DICT_SHARE(
     "orc.map.flat.dict.share",
     true);
 
+namespace {
+std::string columnsToString(const std::vector<uint32_t>& val) {
+  return folly::join(",", val);
+}
+
+std::vector<uint32_t> columnsFromString(const std::string& val) {
+  std::vector<uint32_t> result;
+  if (!val.empty()) {
+    std::vector<folly::StringPiece> pieces;
+    folly::split(',', val, pieces, true);
+    for (auto& p : pieces) {
+      const auto& trimmedCol = folly::trimWhitespace(p);
+      if (!trimmedCol.empty()) {
+        result.push_back(folly::to<uint32_t>(trimmedCol));
+      }
+    }
+  }
+  return result;
+}
+} // namespace
+
 Config::Entry<const std::vector<uint32_t>> Config::MAP_FLAT_COLS(
     "orc.map.flat.cols",
     {},
-    [](const std::vector<uint32_t>& val) { return folly::join(",", val); },
-    [](const std::string& val) {
-      std::vector<uint32_t> result;
-      if (!val.empty()) {
-        std::vector<folly::StringPiece> pieces;
-        folly::split(',', val, pieces, true);
-        for (auto& p : pieces) {
-          const auto& trimmedCol = folly::trimWhitespace(p);
-          if (!trimmedCol.empty()) {
-            result.push_back(folly::to<uint32_t>(trimmedCol));
-          }
-        }
-      }
-      return result;
-    });
+    columnsToString,
+    columnsFromString);
 
 Config::Entry<uint32_t> Config::MAP_FLAT_MAX_KEYS(
     "orc.map.flat.max.keys",
@@ -170,4 +185,12 @@ Config::Entry<uint64_t> Config::RAW_DATA_SIZE_PER_BATCH(
     50UL * 1024 * 1024);
 
 Config::Entry<bool> Config::MAP_STATISTICS("orc.map.statistics", false);
+
+Config::Entry<const std::vector<uint32_t>> Config::BLOOM_FILTER_COLUMNS(
+    "orc.bloom.filter.columns",
+    {},
+    columnsToString,
+    columnsFromString);
+
+Config::Entry<float> Config::BLOOM_FILTER_FPP("orc.bloom.filter.fpp", 0.05);
 } // namespace facebook::velox::dwrf
@@ -100,6 +100,7 @@ class Config {
   static Entry<uint32_t> ENTROPY_STRING_MIN_SAMPLES;
   static Entry<float> ENTROPY_STRING_DICT_SAMPLE_FRACTION;
   static Entry<uint32_t> ENTROPY_STRING_THRESHOLD;
+  static Entry<bool> ENCODING_COST_BASED_SELECTION;
   static Entry<uint32_t> STRING_STATS_LIMIT;
   static Entry<bool> FLATTEN_MAP;
   static Entry<bool> MAP_FLAT_DISABLE_DICT_ENCODING;
@@ -121,6 +122,11 @@ class Config {
   // to write oversized stripes.
   static Entry<uint64_t> RAW_DATA_SIZE_PER_BATCH;
   static Entry<bool> MAP_STATISTICS;
+  // Columns that get a bloom filter per row index stride for point lookups.
+  // Applies to integer and string columns.
+  static Entry<const std::vector<uint32_t>> BLOOM_FILTER_COLUMNS;
+  // False positive probability of the bloom filters.
+  static Entry<float> BLOOM_FILTER_FPP;
 
  private:
   std::unordered_map<std::string, std::string> configs_;
@@ -63,8 +63,7 @@ class FloatingPointDecoder {
 
   template <bool hasNulls, typename Visitor>
   void readWithVisitor(const uint64_t* nulls, Visitor visitor) {
-    if (std::is_same<TData, TRequested>::value &&
-        dwio::common::useFastPath<Visitor, hasNulls>(visitor)) {
+    if (dwio::common::useFastPath<Visitor, hasNulls>(visitor)) {
       fastPath<hasNulls>(nulls, visitor);
       return;
     }
@@ -141,35 +140,102 @@ class FloatingPointDecoder {
           return;
         }
       }
-      dwio::common::fixedWidthScan<TData, filterOnly, true>(
-          innerVector ? folly::Range<const int32_t*>(*innerVector)
-                      : folly::Range<const int32_t*>(rows, outerVector->size()),
-          outerVector->data(),
-          visitor.rawValues(numRows),
-          hasFilter ? visitor.outputRows(numRows) : nullptr,
-          numValues,
-          *input_,
-          bufferStart_,
-          bufferEnd_,
-          visitor.filter(),
-          visitor.hook());
+      auto dataRows = innerVector
+          ? folly::Range<const int32_t*>(*innerVector)
+          : folly::Range<const int32_t*>(rows, outerVector->size());
+      if constexpr (std::is_same<TData, TRequested>::value) {
+        dwio::common::fixedWidthScan<TData, filterOnly, true>(
+            dataRows,
+            outerVector->data(),
+            visitor.rawValues(numRows),
+            hasFilter ? visitor.outputRows(numRows) : nullptr,
+            numValues,
+            *input_,
+            bufferStart_,
+            bufferEnd_,
+            visitor.filter(),
+            visitor.hook());
+      } else {
+        auto values = visitor.rawValues(numRows);
+        readWidened<Visitor::dense>(dataRows, values);
+        dwio::common::
+            processFixedWidthRun<TRequested, filterOnly, true, Visitor::dense>(
+                dataRows,
+                0,
+                dataRows.size(),
+                outerVector->data(),
+                values,
+                hasFilter ? visitor.outputRows(numRows) : nullptr,
+                numValues,
+                visitor.filter(),
+                visitor.hook());
+      }
       skip<false>(tailSkip, 0, nullptr);
     } else {
-      dwio::common::fixedWidthScan<TData, filterOnly, false>(
-          folly::Range<const int32_t*>(rows, numRows),
-          hasHook ? velox::iota(numRows, visitor.innerNonNullRows()) : nullptr,
-          visitor.rawValues(numRows),
-          hasFilter ? visitor.outputRows(numRows) : nullptr,
-          numValues,
-          *input_,
-          bufferStart_,
-          bufferEnd_,
-          visitor.filter(),
-          visitor.hook());
+      auto rowsAsRange = folly::Range<const int32_t*>(rows, numRows);
+      if constexpr (std::is_same<TData, TRequested>::value) {
+        dwio::common::fixedWidthScan<TData, filterOnly, false>(
+            rowsAsRange,
+            hasHook ? velox::iota(numRows, visitor.innerNonNullRows())
+                    : nullptr,
+            visitor.rawValues(numRows),
+            hasFilter ? visitor.outputRows(numRows) : nullptr,
+            numValues,
+            *input_,
+            bufferStart_,
+            bufferEnd_,
+            visitor.filter(),
+            visitor.hook());
+      } else {
+        auto values = visitor.rawValues(numRows);
+        readWidened<Visitor::dense>(rowsAsRange, values);
+        dwio::common::
+            processFixedWidthRun<TRequested, filterOnly, false, Visitor::dense>(
+                rowsAsRange,
+                0,
+                rowsAsRange.size(),
+                hasHook ? velox::iota(numRows, visitor.innerNonNullRows())
+                        : nullptr,
+                values,
+                hasFilter ? visitor.outputRows(numRows) : nullptr,
+                numValues,
+                visitor.filter(),
+                visitor.hook());
+      }
     }
     visitor.setNumValues(hasFilter ? numValues : numRows);
   }
 
+  // Reads the TData values at 'rows' of the non-null values and widens them
+  // into 'values' as TRequested, so that the SIMD filters run over the
+  // requested type. The TData values are read into the front of 'values' and
+  // widened from last to first, which does not overwrite values that have yet
+  // to be widened since TRequested is the wider type.
+  template <bool dense>
+  void readWidened(folly::Range<const int32_t*> rows, TRequested* values) {
+    static_assert(sizeof(TRequested) > sizeof(TData));
+    auto data = reinterpret_cast<TData*>(values);
+    const int32_t numRows = rows.size();
+    if (dense) {
+      readBytes(
+          numRows * sizeof(TData),
+          input_.get(),
+          data,
+          bufferStart_,
+          bufferEnd_);
+    } else {
+      int32_t previousRow = -1;
+      for (auto i = 0; i < numRows; ++i) {
+        skip(rows[i] - previousRow - 1);
+        data[i] = readValue();
+        previousRow = rows[i];
+      }
+    }
+    for (auto i = numRows - 1; i >= 0; --i) {
+      values[i] = data[i];
+    }
+  }
+
   std::unique_ptr<dwio::common::SeekableInputStream> input_;
   const char* bufferStart_ = nullptr;
   const char* bufferEnd_ = nullptr;
@@ -105,6 +105,16 @@ const char* PagedInputStream::ensureInput(size_t availableInputBytes) {
   return inputBuffer_.data();
 }
 
+const char* PagedInputStream::decryptIntoInputBuffer(const char* input) {
+  if (input != inputBuffer_.data() &&
+      inputBuffer_.capacity() < remainingLength_) {
+    inputBuffer_.reserve(remainingLength_);
+  }
+  decrypter_->decryptInto(
+      folly::StringPiece{input, remainingLength_}, inputBuffer_.data());
+  return inputBuffer_.data();
+}
+
 bool PagedInputStream::Next(const void** data, int32_t* size) {
   // if the user pushed back, return them the partial buffer
   if (outputBufferLength_) {
@@ -150,10 +160,14 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
 
   // perform decryption
   if (decrypter_) {
-    decryptionBuffer_ =
-        decrypter_->decrypt(folly::StringPiece{input, remainingLength_});
-    input = reinterpret_cast<const char*>(decryptionBuffer_->data());
-    remainingLength_ = decryptionBuffer_->length();
+    if (decrypter_->isLengthPreserving()) {
+      input = decryptIntoInputBuffer(input);
+    } else {
+      decryptionBuffer_ =
+          decrypter_->decrypt(folly::StringPiece{input, remainingLength_});
+      input = reinterpret_cast<const char*>(decryptionBuffer_->data());
+      remainingLength_ = decryptionBuffer_->length();
+    }
     *data = input;
     *size = remainingLength_;
     outputBufferPtr_ = input + remainingLength_;
@@ -186,6 +200,96 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
   return true;
 }
 
+std::optional<uint64_t> PagedInputStream::decompressInto(
+    char* dest,
+    size_t destLength) {
+  if (state_ == State::HEADER || remainingLength_ == 0) {
+    readHeader();
+  }
+  // An unencrypted uncompressed block is returned by Next() without copying.
+  if (state_ == State::END || (state_ == State::ORIGINAL && !decrypter_) ||
+      (state_ == State::ORIGINAL && remainingLength_ > destLength)) {
+    return std::nullopt;
+  }
+  if (inputBufferPtr_ == inputBufferPtrEnd_) {
+    readBuffer(true);
+  }
+  size_t availSize = std::min(
+      static_cast<size_t>(inputBufferPtrEnd_ - inputBufferPtr_),
+      remainingLength_);
+  uint64_t length;
+  if (state_ == State::ORIGINAL) {
+    decrypter_->decryptInto(
+        folly::StringPiece{ensureInput(availSize), remainingLength_}, dest);
+    length = remainingLength_;
+  } else if (decrypter_) {
+    DWIO_ENSURE_NOT_NULL(decompressor_.get(), "invalid stream state");
+    auto input = decryptIntoInputBuffer(ensureInput(availSize));
+    const auto uncompressedLength =
+        decompressor_->getUncompressedLength(input, remainingLength_);
+    if (uncompressedLength > destLength) {
+      // The block has been read and decrypted. It is decompressed into
+      // 'outputBuffer_' for the next Next() to return.
+      prepareOutputBuffer(uncompressedLength);
+      outputBufferLength_ = decompressor_->decompress(
+          input,
+          remainingLength_,
+          outputBuffer_->data(),
+          outputBuffer_->capacity());
+      outputBufferPtr_ = outputBuffer_->data();
+      remainingLength_ = 0;
+      state_ = State::HEADER;
+      return std::nullopt;
+    }
+    length =
+        decompressor_->decompress(input, remainingLength_, dest, destLength);
+  } else {
+    if (decompressor_->getUncompressedLength(inputBufferPtr_, availSize) >
+        destLength) {
+      return std::nullopt;
+    }
+    auto input = ensureInput(availSize);
+    length =
+        decompressor_->decompress(input, remainingLength_, dest, destLength);
+  }
+  remainingLength_ = 0;
+  state_ = State::HEADER;
+  bytesReturned_ += length;
+  // The block is not kept in 'outputBuffer_', so there is nothing to back
+  // up into. A seek into the block must read it again.
+  outputBufferPtr_ = nullptr;
+  lastHeaderOffset_ = std::numeric_limits<uint64_t>::max();
+  return length;
+}
+
+void PagedInputStream::readFully(char* buffer, size_t bufferSize) {
+  if (decrypter_ ? !decrypter_->isLengthPreserving() : !decompressor_) {
+    SeekableInputStream::readFully(buffer, bufferSize);
+    return;
+  }
+  size_t pos = 0;
+  while (pos < bufferSize) {
+    if (!outputBufferLength_) {
+      auto length = decompressInto(buffer + pos, bufferSize - pos);
+      if (length.has_value()) {
+        pos += length.value();
+        continue;
+      }
+    }
+    const void* chunk;
+    int32_t length;
+    DWIO_ENSURE(Next(&chunk, &length), "bad read in readFully");
+    auto bytesToCopy = std::min<size_t>(length, bufferSize - pos);
+    auto bytes = reinterpret_cast<const char*>(chunk);
+    std::copy(bytes, bytes + bytesToCopy, buffer + pos);
+    pos += bytesToCopy;
+    if (bytesToCopy < length) {
+      // Returns the rest of the last range to the stream.
+      BackUp(length - bytesToCopy);
+    }
+  }
+}
+
 void PagedInputStream::BackUp(int32_t count) {
   DWIO_ENSURE(
       outputBufferPtr_ != nullptr,
@@ -19,6 +19,8 @@
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 
+#include <optional>
+
 namespace facebook::velox::dwrf {
 
 class PagedInputStream : public dwio::common::SeekableInputStream {
@@ -42,6 +44,11 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
 
   bool Next(const void** data, int32_t* size) override;
   void BackUp(int32_t count) override;
+  // Decompresses blocks that fit in the rest of 'buffer' directly into it
+  // instead of decompressing them into 'outputBuffer_' and copying. With a
+  // length preserving decrypter, uncompressed blocks are decrypted directly
+  // into 'buffer' and compressed ones in place before decompressing.
+  void readFully(char* buffer, size_t bufferSize) override;
   bool Skip(int32_t count) override;
   google::protobuf::int64 ByteCount() const override {
     return bytesReturned_;
@@ -94,6 +101,17 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
   // make sure input is contiguous for decompression/decryption
   const char* ensureInput(size_t availableInputBytes);
 
+  // Decrypts the 'remainingLength_' bytes at 'input' into 'inputBuffer_' with
+  // a length preserving 'decrypter_'. This is in place if 'input' is in
+  // 'inputBuffer_' already. Returns the start of 'inputBuffer_'.
+  const char* decryptIntoInputBuffer(const char* input);
+
+  // Decompresses the next block into 'dest' if it is compressed and known
+  // to fit in 'destLength' bytes. An encrypted uncompressed block that fits
+  // is decrypted into 'dest'. Returns the size of the block or std::nullopt
+  // if the block is not in 'dest'.
+  std::optional<uint64_t> decompressInto(char* dest, size_t destLength);
+
   // input stream where to read compressed/encrypted data
   std::unique_ptr<SeekableInputStream> input_;
   memory::MemoryPool& pool_;
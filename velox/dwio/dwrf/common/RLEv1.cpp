@@ -246,4 +246,48 @@ template void RleDecoderV1<true>::nextLengths(
     int32_t* const data,
     const int32_t numValues);
 
+template <bool isSigned>
+void RleDecoderV1<isSigned>::nextRuns(
+    uint64_t numValues,
+    std::vector<int64_t>& values,
+    std::vector<int32_t>& lengths) {
+  auto addRun = [&](int64_t runValue, int32_t length) {
+    if (!values.empty() && values.back() == runValue) {
+      lengths.back() += length;
+    } else {
+      values.push_back(runValue);
+      lengths.push_back(length);
+    }
+  };
+  while (numValues > 0) {
+    if (remainingValues == 0) {
+      readHeader();
+    }
+    uint64_t count = std::min(numValues, remainingValues);
+    if (repeating && delta == 0) {
+      addRun(value, count);
+    } else if (repeating) {
+      for (uint64_t i = 0; i < count; ++i) {
+        addRun(value + static_cast<int64_t>(i) * delta, 1);
+      }
+      value += static_cast<int64_t>(count) * delta;
+    } else {
+      for (uint64_t i = 0; i < count; ++i) {
+        addRun(IntDecoder<isSigned>::readLong(), 1);
+      }
+    }
+    remainingValues -= count;
+    numValues -= count;
+  }
+}
+
+template void RleDecoderV1<true>::nextRuns(
+    uint64_t numValues,
+    std::vector<int64_t>& values,
+    std::vector<int32_t>& lengths);
+template void RleDecoderV1<false>::nextRuns(
+    uint64_t numValues,
+    std::vector<int64_t>& values,
+    std::vector<int32_t>& lengths);
+
 } // namespace facebook::velox::dwrf
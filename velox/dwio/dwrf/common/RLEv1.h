@@ -251,6 +251,15 @@ class RleDecoderV1 : public IntDecoder<isSigned> {
 
   void nextLengths(int32_t* data, int32_t numValues) override;
 
+  // Reads the next 'numValues' non-null values as runs of equal values.
+  // Appends the value of each run to 'values' and its length to 'lengths'.
+  // Repeated runs with a zero delta stay one run and adjacent equal values
+  // are merged, so a stream of long runs decodes without expanding them.
+  void nextRuns(
+      uint64_t numValues,
+      std::vector<int64_t>& values,
+      std::vector<int32_t>& lengths);
+
   template <bool hasNulls>
   inline void skip(int32_t numValues, int32_t current, const uint64_t* nulls) {
     if (hasNulls) {
@@ -21,6 +21,7 @@
 #include "velox/dwio/common/Adaptor.h"
 #include "velox/dwio/common/DataBuffer.h"
 #include "velox/dwio/common/exception/Exception.h"
+#include "velox/dwio/dwrf/common/BitUnpack.h"
 #include "velox/dwio/dwrf/common/IntDecoder.h"
 
 #include <vector>
@@ -113,9 +114,11 @@ class RleDecoderV2 : public IntDecoder<isSigned> {
       uint64_t fb,
       const uint64_t* nulls = nullptr) {
     uint64_t ret = 0;
+    if (!nulls) {
+      ret = unpackBuffered(data + offset, len, fb);
+    }
 
-    // TODO: unroll to improve performance
-    for (uint64_t i = offset; i < (offset + len); i++) {
+    for (uint64_t i = offset + ret; i < (offset + len); i++) {
       // skip null positions
       if (nulls && bits::isBitNull(nulls, i)) {
         continue;
@@ -143,6 +146,50 @@ class RleDecoderV2 : public IntDecoder<isSigned> {
     return ret;
   }
 
+  // Unpacks up to 'len' values of 'fb' bits that are entirely in the
+  // current buffer, starting at the unread bits of 'curByte'. Returns the
+  // number of values unpacked.
+  uint64_t unpackBuffered(int64_t* data, uint64_t len, uint64_t fb) {
+    auto start = reinterpret_cast<const uint8_t*>(
+        IntDecoder<isSigned>::bufferStart);
+    if (!start) {
+      return 0;
+    }
+    uint64_t bitOffset = 0;
+    if (bitsLeft > 0) {
+      // 'curByte' is the last byte read from the buffer.
+      --start;
+      bitOffset = 8 - bitsLeft;
+    }
+    const int64_t available =
+        reinterpret_cast<const uint8_t*>(IntDecoder<isSigned>::bufferEnd) -
+        start - kBitUnpackPadding;
+    if (available <= 0) {
+      return 0;
+    }
+    const auto numValues = std::min<uint64_t>(
+        len, (static_cast<uint64_t>(available) * 8 - bitOffset) / fb);
+    if (numValues == 0) {
+      return 0;
+    }
+    unpackBitsBigEndian(
+        start,
+        bitOffset,
+        fb,
+        numValues,
+        reinterpret_cast<uint64_t*>(data));
+    const auto endBit = bitOffset + numValues * fb;
+    auto end = start + endBit / 8;
+    if (endBit % 8) {
+      curByte = *end++;
+      bitsLeft = 8 - endBit % 8;
+    } else {
+      bitsLeft = 0;
+    }
+    IntDecoder<isSigned>::bufferStart = reinterpret_cast<const char*>(end);
+    return numValues;
+  }
+
   uint64_t nextShortRepeats(
       int64_t* data,
       uint64_t offset,
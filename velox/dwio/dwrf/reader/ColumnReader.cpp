@@ -19,12 +19,14 @@
 #include "velox/dwio/common/exception/Exceptions.h"
 #include "velox/dwio/dwrf/common/IntCodecCommon.h"
 #include "velox/dwio/dwrf/common/IntDecoder.h"
+#include "velox/dwio/dwrf/common/RLEv1.h"
 #include "velox/dwio/dwrf/reader/ConstantColumnReader.h"
 #include "velox/dwio/dwrf/reader/FlatMapColumnReader.h"
 #include "velox/type/Type.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/DictionaryVector.h"
 #include "velox/vector/FlatVector.h"
+#include "velox/vector/SequenceVector.h"
 
 #include <folly/Likely.h>
 #include <folly/Portability.h>
@@ -44,29 +46,38 @@ std::array<char, 1> EMPTY_DICT;
 
 namespace detail {
 
+namespace {
+// Multiplier of an encoded nanos value for each value of its low 3 bits. 0
+// means no trailing zeros were dropped and 'n' > 0 means n + 1 zeros.
+constexpr uint64_t kNanosScale[8] = {
+    1, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000};
+
+FOLLY_ALWAYS_INLINE Timestamp makeTimestamp(int64_t seconds, uint64_t nanos) {
+  nanos = (nanos >> 3) * kNanosScale[nanos & 7];
+  seconds += EPOCH_OFFSET;
+  // Negative times with a fraction count down from the previous second.
+  seconds -= seconds < 0 && nanos != 0;
+  return Timestamp(seconds, nanos);
+}
+} // namespace
+
 void fillTimestamps(
     Timestamp* timestamps,
     const uint64_t* nullsPtr,
     const int64_t* secondsPtr,
     const uint64_t* nanosPtr,
     vector_size_t numValues) {
-  for (vector_size_t i = 0; i < numValues; i++) {
-    if (!nullsPtr || !bits::isBitNull(nullsPtr, i)) {
-      auto nanos = nanosPtr[i];
-      uint64_t zeros = nanos & 0x7;
-      nanos >>= 3;
-      if (zeros != 0) {
-        for (uint64_t j = 0; j <= zeros; ++j) {
-          nanos *= 10;
-        }
-      }
-      auto seconds = secondsPtr[i] + EPOCH_OFFSET;
-      if (seconds < 0 && nanos != 0) {
-        seconds -= 1;
-      }
-      timestamps[i] = Timestamp(seconds, nanos);
+  // Without nulls the loop has no branches, so that the compiler can
+  // vectorize it. With nulls only the non-null rows are converted.
+  if (!nullsPtr) {
+    for (vector_size_t i = 0; i < numValues; i++) {
+      timestamps[i] = makeTimestamp(secondsPtr[i], nanosPtr[i]);
     }
+    return;
   }
+  bits::forEachSetBit(nullsPtr, 0, numValues, [&](vector_size_t i) {
+    timestamps[i] = makeTimestamp(secondsPtr[i], nanosPtr[i]);
+  });
 }
 
 } // namespace detail
@@ -335,7 +346,18 @@ void nextValues(
 template <class ReqT>
 class IntegerDirectColumnReader : public ColumnReader {
  private:
+  // A batch is returned as a SequenceVector if its runs are on the average
+  // at least this long.
+  static constexpr int32_t kMinAverageRunLength = 4;
+
   std::unique_ptr<IntDecoder</*isSigned*/ true>> ints;
+  // Set to 'ints' if it is RLE v1 and SequenceVectors may be returned.
+  RleDecoderV1</*isSigned*/ true>* rleV1_{nullptr};
+  std::vector<int64_t> runValues_;
+  std::vector<int32_t> runLengths_;
+
+  // Makes a SequenceVector of 'numValues' rows from the decoded runs.
+  VectorPtr makeSequence(uint64_t numValues);
 
  public:
   IntegerDirectColumnReader(
@@ -369,9 +391,31 @@ IntegerDirectColumnReader<ReqT>::IntegerDirectColumnReader(
     RleVersion vers = convertRleVersion(encoding.kind());
     ints = IntDecoder</*isSigned*/ true>::createRle(
         stripe.getStream(data, true), vers, memoryPool_, dataVInts, numBytes);
+    if (vers == RleVersion_1 &&
+        stripe.getRowReaderOptions().getReturnSequenceVectors()) {
+      rleV1_ = dynamic_cast<RleDecoderV1</*isSigned*/ true>*>(ints.get());
+    }
   }
 }
 
+template <class ReqT>
+VectorPtr IntegerDirectColumnReader<ReqT>::makeSequence(uint64_t numValues) {
+  const auto numRuns = runValues_.size();
+  auto values = AlignedBuffer::allocate<ReqT>(numRuns, &memoryPool_);
+  auto lengths = AlignedBuffer::allocate<vector_size_t>(numRuns, &memoryPool_);
+  auto* rawValues = values->asMutable<ReqT>();
+  auto* rawLengths = lengths->asMutable<vector_size_t>();
+  for (auto i = 0; i < numRuns; ++i) {
+    rawValues[i] = static_cast<ReqT>(runValues_[i]);
+    rawLengths[i] = runLengths_[i];
+  }
+  return std::make_shared<SequenceVector<ReqT>>(
+      &memoryPool_,
+      numValues,
+      makeFlatVector<ReqT>(&memoryPool_, nullptr, 0, numRuns, values),
+      std::move(lengths));
+}
+
 template <class ReqT>
 uint64_t IntegerDirectColumnReader<ReqT>::skip(uint64_t numValues) {
   numValues = ColumnReader::skip(numValues);
@@ -384,6 +428,19 @@ void IntegerDirectColumnReader<ReqT>::next(
     uint64_t numValues,
     VectorPtr& result,
     const uint64_t* incomingNulls) {
+  // Runs are decoded only when there are no nulls. Batches with short runs
+  // are expanded into a flat vector.
+  const bool readRuns = rleV1_ && !notNullDecoder_ && !incomingNulls;
+  if (readRuns) {
+    runValues_.clear();
+    runLengths_.clear();
+    rleV1_->nextRuns(numValues, runValues_, runLengths_);
+    if (runValues_.size() * kMinAverageRunLength <= numValues) {
+      result = makeSequence(numValues);
+      return;
+    }
+  }
+
   auto flatVector = resetIfWrongFlatVectorType<ReqT>(result);
   BufferPtr values;
   if (flatVector) {
@@ -409,7 +466,18 @@ void IntegerDirectColumnReader<ReqT>::next(
         makeFlatVector<ReqT>(&memoryPool_, nulls, nullCount, numValues, values);
   }
 
-  nextValues(*ints, values->asMutable<ReqT>(), numValues, nullsPtr);
+  if (readRuns) {
+    auto* rawValues = values->asMutable<ReqT>();
+    for (auto i = 0; i < runValues_.size(); ++i) {
+      std::fill(
+          rawValues,
+          rawValues + runLengths_[i],
+          static_cast<ReqT>(runValues_[i]));
+      rawValues += runLengths_[i];
+    }
+  } else {
+    nextValues(*ints, values->asMutable<ReqT>(), numValues, nullsPtr);
+  }
 }
 
 template <class ReqT>
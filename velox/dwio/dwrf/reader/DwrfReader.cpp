@@ -34,6 +34,13 @@ std::unique_ptr<DwrfRowReader> DwrfReader::createDwrfRowReader(
   return std::make_unique<DwrfRowReader>(readerBase_, opts);
 }
 
+DwrfRowReader::~DwrfRowReader() {
+  // The stripes being decoded refer to the memory pool of the reader.
+  for (auto& source : decodingStripes_) {
+    source->close();
+  }
+}
+
 void DwrfRowReader::checkSkipStrides(
     const StatsContext& context,
     uint64_t strideSize) {
@@ -71,20 +78,124 @@ void DwrfRowReader::checkSkipStrides(
   }
 }
 
+void DwrfRowReader::setPreviousRowAtEnd() {
+  if (lastStripe > 0) {
+    previousRow = firstRowOfStripe[lastStripe - 1] +
+        getReader().getFooter().stripes(lastStripe - 1).numberofrows();
+  } else {
+    previousRow = 0;
+  }
+}
+
+void DwrfRowReader::applyRowLimit() {
+  const auto rowLimit = options_.getRowLimit();
+  const auto scanSpec = options_.getScanSpec();
+  if (rowLimit == std::numeric_limits<uint64_t>::max() ||
+      (scanSpec && scanSpec->hasFilter())) {
+    return;
+  }
+  auto& footer = getReader().getFooter();
+  uint64_t numRows = 0;
+  for (auto stripe = currentStripe; stripe < lastStripe; ++stripe) {
+    numRows += footer.stripes(stripe).numberofrows();
+    if (numRows >= rowLimit) {
+      uncappedLastStripe_ = lastStripe;
+      lastStripe = stripe + 1;
+      return;
+    }
+  }
+}
+
+bool DwrfRowReader::canDecodeAhead() const {
+  // Value hooks are called on the thread that decodes.
+  return options_.getDecodeStripesAhead() > 0 &&
+      options_.getDecodingExecutor() && options_.getScanSpec() &&
+      !options_.getScanSpec()->hasValueHook() &&
+      lastStripe > currentStripe + 1;
+}
+
+void DwrfRowReader::scheduleStripes(uint64_t batchSize) {
+  nextStripeToDecode_ = std::max(nextStripeToDecode_, currentStripe);
+  auto& footer = getReader().getFooter();
+  const size_t maxStripes = options_.getDecodeStripesAhead();
+  while (decodingStripes_.size() < maxStripes &&
+         nextStripeToDecode_ < lastStripe) {
+    auto options = options_;
+    options.range(footer.stripes(nextStripeToDecode_).offset(), 1);
+    options.setScanSpec(options_.getScanSpec()->clone());
+    options.setDecodeStripesAhead(0);
+    options.setRowLimit(std::numeric_limits<uint64_t>::max());
+    auto source = std::make_shared<AsyncSource<DecodedStripe>>(
+        [reader = readerBaseShared(), options, batchSize]() {
+          auto decoded = std::make_unique<DecodedStripe>();
+          try {
+            DwrfRowReader rowReader(reader, options);
+            VectorPtr batch;
+            while (auto numRows = rowReader.next(batchSize, batch)) {
+              decoded->batches.emplace_back(numRows, std::move(batch));
+            }
+            dwio::common::RuntimeStatistics stats;
+            rowReader.updateRuntimeStats(stats);
+            decoded->skippedStrides = stats.skippedStrides;
+          } catch (...) {
+            decoded->error = std::current_exception();
+          }
+          return decoded;
+        });
+    options_.getDecodingExecutor()->add([source]() { source->prepare(); });
+    decodingStripes_.push_back(std::move(source));
+    ++nextStripeToDecode_;
+  }
+}
+
+uint64_t DwrfRowReader::nextDecoded(uint64_t size, VectorPtr& result) {
+  for (;;) {
+    if (currentStripe >= lastStripe) {
+      setPreviousRowAtEnd();
+      return 0;
+    }
+    if (!decodedStripe_) {
+      scheduleStripes(size);
+      auto source = std::move(decodingStripes_.front());
+      decodingStripes_.pop_front();
+      scheduleStripes(size);
+      decodedStripe_ = source->move();
+      VELOX_CHECK_NOT_NULL(decodedStripe_);
+      if (decodedStripe_->error) {
+        std::rethrow_exception(decodedStripe_->error);
+      }
+      skippedStrides_ += decodedStripe_->skippedStrides;
+      nextDecodedBatch_ = 0;
+    }
+    if (nextDecodedBatch_ < decodedStripe_->batches.size()) {
+      auto& batch = decodedStripe_->batches[nextDecodedBatch_++];
+      previousRow = firstRowOfStripe[currentStripe] + currentRowInStripe;
+      currentRowInStripe += batch.first;
+      result = std::move(batch.second);
+      return batch.first;
+    }
+    decodedStripe_.reset();
+    currentStripe += 1;
+    currentRowInStripe = 0;
+  }
+}
+
 uint64_t DwrfRowReader::next(uint64_t size, VectorPtr& result) {
   DWIO_ENSURE_GT(size, 0);
+  if (!decodeAhead_.has_value()) {
+    applyRowLimit();
+    decodeAhead_ = canDecodeAhead();
+  }
+  if (decodeAhead_.value()) {
+    return nextDecoded(size, result);
+  }
   auto& footer = getReader().getFooter();
   StatsContext context(
       getReader().getWriterName(), getReader().getWriterVersion());
 
   for (;;) {
     if (currentStripe >= lastStripe) {
-      if (lastStripe > 0) {
-        previousRow = firstRowOfStripe[lastStripe - 1] +
-            footer.stripes(lastStripe - 1).numberofrows();
-      } else {
-        previousRow = 0;
-      }
+      setPreviousRowAtEnd();
       return 0;
     }
 
@@ -130,8 +241,17 @@ uint64_t DwrfRowReader::next(uint64_t size, VectorPtr& result) {
 }
 
 void DwrfRowReader::resetFilterCaches() {
-  dynamic_cast<SelectiveColumnReader*>(columnReader())->resetFilterCaches();
+  // Stripes decoded ahead have no column reader here. Stripes scheduled
+  // after this get the new filters.
+  if (columnReader_) {
+    dynamic_cast<SelectiveColumnReader*>(columnReader())->resetFilterCaches();
+  }
   recomputeStridesToSkip_ = true;
+  // The row limit counts rows before filters.
+  if (uncappedLastStripe_.has_value()) {
+    lastStripe = uncappedLastStripe_.value();
+    uncappedLastStripe_.reset();
+  }
 }
 
 std::unique_ptr<DwrfReader> DwrfReader::create(
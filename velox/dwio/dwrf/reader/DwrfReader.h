@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <deque>
+
+#include "velox/common/base/AsyncSource.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/dwio/dwrf/reader/ColumnReader.h"
 #include "velox/dwio/dwrf/reader/DwrfReaderShared.h"
@@ -52,7 +55,7 @@ class DwrfRowReader : public DwrfRowReaderShared {
       const dwio::common::RowReaderOptions& options)
       : DwrfRowReaderShared{reader, options} {}
 
-  ~DwrfRowReader() override = default;
+  ~DwrfRowReader() override;
 
   // Returns number of rows read. Guaranteed to be less then or equal to size.
   uint64_t next(uint64_t size, VectorPtr& result) override;
@@ -78,8 +81,36 @@ class DwrfRowReader : public DwrfRowReaderShared {
   }
 
  private:
+  // The results of reading a whole stripe with a separate reader.
+  struct DecodedStripe {
+    // Number of rows read and the result of each next().
+    std::vector<std::pair<uint64_t, VectorPtr>> batches;
+    int64_t skippedStrides{0};
+    std::exception_ptr error;
+  };
+
   void checkSkipStrides(const StatsContext& context, uint64_t strideSize);
 
+  // Sets 'previousRow' after the last row of the range being read.
+  void setPreviousRowAtEnd();
+
+  // Ends the range after the stripe with the last row of the row limit of
+  // the options. Rows are counted before filters, so this applies only to a
+  // ScanSpec without filters.
+  void applyRowLimit();
+
+  // True if the options ask for decoding stripes ahead and the ScanSpec
+  // can be copied for that.
+  bool canDecodeAhead() const;
+
+  // Starts decoding stripes on the decoding executor until the configured
+  // number is in progress or decoded.
+  void scheduleStripes(uint64_t batchSize);
+
+  // next() when decoding stripes ahead. Returns the batches of the stripes
+  // in order.
+  uint64_t nextDecoded(uint64_t size, VectorPtr& result);
+
   std::unique_ptr<ColumnReader> columnReader_;
   std::vector<uint32_t> stridesToSkip_;
   // Record of strides to skip in each visited stripe. Used for diagnostics.
@@ -91,6 +122,19 @@ class DwrfRowReader : public DwrfRowReaderShared {
   // filter. Causes filters to be re-evaluated against stride stats on
   // next stride instead of next stripe.
   bool recomputeStridesToSkip_{false};
+
+  // Set on first next() to whether stripes are decoded ahead.
+  std::optional<bool> decodeAhead_;
+  // The end of the range before applyRowLimit(). Restored when a filter is
+  // added.
+  std::optional<uint32_t> uncappedLastStripe_;
+  // Stripes being decoded on the decoding executor, in stripe order.
+  std::deque<std::shared_ptr<AsyncSource<DecodedStripe>>> decodingStripes_;
+  // The next stripe to schedule for decoding.
+  uint32_t nextStripeToDecode_{0};
+  // The stripe whose batches are being returned and the next one to return.
+  std::unique_ptr<DecodedStripe> decodedStripe_;
+  size_t nextDecodedBatch_{0};
 };
 
 class DwrfReader : public DwrfReaderShared {
@@ -207,7 +207,8 @@ DwrfReaderShared::DwrfReaderShared(
               : dwio::common::BufferedInputFactory::baseFactoryShared(),
           options.getFileNum(),
           options.getFileFormat() == FileFormat::ORC ? FileFormat::ORC
-                                                     : FileFormat::DWRF)),
+                                                     : FileFormat::DWRF,
+          options.getFileTailCacheKey())),
       options_(options) {}
 
 std::unique_ptr<StripeInformation> DwrfReaderShared::getStripe(
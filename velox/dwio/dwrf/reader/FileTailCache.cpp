@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/reader/FileTailCache.h"
+
+#include <gflags/gflags.h>
+
+DEFINE_int32(
+    file_tail_cache_mb,
+    256,
+    "Memory for the footers of DWRF files kept for reopening the files.");
+
+namespace facebook::velox::dwrf {
+
+std::shared_ptr<const FileTail> FileTailCache::find(const std::string& key) {
+  return cache_.withWLock([&](auto& cache) -> std::shared_ptr<const FileTail> {
+    auto entry = cache.get(key);
+    if (!entry) {
+      return nullptr;
+    }
+    auto tail = *entry;
+    cache.release(key);
+    return tail;
+  });
+}
+
+void FileTailCache::insert(
+    const std::string& key,
+    std::shared_ptr<const FileTail> tail) {
+  const auto size = tail->size();
+  auto entry = std::make_unique<std::shared_ptr<const FileTail>>(tail);
+  cache_.withWLock([&](auto& cache) {
+    if (cache.add(key, entry.get(), size)) {
+      entry.release();
+    }
+  });
+}
+
+// static
+FileTailCache& FileTailCache::instance() {
+  static FileTailCache cache(
+      static_cast<int64_t>(FLAGS_file_tail_cache_mb) << 20);
+  return cache;
+}
+
+} // namespace facebook::velox::dwrf
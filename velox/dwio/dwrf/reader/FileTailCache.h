@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <memory>
+#include <string>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/dwio/dwrf/common/Common.h"
+#include "velox/type/Type.h"
+
+namespace facebook::velox::dwrf {
+
+// The parsed tail of a DWRF or ORC file: the PostScript, the footer and the
+// stripe metadata cache. Immutable once made and shared by the ReaderBases
+// of the file.
+struct FileTail {
+  uint64_t fileLength;
+  uint64_t psLength;
+  PostScript postScript;
+  // Owns 'footer'.
+  std::unique_ptr<google::protobuf::Arena> arena;
+  proto::Footer* footer;
+  RowTypePtr schema;
+  // The stripe metadata cache, empty if the file has none.
+  std::string stripeCache;
+
+  // Approximate memory held by 'this'.
+  uint64_t size() const {
+    return sizeof(FileTail) + arena->SpaceAllocated() + stripeCache.size();
+  }
+};
+
+// Process wide cache of FileTails, limited to a total size. The key
+// identifies one version of a file, e.g. path, modification time and size,
+// see ReaderOptions::setFileTailCacheKey(). Reopening a file found here
+// costs no IO or parsing of the footer.
+class FileTailCache {
+ public:
+  explicit FileTailCache(int64_t maxBytes) : cache_(maxBytes) {}
+
+  // Returns the tail for 'key' or nullptr if it is not cached.
+  std::shared_ptr<const FileTail> find(const std::string& key);
+
+  void insert(const std::string& key, std::shared_ptr<const FileTail> tail);
+
+  static FileTailCache& instance();
+
+ private:
+  folly::Synchronized<
+      SimpleLRUCache<std::string, std::shared_ptr<const FileTail>>>
+      cache_;
+};
+
+} // namespace facebook::velox::dwrf
@@ -47,8 +47,6 @@ StringKeyBuffer::StringKeyBuffer(
   data_[ordinal] = data;
 }
 
-namespace {
-
 template <typename T>
 KeyValue<T> extractKey(const proto::KeyInfo& info) {
   return KeyValue<T>(info.intkey());
@@ -69,6 +67,8 @@ KeyValue<StringView> parseKeyValue<StringView>(std::string_view str) {
   return KeyValue<StringView>(StringView(str));
 }
 
+namespace {
+
 template <typename T>
 struct KeyProjection {
   KeyProjectionMode mode = KeyProjectionMode::ALLOW;
@@ -220,17 +220,6 @@ ParsedKeyFilter<T> parseKeyFilter(
       .keys = std::move(keys)};
 }
 
-template <typename T>
-KeyPredicate<T> prepareKeyPredicate(
-    const std::shared_ptr<const TypeWithId>& requestedType,
-    StripeStreams& stripe) {
-  auto parsedKeyFilter = parseKeyFilter<T>(requestedType, stripe);
-  return KeyPredicate<T>(
-      parsedKeyFilter.mode,
-      typename KeyPredicate<T>::Lookup(
-          parsedKeyFilter.keys.begin(), parsedKeyFilter.keys.end()));
-}
-
 template <typename T>
 std::vector<std::unique_ptr<KeyNode<T>>> rearrangeKeyNodesAsProjectedOrder(
     std::vector<std::unique_ptr<KeyNode<T>>>& availableKeyNodes,
@@ -254,6 +243,17 @@ std::vector<std::unique_ptr<KeyNode<T>>> rearrangeKeyNodesAsProjectedOrder(
 }
 } // namespace
 
+template <typename T>
+KeyPredicate<T> prepareKeyPredicate(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    StripeStreams& stripe) {
+  auto parsedKeyFilter = parseKeyFilter<T>(requestedType, stripe);
+  return KeyPredicate<T>(
+      parsedKeyFilter.mode,
+      typename KeyPredicate<T>::Lookup(
+          parsedKeyFilter.keys.begin(), parsedKeyFilter.keys.end()));
+}
+
 template <typename T>
 FlatMapColumnReader<T>::FlatMapColumnReader(
     const std::shared_ptr<const TypeWithId>& requestedType,
@@ -756,6 +756,32 @@ std::unique_ptr<ColumnReader> createFlatMapColumnReader(
   }
 }
 
+template KeyValue<int8_t> extractKey<int8_t>(const proto::KeyInfo&);
+template KeyValue<int16_t> extractKey<int16_t>(const proto::KeyInfo&);
+template KeyValue<int32_t> extractKey<int32_t>(const proto::KeyInfo&);
+template KeyValue<int64_t> extractKey<int64_t>(const proto::KeyInfo&);
+
+template KeyValue<int8_t> parseKeyValue<int8_t>(std::string_view);
+template KeyValue<int16_t> parseKeyValue<int16_t>(std::string_view);
+template KeyValue<int32_t> parseKeyValue<int32_t>(std::string_view);
+template KeyValue<int64_t> parseKeyValue<int64_t>(std::string_view);
+
+template KeyPredicate<int8_t> prepareKeyPredicate<int8_t>(
+    const std::shared_ptr<const TypeWithId>&,
+    StripeStreams&);
+template KeyPredicate<int16_t> prepareKeyPredicate<int16_t>(
+    const std::shared_ptr<const TypeWithId>&,
+    StripeStreams&);
+template KeyPredicate<int32_t> prepareKeyPredicate<int32_t>(
+    const std::shared_ptr<const TypeWithId>&,
+    StripeStreams&);
+template KeyPredicate<int64_t> prepareKeyPredicate<int64_t>(
+    const std::shared_ptr<const TypeWithId>&,
+    StripeStreams&);
+template KeyPredicate<StringView> prepareKeyPredicate<StringView>(
+    const std::shared_ptr<const TypeWithId>&,
+    StripeStreams&);
+
 // declare all possible flat map column reader
 template class FlatMapColumnReader<int8_t>;
 template class FlatMapColumnReader<int16_t>;
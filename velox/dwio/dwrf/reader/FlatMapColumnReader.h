@@ -198,6 +198,27 @@ class KeyPredicate {
   std::function<bool(const KeyValue<T>&, const Lookup&)> predicate_;
 };
 
+// Returns the key of the value streams described by 'info'.
+template <typename T>
+KeyValue<T> extractKey(const proto::KeyInfo& info);
+
+template <>
+KeyValue<StringView> extractKey<StringView>(const proto::KeyInfo& info);
+
+// Parses a key given as text, e.g. in a key filter or a subfield.
+template <typename T>
+KeyValue<T> parseKeyValue(std::string_view str);
+
+template <>
+KeyValue<StringView> parseKeyValue<StringView>(std::string_view str);
+
+// Returns the predicate for the keys selected by the column selector
+// expression of 'requestedType'. Selects all keys if there is none.
+template <typename T>
+KeyPredicate<T> prepareKeyPredicate(
+    const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+    StripeStreams& stripe);
+
 template <typename T>
 class FlatMapColumnReader : public ColumnReader {
  public:
@@ -92,7 +92,8 @@ ReaderBase::ReaderBase(
     std::shared_ptr<DecrypterFactory> decryptorFactory,
     std::shared_ptr<dwio::common::BufferedInputFactory> bufferedInputFactory,
     uint64_t fileNum,
-    FileFormat fileFormat)
+    FileFormat fileFormat,
+    const std::string& fileTailCacheKey)
     : pool_{pool},
       stream_{std::move(stream)},
       arena_(std::make_unique<google::protobuf::Arena>()),
@@ -104,12 +105,61 @@ ReaderBase::ReaderBase(
               : dwio::common::BufferedInputFactory::baseFactoryShared()) {
   input_ = bufferedInputFactory_->create(*stream_, pool, fileNum);
 
-  // read last bytes into buffer to get PostScript
-  // If file is small, load the entire file.
-  // TODO: make a config
   fileLength_ = stream_->getLength();
   DWIO_ENSURE(fileLength_ > 0, "ORC file is empty");
 
+  std::shared_ptr<const FileTail> tail;
+  if (!fileTailCacheKey.empty()) {
+    tail = FileTailCache::instance().find(fileTailCacheKey);
+  }
+  if (tail && tail->fileLength == fileLength_) {
+    // A small file is still read whole, since its stripes come next.
+    if (fileLength_ <= FILE_PRELOAD_THRESHOLD) {
+      input_->enqueue({0, fileLength_});
+      input_->load(LogType::FILE);
+    }
+  } else {
+    tail = readTail(fileFormat);
+    if (!fileTailCacheKey.empty()) {
+      FileTailCache::instance().insert(fileTailCacheKey, tail);
+    }
+  }
+  tail_ = tail;
+  psLength_ = tail_->psLength;
+  postScript_ = std::make_unique<PostScript>(tail_->postScript);
+  footer_ = tail_->footer;
+  schema_ = tail_->schema;
+
+  // load stripe index/footer cache
+  if (!tail_->stripeCache.empty()) {
+    const auto cacheSize = tail_->stripeCache.size();
+    auto cacheBuffer =
+        std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
+    std::memcpy(cacheBuffer->data(), tail_->stripeCache.data(), cacheSize);
+    cache_ = std::make_unique<StripeMetadataCache>(
+        postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
+  }
+
+  if (input_->shouldPrefetchStripes()) {
+    auto numStripes = getFooter().stripes_size();
+    for (auto i = 0; i < numStripes; i++) {
+      const auto& stripe = getFooter().stripes(i);
+      input_->enqueue(
+          {stripe.offset() + stripe.indexlength() + stripe.datalength(),
+           stripe.footerlength()});
+    }
+    if (numStripes) {
+      input_->load(LogType::FOOTER);
+    }
+  }
+  // initialize file decrypter
+  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+}
+
+std::shared_ptr<const FileTail> ReaderBase::readTail(FileFormat fileFormat) {
+  // read last bytes into buffer to get PostScript
+  // If file is small, load the entire file.
+  // TODO: make a config
   auto preloadFile = fileLength_ <= FILE_PRELOAD_THRESHOLD;
   uint64_t readSize =
       preloadFile ? fileLength_ : std::min(fileLength_, DIRECTORY_SIZE_GUESS);
@@ -174,39 +224,31 @@ ReaderBase::ReaderBase(
 
   auto footerStream = input_->read(
       fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
-  footer_ = google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
+  auto arena = std::make_unique<google::protobuf::Arena>();
+  auto footer =
+      google::protobuf::Arena::CreateMessage<proto::Footer>(arena.get());
   ProtoUtils::readProtoInto<proto::Footer>(
       createDecompressedStream(std::move(footerStream), "File Footer"),
-      footer_);
+      footer);
 
-  schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*footer_));
-  DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
+  auto schema = std::dynamic_pointer_cast<const RowType>(convertType(*footer));
+  DWIO_ENSURE_NOT_NULL(schema, "invalid schema");
 
-  // load stripe index/footer cache
+  std::string stripeCache;
   if (cacheSize > 0) {
     DWIO_ENSURE_EQ(getFileFormat(), FileFormat::DWRF);
-    auto cacheBuffer =
-        std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
+    stripeCache.resize(cacheSize);
     input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
-        ->readFully(cacheBuffer->data(), cacheSize);
-    cache_ = std::make_unique<StripeMetadataCache>(
-        postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
-  }
-
-  if (input_->shouldPrefetchStripes()) {
-    auto numStripes = getFooter().stripes_size();
-    for (auto i = 0; i < numStripes; i++) {
-      const auto& stripe = getFooter().stripes(i);
-      input_->enqueue(
-          {stripe.offset() + stripe.indexlength() + stripe.datalength(),
-           stripe.footerlength()});
-    }
-    if (numStripes) {
-      input_->load(LogType::FOOTER);
-    }
+        ->readFully(stripeCache.data(), cacheSize);
   }
-  // initialize file decrypter
-  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+  return std::make_shared<const FileTail>(FileTail{
+      fileLength_,
+      psLength_,
+      *postScript_,
+      std::move(arena),
+      footer,
+      std::move(schema),
+      std::move(stripeCache)});
 }
 
 std::vector<uint64_t> ReaderBase::getRowsPerStripe() const {
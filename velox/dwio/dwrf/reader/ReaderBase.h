@@ -22,6 +22,7 @@
 #include "velox/dwio/common/TypeWithId.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/common/Statistics.h"
+#include "velox/dwio/dwrf/reader/FileTailCache.h"
 #include "velox/dwio/dwrf/reader/StripeMetadataCache.h"
 #include "velox/dwio/dwrf/utils/ProtoUtils.h"
 
@@ -63,7 +64,9 @@ class ReaderBase {
       std::numeric_limits<uint64_t>::max();
 
  public:
-  // create reader base from input stream
+  // create reader base from input stream. If 'fileTailCacheKey' is not
+  // empty, the tail of the file comes from FileTailCache if it is there and
+  // is added to it otherwise.
   ReaderBase(
       memory::MemoryPool& pool,
       std::unique_ptr<dwio::common::InputStream> stream,
@@ -72,7 +75,8 @@ class ReaderBase {
       std::shared_ptr<dwio::common::BufferedInputFactory> bufferedInputFactory =
           nullptr,
       uint64_t fileNum = kDefaultFileNum,
-      dwio::common::FileFormat fileFormat = dwio::common::FileFormat::DWRF);
+      dwio::common::FileFormat fileFormat = dwio::common::FileFormat::DWRF,
+      const std::string& fileTailCacheKey = "");
 
   ReaderBase(
       memory::MemoryPool& pool,
@@ -236,6 +240,11 @@ class ReaderBase {
   }
 
  private:
+  // Reads and parses the PostScript, footer and stripe metadata cache at the
+  // end of the file. Sets 'postScript_' and 'psLength_'.
+  std::shared_ptr<const FileTail> readTail(
+      dwio::common::FileFormat fileFormat);
+
   static std::shared_ptr<const Type> convertType(
       const proto::Footer& footer,
       uint32_t index = 0);
@@ -245,6 +254,8 @@ class ReaderBase {
   std::unique_ptr<google::protobuf::Arena> arena_;
   std::unique_ptr<PostScript> postScript_;
 
+  // Owns 'footer_' if set. May be shared with other readers of the file.
+  std::shared_ptr<const FileTail> tail_;
   proto::Footer* footer_ = nullptr;
   uint64_t fileNum_;
   std::unique_ptr<StripeMetadataCache> cache_;
@@ -55,6 +55,10 @@ class SelectiveByteRleColumnReader : public SelectiveColumnReader {
     auto positions = toPositions(index_->entry(index));
     dwio::common::PositionProvider positionsProvider(positions);
 
+    if (flatMapContext_.inMapDecoder) {
+      flatMapContext_.inMapDecoder->seekToRowGroup(positionsProvider);
+    }
+
     if (notNullDecoder_) {
       notNullDecoder_->seekToRowGroup(positionsProvider);
     }
@@ -17,6 +17,7 @@
 #include "velox/dwio/dwrf/reader/SelectiveByteRleColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveColumnReaderInternal.h"
 
+#include "velox/dwio/dwrf/reader/SelectiveFlatMapColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveFloatingPointColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveIntegerDictionaryColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveIntegerDirectColumnReader.h"
@@ -28,11 +29,73 @@
 #include "velox/dwio/dwrf/reader/SelectiveRepeatedColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveStructColumnReader.h"
 
+#include <gflags/gflags.h>
+
+DEFINE_int32(
+    max_prefilled_dictionary_entries,
+    10'000,
+    "Largest DWRF dictionary whose filter results are computed when the "
+    "dictionary is loaded. 0 leaves all filter results to the first use.");
+
 namespace facebook::velox::dwrf {
 
 using dwio::common::TypeWithId;
 using dwio::common::typeutils::CompatChecker;
 
+namespace {
+// Returns false if 'filter' passes only values that are all absent from
+// 'bloomFilter'. Returns true if the filter is not a set of point values.
+bool testBloomFilter(
+    const common::Filter& filter,
+    const BloomFilter& bloomFilter) {
+  if (filter.testNull()) {
+    return true;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      auto range = static_cast<const common::BigintRange*>(&filter);
+      return !range->isSingleValue() || bloomFilter.testLong(range->lower());
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable: {
+      auto values =
+          static_cast<const common::BigintValuesUsingHashTable*>(&filter);
+      for (auto value : values->values()) {
+        if (bloomFilter.testLong(value)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case common::FilterKind::kBigintValuesUsingBitmask: {
+      auto values =
+          static_cast<const common::BigintValuesUsingBitmask*>(&filter);
+      for (auto value : values->values()) {
+        if (bloomFilter.testLong(value)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case common::FilterKind::kBytesRange: {
+      auto range = static_cast<const common::BytesRange*>(&filter);
+      return !range->isSingleValue() ||
+          bloomFilter.testBytes(range->lower().data(), range->lower().size());
+    }
+    case common::FilterKind::kBytesValues: {
+      auto values = static_cast<const common::BytesValues*>(&filter);
+      for (const auto& value : values->values()) {
+        if (bloomFilter.testBytes(value.data(), value.size())) {
+          return true;
+        }
+      }
+      return false;
+    }
+    default:
+      return true;
+  }
+}
+} // namespace
+
 common::AlwaysTrue& alwaysTrue() {
   static common::AlwaysTrue alwaysTrue;
   return alwaysTrue;
@@ -73,6 +136,8 @@ SelectiveColumnReader::SelectiveColumnReader(
   // time pushdown.
   indexStream_ = stripe.getStream(
       encodingKey.forKind(proto::Stream_Kind_ROW_INDEX), false);
+  bloomFilterStream_ = stripe.getStream(
+      encodingKey.forKind(proto::Stream_Kind_BLOOM_FILTER_UTF8), false);
 }
 
 std::vector<uint32_t> SelectiveColumnReader::filterRowGroups(
@@ -85,6 +150,7 @@ std::vector<uint32_t> SelectiveColumnReader::filterRowGroups(
   ensureRowGroupIndex();
   auto filter = scanSpec_->filter();
 
+  auto bloomFilters = bloomFilterIndex();
   std::vector<uint32_t> stridesToSkip;
   for (auto i = 0; i < index_->entry_size(); i++) {
     const auto& entry = index_->entry(i);
@@ -93,6 +159,12 @@ std::vector<uint32_t> SelectiveColumnReader::filterRowGroups(
     if (!testFilter(filter, columnStats.get(), rowGroupSize, type_)) {
       VLOG(1) << "Drop stride " << i << " on " << scanSpec_->toString();
       stridesToSkip.push_back(i); // Skipping stride based on column stats.
+    } else if (
+        bloomFilters && i < bloomFilters->bloomfilter_size() &&
+        !testBloomFilter(*filter, BloomFilter(bloomFilters->bloomfilter(i)))) {
+      VLOG(1) << "Drop stride " << i << " on bloom filter of "
+              << scanSpec_->toString();
+      stridesToSkip.push_back(i);
     }
   }
   return stridesToSkip;
@@ -329,6 +401,19 @@ void SelectiveColumnReader::addStringValue(folly::StringPiece value) {
       StringView(copy, value.size());
 }
 
+common::Filter* SelectiveColumnReader::filterForDictionary(
+    int32_t numValues) const {
+  // Bounds the up front work for a dictionary of which only a few entries
+  // may be referenced by the rows that are read.
+  auto filter = scanSpec_->filter();
+  if (!filter || !filter->isDeterministic() ||
+      filter->kind() == common::FilterKind::kAlwaysTrue ||
+      numValues > FLAGS_max_prefilled_dictionary_entries) {
+    return nullptr;
+  }
+  return filter;
+}
+
 void SelectiveColumnReader::resetFilterCaches() {
   if (!scanState_.filterCache.empty()) {
     simd::memset(
@@ -354,10 +439,20 @@ std::unique_ptr<SelectiveColumnReader> buildIntegerReader(
   switch (static_cast<int64_t>(stripe.getEncoding(ek).kind())) {
     case proto::ColumnEncoding_Kind_DICTIONARY:
       return std::make_unique<SelectiveIntegerDictionaryColumnReader>(
-          requestedType, dataType, stripe, scanSpec, numBytes);
+          requestedType,
+          dataType,
+          stripe,
+          scanSpec,
+          numBytes,
+          std::move(flatMapContext));
     case proto::ColumnEncoding_Kind_DIRECT:
       return std::make_unique<SelectiveIntegerDirectColumnReader>(
-          requestedType, dataType, stripe, numBytes, scanSpec);
+          requestedType,
+          dataType,
+          stripe,
+          numBytes,
+          scanSpec,
+          std::move(flatMapContext));
     default:
       DWIO_RAISE("buildReader unhandled integer encoding");
   }
@@ -403,7 +498,12 @@ std::unique_ptr<SelectiveColumnReader> SelectiveColumnReader::build(
     case TypeKind::MAP:
       if (stripe.getEncoding(ek).kind() ==
           proto::ColumnEncoding_Kind_MAP_FLAT) {
-        VELOX_UNSUPPORTED("SelectiveColumnReader does not support flat maps");
+        return createSelectiveFlatMapColumnReader(
+            requestedType,
+            dataType,
+            stripe,
+            scanSpec,
+            std::move(flatMapContext));
       }
       return std::make_unique<SelectiveMapColumnReader>(
           requestedType, dataType, stripe, scanSpec, std::move(flatMapContext));
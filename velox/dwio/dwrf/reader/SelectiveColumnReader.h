@@ -20,6 +20,7 @@
 #include "velox/common/process/ProcessBase.h"
 #include "velox/dwio/common/ColumnSelector.h"
 #include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 #include "velox/dwio/dwrf/reader/ColumnReader.h"
 #include "velox/type/Filter.h"
 
@@ -368,6 +369,13 @@ class SelectiveColumnReader : public ColumnReader {
   // copy.
   char* copyStringValue(folly::StringPiece value);
 
+  // Returns the filter to evaluate on every entry of a dictionary of
+  // 'numValues' entries when the dictionary is loaded, nullptr if the
+  // entries are evaluated on first use. Results for small dictionaries are
+  // cached up front so that the per row lookup in the filter cache never
+  // falls back to evaluating the filter.
+  common::Filter* FOLLY_NULLABLE filterForDictionary(int32_t numValues) const;
+
   void ensureRowGroupIndex() const {
     VELOX_CHECK(index_ || indexStream_, "Reader needs to have an index stream");
     if (indexStream_) {
@@ -375,6 +383,16 @@ class SelectiveColumnReader : public ColumnReader {
     }
   }
 
+  // Returns the bloom filters of the row groups or nullptr if the column
+  // has none.
+  const proto::BloomFilterIndex* FOLLY_NULLABLE bloomFilterIndex() const {
+    if (bloomFilterStream_) {
+      bloomFilterIndex_ = ProtoUtils::readProto<proto::BloomFilterIndex>(
+          std::move(bloomFilterStream_));
+    }
+    return bloomFilterIndex_.get();
+  }
+
   // Specification of filters, value extraction, pruning etc. The
   // spec is assigned at construction and the contents may change at
   // run time based on adaptation. Owned by caller.
@@ -382,6 +400,10 @@ class SelectiveColumnReader : public ColumnReader {
   TypePtr type_;
   mutable std::unique_ptr<dwio::common::SeekableInputStream> indexStream_;
   mutable std::unique_ptr<proto::RowIndex> index_;
+  // Present if the writer made bloom filters for the column.
+  mutable std::unique_ptr<dwio::common::SeekableInputStream>
+      bloomFilterStream_;
+  mutable std::unique_ptr<proto::BloomFilterIndex> bloomFilterIndex_;
   // Number of rows in a row group. Last row group may have fewer rows.
   uint32_t rowsPerRowGroup_;
 
@@ -0,0 +1,529 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/dwio/dwrf/reader/SelectiveFlatMapColumnReader.h"
+
+#include <algorithm>
+
+namespace facebook::velox::dwrf {
+
+using dwio::common::TypeWithId;
+
+namespace {
+
+constexpr const char* kKeysField = "keys";
+constexpr const char* kElementsField = "elements";
+
+bool isComplex(const Type& type) {
+  return type.isRow() || type.isArray() || type.isMap();
+}
+
+// Adds the specs that extract all of a value of 'type' to 'spec'. Struct
+// readers read only the fields that have a spec.
+void addFieldSpecs(const Type& type, common::ScanSpec& spec) {
+  auto addChild = [&](const std::string& name, const Type& childType) {
+    auto child = spec.getOrCreateChild(common::Subfield(name));
+    child->setProjectOut(true);
+    child->setExtractValues(true);
+    addFieldSpecs(childType, *child);
+    return child;
+  };
+  switch (type.kind()) {
+    case TypeKind::ROW: {
+      auto& rowType = type.asRow();
+      for (auto i = 0; i < rowType.size(); ++i) {
+        addChild(rowType.nameOf(i), *rowType.childAt(i))->setChannel(i);
+      }
+      break;
+    }
+    case TypeKind::MAP:
+      addChild(kKeysField, *type.childAt(0));
+      addChild(kElementsField, *type.childAt(1));
+      break;
+    case TypeKind::ARRAY:
+      addChild(kElementsField, *type.childAt(0));
+      break;
+    default:
+      break;
+  }
+}
+
+template <typename T>
+std::string keyName(const T& key) {
+  return folly::to<std::string>(key);
+}
+
+template <>
+std::string keyName(const StringView& key) {
+  return std::string(key);
+}
+
+} // namespace
+
+template <typename T>
+SelectiveFlatMapColumnReader<T>::SelectiveFlatMapColumnReader(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    StripeStreams& stripe,
+    common::ScanSpec* scanSpec,
+    FlatMapContext flatMapContext)
+    : SelectiveColumnReader(
+          dataType,
+          stripe,
+          scanSpec,
+          dataType->type,
+          std::move(flatMapContext)),
+      requestedType_{requestedType},
+      valueType_{requestedType->type->childAt(1)} {
+  DWIO_ENSURE_EQ(nodeType_->id, dataType->id, "working on the same node");
+  const auto& structKeys =
+      stripe.getRowReaderOptions().getMapColumnIdAsStruct();
+  auto structIt = structKeys.find(requestedType->id);
+  const bool asStruct = structIt != structKeys.end();
+
+  // The specs of single keys. A map also has specs for all keys and all
+  // values.
+  std::unordered_map<KeyValue<T>, const common::ScanSpec*, KeyValueHash<T>>
+      keySpecs;
+  bool isPruned = false;
+  for (auto& child : scanSpec->children()) {
+    if (!asStruct &&
+        (child->fieldName() == kKeysField ||
+         child->fieldName() == kElementsField)) {
+      continue;
+    }
+    keySpecs.emplace(parseKeyValue<T>(child->fieldName()), child.get());
+    isPruned |= child->keepValues();
+  }
+  std::unordered_map<KeyValue<T>, int32_t, KeyValueHash<T>> projectedKeys;
+  if (asStruct) {
+    for (auto i = 0; i < structIt->second.size(); ++i) {
+      projectedKeys.emplace(parseKeyValue<T>(structIt->second[i]), i);
+    }
+  }
+
+  const auto keyPredicate = prepareKeyPredicate<T>(requestedType, stripe);
+  const auto& dataValueType = dataType->childAt(1);
+  const auto& requestedValueType = requestedType->childAt(1);
+  std::unordered_set<uint32_t> processed;
+  stripe.visitStreamsOfNode(
+      dataValueType->id, [&](const StreamInformation& stream) {
+        auto sequence = stream.getSequence();
+        // The shared dictionary has sequence 0 and no key.
+        if (sequence == 0 || !processed.insert(sequence).second) {
+          return;
+        }
+        EncodingKey seqEk(dataValueType->id, sequence);
+        auto key = extractKey<T>(stripe.getEncoding(seqEk).key());
+        if (!keyPredicate(key)) {
+          return;
+        }
+        auto specIt = keySpecs.find(key);
+        auto* keySpec = specIt == keySpecs.end() ? nullptr : specIt->second;
+        bool isOutput = scanSpec_->keepValues() &&
+            (asStruct ? projectedKeys.count(key) > 0
+                      : !isPruned || (keySpec && keySpec->keepValues()));
+        if (!isOutput && !(keySpec && keySpec->hasFilter())) {
+          return;
+        }
+        auto inMap = stripe.getStream(
+            seqEk.forKind(proto::Stream_Kind_IN_MAP), true);
+        DWIO_ENSURE_NOT_NULL(inMap, "In map stream is required");
+        Key entry;
+        entry.value = key.get();
+        entry.name = keyName(key.get());
+        entry.sequence = sequence;
+        entry.isOutput = isOutput;
+        entry.scanSpec = makeKeySpec(entry.name, keySpec, isOutput);
+        entry.inMap = createBooleanRleDecoder(std::move(inMap), seqEk);
+        entry.reader = SelectiveColumnReader::build(
+            requestedValueType,
+            dataValueType,
+            stripe,
+            entry.scanSpec.get(),
+            FlatMapContext{sequence, entry.inMap.get()});
+        keys_.push_back(std::move(entry));
+      });
+
+  std::sort(keys_.begin(), keys_.end(), [](auto& left, auto& right) {
+    return left.sequence < right.sequence;
+  });
+  initStringKeys();
+  for (auto i = 0; i < keys_.size(); ++i) {
+    readOrder_.push_back(i);
+  }
+  std::stable_partition(readOrder_.begin(), readOrder_.end(), [&](auto i) {
+    return keys_[i].scanSpec->hasFilter();
+  });
+
+  if (asStruct) {
+    structFields_.resize(structIt->second.size(), -1);
+    for (auto i = 0; i < keys_.size(); ++i) {
+      auto it = projectedKeys.find(KeyValue<T>(keys_[i].value));
+      if (it != projectedKeys.end()) {
+        structFields_[it->second] = i;
+      }
+    }
+    structType_ = ROW(
+        std::vector<std::string>(structIt->second),
+        std::vector<TypePtr>(structIt->second.size(), valueType_));
+  }
+  VLOG(1) << "[Flat-Map] Initialized a selective flat-map column reader for "
+          << "node " << dataType->id << ", keys=" << keys_.size();
+}
+
+template <typename T>
+std::unique_ptr<common::ScanSpec>
+SelectiveFlatMapColumnReader<T>::makeKeySpec(
+    const std::string& name,
+    const common::ScanSpec* keySpec,
+    bool isOutput) const {
+  // A spec without children does not read any field of a complex value.
+  auto usable = [&](const common::ScanSpec* spec) {
+    return spec && (!isComplex(*valueType_) || !spec->children().empty());
+  };
+  const common::ScanSpec* source = nullptr;
+  if (usable(keySpec)) {
+    source = keySpec;
+  } else if (usable(scanSpec_->childByName(kElementsField))) {
+    source = scanSpec_->childByName(kElementsField);
+  }
+  std::unique_ptr<common::ScanSpec> spec;
+  if (source) {
+    spec = source->clone();
+  } else {
+    spec = std::make_unique<common::ScanSpec>(name);
+    addFieldSpecs(*valueType_, *spec);
+  }
+  if (source != keySpec) {
+    spec->setFilter(
+        keySpec && keySpec->filter() ? keySpec->filter()->clone() : nullptr);
+  }
+  spec->setProjectOut(isOutput);
+  spec->setExtractValues(isOutput);
+  return spec;
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::initStringKeys() {}
+
+template <>
+void SelectiveFlatMapColumnReader<StringView>::initStringKeys() {
+  size_t size = 0;
+  for (auto& key : keys_) {
+    size += key.name.size();
+  }
+  keyBuffer_ = AlignedBuffer::allocate<char>(size, &memoryPool_);
+  auto* data = keyBuffer_->asMutable<char>();
+  for (auto& key : keys_) {
+    std::memcpy(data, key.name.data(), key.name.size());
+    key.value = StringView(data, key.name.size());
+    data += key.name.size();
+  }
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::seekToRowGroup(uint32_t index) {
+  ensureRowGroupIndex();
+  auto positions = toPositions(index_->entry(index));
+  dwio::common::PositionProvider positionsProvider(positions);
+  if (notNullDecoder_) {
+    notNullDecoder_->seekToRowGroup(positionsProvider);
+  }
+  // The readers of the values also seek the in-map streams since their
+  // positions come first in the row index of the values.
+  for (auto& key : keys_) {
+    key.reader->seekToRowGroup(index);
+  }
+  setReadOffsetRecursive(index * rowsPerRowGroup_);
+}
+
+template <typename T>
+uint64_t SelectiveFlatMapColumnReader<T>::skip(uint64_t numValues) {
+  auto numMaps = ColumnReader::skip(numValues);
+  // Like struct children the value readers keep their 'readOffset_' in
+  // terms of rows of the map.
+  for (auto& key : keys_) {
+    uint64_t numInMap = 0;
+    if (numMaps > 0) {
+      detail::ensureCapacity<uint64_t>(
+          skipBuffer_, bits::nwords(numMaps), &memoryPool_);
+      auto* bits = skipBuffer_->asMutable<uint64_t>();
+      key.inMap->next(reinterpret_cast<char*>(bits), numMaps, nullptr);
+      numInMap = bits::countBits(bits, 0, numMaps);
+    }
+    key.reader->skip(numInMap);
+    key.reader->setReadOffsetRecursive(key.reader->readOffset() + numValues);
+  }
+  return numValues;
+}
+
+template <typename T>
+std::vector<uint32_t> SelectiveFlatMapColumnReader<T>::filterRowGroups(
+    uint64_t rowGroupSize,
+    const StatsContext& context) const {
+  auto stridesToSkip =
+      SelectiveColumnReader::filterRowGroups(rowGroupSize, context);
+  for (auto& key : keys_) {
+    // The statistics of a key do not count the maps without the key, for
+    // which the value is null.
+    auto* filter = key.scanSpec->filter();
+    if (!filter || filter->testNull()) {
+      continue;
+    }
+    auto keyStridesToSkip = key.reader->filterRowGroups(rowGroupSize, context);
+    std::vector<uint32_t> merged;
+    merged.reserve(keyStridesToSkip.size() + stridesToSkip.size());
+    std::set_union(
+        keyStridesToSkip.begin(),
+        keyStridesToSkip.end(),
+        stridesToSkip.begin(),
+        stridesToSkip.end(),
+        std::back_inserter(merged));
+    stridesToSkip = std::move(merged);
+  }
+  return stridesToSkip;
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::read(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  // Skips also the values if only nulls are read.
+  seekTo(offset, false);
+  prepareRead<char>(offset, rows, incomingNulls);
+  const vector_size_t numRows = rows.back() + 1;
+  const uint64_t* mapNulls =
+      nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+  for (auto& key : keys_) {
+    detail::ensureCapacity<uint64_t>(
+        key.inMapRows, bits::nwords(numRows), &memoryPool_);
+    key.inMap->next(key.inMapRows->asMutable<char>(), numRows, mapNulls);
+  }
+
+  RowSet activeRows = rows;
+  for (auto i : readOrder_) {
+    if (activeRows.empty()) {
+      break;
+    }
+    auto& key = keys_[i];
+    auto* inMapRows = key.inMapRows->as<uint64_t>();
+    if (key.scanSpec->hasFilter()) {
+      SelectivityTimer timer(key.scanSpec->selectivity(), activeRows.size());
+      key.reader->resetInitTimeClocks();
+      key.reader->read(offset, activeRows, inMapRows);
+      timer.subtract(key.reader->initTimeClocks());
+      activeRows = key.reader->outputRows();
+      key.scanSpec->selectivity().addOutput(activeRows.size());
+    } else {
+      key.reader->read(offset, activeRows, inMapRows);
+    }
+  }
+  // Moves the readers that stopped before the end of the range, e.g.
+  // after the last row passing a filter, to the end using the in-map
+  // bits.
+  for (auto& key : keys_) {
+    auto* reader = key.reader.get();
+    auto end = offset + numRows;
+    if (reader->readOffset() < end) {
+      reader->skip(bits::countBits(
+          key.inMapRows->as<uint64_t>(),
+          reader->readOffset() - offset,
+          numRows));
+      reader->setReadOffsetRecursive(end);
+    }
+  }
+  if (scanSpec_->hasFilter()) {
+    setOutputRows(activeRows);
+  }
+  numValues_ = activeRows.size();
+  readOffset_ = offset + numRows;
+}
+
+template <typename T>
+BufferPtr SelectiveFlatMapColumnReader<T>::makeResultNulls(RowSet rows) {
+  if (!nullsInReadRange_) {
+    return nullptr;
+  }
+  auto* mapNulls = nullsInReadRange_->as<uint64_t>();
+  auto nulls = AlignedBuffer::allocate<bool>(rows.size(), &memoryPool_);
+  auto* rawNulls = nulls->asMutable<uint64_t>();
+  for (auto i = 0; i < rows.size(); ++i) {
+    bits::setNull(rawNulls, i, bits::isBitNull(mapNulls, rows[i]));
+  }
+  return nulls;
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::getValues(
+    RowSet rows,
+    VectorPtr* result) {
+  if (structType_) {
+    getStructValues(rows, result);
+  } else {
+    getMapValues(rows, result);
+  }
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::getStructValues(
+    RowSet rows,
+    VectorPtr* result) {
+  std::vector<VectorPtr> children(structFields_.size());
+  for (auto i = 0; i < structFields_.size(); ++i) {
+    if (structFields_[i] < 0) {
+      children[i] = BaseVector::createNullConstant(
+          valueType_, rows.size(), &memoryPool_);
+      continue;
+    }
+    if (valueType_->isRow()) {
+      children[i] = BaseVector::create(valueType_, 0, &memoryPool_);
+    }
+    keys_[structFields_[i]].reader->getValues(rows, &children[i]);
+  }
+  *result = std::make_shared<RowVector>(
+      &memoryPool_,
+      structType_,
+      makeResultNulls(rows),
+      rows.size(),
+      std::move(children));
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::getMapValues(
+    RowSet rows,
+    VectorPtr* result) {
+  auto nulls = makeResultNulls(rows);
+  auto* rawNulls = nulls ? nulls->as<uint64_t>() : nullptr;
+  auto offsets = allocateOffsets(rows.size(), &memoryPool_);
+  auto sizes = allocateSizes(rows.size(), &memoryPool_);
+  auto* rawOffsets = offsets->asMutable<vector_size_t>();
+  auto* rawSizes = sizes->asMutable<vector_size_t>();
+  vector_size_t numEntries = 0;
+  for (auto i = 0; i < rows.size(); ++i) {
+    rawOffsets[i] = numEntries;
+    if (rawNulls && bits::isBitNull(rawNulls, i)) {
+      continue;
+    }
+    for (auto& key : keys_) {
+      if (key.isOutput &&
+          bits::isBitSet(key.inMapRows->as<uint64_t>(), rows[i])) {
+        ++rawSizes[i];
+      }
+    }
+    numEntries += rawSizes[i];
+  }
+
+  auto keys = BaseVector::create(
+      nodeType_->type->childAt(0), numEntries, &memoryPool_);
+  auto values = BaseVector::create(valueType_, numEntries, &memoryPool_);
+  if (numEntries > 0) {
+    auto* rawKeys = keys->asFlatVector<T>()->mutableRawValues();
+    // Next free position in the entries of each map.
+    std::vector<vector_size_t> nextEntry(rawOffsets, rawOffsets + rows.size());
+    std::vector<vector_size_t> toSourceRow(numEntries);
+    SelectivityVector entries(numEntries, false);
+    for (auto& key : keys_) {
+      if (!key.isOutput) {
+        continue;
+      }
+      auto* inMapRows = key.inMapRows->as<uint64_t>();
+      entries.clearAll();
+      for (auto i = 0; i < rows.size(); ++i) {
+        if ((!rawNulls || !bits::isBitNull(rawNulls, i)) &&
+            bits::isBitSet(inMapRows, rows[i])) {
+          auto entry = nextEntry[i]++;
+          rawKeys[entry] = key.value;
+          toSourceRow[entry] = i;
+          entries.setValid(entry, true);
+        }
+      }
+      entries.updateBounds();
+      if (!entries.hasSelections()) {
+        continue;
+      }
+      VectorPtr keyValues;
+      if (valueType_->isRow()) {
+        keyValues = BaseVector::create(valueType_, 0, &memoryPool_);
+      }
+      key.reader->getValues(rows, &keyValues);
+      values->copy(keyValues.get(), entries, toSourceRow.data());
+    }
+    if constexpr (std::is_same_v<T, StringView>) {
+      keys->asFlatVector<StringView>()->setStringBuffers({keyBuffer_});
+    }
+  }
+  *result = std::make_shared<MapVector>(
+      &memoryPool_,
+      MAP(keys->type(), valueType_),
+      std::move(nulls),
+      rows.size(),
+      std::move(offsets),
+      std::move(sizes),
+      std::move(keys),
+      std::move(values));
+}
+
+namespace {
+template <typename T>
+std::unique_ptr<SelectiveColumnReader> makeReader(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    StripeStreams& stripe,
+    common::ScanSpec* scanSpec,
+    FlatMapContext flatMapContext) {
+  return std::make_unique<SelectiveFlatMapColumnReader<T>>(
+      requestedType, dataType, stripe, scanSpec, std::move(flatMapContext));
+}
+} // namespace
+
+std::unique_ptr<SelectiveColumnReader> createSelectiveFlatMapColumnReader(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    StripeStreams& stripe,
+    common::ScanSpec* scanSpec,
+    FlatMapContext flatMapContext) {
+  const auto kind = dataType->childAt(0)->type->kind();
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return makeReader<int8_t>(
+          requestedType, dataType, stripe, scanSpec, std::move(flatMapContext));
+    case TypeKind::SMALLINT:
+      return makeReader<int16_t>(
+          requestedType, dataType, stripe, scanSpec, std::move(flatMapContext));
+    case TypeKind::INTEGER:
+      return makeReader<int32_t>(
+          requestedType, dataType, stripe, scanSpec, std::move(flatMapContext));
+    case TypeKind::BIGINT:
+      return makeReader<int64_t>(
+          requestedType, dataType, stripe, scanSpec, std::move(flatMapContext));
+    case TypeKind::VARBINARY:
+    case TypeKind::VARCHAR:
+      return makeReader<StringView>(
+          requestedType, dataType, stripe, scanSpec, std::move(flatMapContext));
+    default:
+      DWIO_RAISE("Not supported key type: ", kind);
+  }
+}
+
+template class SelectiveFlatMapColumnReader<int8_t>;
+template class SelectiveFlatMapColumnReader<int16_t>;
+template class SelectiveFlatMapColumnReader<int32_t>;
+template class SelectiveFlatMapColumnReader<int64_t>;
+template class SelectiveFlatMapColumnReader<StringView>;
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include "velox/dwio/dwrf/reader/FlatMapColumnReader.h"
+#include "velox/dwio/dwrf/reader/SelectiveColumnReaderInternal.h"
+
+namespace facebook::velox::dwrf {
+
+// Selective reader for a map written as a flat map. Each key has its own
+// value streams and an in-map stream that tells which maps contain the
+// key. The reader reads only the keys the ScanSpec asks for and applies
+// the filters on keys in the reader of the key's values, so that a
+// filter on one key drops rows before any other key is read.
+//
+// The children of the map's ScanSpec other than 'keys' and 'elements'
+// describe single keys, e.g. the subfield c0["k"]. A key child with a
+// filter filters the rows on the value of the key, a row that does not
+// have the key has a null value. If some key child is extracted, only
+// the extracted keys are returned. Otherwise all the keys of the stripe
+// are returned.
+//
+// If RowReaderOptions::getMapColumnIdAsStruct() has the column, the
+// result is a struct with a field for each configured key, made without
+// building a map. The children of the ScanSpec are then named like the
+// fields.
+template <typename T>
+class SelectiveFlatMapColumnReader : public SelectiveColumnReader {
+ public:
+  SelectiveFlatMapColumnReader(
+      const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+      StripeStreams& stripe,
+      common::ScanSpec* scanSpec,
+      FlatMapContext flatMapContext);
+
+  bool useBulkPath() const override {
+    return false;
+  }
+
+  void resetFilterCaches() override {
+    for (auto& key : keys_) {
+      key.reader->resetFilterCaches();
+    }
+  }
+
+  void seekToRowGroup(uint32_t index) override;
+
+  uint64_t skip(uint64_t numValues) override;
+
+  std::vector<uint32_t> filterRowGroups(
+      uint64_t rowGroupSize,
+      const StatsContext& context) const override;
+
+  void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
+      override;
+
+  void getValues(RowSet rows, VectorPtr* result) override;
+
+  void setReadOffsetRecursive(int32_t readOffset) override {
+    readOffset_ = readOffset;
+    for (auto& key : keys_) {
+      key.reader->setReadOffsetRecursive(readOffset);
+    }
+  }
+
+  // Number of keys that have readers in the current stripe. For testing.
+  int32_t numKeysRead() const {
+    return keys_.size();
+  }
+
+ private:
+  // The streams of one key in the stripe.
+  struct Key {
+    T value;
+    // 'value' as text. The name of the field if the map is read as a
+    // struct.
+    std::string name;
+    uint32_t sequence;
+    // True if the key is in the result. False if the key is read only
+    // for a filter.
+    bool isOutput;
+    // Owned by 'this' since a key may need a spec that is not in the
+    // ScanSpec tree, e.g. a copy of the spec of 'elements'.
+    std::unique_ptr<common::ScanSpec> scanSpec;
+    std::unique_ptr<BooleanRleDecoder> inMap;
+    std::unique_ptr<SelectiveColumnReader> reader;
+    // Bit for each row in the last read, set if the map of the row has
+    // the key. Used as incoming nulls of 'reader'.
+    BufferPtr inMapRows;
+  };
+
+  std::unique_ptr<common::ScanSpec> makeKeySpec(
+      const std::string& name,
+      const common::ScanSpec* keySpec,
+      bool isOutput) const;
+
+  // Sets the string keys to point to 'keyBuffer_'.
+  void initStringKeys();
+
+  void getMapValues(RowSet rows, VectorPtr* result);
+
+  void getStructValues(RowSet rows, VectorPtr* result);
+
+  // Returns the nulls of the maps at 'rows' or nullptr if none is null.
+  BufferPtr makeResultNulls(RowSet rows);
+
+  const std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
+  const TypePtr valueType_;
+  // Keys in the order of their sequence number, which is the order of
+  // keys in maps made by 'this'.
+  std::vector<Key> keys_;
+  // Indices of 'keys_' in read order. Keys with filters come first.
+  std::vector<int32_t> readOrder_;
+  // Set if the result is a struct. The fields of the struct are the
+  // configured keys.
+  RowTypePtr structType_;
+  // Index into 'keys_' for each field of 'structType_', -1 for keys that
+  // are not in the stripe.
+  std::vector<int32_t> structFields_;
+  // Backs StringView keys.
+  BufferPtr keyBuffer_;
+  // In-map bits of skipped rows.
+  BufferPtr skipBuffer_;
+};
+
+// Returns a SelectiveFlatMapColumnReader for the key type of 'dataType'.
+std::unique_ptr<SelectiveColumnReader> createSelectiveFlatMapColumnReader(
+    const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+    const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+    StripeStreams& stripe,
+    common::ScanSpec* scanSpec,
+    FlatMapContext flatMapContext);
+
+} // namespace facebook::velox::dwrf
@@ -30,17 +30,16 @@ class SelectiveFloatingPointColumnReader : public SelectiveColumnReader {
       common::ScanSpec* scanSpec,
       FlatMapContext flatMapContext);
 
-  // Offers fast path only if data and result widths match.
-  bool hasBulkPath() const override {
-    return std::is_same<TData, TRequested>::value;
-  }
-
   void seekToRowGroup(uint32_t index) override {
     ensureRowGroupIndex();
 
     auto positions = toPositions(index_->entry(index));
     dwio::common::PositionProvider positionsProvider(positions);
 
+    if (flatMapContext_.inMapDecoder) {
+      flatMapContext_.inMapDecoder->seekToRowGroup(positionsProvider);
+    }
+
     if (notNullDecoder_) {
       notNullDecoder_->seekToRowGroup(positionsProvider);
     }
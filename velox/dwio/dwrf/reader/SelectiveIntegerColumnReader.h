@@ -17,6 +17,7 @@
 #pragma once
 
 #include "velox/dwio/dwrf/reader/SelectiveColumnReaderInternal.h"
+#include "velox/vector/BiasVector.h"
 
 namespace facebook::velox::dwrf {
 
@@ -28,15 +29,24 @@ class SelectiveIntegerColumnReader : public SelectiveColumnReader {
       std::shared_ptr<const dwio::common::TypeWithId> requestedType,
       StripeStreams& stripe,
       common::ScanSpec* scanSpec,
-      const TypePtr& type)
+      const TypePtr& type,
+      FlatMapContext flatMapContext = FlatMapContext::nonFlatMapContext())
       : SelectiveColumnReader(
             std::move(requestedType),
             stripe,
             scanSpec,
-            type) {}
+            type,
+            std::move(flatMapContext)),
+        returnBiasVectors_(
+            stripe.getRowReaderOptions().getReturnBiasVectors()) {}
 
   void getValues(RowSet rows, VectorPtr* result) override {
     getIntValues(rows, nodeType_->type.get(), result);
+    if (returnBiasVectors_) {
+      if (auto biased = makeBiasVector(**result)) {
+        *result = std::move(biased);
+      }
+    }
   }
 
  protected:
@@ -66,6 +76,10 @@ class SelectiveIntegerColumnReader : public SelectiveColumnReader {
   // possible value hook, filter and denseness.
   template <typename Reader>
   void readCommon(RowSet rows);
+
+ private:
+  // True if batches of narrow range are returned as BiasVectors.
+  const bool returnBiasVectors_;
 };
 
 template <
@@ -148,6 +162,10 @@ void SelectiveIntegerColumnReader::processFilter(
       readHelper<Reader, common::NegatedBigintValuesUsingBitmask, isDense>(
           filter, rows, extractValues);
       break;
+    case common::FilterKind::kBigintBloomFilter:
+      readHelper<Reader, common::BigintBloomFilter, isDense>(
+          filter, rows, extractValues);
+      break;
     default:
       readHelper<Reader, common::Filter, isDense>(filter, rows, extractValues);
       break;
@@ -24,12 +24,14 @@ SelectiveIntegerDictionaryColumnReader::SelectiveIntegerDictionaryColumnReader(
     const std::shared_ptr<const TypeWithId>& dataType,
     StripeStreams& stripe,
     common::ScanSpec* scanSpec,
-    uint32_t numBytes)
+    uint32_t numBytes,
+    FlatMapContext flatMapContext)
     : SelectiveIntegerColumnReader(
           std::move(requestedType),
           stripe,
           scanSpec,
-          dataType->type) {
+          dataType->type,
+          std::move(flatMapContext)) {
   EncodingKey encodingKey{nodeType_->id, flatMapContext_.sequence};
   auto encoding = stripe.getEncoding(encodingKey);
   scanState_.dictionary.numValues = encoding.dictionarysize();
@@ -99,6 +101,21 @@ void SelectiveIntegerDictionaryColumnReader::read(
   readCommon<SelectiveIntegerDictionaryColumnReader>(rows);
 }
 
+template <typename T>
+void SelectiveIntegerDictionaryColumnReader::prefillFilterCache() {
+  auto numValues = scanState_.dictionary.numValues;
+  auto filter = filterForDictionary(numValues);
+  if (!filter || !numValues) {
+    return;
+  }
+  auto values = scanState_.dictionary.values->as<T>();
+  auto cache = scanState_.filterCache.data();
+  for (auto i = 0; i < numValues; ++i) {
+    cache[i] = filter->testInt64(values[i]) ? FilterResult::kSuccess
+                                            : FilterResult::kFailure;
+  }
+}
+
 void SelectiveIntegerDictionaryColumnReader::ensureInitialized() {
   if (LIKELY(initialized_)) {
     return;
@@ -115,6 +132,7 @@ void SelectiveIntegerDictionaryColumnReader::ensureInitialized() {
       scanState_.filterCache.data(),
       FilterResult::kUnknown,
       scanState_.filterCache.size());
+  VELOX_WIDTH_DISPATCH(sizeOfIntKind(type_->kind()), prefillFilterCache);
   initialized_ = true;
   initTimeClocks_ = timer.elapsedClocks();
   scanState_.updateRawState();
@@ -30,7 +30,8 @@ class SelectiveIntegerDictionaryColumnReader
       const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
       StripeStreams& stripe,
       common::ScanSpec* scanSpec,
-      uint32_t numBytes);
+      uint32_t numBytes,
+      FlatMapContext flatMapContext);
 
   void seekToRowGroup(uint32_t index) override {
     ensureRowGroupIndex();
@@ -38,6 +39,10 @@ class SelectiveIntegerDictionaryColumnReader
     auto positions = toPositions(index_->entry(index));
     dwio::common::PositionProvider positionsProvider(positions);
 
+    if (flatMapContext_.inMapDecoder) {
+      flatMapContext_.inMapDecoder->seekToRowGroup(positionsProvider);
+    }
+
     if (notNullDecoder_) {
       notNullDecoder_->seekToRowGroup(positionsProvider);
     }
@@ -62,6 +67,11 @@ class SelectiveIntegerDictionaryColumnReader
  private:
   void ensureInitialized();
 
+  // Evaluates the filter on all dictionary entries if the dictionary is
+  // small enough.
+  template <typename T>
+  void prefillFilterCache();
+
   std::unique_ptr<ByteRleDecoder> inDictionaryReader_;
   std::unique_ptr<IntDecoder</* isSigned = */ false>> dataReader_;
   std::unique_ptr<IntDecoder</* isSigned = */ true>> dictReader_;
@@ -29,12 +29,14 @@ class SelectiveIntegerDirectColumnReader : public SelectiveIntegerColumnReader {
       const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
       StripeStreams& stripe,
       uint32_t numBytes,
-      common::ScanSpec* scanSpec)
+      common::ScanSpec* scanSpec,
+      FlatMapContext flatMapContext)
       : SelectiveIntegerColumnReader(
             std::move(requestedType),
             stripe,
             scanSpec,
-            dataType->type) {
+            dataType->type,
+            std::move(flatMapContext)) {
     EncodingKey encodingKey{nodeType_->id, flatMapContext_.sequence};
     auto data = encodingKey.forKind(proto::Stream_Kind_DATA);
     bool dataVInts = stripe.getUseVInts(data);
@@ -55,6 +57,10 @@ class SelectiveIntegerDirectColumnReader : public SelectiveIntegerColumnReader {
     auto positions = toPositions(index_->entry(index));
     dwio::common::PositionProvider positionsProvider(positions);
 
+    if (flatMapContext_.inMapDecoder) {
+      flatMapContext_.inMapDecoder->seekToRowGroup(positionsProvider);
+    }
+
     if (notNullDecoder_) {
       notNullDecoder_->seekToRowGroup(positionsProvider);
     }
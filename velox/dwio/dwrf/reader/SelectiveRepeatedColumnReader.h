@@ -190,6 +190,10 @@ class SelectiveListColumnReader : public SelectiveRepeatedColumnReader {
     auto positions = toPositions(index_->entry(index));
     dwio::common::PositionProvider positionsProvider(positions);
 
+    if (flatMapContext_.inMapDecoder) {
+      flatMapContext_.inMapDecoder->seekToRowGroup(positionsProvider);
+    }
+
     if (notNullDecoder_) {
       notNullDecoder_->seekToRowGroup(positionsProvider);
     }
@@ -235,6 +239,10 @@ class SelectiveMapColumnReader : public SelectiveRepeatedColumnReader {
     auto positions = toPositions(index_->entry(index));
     dwio::common::PositionProvider positionsProvider(positions);
 
+    if (flatMapContext_.inMapDecoder) {
+      flatMapContext_.inMapDecoder->seekToRowGroup(positionsProvider);
+    }
+
     if (notNullDecoder_) {
       notNullDecoder_->seekToRowGroup(positionsProvider);
     }
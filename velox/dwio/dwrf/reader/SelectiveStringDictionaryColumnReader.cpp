@@ -157,6 +157,24 @@ void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
       scanState_.filterCache.data() + scanState_.dictionary.numValues,
       FilterResult::kUnknown,
       scanState_.dictionary2.numValues);
+  prefillFilterCache(scanState_.dictionary2, scanState_.dictionary.numValues);
+}
+
+void SelectiveStringDictionaryColumnReader::prefillFilterCache(
+    const DictionaryValues& values,
+    int32_t offset) {
+  auto filter = filterForDictionary(values.numValues);
+  if (!filter || !values.numValues) {
+    return;
+  }
+  auto views = values.values->as<StringView>();
+  auto cache = scanState_.filterCache.data() + offset;
+  std::vector<uint64_t> passed(bits::nwords(values.numValues));
+  filter->testStringViews(views, values.numValues, passed.data());
+  for (auto i = 0; i < values.numValues; ++i) {
+    cache[i] = bits::isBitSet(passed.data(), i) ? FilterResult::kSuccess
+                                                : FilterResult::kFailure;
+  }
 }
 
 void SelectiveStringDictionaryColumnReader::makeDictionaryBaseVector() {
@@ -292,6 +310,7 @@ void SelectiveStringDictionaryColumnReader::ensureInitialized() {
       scanState_.filterCache.data(),
       FilterResult::kUnknown,
       scanState_.dictionary.numValues);
+  prefillFilterCache(scanState_.dictionary, 0);
 
   // handle in dictionary stream
   if (inDictionaryReader_) {
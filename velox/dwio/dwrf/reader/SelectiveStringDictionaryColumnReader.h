@@ -69,6 +69,10 @@ class SelectiveStringDictionaryColumnReader : public SelectiveColumnReader {
 
  private:
   void loadStrideDictionary();
+
+  // Evaluates the filter on the entries of 'values' that start at 'offset'
+  // in the filter cache if the dictionary is small enough.
+  void prefillFilterCache(const DictionaryValues& values, int32_t offset);
   void makeDictionaryBaseVector();
 
   template <typename TVisitor>
@@ -40,11 +40,16 @@ class SelectiveStructColumnReader : public SelectiveColumnReader {
       readOffset_ = index * rowsPerRowGroup_;
       return;
     }
-    if (notNullDecoder_) {
+    if (notNullDecoder_ || flatMapContext_.inMapDecoder) {
       ensureRowGroupIndex();
       auto positions = toPositions(index_->entry(index));
       dwio::common::PositionProvider positionsProvider(positions);
-      notNullDecoder_->seekToRowGroup(positionsProvider);
+      if (flatMapContext_.inMapDecoder) {
+        flatMapContext_.inMapDecoder->seekToRowGroup(positionsProvider);
+      }
+      if (notNullDecoder_) {
+        notNullDecoder_->seekToRowGroup(positionsProvider);
+      }
     }
     // Set the read offset recursively. Do this before seeking the
     // children because list/map children will reset the offsets for
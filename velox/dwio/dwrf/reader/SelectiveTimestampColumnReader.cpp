@@ -59,6 +59,9 @@ void SelectiveTimestampColumnReader::seekToRowGroup(uint32_t index) {
 
   auto positions = toPositions(index_->entry(index));
   PositionProvider positionsProvider(positions);
+  if (flatMapContext_.inMapDecoder) {
+    flatMapContext_.inMapDecoder->seekToRowGroup(positionsProvider);
+  }
   if (notNullDecoder_) {
     notNullDecoder_->seekToRowGroup(positionsProvider);
   }
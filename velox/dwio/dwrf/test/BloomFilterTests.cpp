@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+
+using namespace ::testing;
+using namespace facebook::velox::dwrf;
+
+TEST(BloomFilterTests, longs) {
+  BloomFilter filter(10'000, 0.05);
+  for (int64_t i = 0; i < 10'000; ++i) {
+    filter.addLong(i * 7);
+  }
+  for (int64_t i = 0; i < 10'000; ++i) {
+    EXPECT_TRUE(filter.testLong(i * 7));
+  }
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < 10'000; ++i) {
+    numFalsePositives += filter.testLong(i * 7 + 1);
+  }
+  // The configured rate is 5%. Allows for some variation.
+  EXPECT_LT(numFalsePositives, 1'000);
+
+  filter.reset();
+  EXPECT_FALSE(filter.testLong(7));
+}
+
+TEST(BloomFilterTests, bytes) {
+  BloomFilter filter(1'000, 0.01);
+  for (auto i = 0; i < 1'000; ++i) {
+    auto value = fmt::format("value{}", i);
+    filter.addBytes(value.data(), value.size());
+  }
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < 1'000; ++i) {
+    auto value = fmt::format("value{}", i);
+    EXPECT_TRUE(filter.testBytes(value.data(), value.size()));
+    auto other = fmt::format("other{}", i);
+    numFalsePositives += filter.testBytes(other.data(), other.size());
+  }
+  EXPECT_LT(numFalsePositives, 50);
+}
+
+TEST(BloomFilterTests, proto) {
+  BloomFilter filter(1'000, 0.05);
+  for (int64_t i = 0; i < 1'000; ++i) {
+    filter.addLong(i);
+  }
+  filter.addBytes("abc", 3);
+  proto::BloomFilter proto;
+  filter.toProto(proto);
+  EXPECT_EQ(proto.numhashfunctions(), filter.numHashFunctions());
+  EXPECT_EQ(proto.bitset_size() * 64, filter.numBits());
+
+  BloomFilter copy(proto);
+  EXPECT_EQ(copy.numHashFunctions(), filter.numHashFunctions());
+  EXPECT_EQ(copy.numBits(), filter.numBits());
+  for (int64_t i = 0; i < 1'000; ++i) {
+    EXPECT_TRUE(copy.testLong(i));
+  }
+  EXPECT_TRUE(copy.testBytes("abc", 3));
+  for (int64_t i = 1'000; i < 2'000; ++i) {
+    EXPECT_EQ(copy.testLong(i), filter.testLong(i));
+  }
+}
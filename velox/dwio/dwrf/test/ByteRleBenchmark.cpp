@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/dwio/dwrf/common/ByteRLE.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox::dwrf;
+
+// Measures ByteRleDecoder::next() on runs and literals with and without
+// nulls and BooleanRleDecoder::next() on null streams. Each case decodes
+// kNumValues values.
+namespace {
+constexpr int32_t kNumValues = 1'000'000;
+
+// Byte RLE of runs of 130 values.
+std::vector<char> runs;
+// Byte RLE of literal blocks of 128 values.
+std::vector<char> literals;
+// Byte RLE of a null stream with 1% nulls.
+std::vector<char> fewNulls;
+// One in two positions is null.
+std::vector<uint64_t> alternatingNulls;
+// Ranges of 1 to 32 nulls and non-nulls.
+std::vector<uint64_t> rangeNulls;
+
+// Appends the byte RLE of 'values' as literal blocks.
+void appendLiterals(const char* values, int32_t size, std::vector<char>& out) {
+  for (auto i = 0; i < size; i += 128) {
+    auto count = std::min(128, size - i);
+    out.push_back(-count);
+    out.insert(out.end(), values + i, values + i + count);
+  }
+}
+
+void makeData() {
+  for (auto i = 0; i < kNumValues; i += 130) {
+    runs.push_back(127);
+    runs.push_back(i % 100);
+  }
+  std::vector<char> values(kNumValues);
+  for (auto& value : values) {
+    value = folly::Random::rand32(256);
+  }
+  appendLiterals(values.data(), values.size(), literals);
+
+  std::vector<uint64_t> nulls(bits::nwords(kNumValues), bits::kNotNull64);
+  for (auto i = 0; i < kNumValues; ++i) {
+    if (folly::Random::oneIn(100)) {
+      bits::setNull(nulls.data(), i);
+    }
+  }
+  // The bits of the stream are most significant first.
+  auto* bytes = reinterpret_cast<uint8_t*>(nulls.data());
+  bits::reverseBits(bytes, bits::nbytes(kNumValues));
+  appendLiterals(
+      reinterpret_cast<char*>(bytes), bits::nbytes(kNumValues), fewNulls);
+
+  alternatingNulls.resize(bits::nwords(kNumValues), 0xaaaaaaaaaaaaaaaaULL);
+  rangeNulls.resize(bits::nwords(kNumValues), bits::kNotNull64);
+  for (auto i = 0; i < kNumValues;) {
+    auto numNulls = 1 + folly::Random::rand32(32);
+    for (auto j = i; j < std::min<int32_t>(kNumValues, i + numNulls); ++j) {
+      bits::setNull(rangeNulls.data(), j);
+    }
+    i += numNulls + 1 + folly::Random::rand32(32);
+  }
+}
+
+void decodeBytes(const std::vector<char>& stream, const uint64_t* nulls) {
+  folly::BenchmarkSuspender suspender;
+  std::vector<char> data(kNumValues);
+  auto decoder = createByteRleDecoder(
+      std::make_unique<SeekableArrayInputStream>(stream.data(), stream.size()),
+      EncodingKey{0, 0});
+  suspender.dismiss();
+  decoder->next(data.data(), kNumValues, nulls);
+  folly::doNotOptimizeAway(data);
+}
+
+void decodeNulls(const std::vector<char>& stream, const uint64_t* nulls) {
+  folly::BenchmarkSuspender suspender;
+  std::vector<uint64_t> data(bits::nwords(kNumValues));
+  auto decoder = createBooleanRleDecoder(
+      std::make_unique<SeekableArrayInputStream>(stream.data(), stream.size()),
+      EncodingKey{0, 0});
+  suspender.dismiss();
+  decoder->next(reinterpret_cast<char*>(data.data()), kNumValues, nulls);
+  folly::doNotOptimizeAway(data);
+}
+
+BENCHMARK(runs) {
+  decodeBytes(runs, nullptr);
+}
+
+BENCHMARK_RELATIVE(runsAlternatingNulls) {
+  decodeBytes(runs, alternatingNulls.data());
+}
+
+BENCHMARK_RELATIVE(runsRangeNulls) {
+  decodeBytes(runs, rangeNulls.data());
+}
+
+BENCHMARK(literals) {
+  decodeBytes(literals, nullptr);
+}
+
+BENCHMARK_RELATIVE(literalsAlternatingNulls) {
+  decodeBytes(literals, alternatingNulls.data());
+}
+
+BENCHMARK_RELATIVE(literalsRangeNulls) {
+  decodeBytes(literals, rangeNulls.data());
+}
+
+BENCHMARK(nullStream) {
+  decodeNulls(fewNulls, nullptr);
+}
+
+BENCHMARK_RELATIVE(nullStreamRangeNulls) {
+  decodeNulls(fewNulls, rangeNulls.data());
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  makeData();
+  folly::runBenchmarks();
+  return 0;
+}
@@ -18,7 +18,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <numeric>
 #include <optional>
+#include <random>
 #include <vector>
 #include "velox/common/memory/Memory.h"
 #include "velox/dwio/common/MemoryInputStream.h"
@@ -28,6 +30,7 @@
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
 #include "velox/dwio/dwrf/test/utils/BatchMaker.h"
 #include "velox/dwio/dwrf/test/utils/MapBuilder.h"
+#include "velox/dwio/dwrf/writer/EncodingCostModel.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
 #include "velox/type/Type.h"
 #include "velox/vector/DictionaryVector.h"
@@ -2771,6 +2774,82 @@ TEST(ColumnWriterTests, IntegerDictionaryDictionaryEncodableWriterCtor) {
   testIntegerDictionaryEncodableWriterConstructor<int64_t>();
 }
 
+TEST(ColumnWriterTests, rleV1SizeEstimate) {
+  auto estimate = [](const std::vector<int64_t>& values) {
+    return EncodingCostModel::rleV1Size(
+        values.size(), [&](size_t i) { return values[i]; }, true, true, 8);
+  };
+  // A run with a constant delta is a header, the delta and the base.
+  std::vector<int64_t> increasing(100);
+  std::iota(increasing.begin(), increasing.end(), 1000);
+  EXPECT_EQ(estimate(increasing), 4);
+  // Longer runs are split.
+  EXPECT_EQ(estimate(std::vector<int64_t>(300, 5)), 9);
+  // Literals take a header per 128 values.
+  std::vector<int64_t> alternating;
+  for (auto i = 0; i < 200; ++i) {
+    alternating.push_back(i % 2 ? 1 : 60);
+  }
+  EXPECT_EQ(estimate(alternating), 202);
+}
+
+namespace {
+// Writes one stripe of 'values' and returns the encoding of the column.
+template <typename T>
+proto::ColumnEncoding_Kind writeIntegerStripe(
+    const std::vector<T>& values,
+    bool costBasedSelection) {
+  auto type = CppToType<T>::create();
+  auto typeWithId = TypeWithId::create(type, 1);
+  auto scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+  BufferPtr buffer = AlignedBuffer::allocate<T>(values.size(), &pool);
+  std::copy(values.begin(), values.end(), buffer->asMutable<T>());
+  auto batch = std::make_shared<FlatVector<T>>(
+      &pool, nullptr, values.size(), buffer, std::vector<BufferPtr>());
+
+  auto config = std::make_shared<Config>();
+  config->set(Config::ENCODING_COST_BASED_SELECTION, costBasedSelection);
+  WriterContext context{config, getDefaultScopedMemoryPool()};
+  auto columnWriter = BaseColumnWriter::create(context, *typeWithId);
+  columnWriter->write(batch, Ranges::of(0, batch->size()));
+  columnWriter->createIndexEntry();
+  proto::StripeFooter stripeFooter;
+  columnWriter->flush(
+      [&stripeFooter](uint32_t /* unused */) -> proto::ColumnEncoding& {
+        return *stripeFooter.add_encoding();
+      });
+  TestStripeStreams streams(context, stripeFooter, ROW({{"c", type}}));
+  return streams.getEncoding(EncodingKey{1}).kind();
+}
+} // namespace
+
+TEST(ColumnWriterTests, costBasedEncodingSelection) {
+  // Few distinct large values are cheaper as a dictionary.
+  std::vector<int64_t> fewLarge;
+  for (auto i = 0; i < 10'000; ++i) {
+    fewLarge.push_back(1'000'000'000'000 + (i % 50) * 1'000'003);
+  }
+  EXPECT_EQ(
+      writeIntegerStripe(fewLarge, true),
+      proto::ColumnEncoding_Kind::ColumnEncoding_Kind_DICTIONARY);
+
+  // Small values that repeat once in random order are below the key size
+  // threshold but cheaper to write directly.
+  std::vector<int32_t> smallRepeated;
+  for (auto i = 0; i < 10'000; ++i) {
+    smallRepeated.push_back(i % 5'000);
+  }
+  std::mt19937 gen(1);
+  std::shuffle(smallRepeated.begin(), smallRepeated.end(), gen);
+  EXPECT_EQ(
+      writeIntegerStripe(smallRepeated, false),
+      proto::ColumnEncoding_Kind::ColumnEncoding_Kind_DICTIONARY);
+  EXPECT_EQ(
+      writeIntegerStripe(smallRepeated, true),
+      proto::ColumnEncoding_Kind::ColumnEncoding_Kind_DIRECT);
+}
+
 std::string
 generateSomewhatRandomStringData(size_t /*unused*/, size_t i, size_t size) {
   return folly::to<std::string>(generateSomewhatRandomData(i, size, 0, 0));
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/dwio/common/encryption/TestProvider.h"
+#include "velox/dwio/dwrf/common/Compression.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox::dwio::common::encryption;
+using namespace facebook::velox::dwio::common::encryption::test;
+using namespace facebook::velox::dwrf;
+
+// Measures reading compressed and encrypted DWRF streams. Each case reads
+// 64MB of text. The result is in MB, so that folly's iters/s is MB/s.
+namespace {
+constexpr uint64_t kBlockSize = 256 << 10;
+constexpr size_t kDataSize = 64 << 20;
+
+class BenchmarkBufferPool : public CompressionBufferPool {
+ public:
+  BenchmarkBufferPool(memory::MemoryPool& pool, uint64_t blockSize)
+      : buffer_{std::make_unique<DataBuffer<char>>(
+            pool,
+            blockSize + PAGE_HEADER_SIZE)} {}
+
+  std::unique_ptr<DataBuffer<char>> getBuffer(uint64_t /* unused */) override {
+    return std::move(buffer_);
+  }
+
+  void returnBuffer(std::unique_ptr<DataBuffer<char>> buffer) override {
+    buffer_ = std::move(buffer);
+  }
+
+ private:
+  std::unique_ptr<DataBuffer<char>> buffer_;
+};
+
+std::unique_ptr<memory::ScopedMemoryPool> pool;
+std::vector<char> data;
+TestEncrypter encrypter;
+TestDecrypter decrypter;
+TestStreamEncrypter streamEncrypter;
+TestStreamDecrypter streamDecrypter;
+
+std::unique_ptr<MemorySink> compress(
+    CompressionKind kind,
+    const Encrypter* encrypter) {
+  auto sink = std::make_unique<MemorySink>(pool->getPool(), 2 * kDataSize);
+  BenchmarkBufferPool bufferPool(pool->getPool(), kBlockSize);
+  DataBufferHolder holder{
+      pool->getPool(), kBlockSize, 0, DEFAULT_PAGE_GROW_RATIO, sink.get()};
+  Config config;
+  auto stream = createCompressor(kind, bufferPool, holder, config, encrypter);
+  size_t pos = 0;
+  char* buffer;
+  int32_t size;
+  while (pos < kDataSize &&
+         stream->Next(reinterpret_cast<void**>(&buffer), &size)) {
+    auto bytes = std::min<size_t>(size, kDataSize - pos);
+    memcpy(buffer, data.data() + pos, bytes);
+    if (bytes < size) {
+      stream->BackUp(size - bytes);
+    }
+    pos += bytes;
+  }
+  stream->flush();
+  return sink;
+}
+
+// Reads the stream compressed with 'kind' and encrypted with 'encrypter'
+// with Next() if 'readSize' is 0 or with readFully() in pieces of 'readSize'.
+unsigned read(
+    unsigned iters,
+    CompressionKind kind,
+    const Encrypter* encrypter,
+    const Decrypter* decrypter,
+    size_t readSize) {
+  folly::BenchmarkSuspender suspender;
+  auto sink = compress(kind, encrypter);
+  std::vector<char> buffer(readSize);
+  suspender.dismiss();
+  for (auto i = 0; i < iters; ++i) {
+    auto stream = createDecompressor(
+        kind,
+        std::make_unique<SeekableArrayInputStream>(
+            sink->getData(), sink->size()),
+        kBlockSize,
+        pool->getPool(),
+        "DecompressionBenchmark",
+        decrypter);
+    if (readSize == 0) {
+      const void* chunk;
+      int32_t size;
+      while (stream->Next(&chunk, &size)) {
+        folly::doNotOptimizeAway(chunk);
+      }
+      continue;
+    }
+    for (size_t pos = 0; pos < kDataSize; pos += readSize) {
+      stream->readFully(
+          buffer.data(), std::min<size_t>(readSize, kDataSize - pos));
+    }
+    folly::doNotOptimizeAway(buffer.data());
+  }
+  return iters * (kDataSize >> 20);
+}
+
+#define READ_BENCHMARKS(name, kind)                                          \
+  BENCHMARK_NAMED_PARAM_MULTI(                                               \
+      read, name##_next, kind, nullptr, nullptr, 0);                         \
+  BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(                                      \
+      read, name##_next_encrypted, kind, &encrypter, &decrypter, 0);         \
+  BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(                                      \
+      read,                                                                  \
+      name##_next_stream_encrypted,                                          \
+      kind,                                                                  \
+      &streamEncrypter,                                                      \
+      &streamDecrypter,                                                      \
+      0);                                                                    \
+  BENCHMARK_NAMED_PARAM_MULTI(                                               \
+      read, name##_readFully, kind, nullptr, nullptr, 1 << 20);              \
+  BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(                                      \
+      read,                                                                  \
+      name##_readFully_encrypted,                                            \
+      kind,                                                                  \
+      &encrypter,                                                            \
+      &decrypter,                                                            \
+      1 << 20);                                                              \
+  BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(                                      \
+      read,                                                                  \
+      name##_readFully_stream_encrypted,                                     \
+      kind,                                                                  \
+      &streamEncrypter,                                                      \
+      &streamDecrypter,                                                      \
+      1 << 20);                                                              \
+  BENCHMARK_DRAW_LINE()
+
+READ_BENCHMARKS(none, CompressionKind_NONE);
+READ_BENCHMARKS(zstd, CompressionKind_ZSTD);
+READ_BENCHMARKS(zlib, CompressionKind_ZLIB);
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  pool = memory::getDefaultScopedMemoryPool();
+  // Text of words from a small vocabulary, which compresses about 3:1.
+  std::vector<std::string> words;
+  for (auto i = 0; i < 1000; ++i) {
+    std::string word;
+    for (auto j = 0; j < 2 + i % 9; ++j) {
+      word += static_cast<char>('a' + folly::Random::rand32(26));
+    }
+    words.push_back(word + " ");
+  }
+  while (data.size() < kDataSize) {
+    const auto& word = words[folly::Random::rand32(words.size())];
+    data.insert(data.end(), word.begin(), word.end());
+  }
+  data.resize(kDataSize);
+  folly::runBenchmarks();
+  pool.reset();
+  return 0;
+}
@@ -16,6 +16,11 @@
 
 #include "velox/dwio/dwrf/test/E2EFilterTestBase.h"
 #include "velox/dwio/dwrf/writer/FlushPolicy.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+#include <gflags/gflags.h>
+
+DECLARE_int32(max_prefilled_dictionary_entries);
 
 using namespace facebook::velox::dwio::dwrf;
 using namespace facebook::velox::dwio::common;
@@ -24,6 +29,7 @@ using namespace facebook::velox;
 using namespace facebook::velox::common;
 
 using dwio::common::MemorySink;
+using facebook::velox::test::VectorMaker;
 
 class E2EFilterTest : public E2EFilterTestBase {
  protected:
@@ -34,6 +40,11 @@ class E2EFilterTest : public E2EFilterTestBase {
     auto config = std::make_shared<dwrf::Config>();
     config->set(dwrf::Config::COMPRESSION, CompressionKind_NONE);
     config->set(dwrf::Config::USE_VINTS, useVInts_);
+    if (!flatMapColumns_.empty()) {
+      config->set(dwrf::Config::FLATTEN_MAP, true);
+      config->set<const std::vector<uint32_t>>(
+          dwrf::Config::MAP_FLAT_COLS, flatMapColumns_);
+    }
     WriterOptions options;
     options.config = config;
     options.schema = type;
@@ -61,7 +72,28 @@ class E2EFilterTest : public E2EFilterTestBase {
     return std::make_unique<DwrfReader>(opts, std::move(input));
   }
 
+  // Reads with the filters made from 'filterSpecs' once for each limit on
+  // the size of a dictionary whose filter results are computed on load. All
+  // reads must produce the same rows.
+  void testDictionaryPrefill(
+      const std::vector<FilterSpec>& filterSpecs,
+      const std::vector<int32_t>& limits) {
+    std::vector<uint32_t> hitRows;
+    auto filters =
+        filterGenerator->makeSubfieldFilters(filterSpecs, batches_, hitRows);
+    auto spec = filterGenerator->makeScanSpec(std::move(filters));
+    auto savedLimit = FLAGS_max_prefilled_dictionary_entries;
+    for (auto limit : limits) {
+      FLAGS_max_prefilled_dictionary_entries = limit;
+      uint64_t time = 0;
+      readWithFilter(spec, batches_, hitRows, time, false);
+    }
+    FLAGS_max_prefilled_dictionary_entries = savedLimit;
+  }
+
   std::unique_ptr<Writer> writer_;
+  // Top level columns written as flat maps.
+  std::vector<uint32_t> flatMapColumns_;
 };
 
 TEST_F(E2EFilterTest, integerDirect) {
@@ -78,6 +110,22 @@ TEST_F(E2EFilterTest, integerDirect) {
       true);
 }
 
+TEST_F(E2EFilterTest, decodeStripesAhead) {
+  decodingExecutor_ = std::make_shared<folly::CPUThreadPoolExecutor>(4);
+  decodeStripesAhead_ = 2;
+  // Starts a stripe for each batch.
+  flushEveryNBatches_ = 1;
+  testWithTypes(
+      "int_val:int,"
+      "long_val:bigint,"
+      "string_val:string",
+      [&]() {},
+      true,
+      {"int_val", "long_val", "string_val"},
+      10,
+      true);
+}
+
 TEST_F(E2EFilterTest, integerDictionary) {
   testWithTypes(
       "short_val:smallint,"
@@ -178,6 +226,69 @@ TEST_F(E2EFilterTest, stringDictionary) {
       true);
 }
 
+TEST_F(E2EFilterTest, dictionaryFilterPrefill) {
+  // The '_val' columns have dictionaries of a few thousand entries and the
+  // '_large' ones of about 20000, so that the default limit prefills only the
+  // former. The string columns also have mostly unique values that go to the
+  // stride dictionaries.
+  makeRowType(
+      "long_val:bigint,"
+      "long_large:bigint,"
+      "string_val:string,"
+      "string_large:string",
+      false);
+  filterGenerator = std::make_unique<FilterGenerator>(rowType_, 1);
+  makeDataset([&]() {
+    makeIntDistribution<int64_t>(
+        Subfield("long_val"),
+        10, // min
+        100, // max
+        22, // repeats
+        19, // rareFrequency
+        -9999, // rareMin
+        10000000000, // rareMax
+        true); // keepNulls
+    makeIntDistribution<int64_t>(
+        Subfield("long_large"),
+        0, // min
+        20'000, // max
+        0, // repeats
+        0, // rareFrequency
+        0, // rareMin
+        0, // rareMax
+        true); // keepNulls
+    makeStringDistribution(Subfield("string_val"), 50, true, true);
+    int32_t counter = 0;
+    for (auto& batch : batches_) {
+      auto strings = getChildBySubfield(batch.get(), Subfield("string_large"))
+                         ->as<FlatVector<StringView>>();
+      for (auto row = 0; row < strings->size(); ++row) {
+        // Every tenth value keeps its generated value.
+        if (strings->isNullAt(row) || counter++ % 10 == 0) {
+          continue;
+        }
+        std::string value = fmt::format("s{}", counter % 20'000);
+        strings->set(row, StringView(value));
+      }
+    }
+  });
+
+  // 0 leaves all filter results to the first use and 100'000 prefills all
+  // dictionaries.
+  std::vector<int32_t> limits = {
+      0, FLAGS_max_prefilled_dictionary_entries, 100'000};
+  for (auto field : {"long_val", "long_large", "string_val", "string_large"}) {
+    // Ranges of up to 25% fail nulls and wider ones pass them.
+    testDictionaryPrefill({{field, 20, 10}}, limits);
+    testDictionaryPrefill({{field, 10, 60}}, limits);
+    testDictionaryPrefill({{field, 0, 0, FilterKind::kIsNull}}, limits);
+    testDictionaryPrefill({{field, 0, 0, FilterKind::kIsNotNull}}, limits);
+  }
+  testDictionaryPrefill(
+      {{"long_large", 30, 50}, {"string_val", 10, 20}, {"string_large", 0, 40}},
+      limits);
+}
+
 TEST_F(E2EFilterTest, timestamp) {
   testWithTypes(
       "timestamp_val:timestamp,"
@@ -237,3 +348,81 @@ TEST_F(E2EFilterTest, lazyStruct) {
       true,
       false);
 }
+
+TEST_F(E2EFilterTest, flatMap) {
+  constexpr int32_t kRows = 10000;
+  VectorMaker maker(pool_.get());
+  batches_.clear();
+  for (auto i = 0; i < 3; ++i) {
+    auto base = i * kRows;
+    batches_.push_back(maker.rowVector(
+        {"long_val", "map_val"},
+        {maker.flatVector<int64_t>(
+             kRows, [&](vector_size_t row) { return base + row; }),
+         maker.mapVector<int32_t, int64_t>(
+             kRows,
+             [](vector_size_t row) { return row % 4; },
+             [](vector_size_t row, vector_size_t j) { return (row + j) % 6; },
+             [&](vector_size_t row, vector_size_t j) {
+               return (base + row) * 10 + j;
+             },
+             [](vector_size_t row) { return row % 7 == 0; })}));
+  }
+  rowType_ = asRowType(batches_[0]->type());
+  flatMapColumns_ = {1};
+  writeToMemory(rowType_, batches_, false);
+  filterGenerator = std::make_unique<FilterGenerator>(rowType_, 1);
+
+  uint64_t time = 0;
+  readWithoutFilter(
+      filterGenerator->makeScanSpec(SubfieldFilters{}), batches_, time);
+
+  // A filter on the value of one key returns the rows where the key is
+  // present and passes. Extracting the key prunes the map to it.
+  constexpr int64_t kMaxValue = 150000;
+  auto spec = filterGenerator->makeScanSpec(SubfieldFilters{});
+  auto keySpec = spec->getOrCreateChild(Subfield("map_val[2]"));
+  keySpec->setFilter(
+      std::make_unique<velox::common::BigintRange>(0, kMaxValue, false));
+  keySpec->setExtractValues(true);
+
+  auto input = std::make_unique<MemoryInputStream>(
+      sinkPtr_->getData(), sinkPtr_->size());
+  dwio::common::RowReaderOptions rowReaderOpts;
+  rowReaderOpts.setScanSpec(spec);
+  auto reader = makeReader(dwio::common::ReaderOptions{}, std::move(input));
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+  auto batch = BaseVector::create(rowType_, 1, pool_.get());
+  std::vector<int64_t> expected;
+  for (auto& rowVector : batches_) {
+    auto ids = rowVector->childAt(0)->as<FlatVector<int64_t>>();
+    auto maps = rowVector->childAt(1)->as<MapVector>();
+    auto values = maps->mapValues()->as<FlatVector<int64_t>>();
+    auto keys = maps->mapKeys()->as<FlatVector<int32_t>>();
+    for (auto row = 0; row < rowVector->size(); ++row) {
+      if (maps->isNullAt(row)) {
+        continue;
+      }
+      for (auto i = 0; i < maps->sizeAt(row); ++i) {
+        auto index = maps->offsetAt(row) + i;
+        if (keys->valueAt(index) == 2 && values->valueAt(index) <= kMaxValue) {
+          expected.push_back(ids->valueAt(row));
+        }
+      }
+    }
+  }
+  int32_t numHits = 0;
+  while (rowReader->next(1000, batch)) {
+    auto result = batch->as<RowVector>();
+    auto ids = result->childAt(0)->loadedVector()->as<SimpleVector<int64_t>>();
+    auto maps = result->childAt(1)->loadedVector()->as<MapVector>();
+    auto keys = maps->mapKeys()->as<SimpleVector<int32_t>>();
+    for (auto row = 0; row < result->size(); ++row) {
+      ASSERT_LT(numHits, expected.size());
+      ASSERT_EQ(expected[numHits++], ids->valueAt(row));
+      ASSERT_EQ(1, maps->sizeAt(row));
+      ASSERT_EQ(2, keys->valueAt(maps->offsetAt(row)));
+    }
+  }
+  ASSERT_EQ(expected.size(), numHits);
+}
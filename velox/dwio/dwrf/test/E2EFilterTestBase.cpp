@@ -182,6 +182,8 @@ void E2EFilterTestBase::readWithoutFilter(
   ;
   // The spec must stay live over the lifetime of the reader.
   rowReaderOpts.setScanSpec(spec);
+  rowReaderOpts.setDecodingExecutor(decodingExecutor_);
+  rowReaderOpts.setDecodeStripesAhead(decodeStripesAhead_);
   OwnershipChecker ownershipChecker;
   auto rowReader = reader->createRowReader(rowReaderOpts);
 
@@ -232,6 +234,8 @@ void E2EFilterTestBase::readWithFilter(
   auto factory = std::make_unique<SelectiveColumnReaderFactory>(spec);
   // The  spec must stay live over the lifetime of the reader.
   rowReaderOpts.setScanSpec(spec);
+  rowReaderOpts.setDecodingExecutor(decodingExecutor_);
+  rowReaderOpts.setDecodeStripesAhead(decodeStripesAhead_);
   OwnershipChecker ownershipChecker;
   auto rowReader = reader->createRowReader(rowReaderOpts);
   runtimeStats_ = dwio::common::RuntimeStatistics();
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <memory>
 
@@ -292,6 +293,9 @@ class E2EFilterTestBase : public testing::Test {
   int32_t flushEveryNBatches_{10};
   int32_t nextReadSizeIndex_{0};
   std::vector<int32_t> readSizes_;
+  // If set, readers decode this many stripes ahead on 'decodingExecutor_'.
+  std::shared_ptr<folly::Executor> decodingExecutor_;
+  int32_t decodeStripesAhead_{0};
 };
 
 } // namespace facebook::velox::dwio::dwrf
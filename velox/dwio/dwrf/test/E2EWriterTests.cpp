@@ -15,6 +15,7 @@
  */
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <random>
 #include "velox/dwio/common/MemoryInputStream.h"
 #include "velox/dwio/common/Options.h"
@@ -635,6 +636,118 @@ TEST(E2EWriterTests, PartialStride) {
   ASSERT_EQ(true, reader->columnStatistics(1)->hasNull().value());
 }
 
+TEST(E2EWriterTests, parallelEncoding) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "bool_val:boolean,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "timestamp_val:timestamp,"
+      "array_val:array<float>,"
+      "map_val:map<int,double>,"
+      "flat_map_val:map<bigint,string>,"
+      "struct_val:struct<a:float,b:double>"
+      ">");
+  auto config = std::make_shared<Config>();
+  config->set(Config::ROW_INDEX_STRIDE, static_cast<uint32_t>(1000));
+  config->set(Config::FLATTEN_MAP, true);
+  config->set(Config::MAP_FLAT_COLS, {8});
+  // Small blocks so that streams are compressed while columns are written.
+  config->set(Config::COMPRESSION_BLOCK_SIZE, static_cast<uint64_t>(1024));
+
+  std::vector<VectorPtr> batches;
+  for (auto i = 0; i < 6; ++i) {
+    batches.push_back(BatchMaker::createBatch(type, 2'000, pool, nullptr, i));
+  }
+
+  auto write = [&](std::shared_ptr<folly::Executor> executor) {
+    auto sink = std::make_unique<MemorySink>(pool, 200 * kSizeMB);
+    auto* sinkPtr = sink.get();
+    WriterOptions options;
+    options.config = config;
+    options.schema = type;
+    options.flushPolicyFactory =
+        E2EWriterTestUtil::simpleFlushPolicyFactory(false);
+    options.encodingExecutor = std::move(executor);
+    Writer writer{options, std::move(sink), pool};
+    for (size_t i = 0; i < batches.size(); ++i) {
+      writer.write(batches[i]);
+      // Two batches per stripe.
+      if (i % 2 == 1) {
+        writer.flush();
+      }
+    }
+    writer.close();
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  };
+
+  auto serial = write(nullptr);
+  auto parallel = write(std::make_shared<folly::CPUThreadPoolExecutor>(4));
+  // The file does not depend on the threads that encode it.
+  EXPECT_EQ(serial, parallel);
+
+  auto input =
+      std::make_unique<MemoryInputStream>(parallel.data(), parallel.size());
+  ReaderOptions readerOpts;
+  auto reader = std::make_unique<DwrfReader>(readerOpts, std::move(input));
+  EXPECT_EQ(reader->getNumberOfStripes(), 3);
+  EXPECT_EQ(reader->numberOfRows(), 12'000ULL);
+}
+
+TEST(E2EWriterTests, asyncFlush) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "int_val:int,"
+      "string_val:string,"
+      "array_val:array<float>,"
+      "map_val:map<int,double>"
+      ">");
+  auto config = std::make_shared<Config>();
+  config->set(Config::ROW_INDEX_STRIDE, static_cast<uint32_t>(1000));
+
+  std::vector<VectorPtr> batches;
+  for (auto i = 0; i < 6; ++i) {
+    batches.push_back(BatchMaker::createBatch(type, 2'000, pool, nullptr, i));
+  }
+
+  auto write = [&](std::shared_ptr<folly::Executor> executor) {
+    auto sink = std::make_unique<MemorySink>(pool, 200 * kSizeMB);
+    auto* sinkPtr = sink.get();
+    WriterOptions options;
+    options.config = config;
+    options.schema = type;
+    options.flushPolicyFactory =
+        E2EWriterTestUtil::simpleFlushPolicyFactory(false);
+    options.flushExecutor = std::move(executor);
+    Writer writer{options, std::move(sink), pool};
+    // One stripe per batch.
+    for (auto& batch : batches) {
+      writer.write(batch);
+      writer.flush();
+    }
+    writer.close();
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  };
+
+  auto serial = write(nullptr);
+  auto async = write(std::make_shared<folly::CPUThreadPoolExecutor>(1));
+  EXPECT_EQ(serial, async);
+
+  auto input = std::make_unique<MemoryInputStream>(async.data(), async.size());
+  ReaderOptions readerOpts;
+  auto reader = std::make_unique<DwrfReader>(readerOpts, std::move(input));
+  EXPECT_EQ(reader->getNumberOfStripes(), 6);
+  EXPECT_EQ(reader->numberOfRows(), 12'000ULL);
+}
+
 TEST(E2EWriterTests, OversizeRows) {
   auto scopedPool = facebook::velox::memory::getDefaultScopedMemoryPool();
   auto& pool = scopedPool->getPool();
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares the DWRF files written with the threshold based choice between
+// dictionary and direct encoding to the ones written with
+// Config::ENCODING_COST_BASED_SELECTION. Prints the file sizes and
+// benchmarks reading each file.
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/common/MemoryInputStream.h"
+#include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/vector/FlatVector.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwrf;
+
+using dwio::common::MemoryInputStream;
+using dwio::common::MemorySink;
+
+namespace {
+
+constexpr int32_t kNumBatches = 100;
+constexpr int32_t kBatchSize = 10'000;
+
+struct File {
+  std::string name;
+  // Owns the sink that holds the file.
+  std::unique_ptr<Writer> writer;
+  MemorySink* sink;
+};
+
+class EncodingSelectionBenchmark {
+ public:
+  EncodingSelectionBenchmark() : pool_(memory::getDefaultScopedMemoryPool()) {}
+
+  // Writes a file with the values of 'valueAt' for all rows, once with each
+  // way of choosing the encoding. For StringView, 'valueAt' returns
+  // std::string.
+  template <typename T, typename F>
+  void addData(const std::string& name, F valueAt) {
+    std::vector<RowVectorPtr> batches;
+    for (auto i = 0; i < kNumBatches; ++i) {
+      auto values = BaseVector::create<FlatVector<T>>(
+          CppToType<T>::create(), kBatchSize, pool_.get());
+      for (auto row = 0; row < kBatchSize; ++row) {
+        auto value = valueAt(i * kBatchSize + row);
+        values->set(row, T(value));
+      }
+      batches.push_back(std::make_shared<RowVector>(
+          pool_.get(),
+          ROW({"c0"}, {values->type()}),
+          nullptr,
+          kBatchSize,
+          std::vector<VectorPtr>{values}));
+    }
+    files_.push_back(write(name + "_thresholds", batches, false));
+    files_.push_back(write(name + "_cost_based", batches, true));
+  }
+
+  const std::vector<File>& files() const {
+    return files_;
+  }
+
+  // Reads all the rows of 'file'.
+  void read(const File& file) {
+    auto reader = std::make_unique<DwrfReader>(
+        dwio::common::ReaderOptions{},
+        std::make_unique<MemoryInputStream>(
+            file.sink->getData(), file.sink->size()));
+    auto spec = std::make_shared<common::ScanSpec>("root");
+    auto* child = spec->getOrCreateChild(common::Subfield("c0"));
+    child->setProjectOut(true);
+    child->setExtractValues(true);
+    child->setChannel(0);
+    dwio::common::RowReaderOptions rowReaderOpts;
+    rowReaderOpts.setScanSpec(spec);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    VectorPtr batch = BaseVector::create(reader->rowType(), 0, pool_.get());
+    uint64_t numRows = 0;
+    while (rowReader->next(kBatchSize, batch)) {
+      numRows += batch->size();
+    }
+    folly::doNotOptimizeAway(numRows);
+  }
+
+ private:
+  File write(
+      const std::string& name,
+      const std::vector<RowVectorPtr>& batches,
+      bool costBasedSelection) {
+    auto config = std::make_shared<Config>();
+    config->set(Config::ENCODING_COST_BASED_SELECTION, costBasedSelection);
+    WriterOptions options;
+    options.config = config;
+    options.schema = batches[0]->type();
+    auto sink = std::make_unique<MemorySink>(*pool_, 64 << 20);
+    auto* sinkPtr = sink.get();
+    auto writer = std::make_unique<Writer>(options, std::move(sink), *pool_);
+    for (auto& batch : batches) {
+      writer->write(batch);
+    }
+    writer->close();
+    return {name, std::move(writer), sinkPtr};
+  }
+
+  std::unique_ptr<memory::MemoryPool> pool_;
+  std::vector<File> files_;
+};
+
+std::unique_ptr<EncodingSelectionBenchmark> benchmark;
+
+void makeFiles() {
+  // Small integers that each occur twice in random order. The key size
+  // threshold keeps the dictionary although the varints are as short as
+  // the indices.
+  benchmark->addData<int64_t>(
+      "small_repeated_ints", [](auto row) { return row * 7919 % 500'000; });
+  // Few distinct large integers, which both choices write as a dictionary.
+  benchmark->addData<int64_t>("few_large_ints", [](auto row) {
+    return 1'000'000'000'000 + (row % 1'000) * 1'000'003;
+  });
+  // Short strings that each occur twice.
+  benchmark->addData<StringView>("short_repeated_strings", [](auto row) {
+    return fmt::format("{}", row * 7919 % 500'000);
+  });
+  // Long strings of medium cardinality.
+  benchmark->addData<StringView>("long_strings", [](auto row) {
+    return fmt::format(
+        "a somewhat longer string value number {}", row * 7919 % 100'000);
+  });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<EncodingSelectionBenchmark>();
+  makeFiles();
+  for (const auto& file : benchmark->files()) {
+    std::cout << fmt::format("{}: {} bytes", file.name, file.sink->size())
+              << std::endl;
+    folly::addBenchmark(__FILE__, file.name, [&file]() -> unsigned {
+      benchmark->read(file);
+      return 1;
+    });
+  }
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -119,6 +119,22 @@ TEST(DefaultFlushPolicyTest, AdditionalCriteriaTest) {
   }
 }
 
+TEST(DefaultFlushPolicyTest, AbandonDictionaryTest) {
+  constexpr auto kMinRows = DefaultFlushPolicy::kMinRowsToAbandonDictionary;
+  // A dictionary larger than the raw data is abandoned in the first stripe.
+  EXPECT_TRUE(DefaultFlushPolicy::shouldAbandonDictionary(
+      0, kMinRows, 1'000, 2'000));
+  // Not before the minimum number of rows.
+  EXPECT_FALSE(DefaultFlushPolicy::shouldAbandonDictionary(
+      0, kMinRows - 1, 1'000, 2'000));
+  // Not if the values repeat.
+  EXPECT_FALSE(DefaultFlushPolicy::shouldAbandonDictionary(
+      0, kMinRows, 1'000, 500));
+  // Not after the first stripe.
+  EXPECT_FALSE(DefaultFlushPolicy::shouldAbandonDictionary(
+      1, kMinRows, 1'000, 2'000));
+}
+
 TEST(StaticBudgetFlushPolicyTest, StripeProgressTest) {
   struct TestCase {
     const uint64_t stripeSizeThreshold;
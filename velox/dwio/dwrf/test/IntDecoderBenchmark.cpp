@@ -24,6 +24,7 @@
 #include "folly/lang/Bits.h"
 #include "velox/common/base/BitUtil.h"
 #include "velox/dwio/common/exception/Exception.h"
+#include "velox/dwio/dwrf/common/BitUnpack.h"
 #include "velox/dwio/dwrf/common/IntCodecCommon.h"
 #include "velox/dwio/dwrf/common/IntDecoder.h"
 
@@ -937,6 +938,106 @@ BENCHMARK_RELATIVE(decodeNew_64) {
       randomInts_u64.size(), buffer_u64.data(), randomInts_u64_result.data());
 }
 
+// Values of the given bit width packed most significant bit first as in
+// RLEv2 DIRECT runs.
+struct PackedInts {
+  int32_t bitWidth;
+  std::vector<uint8_t> buffer;
+  std::vector<uint64_t> result;
+};
+
+const int32_t kNumPacked = 100000;
+PackedInts packed_7{7};
+PackedInts packed_17{17};
+PackedInts packed_33{33};
+PackedInts packed_60{60};
+
+void pack(PackedInts& packed) {
+  packed.buffer.resize(
+      (kNumPacked * packed.bitWidth + 7) / 8 + kBitUnpackPadding);
+  packed.result.resize(kNumPacked);
+  const uint64_t mask = packed.bitWidth == 64
+      ? ~0ULL
+      : (1ULL << packed.bitWidth) - 1;
+  uint64_t bit = 0;
+  for (int32_t i = 0; i < kNumPacked; ++i) {
+    auto value = folly::Random::rand64() & mask;
+    for (int32_t j = packed.bitWidth - 1; j >= 0; --j, ++bit) {
+      if (value & (1ULL << j)) {
+        packed.buffer[bit / 8] |= 0x80 >> (bit % 8);
+      }
+    }
+  }
+}
+
+// Bit at a time unpacking as in RleDecoderV2::readLongs before
+// unpackBitsBigEndian().
+void unpackOld(PackedInts& packed) {
+  const uint8_t* input = packed.buffer.data();
+  uint32_t bitsLeft = 0;
+  uint32_t curByte = 0;
+  for (int32_t i = 0; i < kNumPacked; ++i) {
+    uint64_t result = 0;
+    uint64_t bitsLeftToRead = packed.bitWidth;
+    while (bitsLeftToRead > bitsLeft) {
+      result <<= bitsLeft;
+      result |= curByte & ((1 << bitsLeft) - 1);
+      bitsLeftToRead -= bitsLeft;
+      curByte = *input++;
+      bitsLeft = 8;
+    }
+    if (bitsLeftToRead > 0) {
+      result <<= bitsLeftToRead;
+      bitsLeft -= static_cast<uint32_t>(bitsLeftToRead);
+      result |= (curByte >> bitsLeft) & ((1 << bitsLeftToRead) - 1);
+    }
+    packed.result[i] = result;
+  }
+  folly::doNotOptimizeAway(packed.result[kNumPacked - 1]);
+}
+
+void unpackNew(PackedInts& packed) {
+  unpackBitsBigEndian(
+      packed.buffer.data(),
+      0,
+      packed.bitWidth,
+      kNumPacked,
+      packed.result.data());
+  folly::doNotOptimizeAway(packed.result[kNumPacked - 1]);
+}
+
+BENCHMARK(unpackOld_7) {
+  unpackOld(packed_7);
+}
+
+BENCHMARK_RELATIVE(unpackNew_7) {
+  unpackNew(packed_7);
+}
+
+BENCHMARK(unpackOld_17) {
+  unpackOld(packed_17);
+}
+
+BENCHMARK_RELATIVE(unpackNew_17) {
+  unpackNew(packed_17);
+}
+
+BENCHMARK(unpackOld_33) {
+  unpackOld(packed_33);
+}
+
+BENCHMARK_RELATIVE(unpackNew_33) {
+  unpackNew(packed_33);
+}
+
+BENCHMARK(unpackOld_60) {
+  unpackOld(packed_60);
+}
+
+BENCHMARK_RELATIVE(unpackNew_60) {
+  unpackNew(packed_60);
+}
+
 int32_t main(int32_t argc, char* argv[]) {
   folly::init(&argc, &argv);
 
@@ -973,6 +1074,11 @@ int32_t main(int32_t argc, char* argv[]) {
   randomInts_u64_result.resize(randomInts_u64.size());
   len_u64 = pos;
 
+  pack(packed_7);
+  pack(packed_17);
+  pack(packed_33);
+  pack(packed_60);
+
   folly::runBenchmarks();
   return 0;
 }
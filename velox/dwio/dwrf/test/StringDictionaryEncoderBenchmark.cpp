@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/dwio/dwrf/writer/StringDictionaryEncoder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwrf;
+
+// Measures adding kNumKeys strings to a StringDictionaryEncoder one at a time
+// with addKey() and in one call to addKeys(), for a low and for a high
+// cardinality column.
+namespace {
+constexpr int32_t kNumKeys = 1'000'000;
+
+std::unique_ptr<memory::ScopedMemoryPool> pool;
+// 1000 distinct values.
+std::vector<std::string> lowCardinality;
+// All values distinct.
+std::vector<std::string> highCardinality;
+
+void makeData() {
+  for (auto i = 0; i < kNumKeys; ++i) {
+    lowCardinality.push_back(
+        fmt::format("value-{}", folly::Random::rand32(1'000)));
+    highCardinality.push_back(fmt::format("a longer distinct value {}", i));
+  }
+}
+
+void addKey(const std::vector<std::string>& strings) {
+  StringDictionaryEncoder encoder{pool->getPool(), pool->getPool()};
+  for (auto& string : strings) {
+    folly::doNotOptimizeAway(encoder.addKey(string, 0));
+  }
+}
+
+void addKeys(const std::vector<std::string>& strings) {
+  folly::BenchmarkSuspender suspender;
+  std::vector<StringView> keys;
+  keys.reserve(strings.size());
+  for (auto& string : strings) {
+    keys.emplace_back(string);
+  }
+  std::vector<uint32_t> indices(keys.size());
+  suspender.dismiss();
+  StringDictionaryEncoder encoder{pool->getPool(), pool->getPool()};
+  encoder.addKeys(
+      folly::Range<const StringView*>(keys.data(), keys.size()),
+      0,
+      indices.data());
+  folly::doNotOptimizeAway(indices);
+}
+
+BENCHMARK(addKeyLowCardinality) {
+  addKey(lowCardinality);
+}
+
+BENCHMARK_RELATIVE(addKeysLowCardinality) {
+  addKeys(lowCardinality);
+}
+
+BENCHMARK(addKeyHighCardinality) {
+  addKey(highCardinality);
+}
+
+BENCHMARK_RELATIVE(addKeysHighCardinality) {
+  addKeys(highCardinality);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  pool = memory::getDefaultScopedMemoryPool();
+  makeData();
+  folly::runBenchmarks();
+  pool.reset();
+  return 0;
+}
@@ -303,6 +303,49 @@ TEST(ByteRle, testAllNulls) {
   rle->next(data.data(), data.size(), allNull.data());
 }
 
+TEST(ByteRle, nullRanges) {
+  // Alternating runs of 20 and literals of 50 values, read in blocks of 7
+  // bytes so that ranges of non-nulls cross headers and buffers.
+  std::vector<char> buffer;
+  std::vector<char> expected;
+  for (auto i = 0; i < 40; ++i) {
+    buffer.push_back(20 - 3);
+    buffer.push_back(i);
+    expected.insert(expected.end(), 20, i);
+    buffer.push_back(-50);
+    for (auto j = 0; j < 50; ++j) {
+      buffer.push_back(i + j);
+      expected.push_back(i + j);
+    }
+  }
+  const int32_t numValues = 2'000;
+  std::vector<uint64_t> nulls(bits::nwords(numValues), bits::kNotNull64);
+  for (auto i = 0; i < numValues; ++i) {
+    // Ranges of nulls and non-nulls of varying lengths.
+    if ((i / 7) % 3 == 1 || i % 64 == 63 || (i >= 500 && i < 700)) {
+      bits::setNull(nulls.data(), i);
+    }
+  }
+  auto rle = createByteDecoder(std::make_unique<SeekableArrayInputStream>(
+      buffer.data(), buffer.size(), 7));
+  std::vector<char> data(numValues, -1);
+  rle->next(data.data(), numValues, nulls.data());
+  int32_t numNonNull = 0;
+  for (auto i = 0; i < numValues; ++i) {
+    if (bits::isBitNull(nulls.data(), i)) {
+      EXPECT_EQ(-1, data[i]) << "Output wrong at " << i;
+    } else {
+      EXPECT_EQ(expected[numNonNull++], data[i]) << "Output wrong at " << i;
+    }
+  }
+  // The rest of the stream continues after the last non-null.
+  data.resize(expected.size() - numNonNull);
+  rle->next(data.data(), data.size(), nullptr);
+  for (auto i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(expected[numNonNull + i], data[i]) << "Output wrong at " << i;
+  }
+}
+
 TEST(ByteRle, testSkip) {
   // the stream generated by Java's TestRunLengthByteReader.testSkips
   // for (int32_t i = 0; i < 2048; ++i) {
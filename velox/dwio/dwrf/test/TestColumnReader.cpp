@@ -111,6 +111,10 @@ class SelectiveColumnReaderBuilder {
         FlatMapContext::nonFlatMapContext());
   }
 
+  common::ScanSpec* scanSpec() const {
+    return scanSpec_.get();
+  }
+
  private:
   std::unique_ptr<common::ScanSpec> scanSpec_;
 };
@@ -4755,6 +4759,54 @@ TEST_P(SchemaMismatchTest, testFloat) {
   runTest<float, double>(size);
 }
 
+TEST_P(SchemaMismatchTest, testFloatWithFilter) {
+  if (!useSelectiveReader()) {
+    return;
+  }
+  proto::ColumnEncoding directEncoding;
+  directEncoding.set_kind(proto::ColumnEncoding_Kind_DIRECT);
+  EXPECT_CALL(streams, getEncodingProxy(_))
+      .WillRepeatedly(Return(&directEncoding));
+  EXPECT_CALL(streams, getStreamProxy(_, _, _)).WillRepeatedly(Return(nullptr));
+  // Every other row is null.
+  auto nulls = folly::make_array<char>(0x7f, 0x55);
+  EXPECT_CALL(streams, getStreamProxy(1, proto::Stream_Kind_PRESENT, false))
+      .WillRepeatedly(
+          Invoke([&](auto /* unused */, auto /* unused */, auto /* unused */) {
+            return new SeekableArrayInputStream(nulls.data(), nulls.size());
+          }));
+  constexpr auto size = 100;
+  std::array<float, size / 2> data;
+  for (auto i = 0; i < data.size(); ++i) {
+    data[i] = i;
+  }
+  EXPECT_CALL(streams, getStreamProxy(1, proto::Stream_Kind_DATA, true))
+      .WillRepeatedly(
+          Invoke([&](auto /* unused */, auto /* unused */, auto /* unused */) {
+            return new SeekableArrayInputStream(
+                reinterpret_cast<char*>(data.data()),
+                data.size() * sizeof(float));
+          }));
+
+  // The REAL column is read as DOUBLE with a filter selecting [10, 30).
+  auto dataType = ROW({"c0"}, {REAL()});
+  auto requestedType = ROW({"c0"}, {DOUBLE()});
+  auto reader =
+      buildReader(builder_, requestedType, streams, {}, false, dataType);
+  builder_.scanSpec()->childByName("c0")->setFilter(
+      std::make_unique<common::FloatRange>(
+          10, false, false, 30, false, true, false));
+  auto batch = newBatch(requestedType);
+  reader->next(size, batch, nullptr);
+
+  ASSERT_EQ(20, batch->size());
+  auto field = getOnlyChild<SimpleVector<double>>(batch);
+  for (auto i = 0; i < batch->size(); ++i) {
+    ASSERT_FALSE(field->isNullAt(i));
+    EXPECT_EQ(10 + i, field->valueAt(i));
+  }
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     SchemaMismatch,
     SchemaMismatchTest,
@@ -21,6 +21,7 @@
 #include "velox/dwio/dwrf/test/OrcTest.h"
 
 #include <folly/Random.h>
+#include <folly/ScopeGuard.h>
 #include <gtest/gtest.h>
 
 #include <algorithm>
@@ -143,6 +144,8 @@ typedef std::tuple<CompressionKind, const Encrypter*, const Decrypter*>
     TestParams;
 TestEncrypter testEncrypter;
 TestDecrypter testDecrypter;
+TestStreamEncrypter testStreamEncrypter;
+TestStreamDecrypter testStreamDecrypter;
 
 class CompressionTest : public TestWithParam<TestParams> {
  public:
@@ -237,6 +240,131 @@ TEST_P(CompressionTest, compressRandomBytes) {
       memSink, kind_, block, testData, dataSize, pool, decrypter_);
 }
 
+// Reads the decompressed data with readFully in 'readSize' pieces from an
+// input that returns ranges of 'inputRangeSize' bytes, so that compressed
+// blocks span input ranges and reads span blocks.
+void readFullyAndVerify(
+    const MemorySink& memSink,
+    CompressionKind kind,
+    uint64_t blockSize,
+    uint64_t inputRangeSize,
+    size_t readSize,
+    const char* data,
+    size_t size,
+    MemoryPool& pool,
+    const Decrypter* decrypter) {
+  std::unique_ptr<SeekableInputStream> inputStream(new SeekableArrayInputStream(
+      memSink.getData(), memSink.size(), inputRangeSize));
+
+  std::unique_ptr<SeekableInputStream> decompressStream = createDecompressor(
+      kind,
+      std::move(inputStream),
+      blockSize,
+      pool,
+      "Test Comrpession",
+      decrypter);
+
+  std::vector<char> buffer(readSize);
+  for (size_t pos = 0; pos < size; pos += readSize) {
+    auto bytes = std::min(readSize, size - pos);
+    decompressStream->readFully(buffer.data(), bytes);
+    ASSERT_EQ(0, memcmp(data + pos, buffer.data(), bytes)) << pos;
+  }
+  const void* chunk;
+  int32_t chunkSize;
+  EXPECT_FALSE(decompressStream->Next(&chunk, &chunkSize));
+}
+
+TEST_P(CompressionTest, readFullyAcrossRanges) {
+  auto scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  MemorySink memSink(pool, DEFAULT_MEM_STREAM_SIZE);
+
+  uint64_t block = 1024;
+  constexpr size_t dataSize = 256 * 1024;
+
+  std::vector<char> testData(dataSize);
+  generateRandomData(testData.data(), dataSize, true);
+  compressAndVerify(
+      kind_, memSink, block, pool, testData.data(), dataSize, encrypter_);
+  // Reads of less than, exactly and more than a block from ranges of less
+  // and more than a compressed block.
+  for (auto inputRangeSize : {100, 5000}) {
+    for (auto readSize : {700, 1024, 3000}) {
+      readFullyAndVerify(
+          memSink,
+          kind_,
+          block,
+          inputRangeSize,
+          readSize,
+          testData.data(),
+          dataSize,
+          pool,
+          decrypter_);
+    }
+  }
+}
+
+// Decompresses in software and fails every other block to exercise the
+// fallback.
+class TestAsyncDecompressor : public AsyncDecompressor {
+ public:
+  bool supports(CompressionKind kind) const override {
+    return kind == CompressionKind_ZSTD || kind == CompressionKind_ZLIB;
+  }
+
+  folly::SemiFuture<std::vector<std::optional<uint64_t>>> submit(
+      CompressionKind kind,
+      const std::vector<Block>& blocks) override {
+    std::vector<std::optional<uint64_t>> lengths;
+    for (auto& block : blocks) {
+      if (numSubmitted_++ % 2) {
+        lengths.push_back(std::nullopt);
+        continue;
+      }
+      auto decompressor =
+          createBlockDecompressor(kind, block.outputCapacity, "Test");
+      lengths.push_back(decompressor->decompress(
+          block.input, block.inputLength, block.output, block.outputCapacity));
+    }
+    return folly::makeSemiFuture(std::move(lengths));
+  }
+
+  int32_t numSubmitted() const {
+    return numSubmitted_;
+  }
+
+ private:
+  int32_t numSubmitted_{0};
+};
+
+TEST_P(CompressionTest, asyncDecompressor) {
+  auto scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  MemorySink memSink(pool, DEFAULT_MEM_STREAM_SIZE);
+
+  uint64_t block = 1024;
+  constexpr size_t dataSize = 64 * 1024;
+
+  std::vector<char> testData(dataSize);
+  generateRandomData(testData.data(), dataSize, true);
+  compressAndVerify(
+      kind_, memSink, block, pool, testData.data(), dataSize, encrypter_);
+
+  auto engine = std::make_shared<TestAsyncDecompressor>();
+  registerAsyncDecompressor(engine);
+  SCOPE_EXIT {
+    registerAsyncDecompressor(nullptr);
+  };
+  decompressAndVerify(
+      memSink, kind_, block, testData.data(), dataSize, pool, decrypter_);
+  if (kind_ == CompressionKind_NONE) {
+    EXPECT_EQ(0, engine->numSubmitted());
+  } else {
+    EXPECT_LT(0, engine->numSubmitted());
+  }
+}
+
 void verifyProto(
     const MemorySink& memSink,
     CompressionKind kind,
@@ -289,10 +417,18 @@ VELOX_INSTANTIATE_TEST_SUITE_P(
     Values(
         std::make_tuple(CompressionKind_ZLIB, nullptr, nullptr),
         std::make_tuple(CompressionKind_ZLIB, &testEncrypter, &testDecrypter),
+        std::make_tuple(
+            CompressionKind_ZLIB, &testStreamEncrypter, &testStreamDecrypter),
         std::make_tuple(CompressionKind_ZSTD, nullptr, nullptr),
         std::make_tuple(CompressionKind_ZSTD, &testEncrypter, &testDecrypter),
+        std::make_tuple(
+            CompressionKind_ZSTD, &testStreamEncrypter, &testStreamDecrypter),
         std::make_tuple(CompressionKind_NONE, nullptr, nullptr),
-        std::make_tuple(CompressionKind_NONE, &testEncrypter, &testDecrypter)));
+        std::make_tuple(CompressionKind_NONE, &testEncrypter, &testDecrypter),
+        std::make_tuple(
+            CompressionKind_NONE,
+            &testStreamEncrypter,
+            &testStreamDecrypter)));
 
 typedef std::tuple<CompressionKind, const Encrypter*> TestParams2;
 
@@ -361,4 +361,38 @@ TEST(RleEncoderV1Test, backfillPosition) {
   }
 }
 
+TEST(RleEncoderV1Test, nextRuns) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+  MemorySink memSink(pool, DEFAULT_MEM_STREAM_SIZE);
+
+  uint64_t block = 1024;
+  DataBufferHolder holder{pool, block, 0, DEFAULT_PAGE_GROW_RATIO, &memSink};
+
+  RleEncoderV1<true> encoder(
+      std::make_unique<BufferedOutputStream>(holder), true, 8);
+
+  // A run longer than the longest repeat of the encoding, literals, a short
+  // repeat and a repeat with a delta.
+  std::vector<int64_t> data(300, 7);
+  for (auto value : {1, 2, 2, -3, -3, -3, -3, -3, 10, 11, 12, 13, 14}) {
+    data.push_back(value);
+  }
+  encoder.add(data.data(), Ranges::of(0, data.size()), nullptr);
+  encoder.flush();
+
+  RleDecoderV1<true> decoder(
+      std::make_unique<SeekableArrayInputStream>(
+          memSink.getData(), memSink.size()),
+      true,
+      INT_BYTE_SIZE);
+  std::vector<int64_t> values;
+  std::vector<int32_t> lengths;
+  decoder.nextRuns(150, values, lengths);
+  decoder.nextRuns(data.size() - 150, values, lengths);
+
+  EXPECT_EQ(std::vector<int64_t>({7, 1, 2, -3, 10, 11, 12, 13, 14}), values);
+  EXPECT_EQ(std::vector<int32_t>({300, 1, 2, 5, 1, 1, 1, 1, 1}), lengths);
+}
+
 } // namespace facebook::velox::dwrf
@@ -24,6 +24,7 @@
 #include "velox/dwio/common/MemoryInputStream.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/reader/FileTailCache.h"
 #include "velox/dwio/dwrf/test/OrcTest.h"
 #include "velox/dwio/dwrf/test/utils/BatchMaker.h"
 #include "velox/dwio/dwrf/test/utils/E2EWriterTestUtil.h"
@@ -66,6 +67,42 @@ TEST(TestReader, testCompressionNames) {
       compressionKindToString(static_cast<CompressionKind>(99)));
 }
 
+TEST(TestReader, fileTailCache) {
+  const std::string fmSmall(getExampleFilePath("fm_small.orc"));
+  // Returns the footer and the number of rows read.
+  auto readRows = [&](const std::string& key) {
+    ReaderOptions readerOpts;
+    readerOpts.setFileTailCacheKey(key);
+    auto reader = DwrfReader::create(
+        std::make_unique<FileInputStream>(fmSmall), readerOpts);
+    auto rowReader = reader->createRowReader(RowReaderOptions());
+    VectorPtr batch;
+    uint64_t numRows = 0;
+    while (rowReader->next(1'000, batch)) {
+      numRows += batch->size();
+    }
+    return std::make_pair(&reader->getFooter(), numRows);
+  };
+
+  const std::string key = fmSmall + ":1:1";
+  EXPECT_EQ(nullptr, FileTailCache::instance().find(key));
+  auto [first, firstRows] = readRows(key);
+  auto tail = FileTailCache::instance().find(key);
+  ASSERT_NE(nullptr, tail);
+  EXPECT_EQ(tail->footer, first);
+  EXPECT_LT(0, firstRows);
+
+  // A second reader of the file reads with the cached footer.
+  auto [second, secondRows] = readRows(key);
+  EXPECT_EQ(tail->footer, second);
+  EXPECT_EQ(firstRows, secondRows);
+
+  // Without a key the reader parses the footer itself.
+  auto [uncached, uncachedRows] = readRows("");
+  EXPECT_NE(tail->footer, uncached);
+  EXPECT_EQ(firstRows, uncachedRows);
+}
+
 // schema of flat map sample file
 // struct {
 //   id int,
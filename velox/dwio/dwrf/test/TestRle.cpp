@@ -15,9 +15,11 @@
  */
 
 #include <gtest/gtest.h>
+#include <random>
 
 #include "velox/common/base/Nulls.h"
 #include "velox/dwio/common/SeekableInputStream.h"
+#include "velox/dwio/dwrf/common/BitUnpack.h"
 #include "velox/dwio/dwrf/common/IntDecoder.h"
 #include "velox/dwio/dwrf/test/OrcTest.h"
 
@@ -3030,3 +3032,31 @@ TEST(RLEv1, testLeadingNulls) {
     EXPECT_EQ(i - 4, data[i]) << "Output wrong at " << i;
   }
 }
+
+TEST(RLEv2, unpackBitsBigEndian) {
+  constexpr int32_t kNumValues = 1000;
+  std::mt19937_64 rng(1);
+  for (int32_t bitWidth = 1; bitWidth <= 64; ++bitWidth) {
+    for (int32_t bitOffset = 0; bitOffset < 8; ++bitOffset) {
+      std::vector<uint8_t> buffer(
+          (bitOffset + kNumValues * bitWidth + 7) / 8 + kBitUnpackPadding);
+      std::vector<uint64_t> expected(kNumValues);
+      const uint64_t mask =
+          bitWidth == 64 ? ~0ULL : (1ULL << bitWidth) - 1;
+      uint64_t bit = bitOffset;
+      for (auto i = 0; i < kNumValues; ++i) {
+        expected[i] = rng() & mask;
+        for (auto j = bitWidth - 1; j >= 0; --j, ++bit) {
+          if (expected[i] & (1ULL << j)) {
+            buffer[bit / 8] |= 0x80 >> (bit % 8);
+          }
+        }
+      }
+      std::vector<uint64_t> result(kNumValues);
+      unpackBitsBigEndian(
+          buffer.data(), bitOffset, bitWidth, kNumValues, result.data());
+      ASSERT_EQ(expected, result) << "bitWidth " << bitWidth << " bitOffset "
+                                  << bitOffset;
+    }
+  }
+}
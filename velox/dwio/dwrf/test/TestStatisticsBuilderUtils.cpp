@@ -309,3 +309,132 @@ TEST(TestStatisticsBuilderUtils, addBinaryValues) {
     EXPECT_EQ(106, binStats->getTotalLength().value());
   }
 }
+
+TEST(TestStatisticsBuilderUtils, addValuesInRuns) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+  size_t size = 300;
+
+  // The first run has no nulls and the second has a null every 7 rows.
+  Ranges ranges;
+  ranges.add(10, 150);
+  ranges.add(160, 300);
+  auto nulls = allocateNulls(size, &pool);
+  for (size_t i = 160; i < size; i += 7) {
+    bits::setNull(nulls->asMutable<uint64_t>(), i);
+  }
+
+  auto intValues = AlignedBuffer::allocate<int64_t>(size, &pool);
+  auto doubleValues = AlignedBuffer::allocate<double>(size, &pool);
+  auto stringValues = AlignedBuffer::allocate<StringView>(size, &pool);
+  std::vector<std::string> strings(size);
+  for (size_t i = 0; i < size; ++i) {
+    intValues->asMutable<int64_t>()[i] = (i * 7919) % 1000 - 500;
+    doubleValues->asMutable<double>()[i] = ((i * 7919) % 1000) * 0.25;
+    strings[i] = std::string(i % 20, 'a' + (i * 7) % 26);
+    stringValues->asMutable<StringView>()[i] = StringView(strings[i]);
+  }
+  auto isNull = [&](size_t pos) {
+    return bits::isBitNull(nulls->as<uint64_t>(), pos);
+  };
+
+  {
+    IntegerStatisticsBuilder builder{options};
+    IntegerStatisticsBuilder expected{options};
+    StatisticsBuilderUtils::addValues<int64_t>(
+        builder,
+        makeFlatVector<int64_t>(&pool, nulls, 20, size, intValues),
+        ranges);
+    for (auto pos : ranges) {
+      if (isNull(pos)) {
+        expected.setHasNull();
+      } else {
+        expected.addValues(intValues->as<int64_t>()[pos]);
+      }
+    }
+    auto stats = builder.build();
+    auto intStats = dynamic_cast<IntegerColumnStatistics*>(stats.get());
+    auto expectedStats = expected.build();
+    auto& expectedInt = dynamic_cast<IntegerColumnStatistics&>(*expectedStats);
+    EXPECT_EQ(expectedInt.getNumberOfValues(), intStats->getNumberOfValues());
+    EXPECT_TRUE(intStats->hasNull().value());
+    EXPECT_EQ(expectedInt.getMinimum(), intStats->getMinimum());
+    EXPECT_EQ(expectedInt.getMaximum(), intStats->getMaximum());
+    EXPECT_EQ(expectedInt.getSum(), intStats->getSum());
+
+    // A run whose sum overflows.
+    intValues->asMutable<int64_t>()[20] = std::numeric_limits<int64_t>::max();
+    intValues->asMutable<int64_t>()[21] = std::numeric_limits<int64_t>::max();
+    StatisticsBuilderUtils::addValues<int64_t>(
+        builder,
+        makeFlatVectorNoNulls<int64_t>(&pool, size, intValues),
+        Ranges::of(0, 100));
+    stats = builder.build();
+    intStats = dynamic_cast<IntegerColumnStatistics*>(stats.get());
+    EXPECT_EQ(
+        std::numeric_limits<int64_t>::max(), intStats->getMaximum().value());
+    EXPECT_FALSE(intStats->getSum().has_value());
+  }
+
+  {
+    DoubleStatisticsBuilder builder{options};
+    DoubleStatisticsBuilder expected{options};
+    StatisticsBuilderUtils::addValues<double>(
+        builder,
+        makeFlatVector<double>(&pool, nulls, 20, size, doubleValues),
+        ranges);
+    for (auto pos : ranges) {
+      if (isNull(pos)) {
+        expected.setHasNull();
+      } else {
+        expected.addValues(doubleValues->as<double>()[pos]);
+      }
+    }
+    auto stats = builder.build();
+    auto doubleStats = dynamic_cast<DoubleColumnStatistics*>(stats.get());
+    auto expectedStats = expected.build();
+    auto& expectedDouble =
+        dynamic_cast<DoubleColumnStatistics&>(*expectedStats);
+    EXPECT_EQ(
+        expectedDouble.getNumberOfValues(), doubleStats->getNumberOfValues());
+    EXPECT_EQ(expectedDouble.getMinimum(), doubleStats->getMinimum());
+    EXPECT_EQ(expectedDouble.getMaximum(), doubleStats->getMaximum());
+    EXPECT_EQ(expectedDouble.getSum(), doubleStats->getSum());
+
+    // A NaN clears min, max and sum.
+    doubleValues->asMutable<double>()[50] = std::nan("");
+    StatisticsBuilderUtils::addValues<double>(
+        builder,
+        makeFlatVectorNoNulls<double>(&pool, size, doubleValues),
+        Ranges::of(0, 100));
+    stats = builder.build();
+    doubleStats = dynamic_cast<DoubleColumnStatistics*>(stats.get());
+    EXPECT_FALSE(doubleStats->getMinimum().has_value());
+    EXPECT_FALSE(doubleStats->getMaximum().has_value());
+    EXPECT_FALSE(doubleStats->getSum().has_value());
+  }
+
+  {
+    StringStatisticsBuilder builder{options};
+    StringStatisticsBuilder expected{options};
+    StatisticsBuilderUtils::addValues(
+        builder,
+        makeFlatVector<StringView>(&pool, nulls, 20, size, stringValues),
+        ranges);
+    for (auto pos : ranges) {
+      if (isNull(pos)) {
+        expected.setHasNull();
+      } else {
+        expected.addValues(strings[pos]);
+      }
+    }
+    auto stats = builder.build();
+    auto strStats = dynamic_cast<StringColumnStatistics*>(stats.get());
+    auto expectedStats = expected.build();
+    auto& expectedStr = dynamic_cast<StringColumnStatistics&>(*expectedStats);
+    EXPECT_EQ(expectedStr.getNumberOfValues(), strStats->getNumberOfValues());
+    EXPECT_EQ(expectedStr.getMinimum(), strStats->getMinimum());
+    EXPECT_EQ(expectedStr.getMaximum(), strStats->getMaximum());
+    EXPECT_EQ(expectedStr.getTotalLength(), strStats->getTotalLength());
+  }
+}
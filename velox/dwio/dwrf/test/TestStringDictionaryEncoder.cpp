@@ -51,6 +51,36 @@ TEST(TestStringDictionaryEncoder, AddKey) {
   }
 }
 
+TEST(TestStringDictionaryEncoder, AddKeys) {
+  auto scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  // More keys than one batch, with repeats within and across batches.
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 100; ++i) {
+    strings.push_back("key" + std::to_string(i % 37));
+  }
+  std::vector<StringView> keys(strings.begin(), strings.end());
+
+  StringDictionaryEncoder batchEncoder{pool, pool};
+  StringDictionaryEncoder encoder{pool, pool};
+  encoder.addKey("key5", 0);
+  batchEncoder.addKey("key5", 0);
+  std::vector<uint32_t> indices(keys.size());
+  batchEncoder.addKeys(
+      folly::Range<const StringView*>(keys.data(), keys.size()),
+      1,
+      indices.data());
+  for (auto i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(encoder.addKey(keys[i], 1), indices[i]);
+  }
+  ASSERT_EQ(encoder.size(), batchEncoder.size());
+  for (auto i = 0; i < encoder.size(); ++i) {
+    EXPECT_EQ(encoder.getKey(i), batchEncoder.getKey(i));
+    EXPECT_EQ(encoder.getCount(i), batchEncoder.getCount(i));
+    EXPECT_EQ(encoder.getStride(i), batchEncoder.getStride(i));
+  }
+}
+
 TEST(TestStringDictionaryEncoder, GetIndex) {
   struct TestCase {
     explicit TestCase(
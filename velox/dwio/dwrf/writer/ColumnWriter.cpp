@@ -17,6 +17,7 @@
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
 #include "velox/dwio/common/ChainedBuffer.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
+#include "velox/dwio/dwrf/writer/EncodingCostModel.h"
 #include "velox/dwio/dwrf/writer/EntropyEncodingSelector.h"
 #include "velox/dwio/dwrf/writer/FlatMapColumnWriter.h"
 #include "velox/dwio/dwrf/writer/IntegerDictionaryEncoder.h"
@@ -25,6 +26,9 @@
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
 
+#include <condition_variable>
+#include <thread>
+
 using namespace facebook::velox::dwio::common;
 using namespace facebook::velox::memory;
 
@@ -33,16 +37,17 @@ namespace facebook::velox::dwrf {
 WriterContext::LocalDecodedVector BaseColumnWriter::decode(
     const VectorPtr& slice,
     const Ranges& ranges) {
-  auto& selected = context_.getSharedSelectivityVector(slice->size());
+  auto selected = context_.getSelectivityVector(slice->size());
   // initialize
-  selected.clearAll();
+  selected->clearAll();
   for (auto& range : ranges.getRanges()) {
-    selected.setValidRange(std::get<0>(range), std::get<1>(range), true);
+    selected->setValidRange(std::get<0>(range), std::get<1>(range), true);
   }
-  selected.updateBounds();
+  selected->updateBounds();
   // decode
   auto localDecoded = context_.getLocalDecodedVector();
-  localDecoded.get().decode(*slice, selected);
+  localDecoded.get().decode(*slice, *selected);
+  context_.releaseSelectivityVector(std::move(selected));
   return localDecoded;
 }
 
@@ -207,6 +212,7 @@ class IntegerColumnWriter : public BaseColumnWriter {
         dictionaryKeySizeThreshold_{
             getConfig(Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
+        costBasedSelection_{getConfig(Config::ENCODING_COST_BASED_SELECTION)},
         useDictionaryEncoding_{useDictionaryEncoding()},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
     DWIO_ENSURE_GE(dictionaryKeySizeThreshold_, 0.0);
@@ -298,6 +304,7 @@ class IntegerColumnWriter : public BaseColumnWriter {
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     BaseColumnWriter::recordPosition();
     // TODO: the only way useDictionaryEncoding_ right now is
     // through abandonDictionary, so we already have the stream initialization
@@ -402,6 +409,9 @@ class IntegerColumnWriter : public BaseColumnWriter {
     // TODO(T91508412): Move the dictionary efficiency based decision into
     // dictionary encoder.
     auto totalElementCount = dictEncoder_.getTotalCount();
+    if (costBasedSelection_ && totalElementCount != 0) {
+      return dictionaryCostsLess();
+    }
     return totalElementCount != 0 &&
         // TODO: wonder if this should be final dictionary size instead. In that
         // case, might be better off passing in the dict size and row size
@@ -411,6 +421,27 @@ class IntegerColumnWriter : public BaseColumnWriter {
         dictionaryKeySizeThreshold_;
   }
 
+  // Compares the estimated sizes of the dictionary and direct encoded
+  // streams of the values in 'rows_'.
+  bool dictionaryCostsLess() const {
+    const bool useVInts = getConfig(Config::USE_VINTS);
+    uint64_t directBytes = 0;
+    uint64_t dictionaryBytes = 0;
+    for (uint32_t i = 0; i < dictEncoder_.size(); ++i) {
+      auto keyBytes = EncodingCostModel::valueSize(
+          dictEncoder_.getKey(i), true, useVInts, sizeof(T));
+      directBytes += keyBytes * dictEncoder_.getCount(i);
+      dictionaryBytes += keyBytes;
+    }
+    dictionaryBytes += EncodingCostModel::rleV1Size(
+        rows_.size(),
+        [&](size_t i) { return rows_[i]; },
+        false,
+        useVInts,
+        sizeof(T));
+    return EncodingCostModel::preferDictionary(dictionaryBytes, directBytes);
+  }
+
   // Should be called only once per stripe for both flushing and abandoning
   // dictionary encoding.
   void populateStrides(
@@ -458,6 +489,7 @@ class IntegerColumnWriter : public BaseColumnWriter {
   size_t finalDictionarySize_;
   const float dictionaryKeySizeThreshold_;
   const bool sort_;
+  const bool costBasedSelection_;
   // This value could change if we are writing with low memory mode or if we
   // determine with the first stripe that the data is not fit for dictionary
   // encoding.
@@ -506,6 +538,9 @@ uint64_t IntegerColumnWriter<T>::writeDict(
     T value = decodedVector.valueAt<T>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(value));
     statsBuilder.addValues(value);
+    if (bloomFilter_) {
+      bloomFilter_->addLong(value);
+    }
   };
 
   uint64_t nullCount = 0;
@@ -548,6 +583,13 @@ uint64_t IntegerColumnWriter<T>::writeDirect(
       dynamic_cast<IntegerStatisticsBuilder&>(*indexStatsBuilder_),
       slice,
       ranges);
+  if (bloomFilter_) {
+    for (auto& pos : ranges) {
+      if (!nulls || !bits::isBitNull(nulls, pos)) {
+        bloomFilter_->addLong(vals[pos]);
+      }
+    }
+  }
   auto rawSize = count * sizeof(T) + (ranges.size() - count) * NULL_SIZE;
   indexStatsBuilder_->increaseRawSize(rawSize);
   return rawSize;
@@ -799,6 +841,7 @@ class StringColumnWriter : public BaseColumnWriter {
             getConfig(Config::ENTROPY_STRING_DICT_SAMPLE_FRACTION),
             getConfig(Config::ENTROPY_STRING_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
+        costBasedSelection_{getConfig(Config::ENCODING_COST_BASED_SELECTION)},
         useDictionaryEncoding_{useDictionaryEncoding()},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
     DWIO_ENSURE(firstStripe_);
@@ -889,6 +932,7 @@ class StringColumnWriter : public BaseColumnWriter {
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     BaseColumnWriter::recordPosition();
     // TODO: the only way useDictionaryEncoding_ right now is
     // through abandonDictionary, so we already have the stream initialization
@@ -1011,10 +1055,42 @@ class StringColumnWriter : public BaseColumnWriter {
 
   // NOTE: This should be called *before* clearing the rows_ buffer.
   bool shouldKeepDictionary() const {
+    if (costBasedSelection_) {
+      return rows_.size() != 0 && dictionaryCostsLess();
+    }
     return rows_.size() != 0 &&
         encodingSelector_.useDictionary(dictEncoder_, rows_.size());
   }
 
+  // Compares the estimated sizes of the dictionary and direct encoded
+  // streams of the values in 'rows_'. The stride dictionaries are not
+  // considered.
+  bool dictionaryCostsLess() const {
+    const bool useVInts = getConfig(Config::USE_VINTS);
+    auto keyLength = [&](uint32_t index) -> int64_t {
+      return dictEncoder_.getKey(index).size();
+    };
+    uint64_t directBytes = EncodingCostModel::rleV1Size(
+        rows_.size(),
+        [&](size_t i) { return keyLength(rows_[i]); },
+        false,
+        useVInts,
+        sizeof(uint32_t));
+    uint64_t dictionaryBytes = EncodingCostModel::rleV1Size(
+        dictEncoder_.size(), keyLength, false, useVInts, sizeof(uint32_t));
+    dictionaryBytes += EncodingCostModel::rleV1Size(
+        rows_.size(),
+        [&](size_t i) { return rows_[i]; },
+        false,
+        useVInts,
+        sizeof(uint32_t));
+    for (uint32_t i = 0; i < dictEncoder_.size(); ++i) {
+      directBytes += keyLength(i) * dictEncoder_.getCount(i);
+      dictionaryBytes += keyLength(i);
+    }
+    return EncodingCostModel::preferDictionary(dictionaryBytes, directBytes);
+  }
+
   // Should be called only once per stripe for both flushing and abandoning
   // dictionary encoding.
   void populateStrides(
@@ -1070,6 +1146,7 @@ class StringColumnWriter : public BaseColumnWriter {
   size_t finalDictionarySize_;
   EntropyEncodingSelector encodingSelector_;
   const bool sort_;
+  const bool costBasedSelection_;
   // This value could change if we are writing with low memory mode or if we
   // determine with the first stripe that the data is not fit for dictionary
   // encoding.
@@ -1100,11 +1177,18 @@ uint64_t StringColumnWriter::writeDict(
   // make sure we have enough space
   rows_.reserve(rows_.size() + ranges.size());
   size_t strideIndex = strideOffsets_.size() - 1;
+  // The keys are added to the dictionary as one batch after the loop.
+  auto& pool = getMemoryPool(MemoryUsageCategory::GENERAL);
+  DataBuffer<StringView> keys{pool};
+  keys.reserve(ranges.size());
   uint64_t rawSize = 0;
   auto processRow = [&](size_t pos) {
     auto sp = decodedVector.valueAt<StringView>(pos);
-    rows_.unsafeAppend(dictEncoder_.addKey(sp, strideIndex));
+    keys.unsafeAppend(sp);
     statsBuilder.addValues(sp);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(sp.data(), sp.size());
+    }
     rawSize += sp.size();
   };
 
@@ -1123,6 +1207,15 @@ uint64_t StringColumnWriter::writeDict(
     }
   }
 
+  DataBuffer<uint32_t> indices{pool, keys.size()};
+  dictEncoder_.addKeys(
+      folly::Range<const StringView*>(keys.data(), keys.size()),
+      strideIndex,
+      indices.data());
+  for (auto i = 0; i < indices.size(); ++i) {
+    rows_.unsafeAppend(indices[i]);
+  }
+
   if (nullCount > 0) {
     statsBuilder.setHasNull();
     rawSize += nullCount * NULL_SIZE;
@@ -1150,6 +1243,9 @@ uint64_t StringColumnWriter::writeDirect(
     auto size = sp.size();
     dataDirect_->write(sp.data(), size);
     statsBuilder.addValues(sp);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(sp.data(), size);
+    }
     rawSize += size;
     lengths.unsafeAppend(size);
   };
@@ -1589,6 +1685,14 @@ class StructColumnWriter : public BaseColumnWriter {
       const RowVector* rowSlice,
       const Ranges& ranges,
       uint64_t nullCount);
+
+  // Writes the children on the calling thread and on tasks of
+  // 'executor'. Each child is written by one thread, so the streams of each
+  // column get the same content as in a serial write.
+  uint64_t writeChildrenParallel(
+      const RowVector* rowSlice,
+      const Ranges& ranges,
+      folly::Executor& executor);
 };
 
 uint64_t StructColumnWriter::writeChildrenAndStats(
@@ -1597,8 +1701,13 @@ uint64_t StructColumnWriter::writeChildrenAndStats(
     uint64_t nullCount) {
   uint64_t rawSize = 0;
   if (ranges.size() > 0) {
-    for (size_t i = 0; i < children_.size(); ++i) {
-      rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
+    auto* executor = context_.encodingExecutor();
+    if (isRoot() && executor && children_.size() > 1) {
+      rawSize += writeChildrenParallel(rowSlice, ranges, *executor);
+    } else {
+      for (size_t i = 0; i < children_.size(); ++i) {
+        rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
+      }
     }
   }
   if (nullCount) {
@@ -1610,6 +1719,75 @@ uint64_t StructColumnWriter::writeChildrenAndStats(
   return rawSize;
 }
 
+namespace {
+// State shared by the threads writing the children of a StructColumnWriter.
+// Tasks that start after all children are claimed only touch this state, so
+// the writer does not wait for tasks still queued on a busy executor.
+struct ParallelWrite {
+  explicit ParallelWrite(int32_t numChildren) : numChildren(numChildren) {}
+
+  const int32_t numChildren;
+  std::atomic<int32_t> nextChild{0};
+  std::atomic<uint64_t> rawSize{0};
+  std::mutex mutex;
+  std::condition_variable finished;
+  int32_t numFinished{0};
+  std::exception_ptr error;
+};
+
+// Writes unclaimed children of 'state' until none is left.
+void writeChildren(
+    ParallelWrite& state,
+    const std::vector<std::unique_ptr<BaseColumnWriter>>& children,
+    const RowVector& rowSlice,
+    const Ranges& ranges) {
+  for (;;) {
+    auto i = state.nextChild++;
+    if (i >= state.numChildren) {
+      return;
+    }
+    std::exception_ptr error;
+    try {
+      state.rawSize += children[i]->write(rowSlice.childAt(i), ranges);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> l(state.mutex);
+    if (error && !state.error) {
+      state.error = error;
+    }
+    if (++state.numFinished == state.numChildren) {
+      state.finished.notify_all();
+    }
+  }
+}
+} // namespace
+
+uint64_t StructColumnWriter::writeChildrenParallel(
+    const RowVector* rowSlice,
+    const Ranges& ranges,
+    folly::Executor& executor) {
+  auto state = std::make_shared<ParallelWrite>(children_.size());
+  const auto numTasks = std::min<int32_t>(
+      children_.size() - 1, std::thread::hardware_concurrency());
+  for (auto i = 0; i < numTasks; ++i) {
+    executor.add([state, this, rowSlice, &ranges]() {
+      if (state->nextChild >= state->numChildren) {
+        return;
+      }
+      writeChildren(*state, children_, *rowSlice, ranges);
+    });
+  }
+  writeChildren(*state, children_, *rowSlice, ranges);
+  std::unique_lock<std::mutex> l(state->mutex);
+  state->finished.wait(
+      l, [&]() { return state->numFinished == state->numChildren; });
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+  return state->rawSize;
+}
+
 uint64_t StructColumnWriter::write(
     const VectorPtr& slice,
     const Ranges& ranges) {
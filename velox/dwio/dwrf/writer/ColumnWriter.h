@@ -17,6 +17,7 @@
 #pragma once
 
 #include "velox/common/base/GTestMacros.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 #include "velox/dwio/dwrf/common/ByteRLE.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/common/IntEncoder.h"
@@ -80,6 +81,7 @@ class BaseColumnWriter : public ColumnWriter {
     fileStatsBuilder_->merge(*indexStatsBuilder_);
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     recordPosition();
     for (auto& child : children_) {
       child->createIndexEntry();
@@ -113,6 +115,11 @@ class BaseColumnWriter : public ColumnWriter {
     setEncoding(encoding);
     encodingOverride(encoding);
     indexBuilder_->flush();
+    if (bloomFilter_) {
+      bloomFilterIndex_.SerializeToZeroCopyStream(bloomFilterOut_.get());
+      bloomFilterOut_->flush();
+      bloomFilterIndex_.Clear();
+    }
   }
 
   uint64_t writeFileStats(std::function<proto::ColumnStatistics&(uint32_t)>
@@ -167,6 +174,30 @@ class BaseColumnWriter : public ColumnWriter {
     auto options = StatisticsBuilderOptions::fromConfig(context.getConfigs());
     indexStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
     fileStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
+    if (isIndexEnabled() && sequence == 0 &&
+        supportsBloomFilter(type.type->kind())) {
+      const auto& columns = getConfig(Config::BLOOM_FILTER_COLUMNS);
+      if (std::find(columns.begin(), columns.end(), type.column) !=
+          columns.end()) {
+        bloomFilter_ = std::make_unique<BloomFilter>(
+            context_.indexStride, getConfig(Config::BLOOM_FILTER_FPP));
+        bloomFilterOut_ = newStream(StreamKind::StreamKind_BLOOM_FILTER_UTF8);
+      }
+    }
+  }
+
+  static bool supportsBloomFilter(TypeKind kind) {
+    return kind == TypeKind::SMALLINT || kind == TypeKind::INTEGER ||
+        kind == TypeKind::BIGINT || kind == TypeKind::VARCHAR;
+  }
+
+  // Adds the bloom filter of the finished stride to the bloom filter index
+  // and starts the next stride.
+  void addBloomFilterEntry() {
+    if (bloomFilter_) {
+      bloomFilter_->toProto(*bloomFilterIndex_.add_bloomfilter());
+      bloomFilter_->reset();
+    }
   }
 
   uint64_t writeNulls(const VectorPtr& slice, const Ranges& ranges) {
@@ -258,6 +289,11 @@ class BaseColumnWriter : public ColumnWriter {
 
   std::unique_ptr<ByteRleEncoder> present_;
   bool hasNull_ = false;
+  // Bloom filter of the current stride if the column is in
+  // BLOOM_FILTER_COLUMNS.
+  std::unique_ptr<BloomFilter> bloomFilter_;
+  proto::BloomFilterIndex bloomFilterIndex_;
+  std::unique_ptr<BufferedOutputStream> bloomFilterOut_;
   // callback used to inject the logic that captures positions for flat map
   // in_map stream
   const std::function<void(IndexBuilder&)> onRecordPosition_;
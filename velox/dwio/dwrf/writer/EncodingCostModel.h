@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Varint.h>
+
+#include "velox/common/encode/Coding.h"
+#include "velox/dwio/dwrf/common/IntCodecCommon.h"
+
+namespace facebook::velox::dwrf {
+
+// Estimates the uncompressed size of DWRF streams for choosing between
+// dictionary and direct encoding from the data of the first stripe, see
+// Config::ENCODING_COST_BASED_SELECTION.
+class EncodingCostModel {
+ public:
+  // A dictionary is kept only if its streams are at least this fraction
+  // smaller than the direct encoding. Covers the extra lookup per value when
+  // reading dictionary encoded data.
+  static constexpr double kDictionaryDecodeOverhead = 0.1;
+
+  // Returns true if 'dictionaryBytes' are worth the decoding cost over
+  // 'directBytes'.
+  static bool preferDictionary(uint64_t dictionaryBytes, uint64_t directBytes) {
+    return dictionaryBytes * (1 + kDictionaryDecodeOverhead) < directBytes;
+  }
+
+  // Size of an integer in a varint or fixed width encoding.
+  static uint64_t
+  valueSize(int64_t value, bool isSigned, bool useVInts, uint32_t numBytes) {
+    if (!useVInts) {
+      return numBytes;
+    }
+    return folly::encodeVarintSize(
+        isSigned ? ZigZag::encode(value) : static_cast<uint64_t>(value));
+  }
+
+  // Size of 'count' values produced by 'valueAt(i)' encoded with RLEv1. Runs
+  // of at least RLE_MINIMUM_REPEAT values with a constant delta in
+  // [-128, 127] take a header, a delta and a base value. Other values are
+  // literals with a header per RLE_MAX_LITERAL_SIZE values.
+  template <typename ValueAt>
+  static uint64_t rleV1Size(
+      size_t count,
+      ValueAt valueAt,
+      bool isSigned,
+      bool useVInts,
+      uint32_t numBytes) {
+    uint64_t size = 0;
+    uint64_t numLiterals = 0;
+    auto literalHeaders = [&]() {
+      return (numLiterals + RLE_MAX_LITERAL_SIZE - 1) / RLE_MAX_LITERAL_SIZE;
+    };
+    size_t i = 0;
+    while (i < count) {
+      const int64_t base = valueAt(i);
+      size_t runLength = 1;
+      int64_t delta;
+      if (i + 1 < count &&
+          !__builtin_sub_overflow(valueAt(i + 1), base, &delta) &&
+          delta >= -128 && delta <= 127) {
+        runLength = 2;
+        int64_t previous = valueAt(i + 1);
+        while (i + runLength < count && runLength < RLE_MAXIMUM_REPEAT) {
+          int64_t next;
+          const int64_t value = valueAt(i + runLength);
+          if (__builtin_sub_overflow(value, previous, &next) ||
+              next != delta) {
+            break;
+          }
+          previous = value;
+          ++runLength;
+        }
+      }
+      if (runLength >= RLE_MINIMUM_REPEAT) {
+        size += literalHeaders() + 2 +
+            valueSize(base, isSigned, useVInts, numBytes);
+        numLiterals = 0;
+        i += runLength;
+      } else {
+        size += valueSize(base, isSigned, useVInts, numBytes);
+        ++numLiterals;
+        ++i;
+      }
+    }
+    return size + literalHeaders();
+  }
+};
+
+} // namespace facebook::velox::dwrf
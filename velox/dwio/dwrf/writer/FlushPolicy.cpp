@@ -34,15 +34,40 @@ FlushDecision DefaultFlushPolicy::shouldFlushDictionary(
   return FlushDecision::SKIP;
 }
 
+namespace {
+bool shouldAbandonDictionary(
+    const WriterContext& context,
+    int64_t dictionaryMemoryUsage) {
+  return context.checkLowMemoryMode() &&
+      DefaultFlushPolicy::shouldAbandonDictionary(
+             context.stripeIndex,
+             context.stripeRowCount,
+             context.stripeRawSize,
+             dictionaryMemoryUsage);
+}
+} // namespace
+
 FlushDecision DefaultFlushPolicy::shouldFlushDictionary(
     bool stripeProgressDecision,
     bool overMemoryBudget,
     const WriterContext& context) {
+  auto dictionaryMemoryUsage =
+      context.getMemoryUsage(MemoryUsageCategory::DICTIONARY).getCurrentBytes();
+  if (shouldAbandonDictionary(context, dictionaryMemoryUsage)) {
+    return FlushDecision::ABANDON_DICTIONARY;
+  }
   return shouldFlushDictionary(
-      stripeProgressDecision,
-      overMemoryBudget,
-      context.getMemoryUsage(MemoryUsageCategory::DICTIONARY)
-          .getCurrentBytes());
+      stripeProgressDecision, overMemoryBudget, dictionaryMemoryUsage);
+}
+
+// static
+bool DefaultFlushPolicy::shouldAbandonDictionary(
+    uint32_t stripeIndex,
+    uint64_t stripeRowCount,
+    uint64_t stripeRawSize,
+    int64_t dictionaryMemoryUsage) {
+  return stripeIndex == 0 && stripeRowCount >= kMinRowsToAbandonDictionary &&
+      dictionaryMemoryUsage > stripeRawSize;
 }
 
 StaticBudgetFlushPolicy::StaticBudgetFlushPolicy(
@@ -65,11 +90,13 @@ FlushDecision StaticBudgetFlushPolicy::shouldFlushDictionary(
     bool stripeProgressDecision,
     bool overMemoryBudget,
     const WriterContext& context) {
+  auto dictionaryMemoryUsage =
+      context.getMemoryUsage(MemoryUsageCategory::DICTIONARY).getCurrentBytes();
+  if (shouldAbandonDictionary(context, dictionaryMemoryUsage)) {
+    return FlushDecision::ABANDON_DICTIONARY;
+  }
   return shouldFlushDictionary(
-      stripeProgressDecision,
-      overMemoryBudget,
-      context.getMemoryUsage(MemoryUsageCategory::DICTIONARY)
-          .getCurrentBytes());
+      stripeProgressDecision, overMemoryBudget, dictionaryMemoryUsage);
 }
 
 RowsPerStripeFlushPolicy::RowsPerStripeFlushPolicy(
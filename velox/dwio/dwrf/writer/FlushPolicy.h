@@ -64,6 +64,19 @@ class DefaultFlushPolicy : public DWRFFlushPolicy {
       bool overMemoryBudget,
       const WriterContext& context) override;
 
+  // Returns true if the dictionaries of the first stripe take more memory
+  // than the raw size of the data written so far, after at least
+  // kMinRowsToAbandonDictionary rows. The values then hardly repeat and
+  // keeping the dictionaries until the flush only costs memory and lookups.
+  // Dictionaries can only be abandoned in the first stripe.
+  static bool shouldAbandonDictionary(
+      uint32_t stripeIndex,
+      uint64_t stripeRowCount,
+      uint64_t stripeRawSize,
+      int64_t dictionaryMemoryUsage);
+
+  static constexpr uint64_t kMinRowsToAbandonDictionary = 10'000;
+
   void onClose() override {
     // No-op
   }
@@ -215,6 +215,45 @@ class IntegerStatisticsBuilder : public StatisticsBuilder,
     addWithOverflowCheck(sum_, value, count);
   }
 
+  // Adds the non-null values[begin, end). The min, max and sum loops have no
+  // overflow checks or branches, so that the compiler vectorizes them. They
+  // run in the width of INT and the sum is checked for overflow only when
+  // the range of the values allows it.
+  template <typename INT>
+  void addDenseValues(const INT* values, size_t begin, size_t end) {
+    const uint64_t count = end - begin;
+    increaseValueCount(count);
+    INT batchMin = std::numeric_limits<INT>::max();
+    INT batchMax = std::numeric_limits<INT>::min();
+    for (auto i = begin; i < end; ++i) {
+      batchMin = std::min(batchMin, values[i]);
+      batchMax = std::max(batchMax, values[i]);
+    }
+    if (min_.has_value() && batchMin < min_.value()) {
+      min_ = batchMin;
+    }
+    if (max_.has_value() && batchMax > max_.value()) {
+      max_ = batchMax;
+    }
+    if (!sum_.has_value()) {
+      return;
+    }
+    // All partial sums are between count * min and count * max.
+    int64_t bound;
+    if (!__builtin_mul_overflow(count, batchMin, &bound) &&
+        !__builtin_mul_overflow(count, batchMax, &bound)) {
+      int64_t sum = 0;
+      for (auto i = begin; i < end; ++i) {
+        sum += values[i];
+      }
+      addWithOverflowCheck<int64_t>(sum_, sum, 1);
+      return;
+    }
+    for (auto i = begin; i < end && sum_.has_value(); ++i) {
+      addWithOverflowCheck<int64_t>(sum_, values[i], 1);
+    }
+  }
+
   void merge(const dwio::common::ColumnStatistics& other) override;
 
   void reset() override {
@@ -272,6 +311,44 @@ class DoubleStatisticsBuilder : public StatisticsBuilder,
     }
   }
 
+  // Adds the non-null values[begin, end). The NaN check and min and max are
+  // one loop without branches that the compiler vectorizes. The sum adds the
+  // values in order, so that it is the same as adding them one at a time.
+  template <typename FLOAT>
+  void addDenseValues(const FLOAT* values, size_t begin, size_t end) {
+    increaseValueCount(end - begin);
+    bool hasNan = false;
+    FLOAT batchMin = std::numeric_limits<FLOAT>::infinity();
+    FLOAT batchMax = -std::numeric_limits<FLOAT>::infinity();
+    for (auto i = begin; i < end; ++i) {
+      const auto value = values[i];
+      hasNan |= value != value;
+      batchMin = value < batchMin ? value : batchMin;
+      batchMax = value > batchMax ? value : batchMax;
+    }
+    if (hasNan) {
+      clear();
+      return;
+    }
+    if (min_.has_value() && batchMin < min_.value()) {
+      min_ = batchMin;
+    }
+    if (max_.has_value() && batchMax > max_.value()) {
+      max_ = batchMax;
+    }
+    if (sum_.has_value()) {
+      double sum = sum_.value();
+      for (auto i = begin; i < end; ++i) {
+        sum += values[i];
+      }
+      if (std::isnan(sum)) {
+        sum_.reset();
+      } else {
+        sum_ = sum;
+      }
+    }
+  }
+
   void merge(const dwio::common::ColumnStatistics& other) override;
 
   void reset() override {
@@ -326,6 +403,43 @@ class StringStatisticsBuilder : public StatisticsBuilder,
     addWithOverflowCheck<uint64_t>(length_, value.size(), count);
   }
 
+  // Adds the non-null values[begin, end). The min and max of the batch are
+  // found with StringView comparisons, which mostly decide on the inlined
+  // prefix, and only these two candidates are compared to and copied into
+  // the min and max of the builder.
+  void addDenseValues(const StringView* values, size_t begin, size_t end) {
+    if (begin == end) {
+      return;
+    }
+    const StringView* batchMin = &values[begin];
+    const StringView* batchMax = &values[begin];
+    uint64_t length = values[begin].size();
+    for (auto i = begin + 1; i < end; ++i) {
+      if (values[i] < *batchMin) {
+        batchMin = &values[i];
+      } else if (values[i] > *batchMax) {
+        batchMax = &values[i];
+      }
+      length += values[i].size();
+    }
+    auto isSelfEmpty = isEmpty(*this);
+    increaseValueCount(end - begin);
+    folly::StringPiece min{*batchMin};
+    folly::StringPiece max{*batchMax};
+    if (isSelfEmpty) {
+      min_ = min;
+      max_ = max;
+    } else {
+      if (min_.has_value() && min < folly::StringPiece{min_.value()}) {
+        min_ = min;
+      }
+      if (max_.has_value() && max > folly::StringPiece{max_.value()}) {
+        max_ = max;
+      }
+    }
+    addWithOverflowCheck<uint64_t>(length_, length, 1);
+  }
+
   void merge(const dwio::common::ColumnStatistics& other) override;
 
   void reset() override {
@@ -24,12 +24,12 @@ void StatisticsBuilderUtils::addValues(
     const Ranges& ranges) {
   auto nulls = vector->rawNulls();
   if (vector->mayHaveNulls()) {
-    for (auto& pos : ranges) {
-      if (bits::isBitNull(nulls, pos)) {
+    for (auto& [begin, end] : ranges.getRanges()) {
+      const auto numNonNull = bits::countBits(nulls, begin, end);
+      if (numNonNull < end - begin) {
         builder.setHasNull();
-      } else {
-        builder.increaseValueCount();
       }
+      builder.increaseValueCount(numNonNull);
     }
   } else {
     builder.increaseValueCount(ranges.size());
@@ -40,21 +40,18 @@ void StatisticsBuilderUtils::addValues(
     BooleanStatisticsBuilder& builder,
     const VectorPtr& vector,
     const Ranges& ranges) {
-  auto nulls = vector->rawNulls();
-  auto vals = vector->as<FlatVector<bool>>()->asRange();
-  if (vector->mayHaveNulls()) {
-    for (auto& pos : ranges) {
-      if (bits::isBitNull(nulls, pos)) {
-        builder.setHasNull();
-      } else {
-        builder.addValues(vals[pos]);
-      }
-    }
-  } else {
-    for (auto& pos : ranges) {
-      builder.addValues(vals[pos]);
-    }
-  }
+  auto nulls = vector->mayHaveNulls() ? vector->rawNulls() : nullptr;
+  auto vals = vector->as<FlatVector<bool>>()->rawValues<uint64_t>();
+  forEachRun(
+      builder,
+      nulls,
+      ranges,
+      [&](auto begin, auto end) {
+        const uint64_t numTrue = bits::countBits(vals, begin, end);
+        builder.addValues(true, numTrue);
+        builder.addValues(false, end - begin - numTrue);
+      },
+      [&](auto pos) { builder.addValues(bits::isBitSet(vals, pos)); });
 }
 
 void StatisticsBuilderUtils::addValues(
@@ -80,21 +77,14 @@ void StatisticsBuilderUtils::addValues(
     StringStatisticsBuilder& builder,
     const VectorPtr& vector,
     const Ranges& ranges) {
-  auto nulls = vector->rawNulls();
+  auto nulls = vector->mayHaveNulls() ? vector->rawNulls() : nullptr;
   auto data = vector->asFlatVector<StringView>()->rawValues();
-  if (vector->mayHaveNulls()) {
-    for (auto& pos : ranges) {
-      if (bits::isBitNull(nulls, pos)) {
-        builder.setHasNull();
-      } else {
-        builder.addValues(folly::StringPiece{data[pos]});
-      }
-    }
-  } else {
-    for (auto& pos : ranges) {
-      builder.addValues(folly::StringPiece{data[pos]});
-    }
-  }
+  forEachRun(
+      builder,
+      nulls,
+      ranges,
+      [&](auto begin, auto end) { builder.addDenseValues(data, begin, end); },
+      [&](auto pos) { builder.addValues(folly::StringPiece{data[pos]}); });
 }
 
 void StatisticsBuilderUtils::addValues(
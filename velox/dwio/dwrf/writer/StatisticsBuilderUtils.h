@@ -67,28 +67,50 @@ class StatisticsBuilderUtils {
       BinaryStatisticsBuilder& builder,
       const VectorPtr& vector,
       const Ranges& ranges);
+
+ private:
+  // Calls 'addDense(begin, end)' for the null-free runs of 'ranges' and
+  // 'addValue(pos)' for the non-null positions of the runs that have nulls.
+  // The nulls of a run are counted with popcount.
+  template <typename AddDense, typename AddValue>
+  static void forEachRun(
+      StatisticsBuilder& builder,
+      const uint64_t* nulls,
+      const Ranges& ranges,
+      AddDense addDense,
+      AddValue addValue);
 };
 
+template <typename AddDense, typename AddValue>
+void StatisticsBuilderUtils::forEachRun(
+    StatisticsBuilder& builder,
+    const uint64_t* nulls,
+    const Ranges& ranges,
+    AddDense addDense,
+    AddValue addValue) {
+  for (auto& [begin, end] : ranges.getRanges()) {
+    if (!nulls || bits::isAllSet(nulls, begin, end, bits::kNotNull)) {
+      addDense(begin, end);
+      continue;
+    }
+    builder.setHasNull();
+    bits::forEachSetBit(nulls, begin, end, addValue);
+  }
+}
+
 template <typename INT>
 void StatisticsBuilderUtils::addValues(
     IntegerStatisticsBuilder& builder,
     const VectorPtr& vector,
     const Ranges& ranges) {
-  auto nulls = vector->rawNulls();
+  auto nulls = vector->mayHaveNulls() ? vector->rawNulls() : nullptr;
   auto vals = vector->asFlatVector<INT>()->rawValues();
-  if (vector->mayHaveNulls()) {
-    for (auto& pos : ranges) {
-      if (bits::isBitNull(nulls, pos)) {
-        builder.setHasNull();
-      } else {
-        builder.addValues(vals[pos]);
-      }
-    }
-  } else {
-    for (auto& pos : ranges) {
-      builder.addValues(vals[pos]);
-    }
-  }
+  forEachRun(
+      builder,
+      nulls,
+      ranges,
+      [&](auto begin, auto end) { builder.addDenseValues(vals, begin, end); },
+      [&](auto pos) { builder.addValues(vals[pos]); });
 }
 
 template <typename INT>
@@ -116,21 +138,14 @@ void StatisticsBuilderUtils::addValues(
     DoubleStatisticsBuilder& builder,
     const VectorPtr& vector,
     const Ranges& ranges) {
-  auto nulls = vector->rawNulls();
+  auto nulls = vector->mayHaveNulls() ? vector->rawNulls() : nullptr;
   auto vals = vector->asFlatVector<FLOAT>()->rawValues();
-  if (vector->mayHaveNulls()) {
-    for (auto& pos : ranges) {
-      if (bits::isBitNull(nulls, pos)) {
-        builder.setHasNull();
-      } else {
-        builder.addValues(vals[pos]);
-      }
-    }
-  } else {
-    for (auto& pos : ranges) {
-      builder.addValues(vals[pos]);
-    }
-  }
+  forEachRun(
+      builder,
+      nulls,
+      ranges,
+      [&](auto begin, auto end) { builder.addDenseValues(vals, begin, end); },
+      [&](auto pos) { builder.addValues(vals[pos]); });
 }
 
 } // namespace facebook::velox::dwrf
@@ -21,6 +21,7 @@
 
 #include "velox/common/base/GTestMacros.h"
 #include "velox/dwio/common/DataBuffer.h"
+#include "velox/type/StringView.h"
 
 namespace facebook::velox::dwrf {
 
@@ -38,12 +39,15 @@ namespace detail {
 // Follys:F14* variant supports it, so leveraging folly for now.
 struct StringLookupKey {
   StringLookupKey(folly::StringPiece sp, uint32_t index)
-      : sp{sp},
-        index{index},
-        hash{folly::crc32c(
-            reinterpret_cast<const uint8_t*>(sp.data()),
-            sp.size(),
-            0 /* seed */)} {}
+      : StringLookupKey{sp, index, hashOf(sp)} {}
+
+  StringLookupKey(folly::StringPiece sp, uint32_t index, uint32_t hash)
+      : sp{sp}, index{index}, hash{hash} {}
+
+  static uint32_t hashOf(folly::StringPiece sp) {
+    return folly::crc32c(
+        reinterpret_cast<const uint8_t*>(sp.data()), sp.size(), 0 /* seed */);
+  }
 
   const folly::StringPiece sp;
   const uint32_t index;
@@ -126,21 +130,43 @@ class StringDictionaryEncoder {
       counts_[index] += count;
       return index;
     }
+    return appendKey(key, strideIndex, count);
+  }
 
-    auto bytesCount = keyBytes_.size();
-    if (UNLIKELY(
-            newIndex == std::numeric_limits<uint32_t>::max() ||
-            (std::numeric_limits<uint32_t>::max() - bytesCount <= sp.size()))) {
-      DWIO_RAISE("exceeds dictionary size limit");
+  // Adds 'keys' as addKey() does and sets indices[i] to the index of
+  // keys[i]. The CRC32C hashes of a batch of keys are computed in one loop
+  // and the hash table chunks of the batch are prefetched before the first
+  // lookup, so that the cache misses of the batch overlap.
+  void addKeys(
+      folly::Range<const StringView*> keys,
+      uint32_t strideIndex,
+      uint32_t* indices) {
+    constexpr int32_t kBatchSize = 32;
+    std::array<uint32_t, kBatchSize> hashes;
+    std::array<folly::F14HashToken, kBatchSize> tokens;
+    for (size_t begin = 0; begin < keys.size(); begin += kBatchSize) {
+      const auto numKeys = std::min<size_t>(kBatchSize, keys.size() - begin);
+      const auto* batch = keys.data() + begin;
+      for (auto i = 0; i < numKeys; ++i) {
+        hashes[i] = detail::StringLookupKey::hashOf(batch[i]);
+      }
+      for (auto i = 0; i < numKeys; ++i) {
+        tokens[i] = keyIndex_.prehash(
+            detail::StringLookupKey{batch[i], 0, hashes[i]});
+      }
+      for (auto i = 0; i < numKeys; ++i) {
+        detail::StringLookupKey key{batch[i], size(), hashes[i]};
+        auto it = keyIndex_.find(tokens[i], key);
+        if (it != keyIndex_.end()) {
+          auto index = it->getIndex();
+          ++counts_[index];
+          indices[begin + i] = index;
+        } else {
+          keyIndex_.insert(key);
+          indices[begin + i] = appendKey(key, strideIndex, 1);
+        }
+      }
     }
-
-    // append keys
-    keyBytes_.extendAppend(bytesCount, sp.data(), sp.size());
-    keyOffsets_.append(keyBytes_.size());
-    hash_.append(key.hash);
-    counts_.append(count);
-    firstSeenStrideIndex_.append(strideIndex);
-    return newIndex;
   }
 
   // Get the current frequency of a key by its index/encoded value.
@@ -177,6 +203,30 @@ class StringDictionaryEncoder {
   VELOX_FRIEND_TEST(TestStringDictionaryEncoder, GetStride);
   VELOX_FRIEND_TEST(TestStringDictionaryEncoder, Clear);
 
+  // Appends the bytes of 'key', which has been inserted in 'keyIndex_', and
+  // returns its index.
+  uint32_t appendKey(
+      const detail::StringLookupKey& key,
+      uint32_t strideIndex,
+      uint32_t count) {
+    auto newIndex = key.index;
+    auto bytesCount = keyBytes_.size();
+    if (UNLIKELY(
+            newIndex == std::numeric_limits<uint32_t>::max() ||
+            (std::numeric_limits<uint32_t>::max() - bytesCount <=
+             key.sp.size()))) {
+      DWIO_RAISE("exceeds dictionary size limit");
+    }
+
+    // append keys
+    keyBytes_.extendAppend(bytesCount, key.sp.data(), key.sp.size());
+    keyOffsets_.append(keyBytes_.size());
+    hash_.append(key.hash);
+    counts_.append(count);
+    firstSeenStrideIndex_.append(strideIndex);
+    return newIndex;
+  }
+
   // Intended for testing only.
   uint32_t getIndex(folly::StringPiece sp) {
     detail::StringLookupKey key{sp, 0};
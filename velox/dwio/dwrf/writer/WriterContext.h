@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+#include <mutex>
+
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/dwio/dwrf/common/Compression.h"
@@ -69,8 +72,7 @@ class WriterContext : public CompressionBufferPool {
     }
     validateConfigs();
     VLOG(1) << fmt::format("Compression config: {}", compression);
-    compressionBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
-        generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    compressionBuffers_.push_back(newCompressionBuffer());
   }
 
   bool hasStream(const DwrfStreamIdentifier& stream) const {
@@ -97,22 +99,8 @@ class WriterContext : public CompressionBufferPool {
   // flush policy evaluation and would be more accurate after flush.
   std::unique_ptr<BufferedOutputStream> newStream(
       const DwrfStreamIdentifier& stream) {
-    DWIO_ENSURE(
-        !hasStream(stream), "Stream already exists ", stream.toString());
-    streams_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(stream),
-        std::forward_as_tuple(
-            getMemoryPool(MemoryUsageCategory::OUTPUT_STREAM),
-            compressionBlockSize,
-            getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
-            getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
-    auto& holder = streams_.at(stream);
-    auto encrypter = handler_->isEncrypted(stream.encodingKey().node)
-        ? std::addressof(
-              handler_->getEncryptionProvider(stream.encodingKey().node))
-        : nullptr;
-    return newStream(compression, holder, encrypter);
+    std::lock_guard<std::mutex> l(mutex_);
+    return newStreamLocked(stream);
   }
 
   std::unique_ptr<DataBufferHolder> newDataBufferHolder(
@@ -137,6 +125,7 @@ class WriterContext : public CompressionBufferPool {
       const EncodingKey& ek,
       velox::memory::MemoryPool& dictionaryPool,
       velox::memory::MemoryPool& generalPool) {
+    std::lock_guard<std::mutex> l(mutex_);
     auto result = dictEncoders_.find(ek);
     if (result == dictEncoders_.end()) {
       auto emplaceResult = dictEncoders_.emplace(
@@ -146,7 +135,7 @@ class WriterContext : public CompressionBufferPool {
               generalPool,
               getConfig(Config::DICTIONARY_SORT_KEYS),
               IntEncoder</* isSigned = */ true>::createDirect(
-                  newStream(
+                  newStreamLocked(
                       {ek.node,
                        ek.sequence,
                        0,
@@ -295,16 +284,22 @@ class WriterContext : public CompressionBufferPool {
 
   std::unique_ptr<dwio::common::DataBuffer<char>> getBuffer(
       uint64_t size) override {
-    DWIO_ENSURE_NOT_NULL(compressionBuffer_);
-    DWIO_ENSURE_GE(compressionBuffer_->size(), size);
-    return std::move(compressionBuffer_);
+    std::lock_guard<std::mutex> l(mutex_);
+    if (compressionBuffers_.empty()) {
+      // Only columns encoded in parallel need more than one buffer.
+      compressionBuffers_.push_back(newCompressionBuffer());
+    }
+    auto buffer = std::move(compressionBuffers_.back());
+    compressionBuffers_.pop_back();
+    DWIO_ENSURE_GE(buffer->size(), size);
+    return buffer;
   }
 
   void returnBuffer(
       std::unique_ptr<dwio::common::DataBuffer<char>> buffer) override {
     DWIO_ENSURE_NOT_NULL(buffer);
-    DWIO_ENSURE(!compressionBuffer_);
-    compressionBuffer_ = std::move(buffer);
+    std::lock_guard<std::mutex> l(mutex_);
+    compressionBuffers_.push_back(std::move(buffer));
   }
 
   void incrementNodeSize(uint32_t node, uint64_t size) {
@@ -413,19 +408,70 @@ class WriterContext : public CompressionBufferPool {
     return LocalDecodedVector{*this};
   }
 
-  SelectivityVector& getSharedSelectivityVector(velox::vector_size_t size) {
-    if (UNLIKELY(!selectivityVector_)) {
-      selectivityVector_ = std::make_unique<velox::SelectivityVector>(size);
-    } else {
-      selectivityVector_->resize(size);
+  std::unique_ptr<velox::SelectivityVector> getSelectivityVector(
+      velox::vector_size_t size) {
+    std::unique_ptr<velox::SelectivityVector> vector;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (!selectivityVectorPool_.empty()) {
+        vector = std::move(selectivityVectorPool_.back());
+        selectivityVectorPool_.pop_back();
+      }
+    }
+    if (!vector) {
+      return std::make_unique<velox::SelectivityVector>(size);
     }
-    return *selectivityVector_;
+    vector->resize(size);
+    return vector;
+  }
+
+  void releaseSelectivityVector(
+      std::unique_ptr<velox::SelectivityVector>&& vector) {
+    std::lock_guard<std::mutex> l(mutex_);
+    selectivityVectorPool_.push_back(std::move(vector));
+  }
+
+  // If set, the top level columns of a batch are written in parallel on
+  // this executor.
+  folly::Executor* FOLLY_NULLABLE encodingExecutor() const {
+    return encodingExecutor_.get();
+  }
+
+  void setEncodingExecutor(std::shared_ptr<folly::Executor> executor) {
+    encodingExecutor_ = std::move(executor);
   }
 
  private:
   void validateConfigs() const;
 
+  // Requires 'mutex_' to be held.
+  std::unique_ptr<BufferedOutputStream> newStreamLocked(
+      const DwrfStreamIdentifier& stream) {
+    DWIO_ENSURE(
+        !hasStream(stream), "Stream already exists ", stream.toString());
+    streams_.emplace(
+        std::piecewise_construct,
+        std::forward_as_tuple(stream),
+        std::forward_as_tuple(
+            getMemoryPool(MemoryUsageCategory::OUTPUT_STREAM),
+            compressionBlockSize,
+            getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
+            getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
+    auto& holder = streams_.at(stream);
+    auto encrypter = handler_->isEncrypted(stream.encodingKey().node)
+        ? std::addressof(
+              handler_->getEncryptionProvider(stream.encodingKey().node))
+        : nullptr;
+    return newStream(compression, holder, encrypter);
+  }
+
+  std::unique_ptr<dwio::common::DataBuffer<char>> newCompressionBuffer() {
+    return std::make_unique<dwio::common::DataBuffer<char>>(
+        generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+  }
+
   std::unique_ptr<velox::DecodedVector> getDecodedVector() {
+    std::lock_guard<std::mutex> l(mutex_);
     if (decodedVectorPool_.empty()) {
       return std::make_unique<velox::DecodedVector>();
     }
@@ -435,6 +481,7 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void releaseDecodedVector(std::unique_ptr<velox::DecodedVector>&& vector) {
+    std::lock_guard<std::mutex> l(mutex_);
     decodedVectorPool_.push_back(std::move(vector));
   }
 
@@ -459,11 +506,18 @@ class WriterContext : public CompressionBufferPool {
   std::function<std::unique_ptr<IndexBuilder>(
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
-  std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
+  // Serializes the stream and dictionary encoder creation and the buffer
+  // pools below when columns are written in parallel.
+  std::mutex mutex_;
+  // Free compression buffers.
+  std::vector<std::unique_ptr<dwio::common::DataBuffer<char>>>
+      compressionBuffers_;
   // A pool of reusable DecodedVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
-  // Reusable SelectivityVector
-  std::unique_ptr<velox::SelectivityVector> selectivityVector_;
+  // A pool of reusable SelectivityVectors.
+  std::vector<std::unique_ptr<velox::SelectivityVector>>
+      selectivityVectorPool_;
+  std::shared_ptr<folly::Executor> encodingExecutor_;
 
   std::unique_ptr<encryption::EncryptionHandler> handler_;
   folly::F14FastMap<uint32_t, uint64_t> nodeSize;
@@ -119,6 +119,12 @@ struct WriterOptionsShared {
   std::shared_ptr<encryption::EncryptionSpecification> encryptionSpec;
   std::shared_ptr<dwio::common::encryption::EncrypterFactory> encrypterFactory;
   int64_t memoryBudget = std::numeric_limits<int64_t>::max();
+  // If set, the top level columns of each batch are encoded and compressed
+  // in parallel on this executor. The file content does not depend on it.
+  std::shared_ptr<folly::Executor> encodingExecutor;
+  // If set, each stripe is written to the sink on this executor while the
+  // next stripe is encoded.
+  std::shared_ptr<folly::Executor> flushExecutor;
 };
 
 class WriterShared : public WriterBase {
@@ -144,6 +150,10 @@ class WriterShared : public WriterBase {
                 folly::to<std::string>(folly::Random::rand64())),
             std::min(options.memoryBudget, parentPool.getCap())),
         std::move(handler));
+    getContext().setEncodingExecutor(options.encodingExecutor);
+    if (options.flushExecutor) {
+      getSink().setFlushExecutor(options.flushExecutor);
+    }
     if (!options.flushPolicyFactory) {
       auto& context = getContext();
       flushPolicy_ = std::make_unique<DefaultFlushPolicy>(
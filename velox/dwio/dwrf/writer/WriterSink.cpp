@@ -18,6 +18,41 @@
 
 namespace facebook::velox::dwrf {
 
+WriterSink::~WriterSink() {
+  try {
+    waitForFlush();
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed writer sink flush: " << e.what();
+  }
+  if (!buffers_.empty() || size_ != 0) {
+    LOG(WARNING) << "Unflushed data in writer sink!";
+  }
+}
+
+void WriterSink::flush() {
+  waitForFlush();
+  if (!flushExecutor_ || buffers_.empty()) {
+    sink_.write(buffers_);
+  } else {
+    pendingFlushEnd_ = sink_.size() + size_;
+    pendingFlush_ = folly::via(
+        flushExecutor_.get(), [this, buffers = std::move(buffers_)]() mutable {
+          sink_.write(buffers);
+        });
+  }
+  buffers_.clear();
+  size_ = 0;
+}
+
+void WriterSink::waitForFlush() {
+  if (!pendingFlush_) {
+    return;
+  }
+  auto pending = std::move(*pendingFlush_);
+  pendingFlush_.reset();
+  std::move(pending).get();
+}
+
 void WriterSink::addBuffer(dwio::common::DataBuffer<char> buffer) {
   auto length = buffer.size();
   if (length > 0) {
@@ -16,7 +16,11 @@
 
 #pragma once
 
+#include <optional>
+
+#include <folly/Executor.h>
 #include <folly/container/Array.h>
+#include <folly/futures/Future.h>
 
 #include "velox/dwio/dwrf/common/Checksum.h"
 #include "velox/dwio/dwrf/common/Config.h"
@@ -60,14 +64,22 @@ class WriterSink {
     addBuffer(pool, ORC_MAGIC.data(), ORC_MAGIC_LEN);
   }
 
-  ~WriterSink() {
-    if (!buffers_.empty() || size_ != 0) {
-      LOG(WARNING) << "Unflushed data in writer sink!";
-    }
-  }
+  ~WriterSink();
 
   uint64_t size() const {
-    return sink_.size() + size_;
+    return (pendingFlush_ ? pendingFlushEnd_ : sink_.size()) + size_;
+  }
+
+  // Makes flush() hand the buffered data to 'executor' and return without
+  // waiting for the write. All data added after this call is buffered until
+  // the next flush(), also if the underlying sink buffers itself. At most
+  // one flush is in progress at a time so the memory is bounded by the data
+  // of two flushes. The buffers being written stay allocated from the pool
+  // of 'this' until the write finishes.
+  void setFlushExecutor(std::shared_ptr<folly::Executor> executor) {
+    DWIO_ENSURE(buffers_.empty());
+    flushExecutor_ = std::move(executor);
+    shouldBuffer_ = !sink_.isBuffered() || flushExecutor_;
   }
 
   void addBuffer(memory::MemoryPool& pool, const char* data, size_t size) {
@@ -86,11 +98,13 @@ class WriterSink {
     other.clear();
   }
 
-  void flush() {
-    sink_.write(buffers_);
-    buffers_.clear();
-    size_ = 0;
-  }
+  // Writes the buffered data to the sink. Waits for the previous flush if
+  // it is still in progress. Write errors of an asynchronous flush are
+  // thrown by the next flush() or waitForFlush().
+  void flush();
+
+  // Waits for the flush in progress, if any.
+  void waitForFlush();
 
   Checksum* getChecksum() {
     return checksum_.get();
@@ -146,6 +160,12 @@ class WriterSink {
 
   std::vector<dwio::common::DataBuffer<char>> buffers_;
 
+  std::shared_ptr<folly::Executor> flushExecutor_;
+  // Write of the previously flushed buffers on 'flushExecutor_'.
+  std::optional<folly::Future<folly::Unit>> pendingFlush_;
+  // Size of the sink after 'pendingFlush_' finishes.
+  uint64_t pendingFlushEnd_{0};
+
   bool shouldChecksum() {
     // checksum is captured in all modes except None and if checksum algorithm
     // is available
@@ -172,6 +172,23 @@ void toDuckDbFilter(
       buildConjunctOrFilter(colIdx, type, values, filters);
       break;
     }
+    case common::FilterKind::kBigintBloomFilter: {
+      // DuckDB has no counterpart for the BloomFilter. The range passes a
+      // superset of the values, which is enough since the filter comes from
+      // a hash join that drops the false positives.
+      auto bloomFilter = static_cast<common::BigintBloomFilter*>(filter);
+      filters.PushFilter(
+          colIdx,
+          constantFilter(
+              ::duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+              makeValue(type, bloomFilter->min())));
+      filters.PushFilter(
+          colIdx,
+          constantFilter(
+              ::duckdb::ExpressionType::COMPARE_LESSTHANOREQUALTO,
+              makeValue(type, bloomFilter->max())));
+      break;
+    }
     case common::FilterKind::kAlwaysFalse:
     case common::FilterKind::kAlwaysTrue:
     case common::FilterKind::kIsNull:
@@ -203,6 +220,19 @@ std::optional<common::Filter*> findFilter(
   return std::nullopt;
 }
 
+// Reads the plain encoded value of 'T' in 'stat' into 'value'. Returns
+// false if 'stat' is not of the size of 'T'.
+template <typename T, typename U>
+bool readStat(const std::string& stat, U& value) {
+  if (stat.size() != sizeof(T)) {
+    return false;
+  }
+  T raw;
+  memcpy(&raw, stat.data(), sizeof(T));
+  value = raw;
+  return true;
+}
+
 } // anonymous namespace
 
 ParquetRowReader::ParquetRowReader(
@@ -328,11 +358,140 @@ std::optional<uint64_t> ParquetReader::numberOfRows() const {
 }
 
 std::unique_ptr<dwio::common::ColumnStatistics> ParquetReader::columnStatistics(
-    uint32_t /*index*/) const {
-  // TODO: implement proper stats
+    uint32_t index) const {
+  // Footer statistics are per leaf column chunk. They map to top level
+  // columns only if no column before 'index' is nested.
+  auto& root = typeWithId();
+  for (uint32_t i = 0; i < root->size(); ++i) {
+    auto& child = root->childAt(i);
+    if (child->id == index && child->size() == 0) {
+      return leafStatistics(i, *child->type);
+    }
+    if (child->size() > 0 || child->id >= index) {
+      break;
+    }
+  }
   return std::make_unique<ColumnStatistics>();
 }
 
+std::unique_ptr<dwio::common::ColumnStatistics> ParquetReader::leafStatistics(
+    uint32_t column,
+    const Type& type) const {
+  using ParquetType = duckdb_parquet::format::Type;
+  auto* metadata = reader_->GetFileMetadata();
+  uint64_t numRows = 0;
+  uint64_t numNulls = 0;
+  bool hasNullCount = true;
+  bool hasMinMax = true;
+  std::optional<int64_t> intMin;
+  std::optional<int64_t> intMax;
+  std::optional<double> doubleMin;
+  std::optional<double> doubleMax;
+  std::optional<std::string> stringMin;
+  std::optional<std::string> stringMax;
+  for (auto& rowGroup : metadata->row_groups) {
+    numRows += rowGroup.num_rows;
+    if (column >= rowGroup.columns.size() ||
+        !rowGroup.columns[column].__isset.meta_data) {
+      return std::make_unique<ColumnStatistics>();
+    }
+    auto& meta = rowGroup.columns[column].meta_data;
+    auto& stats = meta.statistics;
+    if (!meta.__isset.statistics || !stats.__isset.null_count) {
+      hasNullCount = false;
+    } else {
+      numNulls += stats.null_count;
+    }
+    // The deprecated min and max have an unspecified sort order and are not
+    // used.
+    if (!meta.__isset.statistics || !stats.__isset.min_value ||
+        !stats.__isset.max_value) {
+      hasMinMax = false;
+      continue;
+    }
+    auto& min = stats.min_value;
+    auto& max = stats.max_value;
+    switch (meta.type) {
+      case ParquetType::INT32:
+      case ParquetType::INT64: {
+        int64_t low;
+        int64_t high;
+        bool valid = meta.type == ParquetType::INT32
+            ? readStat<int32_t>(min, low) && readStat<int32_t>(max, high)
+            : readStat<int64_t>(min, low) && readStat<int64_t>(max, high);
+        if (!valid) {
+          hasMinMax = false;
+          break;
+        }
+        intMin = intMin.has_value() ? std::min(intMin.value(), low) : low;
+        intMax = intMax.has_value() ? std::max(intMax.value(), high) : high;
+        break;
+      }
+      case ParquetType::FLOAT:
+      case ParquetType::DOUBLE: {
+        double low;
+        double high;
+        bool valid = meta.type == ParquetType::FLOAT
+            ? readStat<float>(min, low) && readStat<float>(max, high)
+            : readStat<double>(min, low) && readStat<double>(max, high);
+        if (!valid) {
+          hasMinMax = false;
+          break;
+        }
+        doubleMin =
+            doubleMin.has_value() ? std::min(doubleMin.value(), low) : low;
+        doubleMax =
+            doubleMax.has_value() ? std::max(doubleMax.value(), high) : high;
+        break;
+      }
+      case ParquetType::BYTE_ARRAY:
+        stringMin = stringMin.has_value() ? std::min(stringMin.value(), min)
+                                          : min;
+        stringMax = stringMax.has_value() ? std::max(stringMax.value(), max)
+                                          : max;
+        break;
+      default:
+        hasMinMax = false;
+        break;
+    }
+  }
+  if (!hasNullCount) {
+    return std::make_unique<ColumnStatistics>();
+  }
+  dwio::common::ColumnStatistics base(
+      numRows - numNulls, numNulls > 0, std::nullopt, std::nullopt);
+  if (!hasMinMax || numRows == numNulls) {
+    return std::make_unique<dwio::common::ColumnStatistics>(base);
+  }
+  switch (type.kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      if (intMin.has_value()) {
+        return std::make_unique<dwio::common::IntegerColumnStatistics>(
+            base, intMin, intMax, std::nullopt);
+      }
+      break;
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+      if (doubleMin.has_value()) {
+        return std::make_unique<dwio::common::DoubleColumnStatistics>(
+            base, doubleMin, doubleMax, std::nullopt);
+      }
+      break;
+    case TypeKind::VARCHAR:
+      if (stringMin.has_value()) {
+        return std::make_unique<dwio::common::StringColumnStatistics>(
+            base, stringMin, stringMax, std::nullopt);
+      }
+      break;
+    default:
+      break;
+  }
+  return std::make_unique<dwio::common::ColumnStatistics>(base);
+}
+
 const velox::RowTypePtr& ParquetReader::rowType() const {
   return type_;
 }
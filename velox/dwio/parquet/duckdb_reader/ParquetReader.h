@@ -27,6 +27,14 @@ VELOX_UNSUPPRESS_DEPRECATION_WARNING
 
 namespace facebook::velox::parquet::duckdb_reader {
 
+// Reads a Parquet file through the DuckDB Parquet reader. ScanSpec filters
+// are pushed down to DuckDB, which skips row groups by the min and max of
+// their column chunks.
+//
+// TODO: Skip pages by the column index and row groups by their dictionary
+// pages. Both need access to page headers and decompression that the
+// bundled DuckDB reader does not expose. A native reader on
+// SelectiveColumnReader would get both.
 class ParquetRowReader : public dwio::common::RowReader {
  public:
   ParquetRowReader(
@@ -75,6 +83,12 @@ class ParquetReader : public dwio::common::Reader {
       const dwio::common::RowReaderOptions& options = {}) const override;
 
  private:
+  // Returns the statistics of top level column 'column' of 'type' merged
+  // from the column chunk statistics of all row groups.
+  std::unique_ptr<dwio::common::ColumnStatistics> leafStatistics(
+      uint32_t column,
+      const Type& type) const;
+
   duckdb::VeloxPoolAllocator allocator_;
   std::unique_ptr<duckdb::InputStreamFileSystem> fileSystem_;
   std::shared_ptr<::duckdb::ParquetReader> reader_;
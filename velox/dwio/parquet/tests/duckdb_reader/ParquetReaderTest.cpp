@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 #include <array>
 
+#include "velox/dwio/common/ScanSpec.h"
 #include "velox/dwio/parquet/duckdb_reader/ParquetReader.h"
 #include "velox/dwio/parquet/tests/ParquetReaderTestBase.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
@@ -90,6 +91,37 @@ TEST_F(ParquetReaderTest, readSampleFull) {
   assertReadExpected(*rowReader, expected);
 }
 
+TEST_F(ParquetReaderTest, sampleStatistics) {
+  const std::string sample(getExampleFilePath("sample.parquet"));
+
+  ReaderOptions readerOptions;
+  ParquetReader reader(
+      std::make_unique<FileInputStream>(sample), readerOptions);
+  auto type = reader.typeWithId();
+
+  auto stats = reader.columnStatistics(type->childAt(0)->id);
+  auto intStats = dynamic_cast<const IntegerColumnStatistics*>(stats.get());
+  ASSERT_NE(intStats, nullptr);
+  EXPECT_EQ(intStats->getNumberOfValues(), 20ULL);
+  EXPECT_EQ(intStats->hasNull(), false);
+  EXPECT_EQ(intStats->getMinimum(), 1);
+  EXPECT_EQ(intStats->getMaximum(), 20);
+
+  stats = reader.columnStatistics(type->childAt(1)->id);
+  auto doubleStats = dynamic_cast<const DoubleColumnStatistics*>(stats.get());
+  ASSERT_NE(doubleStats, nullptr);
+  EXPECT_EQ(doubleStats->getMinimum(), 1.0);
+  EXPECT_EQ(doubleStats->getMaximum(), 20.0);
+
+  // A filter outside of the file statistics prunes the whole file.
+  auto numRows = reader.numberOfRows().value();
+  stats = reader.columnStatistics(type->childAt(0)->id);
+  EXPECT_FALSE(common::testFilter(
+      exec::greaterThanOrEqual(21).get(), stats.get(), numRows, BIGINT()));
+  EXPECT_TRUE(common::testFilter(
+      exec::lessThanOrEqual(5).get(), stats.get(), numRows, BIGINT()));
+}
+
 TEST_F(ParquetReaderTest, readSampleRange1) {
   const std::string sample(getExampleFilePath("sample.parquet"));
 
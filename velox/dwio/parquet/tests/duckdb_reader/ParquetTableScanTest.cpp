@@ -19,6 +19,7 @@
 #include "velox/dwio/dwrf/test/utils/DataFiles.h"
 #include "velox/dwio/parquet/RegisterParquetReader.h"
 #include "velox/dwio/parquet/duckdb_reader/ParquetReader.h"
+#include "velox/dwio/parquet/writer/Writer.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
@@ -36,9 +37,11 @@ class ParquetTableScanTest : public HiveConnectorTestBase {
   void SetUp() override {
     HiveConnectorTestBase::SetUp();
     registerParquetReaderFactory();
+    registerParquetWriterFactory();
   }
 
   void TearDown() override {
+    unregisterParquetWriterFactory();
     unregisterParquetReaderFactory();
     HiveConnectorTestBase::TearDown();
   }
@@ -227,6 +230,40 @@ TEST_F(ParquetTableScanTest, countStar) {
   assertQuery(plan, {split}, "SELECT 20");
 }
 
+TEST_F(ParquetTableScanTest, tableWrite) {
+  using connector::hive::HiveInsertTableHandle;
+  auto data = makeRowVector(
+      {"a", "b", "c"},
+      {
+          makeFlatVector<int64_t>(3'000, [](auto row) { return row; }),
+          makeFlatVector<double>(
+              3'000, [](auto row) { return row * 0.1; }, nullEvery(5)),
+          makeFlatVector<StringView>(
+              3'000,
+              [](auto row) { return StringView(row % 2 ? "odd" : "even"); }),
+      });
+  auto outputFile = exec::test::TempFilePath::create();
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .tableWrite(
+                      data->type()->asRow().names(),
+                      std::make_shared<core::InsertTableHandle>(
+                          kHiveConnectorId,
+                          std::make_shared<HiveInsertTableHandle>(
+                              outputFile->path,
+                              dwio::common::FileFormat::PARQUET)),
+                      "rows")
+                  .planNode();
+  assertQuery(plan, "SELECT 3000");
+
+  loadData(outputFile->path, asRowType(data->type()), data);
+  assertSelect({"a", "b", "c"}, "SELECT a, b, c FROM tmp");
+  assertSelectWithFilter(
+      {"a", "c"},
+      common::test::singleSubfieldFilter("a", exec::lessThan(100)),
+      "SELECT a, c FROM tmp WHERE a < 100");
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   folly::init(&argc, &argv, false);
@@ -161,19 +161,41 @@ std::unordered_map<std::string, std::string> ParquetTpchTest::duckDbParquetWrite
     std::make_pair(
         "region",
         R"(COPY (SELECT * FROM {}) TO '{}' (FORMAT 'parquet', ROW_GROUP_SIZE {}))"),
+    std::make_pair(
+        "part",
+        R"(COPY (SELECT p_partkey, p_name, p_mfgr, p_brand, p_type, p_size,
+        p_container, p_retailprice::DOUBLE as p_retailprice, p_comment
+        FROM {}) TO '{}' (FORMAT 'parquet', ROW_GROUP_SIZE {}))"),
     std::make_pair(
         "supplier",
-        R"(COPY (SELECT * FROM {}) TO '{}' (FORMAT 'parquet', ROW_GROUP_SIZE {}))")};
+        R"(COPY (SELECT s_suppkey, s_name, s_address, s_nationkey, s_phone,
+        s_acctbal::DOUBLE as s_acctbal, s_comment
+        FROM {}) TO '{}' (FORMAT 'parquet', ROW_GROUP_SIZE {}))"),
+    std::make_pair(
+        "partsupp",
+        R"(COPY (SELECT ps_partkey, ps_suppkey, ps_availqty,
+        ps_supplycost::DOUBLE as ps_supplycost, ps_comment
+        FROM {}) TO '{}' (FORMAT 'parquet', ROW_GROUP_SIZE {}))")};
 
 TEST_F(ParquetTpchTest, Q1) {
   assertQuery(1, 2, 10);
 }
 
+TEST_F(ParquetTpchTest, Q2) {
+  std::vector<uint32_t> sortingKeys{0, 1, 2, 3};
+  assertQuery(2, 11, 90, std::move(sortingKeys));
+}
+
 TEST_F(ParquetTpchTest, Q3) {
   std::vector<uint32_t> sortingKeys{1, 2};
   assertQuery(3, 4, 30, std::move(sortingKeys));
 }
 
+TEST_F(ParquetTpchTest, Q4) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(4, 3, 20, std::move(sortingKeys));
+}
+
 TEST_F(ParquetTpchTest, Q5) {
   std::vector<uint32_t> sortingKeys{1};
   assertQuery(5, 7, 60, std::move(sortingKeys));
@@ -183,20 +205,82 @@ TEST_F(ParquetTpchTest, Q6) {
   assertQuery(6, 2, 10);
 }
 
+TEST_F(ParquetTpchTest, Q7) {
+  std::vector<uint32_t> sortingKeys{0, 1, 2};
+  assertQuery(7, 7, 60, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q8) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(8, 9, 80, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q9) {
+  std::vector<uint32_t> sortingKeys{0, 1};
+  assertQuery(9, 7, 60, std::move(sortingKeys));
+}
+
 TEST_F(ParquetTpchTest, Q10) {
   std::vector<uint32_t> sortingKeys{2};
   assertQuery(10, 5, 40, std::move(sortingKeys));
 }
 
+TEST_F(ParquetTpchTest, Q11) {
+  std::vector<uint32_t> sortingKeys{1};
+  assertQuery(11, 9, 60, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q12) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(12, 3, 20, std::move(sortingKeys));
+}
+
 TEST_F(ParquetTpchTest, Q13) {
   std::vector<uint32_t> sortingKeys{0, 1};
   assertQuery(13, 3, 20, std::move(sortingKeys));
 }
 
+TEST_F(ParquetTpchTest, Q14) {
+  assertQuery(14, 3, 20);
+}
+
+TEST_F(ParquetTpchTest, Q15) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(15, 4, 20, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q16) {
+  std::vector<uint32_t> sortingKeys{0, 1, 2, 3};
+  assertQuery(16, 5, 30, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q17) {
+  assertQuery(17, 6, 40);
+}
+
 TEST_F(ParquetTpchTest, Q18) {
   assertQuery(18, 5, 30);
 }
 
+TEST_F(ParquetTpchTest, Q19) {
+  assertQuery(19, 3, 20);
+}
+
+TEST_F(ParquetTpchTest, Q20) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(20, 8, 60, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q21) {
+  std::vector<uint32_t> sortingKeys{0, 1};
+  assertQuery(21, 7, 60, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q22) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(22, 5, 30, std::move(sortingKeys));
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   folly::init(&argc, &argv, false);
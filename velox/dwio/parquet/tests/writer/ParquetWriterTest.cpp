@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <deque>
+
+#include "velox/dwio/common/MemoryInputStream.h"
+#include "velox/dwio/parquet/duckdb_reader/ParquetReader.h"
+#include "velox/dwio/parquet/tests/ParquetReaderTestBase.h"
+#include "velox/dwio/parquet/writer/Writer.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox::dwio::parquet;
+
+class ParquetWriterTest : public ParquetReaderTestBase {
+ protected:
+  // Writes 'batches' with 'options' and returns a reader of the file.
+  std::unique_ptr<parquet::duckdb_reader::ParquetReader> writeAndOpen(
+      const std::vector<RowVectorPtr>& batches,
+      const parquet::WriterOptions& options) {
+    auto sink = std::make_unique<MemorySink>(*pool_, 10 << 20);
+    sink_ = sink.get();
+    writer_ = std::make_unique<parquet::Writer>(
+        std::move(sink),
+        options,
+        *pool_,
+        asRowType(batches[0]->type()));
+    for (auto& batch : batches) {
+      writer_->write(batch);
+    }
+    writer_->close();
+    ReaderOptions readerOptions;
+    return std::make_unique<parquet::duckdb_reader::ParquetReader>(
+        std::make_unique<MemoryInputStream>(sink_->getData(), sink_->size()),
+        readerOptions);
+  }
+
+  RowVectorPtr makeBatch(int32_t size, int32_t start) {
+    return vectorMaker_->rowVector(
+        {"a", "b", "c"},
+        {vectorMaker_->flatVector<int64_t>(
+             size,
+             [&](auto row) { return start + row; },
+             [&](auto row) { return (start + row) % 7 == 0; }),
+         vectorMaker_->flatVector<double>(
+             size, [&](auto row) { return (start + row) * 0.5; }),
+         vectorMaker_->flatVector<StringView>(
+             size,
+             [&](auto row) {
+               strings_.push_back(fmt::format("s{}", (start + row) % 10));
+               return StringView(strings_.back());
+             },
+             [&](auto row) { return (start + row) % 11 == 0; })});
+  }
+
+  std::deque<std::string> strings_;
+  MemorySink* sink_;
+  std::unique_ptr<parquet::Writer> writer_;
+};
+
+TEST_F(ParquetWriterTest, roundTrip) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 5; ++i) {
+    batches.push_back(makeBatch(1'000, i * 1'000));
+  }
+  for (auto compression :
+       {CompressionKind_NONE, CompressionKind_SNAPPY, CompressionKind_ZSTD}) {
+    parquet::WriterOptions options;
+    options.rowsInRowGroup = 1'500;
+    options.compression = compression;
+    auto reader = writeAndOpen(batches, options);
+    EXPECT_EQ(reader->numberOfRows(), 5'000ULL);
+    auto rowType = reader->rowType();
+    ASSERT_EQ(*rowType, *batches[0]->type());
+
+    auto rowReaderOpts = getReaderOpts(rowType);
+    rowReaderOpts.setScanSpec(makeScanSpec(rowType));
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    assertReadExpected(*rowReader, makeBatch(5'000, 0));
+
+    auto stats =
+        reader->columnStatistics(reader->typeWithId()->childAt(0)->id);
+    auto intStats = dynamic_cast<IntegerColumnStatistics*>(stats.get());
+    ASSERT_NE(intStats, nullptr);
+    EXPECT_EQ(intStats->getMinimum(), 1);
+    EXPECT_EQ(intStats->getMaximum(), 4'999);
+    EXPECT_EQ(intStats->hasNull(), true);
+  }
+}
+
+TEST_F(ParquetWriterTest, factory) {
+  parquet::registerParquetWriterFactory();
+  auto batch = makeBatch(100, 0);
+  auto writer = getWriterFactory(FileFormat::PARQUET)
+                    ->createWriter(
+                        std::make_unique<MemorySink>(*pool_, 1 << 20),
+                        asRowType(batch->type()),
+                        *pool_);
+  writer->write(batch);
+  writer->close();
+  parquet::unregisterParquetWriterFactory();
+}
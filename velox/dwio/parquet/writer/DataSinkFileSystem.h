@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/dwio/common/DataSink.h"
+#include "velox/external/duckdb/duckdb.hpp"
+
+namespace facebook::velox::parquet {
+
+class DataSinkFileHandle : public ::duckdb::FileHandle {
+ public:
+  explicit DataSinkFileHandle(::duckdb::FileSystem& fileSystem)
+      : FileHandle(fileSystem, "") {}
+
+  ~DataSinkFileHandle() override {}
+
+ protected:
+  void Close() override {}
+};
+
+// Implements the sequential write part of the DuckDB FileSystem API on top
+// of dwio::common::DataSink for the DuckDB Parquet writer. An instance
+// supports a single file.
+class DataSinkFileSystem : public ::duckdb::FileSystem {
+ public:
+  DataSinkFileSystem(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      memory::MemoryPool& pool)
+      : sink_(std::move(sink)), pool_(pool) {}
+
+  ~DataSinkFileSystem() override = default;
+
+  std::unique_ptr<::duckdb::FileHandle> OpenFile(
+      const std::string& /* path */,
+      uint8_t /*flags*/,
+      ::duckdb::FileLockType /*lock = ::duckdb::FileLockType::NO_LOCK*/,
+      ::duckdb::FileCompressionType /*compression =
+          ::duckdb::FileCompressionType::UNCOMPRESSED*/
+      ,
+      ::duckdb::FileOpener* /*opener = nullptr*/) override {
+    return std::make_unique<DataSinkFileHandle>(*this);
+  }
+
+  int64_t Write(
+      ::duckdb::FileHandle& /*handle*/,
+      void* buffer,
+      int64_t nr_bytes) override {
+    dwio::common::DataBuffer<char> data(pool_, nr_bytes);
+    memcpy(data.data(), buffer, nr_bytes);
+    sink_->write(std::move(data));
+    return nr_bytes;
+  }
+
+  int64_t GetFileSize(::duckdb::FileHandle& /* handle */) override {
+    return sink_->size();
+  }
+
+  // The data reaches the sink on each write. The sink is closed by close().
+  void FileSync(::duckdb::FileHandle& /*handle*/) override {}
+
+  bool OnDiskFile(::duckdb::FileHandle& /*handle*/) override {
+    return false;
+  }
+
+  bool CanSeek() override {
+    return false;
+  }
+
+  std::string GetName() const override {
+    return "dwio::DataSink";
+  }
+
+  void close() {
+    sink_->close();
+  }
+
+ private:
+  std::unique_ptr<dwio::common::DataSink> sink_;
+  memory::MemoryPool& pool_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/Writer.h"
+#include "velox/duckdb/conversion/DuckConversion.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+duckdb_parquet::format::CompressionCodec::type toCodec(
+    dwio::common::CompressionKind kind) {
+  using Codec = duckdb_parquet::format::CompressionCodec;
+  switch (kind) {
+    case dwio::common::CompressionKind_NONE:
+      return Codec::UNCOMPRESSED;
+    case dwio::common::CompressionKind_ZLIB:
+      return Codec::GZIP;
+    case dwio::common::CompressionKind_SNAPPY:
+      return Codec::SNAPPY;
+    case dwio::common::CompressionKind_ZSTD:
+      return Codec::ZSTD;
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported Parquet compression: {}",
+          dwio::common::compressionKindToString(kind));
+  }
+}
+
+template <typename T, typename F>
+void copyValues(
+    const DecodedVector& decoded,
+    vector_size_t offset,
+    int32_t size,
+    ::duckdb::Vector& result,
+    F convert) {
+  auto* data = ::duckdb::FlatVector::GetData<T>(result);
+  auto& validity = ::duckdb::FlatVector::Validity(result);
+  for (auto i = 0; i < size; ++i) {
+    if (decoded.isNullAt(offset + i)) {
+      validity.SetInvalid(i);
+    } else {
+      data[i] = convert(offset + i);
+    }
+  }
+}
+
+template <typename T>
+void copyValues(
+    const DecodedVector& decoded,
+    vector_size_t offset,
+    int32_t size,
+    ::duckdb::Vector& result) {
+  copyValues<T>(decoded, offset, size, result, [&](auto row) {
+    return decoded.valueAt<T>(row);
+  });
+}
+
+// Copies 'size' rows of 'decoded' from 'offset' into the flat 'result'.
+void toDuckDbVector(
+    const DecodedVector& decoded,
+    TypeKind kind,
+    vector_size_t offset,
+    int32_t size,
+    ::duckdb::Vector& result) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      copyValues<bool>(decoded, offset, size, result);
+      break;
+    case TypeKind::TINYINT:
+      copyValues<int8_t>(decoded, offset, size, result);
+      break;
+    case TypeKind::SMALLINT:
+      copyValues<int16_t>(decoded, offset, size, result);
+      break;
+    case TypeKind::INTEGER:
+      copyValues<int32_t>(decoded, offset, size, result);
+      break;
+    case TypeKind::BIGINT:
+      copyValues<int64_t>(decoded, offset, size, result);
+      break;
+    case TypeKind::REAL:
+      copyValues<float>(decoded, offset, size, result);
+      break;
+    case TypeKind::DOUBLE:
+      copyValues<double>(decoded, offset, size, result);
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      copyValues<::duckdb::string_t>(
+          decoded, offset, size, result, [&](auto row) {
+            auto value = decoded.valueAt<StringView>(row);
+            return ::duckdb::StringVector::AddStringOrBlob(
+                result, value.data(), value.size());
+          });
+      break;
+    case TypeKind::TIMESTAMP:
+      copyValues<::duckdb::timestamp_t>(
+          decoded, offset, size, result, [&](auto row) {
+            return duckdb::veloxTimestampToDuckDB(
+                decoded.valueAt<Timestamp>(row));
+          });
+      break;
+    case TypeKind::DATE:
+      copyValues<::duckdb::date_t>(
+          decoded, offset, size, result, [&](auto row) {
+            return ::duckdb::date_t(decoded.valueAt<Date>(row).days());
+          });
+      break;
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported type for Parquet writer: {}", mapTypeKindToName(kind));
+  }
+}
+
+} // namespace
+
+Writer::Writer(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    const WriterOptions& options,
+    memory::MemoryPool& pool,
+    std::shared_ptr<const RowType> schema)
+    : options_(options),
+      schema_(std::move(schema)),
+      fileSystem_(
+          std::make_unique<DataSinkFileSystem>(std::move(sink), pool)) {
+  VELOX_CHECK_GT(options_.rowsInRowGroup, 0);
+  duckdbTypes_.reserve(schema_->size());
+  for (auto& type : schema_->children()) {
+    duckdbTypes_.push_back(duckdb::fromVeloxType(type->kind()));
+  }
+  writer_ = std::make_unique<::duckdb::ParquetWriter>(
+      *fileSystem_,
+      "",
+      nullptr,
+      duckdbTypes_,
+      schema_->names(),
+      toCodec(options_.compression));
+}
+
+void Writer::write(const VectorPtr& data) {
+  VELOX_CHECK(!closed_, "Parquet writer is closed");
+  auto* rowVector = data->as<RowVector>();
+  VELOX_CHECK_NOT_NULL(rowVector, "Parquet writer expects a RowVector");
+  VELOX_CHECK_EQ(rowVector->childrenSize(), schema_->size());
+  const auto numRows = rowVector->size();
+  vector_size_t offset = 0;
+  while (offset < numRows) {
+    // Chunks do not span row groups.
+    const int64_t buffered = buffer_.Count();
+    auto size = std::min<int64_t>(
+        {numRows - offset,
+         STANDARD_VECTOR_SIZE,
+         options_.rowsInRowGroup - buffered});
+    appendChunk(*rowVector, offset, size);
+    offset += size;
+    if (buffered + size >= options_.rowsInRowGroup) {
+      flush();
+    }
+  }
+}
+
+void Writer::appendChunk(
+    const RowVector& data,
+    vector_size_t offset,
+    int32_t size) {
+  auto chunk = std::make_unique<::duckdb::DataChunk>();
+  chunk->Initialize(duckdbTypes_);
+  SelectivityVector rows(offset + size, false);
+  rows.setValidRange(offset, offset + size, true);
+  rows.updateBounds();
+  for (size_t i = 0; i < duckdbTypes_.size(); ++i) {
+    auto& child = data.childAt(i);
+    DecodedVector decoded(*child, rows);
+    toDuckDbVector(decoded, child->typeKind(), offset, size, chunk->data[i]);
+  }
+  chunk->SetCardinality(size);
+  buffer_.Append(std::move(chunk));
+}
+
+void Writer::flush() {
+  if (buffer_.Count() == 0) {
+    return;
+  }
+  writer_->Flush(buffer_);
+  buffer_.Reset();
+}
+
+void Writer::close() {
+  if (closed_) {
+    return;
+  }
+  flush();
+  writer_->Finalize();
+  fileSystem_->close();
+  closed_ = true;
+}
+
+void registerParquetWriterFactory() {
+  dwio::common::registerWriterFactory(
+      std::make_shared<ParquetWriterFactory>());
+}
+
+void unregisterParquetWriterFactory() {
+  dwio::common::unregisterWriterFactory(dwio::common::FileFormat::PARQUET);
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/Macros.h"
+#include "velox/dwio/common/Common.h"
+#include "velox/dwio/common/WriterFactory.h"
+#include "velox/dwio/parquet/writer/DataSinkFileSystem.h"
+#include "velox/vector/ComplexVector.h"
+VELOX_SUPPRESS_DEPRECATION_WARNING
+#include "velox/external/duckdb/parquet-amalgamation.hpp"
+VELOX_UNSUPPRESS_DEPRECATION_WARNING
+
+namespace facebook::velox::parquet {
+
+struct WriterOptions {
+  // Rows buffered before they are written as a row group.
+  int64_t rowsInRowGroup{100'000};
+  dwio::common::CompressionKind compression{
+      dwio::common::CompressionKind_SNAPPY};
+};
+
+// Writes RowVectors to a Parquet file through the DuckDB Parquet writer.
+// Rows are buffered in DuckDB vectors and written out as a row group when
+// the buffer reaches WriterOptions::rowsInRowGroup rows or on flush().
+// Column chunks carry min, max and null count statistics.
+//
+// TODO: Dictionary encode columns other than enums and write page level
+// statistics (the column index). The bundled DuckDB writer does neither.
+class Writer : public dwio::common::Writer {
+ public:
+  Writer(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      const WriterOptions& options,
+      memory::MemoryPool& pool,
+      std::shared_ptr<const RowType> schema);
+
+  ~Writer() override = default;
+
+  void write(const VectorPtr& data) override;
+
+  void flush() override;
+
+  void close() override;
+
+ private:
+  // Appends 'size' rows of 'data' from 'offset' to 'buffer_'.
+  void appendChunk(const RowVector& data, vector_size_t offset, int32_t size);
+
+  const WriterOptions options_;
+  const std::shared_ptr<const RowType> schema_;
+  std::vector<::duckdb::LogicalType> duckdbTypes_;
+  std::unique_ptr<DataSinkFileSystem> fileSystem_;
+  std::unique_ptr<::duckdb::ParquetWriter> writer_;
+  // Rows not yet written.
+  ::duckdb::ChunkCollection buffer_;
+  bool closed_{false};
+};
+
+class ParquetWriterFactory : public dwio::common::WriterFactory {
+ public:
+  ParquetWriterFactory() : WriterFactory(dwio::common::FileFormat::PARQUET) {}
+
+  std::unique_ptr<dwio::common::Writer> createWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      const std::shared_ptr<const RowType>& schema,
+      memory::MemoryPool& pool) override {
+    return std::make_unique<Writer>(
+        std::move(sink), WriterOptions{}, pool, schema);
+  }
+};
+
+void registerParquetWriterFactory();
+
+void unregisterParquetWriterFactory();
+
+} // namespace facebook::velox::parquet
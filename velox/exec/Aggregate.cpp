@@ -30,6 +30,28 @@ bool isPartialOutput(core::AggregationNode::Step step) {
       step == core::AggregationNode::Step::kIntermediate;
 }
 
+void Aggregate::setAllColumnarNulls(
+    char** groups,
+    folly::Range<const vector_size_t*> indices) {
+  uint32_t maxNumber = 0;
+  for (auto i : indices) {
+    maxNumber = std::max(maxNumber, groupNumber(groups[i]));
+  }
+  if (maxNumber >= numColumnarGroups_) {
+    numColumnarGroups_ =
+        std::max<uint64_t>(maxNumber + 1, 2 * numColumnarGroups_);
+    columnarStorage_.resize(
+        bits::nwords(numColumnarGroups_ * columnarWidth_ * 8));
+    columnarNullsStorage_.resize(bits::nwords(numColumnarGroups_));
+    columnarValues_ = reinterpret_cast<char*>(columnarStorage_.data());
+    columnarNulls_ = columnarNullsStorage_.data();
+  }
+  for (auto i : indices) {
+    bits::setBit(columnarNulls_, groupNumber(groups[i]));
+  }
+  numNulls_ += indices.size();
+}
+
 AggregateFunctionMap& aggregateFunctions() {
   static AggregateFunctionMap functions;
   return functions;
@@ -47,6 +47,12 @@ class Aggregate {
   // width part of the state from the fixed part.
   virtual int32_t accumulatorFixedWidthSize() const = 0;
 
+  // Returns the alignment the fixed width part of the accumulator needs on
+  // a group row. Must be a power of two.
+  virtual int32_t accumulatorAlignmentSize() const {
+    return 1;
+  }
+
   // Return true if accumulator is allocated from external memory, e.g. memory
   // not managed by Velox.
   virtual bool accumulatorUsesExternalMemory() const {
@@ -65,7 +71,43 @@ class Aggregate {
     return true;
   }
 
-  void setAllocator(HashStringAllocator* allocator) {
+  // Returns true if more input can be added to an accumulator after
+  // finalize() and extractValues() have been called on it. Window
+  // aggregation relies on this to extend a frame by the newly added rows
+  // instead of recomputing the frame from scratch.
+  virtual bool canAddInputAfterFinalize() const {
+    return true;
+  }
+
+  // Returns true if the accumulators and null flags can be kept in arrays
+  // indexed by group number instead of in the group rows, see
+  // setColumnar(). Such an aggregate accesses its accumulators only through
+  // value() and the null flag helpers, calls setAllNulls() from
+  // initializeNewGroups() and implements addRawInputColumnar().
+  virtual bool supportsColumnar() const {
+    return false;
+  }
+
+  // Keeps the fixed width accumulators and the null flags in arrays indexed
+  // by group number. The group row then has the number of the group at
+  // offset() instead of the accumulator. Must be called before the
+  // RowContainer of the groups is made.
+  void setColumnar() {
+    VELOX_CHECK(supportsColumnar());
+    columnar_ = true;
+    columnarWidth_ = accumulatorFixedWidthSize();
+  }
+
+  bool isColumnar() const {
+    return columnar_;
+  }
+
+  // Offset of the accumulator or of the group number in a group row.
+  int32_t offset() const {
+    return offset_;
+  }
+
+  virtual void setAllocator(HashStringAllocator* allocator) {
     allocator_ = allocator;
   }
 
@@ -77,7 +119,7 @@ class Aggregate {
   // the row. Only applies to accumulators that store variable size data out of
   // line. Fixed length accumulators do not use this. 0 if the row does not have
   // a size field.
-  void setOffsets(
+  virtual void setOffsets(
       int32_t offset,
       int32_t nullByte,
       uint8_t nullMask,
@@ -118,6 +160,15 @@ class Aggregate {
       const std::vector<VectorPtr>& args,
       bool mayPushdown) = 0;
 
+  // Same as addRawInput() for an aggregate with columnar accumulators.
+  // @param groupNumbers Numbers of the groups of the rows of 'args'.
+  virtual void addRawInputColumnar(
+      const uint32_t* /*groupNumbers*/,
+      const SelectivityVector& /*rows*/,
+      const std::vector<VectorPtr>& /*args*/) {
+    VELOX_UNSUPPORTED("Aggregate does not support columnar accumulators");
+  }
+
   // Updates final accumulators from intermediate results.
   // @param groups Pointers to the start of the group rows. These are aligned
   // with the 'args', e.g. data in the i-th row of the 'args' goes to the i-th
@@ -189,6 +240,11 @@ class Aggregate {
   // @param numGroups Number of groups to extract results from.
   // @param result The result vector to store the results in.
   //
+  // This is also how a final or single aggregation spills: Spiller writes the
+  // finalized accumulators of the spilled groups in the intermediate type and
+  // GroupingSet merges them back with addSingleGroupIntermediateResults(),
+  // so variable width accumulators need no separate serialization.
+  //
   // See comment on 'result' in extractValues().
   virtual void
   extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result) = 0;
@@ -197,6 +253,21 @@ class Aggregate {
   // 'groups'. No-op for fixed length accumulators.
   virtual void destroy(folly::Range<char**> /*groups*/) {}
 
+  // Returns true if HashStringAllocator::compact() may move the out of line
+  // storage of the accumulators. This is the case if the accumulators do
+  // not allocate from the HashStringAllocator or if
+  // relocateAccumulators() updates their pointers.
+  virtual bool supportsRelocation() const {
+    return false;
+  }
+
+  // Updates the pointers of the accumulators in 'groups' to the blocks
+  // moved by HashStringAllocator::compact(). No-op for accumulators that
+  // do not allocate from the HashStringAllocator.
+  virtual void relocateAccumulators(
+      folly::Range<char**> /*groups*/,
+      const HashStringAllocator::Relocation& /*relocation*/) {}
+
   // Clears state between reuses, e.g. this is called before reusing
   // the aggregation operator's state after flushing a partial
   // aggregation.
@@ -225,6 +296,9 @@ class Aggregate {
   }
 
   bool isNull(char* group) const {
+    if (columnar_) {
+      return numNulls_ && bits::isBitSet(columnarNulls_, groupNumber(group));
+    }
     return numNulls_ && (group[nullByte_] & nullMask_);
   }
 
@@ -238,6 +312,10 @@ class Aggregate {
   // Sets null flag for all specified groups to true.
   // For any given group, this method can be called at most once.
   void setAllNulls(char** groups, folly::Range<const vector_size_t*> indices) {
+    if (columnar_) {
+      setAllColumnarNulls(groups, indices);
+      return;
+    }
     for (auto i : indices) {
       groups[i][nullByte_] |= nullMask_;
     }
@@ -245,6 +323,15 @@ class Aggregate {
   }
 
   inline bool setNull(char* group) {
+    if (columnar_) {
+      auto number = groupNumber(group);
+      if (bits::isBitSet(columnarNulls_, number)) {
+        return false;
+      }
+      bits::setBit(columnarNulls_, number);
+      ++numNulls_;
+      return true;
+    }
     if (group[nullByte_] & nullMask_) {
       return false;
     }
@@ -254,6 +341,9 @@ class Aggregate {
   }
 
   inline bool clearNull(char* group) {
+    if (columnar_) {
+      return clearColumnarNull(groupNumber(group));
+    }
     if (numNulls_) {
       uint8_t mask = group[nullByte_];
       if (mask & nullMask_) {
@@ -267,9 +357,40 @@ class Aggregate {
 
   template <typename T>
   T* value(char* group) const {
+    if (columnar_) {
+      VELOX_DCHECK_LT(groupNumber(group), numColumnarGroups_);
+      return reinterpret_cast<T*>(
+          columnarValues_ + groupNumber(group) * columnarWidth_);
+    }
     return reinterpret_cast<T*>(group + offset_);
   }
 
+  uint32_t groupNumber(const char* group) const {
+    return *reinterpret_cast<const uint32_t*>(group + offset_);
+  }
+
+  // Returns the columnar accumulators. The accumulator of group number 'n'
+  // is at index 'n'.
+  template <typename T>
+  T* columnarValues() const {
+    VELOX_DCHECK_EQ(sizeof(T), columnarWidth_);
+    return reinterpret_cast<T*>(columnarValues_);
+  }
+
+  // Upper bound of the group numbers of the columnar accumulators.
+  uint64_t numColumnarGroups() const {
+    return numColumnarGroups_;
+  }
+
+  inline bool clearColumnarNull(uint32_t groupNumber) {
+    if (numNulls_ && bits::isBitSet(columnarNulls_, groupNumber)) {
+      bits::clearBit(columnarNulls_, groupNumber);
+      --numNulls_;
+      return true;
+    }
+    return false;
+  }
+
   template <typename T>
   static uint64_t* getRawNulls(T* vector) {
     if (vector->mayHaveNulls()) {
@@ -312,6 +433,24 @@ class Aggregate {
   // different indices vector as the one we get from the DecodedVector is simply
   // sequential.
   std::vector<vector_size_t> pushdownCustomIndices_;
+
+ private:
+  // setAllNulls() for columnar accumulators. Makes space for the new groups.
+  void setAllColumnarNulls(
+      char** groups,
+      folly::Range<const vector_size_t*> indices);
+
+  // True if the accumulators and null flags are in 'columnarValues_' and
+  // 'columnarNulls_'.
+  bool columnar_{false};
+  int32_t columnarWidth_{0};
+  // Number of groups there is space for in the columnar arrays.
+  uint64_t numColumnarGroups_{0};
+  // Backing storage of the columnar arrays.
+  std::vector<uint64_t> columnarStorage_;
+  std::vector<uint64_t> columnarNullsStorage_;
+  char* columnarValues_{nullptr};
+  uint64_t* columnarNulls_{nullptr};
 };
 
 using AggregateFunctionFactory = std::function<std::unique_ptr<Aggregate>(
@@ -44,6 +44,26 @@ void serializeOne(
   stream.appendOne<T>(vector.asUnchecked<SimpleVector<T>>()->valueAt(index));
 }
 
+// The complex type specializations are defined below. They are declared here
+// so that the loops over array elements can call them without a switch.
+template <>
+void serializeOne<TypeKind::ROW>(
+    const BaseVector& vector,
+    vector_size_t index,
+    ByteStream& out);
+
+template <>
+void serializeOne<TypeKind::ARRAY>(
+    const BaseVector& vector,
+    vector_size_t index,
+    ByteStream& out);
+
+template <>
+void serializeOne<TypeKind::MAP>(
+    const BaseVector& vector,
+    vector_size_t index,
+    ByteStream& out);
+
 template <>
 void serializeOne<TypeKind::VARCHAR>(
     const BaseVector& vector,
@@ -126,6 +146,24 @@ void writeNulls(
   }
 }
 
+// Writes the non-null elements at 'offset' + i for i < 'size', or at
+// 'indices[i]' if 'indices' is given. The dispatch on the element type is
+// made once for the array.
+template <TypeKind Kind>
+void serializeElements(
+    const BaseVector& elements,
+    vector_size_t offset,
+    const vector_size_t* indices,
+    vector_size_t size,
+    ByteStream& out) {
+  for (auto i = 0; i < size; ++i) {
+    auto index = indices ? indices[i] : offset + i;
+    if (!elements.isNullAt(index)) {
+      serializeOne<Kind>(elements, index, out);
+    }
+  }
+}
+
 void serializeArray(
     BaseVector& elements,
     vector_size_t offset,
@@ -133,11 +171,14 @@ void serializeArray(
     ByteStream& out) {
   out.appendOne<int32_t>(size);
   writeNulls(elements, offset, size, out);
-  for (auto i = 0; i < size; ++i) {
-    if (!elements.isNullAt(i + offset)) {
-      serializeSwitch(elements, i + offset, out);
-    }
-  }
+  VELOX_DYNAMIC_TYPE_DISPATCH(
+      serializeElements,
+      elements.typeKind(),
+      elements,
+      offset,
+      nullptr,
+      size,
+      out);
 }
 
 void serializeArray(
@@ -146,11 +187,14 @@ void serializeArray(
     ByteStream& out) {
   out.appendOne<int32_t>(indices.size());
   writeNulls(elements, indices, out);
-  for (auto i : indices) {
-    if (!elements.isNullAt(i)) {
-      serializeSwitch(elements, i, out);
-    }
-  }
+  VELOX_DYNAMIC_TYPE_DISPATCH(
+      serializeElements,
+      elements.typeKind(),
+      elements,
+      0,
+      indices.data(),
+      indices.size(),
+      out);
 }
 
 template <>
@@ -349,6 +393,20 @@ int32_t compare(
   return flags.ascending ? result : result * -1;
 }
 
+template <>
+int compare<TypeKind::ARRAY>(
+    ByteStream& left,
+    const BaseVector& right,
+    vector_size_t index,
+    CompareFlags flags);
+
+template <>
+int compare<TypeKind::MAP>(
+    ByteStream& left,
+    const BaseVector& right,
+    vector_size_t index,
+    CompareFlags flags);
+
 int compareStringAsc(
     ByteStream& left,
     const BaseVector& right,
@@ -435,24 +493,23 @@ int compare<TypeKind::ROW>(
   return 0;
 }
 
-int32_t compareArrays(
+// Compares the first 'compareSize' serialized elements in 'left' with the
+// elements of 'elements' at 'offset' + i, or at 'indices[i]' if 'indices' is
+// given. The dispatch on the element type is made once for the array.
+template <TypeKind Kind>
+int32_t compareElements(
     ByteStream& left,
-    BaseVector& elements,
+    const uint64_t* leftNulls,
+    const BaseVector& elements,
     vector_size_t offset,
-    vector_size_t rightSize,
+    const vector_size_t* indices,
+    vector_size_t compareSize,
     CompareFlags flags) {
-  VELOX_DCHECK(!flags.stopAtNull, "not supported compare flag");
-
-  int leftSize = left.read<int32_t>();
-  if (leftSize != rightSize && flags.equalsOnly) {
-    return flags.ascending ? 1 : -1;
-  }
-  auto compareSize = std::min(leftSize, rightSize);
-  auto leftNulls = readNulls(left, leftSize);
   auto wrappedElements = elements.wrappedVector();
   for (auto i = 0; i < compareSize; ++i) {
-    auto elementIndex = elements.wrappedIndex(offset + i);
-    bool leftNull = bits::isBitSet(leftNulls.data(), i);
+    auto elementIndex =
+        elements.wrappedIndex(indices ? indices[i] : offset + i);
+    bool leftNull = bits::isBitSet(leftNulls, i);
     bool rightNull = wrappedElements->isNullAt(elementIndex);
     if (leftNull) {
       if (rightNull) {
@@ -462,11 +519,41 @@ int32_t compareArrays(
     } else if (rightNull) {
       return flags.nullsFirst ? 1 : -1;
     }
-    int result = compareSwitch(left, *wrappedElements, elementIndex, flags);
+    int result = compare<Kind>(left, *wrappedElements, elementIndex, flags);
     if (result) {
       return result;
     }
   }
+  return 0;
+}
+
+int32_t compareArrays(
+    ByteStream& left,
+    BaseVector& elements,
+    vector_size_t offset,
+    vector_size_t rightSize,
+    CompareFlags flags) {
+  VELOX_DCHECK(!flags.stopAtNull, "not supported compare flag");
+
+  int leftSize = left.read<int32_t>();
+  if (leftSize != rightSize && flags.equalsOnly) {
+    return flags.ascending ? 1 : -1;
+  }
+  auto compareSize = std::min(leftSize, rightSize);
+  auto leftNulls = readNulls(left, leftSize);
+  auto result = VELOX_DYNAMIC_TYPE_DISPATCH(
+      compareElements,
+      elements.wrappedVector()->typeKind(),
+      left,
+      leftNulls.data(),
+      elements,
+      offset,
+      nullptr,
+      compareSize,
+      flags);
+  if (result) {
+    return result;
+  }
   return flags.ascending ? (leftSize - rightSize) : (rightSize - leftSize);
 }
 
@@ -484,23 +571,18 @@ int32_t compareArrayIndices(
   }
   auto compareSize = std::min(leftSize, rightSize);
   auto leftNulls = readNulls(left, leftSize);
-  auto wrappedElements = elements.wrappedVector();
-  for (auto i = 0; i < compareSize; ++i) {
-    auto elementIndex = elements.wrappedIndex(rightIndices[i]);
-    bool leftNull = bits::isBitSet(leftNulls.data(), i);
-    bool rightNull = wrappedElements->isNullAt(elementIndex);
-    if (leftNull) {
-      if (rightNull) {
-        continue;
-      }
-      return flags.nullsFirst ? -1 : 1;
-    } else if (rightNull) {
-      return flags.nullsFirst ? 1 : -1;
-    }
-    int result = compareSwitch(left, *wrappedElements, elementIndex, flags);
-    if (result) {
-      return result;
-    }
+  auto result = VELOX_DYNAMIC_TYPE_DISPATCH(
+      compareElements,
+      elements.wrappedVector()->typeKind(),
+      left,
+      leftNulls.data(),
+      elements,
+      0,
+      rightIndices.data(),
+      compareSize,
+      flags);
+  if (result) {
+    return result;
   }
   return flags.ascending ? (leftSize - rightSize) : (rightSize - leftSize);
 }
@@ -594,6 +676,27 @@ int32_t compare(
   return flags.ascending ? result : result * -1;
 }
 
+template <>
+int32_t compare<TypeKind::ROW>(
+    ByteStream& left,
+    ByteStream& right,
+    const Type* type,
+    CompareFlags flags);
+
+template <>
+int32_t compare<TypeKind::ARRAY>(
+    ByteStream& left,
+    ByteStream& right,
+    const Type* type,
+    CompareFlags flags);
+
+template <>
+int32_t compare<TypeKind::MAP>(
+    ByteStream& left,
+    ByteStream& right,
+    const Type* type,
+    CompareFlags flags);
+
 template <>
 int32_t compare<TypeKind::VARCHAR>(
     ByteStream& left,
@@ -626,24 +729,20 @@ int32_t compare<TypeKind::VARBINARY>(
                          : rightValue.compare(leftValue);
 }
 
-int32_t compareArrays(
+// Compares the first 'compareSize' serialized elements of 'left' and
+// 'right'. The dispatch on 'elementType' is made once for the array.
+template <TypeKind Kind>
+int32_t compareElements(
     ByteStream& left,
+    const uint64_t* leftNulls,
     ByteStream& right,
+    const uint64_t* rightNulls,
+    int32_t compareSize,
     const Type* elementType,
     CompareFlags flags) {
-  VELOX_DCHECK(!flags.stopAtNull, "not supported compare flag");
-
-  auto leftSize = left.read<int32_t>();
-  auto rightSize = right.read<int32_t>();
-  if (flags.equalsOnly && leftSize != rightSize) {
-    return flags.ascending ? 1 : -1;
-  }
-  auto compareSize = std::min(leftSize, rightSize);
-  auto leftNulls = readNulls(left, leftSize);
-  auto rightNulls = readNulls(right, rightSize);
   for (auto i = 0; i < compareSize; ++i) {
-    bool leftNull = bits::isBitSet(leftNulls.data(), i);
-    bool rightNull = bits::isBitSet(rightNulls.data(), i);
+    bool leftNull = bits::isBitSet(leftNulls, i);
+    bool rightNull = bits::isBitSet(rightNulls, i);
     if (leftNull && rightNull) {
       continue;
     }
@@ -653,11 +752,42 @@ int32_t compareArrays(
     if (rightNull) {
       return flags.nullsFirst ? 1 : -1;
     }
-    auto result = compareSwitch(left, right, elementType, flags);
+    auto result = compare<Kind>(left, right, elementType, flags);
     if (result) {
       return result;
     }
   }
+  return 0;
+}
+
+int32_t compareArrays(
+    ByteStream& left,
+    ByteStream& right,
+    const Type* elementType,
+    CompareFlags flags) {
+  VELOX_DCHECK(!flags.stopAtNull, "not supported compare flag");
+
+  auto leftSize = left.read<int32_t>();
+  auto rightSize = right.read<int32_t>();
+  if (flags.equalsOnly && leftSize != rightSize) {
+    return flags.ascending ? 1 : -1;
+  }
+  auto compareSize = std::min(leftSize, rightSize);
+  auto leftNulls = readNulls(left, leftSize);
+  auto rightNulls = readNulls(right, rightSize);
+  auto result = VELOX_DYNAMIC_TYPE_DISPATCH(
+      compareElements,
+      elementType->kind(),
+      left,
+      leftNulls.data(),
+      right,
+      rightNulls.data(),
+      compareSize,
+      elementType,
+      flags);
+  if (result) {
+    return result;
+  }
   return flags.ascending ? (leftSize - rightSize) : (rightSize - leftSize);
 }
 
@@ -753,21 +883,47 @@ uint64_t hashOne<TypeKind::VARBINARY>(
   return folly::hasher<StringView>()(readStringView(stream, storage));
 }
 
-uint64_t hashArray(ByteStream& in, uint64_t hash, const Type* elementType) {
-  auto size = in.read<int32_t>();
-  auto nulls = readNulls(in, size);
+template <>
+uint64_t hashOne<TypeKind::ROW>(ByteStream& in, const Type* type);
+
+template <>
+uint64_t hashOne<TypeKind::ARRAY>(ByteStream& in, const Type* type);
+
+template <>
+uint64_t hashOne<TypeKind::MAP>(ByteStream& in, const Type* type);
+
+template <TypeKind Kind>
+uint64_t hashElements(
+    ByteStream& in,
+    uint64_t hash,
+    const uint64_t* nulls,
+    int32_t size,
+    const Type* elementType) {
   for (auto i = 0; i < size; ++i) {
     uint64_t value;
-    if (bits::isBitSet(nulls.data(), i)) {
+    if (bits::isBitSet(nulls, i)) {
       value = BaseVector::kNullHash;
     } else {
-      value = hashSwitch(in, elementType);
+      value = hashOne<Kind>(in, elementType);
     }
     hash = bits::commutativeHashMix(hash, value);
   }
   return hash;
 }
 
+uint64_t hashArray(ByteStream& in, uint64_t hash, const Type* elementType) {
+  auto size = in.read<int32_t>();
+  auto nulls = readNulls(in, size);
+  return VELOX_DYNAMIC_TYPE_DISPATCH(
+      hashElements,
+      elementType->kind(),
+      in,
+      hash,
+      nulls.data(),
+      size,
+      elementType);
+}
+
 template <>
 uint64_t hashOne<TypeKind::ROW>(ByteStream& in, const Type* type) {
   auto size = type->size();
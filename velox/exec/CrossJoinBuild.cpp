@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/CrossJoinBuild.h"
+#include "velox/exec/RangeJoinProbe.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -50,13 +51,23 @@ CrossJoinBuild::CrossJoinBuild(
           nullptr,
           operatorId,
           joinNode->id(),
-          "CrossJoinBuild") {}
+          "CrossJoinBuild"),
+      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
+      rangeJoinNode_{
+          std::dynamic_pointer_cast<const core::RangeJoinNode>(joinNode)} {}
 
 void CrossJoinBuild::addInput(RowVectorPtr input) {
   if (input->size() > 0) {
-    // Load lazy vectors before storing.
+    // Load lazy vectors before storing. Strings are copied out of input
+    // buffers that are mostly unreferenced, e.g. by substrings, so that the
+    // retained build side does not hold on to them.
     for (auto& child : input->children()) {
-      child->loadedVector();
+      auto* loaded = child->loadedVector();
+      if (loaded->isFlatEncoding() &&
+          (loaded->typeKind() == TypeKind::VARCHAR ||
+           loaded->typeKind() == TypeKind::VARBINARY)) {
+        loaded->asFlatVector<StringView>()->compactStringBuffers();
+      }
     }
     data_.emplace_back(std::move(input));
   }
@@ -98,12 +109,57 @@ void CrossJoinBuild::noMoreInput() {
     promise.setValue();
   }
 
+  if (rangeJoinNode_) {
+    data_ = RangeJoinProbe::sortBuildSide(
+        *rangeJoinNode_, std::move(data_), pool());
+  } else {
+    coalesceData();
+  }
+
   operatorCtx_->task()
       ->getCrossJoinBridge(
           operatorCtx_->driverCtx()->splitGroupId, planNodeId())
       ->setData(std::move(data_));
 }
 
+void CrossJoinBuild::coalesceData() {
+  std::vector<VectorPtr> coalesced;
+  for (auto i = 0; i < data_.size();) {
+    if (data_[i]->size() >= outputBatchSize_) {
+      coalesced.push_back(std::move(data_[i++]));
+      continue;
+    }
+    // Find the run of small vectors starting at 'i'.
+    vector_size_t size = 0;
+    auto end = i;
+    while (end < data_.size() && data_[end]->size() < outputBatchSize_ &&
+           size < outputBatchSize_) {
+      size += data_[end++]->size();
+    }
+    if (end == i + 1) {
+      coalesced.push_back(std::move(data_[i++]));
+      continue;
+    }
+    auto batch = BaseVector::create(data_[i]->type(), size, pool());
+    auto* batchRow = batch->asUnchecked<RowVector>();
+    vector_size_t offset = 0;
+    for (; i < end; ++i) {
+      auto* source = data_[i]->asUnchecked<RowVector>();
+      for (auto column = 0; column < batchRow->childrenSize(); ++column) {
+        batchRow->childAt(column)->copy(
+            source->childAt(column)->loadedVector(),
+            offset,
+            0,
+            source->size());
+      }
+      offset += source->size();
+      data_[i] = nullptr;
+    }
+    coalesced.push_back(std::move(batch));
+  }
+  data_ = std::move(coalesced);
+}
+
 bool CrossJoinBuild::isFinished() {
   return !future_.valid() && noMoreInput_;
 }
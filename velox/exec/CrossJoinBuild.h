@@ -59,6 +59,19 @@ class CrossJoinBuild : public Operator {
   }
 
  private:
+  // Copies runs of consecutive build vectors smaller than 'outputBatchSize_'
+  // into vectors of about 'outputBatchSize_' rows. CrossJoinProbe pairs a
+  // batch of probe rows with one build vector at a time, so many small build
+  // vectors would make small output batches.
+  void coalesceData();
+
+  // Number of output rows of CrossJoinProbe per batch.
+  const uint32_t outputBatchSize_;
+
+  // Set if this is the build side of a RangeJoinNode. The data is then
+  // sorted for RangeJoinProbe instead of coalesced.
+  const std::shared_ptr<const core::RangeJoinNode> rangeJoinNode_;
+
   std::vector<VectorPtr> data_;
 
   // Future for synchronizing with other Drivers of the same pipeline. All build
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/CrossJoinProbe.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -22,24 +23,27 @@ CrossJoinProbe::CrossJoinProbe(
     int32_t operatorId,
     DriverCtx* driverCtx,
     const std::shared_ptr<const core::CrossJoinNode>& joinNode)
+    : CrossJoinProbe(operatorId, driverCtx, joinNode, "CrossJoinProbe") {}
+
+CrossJoinProbe::CrossJoinProbe(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::CrossJoinNode>& joinNode,
+    const std::string& operatorType)
     : Operator(
           driverCtx,
           joinNode->outputType(),
           operatorId,
           joinNode->id(),
-          "CrossJoinProbe"),
-      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()} {
-  bool isIdentityProjection = true;
-
+          operatorType),
+      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
+      filterResult_(1) {
   auto probeType = joinNode->sources()[0]->outputType();
   for (auto i = 0; i < probeType->size(); ++i) {
     auto name = probeType->nameOf(i);
     auto outIndex = outputType_->getChildIdxIfExists(name);
     if (outIndex.has_value()) {
       identityProjections_.emplace_back(i, outIndex.value());
-      if (outIndex != i) {
-        isIdentityProjection = false;
-      }
     }
   }
 
@@ -51,11 +55,45 @@ CrossJoinProbe::CrossJoinProbe(
     }
   }
 
-  if (isIdentityProjection && buildProjections_.empty()) {
-    isIdentityProjection_ = true;
+  if (joinNode->filter()) {
+    initializeFilter(joinNode->filter(), probeType, buildType);
   }
 }
 
+void CrossJoinProbe::initializeFilter(
+    const core::TypedExprPtr& filter,
+    const RowTypePtr& probeType,
+    const RowTypePtr& buildType) {
+  std::vector<core::TypedExprPtr> filters = {filter};
+  filter_ =
+      std::make_unique<ExprSet>(std::move(filters), operatorCtx_->execCtx());
+
+  column_index_t filterChannel = 0;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto& field : filter_->expr(0)->distinctFields()) {
+    const auto& name = field->field();
+    auto channel = probeType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      filterProbeInputs_.emplace_back(channel.value(), filterChannel++);
+      names.emplace_back(name);
+      types.emplace_back(probeType->childAt(channel.value()));
+      continue;
+    }
+    channel = buildType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      filterBuildInputs_.emplace_back(channel.value(), filterChannel++);
+      names.emplace_back(name);
+      types.emplace_back(buildType->childAt(channel.value()));
+      continue;
+    }
+    VELOX_FAIL(
+        "Join filter field {} not in probe or build input", field->toString());
+  }
+
+  filterInputType_ = ROW(std::move(names), std::move(types));
+}
+
 BlockingReason CrossJoinProbe::isBlocked(ContinueFuture* future) {
   if (buildData_.has_value()) {
     return BlockingReason::kNotBlocked;
@@ -92,66 +130,127 @@ void CrossJoinProbe::addInput(RowVectorPtr input) {
 }
 
 RowVectorPtr CrossJoinProbe::getOutput() {
-  if (!input_) {
-    return nullptr;
-  }
+  // With a filter, tiles with no passing rows are skipped.
+  while (input_) {
+    const auto inputSize = input_->size();
+    const auto& buildVector = buildData_.value()[buildIndex_];
+    const auto buildSize = buildVector->size();
 
-  const auto inputSize = input_->size();
+    // A tile is 'probeCnt' probe rows times 'buildCnt' build rows.
+    const vector_size_t buildCnt =
+        std::min<vector_size_t>(buildSize - buildRow_, outputBatchSize_);
+    const vector_size_t probeCnt = std::min<vector_size_t>(
+        std::max<vector_size_t>(1, outputBatchSize_ / buildCnt),
+        inputSize - probeRow_);
+    auto size = probeCnt * buildCnt;
 
-  auto buildSize = buildData_.value()[buildIndex_]->size();
-  vector_size_t probeCnt;
-  if (buildSize > outputBatchSize_) {
-    probeCnt = 1;
-  } else {
-    probeCnt = std::min(
-        (vector_size_t)outputBatchSize_ / buildSize, inputSize - probeRow_);
-  }
+    BufferPtr indices = allocateIndices(size, pool());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < probeCnt; ++i) {
+      std::fill(
+          rawIndices + i * buildCnt,
+          rawIndices + (i + 1) * buildCnt,
+          probeRow_ + i);
+    }
 
-  auto size = probeCnt * buildSize;
-  BufferPtr indices = allocateIndices(size, pool());
-  auto* rawIndices = indices->asMutable<vector_size_t>();
-  for (auto i = 0; i < probeCnt; ++i) {
-    std::fill(
-        rawIndices + i * buildSize,
-        rawIndices + (i + 1) * buildSize,
-        probeRow_ + i);
-  }
-  auto output = fillOutput(size, indices);
+    // The build vector is used as is if the tile covers it once.
+    BufferPtr buildIndices = nullptr;
+    if (probeCnt > 1 || buildCnt < buildSize || filter_) {
+      buildIndices = allocateIndices(size, pool());
+      auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
+      for (auto i = 0; i < probeCnt; ++i) {
+        std::iota(
+            rawBuildIndices + i * buildCnt,
+            rawBuildIndices + (i + 1) * buildCnt,
+            buildRow_);
+      }
+    }
 
-  BufferPtr buildIndices = nullptr;
-  if (probeCnt > 1) {
-    buildIndices = allocateIndices(size, pool());
-    auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
-    for (auto i = 0; i < probeCnt; ++i) {
-      std::iota(
-          rawBuildIndices + i * buildSize,
-          rawBuildIndices + (i + 1) * buildSize,
-          0);
+    auto buildRowVector = buildVector->asUnchecked<RowVector>();
+    if (filter_) {
+      size = evalFilter(size, indices, buildIndices, *buildRowVector);
     }
-  }
 
-  auto buildRowVector =
-      buildData_.value()[buildIndex_]->asUnchecked<RowVector>();
-  for (const auto& projection : buildProjections_) {
-    VectorPtr buildVector = buildRowVector->childAt(projection.inputChannel);
+    // 'input_' is reset when the last tile of it is done.
+    auto input = input_;
+    advance(probeCnt, buildCnt);
+    if (size == 0) {
+      continue;
+    }
 
-    if (buildIndices) {
-      buildVector = BaseVector::wrapInDictionary(
-          BufferPtr(nullptr), buildIndices, size, buildVector);
+    std::vector<VectorPtr> columns(outputType_->size());
+    for (const auto& projection : identityProjections_) {
+      columns[projection.outputChannel] =
+          wrapChild(size, indices, input->childAt(projection.inputChannel));
+    }
+    for (const auto& projection : buildProjections_) {
+      columns[projection.outputChannel] = wrapChild(
+          size,
+          buildIndices,
+          buildRowVector->childAt(projection.inputChannel));
     }
-    output->childAt(projection.outputChannel) = buildVector;
+    return std::make_shared<RowVector>(
+        pool(), outputType_, BufferPtr(nullptr), size, std::move(columns));
   }
+  return nullptr;
+}
 
+void CrossJoinProbe::advance(vector_size_t probeCnt, vector_size_t buildCnt) {
   probeRow_ += probeCnt;
-  if (probeRow_ == inputSize) {
-    probeRow_ = 0;
-    ++buildIndex_;
-    if (buildIndex_ == buildData_->size()) {
-      buildIndex_ = 0;
-      input_.reset();
+  if (probeRow_ < input_->size()) {
+    return;
+  }
+  probeRow_ = 0;
+  buildRow_ += buildCnt;
+  if (buildRow_ < buildData_.value()[buildIndex_]->size()) {
+    return;
+  }
+  buildRow_ = 0;
+  ++buildIndex_;
+  if (buildIndex_ == buildData_->size()) {
+    buildIndex_ = 0;
+    input_.reset();
+  }
+}
+
+vector_size_t CrossJoinProbe::evalFilter(
+    vector_size_t size,
+    const BufferPtr& probeIndices,
+    const BufferPtr& buildIndices,
+    const RowVector& buildVector) {
+  std::vector<VectorPtr> filterColumns(filterInputType_->size());
+  for (const auto& projection : filterProbeInputs_) {
+    filterColumns[projection.outputChannel] = wrapChild(
+        size, probeIndices, input_->childAt(projection.inputChannel));
+  }
+  for (const auto& projection : filterBuildInputs_) {
+    filterColumns[projection.outputChannel] = wrapChild(
+        size, buildIndices, buildVector.childAt(projection.inputChannel));
+  }
+  auto filterInput = std::make_shared<RowVector>(
+      pool(),
+      filterInputType_,
+      BufferPtr(nullptr),
+      size,
+      std::move(filterColumns));
+
+  filterRows_.resize(size);
+  filterRows_.setAll();
+  EvalCtx evalCtx(operatorCtx_->execCtx(), filter_.get(), filterInput.get());
+  filter_->eval(0, 1, true, filterRows_, &evalCtx, &filterResult_);
+  decodedFilterResult_.decode(*filterResult_[0], filterRows_);
+
+  auto* rawProbeIndices = probeIndices->asMutable<vector_size_t>();
+  auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
+  vector_size_t numPassed = 0;
+  for (auto i = 0; i < size; ++i) {
+    if (!decodedFilterResult_.isNullAt(i) &&
+        decodedFilterResult_.valueAt<bool>(i)) {
+      rawProbeIndices[numPassed] = rawProbeIndices[i];
+      rawBuildIndices[numPassed++] = rawBuildIndices[i];
     }
   }
-  return output;
+  return numPassed;
 }
 
 bool CrossJoinProbe::isFinished() {
@@ -19,12 +19,18 @@
 #include "velox/exec/Operator.h"
 
 namespace facebook::velox::exec {
+
+// Pairs each probe row with every build row. The output is produced in tiles:
+// a run of up to 'outputBatchSize_' rows of one build vector is paired with
+// as many probe rows as fit in a batch, and the run is paired with all probe
+// rows before moving to the next run. The join filter, if any, is evaluated
+// over a whole tile at a time.
 class CrossJoinProbe : public Operator {
  public:
   CrossJoinProbe(
       int32_t operatorId,
       DriverCtx* driverCtx,
-      const std::shared_ptr<const core::CrossJoinNode>& hashJoinNode);
+      const std::shared_ptr<const core::CrossJoinNode>& joinNode);
 
   void addInput(RowVectorPtr input) override;
 
@@ -40,7 +46,22 @@ class CrossJoinProbe : public Operator {
 
   void close() override;
 
- private:
+ protected:
+  CrossJoinProbe(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::CrossJoinNode>& joinNode,
+      const std::string& operatorType);
+
+  // Applies 'filter_' to the 'size' pairs of probe and build rows in
+  // 'probeIndices' and 'buildIndices'. Moves the passing pairs to the front
+  // of the indices and returns their number.
+  vector_size_t evalFilter(
+      vector_size_t size,
+      const BufferPtr& probeIndices,
+      const BufferPtr& buildIndices,
+      const RowVector& buildVector);
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
@@ -48,13 +69,43 @@ class CrossJoinProbe : public Operator {
 
   std::optional<std::vector<VectorPtr>> buildData_;
 
+  // Input row to process on next call to getOutput().
+  vector_size_t probeRow_{0};
+
+  bool buildSideEmpty_{false};
+
+  // Join filter.
+  std::unique_ptr<ExprSet> filter_;
+
+ private:
+  // Sets up 'filter_' and related members.
+  void initializeFilter(
+      const core::TypedExprPtr& filter,
+      const RowTypePtr& probeType,
+      const RowTypePtr& buildType);
+
+  // Advances to the next tile after 'probeCnt' x 'buildCnt' rows.
+  void advance(vector_size_t probeCnt, vector_size_t buildCnt);
+
   // Index into buildData_ for the build side vector to process on next call to
   // getOutput().
   size_t buildIndex_{0};
 
-  // Input row to process on next call to getOutput().
-  vector_size_t probeRow_{0};
+  // First row of buildData_[buildIndex_] to process on next call to
+  // getOutput().
+  vector_size_t buildRow_{0};
 
-  bool buildSideEmpty_{false};
+  // Type of the RowVector for filter inputs.
+  RowTypePtr filterInputType_;
+
+  // Maps input channels to channels in 'filterInputType_'.
+  std::vector<IdentityProjection> filterProbeInputs_;
+
+  // Maps build channels to channels in 'filterInputType_'.
+  std::vector<IdentityProjection> filterBuildInputs_;
+
+  SelectivityVector filterRows_;
+  std::vector<VectorPtr> filterResult_;
+  DecodedVector decodedFilterResult_;
 };
 } // namespace facebook::velox::exec
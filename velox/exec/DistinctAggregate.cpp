@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DistinctAggregate.h"
+
+#include <cmath>
+
+#include <folly/container/F14Set.h>
+
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+// Hash and equality that treat all NaNs as one value.
+template <typename T>
+struct ValueHash {
+  size_t operator()(const T& value) const {
+    if constexpr (std::is_floating_point_v<T>) {
+      if (std::isnan(value)) {
+        return std::hash<T>()(std::numeric_limits<T>::quiet_NaN());
+      }
+    }
+    return std::hash<T>()(value);
+  }
+};
+
+template <typename T>
+struct ValueEqual {
+  bool operator()(const T& left, const T& right) const {
+    if constexpr (std::is_floating_point_v<T>) {
+      if (std::isnan(left)) {
+        return std::isnan(right);
+      }
+    }
+    return left == right;
+  }
+};
+
+template <typename T>
+using ValueSet = folly::F14FastSet<
+    T,
+    ValueHash<T>,
+    ValueEqual<T>,
+    AlignedStlAllocator<T, 16>>;
+
+// The accumulator is the ValueSet<T> of the distinct values followed by the
+// accumulator of the wrapped aggregate. The null flag is the one of the
+// wrapped aggregate.
+template <typename T>
+class DistinctAggregate : public Aggregate {
+ public:
+  DistinctAggregate(std::unique_ptr<Aggregate> aggregate, TypePtr argType)
+      : Aggregate(aggregate->resultType()),
+        aggregate_(std::move(aggregate)),
+        argType_(std::move(argType)) {}
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return kSetSize + aggregate_->accumulatorFixedWidthSize();
+  }
+
+  bool accumulatorUsesExternalMemory() const override {
+    return aggregate_->accumulatorUsesExternalMemory();
+  }
+
+  bool isFixedSize() const override {
+    return false;
+  }
+
+  // extractValues() adds the distinct values to the wrapped aggregate.
+  bool canAddInputAfterFinalize() const override {
+    return false;
+  }
+
+  void setAllocator(HashStringAllocator* allocator) override {
+    Aggregate::setAllocator(allocator);
+    aggregate_->setAllocator(allocator);
+  }
+
+  void setOffsets(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      int32_t rowSizeOffset) override {
+    Aggregate::setOffsets(offset, nullByte, nullMask, rowSizeOffset);
+    aggregate_->setOffsets(
+        offset + kSetSize, nullByte, nullMask, rowSizeOffset);
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    for (auto index : indices) {
+      new (groups[index] + offset_)
+          ValueSet<T>(AlignedStlAllocator<T, 16>(allocator_));
+    }
+    aggregate_->initializeNewGroups(groups, indices);
+  }
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decoded_.decode(*args[0], rows);
+    rows.applyToSelected([&](vector_size_t row) {
+      if (!decoded_.isNullAt(row)) {
+        auto group = groups[row];
+        auto tracker = trackRowSize(group);
+        insert(group, decoded_.valueAt<T>(row));
+      }
+    });
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decoded_.decode(*args[0], rows);
+    auto tracker = trackRowSize(group);
+    rows.applyToSelected([&](vector_size_t row) {
+      if (!decoded_.isNullAt(row)) {
+        insert(group, decoded_.valueAt<T>(row));
+      }
+    });
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodeIntermediate(rows, args[0]);
+    rows.applyToSelected([&](vector_size_t row) {
+      auto group = groups[row];
+      auto tracker = trackRowSize(group);
+      addArray(group, row);
+    });
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodeIntermediate(rows, args[0]);
+    auto tracker = trackRowSize(group);
+    rows.applyToSelected([&](vector_size_t row) { addArray(group, row); });
+  }
+
+  // The sets are kept for extractAccumulators() after finalize(), which is
+  // how spilling extracts them.
+  void finalize(char** /*groups*/, int32_t /*numGroups*/) override {}
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    // Adds all the distinct values to the wrapped aggregate in one batch.
+    const auto numValues = countValues(groups, numGroups);
+    if (numValues > 0) {
+      auto values = BaseVector::create<FlatVector<T>>(
+          argType_, numValues, (*result)->pool());
+      valueGroups_.resize(numValues);
+      vector_size_t index = 0;
+      for (auto i = 0; i < numGroups; ++i) {
+        for (const auto& value : *set(groups[i])) {
+          // The strings stay in the sets until the groups are destroyed.
+          if constexpr (std::is_same_v<T, StringView>) {
+            values->setNoCopy(index, value);
+          } else {
+            values->set(index, value);
+          }
+          valueGroups_[index++] = groups[i];
+        }
+      }
+      aggregate_->addRawInput(
+          valueGroups_.data(), SelectivityVector(numValues), {values}, false);
+    }
+    aggregate_->finalize(groups, numGroups);
+    aggregate_->extractValues(groups, numGroups, result);
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto arrays = (*result)->as<ArrayVector>();
+    VELOX_CHECK_NOT_NULL(arrays);
+    arrays->resize(numGroups);
+    auto& elements = arrays->elements();
+    elements->resize(countValues(groups, numGroups));
+    auto flatElements = elements->asFlatVector<T>();
+    VELOX_CHECK_NOT_NULL(flatElements);
+
+    uint64_t* rawNulls = getRawNulls(arrays);
+    vector_size_t offset = 0;
+    for (auto i = 0; i < numGroups; ++i) {
+      clearNull(rawNulls, i);
+      auto* values = set(groups[i]);
+      arrays->setOffsetAndSize(i, offset, values->size());
+      for (const auto& value : *values) {
+        flatElements->set(offset++, value);
+      }
+    }
+  }
+
+  void destroy(folly::Range<char**> groups) override {
+    for (auto group : groups) {
+      auto* values = set(group);
+      if constexpr (std::is_same_v<T, StringView>) {
+        for (const auto& value : *values) {
+          if (!value.isInline()) {
+            allocator_->free(HashStringAllocator::headerOf(value.data()));
+          }
+        }
+      }
+      std::destroy_at(values);
+    }
+    aggregate_->destroy(groups);
+  }
+
+ private:
+  static constexpr int32_t kSetSize =
+      bits::roundUp(sizeof(ValueSet<T>), sizeof(void*));
+
+  ValueSet<T>* set(char* group) {
+    return value<ValueSet<T>>(group);
+  }
+
+  vector_size_t countValues(char** groups, int32_t numGroups) {
+    vector_size_t count = 0;
+    for (auto i = 0; i < numGroups; ++i) {
+      count += set(groups[i])->size();
+    }
+    return count;
+  }
+
+  void insert(char* group, const T& value) {
+    auto* values = set(group);
+    if constexpr (std::is_same_v<T, StringView>) {
+      // Strings that are not inline are copied when first seen.
+      if (!value.isInline()) {
+        if (values->find(value) == values->end()) {
+          auto* header = allocator_->allocate(value.size());
+          std::memcpy(header->begin(), value.data(), value.size());
+          values->insert(StringView(header->begin(), value.size()));
+        }
+        return;
+      }
+    }
+    values->insert(value);
+  }
+
+  void decodeIntermediate(const SelectivityVector& rows, const VectorPtr& arg) {
+    decodedIntermediate_.decode(*arg, rows);
+    auto arrays = decodedIntermediate_.base()->as<ArrayVector>();
+    VELOX_CHECK_NOT_NULL(arrays);
+    const auto& elements = arrays->elements();
+    decoded_.decode(*elements, SelectivityVector(elements->size()));
+  }
+
+  void addArray(char* group, vector_size_t row) {
+    if (decodedIntermediate_.isNullAt(row)) {
+      return;
+    }
+    auto arrays = decodedIntermediate_.base()->as<ArrayVector>();
+    const auto index = decodedIntermediate_.index(row);
+    const auto offset = arrays->offsetAt(index);
+    const auto size = arrays->sizeAt(index);
+    for (auto i = offset; i < offset + size; ++i) {
+      if (!decoded_.isNullAt(i)) {
+        insert(group, decoded_.valueAt<T>(i));
+      }
+    }
+  }
+
+  const std::unique_ptr<Aggregate> aggregate_;
+  const TypePtr argType_;
+  DecodedVector decoded_;
+  DecodedVector decodedIntermediate_;
+  // The group of each value passed to 'aggregate_' in extractValues().
+  std::vector<char*> valueGroups_;
+};
+
+} // namespace
+
+std::unique_ptr<Aggregate> createDistinctAggregate(
+    std::unique_ptr<Aggregate> aggregate,
+    const TypePtr& argType) {
+  switch (argType->kind()) {
+    case TypeKind::BOOLEAN:
+      return std::make_unique<DistinctAggregate<bool>>(
+          std::move(aggregate), argType);
+    case TypeKind::TINYINT:
+      return std::make_unique<DistinctAggregate<int8_t>>(
+          std::move(aggregate), argType);
+    case TypeKind::SMALLINT:
+      return std::make_unique<DistinctAggregate<int16_t>>(
+          std::move(aggregate), argType);
+    case TypeKind::INTEGER:
+      return std::make_unique<DistinctAggregate<int32_t>>(
+          std::move(aggregate), argType);
+    case TypeKind::BIGINT:
+      return std::make_unique<DistinctAggregate<int64_t>>(
+          std::move(aggregate), argType);
+    case TypeKind::REAL:
+      return std::make_unique<DistinctAggregate<float>>(
+          std::move(aggregate), argType);
+    case TypeKind::DOUBLE:
+      return std::make_unique<DistinctAggregate<double>>(
+          std::move(aggregate), argType);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return std::make_unique<DistinctAggregate<StringView>>(
+          std::move(aggregate), argType);
+    case TypeKind::TIMESTAMP:
+      return std::make_unique<DistinctAggregate<Timestamp>>(
+          std::move(aggregate), argType);
+    case TypeKind::DATE:
+      return std::make_unique<DistinctAggregate<Date>>(
+          std::move(aggregate), argType);
+    default:
+      VELOX_UNSUPPORTED(
+          "Distinct aggregation is not supported for type {}",
+          argType->toString());
+  }
+}
+
+TypePtr distinctAggregateIntermediateType(const TypePtr& argType) {
+  return ARRAY(argType);
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/Aggregate.h"
+
+namespace facebook::velox::exec {
+
+/// Returns an Aggregate that applies 'aggregate' to the distinct non-null
+/// values of its single argument of 'argType', e.g. count(DISTINCT x). The
+/// distinct values of each group are kept in a hash set allocated from the
+/// HashStringAllocator of the groups, followed by the accumulator of
+/// 'aggregate'. The values are added to 'aggregate' when extracting the
+/// final results. The intermediate result, e.g. for spilling, is the array of
+/// the distinct values, see distinctAggregateIntermediateType(). Supports
+/// scalar argument types.
+std::unique_ptr<Aggregate> createDistinctAggregate(
+    std::unique_ptr<Aggregate> aggregate,
+    const TypePtr& argType);
+
+/// Returns the intermediate type of a distinct aggregate over 'argType'.
+TypePtr distinctAggregateIntermediateType(const TypePtr& argType);
+
+} // namespace facebook::velox::exec
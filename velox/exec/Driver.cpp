@@ -18,8 +18,12 @@
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <folly/executors/task_queue/UnboundedBlockingQueue.h>
 #include <folly/executors/thread_factory/InitThreadFactory.h>
+#include <folly/hash/Hash.h>
 #include <gflags/gflags.h>
+#include "velox/common/process/EventTrace.h"
+#include "velox/common/process/ProcessBase.h"
 #include "velox/common/time/Timer.h"
+#include "velox/exec/DriverExecutor.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Task.h"
 
@@ -48,6 +52,34 @@ velox::memory::MemoryPool* FOLLY_NONNULL DriverCtx::addOperatorPool() {
 
 std::atomic_uint64_t BlockingState::numBlockedDrivers_{0};
 
+namespace {
+// Records the wait of a blocked Driver since 'sinceMicros' on the lane of the
+// Driver in the trace of its Task.
+void recordBlockedTime(
+    const Driver& driver,
+    Operator& op,
+    BlockingReason reason,
+    uint64_t sinceMicros) {
+  const auto* ctx = driver.driverCtx();
+  const auto durationMicros =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::high_resolution_clock::now().time_since_epoch())
+          .count() -
+      sinceMicros;
+  process::TraceEvent event;
+  event.category = "blocked";
+  event.setName(
+      {op.stats().operatorType,
+       op.stats().planNodeId,
+       blockingReasonToString(reason)});
+  event.traceId = ctx->task->traceId();
+  event.startMicros = process::EventTrace::nowMicros() - durationMicros;
+  event.durationMicros = durationMicros;
+  event.lane = Task::traceLane(ctx->pipelineId, ctx->driverId);
+  process::EventTrace::record(event);
+}
+} // namespace
+
 BlockingState::BlockingState(
     std::shared_ptr<Driver> driver,
     ContinueFuture&& future,
@@ -81,6 +113,10 @@ void BlockingState::setResume(std::shared_ptr<BlockingState> state) {
           // references.
           return;
         }
+        if (task->traceId() != 0) {
+          recordBlockedTime(
+              *driver, *state->operator_, state->reason_, state->sinceMicros_);
+        }
         {
           std::lock_guard<std::mutex> l(task->mutex());
           VELOX_CHECK(!driver->state().isSuspended);
@@ -152,17 +188,73 @@ void Driver::enqueue(std::shared_ptr<Driver> driver) {
   if (driver->closed_) {
     return;
   }
-  driver->task()->queryCtx()->executor()->add(
-      [driver]() { Driver::run(driver); });
+  auto executor = driver->task()->queryCtx()->executor();
+  if (auto driverExecutor = dynamic_cast<DriverExecutor*>(executor)) {
+    auto worker = driver->preferredWorker(*driverExecutor);
+    driverExecutor->addWithAffinity(
+        [driver]() { Driver::run(driver); },
+        worker,
+        driver->ctx_->queryConfig().driverPriority());
+    return;
+  }
+  executor->add([driver]() { Driver::run(driver); });
+}
+
+int32_t Driver::preferredWorker(const DriverExecutor& executor) const {
+  if (lastWorker_ >= 0) {
+    return lastWorker_;
+  }
+  // Spread the Drivers of a Task over consecutive workers. Drivers with the
+  // same id in different pipelines, e.g. probe and build, start together.
+  return (folly::hasher<std::string>()(task()->taskId()) + ctx_->driverId) %
+      executor.numWorkers();
+}
+
+void Driver::startTimeSlice() {
+  const uint64_t sliceMs = ctx_->queryConfig().driverCpuTimeSliceMs();
+  timeSliceEndCpuNanos_ =
+      sliceMs == 0 ? 0 : process::threadCpuNanos() + sliceMs * 1'000'000;
+}
+
+bool Driver::timeSliceExpired() {
+  if (timeSliceEndCpuNanos_ == 0 ||
+      process::threadCpuNanos() < timeSliceEndCpuNanos_) {
+    return false;
+  }
+  task()->addDriverTimeSliceYield();
+  return true;
+}
+
+void Driver::updateWorker() {
+  auto executor = DriverExecutor::current();
+  if (!executor || task()->queryCtx()->executor() != executor) {
+    return;
+  }
+  auto worker = DriverExecutor::currentWorker();
+  bool migrated = lastWorker_ >= 0 && worker != lastWorker_;
+  bool crossNode = migrated &&
+      executor->numaNode(worker) != executor->numaNode(lastWorker_);
+  task()->addDriverExecutorRun(migrated, crossNode);
+  lastWorker_ = worker;
 }
 
 Driver::Driver(
     std::unique_ptr<DriverCtx> ctx,
     std::vector<std::unique_ptr<Operator>> operators)
-    : ctx_(std::move(ctx)), operators_(std::move(operators)) {
+    : ctx_(std::move(ctx)),
+      operators_(std::move(operators)),
+      traceName_(
+          fmt::format("Driver {}.{}", ctx_->pipelineId, ctx_->driverId)) {
   curOpIndex_ = operators_.size() - 1;
   // Operators need access to their Driver for adaptation.
   ctx_->driver = this;
+  // A source directly followed by e.g. a Limit produces only the rows the
+  // Limit can use.
+  if (operators_.size() > 1 && operators_[0]->canPushdownLimit()) {
+    if (auto numRows = operators_[1]->maxInputRows()) {
+      operators_[0]->pushdownLimit(numRows.value());
+    }
+  }
 }
 
 namespace {
@@ -308,6 +400,18 @@ StopReason Driver::runInternal(
   const auto statWriterGuard =
       folly::makeGuard([]() { setRunTimeStatWriter(nullptr); });
 
+  // The hardware events of an operator call go to the operator's stats if
+  // enabled for the query.
+  const bool perfEventsEnabled = ctx_->queryConfig().perfEventsEnabled();
+  auto perfEventCounts = [&](Operator* op) {
+    return perfEventsEnabled ? &op->stats().perfEventCounts : nullptr;
+  };
+
+  // The slice and the operator calls in it are recorded in the trace of the
+  // Task if it has one.
+  process::ScopedTraceId traceId(task()->traceId());
+  process::TraceSpan runSpan("driver", {traceName_, "run"});
+
   try {
     int32_t numOperators = operators_.size();
     ContinueFuture future;
@@ -319,6 +423,11 @@ StopReason Driver::runInternal(
           guard.notThrown();
           return stop;
         }
+        if (timeSliceExpired()) {
+          // Driver::run() queues 'this' behind the other Drivers.
+          guard.notThrown();
+          return StopReason::kYield;
+        }
 
         auto op = operators_[i].get();
         // In case we are blocked, this index will point to the operator, whose
@@ -351,6 +460,12 @@ StopReason Driver::runInternal(
             RowVectorPtr result;
             {
               CpuWallTimer timer(op->stats().getOutputTiming);
+              process::PerfEventTimer perfTimer(perfEventCounts(op));
+              process::TraceSpan span(
+                  "operator",
+                  {op->stats().operatorType,
+                   op->stats().planNodeId,
+                   "getOutput"});
               result = op->getOutput();
               if (result) {
                 op->stats().outputVectors += 1;
@@ -362,6 +477,12 @@ StopReason Driver::runInternal(
             pushdownFilters(i);
             if (result) {
               CpuWallTimer timer(nextOp->stats().addInputTiming);
+              process::PerfEventTimer perfTimer(perfEventCounts(nextOp));
+              process::TraceSpan span(
+                  "operator",
+                  {nextOp->stats().operatorType,
+                   nextOp->stats().planNodeId,
+                   "addInput"});
               nextOp->stats().inputVectors += 1;
               nextOp->stats().inputPositions += result->size();
               nextOp->stats().inputBytes += resultBytes;
@@ -391,6 +512,12 @@ StopReason Driver::runInternal(
               }
               if (op->isFinished()) {
                 CpuWallTimer timer(nextOp->stats().finishTiming);
+                process::PerfEventTimer perfTimer(perfEventCounts(nextOp));
+                process::TraceSpan span(
+                    "operator",
+                    {nextOp->stats().operatorType,
+                     nextOp->stats().planNodeId,
+                     "noMoreInput"});
                 nextOp->noMoreInput();
                 break;
               }
@@ -403,6 +530,12 @@ StopReason Driver::runInternal(
           // will come back here after this is again on thread.
           {
             CpuWallTimer timer(op->stats().getOutputTiming);
+            process::PerfEventTimer perfTimer(perfEventCounts(op));
+            process::TraceSpan span(
+                "operator",
+                {op->stats().operatorType,
+                 op->stats().planNodeId,
+                 "getOutput"});
             result = op->getOutput();
             if (result) {
               // This code path is used only in single-threaded execution.
@@ -434,6 +567,8 @@ StopReason Driver::runInternal(
 
 // static
 void Driver::run(std::shared_ptr<Driver> self) {
+  self->updateWorker();
+  self->startTimeSlice();
   std::shared_ptr<BlockingState> blockingState;
   RowVectorPtr nullResult;
   auto reason = self->runInternal(self, blockingState, nullResult);
@@ -465,6 +600,16 @@ void Driver::run(std::shared_ptr<Driver> self) {
   }
 }
 
+void Driver::reclaim() {
+  VELOX_CHECK(!isOnThread());
+  if (closed_) {
+    return;
+  }
+  for (auto& op : operators_) {
+    op->reclaim();
+  }
+}
+
 void Driver::initializeOperatorStats(std::vector<OperatorStats>& stats) {
   stats.resize(operators_.size(), OperatorStats(0, 0, "", ""));
   // initialize the place in stats given by the operatorId. Use the
@@ -479,6 +624,27 @@ void Driver::initializeOperatorStats(std::vector<OperatorStats>& stats) {
   }
 }
 
+void Driver::addMemoryUsage(
+    std::map<std::string, memory::MemoryUsageSnapshot>& usage) const {
+  for (auto& op : operators_) {
+    const auto& tracker = op->pool()->getMemoryUsageTracker();
+    if (!tracker) {
+      continue;
+    }
+    const auto& stats = op->stats();
+    auto name = fmt::format("{}.{}", stats.planNodeId, stats.operatorType);
+    auto& operatorUsage = usage[name];
+    operatorUsage.name = name;
+    auto driverUsage = memory::MemoryUsageSnapshot::fromTracker(name, *tracker);
+    operatorUsage.currentBytes += driverUsage.currentBytes;
+    operatorUsage.peakBytes += driverUsage.peakBytes;
+    operatorUsage.allocatedBytes += driverUsage.allocatedBytes;
+    for (auto i = 0; i < driverUsage.sizeHistogram.size(); ++i) {
+      operatorUsage.sizeHistogram[i] += driverUsage.sizeHistogram[i];
+    }
+  }
+}
+
 void Driver::addStatsToTask() {
   for (auto& op : operators_) {
     auto& stats = op->stats();
@@ -500,6 +666,9 @@ void Driver::close() {
   for (auto& op : operators_) {
     op->close();
   }
+  // Returns the pages this thread cached for the operators to the other
+  // threads.
+  task()->queryCtx()->mappedMemory()->flushThreadCache();
   closed_ = true;
   Task::removeDriver(ctx_->task, this);
 }
@@ -513,19 +682,17 @@ void Driver::closeByTask() {
   closed_ = true;
 }
 
-bool Driver::mayPushdownAggregation(Operator* aggregation) const {
+bool Driver::mayPushdownValueHook(Operator* op) const {
   for (auto i = 1; i < operators_.size(); ++i) {
-    auto op = operators_[i].get();
-    if (aggregation == op) {
+    auto other = operators_[i].get();
+    if (op == other) {
       return true;
     }
-    if (!op->isFilter() || !op->preservesOrder()) {
+    if (!other->isFilter() || !other->preservesOrder()) {
       return false;
     }
   }
-  VELOX_FAIL(
-      "Aggregation operator not found in its Driver: {}",
-      aggregation->toString());
+  VELOX_FAIL("Operator not found in its Driver: {}", op->toString());
 }
 
 std::unordered_set<column_index_t> Driver::canPushdownFilters(
@@ -638,6 +805,8 @@ std::string blockingReasonToString(BlockingReason reason) {
       return "kWaitForMemory";
     case BlockingReason::kWaitForConnector:
       return "kWaitForConnector";
+    case BlockingReason::kWaitForPeers:
+      return "kWaitForPeers";
   }
   VELOX_UNREACHABLE();
   return "";
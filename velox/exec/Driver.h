@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #pragma once
+#include <map>
+
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/futures/Future.h>
 #include <folly/portability/SysSyscall.h>
@@ -26,6 +28,7 @@
 namespace facebook::velox::exec {
 
 class Driver;
+class DriverExecutor;
 class ExchangeClient;
 class Operator;
 struct OperatorStats;
@@ -126,6 +129,7 @@ enum class BlockingReason {
   kWaitForJoinBuild,
   kWaitForMemory,
   kWaitForConnector,
+  kWaitForPeers,
 };
 
 std::string blockingReasonToString(BlockingReason reason);
@@ -236,11 +240,18 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   void initializeOperatorStats(std::vector<OperatorStats>& stats);
 
+  // Adds the memory usage of the operators of 'this' to the element of
+  // 'usage' named <plan node id>.<operator type>.
+  void addMemoryUsage(
+      std::map<std::string, memory::MemoryUsageSnapshot>& usage) const;
+
   void addStatsToTask();
 
-  // Returns true if all operators between the source and 'aggregation' are
-  // order-preserving and do not increase cardinality.
-  bool mayPushdownAggregation(Operator* FOLLY_NONNULL aggregation) const;
+  // Returns true if all operators between the source and 'op' are
+  // order-preserving and do not increase cardinality, so that 'op' may load
+  // the LazyVectors of the source with a ValueHook, e.g. for aggregation or
+  // projection pushdown.
+  bool mayPushdownValueHook(Operator* FOLLY_NONNULL op) const;
 
   // Returns a subset of channels for which there are operators upstream from
   // filterSource that accept dynamically generated filters.
@@ -269,6 +280,10 @@ class Driver : public std::enable_shared_from_this<Driver> {
   // closing non-running Drivers.
   void closeByTask();
 
+  // Calls Operator::reclaim() on the operators of 'this'. Only called by Task
+  // while 'this' is off thread.
+  void reclaim();
+
  private:
   void enqueueInternal();
 
@@ -285,6 +300,20 @@ class Driver : public std::enable_shared_from_this<Driver> {
   // position in the pipeline.
   void pushdownFilters(int operatorIndex);
 
+  // Returns the worker of 'executor' to queue 'this' on.
+  int32_t preferredWorker(const DriverExecutor& executor) const;
+
+  // Records the DriverExecutor worker running 'this' and updates the
+  // placement stats of the Task.
+  void updateWorker();
+
+  // Starts the CPU time slice of a run on an executor thread. See
+  // QueryConfig::kDriverCpuTimeSliceMs.
+  void startTimeSlice();
+
+  // Returns true if 'this' has used up its time slice and should yield.
+  bool timeSliceExpired();
+
   std::unique_ptr<DriverCtx> ctx_;
   std::atomic_bool closed_{false};
 
@@ -293,12 +322,24 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   // Timer used to track down the time we are sitting in the driver queue.
   size_t queueTimeStartMicros_{0};
+
+  // DriverExecutor worker that ran 'this' last, -1 if none. Driver::enqueue()
+  // queues 'this' on the same worker to keep its memory local.
+  int32_t lastWorker_{-1};
+
+  // Thread CPU time at which the current run on an executor thread yields.
+  // 0 if the run has no time slice, e.g. when running via next().
+  uint64_t timeSliceEndCpuNanos_{0};
+
   // Index of the current operator to run (or the 1st one if we haven't started
   // yet). Used to determine which operator's queueTime we should update.
   size_t curOpIndex_{0};
 
   std::vector<std::unique_ptr<Operator>> operators_;
 
+  // Names the run slices of 'this' in the trace of the Task.
+  const std::string traceName_;
+
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
 };
 
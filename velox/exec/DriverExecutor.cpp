@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverExecutor.h"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <glog/logging.h>
+#include <unistd.h>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace facebook::velox::exec {
+
+namespace {
+thread_local DriverExecutor* currentExecutor{nullptr};
+thread_local int32_t currentWorkerIndex{-1};
+
+// Upper bound on NUMA node numbers probed in sysfs.
+constexpr int32_t kMaxNumaNodes = 64;
+} // namespace
+
+DriverExecutor::DriverExecutor(Options options) : options_(options) {
+  int32_t numCpus = std::max(1U, std::thread::hardware_concurrency());
+  auto numThreads = options_.numThreads > 0 ? options_.numThreads : numCpus;
+
+  // Nodes are numbered densely in order of first appearance.
+  std::unordered_map<int32_t, int32_t> nodeIndices;
+  for (auto i = 0; i < numThreads; ++i) {
+    auto worker = std::make_unique<Worker>();
+    auto node = options_.pinThreads ? numaNodeOfCpu(i % numCpus) : 0;
+    worker->node = nodeIndices.emplace(node, nodeIndices.size()).first->second;
+    if (worker->node == workersByNode_.size()) {
+      workersByNode_.emplace_back();
+    }
+    workersByNode_[worker->node].push_back(i);
+    workers_.push_back(std::move(worker));
+  }
+  numQueued_ =
+      std::make_unique<std::atomic<int64_t>[]>(workersByNode_.size());
+
+  for (auto i = 0; i < numThreads; ++i) {
+    workers_[i]->thread = std::thread([this, i, numCpus]() {
+#ifdef __linux__
+      if (options_.pinThreads) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(i % numCpus, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus)) {
+          LOG(WARNING) << "Failed to pin DriverExecutor worker " << i;
+        }
+      }
+#endif
+      currentExecutor = this;
+      currentWorkerIndex = i;
+      run(i);
+    });
+  }
+}
+
+DriverExecutor::~DriverExecutor() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    stop_ = true;
+    for (auto& worker : workers_) {
+      worker->wakeup.notify_one();
+    }
+  }
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+// static
+DriverExecutor* DriverExecutor::current() {
+  return currentExecutor;
+}
+
+// static
+int32_t DriverExecutor::currentWorker() {
+  return currentWorkerIndex;
+}
+
+// static
+int32_t DriverExecutor::numaNodeOfCpu(int32_t cpu) {
+#ifdef __linux__
+  // The directory of each CPU has a link to the directory of its node.
+  for (auto node = 0; node < kMaxNumaNodes; ++node) {
+    auto path = fmt::format("/sys/devices/system/cpu/cpu{}/node{}", cpu, node);
+    if (access(path.c_str(), F_OK) == 0) {
+      return node;
+    }
+  }
+#endif
+  return 0;
+}
+
+void DriverExecutor::add(folly::Func func) {
+  addWithAffinity(std::move(func), -1);
+}
+
+void DriverExecutor::addWithAffinity(
+    folly::Func func,
+    int32_t worker,
+    int32_t priority) {
+  if (worker < 0) {
+    worker = current() == this ? currentWorker()
+                               : nextWorker_++ % workers_.size();
+  }
+  push(
+      worker % workers_.size(),
+      std::move(func),
+      std::clamp(priority, 0, kNumPriorities - 1));
+}
+
+void DriverExecutor::push(int32_t worker, folly::Func func, int32_t priority) {
+  auto& target = *workers_[worker];
+  int32_t queueSize;
+  {
+    std::lock_guard<std::mutex> l(target.mutex);
+    auto& queue = target.queues[priority];
+    if (queue.empty()) {
+      target.passes[priority] =
+          std::max(target.passes[priority], target.pass);
+    }
+    queue.push_back(std::move(func));
+    queueSize = ++target.numQueued;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  ++numQueued_[target.node];
+  // A worker adding to its own empty queue, e.g. for a yielding Driver, runs
+  // the function next. Waking up another worker would only move it.
+  if (queueSize == 1 && current() == this && currentWorker() == worker) {
+    return;
+  }
+  wakeUp(worker);
+}
+
+void DriverExecutor::wakeUp(int32_t worker) {
+  auto& target = *workers_[worker];
+  Worker* idleWorker = target.idle ? &target : nullptr;
+  for (auto i = 0; !idleWorker && i < workersByNode_[target.node].size();
+       ++i) {
+    auto& candidate = *workers_[workersByNode_[target.node][i]];
+    if (candidate.idle) {
+      idleWorker = &candidate;
+    }
+  }
+  for (auto i = 0; options_.crossNodeStealing && !idleWorker &&
+       i < workers_.size();
+       ++i) {
+    if (workers_[i]->idle) {
+      idleWorker = workers_[i].get();
+    }
+  }
+  if (idleWorker) {
+    idleWorker->idle = false;
+    idleWorker->wakeup.notify_one();
+  }
+}
+
+folly::Func DriverExecutor::takeFrom(int32_t victim, bool steal) {
+  auto& worker = *workers_[victim];
+  folly::Func func;
+  {
+    std::lock_guard<std::mutex> l(worker.mutex);
+    if (worker.numQueued == 0) {
+      return func;
+    }
+    int32_t priority = -1;
+    for (auto i = kNumPriorities - 1; i >= 0; --i) {
+      if (!worker.queues[i].empty() &&
+          (priority < 0 || steal ||
+           worker.passes[i] < worker.passes[priority])) {
+        priority = i;
+        if (steal) {
+          break;
+        }
+      }
+    }
+    auto& queue = worker.queues[priority];
+    if (steal) {
+      func = std::move(queue.back());
+      queue.pop_back();
+    } else {
+      func = std::move(queue.front());
+      queue.pop_front();
+      worker.pass = worker.passes[priority];
+      worker.passes[priority] += kStride >> priority;
+    }
+    --worker.numQueued;
+  }
+  --numQueued_[worker.node];
+  return func;
+}
+
+folly::Func DriverExecutor::take(int32_t worker) {
+  if (auto func = takeFrom(worker, false)) {
+    return func;
+  }
+  auto node = workers_[worker]->node;
+  const auto& sameNode = workersByNode_[node];
+  for (auto i = 0; i < sameNode.size(); ++i) {
+    // Start at different positions so that thieves spread over the victims.
+    auto victim = sameNode[(worker + i) % sameNode.size()];
+    if (victim == worker) {
+      continue;
+    }
+    if (auto func = takeFrom(victim, true)) {
+      ++numStolen_;
+      return func;
+    }
+  }
+  if (!options_.crossNodeStealing) {
+    return nullptr;
+  }
+  for (auto i = 1; i < workers_.size(); ++i) {
+    auto victim = (worker + i) % workers_.size();
+    if (workers_[victim]->node == node) {
+      continue;
+    }
+    if (auto func = takeFrom(victim, true)) {
+      ++numStolen_;
+      ++numCrossNodeStolen_;
+      return func;
+    }
+  }
+  return nullptr;
+}
+
+bool DriverExecutor::hasWork(int32_t worker) const {
+  if (!options_.crossNodeStealing) {
+    return numQueued_[workers_[worker]->node] > 0;
+  }
+  for (auto node = 0; node < workersByNode_.size(); ++node) {
+    if (numQueued_[node] > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void DriverExecutor::run(int32_t worker) {
+  for (;;) {
+    if (auto func = take(worker)) {
+      try {
+        func();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "DriverExecutor function threw: " << e.what();
+      }
+      ++numRun_;
+      continue;
+    }
+    std::unique_lock<std::mutex> l(mutex_);
+    if (hasWork(worker)) {
+      continue;
+    }
+    if (stop_) {
+      return;
+    }
+    auto& self = *workers_[worker];
+    self.idle = true;
+    self.wakeup.wait(l, [&]() { return stop_ || hasWork(worker); });
+    self.idle = false;
+  }
+}
+
+DriverExecutor::Stats DriverExecutor::stats() const {
+  Stats stats;
+  stats.numRun = numRun_;
+  stats.numStolen = numStolen_;
+  stats.numCrossNodeStolen = numCrossNodeStolen_;
+  return stats;
+}
+
+} // namespace facebook::velox::exec
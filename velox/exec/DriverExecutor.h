@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <folly/Executor.h>
+
+namespace facebook::velox::exec {
+
+/// Executor with one run queue per worker thread, meant to be passed to
+/// QueryCtx for running Drivers. Functions are added to the queue of a
+/// specific worker. A worker runs the functions of its own queue in FIFO
+/// order. When its queue is empty, it steals from the back of the queues of
+/// other workers, first from workers on the same NUMA node, then, if
+/// allowed, from workers on other nodes.
+///
+/// Driver::enqueue() adds a Driver to the worker that ran it last, so that
+/// the Driver keeps running on the core, and thus the NUMA node, where its
+/// memory was first touched. Worker threads are pinned to cores on Linux.
+///
+/// Each function has a priority from 0 to kNumPriorities - 1. A worker
+/// shares its time between the priorities of its queued functions with
+/// stride scheduling: A function of priority p gets twice the share of a
+/// function of priority p - 1, so that short, high priority queries do not
+/// wait behind long running ones but low priority work still progresses.
+/// Drivers give up their thread at the end of a time slice, see
+/// QueryConfig::kDriverCpuTimeSliceMs.
+class DriverExecutor : public folly::Executor {
+ public:
+  static constexpr int32_t kNumPriorities = 4;
+
+  struct Options {
+    /// Number of worker threads. 0 means one per hardware thread.
+    int32_t numThreads{0};
+
+    /// If true, worker i is pinned to CPU i modulo the number of CPUs. Linux
+    /// only.
+    bool pinThreads{true};
+
+    /// If true, idle workers steal from workers on other NUMA nodes after
+    /// finding no work on their own node.
+    bool crossNodeStealing{true};
+  };
+
+  struct Stats {
+    /// Number of functions run.
+    uint64_t numRun{0};
+
+    /// Number of functions run by a worker other than the one whose queue
+    /// they were added to.
+    uint64_t numStolen{0};
+
+    /// Number of stolen functions that were queued on another NUMA node.
+    uint64_t numCrossNodeStolen{0};
+  };
+
+  DriverExecutor() : DriverExecutor(Options{}) {}
+
+  explicit DriverExecutor(Options options);
+
+  /// Runs the functions left in the queues and joins the workers.
+  ~DriverExecutor() override;
+
+  /// Adds 'func' with priority 0 to the queue of the calling worker or to a
+  /// worker picked round-robin if the caller is not a worker of 'this'.
+  void add(folly::Func func) override;
+
+  /// Adds 'func' to the queue of 'worker'. Same as add() if 'worker' is
+  /// negative. 'priority' is clamped to [0, kNumPriorities - 1].
+  void addWithAffinity(folly::Func func, int32_t worker, int32_t priority = 0);
+
+  int32_t numWorkers() const {
+    return workers_.size();
+  }
+
+  /// Returns the NUMA node of the CPU 'worker' is pinned to. All workers are
+  /// on node 0 if NUMA information is unavailable or threads are not pinned.
+  int32_t numaNode(int32_t worker) const {
+    return workers_[worker]->node;
+  }
+
+  int32_t numNumaNodes() const {
+    return workersByNode_.size();
+  }
+
+  Stats stats() const;
+
+  /// Returns the DriverExecutor whose worker runs the calling thread or
+  /// nullptr if the thread is not a DriverExecutor worker.
+  static DriverExecutor* FOLLY_NULLABLE current();
+
+  /// Returns the index of the worker running the calling thread in
+  /// current() or -1 if the thread is not a DriverExecutor worker.
+  static int32_t currentWorker();
+
+ private:
+  // Stride of priority 0. Priority p advances its pass by kStride >> p per
+  // function taken.
+  static constexpr uint64_t kStride = 1 << (kNumPriorities - 1);
+
+  struct Worker {
+    // Serializes access to the queues and passes.
+    std::mutex mutex;
+
+    // Queued functions by priority.
+    std::array<std::deque<folly::Func>, kNumPriorities> queues;
+
+    // Total number of functions in 'queues'.
+    int32_t numQueued{0};
+
+    // The worker takes the function of the non-empty priority with the
+    // lowest pass, the higher priority on ties.
+    std::array<uint64_t, kNumPriorities> passes{};
+
+    // Pass of the priority taken last. A priority that gets work after being
+    // idle starts from here and does not get credit for the idle time.
+    uint64_t pass{0};
+
+    int32_t node{0};
+    std::thread thread;
+
+    // True while the worker waits on 'wakeup'. Guarded by the executor's
+    // 'mutex_'.
+    bool idle{false};
+    std::condition_variable wakeup;
+  };
+
+  // Returns the NUMA node of 'cpu', 0 if unknown.
+  static int32_t numaNodeOfCpu(int32_t cpu);
+
+  void push(int32_t worker, folly::Func func, int32_t priority);
+
+  // Wakes up 'worker' if idle, otherwise an idle worker that may steal from
+  // it. Must be called under 'mutex_'.
+  void wakeUp(int32_t worker);
+
+  // Takes a function from the queue of 'worker' or steals one from another
+  // worker. Returns an empty function if none is found.
+  folly::Func take(int32_t worker);
+
+  // Takes the function at the front of the queue picked by stride scheduling
+  // if 'steal' is false, otherwise the last function of the highest priority
+  // queue of 'victim'.
+  folly::Func takeFrom(int32_t victim, bool steal);
+
+  // Returns true if 'worker' may find work to take.
+  bool hasWork(int32_t worker) const;
+
+  void run(int32_t worker);
+
+  const Options options_;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Worker indices for each NUMA node.
+  std::vector<std::vector<int32_t>> workersByNode_;
+
+  // Number of queued functions per NUMA node. Incremented under 'mutex_' so
+  // that an idle worker does not miss a wakeup.
+  std::unique_ptr<std::atomic<int64_t>[]> numQueued_;
+
+  std::mutex mutex_;
+  bool stop_{false};
+
+  std::atomic<uint32_t> nextWorker_{0};
+
+  std::atomic<uint64_t> numRun_{0};
+  std::atomic<uint64_t> numStolen_{0};
+  std::atomic<uint64_t> numCrossNodeStolen_{0};
+};
+
+} // namespace facebook::velox::exec
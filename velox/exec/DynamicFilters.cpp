@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/DynamicFilters.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+folly::dynamic serializeValues(const std::vector<int64_t>& values) {
+  folly::dynamic array = folly::dynamic::array;
+  for (auto value : values) {
+    array.push_back(value);
+  }
+  return array;
+}
+} // namespace
+
+folly::dynamic serializeDynamicFilter(const common::Filter& filter) {
+  folly::dynamic obj = folly::dynamic::object;
+  obj["nullAllowed"] = filter.testNull();
+  switch (filter.kind()) {
+    case common::FilterKind::kAlwaysFalse:
+      obj["kind"] = "alwaysFalse";
+      break;
+    case common::FilterKind::kBigintRange: {
+      auto& range = static_cast<const common::BigintRange&>(filter);
+      obj["kind"] = "bigintRange";
+      obj["lower"] = range.lower();
+      obj["upper"] = range.upper();
+      break;
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      obj["kind"] = "bigintValues";
+      obj["values"] = serializeValues(
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values());
+      break;
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      obj["kind"] = "bigintValues";
+      obj["values"] = serializeValues(
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values());
+      break;
+    case common::FilterKind::kBigintBloomFilter: {
+      auto& bloom = static_cast<const common::BigintBloomFilter&>(filter);
+      obj["kind"] = "bigintBloomFilter";
+      obj["min"] = bloom.min();
+      obj["max"] = bloom.max();
+      folly::dynamic bits = folly::dynamic::array;
+      for (auto word : bloom.bloomFilter()->bits()) {
+        bits.push_back(static_cast<int64_t>(word));
+      }
+      obj["bits"] = std::move(bits);
+      break;
+    }
+    default:
+      VELOX_UNSUPPORTED(
+          "Dynamic filter cannot be serialized: {}", filter.toString());
+  }
+  return obj;
+}
+
+std::shared_ptr<common::Filter> deserializeDynamicFilter(
+    const folly::dynamic& obj) {
+  const auto& kind = obj["kind"].asString();
+  const bool nullAllowed = obj["nullAllowed"].asBool();
+  if (kind == "alwaysFalse") {
+    return std::make_shared<common::AlwaysFalse>();
+  }
+  if (kind == "bigintRange") {
+    return std::make_shared<common::BigintRange>(
+        obj["lower"].asInt(), obj["upper"].asInt(), nullAllowed);
+  }
+  if (kind == "bigintValues") {
+    std::vector<int64_t> values;
+    values.reserve(obj["values"].size());
+    for (const auto& value : obj["values"]) {
+      values.push_back(value.asInt());
+    }
+    return common::createBigintValues(values, nullAllowed);
+  }
+  if (kind == "bigintBloomFilter") {
+    std::vector<uint64_t> bits;
+    bits.reserve(obj["bits"].size());
+    for (const auto& word : obj["bits"]) {
+      bits.push_back(static_cast<uint64_t>(word.asInt()));
+    }
+    return std::make_shared<common::BigintBloomFilter>(
+        obj["min"].asInt(),
+        obj["max"].asInt(),
+        std::make_shared<const BloomFilter<>>(std::move(bits)),
+        nullAllowed);
+  }
+  VELOX_USER_FAIL("Unknown kind of serialized dynamic filter: {}", kind);
+}
+
+} // namespace facebook::velox::exec
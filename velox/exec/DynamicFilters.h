@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/dynamic.h>
+
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::exec {
+
+// Serializes a dynamic filter made by a HashBuild, so that it can be
+// delivered to the TableScans of other Tasks, see
+// Task::joinDynamicFilters(). Supports the filters a join makes:
+// BigintRange, BigintValuesUsingHashTable, BigintValuesUsingBitmask and
+// BigintBloomFilter, besides AlwaysFalse.
+folly::dynamic serializeDynamicFilter(const common::Filter& filter);
+
+// Makes a filter that passes the same values as the one 'obj' was
+// serialized from.
+std::shared_ptr<common::Filter> deserializeDynamicFilter(
+    const folly::dynamic& obj);
+
+} // namespace facebook::velox::exec
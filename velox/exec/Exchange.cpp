@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/Exchange.h"
+#include "velox/common/time/Timer.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 
 namespace facebook::velox::exec {
@@ -30,8 +31,39 @@ SerializedPage::SerializedPage(std::unique_ptr<folly::IOBuf> iobuf)
   }
 }
 
+SerializedPage::SerializedPage(
+    std::vector<RowVectorPtr> vectors,
+    int64_t size,
+    std::shared_ptr<void> owner)
+    : iobufBytes_(size),
+      vectors_(std::move(vectors)),
+      vectorOwner_(std::move(owner)) {
+  VELOX_CHECK(!vectors_.empty());
+}
+
+RowVectorPtr SerializedPage::copyVectors(
+    const RowTypePtr& type,
+    memory::MemoryPool* pool) const {
+  vector_size_t numRows = 0;
+  for (auto& vector : vectors_) {
+    numRows += vector->size();
+  }
+  auto result = std::static_pointer_cast<RowVector>(
+      BaseVector::create(type, numRows, pool));
+  vector_size_t offset = 0;
+  for (auto& vector : vectors_) {
+    result->copy(vector.get(), offset, 0, vector->size());
+    offset += vector->size();
+  }
+  return result;
+}
+
 void SerializedPage::prepareStreamForDeserialize(ByteStream* input) {
+  VELOX_CHECK(iobuf_, "A page of vectors has no serialized form");
   input->resetInput(std::move(ranges_));
+  // Deserialized vectors may reference the page memory in place. The
+  // clone shares the memory of 'iobuf_' and keeps it alive after 'this'.
+  input->setInputOwner(std::shared_ptr<folly::IOBuf>(iobuf_->clone()));
 }
 
 std::shared_ptr<ExchangeSource> ExchangeSource::create(
@@ -71,21 +103,22 @@ class LocalExchangeSource : public ExchangeSource {
     return !pending;
   }
 
-  void request() override {
+  void request(uint64_t maxBytes) override {
     auto buffers = PartitionedOutputBufferManager::getInstance().lock();
     VELOX_CHECK_NOT_NULL(buffers, "invalid PartitionedOutputBufferManager");
     VELOX_CHECK(requestPending_);
     auto requestedSequence = sequence_;
     auto self = shared_from_this();
-    buffers->getData(
+    buffers->getPages(
         taskId_,
         destination_,
-        kMaxBytes,
+        maxBytes,
         sequence_,
         // Since this lambda may outlive 'this', we need to capture a
         // shared_ptr to the current object (self).
         [self, requestedSequence, buffers, this](
-            std::vector<std::unique_ptr<folly::IOBuf>> data, int64_t sequence) {
+            std::vector<std::shared_ptr<SerializedPage>> data,
+            int64_t sequence) {
           if (requestedSequence > sequence) {
             VLOG(2) << "Receives earlier sequence than requested: task "
                     << taskId_ << ", destination " << destination_
@@ -104,9 +137,18 @@ class LocalExchangeSource : public ExchangeSource {
               // Keep looping, there could be extra end markers.
               continue;
             }
-            inputPage->unshare();
-            pages.push_back(
-                std::make_unique<SerializedPage>(std::move(inputPage)));
+            if (inputPage->hasVectors()) {
+              // Vectors pass to the consumer without serialization.
+              pages.push_back(std::make_unique<SerializedPage>(
+                  inputPage->vectors(),
+                  inputPage->size(),
+                  inputPage->vectorOwner()));
+            } else {
+              auto iobuf = inputPage->getIOBuf();
+              iobuf->unshare();
+              pages.push_back(
+                  std::make_unique<SerializedPage>(std::move(iobuf)));
+            }
             inputPage = nullptr;
           }
           int64_t ackSequence;
@@ -132,9 +174,6 @@ class LocalExchangeSource : public ExchangeSource {
   }
 
   void close() override {}
-
- private:
-  static constexpr uint64_t kMaxBytes = 32 * 1024 * 1024; // 32 MB
 };
 
 std::unique_ptr<ExchangeSource> createLocalExchangeSource(
@@ -151,7 +190,7 @@ std::unique_ptr<ExchangeSource> createLocalExchangeSource(
 } // namespace
 
 void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
-  std::shared_ptr<ExchangeSource> toRequest;
+  std::vector<std::pair<std::shared_ptr<ExchangeSource>, uint64_t>> toRequest;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
     bool duplicate = !taskIds_.insert(taskId).second;
@@ -163,12 +202,12 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
     auto source = ExchangeSource::create(taskId, destination_, queue_);
     sources_.push_back(source);
     queue_->addSource();
-    if (source->shouldRequestLocked()) {
-      toRequest = source;
-    }
+    toRequest = pickSourcesLocked();
   }
   // Outside of lock
-  toRequest->request();
+  for (auto& [source, maxBytes] : toRequest) {
+    source->request(maxBytes);
+  }
 }
 
 void ExchangeClient::noMoreRemoteTasks() {
@@ -179,7 +218,7 @@ void ExchangeClient::noMoreRemoteTasks() {
 std::unique_ptr<SerializedPage> ExchangeClient::next(
     bool* atEnd,
     ContinueFuture* future) {
-  std::vector<std::shared_ptr<ExchangeSource>> toRequest;
+  std::vector<std::pair<std::shared_ptr<ExchangeSource>, uint64_t>> toRequest;
   std::unique_ptr<SerializedPage> page;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
@@ -188,25 +227,73 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
     if (*atEnd) {
       return page;
     }
-    if (page && queue_->totalBytes() > queue_->minBytes()) {
-      return page;
+    const int64_t minBytes = queue_->minBytes();
+    if (!page) {
+      // The consumer is faster than the sources. Larger requests keep
+      // more data in flight.
+      ++stats_.numStarved;
+      requestBytes_ = std::min(2 * requestBytes_, minBytes);
+    } else if (queue_->totalBytes() > minBytes / 2) {
+      requestBytes_ = std::max(requestBytes_ / 2, kMinRequestBytes);
     }
-    // There is space for more data, send requests to sources with no pending
-    // request.
-    for (auto& source : sources_) {
-      if (source->shouldRequestLocked()) {
-        toRequest.push_back(source);
-      }
+    if (page && queue_->totalBytes() > minBytes) {
+      return page;
     }
+    toRequest = pickSourcesLocked();
   }
 
   // Outside of lock
-  for (auto& source : toRequest) {
-    source->request();
+  for (auto& [source, maxBytes] : toRequest) {
+    source->request(maxBytes);
   }
   return page;
 }
 
+std::vector<std::pair<std::shared_ptr<ExchangeSource>, uint64_t>>
+ExchangeClient::pickSourcesLocked() {
+  for (auto& source : sources_) {
+    if (!source->requestPending_ && source->credit_ > 0) {
+      outstandingCredit_ -= source->credit_;
+      source->credit_ = 0;
+    }
+  }
+  std::vector<std::pair<std::shared_ptr<ExchangeSource>, uint64_t>> toRequest;
+  if (sources_.empty()) {
+    return toRequest;
+  }
+  int64_t available = static_cast<int64_t>(queue_->minBytes()) -
+      queue_->totalBytes() - outstandingCredit_;
+  const auto numSources = sources_.size();
+  for (size_t i = 0; i < numSources; ++i) {
+    auto& source = sources_[(nextSource_ + i) % numSources];
+    if (source->atEnd_) {
+      continue;
+    }
+    if (available <= 0) {
+      // The pending requests or the consumer free up budget later.
+      if (!source->requestPending_) {
+        ++stats_.numBackpressured;
+      }
+      break;
+    }
+    if (!source->shouldRequestLocked()) {
+      continue;
+    }
+    // A retried request replaces the credit of the pending one.
+    available += source->credit_;
+    outstandingCredit_ -= source->credit_;
+    auto credit = std::min<int64_t>(requestBytes_, available);
+    source->credit_ = credit;
+    outstandingCredit_ += credit;
+    available -= credit;
+    ++stats_.numRequests;
+    stats_.requestedBytes += credit;
+    toRequest.emplace_back(source, credit);
+  }
+  nextSource_ = (nextSource_ + 1) % numSources;
+  return toRequest;
+}
+
 ExchangeClient::~ExchangeClient() {
   for (auto& source : sources_) {
     source->close();
@@ -270,6 +357,18 @@ BlockingReason Exchange::isBlocked(ContinueFuture* future) {
   ContinueFuture dataFuture;
   currentPage_ = exchangeClient_->next(&atEnd_, &dataFuture);
   if (currentPage_ || atEnd_) {
+    if (currentPage_ && pageWaitStartMicros_ != 0) {
+      stats_.addRuntimeStat(
+          "pageWaitWallNanos",
+          RuntimeCounter(
+              (getCurrentTimeMicro() - pageWaitStartMicros_) * 1'000,
+              RuntimeCounter::Unit::kNanos,
+              /*histogram=*/true));
+    }
+    pageWaitStartMicros_ = 0;
+    if (atEnd_) {
+      recordExchangeClientStats();
+    }
     if (atEnd_ && noMoreSplits_) {
       operatorCtx_->task()->multipleSplitsFinished(stats_.numSplits);
     }
@@ -277,6 +376,9 @@ BlockingReason Exchange::isBlocked(ContinueFuture* future) {
   }
 
   // We have a dataFuture and we may also have a splitFuture_.
+  if (pageWaitStartMicros_ == 0) {
+    pageWaitStartMicros_ = getCurrentTimeMicro();
+  }
 
   if (splitFuture_.valid()) {
     // Block until data becomes available or more splits arrive.
@@ -293,15 +395,54 @@ BlockingReason Exchange::isBlocked(ContinueFuture* future) {
                                : BlockingReason::kWaitForExchange;
 }
 
+void Exchange::recordExchangeClientStats() {
+  if (operatorCtx_->driverCtx()->driverId != 0) {
+    return;
+  }
+  auto clientStats = exchangeClient_->stats();
+  stats_.addRuntimeStat(
+      "exchangeRequests", RuntimeCounter(clientStats.numRequests));
+  stats_.addRuntimeStat(
+      "exchangeRequestedBytes",
+      RuntimeCounter(clientStats.requestedBytes, RuntimeCounter::Unit::kBytes));
+  stats_.addRuntimeStat(
+      "exchangeBackpressured", RuntimeCounter(clientStats.numBackpressured));
+  stats_.addRuntimeStat(
+      "exchangeStarved", RuntimeCounter(clientStats.numStarved));
+}
+
 bool Exchange::isFinished() {
   return atEnd_;
 }
 
+VectorSerde::Options exchangeSerdeOptions(const core::QueryConfig& config) {
+  VectorSerde::Options options;
+  const auto codec = config.exchangeCompressionCodec();
+  if (codec == "lz4") {
+    options.compressionKind = folly::io::CodecType::LZ4;
+  } else if (codec == "zstd") {
+    options.compressionKind = folly::io::CodecType::ZSTD;
+  } else {
+    VELOX_USER_CHECK_EQ(
+        codec, "none", "Unknown exchange compression codec: {}", codec);
+  }
+  return options;
+}
+
 RowVectorPtr Exchange::getOutput() {
   if (!currentPage_) {
     return nullptr;
   }
 
+  if (currentPage_->hasVectors()) {
+    stats_.rawInputBytes += currentPage_->size();
+    result_ = currentPage_->copyVectors(outputType_, operatorCtx_->pool());
+    currentPage_ = nullptr;
+    stats_.inputPositions += result_->size();
+    stats_.inputBytes += result_->retainedSize();
+    return result_;
+  }
+
   if (!inputStream_) {
     inputStream_ = std::make_unique<ByteStream>();
     stats_.rawInputBytes += currentPage_->size();
@@ -309,7 +450,11 @@ RowVectorPtr Exchange::getOutput() {
   }
 
   VectorStreamGroup::read(
-      inputStream_.get(), operatorCtx_->pool(), outputType_, &result_);
+      inputStream_.get(),
+      operatorCtx_->pool(),
+      outputType_,
+      &result_,
+      &serdeOptions_);
 
   stats_.inputPositions += result_->size();
   stats_.inputBytes += result_->retainedSize();
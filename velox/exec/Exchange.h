@@ -21,6 +21,10 @@
 
 namespace facebook::velox::exec {
 
+// Returns the options for serializing and deserializing the pages
+// exchanged by a query with 'config'.
+VectorSerde::Options exchangeSerdeOptions(const core::QueryConfig& config);
+
 // Corresponds to Presto SerializedPage, i.e. a container for
 // serialize vectors in Presto wire format.
 class SerializedPage {
@@ -30,6 +34,15 @@ class SerializedPage {
   // Construct from IOBuf chain.
   explicit SerializedPage(std::unique_ptr<folly::IOBuf> iobuf);
 
+  // Constructs a page that holds 'vectors' instead of serialized data.
+  // Only consumers in the same process can take such a page. 'size' is
+  // the serialized size of 'vectors', by which the page is accounted.
+  // 'owner' keeps the memory of 'vectors' alive, e.g. the producer Task.
+  SerializedPage(
+      std::vector<RowVectorPtr> vectors,
+      int64_t size,
+      std::shared_ptr<void> owner);
+
   ~SerializedPage() = default;
 
   // Returns the size of the serialized data in bytes.
@@ -38,13 +51,33 @@ class SerializedPage {
   }
 
   // Makes 'input' ready for deserializing 'this' with
-  // VectorStreamGroup::read().
+  // VectorStreamGroup::read(). The deserialized vectors may reference
+  // the memory of 'this' and keep it alive after 'this' is destroyed.
   void prepareStreamForDeserialize(ByteStream* input);
 
   std::unique_ptr<folly::IOBuf> getIOBuf() const {
+    VELOX_CHECK(iobuf_, "A page of vectors has no serialized form");
     return iobuf_->clone();
   }
 
+  // True if 'this' holds vectors instead of serialized data.
+  bool hasVectors() const {
+    return !iobuf_;
+  }
+
+  const std::vector<RowVectorPtr>& vectors() const {
+    return vectors_;
+  }
+
+  const std::shared_ptr<void>& vectorOwner() const {
+    return vectorOwner_;
+  }
+
+  // Returns the rows of vectors() copied into one vector of 'type'
+  // allocated from 'pool'. The result does not reference 'this'.
+  RowVectorPtr copyVectors(const RowTypePtr& type, memory::MemoryPool* pool)
+      const;
+
  private:
   static int64_t chainBytes(folly::IOBuf& iobuf) {
     int64_t size = 0;
@@ -62,6 +95,10 @@ class SerializedPage {
 
   // Number of payload bytes in 'iobuf_'.
   const int64_t iobufBytes_;
+
+  // The contents of a page of vectors. 'iobuf_' is nullptr in this case.
+  std::vector<RowVectorPtr> vectors_;
+  std::shared_ptr<void> vectorOwner_;
 };
 
 // Queue of results retrieved from source. Owned by shared_ptr by
@@ -219,9 +256,10 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   virtual bool shouldRequestLocked() = 0;
 
   // Requests the producer to generate more data. Call only if shouldRequest()
-  // was true. The object handles its own lifetime by acquiring a
-  // shared_from_this() pointer if needed.
-  virtual void request() = 0;
+  // was true. The response should not be larger than 'maxBytes' unless the
+  // first page is larger. The object handles its own lifetime by acquiring
+  // a shared_from_this() pointer if needed.
+  virtual void request(uint64_t maxBytes) = 0;
 
   // Close the exchange source. May be called before all data
   // has been received and proessed. This can happen in case
@@ -253,6 +291,9 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   std::shared_ptr<ExchangeQueue> queue_;
   bool requestPending_ = false;
   bool atEnd_ = false;
+  // Bytes granted by the ExchangeClient to the pending request. Returned
+  // to the client once 'requestPending_' is false.
+  uint64_t credit_ = 0;
 };
 
 struct RemoteConnectorSplit : public connector::ConnectorSplit {
@@ -263,10 +304,29 @@ struct RemoteConnectorSplit : public connector::ConnectorSplit {
 };
 
 // Handle for a set of producers. This may be shared by multiple Exchanges, one
-// per consumer thread.
+// per consumer thread. The bytes in the queue plus the bytes requested from
+// the sources stay within the minSize of the queue. Each request gets a
+// credit of at most the current request size, which grows while the
+// consumer finds the queue empty and shrinks while the queue is more than
+// half full. Idle sources get credit in round robin order so that one fast
+// source cannot take the whole budget.
 class ExchangeClient {
  public:
   static constexpr int32_t kDefaultMinSize = 32 << 20; // 32 MB.
+  static constexpr int64_t kMinRequestBytes = 64 << 10; // 64 KB.
+  static constexpr int64_t kInitialRequestBytes = 1 << 20; // 1 MB.
+
+  struct Stats {
+    // Requests sent to sources.
+    int64_t numRequests{0};
+    // Sum of the credits of the requests.
+    int64_t requestedBytes{0};
+    // Times idle sources were not requested from because the queue and
+    // the pending requests used up the budget.
+    int64_t numBackpressured{0};
+    // Times a consumer found the queue empty.
+    int64_t numStarved{0};
+  };
 
   explicit ExchangeClient(int destination, int64_t minSize = kDefaultMinSize)
       : destination_(destination),
@@ -291,11 +351,29 @@ class ExchangeClient {
 
   std::string toString();
 
+  Stats stats() const {
+    std::lock_guard<std::mutex> l(queue_->mutex());
+    return stats_;
+  }
+
  private:
+  // Returns credits of completed requests and picks the sources to
+  // request from together with their credits. Call while holding
+  // queue_->mutex().
+  std::vector<std::pair<std::shared_ptr<ExchangeSource>, uint64_t>>
+  pickSourcesLocked();
+
   const int destination_;
   std::shared_ptr<ExchangeQueue> queue_;
   std::unordered_set<std::string> taskIds_;
   std::vector<std::shared_ptr<ExchangeSource>> sources_;
+  // Sum of the credits of pending requests.
+  uint64_t outstandingCredit_{0};
+  // Upper limit for the credit of a request.
+  int64_t requestBytes_{kInitialRequestBytes};
+  // Source to consider first in the next pickSourcesLocked().
+  size_t nextSource_{0};
+  Stats stats_;
 };
 
 class Exchange : public SourceOperator {
@@ -312,6 +390,7 @@ class Exchange : public SourceOperator {
             exchangeNode->id(),
             "Exchange"),
         planNodeId_(exchangeNode->id()),
+        serdeOptions_(exchangeSerdeOptions(ctx->queryConfig())),
         exchangeClient_(std::move(exchangeClient)) {}
 
   ~Exchange() override {
@@ -340,7 +419,12 @@ class Exchange : public SourceOperator {
   /// exchangeClient_.
   bool getSplits(ContinueFuture* future);
 
+  /// Adds the flow control stats of 'exchangeClient_' to the runtime stats.
+  /// Only the operator that feeds splits into the shared client does so.
+  void recordExchangeClientStats();
+
   const core::PlanNodeId planNodeId_;
+  const VectorSerde::Options serdeOptions_;
   bool noMoreSplits_ = false;
 
   /// A future received from Task::getSplitOrFuture(). It will be complete when
@@ -352,6 +436,9 @@ class Exchange : public SourceOperator {
   std::unique_ptr<SerializedPage> currentPage_;
   std::unique_ptr<ByteStream> inputStream_;
   bool atEnd_{false};
+  // Time at which isBlocked() started waiting for the next page, 0 if not
+  // waiting.
+  uint64_t pageWaitStartMicros_{0};
 };
 
 } // namespace facebook::velox::exec
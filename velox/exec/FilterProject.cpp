@@ -15,6 +15,7 @@
  */
 #include "velox/exec/FilterProject.h"
 #include "velox/core/Expressions.h"
+#include "velox/exec/Driver.h"
 #include "velox/expression/Expr.h"
 
 namespace facebook::velox::exec {
@@ -38,6 +39,28 @@ bool checkAddIdentityProjection(
 
   return false;
 }
+
+// Adds the number of references to each input column in 'expr' to 'counts'.
+// Lambda arguments with the name of a column count as references to it.
+void countColumnReferences(
+    const core::TypedExprPtr& expr,
+    std::unordered_map<std::string, int32_t>& counts) {
+  if (auto field =
+          dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+    const auto& inputs = field->inputs();
+    if (inputs.empty() ||
+        dynamic_cast<const core::InputTypedExpr*>(inputs[0].get())) {
+      ++counts[field->name()];
+      return;
+    }
+  }
+  if (auto lambda = dynamic_cast<const core::LambdaTypedExpr*>(expr.get())) {
+    countColumnReferences(lambda->body(), counts);
+  }
+  for (const auto& input : expr->inputs()) {
+    countColumnReferences(input, counts);
+  }
+}
 } // namespace
 
 FilterProject::FilterProject(
@@ -51,21 +74,60 @@ FilterProject::FilterProject(
           operatorId,
           project ? project->id() : filter->id(),
           "FilterProject"),
-      hasFilter_(filter != nullptr) {
+      hasFilter_(filter != nullptr),
+      compactionSelectivity_(
+          driverCtx->queryConfig().filterProjectCompactionSelectivity()) {
   std::vector<std::shared_ptr<const core::ITypedExpr>> allExprs;
   if (hasFilter_) {
     allExprs.push_back(filter->filter());
   }
   if (project) {
     auto inputType = project->sources()[0]->outputType();
+    std::unordered_map<std::string, int32_t> columnReferences;
+    if (hasFilter_) {
+      countColumnReferences(filter->filter(), columnReferences);
+    }
+    for (const auto& projection : project->projections()) {
+      countColumnReferences(projection, columnReferences);
+    }
+    // Projections that may be computed by a ValueHook go after the others,
+    // so that the others are evaluated together.
+    std::vector<std::pair<column_index_t, ProjectionHookFunction>> hooks;
     for (column_index_t i = 0; i < project->projections().size(); i++) {
       auto projection = project->projections()[i];
       bool identityProjection = checkAddIdentityProjection(
           projection, inputType, i, identityProjections_);
-      if (!identityProjection) {
-        allExprs.push_back(projection);
-        resultProjections_.emplace_back(allExprs.size() - 1, i);
+      if (identityProjection) {
+        continue;
+      }
+      // A LazyVector is loaded once, so the column may have no other use.
+      std::string columnName;
+      auto hook = makeProjectionHook(projection, &columnName);
+      if (hook && columnReferences[columnName] == 1) {
+        hooks.emplace_back(i, std::move(hook));
+        hookProjections_.push_back(
+            {inputType->getChildIdx(columnName), 0, nullptr});
+        continue;
       }
+      allExprs.push_back(projection);
+      resultProjections_.emplace_back(allExprs.size() - 1, i);
+    }
+    std::unordered_map<std::string, int32_t> projectionReferences;
+    for (const auto& projection : resultProjections_) {
+      countColumnReferences(
+          allExprs[projection.inputChannel], projectionReferences);
+    }
+    for (const auto& [name, count] : projectionReferences) {
+      // Lambda arguments that are not columns are also counted.
+      if (auto channel = inputType->getChildIdxIfExists(name)) {
+        compactedChannels_.push_back(channel.value());
+      }
+    }
+    for (auto i = 0; i < hooks.size(); ++i) {
+      allExprs.push_back(project->projections()[hooks[i].first]);
+      resultProjections_.emplace_back(allExprs.size() - 1, hooks[i].first);
+      hookProjections_[i].exprIndex = allExprs.size() - 1;
+      hookProjections_[i].function = std::move(hooks[i].second);
     }
   } else {
     for (column_index_t i = 0; i < outputType_->size(); ++i) {
@@ -74,7 +136,28 @@ FilterProject::FilterProject(
     isIdentityProjection_ = true;
   }
   numExprs_ = allExprs.size();
-  exprs_ = makeExprSetFromFlag(std::move(allExprs), operatorCtx_->execCtx());
+  const auto& task = operatorCtx_->task();
+  if (task->isGroupedExecution()) {
+    std::tie(exprCtx_, exprs_) = task->takeExprSet(planNodeId());
+    if (exprs_) {
+      stats_.addRuntimeStat("reusedExprSet", RuntimeCounter(1));
+      return;
+    }
+  }
+  exprCtx_ = std::make_unique<core::ExecCtx>(pool(), task->queryCtx().get());
+  exprs_ = makeExprSetFromFlag(std::move(allExprs), exprCtx_.get());
+}
+
+void FilterProject::close() {
+  Operator::close();
+  if (!exprs_) {
+    return;
+  }
+  exprs_->clear();
+  const auto& task = operatorCtx_->task();
+  if (task->isGroupedExecution()) {
+    task->releaseExprSet(planNodeId(), std::move(exprCtx_), std::move(exprs_));
+  }
 }
 
 void FilterProject::addInput(RowVectorPtr input) {
@@ -82,9 +165,16 @@ void FilterProject::addInput(RowVectorPtr input) {
   numProcessedInputRows_ = 0;
   if (!resultProjections_.empty()) {
     results_.resize(resultProjections_.back().inputChannel + 1);
+    auto* execCtx = operatorCtx_->execCtx();
     for (auto& result : results_) {
       if (result && result.unique() && result->isFlatEncoding()) {
         BaseVector::prepareForReuse(result, 0);
+      } else if (result && result->isFlatEncoding()) {
+        // The consumer still references 'result'. Continues with a vector the
+        // consumer is done with and keeps 'result' for a later batch.
+        auto type = result->type();
+        execCtx->releaseVector(std::move(result));
+        result = execCtx->getVector(type, 0);
       } else {
         result.reset();
       }
@@ -148,6 +238,9 @@ RowVectorPtr FilterProject::getOutput() {
 
   // evaluate projections (if present)
   if (!isIdentityProjection_) {
+    if (!allRowsSelected && shouldCompact(numOut, size)) {
+      return projectCompacted(numOut);
+    }
     if (!allRowsSelected) {
       rows->setFromBits(filterEvalCtx_.selectedBits->as<uint64_t>(), size);
     }
@@ -160,7 +253,129 @@ RowVectorPtr FilterProject::getOutput() {
 
 void FilterProject::project(const SelectivityVector& rows, EvalCtx* evalCtx) {
   exprs_->eval(
-      hasFilter_ ? 1 : 0, numExprs_, !hasFilter_, rows, evalCtx, &results_);
+      hasFilter_ ? 1 : 0,
+      numExprs_ - hookProjections_.size(),
+      !hasFilter_,
+      rows,
+      evalCtx,
+      &results_);
+  if (hookProjections_.empty()) {
+    return;
+  }
+  if (!pushdownChecked_) {
+    mayPushdown_ =
+        operatorCtx_->driverCtx()->queryConfig().projectionPushdown() &&
+        operatorCtx_->driver()->mayPushdownValueHook(this);
+    pushdownChecked_ = true;
+  }
+  for (const auto& hookProjection : hookProjections_) {
+    const auto& column = input_->childAt(hookProjection.inputChannel);
+    auto& result = results_[hookProjection.exprIndex];
+    if (!mayPushdown_ || !column->isLazy() ||
+        column->asUnchecked<LazyVector>()->isLoaded()) {
+      exprs_->eval(
+          hookProjection.exprIndex,
+          hookProjection.exprIndex + 1,
+          false,
+          rows,
+          evalCtx,
+          &results_);
+      continue;
+    }
+    BaseVector::ensureWritable(
+        rows, exprs_->expr(hookProjection.exprIndex)->type(), pool(), &result);
+    rowNumbers_.resize(rows.countSelected());
+    vector_size_t numRows = 0;
+    rows.applyToSelected([&](auto row) { rowNumbers_[numRows++] = row; });
+    hookProjection.function(
+        *column->asUnchecked<LazyVector>(),
+        RowSet(rowNumbers_.data(), numRows),
+        *result);
+  }
+}
+
+bool FilterProject::shouldCompact(vector_size_t numOut, vector_size_t size)
+    const {
+  if (compactionSelectivity_ <= 0 || resultProjections_.empty() ||
+      !hookProjections_.empty() || numOut > size * compactionSelectivity_) {
+    return false;
+  }
+  // A single run of passing rows is as dense as a copy of it.
+  const auto* indices = filterEvalCtx_.selectedIndices->as<vector_size_t>();
+  return indices[numOut - 1] - indices[0] + 1 != numOut;
+}
+
+RowVectorPtr FilterProject::projectCompacted(vector_size_t numOut) {
+  const auto size = input_->size();
+  auto* execCtx = operatorCtx_->execCtx();
+  LocalSelectivityVector localPassingRows(*execCtx, size);
+  auto* passingRows = localPassingRows.get();
+  passingRows->setFromBits(filterEvalCtx_.selectedBits->as<uint64_t>(), size);
+  LocalSelectivityVector localOutputRows(*execCtx, numOut);
+  auto* outputRows = localOutputRows.get();
+  outputRows->setAll();
+  const auto* indices = filterEvalCtx_.selectedIndices->as<vector_size_t>();
+
+  // The columns that the projections do not reference are null constants.
+  std::vector<VectorPtr> children(input_->childrenSize());
+  for (auto channel : compactedChannels_) {
+    children[channel] = compactColumn(
+        input_->childAt(channel), numOut, indices, *passingRows, *outputRows);
+  }
+  const auto& inputType = input_->type();
+  for (auto i = 0; i < children.size(); ++i) {
+    if (!children[i]) {
+      children[i] =
+          BaseVector::createNullConstant(inputType->childAt(i), numOut, pool());
+    }
+  }
+  auto compacted = std::make_shared<RowVector>(
+      pool(), inputType, BufferPtr(nullptr), numOut, std::move(children));
+
+  // The shared subexpressions of the filter are cleared since their values
+  // are for the rows of the input.
+  EvalCtx evalCtx(execCtx, exprs_.get(), compacted.get());
+  exprs_->eval(1, numExprs_, true, *outputRows, &evalCtx, &results_);
+  stats_.addRuntimeStat("compactedBatches", RuntimeCounter(1));
+
+  std::vector<VectorPtr> columns(outputType_->size());
+  for (const auto& projection : identityProjections_) {
+    columns[projection.outputChannel] = wrapChild(
+        numOut,
+        filterEvalCtx_.selectedIndices,
+        input_->childAt(projection.inputChannel));
+  }
+  for (const auto& projection : resultProjections_) {
+    columns[projection.outputChannel] = results_[projection.inputChannel];
+  }
+  return std::make_shared<RowVector>(
+      pool(), outputType_, BufferPtr(nullptr), numOut, std::move(columns));
+}
+
+VectorPtr FilterProject::compactColumn(
+    VectorPtr column,
+    vector_size_t numOut,
+    const vector_size_t* indices,
+    const SelectivityVector& passingRows,
+    const SelectivityVector& outputRows) {
+  if (isLazyNotLoaded(*column)) {
+    LazyVector::ensureLoadedRows(column, passingRows);
+  }
+  const auto* source = column->loadedVector();
+  auto result = BaseVector::create(column->type(), numOut, pool());
+  if (!source->isFlatEncoding()) {
+    result->copy(source, outputRows, indices);
+    return result;
+  }
+  for (vector_size_t i = 0; i < numOut;) {
+    auto end = i + 1;
+    while (end < numOut && indices[end] == indices[end - 1] + 1) {
+      ++end;
+    }
+    result->copy(source, i, indices[i], end - i);
+    i = end;
+  }
+  return result;
 }
 
 vector_size_t FilterProject::filter(
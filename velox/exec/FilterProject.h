@@ -18,6 +18,7 @@
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/ProjectionHook.h"
 #include "velox/expression/Expr.h"
 
 namespace facebook::velox::exec {
@@ -51,10 +52,7 @@ class FilterProject : public Operator {
 
   bool isFinished() override;
 
-  void close() override {
-    Operator::close();
-    exprs_->clear();
-  }
+  void close() override;
 
  private:
   // Tests if 'numProcessedRows_' equals to the length of input_ and clears
@@ -73,13 +71,60 @@ class FilterProject : public Operator {
   // pre-condition: !isIdentityProjection_
   void project(const SelectivityVector& rows, EvalCtx* evalCtx);
 
+  // True if the 'numOut' rows of 'size' that passed the filter are copied to
+  // dense vectors before evaluating the projections.
+  bool shouldCompact(vector_size_t numOut, vector_size_t size) const;
+
+  // Evaluates the projections over a copy of the 'numOut' rows that passed
+  // the filter and returns the output.
+  RowVectorPtr projectCompacted(vector_size_t numOut);
+
+  // Returns the 'numOut' rows at 'indices' of 'column' as a new vector of
+  // 'numOut' rows. Runs of consecutive rows of a flat column are copied at
+  // once. Only the rows in 'passingRows' of a lazy column are loaded.
+  VectorPtr compactColumn(
+      VectorPtr column,
+      vector_size_t numOut,
+      const vector_size_t* indices,
+      const SelectivityVector& passingRows,
+      const SelectivityVector& outputRows);
+
   // If true exprs_[0] is a filter and the other expressions are projections
   const bool hasFilter_{false};
+  // The context 'exprs_' is compiled with. 'exprs_' and 'exprCtx_' go to the
+  // FilterProject of the next split group in grouped execution.
+  std::unique_ptr<core::ExecCtx> exprCtx_;
   std::unique_ptr<ExprSet> exprs_;
   int32_t numExprs_;
 
   FilterEvalCtx filterEvalCtx_;
 
   vector_size_t numProcessedInputRows_{0};
+
+  // A projection computed by loading a lazy input column with a ValueHook.
+  // The expression at 'exprIndex' computes it if the column is not lazy.
+  struct HookProjection {
+    column_index_t inputChannel;
+    column_index_t exprIndex;
+    ProjectionHookFunction function;
+  };
+
+  // The last projections in 'exprs_'.
+  std::vector<HookProjection> hookProjections_;
+
+  // True if the lazy input columns may be loaded with a ValueHook. Checked on
+  // the first batch.
+  bool mayPushdown_{false};
+  bool pushdownChecked_{false};
+
+  // The selected rows as a RowSet for loading with a ValueHook.
+  std::vector<vector_size_t> rowNumbers_;
+
+  // See QueryConfig::kFilterProjectCompactionSelectivity.
+  const double compactionSelectivity_;
+
+  // The input columns referenced by the projections that are not identity
+  // projections. These are copied when compacting.
+  std::vector<column_index_t> compactedChannels_;
 };
 } // namespace facebook::velox::exec
@@ -20,6 +20,11 @@
 namespace facebook::velox::exec {
 
 namespace {
+// Range of the number of hash bits for spill partitions. Gives 4 to 16
+// spill partitions.
+constexpr int32_t kMinSpillPartitionBits = 2;
+constexpr int32_t kMaxSpillPartitionBits = 4;
+
 bool allAreSinglyReferenced(
     const std::vector<column_index_t>& argList,
     const std::unordered_map<column_index_t, int>& channelUseCount) {
@@ -35,19 +40,6 @@ bool areAllLazyNotLoaded(const std::vector<VectorPtr>& vectors) {
     return isLazyNotLoaded(*vector);
   });
 }
-
-std::optional<std::string> makeSpillPath(
-    bool isPartial,
-    const OperatorCtx& operatorCtx) {
-  if (isPartial) {
-    return std::nullopt;
-  }
-  auto path = operatorCtx.task()->queryCtx()->config().spillPath();
-  if (path.has_value()) {
-    return path.value() + "/" + operatorCtx.task()->taskId();
-  }
-  return std::nullopt;
-}
 } // namespace
 
 GroupingSet::GroupingSet(
@@ -78,10 +70,21 @@ GroupingSet::GroupingSet(
       rows_(mappedMemory_),
       isAdaptive_(
           operatorCtx->task()->queryCtx()->config().hashAdaptivityEnabled()),
+      columnarAccumulators_(
+          operatorCtx->task()
+              ->queryCtx()
+              ->config()
+              .aggregationColumnarAccumulators()),
       execCtx_(*operatorCtx->execCtx()),
-      spillPath_(makeSpillPath(isPartial, *operatorCtx)),
+      spillPath_(
+          isPartial ? std::nullopt : operatorCtx->makeSpillPath()),
       pool_(*operatorCtx->pool()),
       spillExecutor_(operatorCtx->task()->queryCtx()->spillExecutor()),
+      spillCompression_(spillCodecType(
+          operatorCtx->task()->queryCtx()->config().spillCompressionCodec())),
+      spillDirectories_(operatorCtx->spillDirectories()),
+      maxSpillMergeFanIn_(
+          operatorCtx->task()->queryCtx()->config().maxSpillMergeFanIn()),
       testSpillPct_(
           operatorCtx->task()->queryCtx()->config().testingSpillPct()) {
   for (auto& hasher : hashers_) {
@@ -216,6 +219,13 @@ void GroupingSet::addInputForActiveRows(
   }
   table_->groupProbe(*lookup_);
   masks_.addInput(input, activeRows_);
+  auto* rowContainer = table_->rows();
+  if (rowContainer->groupNumberOffset()) {
+    groupNumbers_.resize(lookup_->hits.size());
+    for (auto row : lookup_->rows) {
+      groupNumbers_[row] = rowContainer->groupNumber(lookup_->hits[row]);
+    }
+  }
   for (auto i = 0; i < aggregates_.size(); ++i) {
     const auto& rows = getSelectivityVector(i);
 
@@ -230,7 +240,10 @@ void GroupingSet::addInputForActiveRows(
     // this.
     const bool canPushdown = (&rows == &activeRows_) && mayPushdown &&
         mayPushdown_[i] && areAllLazyNotLoaded(tempVectors_);
-    if (isRawInput_) {
+    if (aggregates_[i]->isColumnar()) {
+      aggregates_[i]->addRawInputColumnar(
+          groupNumbers_.data(), rows, tempVectors_);
+    } else if (isRawInput_) {
       aggregates_[i]->addRawInput(
           lookup_->hits.data(), rows, tempVectors_, canPushdown);
     } else {
@@ -252,6 +265,13 @@ void GroupingSet::addRemainingInput() {
 }
 
 void GroupingSet::createHashTable() {
+  if (columnarAccumulators_ && isRawInput_ && !spillPath_.has_value()) {
+    for (auto& aggregate : aggregates_) {
+      if (aggregate->supportsColumnar()) {
+        aggregate->setColumnar();
+      }
+    }
+  }
   if (ignoreNullKeys_) {
     table_ = HashTable<true>::createForAggregation(
         std::move(hashers_), aggregates_, mappedMemory_);
@@ -400,6 +420,10 @@ bool GroupingSet::getOutput(
     return getOutputWithSpill(result);
   }
 
+  if (table_ && noMoreInput_ && !isPartial_ && !remainingInput_) {
+    releaseOutputMemory(iterator);
+  }
+
   // @lint-ignore CLANGTIDY
   char* groups[batchSize];
   int32_t numGroups =
@@ -413,13 +437,44 @@ bool GroupingSet::getOutput(
     }
     return false;
   }
-  extractGroups(folly::Range<char**>(groups, numGroups), result);
+  extractGroups(folly::Range<char**>(groups, numGroups), result, isPartial_);
+  return true;
+}
+
+void GroupingSet::releaseOutputMemory(const RowContainerIterator& iterator) {
+  if (iterator.allocationIndex == 0 && iterator.runIndex == 0 &&
+      iterator.rowOffset == 0) {
+    outputReleasedBytes_ += table_->freeTable();
+    return;
+  }
+  outputReleasedBytes_ += table_->rows()->releaseRowsBefore(iterator);
+}
+
+bool GroupingSet::getIntermediateOutput(
+    int32_t batchSize,
+    RowContainerIterator& iterator,
+    RowVectorPtr& result) {
+  VELOX_CHECK_NULL(
+      spiller_, "Intermediate output of a spilled grouping set is unsupported");
+  if (isGlobal_) {
+    return getGlobalAggregationOutput(batchSize, true, iterator, result);
+  }
+
+  // @lint-ignore CLANGTIDY
+  char* groups[batchSize];
+  int32_t numGroups =
+      table_ ? table_->rows()->listRows(&iterator, batchSize, groups) : 0;
+  if (!numGroups) {
+    return false;
+  }
+  extractGroups(folly::Range<char**>(groups, numGroups), result, true);
   return true;
 }
 
 void GroupingSet::extractGroups(
     folly::Range<char**> groups,
-    const RowVectorPtr& result) {
+    const RowVectorPtr& result,
+    bool isPartial) {
   result->resize(groups.size());
   RowContainer& rows = table_ ? *table_->rows() : *rowsWhileReadingSpill_;
   auto totalKeys = rows.keyTypes().size();
@@ -430,7 +485,7 @@ void GroupingSet::extractGroups(
   for (int32_t i = 0; i < aggregates_.size(); ++i) {
     aggregates_[i]->finalize(groups.data(), groups.size());
     auto& aggregateVector = result->childAt(i + totalKeys);
-    if (isPartial_) {
+    if (isPartial) {
       aggregates_[i]->extractAccumulators(
           groups.data(), groups.size(), &aggregateVector);
     } else {
@@ -446,6 +501,53 @@ void GroupingSet::resetPartial() {
   }
 }
 
+void GroupingSet::toIntermediate(
+    const RowVectorPtr& input,
+    RowVectorPtr& result) {
+  VELOX_CHECK(isPartial_ && isRawInput_ && !isGlobal_);
+  if (!table_) {
+    createHashTable();
+  }
+  VELOX_CHECK_EQ(table_->rows()->numRows(), 0);
+
+  auto numRows = input->size();
+  result->resize(numRows);
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    result->childAt(i) =
+        BaseVector::loadedVectorShared(input->childAt(keyChannels_[i]));
+  }
+  if (aggregates_.empty()) {
+    return;
+  }
+
+  auto* rowContainer = table_->rows();
+  intermediateGroups_.resize(numRows);
+  intermediateRowNumbers_.resize(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    intermediateGroups_[i] = rowContainer->newRow();
+    intermediateRowNumbers_[i] = i;
+  }
+  auto groups = intermediateGroups_.data();
+
+  activeRows_.resize(numRows);
+  activeRows_.setAll();
+  masks_.addInput(input, activeRows_);
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    auto& aggregate = aggregates_[i];
+    aggregate->initializeNewGroups(groups, intermediateRowNumbers_);
+    const auto& rows = getSelectivityVector(i);
+    if (rows.hasSelections()) {
+      populateTempVectors(i, input);
+      aggregate->addRawInput(groups, rows, tempVectors_, false);
+    }
+    aggregate->finalize(groups, numRows);
+    aggregate->extractAccumulators(
+        groups, numRows, &result->childAt(i + keyChannels_.size()));
+  }
+  tempVectors_.clear();
+  rowContainer->clear();
+}
+
 uint64_t GroupingSet::allocatedBytes() const {
   if (table_) {
     return table_->allocatedBytes();
@@ -454,6 +556,14 @@ uint64_t GroupingSet::allocatedBytes() const {
   return stringAllocator_.retainedSize() + rows_.allocatedBytes();
 }
 
+std::pair<uint64_t, uint64_t> GroupingSet::stringAllocatorFreeSpace() const {
+  if (!table_) {
+    return {stringAllocator_.freeBytes(), stringAllocator_.numFreeBlocks()};
+  }
+  const auto& allocator = table_->rows()->stringAllocator();
+  return {allocator.freeBytes(), allocator.numFreeBlocks()};
+}
+
 const HashLookup& GroupingSet::hashLookup() const {
   return *lookup_;
 }
@@ -518,6 +628,21 @@ void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
   if (tracker->maybeReserve(targetIncrement)) {
     return;
   }
+
+  // Accumulators that are repeatedly extended and freed fragment the
+  // variable length data. If much of it is free, moving the allocated blocks
+  // together may free enough memory to continue without spilling.
+  auto& allocator = rows->stringAllocator();
+  if (allocator.freeBytes() > allocator.retainedSize() / 4) {
+    auto freedBytes = rows->compactStringAllocator();
+    if (freedBytes > 0) {
+      ++numCompactions_;
+      compactedBytes_ += freedBytes;
+      if (tracker->maybeReserve(targetIncrement)) {
+        return;
+      }
+    }
+  }
   auto rowsToSpill =
       targetIncrement / (rows->fixedRowSize() + outOfLineBytesPerRow);
 
@@ -538,24 +663,47 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
     }
     assert(mappedMemory_->tracker()); // lint
     auto fileSize = mappedMemory_->tracker()->getCurrentUserBytes() / 4;
+    // Makes one partition about the size that must be spilled now, so that a
+    // spill typically writes out whole partitions.
+    const int64_t estimatedBytes = table_->allocatedBytes();
+    const auto numDistinct = table_->numDistinct();
+    const double keepFraction = numDistinct == 0
+        ? 0
+        : std::max<int64_t>(0, targetRows) / static_cast<double>(numDistinct);
+    const auto numBits = Spiller::numPartitionBits(
+        estimatedBytes,
+        estimatedBytes * keepFraction,
+        kMinSpillPartitionBits,
+        kMaxSpillPartitionBits);
     spiller_ = std::make_unique<Spiller>(
         *rows,
         [&](folly::Range<char**> rows) { table_->erase(rows); },
         ROW(std::move(names), std::move(types)),
-        // Spill up to 4 partitions based on bits 29 and 30 of the hash number.
-        // Any two bits would do.
-        HashBitRange(29, 31),
+        // Spill partitions are based on the bits from 29 up of the hash
+        // number. Any bits would do.
+        HashBitRange(29, 29 + numBits),
         rows->keyTypes().size(),
         spillPath_.value(),
         fileSize,
         Spiller::spillPool(),
-        spillExecutor_);
+        spillExecutor_,
+        {},
+        spillCompression_,
+        spillDirectories_);
   }
   spiller_->spill(targetRows, targetBytes, spillIterator_);
 }
 
+int64_t GroupingSet::reclaimableBytes() const {
+  if (isPartial_ || !spillPath_.has_value() || noMoreInput_ || !table_ ||
+      table_->numDistinct() == 0) {
+    return 0;
+  }
+  return table_->allocatedBytes();
+}
+
 bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
-  if (outputPartition_ == -1) {
+  if (!spillOutputStarted_) {
     mergeArgs_.resize(1);
     std::vector<TypePtr> keyTypes;
     for (auto& hasher : table_->hashers()) {
@@ -576,7 +724,7 @@ bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
     // needed for producing spill output.
     rowsWhileReadingSpill_ = table_->moveRows();
     table_.reset();
-    outputPartition_ = 0;
+    spillOutputStarted_ = true;
     nonSpilledRows_ = spiller_->finishSpill();
   }
 
@@ -597,22 +745,24 @@ bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
     extractGroups(
         folly::Range<char**>(
             nonSpilledRows_.value().data() + nonSpilledIndex_, numGroups),
-        result);
+        result,
+        isPartial_);
     nonSpilledIndex_ += numGroups;
     return true;
   }
-  while (outputPartition_ < spiller_->state().maxPartitions()) {
+  for (;;) {
     if (!merge_) {
-      merge_ = spiller_->startMerge(outputPartition_);
+      merge_ = spiller_->nextMerge(maxSpillMergeFanIn_);
+      if (!merge_) {
+        return false;
+      }
     }
     if (!mergeNext(result)) {
-      ++outputPartition_;
       merge_ = nullptr;
       continue;
     }
     return true;
   }
-  return false;
 }
 
 bool GroupingSet::mergeNext(const RowVectorPtr& result) {
@@ -653,7 +803,8 @@ void GroupingSet::extractSpillResult(const RowVectorPtr& result) {
   RowContainerIterator iter;
   mergeRows_->listRows(
       &iter, rows.size(), RowContainer::kUnlimited, rows.data());
-  extractGroups(folly::Range<char**>(rows.data(), rows.size()), result);
+  extractGroups(
+      folly::Range<char**>(rows.data(), rows.size()), result, isPartial_);
   mergeRows_->clear();
 }
 
@@ -59,10 +59,27 @@ class GroupingSet {
       RowContainerIterator& iterator,
       RowVectorPtr& result);
 
+  /// Extracts the accumulators of the groups in the intermediate type for
+  /// adding them to a GroupingSet on a subset of the grouping keys. Unlike
+  /// getOutput(), leaves the groups in place for a subsequent getOutput().
+  /// Returns false when all groups have been extracted. Not supported after
+  /// spilling.
+  bool getIntermediateOutput(
+      int32_t batchSize,
+      RowContainerIterator& iterator,
+      RowVectorPtr& result);
+
   uint64_t allocatedBytes() const;
 
   void resetPartial();
 
+  /// Converts 'input' to intermediate results without grouping. Each input
+  /// row makes a group of its own. 'result' gets the grouping keys followed by
+  /// the accumulators of the aggregates. Used by partial aggregation when
+  /// grouping does not reduce the number of rows. The hash table must be
+  /// empty. Its RowContainer holds the accumulators while converting.
+  void toIntermediate(const RowVectorPtr& input, RowVectorPtr& result);
+
   const HashLookup& hashLookup() const;
 
   /// Spills content until under 'targetRows' and under 'targetBytes'
@@ -74,12 +91,52 @@ class GroupingSet {
   /// of this will be in a paused state and off thread.
   void spill(int64_t targetRows, int64_t targetBytes);
 
+  /// Returns the bytes spill(0, 0) would free, 0 if spilling is not enabled
+  /// or all input has been received.
+  int64_t reclaimableBytes() const;
+
   /// Returns the total bytes and rows spilled so far.
   std::pair<int64_t, int64_t> spilledBytesAndRows() const {
     return spiller_ ? spiller_->spilledBytesAndRows()
                     : std::pair<int64_t, int64_t>(0, 0);
   }
 
+  /// Returns the bytes spilled to each spill partition.
+  std::vector<int64_t> spilledPartitionBytes() const {
+    return spiller_ ? spiller_->spilledPartitionBytes()
+                    : std::vector<int64_t>();
+  }
+
+  /// Returns the number of spill partitions that were repartitioned
+  /// because they had too many files to merge at once.
+  int32_t numSpillRepartitions() const {
+    return spiller_ ? spiller_->numRepartitions() : 0;
+  }
+
+  /// Returns the bytes written to and read from each spill directory.
+  std::unordered_map<std::string, SpillDirectoryStats> spillDirectoryStats()
+      const {
+    return spiller_ ? spiller_->spillDirectoryStats()
+                    : std::unordered_map<std::string, SpillDirectoryStats>();
+  }
+
+  /// Returns the number of times the variable length data of the groups was
+  /// compacted instead of spilling and the total bytes freed by this.
+  std::pair<int32_t, int64_t> numCompactionsAndBytes() const {
+    return {numCompactions_, compactedBytes_};
+  }
+
+  /// Returns the bytes of the hash table and of the groups freed while
+  /// producing the final output, before the groups were cleared.
+  int64_t outputReleasedBytes() const {
+    return outputReleasedBytes_;
+  }
+
+  /// Returns the bytes in free blocks and the number of free blocks of the
+  /// HashStringAllocator of the groups. Many free blocks for the same bytes
+  /// mean that the free space is fragmented.
+  std::pair<uint64_t, uint64_t> stringAllocatorFreeSpace() const;
+
   /// Return the number of rows kept in memory.
   int64_t numRows() const {
     return table_ ? table_->rows()->numRows() : 0;
@@ -115,9 +172,12 @@ class GroupingSet {
   void ensureInputFits(const RowVectorPtr& input);
 
   // Copies the grouping keys and aggregates for 'groups' into 'result' If
-  // partial output, extracts the intermediate type for aggregates, final result
+  // 'isPartial', extracts the intermediate type for aggregates, final result
   // otherwise.
-  void extractGroups(folly::Range<char**> groups, const RowVectorPtr& result);
+  void extractGroups(
+      folly::Range<char**> groups,
+      const RowVectorPtr& result,
+      bool isPartial);
 
   /// Produces output in if spilling has occurred. First produces data
   /// from non-spilled partitions, then merges spill runs and
@@ -125,6 +185,12 @@ class GroupingSet {
   /// end.
   bool getOutputWithSpill(const RowVectorPtr& result);
 
+  // Frees the memory that the final output no longer needs: the hash table
+  // when the output starts and then the allocations of the groups that
+  // 'iterator' has passed. The groups are read once and no more input
+  // follows.
+  void releaseOutputMemory(const RowContainerIterator& iterator);
+
   /// Reads rows from the current spilled partition until producing a batch of
   /// final results in 'result'. Returns false and leaves 'result' empty when
   /// the partition is fully read.
@@ -183,6 +249,11 @@ class GroupingSet {
 
   // Place for the arguments of the aggregate being updated.
   std::vector<VectorPtr> tempVectors_;
+
+  // One group per input row and the row numbers for initializing them. Used
+  // in toIntermediate().
+  std::vector<char*> intermediateGroups_;
+  std::vector<vector_size_t> intermediateRowNumbers_;
   std::unique_ptr<BaseHashTable> table_;
   std::unique_ptr<HashLookup> lookup_;
   SelectivityVector activeRows_;
@@ -193,6 +264,15 @@ class GroupingSet {
   AllocationPool rows_;
   const bool isAdaptive_;
 
+  // True if the aggregates that support it keep their accumulators in
+  // arrays indexed by group number, see Aggregate::setColumnar(). Applies to
+  // raw input without spilling.
+  const bool columnarAccumulators_;
+
+  // Group numbers of the rows of the input batch. Set if some aggregate is
+  // columnar.
+  raw_vector<uint32_t> groupNumbers_;
+
   core::ExecCtx& execCtx_;
 
   bool noMoreInput_{false};
@@ -215,6 +295,14 @@ class GroupingSet {
   const std::optional<std::string> spillPath_;
 
   std::unique_ptr<Spiller> spiller_;
+
+  // Number of compactions of the variable length data of the groups made to
+  // avoid spilling and the bytes freed by them.
+  int32_t numCompactions_{0};
+  int64_t compactedBytes_{0};
+
+  // Bytes freed by releaseOutputMemory().
+  int64_t outputReleasedBytes_{0};
   std::unique_ptr<TreeOfLosers<SpillStream>> merge_;
   RowContainerIterator spillIterator_;
 
@@ -224,8 +312,8 @@ class GroupingSet {
   // The row with the current merge state, allocated from 'mergeRow_'.
   char* FOLLY_NULLABLE mergeState_ = nullptr;
 
-  // The currently running spill partition in producing spilld output.
-  int32_t outputPartition_{-1};
+  // True after starting to produce spilled output.
+  bool spillOutputStarted_{false};
 
   // Intermediate vector for passing arguments to aggregate in merging spill.
   std::vector<VectorPtr> mergeArgs_;
@@ -250,6 +338,16 @@ class GroupingSet {
   // Executor for spilling. If nullptr spilling writes on the Driver's thread.
   folly::Executor* FOLLY_NULLABLE const spillExecutor_;
 
+  // Codec for the spill files.
+  const folly::io::CodecType spillCompression_;
+
+  // Directories the spill files are striped over.
+  const std::vector<SpillDirectory*> spillDirectories_;
+
+  // Maximum number of spill files merged at a time in producing spilled
+  // output.
+  const int32_t maxSpillMergeFanIn_;
+
   // The RowContainer of 'table_' is moved here before freeing
   // 'table_' when starting to read spill output.
   std::unique_ptr<RowContainer> rowsWhileReadingSpill_;
@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/GroupingSetsAggregation.h"
+#include <algorithm>
+#include <numeric>
+#include "velox/exec/Aggregate.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+bool isAggregationInput(
+    column_index_t channel,
+    const core::GroupIdNode& groupIdNode) {
+  return channel >= groupIdNode.numGroupingKeys() &&
+      channel < groupIdNode.outputType()->size() - 1;
+}
+} // namespace
+
+// static
+bool GroupingSetsAggregation::canFuse(
+    const core::GroupIdNode& groupIdNode,
+    const core::AggregationNode& aggregationNode) {
+  if (!isRawInput(aggregationNode.step()) ||
+      aggregationNode.aggregates().empty() ||
+      !aggregationNode.preGroupedKeys().empty() ||
+      aggregationNode.ignoreNullKeys()) {
+    return false;
+  }
+
+  const auto& type = groupIdNode.outputType();
+  const auto groupIdChannel = type->size() - 1;
+  const auto& keys = aggregationNode.groupingKeys();
+  if (keys.size() != groupIdNode.numGroupingKeys() + 1) {
+    return false;
+  }
+  std::vector<bool> isKey(type->size(), false);
+  for (const auto& key : keys) {
+    auto channel = exprToChannel(key.get(), type);
+    if (channel == kConstantChannel || isKey[channel] ||
+        (channel >= groupIdNode.numGroupingKeys() &&
+         channel != groupIdChannel)) {
+      return false;
+    }
+    isKey[channel] = true;
+  }
+
+  const auto& masks = aggregationNode.aggregateMasks();
+  for (auto i = 0; i < aggregationNode.aggregates().size(); ++i) {
+    if (aggregationNode.isDistinct(i)) {
+      return false;
+    }
+    for (const auto& arg : aggregationNode.aggregates()[i]->inputs()) {
+      auto channel = exprToChannel(arg.get(), type);
+      if (channel != kConstantChannel &&
+          !isAggregationInput(channel, groupIdNode)) {
+        return false;
+      }
+    }
+    if (i < masks.size() && masks[i] &&
+        !isAggregationInput(type->getChildIdx(masks[i]->name()), groupIdNode)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+GroupingSetsAggregation::GroupingSetsAggregation(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::GroupIdNode>& groupIdNode,
+    const std::shared_ptr<const core::AggregationNode>& aggregationNode)
+    : Operator(
+          driverCtx,
+          aggregationNode->outputType(),
+          operatorId,
+          aggregationNode->id(),
+          aggregationNode->step() == core::AggregationNode::Step::kPartial
+              ? "PartialAggregation"
+              : "Aggregation"),
+      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
+      maxPartialAggregationMemoryUsage_(
+          driverCtx->queryConfig().maxPartialAggregationMemoryUsage()),
+      isPartialOutput_(isPartialOutput(aggregationNode->step())),
+      numKeys_(aggregationNode->groupingKeys().size()) {
+  VELOX_CHECK(canFuse(*groupIdNode, *aggregationNode));
+  const auto& inputType = groupIdNode->sources()[0]->outputType();
+  const auto& groupIdType = groupIdNode->outputType();
+  const auto numGroupingKeys = groupIdNode->numGroupingKeys();
+
+  // Maps a GroupId output channel of an aggregation input to the input
+  // channel.
+  auto toInputChannel = [&](column_index_t channel) -> column_index_t {
+    if (channel == kConstantChannel) {
+      return channel;
+    }
+    return inputType->getChildIdx(
+        groupIdNode->aggregationInputs()[channel - numGroupingKeys]->name());
+  };
+
+  // The GroupId output channels of the grouping keys of the aggregation.
+  std::vector<column_index_t> keyChannels;
+  for (auto i = 0; i < numKeys_; ++i) {
+    keyChannels.push_back(
+        exprToChannel(aggregationNode->groupingKeys()[i].get(), groupIdType));
+    if (keyChannels.back() == groupIdType->size() - 1) {
+      groupIdKey_ = i;
+    }
+  }
+
+  std::unordered_map<std::string, column_index_t> outputChannels;
+  for (const auto& [output, input] : groupIdNode->outputGroupingKeyNames()) {
+    outputChannels[input->name()] = groupIdType->getChildIdx(output);
+  }
+
+  // The keys of each grouping set as positions in the aggregation's grouping
+  // keys, with the input channel for each.
+  const auto& groupingSets = groupIdNode->groupingSets();
+  std::vector<std::vector<std::pair<column_index_t, column_index_t>>> setKeys(
+      groupingSets.size());
+  for (auto i = 0; i < groupingSets.size(); ++i) {
+    std::vector<column_index_t> inputChannels(
+        numGroupingKeys, kConstantChannel);
+    for (const auto& key : groupingSets[i]) {
+      inputChannels[outputChannels.at(key->name())] =
+          inputType->getChildIdx(key->name());
+    }
+    for (auto key = 0; key < numKeys_; ++key) {
+      if (key != groupIdKey_ &&
+          inputChannels[keyChannels[key]] != kConstantChannel) {
+        setKeys[i].emplace_back(key, inputChannels[keyChannels[key]]);
+      }
+    }
+  }
+
+  // Sets with more keys come first so that a set comes after its supersets.
+  std::vector<int32_t> order(groupingSets.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](auto left, auto right) {
+    return setKeys[left].size() > setKeys[right].size();
+  });
+
+  const auto numAggregates = aggregationNode->aggregates().size();
+  const auto& masks = aggregationNode->aggregateMasks();
+  std::vector<TypePtr> intermediateTypes;
+  for (const auto& aggregate : aggregationNode->aggregates()) {
+    std::vector<TypePtr> argTypes;
+    for (const auto& arg : aggregate->inputs()) {
+      argTypes.push_back(arg->type());
+    }
+    intermediateTypes.push_back(
+        Aggregate::intermediateType(aggregate->name(), argTypes));
+  }
+
+  // The intermediate results of a spilled set cannot be extracted.
+  const bool mayRollUp =
+      isPartialOutput_ || !operatorCtx_->makeSpillPath().has_value();
+  int32_t numRolledUp = 0;
+  for (auto index : order) {
+    Set set;
+    set.groupId = index;
+    for (const auto& [key, _] : setKeys[index]) {
+      set.keys.push_back(key);
+    }
+
+    // Rolls up from the set with the fewest keys among the supersets.
+    std::optional<int32_t> parent;
+    for (auto i = 0; mayRollUp && i < sets_.size(); ++i) {
+      const auto& keys = sets_[i].keys;
+      if (keys.size() > set.keys.size() &&
+          std::includes(
+              keys.begin(), keys.end(), set.keys.begin(), set.keys.end()) &&
+          (!parent.has_value() ||
+           keys.size() < sets_[parent.value()].keys.size())) {
+        parent = i;
+      }
+    }
+    set.isRawInput = !parent.has_value();
+
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    for (const auto& [key, inputChannel] : setKeys[index]) {
+      auto channel = inputChannel;
+      if (parent.has_value()) {
+        const auto& parentKeys = sets_[parent.value()].keys;
+        channel = std::find(parentKeys.begin(), parentKeys.end(), key) -
+            parentKeys.begin();
+      }
+      names.push_back(outputType_->nameOf(key));
+      types.push_back(outputType_->childAt(key));
+      hashers.push_back(VectorHasher::create(types.back(), channel));
+    }
+    auto intermediateTypesOfSet = types;
+    intermediateTypesOfSet.insert(
+        intermediateTypesOfSet.end(),
+        intermediateTypes.begin(),
+        intermediateTypes.end());
+    auto intermediateNames = names;
+
+    std::vector<std::unique_ptr<Aggregate>> aggregates;
+    std::vector<std::optional<column_index_t>> maskChannels;
+    std::vector<std::vector<column_index_t>> channelLists;
+    std::vector<std::vector<VectorPtr>> constantLists;
+    for (auto i = 0; i < numAggregates; ++i) {
+      const auto& aggregate = aggregationNode->aggregates()[i];
+      const auto& resultType = outputType_->childAt(numKeys_ + i);
+      names.push_back(outputType_->nameOf(numKeys_ + i));
+      types.push_back(resultType);
+      intermediateNames.push_back(names.back());
+      if (parent.has_value()) {
+        aggregates.push_back(Aggregate::create(
+            aggregate->name(),
+            isPartialOutput_ ? core::AggregationNode::Step::kIntermediate
+                             : core::AggregationNode::Step::kFinal,
+            {intermediateTypes[i]},
+            resultType));
+        maskChannels.emplace_back(std::nullopt);
+        channelLists.push_back({static_cast<column_index_t>(
+            sets_[parent.value()].keys.size() + i)});
+        constantLists.push_back({nullptr});
+        continue;
+      }
+
+      std::vector<TypePtr> argTypes;
+      std::vector<column_index_t> channels;
+      std::vector<VectorPtr> constants;
+      for (const auto& arg : aggregate->inputs()) {
+        argTypes.push_back(arg->type());
+        channels.push_back(
+            toInputChannel(exprToChannel(arg.get(), groupIdType)));
+        if (channels.back() == kConstantChannel) {
+          auto constant =
+              dynamic_cast<const core::ConstantTypedExpr*>(arg.get());
+          constants.push_back(BaseVector::createConstant(
+              constant->value(), 1, operatorCtx_->pool()));
+        } else {
+          constants.push_back(nullptr);
+        }
+      }
+      if (i < masks.size() && masks[i]) {
+        maskChannels.emplace_back(
+            toInputChannel(groupIdType->getChildIdx(masks[i]->name())));
+      } else {
+        maskChannels.emplace_back(std::nullopt);
+      }
+      aggregates.push_back(Aggregate::create(
+          aggregate->name(), aggregationNode->step(), argTypes, resultType));
+      channelLists.push_back(std::move(channels));
+      constantLists.push_back(std::move(constants));
+    }
+
+    set.outputType = ROW(std::move(names), std::move(types));
+    set.intermediateType =
+        ROW(std::move(intermediateNames), std::move(intermediateTypesOfSet));
+    set.groupingSet = std::make_unique<GroupingSet>(
+        std::move(hashers),
+        std::vector<column_index_t>{},
+        std::move(aggregates),
+        std::move(maskChannels),
+        std::move(channelLists),
+        std::move(constantLists),
+        std::vector<TypePtr>(intermediateTypes),
+        false,
+        isPartialOutput_,
+        set.isRawInput,
+        operatorCtx_.get());
+    if (parent.has_value()) {
+      sets_[parent.value()].children.push_back(sets_.size());
+      ++numRolledUp;
+    }
+    sets_.push_back(std::move(set));
+  }
+  if (numRolledUp > 0) {
+    stats_.addRuntimeStat(
+        "rolledUpGroupingSets", RuntimeCounter(numRolledUp));
+  }
+}
+
+void GroupingSetsAggregation::addInput(RowVectorPtr input) {
+  // Load Lazy vectors. These are read by several grouping sets and are not
+  // pushed down into the aggregates.
+  for (auto& child : input->children()) {
+    child->loadedVector();
+  }
+  for (auto& set : sets_) {
+    if (set.isRawInput) {
+      set.groupingSet->addInput(input, false);
+    }
+  }
+  numInputRows_ += input->size();
+
+  if (isPartialOutput_) {
+    int64_t allocatedBytes = 0;
+    for (const auto& set : sets_) {
+      allocatedBytes += set.groupingSet->allocatedBytes();
+    }
+    partialFull_ = allocatedBytes > maxPartialAggregationMemoryUsage_;
+  }
+}
+
+void GroupingSetsAggregation::addToChildren(
+    const Set& set,
+    const RowVectorPtr& input) {
+  for (auto child : set.children) {
+    sets_[child].groupingSet->addInput(input, false);
+  }
+}
+
+void GroupingSetsAggregation::rollUp(Set& set) {
+  RowContainerIterator iterator;
+  for (;;) {
+    auto intermediate = std::static_pointer_cast<RowVector>(
+        BaseVector::create(set.intermediateType, outputBatchSize_, pool()));
+    if (!set.groupingSet->getIntermediateOutput(
+            outputBatchSize_, iterator, intermediate)) {
+      return;
+    }
+    addToChildren(set, intermediate);
+  }
+}
+
+RowVectorPtr GroupingSetsAggregation::makeOutput(
+    const Set& set,
+    const RowVectorPtr& result) {
+  const auto size = result->size();
+  std::vector<VectorPtr> columns(outputType_->size());
+  // The keys that are not in 'set' are null.
+  for (auto i = 0; i < numKeys_; ++i) {
+    if (i == groupIdKey_) {
+      columns[i] = BaseVector::createConstant(set.groupId, size, pool());
+    } else {
+      columns[i] = BaseVector::createNullConstant(
+          outputType_->childAt(i), size, pool());
+    }
+  }
+  for (auto i = 0; i < set.keys.size(); ++i) {
+    columns[set.keys[i]] = result->childAt(i);
+  }
+  for (auto i = numKeys_; i < outputType_->size(); ++i) {
+    columns[i] = result->childAt(set.keys.size() + i - numKeys_);
+  }
+  return std::make_shared<RowVector>(
+      pool(), outputType_, nullptr, size, std::move(columns));
+}
+
+RowVectorPtr GroupingSetsAggregation::getOutput() {
+  if (finished_ || (!noMoreInput_ && !partialFull_)) {
+    return nullptr;
+  }
+
+  while (outputSet_ < sets_.size()) {
+    auto& set = sets_[outputSet_];
+    // A global aggregation has a result row even without input rows, unlike
+    // an aggregation on the group id. Its accumulators are not reset after
+    // flushing partial results, so it is output only at the end.
+    if (set.keys.empty() && (!noMoreInput_ || numInputRows_ == 0)) {
+      ++outputSet_;
+      continue;
+    }
+    if (!outputSetStarted_) {
+      outputSetStarted_ = true;
+      if (noMoreInput_) {
+        set.groupingSet->noMoreInput();
+      }
+      // Partial output is intermediate results, which go to the children as
+      // they are output.
+      if (!isPartialOutput_ && !set.children.empty()) {
+        rollUp(set);
+      }
+    }
+
+    const int32_t batchSize = set.keys.empty() ? 1 : outputBatchSize_;
+    auto result = std::static_pointer_cast<RowVector>(
+        BaseVector::create(set.outputType, batchSize, pool()));
+    if (set.groupingSet->getOutput(batchSize, resultIterator_, result)) {
+      if (isPartialOutput_) {
+        addToChildren(set, result);
+      }
+      return makeOutput(set, result);
+    }
+    resultIterator_.reset();
+    outputSetStarted_ = false;
+    ++outputSet_;
+  }
+
+  outputSet_ = 0;
+  partialFull_ = false;
+  if (noMoreInput_) {
+    finished_ = true;
+  }
+  return nullptr;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/GroupingSet.h"
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+
+// Runs a GroupIdNode and the AggregationNode over it as one operator. GroupId
+// repeats each input batch once per grouping set and the aggregation then
+// hashes every copy on all the grouping keys and the group id. This operator
+// instead adds each input batch to one GroupingSet per grouping set, keyed on
+// the keys of the set only. A grouping set whose keys are a subset of the keys
+// of another grouping set is rolled up from the intermediate results of the
+// smallest such superset instead of from the input rows, unless the
+// aggregation may spill. The output is the same as that of the two operators.
+class GroupingSetsAggregation : public Operator {
+ public:
+  GroupingSetsAggregation(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::GroupIdNode>& groupIdNode,
+      const std::shared_ptr<const core::AggregationNode>& aggregationNode);
+
+  // Returns true if 'aggregationNode' over 'groupIdNode' can run as a
+  // GroupingSetsAggregation. The aggregation must group on all the grouping
+  // keys and the group id, must have raw input and no pre-grouped keys or
+  // distinct aggregates, and its aggregates must take only aggregation inputs
+  // of the GroupId or constants.
+  static bool canFuse(
+      const core::GroupIdNode& groupIdNode,
+      const core::AggregationNode& aggregationNode);
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  bool needsInput() const override {
+    return !noMoreInput_ && !partialFull_;
+  }
+
+  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+  void close() override {
+    Operator::close();
+    sets_.clear();
+  }
+
+ private:
+  struct Set {
+    std::unique_ptr<GroupingSet> groupingSet;
+
+    // Position of the grouping set in GroupIdNode::groupingSets(). This is
+    // the value of the group id column.
+    int64_t groupId;
+
+    // The grouping keys of the set as positions in the aggregation's grouping
+    // keys.
+    std::vector<column_index_t> keys;
+
+    // Type of the output of 'groupingSet': 'keys' followed by the aggregates.
+    RowTypePtr outputType;
+
+    // Type of the intermediate results of 'groupingSet' for rolling up
+    // 'children'.
+    RowTypePtr intermediateType;
+
+    // Positions in 'sets_' of the grouping sets rolled up from this one.
+    std::vector<int32_t> children;
+
+    // True if the set gets the input rows, false if it is rolled up.
+    bool isRawInput{true};
+  };
+
+  // Adds 'input' to the children of 'set'. 'input' has the keys of 'set'
+  // followed by the intermediate results of the aggregates.
+  void addToChildren(const Set& set, const RowVectorPtr& input);
+
+  // Adds the intermediate results of 'set' to its children.
+  void rollUp(Set& set);
+
+  // Returns the output of the aggregation for 'result', a batch of output of
+  // 'set'.
+  RowVectorPtr makeOutput(const Set& set, const RowVectorPtr& result);
+
+  // Maximum number of rows in the output batch.
+  const uint32_t outputBatchSize_;
+
+  const int64_t maxPartialAggregationMemoryUsage_;
+
+  const bool isPartialOutput_;
+
+  // Number of grouping keys of the aggregation, including the group id.
+  column_index_t numKeys_;
+
+  // Position of the group id in the grouping keys of the aggregation.
+  column_index_t groupIdKey_;
+
+  // The grouping sets, ordered so that a set comes after the set it is
+  // rolled up from.
+  std::vector<Set> sets_;
+
+  // Number of input rows since the start.
+  int64_t numInputRows_{0};
+
+  // True if partial aggregation has reached its memory limit and flushes its
+  // groups.
+  bool partialFull_{false};
+
+  bool finished_{false};
+
+  // Position in 'sets_' of the grouping set being output.
+  int32_t outputSet_{0};
+
+  // True if the set at 'outputSet_' has been started, i.e. rolled up and
+  // told there is no more input if applicable.
+  bool outputSetStarted_{false};
+
+  RowContainerIterator resultIterator_;
+};
+
+} // namespace facebook::velox::exec
@@ -16,6 +16,7 @@
 #include "velox/exec/HashAggregation.h"
 #include <optional>
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/DistinctAggregate.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -37,7 +38,15 @@ HashAggregation::HashAggregation(
           driverCtx->queryConfig().maxPartialAggregationMemoryUsage()),
       isPartialOutput_(isPartialOutput(aggregationNode->step())),
       isDistinct_(aggregationNode->aggregates().empty()),
-      isGlobal_(aggregationNode->groupingKeys().empty()) {
+      isGlobal_(aggregationNode->groupingKeys().empty()),
+      mayAbandonPartialAggregation_(
+          aggregationNode->step() == core::AggregationNode::Step::kPartial &&
+          !isGlobal_ && aggregationNode->preGroupedKeys().empty() &&
+          !aggregationNode->ignoreNullKeys()),
+      abandonPartialAggregationMinRows_(
+          driverCtx->queryConfig().abandonPartialAggregationMinRows()),
+      abandonPartialAggregationMinPct_(
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()) {
   auto inputType = aggregationNode->sources()[0]->outputType();
 
   auto numHashers = aggregationNode->groupingKeys().size();
@@ -85,7 +94,11 @@ HashAggregation::HashAggregation(
         constants.push_back(nullptr);
       }
     }
-    if (isRawInput(aggregationNode->step())) {
+    const bool isDistinct = aggregationNode->isDistinct(i);
+    if (isDistinct) {
+      intermediateTypes.push_back(
+          distinctAggregateIntermediateType(argTypes[0]));
+    } else if (isRawInput(aggregationNode->step())) {
       intermediateTypes.push_back(
           Aggregate::intermediateType(aggregate->name(), argTypes));
     } else {
@@ -113,6 +126,10 @@ HashAggregation::HashAggregation(
     const auto& resultType = outputType_->childAt(numHashers + i);
     aggregates.push_back(Aggregate::create(
         aggregate->name(), aggregationNode->step(), argTypes, resultType));
+    if (isDistinct) {
+      aggregates.back() =
+          createDistinctAggregate(std::move(aggregates.back()), argTypes[0]);
+    }
     args.push_back(channels);
     constantLists.push_back(constants);
   }
@@ -150,14 +167,25 @@ HashAggregation::HashAggregation(
 }
 
 void HashAggregation::addInput(RowVectorPtr input) {
+  if (abandonedPartialAggregation_) {
+    // Converted to intermediate results in getOutput().
+    input_ = std::move(input);
+    return;
+  }
   if (!pushdownChecked_) {
-    mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
+    mayPushdown_ = operatorCtx_->driver()->mayPushdownValueHook(this);
     pushdownChecked_ = true;
   }
   groupingSet_->addInput(input, mayPushdown_);
+  // The groups of 'input' are in 'groupingSet_', so that the ratio of groups
+  // to input rows covers the same rows on both sides.
+  numInputRows_ += input->size();
+  abandonPartialAggregationIfNeeded();
+
   auto spilled = groupingSet_->spilledBytesAndRows();
   stats_.spilledBytes = spilled.first;
   stats_.spilledRows = spilled.second;
+  stats_.spillDirectoryStats = groupingSet_->spillDirectoryStats();
 
   if (isPartialOutput_ &&
       groupingSet_->allocatedBytes() > maxPartialAggregationMemoryUsage_) {
@@ -191,7 +219,78 @@ void HashAggregation::flushPartialOutputIfNeed() {
         "flushRowCount", RuntimeCounter(groupingSet_->numRows()));
     groupingSet_->resetPartial();
     partialFull_ = false;
+    numInputRows_ = 0;
+  }
+}
+
+void HashAggregation::abandonPartialAggregationIfNeeded() {
+  if (!mayAbandonPartialAggregation_ || abandonedPartialAggregation_ ||
+      numInputRows_ < abandonPartialAggregationMinRows_) {
+    return;
+  }
+  if (groupingSet_->numRows() * 100 <
+      numInputRows_ * abandonPartialAggregationMinPct_) {
+    return;
   }
+  // The keys are nearly unique. Flush the groups and pass the rest of the
+  // input through.
+  stats().addRuntimeStat("abandonedPartialAggregation", RuntimeCounter(1));
+  abandonedPartialAggregation_ = true;
+  partialFull_ = true;
+}
+
+void HashAggregation::addStringAllocatorStats() {
+  auto [freeBytes, numFreeBlocks] = groupingSet_->stringAllocatorFreeSpace();
+  if (numFreeBlocks > 0) {
+    stats_.addRuntimeStat(
+        "stringAllocatorFreeBytes",
+        RuntimeCounter(freeBytes, RuntimeCounter::Unit::kBytes));
+    stats_.addRuntimeStat(
+        "stringAllocatorNumFreeBlocks", RuntimeCounter(numFreeBlocks));
+  }
+  auto [numCompactions, compactedBytes] =
+      groupingSet_->numCompactionsAndBytes();
+  if (numCompactions > 0) {
+    stats_.addRuntimeStat(
+        "stringAllocatorCompactions", RuntimeCounter(numCompactions));
+    stats_.addRuntimeStat(
+        "stringAllocatorCompactedBytes",
+        RuntimeCounter(compactedBytes, RuntimeCounter::Unit::kBytes));
+  }
+}
+
+void HashAggregation::addSpillStats() {
+  stats_.spillDirectoryStats = groupingSet_->spillDirectoryStats();
+  for (auto bytes : groupingSet_->spilledPartitionBytes()) {
+    if (bytes > 0) {
+      stats_.addRuntimeStat(
+          "spilledPartitionBytes",
+          RuntimeCounter(bytes, RuntimeCounter::Unit::kBytes));
+    }
+  }
+  if (auto numRepartitions = groupingSet_->numSpillRepartitions()) {
+    stats_.addRuntimeStat("spillRepartitions", RuntimeCounter(numRepartitions));
+  }
+}
+
+RowVectorPtr HashAggregation::getPassThroughOutput() {
+  if (!input_) {
+    if (noMoreInput_) {
+      finished_ = true;
+    }
+    return nullptr;
+  }
+
+  RowVectorPtr output;
+  if (isDistinct_) {
+    output = fillOutput(input_->size(), nullptr);
+  } else {
+    prepareOutput(input_->size());
+    groupingSet_->toIntermediate(input_, output_);
+    output = output_;
+  }
+  input_ = nullptr;
+  return output;
 }
 
 RowVectorPtr HashAggregation::getOutput() {
@@ -200,6 +299,12 @@ RowVectorPtr HashAggregation::getOutput() {
     return nullptr;
   }
 
+  // The groups accumulated before abandoning partial aggregation are flushed
+  // while 'partialFull_' is set.
+  if (abandonedPartialAggregation_ && !partialFull_) {
+    return getPassThroughOutput();
+  }
+
   // Produce results if one of the following is true:
   // - received no-more-input message;
   // - partial aggregation reached memory limit;
@@ -213,6 +318,7 @@ RowVectorPtr HashAggregation::getOutput() {
 
   if (isDistinct_) {
     if (!newDistincts_) {
+      flushPartialOutputIfNeed();
       if (noMoreInput_) {
         finished_ = true;
       }
@@ -248,6 +354,12 @@ RowVectorPtr HashAggregation::getOutput() {
 
     if (noMoreInput_) {
       finished_ = true;
+      addSpillStats();
+      if (auto releasedBytes = groupingSet_->outputReleasedBytes()) {
+        stats_.addRuntimeStat(
+            "outputReleasedBytes",
+            RuntimeCounter(releasedBytes, RuntimeCounter::Unit::kBytes));
+      }
     }
     return nullptr;
   }
@@ -257,4 +369,16 @@ RowVectorPtr HashAggregation::getOutput() {
 bool HashAggregation::isFinished() {
   return finished_;
 }
+
+void HashAggregation::reclaim() {
+  if (reclaimableBytes() == 0) {
+    return;
+  }
+  groupingSet_->spill(0, 0);
+  releaseReservation();
+  auto spilled = groupingSet_->spilledBytesAndRows();
+  stats_.spilledBytes = spilled.first;
+  stats_.spilledRows = spilled.second;
+  stats_.spillDirectoryStats = groupingSet_->spillDirectoryStats();
+}
 } // namespace facebook::velox::exec
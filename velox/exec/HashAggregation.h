@@ -32,10 +32,12 @@ class HashAggregation : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !partialFull_;
+    return !noMoreInput_ && !partialFull_ &&
+        !(abandonedPartialAggregation_ && input_);
   }
 
   void noMoreInput() override {
+    addStringAllocatorStats();
     groupingSet_->noMoreInput();
     Operator::noMoreInput();
   }
@@ -46,6 +48,12 @@ class HashAggregation : public Operator {
 
   bool isFinished() override;
 
+  int64_t reclaimableBytes() const override {
+    return groupingSet_ ? groupingSet_->reclaimableBytes() : 0;
+  }
+
+  void reclaim() override;
+
   void close() override {
     Operator::close();
     groupingSet_.reset();
@@ -55,6 +63,23 @@ class HashAggregation : public Operator {
   void prepareOutput(vector_size_t size);
   void flushPartialOutputIfNeed();
 
+  // Switches partial aggregation to passing its input through when the
+  // number of groups is close to the number of input rows. The groups
+  // accumulated so far are flushed first.
+  void abandonPartialAggregationIfNeeded();
+
+  // Returns 'input_' converted to intermediate results without grouping.
+  RowVectorPtr getPassThroughOutput();
+
+  // Records the free space of the variable length data of the groups and
+  // its compactions in the runtime stats.
+  void addStringAllocatorStats();
+
+  // Records the spill IO per directory, the bytes of each spill partition
+  // and the number of repartitioned spill partitions. The spread of
+  // 'spilledPartitionBytes' shows the skew between partitions.
+  void addSpillStats();
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
@@ -64,6 +89,12 @@ class HashAggregation : public Operator {
   const bool isDistinct_;
   const bool isGlobal_;
 
+  // True if this is a partial aggregation that may pass its input through.
+  // See abandonPartialAggregationIfNeeded().
+  const bool mayAbandonPartialAggregation_;
+  const int32_t abandonPartialAggregationMinRows_;
+  const int32_t abandonPartialAggregationMinPct_;
+
   std::unique_ptr<GroupingSet> groupingSet_;
 
   bool partialFull_ = false;
@@ -73,6 +104,12 @@ class HashAggregation : public Operator {
   bool pushdownChecked_ = false;
   bool mayPushdown_ = false;
 
+  // Number of input rows added to 'groupingSet_' since the last flush.
+  int64_t numInputRows_ = 0;
+
+  // True if partial aggregation has switched to passing its input through.
+  bool abandonedPartialAggregation_ = false;
+
   /// Possibly reusable output vector.
   RowVectorPtr output_;
 };
@@ -15,20 +15,46 @@
  */
 
 #include "velox/exec/HashBuild.h"
+
+#include <folly/String.h>
+
+#include "velox/exec/HashTableCache.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/SharedHashTables.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
 
-void HashJoinBridge::setHashTable(std::unique_ptr<BaseHashTable> table) {
+void HashJoinBridge::setHashTable(
+    std::unique_ptr<BaseHashTable> table,
+    std::vector<HashJoinSpillPartition> spillPartitions,
+    std::vector<std::shared_ptr<common::Filter>> keyBloomFilters) {
   VELOX_CHECK(table, "setHashTable called with null table");
+  setTable(
+      std::move(table), std::move(spillPartitions), std::move(keyBloomFilters));
+}
+
+void HashJoinBridge::setSharedHashTable(
+    std::shared_ptr<BaseHashTable> table,
+    std::vector<std::shared_ptr<common::Filter>> keyBloomFilters) {
+  VELOX_CHECK(table, "setSharedHashTable called with null table");
+  setTable(std::move(table), {}, std::move(keyBloomFilters));
+}
 
+void HashJoinBridge::setTable(
+    std::shared_ptr<BaseHashTable> table,
+    std::vector<HashJoinSpillPartition> spillPartitions,
+    std::vector<std::shared_ptr<common::Filter>> keyBloomFilters) {
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!table_, "setHashTable may be called only once");
-    // Ownership becomes shared.
-    table_.reset(table.release());
+    table_ = std::move(table);
+    spillPartitions_ = std::move(spillPartitions);
+    for (const auto& partition : spillPartitions_) {
+      spilledPartitionNumbers_.push_back(partition.partition);
+    }
+    keyBloomFilters_ = std::move(keyBloomFilters);
     promises = std::move(promises_);
   }
   notify(std::move(promises));
@@ -54,20 +80,369 @@ std::optional<HashJoinBridge::HashBuildResult> HashJoinBridge::tableOrFuture(
   VELOX_CHECK(
       !cancelled_, "Getting hash table after the build side is aborted");
   if (table_ || antiJoinHasNullKeys_) {
-    return HashBuildResult{table_, antiJoinHasNullKeys_};
+    return HashBuildResult{
+        table_,
+        antiJoinHasNullKeys_,
+        spilledPartitionNumbers_,
+        keyBloomFilters_,
+        swapped_};
   }
   promises_.emplace_back("HashJoinBridge::tableOrFuture");
   *future = promises_.back().getSemiFuture();
   return std::nullopt;
 }
 
+std::optional<HashJoinBridge::HashBuildResult> HashJoinBridge::tableIfSet() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cancelled_ || (!table_ && !antiJoinHasNullKeys_)) {
+    return std::nullopt;
+  }
+  return HashBuildResult{
+      table_,
+      antiJoinHasNullKeys_,
+      spilledPartitionNumbers_,
+      keyBloomFilters_,
+      swapped_};
+}
+
+bool HashJoinBridge::startBuild(
+    const std::function<CachedBuild()>& lookup,
+    std::optional<std::string>& cacheKey) {
+  std::vector<ContinuePromise> promises;
+  bool buildsTable;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!buildsTable_.has_value()) {
+      auto build = lookup();
+      buildsTable_ = !build.table.has_value();
+      if (build.table.has_value()) {
+        VELOX_CHECK(!table_, "Table set before startBuild");
+        table_ = std::move(build.table->table);
+        antiJoinHasNullKeys_ = build.table->antiJoinHasNullKeys;
+        keyBloomFilters_ = std::move(build.table->keyBloomFilters);
+        promises = std::move(promises_);
+      } else {
+        cacheKey_ = std::move(build.cacheKey);
+      }
+    }
+    buildsTable = buildsTable_.value();
+    cacheKey = cacheKey_;
+  }
+  notify(std::move(promises));
+  return buildsTable;
+}
+
+void HashJoinBridge::addProbeSpillFiles(
+    int32_t partition,
+    std::vector<std::unique_ptr<SpillFile>> files) {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& spillPartition : spillPartitions_) {
+    if (spillPartition.partition == partition) {
+      for (auto& file : files) {
+        spillPartition.probeFiles.push_back(std::move(file));
+      }
+      return;
+    }
+  }
+  VELOX_FAIL("Adding probe side spill files to a partition that did not spill");
+}
+
+std::optional<HashJoinSpillPartition> HashJoinBridge::nextSpillPartition() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (nextSpillPartition_ >= spillPartitions_.size()) {
+    return std::nullopt;
+  }
+  return std::move(spillPartitions_[nextSpillPartition_++]);
+}
+
+void HashJoinBridge::addProbeInput(
+    std::vector<RowVectorPtr> input,
+    bool complete,
+    int32_t numProbes) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    numProbes_ = numProbes;
+    ++numReportedProbes_;
+    VELOX_CHECK_LE(numReportedProbes_, numProbes_);
+    if (!complete) {
+      probeInputComplete_ = false;
+      probeInput_.clear();
+    } else if (probeInputComplete_) {
+      for (auto& vector : input) {
+        numProbeRows_ += vector->size();
+        probeInput_.push_back(std::move(vector));
+      }
+    }
+    if (decideSwapLocked()) {
+      // Wakes up the last HashBuild. The HashProbes waiting for the table
+      // wake up too and wait again.
+      promises = std::move(promises_);
+    }
+  }
+  notify(std::move(promises));
+}
+
+std::optional<bool> HashJoinBridge::swapOrFuture(
+    uint64_t numBuildRows,
+    double ratio,
+    ContinueFuture* future) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!cancelled_, "Swapping join sides after the join is aborted");
+  numBuildRows_ = numBuildRows;
+  swapRatio_ = ratio;
+  decideSwapLocked();
+  if (swap_.has_value()) {
+    return swap_;
+  }
+  promises_.emplace_back("HashJoinBridge::swapOrFuture");
+  *future = promises_.back().getSemiFuture();
+  return std::nullopt;
+}
+
+bool HashJoinBridge::decideSwapLocked() {
+  if (swap_.has_value() || !numBuildRows_.has_value()) {
+    return false;
+  }
+  if (!probeInputComplete_) {
+    swap_ = false;
+    return true;
+  }
+  if (numProbes_ == 0 || numReportedProbes_ < numProbes_) {
+    return false;
+  }
+  swap_ = numBuildRows_.value() > swapRatio_ * numProbeRows_;
+  if (!swap_.value()) {
+    probeInput_.clear();
+  }
+  return true;
+}
+
+std::vector<RowVectorPtr> HashJoinBridge::takeProbeInput() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return std::move(probeInput_);
+}
+
+void HashJoinBridge::setSwappedTable(
+    std::unique_ptr<BaseHashTable> table,
+    std::vector<std::shared_ptr<BaseHashTable>> buildTables) {
+  VELOX_CHECK(table, "setSwappedTable called with null table");
+
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(!table_, "setSwappedTable may be called only once");
+    table_.reset(table.release());
+    swapped_ = true;
+    swappedBuildTables_ = std::move(buildTables);
+    promises = std::move(promises_);
+  }
+  notify(std::move(promises));
+}
+
+std::shared_ptr<BaseHashTable> HashJoinBridge::nextSwappedBuildTable() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (nextSwappedBuildTable_ >= swappedBuildTables_.size()) {
+    return nullptr;
+  }
+  return std::move(swappedBuildTables_[nextSwappedBuildTable_++]);
+}
+
+std::unique_ptr<BaseHashTable> createJoinTable(
+    const core::HashJoinNode& joinNode,
+    std::vector<std::unique_ptr<VectorHasher>> keyHashers,
+    const std::vector<TypePtr>& dependentTypes,
+    memory::MappedMemory* mappedMemory,
+    const core::QueryConfig& config) {
+  const auto layout = config.hashJoinInterleavedBuckets()
+      ? BaseHashTable::Layout::kInterleaved
+      : BaseHashTable::Layout::kSeparate;
+  if (joinNode.isRightJoin() || joinNode.isFullJoin()) {
+    // Do not ignore null keys.
+    return HashTable<false>::createForJoin(
+        std::move(keyHashers),
+        dependentTypes,
+        true, // allowDuplicates
+        true, // hasProbedFlag
+        mappedMemory,
+        layout);
+  }
+
+  // Semi and anti join with no extra filter only needs to know whether there
+  // is a match. Hence, no need to store entries with duplicate keys.
+  const bool dropDuplicates = !joinNode.filter() &&
+      (joinNode.isLeftSemiJoin() || joinNode.isAntiJoin());
+
+  return HashTable<true>::createForJoin(
+      std::move(keyHashers),
+      dependentTypes,
+      !dropDuplicates, // allowDuplicates
+      false, // hasProbedFlag
+      mappedMemory,
+      layout);
+}
+
+std::vector<std::shared_ptr<common::Filter>> makeJoinKeyFilters(
+    const HashJoinBridge::HashBuildResult& result) {
+  if (!result.table || result.antiJoinHasNullKeys || result.swapped ||
+      !result.spilledPartitions.empty() || result.table->numDistinct() == 0) {
+    return {};
+  }
+  const auto& hashers = result.table->hashers();
+  std::vector<std::shared_ptr<common::Filter>> filters(hashers.size());
+  for (auto i = 0; i < hashers.size(); ++i) {
+    if (result.table->hashMode() != BaseHashTable::HashMode::kHash) {
+      filters[i] = hashers[i]->getFilter(false);
+    }
+    if (!filters[i] && !result.keyBloomFilters.empty()) {
+      filters[i] = result.keyBloomFilters[i];
+    }
+  }
+  return filters;
+}
+
+bool isKeyOnlyJoin(const core::HashJoinNode& joinNode) {
+  if (joinNode.filter() ||
+      (!joinNode.isLeftSemiJoin() && !joinNode.isAntiJoin())) {
+    return false;
+  }
+  const auto& buildType = joinNode.sources()[1]->outputType();
+  for (const auto& name : joinNode.outputType()->names()) {
+    if (!buildType->containsChild(name)) {
+      continue;
+    }
+    bool isKey = false;
+    for (const auto& key : joinNode.rightKeys()) {
+      isKey = isKey || key->name() == name;
+    }
+    if (!isKey) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool isPlanNodeIdListed(const std::string& ids, const core::PlanNodeId& id) {
+  if (ids.empty()) {
+    return false;
+  }
+  std::vector<folly::StringPiece> listed;
+  folly::split(',', ids, listed, true);
+  for (auto listedId : listed) {
+    if (folly::trimWhitespace(listedId) == id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<BaseHashTable> retainTaskWithTable(
+    std::shared_ptr<BaseHashTable> table,
+    std::shared_ptr<Task> task) {
+  auto* rawTable = table.get();
+  // The rows of 'table' are in the memory of 'task', so 'table' goes first.
+  return std::shared_ptr<BaseHashTable>(
+      rawTable,
+      [table = std::move(table),
+       task = std::move(task)](BaseHashTable* /*unused*/) mutable {
+        table.reset();
+        task.reset();
+      });
+}
+
+bool canSwapJoinSides(
+    const core::HashJoinNode& joinNode,
+    const core::QueryConfig& config) {
+  // A spilled partition is built from the build side, so the sides are never
+  // swapped if the build may spill. Shared and cached tables are probed by
+  // other Tasks.
+  return config.hashJoinAdaptiveSwapEnabled() && joinNode.isInnerJoin() &&
+      !joinNode.filter() && !config.spillPath().has_value() &&
+      !SharedHashTables::isShared(joinNode, config) &&
+      !HashTableCache::isCached(joinNode, config);
+}
+
+void storeJoinBuildRows(
+    BaseHashTable& table,
+    const RowVector& input,
+    const SelectivityVector& activeRows,
+    const std::vector<column_index_t>& dependentChannels,
+    std::vector<std::unique_ptr<DecodedVector>>& decoders,
+    bool& analyzeKeys,
+    raw_vector<uint64_t>& hashes) {
+  if (analyzeKeys && hashes.size() < activeRows.size()) {
+    hashes.resize(activeRows.size());
+  }
+
+  auto& hashers = table.hashers();
+
+  // As long as analyzeKeys is true, we keep running the keys through
+  // the Vectorhashers so that we get a possible mapping of the keys
+  // to small ints for array or normalized key. When mayUseValueIds is
+  // false for the first time we stop. We do not retain the value ids
+  // since the final ones will only be known after all data is
+  // received.
+  for (auto& hasher : hashers) {
+    // TODO: Load only for active rows, except if right/full outer join.
+    if (analyzeKeys) {
+      hasher->computeValueIds(
+          *input.childAt(hasher->channel())->loadedVector(),
+          activeRows,
+          hashes);
+      analyzeKeys = hasher->mayUseValueIds();
+    } else {
+      hasher->decode(
+          *input.childAt(hasher->channel())->loadedVector(), activeRows);
+    }
+  }
+  for (auto i = 0; i < dependentChannels.size(); ++i) {
+    decoders[i]->decode(
+        *input.childAt(dependentChannels[i])->loadedVector(), activeRows);
+  }
+  auto rows = table.rows();
+  auto nextOffset = rows->nextOffset();
+  activeRows.applyToSelected([&](auto rowIndex) {
+    char* newRow = rows->newRow();
+    if (nextOffset) {
+      *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+    }
+    // Store the columns for each row in sequence. At probe time
+    // strings of the row will probably be in consecutive places, so
+    // reading one will prime the cache for the next.
+    for (auto i = 0; i < hashers.size(); ++i) {
+      rows->store(hashers[i]->decodedVector(), rowIndex, newRow, i);
+    }
+    for (auto i = 0; i < dependentChannels.size(); ++i) {
+      rows->store(*decoders[i], rowIndex, newRow, i + hashers.size());
+    }
+  });
+}
+
 HashBuild::HashBuild(
     int32_t operatorId,
     DriverCtx* driverCtx,
     std::shared_ptr<const core::HashJoinNode> joinNode)
     : Operator(driverCtx, nullptr, operatorId, joinNode->id(), "HashBuild"),
+      joinNode_(joinNode),
       joinType_{joinNode->joinType()},
-      mappedMemory_(operatorCtx_->mappedMemory()) {
+      sharedTableKey_(SharedHashTables::key(
+          *joinNode,
+          *driverCtx->task,
+          driverCtx->splitGroupId)),
+      cachesTable_(
+          HashTableCache::isCached(*joinNode, driverCtx->queryConfig())),
+      canSwap_(canSwapJoinSides(*joinNode, driverCtx->queryConfig())),
+      mappedMemory_(operatorCtx_->mappedMemory()),
+      spillPath_(
+          canSpill(*joinNode) && !sharedTableKey_.has_value() && !cachesTable_
+              ? operatorCtx_->makeSpillPath()
+              : std::nullopt),
+      spillExecutor_(operatorCtx_->task()->queryCtx()->spillExecutor()),
+      spillCompression_(spillCodecType(
+          operatorCtx_->task()->queryCtx()->config().spillCompressionCodec())),
+      spillDirectories_(operatorCtx_->spillDirectories()),
+      testSpillPct_(
+          operatorCtx_->task()->queryCtx()->config().testingSpillPct()) {
   auto type = joinNode->sources()[1]->outputType();
 
   auto numKeys = joinNode->rightKeys().size();
@@ -76,21 +451,25 @@ HashBuild::HashBuild(
   keyChannelSet.reserve(numKeys);
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
   keyHashers.reserve(numKeys);
+  std::vector<TypePtr> spillTypes;
   for (auto& key : joinNode->rightKeys()) {
     auto channel = exprToChannel(key.get(), type);
     keyChannelSet.emplace(channel);
     keyChannels_.emplace_back(channel);
     keyHashers.emplace_back(
         std::make_unique<VectorHasher>(type->childAt(channel), channel));
+    spillTypes.push_back(type->childAt(channel));
   }
 
-  // Identify the non-key build side columns and make a decoder for each.
-  auto numDependents = type->size() - numKeys;
+  // Identify the non-key build side columns and make a decoder for each. A
+  // key only join stores none.
+  const bool keyOnly = isKeyOnlyJoin(*joinNode);
+  auto numDependents = keyOnly ? 0 : type->size() - numKeys;
   dependentChannels_.reserve(numDependents);
   decoders_.reserve(numDependents);
   std::vector<TypePtr> dependentTypes;
   dependentTypes.reserve(numDependents);
-  for (auto i = 0; i < type->size(); ++i) {
+  for (auto i = 0; i < type->size() && !keyOnly; ++i) {
     if (keyChannelSet.find(i) == keyChannelSet.end()) {
       dependentTypes.emplace_back(type->childAt(i));
       dependentChannels_.emplace_back(i);
@@ -98,30 +477,41 @@ HashBuild::HashBuild(
     }
   }
 
-  if (joinNode->isRightJoin() || joinNode->isFullJoin()) {
-    // Do not ignore null keys.
-    table_ = HashTable<false>::createForJoin(
-        std::move(keyHashers),
-        dependentTypes,
-        true, // allowDuplicates
-        true, // hasProbedFlag
-        mappedMemory_);
-  } else {
-    // Semi and anti join with no extra filter only needs to know whether there
-    // is a match. Hence, no need to store entries with duplicate keys.
-    const bool dropDuplicates = !joinNode->filter() &&
-        (joinNode->isLeftSemiJoin() || joinNode->isAntiJoin());
-
-    table_ = HashTable<true>::createForJoin(
-        std::move(keyHashers),
-        dependentTypes,
-        !dropDuplicates, // allowDuplicates
-        false, // hasProbedFlag
-        mappedMemory_);
+  spillTypes.insert(
+      spillTypes.end(), dependentTypes.begin(), dependentTypes.end());
+  std::vector<std::string> spillNames;
+  for (auto i = 0; i < spillTypes.size(); ++i) {
+    spillNames.push_back(fmt::format("s{}", i));
   }
+  spillType_ = ROW(std::move(spillNames), std::move(spillTypes));
+
+  table_ = createJoinTable(
+      *joinNode,
+      std::move(keyHashers),
+      dependentTypes,
+      mappedMemory_,
+      driverCtx->queryConfig());
   analyzeKeys_ = table_->hashMode() != BaseHashTable::HashMode::kHash;
 }
 
+// static
+bool HashBuild::canSpill(const core::HashJoinNode& joinNode) {
+  // Right, full and anti joins need to see the whole build side to produce
+  // their output. The partition of a probe row is computed from the vector
+  // and the partition of a build row from the RowContainer. The two hash
+  // the same way only for scalar types.
+  if (!joinNode.isInnerJoin() && !joinNode.isLeftJoin() &&
+      !joinNode.isLeftSemiJoin()) {
+    return false;
+  }
+  for (const auto& key : joinNode.rightKeys()) {
+    if (!key->type()->isPrimitiveType()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void HashBuild::addInput(RowVectorPtr input) {
   activeRows_.resize(input->size());
   activeRows_.setAll();
@@ -140,52 +530,178 @@ void HashBuild::addInput(RowVectorPtr input) {
     }
   }
 
-  if (analyzeKeys_ && hashes_.size() < activeRows_.size()) {
-    hashes_.resize(activeRows_.size());
-  }
+  ensureInputFits(input);
 
-  auto& hashers = table_->hashers();
+  storeJoinBuildRows(
+      *table_,
+      *input,
+      activeRows_,
+      dependentChannels_,
+      decoders_,
+      analyzeKeys_,
+      hashes_);
 
-  // As long as analyzeKeys is true, we keep running the keys through
-  // the Vectorhashers so that we get a possible mapping of the keys
-  // to small ints for array or normalized key. When mayUseValueIds is
-  // false for the first time we stop. We do not retain the value ids
-  // since the final ones will only be known after all data is
-  // received.
-  for (auto& hasher : hashers) {
-    // TODO: Load only for active rows, except if right/full outer join.
-    if (analyzeKeys_) {
-      hasher->computeValueIds(
-          *input->childAt(hasher->channel())->loadedVector(),
-          activeRows_,
-          hashes_);
-      analyzeKeys_ = hasher->mayUseValueIds();
-    } else {
-      hasher->decode(
-          *input->childAt(hasher->channel())->loadedVector(), activeRows_);
-    }
+  if (spiller_) {
+    auto spilled = spiller_->spilledBytesAndRows();
+    stats_.spilledBytes = spilled.first;
+    stats_.spilledRows = spilled.second;
+    stats_.spillDirectoryStats = spiller_->spillDirectoryStats();
   }
-  for (auto i = 0; i < dependentChannels_.size(); ++i) {
-    decoders_[i]->decode(
-        *input->childAt(dependentChannels_[i])->loadedVector(), activeRows_);
+}
+
+void HashBuild::ensureInputFits(const RowVectorPtr& input) {
+  // Spilling is considered only if spillPath is set.
+  if (!spillPath_.has_value()) {
+    return;
   }
   auto rows = table_->rows();
-  auto nextOffset = rows->nextOffset();
-  activeRows_.applyToSelected([&](auto rowIndex) {
-    char* newRow = rows->newRow();
-    if (nextOffset) {
-      *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
-    }
-    // Store the columns for each row in sequence. At probe time
-    // strings of the row will probably be in consecutive places, so
-    // reading one will prime the cache for the next.
-    for (auto i = 0; i < hashers.size(); ++i) {
-      rows->store(hashers[i]->decodedVector(), rowIndex, newRow, i);
+  auto numRows = rows->numRows();
+  if (!numRows) {
+    // Nothing to spill.
+    return;
+  }
+
+  auto [freeRows, outOfLineFreeBytes] = rows->freeSpace();
+  auto outOfLineBytes =
+      rows->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  auto outOfLineBytesPerRow = outOfLineBytes / numRows;
+
+  // Test-only spill path.
+  if (testSpillPct_ &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <= testSpillPct_) {
+    auto rowsToSpill = numRows / 10;
+    spill(
+        numRows - rowsToSpill,
+        outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow));
+    return;
+  }
+
+  // Rows with null keys are not added to the table.
+  int64_t flatBytes = input->estimateFlatSize(activeRows_);
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the
+  // input as a cap on the new variable length data needed. The hash
+  // table is built only after all input is received.
+  auto increment =
+      rows->sizeIncrement(input->size(), outOfLineBytes ? flatBytes : 0);
+  auto tracker = mappedMemory_->tracker();
+  assert(tracker);
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * increment) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of
+  // twice the maximum increment from this input and 1/4 of the current
+  // reservation.
+  auto targetIncrement =
+      std::max<int64_t>(increment * 2, tracker->getCurrentUserBytes() / 4);
+  if (tracker->maybeReserve(targetIncrement)) {
+    return;
+  }
+  auto rowsToSpill = std::min<int64_t>(
+      numRows, targetIncrement / (rows->fixedRowSize() + outOfLineBytesPerRow));
+
+  spill(
+      numRows - rowsToSpill,
+      outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow));
+}
+
+void HashBuild::ensureSpiller() {
+  if (spiller_) {
+    return;
+  }
+  assert(mappedMemory_->tracker()); // lint
+  auto fileSize = mappedMemory_->tracker()->getCurrentUserBytes() / 4;
+  spiller_ = std::make_unique<Spiller>(
+      *table_->rows(),
+      [&](folly::Range<char**> rows) { table_->rows()->eraseRows(rows); },
+      spillType_,
+      HashJoinSpillPartition::bitRange(HashJoinSpillPartition::kStartBit),
+      0, // The spilled rows are not sorted.
+      spillPath_.value(),
+      fileSize,
+      Spiller::spillPool(),
+      spillExecutor_,
+      {},
+      spillCompression_,
+      spillDirectories_);
+}
+
+void HashBuild::spill(int64_t targetRows, int64_t targetBytes) {
+  ensureSpiller();
+  spiller_->spill(targetRows, targetBytes, spillIterator_);
+}
+
+int64_t HashBuild::reclaimableBytes() const {
+  if (!spillPath_.has_value() || noMoreInput_ || !table_ ||
+      table_->rows()->numRows() == 0) {
+    return 0;
+  }
+  return table_->rows()->allocatedBytes();
+}
+
+void HashBuild::reclaim() {
+  if (reclaimableBytes() == 0) {
+    return;
+  }
+  spill(0, 0);
+  releaseReservation();
+  auto spilled = spiller_->spilledBytesAndRows();
+  stats_.spilledBytes = spilled.first;
+  stats_.spilledRows = spilled.second;
+  stats_.spillDirectoryStats = spiller_->spillDirectoryStats();
+}
+
+std::vector<int32_t> HashBuild::spilledPartitions() const {
+  std::vector<int32_t> partitions;
+  if (spiller_) {
+    for (auto i = 0; i < spiller_->state().maxPartitions(); ++i) {
+      if (spiller_->isSpilled(i)) {
+        partitions.push_back(i);
+      }
     }
-    for (auto i = 0; i < dependentChannels_.size(); ++i) {
-      rows->store(*decoders_[i], rowIndex, newRow, i + hashers.size());
+  }
+  return partitions;
+}
+
+// static
+std::vector<HashJoinSpillPartition> HashBuild::finishSpill(
+    const std::vector<HashBuild*>& builds,
+    const std::vector<int32_t>& partitions) {
+  std::vector<HashJoinSpillPartition> spillPartitions;
+  for (auto partition : partitions) {
+    spillPartitions.push_back(HashJoinSpillPartition{
+        partition,
+        HashJoinSpillPartition::kStartBit +
+            HashJoinSpillPartition::kNumPartitionBits});
+  }
+  for (auto* build : builds) {
+    build->ensureSpiller();
+    build->spiller_->finishSpill(partitions);
+    for (auto& spillPartition : spillPartitions) {
+      if (!build->spiller_->isSpilled(spillPartition.partition)) {
+        continue;
+      }
+      for (auto& file :
+           build->spiller_->takeFiles(spillPartition.partition)) {
+        spillPartition.buildFiles.push_back(std::move(file));
+      }
     }
-  });
+    auto spilled = build->spiller_->spilledBytesAndRows();
+    build->stats_.spilledBytes = spilled.first;
+    build->stats_.spilledRows = spilled.second;
+    build->stats_.spillDirectoryStats =
+        build->spiller_->spillDirectoryStats();
+  }
+  return spillPartitions;
 }
 
 void HashBuild::noMoreInput() {
@@ -208,8 +724,11 @@ void HashBuild::noMoreInput() {
 
   std::vector<std::unique_ptr<BaseHashTable>> otherTables;
   otherTables.reserve(peers.size());
+  std::vector<HashJoinSpillPartition> spillPartitions;
+  std::vector<RowContainer*> rowContainers;
 
   if (!antiJoinHasNullKeys_) {
+    std::vector<HashBuild*> builds{this};
     for (auto& peer : peers) {
       auto op = peer->findOperator(planNodeId());
       HashBuild* build = dynamic_cast<HashBuild*>(op);
@@ -218,7 +737,31 @@ void HashBuild::noMoreInput() {
         antiJoinHasNullKeys_ = true;
         break;
       }
-      otherTables.push_back(std::move(build->table_));
+      builds.push_back(build);
+    }
+
+    if (!antiJoinHasNullKeys_) {
+      // A partition spilled by any build Driver is spilled by all so that the
+      // hash table has either all or none of the rows of a partition.
+      std::vector<int32_t> partitions;
+      for (auto* build : builds) {
+        for (auto partition : build->spilledPartitions()) {
+          if (std::find(partitions.begin(), partitions.end(), partition) ==
+              partitions.end()) {
+            partitions.push_back(partition);
+          }
+        }
+      }
+      if (!partitions.empty()) {
+        std::sort(partitions.begin(), partitions.end());
+        spillPartitions = finishSpill(builds, partitions);
+      }
+      for (auto* build : builds) {
+        rowContainers.push_back(build->table_->rows());
+      }
+      for (auto i = 1; i < builds.size(); ++i) {
+        otherTables.push_back(std::move(builds[i]->table_));
+      }
     }
   }
 
@@ -230,20 +773,147 @@ void HashBuild::noMoreInput() {
   }
 
   if (antiJoinHasNullKeys_) {
-    operatorCtx_->task()
-        ->getHashJoinBridge(
-            operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-        ->setAntiJoinHasNullKeys();
+    auto bridge = operatorCtx_->task()->getHashJoinBridge(
+        operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+    bridge->setAntiJoinHasNullKeys();
+    if (buildsSharedTable_) {
+      SharedHashTables::instance().publish(
+          sharedTableKey_.value(), bridge.get(), nullptr, {});
+    }
+    if (cacheKey_.has_value()) {
+      HashTableCache::instance().put(
+          cacheKey_.value(), nullptr, {}, operatorCtx_->task());
+    }
+  } else if (canSwap_) {
+    otherTables_ = std::move(otherTables);
+    waitingForSwap_ = true;
+    maybeSwap();
   } else {
-    table_->prepareJoinTable(std::move(otherTables));
+    finishTable(
+        std::move(otherTables), std::move(spillPartitions), rowContainers);
+  }
+}
+
+void HashBuild::finishTable(
+    std::vector<std::unique_ptr<BaseHashTable>> otherTables,
+    std::vector<HashJoinSpillPartition> spillPartitions,
+    const std::vector<RowContainer*>& rowContainers) {
+  // The peers are done and their threads are free to insert rows in
+  // parallel.
+  table_->prepareJoinTable(
+      std::move(otherTables), operatorCtx_->task()->queryCtx()->executor());
 
-    addRuntimeStats();
+  addRuntimeStats();
 
-    operatorCtx_->task()
-        ->getHashJoinBridge(
-            operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-        ->setHashTable(std::move(table_));
+  // The BloomFilters must pass all the build side keys. The rows of the
+  // spilled partitions are not in 'rowContainers'.
+  std::vector<std::shared_ptr<common::Filter>> keyBloomFilters;
+  if (spillPartitions.empty() &&
+      (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_))) {
+    keyBloomFilters = makeKeyBloomFilters(rowContainers);
   }
+
+  auto bridge = operatorCtx_->task()->getHashJoinBridge(
+      operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+  if (buildsSharedTable_ || cacheKey_.has_value()) {
+    std::shared_ptr<BaseHashTable> table = std::move(table_);
+    bridge->setSharedHashTable(table, keyBloomFilters);
+    if (buildsSharedTable_) {
+      SharedHashTables::instance().publish(
+          sharedTableKey_.value(), bridge.get(), table, keyBloomFilters);
+    }
+    if (cacheKey_.has_value()) {
+      HashTableCache::instance().put(
+          cacheKey_.value(),
+          std::move(table),
+          std::move(keyBloomFilters),
+          operatorCtx_->task());
+    }
+    return;
+  }
+  bridge->setHashTable(
+      std::move(table_),
+      std::move(spillPartitions),
+      std::move(keyBloomFilters));
+}
+
+void HashBuild::maybeSwap() {
+  auto bridge = operatorCtx_->task()->getHashJoinBridge(
+      operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+  uint64_t numRows = table_->rows()->numRows();
+  for (const auto& table : otherTables_) {
+    numRows += table->rows()->numRows();
+  }
+  auto swap = bridge->swapOrFuture(
+      numRows,
+      operatorCtx_->driverCtx()->queryConfig().hashJoinSwapRatio(),
+      &future_);
+  if (!swap.has_value()) {
+    return;
+  }
+  waitingForSwap_ = false;
+  auto otherTables = std::move(otherTables_);
+  if (!swap.value()) {
+    std::vector<RowContainer*> rowContainers{table_->rows()};
+    for (const auto& table : otherTables) {
+      rowContainers.push_back(table->rows());
+    }
+    finishTable(std::move(otherTables), {}, rowContainers);
+    return;
+  }
+
+  stats_.addRuntimeStat("hashJoinSwapped", RuntimeCounter(1));
+  auto probeTable = makeSwappedTable(bridge->takeProbeInput());
+  std::vector<std::shared_ptr<BaseHashTable>> buildTables;
+  buildTables.push_back(std::move(table_));
+  for (auto& table : otherTables) {
+    buildTables.push_back(std::move(table));
+  }
+  bridge->setSwappedTable(std::move(probeTable), std::move(buildTables));
+}
+
+std::unique_ptr<BaseHashTable> HashBuild::makeSwappedTable(
+    const std::vector<RowVectorPtr>& probeInput) {
+  auto type = joinNode_->sources()[0]->outputType();
+  folly::F14FastSet<column_index_t> keyChannelSet;
+  std::vector<column_index_t> keyChannels;
+  std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+  for (auto& key : joinNode_->leftKeys()) {
+    auto channel = exprToChannel(key.get(), type);
+    keyChannelSet.emplace(channel);
+    keyChannels.push_back(channel);
+    keyHashers.push_back(
+        std::make_unique<VectorHasher>(type->childAt(channel), channel));
+  }
+  std::vector<TypePtr> dependentTypes;
+  std::vector<column_index_t> dependentChannels;
+  std::vector<std::unique_ptr<DecodedVector>> decoders;
+  for (auto i = 0; i < type->size(); ++i) {
+    if (keyChannelSet.find(i) == keyChannelSet.end()) {
+      dependentTypes.push_back(type->childAt(i));
+      dependentChannels.push_back(i);
+      decoders.push_back(std::make_unique<DecodedVector>());
+    }
+  }
+  auto table = createJoinTable(
+      *joinNode_,
+      std::move(keyHashers),
+      dependentTypes,
+      mappedMemory_,
+      operatorCtx_->driverCtx()->queryConfig());
+
+  bool analyzeKeys = table->hashMode() != BaseHashTable::HashMode::kHash;
+  raw_vector<uint64_t> hashes;
+  SelectivityVector rows;
+  for (const auto& input : probeInput) {
+    rows.resize(input->size());
+    rows.setAll();
+    deselectRowsWithNulls(*input, keyChannels, rows, *operatorCtx_->execCtx());
+    storeJoinBuildRows(
+        *table, *input, rows, dependentChannels, decoders, analyzeKeys, hashes);
+  }
+  table->prepareJoinTable({});
+  return table;
 }
 
 void HashBuild::addRuntimeStats() {
@@ -264,7 +934,147 @@ void HashBuild::addRuntimeStats() {
   }
 }
 
+namespace {
+// Adds the non-null values of 'column' in 'rows' to 'bloomFilter' and updates
+// 'min' and 'max'.
+template <typename T>
+void addToBloomFilter(
+    char* const* rows,
+    int32_t numRows,
+    RowColumn column,
+    BloomFilter<>& bloomFilter,
+    int64_t& min,
+    int64_t& max) {
+  for (auto i = 0; i < numRows; ++i) {
+    if (column.nullMask() &&
+        RowContainer::isNullAt(rows[i], column.nullByte(), column.nullMask())) {
+      continue;
+    }
+    int64_t value = RowContainer::valueAt<T>(rows[i], column.offset());
+    bloomFilter.insert(value);
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+}
+} // namespace
+
+std::vector<std::shared_ptr<common::Filter>> HashBuild::makeKeyBloomFilters(
+    const std::vector<RowContainer*>& rowContainers) const {
+  if (table_->numDistinct() == 0 ||
+      table_->numDistinct() > kMaxBloomFilterRows) {
+    return {};
+  }
+  const auto& hashers = table_->hashers();
+  std::vector<int32_t> keys;
+  for (auto i = 0; i < hashers.size(); ++i) {
+    if (table_->hashMode() != BaseHashTable::HashMode::kHash &&
+        !hashers[i]->distinctOverflow()) {
+      continue;
+    }
+    switch (hashers[i]->typeKind()) {
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+        keys.push_back(i);
+        break;
+      default:
+        break;
+    }
+  }
+  if (keys.empty()) {
+    return {};
+  }
+
+  std::vector<std::shared_ptr<BloomFilter<>>> bloomFilters(keys.size());
+  std::vector<int64_t> mins(keys.size(), std::numeric_limits<int64_t>::max());
+  std::vector<int64_t> maxs(keys.size(), std::numeric_limits<int64_t>::min());
+  for (auto& bloomFilter : bloomFilters) {
+    bloomFilter = std::make_shared<BloomFilter<>>();
+    bloomFilter->reset(table_->numDistinct());
+  }
+  constexpr int32_t kBatchSize = 1024;
+  std::vector<char*> rows(kBatchSize);
+  for (auto* rowContainer : rowContainers) {
+    RowContainerIterator iter;
+    while (auto numRows =
+               rowContainer->listRows(&iter, kBatchSize, rows.data())) {
+      for (auto i = 0; i < keys.size(); ++i) {
+        auto column = rowContainer->columnAt(keys[i]);
+        auto& bloomFilter = *bloomFilters[i];
+        switch (hashers[keys[i]]->typeKind()) {
+          case TypeKind::TINYINT:
+            addToBloomFilter<int8_t>(
+                rows.data(), numRows, column, bloomFilter, mins[i], maxs[i]);
+            break;
+          case TypeKind::SMALLINT:
+            addToBloomFilter<int16_t>(
+                rows.data(), numRows, column, bloomFilter, mins[i], maxs[i]);
+            break;
+          case TypeKind::INTEGER:
+            addToBloomFilter<int32_t>(
+                rows.data(), numRows, column, bloomFilter, mins[i], maxs[i]);
+            break;
+          default:
+            addToBloomFilter<int64_t>(
+                rows.data(), numRows, column, bloomFilter, mins[i], maxs[i]);
+            break;
+        }
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<common::Filter>> filters(hashers.size());
+  for (auto i = 0; i < keys.size(); ++i) {
+    if (mins[i] > maxs[i]) {
+      // All keys are null.
+      continue;
+    }
+    filters[keys[i]] = std::make_shared<common::BigintBloomFilter>(
+        mins[i], maxs[i], std::move(bloomFilters[i]), false);
+  }
+  return filters;
+}
+
+void HashBuild::decideBuild() {
+  buildDecided_ = true;
+  auto& task = operatorCtx_->task();
+  const auto splitGroupId = operatorCtx_->driverCtx()->splitGroupId;
+  sharedTableBridge_ = task->getHashJoinBridge(splitGroupId, planNodeId());
+  if (cachesTable_) {
+    auto lookup = [&]() {
+      HashJoinBridge::CachedBuild build;
+      build.cacheKey = HashTableCache::key(*joinNode_, *task, splitGroupId);
+      if (build.cacheKey.has_value()) {
+        build.table = HashTableCache::instance().find(build.cacheKey.value());
+      }
+      return build;
+    };
+    if (!sharedTableBridge_->startBuild(lookup, cacheKey_)) {
+      stats_.addRuntimeStat("hashTableCacheHit", RuntimeCounter(1));
+      Operator::noMoreInput();
+      return;
+    }
+  }
+  if (sharedTableKey_.has_value()) {
+    buildsSharedTable_ = SharedHashTables::instance().buildOrShare(
+        sharedTableKey_.value(), task, sharedTableBridge_);
+    if (!buildsSharedTable_) {
+      stats_.addRuntimeStat("sharedHashTable", RuntimeCounter(1));
+      Operator::noMoreInput();
+    }
+  }
+}
+
 BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
+  // The Driver asks the sink if it is blocked before giving it input. The
+  // Task is not locked here, unlike in the constructor.
+  if ((sharedTableKey_.has_value() || cachesTable_) && !buildDecided_) {
+    decideBuild();
+  }
+  if (waitingForSwap_ && !future_.valid()) {
+    maybeSwap();
+  }
   if (!future_.valid()) {
     return BlockingReason::kNotBlocked;
   }
@@ -273,7 +1083,16 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
 }
 
 bool HashBuild::isFinished() {
-  return !future_.valid() && noMoreInput_;
+  return !future_.valid() && noMoreInput_ && !waitingForSwap_;
+}
+
+void HashBuild::close() {
+  // A failed Task does not publish its table. The Tasks waiting for it fail
+  // too.
+  if (buildsSharedTable_ && !operatorCtx_->task()->isRunning()) {
+    SharedHashTables::instance().cancel(
+        sharedTableKey_.value(), sharedTableBridge_.get());
+  }
 }
 
 } // namespace facebook::velox::exec
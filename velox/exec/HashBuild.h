@@ -18,18 +18,67 @@
 #include "velox/exec/HashTable.h"
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/expression/Expr.h"
 
 namespace facebook::velox::exec {
 
+// Spilled build and probe side rows of one hash partition of a hash join. A
+// hash join that spills partitions its build and probe sides on a range of
+// bits of the hash number of the join keys. The in-memory hash table covers
+// the partitions that did not spill. The spilled partitions are then built and
+// probed one at a time. A partition whose build side is too large for memory is
+// partitioned again on the next range of hash bits.
+struct HashJoinSpillPartition {
+  // Number of hash bits for one level of partitioning.
+  static constexpr uint8_t kNumPartitionBits = 2;
+  // Lowest hash bit of the first level of partitioning. The low bits of the
+  // hash number select the hash table bucket and bits 32-38 make the hash
+  // tag. Partitioning on these would cluster the rows of a partition in the
+  // hash table.
+  static constexpr uint8_t kStartBit = 40;
+  // Maximum number of partitioning levels.
+  static constexpr int32_t kMaxLevels = 4;
+
+  static HashBitRange bitRange(uint8_t bitOffset) {
+    return HashBitRange(bitOffset, bitOffset + kNumPartitionBits);
+  }
+
+  // Number of 'this' within its level of partitioning.
+  int32_t partition;
+
+  // Lowest hash bit for partitioning 'this' further.
+  uint8_t nextBitOffset;
+
+  // Spilled build side rows. The columns are the join keys followed by the
+  // dependent build side columns.
+  std::vector<std::unique_ptr<SpillFile>> buildFiles;
+
+  // Spilled probe side input.
+  std::vector<std::unique_ptr<SpillFile>> probeFiles;
+};
+
 // Hands over a hash table from a multi-threaded build pipeline to a
 // multi-threaded probe pipeline. This is owned by shared_ptr by all the build
 // and probe Operator instances concerned. Corresponds to the Presto concept of
 // the same name.
 class HashJoinBridge : public JoinBridge {
  public:
-  void setHashTable(std::unique_ptr<BaseHashTable> table);
+  // Sets the hash table made from the partitions of the build side that did
+  // not spill. 'spillPartitions' are the spilled build side partitions.
+  // 'keyBloomFilters' has a filter or nullptr for each join key. See
+  // HashBuildResult.
+  void setHashTable(
+      std::unique_ptr<BaseHashTable> table,
+      std::vector<HashJoinSpillPartition> spillPartitions = {},
+      std::vector<std::shared_ptr<common::Filter>> keyBloomFilters = {});
+
+  // Sets a hash table built by the HashBuilds of another Task. See
+  // SharedHashTables.
+  void setSharedHashTable(
+      std::shared_ptr<BaseHashTable> table,
+      std::vector<std::shared_ptr<common::Filter>> keyBloomFilters);
 
   void setAntiJoinHasNullKeys();
 
@@ -37,18 +86,182 @@ class HashJoinBridge : public JoinBridge {
   // anti join, a build side entry with a null in a join key makes the join
   // return nothing. In this case, HashBuild operator finishes early without
   // processing all the input and without finishing building the hash table.
+  // 'spilledPartitions' are the numbers of the build side partitions that are
+  // not in 'table'. The probe side input of these partitions must be spilled
+  // too. 'keyBloomFilters' is either empty or has a BigintBloomFilter or
+  // nullptr for each join key. The filters pass all the key values in 'table'
+  // and are meant for keys that get no exact dynamic filter from 'table'.
+  // 'swapped' is true if 'table' is made of the probe side input. See
+  // setSwappedTable().
   struct HashBuildResult {
     std::shared_ptr<BaseHashTable> table;
     bool antiJoinHasNullKeys;
+    std::vector<int32_t> spilledPartitions;
+    std::vector<std::shared_ptr<common::Filter>> keyBloomFilters;
+    bool swapped{false};
   };
 
   std::optional<HashBuildResult> tableOrFuture(ContinueFuture* future);
 
+  // Returns the result if the table is set, std::nullopt otherwise. Does not
+  // wait.
+  std::optional<HashBuildResult> tableIfSet();
+
+  // The outcome of looking up a table built before, see startBuild().
+  // 'cacheKey' is the key to cache a table built now under, if it may be
+  // cached. 'table' is a table built before, if any.
+  struct CachedBuild {
+    std::optional<std::string> cacheKey;
+    std::optional<HashBuildResult> table;
+  };
+
+  // Decides once for all the HashBuilds of the bridge whether they build
+  // the table. The first caller runs 'lookup'. If that finds a table, the
+  // table is set as by setSharedHashTable() and the HashBuilds do not build.
+  // Returns true if the HashBuilds build the table and sets 'cacheKey' to
+  // the key from 'lookup' for them.
+  bool startBuild(
+      const std::function<CachedBuild()>& lookup,
+      std::optional<std::string>& cacheKey);
+
+  // Adds spilled probe side input of 'partition'. Called by each HashProbe
+  // for each spilled partition once all its input is received.
+  void addProbeSpillFiles(
+      int32_t partition,
+      std::vector<std::unique_ptr<SpillFile>> files);
+
+  // Returns the next spilled partition to build and probe. Returns
+  // std::nullopt if all spilled partitions have been taken. Must be called
+  // only after all HashProbes have added their spilled input.
+  std::optional<HashJoinSpillPartition> nextSpillPartition();
+
+  // Adaptive swap of the build and probe sides of an inner join. Each of the
+  // 'numProbes' HashProbes reports its input once, before waiting for the
+  // table. 'complete' means that 'input' is all of its input. Otherwise
+  // 'input' is empty and the sides are not swapped.
+  void addProbeInput(
+      std::vector<RowVectorPtr> input,
+      bool complete,
+      int32_t numProbes);
+
+  // Called by the last HashBuild with the number of build side rows before
+  // making the table. Returns true if the sides are to be swapped, false if
+  // not and std::nullopt with 'future' set if the HashProbes have not all
+  // reported their input yet. The sides are swapped if all probe input is
+  // known and 'numBuildRows' is more than 'ratio' times its rows.
+  std::optional<bool> swapOrFuture(
+      uint64_t numBuildRows,
+      double ratio,
+      ContinueFuture* future);
+
+  // Returns the probe side input reported to addProbeInput().
+  std::vector<RowVectorPtr> takeProbeInput();
+
+  // Sets the table made of the probe side input after a swap. 'buildTables'
+  // hold the build side rows, not made into a hash table. The HashProbes
+  // take these with nextSwappedBuildTable() and probe 'table' with them.
+  void setSwappedTable(
+      std::unique_ptr<BaseHashTable> table,
+      std::vector<std::shared_ptr<BaseHashTable>> buildTables);
+
+  // Returns the next table of build side rows to probe the swapped table
+  // with, nullptr if all are taken.
+  std::shared_ptr<BaseHashTable> nextSwappedBuildTable();
+
  private:
+  void setTable(
+      std::shared_ptr<BaseHashTable> table,
+      std::vector<HashJoinSpillPartition> spillPartitions,
+      std::vector<std::shared_ptr<common::Filter>> keyBloomFilters);
+
+  // Decides on the swap once the build side and all HashProbes have
+  // reported. Returns true if decided by this call.
+  bool decideSwapLocked();
+
   std::shared_ptr<BaseHashTable> table_;
   bool antiJoinHasNullKeys_{false};
+  // Set by the first startBuild().
+  std::optional<bool> buildsTable_;
+  std::optional<std::string> cacheKey_;
+  std::vector<HashJoinSpillPartition> spillPartitions_;
+  std::vector<int32_t> spilledPartitionNumbers_;
+  std::vector<std::shared_ptr<common::Filter>> keyBloomFilters_;
+  // Index of the first partition in 'spillPartitions_' not returned from
+  // nextSpillPartition().
+  size_t nextSpillPartition_{0};
+
+  // State of the adaptive swap. 'numProbes_' is 0 until the first HashProbe
+  // reports. 'probeInputComplete_' is false once a HashProbe has reported
+  // incomplete input.
+  int32_t numProbes_{0};
+  int32_t numReportedProbes_{0};
+  bool probeInputComplete_{true};
+  std::vector<RowVectorPtr> probeInput_;
+  uint64_t numProbeRows_{0};
+  std::optional<uint64_t> numBuildRows_;
+  double swapRatio_{0};
+  std::optional<bool> swap_;
+  bool swapped_{false};
+  std::vector<std::shared_ptr<BaseHashTable>> swappedBuildTables_;
+  size_t nextSwappedBuildTable_{0};
 };
 
+// Creates an empty hash table for the build side of 'joinNode'. 'keyHashers'
+// are for the join keys and 'dependentTypes' are the types of the other build
+// side columns. The table has interleaved buckets if so set in 'config'.
+std::unique_ptr<BaseHashTable> createJoinTable(
+    const core::HashJoinNode& joinNode,
+    std::vector<std::unique_ptr<VectorHasher>> keyHashers,
+    const std::vector<TypePtr>& dependentTypes,
+    memory::MappedMemory* mappedMemory,
+    const core::QueryConfig& config);
+
+// Returns a dynamic filter or nullptr for each join key of the table in
+// 'result'. A key gets the exact filter of its VectorHasher if the table is
+// not in kHash mode and the BloomFilter of 'result' otherwise. All are nullptr
+// if the table does not have all the build side rows, i.e. if it is empty,
+// has spilled partitions or is swapped.
+std::vector<std::shared_ptr<common::Filter>> makeJoinKeyFilters(
+    const HashJoinBridge::HashBuildResult& result);
+
+// Returns true if the build side of 'joinNode' is only checked for the
+// existence of a key, i.e. for a semi or anti join with no filter and no
+// non-key build side column in the output. The hash table of such a join
+// stores only the keys and has one entry per distinct key and no chains of
+// duplicates, so that a probe stops at the first match.
+bool isKeyOnlyJoin(const core::HashJoinNode& joinNode);
+
+// Stores 'activeRows' of 'input' in the RowContainer of 'table'. The keys are
+// taken from the channels of the hashers of 'table' and the dependent columns
+// from 'dependentChannels', decoded with 'decoders'. As long as 'analyzeKeys'
+// is true, the keys are run through VectorHasher::computeValueIds() to find
+// out if an array or normalized key hash mode is possible. 'analyzeKeys' is
+// set to false once it is not. 'hashes' is scratch space.
+void storeJoinBuildRows(
+    BaseHashTable& table,
+    const RowVector& input,
+    const SelectivityVector& activeRows,
+    const std::vector<column_index_t>& dependentChannels,
+    std::vector<std::unique_ptr<DecodedVector>>& decoders,
+    bool& analyzeKeys,
+    raw_vector<uint64_t>& hashes);
+
+// Returns true if 'id' is one of the comma separated plan node ids in 'ids'.
+bool isPlanNodeIdListed(const std::string& ids, const core::PlanNodeId& id);
+
+// Returns a reference to 'table' that also keeps 'task' alive. For tables
+// probed by other Tasks, since the pools of 'task' own the memory of
+// 'table'.
+std::shared_ptr<BaseHashTable> retainTaskWithTable(
+    std::shared_ptr<BaseHashTable> table,
+    std::shared_ptr<Task> task);
+
+// Returns true if the build and probe sides of 'joinNode' may be swapped at
+// run time. See QueryConfig::kHashJoinAdaptiveSwapEnabled.
+bool canSwapJoinSides(
+    const core::HashJoinNode& joinNode,
+    const core::QueryConfig& config);
+
 // Builds a hash table for use in HashProbe. This is the final
 // Operator in a build side Driver. The build side pipeline has
 // multiple Drivers, each with its own HashBuild. The build finishes
@@ -58,6 +271,23 @@ class HashJoinBridge : public JoinBridge {
 // table. This table is then passed to the probe side pipeline via
 // JoinBridge. After this, all build side Drivers finish and free
 // their state.
+//
+// If a spill path is configured and the memory reservation of the
+// operator cannot be grown to fit the next input, the accumulated rows
+// are spilled to disk by hash partition. At the barrier, each partition
+// spilled by any of the Drivers is spilled by all of them, so that the
+// hash table covers only the partitions that did not spill. Spilling is
+// supported for inner, left and left semi joins with scalar join keys.
+//
+// If the join sides may be swapped, the last Driver waits at the barrier for
+// the HashProbes to report their input to the JoinBridge. If the build side
+// is much larger, it makes the hash table of the probe side input instead
+// and hands over the build side rows for the HashProbes to probe it with.
+//
+// If the table is shared with the other Tasks of the stage, see
+// SharedHashTables, the HashBuilds of the Tasks that do not build it finish
+// without input and the JoinBridge gets the table of the building Task. The
+// same goes for a table found in HashTableCache.
 class HashBuild final : public Operator {
  public:
   HashBuild(
@@ -81,13 +311,107 @@ class HashBuild final : public Operator {
 
   bool isFinished() override;
 
-  void close() override {}
+  int64_t reclaimableBytes() const override;
+
+  // Spills all build side rows while input is still arriving. The spilled
+  // partitions are joined after the non-spilled ones, as when spilling to
+  // fit the input.
+  void reclaim() override;
+
+  void close() override;
 
  private:
+  // Maximum number of build side rows for making BloomFilters on the join
+  // keys. A BloomFilter takes 2 bytes per row.
+  static constexpr uint64_t kMaxBloomFilterRows = 16 << 20;
+
   void addRuntimeStats();
 
+  // Finds out from HashTableCache and SharedHashTables whether this Task
+  // builds the table. If not, finishes without input.
+  void decideBuild();
+
+  // Makes the join hash table of 'table_' and 'otherTables' and hands it over
+  // to the HashJoinBridge. See HashJoinBridge::setHashTable().
+  void finishTable(
+      std::vector<std::unique_ptr<BaseHashTable>> otherTables,
+      std::vector<HashJoinSpillPartition> spillPartitions,
+      const std::vector<RowContainer*>& rowContainers);
+
+  // Called by the last build Driver if 'canSwap_'. Asks the HashJoinBridge
+  // whether to swap the join sides and sets 'future_' if this is not decided
+  // yet. Otherwise finishes the build either way.
+  void maybeSwap();
+
+  // Returns a join hash table of 'probeInput' for a swapped join. The keys
+  // are the probe side join keys and the dependents the other probe side
+  // columns, in the order of makeTableType() in HashProbe.
+  std::unique_ptr<BaseHashTable> makeSwappedTable(
+      const std::vector<RowVectorPtr>& probeInput);
+
+  // Returns a BigintBloomFilter for each integer join key that gets no exact
+  // dynamic filter from 'table_', i.e. each key of a kHash mode table or with
+  // too many distinct values, and nullptr for the other keys. Returns an empty
+  // vector if no key needs a filter. 'rowContainers' hold the rows of 'table_'
+  // and of the tables of the peers. Must be called after prepareJoinTable().
+  std::vector<std::shared_ptr<common::Filter>> makeKeyBloomFilters(
+      const std::vector<RowContainer*>& rowContainers) const;
+
+  // Returns true if spilling is possible for 'joinNode'.
+  static bool canSpill(const core::HashJoinNode& joinNode);
+
+  // Checks if the input will fit in the existing memory and increases the
+  // reservation if not. If the reservation cannot be increased, spills enough
+  // to make space for the input.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills content until under 'targetRows' and under 'targetBytes' of out of
+  // line data are left.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  // Creates 'spiller_' if not yet created.
+  void ensureSpiller();
+
+  // Returns the numbers of the partitions spilled by 'this'.
+  std::vector<int32_t> spilledPartitions() const;
+
+  // Called by the last build Driver on behalf of all the others. Spills the
+  // rows of 'partitions' that are still in memory in 'builds' and returns the
+  // files of each spilled partition.
+  static std::vector<HashJoinSpillPartition> finishSpill(
+      const std::vector<HashBuild*>& builds,
+      const std::vector<int32_t>& partitions);
+
+  const std::shared_ptr<const core::HashJoinNode> joinNode_;
+
   const core::JoinType joinType_;
 
+  // Key of the table in SharedHashTables if shared with other Tasks.
+  const std::optional<std::string> sharedTableKey_;
+
+  // True if the table may be kept in HashTableCache.
+  const bool cachesTable_;
+
+  // True once decideBuild() has run.
+  bool buildDecided_{false};
+
+  // True if this Task builds the table of 'sharedTableKey_'.
+  bool buildsSharedTable_{false};
+
+  // Key to put the table under in HashTableCache after building it.
+  std::optional<std::string> cacheKey_;
+
+  // The HashJoinBridge of this Task. Set by decideBuild().
+  std::shared_ptr<HashJoinBridge> sharedTableBridge_;
+
+  // True if the join sides may be swapped. See canSwapJoinSides().
+  const bool canSwap_;
+
+  // True while the last build Driver waits for the swap decision. The tables
+  // of the peers are then kept in 'otherTables_'.
+  bool waitingForSwap_{false};
+  std::vector<std::unique_ptr<BaseHashTable>> otherTables_;
+
   // Container for the rows being accumulated.
   std::unique_ptr<BaseHashTable> table_;
 
@@ -120,6 +444,32 @@ class HashBuild final : public Operator {
   // True if this is a build side of an anti join and has at least one entry
   // with null join keys.
   bool antiJoinHasNullKeys_{false};
+
+  // Filesystem path for spill files, empty if spilling is disabled.
+  const std::optional<std::string> spillPath_;
+
+  // Executor for spilling. If nullptr spilling writes on the Driver's thread.
+  folly::Executor* FOLLY_NULLABLE const spillExecutor_;
+
+  // Codec for the spill files.
+  const folly::io::CodecType spillCompression_;
+
+  // Directories the spill files are striped over.
+  const std::vector<SpillDirectory*> spillDirectories_;
+
+  // Percentage of input batches to be spilled for testing. 0 means no
+  // spilling for test.
+  const int32_t testSpillPct_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct_'.
+  uint64_t spillTestCounter_{0};
+
+  // Type of the spilled rows: the join keys followed by the dependent columns.
+  RowTypePtr spillType_;
+
+  std::unique_ptr<Spiller> spiller_;
+  RowContainerIterator spillIterator_;
 };
 
 } // namespace facebook::velox::exec
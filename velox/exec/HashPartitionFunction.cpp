@@ -42,6 +42,12 @@ void HashPartitionFunction::partition(
     std::vector<uint32_t>& partitions) {
   auto size = input.size();
 
+  partitions.resize(size);
+  if (hashers_.size() == 1 && size > 0 &&
+      partitionDistinct(input, partitions)) {
+    return;
+  }
+
   rows_.resize(size);
   rows_.setAll();
 
@@ -56,9 +62,60 @@ void HashPartitionFunction::partition(
     }
   }
 
-  partitions.resize(size);
   for (auto i = 0; i < size; ++i) {
     partitions[i] = hashes_[i] % numPartitions_;
   }
 }
+
+bool HashPartitionFunction::partitionDistinct(
+    const RowVector& input,
+    std::vector<uint32_t>& partitions) {
+  auto& hasher = hashers_[0];
+  if (hasher->channel() == kConstantChannel ||
+      input.childAt(hasher->channel())->isConstantEncoding()) {
+    rows_.resize(1);
+    rows_.setAll();
+    hashes_.resize(1);
+    if (hasher->channel() == kConstantChannel) {
+      hasher->hashPrecomputed(rows_, false, hashes_);
+    } else {
+      hasher->hash(*input.childAt(hasher->channel()), rows_, false, hashes_);
+    }
+    std::fill(
+        partitions.begin(), partitions.end(), hashes_[0] % numPartitions_);
+    return true;
+  }
+
+  const auto& key = input.childAt(hasher->channel());
+  if (key->encoding() != VectorEncoding::Simple::DICTIONARY) {
+    return false;
+  }
+  const auto size = input.size();
+  rows_.resize(size);
+  rows_.setAll();
+  decoded_.decode(*key, rows_);
+  if (decoded_.isIdentityMapping() || decoded_.isConstantMapping() ||
+      decoded_.base()->size() >= size) {
+    return false;
+  }
+
+  // Hashes each value of the base once.
+  const auto* base = decoded_.base();
+  baseRows_.resize(base->size());
+  baseRows_.setAll();
+  hashes_.resize(base->size());
+  hasher->hash(*base, baseRows_, false, hashes_);
+  basePartitions_.resize(base->size());
+  for (auto i = 0; i < base->size(); ++i) {
+    basePartitions_[i] = hashes_[i] % numPartitions_;
+  }
+
+  const uint32_t nullPartition = VectorHasher::kNullHash % numPartitions_;
+  for (auto i = 0; i < size; ++i) {
+    partitions[i] = decoded_.isNullAt(i)
+        ? nullPartition
+        : basePartitions_[decoded_.index(i)];
+  }
+  return true;
+}
 } // namespace facebook::velox::exec
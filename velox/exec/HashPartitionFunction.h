@@ -17,6 +17,7 @@
 
 #include <velox/exec/VectorHasher.h>
 #include "velox/core/PlanNode.h"
+#include "velox/vector/DecodedVector.h"
 
 namespace facebook::velox::exec {
 
@@ -34,11 +35,21 @@ class HashPartitionFunction : public core::PartitionFunction {
       override;
 
  private:
+  // Sets 'partitions' from the distinct values of the only key if it is
+  // constant or a dictionary over fewer values than the rows of 'input'.
+  // Returns false if the key is not encoded so.
+  bool partitionDistinct(
+      const RowVector& input,
+      std::vector<uint32_t>& partitions);
+
   const int numPartitions_;
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
 
   // Reusable memory.
   SelectivityVector rows_;
   raw_vector<uint64_t> hashes_;
+  DecodedVector decoded_;
+  SelectivityVector baseRows_;
+  std::vector<uint32_t> basePartitions_;
 };
 } // namespace facebook::velox::exec
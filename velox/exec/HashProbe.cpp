@@ -24,11 +24,12 @@ namespace facebook::velox::exec {
 namespace {
 
 // Returns the type for the hash table row. Build side keys first,
-// then dependent build side columns.
+// then dependent build side columns unless 'keysOnly' is true.
 std::shared_ptr<const RowType> makeTableType(
     const RowType* type,
     const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
-        keys) {
+        keys,
+    bool keysOnly) {
   std::vector<std::string> names;
   std::vector<TypePtr> types;
   std::unordered_set<column_index_t> keyChannels(keys.size());
@@ -40,7 +41,7 @@ std::shared_ptr<const RowType> makeTableType(
     types.emplace_back(type->childAt(channel));
     keyChannels.insert(channel);
   }
-  for (auto i = 0; i < type->size(); ++i) {
+  for (auto i = 0; i < type->size() && !keysOnly; ++i) {
     if (keyChannels.find(i) == keyChannels.end()) {
       names.emplace_back(type->nameOf(i));
       types.emplace_back(type->childAt(i));
@@ -48,6 +49,21 @@ std::shared_ptr<const RowType> makeTableType(
   }
   return std::make_shared<RowType>(std::move(names), std::move(types));
 }
+
+// Returns 'input' with all children loaded. Spilling serializes the children
+// and buffered input outlives the batch of its producer, which require them
+// to be loaded.
+RowVectorPtr loadedRowVector(
+    const RowVectorPtr& input,
+    memory::MemoryPool* pool) {
+  std::vector<VectorPtr> children;
+  children.reserve(input->childrenSize());
+  for (auto& child : input->children()) {
+    children.push_back(BaseVector::loadedVectorShared(child));
+  }
+  return std::make_shared<RowVector>(
+      pool, input->type(), nullptr, input->size(), std::move(children));
+}
 } // namespace
 
 HashProbe::HashProbe(
@@ -60,10 +76,15 @@ HashProbe::HashProbe(
           operatorId,
           joinNode->id(),
           "HashProbe"),
-      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
+      outputBatchSize_{outputBatchRows()},
+      joinNode_(joinNode),
       joinType_{joinNode->joinType()},
       filterResult_(1),
-      outputRows_(outputBatchSize_) {
+      outputRows_(outputBatchSize_),
+      canSwap_(canSwapJoinSides(*joinNode, driverCtx->queryConfig())),
+      maxBufferedRows_(driverCtx->queryConfig().hashJoinSwapMaxProbeRows()),
+      spillCompression_(
+          spillCodecType(driverCtx->queryConfig().spillCompressionCodec())) {
   auto probeType = joinNode->sources()[0]->outputType();
   auto numKeys = joinNode->leftKeys().size();
   keyChannels_.reserve(numKeys);
@@ -76,9 +97,10 @@ HashProbe::HashProbe(
   }
   lookup_ = std::make_unique<HashLookup>(hashers_);
   auto buildType = joinNode->sources()[1]->outputType();
-  auto tableType = makeTableType(buildType.get(), joinNode->rightKeys());
+  tableType_ = makeTableType(
+      buildType.get(), joinNode->rightKeys(), isKeyOnlyJoin(*joinNode));
   if (joinNode->filter()) {
-    initializeFilter(joinNode->filter(), probeType, tableType);
+    initializeFilter(joinNode->filter(), probeType, tableType_);
   }
 
   size_t countIdentityProjection = 0;
@@ -94,7 +116,7 @@ HashProbe::HashProbe(
   }
 
   for (column_index_t i = 0; i < outputType_->size(); ++i) {
-    auto tableChannel = tableType->getChildIdxIfExists(outputType_->nameOf(i));
+    auto tableChannel = tableType_->getChildIdxIfExists(outputType_->nameOf(i));
     if (tableChannel.has_value()) {
       tableResultProjections_.emplace_back(tableChannel.value(), i);
     }
@@ -146,10 +168,36 @@ void HashProbe::initializeFilter(
 }
 
 BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
+  if (spillInputFuture_.valid()) {
+    *future = std::move(spillInputFuture_);
+    return BlockingReason::kWaitForJoinBuild;
+  }
+
   if (table_) {
     return BlockingReason::kNotBlocked;
   }
 
+  if (canSwap_ && !inputReported_) {
+    if (!swapBridge_) {
+      swapBridge_ = operatorCtx_->task()->getHashJoinBridge(
+          operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+    }
+    // Input that may get dynamic filters from the table is not taken before
+    // the table.
+    if (!collectingInput_) {
+      auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
+          this, keyChannels_);
+      if (channels.empty()) {
+        collectingInput_ = true;
+      } else {
+        reportInput(false);
+      }
+    }
+    if (collectingInput_) {
+      return BlockingReason::kNotBlocked;
+    }
+  }
+
   auto hashBuildResult =
       operatorCtx_->task()
           ->getHashJoinBridge(
@@ -159,34 +207,49 @@ BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
     return BlockingReason::kWaitForJoinBuild;
   }
 
-  if (hashBuildResult->antiJoinHasNullKeys) {
+  if (hashBuildResult->swapped) {
+    setupSwappedJoin(hashBuildResult->table);
+  } else if (hashBuildResult->antiJoinHasNullKeys) {
     // Anti join with null keys on the build side always returns nothing.
     VELOX_CHECK(isAntiJoin(joinType_));
     finished_ = true;
   } else {
     table_ = hashBuildResult->table;
-    if (table_->numDistinct() == 0) {
+    spilledPartitions_ = std::move(hashBuildResult->spilledPartitions);
+    if (!spilledPartitions_.empty()) {
+      // The rows of the spilled partitions are not in 'table_'. The join can
+      // neither finish early on an empty 'table_' nor push down filters made
+      // from it.
+      isSpilledPartition_.resize(
+          HashJoinSpillPartition::bitRange(HashJoinSpillPartition::kStartBit)
+              .numPartitions());
+      for (auto partition : spilledPartitions_) {
+        isSpilledPartition_[partition] = true;
+      }
+    } else if (table_->numDistinct() == 0) {
       // Build side is empty. Inner, right and semi joins return nothing in this
       // case, hence, we can terminate the pipeline early.
       if (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_) ||
           isRightJoin(joinType_)) {
         finished_ = true;
       }
-    } else if (
-        (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_)) &&
-        table_->hashMode() != BaseHashTable::HashMode::kHash) {
+    } else if (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_)) {
       // Find out whether there are any upstream operators that can accept
       // dynamic filters on all or a subset of the join keys. Create dynamic
-      // filters to push down.
-      const auto& buildHashers = table_->hashers();
+      // filters to push down. The keys without an exact filter from
+      // 'table_' get the BloomFilter made by HashBuild, if any.
+      auto filters = makeJoinKeyFilters(*hashBuildResult);
       auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
           this, keyChannels_);
-      for (auto i = 0; i < keyChannels_.size(); i++) {
-        if (channels.find(keyChannels_[i]) != channels.end()) {
-          if (auto filter = buildHashers[i]->getFilter(false)) {
-            dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
-          }
+      for (auto i = 0; i < filters.size(); i++) {
+        if (!filters[i] ||
+            channels.find(keyChannels_[i]) == channels.end()) {
+          continue;
+        }
+        if (filters[i]->kind() == common::FilterKind::kBigintBloomFilter) {
+          hasBloomFilter_ = true;
         }
+        dynamicFilters_.emplace(keyChannels_[i], std::move(filters[i]));
       }
     }
   }
@@ -198,16 +261,126 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
+  //  * build side has no dependent columns,
+  //  * the filter is exact.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
-      tableResultProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
+      tableResultProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
+      !hasBloomFilter_) {
     canReplaceWithDynamicFilter_ = true;
   }
 
   Operator::clearDynamicFilters();
 }
 
+void HashProbe::close() {
+  // The last HashBuild waits for all HashProbes to report their input.
+  if (swapBridge_ && !inputReported_) {
+    reportInput(false);
+  }
+  Operator::close();
+}
+
+void HashProbe::reportInput(bool complete) {
+  collectingInput_ = false;
+  inputReported_ = true;
+  if (!swapBridge_) {
+    swapBridge_ = operatorCtx_->task()->getHashJoinBridge(
+        operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+  }
+  swapBridge_->addProbeInput(
+      complete ? bufferedInput_ : std::vector<RowVectorPtr>{},
+      complete,
+      operatorCtx_->task()->numDrivers(
+          operatorCtx_->driverCtx()->pipelineId));
+}
+
+void HashProbe::setupSwappedJoin(std::shared_ptr<BaseHashTable> table) {
+  stats_.addRuntimeStat("hashJoinSwapped", RuntimeCounter(1));
+  swapped_ = true;
+  table_ = std::move(table);
+  bufferedInput_.clear();
+  nextBufferedInput_ = 0;
+  if (table_->numDistinct() == 0) {
+    // Probe side is empty.
+    finished_ = true;
+    return;
+  }
+
+  // The input is now build side rows and the table has the probe side rows,
+  // keys first.
+  const auto numKeys = keyChannels_.size();
+  for (auto i = 0; i < numKeys; ++i) {
+    keyChannels_[i] = i;
+    hashers_[i] = std::make_unique<VectorHasher>(tableType_->childAt(i), i);
+  }
+  lookup_ = std::make_unique<HashLookup>(hashers_);
+  scratchMemory_.clear();
+
+  auto probeTableType = makeTableType(
+      joinNode_->sources()[0]->outputType().get(),
+      joinNode_->leftKeys(),
+      false);
+  identityProjections_.clear();
+  tableResultProjections_.clear();
+  isIdentityProjection_ = false;
+  for (column_index_t i = 0; i < outputType_->size(); ++i) {
+    const auto& name = outputType_->nameOf(i);
+    auto buildChannel = tableType_->getChildIdxIfExists(name);
+    if (buildChannel.has_value()) {
+      identityProjections_.emplace_back(buildChannel.value(), i);
+      continue;
+    }
+    auto probeChannel = probeTableType->getChildIdxIfExists(name);
+    if (probeChannel.has_value()) {
+      tableResultProjections_.emplace_back(probeChannel.value(), i);
+    }
+  }
+}
+
+bool HashProbe::nextSwappedInput() {
+  for (;;) {
+    if (!swappedBuildTable_) {
+      swappedBuildTable_ = swapBridge_->nextSwappedBuildTable();
+      if (!swappedBuildTable_) {
+        return false;
+      }
+      swappedBuildIterator_.reset();
+    }
+    auto* rows = swappedBuildTable_->rows();
+    swappedBuildRows_.resize(outputBatchSize_);
+    auto numRows = rows->listRows(
+        &swappedBuildIterator_, outputBatchSize_, swappedBuildRows_.data());
+    if (!numRows) {
+      swappedBuildTable_ = nullptr;
+      continue;
+    }
+    auto batch = BaseVector::create<RowVector>(tableType_, numRows, pool());
+    for (auto i = 0; i < tableType_->size(); ++i) {
+      rows->extractColumn(
+          swappedBuildRows_.data(), numRows, i, batch->childAt(i));
+    }
+    addInput(std::move(batch));
+    if (input_) {
+      return true;
+    }
+  }
+}
+
 void HashProbe::addInput(RowVectorPtr input) {
+  if (collectingInput_) {
+    numBufferedRows_ += input->size();
+    bufferedInput_.push_back(loadedRowVector(input, pool()));
+    if (numBufferedRows_ > maxBufferedRows_) {
+      reportInput(false);
+    }
+    return;
+  }
+  if (!spilledPartitions_.empty() && !probingSpill_) {
+    input = spillInput(std::move(input));
+    if (!input) {
+      return;
+    }
+  }
   input_ = std::move(input);
 
   if (canReplaceWithDynamicFilter_) {
@@ -216,6 +389,12 @@ void HashProbe::addInput(RowVectorPtr input) {
   }
 
   if (table_->numDistinct() == 0) {
+    if (!spilledPartitions_.empty() &&
+        (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_))) {
+      // The build side rows that did not spill are all in spilled partitions.
+      input_ = nullptr;
+      return;
+    }
     // Build side is empty. This state is valid only for anti, left and full
     // joins.
     VELOX_CHECK(
@@ -233,11 +412,12 @@ void HashProbe::addInput(RowVectorPtr input) {
   lookup_->hashes.resize(input_->size());
   auto mode = table_->hashMode();
   auto& buildHashers = table_->hashers();
+  scratchMemory_.resize(keyChannels_.size());
   for (auto i = 0; i < keyChannels_.size(); ++i) {
     auto key = input_->childAt(keyChannels_[i])->loadedVector();
     if (mode != BaseHashTable::HashMode::kHash) {
       buildHashers[i]->lookupValueIds(
-          *key, activeRows_, scratchMemory_, lookup_->hashes);
+          *key, activeRows_, scratchMemory_[i], lookup_->hashes);
     } else {
       hashers_[i]->hash(*key, activeRows_, i > 0, lookup_->hashes);
     }
@@ -287,19 +467,21 @@ void HashProbe::addInput(RowVectorPtr input) {
 
 namespace {
 // Copy values from 'rows' of 'table' according to 'projections' in
-// 'result'. Reuses 'result' children where possible.
+// 'result'. Reuses 'result' children where possible. Otherwise takes vectors
+// from the vector pool of 'execCtx'.
 void extractColumns(
     BaseHashTable* table,
     folly::Range<char**> rows,
     folly::Range<const IdentityProjection*> projections,
-    memory::MemoryPool* pool,
+    core::ExecCtx* execCtx,
     const RowVectorPtr& result) {
   for (auto projection : projections) {
     auto& child = result->childAt(projection.outputChannel);
     // TODO: Consider reuse of complex types.
     if (!child || !BaseVector::isReusableFlatVector(child)) {
-      child = BaseVector::create(
-          result->type()->childAt(projection.outputChannel), rows.size(), pool);
+      execCtx->releaseVector(std::move(child));
+      child = execCtx->getVector(
+          result->type()->childAt(projection.outputChannel), rows.size());
     }
     child->resize(rows.size());
     table->rows()->extractColumn(
@@ -324,14 +506,26 @@ void HashProbe::prepareOutput(vector_size_t size) {
   // We expect output vectors containing probe-side data to be null (reset in
   // clearIdentityProjectedOutput). BaseVector::prepareForReuse keeps null
   // children unmodified and makes non-null (build side) children reusable.
-  if (output_) {
+  if (output_ && output_.unique()) {
     VectorPtr output = std::move(output_);
     BaseVector::prepareForReuse(output, size);
     output_ = std::static_pointer_cast<RowVector>(output);
-  } else {
-    output_ = std::static_pointer_cast<RowVector>(
-        BaseVector::create(outputType_, size, pool()));
+    return;
   }
+  if (output_) {
+    // The consumer still references 'output_'. Its build side children come
+    // back through the vector pool when the consumer is done with them.
+    for (auto& child : output_->children()) {
+      operatorCtx_->execCtx()->releaseVector(child);
+    }
+  }
+  // The children are set by fillOutput() or getNonMatchingOutputForRightJoin().
+  output_ = std::make_shared<RowVector>(
+      pool(),
+      outputType_,
+      BufferPtr(nullptr),
+      size,
+      std::vector<VectorPtr>(outputType_->size()));
 }
 
 void HashProbe::fillOutput(vector_size_t size) {
@@ -351,7 +545,7 @@ void HashProbe::fillOutput(vector_size_t size) {
       table_.get(),
       folly::Range<char**>(outputRows_.data(), size),
       tableResultProjections_,
-      pool(),
+      operatorCtx_->execCtx(),
       output_);
 }
 
@@ -382,8 +576,9 @@ RowVectorPtr HashProbe::getNonMatchingOutputForRightJoin() {
       table_.get(),
       folly::Range<char**>(outputRows_.data(), numOut),
       tableResultProjections_,
-      pool(),
+      operatorCtx_->execCtx(),
       output_);
+  outputBatchSize_ = outputBatchRows(averageRowSize(*output_));
   return output_;
 }
 
@@ -398,6 +593,27 @@ void HashProbe::clearIdentityProjectedOutput() {
 
 RowVectorPtr HashProbe::getOutput() {
   clearIdentityProjectedOutput();
+  if (swapped_) {
+    if (!input_ && !nextSwappedInput()) {
+      finished_ = true;
+      return nullptr;
+    }
+  } else if (table_) {
+    while (!input_ && nextBufferedInput_ < bufferedInput_.size()) {
+      addInput(std::move(bufferedInput_[nextBufferedInput_++]));
+    }
+  }
+  if (!input_ && noMoreInput_ && !spilledPartitions_.empty()) {
+    if (spillInputFuture_.valid()) {
+      return nullptr;
+    }
+    while (!input_) {
+      if (!nextSpillInput()) {
+        finished_ = true;
+        return nullptr;
+      }
+    }
+  }
   if (!input_) {
     if (noMoreInput_ && (isRightJoin(joinType_) || isFullJoin(joinType_))) {
       auto output = getNonMatchingOutputForRightJoin();
@@ -489,6 +705,8 @@ RowVectorPtr HashProbe::getOutput() {
 
     if (isLeftSemiOrAntiJoinNoFilter || emptyBuildSide) {
       input_ = nullptr;
+    } else {
+      outputBatchSize_ = outputBatchRows(averageRowSize(*output_));
     }
     return output_;
   }
@@ -510,7 +728,7 @@ void HashProbe::fillFilterInput(vector_size_t size) {
       table_.get(),
       folly::Range<char**>(outputRows_.data(), size),
       filterBuildInputs_,
-      pool(),
+      operatorCtx_->execCtx(),
       filterInput_);
 }
 
@@ -617,6 +835,14 @@ void HashProbe::ensureLoadedIfNotAtEnd(column_index_t channel) {
 
 void HashProbe::noMoreInput() {
   Operator::noMoreInput();
+  if (canSwap_ && !inputReported_) {
+    reportInput(true);
+    return;
+  }
+  if (!spilledPartitions_.empty()) {
+    finishSpillInput();
+    return;
+  }
   if (isRightJoin(joinType_) || isFullJoin(joinType_)) {
     std::vector<ContinuePromise> promises;
     std::vector<std::shared_ptr<Driver>> peers;
@@ -635,4 +861,341 @@ void HashProbe::noMoreInput() {
 bool HashProbe::isFinished() {
   return finished_;
 }
+
+void HashProbe::computeSpillPartitions(
+    const RowVector& input,
+    std::vector<std::unique_ptr<VectorHasher>>& hashers,
+    const HashBitRange& bits) {
+  const auto numRows = input.size();
+  SelectivityVector rows(numRows);
+  spillHashes_.resize(numRows);
+  for (auto i = 0; i < hashers.size(); ++i) {
+    auto key = input.childAt(hashers[i]->channel())->loadedVector();
+    hashers[i]->hash(*key, rows, i > 0, spillHashes_);
+  }
+  spillRowPartitions_.resize(numRows);
+  const auto numPartitions = bits.numPartitions();
+  for (auto row = 0; row < numRows; ++row) {
+    spillRowPartitions_[row] = bits.partition(spillHashes_[row], numPartitions);
+  }
+}
+
+namespace {
+// Appends the rows of 'input' to the partitions of 'state' given by
+// 'partitions'. Rows with a negative partition are skipped. Consecutive rows
+// of the same partition are written as one range.
+void appendToPartitions(
+    const RowVectorPtr& input,
+    const std::vector<int32_t>& partitions,
+    int32_t numPartitions,
+    SpillState& state) {
+  std::vector<std::vector<IndexRange>> ranges(numPartitions);
+  for (vector_size_t row = 0; row < input->size(); ++row) {
+    auto partition = partitions[row];
+    if (partition < 0) {
+      continue;
+    }
+    auto& partitionRanges = ranges[partition];
+    if (!partitionRanges.empty() &&
+        partitionRanges.back().begin + partitionRanges.back().size == row) {
+      ++partitionRanges.back().size;
+    } else {
+      partitionRanges.push_back(IndexRange{row, 1});
+    }
+  }
+  for (auto partition = 0; partition < numPartitions; ++partition) {
+    auto& partitionRanges = ranges[partition];
+    if (!partitionRanges.empty()) {
+      state.appendToPartition(
+          partition,
+          input,
+          folly::Range<IndexRange*>(
+              partitionRanges.data(), partitionRanges.size()));
+    }
+  }
+}
+} // namespace
+
+RowVectorPtr HashProbe::spillInput(RowVectorPtr input) {
+  auto loaded = loadedRowVector(input, pool());
+  const auto numRows = loaded->size();
+  const auto bits =
+      HashJoinSpillPartition::bitRange(HashJoinSpillPartition::kStartBit);
+  computeSpillPartitions(*loaded, hashers_, bits);
+
+  // Rows with a null key are never spilled since they do not match any build
+  // side row. They are kept for the joins that output them.
+  nonNullRows_.resize(numRows);
+  nonNullRows_.setAll();
+  deselectRowsWithNulls(
+      *loaded, keyChannels_, nonNullRows_, *operatorCtx_->execCtx());
+
+  auto indices = allocateIndices(numRows, pool());
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  vector_size_t numKept = 0;
+  vector_size_t numSpilled = 0;
+  for (auto row = 0; row < numRows; ++row) {
+    auto& partition = spillRowPartitions_[row];
+    if (nonNullRows_.isValid(row) && isSpilledPartition_[partition]) {
+      ++numSpilled;
+    } else {
+      partition = -1;
+      rawIndices[numKept++] = row;
+    }
+  }
+  if (numSpilled == 0) {
+    return loaded;
+  }
+
+  if (!spillState_) {
+    spillState_ = std::make_unique<SpillState>(
+        operatorCtx_->makeSpillPath().value() + "-probe",
+        bits.numPartitions(),
+        0,
+        kSpillFileSize,
+        Spiller::spillPool(),
+        Spiller::spillMappedMemory(),
+        std::vector<CompareFlags>{},
+        spillCompression_,
+        nullptr,
+        operatorCtx_->spillDirectories());
+  }
+  appendToPartitions(
+      loaded, spillRowPartitions_, bits.numPartitions(), *spillState_);
+  numSpilledRows_ += numSpilled;
+
+  if (numKept == 0) {
+    return nullptr;
+  }
+  return wrap(numKept, indices, loaded);
+}
+
+void HashProbe::finishSpillInput() {
+  auto bridge = operatorCtx_->task()->getHashJoinBridge(
+      operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+  if (spillState_) {
+    stats_.spilledBytes += spillState_->spilledBytes();
+    stats_.spilledRows += numSpilledRows_;
+    for (const auto& [directory, stats] : spillState_->directoryStats()) {
+      stats_.spillDirectoryStats[directory].add(stats);
+    }
+    for (auto partition : spilledPartitions_) {
+      if (spillState_->hasFiles(partition)) {
+        bridge->addProbeSpillFiles(
+            partition, spillState_->takeFiles(partition));
+      }
+    }
+    spillState_.reset();
+  }
+
+  // The spilled partitions are probed once all HashProbes have handed over
+  // their spilled input. The last one to finish wakes up the others.
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(),
+          operatorCtx_->driver(),
+          &spillInputFuture_,
+          promises,
+          peers)) {
+    return;
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+bool HashProbe::nextSpillInput() {
+  probingSpill_ = true;
+  for (;;) {
+    if (spillPartition_.has_value()) {
+      auto& files = spillPartition_->probeFiles;
+      while (spillProbeFileIndex_ < files.size()) {
+        auto& file = files[spillProbeFileIndex_];
+        if (auto batch = file->readBatch()) {
+          addInput(std::move(batch));
+          return true;
+        }
+        file.reset();
+        if (++spillProbeFileIndex_ < files.size()) {
+          files[spillProbeFileIndex_]->startRead();
+        }
+      }
+      spillPartition_.reset();
+    }
+
+    std::optional<HashJoinSpillPartition> partition;
+    if (!pendingSpillPartitions_.empty()) {
+      partition = std::move(pendingSpillPartitions_.back());
+      pendingSpillPartitions_.pop_back();
+    } else {
+      partition = operatorCtx_->task()
+                      ->getHashJoinBridge(
+                          operatorCtx_->driverCtx()->splitGroupId,
+                          planNodeId())
+                      ->nextSpillPartition();
+    }
+    if (!partition.has_value()) {
+      return false;
+    }
+    if (partition->probeFiles.empty() || !buildSpillPartition(*partition)) {
+      continue;
+    }
+    spillPartition_ = std::move(partition);
+    spillProbeFileIndex_ = 0;
+    spillPartition_->probeFiles[0]->startRead();
+  }
+}
+
+bool HashProbe::buildSpillPartition(HashJoinSpillPartition& partition) {
+  uint64_t buildBytes = 0;
+  for (const auto& file : partition.buildFiles) {
+    buildBytes += file->size();
+  }
+  const auto level =
+      (partition.nextBitOffset - HashJoinSpillPartition::kStartBit) /
+      HashJoinSpillPartition::kNumPartitionBits;
+  if (level < HashJoinSpillPartition::kMaxLevels) {
+    // The rows and the hash table take about twice the serialized size.
+    auto tracker = operatorCtx_->mappedMemory()->tracker();
+    if (tracker && tracker->getAvailableReservation() < 2 * buildBytes &&
+        !tracker->maybeReserve(2 * buildBytes)) {
+      repartition(partition);
+      return false;
+    }
+  }
+
+  const auto numKeys = hashers_.size();
+  std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+  keyHashers.reserve(numKeys);
+  for (auto i = 0; i < numKeys; ++i) {
+    keyHashers.push_back(
+        std::make_unique<VectorHasher>(tableType_->childAt(i), i));
+  }
+  std::vector<TypePtr> dependentTypes;
+  std::vector<column_index_t> dependentChannels;
+  std::vector<std::unique_ptr<DecodedVector>> decoders;
+  for (auto i = numKeys; i < tableType_->size(); ++i) {
+    dependentTypes.push_back(tableType_->childAt(i));
+    dependentChannels.push_back(i);
+    decoders.push_back(std::make_unique<DecodedVector>());
+  }
+  auto table = createJoinTable(
+      *joinNode_,
+      std::move(keyHashers),
+      dependentTypes,
+      operatorCtx_->mappedMemory(),
+      operatorCtx_->driverCtx()->queryConfig());
+
+  bool analyzeKeys = table->hashMode() != BaseHashTable::HashMode::kHash;
+  raw_vector<uint64_t> hashes;
+  SelectivityVector rows;
+  for (auto& file : partition.buildFiles) {
+    file->startRead();
+    while (auto batch = file->readBatch()) {
+      rows.resize(batch->size());
+      rows.setAll();
+      storeJoinBuildRows(
+          *table,
+          *batch,
+          rows,
+          dependentChannels,
+          decoders,
+          analyzeKeys,
+          hashes);
+    }
+    file.reset();
+  }
+  partition.buildFiles.clear();
+
+  table->prepareJoinTable({});
+  if (table->numDistinct() == 0 &&
+      (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_))) {
+    // No probe side row of 'partition' can match.
+    return false;
+  }
+  table_ = std::move(table);
+  scratchMemory_.clear();
+  lookup_ = std::make_unique<HashLookup>(hashers_);
+  return true;
+}
+
+void HashProbe::repartition(HashJoinSpillPartition& partition) {
+  const auto bits = HashJoinSpillPartition::bitRange(partition.nextBitOffset);
+  const auto numPartitions = bits.numPartitions();
+  const auto path = fmt::format(
+      "{}-{}-{}",
+      operatorCtx_->makeSpillPath().value(),
+      partition.nextBitOffset,
+      partition.partition);
+  const auto spillDirectories = operatorCtx_->spillDirectories();
+  SpillState buildState(
+      path + "-build",
+      numPartitions,
+      0,
+      kSpillFileSize,
+      Spiller::spillPool(),
+      Spiller::spillMappedMemory(),
+      std::vector<CompareFlags>{},
+      spillCompression_,
+      nullptr,
+      spillDirectories);
+  SpillState probeState(
+      path + "-probe",
+      numPartitions,
+      0,
+      kSpillFileSize,
+      Spiller::spillPool(),
+      Spiller::spillMappedMemory(),
+      std::vector<CompareFlags>{},
+      spillCompression_,
+      nullptr,
+      spillDirectories);
+
+  if (buildSpillHashers_.empty()) {
+    for (auto i = 0; i < hashers_.size(); ++i) {
+      buildSpillHashers_.push_back(
+          std::make_unique<VectorHasher>(tableType_->childAt(i), i));
+    }
+  }
+  repartitionFiles(partition.buildFiles, buildSpillHashers_, bits, buildState);
+  repartitionFiles(partition.probeFiles, hashers_, bits, probeState);
+  for (const auto* state : {&buildState, &probeState}) {
+    for (const auto& [directory, stats] : state->directoryStats()) {
+      stats_.spillDirectoryStats[directory].add(stats);
+    }
+  }
+
+  for (auto i = 0; i < numPartitions; ++i) {
+    if (!probeState.hasFiles(i)) {
+      continue;
+    }
+    HashJoinSpillPartition subPartition;
+    subPartition.partition = i;
+    subPartition.nextBitOffset =
+        partition.nextBitOffset + HashJoinSpillPartition::kNumPartitionBits;
+    if (buildState.hasFiles(i)) {
+      subPartition.buildFiles = buildState.takeFiles(i);
+    }
+    subPartition.probeFiles = probeState.takeFiles(i);
+    pendingSpillPartitions_.push_back(std::move(subPartition));
+  }
+}
+
+void HashProbe::repartitionFiles(
+    std::vector<std::unique_ptr<SpillFile>>& files,
+    std::vector<std::unique_ptr<VectorHasher>>& hashers,
+    const HashBitRange& bits,
+    SpillState& state) {
+  for (auto& file : files) {
+    file->startRead();
+    while (auto batch = file->readBatch()) {
+      computeSpillPartitions(*batch, hashers, bits);
+      appendToPartitions(
+          batch, spillRowPartitions_, bits.numPartitions(), state);
+    }
+    file.reset();
+  }
+  files.clear();
+}
 } // namespace facebook::velox::exec
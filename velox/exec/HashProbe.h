@@ -22,7 +22,17 @@
 
 namespace facebook::velox::exec {
 
-// Probes a hash table made by HashBuild.
+// Probes a hash table made by HashBuild. If the build side spilled, the probe
+// input rows of the spilled partitions are spilled too. Once all input is
+// received, the HashProbes of the pipeline take turns building a hash table
+// from the build side of a spilled partition and probing it with the spilled
+// probe input of the same partition.
+//
+// If the join sides may be swapped, see canSwapJoinSides(), the HashProbes
+// buffer their input before the table is ready and report it to the
+// HashJoinBridge. If the table comes back swapped, it has the probe side rows
+// and the HashProbes probe it with the build side rows. Otherwise the
+// buffered input is probed first.
 class HashProbe : public Operator {
  public:
   HashProbe(
@@ -34,6 +44,12 @@ class HashProbe : public Operator {
     if (finished_ || noMoreInput_ || input_) {
       return false;
     }
+    if (collectingInput_) {
+      return true;
+    }
+    if (nextBufferedInput_ < bufferedInput_.size()) {
+      return false;
+    }
     if (table_) {
       return true;
     }
@@ -54,6 +70,8 @@ class HashProbe : public Operator {
 
   void clearDynamicFilters() override;
 
+  void close() override;
+
  private:
   // Sets up 'filter_' and related members.
   void initializeFilter(
@@ -88,8 +106,70 @@ class HashProbe : public Operator {
 
   void ensureLoadedIfNotAtEnd(column_index_t channel);
 
-  // TODO: Define batch size as bytes based on RowContainer row sizes.
-  const uint32_t outputBatchSize_;
+  // Sets 'spillRowPartitions_' to the partition in 'bits' of each row of
+  // 'input'. The keys are the columns of 'input' given by the channels of
+  // 'hashers'.
+  void computeSpillPartitions(
+      const RowVector& input,
+      std::vector<std::unique_ptr<VectorHasher>>& hashers,
+      const HashBitRange& bits);
+
+  // Spills the rows of 'input' that fall in a spilled partition of the build
+  // side and returns the other rows. Returns nullptr if all rows are spilled.
+  RowVectorPtr spillInput(RowVectorPtr input);
+
+  // Hands over the spilled probe input to the HashJoinBridge and waits for
+  // the other HashProbes of the pipeline to do the same.
+  void finishSpillInput();
+
+  // Sets 'input_' to the next batch of spilled probe input. Builds and
+  // switches to the hash table of the next spilled partition when the probe
+  // input of the current one is consumed. Returns false when all spilled
+  // partitions are done.
+  bool nextSpillInput();
+
+  // Makes 'table_' from the build side of 'partition'. If the build side does
+  // not fit in memory, partitions 'partition' on its next range of hash bits
+  // and adds the results to 'pendingSpillPartitions_'. Returns false if
+  // 'table_' is not made or there is nothing to probe in 'partition'.
+  bool buildSpillPartition(HashJoinSpillPartition& partition);
+
+  // Splits the build and probe side of 'partition' on the next range of hash
+  // bits and adds the non-empty results to 'pendingSpillPartitions_'.
+  void repartition(HashJoinSpillPartition& partition);
+
+  // Writes the content of 'files' to the partitions of 'state' given by
+  // 'bits'. The keys are hashed with 'hashers'. Deletes 'files'.
+  void repartitionFiles(
+      std::vector<std::unique_ptr<SpillFile>>& files,
+      std::vector<std::unique_ptr<VectorHasher>>& hashers,
+      const HashBitRange& bits,
+      SpillState& state);
+
+  // Reports the input buffered so far to the HashJoinBridge and stops
+  // buffering. 'complete' is true if this is all the input.
+  void reportInput(bool complete);
+
+  // Switches to probing 'table', made of the probe side input, with the
+  // build side rows.
+  void setupSwappedJoin(std::shared_ptr<BaseHashTable> table);
+
+  // Sets 'input_' to the next batch of build side rows of a swapped join.
+  // Returns false when all are done.
+  bool nextSwappedInput();
+
+  // Target size of a file of spilled probe input.
+  static constexpr uint64_t kSpillFileSize = 64 << 20;
+
+  // Max number of output rows per batch. Adapted to the width of the output
+  // rows after each batch.
+  uint32_t outputBatchSize_;
+
+  const std::shared_ptr<const core::HashJoinNode> joinNode_;
+
+  // Type of the hash table row: build side keys followed by the dependent
+  // build side columns. This is also the type of the spilled build side rows.
+  RowTypePtr tableType_;
 
   const core::JoinType joinType_;
 
@@ -104,13 +184,19 @@ class HashProbe : public Operator {
   // True if the join became a no-op after pushing down the filter.
   bool replacedWithDynamicFilter_{false};
 
+  // True if a dynamic filter is a BigintBloomFilter. Such a filter passes
+  // values that have no match, so the join cannot be replaced with it.
+  bool hasBloomFilter_{false};
+
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
 
   // Table shared between other HashProbes in other Drivers of the
   // same pipeline.
   std::shared_ptr<BaseHashTable> table_;
 
-  VectorHasher::ScratchMemory scratchMemory_;
+  // Scratch memory for looking up the value ids of each key in 'table_'.
+  // Reset when 'table_' changes.
+  std::vector<VectorHasher::ScratchMemory> scratchMemory_;
 
   // Rows to apply 'filter_' to.
   SelectivityVector filterRows_;
@@ -252,6 +338,77 @@ class HashProbe : public Operator {
   // cases where there is more than one batch of output or join filter
   // input.
   SelectivityVector passingInputRows_;
+
+  // Numbers of the build side partitions that spilled. Empty if the build
+  // side did not spill.
+  std::vector<int32_t> spilledPartitions_;
+
+  // True for the partitions in 'spilledPartitions_'.
+  std::vector<bool> isSpilledPartition_;
+
+  // Spilled probe input. Created on first use.
+  std::unique_ptr<SpillState> spillState_;
+  uint64_t numSpilledRows_{0};
+
+  // Hash number and spill partition of each row of the input being
+  // partitioned.
+  raw_vector<uint64_t> spillHashes_;
+  std::vector<int32_t> spillRowPartitions_;
+
+  // Hashers for the keys of spilled build side rows. Created on first use.
+  std::vector<std::unique_ptr<VectorHasher>> buildSpillHashers_;
+
+  // Future for waiting for the other HashProbes to hand over their spilled
+  // input.
+  ContinueFuture spillInputFuture_{ContinueFuture::makeEmpty()};
+
+  // True once all non-spilled input is probed and 'this' is probing spilled
+  // partitions.
+  bool probingSpill_{false};
+
+  // The spilled partition that 'table_' is made of.
+  std::optional<HashJoinSpillPartition> spillPartition_;
+
+  // Index of the file of 'spillPartition_' being probed.
+  size_t spillProbeFileIndex_{0};
+
+  // Partitions made by partitioning spilled partitions further. These are
+  // probed by 'this' after the current one.
+  std::vector<HashJoinSpillPartition> pendingSpillPartitions_;
+
+  // True if the join sides may be swapped. See canSwapJoinSides().
+  const bool canSwap_;
+
+  // Maximum number of rows in 'bufferedInput_' for a swap.
+  const uint64_t maxBufferedRows_;
+
+  // Codec for the spill files of probe input and of repartitioned spilled
+  // partitions.
+  const folly::io::CodecType spillCompression_;
+
+  // Set on first use if 'canSwap_'.
+  std::shared_ptr<HashJoinBridge> swapBridge_;
+
+  // True while the input goes to 'bufferedInput_'.
+  bool collectingInput_{false};
+
+  // True once 'this' has reported its input to 'swapBridge_'.
+  bool inputReported_{false};
+
+  // Input received before the table. Probed first if the join is not
+  // swapped. 'nextBufferedInput_' is the index of the next batch to probe.
+  std::vector<RowVectorPtr> bufferedInput_;
+  size_t nextBufferedInput_{0};
+  uint64_t numBufferedRows_{0};
+
+  // True if 'table_' is made of the probe side input. 'input_' then has the
+  // build side rows in the layout of 'tableType_'.
+  bool swapped_{false};
+
+  // The build side rows being listed into 'input_' of a swapped join.
+  std::shared_ptr<BaseHashTable> swappedBuildTable_;
+  RowContainerIterator swappedBuildIterator_;
+  std::vector<char*> swappedBuildRows_;
 };
 
 } // namespace facebook::velox::exec
@@ -15,6 +15,8 @@
  */
 
 #include "velox/exec/HashTable.h"
+#include <folly/ScopeGuard.h>
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/common/process/ProcessBase.h"
@@ -40,10 +42,12 @@ HashTable<ignoreNullKeys>::HashTable(
     bool allowDuplicates,
     bool isJoinBuild,
     bool hasProbedFlag,
-    memory::MappedMemory* mappedMemory)
+    memory::MappedMemory* mappedMemory,
+    Layout layout)
     : BaseHashTable(std::move(hashers)),
       aggregates_(aggregates),
-      isJoinBuild_(isJoinBuild) {
+      isJoinBuild_(isJoinBuild),
+      layout_(layout) {
   std::vector<TypePtr> keys;
   for (auto& hasher : hashers_) {
     keys.push_back(hasher->type());
@@ -91,11 +95,14 @@ class ProbeState {
 
   // Use one instruction to load 16 tags
   // Use another instruction to make 16 copies of the tag being searched for
-  inline void
-  preProbe(uint8_t* tags, uint64_t sizeMask, uint64_t hash, int32_t row) {
+  inline void preProbe(
+      const BaseHashTable::Slots& slots,
+      uint64_t sizeMask,
+      uint64_t hash,
+      int32_t row) {
     row_ = row;
     tagIndex_ = tagsByteOffset(hash, sizeMask);
-    tagsInTable_ = BaseHashTable::loadTags(tags, tagIndex_);
+    tagsInTable_ = BaseHashTable::loadTags(slots, tagIndex_);
     auto tag = BaseHashTable::hashTag(hash);
     wantedTags_ = BaseHashTable::TagVector::broadcast(tag);
     group_ = nullptr;
@@ -105,17 +112,16 @@ class ProbeState {
   // Use one instruction to compare the tag being searched for to 16 tags
   // If there is a match, load corresponding data from the table
   template <Operation op = Operation::kProbe>
-  inline void firstProbe(char** table, int32_t firstKey) {
+  inline void firstProbe(const BaseHashTable::Slots& slots, int32_t firstKey) {
     hits_ = simd::toBitMask(tagsInTable_ == wantedTags_);
     if (hits_) {
-      loadNextHit<op>(table, firstKey);
+      loadNextHit<op>(slots, firstKey);
     }
   }
 
   template <Operation op, typename Compare, typename Insert>
   inline char* FOLLY_NULLABLE fullProbe(
-      uint8_t* tags,
-      char** table,
+      const BaseHashTable::Slots& slots,
       uint64_t sizeMask,
       int32_t firstKey,
       Compare compare,
@@ -123,14 +129,14 @@ class ProbeState {
       bool extraCheck = false) {
     if (group_ && compare(group_, row_)) {
       if (op == Operation::kErase) {
-        eraseHit(tags);
+        eraseHit(slots);
       }
       return group_;
     }
 
     auto alreadyChecked = group_;
     if (extraCheck) {
-      tagsInTable_ = BaseHashTable::loadTags(tags, tagIndex_);
+      tagsInTable_ = BaseHashTable::loadTags(slots, tagIndex_);
       hits_ = simd::toBitMask(tagsInTable_ == wantedTags_);
     }
 
@@ -166,18 +172,18 @@ class ProbeState {
           }
         }
       } else {
-        loadNextHit<op>(table, firstKey);
+        loadNextHit<op>(slots, firstKey);
         if (!(extraCheck && group_ == alreadyChecked) &&
             compare(group_, row_)) {
           if (op == Operation::kErase) {
-            eraseHit(tags);
+            eraseHit(slots);
           }
           return group_;
         }
         continue;
       }
       tagIndex_ = (tagIndex_ + sizeof(BaseHashTable::TagVector)) & sizeMask;
-      tagsInTable_ = BaseHashTable::loadTags(tags, tagIndex_);
+      tagsInTable_ = BaseHashTable::loadTags(slots, tagIndex_);
       hits_ = simd::toBitMask(tagsInTable_ == wantedTags_) & kFullMask;
     }
   }
@@ -186,22 +192,24 @@ class ProbeState {
   static constexpr uint8_t kNotSet = 0xff;
 
   template <Operation op>
-  inline void loadNextHit(char** table, int32_t firstKey) {
+  inline void loadNextHit(
+      const BaseHashTable::Slots& slots,
+      int32_t firstKey) {
     int32_t hit = bits::getAndClearLastSetBit(hits_);
 
     if (op == Operation::kErase) {
       indexInTags_ = hit;
     }
-    group_ = BaseHashTable::loadRow(table, tagIndex_ + hit);
+    group_ = BaseHashTable::loadRow(slots, tagIndex_ + hit);
     __builtin_prefetch(group_ + firstKey);
   }
 
-  void eraseHit(uint8_t* tags) {
+  void eraseHit(const BaseHashTable::Slots& slots) {
     const auto kEmptyGroup = BaseHashTable::TagVector::broadcast(0);
     auto empty = simd::toBitMask(tagsInTable_ == kEmptyGroup);
 
     BaseHashTable::storeTag(
-        tags, tagIndex_ + indexInTags_, empty ? 0 : kTombstoneTag);
+        slots, tagIndex_ + indexInTags_, empty ? 0 : kTombstoneTag);
   }
 
   char* group_;
@@ -237,10 +245,13 @@ void HashTable<ignoreNullKeys>::storeRowPointer(
     int32_t index,
     uint64_t hash,
     char* row) {
-  if (hashMode_ != HashMode::kArray) {
-    tags_[index] = hashTag(hash);
+  if (hashMode_ == HashMode::kArray) {
+    table_[index] = row;
+    return;
   }
-  table_[index] = row;
+  const auto slots = this->slots();
+  storeTag(slots, index, hashTag(hash));
+  storeRow(slots, index, row);
 }
 
 template <bool ignoreNullKeys>
@@ -307,8 +318,7 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::fullProbe(
   if (hashMode_ == HashMode::kNormalizedKey) {
     // NOLINT
     lookup.hits[state.row()] = state.fullProbe<op>(
-        tags_,
-        table_,
+        slots(),
         sizeMask_,
         -static_cast<int32_t>(sizeof(normalized_key_t)),
         [&](char* group, int32_t row) INLINE_LAMBDA {
@@ -323,8 +333,7 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::fullProbe(
   }
   // NOLINT
   lookup.hits[state.row()] = state.fullProbe<op>(
-      tags_,
-      table_,
+      slots(),
       sizeMask_,
       0,
       [&](char* group, int32_t row) { return compareKeys(group, lookup, row); },
@@ -369,37 +378,7 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
   if (hashMode_ == HashMode::kNormalizedKey) {
     populateNormalizedKeys(lookup, sizeBits_);
   }
-  ProbeState state1;
-  ProbeState state2;
-  ProbeState state3;
-  ProbeState state4;
-  int32_t probeIndex = 0;
-  int32_t numProbes = lookup.rows.size();
-  auto rows = lookup.rows.data();
-  for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
-    int32_t row = rows[probeIndex];
-    state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    row = rows[probeIndex + 1];
-    state2.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    row = rows[probeIndex + 2];
-    state3.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    row = rows[probeIndex + 3];
-    state4.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    state1.firstProbe<ProbeState::Operation::kInsert>(table_, 0);
-    state2.firstProbe<ProbeState::Operation::kInsert>(table_, 0);
-    state3.firstProbe<ProbeState::Operation::kInsert>(table_, 0);
-    state4.firstProbe<ProbeState::Operation::kInsert>(table_, 0);
-    fullProbe<false>(lookup, state1, false);
-    fullProbe<false>(lookup, state2, true);
-    fullProbe<false>(lookup, state3, true);
-    fullProbe<false>(lookup, state4, true);
-  }
-  for (; probeIndex < numProbes; ++probeIndex) {
-    int32_t row = rows[probeIndex];
-    state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    state1.firstProbe(table_, 0);
-    fullProbe<false>(lookup, state1, false);
-  }
+  bulkProbe<false>(lookup);
   initializeNewGroups(lookup);
 }
 
@@ -468,36 +447,38 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
   if (hashMode_ == HashMode::kNormalizedKey) {
     populateNormalizedKeys(lookup, sizeBits_);
   }
-  int32_t probeIndex = 0;
-  int32_t numProbes = lookup.rows.size();
+  bulkProbe<true>(lookup);
+}
+
+template <bool ignoreNullKeys>
+template <bool isJoin>
+void HashTable<ignoreNullKeys>::bulkProbe(HashLookup& lookup) {
+  constexpr ProbeState::Operation op =
+      isJoin ? ProbeState::Operation::kProbe : ProbeState::Operation::kInsert;
+  const auto slots = this->slots();
+  const auto firstKey = firstKeyOffset();
+  const int32_t numProbes = lookup.rows.size();
   const vector_size_t* rows = lookup.rows.data();
-  ProbeState state1;
-  ProbeState state2;
-  ProbeState state3;
-  ProbeState state4;
-  for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
-    int32_t row = rows[probeIndex];
-    state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    row = rows[probeIndex + 1];
-    state2.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    row = rows[probeIndex + 2];
-    state3.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    row = rows[probeIndex + 3];
-    state4.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    state1.firstProbe(table_, 0);
-    state2.firstProbe(table_, 0);
-    state3.firstProbe(table_, 0);
-    state4.firstProbe(table_, 0);
-    fullProbe<true>(lookup, state1, false);
-    fullProbe<true>(lookup, state2, false);
-    fullProbe<true>(lookup, state3, false);
-    fullProbe<true>(lookup, state4, false);
-  }
-  for (; probeIndex < numProbes; ++probeIndex) {
-    int32_t row = rows[probeIndex];
-    state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
-    state1.firstProbe(table_, 0);
-    fullProbe<true>(lookup, state1, false);
+  const uint64_t* hashes = lookup.hashes.data();
+  ProbeState states[kProbeGroupSize];
+  for (int32_t probeIndex = 0; probeIndex < numProbes;
+       probeIndex += kProbeGroupSize) {
+    const auto groupSize = std::min(kProbeGroupSize, numProbes - probeIndex);
+    const auto* groupRows = rows + probeIndex;
+    for (auto i = 0; i < groupSize; ++i) {
+      prefetchSlots(
+          slots, ProbeState::tagsByteOffset(hashes[groupRows[i]], sizeMask_));
+    }
+    for (auto i = 0; i < groupSize; ++i) {
+      const auto row = groupRows[i];
+      states[i].preProbe(slots, sizeMask_, hashes[row], row);
+      states[i].template firstProbe<op>(slots, firstKey);
+    }
+    // In a group by, a probe may miss a key inserted by an earlier probe of
+    // the group after its tags were loaded. 'extraCheck' reloads the tags.
+    for (auto i = 0; i < groupSize; ++i) {
+      fullProbe<isJoin>(lookup, states[i], !isJoin && i > 0);
+    }
   }
 }
 
@@ -520,17 +501,28 @@ void HashTable<ignoreNullKeys>::allocateTables(uint64_t size) {
     sizeBits_ = __builtin_popcountll(sizeMask_);
     constexpr auto kPageSize = memory::MappedMemory::kPageSize;
     // The total size is 9 bytes per slot, 8 in the pointers table and 1 in the
-    // tags table.
-    auto numPages = bits::roundUp(size * 9, kPageSize) / kPageSize;
+    // tags table, or 8 bytes per slot in buckets of 16 slots.
+    auto numPages =
+        bits::roundUp(size * bytesPerSlot(), kPageSize) / kPageSize;
     if (!rows_->mappedMemory()->allocateContiguous(
             numPages, nullptr, tableAllocation_)) {
       VELOX_FAIL("Could not allocate join/group by hash table");
     }
     table_ = tableAllocation_.data<char*>();
-    tags_ = reinterpret_cast<uint8_t*>(table_ + size);
-    memset(tags_, 0, size_);
-    // Not strictly necessary to clear 'table_' but more debuggable.
-    memset(table_, 0, size_ * sizeof(char*));
+    if (layout_ == Layout::kInterleaved) {
+      // The buckets start at a page boundary and are aligned for loadTags().
+      // There is one bucket per 16 slots.
+      static_assert(
+          sizeof(TagVector) * (1 + kPointerSize) <= kBucketSize,
+          "A bucket must fit 16 tags and their row pointers");
+      tags_ = nullptr;
+      memset(table_, 0, size_ * bytesPerSlot());
+    } else {
+      tags_ = reinterpret_cast<uint8_t*>(table_ + size);
+      memset(tags_, 0, size_);
+      // Not strictly necessary to clear 'table_' but more debuggable.
+      memset(table_, 0, size_ * sizeof(char*));
+    }
   }
 }
 
@@ -541,11 +533,28 @@ void HashTable<ignoreNullKeys>::clear() {
     memset(tags_, 0, size_);
   }
   if (table_) {
+    // Also clears the tags in the buckets of a kInterleaved table, which has
+    // 8 bytes per slot.
     memset(table_, 0, sizeof(char*) * size_);
   }
   numDistinct_ = 0;
 }
 
+template <bool ignoreNullKeys>
+int64_t HashTable<ignoreNullKeys>::freeTable() {
+  const int64_t freedBytes = tableAllocation_.numPages() *
+      memory::MappedMemory::kPageSize;
+  if (tableAllocation_.data()) {
+    rows_->mappedMemory()->freeContiguous(tableAllocation_);
+  }
+  table_ = nullptr;
+  tags_ = nullptr;
+  size_ = 0;
+  sizeMask_ = 0;
+  sizeBits_ = 0;
+  return freedBytes;
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::checkSize(int32_t numNew) {
   if (!table_ || !size_) {
@@ -567,7 +576,7 @@ void HashTable<ignoreNullKeys>::checkSize(int32_t numNew) {
 }
 
 template <bool ignoreNullKeys>
-bool HashTable<ignoreNullKeys>::insertBatch(
+bool HashTable<ignoreNullKeys>::hashRows(
     char** groups,
     int32_t numGroups,
     raw_vector<uint64_t>& hashes) {
@@ -591,6 +600,17 @@ bool HashTable<ignoreNullKeys>::insertBatch(
       }
     }
   }
+  return true;
+}
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::insertBatch(
+    char** groups,
+    int32_t numGroups,
+    raw_vector<uint64_t>& hashes) {
+  if (!hashRows(groups, numGroups, hashes)) {
+    return false;
+  }
   if (isJoinBuild_) {
     insertForJoin(groups, hashes.data(), numGroups);
   } else {
@@ -621,10 +641,11 @@ void HashTable<ignoreNullKeys>::insertForGroupBy(
         hashes[i] = mixNormalizedKey(hash, sizeBits_);
       }
     }
+    const auto slots = this->slots();
     for (int32_t i = 0; i < numGroups; ++i) {
       auto hash = hashes[i];
       auto tagIndex = ProbeState::tagsByteOffset(hash, sizeMask_);
-      auto tagsInTable = BaseHashTable::loadTags(tags_, tagIndex);
+      auto tagsInTable = BaseHashTable::loadTags(slots, tagIndex);
       for (;;) {
         MaskType free =
             ~simd::toBitMask(
@@ -636,7 +657,7 @@ void HashTable<ignoreNullKeys>::insertForGroupBy(
           break;
         }
         tagIndex = (tagIndex + sizeof(TagVector)) & sizeMask_;
-        tagsInTable = loadTags(tags_, tagIndex);
+        tagsInTable = loadTags(slots, tagIndex);
       }
     }
   }
@@ -676,8 +697,7 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::buildFullProbe(
     bool extraCheck) {
   if (hashMode_ == HashMode::kNormalizedKey) {
     state.fullProbe<ProbeState::Operation::kInsert>(
-        tags_,
-        table_,
+        slots(),
         sizeMask_,
         -static_cast<int32_t>(sizeof(normalized_key_t)),
         [&](char* group, int32_t /*row*/) {
@@ -697,8 +717,7 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::buildFullProbe(
         extraCheck);
   } else {
     state.fullProbe<ProbeState::Operation::kInsert>(
-        tags_,
-        table_,
+        slots(),
         sizeMask_,
         0,
         [&](char* group, int32_t /*row*/) {
@@ -743,16 +762,219 @@ void HashTable<ignoreNullKeys>::insertForJoin(
     return;
   }
 
+  insertForJoinWithHashes(groups, hashes, numGroups);
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::insertForJoinWithHashes(
+    char** groups,
+    uint64_t* hashes,
+    int32_t numGroups) {
+  const auto slots = this->slots();
   ProbeState state1;
   for (auto i = 0; i < numGroups; ++i) {
-    state1.preProbe(tags_, sizeMask_, hashes[i], i);
-    state1.firstProbe(table_, 0);
+    state1.preProbe(slots, sizeMask_, hashes[i], i);
+    state1.firstProbe(slots, 0);
     buildFullProbe(state1, hashes[i], groups[i], i);
   }
 }
 
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::insertForJoinInRange(
+    char* row,
+    uint64_t hash,
+    int64_t rangeEnd,
+    bool& hasDuplicates) {
+  const auto kEmptyGroup = BaseHashTable::TagVector::broadcast(0);
+  const auto wantedTags = BaseHashTable::TagVector::broadcast(hashTag(hash));
+  int64_t tagIndex = ProbeState::tagsByteOffset(hash, sizeMask_);
+  const auto slots = this->slots();
+  for (;;) {
+    auto tagsInTable = loadTags(slots, tagIndex);
+    MaskType hits = simd::toBitMask(tagsInTable == wantedTags) &
+        ProbeState::kFullMask;
+    while (hits) {
+      char* group =
+          loadRow(slots, tagIndex + bits::getAndClearLastSetBit(hits));
+      bool equal = hashMode_ == HashMode::kNormalizedKey
+          ? RowContainer::normalizedKey(group) ==
+              RowContainer::normalizedKey(row)
+          : compareKeys(group, row);
+      if (equal) {
+        if (nextOffset_) {
+          // Same as pushNext() but keeps 'hasDuplicates_' unchanged since
+          // this runs on multiple threads.
+          hasDuplicates = true;
+          auto previousNext = nextRow(group);
+          nextRow(group) = row;
+          nextRow(row) = previousNext;
+        }
+        return true;
+      }
+    }
+    MaskType empty = simd::toBitMask(tagsInTable == kEmptyGroup) &
+        ProbeState::kFullMask;
+    if (empty) {
+      storeRowPointer(
+          tagIndex + bits::getAndClearLastSetBit(empty), hash, row);
+      return true;
+    }
+    tagIndex += sizeof(TagVector);
+    if (tagIndex >= rangeEnd) {
+      return false;
+    }
+  }
+}
+
+namespace {
+// Runs 'tasks' on 'executor' and waits for all of them to finish. A task
+// that has not started on 'executor' by the time it is waited for runs on
+// the calling thread. Runs all tasks on the calling thread if 'executor' is
+// nullptr. Rethrows the first error.
+void runTasks(
+    folly::Executor* executor,
+    std::vector<std::function<void()>> tasks) {
+  std::vector<std::shared_ptr<AsyncSource<std::exception_ptr>>> sources;
+  sources.reserve(tasks.size());
+  for (auto& task : tasks) {
+    sources.push_back(std::make_shared<AsyncSource<std::exception_ptr>>(
+        [task = std::move(task)]() {
+          try {
+            task();
+            return std::make_unique<std::exception_ptr>();
+          } catch (const std::exception& e) {
+            return std::make_unique<std::exception_ptr>(
+                std::current_exception());
+          }
+        }));
+    if (executor) {
+      executor->add([source = sources.back()]() { source->prepare(); });
+    }
+  }
+  std::exception_ptr error;
+  for (auto& source : sources) {
+    auto result = source->move();
+    if (result && *result && !error) {
+      error = *result;
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+} // namespace
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::canParallelJoinBuild() const {
+  return isJoinBuild_ && buildExecutor_ && !otherTables_.empty() &&
+      hashMode_ != HashMode::kArray && size_ >= kMinParallelBuildSize;
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::parallelJoinBuild() {
+  const auto numTables = otherTables_.size() + 1;
+  const int64_t partitionSize = bits::roundUp(
+      (size_ + numTables - 1) / numTables, sizeof(TagVector));
+  const auto numPartitions = (size_ + partitionSize - 1) / partitionSize;
+
+  // Rows and hashes of each table for each partition.
+  std::vector<std::vector<std::vector<char*>>> tableRows(numTables);
+  std::vector<std::vector<raw_vector<uint64_t>>> tableHashes(numTables);
+  std::vector<uint8_t> hashFailed(numTables, false);
+  std::vector<std::function<void()>> hashTasks;
+  for (auto i = 0; i < numTables; ++i) {
+    hashTasks.push_back([&, i]() {
+      auto* table = i == 0 ? this : otherTables_[i - 1].get();
+      std::vector<char*> rows(table->rows()->numRows());
+      RowContainerIterator iterator;
+      int32_t numRows = 0;
+      while (numRows < rows.size()) {
+        auto numListed = table->rows()->listRows(
+            &iterator, rows.size() - numRows, rows.data() + numRows);
+        if (!numListed) {
+          break;
+        }
+        numRows += numListed;
+      }
+      raw_vector<uint64_t> hashes;
+      hashes.resize(numRows);
+      if (!hashRows(rows.data(), numRows, hashes)) {
+        hashFailed[i] = true;
+        return;
+      }
+      auto& partitionRows = tableRows[i];
+      auto& partitionHashes = tableHashes[i];
+      partitionRows.resize(numPartitions);
+      partitionHashes.resize(numPartitions);
+      for (auto row = 0; row < numRows; ++row) {
+        auto hash = hashes[row];
+        if (hashMode_ == HashMode::kNormalizedKey) {
+          RowContainer::normalizedKey(rows[row]) = hash;
+          hash = mixNormalizedKey(hash, sizeBits_);
+        }
+        auto partition =
+            ProbeState::tagsByteOffset(hash, sizeMask_) / partitionSize;
+        partitionRows[partition].push_back(rows[row]);
+        partitionHashes[partition].push_back(hash);
+      }
+    });
+  }
+  // Value ids are computed with VectorHashers shared by all tables, which
+  // is not thread safe. Only hashing is done in parallel.
+  runTasks(
+      hashMode_ == HashMode::kHash ? buildExecutor_ : nullptr,
+      std::move(hashTasks));
+  for (auto failed : hashFailed) {
+    if (failed) {
+      VELOX_CHECK(hashMode_ != HashMode::kHash);
+      setHashMode(HashMode::kHash, 0);
+      return;
+    }
+  }
+
+  // Rows that do not fit in the range of their partition.
+  std::vector<std::vector<char*>> overflowRows(numPartitions);
+  std::vector<raw_vector<uint64_t>> overflowHashes(numPartitions);
+  std::vector<uint8_t> partitionHasDuplicates(numPartitions, false);
+  std::vector<std::function<void()>> insertTasks;
+  for (auto partition = 0; partition < numPartitions; ++partition) {
+    insertTasks.push_back([&, partition]() {
+      const auto rangeEnd =
+          std::min<int64_t>((partition + 1) * partitionSize, size_);
+      bool hasDuplicates = false;
+      for (auto i = 0; i < numTables; ++i) {
+        auto& rows = tableRows[i][partition];
+        auto& hashes = tableHashes[i][partition];
+        for (auto row = 0; row < rows.size(); ++row) {
+          if (!insertForJoinInRange(
+                  rows[row], hashes[row], rangeEnd, hasDuplicates)) {
+            overflowRows[partition].push_back(rows[row]);
+            overflowHashes[partition].push_back(hashes[row]);
+          }
+        }
+      }
+      partitionHasDuplicates[partition] = hasDuplicates;
+    });
+  }
+  runTasks(buildExecutor_, std::move(insertTasks));
+
+  for (auto partition = 0; partition < numPartitions; ++partition) {
+    if (partitionHasDuplicates[partition]) {
+      hasDuplicates_ = true;
+    }
+    insertForJoinWithHashes(
+        overflowRows[partition].data(),
+        overflowHashes[partition].data(),
+        overflowRows[partition].size());
+  }
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::rehash() {
+  if (canParallelJoinBuild()) {
+    parallelJoinBuild();
+    return;
+  }
   constexpr int32_t kHashBatchSize = 1024;
   // @lint-ignore CLANGTIDY
   raw_vector<uint64_t> hashes;
@@ -1019,8 +1241,11 @@ std::string HashTable<ignoreNullKeys>::toString() {
     // 'size_' and 'table_' may not be set if initializing.
     uint64_t size =
         std::min<uint64_t>(tableAllocation_.size() / sizeof(char*), size_);
+    const auto slots = this->slots();
     for (int32_t i = 0; i < size; ++i) {
-      occupied += table_[i] != nullptr;
+      occupied += hashMode_ == HashMode::kArray
+          ? table_[i] != nullptr
+          : loadRow(slots, i) != nullptr;
     }
   }
   out << "[HashTable  size: " << size_ << " occupied: " << occupied << "]";
@@ -1049,7 +1274,10 @@ bool mayUseValueIds(const BaseHashTable& table) {
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::prepareJoinTable(
-    std::vector<std::unique_ptr<BaseHashTable>> tables) {
+    std::vector<std::unique_ptr<BaseHashTable>> tables,
+    folly::Executor* executor) {
+  buildExecutor_ = executor;
+  auto resetExecutor = folly::makeGuard([&]() { buildExecutor_ = nullptr; });
   otherTables_.reserve(tables.size());
   for (auto& table : tables) {
     otherTables_.emplace_back(std::unique_ptr<HashTable<ignoreNullKeys>>(
@@ -1215,14 +1443,14 @@ void HashTable<ignoreNullKeys>::eraseWithHashes(
       }
     }
 
+    const auto slots = this->slots();
     ProbeState state;
     for (auto i = 0; i < numRows; ++i) {
-      state.preProbe(tags_, sizeMask_, hashes[i], i);
+      state.preProbe(slots, sizeMask_, hashes[i], i);
 
-      state.firstProbe<ProbeState::Operation::kErase>(table_, 0);
+      state.firstProbe<ProbeState::Operation::kErase>(slots, 0);
       state.fullProbe<ProbeState::Operation::kErase>(
-          tags_,
-          table_,
+          slots,
           sizeMask_,
           0,
           [&](const char* group, int32_t row) { return rows[row] == group; },
@@ -64,6 +64,29 @@ class BaseHashTable {
   static constexpr uint64_t kArrayHashMaxSize = 2L << 20;
   enum class HashMode { kHash, kArray, kNormalizedKey };
 
+  /// Layout of the tags and payload row pointers in kHash and kNormalizedKey
+  /// mode. kSeparate keeps the tags and the row pointers in two arrays, so a
+  /// probe that matches a tag loads the row pointer from another cache line.
+  /// kInterleaved keeps the tags of 16 consecutive slots and the low 6 bytes
+  /// of their row pointers in one 128 byte bucket. kArray mode always uses an
+  /// array of row pointers.
+  enum class Layout { kSeparate, kInterleaved };
+
+  /// Number of bytes in a bucket of a kInterleaved table.
+  static constexpr int32_t kBucketSize = 128;
+
+  /// Number of bytes of a row pointer stored in a kInterleaved table.
+  static constexpr int32_t kPointerSize = 6;
+
+  /// Addresses the tag and row pointer of a slot in either layout. Slot i of
+  /// a kInterleaved table is in bucket i / 16. 'tags' is nullptr for
+  /// kInterleaved, where 'table' is the start of the buckets.
+  struct Slots {
+    uint8_t* tags{nullptr};
+    char** table{nullptr};
+    bool interleaved{false};
+  };
+
   // Keeps track of results returned from a join table. One batch of
   // keys can produce multiple batches of results. This is initialized
   // from HashLookup, which is expected to stay constant while 'this'
@@ -133,8 +156,12 @@ class BaseHashTable {
       uint64_t maxBytes,
       char** rows) = 0;
 
+  /// Moves the contents of 'tables' into 'this' and prepares 'this' for use in
+  /// hash join probe. If 'executor' is not null, the rows may be inserted in
+  /// parallel on 'executor'.
   virtual void prepareJoinTable(
-      std::vector<std::unique_ptr<BaseHashTable>> tables) = 0;
+      std::vector<std::unique_ptr<BaseHashTable>> tables,
+      folly::Executor* executor = nullptr) = 0;
 
   /// Returns the memory footprint in bytes for any data structures
   /// owned by 'this'.
@@ -144,6 +171,12 @@ class BaseHashTable {
   /// be used for flushing a partial group by, for example.
   virtual void clear() = 0;
 
+  /// Frees the hash table but keeps the rows, which can still be listed
+  /// from rows(). Used when no more lookups or inserts follow, e.g. when a
+  /// final group by starts producing output. Returns the number of bytes
+  /// freed. No lookups or inserts may follow.
+  virtual int64_t freeTable() = 0;
+
   /// Returns the number of rows in a group by or hash join build
   /// side. This is used for sizing the internal hash table.
   virtual uint64_t numDistinct() const = 0;
@@ -184,10 +217,6 @@ class BaseHashTable {
   /// Returns a brief description for use in debugging.
   virtual std::string toString() = 0;
 
-  static void storeTag(uint8_t* tags, int32_t index, uint8_t tag) {
-    tags[index] = tag;
-  }
-
   const std::vector<std::unique_ptr<VectorHasher>>& hashers() const {
     return hashers_;
   }
@@ -210,17 +239,71 @@ class BaseHashTable {
     return static_cast<uint8_t>(hash >> 32) | 0x80;
   }
 
-  /// Loads a vector of tags for bulk comparison.
-  static TagVector loadTags(uint8_t* tags, int32_t tagIndex) {
-    return TagVector::load_unaligned(tags + tagIndex);
+  /// Loads a vector of tags for bulk comparison. 'tagIndex' is a multiple of
+  /// sizeof(TagVector).
+  static TagVector loadTags(const Slots& slots, int64_t tagIndex) {
+    if (slots.interleaved) {
+      return TagVector::load_aligned(
+          reinterpret_cast<uint8_t*>(bucketAt(slots, tagIndex)));
+    }
+    return TagVector::load_unaligned(slots.tags + tagIndex);
   }
 
   /// Loads the payload row pointer corresponding to the tag at 'index'.
-  static char* loadRow(char** table, int32_t index) {
-    return table[index];
+  static char* loadRow(const Slots& slots, int64_t index) {
+    if (slots.interleaved) {
+      // The 8 byte load ends inside the bucket: 16 + 15 * 6 + 8 < 128.
+      auto word = *reinterpret_cast<const uint64_t*>(pointerAt(slots, index));
+      return reinterpret_cast<char*>(word & kPointerMask);
+    }
+    return slots.table[index];
+  }
+
+  /// Prefetches the tags and row pointers of the slots starting at
+  /// 'tagIndex', a multiple of sizeof(TagVector).
+  static void prefetchSlots(const Slots& slots, int64_t tagIndex) {
+    if (slots.interleaved) {
+      auto* bucket = bucketAt(slots, tagIndex);
+      __builtin_prefetch(bucket);
+      __builtin_prefetch(bucket + kBucketSize / 2);
+    } else {
+      __builtin_prefetch(slots.tags + tagIndex);
+      __builtin_prefetch(slots.table + tagIndex);
+      __builtin_prefetch(slots.table + tagIndex + sizeof(TagVector) / 2);
+    }
+  }
+
+  static void storeTag(const Slots& slots, int64_t index, uint8_t tag) {
+    if (slots.interleaved) {
+      bucketAt(slots, index)[index % sizeof(TagVector)] = tag;
+    } else {
+      slots.tags[index] = tag;
+    }
+  }
+
+  static void storeRow(const Slots& slots, int64_t index, char* row) {
+    if (slots.interleaved) {
+      auto word = reinterpret_cast<uint64_t>(row);
+      VELOX_DCHECK_EQ(word & ~kPointerMask, 0UL);
+      memcpy(pointerAt(slots, index), &word, kPointerSize);
+    } else {
+      slots.table[index] = row;
+    }
   }
 
  protected:
+  static constexpr uint64_t kPointerMask = (1UL << (8 * kPointerSize)) - 1;
+
+  static char* bucketAt(const Slots& slots, int64_t index) {
+    return reinterpret_cast<char*>(slots.table) +
+        (index / sizeof(TagVector)) * kBucketSize;
+  }
+
+  static char* pointerAt(const Slots& slots, int64_t index) {
+    return bucketAt(slots, index) + sizeof(TagVector) +
+        (index % sizeof(TagVector)) * kPointerSize;
+  }
+
   virtual void setHashMode(HashMode mode, int32_t numNew) = 0;
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
   std::unique_ptr<RowContainer> rows_;
@@ -237,7 +320,8 @@ class HashTable : public BaseHashTable {
   // second occurrences of a key are to be silently ignored or will
   // not occur. In this case the row does not need a link to the next
   // match. 'hasProbedFlag' adds an extra bit in every row for tracking rows
-  // that matches join condition for right and full outer joins.
+  // that matches join condition for right and full outer joins. 'layout'
+  // is the layout of the tags and row pointers, see Layout.
   HashTable(
       std::vector<std::unique_ptr<VectorHasher>>&& hashers,
       const std::vector<std::unique_ptr<Aggregate>>& aggregates,
@@ -245,12 +329,14 @@ class HashTable : public BaseHashTable {
       bool allowDuplicates,
       bool isJoinBuild,
       bool hasProbedFlag,
-      memory::MappedMemory* memory);
+      memory::MappedMemory* memory,
+      Layout layout = Layout::kSeparate);
 
   static std::unique_ptr<HashTable> createForAggregation(
       std::vector<std::unique_ptr<VectorHasher>>&& hashers,
       const std::vector<std::unique_ptr<Aggregate>>& aggregates,
-      memory::MappedMemory* memory) {
+      memory::MappedMemory* memory,
+      Layout layout = Layout::kSeparate) {
     return std::make_unique<HashTable>(
         std::move(hashers),
         aggregates,
@@ -258,7 +344,8 @@ class HashTable : public BaseHashTable {
         false, // allowDuplicates
         false, // isJoinBuild
         false, // hasProbedFlag
-        memory);
+        memory,
+        layout);
   }
 
   static std::unique_ptr<HashTable> createForJoin(
@@ -266,7 +353,8 @@ class HashTable : public BaseHashTable {
       const std::vector<TypePtr>& dependentTypes,
       bool allowDuplicates,
       bool hasProbedFlag,
-      memory::MappedMemory* memory) {
+      memory::MappedMemory* memory,
+      Layout layout = Layout::kSeparate) {
     static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
     return std::make_unique<HashTable>(
         std::move(hashers),
@@ -275,7 +363,8 @@ class HashTable : public BaseHashTable {
         allowDuplicates,
         true, // isJoinBuild
         hasProbedFlag,
-        memory);
+        memory,
+        layout);
   }
 
   virtual ~HashTable() override = default;
@@ -298,10 +387,13 @@ class HashTable : public BaseHashTable {
 
   void clear() override;
 
+  int64_t freeTable() override;
+
   int64_t allocatedBytes() const override {
-    // for each row: 1 byte per tag + sizeof(Entry) per table entry + memory
-    // allocated with MappedMemory for fixed-width rows and strings.
-    return (1 + sizeof(char*)) * size_ + rows_->allocatedBytes();
+    // for each row: 1 byte per tag + sizeof(Entry) per table entry, or 8
+    // bytes per slot of a bucket, + memory allocated with MappedMemory for
+    // fixed-width rows and strings.
+    return bytesPerSlot() * size_ + rows_->allocatedBytes();
   }
 
   HashStringAllocator* stringAllocator() override {
@@ -334,21 +426,41 @@ class HashTable : public BaseHashTable {
   // tables are filled, they are combined into one top level table
   // with prepareJoinTable. This then takes ownership of all the data
   // and VectorHashers and decides the hash mode and representation.
+  // If 'executor' is given and the table is large enough, the rows are
+  // inserted in parallel, see parallelJoinBuild().
   void prepareJoinTable(
-      std::vector<std::unique_ptr<BaseHashTable>> tables) override;
+      std::vector<std::unique_ptr<BaseHashTable>> tables,
+      folly::Executor* executor = nullptr) override;
 
   uint64_t hashTableSizeIncrease(int32_t numNewDistinct) const override {
     if (numDistinct_ + numNewDistinct > rehashSize()) {
       // If rehashed, the table adds size_ entries (i.e. doubles),
       // adding one pointer and one tag byte for each new position.
-      return size_ * (sizeof(void*) + 1);
+      return size_ * bytesPerSlot();
     }
     return 0;
   }
 
   std::string toString() override;
 
+  Layout layout() const {
+    return layout_;
+  }
+
  private:
+  // Bytes of tags and row pointers per slot in kHash and kNormalizedKey mode.
+  int64_t bytesPerSlot() const {
+    return layout_ == Layout::kInterleaved
+        ? kBucketSize / sizeof(TagVector)
+        : 1 + sizeof(char*);
+  }
+
+  // Returns the tags and row pointers for use with loadTags(), loadRow(),
+  // storeTag() and storeRow().
+  Slots slots() const {
+    return {tags_, table_, layout_ == Layout::kInterleaved};
+  }
+
   // Returns the number of entries after which the table gets rehashed.
   uint64_t rehashSize() const {
     // This implements the F14 load factor: Resize if less than 1/8 unoccupied.
@@ -382,17 +494,44 @@ class HashTable : public BaseHashTable {
   void clearUseRange(std::vector<bool>& useRange);
 
   void rehash();
+
+  // Returns true if rehash() can insert the rows of a join build in parallel.
+  bool canParallelJoinBuild() const;
+
+  // Inserts the rows of 'this' and 'otherTables_' in parallel on
+  // 'buildExecutor_'. The table is divided into one range of buckets per
+  // build side table. First, the rows of each table are hashed and
+  // assigned to the range of their bucket. Then each range is filled from
+  // the rows assigned to it, by a separate thread. A row whose probe would go
+  // past the end of its range is inserted after all ranges are done.
+  void parallelJoinBuild();
+
+  // Inserts 'row' into the range of tag byte offsets ending at 'rangeEnd'.
+  // Returns false if the probe for 'row' would pass 'rangeEnd'. Sets
+  // 'hasDuplicates' if 'row' is added to an existing entry.
+  bool insertForJoinInRange(
+      char* row,
+      uint64_t hash,
+      int64_t rangeEnd,
+      bool& hasDuplicates);
+
   void initializeNewGroups(HashLookup& lookup);
   void storeKeys(HashLookup& lookup, vector_size_t row);
 
   void storeRowPointer(int32_t index, uint64_t hash, char* row);
 
-  // Allocates new tables for tags and payload pointers. The size must
-  // a power of 2.
+  // Allocates new tables for tags and payload pointers, or buckets for
+  // kInterleaved layout. The size must a power of 2.
   void allocateTables(uint64_t size);
 
   void checkSize(int32_t numNew);
 
+  // Computes hash numbers of the appropriate hash mode for 'groups' and
+  // stores these in 'hashes'. Returns false if a key has no value id in
+  // kArray or kNormalizedKey mode.
+  bool
+  hashRows(char** groups, int32_t numGroups, raw_vector<uint64_t>& hashes);
+
   // Computes hash numbers of the appropriate hash mode for 'groups',
   // stores these in 'hashes' and inserts the groups using
   // insertForJoin or insertForGroupBy.
@@ -405,6 +544,12 @@ class HashTable : public BaseHashTable {
   // group. Duplicate key rows are chained via their next link.
   void insertForJoin(char** groups, uint64_t* hashes, int32_t numGroups);
 
+  // Inserts 'numGroups' entries into a kHash or kNormalizedKey join
+  // table. Unlike insertForJoin(), expects the normalized keys to be
+  // already stored and 'hashes' to be mixed.
+  void
+  insertForJoinWithHashes(char** groups, uint64_t* hashes, int32_t numGroups);
+
   // Inserts 'numGroups' entries into 'this'. 'groups' point to
   // contents in a RowContainer owned by 'this'. 'hashes' are te hash
   // numbers or array indices (if kArray mode) for each
@@ -421,6 +566,23 @@ class HashTable : public BaseHashTable {
   template <bool isJoin>
   void fullProbe(HashLookup& lookup, ProbeState& state, bool extraCheck);
 
+  // Probes 'lookup' in groups of 'kProbeGroupSize' rows. Each stage works on
+  // all rows of a group before the next stage starts, so that the cache
+  // misses of the group overlap: the tags and row pointers are prefetched,
+  // then the tags are compared and the first matching row of each probe is
+  // prefetched, then the keys are compared. Inserts the missing keys in a
+  // group by and returns the first hit in a join probe.
+  template <bool isJoin>
+  void bulkProbe(HashLookup& lookup);
+
+  // Offset of the first key to prefetch from the start of a row. This is
+  // the normalized key below the row in kNormalizedKey mode.
+  int32_t firstKeyOffset() const {
+    return hashMode_ == HashMode::kNormalizedKey
+        ? -static_cast<int32_t>(sizeof(normalized_key_t))
+        : 0;
+  }
+
   // Adds a row to a hash join table in kArray hash mode. Returns true
   // if a new entry was made and false if the row was added to an
   // existing set of rows with the same key.
@@ -460,7 +622,11 @@ class HashTable : public BaseHashTable {
   // Offset of next row link for join build side, 0 if none. Copied
   // from 'rows_'.
   int32_t nextOffset_;
+  const Layout layout_;
+  // Tags for kSeparate layout, nullptr for kInterleaved.
   uint8_t* tags_ = nullptr;
+  // Row pointers in kArray mode or for kSeparate layout, buckets for
+  // kInterleaved layout.
   char** table_ = nullptr;
   memory::MappedMemory::ContiguousAllocation tableAllocation_;
   int64_t size_ = 0;
@@ -470,6 +636,17 @@ class HashTable : public BaseHashTable {
   // Owns the memory of multiple build side hash join tables that are
   // combined into a single probe hash table.
   std::vector<std::unique_ptr<HashTable<ignoreNullKeys>>> otherTables_;
+
+  // Executor for parallelJoinBuild(). Set only during prepareJoinTable().
+  folly::Executor* buildExecutor_{nullptr};
+
+  // Minimum number of entries in a join table for it to be built in
+  // parallel. Smaller tables are built faster on one thread.
+  static constexpr int64_t kMinParallelBuildSize = 1 << 16;
+
+  // Number of rows in a stage of bulkProbe(). Enough for the prefetches of
+  // a group to be in flight together.
+  static constexpr int32_t kProbeGroupSize = 16;
 };
 
 } // namespace facebook::velox::exec
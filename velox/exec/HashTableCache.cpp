@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/HashTableCache.h"
+
+#include <map>
+
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+// Adds the leaves of 'node' to 'scans'. Returns false if a leaf is not a
+// TableScan.
+bool collectTableScans(
+    const core::PlanNode& node,
+    std::vector<const core::TableScanNode*>& scans) {
+  if (node.sources().empty()) {
+    auto scan = dynamic_cast<const core::TableScanNode*>(&node);
+    if (!scan) {
+      return false;
+    }
+    scans.push_back(scan);
+    return true;
+  }
+  for (const auto& source : node.sources()) {
+    if (!collectTableScans(*source, scans)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+HashTableCache::HashTableCache(int64_t capacity)
+    : tracker_(memory::MemoryUsageTracker::create()), capacity_(capacity) {}
+
+// static
+HashTableCache& HashTableCache::instance() {
+  static HashTableCache cache;
+  return cache;
+}
+
+// static
+bool HashTableCache::isCached(
+    const core::HashJoinNode& joinNode,
+    const core::QueryConfig& config) {
+  if (joinNode.isRightJoin() || joinNode.isFullJoin()) {
+    return false;
+  }
+  return isPlanNodeIdListed(config.hashTableCacheJoinIds(), joinNode.id());
+}
+
+// static
+std::optional<std::string> HashTableCache::key(
+    const core::HashJoinNode& joinNode,
+    Task& task,
+    uint32_t splitGroupId) {
+  const auto& buildSide = joinNode.sources()[1];
+  std::vector<const core::TableScanNode*> scans;
+  if (!collectTableScans(*buildSide, scans)) {
+    return std::nullopt;
+  }
+  std::stringstream key;
+  key << core::joinTypeName(joinNode.joinType()) << " join on";
+  for (const auto& buildKey : joinNode.rightKeys()) {
+    key << " " << buildKey->name();
+  }
+  if (isKeyOnlyJoin(joinNode)) {
+    key << " keys only";
+  }
+  key << std::endl << buildSide->toString(true, true);
+  for (const auto* scan : scans) {
+    key << "scan " << scan->tableHandle()->connectorId() << ":";
+    // The assignments are in an unordered map.
+    std::map<std::string, std::string> columns;
+    for (const auto& [name, column] : scan->assignments()) {
+      auto columnName = column->toString();
+      if (columnName.empty()) {
+        return std::nullopt;
+      }
+      columns[name] = std::move(columnName);
+    }
+    for (const auto& [name, column] : columns) {
+      key << " " << name << "=" << column;
+    }
+    auto splits = task.pendingSplitsIfComplete(splitGroupId, scan->id());
+    if (!splits.has_value()) {
+      return std::nullopt;
+    }
+    std::vector<std::string> versions;
+    versions.reserve(splits->size());
+    for (const auto& split : splits.value()) {
+      auto version = split->dataVersion();
+      if (!version.has_value()) {
+        return std::nullopt;
+      }
+      versions.push_back(std::move(version.value()));
+    }
+    // The order of the splits does not change the table.
+    std::sort(versions.begin(), versions.end());
+    key << std::endl;
+    for (const auto& version : versions) {
+      key << "  " << version << std::endl;
+    }
+  }
+  return key.str();
+}
+
+std::optional<HashJoinBridge::HashBuildResult> HashTableCache::find(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return std::nullopt;
+  }
+  auto& entry = it->second;
+  lru_.splice(lru_.begin(), lru_, entry.lruPosition);
+  return HashJoinBridge::HashBuildResult{
+      entry.table, entry.antiJoinHasNullKeys, {}, entry.keyBloomFilters};
+}
+
+void HashTableCache::put(
+    const std::string& key,
+    std::shared_ptr<BaseHashTable> table,
+    std::vector<std::shared_ptr<common::Filter>> keyBloomFilters,
+    std::shared_ptr<Task> task) {
+  const int64_t bytes = key.size() + (table ? table->allocatedBytes() : 0);
+  std::lock_guard<std::mutex> l(mutex_);
+  if (bytes > capacity_ || entries_.count(key)) {
+    return;
+  }
+  evictLocked(capacity_ - bytes);
+  Entry entry;
+  entry.antiJoinHasNullKeys = table == nullptr;
+  if (table) {
+    entry.table = retainTaskWithTable(std::move(table), std::move(task));
+  }
+  entry.keyBloomFilters = std::move(keyBloomFilters);
+  entry.bytes = bytes;
+  lru_.push_front(key);
+  entry.lruPosition = lru_.begin();
+  entries_.emplace(key, std::move(entry));
+  cachedBytes_ += bytes;
+  tracker_->update(bytes);
+}
+
+void HashTableCache::evictLocked(int64_t maxBytes) {
+  while (cachedBytes_ > maxBytes && !lru_.empty()) {
+    auto it = entries_.find(lru_.back());
+    VELOX_CHECK(it != entries_.end());
+    cachedBytes_ -= it->second.bytes;
+    tracker_->update(-it->second.bytes);
+    entries_.erase(it);
+    lru_.pop_back();
+  }
+}
+
+void HashTableCache::setCapacity(int64_t capacity) {
+  std::lock_guard<std::mutex> l(mutex_);
+  capacity_ = capacity;
+  evictLocked(capacity_);
+}
+
+void HashTableCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  evictLocked(0);
+}
+
+size_t HashTableCache::size() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return entries_.size();
+}
+
+} // namespace facebook::velox::exec
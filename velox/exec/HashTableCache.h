@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <list>
+#include <mutex>
+
+#include "velox/common/memory/MemoryUsageTracker.h"
+#include "velox/exec/HashBuild.h"
+
+namespace facebook::velox::exec {
+
+class Task;
+
+/// Process-wide cache of the finished hash tables of the build sides of
+/// joins, for queries that join the same slowly changing dimension tables
+/// over and over. The joins listed in the hash_table_cache_join_ids query
+/// config are cached. The HashBuilds of a later join with the same build side
+/// over the same data finish without input and the HashJoinBridge gets the
+/// cached table.
+///
+/// The key is the build side plan with the columns read by its TableScans,
+/// the join type and keys, and the data versions of the splits of the
+/// TableScans, see ConnectorSplit::dataVersion(). A build side is cached
+/// only if all its leaves are TableScans, all their splits have versions and
+/// all were added with noMoreSplits() before the Task started. Like shared
+/// tables, see SharedHashTables, cached tables are probed read only, so
+/// right and full joins are not cached, and cached builds neither spill nor
+/// swap the join sides.
+///
+/// A cached table keeps the Task that built it, whose pools own its memory,
+/// alive. The cached bytes are counted in tracker() and the least recently
+/// used tables are evicted to stay under the capacity. An evicted table lives
+/// until the joins that probe it are done. Thread safe.
+class HashTableCache {
+ public:
+  static constexpr int64_t kDefaultCapacity = 256 << 20;
+
+  explicit HashTableCache(int64_t capacity = kDefaultCapacity);
+
+  /// The cache used by HashBuild.
+  static HashTableCache& instance();
+
+  /// Returns true if the table of 'joinNode' may be cached under 'config'.
+  static bool isCached(
+      const core::HashJoinNode& joinNode,
+      const core::QueryConfig& config);
+
+  /// Returns the cache key of the table of 'joinNode' in split group
+  /// 'splitGroupId' of 'task', std::nullopt if the table cannot be cached.
+  /// Must be called before the build side TableScans take splits.
+  static std::optional<std::string>
+  key(const core::HashJoinNode& joinNode, Task& task, uint32_t splitGroupId);
+
+  /// Returns the table cached under 'key', if any.
+  std::optional<HashJoinBridge::HashBuildResult> find(const std::string& key);
+
+  /// Caches 'table' built by 'task' under 'key'. 'table' is nullptr if the
+  /// build side of an anti join has a null key. Evicts the least recently
+  /// used tables to make space. A table larger than the capacity is not
+  /// cached.
+  void put(
+      const std::string& key,
+      std::shared_ptr<BaseHashTable> table,
+      std::vector<std::shared_ptr<common::Filter>> keyBloomFilters,
+      std::shared_ptr<Task> task);
+
+  /// Sets the maximum of the cached bytes. Evicts to stay under it.
+  void setCapacity(int64_t capacity);
+
+  /// Evicts all tables.
+  void clear();
+
+  /// Returns the number of cached tables.
+  size_t size();
+
+  /// Counts the bytes of the cached tables.
+  const std::shared_ptr<memory::MemoryUsageTracker>& tracker() const {
+    return tracker_;
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<BaseHashTable> table;
+    bool antiJoinHasNullKeys;
+    std::vector<std::shared_ptr<common::Filter>> keyBloomFilters;
+    int64_t bytes;
+    // Position in 'lru_'.
+    std::list<std::string>::iterator lruPosition;
+  };
+
+  // Evicts least recently used tables until at most 'maxBytes' are cached.
+  void evictLocked(int64_t maxBytes);
+
+  const std::shared_ptr<memory::MemoryUsageTracker> tracker_;
+
+  std::mutex mutex_;
+  int64_t capacity_;
+  int64_t cachedBytes_{0};
+  std::unordered_map<std::string, Entry> entries_;
+  // Keys of 'entries_', most recently used first.
+  std::list<std::string> lru_;
+};
+
+} // namespace facebook::velox::exec
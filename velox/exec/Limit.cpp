@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "velox/exec/Limit.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
 Limit::Limit(
@@ -35,10 +37,15 @@ Limit::Limit(
   for (column_index_t i = 0; i < numColumns; ++i) {
     identityProjections_.emplace_back(i, i);
   }
+  if (limitNode->isPartial() && limitNode->offset() == 0) {
+    sharedLimit_ = driverCtx->task->getSharedLimit(
+        driverCtx->splitGroupId, limitNode->id(), limitNode->count());
+  }
 }
 
 bool Limit::needsInput() const {
-  return !finished_ && input_ == nullptr;
+  return !finished_ && input_ == nullptr &&
+      (!sharedLimit_ || *sharedLimit_ > 0);
 }
 
 void Limit::addInput(RowVectorPtr input) {
@@ -51,6 +58,10 @@ RowVectorPtr Limit::getOutput() {
     return nullptr;
   }
 
+  if (sharedLimit_) {
+    return getSharedOutput();
+  }
+
   const auto inputSize = input_->size();
 
   if (remainingOffset_ >= inputSize) {
@@ -88,14 +99,54 @@ RowVectorPtr Limit::getOutput() {
     return output;
   }
 
+  auto output = firstRows(remainingLimit_);
+  remainingLimit_ = 0;
+  return output;
+}
+
+RowVectorPtr Limit::getSharedOutput() {
+  const int64_t inputSize = input_->size();
+  auto remaining = sharedLimit_->load();
+  int64_t numRows;
+  do {
+    numRows = std::min(remaining, inputSize);
+  } while (
+      !sharedLimit_->compare_exchange_weak(remaining, remaining - numRows));
+
+  if (remaining == numRows) {
+    finished_ = true;
+  }
+  if (numRows == 0) {
+    input_.reset();
+    return nullptr;
+  }
+  if (numRows == inputSize) {
+    return std::move(input_);
+  }
+  return firstRows(numRows);
+}
+
+RowVectorPtr Limit::firstRows(vector_size_t numRows) {
+  auto children = input_->children();
+  BufferPtr indices;
+  for (auto& child : children) {
+    if (!isLazyNotLoaded(*child)) {
+      continue;
+    }
+    if (!indices) {
+      indices = allocateIndices(numRows, pool());
+      auto rawIndices = indices->asMutable<vector_size_t>();
+      std::iota(rawIndices, rawIndices + numRows, 0);
+    }
+    child = wrapChild(numRows, indices, child);
+  }
   auto output = std::make_shared<RowVector>(
       input_->pool(),
       input_->type(),
       input_->nulls(),
-      remainingLimit_,
-      input_->children());
+      numRows,
+      std::move(children));
   input_.reset();
-  remainingLimit_ = 0;
   return output;
 }
 } // namespace facebook::velox::exec
@@ -35,12 +35,29 @@ class Limit : public Operator {
   }
 
   bool isFinished() override {
-    return finished_ || (noMoreInput_ && input_ == nullptr);
+    return finished_ || (noMoreInput_ && input_ == nullptr) ||
+        (input_ == nullptr && sharedLimit_ && *sharedLimit_ == 0);
+  }
+
+  std::optional<int64_t> maxInputRows() const override {
+    return static_cast<int64_t>(remainingOffset_) + remainingLimit_;
   }
 
  private:
+  // Returns the rows of 'input_' taken from 'sharedLimit_'.
+  RowVectorPtr getSharedOutput();
+
+  // Returns the first 'numRows' rows of 'input_'. Columns that are not
+  // loaded yet are wrapped in a dictionary over these rows so that loading
+  // them downstream decodes only the rows that are returned.
+  RowVectorPtr firstRows(vector_size_t numRows);
+
   int32_t remainingOffset_;
   int32_t remainingLimit_;
   bool finished_{false};
+  // The rows still to produce by all drivers of a partial Limit without
+  // offset. The drivers take the rows of each input from it, so that all
+  // of them finish as soon as the Task has produced 'count' rows.
+  std::shared_ptr<std::atomic<int64_t>> sharedLimit_;
 };
 } // namespace facebook::velox::exec
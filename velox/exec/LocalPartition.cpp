@@ -29,56 +29,64 @@ void notify(std::vector<ContinuePromise>& promises) {
 bool LocalExchangeMemoryManager::increaseMemoryUsage(
     ContinueFuture* future,
     int64_t added) {
-  std::lock_guard<std::mutex> l(mutex_);
-  bufferedBytes_ += added;
-
-  if (bufferedBytes_ >= maxBufferSize_) {
-    promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
-    *future = promises_.back().getSemiFuture();
-    return true;
+  if ((bufferedBytes_ += added) < maxBufferSize_) {
+    return false;
   }
 
-  return false;
+  std::lock_guard<std::mutex> l(mutex_);
+  // A consumer that reduces the usage after this wakes up the promise below.
+  ++numBlockedProducers_;
+  if (bufferedBytes_ < maxBufferSize_) {
+    --numBlockedProducers_;
+    return false;
+  }
+  promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
+  *future = promises_.back().getSemiFuture();
+  return true;
 }
 
 void LocalExchangeMemoryManager::decreaseMemoryUsage(int64_t removed) {
+  if ((bufferedBytes_ -= removed) >= maxBufferSize_ ||
+      numBlockedProducers_ == 0) {
+    return;
+  }
+
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
-    bufferedBytes_ -= removed;
-
-    if (bufferedBytes_ < maxBufferSize_ &&
-        bufferedBytes_ + removed >= maxBufferSize_) {
+    if (bufferedBytes_ < maxBufferSize_) {
       promises = std::move(promises_);
+      numBlockedProducers_ = 0;
     }
   }
-
   notify(promises);
 }
 
 void LocalExchangeQueue::addProducer() {
-  queue_.withWLock([&](auto& /*queue*/) {
-    VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
-    ++pendingProducers_;
-  });
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
+  ++pendingProducers_;
 }
 
 void LocalExchangeQueue::noMoreProducers() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto& queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!noMoreProducers_, "noMoreProducers can be called only once");
     noMoreProducers_ = true;
     if (pendingProducers_ == 0) {
       // No more data will be produced.
+      noMoreData_ = true;
       consumerPromises = std::move(consumerPromises_);
+      numBlockedConsumers_ = 0;
 
-      if (queue.empty()) {
+      if (size_ == 0) {
         // All data has been consumed.
         producerPromises = std::move(producerPromises_);
       }
     }
-  });
+  }
   notify(consumerPromises);
   notify(producerPromises);
 }
@@ -86,23 +94,41 @@ void LocalExchangeQueue::noMoreProducers() {
 BlockingReason LocalExchangeQueue::enqueue(
     RowVectorPtr input,
     ContinueFuture* future) {
+  if (closed_) {
+    return BlockingReason::kNotBlocked;
+  }
+
   auto inputBytes = input->retainedSize();
 
-  std::vector<ContinuePromise> consumerPromises;
-  bool isClosed = queue_.withWLock([&](auto& queue) {
-    if (closed_) {
-      return true;
-    }
-    queue.push(std::move(input));
-    consumerPromises = std::move(consumerPromises_);
-    return false;
-  });
+  // Once a vector has gone to 'overflow_', the following ones go there too
+  // until the consumers have caught up.
+  if (numOverflow_ > 0 || !queue_.write(std::move(input))) {
+    std::lock_guard<std::mutex> l(mutex_);
+    overflow_.push_back(std::move(input));
+    ++numOverflow_;
+  }
+  ++size_;
 
-  if (isClosed) {
+  if (closed_) {
+    // close() may have run before the vector was added.
+    dropQueued();
     return BlockingReason::kNotBlocked;
   }
 
-  notify(consumerPromises);
+  // Consumers block only after seeing 'size_' at zero with
+  // 'numBlockedConsumers_' incremented. Either this sees them or they see
+  // the new size.
+  if (numBlockedConsumers_ > 0) {
+    std::vector<ContinuePromise> consumerPromises;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      consumerPromises = std::move(consumerPromises_);
+      numBlockedConsumers_ = 0;
+    }
+    // Wakes up all waiting consumers at once. Each takes at most one vector,
+    // so some may find the queue empty and block again.
+    notify(consumerPromises);
+  }
 
   if (memoryManager_->increaseMemoryUsage(future, inputBytes)) {
     return BlockingReason::kWaitForConsumer;
@@ -114,101 +140,123 @@ BlockingReason LocalExchangeQueue::enqueue(
 void LocalExchangeQueue::noMoreData() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK_GT(pendingProducers_, 0);
     --pendingProducers_;
     if (noMoreProducers_ && pendingProducers_ == 0) {
+      noMoreData_ = true;
       consumerPromises = std::move(consumerPromises_);
-      if (queue.empty()) {
+      numBlockedConsumers_ = 0;
+      if (size_ == 0) {
         producerPromises = std::move(producerPromises_);
       }
     }
-  });
+  }
   notify(consumerPromises);
   notify(producerPromises);
 }
 
+bool LocalExchangeQueue::tryDequeue(RowVectorPtr& data) {
+  if (!queue_.read(data)) {
+    if (numOverflow_ == 0) {
+      return false;
+    }
+    std::lock_guard<std::mutex> l(mutex_);
+    if (overflow_.empty()) {
+      return false;
+    }
+    data = std::move(overflow_.front());
+    overflow_.pop_front();
+    --numOverflow_;
+  }
+  --size_;
+  return true;
+}
+
 BlockingReason LocalExchangeQueue::next(
     ContinueFuture* future,
     memory::MemoryPool* pool,
     RowVectorPtr* data) {
-  std::vector<ContinuePromise> producerPromises;
-  auto blockingReason = queue_.withWLock([&](auto& queue) {
-    *data = nullptr;
-    if (queue.empty()) {
-      if (isFinishedLocked(queue)) {
-        return BlockingReason::kNotBlocked;
-      }
-
-      consumerPromises_.emplace_back("LocalExchangeQueue::next");
-      *future = consumerPromises_.back().getSemiFuture();
-
-      return BlockingReason::kWaitForExchange;
+  *data = nullptr;
+  for (;;) {
+    if (closed_) {
+      return BlockingReason::kNotBlocked;
+    }
+    if (tryDequeue(*data)) {
+      break;
     }
 
-    *data = queue.front();
-    queue.pop();
+    std::lock_guard<std::mutex> l(mutex_);
+    // A producer that adds data after this wakes up the promise below.
+    ++numBlockedConsumers_;
+    if (size_ > 0) {
+      // Data arrived or was not yet taken by another consumer.
+      --numBlockedConsumers_;
+      continue;
+    }
+    if (noMoreData_ || closed_) {
+      --numBlockedConsumers_;
+      return BlockingReason::kNotBlocked;
+    }
+    consumerPromises_.emplace_back("LocalExchangeQueue::next");
+    *future = consumerPromises_.back().getSemiFuture();
+    return BlockingReason::kWaitForExchange;
+  }
 
-    memoryManager_->decreaseMemoryUsage((*data)->retainedSize());
+  memoryManager_->decreaseMemoryUsage((*data)->retainedSize());
 
-    if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
+  if (noMoreData_ && size_ == 0) {
+    std::vector<ContinuePromise> producerPromises;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
       producerPromises = std::move(producerPromises_);
     }
-
-    return BlockingReason::kNotBlocked;
-  });
-  notify(producerPromises);
-  return blockingReason;
-}
-
-bool LocalExchangeQueue::isFinishedLocked(
-    const std::queue<RowVectorPtr>& queue) const {
-  if (closed_) {
-    return true;
-  }
-
-  if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
-    return true;
+    notify(producerPromises);
   }
 
-  return false;
+  return BlockingReason::kNotBlocked;
 }
 
 BlockingReason LocalExchangeQueue::isFinished(ContinueFuture* future) {
-  return queue_.withWLock([&](auto& queue) {
-    if (isFinishedLocked(queue)) {
-      return BlockingReason::kNotBlocked;
-    }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (isFinished()) {
+    return BlockingReason::kNotBlocked;
+  }
 
-    producerPromises_.emplace_back("LocalExchangeQueue::isFinished");
-    *future = producerPromises_.back().getSemiFuture();
+  producerPromises_.emplace_back("LocalExchangeQueue::isFinished");
+  *future = producerPromises_.back().getSemiFuture();
 
-    return BlockingReason::kWaitForConsumer;
-  });
+  return BlockingReason::kWaitForConsumer;
 }
 
 bool LocalExchangeQueue::isFinished() {
-  return queue_.withWLock([&](auto& queue) { return isFinishedLocked(queue); });
+  return closed_ || (noMoreData_ && size_ == 0);
+}
+
+void LocalExchangeQueue::dropQueued() {
+  uint64_t freedBytes = 0;
+  RowVectorPtr data;
+  while (tryDequeue(data)) {
+    freedBytes += data->retainedSize();
+  }
+  if (freedBytes) {
+    memoryManager_->decreaseMemoryUsage(freedBytes);
+  }
 }
 
 void LocalExchangeQueue::close() {
+  closed_ = true;
+  dropQueued();
+
   std::vector<ContinuePromise> producerPromises;
   std::vector<ContinuePromise> consumerPromises;
-  queue_.withWLock([&](auto& queue) {
-    uint64_t freedBytes = 0;
-    while (!queue.empty()) {
-      freedBytes += queue.front()->retainedSize();
-      queue.pop();
-    }
-
-    if (freedBytes) {
-      memoryManager_->decreaseMemoryUsage(freedBytes);
-    }
-
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     producerPromises = std::move(producerPromises_);
     consumerPromises = std::move(consumerPromises_);
-    closed_ = true;
-  });
+    numBlockedConsumers_ = 0;
+  }
   notify(producerPromises);
   notify(consumerPromises);
 }
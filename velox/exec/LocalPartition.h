@@ -15,13 +15,18 @@
  */
 #pragma once
 
+#include <deque>
+
+#include <folly/MPMCQueue.h>
+
 #include "velox/exec/Operator.h"
 #include "velox/exec/VectorHasher.h"
 
 namespace facebook::velox::exec {
 
 /// Keeps track of the total size in bytes of the data buffered in all
-/// LocalExchangeQueues.
+/// LocalExchangeQueues. The size is an atomic counter. The mutex is taken
+/// only by producers that block and by consumers that wake them up.
 class LocalExchangeMemoryManager {
  public:
   explicit LocalExchangeMemoryManager(int64_t maxBufferSize)
@@ -35,8 +40,11 @@ class LocalExchangeMemoryManager {
 
  private:
   const int64_t maxBufferSize_;
+  std::atomic<int64_t> bufferedBytes_{0};
+  // Number of entries in 'promises_'. Consumers take 'mutex_' only if there
+  // are blocked producers.
+  std::atomic<int32_t> numBlockedProducers_{0};
   std::mutex mutex_;
-  int64_t bufferedBytes_{0};
   std::vector<ContinuePromise> promises_;
 };
 
@@ -46,12 +54,20 @@ class LocalExchangeMemoryManager {
 /// must be called after all producers have been registered. A producer calls
 /// 'enqueue' multiple time to put the data and calls 'noMoreData' when done.
 /// Consumers call 'next' repeatedly to fetch the data.
+///
+/// The data is passed through a lock-free bounded MPMC queue. The mutex is
+/// taken only to block or wake up consumers and producers and to register
+/// and finish producers. A producer takes it on enqueue only if a consumer is
+/// waiting, and then wakes up all waiting consumers at once. Vectors from
+/// different producers come out in no particular order.
 class LocalExchangeQueue {
  public:
   LocalExchangeQueue(
       std::shared_ptr<LocalExchangeMemoryManager> memoryManager,
       int partition)
-      : memoryManager_{std::move(memoryManager)}, partition_{partition} {}
+      : memoryManager_{std::move(memoryManager)},
+        partition_{partition},
+        queue_{kMaxQueuedVectors} {}
 
   std::string toString() const {
     return fmt::format("LocalExchangeQueue({})", partition_);
@@ -94,22 +110,48 @@ class LocalExchangeQueue {
   void close();
 
  private:
-  bool isFinishedLocked(const std::queue<RowVectorPtr>& queue) const;
+  // Capacity of 'queue_'. Vectors beyond this go to 'overflow_'. The byte
+  // limit of LocalExchangeMemoryManager normally blocks producers first.
+  static constexpr size_t kMaxQueuedVectors = 1024;
+
+  // Takes a vector from 'queue_' or 'overflow_'. Returns false if none is
+  // found.
+  bool tryDequeue(RowVectorPtr& data);
+
+  // Drops the queued data and returns the memory to 'memoryManager_'.
+  void dropQueued();
 
   std::shared_ptr<LocalExchangeMemoryManager> memoryManager_;
   const int partition_;
-  folly::Synchronized<std::queue<RowVectorPtr>> queue_;
+
+  folly::MPMCQueue<RowVectorPtr> queue_;
+
+  // Number of vectors in 'queue_' and 'overflow_'. Incremented after adding
+  // and decremented after removing a vector.
+  std::atomic<int64_t> size_{0};
+
+  // Number of vectors in 'overflow_'.
+  std::atomic<int32_t> numOverflow_{0};
+
+  // Number of consumers blocked on 'consumerPromises_'.
+  std::atomic<int32_t> numBlockedConsumers_{0};
+
+  // True after noMoreProducers() has been called and all producers have
+  // called noMoreData().
+  std::atomic<bool> noMoreData_{false};
+  std::atomic<bool> closed_{false};
+
+  // Guards the members below.
+  std::mutex mutex_;
+  std::deque<RowVectorPtr> overflow_;
   // Satisfied when data becomes available or all producers report that they
-  // finished producing, e.g. queue_ is not empty or noMoreProducers_ is true
-  // and pendingProducers_ is zero.
+  // finished producing, e.g. size_ is not zero or noMoreData_ is true.
   std::vector<ContinuePromise> consumerPromises_;
   // Satisfied when all data has been fetched and no more data will be produced,
-  // e.g. queue_ is empty, noMoreProducers_ is true and pendingProducers_ is
-  // zero.
+  // e.g. size_ is zero and noMoreData_ is true.
   std::vector<ContinuePromise> producerPromises_;
   int pendingProducers_{0};
   bool noMoreProducers_{false};
-  bool closed_{false};
 };
 
 /// Fetches data for a single partition produced by local exchange from
@@ -24,6 +24,7 @@
 #include "velox/exec/Exchange.h"
 #include "velox/exec/FilterProject.h"
 #include "velox/exec/GroupId.h"
+#include "velox/exec/GroupingSetsAggregation.h"
 #include "velox/exec/HashAggregation.h"
 #include "velox/exec/HashBuild.h"
 #include "velox/exec/HashProbe.h"
@@ -32,12 +33,14 @@
 #include "velox/exec/MergeJoin.h"
 #include "velox/exec/OrderBy.h"
 #include "velox/exec/PartitionedOutput.h"
+#include "velox/exec/RangeJoinProbe.h"
 #include "velox/exec/StreamingAggregation.h"
 #include "velox/exec/TableScan.h"
 #include "velox/exec/TableWriter.h"
 #include "velox/exec/TopN.h"
 #include "velox/exec/Unnest.h"
 #include "velox/exec/Values.h"
+#include "velox/exec/Window.h"
 
 namespace facebook::velox::exec {
 
@@ -276,6 +279,26 @@ void LocalPlanner::plan(
   }
 }
 
+LocalPlan::LocalPlan(core::PlanFragment planFragment, uint32_t maxDrivers)
+    : planFragment_(std::move(planFragment)), maxDrivers_(maxDrivers) {
+  VELOX_CHECK_GE(maxDrivers_, 1);
+  LocalPlanner::plan(planFragment_, nullptr, &driverFactories_, maxDrivers_);
+}
+
+std::vector<std::unique_ptr<DriverFactory>> LocalPlan::makeDriverFactories(
+    ConsumerSupplier consumerSupplier) const {
+  std::vector<std::unique_ptr<DriverFactory>> driverFactories;
+  driverFactories.reserve(driverFactories_.size());
+  for (const auto& factory : driverFactories_) {
+    driverFactories.push_back(std::make_unique<DriverFactory>(*factory));
+  }
+  // The output pipeline is the first one and its consumer is the only one
+  // that depends on the Task.
+  driverFactories[0]->consumerSupplier =
+      detail::makeConsumerSupplier(consumerSupplier);
+  return driverFactories;
+}
+
 std::shared_ptr<Driver> DriverFactory::createDriver(
     std::unique_ptr<DriverCtx> ctx,
     std::shared_ptr<ExchangeClient> exchangeClient,
@@ -347,6 +370,11 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
         auto joinNode =
             std::dynamic_pointer_cast<const core::HashJoinNode>(planNode)) {
       operators.push_back(std::make_unique<HashProbe>(id, ctx.get(), joinNode));
+    } else if (
+        auto joinNode =
+            std::dynamic_pointer_cast<const core::RangeJoinNode>(planNode)) {
+      operators.push_back(
+          std::make_unique<RangeJoinProbe>(id, ctx.get(), joinNode));
     } else if (
         auto joinNode =
             std::dynamic_pointer_cast<const core::CrossJoinNode>(planNode)) {
@@ -367,6 +395,19 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
     } else if (
         auto groupIdNode =
             std::dynamic_pointer_cast<const core::GroupIdNode>(planNode)) {
+      if (i < planNodes.size() - 1 &&
+          ctx->queryConfig().groupingSetsFusion()) {
+        auto aggregationNode =
+            std::dynamic_pointer_cast<const core::AggregationNode>(
+                planNodes[i + 1]);
+        if (aggregationNode &&
+            GroupingSetsAggregation::canFuse(*groupIdNode, *aggregationNode)) {
+          operators.push_back(std::make_unique<GroupingSetsAggregation>(
+              id, ctx.get(), groupIdNode, aggregationNode));
+          i++;
+          continue;
+        }
+      }
       operators.push_back(
           std::make_unique<GroupId>(id, ctx.get(), groupIdNode));
     } else if (
@@ -380,8 +421,16 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
     } else if (
         auto orderByNode =
             std::dynamic_pointer_cast<const core::OrderByNode>(planNode)) {
+      // The last node of the pipeline may feed a LocalMerge.
+      auto localMerge = i == planNodes.size() - 1
+          ? std::dynamic_pointer_cast<const core::LocalMergeNode>(consumerNode)
+          : nullptr;
       operators.push_back(
-          std::make_unique<OrderBy>(id, ctx.get(), orderByNode));
+          std::make_unique<OrderBy>(id, ctx.get(), orderByNode, localMerge));
+    } else if (
+        auto windowNode =
+            std::dynamic_pointer_cast<const core::WindowNode>(planNode)) {
+      operators.push_back(std::make_unique<Window>(id, ctx.get(), windowNode));
     } else if (
         auto localMerge =
             std::dynamic_pointer_cast<const core::LocalMergeNode>(planNode)) {
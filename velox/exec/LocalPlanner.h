@@ -15,12 +15,9 @@
  */
 #pragma once
 
+#include "velox/core/PlanFragment.h"
 #include "velox/exec/Operator.h"
 
-namespace facebook::velox::core {
-struct PlanFragment;
-} // namespace facebook::velox::core
-
 namespace facebook::velox::exec {
 
 class LocalPlanner {
@@ -31,4 +28,32 @@ class LocalPlanner {
       std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
       uint32_t maxDrivers);
 };
+
+/// The DriverFactories of a plan fragment, planned once for all the Tasks
+/// that run the fragment. A Task started with Task::start(self, localPlan)
+/// copies these instead of planning its fragment again. The Tasks may have
+/// different splits and QueryCtxs.
+class LocalPlan {
+ public:
+  LocalPlan(core::PlanFragment planFragment, uint32_t maxDrivers);
+
+  const core::PlanFragment& planFragment() const {
+    return planFragment_;
+  }
+
+  uint32_t maxDrivers() const {
+    return maxDrivers_;
+  }
+
+  /// Returns copies of the DriverFactories. 'consumerSupplier' is for the
+  /// output pipeline as in LocalPlanner::plan().
+  std::vector<std::unique_ptr<DriverFactory>> makeDriverFactories(
+      ConsumerSupplier consumerSupplier) const;
+
+ private:
+  const core::PlanFragment planFragment_;
+  const uint32_t maxDrivers_;
+  // Planned without a consumer.
+  std::vector<std::unique_ptr<DriverFactory>> driverFactories_;
+};
 } // namespace facebook::velox::exec
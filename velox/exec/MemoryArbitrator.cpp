@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/MemoryArbitrator.h"
+
+#include <folly/ScopeGuard.h>
+#include <glog/logging.h>
+#include <algorithm>
+
+namespace facebook::velox::exec {
+
+namespace {
+// True on a thread that arbitrates. Allocations made while reclaiming, e.g.
+// by spilling, must not arbitrate again.
+thread_local bool inArbitration{false};
+} // namespace
+
+MemoryArbitrator::MemoryArbitrator(Options options) : options_(options) {
+  VELOX_CHECK_GT(options_.capacity, 0);
+  VELOX_CHECK_GT(options_.minGrowBytes, 0);
+}
+
+void MemoryArbitrator::addTask(const std::shared_ptr<Task>& task) {
+  const auto& tracker = task->queryCtx()->pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(
+      tracker, "The QueryCtx of task {} has no memory tracker", task->taskId());
+  std::lock_guard<std::mutex> l(mutex_);
+  removeFinishedQueriesLocked();
+  auto [it, inserted] = queries_.try_emplace(tracker.get());
+  auto& query = it->second;
+  query.tasks.push_back(task);
+  if (!inserted) {
+    return;
+  }
+  query.tracker = tracker;
+  setCapacity(
+      query,
+      std::max(
+          std::min(options_.initialQueryCapacity, freeCapacityLocked()),
+          tracker->totalReservedBytes()));
+  tracker->setGrowCallback([this](
+                               memory::MemoryUsageTracker::UsageType /*type*/,
+                               int64_t /*size*/,
+                               memory::MemoryUsageTracker& tracker) {
+    return growCapacity(tracker);
+  });
+}
+
+int64_t MemoryArbitrator::freeCapacity() {
+  std::lock_guard<std::mutex> l(mutex_);
+  removeFinishedQueriesLocked();
+  return freeCapacityLocked();
+}
+
+MemoryArbitrator::Stats MemoryArbitrator::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+bool MemoryArbitrator::growCapacity(memory::MemoryUsageTracker& tracker) {
+  if (inArbitration) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = queries_.find(&tracker);
+    if (it == queries_.end()) {
+      return false;
+    }
+    ++it->second.numWaiting;
+    ++stats_.numRequests;
+  }
+  // The Query stays in 'queries_' while it has waiters.
+  auto waitingGuard = folly::makeGuard([&]() {
+    std::lock_guard<std::mutex> l(mutex_);
+    --queries_.find(&tracker)->second.numWaiting;
+  });
+
+  std::lock_guard<std::mutex> arbitration(arbitrationMutex_);
+  inArbitration = true;
+  auto arbitrationGuard = folly::makeGuard([]() { inArbitration = false; });
+  // The usage of 'tracker' is as if the allocation calling this had
+  // succeeded.
+  const int64_t needed = std::max<int64_t>(
+      1, tracker.totalReservedBytes() - tracker.maxTotalBytes());
+  const int64_t increment = std::max(needed, options_.minGrowBytes);
+  if (freeCapacity() < increment) {
+    reclaim(&tracker, increment);
+  }
+
+  std::lock_guard<std::mutex> l(mutex_);
+  const auto free = freeCapacityLocked();
+  if (free < needed) {
+    ++stats_.numFailures;
+    return false;
+  }
+  auto& query = queries_.find(&tracker)->second;
+  setCapacity(query, query.capacity + std::min(free, increment));
+  return true;
+}
+
+void MemoryArbitrator::reclaim(
+    const memory::MemoryUsageTracker* requester,
+    int64_t targetBytes) {
+  struct Candidate {
+    std::shared_ptr<memory::MemoryUsageTracker> tracker;
+    std::vector<std::shared_ptr<Task>> tasks;
+    int64_t usage;
+  };
+  std::vector<Candidate> candidates;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto& [key, query] : queries_) {
+      if (key == requester || query.numWaiting > 0) {
+        continue;
+      }
+      auto tracker = query.tracker.lock();
+      if (!tracker) {
+        continue;
+      }
+      Candidate candidate{tracker, {}, tracker->totalReservedBytes()};
+      for (auto& weakTask : query.tasks) {
+        if (auto task = weakTask.lock()) {
+          candidate.tasks.push_back(std::move(task));
+        }
+      }
+      candidates.push_back(std::move(candidate));
+    }
+  }
+  // The largest queries are likely to free the most.
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const Candidate& left, const Candidate& right) {
+        return left.usage > right.usage;
+      });
+
+  for (auto& candidate : candidates) {
+    if (freeCapacity() >= targetBytes) {
+      return;
+    }
+    const auto usageBefore = candidate.tracker->totalReservedBytes();
+    bool reclaimed = false;
+    for (auto& task : candidate.tasks) {
+      // The Task mutex is taken outside of 'mutex_'.
+      if (task->isRunning() && reclaimTask(task)) {
+        reclaimed = true;
+      }
+    }
+    if (!reclaimed) {
+      continue;
+    }
+    const auto usage = candidate.tracker->totalReservedBytes();
+    std::lock_guard<std::mutex> l(mutex_);
+    ++stats_.numReclaims;
+    stats_.reclaimedBytes += std::max<int64_t>(0, usageBefore - usage);
+    auto it = queries_.find(candidate.tracker.get());
+    if (it != queries_.end()) {
+      // Keep the limit above the usage so that the query can continue.
+      setCapacity(
+          it->second,
+          std::min(
+              it->second.capacity,
+              static_cast<int64_t>(bits::roundUp(
+                  usage + options_.minGrowBytes, options_.minGrowBytes))));
+    }
+  }
+}
+
+bool MemoryArbitrator::reclaimTask(const std::shared_ptr<Task>& task) {
+  const bool paused = Task::preempt(task, options_.pauseTimeoutMs);
+  try {
+    if (!task->error()) {
+      Task::resume(task);
+    }
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to resume task " << task->taskId()
+                 << " after reclaiming memory: " << e.what();
+  }
+  return paused;
+}
+
+// static
+void MemoryArbitrator::setCapacity(Query& query, int64_t capacity) {
+  query.capacity = capacity;
+  if (auto tracker = query.tracker.lock()) {
+    tracker->updateConfig(memory::MemoryUsageConfigBuilder()
+                              .maxUserMemory(capacity)
+                              .maxSystemMemory(capacity)
+                              .maxTotalMemory(capacity)
+                              .build());
+  }
+}
+
+void MemoryArbitrator::removeFinishedQueriesLocked() {
+  for (auto it = queries_.begin(); it != queries_.end();) {
+    auto& query = it->second;
+    bool finished = query.tracker.expired() ||
+        std::all_of(query.tasks.begin(),
+                    query.tasks.end(),
+                    [](const auto& task) { return task.expired(); });
+    if (finished && query.numWaiting == 0) {
+      it = queries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+int64_t MemoryArbitrator::freeCapacityLocked() const {
+  auto free = options_.capacity;
+  for (const auto& [key, query] : queries_) {
+    free -= query.capacity;
+  }
+  return free;
+}
+
+} // namespace facebook::velox::exec
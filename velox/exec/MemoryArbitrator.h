@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include "velox/common/memory/MemoryUsageTracker.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+/// Divides a node-wide memory capacity between the queries running on the
+/// node. Each query gets a memory limit on the root MemoryUsageTracker of its
+/// QueryCtx. When a query exceeds its limit, the GrowCallback of the tracker
+/// asks 'this' for more. The limit is raised from unused capacity if there is
+/// enough. Otherwise, other queries are paused one at a time, starting with
+/// the largest, and their operators are asked to give memory back with
+/// Operator::reclaim(), e.g. by spilling. The limits of these queries shrink
+/// to what they still use. The query fails with a memory cap error only if this
+/// does not free enough.
+///
+/// The arbitrator must outlive the tasks added to it.
+class MemoryArbitrator {
+ public:
+  struct Options {
+    /// Total bytes the queries added to 'this' may use.
+    int64_t capacity{0};
+
+    /// Limit of a query when its first task is added.
+    int64_t initialQueryCapacity{128 << 20};
+
+    /// Minimum increment of the limit of a query.
+    int64_t minGrowBytes{8 << 20};
+
+    /// Maximum time to wait for a task to go off thread before reclaiming
+    /// from it. A task that does not pause in time is skipped, e.g. if its
+    /// Drivers are themselves waiting for memory.
+    uint64_t pauseTimeoutMs{1'000};
+  };
+
+  struct Stats {
+    /// Number of requests to raise the limit of a query.
+    uint64_t numRequests{0};
+
+    /// Number of requests that could not be satisfied.
+    uint64_t numFailures{0};
+
+    /// Number of times a task was paused to reclaim memory from it.
+    uint64_t numReclaims{0};
+
+    /// Bytes freed by reclaiming.
+    int64_t reclaimedBytes{0};
+  };
+
+  explicit MemoryArbitrator(Options options);
+
+  /// Puts the query of 'task' under the control of 'this'. The tasks of a
+  /// query share the limit of the tracker of their QueryCtx. Must be called
+  /// before the task starts. The capacity of a query returns to 'this' when
+  /// all of its tasks are destroyed.
+  void addTask(const std::shared_ptr<Task>& task);
+
+  /// Returns the capacity not given to any query.
+  int64_t freeCapacity();
+
+  Stats stats() const;
+
+ private:
+  struct Query {
+    std::weak_ptr<memory::MemoryUsageTracker> tracker;
+    std::vector<std::weak_ptr<Task>> tasks;
+
+    // Current limit of the query.
+    int64_t capacity{0};
+
+    // Number of threads waiting for the limit to grow. A query with waiters
+    // has Drivers on thread and is not paused for reclaiming.
+    int32_t numWaiting{0};
+  };
+
+  // GrowCallback of the tracker of each query. Returns true if the limit of
+  // 'tracker' was raised above its usage.
+  bool growCapacity(memory::MemoryUsageTracker& tracker);
+
+  // Reclaims memory from queries other than 'requester' until the free
+  // capacity is at least 'targetBytes'.
+  void reclaim(
+      const memory::MemoryUsageTracker* requester,
+      int64_t targetBytes);
+
+  // Pauses 'task', calls Task::reclaim() and resumes it. Returns false if the
+  // task did not go off thread in time.
+  bool reclaimTask(const std::shared_ptr<Task>& task);
+
+  // Sets the limit of 'query' to 'capacity'.
+  static void setCapacity(Query& query, int64_t capacity);
+
+  // Removes the queries with no live task and returns their capacity to
+  // 'this'. Must be called under 'mutex_'.
+  void removeFinishedQueriesLocked();
+
+  int64_t freeCapacityLocked() const;
+
+  const Options options_;
+
+  // Serializes arbitrations. Reclaiming pauses other queries and may spill,
+  // so this is held for long. Acquired before 'mutex_'.
+  std::mutex arbitrationMutex_;
+
+  // Guards 'queries_' and 'stats_'.
+  mutable std::mutex mutex_;
+
+  std::unordered_map<const memory::MemoryUsageTracker*, Query> queries_;
+
+  Stats stats_;
+};
+
+} // namespace facebook::velox::exec
@@ -17,6 +17,7 @@
 #include <boost/circular_buffer.hpp>
 
 #include "velox/exec/Merge.h"
+#include "velox/exec/OrderBy.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -79,7 +80,7 @@ BlockingReason Merge::isBlocked(ContinueFuture* future) {
   }
 
   // No merging is needed if there is only one source.
-  if (streams_.empty() && sources_.size() > 1) {
+  if (streams_.empty() && sources_.size() > 1 && !concatenate_) {
     initializeTreeOfLosers();
   }
 
@@ -107,18 +108,24 @@ RowVectorPtr Merge::getOutput() {
     return nullptr;
   }
 
-  // No merging is needed if there is only one source.
-  if (sources_.size() == 1) {
-    ContinueFuture future;
-    RowVectorPtr data;
-    auto reason = sources_[0]->next(data, &future);
-    if (reason != BlockingReason::kNotBlocked) {
-      sourceBlockingFutures_.emplace_back(std::move(future));
-      return nullptr;
+  // No merging is needed if there is only one source or if the sources are
+  // already in order.
+  if (sources_.size() == 1 || concatenate_) {
+    while (currentSource_ < sources_.size()) {
+      ContinueFuture future;
+      RowVectorPtr data;
+      auto reason = sources_[currentSource_]->next(data, &future);
+      if (reason != BlockingReason::kNotBlocked) {
+        sourceBlockingFutures_.emplace_back(std::move(future));
+        return nullptr;
+      }
+      if (data) {
+        return data;
+      }
+      ++currentSource_;
     }
-
-    finished_ = data == nullptr;
-    return data;
+    finished_ = true;
+    return nullptr;
   }
 
   if (!output_) {
@@ -130,7 +137,18 @@ RowVectorPtr Merge::getOutput() {
   }
 
   for (;;) {
-    auto stream = treeOfLosers_->next();
+    SourceStream* stream;
+    vector_size_t count = 1;
+    if (mergeRuns_) {
+      auto [winner, runnerUp] = treeOfLosers_->nextWithRunnerUp();
+      stream = winner;
+      if (stream) {
+        count = stream->numRowsNotAfter(
+            runnerUp, outputBatchSize_ - outputSize_);
+      }
+    } else {
+      stream = treeOfLosers_->next();
+    }
 
     if (!stream) {
       output_->resize(outputSize_);
@@ -138,16 +156,21 @@ RowVectorPtr Merge::getOutput() {
       return std::move(output_);
     }
 
-    if (stream->setOutputRow(outputSize_)) {
+    if (stream != lastStream_) {
+      lastStream_ = stream;
+      ++numRuns_;
+    }
+
+    if (stream->setOutputRows(outputSize_, count)) {
       // The stream is at end of input batch. Need to copy out the rows before
       // fetching next batch in 'pop'.
       stream->copyToOutput(output_);
     }
 
-    ++outputSize_;
+    outputSize_ += count;
 
     // Advance the stream.
-    stream->pop(sourceBlockingFutures_);
+    stream->pop(sourceBlockingFutures_, count);
 
     if (outputSize_ == outputBatchSize_) {
       // Copy out data from all sources.
@@ -155,6 +178,9 @@ RowVectorPtr Merge::getOutput() {
         s->copyToOutput(output_);
       }
 
+      mergeRuns_ = outputSize_ >= numRuns_ * kMinMergeRun;
+      lastStream_ = nullptr;
+      numRuns_ = 0;
       outputSize_ = 0;
       return std::move(output_);
     }
@@ -165,8 +191,8 @@ RowVectorPtr Merge::getOutput() {
   }
 }
 
-bool SourceStream::operator<(const MergeStream& other) const {
-  const auto& otherCursor = static_cast<const SourceStream&>(other);
+int32_t SourceStream::compare(vector_size_t row, const SourceStream& other)
+    const {
   for (auto i = 0; i < sortingKeys_.size(); ++i) {
     const auto& [_, compareFlags] = sortingKeys_[i];
     VELOX_DCHECK(
@@ -174,22 +200,60 @@ bool SourceStream::operator<(const MergeStream& other) const {
         "stopAtNull not supported for merge compare flags");
     if (auto result = keyColumns_[i]
                           ->compare(
-                              otherCursor.keyColumns_[i],
-                              currentSourceRow_,
-                              otherCursor.currentSourceRow_,
+                              other.keyColumns_[i],
+                              row,
+                              other.currentSourceRow_,
                               compareFlags)
                           .value()) {
-      return result < 0;
+      return result;
     }
   }
-  return false;
+  return 0;
 }
 
-bool SourceStream::pop(std::vector<ContinueFuture>& futures) {
-  ++currentSourceRow_;
+bool SourceStream::operator<(const MergeStream& other) const {
+  return compare(currentSourceRow_, static_cast<const SourceStream&>(other)) <
+      0;
+}
+
+vector_size_t SourceStream::numRowsNotAfter(
+    const SourceStream* other,
+    vector_size_t maxRows) const {
+  const auto end =
+      std::min<vector_size_t>(data_->size(), currentSourceRow_ + maxRows);
+  if (!other) {
+    return end - currentSourceRow_;
+  }
+  // The current row is not after 'other'. Gallops forward so that a short
+  // run costs few comparisons and then bisects between the last row known
+  // not to be after 'other' and the first row known to be after it.
+  auto notAfter = currentSourceRow_;
+  auto after = end;
+  for (vector_size_t step = 1; notAfter + step < end; step *= 2) {
+    if (compare(notAfter + step, *other) > 0) {
+      after = notAfter + step;
+      break;
+    }
+    notAfter += step;
+  }
+  while (after - notAfter > 1) {
+    const auto middle = notAfter + (after - notAfter) / 2;
+    if (compare(middle, *other) > 0) {
+      after = middle;
+    } else {
+      notAfter = middle;
+    }
+  }
+  return after - currentSourceRow_;
+}
+
+bool SourceStream::pop(
+    std::vector<ContinueFuture>& futures,
+    vector_size_t count) {
+  currentSourceRow_ += count;
   if (currentSourceRow_ == data_->size()) {
     // Make sure all current data has been copied out.
-    VELOX_CHECK(!outputRows_.hasSelections());
+    VELOX_CHECK(outputRuns_.empty());
     return fetchMoreData(futures);
   }
 
@@ -197,22 +261,43 @@ bool SourceStream::pop(std::vector<ContinueFuture>& futures) {
 }
 
 void SourceStream::copyToOutput(RowVectorPtr& output) {
-  outputRows_.updateBounds();
-
-  if (!outputRows_.hasSelections()) {
+  if (outputRuns_.empty()) {
     return;
   }
 
+  vector_size_t numRows = 0;
+  for (const auto& [_, count] : outputRuns_) {
+    numRows += count;
+  }
+
   vector_size_t sourceRow = firstSourceRow_;
-  outputRows_.applyToSelected(
-      [&](auto row) { sourceRows_[row] = sourceRow++; });
+  const vector_size_t numRuns = outputRuns_.size();
+  if (numRows >= numRuns * kMinCopyRun) {
+    // Long runs are copied as ranges, which copies values and nulls in bulk.
+    for (auto i = 0; i < output->type()->size(); ++i) {
+      auto* source = data_->childAt(i).get();
+      sourceRow = firstSourceRow_;
+      for (const auto& [outputRow, count] : outputRuns_) {
+        output->childAt(i)->copy(source, outputRow, sourceRow, count);
+        sourceRow += count;
+      }
+    }
+  } else {
+    for (const auto& [outputRow, count] : outputRuns_) {
+      outputRows_.setValidRange(outputRow, outputRow + count, true);
+    }
+    outputRows_.updateBounds();
+    outputRows_.applyToSelected(
+        [&](auto row) { sourceRows_[row] = sourceRow++; });
 
-  for (auto i = 0; i < output->type()->size(); ++i) {
-    output->childAt(i)->copy(
-        data_->childAt(i).get(), outputRows_, sourceRows_.data());
-  }
+    for (auto i = 0; i < output->type()->size(); ++i) {
+      output->childAt(i)->copy(
+          data_->childAt(i).get(), outputRows_, sourceRows_.data());
+    }
 
-  outputRows_.clearAll();
+    outputRows_.clearAll();
+  }
+  outputRuns_.clear();
 
   if (sourceRow == data_->size()) {
     firstSourceRow_ = 0;
@@ -262,6 +347,11 @@ LocalMerge::LocalMerge(
       operatorCtx_->driverCtx()->driverId,
       0,
       "LocalMerge needs to run single-threaded");
+  if (auto orderBy = std::dynamic_pointer_cast<const core::OrderByNode>(
+          localMergeNode->sources()[0])) {
+    concatenate_ = OrderBy::isRangeMerge(
+        *orderBy, *localMergeNode, driverCtx->queryConfig());
+  }
 }
 
 BlockingReason LocalMerge::addMergeSources(ContinueFuture* /* future */) {
@@ -283,7 +373,8 @@ MergeExchange::MergeExchange(
           mergeExchangeNode->sortingKeys(),
           mergeExchangeNode->sortingOrders(),
           mergeExchangeNode->id(),
-          "MergeExchange") {}
+          "MergeExchange"),
+      serdeOptions_(exchangeSerdeOptions(driverCtx->queryConfig())) {}
 
 BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
   if (operatorCtx_->driverCtx()->driverId != 0) {
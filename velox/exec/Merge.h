@@ -57,6 +57,11 @@ class Merge : public SourceOperator {
 
   std::vector<std::shared_ptr<MergeSource>> sources_;
 
+  /// True if the sources hold consecutive key ranges in the order of
+  /// 'sources_'. The sources are then read one after the other instead of
+  /// being merged. See OrderBy::isRangeMerge().
+  bool concatenate_{false};
+
  private:
   void initializeTreeOfLosers();
 
@@ -77,8 +82,28 @@ class Merge : public SourceOperator {
   /// Number of rows accumulated in 'output_' so far.
   vector_size_t outputSize_{0};
 
+  /// Minimum average number of consecutive output rows from the same source
+  /// for merging runs of rows, see mergeRuns_.
+  static constexpr vector_size_t kMinMergeRun = 4;
+
+  /// True if the tree of losers returns the runner-up with the winner so that
+  /// all the rows of the winner up to the runner-up's key are taken at once.
+  /// This costs an extra comparison per level of the tree for each winner and
+  /// pays off when the sources have runs of non-overlapping rows. Decided for
+  /// each output batch from the runs in the previous batch.
+  bool mergeRuns_{true};
+
+  /// The source of the last rows added to 'output_'.
+  SourceStream* lastStream_{nullptr};
+
+  /// Number of runs of consecutive rows from the same source in 'output_'.
+  vector_size_t numRuns_{0};
+
   bool finished_{false};
 
+  /// Source being read if there is one source or if 'concatenate_' is true.
+  size_t currentSource_{0};
+
   /// A list of blocking futures for sources. These are populates when a given
   /// source is blocked waiting for the next batch of data.
   std::vector<ContinueFuture> sourceBlockingFutures_;
@@ -114,20 +139,35 @@ class SourceStream final : public MergeStream {
   /// 'other'.
   bool operator<(const MergeStream& other) const override;
 
-  /// Advances to the next row. Returns true and appends a future to 'futures'
+  /// Returns the number of rows from the current row on that are not greater
+  /// than the current row of 'other', at least 1 and at most 'maxRows'. These
+  /// rows come before 'other' in the merge if this is the winner and 'other'
+  /// the runner-up of TreeOfLosers::nextWithRunnerUp(). Returns the number of
+  /// rows left in the current batch, up to 'maxRows', if 'other' is nullptr.
+  vector_size_t numRowsNotAfter(
+      const SourceStream* other,
+      vector_size_t maxRows) const;
+
+  /// Advances by 'count' rows. Returns true and appends a future to 'futures'
   /// if runs out of rows in the current batch and needs to wait for the
   /// source to produce the next batch. The return flag has the meaning of
   /// 'is-blocked'.
-  bool pop(std::vector<ContinueFuture>& futures);
-
-  /// Records the output row number for the current row. Returns true if
-  /// current row is the last row in the current batch, in which case the
-  /// caller must call 'copyToOutput' before calling pop(). The caller must
-  /// call 'setOutputRow' before calling 'pop'. The output rows must
-  /// monotonically increase in between calls to 'copyToOutput'.
-  bool setOutputRow(vector_size_t row) {
-    outputRows_.setValid(row, true);
-    return currentSourceRow_ == data_->size() - 1;
+  bool pop(std::vector<ContinueFuture>& futures, vector_size_t count = 1);
+
+  /// Records the output row numbers 'row' to 'row + count - 1' for 'count'
+  /// rows from the current row on. Returns true if these include the last row
+  /// in the current batch, in which case the caller must call 'copyToOutput'
+  /// before calling pop(). The caller must call 'setOutputRows' before
+  /// calling 'pop'. The output rows must monotonically increase in between
+  /// calls to 'copyToOutput'.
+  bool setOutputRows(vector_size_t row, vector_size_t count = 1) {
+    if (!outputRuns_.empty() &&
+        outputRuns_.back().first + outputRuns_.back().second == row) {
+      outputRuns_.back().second += count;
+    } else {
+      outputRuns_.emplace_back(row, count);
+    }
+    return currentSourceRow_ + count == data_->size();
   }
 
   /// Called if either current row is the last row in the current batch or the
@@ -136,8 +176,16 @@ class SourceStream final : public MergeStream {
   void copyToOutput(RowVectorPtr& output);
 
  private:
+  /// Minimum average number of rows in the runs of consecutive output rows
+  /// for copying the runs one at a time instead of copying all rows with one
+  /// selective copy.
+  static constexpr vector_size_t kMinCopyRun = 16;
+
   bool fetchMoreData(std::vector<ContinueFuture>& futures);
 
+  /// Compares 'row' with the current row of 'other'.
+  int32_t compare(vector_size_t row, const SourceStream& other) const;
+
   MergeSource* source_;
 
   const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys_;
@@ -162,7 +210,11 @@ class SourceStream final : public MergeStream {
   /// First source row that hasn't been copied out yet.
   vector_size_t firstSourceRow_{0};
 
-  /// Output row numbers for source rows that haven't been copied out yet.
+  /// Output row number and number of rows of the runs of consecutive output
+  /// rows for the source rows that haven't been copied out yet.
+  std::vector<std::pair<vector_size_t, vector_size_t>> outputRuns_;
+
+  /// Reusable memory.
   SelectivityVector outputRows_;
 
   /// Reusable memory.
@@ -171,7 +223,9 @@ class SourceStream final : public MergeStream {
 
 // LocalMerge merges its source's output into a single stream of
 // sorted rows. It runs single threaded. The sources may run multi-threaded and
-// in the same task.
+// in the same task. If the source is an OrderBy in range merge mode, the
+// Drivers of the source produce consecutive ranges and LocalMerge
+// concatenates these.
 class LocalMerge : public Merge {
  public:
   LocalMerge(
@@ -193,10 +247,15 @@ class MergeExchange : public Merge {
       DriverCtx* driverCtx,
       const std::shared_ptr<const core::MergeExchangeNode>& orderByNode);
 
+  const VectorSerde::Options& serdeOptions() const {
+    return serdeOptions_;
+  }
+
  protected:
   BlockingReason addMergeSources(ContinueFuture* future) override;
 
  private:
+  const VectorSerde::Options serdeOptions_;
   bool noMoreSplits_ = false;
   size_t numSplits_{0}; // Number of splits we took to process so far.
 };
@@ -137,6 +137,81 @@ void MergeJoin::addInput(RowVectorPtr input) {
   }
 }
 
+namespace {
+template <typename T>
+int32_t compareFlat(
+    const BaseVector& key,
+    vector_size_t index,
+    const BaseVector& otherKey,
+    vector_size_t otherIndex) {
+  const auto value = key.asUnchecked<FlatVector<T>>()->valueAtFast(index);
+  const auto otherValue =
+      otherKey.asUnchecked<FlatVector<T>>()->valueAtFast(otherIndex);
+  if (value == otherValue) {
+    return 0;
+  }
+  return value < otherValue ? -1 : 1;
+}
+
+// Compares 'index' row of 'key' with 'otherIndex' row of 'otherKey' without
+// going through the virtual BaseVector::compare for the common key types.
+int32_t compareKeys(
+    const BaseVector& key,
+    vector_size_t index,
+    const BaseVector& otherKey,
+    vector_size_t otherIndex) {
+  if (key.isFlatEncoding() && otherKey.isFlatEncoding() &&
+      !(key.rawNulls() && bits::isBitNull(key.rawNulls(), index)) &&
+      !(otherKey.rawNulls() &&
+        bits::isBitNull(otherKey.rawNulls(), otherIndex))) {
+    switch (key.typeKind()) {
+      case TypeKind::BIGINT:
+        return compareFlat<int64_t>(key, index, otherKey, otherIndex);
+      case TypeKind::INTEGER:
+        return compareFlat<int32_t>(key, index, otherKey, otherIndex);
+      case TypeKind::VARCHAR:
+        return compareFlat<StringView>(key, index, otherKey, otherIndex);
+      case TypeKind::DATE:
+        return compareFlat<Date>(key, index, otherKey, otherIndex);
+      default:
+        break;
+    }
+  }
+  return key.compare(&otherKey, index, otherIndex);
+}
+
+// Returns the first row after 'index' with a value different from 'index'.
+// The rows with equal values are consecutive, so the end of a long run is
+// found with an exponential search followed by a binary search.
+template <typename T>
+vector_size_t
+findEndOfRun(const T* values, vector_size_t index, vector_size_t size) {
+  const auto value = values[index];
+  // 'index' + 'step' / 2 is in the run, 'index' + 'step' may not be.
+  vector_size_t step = 1;
+  while (step < size - index && values[index + step] == value) {
+    step *= 2;
+  }
+  auto begin = index + step / 2 + 1;
+  auto end = std::min<vector_size_t>(index + step, size);
+  while (begin < end) {
+    const auto middle = begin + (end - begin) / 2;
+    if (values[middle] == value) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  return begin;
+}
+
+template <typename T>
+vector_size_t findEndOfFlatRun(const BaseVector& key, vector_size_t index) {
+  return findEndOfRun(
+      key.asUnchecked<FlatVector<T>>()->rawValues(), index, key.size());
+}
+} // namespace
+
 // static
 int32_t MergeJoin::compare(
     const std::vector<column_index_t>& keys,
@@ -146,8 +221,11 @@ int32_t MergeJoin::compare(
     const RowVectorPtr& otherBatch,
     vector_size_t otherIndex) {
   for (auto i = 0; i < keys.size(); ++i) {
-    auto compare = batch->childAt(keys[i])->compare(
-        otherBatch->childAt(otherKeys[i]).get(), index, otherIndex);
+    auto compare = compareKeys(
+        *batch->childAt(keys[i]),
+        index,
+        *otherBatch->childAt(otherKeys[i]),
+        otherIndex);
     if (compare != 0) {
       return compare;
     }
@@ -156,6 +234,38 @@ int32_t MergeJoin::compare(
   return 0;
 }
 
+// static
+vector_size_t MergeJoin::findEndOfRun(
+    const std::vector<column_index_t>& keys,
+    const RowVectorPtr& batch,
+    vector_size_t index) {
+  const auto numRows = batch->size();
+  if (keys.size() == 1) {
+    const auto& key = *batch->childAt(keys[0]);
+    if (key.isFlatEncoding() && !key.rawNulls()) {
+      switch (key.typeKind()) {
+        case TypeKind::BIGINT:
+          return findEndOfFlatRun<int64_t>(key, index);
+        case TypeKind::INTEGER:
+          return findEndOfFlatRun<int32_t>(key, index);
+        case TypeKind::VARCHAR:
+          return findEndOfFlatRun<StringView>(key, index);
+        case TypeKind::DATE:
+          return findEndOfFlatRun<Date>(key, index);
+        default:
+          break;
+      }
+    }
+  }
+
+  vector_size_t endIndex = index + 1;
+  while (endIndex < numRows &&
+         compare(keys, batch, index, keys, batch, endIndex) == 0) {
+    ++endIndex;
+  }
+  return endIndex;
+}
+
 bool MergeJoin::findEndOfMatch(
     Match& match,
     const RowVectorPtr& input,
@@ -170,9 +280,9 @@ bool MergeJoin::findEndOfMatch(
   auto numInput = input->size();
 
   vector_size_t endIndex = 0;
-  while (endIndex < numInput &&
-         compare(keys, input, endIndex, keys, prevInput, prevIndex) == 0) {
-    ++endIndex;
+  if (numInput > 0 &&
+      compare(keys, input, 0, keys, prevInput, prevIndex) == 0) {
+    endIndex = findEndOfRun(keys, input, 0);
   }
 
   if (endIndex == numInput) {
@@ -209,6 +319,21 @@ void copyRow(
 } // namespace
 
 void MergeJoin::addOutputRowForLeftJoin() {
+  if (!filter_) {
+    if (outputSize_ == 0) {
+      outputLeft_ = input_;
+    }
+    if (!rightNulls_) {
+      rightNulls_ = AlignedBuffer::allocate<bool>(
+          outputBatchSize_, pool(), bits::kNotNull);
+    }
+    rawLeftIndices_[outputSize_] = index_;
+    rawRightIndices_[outputSize_] = 0;
+    bits::setNull(rightNulls_->asMutable<uint64_t>(), outputSize_);
+    ++outputSize_;
+    return;
+  }
+
   copyRow(input_, index_, output_, outputSize_, leftProjections_);
 
   for (const auto& projection : rightProjections_) {
@@ -224,6 +349,29 @@ void MergeJoin::addOutputRowForLeftJoin() {
   ++outputSize_;
 }
 
+vector_size_t MergeJoin::addOutputRows(
+    const RowVectorPtr& left,
+    vector_size_t leftIndex,
+    const RowVectorPtr& right,
+    vector_size_t rightStart,
+    vector_size_t rightEnd) {
+  if (outputSize_ == 0) {
+    outputLeft_ = left;
+  }
+  if (!outputRight_) {
+    outputRight_ = right;
+  }
+  const auto numRows = std::min<vector_size_t>(
+      rightEnd - rightStart, outputBatchSize_ - outputSize_);
+  std::fill_n(rawLeftIndices_ + outputSize_, numRows, leftIndex);
+  std::iota(
+      rawRightIndices_ + outputSize_,
+      rawRightIndices_ + outputSize_ + numRows,
+      rightStart);
+  outputSize_ += numRows;
+  return numRows;
+}
+
 void MergeJoin::addOutputRow(
     const RowVectorPtr& left,
     vector_size_t leftIndex,
@@ -248,6 +396,17 @@ void MergeJoin::addOutputRow(
 }
 
 void MergeJoin::prepareOutput() {
+  if (!filter_) {
+    if (!leftIndices_) {
+      leftIndices_ = allocateIndices(outputBatchSize_, pool());
+      rawLeftIndices_ = leftIndices_->asMutable<vector_size_t>();
+      rightIndices_ = allocateIndices(outputBatchSize_, pool());
+      rawRightIndices_ = rightIndices_->asMutable<vector_size_t>();
+      outputSize_ = 0;
+    }
+    return;
+  }
+
   if (output_ == nullptr) {
     std::vector<VectorPtr> localColumns(outputType_->size());
     for (auto i = 0; i < outputType_->size(); ++i) {
@@ -334,13 +493,18 @@ bool MergeJoin::addToOutput() {
         auto rightEnd =
             r == numRights - 1 ? rightMatch_->endIndex : right->size();
 
-        for (auto j = rightStart; j < rightEnd; ++j) {
-          if (outputSize_ == outputBatchSize_) {
+        for (auto j = rightStart; j < rightEnd;) {
+          if (isOutputFull(left, right)) {
             leftMatch_->setCursor(l, i);
             rightMatch_->setCursor(r, j);
             return true;
           }
-          addOutputRow(left, i, right, j);
+          if (filter_) {
+            addOutputRow(left, i, right, j);
+            ++j;
+          } else {
+            j += addOutputRows(left, i, right, j, rightEnd);
+          }
         }
       }
     }
@@ -352,6 +516,45 @@ bool MergeJoin::addToOutput() {
   return outputSize_ == outputBatchSize_;
 }
 
+RowVectorPtr MergeJoin::produceOutput() {
+  if (filter_) {
+    output_->resize(outputSize_);
+    return std::move(output_);
+  }
+
+  std::vector<VectorPtr> columns(outputType_->size());
+  for (const auto& projection : leftProjections_) {
+    columns[projection.outputChannel] = wrapChild(
+        outputSize_,
+        leftIndices_,
+        outputLeft_->childAt(projection.inputChannel));
+  }
+  for (const auto& projection : rightProjections_) {
+    if (outputRight_) {
+      columns[projection.outputChannel] = wrapChild(
+          outputSize_,
+          rightIndices_,
+          outputRight_->childAt(projection.inputChannel),
+          rightNulls_);
+    } else {
+      columns[projection.outputChannel] = BaseVector::createNullConstant(
+          outputType_->childAt(projection.outputChannel), outputSize_, pool());
+    }
+  }
+  auto output = std::make_shared<RowVector>(
+      pool(), outputType_, BufferPtr(nullptr), outputSize_, std::move(columns));
+
+  // The buffers are now referenced by 'output'. Allocate new ones for the
+  // next batch.
+  outputLeft_ = nullptr;
+  outputRight_ = nullptr;
+  leftIndices_ = nullptr;
+  rightIndices_ = nullptr;
+  rightNulls_ = nullptr;
+  outputSize_ = 0;
+  return output;
+}
+
 RowVectorPtr MergeJoin::getOutput() {
   // Make sure to have is-blocked or needs-input as true if returning null
   // output. Otherwise, Driver assumes the operator is finished.
@@ -409,7 +612,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
     // Not all rows from the last match fit in the output. Continue producing
     // results from the current match.
     if (addToOutput()) {
-      return std::move(output_);
+      return produceOutput();
     }
   }
 
@@ -460,7 +663,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
     VELOX_CHECK(rightMatch_ && rightMatch_->complete);
 
     if (addToOutput()) {
-      return std::move(output_);
+      return produceOutput();
     }
   }
 
@@ -469,8 +672,8 @@ RowVectorPtr MergeJoin::doGetOutput() {
       if (input_ && noMoreRightInput_) {
         prepareOutput();
         while (true) {
-          if (outputSize_ == outputBatchSize_) {
-            return std::move(output_);
+          if (isOutputFull(input_, nullptr)) {
+            return produceOutput();
           }
 
           addOutputRowForLeftJoin();
@@ -484,15 +687,13 @@ RowVectorPtr MergeJoin::doGetOutput() {
         }
       }
 
-      if (noMoreInput_ && output_) {
-        output_->resize(outputSize_);
-        return std::move(output_);
+      if (noMoreInput_ && hasOutput()) {
+        return produceOutput();
       }
     } else {
       if (noMoreInput_ || noMoreRightInput_) {
-        if (output_) {
-          output_->resize(outputSize_);
-          return std::move(output_);
+        if (hasOutput()) {
+          return produceOutput();
         }
         input_ = nullptr;
       }
@@ -511,8 +712,8 @@ RowVectorPtr MergeJoin::doGetOutput() {
       if (isLeftJoin(joinType_)) {
         prepareOutput();
 
-        if (outputSize_ == outputBatchSize_) {
-          return std::move(output_);
+        if (isOutputFull(input_, nullptr)) {
+          return produceOutput();
         }
 
         addOutputRowForLeftJoin();
@@ -541,10 +742,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
     if (compareResult == 0) {
       // Found a match. Identify all rows on the left and right that have the
       // matching keys.
-      vector_size_t endIndex = index_ + 1;
-      while (endIndex < input_->size() && compareLeft(endIndex) == 0) {
-        ++endIndex;
-      }
+      const auto endIndex = findEndOfRun(leftKeys_, input_, index_);
 
       if (endIndex == input_->size()) {
         // Matches continue in subsequent input. Load all lazies.
@@ -553,11 +751,8 @@ RowVectorPtr MergeJoin::doGetOutput() {
       leftMatch_ = Match{
           {input_}, index_, endIndex, endIndex < input_->size(), std::nullopt};
 
-      vector_size_t endRightIndex = rightIndex_ + 1;
-      while (endRightIndex < rightInput_->size() &&
-             compareRight(endRightIndex) == 0) {
-        ++endRightIndex;
-      }
+      const auto endRightIndex =
+          findEndOfRun(rightKeys_, rightInput_, rightIndex_);
 
       rightMatch_ = Match{
           {rightInput_},
@@ -583,7 +778,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
       rightIndex_ = endRightIndex;
 
       if (addToOutput()) {
-        return std::move(output_);
+        return produceOutput();
       }
 
       compareResult = compare();
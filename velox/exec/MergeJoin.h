@@ -59,23 +59,22 @@ class MergeJoin : public Operator {
       const RowVectorPtr& otherBatch,
       vector_size_t otherIndex);
 
+  // Returns the first row after 'index' in 'batch' whose keys differ from the
+  // keys of 'index', or the size of 'batch' if there is no such row. Relies on
+  // 'batch' being sorted on 'keys'. A single flat key without nulls is
+  // scanned on its raw values with an exponential search for the end of the
+  // run.
+  static vector_size_t findEndOfRun(
+      const std::vector<column_index_t>& keys,
+      const RowVectorPtr& batch,
+      vector_size_t index);
+
   // Compare rows on the left and right at index_ and rightIndex_ respectively.
   int32_t compare() const {
     return compare(
         leftKeys_, input_, index_, rightKeys_, rightInput_, rightIndex_);
   }
 
-  // Compare two rows on the left: index_ and index.
-  int32_t compareLeft(vector_size_t index) const {
-    return compare(leftKeys_, input_, index_, leftKeys_, input_, index);
-  }
-
-  // Compare two rows on the right: rightIndex_ and index.
-  int32_t compareRight(vector_size_t index) const {
-    return compare(
-        rightKeys_, rightInput_, rightIndex_, rightKeys_, rightInput_, index);
-  }
-
   // Compare two rows from the left side.
   int32_t compareLeft(
       const RowVectorPtr& batch,
@@ -148,9 +147,33 @@ class MergeJoin : public Operator {
       const std::vector<column_index_t>& keys);
 
   /// Initialize 'output_' vector using 'ouputType_' and 'outputBatchSize_' if
-  /// it is null.
+  /// it is null. Without a filter, allocates the index buffers for the
+  /// dictionary output instead.
   void prepareOutput();
 
+  /// Returns true if there is an output batch in progress.
+  bool hasOutput() const {
+    return filter_ ? output_ != nullptr : outputSize_ > 0;
+  }
+
+  /// Returns true if no row from 'left' and 'right' can be added to the
+  /// output. Dictionary output is full when it has 'outputBatchSize_' rows or
+  /// when its rows refer to a different batch than 'left' or 'right'. A null
+  /// 'right' is a left-side row without a match.
+  bool isOutputFull(const RowVectorPtr& left, const RowVectorPtr& right) const {
+    if (outputSize_ == outputBatchSize_) {
+      return true;
+    }
+    if (filter_ || outputSize_ == 0) {
+      return false;
+    }
+    return left != outputLeft_ ||
+        (right != nullptr && outputRight_ != nullptr && right != outputRight_);
+  }
+
+  /// Returns the output batch in progress and resets the output state.
+  RowVectorPtr produceOutput();
+
   // Appends a cartesian product of the current set of matching rows, leftMatch_
   // x rightMatch_, to output_. Returns true if output_ is full. Sets
   // leftMatchCursor_ and rightMatchCursor_ if output_ filled up before all the
@@ -161,21 +184,30 @@ class MergeJoin : public Operator {
   bool addToOutput();
 
   // Adds one row of output by copying values from left and right batches at the
-  // specified rows. Advances outputSize_. Assumes that output_ has room.
-  //
-  // TODO: Copying is inefficient especially for complex type values. Consider
-  // an optimization of using dictionary wrapping when full batch of output can
-  // be produced using single batch of input from the left side and single batch
-  // of input from the right side.
+  // specified rows. Advances outputSize_. Assumes that output_ has room. Used
+  // only with a filter, which is evaluated on copies of the filter inputs.
   void addOutputRow(
       const RowVectorPtr& left,
       vector_size_t leftIndex,
       const RowVectorPtr& right,
       vector_size_t rightIndex);
 
+  /// Adds up to 'rightEnd' - 'rightStart' rows of output that pair the
+  /// 'leftIndex' row of 'left' with the consecutive rows of 'right' starting
+  /// at 'rightStart'. Used without a filter. Records the rows as index ranges
+  /// into 'left' and 'right' for dictionary output. Returns the number of
+  /// rows added, which is limited by the room in the output.
+  vector_size_t addOutputRows(
+      const RowVectorPtr& left,
+      vector_size_t leftIndex,
+      const RowVectorPtr& right,
+      vector_size_t rightStart,
+      vector_size_t rightEnd);
+
   /// Adds one row of output for a left-side row with no right-side match.
-  /// Copies values from the 'index_' row on the left side and fills in nulls
-  /// for columns that correspond to the right side.
+  /// Copies values from the 'index_' row on the left side, or records its
+  /// index for dictionary output, and fills in nulls for columns that
+  /// correspond to the right side.
   void addOutputRowForLeftJoin();
 
   /// Evaluates join filter on 'filterInput_' and returns 'output' that contains
@@ -383,10 +415,27 @@ class MergeJoin : public Operator {
   /// A set of rows with matching keys on the right side.
   std::optional<Match> rightMatch_;
 
+  /// Output batch in progress when there is a filter. Rows are copied into
+  /// it, see addOutputRow().
   RowVectorPtr output_;
 
-  /// Number of rows accumulated in the output_.
-  vector_size_t outputSize_;
+  /// Without a filter, the output is made of dictionaries over a single left
+  /// batch and a single right batch. These are the batches and the indices of
+  /// the output rows in them. 'outputRight_' is null if all rows of the
+  /// output are left-side rows without a match.
+  RowVectorPtr outputLeft_;
+  RowVectorPtr outputRight_;
+  BufferPtr leftIndices_;
+  vector_size_t* rawLeftIndices_{nullptr};
+  BufferPtr rightIndices_;
+  vector_size_t* rawRightIndices_{nullptr};
+
+  /// Nulls for the right-side columns of the dictionary output. Set for
+  /// left-side rows without a match. Allocated on first use.
+  BufferPtr rightNulls_;
+
+  /// Number of rows accumulated in the output.
+  vector_size_t outputSize_{0};
 
   /// A future that will be completed when right side input becomes available.
   ContinueFuture future_{ContinueFuture::makeEmpty()};
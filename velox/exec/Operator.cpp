@@ -78,7 +78,10 @@ OperatorCtx::createConnectorQueryCtx(
       driverCtx_->task->queryCtx()->getConnectorConfig(connectorId),
       expressionEvaluator_.get(),
       driverCtx_->task->queryCtx()->mappedMemory(),
-      fmt::format("{}.{}", driverCtx_->task->taskId(), planNodeId));
+      fmt::format("{}.{}", driverCtx_->task->taskId(), planNodeId),
+      driverCtx_->queryConfig().adaptiveFilterReorderingEnabled(),
+      driverCtx_->queryConfig().maxPendingConnectorBatches(),
+      driverCtx_->queryConfig().preserveConnectorBatchOrder());
 }
 
 std::vector<std::unique_ptr<Operator::PlanNodeTranslator>>&
@@ -154,6 +157,22 @@ const std::string& OperatorCtx::taskId() const {
   return driverCtx_->task->taskId();
 }
 
+std::optional<std::string> OperatorCtx::makeSpillPath() const {
+  auto path = driverCtx_->task->queryCtx()->config().spillPath();
+  if (path.has_value()) {
+    return taskId();
+  }
+  return std::nullopt;
+}
+
+std::vector<SpillDirectory*> OperatorCtx::spillDirectories() const {
+  auto path = driverCtx_->task->queryCtx()->config().spillPath();
+  if (path.has_value()) {
+    return SpillDirectory::parse(path.value());
+  }
+  return {};
+}
+
 static bool isSequence(
     const vector_size_t* numbers,
     vector_size_t start,
@@ -199,12 +218,52 @@ RowVectorPtr Operator::fillOutput(vector_size_t size, BufferPtr mapping) {
       std::move(columns));
 }
 
+vector_size_t Operator::outputBatchRows(
+    std::optional<uint64_t> averageRowSize) const {
+  const auto& queryConfig = operatorCtx_->driverCtx()->queryConfig();
+  if (!averageRowSize.has_value() ||
+      queryConfig.isPreferredOutputBatchSizeSet()) {
+    return queryConfig.preferredOutputBatchSize();
+  }
+  const uint64_t maxRows = queryConfig.maxOutputBatchRows();
+  return std::max<uint64_t>(
+      1,
+      std::min(
+          maxRows,
+          queryConfig.preferredOutputBatchBytes() /
+              std::max<uint64_t>(1, averageRowSize.value())));
+}
+
+// static
+std::optional<uint64_t> Operator::averageRowSize(const RowVector& vector) {
+  if (vector.size() == 0) {
+    return std::nullopt;
+  }
+  // A child may be longer than 'vector', e.g. the elements in an Unnest
+  // output, so the average is taken per child.
+  double size = 0;
+  for (const auto& child : vector.children()) {
+    if (child && child->size() > 0) {
+      size += 1.0 * child->estimateFlatSize() / child->size();
+    }
+  }
+  if (size == 0) {
+    return std::nullopt;
+  }
+  return std::max<uint64_t>(1, size);
+}
+
+void Operator::releaseReservation() {
+  operatorCtx_->mappedMemory()->tracker()->release();
+}
+
 void Operator::recordBlockingTime(uint64_t start) {
   uint64_t now =
       std::chrono::duration_cast<std::chrono::microseconds>(
           std::chrono::high_resolution_clock::now().time_since_epoch())
           .count();
   stats_.blockedWallNanos += (now - start) * 1000;
+  stats_.blockedWallNanosHistogram.add((now - start) * 1000);
 }
 
 std::string Operator::toString() const {
@@ -290,9 +349,12 @@ void OperatorStats::add(const OperatorStats& other) {
   physicalWrittenBytes += other.physicalWrittenBytes;
 
   blockedWallNanos += other.blockedWallNanos;
+  blockedWallNanosHistogram.merge(other.blockedWallNanosHistogram);
 
   finishTiming.add(other.finishTiming);
 
+  perfEventCounts.add(other.perfEventCounts);
+
   memoryStats.add(other.memoryStats);
 
   for (const auto& [name, stats] : other.runtimeStats) {
@@ -306,6 +368,9 @@ void OperatorStats::add(const OperatorStats& other) {
   numDrivers += other.numDrivers;
   spilledBytes += other.spilledBytes;
   spilledRows += other.spilledRows;
+  for (const auto& [directory, stats] : other.spillDirectoryStats) {
+    spillDirectoryStats[directory].add(stats);
+  }
 }
 
 void OperatorStats::clear() {
@@ -324,12 +389,16 @@ void OperatorStats::clear() {
   physicalWrittenBytes = 0;
 
   blockedWallNanos = 0;
+  blockedWallNanosHistogram = {};
 
   finishTiming.clear();
 
+  perfEventCounts.clear();
+
   memoryStats.clear();
 
   runtimeStats.clear();
+  spillDirectoryStats.clear();
 }
 
 } // namespace facebook::velox::exec
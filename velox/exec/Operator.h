@@ -15,10 +15,12 @@
  */
 #pragma once
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/process/PerfEvents.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Driver.h"
 #include "velox/exec/JoinBridge.h"
+#include "velox/exec/Spill.h"
 #include "velox/type/Filter.h"
 
 namespace facebook::velox::exec {
@@ -43,6 +45,9 @@ struct MemoryStats {
   uint64_t peakSystemMemoryReservation{0};
   uint64_t peakTotalMemoryReservation{0};
   uint64_t numMemoryAllocations{0};
+  // Bytes allocated from the tracker, excluding frees. See
+  // MemoryUsageTracker::getAllocatedBytes().
+  uint64_t allocatedBytes{0};
 
   void update(const std::shared_ptr<memory::MemoryUsageTracker>& tracker) {
     if (!tracker) {
@@ -54,6 +59,7 @@ struct MemoryStats {
     peakSystemMemoryReservation = tracker->getPeakSystemBytes();
     peakTotalMemoryReservation = tracker->getPeakTotalBytes();
     numMemoryAllocations = tracker->getNumAllocs();
+    allocatedBytes = tracker->getAllocatedBytes();
   }
 
   void add(const MemoryStats& other) {
@@ -67,6 +73,7 @@ struct MemoryStats {
     peakTotalMemoryReservation =
         std::max(peakTotalMemoryReservation, other.peakTotalMemoryReservation);
     numMemoryAllocations += other.numMemoryAllocations;
+    allocatedBytes += other.allocatedBytes;
   }
 
   void clear() {
@@ -77,6 +84,7 @@ struct MemoryStats {
     peakSystemMemoryReservation = 0;
     peakTotalMemoryReservation = 0;
     numMemoryAllocations = 0;
+    allocatedBytes = 0;
   }
 };
 
@@ -122,8 +130,15 @@ struct OperatorStats {
 
   uint64_t blockedWallNanos = 0;
 
+  /// The wall time of each wait of a blocked Driver on this operator.
+  RuntimeHistogram blockedWallNanosHistogram;
+
   CpuWallTiming finishTiming;
 
+  /// Hardware events of addInput, getOutput and finish. Counted only if
+  /// QueryConfig::perfEventsEnabled().
+  process::PerfEventCounts perfEventCounts;
+
   MemoryStats memoryStats;
 
   // Total bytes written for spilling.
@@ -132,6 +147,9 @@ struct OperatorStats {
   // Total rows written for spilling.
   uint64_t spilledRows{0};
 
+  // Bytes written to and read from spill files, keyed on spill directory.
+  std::unordered_map<std::string, SpillDirectoryStats> spillDirectoryStats;
+
   std::unordered_map<std::string, RuntimeMetric> runtimeStats;
 
   int numDrivers = 0;
@@ -148,13 +166,26 @@ struct OperatorStats {
 
   void addRuntimeStat(const std::string& name, const RuntimeCounter& value) {
     if (UNLIKELY(runtimeStats.count(name) == 0)) {
-      runtimeStats.insert(std::pair(name, RuntimeMetric(value.unit)));
+      runtimeStats.insert(
+          std::pair(name, RuntimeMetric(value.unit, value.histogram)));
     } else {
       VELOX_CHECK_EQ(runtimeStats.at(name).unit, value.unit);
     }
     runtimeStats.at(name).addValue(value.value);
   }
 
+  /// Returns the bytes allocated per second of wall time spent in addInput,
+  /// getOutput and finish. High rates point to operators that churn memory
+  /// in small allocations.
+  uint64_t allocatedBytesPerSecond() const {
+    auto wallNanos = addInputTiming.wallNanos + getOutputTiming.wallNanos +
+        finishTiming.wallNanos;
+    if (wallNanos == 0) {
+      return 0;
+    }
+    return memoryStats.allocatedBytes * 1'000'000'000.0 / wallNanos;
+  }
+
   void add(const OperatorStats& other);
   void clear();
 };
@@ -185,6 +216,16 @@ class OperatorCtx {
 
   core::ExecCtx* execCtx() const;
 
+  // Returns the path prefix for spill files of the operator relative to the
+  // directories from spillDirectories(). This is the task id. Returns
+  // std::nullopt if spilling is not enabled.
+  std::optional<std::string> makeSpillPath() const;
+
+  // Returns the directories in the spill path of the query config. The spill
+  // files of the operator are striped over these. Empty if spilling is not
+  // enabled.
+  std::vector<SpillDirectory*> spillDirectories() const;
+
   // Makes an extract of QueryCtx for use in a connector. 'planNodeId'
   // is the id of the calling TableScan. This and the task id identify
   // the scan for column access tracking.
@@ -328,6 +369,26 @@ class Operator {
         toString());
   }
 
+  // Returns the number of input rows after which this operator needs no
+  // more input, e.g. offset + count of a Limit, or std::nullopt if it needs
+  // all input.
+  virtual std::optional<int64_t> maxInputRows() const {
+    return std::nullopt;
+  }
+
+  // Returns true if this operator would accept a limit on the number of rows
+  // it produces from the downstream operator.
+  virtual bool canPushdownLimit() const {
+    return false;
+  }
+
+  // Tells this operator that the downstream operator needs no more than
+  // 'numRows' rows. Called only if canPushdownLimit() returns true.
+  virtual void pushdownLimit(int64_t /*numRows*/) {
+    VELOX_UNSUPPORTED(
+        "This operator doesn't support limit pushdown: {}", toString());
+  }
+
   // Returns a list of identify projections, e.g. columns that are projected
   // as-is possibly after applying a filter.
   const std::vector<IdentityProjection>& identityProjections() const {
@@ -341,6 +402,17 @@ class Operator {
     results_.clear();
   }
 
+  // Returns an estimate of the bytes reclaim() would free, 0 if 'this' holds
+  // no memory it can give up.
+  virtual int64_t reclaimableBytes() const {
+    return 0;
+  }
+
+  // Frees memory held by 'this', e.g. by spilling its state to disk, on
+  // behalf of another query. Called by MemoryArbitrator while the Task is
+  // paused and the Driver of 'this' is off thread.
+  virtual void reclaim() {}
+
   // Returns true if 'this' never has more output rows than input rows.
   virtual bool isFilter() const {
     return false;
@@ -399,6 +471,23 @@ class Operator {
   // 'identityProjections_' and 'resultProjections_'.
   RowVectorPtr fillOutput(vector_size_t size, BufferPtr mapping);
 
+  // Returns the number of rows for an output batch of rows of
+  // 'averageRowSize' bytes. This is the preferred output batch size of the
+  // query config if that is set or 'averageRowSize' is not known. Otherwise
+  // it is the preferred output batch bytes worth of rows, up to the max
+  // output batch rows.
+  vector_size_t outputBatchRows(
+      std::optional<uint64_t> averageRowSize = std::nullopt) const;
+
+  // Returns the average size of a row of 'vector' once its columns are
+  // flattened. Columns that are not loaded are not counted. Returns
+  // std::nullopt if no column has a size.
+  static std::optional<uint64_t> averageRowSize(const RowVector& vector);
+
+  // Called by reclaim() after spilling. Releases the memory reserved by
+  // 'this' so that MemoryArbitrator can grant it to another query.
+  void releaseReservation();
+
   std::unique_ptr<OperatorCtx> operatorCtx_;
   OperatorStats stats_;
   const std::shared_ptr<const RowType> outputType_;
@@ -14,84 +14,400 @@
  * limitations under the License.
  */
 #include "velox/exec/OrderBy.h"
+#include "velox/exec/PrefixSort.h"
+#include "velox/exec/Task.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
 
+namespace {
+// Number of rows sampled from the sorted runs per range when picking the
+// range boundaries.
+constexpr int64_t kSamplesPerRange = 128;
+} // namespace
+
 OrderBy::OrderBy(
     int32_t operatorId,
     DriverCtx* driverCtx,
-    const std::shared_ptr<const core::OrderByNode>& orderByNode)
+    const std::shared_ptr<const core::OrderByNode>& orderByNode,
+    const std::shared_ptr<const core::LocalMergeNode>& localMerge)
     : Operator(
           driverCtx,
           orderByNode->outputType(),
           operatorId,
           orderByNode->id(),
           "OrderBy"),
-      data_(std::make_unique<RowContainer>(
-          outputType_->as<TypeKind::ROW>().children(),
-          operatorCtx_->mappedMemory())) {
+      spillPath_(operatorCtx_->makeSpillPath()),
+      spillExecutor_(operatorCtx_->task()->queryCtx()->spillExecutor()),
+      spillCompression_(spillCodecType(
+          operatorCtx_->task()->queryCtx()->config().spillCompressionCodec())),
+      spillDirectories_(operatorCtx_->spillDirectories()),
+      testSpillPct_(
+          operatorCtx_->task()->queryCtx()->config().testingSpillPct()),
+      rangeMerge_(
+          localMerge &&
+          isRangeMerge(*orderByNode, *localMerge, driverCtx->queryConfig())) {
   auto type = orderByNode->outputType();
   auto numKeys = orderByNode->sortingKeys().size();
+  columnMap_.resize(type->size());
+  std::vector<bool> isKey(type->size(), false);
+  std::vector<TypePtr> keyTypes;
   for (int i = 0; i < numKeys; ++i) {
     auto channel = exprToChannel(orderByNode->sortingKeys()[i].get(), type);
     VELOX_CHECK(
         channel != kConstantChannel,
         "OrderBy doesn't allow constant grouping keys");
-    keyInfo_.emplace_back(channel, orderByNode->sortingOrders()[i]);
+    if (!isKey[channel]) {
+      isKey[channel] = true;
+      columnMap_[channel] = i;
+    }
+    containerChannels_.push_back(channel);
+    keyTypes.push_back(type->childAt(channel));
+    const auto& sortOrder = orderByNode->sortingOrders()[i];
+    keyCompareFlags_.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+  }
+
+  // The columns that are not sorting keys are stored as dependents.
+  std::vector<TypePtr> dependentTypes;
+  for (column_index_t channel = 0; channel < type->size(); ++channel) {
+    if (!isKey[channel]) {
+      columnMap_[channel] = containerChannels_.size();
+      containerChannels_.push_back(channel);
+      dependentTypes.push_back(type->childAt(channel));
+    }
   }
+
+  data_ = std::make_shared<RowContainer>(
+      keyTypes, dependentTypes, operatorCtx_->mappedMemory());
+}
+
+// static
+bool OrderBy::isRangeMerge(
+    const core::OrderByNode& orderBy,
+    const core::LocalMergeNode& localMerge,
+    const core::QueryConfig& config) {
+  if (!config.orderByRangeMerge() || config.spillPath().has_value() ||
+      !orderBy.isPartial() || localMerge.sources().size() != 1 ||
+      localMerge.sources()[0].get() != &orderBy) {
+    return false;
+  }
+  const auto& keys = orderBy.sortingKeys();
+  const auto& mergeKeys = localMerge.sortingKeys();
+  if (keys.size() != mergeKeys.size()) {
+    return false;
+  }
+  for (auto i = 0; i < keys.size(); ++i) {
+    const auto& order = orderBy.sortingOrders()[i];
+    const auto& mergeOrder = localMerge.sortingOrders()[i];
+    if (keys[i]->name() != mergeKeys[i]->name() ||
+        order.isAscending() != mergeOrder.isAscending() ||
+        order.isNullsFirst() != mergeOrder.isNullsFirst()) {
+      return false;
+    }
+  }
+  return true;
 }
 
 void OrderBy::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   SelectivityVector allRows(input->size());
   std::vector<char*> rows(input->size());
   for (int row = 0; row < input->size(); ++row) {
     rows[row] = data_->newRow();
   }
-  for (size_t col = 0; col < input->childrenSize(); ++col) {
-    DecodedVector decoded(*input->childAt(col), allRows);
+  for (size_t col = 0; col < containerChannels_.size(); ++col) {
+    DecodedVector decoded(*input->childAt(containerChannels_[col]), allRows);
     for (int i = 0; i < input->size(); ++i) {
       data_->store(decoded, i, rows[i], col);
     }
   }
 
   numRows_ += allRows.size();
+
+  if (spiller_) {
+    auto spilled = spiller_->spilledBytesAndRows();
+    stats_.spilledBytes = spilled.first;
+    stats_.spilledRows = spilled.second;
+    stats_.spillDirectoryStats = spiller_->spillDirectoryStats();
+  }
+}
+
+void OrderBy::ensureInputFits(const RowVectorPtr& input) {
+  // Spilling is considered only if spillPath is set.
+  if (!spillPath_.has_value()) {
+    return;
+  }
+  auto numRows = data_->numRows();
+  if (!numRows) {
+    // Nothing to spill.
+    return;
+  }
+
+  // Test-only spill path.
+  if (testSpillPct_ &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <= testSpillPct_) {
+    spill(0, 0);
+    return;
+  }
+
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  int64_t flatBytes = input->estimateFlatSize();
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the
+  // input as a cap on the new variable length data needed.
+  auto increment =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatBytes : 0);
+  auto tracker = operatorCtx_->mappedMemory()->tracker();
+  assert(tracker);
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * increment) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of
+  // twice the maximum increment from this input and 1/4 of the current
+  // reservation.
+  auto targetIncrement =
+      std::max<int64_t>(increment * 2, tracker->getCurrentUserBytes() / 4);
+  if (tracker->maybeReserve(targetIncrement)) {
+    return;
+  }
+
+  // Spill all rows as one sorted run. Spilling only a part of the rows would
+  // produce shorter runs and more streams to merge.
+  spill(0, 0);
+}
+
+void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
+  if (!spiller_) {
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < containerChannels_.size(); ++i) {
+      names.push_back(fmt::format("s{}", i));
+      types.push_back(outputType_->childAt(containerChannels_[i]));
+    }
+    assert(operatorCtx_->mappedMemory()->tracker()); // lint
+    auto fileSize =
+        operatorCtx_->mappedMemory()->tracker()->getCurrentUserBytes() / 4;
+    spiller_ = std::make_unique<Spiller>(
+        *data_,
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        ROW(std::move(names), std::move(types)),
+        // A single spill partition. The order is global so there is nothing
+        // to partition.
+        HashBitRange(0, 0),
+        keyCompareFlags_.size(),
+        spillPath_.value(),
+        fileSize,
+        Spiller::spillPool(),
+        spillExecutor_,
+        keyCompareFlags_,
+        spillCompression_,
+        spillDirectories_);
+  }
+  spiller_->spill(targetRows, targetBytes, spillIterator_);
+}
+
+int64_t OrderBy::reclaimableBytes() const {
+  if (!spillPath_.has_value() || noMoreInput_ || data_->numRows() == 0) {
+    return 0;
+  }
+  return data_->allocatedBytes();
+}
+
+void OrderBy::reclaim() {
+  if (reclaimableBytes() == 0) {
+    return;
+  }
+  spill(0, 0);
+  releaseReservation();
+  auto spilled = spiller_->spilledBytesAndRows();
+  stats_.spilledBytes = spilled.first;
+  stats_.spilledRows = spilled.second;
+  stats_.spillDirectoryStats = spiller_->spillDirectoryStats();
 }
 
 void OrderBy::noMoreInput() {
   Operator::noMoreInput();
 
+  if (rangeMerge_) {
+    // Drivers without rows still merge a range of the rows of their peers.
+    sortRows();
+    startRangeMerge();
+    return;
+  }
+
   // No data.
   if (numRows_ == 0) {
     finished_ = true;
     return;
   }
 
+  if (spiller_) {
+    // All rows are in the single spill partition, so there are no rows in
+    // non-spilling partitions.
+    spiller_->finishSpill();
+    merge_ = spiller_->startMerge(0);
+    return;
+  }
+
+  sortRows();
+}
+
+void OrderBy::sortRows() {
   // Sort the pointers to the rows in RowContainer (data_) instead of sorting
   // the rows.
   returningRows_.resize(numRows_);
+  if (numRows_ == 0) {
+    return;
+  }
   RowContainerIterator iter;
   data_->listRows(&iter, numRows_, returningRows_.data());
 
-  std::sort(
-      returningRows_.begin(),
-      returningRows_.end(),
-      [this](const char* leftRow, const char* rightRow) {
-        for (auto& [channelIndex, sortOrder] : keyInfo_) {
-          if (auto result = data_->compare(
-                  leftRow,
-                  rightRow,
-                  channelIndex,
-                  {sortOrder.isNullsFirst(), sortOrder.isAscending(), false})) {
-            return result < 0;
-          }
-        }
-        return false; // lhs == rhs.
-      });
+  PrefixSort::sort(
+      *data_,
+      PrefixSort::leadingColumns(keyCompareFlags_.size(), keyCompareFlags_),
+      folly::Range<char**>(returningRows_.data(), returningRows_.size()));
+}
+
+BlockingReason OrderBy::isBlocked(ContinueFuture* future) {
+  if (rangesFuture_.valid()) {
+    *future = std::move(rangesFuture_);
+    return BlockingReason::kWaitForPeers;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
+void OrderBy::startRangeMerge() {
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last Driver to sort its rows assigns the ranges of all Drivers.
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(),
+          operatorCtx_->driver(),
+          &rangesFuture_,
+          promises,
+          peers)) {
+    return;
+  }
+
+  std::vector<OrderBy*> orderBys{this};
+  for (auto& peer : peers) {
+    auto* orderBy = dynamic_cast<OrderBy*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(orderBy);
+    orderBys.push_back(orderBy);
+  }
+  assignRanges(orderBys);
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void OrderBy::assignRanges(const std::vector<OrderBy*>& peers) {
+  // Range i goes to the Driver with partition id i. LocalMerge reads the
+  // MergeSources of the Drivers in this order.
+  const auto numRanges = peers.size();
+  std::vector<OrderBy*> peersByRange(numRanges);
+  for (auto* peer : peers) {
+    auto partitionId = peer->operatorCtx_->driverCtx()->partitionId;
+    VELOX_CHECK_LT(partitionId, numRanges);
+    peersByRange[partitionId] = peer;
+  }
+
+  auto runs = std::make_shared<std::vector<SortedRun>>();
+  int64_t numRows = 0;
+  for (auto* peer : peersByRange) {
+    runs->push_back({peer->data_, std::move(peer->returningRows_)});
+    numRows += runs->back().rows.size();
+  }
+
+  // Sample each run in proportion to its size. Evenly spaced rows of a
+  // sorted run are its quantiles.
+  std::vector<char*> samples;
+  const int64_t numSamples = kSamplesPerRange * numRanges;
+  for (const auto& run : *runs) {
+    const int64_t size = run.rows.size();
+    if (size == 0) {
+      continue;
+    }
+    const auto runSamples = std::max<int64_t>(1, size * numSamples / numRows);
+    for (auto i = 0; i < runSamples; ++i) {
+      samples.push_back(run.rows[i * size / runSamples]);
+    }
+  }
+  auto lessThan = [&](const char* left, const char* right) {
+    return compareRows(left, right) < 0;
+  };
+  std::sort(samples.begin(), samples.end(), lessThan);
+
+  // Range i holds the rows from splitter i - 1 up to, not including,
+  // splitter i. Equal rows of all runs fall into the same range.
+  std::vector<char*> splitters;
+  for (auto i = 1; i < numRanges && !samples.empty(); ++i) {
+    splitters.push_back(samples[i * samples.size() / numRanges]);
+  }
+  for (auto* peer : peersByRange) {
+    peer->runs_ = runs;
+    peer->ranges_.clear();
+  }
+  for (const auto& run : *runs) {
+    char* const* begin = run.rows.data();
+    char* const* end = begin + run.rows.size();
+    char* const* rangeBegin = begin;
+    for (auto i = 0; i < numRanges; ++i) {
+      char* const* rangeEnd = i < splitters.size()
+          ? std::lower_bound(rangeBegin, end, splitters[i], lessThan)
+          : end;
+      peersByRange[i]->ranges_.emplace_back(rangeBegin, rangeEnd);
+      rangeBegin = rangeEnd;
+    }
+  }
+}
+
+int32_t OrderBy::compareRows(const char* left, const char* right) const {
+  for (auto i = 0; i < keyCompareFlags_.size(); ++i) {
+    if (auto result = data_->compare(left, right, i, keyCompareFlags_[i])) {
+      return result;
+    }
+  }
+  return 0;
+}
+
+int32_t SortedRowStream::compare(const MergeStream& other) const {
+  const char* right = *static_cast<const SortedRowStream&>(other).current_;
+  for (auto i = 0; i < keyCompareFlags_.size(); ++i) {
+    if (auto result = data_.compare(*current_, right, i, keyCompareFlags_[i])) {
+      return result;
+    }
+  }
+  return 0;
 }
 
 RowVectorPtr OrderBy::getOutput() {
-  if (finished_ || !noMoreInput_ || returningRows_.size() == numRowsReturned_) {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+
+  if (merge_) {
+    return getOutputFromSpill();
+  }
+
+  if (rangeMerge_) {
+    return getOutputFromRanges();
+  }
+
+  if (returningRows_.size() == numRowsReturned_) {
     return nullptr;
   }
 
@@ -108,7 +424,7 @@ RowVectorPtr OrderBy::getOutput() {
     data_->extractColumn(
         returningRows_.data() + numRowsReturned_,
         numRowsToReturn,
-        i,
+        columnMap_[i],
         result->childAt(i));
   }
 
@@ -118,4 +434,102 @@ RowVectorPtr OrderBy::getOutput() {
 
   return result;
 }
+
+RowVectorPtr OrderBy::getOutputFromSpill() {
+  size_t maxRows = data_->estimatedNumRowsPerBatch(kBatchSizeInBytes);
+  int32_t numRowsToReturn = std::min(maxRows, numRows_ - numRowsReturned_);
+
+  VELOX_CHECK_GT(numRowsToReturn, 0);
+
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, numRowsToReturn, operatorCtx_->pool()));
+
+  int32_t numRows = 0;
+  for (; numRows < numRowsToReturn; ++numRows) {
+    auto stream = merge_->next();
+    if (!stream) {
+      break;
+    }
+    auto& source = stream->current();
+    for (int i = 0; i < outputType_->size(); ++i) {
+      result->childAt(i)->copy(
+          source.childAt(columnMap_[i]).get(),
+          numRows,
+          stream->currentIndex(),
+          1);
+    }
+    stream->pop();
+  }
+  VELOX_CHECK_EQ(numRows, numRowsToReturn, "Spilled rows lost in merge");
+
+  numRowsReturned_ += numRowsToReturn;
+
+  finished_ = (numRowsReturned_ == numRows_);
+  if (finished_) {
+    merge_ = nullptr;
+    stats_.spillDirectoryStats = spiller_->spillDirectoryStats();
+  }
+
+  return result;
+}
+
+RowVectorPtr OrderBy::getOutputFromRanges() {
+  // The last Driver to finish its input assigns the ranges of the others
+  // before it sets their 'rangesFuture_'.
+  if (rangesFuture_.valid()) {
+    return nullptr;
+  }
+  VELOX_CHECK_NOT_NULL(runs_);
+  if (!rangeTree_) {
+    std::vector<std::unique_ptr<SortedRowStream>> streams;
+    for (const auto& [begin, end] : ranges_) {
+      if (begin < end) {
+        streams.push_back(std::make_unique<SortedRowStream>(
+            *data_, keyCompareFlags_, begin, end));
+      }
+    }
+    if (streams.empty()) {
+      finished_ = true;
+      runs_ = nullptr;
+      return nullptr;
+    }
+    rangeTree_ =
+        std::make_unique<TreeOfLosers<SortedRowStream>>(std::move(streams));
+  }
+
+  const size_t maxRows = data_->estimatedNumRowsPerBatch(kBatchSizeInBytes);
+  outputRows_.clear();
+  while (outputRows_.size() < maxRows) {
+    auto* stream = rangeTree_->next();
+    if (!stream) {
+      finished_ = true;
+      break;
+    }
+    outputRows_.push_back(stream->pop());
+  }
+  if (outputRows_.empty()) {
+    // The previous batch ended exactly at the end of the ranges.
+    rangeTree_ = nullptr;
+    runs_ = nullptr;
+    return nullptr;
+  }
+
+  auto result = std::dynamic_pointer_cast<RowVector>(BaseVector::create(
+      outputType_, outputRows_.size(), operatorCtx_->pool()));
+  for (int i = 0; i < outputType_->size(); ++i) {
+    RowContainer::extractColumn(
+        outputRows_.data(),
+        outputRows_.size(),
+        data_->columnAt(columnMap_[i]),
+        result->childAt(i));
+  }
+  numRowsReturned_ += outputRows_.size();
+
+  if (finished_) {
+    rangeTree_ = nullptr;
+    // The rows of the peers are freed when the last peer is done.
+    runs_ = nullptr;
+  }
+  return result;
+}
 } // namespace facebook::velox::exec
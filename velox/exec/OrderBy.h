@@ -18,26 +18,52 @@
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
+#include "velox/exec/TreeOfLosers.h"
 
 namespace facebook::velox::exec {
 
+class SortedRowStream;
+
 // OrderBy operator implementation: OrderBy stores all its inputs in a
 // RowContainer as the inputs are added. Until all inputs are available,
 // it blocks the pipeline. Once all inputs are available, it sorts pointers
-// to the rows using the RowContainer's compare() function. And finally it
-// constructs and returns the sorted output RowVector using the data in the
-// RowContainer.
+// to the rows with PrefixSort, which compares binary prefixes of the leading
+// keys and uses the RowContainer's compare() function only for ties. And
+// finally it constructs and returns the sorted output RowVector using the data
+// in the RowContainer.
+// If a spill path is configured and the memory reservation of the operator
+// cannot be grown to fit the next input, the content of the RowContainer is
+// sorted and written to disk as a sorted run. Once all inputs are available,
+// the output is produced by merging the spilled runs with the rows still in
+// memory.
+// A partial OrderBy that feeds a LocalMerge may merge range-partitioned, see
+// isRangeMerge(). After sorting, the Drivers wait for each other. The last
+// one samples the sorted runs of all Drivers for the boundaries of one key
+// range per Driver. Each Driver then merges its range of all the runs, so
+// that the LocalMerge only has to concatenate the ranges.
 // Limitations:
 // * It memcopies twice: 1) input to RowContainer and 2) RowContainer to
 // output.
-// * It does not support spilling. For now, if memory limit exceeds, it will
-// throw an exception: VeloxMemoryCapExceeded.
 class OrderBy : public Operator {
  public:
+  // 'localMerge' is the node the output of 'this' goes to if it is a
+  // LocalMerge, otherwise nullptr.
   OrderBy(
       int32_t operatorId,
       DriverCtx* driverCtx,
-      const std::shared_ptr<const core::OrderByNode>& orderByNode);
+      const std::shared_ptr<const core::OrderByNode>& orderByNode,
+      const std::shared_ptr<const core::LocalMergeNode>& localMerge = nullptr);
+
+  // Returns true if the Drivers of 'orderBy' merge key ranges of each others'
+  // sorted runs for 'localMerge', which then concatenates the ranges. This is
+  // the case if QueryConfig::kOrderByRangeMerge is set, spilling is
+  // disabled, 'orderBy' is partial and is the only source of 'localMerge' and
+  // both have the same keys.
+  static bool isRangeMerge(
+      const core::OrderByNode& orderBy,
+      const core::LocalMergeNode& localMerge,
+      const core::QueryConfig& config);
 
   bool needsInput() const override {
     return !finished_;
@@ -49,24 +75,147 @@ class OrderBy : public Operator {
 
   RowVectorPtr getOutput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override {
     return finished_;
   }
 
+  int64_t reclaimableBytes() const override;
+
+  void reclaim() override;
+
  private:
   static const int32_t kBatchSizeInBytes{2 * 1024 * 1024};
 
-  std::unique_ptr<RowContainer> data_;
-  std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
+  // Checks if the input will fit in the existing memory and increases the
+  // reservation if not. If the reservation cannot be increased, spills all
+  // rows of 'data_' as a sorted run.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills content until under 'targetRows' and under 'targetBytes' of out of
+  // line data are left.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  // Produces the next batch of output by merging the spilled runs with the
+  // rows left in 'data_'.
+  RowVectorPtr getOutputFromSpill();
+
+  // Sorts the pointers to the rows of 'data_' into 'returningRows_'.
+  void sortRows();
+
+  // Waits for the peers to sort their rows. The last one assigns the ranges.
+  void startRangeMerge();
+
+  // Picks the range boundaries from the sorted runs of 'peers', which include
+  // 'this', and sets the ranges to merge of each peer.
+  void assignRanges(const std::vector<OrderBy*>& peers);
+
+  // Produces the next batch of output by merging the range of 'this'.
+  RowVectorPtr getOutputFromRanges();
+
+  // Compares the keys of two rows of 'data_' or of a RowContainer of a peer.
+  // The containers of the peers have the same layout.
+  int32_t compareRows(const char* left, const char* right) const;
+
+  // Input channel of each column of 'data_'. The sorting keys come first,
+  // followed by the remaining input columns.
+  std::vector<column_index_t> containerChannels_;
+
+  // Column of 'data_' for each output column.
+  std::vector<column_index_t> columnMap_;
+
+  // Comparison flags for each key of 'data_'.
+  std::vector<CompareFlags> keyCompareFlags_;
+
+  // Shared with the peers in range merge mode.
+  std::shared_ptr<RowContainer> data_;
 
   size_t numRows_ = 0;
   size_t numRowsReturned_ = 0;
   std::vector<char*> returningRows_;
 
+  // Filesystem path for spill files, empty if spilling is disabled.
+  const std::optional<std::string> spillPath_;
+
+  // Executor for spilling. If nullptr spilling writes on the Driver's thread.
+  folly::Executor* FOLLY_NULLABLE const spillExecutor_;
+
+  // Codec for the spill files.
+  const folly::io::CodecType spillCompression_;
+
+  // Directories the spill files are striped over.
+  const std::vector<SpillDirectory*> spillDirectories_;
+
+  // Percentage of input batches to be spilled for testing. 0 means no
+  // spilling for test.
+  const int32_t testSpillPct_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct_'.
+  uint64_t spillTestCounter_{0};
+
+  std::unique_ptr<Spiller> spiller_;
+  RowContainerIterator spillIterator_;
+
+  // Merges the spilled runs and the unspilled rows when producing output.
+  std::unique_ptr<TreeOfLosers<SpillStream>> merge_;
+
+  // True if the Drivers merge ranges of each others' runs, see isRangeMerge().
+  const bool rangeMerge_;
+
+  // Sorted rows of a Driver in range merge mode.
+  struct SortedRun {
+    std::shared_ptr<RowContainer> data;
+    std::vector<char*> rows;
+  };
+
+  // The runs of all peers. Set by the last peer to sort its rows.
+  std::shared_ptr<std::vector<SortedRun>> runs_;
+
+  // Begin and end of the range of 'this' in each of 'runs_'.
+  std::vector<std::pair<char* const*, char* const*>> ranges_;
+
+  // Merges 'ranges_'.
+  std::unique_ptr<TreeOfLosers<SortedRowStream>> rangeTree_;
+
+  // Reusable memory for the rows of an output batch in range merge mode.
+  std::vector<char*> outputRows_;
+
+  // Completed when the ranges are assigned.
+  ContinueFuture rangesFuture_;
+
   bool finished_ = false;
 };
+
+// Cursor over a range of sorted rows, see OrderBy::assignRanges().
+class SortedRowStream final : public MergeStream {
+ public:
+  SortedRowStream(
+      RowContainer& data,
+      const std::vector<CompareFlags>& keyCompareFlags,
+      char* const* begin,
+      char* const* end)
+      : data_(data),
+        keyCompareFlags_(keyCompareFlags),
+        current_(begin),
+        end_(end) {}
+
+  bool hasData() const override {
+    return current_ < end_;
+  }
+
+  int32_t compare(const MergeStream& other) const override;
+
+  // Returns the current row and advances to the next.
+  char* pop() {
+    return *current_++;
+  }
+
+ private:
+  RowContainer& data_;
+  const std::vector<CompareFlags>& keyCompareFlags_;
+  char* const* current_;
+  char* const* const end_;
+};
 } // namespace facebook::velox::exec
@@ -62,6 +62,37 @@ void Destination::serialize(
     const RowVectorPtr& output,
     vector_size_t begin,
     vector_size_t end) {
+  if (vectorOwner_) {
+    vector_size_t numRows = 0;
+    for (vector_size_t i = begin; i < end; i++) {
+      numRows += rows_[i].size;
+    }
+    if (numRows == output->size()) {
+      vectors_.push_back(output);
+      return;
+    }
+    auto pool = output->pool();
+    auto indices = allocateIndices(numRows, pool);
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    vector_size_t numIndices = 0;
+    for (vector_size_t i = begin; i < end; i++) {
+      for (vector_size_t j = 0; j < rows_[i].size; ++j) {
+        rawIndices[numIndices++] = rows_[i].begin + j;
+      }
+    }
+    std::vector<VectorPtr> children;
+    children.reserve(output->childrenSize());
+    for (auto& child : output->children()) {
+      children.push_back(BaseVector::wrapInDictionary(
+          nullptr,
+          indices,
+          numRows,
+          BaseVector::loadedVectorShared(child)));
+    }
+    vectors_.push_back(std::make_shared<RowVector>(
+        pool, output->type(), nullptr, numRows, std::move(children)));
+    return;
+  }
   if (!current_) {
     current_ = std::make_unique<VectorStreamGroup>(memory_);
     auto rowType = std::dynamic_pointer_cast<const RowType>(output->type());
@@ -69,7 +100,7 @@ void Destination::serialize(
     for (vector_size_t i = begin; i < end; i++) {
       numRows += rows_[i].size;
     }
-    current_->createStreamTree(rowType, numRows);
+    current_->createStreamTree(rowType, numRows, &serdeOptions_);
   }
   current_->append(output, folly::Range(&rows_[begin], end - begin));
 }
@@ -77,6 +108,15 @@ void Destination::serialize(
 BlockingReason Destination::flush(
     PartitionedOutputBufferManager& bufferManager,
     ContinueFuture* future) {
+  if (!vectors_.empty()) {
+    auto page = std::make_unique<SerializedPage>(
+        std::move(vectors_), bytesInCurrent_, vectorOwner_);
+    vectors_.clear();
+    bytesInCurrent_ = 0;
+    setTargetSizePct();
+    return bufferManager.enqueue(
+        taskId_, destination_, std::move(page), future);
+  }
   if (!current_) {
     return BlockingReason::kNotBlocked;
   }
@@ -89,13 +129,16 @@ BlockingReason Destination::flush(
       std::max<int64_t>(kMinMessageSize, current_->size()));
   current_->flush(&stream);
   current_.reset();
+  auto iobuf = stream.getIOBuf();
+  flushedEstimatedBytes_ += bytesInCurrent_;
+  flushedBytes_ += iobuf->computeChainDataLength();
   bytesInCurrent_ = 0;
   setTargetSizePct();
 
   return bufferManager.enqueue(
       taskId_,
       destination_,
-      std::make_unique<SerializedPage>(stream.getIOBuf()),
+      std::make_unique<SerializedPage>(std::move(iobuf)),
       future);
 }
 
@@ -123,9 +166,11 @@ void PartitionedOutput::initializeInput(RowVectorPtr input) {
 void PartitionedOutput::initializeDestinations() {
   if (destinations_.empty()) {
     auto taskId = operatorCtx_->taskId();
+    auto vectorOwner =
+        localExchangeVectors_ ? operatorCtx_->task() : nullptr;
     for (int i = 0; i < numDestinations_; ++i) {
-      destinations_.push_back(
-          std::make_unique<Destination>(taskId, i, mappedMemory_));
+      destinations_.push_back(std::make_unique<Destination>(
+          taskId, i, mappedMemory_, serdeOptions_, vectorOwner));
     }
   }
 }
@@ -159,8 +204,9 @@ void PartitionedOutput::estimateRowSizes() {
 }
 
 void PartitionedOutput::addInput(RowVectorPtr input) {
-  // TODO Report outputBytes as bytes after serialization
-  stats_.outputBytes += input->retainedSize();
+  // The bytes after serialization are reported in the 'serializedBytes'
+  // runtime stat at the end.
+  stats_.outputBytes += input->estimateFlatSize();
   stats_.outputPositions += input->size();
 
   initializeInput(std::move(input));
@@ -201,6 +247,8 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
           destinations_[partitions_[i]]->addRow(i);
         }
       }
+    } else if (!hashers_.empty()) {
+      addRowsWithHotKeys();
     } else {
       for (vector_size_t i = 0; i < numInput; ++i) {
         destinations_[partitions_[i]]->addRow(i);
@@ -209,6 +257,127 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
   }
 }
 
+// static
+std::vector<std::unique_ptr<VectorHasher>> PartitionedOutput::createHashers(
+    const RowTypePtr& inputType,
+    const std::vector<column_index_t>& keyChannels) {
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  hashers.reserve(keyChannels.size());
+  for (auto channel : keyChannels) {
+    VELOX_CHECK_NE(
+        channel, kConstantChannel, "Hot keys require column partitioning keys");
+    hashers.push_back(
+        VectorHasher::create(inputType->childAt(channel), channel));
+  }
+  return hashers;
+}
+
+// static
+std::vector<uint64_t> PartitionedOutput::hashKeys(
+    const RowVector& input,
+    const std::vector<column_index_t>& keyChannels) {
+  auto hashers = createHashers(asRowType(input.type()), keyChannels);
+  SelectivityVector rows(input.size());
+  raw_vector<uint64_t> hashes(input.size());
+  for (auto i = 0; i < hashers.size(); ++i) {
+    hashers[i]->hash(*input.childAt(keyChannels[i]), rows, i > 0, hashes);
+  }
+  return std::vector<uint64_t>(hashes.begin(), hashes.end());
+}
+
+void PartitionedOutput::computeHashes() {
+  auto size = input_->size();
+  rows_.resize(size);
+  rows_.setAll();
+  hashes_.resize(size);
+  for (auto i = 0; i < hashers_.size(); ++i) {
+    hashers_[i]->hash(
+        *input_->childAt(hashers_[i]->channel()), rows_, i > 0, hashes_);
+  }
+}
+
+void PartitionedOutput::sampleHotKeys() {
+  // Keeping 2 / 'hotKeyFraction_' counters undercounts a key by less than
+  // half the threshold.
+  const size_t maxCounters = std::ceil(2 / hotKeyFraction_);
+  auto size = input_->size();
+  auto row = nextSampledRow_;
+  for (; row < size; row += kHotKeySampleStride) {
+    ++numSampledRows_;
+    auto it = hotKeyCounts_.find(hashes_[row]);
+    if (it != hotKeyCounts_.end()) {
+      ++it->second;
+    } else if (hotKeyCounts_.size() < maxCounters) {
+      hotKeyCounts_[hashes_[row]] = 1;
+    } else {
+      // Decrements all counters and drops the ones that reach 0.
+      for (auto counter = hotKeyCounts_.begin();
+           counter != hotKeyCounts_.end();) {
+        if (--counter->second == 0) {
+          counter = hotKeyCounts_.erase(counter);
+        } else {
+          ++counter;
+        }
+      }
+    }
+  }
+  nextSampledRow_ = row - size;
+}
+
+void PartitionedOutput::reportHotKeys(
+    PartitionedOutputBufferManager& bufferManager) {
+  // A counter underestimates its key by less than half the threshold, so
+  // this reports all keys above the threshold and possibly some keys above
+  // half of it.
+  const double minCount = numSampledRows_ * hotKeyFraction_ / 2;
+  std::vector<uint64_t> hotKeys;
+  for (const auto& [hash, count] : hotKeyCounts_) {
+    if (count > minCount) {
+      hotKeys.push_back(hash);
+    }
+  }
+  stats_.addRuntimeStat("numHotKeys", RuntimeCounter(hotKeys.size()));
+  if (!hotKeys.empty()) {
+    bufferManager.addHotKeys(operatorCtx_->taskId(), hotKeys);
+  }
+}
+
+void PartitionedOutput::addRowsWithHotKeys() {
+  computeHashes();
+  if (hotKeyFraction_ > 0) {
+    sampleHotKeys();
+  }
+  auto numInput = input_->size();
+  if (skewMode_ == core::PartitionedOutputNode::SkewMode::kNone ||
+      hotKeyHashes_.empty()) {
+    for (vector_size_t i = 0; i < numInput; ++i) {
+      destinations_[partitions_[i]]->addRow(i);
+    }
+    return;
+  }
+
+  vector_size_t numHotRows = 0;
+  for (vector_size_t i = 0; i < numInput; ++i) {
+    if (!std::binary_search(
+            hotKeyHashes_.begin(), hotKeyHashes_.end(), hashes_[i])) {
+      destinations_[partitions_[i]]->addRow(i);
+      continue;
+    }
+    ++numHotRows;
+    if (skewMode_ == core::PartitionedOutputNode::SkewMode::kSplit) {
+      destinations_[nextSplitDestination_]->addRow(i);
+      nextSplitDestination_ = (nextSplitDestination_ + 1) % numDestinations_;
+    } else {
+      for (auto& destination : destinations_) {
+        destination->addRow(i);
+      }
+    }
+  }
+  if (numHotRows > 0) {
+    stats_.addRuntimeStat("numHotKeyRows", RuntimeCounter(numHotRows));
+  }
+}
+
 void PartitionedOutput::collectNullRows() {
   auto size = input_->size();
   rows_.resize(size);
@@ -228,6 +397,26 @@ void PartitionedOutput::collectNullRows() {
   nullRows_.updateBounds();
 }
 
+void PartitionedOutput::reportSerializedBytes() {
+  int64_t estimatedBytes = 0;
+  int64_t serializedBytes = 0;
+  for (auto& destination : destinations_) {
+    estimatedBytes += destination->flushedEstimatedBytes();
+    serializedBytes += destination->flushedBytes();
+  }
+  if (serializedBytes == 0) {
+    return;
+  }
+  stats_.addRuntimeStat(
+      "serializedBytes",
+      RuntimeCounter(serializedBytes, RuntimeCounter::Unit::kBytes));
+  // Positive if the row size estimates were too large.
+  stats_.addRuntimeStat(
+      "serializedBytesEstimateError",
+      RuntimeCounter(
+          estimatedBytes - serializedBytes, RuntimeCounter::Unit::kBytes));
+}
+
 RowVectorPtr PartitionedOutput::getOutput() {
   if (finished_) {
     return nullptr;
@@ -288,7 +477,11 @@ RowVectorPtr PartitionedOutput::getOutput() {
       destination->flush(*bufferManager, nullptr);
       destination->setFinished();
     }
+    reportSerializedBytes();
 
+    if (hotKeyFraction_ > 0) {
+      reportHotKeys(*bufferManager);
+    }
     bufferManager->noMoreData(operatorCtx_->task()->taskId());
     finished_ = true;
   }
@@ -16,8 +16,10 @@
 #pragma once
 
 #include <folly/Random.h>
+#include <folly/container/F14Map.h>
 #include "velox/exec/Operator.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
+#include "velox/exec/VectorHasher.h"
 
 namespace facebook::velox::exec {
 
@@ -28,8 +30,14 @@ class Destination {
   Destination(
       const std::string& taskId,
       int destination,
-      memory::MappedMemory* FOLLY_NONNULL memory)
-      : taskId_(taskId), destination_(destination), memory_(memory) {
+      memory::MappedMemory* FOLLY_NONNULL memory,
+      const VectorSerde::Options& serdeOptions,
+      std::shared_ptr<Task> vectorOwner = nullptr)
+      : taskId_(taskId),
+        destination_(destination),
+        memory_(memory),
+        serdeOptions_(serdeOptions),
+        vectorOwner_(std::move(vectorOwner)) {
     setTargetSizePct();
   }
 
@@ -71,6 +79,16 @@ class Destination {
     return bytesInCurrent_;
   }
 
+  // The estimated bytes of the rows of the serialized pages flushed so far.
+  uint64_t flushedEstimatedBytes() const {
+    return flushedEstimatedBytes_;
+  }
+
+  // The bytes of the serialized pages flushed so far.
+  uint64_t flushedBytes() const {
+    return flushedBytes_;
+  }
+
  private:
   void
   serialize(const RowVectorPtr& input, vector_size_t begin, vector_size_t end);
@@ -91,7 +109,18 @@ class Destination {
   const std::string taskId_;
   const int destination_;
   memory::MappedMemory* FOLLY_NONNULL const memory_;
+  // Options for the pages to 'destination_'. Carries the compression
+  // adaptation from page to page.
+  VectorSerde::Options serdeOptions_;
+  // If set, the pages to 'destination_' carry RowVectors instead of
+  // serialized data. The vectors are slices of the input, whose memory
+  // is kept alive by this Task.
+  const std::shared_ptr<Task> vectorOwner_;
+  // The vectors for the next page if 'vectorOwner_' is set.
+  std::vector<RowVectorPtr> vectors_;
   uint64_t bytesInCurrent_{0};
+  uint64_t flushedEstimatedBytes_{0};
+  uint64_t flushedBytes_{0};
   std::vector<IndexRange> rows_;
 
   // First row of 'rows_' that is not appended to 'current_'
@@ -121,12 +150,21 @@ class Destination {
 // partitioned, and divides the stream into a series of output data ready to be
 // sent to other workers. This operator is also capable of re-ordering and
 // dropping columns from its input.
+//
+// If the 'partitioned_output_hot_key_fraction' config is set, the operator
+// counts a sample of the key hashes and reports the keys that are more
+// frequent than the fraction to the PartitionedOutputBufferManager. A plan
+// that knows hot keys routes them according to
+// core::PartitionedOutputNode::SkewMode.
 class PartitionedOutput : public Operator {
  public:
   // Minimum flush size for non-final flush. 60KB + overhead fits a
   // network MTU of 64K.
   static constexpr uint64_t kMinDestinationSize = 60 * 1024;
 
+  // Every kHotKeySampleStride'th row is counted for hot key detection.
+  static constexpr int32_t kHotKeySampleStride = 8;
+
   PartitionedOutput(
       int32_t operatorId,
       DriverCtx* FOLLY_NONNULL ctx,
@@ -138,7 +176,10 @@ class PartitionedOutput : public Operator {
             planNode->id(),
             "PartitionedOutput"),
         keyChannels_(toChannels(planNode->inputType(), planNode->keys())),
-        numDestinations_(planNode->numPartitions()),
+        // A broadcast serializes each batch once. The buffer manager shares
+        // the pages with all destinations.
+        numDestinations_(
+            planNode->isBroadcast() ? 1 : planNode->numPartitions()),
         replicateNullsAndAny_(planNode->isReplicateNullsAndAny()),
         partitionFunction_(
             numDestinations_ == 1
@@ -151,13 +192,41 @@ class PartitionedOutput : public Operator {
         bufferManager_(PartitionedOutputBufferManager::getInstance()),
         maxBufferedBytes_(
             ctx->task->queryCtx()->config().maxPartitionedOutputBufferSize()),
-        mappedMemory_{operatorCtx_->mappedMemory()} {
+        mappedMemory_{operatorCtx_->mappedMemory()},
+        serdeOptions_(exchangeSerdeOptions(ctx->queryConfig())),
+        localExchangeVectors_(
+            ctx->queryConfig().localExchangeVectors() &&
+            ctx->task->taskId().find("local://") == 0),
+        skewMode_(planNode->skewMode()),
+        hotKeyHashes_(planNode->hotKeyHashes()),
+        hotKeyFraction_(
+            numDestinations_ == 1 || keyChannels_.empty()
+                ? 0
+                : ctx->task->queryCtx()
+                      ->config()
+                      .partitionedOutputHotKeyFraction()) {
     if (numDestinations_ == 1 || planNode->isBroadcast()) {
       VELOX_CHECK(keyChannels_.empty());
       VELOX_CHECK_NULL(partitionFunction_);
     }
+    VELOX_USER_CHECK(
+        hotKeyFraction_ >= 0 && hotKeyFraction_ <= 1,
+        "Hot key fraction must be between 0 and 1: {}",
+        hotKeyFraction_);
+    if ((skewMode_ != core::PartitionedOutputNode::SkewMode::kNone &&
+         !hotKeyHashes_.empty()) ||
+        hotKeyFraction_ > 0) {
+      hashers_ = createHashers(planNode->inputType(), keyChannels_);
+    }
   }
 
+  // Returns the hashes of the keys in 'keyChannels' of 'input' that identify
+  // hot keys in core::PartitionedOutputNode::hotKeyHashes(). These are the
+  // hashes that HashPartitionFunction maps to partitions.
+  static std::vector<uint64_t> hashKeys(
+      const RowVector& input,
+      const std::vector<column_index_t>& keyChannels);
+
   void addInput(RowVectorPtr input) override;
 
   // Always returns nullptr. The action is to further process
@@ -195,9 +264,30 @@ class PartitionedOutput : public Operator {
 
   void estimateRowSizes();
 
+  // Adds the bytes of the serialized pages and the error of the row size
+  // estimates for them to the runtime stats.
+  void reportSerializedBytes();
+
   /// Collect all rows with null keys into nullRows_.
   void collectNullRows();
 
+  static std::vector<std::unique_ptr<VectorHasher>> createHashers(
+      const RowTypePtr& inputType,
+      const std::vector<column_index_t>& keyChannels);
+
+  // Sets 'hashes_' to the key hashes of 'input_'.
+  void computeHashes();
+
+  // Adds a sample of 'hashes_' to 'hotKeyCounts_'.
+  void sampleHotKeys();
+
+  // Reports the hot keys in 'hotKeyCounts_' to 'bufferManager'.
+  void reportHotKeys(PartitionedOutputBufferManager& bufferManager);
+
+  // Adds the rows of 'input_' to the destinations, sending the rows with hot
+  // keys to the destinations given by 'skewMode_'.
+  void addRowsWithHotKeys();
+
   const std::vector<column_index_t> keyChannels_;
   const int numDestinations_;
   const bool replicateNullsAndAny_;
@@ -218,12 +308,34 @@ class PartitionedOutput : public Operator {
   std::weak_ptr<exec::PartitionedOutputBufferManager> bufferManager_;
   const int64_t maxBufferedBytes_;
   memory::MappedMemory* FOLLY_NONNULL mappedMemory_;
+  const VectorSerde::Options serdeOptions_;
+  // True if the destinations pass vectors instead of serialized pages.
+  const bool localExchangeVectors_;
   RowVectorPtr output_;
 
+  const core::PartitionedOutputNode::SkewMode skewMode_;
+  // Sorted hashes of the keys routed by 'skewMode_'.
+  const std::vector<uint64_t> hotKeyHashes_;
+  // Minimum share of the rows for a key to be reported as hot. 0 disables
+  // detection.
+  const double hotKeyFraction_;
+  // Hash the keys for 'hotKeyHashes_' and hot key detection.
+  std::vector<std::unique_ptr<VectorHasher>> hashers_;
+  // Destination of the next row with a hot key in kSplit mode.
+  int32_t nextSplitDestination_{0};
+
+  // Misra-Gries counters of the sampled key hashes. A key with more than
+  // 'hotKeyFraction_' of the samples always has a counter.
+  folly::F14FastMap<uint64_t, int64_t> hotKeyCounts_;
+  int64_t numSampledRows_{0};
+  // Offset of the next sampled row in the next input.
+  int32_t nextSampledRow_{0};
+
   // Reusable memory.
   SelectivityVector rows_;
   SelectivityVector nullRows_;
   std::vector<uint32_t> partitions_;
+  raw_vector<uint64_t> hashes_;
 };
 
 } // namespace facebook::velox::exec
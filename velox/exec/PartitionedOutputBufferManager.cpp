@@ -18,10 +18,10 @@
 
 namespace facebook::velox::exec {
 
-std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
+std::vector<std::shared_ptr<SerializedPage>> DestinationBuffer::getData(
     uint64_t maxBytes,
     int64_t sequence,
-    DataAvailableCallback notify) {
+    PagesAvailableCallback notify) {
   VELOX_CHECK_GE(
       sequence, sequence_, "Get received for an already acknowledged item");
 
@@ -41,7 +41,7 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
     return {};
   }
 
-  std::vector<std::unique_ptr<folly::IOBuf>> result;
+  std::vector<std::shared_ptr<SerializedPage>> result;
   uint64_t resultBytes = 0;
   for (auto i = sequence - sequence_; i < data_.size(); i++) {
     // nullptr is used as end marker
@@ -50,7 +50,7 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
       result.push_back(nullptr);
       break;
     }
-    result.push_back(data_[i]->getIOBuf());
+    result.push_back(data_[i]);
     resultBytes += data_[i]->size();
     if (resultBytes >= maxBytes) {
       break;
@@ -162,6 +162,7 @@ PartitionedOutputBuffer::PartitionedOutputBuffer(
   for (int i = 0; i < numDestinations; i++) {
     buffers_.push_back(std::make_unique<DestinationBuffer>());
   }
+  destinationBytes_.resize(numDestinations);
 }
 
 void PartitionedOutputBuffer::updateBroadcastOutputBuffers(
@@ -169,6 +170,7 @@ void PartitionedOutputBuffer::updateBroadcastOutputBuffers(
     bool noMoreBuffers) {
   VELOX_CHECK(broadcast_);
 
+  std::vector<std::shared_ptr<SerializedPage>> freed;
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
@@ -182,10 +184,12 @@ void PartitionedOutputBuffer::updateBroadcastOutputBuffers(
     }
 
     noMoreBroadcastBuffers_ = true;
-    updateAfterAcknowledgeLocked(dataToBroadcast_, promises);
+    freed = std::move(dataToBroadcast_);
+    dataToBroadcast_.clear();
+    updateAfterAcknowledgeLocked(freed, promises);
   }
 
-  releaseAfterAcknowledge(dataToBroadcast_, promises);
+  releaseAfterAcknowledge(freed, promises);
 }
 
 void PartitionedOutputBuffer::updateNumDrivers(uint32_t newNumDrivers) {
@@ -206,10 +210,12 @@ void PartitionedOutputBuffer::updateNumDrivers(uint32_t newNumDrivers) {
 void PartitionedOutputBuffer::addBroadcastOutputBuffersLocked(int numBuffers) {
   VELOX_CHECK(!noMoreBroadcastBuffers_)
   buffers_.reserve(numBuffers);
+  destinationBytes_.resize(numBuffers);
   for (auto i = buffers_.size(); i < numBuffers; i++) {
     auto buffer = std::make_unique<DestinationBuffer>();
     for (const auto& data : dataToBroadcast_) {
       buffer->enqueue(data);
+      destinationBytes_[i] += data->size();
     }
     if (atEnd_) {
       buffer->enqueue(nullptr);
@@ -234,15 +240,17 @@ BlockingReason PartitionedOutputBuffer::enqueue(
     totalSize_ += data->size();
     if (broadcast_) {
       std::shared_ptr<SerializedPage> sharedData(data.release());
-      for (auto& buffer : buffers_) {
-        buffer->enqueue(sharedData);
-        dataAvailableCallbacks.emplace_back(buffer->getAndClearNotify());
+      for (auto i = 0; i < buffers_.size(); ++i) {
+        destinationBytes_[i] += sharedData->size();
+        buffers_[i]->enqueue(sharedData);
+        dataAvailableCallbacks.emplace_back(buffers_[i]->getAndClearNotify());
       }
 
       if (!noMoreBroadcastBuffers_) {
         dataToBroadcast_.emplace_back(sharedData);
       }
     } else {
+      destinationBytes_[destination] += data->size();
       auto buffer = buffers_[destination].get();
       buffer->enqueue(std::move(data));
       dataAvailableCallbacks.emplace_back(buffer->getAndClearNotify());
@@ -336,14 +344,22 @@ void PartitionedOutputBuffer::acknowledge(int destination, int64_t sequence) {
 }
 
 void PartitionedOutputBuffer::updateAfterAcknowledgeLocked(
-    const std::vector<std::shared_ptr<SerializedPage>>& freed,
+    std::vector<std::shared_ptr<SerializedPage>>& freed,
     std::vector<ContinuePromise>& promises) {
   uint64_t totalFreed = 0;
-  for (const auto& free : freed) {
-    if (free.unique()) {
-      totalFreed += free->size();
+  size_t numUnreferenced = 0;
+  for (auto i = 0; i < freed.size(); ++i) {
+    if (freed[i].unique()) {
+      totalFreed += freed[i]->size();
+      if (i != numUnreferenced) {
+        freed[numUnreferenced] = std::move(freed[i]);
+      }
+      ++numUnreferenced;
     }
   }
+  // Releases the references to pages that other destinations still hold.
+  // Only the pages freed here are destructed outside of 'mutex_'.
+  freed.resize(numUnreferenced);
   if (totalFreed == 0) {
     return;
   }
@@ -393,8 +409,8 @@ void PartitionedOutputBuffer::getData(
     int destination,
     uint64_t maxBytes,
     int64_t sequence,
-    DataAvailableCallback notify) {
-  std::vector<std::unique_ptr<folly::IOBuf>> data;
+    PagesAvailableCallback notify) {
+  std::vector<std::shared_ptr<SerializedPage>> data;
   std::vector<std::shared_ptr<SerializedPage>> freed;
   std::vector<ContinuePromise> promises;
   {
@@ -433,6 +449,24 @@ void PartitionedOutputBuffer::terminate() {
   }
 }
 
+std::vector<uint64_t> PartitionedOutputBuffer::destinationBytes() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return destinationBytes_;
+}
+
+void PartitionedOutputBuffer::addHotKeys(
+    const std::vector<uint64_t>& hotKeyHashes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  hotKeys_.insert(hotKeys_.end(), hotKeyHashes.begin(), hotKeyHashes.end());
+  std::sort(hotKeys_.begin(), hotKeys_.end());
+  hotKeys_.erase(std::unique(hotKeys_.begin(), hotKeys_.end()), hotKeys_.end());
+}
+
+std::vector<uint64_t> PartitionedOutputBuffer::hotKeys() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return hotKeys_;
+}
+
 std::string PartitionedOutputBuffer::toString() {
   std::lock_guard<std::mutex> l(mutex_);
   std::stringstream out;
@@ -442,7 +476,8 @@ std::string PartitionedOutputBuffer::toString() {
       << (atEnd_ ? "at end, " : "") << "destinations: " << std::endl;
   for (auto i = 0; i < buffers_.size(); ++i) {
     auto buffer = buffers_[i].get();
-    out << i << ": " << (buffer ? buffer->toString() : "none") << std::endl;
+    out << i << ": " << (buffer ? buffer->toString() : "none")
+        << " enqueued: " << destinationBytes_[i] << "b" << std::endl;
   }
   out << "]" << std::endl;
   return out.str();
@@ -526,7 +561,31 @@ void PartitionedOutputBufferManager::getData(
     uint64_t maxBytes,
     int64_t sequence,
     DataAvailableCallback notify) {
-  getBuffer(taskId)->getData(destination, maxBytes, sequence, notify);
+  getBuffer(taskId)->getData(
+      destination,
+      maxBytes,
+      sequence,
+      [notify](
+          std::vector<std::shared_ptr<SerializedPage>> pages,
+          int64_t pagesSequence) {
+        // A shallow copy of each page. nullptr is the end marker.
+        std::vector<std::unique_ptr<folly::IOBuf>> data;
+        data.reserve(pages.size());
+        for (auto& page : pages) {
+          data.push_back(page ? page->getIOBuf() : nullptr);
+        }
+        notify(std::move(data), pagesSequence);
+      });
+}
+
+void PartitionedOutputBufferManager::getPages(
+    const std::string& taskId,
+    int destination,
+    uint64_t maxBytes,
+    int64_t sequence,
+    PagesAvailableCallback notify) {
+  getBuffer(taskId)->getData(
+      destination, maxBytes, sequence, std::move(notify));
 }
 
 void PartitionedOutputBufferManager::initializeTask(
@@ -578,6 +637,22 @@ void PartitionedOutputBufferManager::removeTask(const std::string& taskId) {
   }
 }
 
+std::vector<uint64_t> PartitionedOutputBufferManager::destinationBytes(
+    const std::string& taskId) {
+  return getBuffer(taskId)->destinationBytes();
+}
+
+void PartitionedOutputBufferManager::addHotKeys(
+    const std::string& taskId,
+    const std::vector<uint64_t>& hotKeyHashes) {
+  getBuffer(taskId)->addHotKeys(hotKeyHashes);
+}
+
+std::vector<uint64_t> PartitionedOutputBufferManager::hotKeys(
+    const std::string& taskId) {
+  return getBuffer(taskId)->hotKeys();
+}
+
 std::string PartitionedOutputBufferManager::toString() {
   return buffers_.withLock([](const auto& buffers) {
     std::stringstream out;
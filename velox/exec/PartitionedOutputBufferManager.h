@@ -28,10 +28,17 @@ namespace facebook::velox::exec {
 using DataAvailableCallback = std::function<
     void(std::vector<std::unique_ptr<folly::IOBuf>> pages, int64_t sequence)>;
 
+// Same as DataAvailableCallback but with the SerializedPages themselves.
+// Used by consumers in the same process, which can also take pages that
+// hold vectors.
+using PagesAvailableCallback = std::function<void(
+    std::vector<std::shared_ptr<SerializedPage>> pages,
+    int64_t sequence)>;
+
 struct DataAvailable {
-  DataAvailableCallback callback;
+  PagesAvailableCallback callback;
   int64_t sequence;
-  std::vector<std::unique_ptr<folly::IOBuf>> data;
+  std::vector<std::shared_ptr<SerializedPage>> data;
 
   void notify() {
     if (callback) {
@@ -51,11 +58,11 @@ class DestinationBuffer {
     data_.push_back(std::move(data));
   }
 
-  // Returns a shallow copy (folly::IOBuf::clone) of the data starting at
-  // 'sequence', stopping after exceeding 'maxBytes'. If there is no data,
-  // 'notify' is installed so that this gets called when data is added.
-  std::vector<std::unique_ptr<folly::IOBuf>>
-  getData(uint64_t maxBytes, int64_t sequence, DataAvailableCallback notify);
+  // Returns the pages starting at 'sequence', stopping after exceeding
+  // 'maxBytes'. If there is no data, 'notify' is installed so that this
+  // gets called when data is added.
+  std::vector<std::shared_ptr<SerializedPage>>
+  getData(uint64_t maxBytes, int64_t sequence, PagesAvailableCallback notify);
 
   // Removes data from the queue and returns removed data. If 'fromGetData' we
   // do not give a warning for the case where no data is removed, otherwise we
@@ -78,7 +85,7 @@ class DestinationBuffer {
   std::vector<std::shared_ptr<SerializedPage>> data_;
   // The sequence number of the first in 'data_'.
   int64_t sequence_ = 0;
-  DataAvailableCallback notify_ = nullptr;
+  PagesAvailableCallback notify_ = nullptr;
   // The sequence number of the first item to pass to 'notify'.
   int64_t notifySequence_;
   uint64_t notifyMaxBytes_;
@@ -126,12 +133,23 @@ class PartitionedOutputBuffer {
       int destination,
       uint64_t maxSize,
       int64_t sequence,
-      DataAvailableCallback notify);
+      PagesAvailableCallback notify);
 
   // Continues any possibly waiting producers. Called when the
   // producer task has an error or cancellation.
   void terminate();
 
+  // Returns the number of bytes enqueued for each destination so far,
+  // including data that has been acknowledged. Broadcast data counts for
+  // every destination.
+  std::vector<uint64_t> destinationBytes();
+
+  // Adds to the hashes of the hot keys found by the producers.
+  void addHotKeys(const std::vector<uint64_t>& hotKeyHashes);
+
+  // Returns the sorted hashes of the hot keys reported by addHotKeys().
+  std::vector<uint64_t> hotKeys();
+
   std::string toString();
 
  private:
@@ -145,9 +163,12 @@ class PartitionedOutputBuffer {
   void checkIfDone(bool oneDriverFinished);
 
   // Updates buffered size and returns possibly continuable producer promises in
-  // 'promises'.
+  // 'promises'. A broadcast page is shared by all destinations and counts as
+  // freed when the last destination releases it. The pages that are still
+  // referenced by other destinations are dropped from 'freed' so that the
+  // last one to be acknowledged is seen as unreferenced under 'mutex_'.
   void updateAfterAcknowledgeLocked(
-      const std::vector<std::shared_ptr<SerializedPage>>& freed,
+      std::vector<std::shared_ptr<SerializedPage>>& freed,
       std::vector<ContinuePromise>& promises);
 
   /// Given an updated total number of broadcast buffers, add any missing ones
@@ -179,6 +200,10 @@ class PartitionedOutputBuffer {
   std::vector<ContinuePromise> promises_;
   // One buffer per destination
   std::vector<std::unique_ptr<DestinationBuffer>> buffers_;
+  // Bytes enqueued for each destination.
+  std::vector<uint64_t> destinationBytes_;
+  // Sorted hashes of the hot keys reported by the producers.
+  std::vector<uint64_t> hotKeys_;
   uint32_t numFinished_{0};
   // When this reaches buffers_.size(), 'this' can be freed.
   int numFinalAcknowledges_ = 0;
@@ -242,8 +267,31 @@ class PartitionedOutputBufferManager {
       int64_t sequence,
       DataAvailableCallback notify);
 
+  // Same as getData() but passes the pages to 'notify' without taking a
+  // shallow copy of their IOBufs. Pages of vectors are only returned by
+  // this.
+  void getPages(
+      const std::string& taskId,
+      int destination,
+      uint64_t maxBytes,
+      int64_t sequence,
+      PagesAvailableCallback notify);
+
   void removeTask(const std::string& taskId);
 
+  // Returns the number of bytes enqueued for each destination of 'taskId'.
+  // Comparing the destinations shows skew in the partitioning keys.
+  std::vector<uint64_t> destinationBytes(const std::string& taskId);
+
+  // Records the hashes of the keys that 'taskId' found to be hot. The
+  // coordinator fetches them with hotKeys() to plan a skewed join, see
+  // core::PartitionedOutputNode::SkewMode.
+  void addHotKeys(
+      const std::string& taskId,
+      const std::vector<uint64_t>& hotKeyHashes);
+
+  std::vector<uint64_t> hotKeys(const std::string& taskId);
+
   static std::weak_ptr<PartitionedOutputBufferManager> getInstance();
 
   uint64_t numBuffers() const;
@@ -48,9 +48,13 @@ void PlanNodeStats::addTotals(const OperatorStats& stats) {
   cpuWallTiming.add(stats.finishTiming);
 
   blockedWallNanos += stats.blockedWallNanos;
+  blockedWallNanosHistogram.merge(stats.blockedWallNanosHistogram);
 
   peakMemoryBytes += stats.memoryStats.peakTotalMemoryReservation;
   numMemoryAllocations += stats.memoryStats.numMemoryAllocations;
+  allocatedBytes += stats.memoryStats.allocatedBytes;
+
+  perfEventCounts.add(stats.perfEventCounts);
 
   for (const auto& [name, runtimeStats] : stats.runtimeStats) {
     if (UNLIKELY(customStats.count(name) == 0)) {
@@ -85,8 +89,14 @@ std::string PlanNodeStats::toString(bool includeInputStats) const {
   out << "Output: " << outputRows << " rows (" << succinctBytes(outputBytes)
       << ", " << outputVectors << " batches)"
       << ", Cpu time: " << succinctNanos(cpuWallTiming.cpuNanos)
-      << ", Blocked wall time: " << succinctNanos(blockedWallNanos)
-      << ", Peak memory: " << succinctBytes(peakMemoryBytes)
+      << ", Blocked wall time: " << succinctNanos(blockedWallNanos);
+  if (blockedWallNanosHistogram.count() > 0) {
+    const auto& histogram = blockedWallNanosHistogram;
+    out << " (p50: " << succinctNanos(histogram.quantile(0.5))
+        << ", p99: " << succinctNanos(histogram.quantile(0.99))
+        << ", p999: " << succinctNanos(histogram.quantile(0.999)) << ")";
+  }
+  out << ", Peak memory: " << succinctBytes(peakMemoryBytes)
       << ", Memory allocations: " << numMemoryAllocations;
 
   if (numDrivers > 0) {
@@ -96,6 +106,19 @@ std::string PlanNodeStats::toString(bool includeInputStats) const {
   if (numSplits > 0) {
     out << ", Splits: " << numSplits;
   }
+
+  if (!perfEventCounts.empty()) {
+    const auto& counts = perfEventCounts;
+    const double ipc = counts.cycles == 0
+        ? 0
+        : (double)counts.instructions / counts.cycles;
+    out << ", Cycles: " << counts.cycles
+        << ", Instructions: " << counts.instructions
+        << fmt::format(" (IPC {:.2f})", ipc)
+        << ", LLC misses: " << counts.llcMisses
+        << ", Branch misses: " << counts.branchMisses
+        << ", dTLB misses: " << counts.dtlbMisses;
+  }
   return out.str();
 }
 
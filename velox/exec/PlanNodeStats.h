@@ -80,12 +80,23 @@ struct PlanNodeStats {
   /// Sum of blocked wall time for all corresponding operators.
   uint64_t blockedWallNanos{0};
 
+  /// The wall time of each wait on the corresponding operators.
+  RuntimeHistogram blockedWallNanosHistogram;
+
   /// Max of peak memory usage for all corresponding operators. Assumes that all
   /// operator instances were running concurrently.
   uint64_t peakMemoryBytes{0};
 
   uint64_t numMemoryAllocations{0};
 
+  /// Sum of bytes allocated by all corresponding operators. Divided by the
+  /// wall time in 'cpuWallTiming' this is the allocation rate.
+  uint64_t allocatedBytes{0};
+
+  /// Sum of the hardware events of all corresponding operators. Empty unless
+  /// QueryConfig::perfEventsEnabled().
+  process::PerfEventCounts perfEventCounts;
+
   /// Operator-specific counters.
   std::unordered_map<std::string, RuntimeMetric> customStats;
 
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+
+#include <folly/lang/Bits.h>
+
+namespace facebook::velox::exec {
+
+namespace {
+
+// Returns the number of value bytes in the prefix for a key of 'kind', 0 if
+// the kind cannot be encoded. Strings are variable width and return -1.
+int32_t valueBytes(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+    case TypeKind::REAL:
+      return 4;
+    case TypeKind::BIGINT:
+    case TypeKind::DOUBLE:
+      return 8;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return -1;
+    default:
+      return 0;
+  }
+}
+
+// Keys covered by the prefix and their positions in it.
+struct PrefixLayout {
+  // Offset of the null byte of each encoded key. The value follows.
+  std::vector<int32_t> offsets;
+
+  // Number of value bytes of each encoded key.
+  std::vector<int32_t> sizes;
+
+  // Number of leading keys whose prefix bytes are equal only for equal
+  // values. Rows with equal prefixes are compared on the remaining keys.
+  int32_t numFullKeys{0};
+
+  int32_t numBytes{0};
+};
+
+PrefixLayout makeLayout(
+    const RowContainer& container,
+    const std::vector<PrefixSort::SortKey>& keys) {
+  PrefixLayout layout;
+  for (const auto& key : keys) {
+    auto size = valueBytes(container.columnTypes()[key.first]->kind());
+    if (size == 0) {
+      break;
+    }
+    auto isString = size < 0;
+    if (isString) {
+      size = PrefixSort::kMaxPrefixBytes - layout.numBytes - 1;
+      if (size <= 0) {
+        break;
+      }
+    } else if (layout.numBytes + 1 + size > PrefixSort::kMaxPrefixBytes) {
+      break;
+    }
+    layout.offsets.push_back(layout.numBytes);
+    layout.sizes.push_back(size);
+    layout.numBytes += 1 + size;
+    if (isString) {
+      break;
+    }
+    ++layout.numFullKeys;
+  }
+  return layout;
+}
+
+// Writes 'value' big endian with the sign bit flipped so that unsigned
+// comparison orders like signed comparison.
+template <typename T>
+void encodeInteger(T value, bool ascending, uint8_t* dest) {
+  using U = std::make_unsigned_t<T>;
+  constexpr U kSignBit = U(1) << (sizeof(U) * 8 - 1);
+  U bits = static_cast<U>(value) ^ kSignBit;
+  if (!ascending) {
+    bits = ~bits;
+  }
+  bits = folly::Endian::big(bits);
+  memcpy(dest, &bits, sizeof(U));
+}
+
+// Writes 'value' big endian so that unsigned comparison orders like
+// RowContainer::comparePrimitiveAsc(): The sign bit of positive numbers and
+// all bits of negative numbers are flipped. NaN is made the largest value
+// and -0.0 is encoded as 0.0, since the two compare equal.
+template <typename T, typename U>
+void encodeFloat(T value, bool ascending, uint8_t* dest) {
+  static_assert(sizeof(T) == sizeof(U));
+  constexpr U kSignBit = U(1) << (sizeof(U) * 8 - 1);
+  if (std::isnan(value)) {
+    value = std::numeric_limits<T>::quiet_NaN();
+  } else if (value == 0) {
+    value = 0;
+  }
+  U bits;
+  memcpy(&bits, &value, sizeof(U));
+  bits = (bits & kSignBit) ? ~bits : bits | kSignBit;
+  if (!ascending) {
+    bits = ~bits;
+  }
+  bits = folly::Endian::big(bits);
+  memcpy(dest, &bits, sizeof(U));
+}
+
+// Writes the first 'size' bytes of 'value', padded with zeros.
+void encodeString(
+    StringView value,
+    bool ascending,
+    int32_t size,
+    uint8_t* dest) {
+  std::string storage;
+  if (!value.isInline()) {
+    value = HashStringAllocator::contiguousString(value, storage);
+  }
+  auto numBytes = std::min<int32_t>(size, value.size());
+  memcpy(dest, value.data(), numBytes);
+  memset(dest + numBytes, 0, size - numBytes);
+  if (!ascending) {
+    for (auto i = 0; i < size; ++i) {
+      dest[i] = ~dest[i];
+    }
+  }
+}
+
+template <TypeKind Kind>
+void encodeValue(
+    const char* row,
+    int32_t offset,
+    bool ascending,
+    int32_t size,
+    uint8_t* dest) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  if constexpr (Kind == TypeKind::BOOLEAN) {
+    auto value = RowContainer::valueAt<bool>(row, offset);
+    dest[0] = ascending == value ? 1 : 0;
+  } else if constexpr (
+      Kind == TypeKind::TINYINT || Kind == TypeKind::SMALLINT ||
+      Kind == TypeKind::INTEGER || Kind == TypeKind::BIGINT) {
+    encodeInteger(RowContainer::valueAt<T>(row, offset), ascending, dest);
+  } else if constexpr (Kind == TypeKind::REAL) {
+    encodeFloat<float, uint32_t>(
+        RowContainer::valueAt<float>(row, offset), ascending, dest);
+  } else if constexpr (Kind == TypeKind::DOUBLE) {
+    encodeFloat<double, uint64_t>(
+        RowContainer::valueAt<double>(row, offset), ascending, dest);
+  } else if constexpr (
+      Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
+    encodeString(
+        RowContainer::valueAt<StringView>(row, offset), ascending, size, dest);
+  } else {
+    VELOX_UNREACHABLE();
+  }
+}
+
+// A row and its prefix as 'kNumWords' words that compare like the prefix
+// bytes.
+template <int32_t kNumWords>
+struct PrefixEntry {
+  uint64_t words[kNumWords];
+  char* row;
+};
+
+// Writes the prefix bytes of key 'keyIndex' for all of 'entries'.
+template <int32_t kNumWords, TypeKind Kind>
+void encodeKey(
+    const RowContainer& container,
+    const PrefixSort::SortKey& key,
+    const PrefixLayout& layout,
+    int32_t keyIndex,
+    std::vector<PrefixEntry<kNumWords>>& entries) {
+  auto column = container.columnAt(key.first);
+  auto nullByte = column.nullByte();
+  auto nullMask = column.nullMask();
+  auto offset = column.offset();
+  auto flags = key.second;
+  auto prefixOffset = layout.offsets[keyIndex];
+  auto size = layout.sizes[keyIndex];
+  for (auto& entry : entries) {
+    auto dest = reinterpret_cast<uint8_t*>(entry.words) + prefixOffset;
+    if (RowContainer::isNullAt(entry.row, nullByte, nullMask)) {
+      dest[0] = flags.nullsFirst ? 0 : 1;
+      memset(dest + 1, 0, size);
+    } else {
+      dest[0] = flags.nullsFirst ? 1 : 0;
+      encodeValue<Kind>(entry.row, offset, flags.ascending, size, dest + 1);
+    }
+  }
+}
+
+template <int32_t kNumWords>
+void sortWithPrefix(
+    RowContainer& container,
+    const std::vector<PrefixSort::SortKey>& keys,
+    const PrefixLayout& layout,
+    folly::Range<char**> rows) {
+  std::vector<PrefixEntry<kNumWords>> entries(rows.size());
+  for (auto i = 0; i < rows.size(); ++i) {
+    memset(entries[i].words, 0, sizeof(entries[i].words));
+    entries[i].row = rows[i];
+  }
+  for (auto i = 0; i < layout.offsets.size(); ++i) {
+    VELOX_DYNAMIC_SCALAR_TEMPLATE_TYPE_DISPATCH(
+        encodeKey,
+        kNumWords,
+        container.columnTypes()[keys[i].first]->kind(),
+        container,
+        keys[i],
+        layout,
+        i,
+        entries);
+  }
+  // The prefix bytes are big endian. Loading the words as big endian makes
+  // word comparison equal to comparing the bytes.
+  for (auto& entry : entries) {
+    for (auto i = 0; i < kNumWords; ++i) {
+      entry.words[i] = folly::Endian::big(entry.words[i]);
+    }
+  }
+
+  std::sort(
+      entries.begin(),
+      entries.end(),
+      [&](const PrefixEntry<kNumWords>& left,
+          const PrefixEntry<kNumWords>& right) {
+        for (auto i = 0; i < kNumWords; ++i) {
+          if (left.words[i] != right.words[i]) {
+            return left.words[i] < right.words[i];
+          }
+        }
+        for (auto i = layout.numFullKeys; i < keys.size(); ++i) {
+          if (auto result = container.compare(
+                  left.row, right.row, keys[i].first, keys[i].second)) {
+            return result < 0;
+          }
+        }
+        return false;
+      });
+
+  for (auto i = 0; i < rows.size(); ++i) {
+    rows[i] = entries[i].row;
+  }
+}
+} // namespace
+
+// static
+void PrefixSort::sort(
+    RowContainer& container,
+    const std::vector<SortKey>& keys,
+    folly::Range<char**> rows) {
+  if (rows.size() < 2) {
+    return;
+  }
+  auto layout = makeLayout(container, keys);
+  switch (bits::roundUp(layout.numBytes, 8) / 8) {
+    case 0:
+      std::sort(
+          rows.begin(), rows.end(), [&](const char* left, const char* right) {
+            for (const auto& key : keys) {
+              if (auto result =
+                      container.compare(left, right, key.first, key.second)) {
+                return result < 0;
+              }
+            }
+            return false;
+          });
+      break;
+    case 1:
+      sortWithPrefix<1>(container, keys, layout, rows);
+      break;
+    case 2:
+      sortWithPrefix<2>(container, keys, layout, rows);
+      break;
+    case 3:
+      sortWithPrefix<3>(container, keys, layout, rows);
+      break;
+    case 4:
+      sortWithPrefix<4>(container, keys, layout, rows);
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+// static
+std::vector<PrefixSort::SortKey> PrefixSort::leadingColumns(
+    int32_t numKeys,
+    const std::vector<CompareFlags>& flags) {
+  VELOX_CHECK(flags.empty() || flags.size() == numKeys);
+  std::vector<SortKey> keys;
+  keys.reserve(numKeys);
+  for (column_index_t i = 0; i < numKeys; ++i) {
+    keys.emplace_back(i, flags.empty() ? CompareFlags() : flags[i]);
+  }
+  return keys;
+}
+
+} // namespace facebook::velox::exec
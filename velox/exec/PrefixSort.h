@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/base/CompareFlags.h"
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+// Sorts pointers to rows of a RowContainer. The leading sort keys of each row
+// are encoded into a binary prefix of up to kMaxPrefixBytes that orders like
+// the keys when compared as unsigned bytes. The prefixes are kept next to the
+// row pointers in a side array, so that most comparisons neither dereference
+// the rows nor dispatch on the key types. Rows with equal prefixes are
+// compared with RowContainer::compare() on the keys the prefix does not fully
+// cover.
+//
+// BOOLEAN, TINYINT, SMALLINT, INTEGER, BIGINT, REAL, DOUBLE, VARCHAR and
+// VARBINARY keys can be encoded. Each encoded key takes a null byte followed
+// by the value. A string key is truncated to the bytes left in the prefix and
+// is the last key of the prefix. The prefix also ends before the first key of
+// another type or the first key that does not fit. If not even the first key
+// can be encoded, the rows are sorted with RowContainer::compare() only.
+class PrefixSort {
+ public:
+  // Column index in the RowContainer and comparison flags of a sort key.
+  using SortKey = std::pair<column_index_t, CompareFlags>;
+
+  static constexpr int32_t kMaxPrefixBytes = 32;
+
+  // Sorts 'rows' of 'container' on 'keys'.
+  static void sort(
+      RowContainer& container,
+      const std::vector<SortKey>& keys,
+      folly::Range<char**> rows);
+
+  // Returns the sort keys for the first 'numKeys' columns of a RowContainer.
+  // 'flags' gives the comparison flags for each key. If empty, the default
+  // flags are used for all keys.
+  static std::vector<SortKey> leadingColumns(
+      int32_t numKeys,
+      const std::vector<CompareFlags>& flags = {});
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/ProjectionHook.h"
+
+namespace facebook::velox::exec {
+namespace {
+template <typename T, typename TResult, typename Op>
+ProjectionHookFunction makeFunction(T constant) {
+  return [constant](const LazyVector& column, RowSet rows, BaseVector& result) {
+    ProjectionHook<T, TResult, Op> hook(
+        constant, rows, result.asUnchecked<FlatVector<TResult>>());
+    column.load(rows, &hook);
+  };
+}
+
+// The names are those of the Presto functions. Integer arithmetic is not
+// pushed down since it checks for overflow.
+template <typename T>
+ProjectionHookFunction makeFunction(const std::string& name, T constant) {
+  if (name == "eq") {
+    return makeFunction<T, bool, std::equal_to<T>>(constant);
+  }
+  if (name == "neq") {
+    return makeFunction<T, bool, std::not_equal_to<T>>(constant);
+  }
+  if (name == "lt") {
+    return makeFunction<T, bool, std::less<T>>(constant);
+  }
+  if (name == "lte") {
+    return makeFunction<T, bool, std::less_equal<T>>(constant);
+  }
+  if (name == "gt") {
+    return makeFunction<T, bool, std::greater<T>>(constant);
+  }
+  if (name == "gte") {
+    return makeFunction<T, bool, std::greater_equal<T>>(constant);
+  }
+  if constexpr (std::is_floating_point_v<T>) {
+    if (name == "plus") {
+      return makeFunction<T, T, std::plus<T>>(constant);
+    }
+    if (name == "minus") {
+      return makeFunction<T, T, std::minus<T>>(constant);
+    }
+    if (name == "multiply") {
+      return makeFunction<T, T, std::multiplies<T>>(constant);
+    }
+  }
+  return nullptr;
+}
+} // namespace
+
+ProjectionHookFunction makeProjectionHook(
+    const core::TypedExprPtr& projection,
+    std::string* columnName) {
+  auto call = dynamic_cast<const core::CallTypedExpr*>(projection.get());
+  if (!call || call->inputs().size() != 2) {
+    return nullptr;
+  }
+  auto field =
+      dynamic_cast<const core::FieldAccessTypedExpr*>(call->inputs()[0].get());
+  auto constant =
+      dynamic_cast<const core::ConstantTypedExpr*>(call->inputs()[1].get());
+  if (!field || !constant || constant->hasValueVector() ||
+      constant->value().isNull() ||
+      !field->type()->equivalent(*constant->type())) {
+    return nullptr;
+  }
+  if (!field->inputs().empty() &&
+      !dynamic_cast<const core::InputTypedExpr*>(field->inputs()[0].get())) {
+    return nullptr;
+  }
+  // The value of an INTEGER column may be passed as a 64 bit integer, whose
+  // low bytes are the value on little endian platforms.
+  ProjectionHookFunction function;
+  const auto& value = constant->value();
+  switch (field->type()->kind()) {
+    case TypeKind::INTEGER:
+      function = makeFunction(call->name(), value.value<int32_t>());
+      break;
+    case TypeKind::BIGINT:
+      function = makeFunction(call->name(), value.value<int64_t>());
+      break;
+    case TypeKind::REAL:
+      function = makeFunction(call->name(), value.value<float>());
+      break;
+    case TypeKind::DOUBLE:
+      function = makeFunction(call->name(), value.value<double>());
+      break;
+    default:
+      return nullptr;
+  }
+  if (function) {
+    *columnName = field->name();
+  }
+  return function;
+}
+
+} // namespace facebook::velox::exec
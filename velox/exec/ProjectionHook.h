@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <functional>
+
+#include "velox/core/Expressions.h"
+#include "velox/vector/FlatVector.h"
+#include "velox/vector/LazyVector.h"
+
+namespace facebook::velox::exec {
+
+// Computes 'Op(value, constant)' for the values of a LazyVector as the
+// loader produces them, so that a projection of a column of a table scan
+// does not materialize the column. The index passed to addValue() is the
+// position in 'rows'. The rows of 'result' are null until a value is added,
+// so null values need not be delivered.
+template <typename T, typename TResult, typename Op>
+class ProjectionHook final : public ValueHook {
+ public:
+  ProjectionHook(T constant, RowSet rows, FlatVector<TResult>* result)
+      : constant_(constant), rows_(rows), result_(result) {
+    for (auto row : rows_) {
+      result_->setNull(row, true);
+    }
+  }
+
+  void addValue(vector_size_t index, const void* value) override {
+    result_->set(
+        rows_[index], Op()(*reinterpret_cast<const T*>(value), constant_));
+  }
+
+ private:
+  const T constant_;
+  const RowSet rows_;
+  FlatVector<TResult>* const result_;
+};
+
+// Loads 'column' for 'rows' into 'result', a flat vector of the projection's
+// type, with a ProjectionHook.
+using ProjectionHookFunction = std::function<
+    void(const LazyVector& column, RowSet rows, BaseVector& result)>;
+
+// Returns a function to compute 'projection' with a ProjectionHook if it is
+// a comparison of an input column with a constant, or a floating point
+// plus, minus or multiply of an input column and a constant. Sets
+// '*columnName' to the name of the column. Returns nullptr otherwise.
+ProjectionHookFunction makeProjectionHook(
+    const core::TypedExprPtr& projection,
+    std::string* FOLLY_NONNULL columnName);
+
+} // namespace facebook::velox::exec
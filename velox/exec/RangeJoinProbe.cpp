@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/RangeJoinProbe.h"
+#include "velox/exec/OperatorUtils.h"
+
+#include <cmath>
+
+namespace facebook::velox::exec {
+
+namespace {
+// A NaN bound or probe key matches nothing, since all comparisons with NaN
+// are false. Leaving NaNs out also keeps the sort and the binary search on a
+// strict weak ordering.
+template <typename T>
+bool isNan(T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::isnan(value);
+  } else {
+    return false;
+  }
+}
+
+template <TypeKind Kind>
+std::vector<vector_size_t> sortedRanges(
+    const BaseVector& lower,
+    const BaseVector& upper) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  SelectivityVector allRows(lower.size());
+  DecodedVector lowers(lower, allRows);
+  DecodedVector uppers(upper, allRows);
+  std::vector<vector_size_t> rows;
+  for (auto i = 0; i < lower.size(); ++i) {
+    if (!lowers.isNullAt(i) && !uppers.isNullAt(i) &&
+        !isNan(lowers.valueAt<T>(i)) && !isNan(uppers.valueAt<T>(i)) &&
+        !(uppers.valueAt<T>(i) < lowers.valueAt<T>(i))) {
+      rows.push_back(i);
+    }
+  }
+  std::sort(rows.begin(), rows.end(), [&](auto left, auto right) {
+    return lowers.valueAt<T>(left) < lowers.valueAt<T>(right);
+  });
+  return rows;
+}
+} // namespace
+
+RangeJoinProbe::RangeJoinProbe(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::RangeJoinNode>& joinNode)
+    : CrossJoinProbe(operatorId, driverCtx, joinNode, "RangeJoinProbe"),
+      keyKind_(joinNode->probeKey()->type()->kind()),
+      probeChannel_(joinNode->sources()[0]->outputType()->getChildIdx(
+          joinNode->probeKey()->name())),
+      lowerChannel_(joinNode->sources()[1]->outputType()->getChildIdx(
+          joinNode->lowerKey()->name())),
+      upperChannel_(joinNode->sources()[1]->outputType()->getChildIdx(
+          joinNode->upperKey()->name())) {}
+
+// static
+std::vector<VectorPtr> RangeJoinProbe::sortBuildSide(
+    const core::RangeJoinNode& joinNode,
+    std::vector<VectorPtr> data,
+    memory::MemoryPool* pool) {
+  if (data.empty()) {
+    return data;
+  }
+  const auto& type = joinNode.sources()[1]->outputType();
+  vector_size_t size = 0;
+  for (const auto& vector : data) {
+    size += vector->size();
+  }
+  auto all = BaseVector::create<RowVector>(type, size, pool);
+  vector_size_t offset = 0;
+  for (auto& vector : data) {
+    auto* source = vector->asUnchecked<RowVector>();
+    for (auto i = 0; i < type->size(); ++i) {
+      all->childAt(i)->copy(
+          source->childAt(i)->loadedVector(), offset, 0, source->size());
+    }
+    offset += source->size();
+    vector = nullptr;
+  }
+
+  auto rows = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+      sortedRanges,
+      joinNode.probeKey()->type()->kind(),
+      *all->childAt(type->getChildIdx(joinNode.lowerKey()->name())),
+      *all->childAt(type->getChildIdx(joinNode.upperKey()->name())));
+  if (rows.empty()) {
+    return {};
+  }
+
+  auto sorted = BaseVector::create<RowVector>(type, rows.size(), pool);
+  SelectivityVector sortedRows(rows.size());
+  for (auto i = 0; i < type->size(); ++i) {
+    sorted->childAt(i)->copy(all->childAt(i).get(), sortedRows, rows.data());
+  }
+  return {sorted};
+}
+
+template <TypeKind Kind>
+void RangeJoinProbe::initializeTree() {
+  using T = typename TypeTraits<Kind>::NativeType;
+  auto* uppers = buildVector_->childAt(upperChannel_)->asFlatVector<T>();
+  treeSize_ = bits::nextPowerOfTwo(buildVector_->size());
+  tree_.assign(2 * treeSize_, -1);
+  std::iota(
+      tree_.begin() + treeSize_,
+      tree_.begin() + treeSize_ + buildVector_->size(),
+      0);
+  for (auto node = treeSize_ - 1; node > 0; --node) {
+    auto left = tree_[2 * node];
+    auto right = tree_[2 * node + 1];
+    tree_[node] = right >= 0 && uppers->valueAt(left) < uppers->valueAt(right)
+        ? right
+        : left;
+  }
+}
+
+void RangeJoinProbe::addInput(RowVectorPtr input) {
+  CrossJoinProbe::addInput(std::move(input));
+  decodedProbeKeys_.decode(
+      *input_->childAt(probeChannel_), SelectivityVector(input_->size()));
+}
+
+template <TypeKind Kind>
+vector_size_t RangeJoinProbe::findMatches(
+    vector_size_t* probeIndices,
+    vector_size_t* buildIndices) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  auto* lowers = buildVector_->childAt(lowerChannel_)->asFlatVector<T>();
+  auto* uppers = buildVector_->childAt(upperChannel_)->asFlatVector<T>();
+  const auto numBuildRows = buildVector_->size();
+  vector_size_t numMatches = 0;
+  while (numMatches < outputBatchSize_ && probeRow_ < input_->size()) {
+    if (decodedProbeKeys_.isNullAt(probeRow_) ||
+        isNan(decodedProbeKeys_.valueAt<T>(probeRow_))) {
+      ++probeRow_;
+      continue;
+    }
+    const auto key = decodedProbeKeys_.valueAt<T>(probeRow_);
+    if (!rowStarted_) {
+      // Binary search for the first build row with lower bound > 'key'.
+      int32_t begin = 0;
+      int32_t end = numBuildRows;
+      while (begin < end) {
+        auto middle = begin + (end - begin) / 2;
+        if (key < lowers->valueAt(middle)) {
+          end = middle;
+        } else {
+          begin = middle + 1;
+        }
+      }
+      rangeEnd_ = begin;
+      if (rangeEnd_ > 0) {
+        stack_.push_back(1);
+      }
+      rowStarted_ = true;
+    }
+
+    while (!stack_.empty() && numMatches < outputBatchSize_) {
+      auto node = stack_.back();
+      stack_.pop_back();
+      auto maxRow = tree_[node];
+      if (maxRow < 0 || uppers->valueAt(maxRow) < key) {
+        continue;
+      }
+      // First build row under 'node'.
+      const int32_t level = 63 - bits::countLeadingZeros(node);
+      const auto firstRow = (node - (1 << level)) * (treeSize_ >> level);
+      if (firstRow >= rangeEnd_) {
+        continue;
+      }
+      if (node >= treeSize_) {
+        probeIndices[numMatches] = probeRow_;
+        buildIndices[numMatches++] = node - treeSize_;
+        continue;
+      }
+      stack_.push_back(2 * node + 1);
+      stack_.push_back(2 * node);
+    }
+
+    if (stack_.empty()) {
+      rowStarted_ = false;
+      ++probeRow_;
+    }
+  }
+  return numMatches;
+}
+
+RowVectorPtr RangeJoinProbe::getOutput() {
+  if (!input_) {
+    return nullptr;
+  }
+  if (!buildVector_) {
+    VELOX_CHECK_EQ(buildData_->size(), 1);
+    buildVector_ = std::static_pointer_cast<RowVector>(buildData_->at(0));
+    VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(initializeTree, keyKind_);
+  }
+
+  // With a filter, batches with no passing rows are skipped.
+  for (;;) {
+    auto probeIndices = allocateIndices(outputBatchSize_, pool());
+    auto buildIndices = allocateIndices(outputBatchSize_, pool());
+    auto size = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+        findMatches,
+        keyKind_,
+        probeIndices->asMutable<vector_size_t>(),
+        buildIndices->asMutable<vector_size_t>());
+    if (filter_ && size > 0) {
+      size = evalFilter(size, probeIndices, buildIndices, *buildVector_);
+    }
+
+    auto input = input_;
+    if (probeRow_ == input_->size()) {
+      probeRow_ = 0;
+      input_.reset();
+    }
+    if (size == 0) {
+      if (!input_) {
+        return nullptr;
+      }
+      continue;
+    }
+
+    std::vector<VectorPtr> columns(outputType_->size());
+    for (const auto& projection : identityProjections_) {
+      columns[projection.outputChannel] = wrapChild(
+          size, probeIndices, input->childAt(projection.inputChannel));
+    }
+    for (const auto& projection : buildProjections_) {
+      columns[projection.outputChannel] = wrapChild(
+          size, buildIndices, buildVector_->childAt(projection.inputChannel));
+    }
+    return std::make_shared<RowVector>(
+        pool(), outputType_, BufferPtr(nullptr), size, std::move(columns));
+  }
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/CrossJoinProbe.h"
+
+namespace facebook::velox::exec {
+
+// Probe side of a RangeJoinNode. The build side is gathered by
+// CrossJoinBuild, which calls sortBuildSide() to make a single vector of the
+// build rows sorted on the lower bound. Each probe key then binary searches
+// the rows with lower bound <= key and finds the ones among them with upper
+// bound >= key in an implicit interval tree: a binary tree over the sorted
+// rows where each node holds the row with the largest upper bound below it.
+// Subtrees whose largest upper bound is below the key are skipped, so a probe
+// costs O(log n) per match instead of O(n).
+class RangeJoinProbe : public CrossJoinProbe {
+ public:
+  RangeJoinProbe(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::RangeJoinNode>& joinNode);
+
+  // Returns a single vector with the rows of 'data' that have non-null
+  // bounds with lower <= upper, sorted on the lower bound. Returns no vector
+  // if there are no such rows.
+  static std::vector<VectorPtr> sortBuildSide(
+      const core::RangeJoinNode& joinNode,
+      std::vector<VectorPtr> data,
+      memory::MemoryPool* pool);
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+ private:
+  // Sets up 'tree_' over the sorted build rows.
+  template <TypeKind Kind>
+  void initializeTree();
+
+  // Writes up to 'outputBatchSize_' matching pairs of probe and build rows
+  // to 'probeIndices' and 'buildIndices' and returns their number. Continues
+  // where the previous call stopped.
+  template <TypeKind Kind>
+  vector_size_t findMatches(
+      vector_size_t* probeIndices,
+      vector_size_t* buildIndices);
+
+  const TypeKind keyKind_;
+  const column_index_t probeChannel_;
+  const column_index_t lowerChannel_;
+  const column_index_t upperChannel_;
+
+  // The sorted build rows, see sortBuildSide().
+  RowVectorPtr buildVector_;
+
+  // Number of leaves of 'tree_', a power of two. Leaf i is node
+  // 'treeSize_' + i and holds build row i. The children of node n are 2n and
+  // 2n + 1. The root is node 1.
+  int32_t treeSize_{0};
+
+  // Build row with the largest upper bound under each node, -1 for nodes
+  // with no build rows.
+  std::vector<int32_t> tree_;
+
+  DecodedVector decodedProbeKeys_;
+
+  // True if the matches of the probe row 'probeRow_' are being enumerated.
+  bool rowStarted_{false};
+
+  // Number of build rows with lower bound <= the key of 'probeRow_'.
+  int32_t rangeEnd_{0};
+
+  // Nodes of 'tree_' left to visit for 'probeRow_'.
+  std::vector<int32_t> stack_;
+};
+} // namespace facebook::velox::exec
@@ -97,9 +97,19 @@ RowContainer::RowContainer(
   offset = std::max<int32_t>(offset, sizeof(void*));
   int32_t firstAggregate = offsets_.size();
   int32_t firstAggregateOffset = offset;
+  int32_t groupNumberOffset = -1;
   for (auto& aggregate : aggregates) {
-    offsets_.push_back(offset);
-    offset += aggregate->accumulatorFixedWidthSize();
+    if (aggregate->isColumnar()) {
+      // The columnar accumulators share the group number of the row.
+      if (groupNumberOffset < 0) {
+        groupNumberOffset = offset;
+        offset += sizeof(uint32_t);
+      }
+      offsets_.push_back(groupNumberOffset);
+    } else {
+      offsets_.push_back(offset);
+      offset += aggregate->accumulatorFixedWidthSize();
+    }
     nullOffsets_.push_back(nullOffset);
     ++nullOffset;
     isVariableWidth |= !aggregate->isFixedSize();
@@ -138,6 +148,9 @@ RowContainer::RowContainer(
   if (rowSizeOffset_) {
     rowSizeOffset_ += nullBytes;
   }
+  if (groupNumberOffset >= 0) {
+    groupNumberOffset_ = groupNumberOffset + nullBytes;
+  }
   for (int32_t i = 0; i < aggregates_.size() + dependentTypes.size(); ++i) {
     offsets_[i + firstAggregate] += nullBytes;
     nullOffset = nullOffsets_[i + firstAggregate];
@@ -191,6 +204,11 @@ char* RowContainer::newRow() {
     if (normalizedKeySize_) {
       ++numRowsWithNormalizedKey_;
     }
+    if (groupNumberOffset_) {
+      // A reused row keeps its number. All rows are live or free.
+      *reinterpret_cast<uint32_t*>(row + groupNumberOffset_) =
+          numRows_ + numFreeRows_ - 1;
+    }
   }
   return initializeRow(row, false /* reuse */);
 }
@@ -277,6 +295,56 @@ void RowContainer::checkConsistency() {
   VELOX_CHECK_EQ(allocatedRows, numRows_);
 }
 
+int64_t RowContainer::compactStringAllocator() {
+  for (auto& aggregate : aggregates_) {
+    if (!aggregate->supportsRelocation()) {
+      return 0;
+    }
+  }
+  return stringAllocator_.compact(
+      [&](const HashStringAllocator::Relocation& relocation) {
+        if (!relocation.numMoves()) {
+          return;
+        }
+        constexpr int32_t kBatch = 1000;
+        std::vector<char*> rows(kBatch);
+        RowContainerIterator iter;
+        for (;;) {
+          int64_t numRows = listRows(&iter, kBatch, rows.data());
+          if (!numRows) {
+            break;
+          }
+          for (auto i = 0; i < types_.size(); ++i) {
+            switch (typeKinds_[i]) {
+              case TypeKind::VARCHAR:
+              case TypeKind::VARBINARY:
+              case TypeKind::ROW:
+              case TypeKind::ARRAY:
+              case TypeKind::MAP: {
+                auto column = columnAt(i);
+                for (auto j = 0; j < numRows; ++j) {
+                  auto row = rows[j];
+                  if (isNullAt(row, column.nullByte(), column.nullMask())) {
+                    continue;
+                  }
+                  auto& view = valueAt<StringView>(row, column.offset());
+                  if (!view.isInline()) {
+                    view = StringView(
+                        relocation.newAddress(view.data()), view.size());
+                  }
+                }
+              } break;
+              default:;
+            }
+          }
+          for (auto& aggregate : aggregates_) {
+            aggregate->relocateAccumulators(
+                folly::Range<char**>(rows.data(), numRows), relocation);
+          }
+        }
+      });
+}
+
 void RowContainer::freeAggregates(folly::Range<char**> rows) {
   for (auto& aggregate : aggregates_) {
     aggregate->destroy(rows);
@@ -501,7 +569,8 @@ void RowContainer::clear() {
     constexpr int32_t kBatch = 1000;
     std::vector<char*> rows(kBatch);
 
-    RowContainerIterator iter;
+    // The rows before 'releasedIter_' have already been destroyed.
+    RowContainerIterator iter = releasedIter_;
     for (;;) {
       int64_t numRows = listRows(&iter, kBatch, rows.data());
       if (!numRows) {
@@ -520,6 +589,56 @@ void RowContainer::clear() {
   }
   numFreeRows_ = 0;
   firstFreeRow_ = nullptr;
+  releasedIter_.reset();
+}
+
+int64_t RowContainer::releaseRowsBefore(const RowContainerIterator& iter) {
+  VELOX_CHECK_EQ(rows_.numLargeAllocations(), 0);
+  // Rows may still be added to the current allocation.
+  const auto end =
+      std::min(iter.allocationIndex, rows_.numSmallAllocations() - 1);
+  if (releasedIter_.allocationIndex >= end) {
+    return 0;
+  }
+  if (releasedIter_.allocationIndex == 0) {
+    releasedIter_.normalizedKeysLeft = numRowsWithNormalizedKey_;
+  }
+  // Walks the rows like listRows() to keep track of the rows with a
+  // normalized key, so that the remaining rows can be listed from
+  // 'releasedIter_'.
+  auto& keysLeft = releasedIter_.normalizedKeysLeft;
+  std::vector<char*> rows;
+  int64_t freedBytes = 0;
+  for (auto i = releasedIter_.allocationIndex; i < end; ++i) {
+    auto allocation = rows_.allocationAt(i);
+    for (auto runIndex = 0; runIndex < allocation->numRuns(); ++runIndex) {
+      auto run = allocation->runAt(runIndex);
+      auto data = run.data<char>();
+      const int64_t limit = run.numPages() * memory::MappedMemory::kPageSize;
+      int64_t offset = 0;
+      for (;;) {
+        const auto keySize = keysLeft > 0 ? sizeof(normalized_key_t) : 0;
+        if (offset + fixedRowSize_ + keySize > limit) {
+          break;
+        }
+        auto row = data + offset + keySize;
+        offset += fixedRowSize_ + keySize;
+        if (keySize) {
+          --keysLeft;
+        }
+        if (usesExternalMemory_ && !bits::isBitSet(row, freeFlagOffset_)) {
+          rows.push_back(row);
+        }
+      }
+    }
+    if (!rows.empty()) {
+      freeAggregates(folly::Range<char**>(rows.data(), rows.size()));
+      rows.clear();
+    }
+    freedBytes += rows_.freeAllocation(i);
+  }
+  releasedIter_.allocationIndex = end;
+  return freedBytes;
 }
 
 void RowContainer::setProbedFlag(char** rows, int32_t numRows) {
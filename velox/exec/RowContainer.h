@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/memory/HashStringAllocator.h"
 #include "velox/common/memory/MappedMemory.h"
 #include "velox/exec/Aggregate.h"
@@ -101,6 +102,25 @@ class RowContainer {
             mappedMemory,
             ContainerRowSerde::instance()) {}
 
+  // 'keyTypes' gives the type of the keys of each row and
+  // 'dependentTypes' the types of the non-key columns, e.g. for an order
+  // by. Uses 'mappedMemory' for bulk allocation.
+  RowContainer(
+      const std::vector<TypePtr>& keyTypes,
+      const std::vector<TypePtr>& dependentTypes,
+      memory::MappedMemory* mappedMemory)
+      : RowContainer(
+            keyTypes,
+            true, // nullableKeys
+            emptyAggregates(),
+            dependentTypes,
+            false, // hasNext
+            false, // isJoinBuild
+            false, // hasProbedFlag
+            false, // hasNormalizedKey
+            mappedMemory,
+            ContainerRowSerde::instance()) {}
+
   // 'keyTypes' gives the type of the key of each row. For a group by,
   // order by or right outer join build side these may be
   // nullable. 'nullableKeys' specifies if these have a null flag.
@@ -292,6 +312,19 @@ class RowContainer {
     return rowSizeOffset_;
   }
 
+  // Returns the offset of the uint32_t group number of a row with columnar
+  // aggregates or 0 if there are no columnar aggregates, see
+  // Aggregate::setColumnar(). The rows are numbered from 0 in the order
+  // they are allocated.
+  int32_t groupNumberOffset() const {
+    return groupNumberOffset_;
+  }
+
+  uint32_t groupNumber(const char* row) const {
+    VELOX_DCHECK(groupNumberOffset_);
+    return *reinterpret_cast<const uint32_t*>(row + groupNumberOffset_);
+  }
+
   // For a hash join table with possible non-unique entries, the offset of
   // the pointer to the next row with the same key. 0 if keys are
   // guaranteed unique, e.g. for a group by or semijoin build.
@@ -320,6 +353,13 @@ class RowContainer {
         stringAllocator_.freeSpace());
   }
 
+  // Moves the variable length data of the rows and accumulators next to
+  // each other in the HashStringAllocator, frees the memory that becomes
+  // unused and updates the pointers in the rows. Returns the number of bytes
+  // freed. Returns 0 if an aggregate does not support relocation of its
+  // accumulators.
+  int64_t compactStringAllocator();
+
   // Returns a cap on  extra memory that may be needed when adding 'numRows'
   // and variableLengthBytes of out-of-line variable length data.
   int64_t sizeIncrement(vector_size_t numRows, int64_t variableLengthBytes)
@@ -328,9 +368,25 @@ class RowContainer {
   // Resets the state to be as after construction. Frees memory for payload.
   void clear();
 
-  int32_t compareRows(const char* left, const char* right) {
+  // Frees the allocations of rows that 'iter' has moved past, except the
+  // current allocation, for returning the rows in a single pass, e.g. the
+  // output of a final aggregation. The accumulators of the freed rows are
+  // destroyed. Their variable width data stays in the HashStringAllocator
+  // until clear(). Returns the number of bytes freed. After this, the rows
+  // may only be listed from 'iter' onwards and the container may only be
+  // cleared.
+  int64_t releaseRowsBefore(const RowContainerIterator& iter);
+
+  // Compares 'left' and 'right' on all keys. 'flags' gives the comparison
+  // flags for each key. If empty, the default flags are used for all keys.
+  int32_t compareRows(
+      const char* left,
+      const char* right,
+      const std::vector<CompareFlags>& flags = {}) {
+    VELOX_DCHECK(flags.empty() || flags.size() == keyTypes_.size());
     for (auto i = 0; i < keyTypes_.size(); ++i) {
-      auto result = compare(left, right, i);
+      auto result =
+          compare(left, right, i, flags.empty() ? CompareFlags() : flags[i]);
       if (result) {
         return result;
       }
@@ -389,15 +445,15 @@ class RowContainer {
     return (row[nullByte] & nullMask) != 0;
   }
 
- private:
-  // Offset of the pointer to the next free row on a free row.
-  static constexpr int32_t kNextFreeOffset = 0;
-
   template <typename T>
   static inline T valueAt(const char* group, int32_t offset) {
     return *reinterpret_cast<const T*>(group + offset);
   }
 
+ private:
+  // Offset of the pointer to the next free row on a free row.
+  static constexpr int32_t kNextFreeOffset = 0;
+
   template <typename T>
   static inline T& valueAt(char* group, int32_t offset) {
     return *reinterpret_cast<T*>(group + offset);
@@ -472,6 +528,75 @@ class RowContainer {
     }
   }
 
+  // Number of rows ahead of the current one whose values are prefetched
+  // when extracting a column. The rows are scattered over the container, so
+  // most of the time of an extract goes to cache misses.
+  static constexpr int32_t kPrefetchDistance = 16;
+
+  static inline void prefetchValue(
+      const char* const* rows,
+      int32_t index,
+      int32_t numRows,
+      int32_t offset) {
+    if (index < numRows && rows[index]) {
+      __builtin_prefetch(rows[index] + offset);
+    }
+  }
+
+  // Returns a mask with bit 'i - begin' set if 'rows[i]' is not nullptr
+  // for 'i' in [begin, end). 'end - begin' is at most 64.
+  static inline uint64_t nonNullRows(
+      const char* const* rows,
+      int32_t begin,
+      int32_t end) {
+    uint64_t mask = 0;
+    for (auto i = begin; i < end; ++i) {
+      mask |= static_cast<uint64_t>(rows[i] != nullptr) << (i - begin);
+    }
+    return mask;
+  }
+
+  // Returns the mask of all rows of [begin, end) for nonNullRows().
+  static inline uint64_t allRowsMask(int32_t begin, int32_t end) {
+    return end - begin == 64 ? ~0ULL : bits::lowMask(end - begin);
+  }
+
+  // Copies the values at 'offset' of 'rows' [begin, end) to the same
+  // positions of 'values'. The rows must not be nullptr. 8 byte values are
+  // loaded with SIMD gathers.
+  template <typename T>
+  static void gatherValues(
+      const char* const* rows,
+      int32_t begin,
+      int32_t end,
+      int32_t numRows,
+      int32_t offset,
+      MutableRange<T>& values) {
+    auto i = begin;
+    if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, double>) {
+      using Indices = xsimd::batch<int64_t>;
+      // The indices are the distances of the rows from 'rows[begin]'.
+      const auto* base = reinterpret_cast<const T*>(rows[begin] + offset);
+      const Indices baseAddress(reinterpret_cast<int64_t>(rows[begin]));
+      for (; i + Indices::size <= end; i += Indices::size) {
+        for (auto j = 0; j < Indices::size; ++j) {
+          prefetchValue(rows, i + j + kPrefetchDistance, numRows, offset);
+        }
+        auto indices = Indices::load_unaligned(
+                           reinterpret_cast<const int64_t*>(rows + i)) -
+            baseAddress;
+        simd::gather<T, int64_t, 1>(base, indices)
+            .store_unaligned(values.data() + i);
+      }
+    }
+    for (; i < end; ++i) {
+      prefetchValue(rows, i + kPrefetchDistance, numRows, offset);
+      values[i] = valueAt<T>(rows[i], offset);
+    }
+  }
+
+  // Extracts 64 rows at a time. The null flags of a group of rows are
+  // collected into a word and stored in 'result's nulls at once.
   template <typename T>
   static void extractValuesWithNulls(
       const char* const* rows,
@@ -485,13 +610,26 @@ class RowContainer {
     auto nulls = nullBuffer->asMutable<uint64_t>();
     BufferPtr valuesBuffer = result->mutableValues(numRows);
     auto values = valuesBuffer->asMutableRange<T>();
-    for (int32_t i = 0; i < numRows; ++i) {
-      if (rows[i] == nullptr) {
-        bits::setNull(nulls, i, true);
-      } else {
-        bits::setNull(nulls, i, isNullAt(rows[i], nullByte, nullMask));
-        values[i] = valueAt<T>(rows[i], offset);
+    for (int32_t begin = 0; begin < numRows; begin += 64) {
+      const auto end = std::min<int32_t>(numRows, begin + 64);
+      const bool allRows =
+          nonNullRows(rows, begin, end) == allRowsMask(begin, end);
+      if (allRows) {
+        gatherValues<T>(rows, begin, end, numRows, offset, values);
       }
+      uint64_t notNull = 0;
+      for (auto i = begin; i < end; ++i) {
+        if (!rows[i]) {
+          continue;
+        }
+        if (!allRows) {
+          prefetchValue(rows, i + kPrefetchDistance, numRows, offset);
+          values[i] = valueAt<T>(rows[i], offset);
+        }
+        const bool isNull = isNullAt(rows[i], nullByte, nullMask);
+        notNull |= static_cast<uint64_t>(!isNull) << (i - begin);
+      }
+      nulls[begin / 64] = notNull;
     }
   }
 
@@ -504,13 +642,27 @@ class RowContainer {
     result->resize(numRows);
     BufferPtr valuesBuffer = result->mutableValues(numRows);
     auto values = valuesBuffer->asMutableRange<T>();
-    for (int32_t i = 0; i < numRows; ++i) {
-      if (rows[i] == nullptr) {
-        result->setNull(i, true);
-      } else {
-        result->setNull(i, false);
+    // Nulls are written only if 'result' has nulls or a row is nullptr.
+    uint64_t* nulls = result->rawNulls() ? result->mutableRawNulls() : nullptr;
+    for (int32_t begin = 0; begin < numRows; begin += 64) {
+      const auto end = std::min<int32_t>(numRows, begin + 64);
+      const auto nonNull = nonNullRows(rows, begin, end);
+      if (nonNull == allRowsMask(begin, end)) {
         // Here a StringView will reference the hash table, not copy.
-        values[i] = valueAt<T>(rows[i], offset);
+        gatherValues<T>(rows, begin, end, numRows, offset, values);
+      } else {
+        for (auto i = begin; i < end; ++i) {
+          if (rows[i]) {
+            prefetchValue(rows, i + kPrefetchDistance, numRows, offset);
+            values[i] = valueAt<T>(rows[i], offset);
+          }
+        }
+        if (!nulls) {
+          nulls = result->mutableRawNulls();
+        }
+      }
+      if (nulls) {
+        nulls[begin / 64] = nonNull;
       }
     }
   }
@@ -792,6 +944,7 @@ class RowContainer {
   // Bit position of free bit.
   int32_t freeFlagOffset_ = 0;
   int32_t rowSizeOffset_ = 0;
+  int32_t groupNumberOffset_ = 0;
 
   int32_t fixedRowSize_;
   // True if normalized keys are enabled in initial state.
@@ -812,6 +965,8 @@ class RowContainer {
 
   AllocationPool rows_;
   HashStringAllocator stringAllocator_;
+  // The start of the first allocation not freed by releaseRowsBefore().
+  RowContainerIterator releasedIter_;
 
   const RowSerde& serde_;
   // RowContainer requires a valid reference to a vector of aggregates. We use
@@ -891,6 +1046,7 @@ inline void RowContainer::extractValuesNoNulls<StringView>(
     FlatVector<StringView>* result) {
   result->resize(numRows);
   for (int32_t i = 0; i < numRows; ++i) {
+    prefetchValue(rows, i + kPrefetchDistance, numRows, offset);
     if (rows[i] == nullptr) {
       result->setNull(i, true);
     } else {
@@ -910,6 +1066,7 @@ inline void RowContainer::extractValuesWithNulls<StringView>(
     FlatVector<StringView>* result) {
   result->resize(numRows);
   for (int32_t i = 0; i < numRows; ++i) {
+    prefetchValue(rows, i + kPrefetchDistance, numRows, offset);
     if (!rows[i] || isNullAt(rows[i], nullByte, nullMask)) {
       result->setNull(i, true);
     } else {
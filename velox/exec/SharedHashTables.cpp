@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/SharedHashTables.h"
+
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+// static
+SharedHashTables& SharedHashTables::instance() {
+  static SharedHashTables tables;
+  return tables;
+}
+
+// static
+bool SharedHashTables::isShared(
+    const core::HashJoinNode& joinNode,
+    const core::QueryConfig& config) {
+  if (joinNode.isRightJoin() || joinNode.isFullJoin()) {
+    return false;
+  }
+  return isPlanNodeIdListed(config.sharedHashTableJoinIds(), joinNode.id());
+}
+
+// static
+std::optional<std::string> SharedHashTables::key(
+    const core::HashJoinNode& joinNode,
+    const Task& task,
+    uint32_t splitGroupId) {
+  if (!isShared(joinNode, task.queryCtx()->config())) {
+    return std::nullopt;
+  }
+  const auto& taskId = task.taskId();
+  const auto queryEnd = taskId.find('.');
+  if (queryEnd == std::string::npos) {
+    return std::nullopt;
+  }
+  const auto stageEnd = taskId.find('.', queryEnd + 1);
+  if (stageEnd == std::string::npos) {
+    return std::nullopt;
+  }
+  return fmt::format(
+      "{}/{}/{}", taskId.substr(0, stageEnd), joinNode.id(), splitGroupId);
+}
+
+// static
+bool SharedHashTables::isStale(const Entry& entry) {
+  return entry.builderTask.expired() ||
+      (entry.published && !entry.antiJoinHasNullKeys &&
+       entry.table.expired());
+}
+
+// static
+std::function<void()> SharedHashTables::shareFunc(
+    const Entry& entry,
+    std::shared_ptr<HashJoinBridge> bridge) {
+  if (entry.antiJoinHasNullKeys) {
+    return [bridge]() { bridge->setAntiJoinHasNullKeys(); };
+  }
+  auto table = entry.table.lock();
+  auto task = entry.builderTask.lock();
+  if (!table || !task) {
+    return nullptr;
+  }
+  auto sharedTable = retainTaskWithTable(std::move(table), std::move(task));
+  return [bridge,
+          sharedTable = std::move(sharedTable),
+          keyBloomFilters = entry.keyBloomFilters]() {
+    bridge->setSharedHashTable(sharedTable, keyBloomFilters);
+  };
+}
+
+bool SharedHashTables::buildOrShare(
+    const std::string& key,
+    const std::shared_ptr<Task>& task,
+    const std::shared_ptr<HashJoinBridge>& bridge) {
+  std::function<void()> share;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (isStale(it->second)) {
+        it = entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      Entry entry;
+      entry.builderTask = task;
+      entry.builder = bridge;
+      entries_.emplace(key, std::move(entry));
+      return true;
+    }
+    auto& entry = it->second;
+    if (entry.builder.lock() == bridge) {
+      return true;
+    }
+    auto builderTask = entry.builderTask.lock();
+    if (!builderTask || builderTask->queryCtx() != task->queryCtx()) {
+      return true;
+    }
+    for (const auto& sharer : entry.sharers) {
+      if (sharer.lock() == bridge) {
+        return false;
+      }
+    }
+    entry.sharers.push_back(bridge);
+    if (entry.published) {
+      share = shareFunc(entry, bridge);
+      VELOX_CHECK_NOT_NULL(share, "Shared hash table is gone: {}", key);
+    }
+  }
+  if (share) {
+    share();
+  }
+  return false;
+}
+
+void SharedHashTables::publish(
+    const std::string& key,
+    const HashJoinBridge* bridge,
+    const std::shared_ptr<BaseHashTable>& table,
+    const std::vector<std::shared_ptr<common::Filter>>& keyBloomFilters) {
+  std::vector<std::function<void()>> shares;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.builder.lock().get() != bridge) {
+      return;
+    }
+    auto& entry = it->second;
+    VELOX_CHECK(!entry.published, "Shared hash table published twice: {}", key);
+    entry.published = true;
+    entry.antiJoinHasNullKeys = table == nullptr;
+    entry.table = table;
+    entry.keyBloomFilters = keyBloomFilters;
+    for (const auto& sharer : entry.sharers) {
+      if (auto sharerBridge = sharer.lock()) {
+        if (auto share = shareFunc(entry, std::move(sharerBridge))) {
+          shares.push_back(std::move(share));
+        }
+      }
+    }
+  }
+  for (auto& share : shares) {
+    share();
+  }
+}
+
+void SharedHashTables::cancel(
+    const std::string& key,
+    const HashJoinBridge* bridge) {
+  std::vector<std::shared_ptr<HashJoinBridge>> sharers;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.published ||
+        it->second.builder.lock().get() != bridge) {
+      return;
+    }
+    for (const auto& sharer : it->second.sharers) {
+      if (auto sharerBridge = sharer.lock()) {
+        sharers.push_back(std::move(sharerBridge));
+      }
+    }
+    entries_.erase(it);
+  }
+  for (auto& sharer : sharers) {
+    sharer->cancel();
+  }
+}
+
+size_t SharedHashTables::size() {
+  std::lock_guard<std::mutex> l(mutex_);
+  size_t count = 0;
+  for (const auto& [key, entry] : entries_) {
+    if (!isStale(entry)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <optional>
+
+#include "velox/exec/HashBuild.h"
+
+namespace facebook::velox::exec {
+
+class Task;
+
+/// Process-wide registry of the hash tables of broadcast joins. All the tasks
+/// of a stage that run in this process get the whole build side of a
+/// broadcast join and would each build the same table. For the joins listed
+/// in the shared_hash_table_join_ids query config, the first task to reach
+/// the join builds the table and the other tasks of the same query and stage
+/// get it through their HashJoinBridge without building. The table is read
+/// only for the probes, so only joins that do not mark build side rows, i.e.
+/// not right or full joins, are shared. Shared builds neither spill nor swap
+/// the join sides.
+///
+/// The memory of the table is charged once, to the building task. The
+/// bridges of the other tasks hold the table and the building task, whose
+/// pools own its memory, so that the table lives until the last task that
+/// probes it is gone. The registry only has weak references. A task that
+/// comes after the table is gone builds it again. Thread safe.
+class SharedHashTables {
+ public:
+  /// The registry used by HashBuild.
+  static SharedHashTables& instance();
+
+  /// Returns true if the table of 'joinNode' is shared under 'config'.
+  static bool isShared(
+      const core::HashJoinNode& joinNode,
+      const core::QueryConfig& config);
+
+  /// Returns the registry key of the table of 'joinNode' in split group
+  /// 'splitGroupId' of 'task', or std::nullopt if the table is not shared.
+  /// Task ids are <query>.<stage>.<...>, so the tasks of a stage have the
+  /// same id up to the second '.'. Ids not of this form are not shared.
+  static std::optional<std::string> key(
+      const core::HashJoinNode& joinNode,
+      const Task& task,
+      uint32_t splitGroupId);
+
+  /// Returns true if 'bridge' of 'task' builds the table of 'key'.
+  /// Otherwise 'bridge' gets the table of the building task once it is
+  /// published, right away if it already is. Each HashBuild of a task calls
+  /// this, and all of them get the same answer. A task of another QueryCtx
+  /// builds its own table.
+  bool buildOrShare(
+      const std::string& key,
+      const std::shared_ptr<Task>& task,
+      const std::shared_ptr<HashJoinBridge>& bridge);
+
+  /// Hands the table built by 'bridge' to the bridges that share it. 'table'
+  /// is nullptr if the build side of an anti join has a null key. No-op if
+  /// 'bridge' does not build 'key'.
+  void publish(
+      const std::string& key,
+      const HashJoinBridge* bridge,
+      const std::shared_ptr<BaseHashTable>& table,
+      const std::vector<std::shared_ptr<common::Filter>>& keyBloomFilters);
+
+  /// Cancels the bridges waiting for the table of 'key' and forgets the
+  /// build. Called when the task of 'bridge' fails before publishing. No-op
+  /// if 'bridge' does not build 'key' or the table is published.
+  void cancel(const std::string& key, const HashJoinBridge* bridge);
+
+  /// Returns the number of builds in progress or with a live table.
+  size_t size();
+
+ private:
+  struct Entry {
+    std::weak_ptr<Task> builderTask;
+    std::weak_ptr<HashJoinBridge> builder;
+    bool published{false};
+    bool antiJoinHasNullKeys{false};
+    std::weak_ptr<BaseHashTable> table;
+    std::vector<std::shared_ptr<common::Filter>> keyBloomFilters;
+    // The bridges of the other tasks. These are given the table on publish.
+    std::vector<std::weak_ptr<HashJoinBridge>> sharers;
+  };
+
+  // Returns true if the build of 'entry' is gone.
+  static bool isStale(const Entry& entry);
+
+  // Returns a function that gives the published table of 'entry' to
+  // 'bridge', to be called outside of 'mutex_'. The table given to 'bridge'
+  // holds the building task. Returns nullptr if the table is gone.
+  static std::function<void()> shareFunc(
+      const Entry& entry,
+      std::shared_ptr<HashJoinBridge> bridge);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SortBuffer.h"
+#include "velox/exec/PrefixSort.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+SortBuffer::SortBuffer(
+    const RowTypePtr& type,
+    const std::vector<column_index_t>& sortChannels,
+    const std::vector<CompareFlags>& sortCompareFlags,
+    OperatorCtx& operatorCtx)
+    : type_(type),
+      operatorCtx_(operatorCtx),
+      spillPath_(operatorCtx.makeSpillPath()),
+      testSpillPct_(
+          operatorCtx.task()->queryCtx()->config().testingSpillPct()) {
+  VELOX_CHECK(!sortChannels.empty());
+  VELOX_CHECK_EQ(sortChannels.size(), sortCompareFlags.size());
+  columnMap_.resize(type_->size());
+  std::vector<bool> isKey(type_->size(), false);
+  std::vector<TypePtr> keyTypes;
+  for (auto i = 0; i < sortChannels.size(); ++i) {
+    auto channel = sortChannels[i];
+    if (!isKey[channel]) {
+      isKey[channel] = true;
+      columnMap_[channel] = i;
+    }
+    containerChannels_.push_back(channel);
+    keyTypes.push_back(type_->childAt(channel));
+    keyCompareFlags_.push_back(sortCompareFlags[i]);
+  }
+
+  std::vector<TypePtr> dependentTypes;
+  for (column_index_t channel = 0; channel < type_->size(); ++channel) {
+    if (!isKey[channel]) {
+      columnMap_[channel] = containerChannels_.size();
+      containerChannels_.push_back(channel);
+      dependentTypes.push_back(type_->childAt(channel));
+    }
+  }
+
+  data_ = std::make_unique<RowContainer>(
+      keyTypes, dependentTypes, operatorCtx_.mappedMemory());
+}
+
+void SortBuffer::addInput(const RowVectorPtr& input) {
+  VELOX_CHECK(!noMoreInput_);
+  ensureInputFits(input);
+
+  SelectivityVector allRows(input->size());
+  std::vector<char*> rows(input->size());
+  for (auto row = 0; row < input->size(); ++row) {
+    rows[row] = data_->newRow();
+  }
+  for (auto col = 0; col < containerChannels_.size(); ++col) {
+    DecodedVector decoded(*input->childAt(containerChannels_[col]), allRows);
+    for (auto i = 0; i < input->size(); ++i) {
+      data_->store(decoded, i, rows[i], col);
+    }
+  }
+  numRows_ += input->size();
+}
+
+void SortBuffer::ensureInputFits(const RowVectorPtr& input) {
+  if (!spillPath_.has_value() || data_->numRows() == 0) {
+    return;
+  }
+
+  if (testSpillPct_ &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <= testSpillPct_) {
+    spill();
+    return;
+  }
+
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  int64_t flatBytes = input->estimateFlatSize();
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatBytes)) {
+    return;
+  }
+
+  auto increment =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatBytes : 0);
+  auto tracker = operatorCtx_.mappedMemory()->tracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  if (tracker->getAvailableReservation() > 2 * increment) {
+    return;
+  }
+  auto targetIncrement =
+      std::max<int64_t>(increment * 2, tracker->getCurrentUserBytes() / 4);
+  if (tracker->maybeReserve(targetIncrement)) {
+    return;
+  }
+
+  // All rows go into one sorted run, which makes the fewest runs to merge.
+  spill();
+}
+
+void SortBuffer::spill() {
+  if (!spiller_) {
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < containerChannels_.size(); ++i) {
+      names.push_back(fmt::format("s{}", i));
+      types.push_back(type_->childAt(containerChannels_[i]));
+    }
+    auto fileSize =
+        operatorCtx_.mappedMemory()->tracker()->getCurrentUserBytes() / 4;
+    const auto& queryCtx = operatorCtx_.task()->queryCtx();
+    spiller_ = std::make_unique<Spiller>(
+        *data_,
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        ROW(std::move(names), std::move(types)),
+        HashBitRange(0, 0),
+        keyCompareFlags_.size(),
+        spillPath_.value(),
+        fileSize,
+        Spiller::spillPool(),
+        queryCtx->spillExecutor(),
+        keyCompareFlags_,
+        spillCodecType(queryCtx->config().spillCompressionCodec()),
+        operatorCtx_.spillDirectories());
+  }
+  spiller_->spill(0, 0, spillIterator_);
+}
+
+void SortBuffer::noMoreInput() {
+  VELOX_CHECK(!noMoreInput_);
+  noMoreInput_ = true;
+  if (numRows_ == 0) {
+    return;
+  }
+
+  if (spiller_) {
+    spiller_->finishSpill();
+    merge_ = spiller_->startMerge(0);
+    return;
+  }
+
+  sortedRows_.resize(numRows_);
+  RowContainerIterator iter;
+  data_->listRows(&iter, numRows_, sortedRows_.data());
+  PrefixSort::sort(
+      *data_,
+      PrefixSort::leadingColumns(keyCompareFlags_.size(), keyCompareFlags_),
+      folly::Range<char**>(sortedRows_.data(), sortedRows_.size()));
+}
+
+RowVectorPtr SortBuffer::getOutput() {
+  VELOX_CHECK(noMoreInput_);
+  if (numRowsReturned_ == numRows_) {
+    return nullptr;
+  }
+  if (merge_) {
+    return getOutputFromSpill();
+  }
+
+  auto numRows = std::min<size_t>(
+      data_->estimatedNumRowsPerBatch(kBatchSizeInBytes),
+      numRows_ - numRowsReturned_);
+  auto result = std::static_pointer_cast<RowVector>(
+      BaseVector::create(type_, numRows, operatorCtx_.pool()));
+  for (auto i = 0; i < type_->size(); ++i) {
+    data_->extractColumn(
+        sortedRows_.data() + numRowsReturned_,
+        numRows,
+        columnMap_[i],
+        result->childAt(i));
+  }
+  numRowsReturned_ += numRows;
+  return result;
+}
+
+RowVectorPtr SortBuffer::getOutputFromSpill() {
+  auto numRowsToReturn = std::min<size_t>(
+      data_->estimatedNumRowsPerBatch(kBatchSizeInBytes),
+      numRows_ - numRowsReturned_);
+  auto result = std::static_pointer_cast<RowVector>(
+      BaseVector::create(type_, numRowsToReturn, operatorCtx_.pool()));
+
+  size_t numRows = 0;
+  for (; numRows < numRowsToReturn; ++numRows) {
+    auto stream = merge_->next();
+    if (!stream) {
+      break;
+    }
+    auto& source = stream->current();
+    for (auto i = 0; i < type_->size(); ++i) {
+      result->childAt(i)->copy(
+          source.childAt(columnMap_[i]).get(),
+          numRows,
+          stream->currentIndex(),
+          1);
+    }
+    stream->pop();
+  }
+  VELOX_CHECK_EQ(numRows, numRowsToReturn, "Spilled rows lost in merge");
+  numRowsReturned_ += numRows;
+  if (numRowsReturned_ == numRows_) {
+    merge_ = nullptr;
+  }
+  return result;
+}
+
+} // namespace facebook::velox::exec
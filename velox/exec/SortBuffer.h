@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
+#include "velox/exec/TreeOfLosers.h"
+
+namespace facebook::velox::exec {
+
+// Sorts the rows added to it on a subset of the columns. The rows are
+// stored in a RowContainer and sorted with PrefixSort once all rows are
+// added. If a spill path is configured and the memory reservation of the
+// operator cannot be grown to fit the next input, the rows are written to
+// disk as a sorted run and the output is produced by merging the runs, like
+// in OrderBy. Used by TableWriter to write files sorted on the sorting keys
+// of the TableWriteNode.
+class SortBuffer {
+ public:
+  // 'sortChannels' are the columns of 'type' to sort on, collated by
+  // 'sortCompareFlags'. 'operatorCtx' gives the memory and spill settings
+  // and must outlive 'this'.
+  SortBuffer(
+      const RowTypePtr& type,
+      const std::vector<column_index_t>& sortChannels,
+      const std::vector<CompareFlags>& sortCompareFlags,
+      OperatorCtx& operatorCtx);
+
+  void addInput(const RowVectorPtr& input);
+
+  // Sorts the rows or starts merging the spilled runs.
+  void noMoreInput();
+
+  // Returns the next batch of sorted rows, nullptr after the last batch.
+  // noMoreInput() must have been called.
+  RowVectorPtr getOutput();
+
+  // Returns the spiller, nullptr if nothing was spilled.
+  const Spiller* FOLLY_NULLABLE spiller() const {
+    return spiller_.get();
+  }
+
+ private:
+  static const int32_t kBatchSizeInBytes{2 * 1024 * 1024};
+
+  // Checks if the input will fit in the existing memory and increases the
+  // reservation if not. If the reservation cannot be increased, spills all
+  // rows as a sorted run.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  void spill();
+
+  RowVectorPtr getOutputFromSpill();
+
+  const RowTypePtr type_;
+  OperatorCtx& operatorCtx_;
+
+  // Column of 'type_' for each column of 'data_'. The sorting keys come
+  // first, followed by the remaining columns.
+  std::vector<column_index_t> containerChannels_;
+
+  // Column of 'data_' for each column of 'type_'.
+  std::vector<column_index_t> columnMap_;
+
+  std::vector<CompareFlags> keyCompareFlags_;
+
+  std::unique_ptr<RowContainer> data_;
+
+  size_t numRows_{0};
+  size_t numRowsReturned_{0};
+  std::vector<char*> sortedRows_;
+
+  // Filesystem path for spill files, empty if spilling is disabled.
+  const std::optional<std::string> spillPath_;
+
+  // Percentage of input batches to be spilled for testing.
+  const int32_t testSpillPct_;
+  uint64_t spillTestCounter_{0};
+
+  std::unique_ptr<Spiller> spiller_;
+  RowContainerIterator spillIterator_;
+
+  // Merges the spilled runs and the unspilled rows.
+  std::unique_ptr<TreeOfLosers<SpillStream>> merge_;
+
+  bool noMoreInput_{false};
+};
+
+} // namespace facebook::velox::exec
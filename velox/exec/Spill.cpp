@@ -15,18 +15,186 @@
  */
 
 #include "velox/exec/Spill.h"
+#include <folly/String.h>
+#include <folly/io/Cursor.h>
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/process/EventTrace.h"
+#include "velox/common/time/Timer.h"
+#include "velox/vector/LazyVector.h"
 
 namespace facebook::velox::exec {
 
+namespace {
+// A compressed block of a spill file starts with its uncompressed and
+// compressed sizes as int32_t.
+constexpr int32_t kBlockHeaderSize = 2 * sizeof(int32_t);
+
+// Adds the wall time of an append to the runtime stats of the spilling
+// operator.
+void recordWriteTime(uint64_t wallMicros) {
+  addThreadLocalRuntimeStat(
+      "spillWriteWallNanos",
+      RuntimeCounter(
+          wallMicros * 1'000,
+          RuntimeCounter::Unit::kNanos,
+          /*histogram=*/true));
+}
+
+void append(WriteFile& file, const folly::IOBuf& data) {
+  for (auto& range : data) {
+    file.append(std::string_view(
+        reinterpret_cast<const char*>(range.data()), range.size()));
+  }
+}
+} // namespace
+
 std::atomic<int32_t> SpillStream::ordinalCounter_;
 
+folly::io::CodecType spillCodecType(const std::string& name) {
+  if (name == "none") {
+    return folly::io::CodecType::NO_COMPRESSION;
+  }
+  if (name == "lz4") {
+    return folly::io::CodecType::LZ4;
+  }
+  if (name == "zstd") {
+    return folly::io::CodecType::ZSTD;
+  }
+  VELOX_USER_FAIL("Unknown spill compression codec: {}", name);
+}
+
+// static
+std::vector<SpillDirectory*> SpillDirectory::parse(
+    const std::string& spillPath) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::unique_ptr<SpillDirectory>>
+      directories;
+  std::vector<std::string> entries;
+  folly::split(',', spillPath, entries, true);
+  std::vector<SpillDirectory*> result;
+  std::lock_guard<std::mutex> l(mutex);
+  for (auto& entry : entries) {
+    // The capacity is the part after the last ':' if it is a number. This
+    // leaves paths like file:/x without a capacity.
+    uint64_t capacity = 0;
+    auto colon = entry.rfind(':');
+    if (colon != std::string::npos && colon + 1 < entry.size() &&
+        std::all_of(entry.begin() + colon + 1, entry.end(), ::isdigit)) {
+      capacity = folly::to<uint64_t>(entry.substr(colon + 1));
+      entry.resize(colon);
+    }
+    auto& directory = directories[entry];
+    if (!directory) {
+      directory = std::make_unique<SpillDirectory>(entry, capacity);
+    }
+    result.push_back(directory.get());
+  }
+  return result;
+}
+
+// static
+SpillDirectory* SpillDirectory::pick(
+    const std::vector<SpillDirectory*>& directories,
+    uint64_t bytes) {
+  VELOX_CHECK(!directories.empty());
+  SpillDirectory* best = nullptr;
+  SpillDirectory* mostFree = directories[0];
+  for (auto* directory : directories) {
+    auto freeBytes = directory->freeBytes();
+    if (freeBytes > mostFree->freeBytes()) {
+      mostFree = directory;
+    }
+    if (freeBytes < static_cast<int64_t>(bytes)) {
+      continue;
+    }
+    if (!best) {
+      best = directory;
+      continue;
+    }
+    if (directory->numWriters() != best->numWriters()) {
+      if (directory->numWriters() < best->numWriters()) {
+        best = directory;
+      }
+      continue;
+    }
+    if (freeBytes != best->freeBytes()) {
+      if (freeBytes > best->freeBytes()) {
+        best = directory;
+      }
+      continue;
+    }
+    if (directory->usedBytes() < best->usedBytes()) {
+      best = directory;
+    }
+  }
+  return best ? best : mostFree;
+}
+
+SpillInput::~SpillInput() {
+  if (prefetch_) {
+    // Waits for a read in flight. Its result and error are dropped.
+    prefetch_->move();
+  }
+}
+
+int32_t SpillInput::load(BufferPtr& buffer) {
+  if (!codec_) {
+    int32_t readBytes = std::min(size_ - offset_, buffer->capacity());
+    VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
+    input_->pread(offset_, readBytes, buffer->asMutable<char>());
+    offset_ += readBytes;
+    return readBytes;
+  }
+  VELOX_CHECK_LE(
+      offset_ + kBlockHeaderSize, size_, "Reading past end of spill file");
+  int32_t sizes[2];
+  input_->pread(offset_, kBlockHeaderSize, sizes);
+  const auto uncompressedSize = sizes[0];
+  const auto compressedSize = sizes[1];
+  offset_ += kBlockHeaderSize;
+  VELOX_CHECK_LE(offset_ + compressedSize, size_, "Truncated spill file");
+  auto compressed = folly::IOBuf::create(compressedSize);
+  input_->pread(offset_, compressedSize, compressed->writableData());
+  compressed->append(compressedSize);
+  offset_ += compressedSize;
+  auto uncompressed = codec_->uncompress(compressed.get(), uncompressedSize);
+  if (buffer->capacity() < uncompressedSize) {
+    AlignedBuffer::reallocate<char>(&buffer, uncompressedSize);
+  }
+  folly::io::Cursor(uncompressed.get())
+      .pull(buffer->asMutable<char>(), uncompressedSize);
+  return uncompressedSize;
+}
+
+void SpillInput::startPrefetch() {
+  prefetch_ = std::make_shared<AsyncSource<int32_t>>([this]() {
+    try {
+      return std::make_unique<int32_t>(load(prefetchBuffer_));
+    } catch (const std::exception&) {
+      // The error is rethrown on the reading thread in next().
+      prefetchError_ = std::current_exception();
+      return std::make_unique<int32_t>(0);
+    }
+  });
+  executor_->add([prefetch = prefetch_]() { prefetch->prepare(); });
+}
+
 void SpillInput::next(bool /*throwIfPastEnd*/) {
-  int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
-  VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
+  int32_t readBytes;
+  if (prefetch_) {
+    readBytes = *prefetch_->move();
+    prefetch_ = nullptr;
+    if (prefetchError_) {
+      std::rethrow_exception(prefetchError_);
+    }
+    std::swap(buffer_, prefetchBuffer_);
+  } else {
+    readBytes = load(buffer_);
+  }
   setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
-  input_->pread(offset_, readBytes, buffer_->asMutable<char>());
-  offset_ += readBytes;
+  if (executor_ && offset_ < size_) {
+    startPrefetch();
+  }
 }
 
 void SpillStream::pop() {
@@ -36,6 +204,16 @@ void SpillStream::pop() {
 }
 
 SpillFile::~SpillFile() {
+  if (pendingWrite_) {
+    // Waits for the append in flight. Its error is dropped.
+    pendingWrite_->move();
+  }
+  if (directory_) {
+    if (output_) {
+      directory_->removeWriter();
+    }
+    directory_->addUsedBytes(-static_cast<int64_t>(writtenBytes_));
+  }
   try {
     auto fs = filesystems::getFileSystem(path_, nullptr);
     fs->remove(path_);
@@ -48,10 +226,75 @@ WriteFile& SpillFile::output() {
   if (!output_) {
     auto fs = filesystems::getFileSystem(path_, nullptr);
     output_ = fs->openFileForWrite(path_);
+    if (directory_) {
+      directory_->addWriter();
+    }
   }
   return *output_;
 }
 
+void SpillFile::write(std::unique_ptr<folly::IOBuf> data) {
+  auto& file = output();
+  auto numBytes = data->computeChainDataLength();
+  writtenBytes_ += numBytes;
+  if (directory_) {
+    directory_->addUsedBytes(numBytes);
+    if (ioStats_) {
+      ioStats_->addWrittenBytes(directory_->path(), numBytes);
+    }
+  }
+  if (!executor_) {
+    process::TraceSpan span("spill", {"write"});
+    uint64_t wallMicros = 0;
+    {
+      MicrosecondTimer timer(&wallMicros);
+      append(file, *data);
+    }
+    recordWriteTime(wallMicros);
+    return;
+  }
+  waitForWrite();
+  pendingWrite_ = std::make_shared<AsyncSource<WriteResult>>(
+      [&file,
+       data = std::shared_ptr<folly::IOBuf>(std::move(data)),
+       traceId = process::EventTrace::currentTraceId()]() {
+        // The write is in the trace of the spilling thread.
+        process::ScopedTraceId scopedTraceId(traceId);
+        process::TraceSpan span("spill", {"write"});
+        auto result = std::make_unique<WriteResult>();
+        try {
+          MicrosecondTimer timer(&result->wallMicros);
+          append(file, *data);
+        } catch (const std::exception&) {
+          result->error = std::current_exception();
+        }
+        return result;
+      });
+  executor_->add([write = pendingWrite_]() { write->prepare(); });
+}
+
+void SpillFile::waitForWrite() {
+  if (!pendingWrite_) {
+    return;
+  }
+  auto result = pendingWrite_->move();
+  pendingWrite_ = nullptr;
+  if (result->error) {
+    std::rethrow_exception(result->error);
+  }
+  recordWriteTime(result->wallMicros);
+}
+
+void SpillFile::finishWrite() {
+  VELOX_CHECK(output_);
+  waitForWrite();
+  fileSize_ = writtenBytes_;
+  output_ = nullptr;
+  if (directory_) {
+    directory_->removeWriter();
+  }
+}
+
 void SpillFile::startRead() {
   constexpr uint64_t kMaxReadBufferSize =
       (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
@@ -59,23 +302,48 @@ void SpillFile::startRead() {
   VELOX_CHECK(!input_);
   auto fs = filesystems::getFileSystem(path_, nullptr);
   auto file = fs->openFileForRead(path_);
-  auto buffer = AlignedBuffer::allocate<char>(
-      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+  auto bufferSize = std::min<uint64_t>(fileSize_, kMaxReadBufferSize);
+  auto buffer = AlignedBuffer::allocate<char>(bufferSize, &pool_);
+  // With an executor, the next range is read while the current one is
+  // consumed, for example by a merge of many spill files.
+  BufferPtr prefetchBuffer = executor_
+      ? AlignedBuffer::allocate<char>(bufferSize, &pool_)
+      : nullptr;
+  input_ = std::make_unique<SpillInput>(
+      std::move(file),
+      std::move(buffer),
+      codec_.get(),
+      std::move(prefetchBuffer),
+      executor_);
   nextBatch();
 }
 
+RowVectorPtr SpillFile::readBatch() {
+  VELOX_CHECK(input_, "startRead() must be called before readBatch()");
+  if (index_ >= size_) {
+    return nullptr;
+  }
+  auto batch = std::move(rowVector_);
+  nextBatch();
+  return batch;
+}
+
 void SpillFile::nextBatch() {
   index_ = 0;
-  if (input_->atEnd()) {
+  if (!input_->atEnd()) {
+    VectorStreamGroup::read(input_.get(), &pool_, type_, &rowVector_);
+    size_ = rowVector_->size();
+  } else {
     size_ = 0;
-    return;
   }
-  VectorStreamGroup::read(input_.get(), &pool_, type_, &rowVector_);
-  size_ = rowVector_->size();
+  if (directory_ && ioStats_) {
+    auto readBytes = input_->readBytes();
+    ioStats_->addReadBytes(directory_->path(), readBytes - reportedReadBytes_);
+    reportedReadBytes_ = readBytes;
+  }
 }
 
-WriteFile& SpillFileList::currentOutput() {
+SpillFile& SpillFileList::currentFile() {
   if (files_.empty() || !files_.back()->isWritable() ||
       files_.back()->size() > targetFileSize_ * 1.5) {
     if (!files_.empty() && files_.back()->isWritable()) {
@@ -84,10 +352,18 @@ WriteFile& SpillFileList::currentOutput() {
     files_.push_back(std::make_unique<SpillFile>(
         type_,
         numSortingKeys_,
+        sortCompareFlags_,
         fmt::format("{}-{}", path_, files_.size()),
-        pool_));
+        pool_,
+        compression_,
+        executor_,
+        directories_.empty()
+            ? nullptr
+            : SpillDirectory::pick(directories_, targetFileSize_),
+        ioStats_));
+    files_.back()->output();
   }
-  return files_.back()->output();
+  return *files_.back();
 }
 
 void SpillFileList::flush() {
@@ -97,11 +373,15 @@ void SpillFileList::flush() {
     batch_->flush(&out);
     batch_.reset();
     auto iobuf = out.getIOBuf();
-    auto& file = currentOutput();
-    for (auto& range : *iobuf) {
-      file.append(std::string_view(
-          reinterpret_cast<const char*>(range.data()), range.size()));
+    if (codec_) {
+      int32_t sizes[2];
+      sizes[0] = iobuf->computeChainDataLength();
+      auto compressed = codec_->compress(iobuf.get());
+      sizes[1] = compressed->computeChainDataLength();
+      iobuf = folly::IOBuf::copyBuffer(sizes, kBlockHeaderSize);
+      iobuf->prependChain(std::move(compressed));
     }
+    currentFile().write(std::move(iobuf));
   }
 }
 
@@ -145,19 +425,41 @@ void SpillState::setNumPartitions(int32_t numPartitions) {
 void SpillState::appendToPartition(
     int32_t partition,
     const RowVectorPtr& rows) {
+  IndexRange range{0, rows->size()};
+  appendToPartition(partition, rows, folly::Range<IndexRange*>(&range, 1));
+}
+
+void SpillState::appendToPartition(
+    int32_t partition,
+    const RowVectorPtr& rows,
+    const folly::Range<IndexRange*>& indices) {
   // Ensure that partition exist before writing.
   if (!files_.at(partition)) {
     files_[partition] = std::make_unique<SpillFileList>(
         std::static_pointer_cast<const RowType>(rows->type()),
         numSortingKeys_,
+        sortCompareFlags_,
         fmt::format("{}-spill-{}", path_, partition),
         targetFileSize_,
         pool_,
-        mappedMemory_);
+        mappedMemory_,
+        compression_,
+        executor_,
+        directories_,
+        ioStats_);
   }
 
-  IndexRange range{0, rows->size()};
-  files_[partition]->write(rows, folly::Range<IndexRange*>(&range, 1));
+  files_[partition]->write(rows, indices);
+}
+
+std::vector<std::unique_ptr<SpillFile>> SpillState::takeFiles(
+    int32_t partition) {
+  VELOX_CHECK(
+      hasFiles(partition), "No spill files for partition {}", partition);
+  auto list = std::move(files_[partition]);
+  // The bytes are taken before files() moves the files out of 'list'.
+  takenBytes_[partition] += list->spilledBytes();
+  return list->files();
 }
 
 std::unique_ptr<TreeOfLosers<SpillStream>> SpillState::startMerge(
@@ -166,6 +468,7 @@ std::unique_ptr<TreeOfLosers<SpillStream>> SpillState::startMerge(
   VELOX_CHECK_LT(partition, files_.size());
   std::vector<std::unique_ptr<SpillStream>> result;
   if (auto list = std::move(files_[partition]); list) {
+    takenBytes_[partition] += list->spilledBytes();
     for (auto& file : list->files()) {
       file->startRead();
       result.push_back(std::move(file));
@@ -177,12 +480,16 @@ std::unique_ptr<TreeOfLosers<SpillStream>> SpillState::startMerge(
   return std::make_unique<TreeOfLosers<SpillStream>>(std::move(result));
 }
 
+int64_t SpillState::spilledBytes(int32_t partition) const {
+  VELOX_CHECK_LT(partition, files_.size());
+  return takenBytes_[partition] +
+      (files_[partition] ? files_[partition]->spilledBytes() : 0);
+}
+
 int64_t SpillState::spilledBytes() const {
   int64_t bytes = 0;
-  for (auto& list : files_) {
-    if (list) {
-      bytes += list->spilledBytes();
-    }
+  for (auto partition = 0; partition < files_.size(); ++partition) {
+    bytes += spilledBytes(partition);
   }
   return bytes;
 }
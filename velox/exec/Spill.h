@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+#include <folly/compression/Compression.h>
+
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/file/File.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/vector/ComplexVector.h"
@@ -24,38 +28,187 @@
 
 namespace facebook::velox::exec {
 
+// Returns the codec for compressing spill files given its name in
+// QueryConfig, one of "none", "lz4" or "zstd".
+folly::io::CodecType spillCodecType(const std::string& name);
+
+// Bytes written to and read from the spill files in one spill directory.
+struct SpillDirectoryStats {
+  uint64_t writtenBytes{0};
+  uint64_t readBytes{0};
+
+  void add(const SpillDirectoryStats& other) {
+    writtenBytes += other.writtenBytes;
+    readBytes += other.readBytes;
+  }
+};
+
+// Spill IO of one SpillState per spill directory. Shared with the
+// SpillFiles of the state, which may outlive it and may be read on other
+// threads.
+class SpillIoStats {
+ public:
+  void addWrittenBytes(const std::string& directory, uint64_t bytes) {
+    std::lock_guard<std::mutex> l(mutex_);
+    stats_[directory].writtenBytes += bytes;
+  }
+
+  void addReadBytes(const std::string& directory, uint64_t bytes) {
+    std::lock_guard<std::mutex> l(mutex_);
+    stats_[directory].readBytes += bytes;
+  }
+
+  std::unordered_map<std::string, SpillDirectoryStats> stats() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return stats_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, SpillDirectoryStats> stats_;
+};
+
+// A local directory for spill files. There is one instance per path for
+// the process so that the spill files of all queries are striped over the
+// directories by their current load.
+class SpillDirectory {
+ public:
+  SpillDirectory(std::string path, uint64_t capacity)
+      : path_(std::move(path)), capacity_(capacity) {}
+
+  // Returns the directories in 'spillPath', a comma separated list of
+  // directories. Each may be followed by ':' and its capacity in bytes. A
+  // directory without a capacity is not limited. The capacity of a path is
+  // set by the first call that lists it.
+  static std::vector<SpillDirectory*> parse(const std::string& spillPath);
+
+  // Returns the directory with the fewest files being written among
+  // 'directories' that have at least 'bytes' free, the one with the most
+  // free space and then the fewest used bytes on ties. If none has 'bytes'
+  // free, returns the one with the most free space.
+  static SpillDirectory* pick(
+      const std::vector<SpillDirectory*>& directories,
+      uint64_t bytes);
+
+  const std::string& path() const {
+    return path_;
+  }
+
+  // Returns the bytes in live spill files.
+  int64_t usedBytes() const {
+    return usedBytes_;
+  }
+
+  // Returns the capacity minus the bytes in live spill files.
+  int64_t freeBytes() const {
+    if (capacity_ == 0) {
+      return std::numeric_limits<int64_t>::max();
+    }
+    return static_cast<int64_t>(capacity_) - usedBytes_;
+  }
+
+  // Number of spill files being written. Stands for the depth of the write
+  // queue of the disk.
+  int32_t numWriters() const {
+    return numWriters_;
+  }
+
+  void addWriter() {
+    ++numWriters_;
+  }
+
+  void removeWriter() {
+    --numWriters_;
+  }
+
+  // Adds 'bytes' to the live spill files. Negative when files are deleted.
+  void addUsedBytes(int64_t bytes) {
+    usedBytes_ += bytes;
+  }
+
+ private:
+  const std::string path_;
+  // Byte capacity. 0 if not limited.
+  const uint64_t capacity_;
+  std::atomic<int64_t> usedBytes_{0};
+  std::atomic<int32_t> numWriters_{0};
+};
+
 // Input stream backed by spill file.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
+  // Reads from 'input' using 'buffer' for buffering reads. If 'codec' is
+  // set, the file consists of blocks compressed with it, each preceded by
+  // its uncompressed and compressed sizes. If 'executor' is set, the next
+  // read goes to 'prefetchBuffer' on 'executor' while 'buffer' is consumed.
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      folly::io::Codec* codec = nullptr,
+      BufferPtr prefetchBuffer = nullptr,
+      folly::Executor* executor = nullptr)
       : input_(std::move(input)),
         buffer_(std::move(buffer)),
+        prefetchBuffer_(std::move(prefetchBuffer)),
+        codec_(codec),
+        executor_(executor),
         size_(input_->size()) {
+    VELOX_CHECK(!executor_ || prefetchBuffer_);
     next(true);
   }
 
+  ~SpillInput() override;
+
   void next(bool throwIfPastEnd) override;
 
+  // Returns the bytes read from the file so far, including read-ahead.
+  uint64_t readBytes() const {
+    return offset_;
+  }
+
   // True if all of the file has been read into vectors.
   bool atEnd() const {
-    return offset_ >= size_ && ranges()[0].position >= ranges()[0].size;
+    return !prefetch_ && offset_ >= size_ &&
+        ranges()[0].position >= ranges()[0].size;
   }
 
  private:
+  // Reads the next range of the file into 'buffer', decompressing it if
+  // the file is compressed. Returns the number of bytes in 'buffer'.
+  int32_t load(BufferPtr& buffer);
+
+  // Starts loading the next range into 'prefetchBuffer_' on 'executor_'.
+  void startPrefetch();
+
   std::unique_ptr<ReadFile> input_;
   BufferPtr buffer_;
+  BufferPtr prefetchBuffer_;
+  folly::io::Codec* const codec_;
+  folly::Executor* const executor_;
   const uint64_t size_;
-  // Offset of first byte not in 'buffer_'
-  uint64_t offset_ = 0;
+  // Offset of first byte not in 'buffer_' or 'prefetchBuffer_'. Advanced by
+  // read-ahead on 'executor_'.
+  std::atomic<uint64_t> offset_{0};
+  // Read in progress into 'prefetchBuffer_'. Produces the number of bytes
+  // read. An error is kept in 'prefetchError_'.
+  std::shared_ptr<AsyncSource<int32_t>> prefetch_;
+  std::exception_ptr prefetchError_;
 };
 
 // A source of spilled RowVectors coming either from a file or memory.
 class SpillStream : public MergeStream {
  public:
-  SpillStream(RowTypePtr type, int32_t numSortingKeys, memory::MemoryPool& pool)
+  // 'sortCompareFlags' gives the sort order of each of the
+  // 'numSortingKeys' leading columns. If empty, all keys are sorted
+  // ascending with nulls first.
+  SpillStream(
+      RowTypePtr type,
+      int32_t numSortingKeys,
+      const std::vector<CompareFlags>& sortCompareFlags,
+      memory::MemoryPool& pool)
       : type_(std::move(type)),
         numSortingKeys_(numSortingKeys),
+        sortCompareFlags_(sortCompareFlags),
         pool_(pool),
         ordinal_(++ordinalCounter_) {}
 
@@ -75,8 +228,14 @@ class SpillStream : public MergeStream {
     auto& otherChildren = otherStream.current().children();
     int32_t key = 0;
     do {
-      auto result = children[key]->compare(
-          otherChildren[key].get(), index_, otherStream.index_);
+      auto result = children[key]
+                        ->compare(
+                            otherChildren[key].get(),
+                            index_,
+                            otherStream.index_,
+                            sortCompareFlags_.empty() ? CompareFlags()
+                                                      : sortCompareFlags_[key])
+                        .value();
       if (result) {
         return result;
       }
@@ -147,6 +306,10 @@ class SpillStream : public MergeStream {
   // 0 if not sorted.
   const int32_t numSortingKeys_;
 
+  // Sort order of each sorting key. Empty if all keys are ascending with
+  // nulls first.
+  const std::vector<CompareFlags> sortCompareFlags_;
+
   memory::MemoryPool& pool_;
 
   // Current batch of rows.
@@ -179,30 +342,48 @@ class SpillFile : public SpillStream {
   SpillFile(
       RowTypePtr type,
       int32_t numSortingKeys,
+      const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
-      memory::MemoryPool& pool)
-      : SpillStream(std::move(type), numSortingKeys, pool),
-        path_(fmt::format("{}-{}", path, ordinalCounter_++)) {}
+      memory::MemoryPool& pool,
+      folly::io::CodecType compression = folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* executor = nullptr,
+      SpillDirectory* directory = nullptr,
+      std::shared_ptr<SpillIoStats> ioStats = nullptr)
+      : SpillStream(std::move(type), numSortingKeys, sortCompareFlags, pool),
+        path_(fmt::format(
+            "{}{}-{}",
+            directory ? directory->path() + "/" : "",
+            path,
+            ordinalCounter_++)),
+        codec_(
+            compression == folly::io::CodecType::NO_COMPRESSION
+                ? nullptr
+                : folly::io::getCodec(compression)),
+        executor_(executor),
+        directory_(directory),
+        ioStats_(std::move(ioStats)) {}
 
   ~SpillFile() override;
 
   // Returns a file for writing spilled data. The caller constructs
   // this, then calls output() and writes serialized data to the file
-  // and calls finishWrite when the file has reached its final
+  // with write() and calls finishWrite when the file has reached its final
   // size. For sorted spilling, the data in one file is expected to be
   // sorted.
   WriteFile& output();
 
+  // Appends 'data' to the file. 'data' is compressed by the caller if
+  // 'this' is compressed. If 'executor_' is set, the append is made on it
+  // and this waits only for the previous append, so that the caller can
+  // produce the next 'data' while one write is in flight.
+  void write(std::unique_ptr<folly::IOBuf> data);
+
   bool isWritable() const {
     return output_ != nullptr;
   }
 
   // Finishes writing and flushes any unwritten data.
-  void finishWrite() {
-    VELOX_CHECK(output_);
-    fileSize_ = output_->size();
-    output_ = nullptr;
-  }
+  void finishWrite();
 
   // Prepares 'this' for reading. Positions the read at the first row of
   // content. The caller must call output() and finishWrite() before this.
@@ -213,7 +394,7 @@ class SpillFile : public SpillStream {
   // size.
   uint64_t size() const override {
     if (output_) {
-      return output_->size();
+      return writtenBytes_;
     }
     return fileSize_;
   }
@@ -221,12 +402,41 @@ class SpillFile : public SpillStream {
   // Sets 'result' to refer to the next row of content of 'this'.
   void read(RowVector& result);
 
+  // Returns the next batch of content of 'this' or nullptr at end. Used for
+  // reading spilled data a batch at a time instead of row by row as in a
+  // merge. startRead() must be called first.
+  RowVectorPtr readBatch();
+
  private:
   void nextBatch() override;
 
+  // The outcome of an append on 'executor_'.
+  struct WriteResult {
+    std::exception_ptr error;
+    uint64_t wallMicros{0};
+  };
+
+  // Waits for the append in flight, if any, and rethrows its error.
+  void waitForWrite();
+
   const std::string path_;
+  // Decompresses the blocks of the file. nullptr if not compressed.
+  const std::unique_ptr<folly::io::Codec> codec_;
+  // Executor for writes and read-ahead. Writes and reads are synchronous
+  // if nullptr.
+  folly::Executor* const executor_;
+  // The directory of the file. nullptr if 'path_' is not in a
+  // SpillDirectory.
+  SpillDirectory* const directory_;
+  // Receives the written and read bytes if set.
+  const std::shared_ptr<SpillIoStats> ioStats_;
+  // Bytes read reported to 'ioStats_'.
+  uint64_t reportedReadBytes_ = 0;
   // Byte size of the backing file. Set when finishing writing.
   uint64_t fileSize_ = 0;
+  // Bytes passed to write(), including an append in flight.
+  uint64_t writtenBytes_ = 0;
+  std::shared_ptr<AsyncSource<WriteResult>> pendingWrite_;
   std::unique_ptr<WriteFile> output_;
   std::unique_ptr<SpillInput> input_;
 };
@@ -238,26 +448,46 @@ class SpillFileList {
  public:
   // Constructs a set of spill files. 'type' is a RowType describing the
   // content. 'numSortingKeys' is the number of leading columns on which the
-  // data is sorted. 'path' is a file path prefix. ' 'targetFileSize' is the
-  // target byte size of a single file in the file set. 'pool' and
+  // data is sorted and 'sortCompareFlags' their sort orders, empty for
+  // ascending with nulls first. 'path' is a file path prefix. '
+  // 'targetFileSize' is the target byte size of a single file in the file
+  // set. 'pool' and
   // 'mappedMemory' are used for buffering and constructing the result data read
-  // from 'this'.
+  // from 'this'. 'compression' is the codec for the blocks of the files.
+  // If 'executor' is set, file writes and read-ahead are done on it. If
+  // 'directories' is not empty, 'path' is relative to them and each new
+  // file goes to the least loaded of them. The written and read bytes go to
+  // 'ioStats' if set.
   //
   // When writing sorted spill runs, the caller is responsible for buffering and
   // sorting the data. write is called multiple times, followed by flush().
   SpillFileList(
       RowTypePtr type,
       int32_t numSortingKeys,
+      const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
       uint64_t targetFileSize,
       memory::MemoryPool& pool,
-      memory::MappedMemory& mappedMemory)
+      memory::MappedMemory& mappedMemory,
+      folly::io::CodecType compression = folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* executor = nullptr,
+      const std::vector<SpillDirectory*>& directories = {},
+      std::shared_ptr<SpillIoStats> ioStats = nullptr)
       : type_(type),
         numSortingKeys_(numSortingKeys),
+        sortCompareFlags_(sortCompareFlags),
         path_(path),
         targetFileSize_(targetFileSize),
         pool_(pool),
-        mappedMemory_(mappedMemory) {}
+        mappedMemory_(mappedMemory),
+        compression_(compression),
+        codec_(
+            compression == folly::io::CodecType::NO_COMPRESSION
+                ? nullptr
+                : folly::io::getCodec(compression)),
+        executor_(executor),
+        directories_(directories),
+        ioStats_(std::move(ioStats)) {}
 
   // Adds 'rows' for the positions in 'indices' into 'this'. The indices
   // must produce a view where the rows are sorted if sorting is desired.
@@ -279,17 +509,28 @@ class SpillFileList {
 
   int64_t spilledBytes() const;
 
+  int32_t numFiles() const {
+    return files_.size();
+  }
+
  private:
   // Returns the current file to write to and creates one if needed.
-  WriteFile& currentOutput();
+  SpillFile& currentFile();
   // Writes data from 'batch_' to the current output file.
   void flush();
   const RowTypePtr type_;
   const int32_t numSortingKeys_;
+  const std::vector<CompareFlags> sortCompareFlags_;
   const std::string path_;
   const uint64_t targetFileSize_;
   memory::MemoryPool& pool_;
   memory::MappedMemory& mappedMemory_;
+  const folly::io::CodecType compression_;
+  // Compresses the serialized batches. nullptr if not compressing.
+  const std::unique_ptr<folly::io::Codec> codec_;
+  folly::Executor* const executor_;
+  const std::vector<SpillDirectory*> directories_;
+  const std::shared_ptr<SpillIoStats> ioStats_;
   std::unique_ptr<VectorStreamGroup> batch_;
   std::vector<std::unique_ptr<SpillFile>> files_;
 };
@@ -305,21 +546,35 @@ class SpillState {
   // on which the data is sorted, 0 if only hash partitioning is used.
   // 'targetFileSize' is the target size of a single
   // file.  'pool' and 'mappedMemory' own
-  // the memory for state and results.
+  // the memory for state and results. 'sortCompareFlags' gives the sort
+  // order of each sorting key. If empty, all keys are ascending with nulls
+  // first. 'compression', 'executor' and 'directories' are passed to the
+  // SpillFileLists. If 'directories' is not empty, 'path' is relative to
+  // them.
   SpillState(
       const std::string& path,
       int32_t maxPartitions,
       int32_t numSortingKeys,
       uint64_t targetFileSize,
       memory::MemoryPool& pool,
-      memory::MappedMemory& mappedMemory)
+      memory::MappedMemory& mappedMemory,
+      const std::vector<CompareFlags>& sortCompareFlags = {},
+      folly::io::CodecType compression = folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* executor = nullptr,
+      const std::vector<SpillDirectory*>& directories = {})
       : path_(path),
         maxPartitions_(maxPartitions),
         numSortingKeys_(numSortingKeys),
+        sortCompareFlags_(sortCompareFlags),
         targetFileSize_(targetFileSize),
         files_(maxPartitions_),
         pool_(pool),
-        mappedMemory_(mappedMemory) {}
+        mappedMemory_(mappedMemory),
+        compression_(compression),
+        executor_(executor),
+        directories_(directories),
+        ioStats_(std::make_shared<SpillIoStats>()),
+        takenBytes_(maxPartitions_) {}
 
   int32_t numPartitions() const {
     return numPartitions_;
@@ -347,6 +602,12 @@ class SpillState {
   // different partition.
   void appendToPartition(int32_t partition, const RowVectorPtr& rows);
 
+  // Appends the rows of 'rows' given by 'indices' to 'partition'.
+  void appendToPartition(
+      int32_t partition,
+      const RowVectorPtr& rows,
+      const folly::Range<IndexRange*>& indices);
+
   // Finishes a sorted run for 'partition'. If write is called for 'partition'
   // again, the data does not have to be sorted relative to the data
   // written so far.
@@ -365,13 +626,35 @@ class SpillState {
     return partition < files_.size() && files_[partition];
   }
 
+  // Finishes writing 'partition' and returns its files. The caller becomes
+  // responsible for the files and 'partition' has no files after this.
+  std::vector<std::unique_ptr<SpillFile>> takeFiles(int32_t partition);
+
+  // Returns the number of files of 'partition' that have not been taken or
+  // merged.
+  int32_t numFiles(int32_t partition) const {
+    return hasFiles(partition) ? files_[partition]->numFiles() : 0;
+  }
+
+  // Returns the bytes spilled to 'partition', including files that have
+  // been taken or merged.
+  int64_t spilledBytes(int32_t partition) const;
+
   int64_t spilledBytes() const;
 
+  // Returns the bytes written and read per spill directory by the files of
+  // 'this', including files taken by takeFiles().
+  std::unordered_map<std::string, SpillDirectoryStats> directoryStats()
+      const {
+    return ioStats_->stats();
+  }
+
  private:
   const RowTypePtr type_;
   const std::string path_;
   const int32_t maxPartitions_;
   const int32_t numSortingKeys_;
+  const std::vector<CompareFlags> sortCompareFlags_;
   // Number of currently spilling partitions.
   int32_t numPartitions_ = 0;
   const uint64_t targetFileSize_;
@@ -380,6 +663,13 @@ class SpillState {
   std::vector<std::unique_ptr<SpillFileList>> files_;
   memory::MemoryPool& pool_;
   memory::MappedMemory& mappedMemory_;
+  const folly::io::CodecType compression_;
+  folly::Executor* const executor_;
+  const std::vector<SpillDirectory*> directories_;
+  const std::shared_ptr<SpillIoStats> ioStats_;
+  // Bytes in the files given out by takeFiles() or startMerge() for each
+  // partition.
+  std::vector<int64_t> takenBytes_;
 };
 
 } // namespace facebook::velox::exec
@@ -17,6 +17,8 @@
 #include "velox/exec/Spiller.h"
 
 #include "velox/common/base/AsyncSource.h"
+#include "velox/common/process/EventTrace.h"
+#include "velox/exec/PrefixSort.h"
 
 #include <folly/ScopeGuard.h>
 
@@ -79,10 +81,11 @@ class RowContainerSpillStream : public SpillStream {
   RowContainerSpillStream(
       RowTypePtr type,
       int32_t numSortingKeys,
+      const std::vector<CompareFlags>& sortCompareFlags,
       memory::MemoryPool& pool,
       Spiller::SpillRows&& rows,
       Spiller& spiller)
-      : SpillStream(std::move(type), numSortingKeys, pool),
+      : SpillStream(std::move(type), numSortingKeys, sortCompareFlags, pool),
         rows_(std::move(rows)),
         spiller_(spiller) {
     if (!rows_.empty()) {
@@ -126,19 +129,18 @@ std::unique_ptr<SpillStream> Spiller::spillStreamOverRows(int32_t partition) {
   return std::make_unique<RowContainerSpillStream>(
       rowType_,
       container_.keyTypes().size(),
+      sortCompareFlags_,
       pool_,
       std::move(spillRuns_[partition].rows),
       *this);
 }
 
 void Spiller::ensureSorted(SpillRun& run) {
-  if (!run.sorted) {
-    std::sort(
-        run.rows.begin(),
-        run.rows.end(),
-        [&](const char* left, const char* right) {
-          return container_.compareRows(left, right) < 0;
-        });
+  if (!run.sorted && numSortingKeys_ > 0) {
+    PrefixSort::sort(
+        container_,
+        PrefixSort::leadingColumns(numSortingKeys_, sortCompareFlags_),
+        folly::Range<char**>(run.rows.data(), run.rows.size()));
     run.sorted = true;
   }
 }
@@ -232,6 +234,7 @@ void Spiller::spill(
     uint64_t targetRows,
     uint64_t targetBytes,
     RowContainerIterator& iterator) {
+  process::TraceSpan span("spill", {"spill"});
   bool doneFullSweep = false;
   bool startedFullSweep = false;
   VELOX_CHECK(!spillFinalized_);
@@ -290,6 +293,175 @@ Spiller::SpillRows Spiller::finishSpill() {
   return rowsFromNonSpillingPartitions;
 }
 
+void Spiller::finishSpill(const std::vector<int32_t>& partitions) {
+  VELOX_CHECK(!spillFinalized_);
+  spillFinalized_ = true;
+  for (auto newPartition = spillRuns_.size();
+       newPartition < state_.maxPartitions();
+       ++newPartition) {
+    spillRuns_.emplace_back(spillMappedMemory());
+  }
+  if (state_.numPartitions() < state_.maxPartitions()) {
+    state_.setNumPartitions(state_.maxPartitions());
+  }
+  clearSpillRuns();
+  RowContainerIterator iterator;
+  // Makes runs of all rows and marks the non-empty ones for spilling.
+  fillSpillRuns(iterator, RowContainer::kUnlimited);
+  for (auto partition = 0; partition < spillRuns_.size(); ++partition) {
+    if (std::find(partitions.begin(), partitions.end(), partition) ==
+        partitions.end()) {
+      pendingSpillPartitions_.erase(partition);
+      spillRuns_[partition].clear();
+    }
+  }
+  advanceSpill(std::numeric_limits<uint64_t>::max());
+  VELOX_CHECK(pendingSpillPartitions_.empty());
+}
+
+std::vector<int64_t> Spiller::spilledPartitionBytes() const {
+  std::vector<int64_t> bytes(state_.maxPartitions());
+  for (auto partition = 0; partition < bytes.size(); ++partition) {
+    bytes[partition] = state_.spilledBytes(partition);
+  }
+  return bytes;
+}
+
+// static
+int32_t Spiller::numPartitionBits(
+    int64_t estimatedBytes,
+    int64_t availableBytes,
+    int32_t minBits,
+    int32_t maxBits) {
+  auto bytesToSpill = std::max<int64_t>(1, estimatedBytes - availableBytes);
+  auto numBits = minBits;
+  while (numBits < maxBits && (bytesToSpill << numBits) < estimatedBytes) {
+    ++numBits;
+  }
+  return numBits;
+}
+
+namespace {
+// Number of hash bits added for each level of repartitioning.
+constexpr int32_t kRepartitionBits = 2;
+} // namespace
+
+std::unique_ptr<TreeOfLosers<SpillStream>> Spiller::nextMerge(
+    int32_t maxMergeFanIn) {
+  VELOX_CHECK(spillFinalized_);
+  VELOX_CHECK_GT(numSortingKeys_, 0, "Only sorted spills can be merged");
+  VELOX_CHECK_GE(maxMergeFanIn, 2);
+  for (;;) {
+    if (pendingMerges_.empty()) {
+      if (nextMergePartition_ >= state_.maxPartitions()) {
+        return nullptr;
+      }
+      pendingMerges_.push_back({&state_, nextMergePartition_++, bits_.end()});
+    }
+    auto pending = pendingMerges_.back();
+    pendingMerges_.pop_back();
+    auto numStreams = pending.state->numFiles(pending.partition);
+    std::unique_ptr<SpillStream> rows;
+    if (pending.state == &state_) {
+      numStreams += !spillRuns_[pending.partition].rows.empty();
+      rows = spillStreamOverRows(pending.partition);
+    }
+    if (numStreams <= maxMergeFanIn ||
+        pending.nextBitOffset + kRepartitionBits > 64) {
+      return pending.state->startMerge(pending.partition, std::move(rows));
+    }
+    repartition(pending, std::move(rows), maxMergeFanIn);
+  }
+}
+
+void Spiller::repartition(
+    const PendingMerge& pending,
+    std::unique_ptr<SpillStream> rows,
+    int32_t maxMergeFanIn) {
+  // Number of rows copied to a sub-partition before writing them out.
+  constexpr vector_size_t kBatchRows = 1024;
+  ++numRepartitions_;
+  const HashBitRange partitionBits(
+      pending.nextBitOffset, pending.nextBitOffset + kRepartitionBits);
+  const auto numPartitions = partitionBits.numPartitions();
+  auto state = std::make_unique<SpillState>(
+      fmt::format("{}-repartition-{}", path_, repartitionStates_.size()),
+      numPartitions,
+      numSortingKeys_,
+      state_.targetFileSize(),
+      pool_,
+      spillMappedMemory(),
+      sortCompareFlags_,
+      compression_,
+      executor_,
+      directories_);
+  std::vector<std::unique_ptr<SpillFile>> files;
+  if (pending.state->hasFiles(pending.partition)) {
+    files = pending.state->takeFiles(pending.partition);
+  }
+
+  std::vector<RowVectorPtr> batches(numPartitions);
+  std::vector<vector_size_t> batchSizes(numPartitions, 0);
+  auto flush = [&](int32_t partition) {
+    batches[partition]->resize(batchSizes[partition]);
+    state->appendToPartition(partition, batches[partition]);
+    batches[partition] = nullptr;
+    batchSizes[partition] = 0;
+  };
+
+  size_t nextFile = 0;
+  while (rows || nextFile < files.size()) {
+    std::vector<std::unique_ptr<SpillStream>> streams;
+    if (rows) {
+      streams.push_back(std::move(rows));
+    }
+    while (streams.size() < maxMergeFanIn && nextFile < files.size()) {
+      files[nextFile]->startRead();
+      streams.push_back(std::move(files[nextFile++]));
+    }
+    TreeOfLosers<SpillStream> merge(std::move(streams));
+    while (auto stream = merge.next()) {
+      const auto& current = stream->current();
+      const auto index = stream->currentIndex();
+      uint64_t hash = 0;
+      for (auto i = 0; i < numSortingKeys_; ++i) {
+        auto keyHash = current.childAt(i)->hashValueAt(index);
+        hash = i == 0 ? keyHash : bits::hashMix(hash, keyHash);
+      }
+      auto partition = partitionBits.partition(hash, numPartitions);
+      auto& batch = batches[partition];
+      if (!batch) {
+        batch = BaseVector::create<RowVector>(rowType_, kBatchRows, &pool_);
+      }
+      for (auto i = 0; i < current.childrenSize(); ++i) {
+        batch->childAt(i)->copy(
+            current.childAt(i).get(), batchSizes[partition], index, 1);
+      }
+      if (++batchSizes[partition] == kBatchRows) {
+        flush(partition);
+      }
+      stream->pop();
+    }
+    // Each group of streams makes one sorted run in each sub-partition.
+    for (auto partition = 0; partition < numPartitions; ++partition) {
+      if (batches[partition]) {
+        flush(partition);
+      }
+      if (state->hasFiles(partition)) {
+        state->finishWrite(partition);
+      }
+    }
+  }
+
+  // The first sub-partition is merged first.
+  for (auto partition = numPartitions - 1; partition >= 0; --partition) {
+    if (state->hasFiles(partition)) {
+      pendingMerges_.push_back({state.get(), partition, partitionBits.end()});
+    }
+  }
+  repartitionStates_.push_back(std::move(state));
+}
+
 void Spiller::clearSpillRuns() {
   for (auto& run : spillRuns_) {
     run.clear();
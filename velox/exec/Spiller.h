@@ -35,6 +35,14 @@ class HashBitRange {
     return 1 << (end_ - begin_);
   }
 
+  uint8_t begin() const {
+    return begin_;
+  }
+
+  uint8_t end() const {
+    return end_;
+  }
+
  private:
   // Low bit number of hash number bit range.
   const uint8_t begin_;
@@ -48,6 +56,13 @@ class HashBitRange {
 class Spiller {
  public:
   using SpillRows = std::vector<char*, memory::StlMappedMemoryAllocator<char*>>;
+  // 'sortCompareFlags' gives the sort order of the keys of 'container' in a
+  // sorted spill. If empty, the keys are sorted ascending with nulls first.
+  // 'compression' is the codec for the spill files. If 'executor' is set, the
+  // spill partitions are written in parallel on it and the file writes and
+  // read-ahead of the spill files are done on it. If 'directories' is
+  // non-empty, 'path' is relative and the spill files are striped over
+  // 'directories'.
   Spiller(
       RowContainer& container,
       RowContainer::Eraser eraser,
@@ -57,20 +72,32 @@ class Spiller {
       const std::string& path,
       int64_t targetFileSize,
       memory::MemoryPool& pool,
-      folly::Executor* executor)
+      folly::Executor* executor,
+      const std::vector<CompareFlags>& sortCompareFlags = {},
+      folly::io::CodecType compression = folly::io::CodecType::NO_COMPRESSION,
+      const std::vector<SpillDirectory*>& directories = {})
       : container_(container),
         eraser_(eraser),
         rowType_(std::move(rowType)),
         bits_(bits),
+        numSortingKeys_(numSortingKeys),
+        sortCompareFlags_(sortCompareFlags),
         state_(
             path,
             bits.numPartitions(),
             numSortingKeys,
             targetFileSize,
             pool,
-            spillMappedMemory()),
+            spillMappedMemory(),
+            sortCompareFlags,
+            compression,
+            executor,
+            directories),
         pool_(pool),
-        executor_(executor) {}
+        executor_(executor),
+        path_(path),
+        compression_(compression),
+        directories_(directories) {}
 
   // Spills rows from 'this' until there are under 'targetRows' rows
   // and 'targetBytes' of allocated variable length space in
@@ -96,6 +123,17 @@ class Spiller {
   // started spilling.
   SpillRows finishSpill();
 
+  // Finishes spilling by writing out all rows of 'partitions' that are still
+  // in 'container_'. The rows of the other partitions stay in
+  // 'container_'. Used by hash join build, where the whole build side of a
+  // spilled partition must be on disk before probing starts.
+  void finishSpill(const std::vector<int32_t>& partitions);
+
+  // Returns the spill files of 'partition'. The caller takes ownership.
+  std::vector<std::unique_ptr<SpillFile>> takeFiles(int32_t partition) {
+    return state_.takeFiles(partition);
+  }
+
   RowContainer& container() const {
     return container_;
   }
@@ -109,11 +147,47 @@ class Spiller {
     return state_.startMerge(partition, spillStreamOverRows(partition));
   }
 
+  // Returns a merge over the next part of the spilled and unspilled rows
+  // after finishSpill(). Returns nullptr after all rows are returned. The
+  // merges cover disjoint sets of keys. A spill partition whose merge would
+  // have more than 'maxMergeFanIn' streams is first repartitioned on the
+  // next bits of the hash number after 'bits_': groups of up to
+  // 'maxMergeFanIn' streams are merged and the rows are written to
+  // sub-partitions. Each group adds one sorted run to each sub-partition.
+  // Sub-partitions that still have too many runs are repartitioned again.
+  std::unique_ptr<TreeOfLosers<SpillStream>> nextMerge(int32_t maxMergeFanIn);
+
+  // Number of partitions repartitioned by nextMerge(). For testing.
+  int32_t numRepartitions() const {
+    return numRepartitions_;
+  }
+
+  // Returns the number of hash bits for partitioning spilled data of
+  // 'estimatedBytes' when 'availableBytes' may stay in memory. This makes
+  // one partition about the size that must be spilled, so that spilling a
+  // partition frees enough memory. The result is between 'minBits' and
+  // 'maxBits'.
+  static int32_t numPartitionBits(
+      int64_t estimatedBytes,
+      int64_t availableBytes,
+      int32_t minBits,
+      int32_t maxBits);
+
   std::pair<int64_t, int64_t> spilledBytesAndRows() const {
     return std::make_pair<int64_t, int64_t>(
         state_.spilledBytes(), spilledRows_);
   }
 
+  // Returns the bytes spilled to each partition. Shows skew between
+  // partitions.
+  std::vector<int64_t> spilledPartitionBytes() const;
+
+  // Returns the bytes written to and read from each spill directory.
+  std::unordered_map<std::string, SpillDirectoryStats> spillDirectoryStats()
+      const {
+    return state_.directoryStats();
+  }
+
   // Extracts the keys, dependents or accumulators for 'rows' into '*result'.
   // Creates '*results' in spillPool() if nullptr. Used from Spiller and
   // RowContainerSpillStream.
@@ -208,10 +282,35 @@ class Spiller {
   // Writes out  and erases rows marked for spilling.
   void advanceSpill(uint64_t maxBytes);
 
+  // A spill partition waiting to be merged by nextMerge().
+  struct PendingMerge {
+    // State with the files of 'partition'. Either 'state_' or one of
+    // 'repartitionStates_'.
+    SpillState* state;
+    int32_t partition;
+    // First bit of the hash number for repartitioning 'partition'.
+    uint8_t nextBitOffset;
+  };
+
+  // Merges the streams of 'pending' and 'rows' in groups of at most
+  // 'maxMergeFanIn' and writes the rows to a new SpillState partitioned on
+  // the bits after 'pending.nextBitOffset'. Adds the partitions of the new
+  // state to 'pendingMerges_'.
+  void repartition(
+      const PendingMerge& pending,
+      std::unique_ptr<SpillStream> rows,
+      int32_t maxMergeFanIn);
+
   RowContainer& container_;
   const RowContainer::Eraser eraser_;
   RowTypePtr rowType_;
   const HashBitRange bits_;
+  // Number of leading keys on which spill runs are sorted. 0 if runs are not
+  // sorted.
+  const int32_t numSortingKeys_;
+  // Sort order of the keys of 'container_' for sorted spilling. Empty if all
+  // keys are ascending with nulls first.
+  const std::vector<CompareFlags> sortCompareFlags_;
   SpillState state_;
 
   // One spill run for each partition of spillable data.
@@ -228,6 +327,21 @@ class Spiller {
   memory::MemoryPool& pool_;
   folly::Executor* const executor_;
   uint64_t spilledRows_{0};
+  const std::string path_;
+  const folly::io::CodecType compression_;
+  const std::vector<SpillDirectory*> directories_;
+
+  // Next partition of 'state_' for nextMerge().
+  int32_t nextMergePartition_{0};
+
+  // Partitions to merge before 'nextMergePartition_'. The last is merged
+  // first.
+  std::vector<PendingMerge> pendingMerges_;
+
+  // States made by repartition().
+  std::vector<std::unique_ptr<SpillState>> repartitionStates_;
+
+  int32_t numRepartitions_{0};
 };
 
 } // namespace facebook::velox::exec
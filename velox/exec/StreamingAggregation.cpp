@@ -15,6 +15,7 @@
  */
 #include "velox/exec/StreamingAggregation.h"
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/DistinctAggregate.h"
 #include "velox/exec/RowContainer.h"
 
 namespace facebook::velox::exec {
@@ -80,6 +81,10 @@ StreamingAggregation::StreamingAggregation(
     const auto& aggResultType = outputType_->childAt(numKeys + i);
     aggregates_.push_back(Aggregate::create(
         aggregate->name(), aggregationNode->step(), argTypes, aggResultType));
+    if (aggregationNode->isDistinct(i)) {
+      aggregates_.back() =
+          createDistinctAggregate(std::move(aggregates_.back()), argTypes[0]);
+    }
     args_.push_back(channels);
     constantArgs_.push_back(constants);
   }
@@ -125,6 +130,68 @@ bool equalKeys(
 
   return true;
 }
+
+// Sets the bits in 'boundaries' for the rows in [1, size) where 'key' differs
+// from the row before.
+void findBoundariesGeneric(
+    const BaseVector& key,
+    vector_size_t size,
+    uint64_t* boundaries) {
+  for (auto i = 1; i < size; ++i) {
+    if (!key.equalValueAt(&key, i, i - 1)) {
+      bits::setBit(boundaries, i);
+    }
+  }
+}
+
+template <typename T>
+void findBoundaries(
+    const BaseVector& key,
+    const DecodedVector& decoded,
+    vector_size_t size,
+    uint64_t* boundaries) {
+  if (!decoded.isIdentityMapping() || decoded.mayHaveNulls()) {
+    findBoundariesGeneric(key, size, boundaries);
+    return;
+  }
+  // Produces a word of boundary bits at a time without branches so that the
+  // comparisons of adjacent values vectorize.
+  const auto* values = decoded.data<T>();
+  for (auto word = 0; word < bits::nwords(size); ++word) {
+    const vector_size_t begin = std::max(1, word * 64);
+    const vector_size_t end = std::min(size, (word + 1) * 64);
+    uint64_t mask = 0;
+    for (auto i = begin; i < end; ++i) {
+      mask |= static_cast<uint64_t>(!(values[i] == values[i - 1])) << (i & 63);
+    }
+    boundaries[word] |= mask;
+  }
+}
+
+void findBoundaries(
+    const BaseVector& key,
+    const DecodedVector& decoded,
+    vector_size_t size,
+    uint64_t* boundaries) {
+  if (decoded.isConstantMapping()) {
+    return;
+  }
+  switch (key.typeKind()) {
+    case TypeKind::TINYINT:
+      return findBoundaries<int8_t>(key, decoded, size, boundaries);
+    case TypeKind::SMALLINT:
+      return findBoundaries<int16_t>(key, decoded, size, boundaries);
+    case TypeKind::INTEGER:
+      return findBoundaries<int32_t>(key, decoded, size, boundaries);
+    case TypeKind::BIGINT:
+      return findBoundaries<int64_t>(key, decoded, size, boundaries);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return findBoundaries<StringView>(key, decoded, size, boundaries);
+    default:
+      return findBoundariesGeneric(key, size, boundaries);
+  }
+}
 } // namespace
 
 char* StreamingAggregation::startNewGroup(vector_size_t index) {
@@ -172,43 +239,58 @@ RowVectorPtr StreamingAggregation::createOutput(size_t numGroups) {
   return output;
 }
 
-void StreamingAggregation::assignGroups() {
+void StreamingAggregation::findGroupStarts() {
   auto numInput = input_->size();
-
-  inputGroups_.resize(numInput);
-
-  // Look for the end of the last group.
-  vector_size_t index = 0;
-  if (prevInput_) {
-    auto prevIndex = prevInput_->size() - 1;
-    auto* prevGroup = groups_[numGroups_ - 1];
-    for (; index < numInput; ++index) {
-      if (equalKeys(groupingKeys_, prevInput_, prevIndex, input_, index)) {
-        inputGroups_[index] = prevGroup;
-      } else {
-        break;
-      }
-    }
+  boundaries_.assign(bits::nwords(numInput), 0);
+  for (auto i = 0; i < groupingKeys_.size(); ++i) {
+    findBoundaries(
+        *input_->childAt(groupingKeys_[i]),
+        decodedKeys_[i],
+        numInput,
+        boundaries_.data());
   }
 
-  if (index < numInput) {
-    for (auto i = 0; i < groupingKeys_.size(); ++i) {
-      decodedKeys_[i].decode(*input_->childAt(groupingKeys_[i]), inputRows_);
-    }
+  groupStarts_.clear();
+  groupStarts_.push_back(0);
+  bits::forEachSetBit(boundaries_.data(), 1, numInput, [&](auto row) {
+    groupStarts_.push_back(row);
+  });
+}
 
-    auto* newGroup = startNewGroup(index);
-    inputGroups_[index] = newGroup;
+void StreamingAggregation::assignGroups() {
+  auto numInput = input_->size();
 
-    for (auto i = index + 1; i < numInput; ++i) {
-      if (equalKeys(groupingKeys_, input_, index, input_, i)) {
-        inputGroups_[i] = inputGroups_[index];
-      } else {
-        newGroup = startNewGroup(i);
-        inputGroups_[i] = newGroup;
-        index = i;
-      }
+  for (auto i = 0; i < groupingKeys_.size(); ++i) {
+    decodedKeys_[i].decode(*input_->childAt(groupingKeys_[i]), inputRows_);
+  }
+  findGroupStarts();
+
+  // The first run continues the last group if its keys are equal to the
+  // last row of the previous input.
+  auto numRuns = groupStarts_.size();
+  runGroups_.resize(numRuns);
+  for (auto run = 0; run < numRuns; ++run) {
+    if (run == 0 && prevInput_ &&
+        equalKeys(
+            groupingKeys_, prevInput_, prevInput_->size() - 1, input_, 0)) {
+      runGroups_[run] = groups_[numGroups_ - 1];
+    } else {
+      runGroups_[run] = startNewGroup(groupStarts_[run]);
     }
   }
+
+  aggregateRuns_ = numInput >= numRuns * kMinAverageRunLength;
+  if (aggregateRuns_) {
+    return;
+  }
+  inputGroups_.resize(numInput);
+  for (auto run = 0; run < numRuns; ++run) {
+    auto end = run + 1 < numRuns ? groupStarts_[run + 1] : numInput;
+    std::fill(
+        inputGroups_.begin() + groupStarts_[run],
+        inputGroups_.begin() + end,
+        runGroups_[run]);
+  }
 }
 
 const SelectivityVector& StreamingAggregation::getSelectivityVector(
@@ -232,6 +314,11 @@ void StreamingAggregation::evaluateAggregates() {
       }
     }
 
+    if (aggregateRuns_) {
+      evaluateAggregateRuns(i, args);
+      continue;
+    }
+
     const auto& rows = getSelectivityVector(i);
 
     if (isRawInput(step_)) {
@@ -242,6 +329,27 @@ void StreamingAggregation::evaluateAggregates() {
   }
 }
 
+void StreamingAggregation::evaluateAggregateRuns(
+    size_t aggregateIndex,
+    const std::vector<VectorPtr>& args) {
+  auto& aggregate = aggregates_[aggregateIndex];
+  // The bits of 'runRows_' outside of the active range are ignored, so
+  // narrowing the range to each run selects the rows of the run.
+  runRows_ = getSelectivityVector(aggregateIndex);
+  auto numInput = input_->size();
+  auto numRuns = groupStarts_.size();
+  for (auto run = 0; run < numRuns; ++run) {
+    auto end = run + 1 < numRuns ? groupStarts_[run + 1] : numInput;
+    runRows_.setActiveRange(groupStarts_[run], end);
+    if (isRawInput(step_)) {
+      aggregate->addSingleGroupRawInput(runGroups_[run], runRows_, args, false);
+    } else {
+      aggregate->addSingleGroupIntermediateResults(
+          runGroups_[run], runRows_, args, false);
+    }
+  }
+}
+
 bool StreamingAggregation::isFinished() {
   return noMoreInput_ && input_ == nullptr && numGroups_ == 0;
 }
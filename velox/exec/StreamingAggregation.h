@@ -59,13 +59,29 @@ class StreamingAggregation : public Operator {
   // of the groups_ vector.
   RowVectorPtr createOutput(size_t numGroups);
 
-  // Assign input rows to groups based on values of the grouping keys. Store the
-  // assignments in inputGroups_.
+  // Sets 'groupStarts_' to the first row of each run of rows with equal
+  // grouping keys in 'input_'. Compares adjacent rows of flat key columns in
+  // a loop over the whole batch.
+  void findGroupStarts();
+
+  // Assign input rows to groups based on values of the grouping keys. Store
+  // the group of each run in 'runGroups_' and, if the runs are short, the
+  // group of each row in 'inputGroups_'.
   void assignGroups();
 
   // Add input data to accumulators.
   void evaluateAggregates();
 
+  // Adds the input of the aggregate 'aggregateIndex' to the accumulators once
+  // per run of rows in the same group.
+  void evaluateAggregateRuns(
+      size_t aggregateIndex,
+      const std::vector<VectorPtr>& args);
+
+  // Runs with equal keys shorter than this on average are aggregated with a
+  // group pointer per row instead of one call per run.
+  static constexpr vector_size_t kMinAverageRunLength = 16;
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
@@ -94,9 +110,23 @@ class StreamingAggregation : public Operator {
 
   // Reusable memory.
 
-  // Pointers to groups for all input rows.
+  // Pointers to groups for all input rows. Not used if 'aggregateRuns_'.
   std::vector<char*> inputGroups_;
 
+  // Bits set for the rows of 'input_' whose keys differ from the row before.
+  std::vector<uint64_t> boundaries_;
+
+  // The first row of each run of equal keys in 'input_' and the group of each
+  // run.
+  std::vector<vector_size_t> groupStarts_;
+  std::vector<char*> runGroups_;
+
+  // True if the runs are long enough to call the aggregates once per run.
+  bool aggregateRuns_{false};
+
+  // The rows of one run.
+  SelectivityVector runRows_;
+
   // A subset of input rows to evaluate the aggregate function on. Rows
   // where aggregation mask is false are excluded.
   SelectivityVector inputRows_;
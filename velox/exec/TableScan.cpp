@@ -32,45 +32,69 @@ TableScan::TableScan(
           "TableScan"),
       tableHandle_(tableScanNode->tableHandle()),
       columnHandles_(tableScanNode->assignments()),
+      scanType_(tableScanNode->scanType()),
+      aggregates_(tableScanNode->aggregates()),
       driverCtx_(driverCtx),
-      preferredBatchSize_(driverCtx->queryConfig().preferredOutputBatchSize()) {
+      splitChunkBytes_(driverCtx->queryConfig().tableScanSplitChunkBytes()) {
   connector_ = connector::getConnector(tableHandle_->connectorId());
+  VELOX_CHECK(
+      aggregates_.empty() || connector_->supportsAggregationPushdown(),
+      "Connector {} does not support aggregation pushdown",
+      tableHandle_->connectorId());
+  if (connector_->supportsSplitPreload() && connector_->executor()) {
+    maxPreloadedSplits_ = driverCtx->queryConfig().maxSplitPreloadPerDriver();
+  }
 }
 
 RowVectorPtr TableScan::getOutput() {
   if (noMoreSplits_) {
     return nullptr;
   }
+  if (remainingRows_.has_value() && remainingRows_.value() == 0) {
+    if (!needNewSplit_) {
+      driverCtx_->task->splitFinished();
+    }
+    noMoreSplits_ = true;
+    addConnectorStats();
+    return nullptr;
+  }
 
   for (;;) {
     if (needNewSplit_) {
       exec::Split split;
       blockingReason_ = driverCtx_->task->getSplitOrFuture(
-          driverCtx_->splitGroupId, planNodeId(), split, blockingFuture_);
+          driverCtx_->splitGroupId,
+          planNodeId(),
+          split,
+          blockingFuture_,
+          maxPreloadedSplits_,
+          [&](auto queuedSplit) { preload(queuedSplit); },
+          splitChunkBytes_);
       if (blockingReason_ != BlockingReason::kNotBlocked) {
+        if (splitWaitStartMicros_ == 0) {
+          splitWaitStartMicros_ = getCurrentTimeMicro();
+        }
         return nullptr;
       }
+      if (splitWaitStartMicros_ != 0) {
+        // The time idle while the other Drivers read their splits.
+        stats_.addRuntimeStat(
+            "splitWaitWallNanos",
+            RuntimeCounter(
+                (getCurrentTimeMicro() - splitWaitStartMicros_) * 1'000,
+                RuntimeCounter::Unit::kNanos));
+        splitWaitStartMicros_ = 0;
+      }
 
       if (!split.hasConnectorSplit()) {
         noMoreSplits_ = true;
-
-        if (dataSource_) {
-          auto connectorStats = dataSource_->runtimeStats();
-          for (const auto& [name, counter] : connectorStats) {
-            if (UNLIKELY(stats_.runtimeStats.count(name) == 0)) {
-              stats_.runtimeStats.insert(
-                  std::make_pair(name, RuntimeMetric(counter.unit)));
-            } else {
-              VELOX_CHECK_EQ(stats_.runtimeStats.at(name).unit, counter.unit);
-            }
-            stats_.runtimeStats.at(name).addValue(counter.value);
-          }
-        }
+        addConnectorStats();
         return nullptr;
       }
 
       const auto& connectorSplit = split.connectorSplit;
       needNewSplit_ = false;
+      addNewDynamicFilters();
 
       VELOX_CHECK(
           connector_->connectorId() == connectorSplit->connectorId,
@@ -80,21 +104,49 @@ RowVectorPtr TableScan::getOutput() {
         connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
             connectorSplit->connectorId, planNodeId());
         dataSource_ = connector_->createDataSource(
-            outputType_,
-            tableHandle_,
-            columnHandles_,
-            connectorQueryCtx_.get());
-        for (const auto& entry : pendingDynamicFilters_) {
+            scanType_, tableHandle_, columnHandles_, connectorQueryCtx_.get());
+        if (!aggregates_.empty()) {
+          VELOX_CHECK(
+              dataSource_->pushdownAggregates(aggregates_, outputType_),
+              "DataSource of connector {} cannot compute the aggregates of {}",
+              connector_->connectorId(),
+              planNodeId());
+        }
+        for (const auto& entry : dynamicFilters_) {
           dataSource_->addDynamicFilter(entry.first, entry.second);
         }
-        pendingDynamicFilters_.clear();
       }
 
       debugString_ = fmt::format(
           "Split {} Task {}",
           connectorSplit->toString(),
           operatorCtx_->task()->taskId());
-      dataSource_->addSplit(connectorSplit);
+      // Covers the wait for a preload in progress.
+      const auto splitLoadStartMicros = getCurrentTimeMicro();
+      std::unique_ptr<std::shared_ptr<connector::DataSource>> preloaded;
+      if (connectorSplit->dataSource) {
+        // Waits for a preload in progress or makes the DataSource here
+        // if the preload has not started.
+        preloaded = connectorSplit->dataSource->move();
+        connectorSplit->dataSource.reset();
+      }
+      if (preloaded && *preloaded) {
+        dataSource_->setFromDataSource(std::move(*preloaded));
+        for (const auto& entry : dynamicFilters_) {
+          dataSource_->addDynamicFilter(entry.first, entry.second);
+        }
+      } else {
+        if (remainingRows_.has_value()) {
+          dataSource_->setRowLimit(remainingRows_.value());
+        }
+        dataSource_->addSplit(connectorSplit);
+      }
+      stats_.addRuntimeStat(
+          "splitLoadWallNanos",
+          RuntimeCounter(
+              (getCurrentTimeMicro() - splitLoadStartMicros) * 1'000,
+              RuntimeCounter::Unit::kNanos,
+              /*histogram=*/true));
       ++stats_.numSplits;
       setBatchSize();
     }
@@ -106,7 +158,10 @@ RowVectorPtr TableScan::getOutput() {
          },
          &debugString_});
 
-    auto dataOptional = dataSource_->next(readBatchSize_, blockingFuture_);
+    const auto batchSize = remainingRows_.has_value()
+        ? std::min<int64_t>(readBatchSize_, remainingRows_.value())
+        : readBatchSize_;
+    auto dataOptional = dataSource_->next(batchSize, blockingFuture_);
     if (!dataOptional.has_value()) {
       blockingReason_ = BlockingReason::kWaitForConnector;
       return nullptr;
@@ -116,7 +171,8 @@ RowVectorPtr TableScan::getOutput() {
         "dataSourceWallNanos",
         RuntimeCounter(
             (getCurrentTimeMicro() - ioTimeStartMicros) * 1'000,
-            RuntimeCounter::Unit::kNanos));
+            RuntimeCounter::Unit::kNanos,
+            /*histogram=*/true));
     stats_.rawInputPositions = dataSource_->getCompletedRows();
     stats_.rawInputBytes = dataSource_->getCompletedBytes();
     auto data = dataOptional.value();
@@ -124,6 +180,10 @@ RowVectorPtr TableScan::getOutput() {
       if (data->size() > 0) {
         stats_.inputPositions += data->size();
         stats_.inputBytes += data->retainedSize();
+        if (remainingRows_.has_value()) {
+          remainingRows_ = std::max<int64_t>(
+              0, remainingRows_.value() - static_cast<int64_t>(data->size()));
+        }
         return data;
       }
       continue;
@@ -138,23 +198,73 @@ bool TableScan::isFinished() {
   return noMoreSplits_;
 }
 
-void TableScan::setBatchSize() {
-  if (preferredBatchSize_ != 1024) {
-    // Not the default value.
-    readBatchSize_ = preferredBatchSize_;
-    return;
-  }
-  constexpr int64_t kMB = 1 << 20;
-  auto estimate = dataSource_->estimatedRowSize();
-  if (estimate == connector::DataSource::kUnknownRowSize) {
-    readBatchSize_ = kDefaultBatchSize;
+void TableScan::pushdownLimit(int64_t numRows) {
+  remainingRows_ = numRows;
+  maxPreloadedSplits_ = 0;
+}
+
+void TableScan::close() {
+  dataSource_.reset();
+  SourceOperator::close();
+}
+
+void TableScan::addConnectorStats() {
+  if (!dataSource_) {
     return;
   }
-  if (estimate < 1024) {
-    readBatchSize_ = 10000; // No more than 10MB of data per batch.
-    return;
+  auto connectorStats = dataSource_->runtimeStats();
+  for (const auto& [name, counter] : connectorStats) {
+    if (UNLIKELY(stats_.runtimeStats.count(name) == 0)) {
+      stats_.runtimeStats.insert(
+          std::make_pair(name, RuntimeMetric(counter.unit, counter.histogram)));
+    } else {
+      VELOX_CHECK_EQ(stats_.runtimeStats.at(name).unit, counter.unit);
+    }
+    stats_.runtimeStats.at(name).addValue(counter.value);
   }
-  readBatchSize_ = std::min<int64_t>(100, 10 * kMB / estimate);
+}
+
+void TableScan::setBatchSize() {
+  auto estimate = dataSource_->estimatedRowSize();
+  readBatchSize_ = outputBatchRows(
+      estimate == connector::DataSource::kUnknownRowSize
+          ? std::nullopt
+          : std::optional<uint64_t>(estimate));
+}
+
+void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
+  // The preload may run after this is destroyed. It holds the Task,
+  // which owns the memory pool of the ConnectorQueryCtx, and skips the
+  // work if the Task is no longer running. Errors are left for
+  // addSplit() on the driver thread to raise.
+  split->dataSource =
+      std::make_shared<AsyncSource<std::shared_ptr<connector::DataSource>>>(
+          [type = scanType_,
+           table = tableHandle_,
+           columns = columnHandles_,
+           connector = connector_,
+           ctx = operatorCtx_->createConnectorQueryCtx(
+               split->connectorId, planNodeId()),
+           task = operatorCtx_->task(),
+           split = std::weak_ptr<connector::ConnectorSplit>(split)]()
+              -> std::unique_ptr<std::shared_ptr<connector::DataSource>> {
+            auto strongSplit = split.lock();
+            if (!strongSplit || !task->isRunning()) {
+              return nullptr;
+            }
+            try {
+              auto dataSource =
+                  connector->createDataSource(type, table, columns, ctx.get());
+              dataSource->addSplit(strongSplit);
+              return std::make_unique<std::shared_ptr<connector::DataSource>>(
+                  std::move(dataSource));
+            } catch (const std::exception& e) {
+              VLOG(1) << "Split preload failed: " << e.what();
+              return nullptr;
+            }
+          });
+  connector_->executor()->add(
+      [source = split->dataSource]() { source->prepare(); });
 }
 
 void TableScan::addDynamicFilter(
@@ -162,8 +272,16 @@ void TableScan::addDynamicFilter(
     const std::shared_ptr<common::Filter>& filter) {
   if (dataSource_) {
     dataSource_->addDynamicFilter(outputChannel, filter);
-  } else {
-    pendingDynamicFilters_.emplace(outputChannel, filter);
+  }
+  dynamicFilters_.emplace_back(outputChannel, filter);
+}
+
+void TableScan::addNewDynamicFilters() {
+  auto filters = driverCtx_->task->newDynamicFilters(
+      planNodeId(), numRemoteDynamicFilters_);
+  for (const auto& [name, filter] : filters) {
+    addDynamicFilter(scanType_->getChildIdx(name), filter);
+    stats_.addRuntimeStat("dynamicFiltersAccepted", RuntimeCounter(1));
   }
 }
 
@@ -47,16 +47,46 @@ class TableScan : public SourceOperator {
       column_index_t outputChannel,
       const std::shared_ptr<common::Filter>& filter) override;
 
+  bool canPushdownLimit() const override {
+    return true;
+  }
+
+  // Finishes after 'numRows' rows, caps the batch size by the rows to go
+  // and passes these to the DataSource as a row limit for each split.
+  // Queued splits are not preloaded since the rows of the split being read
+  // will often be enough.
+  void pushdownLimit(int64_t numRows) override;
+
+  // Destroys the DataSource, which cancels the IO it has scheduled, e.g.
+  // when a downstream Limit finishes before the splits are read.
+  void close() override;
+
  private:
   static constexpr int32_t kDefaultBatchSize = 1024;
 
-  // Adjust batch size according to split information.
+  // Sets 'readBatchSize_' from the row size estimate of the split.
   void setBatchSize();
 
+  // Adds the filters from Task::addDynamicFilters() that arrived since the
+  // previous call. Called before a split starts.
+  void addNewDynamicFilters();
+
+  // Adds the runtime stats of 'dataSource_' to the stats of 'this'.
+  void addConnectorStats();
+
+  // Sets 'split->dataSource' to a DataSource that gets 'split' added on
+  // the connector's executor. Called by the Task for splits queued
+  // behind the one this is about to read.
+  void preload(std::shared_ptr<connector::ConnectorSplit> split);
+
   const std::shared_ptr<connector::ConnectorTableHandle> tableHandle_;
   const std::
       unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
           columnHandles_;
+  // The columns read from the connector. Differs from the output type if
+  // the connector computes 'aggregates_'.
+  const RowTypePtr scanType_;
+  const std::vector<connector::PushdownAggregate> aggregates_;
   DriverCtx* driverCtx_;
   ContinueFuture blockingFuture_{ContinueFuture::makeEmpty()};
   BlockingReason blockingReason_;
@@ -65,12 +95,23 @@ class TableScan : public SourceOperator {
   std::shared_ptr<connector::ConnectorQueryCtx> connectorQueryCtx_;
   std::shared_ptr<connector::DataSource> dataSource_;
   bool noMoreSplits_ = false;
-  // Dynamic filters to add to the data source when it gets created.
-  std::unordered_map<column_index_t, std::shared_ptr<common::Filter>>
-      pendingDynamicFilters_;
+  // Dynamic filters in order of arrival. Added to the data source when
+  // it gets created and again when it takes over a preloaded split.
+  std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>
+      dynamicFilters_;
+  // Number of the filters of Task::addDynamicFilters() added to 'this'.
+  size_t numRemoteDynamicFilters_{0};
+  // Number of queued splits to preload, 0 if the connector does not
+  // support preload.
+  int32_t maxPreloadedSplits_{0};
   int32_t readBatchSize_{kDefaultBatchSize};
-  // A preferred batch size from configuration.
-  uint32_t preferredBatchSize_;
+  // The rows to produce before finishing if a limit was pushed down.
+  std::optional<int64_t> remainingRows_;
+  // Splits larger than this are divided for other Drivers. 0 means never.
+  const uint64_t splitChunkBytes_;
+  // Time when 'this' ran out of splits to read, 0 if it is not waiting for
+  // one. The wait is reported as the splitWaitWallNanos runtime stat.
+  uint64_t splitWaitStartMicros_{0};
 
   // String shown in ExceptionContext inside DataSource and LazyVector loading.
   std::string debugString_;
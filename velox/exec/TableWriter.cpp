@@ -55,6 +55,23 @@ TableWriter::TableWriter(
   }
 
   mappedType_ = ROW(std::move(names), std::move(types));
+
+  const auto& sortingKeys = tableWriteNode->sortingKeys();
+  if (!sortingKeys.empty()) {
+    std::vector<column_index_t> sortChannels;
+    for (auto i = 0; i < sortingKeys.size(); ++i) {
+      auto channel =
+          tableWriteNode->columns()->getChildIdx(sortingKeys[i]->name());
+      const auto& sortOrder = tableWriteNode->sortingOrders()[i];
+      sortChannels.push_back(channel);
+      sortingColumns_.push_back(mappedType_->nameOf(channel));
+      sortingFlags_.push_back(
+          {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+    }
+    sortBuffer_ = std::make_unique<SortBuffer>(
+        mappedType_, sortChannels, sortingFlags_, *operatorCtx_);
+  }
+
   const auto& config = driverCtx_->task->queryCtx()->config();
   if (config.createEmptyFiles()) {
     LOG(INFO) << "Enforce creating empty files\n";
@@ -65,6 +82,9 @@ TableWriter::TableWriter(
 void TableWriter::createDataSink() {
   dataSink_ = connector_->createDataSink(
       mappedType_, insertTableHandle_, connectorQueryCtx_.get());
+  if (sortBuffer_) {
+    dataSink_->setSortOrder(sortingColumns_, sortingFlags_);
+  }
 }
 
 void TableWriter::addInput(RowVectorPtr input) {
@@ -86,12 +106,42 @@ void TableWriter::addInput(RowVectorPtr input) {
       mappedChildren,
       input->getNullCount());
 
+  numWrittenRows_ += input->size();
+  if (sortBuffer_) {
+    sortBuffer_->addInput(mappedInput);
+    return;
+  }
+
   // Lazily instantiate data sink to prevent leftover empty files.
   if (!dataSink_) {
     createDataSink();
   }
   dataSink_->appendData(mappedInput);
-  numWrittenRows_ += input->size();
+}
+
+void TableWriter::noMoreInput() {
+  Operator::noMoreInput();
+  if (sortBuffer_) {
+    writeSorted();
+  }
+  close();
+}
+
+void TableWriter::writeSorted() {
+  sortBuffer_->noMoreInput();
+  while (auto output = sortBuffer_->getOutput()) {
+    if (!dataSink_) {
+      createDataSink();
+    }
+    dataSink_->appendData(output);
+  }
+  if (auto spiller = sortBuffer_->spiller()) {
+    auto spilled = spiller->spilledBytesAndRows();
+    stats_.spilledBytes = spilled.first;
+    stats_.spilledRows = spilled.second;
+    stats_.spillDirectoryStats = spiller->spillDirectoryStats();
+  }
+  sortBuffer_.reset();
 }
 
 RowVectorPtr TableWriter::getOutput() {
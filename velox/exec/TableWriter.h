@@ -18,6 +18,7 @@
 
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/SortBuffer.h"
 
 namespace facebook::velox::exec {
 
@@ -37,10 +38,7 @@ class TableWriter : public Operator {
 
   void addInput(RowVectorPtr input) override;
 
-  void noMoreInput() override {
-    Operator::noMoreInput();
-    close();
-  }
+  void noMoreInput() override;
 
   virtual bool needsInput() const override {
     return true;
@@ -64,6 +62,9 @@ class TableWriter : public Operator {
  private:
   void createDataSink();
 
+  // Writes the rows of 'sortBuffer_' in sorted order.
+  void writeSorted();
+
   std::vector<column_index_t> inputMapping_;
   std::shared_ptr<const RowType> mappedType_;
   vector_size_t numWrittenRows_;
@@ -74,5 +75,12 @@ class TableWriter : public Operator {
   std::shared_ptr<connector::ConnectorQueryCtx> connectorQueryCtx_;
   std::shared_ptr<connector::DataSink> dataSink_;
   std::shared_ptr<connector::ConnectorInsertTableHandle> insertTableHandle_;
+
+  // Set if the TableWriteNode has sorting keys. Buffers all input until
+  // noMoreInput().
+  std::unique_ptr<SortBuffer> sortBuffer_;
+  // Table column names and collations of the sorting keys.
+  std::vector<std::string> sortingColumns_;
+  std::vector<CompareFlags> sortingFlags_;
 };
 } // namespace facebook::velox::exec
@@ -16,16 +16,21 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <folly/json.h>
 
 #include "velox/codegen/Codegen.h"
+#include "velox/common/process/EventTrace.h"
 #include "velox/common/time/Timer.h"
 #include "velox/exec/CrossJoinBuild.h"
+#include "velox/exec/DynamicFilters.h"
 #include "velox/exec/Exchange.h"
 #include "velox/exec/HashBuild.h"
 #include "velox/exec/LocalPlanner.h"
 #include "velox/exec/Merge.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/Task.h"
+#include "velox/exec/TaskProfile.h"
+#include "velox/expression/Expr.h"
 #if CODEGEN_ENABLED == 1
 #include "velox/experimental/codegen/CodegenLogger.h"
 #endif
@@ -104,6 +109,20 @@ std::unordered_set<core::PlanNodeId> collectSplitPlanNodeIds(
   return sourceIds;
 }
 
+const core::PlanNode* findPlanNode(
+    const core::PlanNode* planNode,
+    const core::PlanNodeId& id) {
+  if (planNode->id() == id) {
+    return planNode;
+  }
+  for (const auto& child : planNode->sources()) {
+    if (auto node = findPlanNode(child.get(), id)) {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
 } // namespace
 
 Task::Task(
@@ -140,10 +159,14 @@ Task::Task(
       planFragment_(std::move(planFragment)),
       destination_(destination),
       queryCtx_(std::move(queryCtx)),
+      traceId_(
+          queryCtx_->config().eventTraceEnabled()
+              ? process::EventTrace::newTraceId()
+              : 0),
       splitPlanNodeIds_(collectSplitPlanNodeIds(planFragment_.planNode)),
       consumerSupplier_(std::move(consumerSupplier)),
       onError_(onError),
-      pool_(queryCtx_->pool()->addScopedChild("task_root")),
+      pool_(queryCtx_->pool()->addScopedChild(fmt::format("task.{}", taskId_))),
       bufferManager_(PartitionedOutputBufferManager::getInstance()) {}
 
 Task::~Task() {
@@ -182,6 +205,37 @@ memory::MappedMemory* FOLLY_NONNULL Task::addOperatorMemory(
   return mappedMemory.get();
 }
 
+memory::MemoryUsageSnapshot Task::memoryUsageSnapshot() const {
+  memory::MemoryUsageSnapshot snapshot;
+  if (const auto& tracker = pool_->getMemoryUsageTracker()) {
+    snapshot = memory::MemoryUsageSnapshot::fromTracker(taskId_, *tracker);
+  } else {
+    snapshot.name = taskId_;
+    snapshot.currentBytes = pool_->getCurrentBytes();
+    snapshot.peakBytes = pool_->getMaxBytes();
+  }
+  // Operator usage by pipeline and operator name.
+  std::map<int32_t, std::map<std::string, memory::MemoryUsageSnapshot>>
+      pipelines;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (const auto& driver : drivers_) {
+      if (driver) {
+        driver->addMemoryUsage(pipelines[driver->driverCtx()->pipelineId]);
+      }
+    }
+  }
+  for (auto& [pipelineId, operators] : pipelines) {
+    memory::MemoryUsageSnapshot pipeline;
+    pipeline.name = fmt::format("pipeline.{}", pipelineId);
+    for (auto& [name, usage] : operators) {
+      pipeline.addChild(std::move(usage), true);
+    }
+    snapshot.addChild(std::move(pipeline), false);
+  }
+  return snapshot;
+}
+
 bool Task::supportsSingleThreadedExecution() const {
   std::vector<std::unique_ptr<DriverFactory>> driverFactories;
 
@@ -300,16 +354,7 @@ void Task::start(
     uint32_t concurrentSplitGroups) {
   VELOX_CHECK_GE(
       maxDrivers, 1, "maxDrivers parameter must be greater then or equal to 1");
-  VELOX_CHECK_GE(
-      concurrentSplitGroups,
-      1,
-      "concurrentSplitGroups parameter must be greater then or equal to 1");
-  VELOX_CHECK(self->drivers_.empty());
-  self->concurrentSplitGroups_ = concurrentSplitGroups;
-  {
-    std::lock_guard<std::mutex> l(self->mutex_);
-    self->taskStats_.executionStartTimeMs = getCurrentTimeMs();
-  }
+  prepareStart(self, concurrentSplitGroups);
 
 #if CODEGEN_ENABLED == 1
   const auto& config = self->queryCtx()->config();
@@ -333,7 +378,44 @@ void Task::start(
       self->consumerSupplier(),
       &self->driverFactories_,
       maxDrivers);
+  startPipelines(self);
+}
+
+// static
+void Task::start(
+    std::shared_ptr<Task> self,
+    const LocalPlan& localPlan,
+    uint32_t concurrentSplitGroups) {
+  const auto& planFragment = localPlan.planFragment();
+  VELOX_CHECK(
+      planFragment.planNode == self->planFragment_.planNode &&
+          planFragment.executionStrategy ==
+              self->planFragment_.executionStrategy &&
+          planFragment.numSplitGroups == self->planFragment_.numSplitGroups,
+      "LocalPlan is not made for the plan fragment of task {}",
+      self->taskId_);
+  prepareStart(self, concurrentSplitGroups);
+  self->driverFactories_ =
+      localPlan.makeDriverFactories(self->consumerSupplier());
+  startPipelines(self);
+}
 
+// static
+void Task::prepareStart(
+    std::shared_ptr<Task>& self,
+    uint32_t concurrentSplitGroups) {
+  VELOX_CHECK_GE(
+      concurrentSplitGroups,
+      1,
+      "concurrentSplitGroups parameter must be greater then or equal to 1");
+  VELOX_CHECK(self->drivers_.empty());
+  self->concurrentSplitGroups_ = concurrentSplitGroups;
+  std::lock_guard<std::mutex> l(self->mutex_);
+  self->taskStats_.executionStartTimeMs = getCurrentTimeMs();
+}
+
+// static
+void Task::startPipelines(std::shared_ptr<Task>& self) {
   // Keep one exchange client per pipeline (NULL if not used).
   const auto numPipelines = self->driverFactories_.size();
   self->exchangeClients_.resize(numPipelines);
@@ -606,7 +688,7 @@ void Task::ensureSplitGroupsAreBeingProcessedLocked(
   }
 
   while (numRunningSplitGroups_ < concurrentSplitGroups_ and
-         not queuedSplitGroups_.empty()) {
+         not queuedSplitGroups_.empty() and hasMemoryForSplitGroupLocked()) {
     const uint32_t splitGroupId = queuedSplitGroups_.front();
     queuedSplitGroups_.pop();
 
@@ -633,6 +715,43 @@ void Task::ensureSplitGroupsAreBeingProcessedLocked(
   }
 }
 
+bool Task::hasMemoryForSplitGroupLocked() const {
+  if (numRunningSplitGroups_ == 0) {
+    return true;
+  }
+  const auto& queryTracker = queryCtx_->pool()->getMemoryUsageTracker();
+  const auto& taskTracker = pool_->getMemoryUsageTracker();
+  if (!queryTracker || !taskTracker) {
+    return true;
+  }
+  const auto bytesPerSplitGroup =
+      taskTracker->getCurrentTotalBytes() / numRunningSplitGroups_;
+  return queryTracker->maxTotalBytes() -
+      queryTracker->getCurrentTotalBytes() >=
+      bytesPerSplitGroup;
+}
+
+void Task::releaseExprSet(
+    const core::PlanNodeId& planNodeId,
+    std::unique_ptr<core::ExecCtx> execCtx,
+    std::unique_ptr<ExprSet> exprSet) {
+  std::lock_guard<std::mutex> l(exprSetsMutex_);
+  reusableExprSets_[planNodeId].emplace_back(
+      std::move(execCtx), std::move(exprSet));
+}
+
+std::pair<std::unique_ptr<core::ExecCtx>, std::unique_ptr<ExprSet>>
+Task::takeExprSet(const core::PlanNodeId& planNodeId) {
+  std::lock_guard<std::mutex> l(exprSetsMutex_);
+  auto it = reusableExprSets_.find(planNodeId);
+  if (it == reusableExprSets_.end() || it->second.empty()) {
+    return {nullptr, nullptr};
+  }
+  auto exprSet = std::move(it->second.back());
+  it->second.pop_back();
+  return exprSet;
+}
+
 void Task::setMaxSplitSequenceId(
     const core::PlanNodeId& planNodeId,
     long maxSequenceId) {
@@ -843,24 +962,135 @@ BlockingReason Task::getSplitOrFuture(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId,
     exec::Split& split,
-    ContinueFuture& future) {
+    ContinueFuture& future,
+    int32_t maxPreloadSplits,
+    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload,
+    uint64_t splitChunkBytes) {
+  std::unique_ptr<ContinuePromise> promise;
+  BlockingReason reason;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+
+    auto& splitsState = splitsStates_[planNodeId];
+    auto& splitsStore = splitsState.groupSplitsStores
+                            [isUngroupedExecution() ? 0 : splitGroupId];
+    reason = getSplitOrFutureLocked(
+        splitsStore,
+        split,
+        future,
+        maxPreloadSplits,
+        preload,
+        splitChunkBytes,
+        promise);
+  }
+  if (promise) {
+    promise->setValue();
+  }
+  return reason;
+}
+
+std::optional<std::string> Task::joinDynamicFilters(
+    const core::PlanNodeId& joinNodeId,
+    uint32_t splitGroupId) {
+  auto joinNode = dynamic_cast<const core::HashJoinNode*>(
+      findPlanNode(planFragment_.planNode.get(), joinNodeId));
+  VELOX_USER_CHECK_NOT_NULL(joinNode, "Not a hash join: {}", joinNodeId);
+  auto result = getHashJoinBridge(splitGroupId, joinNodeId)->tableIfSet();
+  if (!result.has_value()) {
+    return std::nullopt;
+  }
+  folly::dynamic filters = folly::dynamic::object;
+  if (!joinNode->isInnerJoin() && !joinNode->isLeftSemiJoin()) {
+    return folly::toJson(filters);
+  }
+  const auto& keys = joinNode->leftKeys();
+  if (result->table && result->table->numDistinct() == 0 &&
+      result->spilledPartitions.empty() && !result->swapped) {
+    for (const auto& key : keys) {
+      filters[key->name()] = serializeDynamicFilter(common::AlwaysFalse());
+    }
+    return folly::toJson(filters);
+  }
+  auto keyFilters = makeJoinKeyFilters(*result);
+  for (auto i = 0; i < keyFilters.size(); ++i) {
+    if (keyFilters[i]) {
+      filters[keys[i]->name()] = serializeDynamicFilter(*keyFilters[i]);
+    }
+  }
+  return folly::toJson(filters);
+}
+
+void Task::addDynamicFilters(
+    const core::PlanNodeId& scanNodeId,
+    const std::string& filters) {
+  auto scanNode = dynamic_cast<const core::TableScanNode*>(
+      findPlanNode(planFragment_.planNode.get(), scanNodeId));
+  VELOX_USER_CHECK_NOT_NULL(scanNode, "Not a TableScan: {}", scanNodeId);
+  std::vector<std::pair<std::string, std::shared_ptr<common::Filter>>>
+      newFilters;
+  for (const auto& [name, filter] : folly::parseJson(filters).items()) {
+    VELOX_USER_CHECK(
+        scanNode->scanType()->containsChild(name.asString()),
+        "Dynamic filter on a column not read by TableScan {}: {}",
+        scanNodeId,
+        name.asString());
+    newFilters.emplace_back(name.asString(), deserializeDynamicFilter(filter));
+  }
   std::lock_guard<std::mutex> l(mutex_);
+  auto& scanFilters = remoteDynamicFilters_[scanNodeId];
+  scanFilters.insert(scanFilters.end(), newFilters.begin(), newFilters.end());
+}
 
-  auto& splitsState = splitsStates_[planNodeId];
+std::vector<std::pair<std::string, std::shared_ptr<common::Filter>>>
+Task::newDynamicFilters(const core::PlanNodeId& scanNodeId, size_t& numSeen) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = remoteDynamicFilters_.find(scanNodeId);
+  if (it == remoteDynamicFilters_.end() || it->second.size() <= numSeen) {
+    return {};
+  }
+  std::vector<std::pair<std::string, std::shared_ptr<common::Filter>>>
+      filters(it->second.begin() + numSeen, it->second.end());
+  numSeen = it->second.size();
+  return filters;
+}
 
-  if (isUngroupedExecution()) {
-    return getSplitOrFutureLocked(
-        splitsState.groupSplitsStores[0], split, future);
-  } else {
-    return getSplitOrFutureLocked(
-        splitsState.groupSplitsStores[splitGroupId], split, future);
+std::optional<std::vector<std::shared_ptr<connector::ConnectorSplit>>>
+Task::pendingSplitsIfComplete(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = splitsStates_.find(planNodeId);
+  if (it == splitsStates_.end()) {
+    return std::nullopt;
+  }
+  auto storeIt = it->second.groupSplitsStores.find(
+      isUngroupedExecution() ? 0 : splitGroupId);
+  if (storeIt == it->second.groupSplitsStores.end()) {
+    return std::nullopt;
+  }
+  const auto& splitsStore = storeIt->second;
+  if (!splitsStore.noMoreSplits || splitsStore.splitsTaken) {
+    return std::nullopt;
+  }
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+  for (const auto& split : splitsStore.splits) {
+    if (!split.hasConnectorSplit()) {
+      return std::nullopt;
+    }
+    splits.push_back(split.connectorSplit);
   }
+  return splits;
 }
 
 BlockingReason Task::getSplitOrFutureLocked(
     SplitsStore& splitsStore,
     exec::Split& split,
-    ContinueFuture& future) {
+    ContinueFuture& future,
+    int32_t maxPreloadSplits,
+    const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+        preload,
+    uint64_t splitChunkBytes,
+    std::unique_ptr<ContinuePromise>& promise) {
   if (splitsStore.splits.empty()) {
     if (splitsStore.noMoreSplits) {
       return BlockingReason::kNotBlocked;
@@ -872,8 +1102,19 @@ BlockingReason Task::getSplitOrFutureLocked(
     return BlockingReason::kWaitForSplit;
   }
 
+  // A split with a preloaded DataSource is read whole. It was divided before
+  // the preload.
+  if (splitChunkBytes > 0 &&
+      divideSplitLocked(splitsStore, 0, splitChunkBytes) &&
+      !splitsStore.splitPromises.empty()) {
+    // The rest of the split is for a Driver that is out of splits.
+    promise = std::make_unique<ContinuePromise>(
+        std::move(splitsStore.splitPromises.back()));
+    splitsStore.splitPromises.pop_back();
+  }
   split = std::move(splitsStore.splits.front());
   splitsStore.splits.pop_front();
+  splitsStore.splitsTaken = true;
 
   --taskStats_.numQueuedSplits;
   ++taskStats_.numRunningSplits;
@@ -882,9 +1123,52 @@ BlockingReason Task::getSplitOrFutureLocked(
     taskStats_.firstSplitStartTimeMs = taskStats_.lastSplitStartTimeMs;
   }
 
+  if (maxPreloadSplits > 0 && preload) {
+    int32_t numPreloaded = 0;
+    for (auto i = 0; i < splitsStore.splits.size(); ++i) {
+      if (numPreloaded >= maxPreloadSplits) {
+        break;
+      }
+      if (!splitsStore.splits[i].hasConnectorSplit()) {
+        continue;
+      }
+      if (!splitsStore.splits[i].connectorSplit->dataSource) {
+        if (splitChunkBytes > 0) {
+          divideSplitLocked(splitsStore, i, splitChunkBytes);
+        }
+        preload(splitsStore.splits[i].connectorSplit);
+      }
+      ++numPreloaded;
+    }
+  }
+
   return BlockingReason::kNotBlocked;
 }
 
+bool Task::divideSplitLocked(
+    SplitsStore& splitsStore,
+    size_t index,
+    uint64_t splitChunkBytes) {
+  auto& split = splitsStore.splits[index];
+  if (!split.hasConnectorSplit() || split.connectorSplit->dataSource) {
+    return false;
+  }
+  auto parts = split.connectorSplit->divide(splitChunkBytes);
+  if (parts.empty()) {
+    return false;
+  }
+  VELOX_CHECK_EQ(2, parts.size());
+  const auto groupId = split.groupId;
+  split.connectorSplit = std::move(parts[0]);
+  splitsStore.splits.insert(
+      splitsStore.splits.begin() + index + 1,
+      exec::Split(std::move(parts[1]), groupId));
+  ++taskStats_.numTotalSplits;
+  ++taskStats_.numQueuedSplits;
+  ++taskStats_.numDividedSplits;
+  return true;
+}
+
 void Task::splitFinished() {
   std::lock_guard<std::mutex> l(mutex_);
   ++taskStats_.numFinishedSplits;
@@ -1279,6 +1563,9 @@ uint64_t Task::timeSinceEndMs() const {
 }
 
 void Task::onTaskCompletion() {
+  if (queryCtx_->config().taskProfileEnabled()) {
+    TaskProfileStore::instance().add(taskId_, toProfileJson());
+  }
   listeners().withRLock([&](auto& listeners) {
     for (auto& listener : listeners) {
       listener->onTaskCompletion(
@@ -1325,6 +1612,31 @@ std::string Task::toString() const {
   return out.str();
 }
 
+std::string Task::toChromeTrace() const {
+  VELOX_CHECK_NE(
+      traceId_,
+      0,
+      "Set {} to trace Task {}",
+      core::QueryConfig::kEventTraceEnabled,
+      taskId_);
+  return process::EventTrace::toChromeTrace(
+      process::EventTrace::events(traceId_),
+      fmt::format("Task {}", taskId_),
+      [](int32_t lane) {
+        return fmt::format("Driver {}.{} blocked", lane >> 16, lane & 0xffff);
+      });
+}
+
+std::string Task::toProfileJson() const {
+  return folly::toJson(makeTaskProfile(
+      taskId_,
+      uuid_,
+      state(),
+      errorMessage(),
+      taskStats(),
+      memoryUsageSnapshot()));
+}
+
 std::shared_ptr<MergeSource> Task::addLocalMergeSource(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId,
@@ -1369,6 +1681,17 @@ std::shared_ptr<MergeJoinSource> Task::getMergeJoinSource(
   return it->second;
 }
 
+std::shared_ptr<std::atomic<int64_t>> Task::getSharedLimit(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId,
+    int64_t count) {
+  auto& limit = splitGroupStates_[splitGroupId].limits[planNodeId];
+  if (!limit) {
+    limit = std::make_shared<std::atomic<int64_t>>(count);
+  }
+  return limit;
+}
+
 void Task::createLocalExchangeQueuesLocked(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId,
@@ -1620,6 +1943,36 @@ ContinueFuture Task::requestPauseLocked(bool pause) {
   return makeFinishFutureLocked("Task::requestPause");
 }
 
+void Task::reclaim() {
+  // Holding 'mutex_' keeps the Drivers from being closed while spilling.
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(
+      pauseRequested_ && numThreads_ == 0,
+      "Task {} must be paused to reclaim memory",
+      taskId_);
+  for (auto& driver : drivers_) {
+    if (driver) {
+      driver->reclaim();
+    }
+  }
+}
+
+// static
+bool Task::preempt(const std::shared_ptr<Task>& self, uint64_t maxWaitMs) {
+  auto future = self->requestPause(true);
+  future.wait(std::chrono::milliseconds(maxWaitMs));
+  if (!future.isReady()) {
+    return false;
+  }
+  try {
+    self->reclaim();
+  } catch (const std::exception&) {
+    // The state of the operators is unknown after a failed spill.
+    self->setError(std::current_exception());
+  }
+  return true;
+}
+
 Task::TaskCompletionNotifier::~TaskCompletionNotifier() {
   notify();
 }
@@ -30,6 +30,8 @@ class PartitionedOutputBufferManager;
 
 class HashJoinBridge;
 class CrossJoinBridge;
+class ExprSet;
+class LocalPlan;
 
 class Task : public std::enable_shared_from_this<Task> {
  public:
@@ -88,6 +90,27 @@ class Task : public std::enable_shared_from_this<Task> {
     return queryCtx_;
   }
 
+  /// Returns the id of the events of 'this' in process::EventTrace or 0 if
+  /// the event_trace_enabled query config is not set.
+  uint64_t traceId() const {
+    return traceId_;
+  }
+
+  /// Returns the events of 'this' still in the EventTrace buffers as a Chrome
+  /// trace, which chrome://tracing and ui.perfetto.dev open. There is a track
+  /// per thread with the Driver run slices, the operator calls, IO and spill,
+  /// and a track per Driver with its blocked time.
+  std::string toChromeTrace() const;
+
+  /// Returns the profile of 'this' made by makeTaskProfile() as JSON. May
+  /// be called while 'this' is running.
+  std::string toProfileJson() const;
+
+  /// Returns the lane of a Driver in the trace of its Task.
+  static int32_t traceLane(int32_t pipelineId, int32_t driverId) {
+    return (pipelineId << 16) | driverId;
+  }
+
   /// Returns MemoryPool used to allocate memory during execution. This instance
   /// is a child of the MemoryPool passed in the constructor.
   memory::MemoryPool* FOLLY_NONNULL pool() const {
@@ -118,6 +141,14 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t maxDrivers,
       uint32_t concurrentSplitGroups = 1);
 
+  /// Like start() but takes the pipelines from 'localPlan', which must be
+  /// made for the plan fragment of 'self', instead of planning the fragment.
+  /// The max drivers are those of 'localPlan'.
+  static void start(
+      std::shared_ptr<Task> self,
+      const LocalPlan& localPlan,
+      uint32_t concurrentSplitGroups = 1);
+
   /// If this returns true, this Task supports the single-threaded execution API
   /// next().
   bool supportsSingleThreadedExecution() const;
@@ -217,7 +248,35 @@ class Task : public std::enable_shared_from_this<Task> {
   // Returns by copy as other threads might be updating the structure.
   TaskStats taskStats() const {
     std::lock_guard<std::mutex> l(mutex_);
-    return taskStats_;
+    auto stats = taskStats_;
+    stats.numDriverExecutorRuns = numDriverExecutorRuns_;
+    stats.numDriverMigrations = numDriverMigrations_;
+    stats.numDriverCrossNodeMigrations = numDriverCrossNodeMigrations_;
+    stats.numDriverTimeSliceYields = numDriverTimeSliceYields_;
+    return stats;
+  }
+
+  /// Returns a snapshot of the memory usage of 'this' by pipeline and
+  /// operator. The usage of an operator is summed over its Drivers and named
+  /// <plan node id>.<operator type>. Pipelines are named pipeline.<id>.
+  memory::MemoryUsageSnapshot memoryUsageSnapshot() const;
+
+  /// Records that a Driver started running on a DriverExecutor worker.
+  /// 'migrated' is true if the worker differs from the one of the previous
+  /// run of the Driver, 'crossNode' if it is on another NUMA node.
+  void addDriverExecutorRun(bool migrated, bool crossNode) {
+    ++numDriverExecutorRuns_;
+    if (migrated) {
+      ++numDriverMigrations_;
+    }
+    if (crossNode) {
+      ++numDriverCrossNodeMigrations_;
+    }
+  }
+
+  /// Records that a Driver yielded its thread at the end of its time slice.
+  void addDriverTimeSliceYield() {
+    ++numDriverTimeSliceYields_;
   }
 
   /// Returns time (ms) since the task execution started or zero, if not
@@ -233,6 +292,11 @@ class Task : public std::enable_shared_from_this<Task> {
     return numDrivers(getOutputPipelineId());
   }
 
+  /// Returns the number of drivers of 'pipelineId' in each split group.
+  uint32_t numDrivers(int pipelineId) const {
+    return driverFactories_[pipelineId]->numDrivers;
+  }
+
   /// Returns the number of running drivers.
   uint32_t numRunningDrivers() const {
     std::lock_guard<std::mutex> taskLock(mutex_);
@@ -251,6 +315,24 @@ class Task : public std::enable_shared_from_this<Task> {
     return numFinishedDrivers_;
   }
 
+  /// Returns the dynamic filters made by the HashBuild of the inner or left
+  /// semi join 'joinNodeId' in 'splitGroupId', for delivery to the probe side
+  /// TableScans of other Tasks with addDynamicFilters(). The result is a JSON
+  /// object that maps the names of the probe side keys with a filter to the
+  /// serialized filters, see serializeDynamicFilter(). An empty build side
+  /// gives each key a filter that passes nothing. Returns std::nullopt if
+  /// the build is not finished.
+  std::optional<std::string> joinDynamicFilters(
+      const core::PlanNodeId& joinNodeId,
+      uint32_t splitGroupId = 0);
+
+  /// Adds 'filters' from joinDynamicFilters() of another Task to the
+  /// TableScan 'scanNodeId'. The keys of 'filters' are output column names
+  /// of the scan. The TableScans apply the filters from their next split on.
+  void addDynamicFilters(
+      const core::PlanNodeId& scanNodeId,
+      const std::string& filters);
+
   /// Internal public methods. These methods are intended to be used by internal
   /// library components (Driver, Operator, etc.) and should not be called by
   /// the library users.
@@ -282,11 +364,51 @@ class Task : public std::enable_shared_from_this<Task> {
   // received, sets split to null and returns kNotBlocked. Otherwise, returns
   // kWaitForSplit and sets a future that will complete when split becomes
   // available or no-more-splits signal is received.
+  /// Gets the next split for 'planNodeId' or a future that is realized
+  /// when one is added. If 'maxPreloadSplits' is positive, calls
+  /// 'preload' on up to that many of the splits that remain queued and
+  /// have no preloaded DataSource. If 'splitChunkBytes' is positive, a
+  /// split larger than that is divided, see ConnectorSplit::divide(). The
+  /// first part is returned and the rest is queued first for the next
+  /// caller, which may be an idle Driver of the same scan.
   BlockingReason getSplitOrFuture(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
       exec::Split& split,
-      ContinueFuture& future);
+      ContinueFuture& future,
+      int32_t maxPreloadSplits = 0,
+      std::function<void(std::shared_ptr<connector::ConnectorSplit>)>
+          preload = nullptr,
+      uint64_t splitChunkBytes = 0);
+
+  /// In grouped execution, keeps 'exprSet', compiled by an Operator of
+  /// 'planNodeId' with 'execCtx', for the Operator of the same plan node in
+  /// a later split group. Compiling the expressions of each Operator once per
+  /// split group would dominate the setup of small split groups.
+  void releaseExprSet(
+      const core::PlanNodeId& planNodeId,
+      std::unique_ptr<core::ExecCtx> execCtx,
+      std::unique_ptr<ExprSet> exprSet);
+
+  /// Returns expressions of 'planNodeId' from releaseExprSet() with the
+  /// ExecCtx they were compiled with, or nullptrs if there are none. May be
+  /// called from Operator constructors, which run under 'mutex_'.
+  std::pair<std::unique_ptr<core::ExecCtx>, std::unique_ptr<ExprSet>>
+  takeExprSet(const core::PlanNodeId& planNodeId);
+
+  /// Returns the filters added to TableScan 'scanNodeId' by
+  /// addDynamicFilters() after the first 'numSeen' and sets 'numSeen' to the
+  /// number added so far.
+  std::vector<std::pair<std::string, std::shared_ptr<common::Filter>>>
+  newDynamicFilters(const core::PlanNodeId& scanNodeId, size_t& numSeen);
+
+  /// Returns the connector splits for 'planNodeId' in 'splitGroupId' if all
+  /// of them have arrived and none has been given out yet, std::nullopt
+  /// otherwise.
+  std::optional<std::vector<std::shared_ptr<connector::ConnectorSplit>>>
+  pendingSplitsIfComplete(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId);
 
   void splitFinished();
 
@@ -311,6 +433,15 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
+  /// Returns the count of rows still to produce by the drivers of the
+  /// partial Limit 'planNodeId' in 'splitGroupId'. Makes it with 'count'
+  /// when the first driver is made. Called when making the Drivers, under
+  /// 'mutex_'.
+  std::shared_ptr<std::atomic<int64_t>> getSharedLimit(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId,
+      int64_t count);
+
   void createLocalExchangeQueuesLocked(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
@@ -442,6 +573,20 @@ class Task : public std::enable_shared_from_this<Task> {
 
   ContinueFuture requestPauseLocked(bool pause);
 
+  /// Frees memory held by the operators of 'this', e.g. by spilling, on
+  /// behalf of MemoryArbitrator. 'this' must be paused with all Drivers off
+  /// thread. Drivers stay paused until resume().
+  void reclaim();
+
+  /// Preempts 'self' to give its threads and memory to higher priority
+  /// work. Pauses the Drivers at their next operator boundary and waits up
+  /// to 'maxWaitMs' for them to go off thread. If they do, spills the
+  /// operators that support it, see reclaim(), and returns true. A failed
+  /// spill sets the error of 'self'. 'self' stays paused in either case
+  /// until resume(), after which the spilled operators read back their
+  /// state as part of producing their output.
+  static bool preempt(const std::shared_ptr<Task>& self, uint64_t maxWaitMs);
+
   // Requests activity of 'this' to stop. The returned future will be
   // realized when the last thread stops running for 'this'. This is used to
   // mark cancellation by the user.
@@ -484,10 +629,35 @@ class Task : public std::enable_shared_from_this<Task> {
       const core::PlanNodeId& planNodeId);
 
   /// Retrieve a split or split future from the given split store structure.
+  /// Sets 'promise' to the promise of a waiting Driver if the split is
+  /// divided.
   BlockingReason getSplitOrFutureLocked(
       SplitsStore& splitsStore,
       exec::Split& split,
-      ContinueFuture& future);
+      ContinueFuture& future,
+      int32_t maxPreloadSplits,
+      const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+          preload,
+      uint64_t splitChunkBytes,
+      std::unique_ptr<ContinuePromise>& promise);
+
+  /// Replaces 'splitsStore.splits[index]' with its first 'splitChunkBytes'
+  /// and queues the rest right after it. Returns false if the split is not
+  /// divided.
+  bool divideSplitLocked(
+      SplitsStore& splitsStore,
+      size_t index,
+      uint64_t splitChunkBytes);
+
+  /// Checks that 'self' can start and records the start time. Called by
+  /// start() before making 'driverFactories_'.
+  static void prepareStart(
+      std::shared_ptr<Task>& self,
+      uint32_t concurrentSplitGroups);
+
+  /// Sets up the pipelines of 'driverFactories_' and starts the Drivers of
+  /// ungrouped execution.
+  static void startPipelines(std::shared_ptr<Task>& self);
 
   /// Creates for the given split group and fills up the 'SplitGroupState'
   /// structure, which stores inter-operator state (local exchange, bridges).
@@ -506,6 +676,10 @@ class Task : public std::enable_shared_from_this<Task> {
   /// processed. If yes, creates split group state and Drivers and runs them.
   void ensureSplitGroupsAreBeingProcessedLocked(std::shared_ptr<Task>& self);
 
+  // Returns true if the query has the memory for one more split group, going
+  // by the memory of the running ones. Always true if none is running.
+  bool hasMemoryForSplitGroupLocked() const;
+
   void driverClosedLocked();
 
   /// Returns true if Task is in kRunning state, but all drivers finished
@@ -562,10 +736,6 @@ class Task : public std::enable_shared_from_this<Task> {
     return driverFactories_[pipelineId]->outputDriver;
   }
 
-  uint32_t numDrivers(int pipelineId) const {
-    return driverFactories_[pipelineId]->numDrivers;
-  }
-
   int getOutputPipelineId() const;
 
   // RAII helper class to satisfy 'stateChangePromises_' and notify listeners
@@ -608,6 +778,7 @@ class Task : public std::enable_shared_from_this<Task> {
   core::PlanFragment planFragment_;
   const int destination_;
   const std::shared_ptr<core::QueryCtx> queryCtx_;
+  const uint64_t traceId_;
 
   /// A set of IDs of leaf plan nodes that require splits. Used to check plan
   /// node IDs specified in split management methods.
@@ -681,9 +852,24 @@ class Task : public std::enable_shared_from_this<Task> {
   /// Stores separate splits state for each plan node.
   std::unordered_map<core::PlanNodeId, SplitsState> splitsStates_;
 
+  /// Filters from addDynamicFilters() by TableScan plan node id, in order of
+  /// arrival.
+  std::unordered_map<
+      core::PlanNodeId,
+      std::vector<std::pair<std::string, std::shared_ptr<common::Filter>>>>
+      remoteDynamicFilters_;
+
   std::vector<ContinuePromise> stateChangePromises_;
 
   TaskStats taskStats_;
+
+  // Counters for Driver scheduling on executor threads. Updated without
+  // 'mutex_' on every Driver run and copied into taskStats().
+  std::atomic<uint64_t> numDriverExecutorRuns_{0};
+  std::atomic<uint64_t> numDriverMigrations_{0};
+  std::atomic<uint64_t> numDriverCrossNodeMigrations_{0};
+  std::atomic<uint64_t> numDriverTimeSliceYields_{0};
+
   std::unique_ptr<memory::MemoryPool> pool_;
 
   // Keep driver and operator memory pools alive for the duration of the task to
@@ -694,6 +880,16 @@ class Task : public std::enable_shared_from_this<Task> {
   // allow for sharing data without copy.
   std::vector<std::shared_ptr<memory::MappedMemory>> childMappedMemories_;
 
+  // Expressions from releaseExprSet() by plan node id. Declared after the
+  // pools, which hold their memory. Guarded by 'exprSetsMutex_', since
+  // Operator constructors run under 'mutex_'.
+  std::mutex exprSetsMutex_;
+  std::unordered_map<
+      core::PlanNodeId,
+      std::vector<
+          std::pair<std::unique_ptr<core::ExecCtx>, std::unique_ptr<ExprSet>>>>
+      reusableExprSets_;
+
   /// Stores inter-operator state (exchange, bridges) per split group.
   /// During ungrouped execution we use the [0] entry in this vector.
   std::unordered_map<uint32_t, SplitGroupState> splitGroupStates_;
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/TaskProfile.h"
+
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+const char* stateName(TaskState state) {
+  switch (state) {
+    case kRunning:
+      return "running";
+    case kFinished:
+      return "finished";
+    case kCanceled:
+      return "canceled";
+    case kAborted:
+      return "aborted";
+    case kFailed:
+      return "failed";
+  }
+  return "unknown";
+}
+
+const char* unitName(RuntimeCounter::Unit unit) {
+  switch (unit) {
+    case RuntimeCounter::Unit::kNone:
+      return "none";
+    case RuntimeCounter::Unit::kNanos:
+      return "nanos";
+    case RuntimeCounter::Unit::kBytes:
+      return "bytes";
+  }
+  return "unknown";
+}
+
+folly::dynamic toJson(const CpuWallTiming& timing) {
+  return folly::dynamic::object("count", timing.count)(
+      "wallNanos", timing.wallNanos)("cpuNanos", timing.cpuNanos);
+}
+
+folly::dynamic quantilesJson(const RuntimeHistogram& histogram) {
+  return folly::dynamic::object("count", histogram.count())(
+      "p50", histogram.quantile(0.5))("p99", histogram.quantile(0.99))(
+      "p999", histogram.quantile(0.999));
+}
+
+folly::dynamic toJson(const RuntimeMetric& metric) {
+  auto result = folly::dynamic::object("unit", unitName(metric.unit))(
+      "sum", metric.sum)("count", metric.count)("min", metric.min)(
+      "max", metric.max);
+  if (metric.histogram.has_value()) {
+    result["histogram"] = quantilesJson(metric.histogram.value());
+  }
+  return result;
+}
+
+folly::dynamic toJson(const MemoryStats& stats) {
+  return folly::dynamic::object(
+      "userMemoryReservation", stats.userMemoryReservation)(
+      "systemMemoryReservation", stats.systemMemoryReservation)(
+      "peakUserMemoryReservation", stats.peakUserMemoryReservation)(
+      "peakSystemMemoryReservation", stats.peakSystemMemoryReservation)(
+      "peakTotalMemoryReservation", stats.peakTotalMemoryReservation)(
+      "numMemoryAllocations", stats.numMemoryAllocations)(
+      "allocatedBytes", stats.allocatedBytes);
+}
+
+folly::dynamic toJson(const OperatorStats& stats) {
+  auto result = folly::dynamic::object("operatorId", stats.operatorId)(
+      "planNodeId", stats.planNodeId)("operatorType", stats.operatorType)(
+      "numDrivers", stats.numDrivers)("numSplits", stats.numSplits)(
+      "rawInputBytes", stats.rawInputBytes)(
+      "rawInputPositions", stats.rawInputPositions)(
+      "inputBytes", stats.inputBytes)("inputPositions", stats.inputPositions)(
+      "inputVectors", stats.inputVectors)("outputBytes", stats.outputBytes)(
+      "outputPositions", stats.outputPositions)(
+      "outputVectors", stats.outputVectors)(
+      "physicalWrittenBytes", stats.physicalWrittenBytes)(
+      "addInputTiming", toJson(stats.addInputTiming))(
+      "getOutputTiming", toJson(stats.getOutputTiming))(
+      "finishTiming", toJson(stats.finishTiming))(
+      "blockedWallNanos", stats.blockedWallNanos)(
+      "blockedWallNanosHistogram",
+      quantilesJson(stats.blockedWallNanosHistogram))(
+      "memoryStats", toJson(stats.memoryStats))(
+      "spilledBytes", stats.spilledBytes)("spilledRows", stats.spilledRows);
+
+  const auto& perf = stats.perfEventCounts;
+  result["perfEventCounts"] = folly::dynamic::object("cycles", perf.cycles)(
+      "instructions", perf.instructions)("llcMisses", perf.llcMisses)(
+      "branchMisses", perf.branchMisses)("dtlbMisses", perf.dtlbMisses);
+
+  auto spillDirectories = folly::dynamic::object();
+  for (const auto& [directory, directoryStats] : stats.spillDirectoryStats) {
+    spillDirectories[directory] = folly::dynamic::object(
+        "writtenBytes", directoryStats.writtenBytes)(
+        "readBytes", directoryStats.readBytes);
+  }
+  result["spillDirectoryStats"] = std::move(spillDirectories);
+
+  auto runtimeStats = folly::dynamic::object();
+  for (const auto& [name, metric] : stats.runtimeStats) {
+    runtimeStats[name] = toJson(metric);
+  }
+  result["runtimeStats"] = std::move(runtimeStats);
+  return result;
+}
+
+folly::dynamic toJson(const memory::MemoryUsageSnapshot& snapshot) {
+  auto children = folly::dynamic::array();
+  for (const auto& child : snapshot.children) {
+    children.push_back(toJson(child));
+  }
+  return folly::dynamic::object("name", snapshot.name)(
+      "currentBytes", snapshot.currentBytes)("peakBytes", snapshot.peakBytes)(
+      "allocatedBytes", snapshot.allocatedBytes)(
+      "children", std::move(children));
+}
+
+} // namespace
+
+folly::dynamic makeTaskProfile(
+    const std::string& taskId,
+    const std::string& uuid,
+    TaskState state,
+    const std::string& error,
+    const TaskStats& stats,
+    const memory::MemoryUsageSnapshot& memory) {
+  auto pipelines = folly::dynamic::array();
+  for (const auto& pipeline : stats.pipelineStats) {
+    auto operators = folly::dynamic::array();
+    for (const auto& operatorStats : pipeline.operatorStats) {
+      operators.push_back(toJson(operatorStats));
+    }
+    pipelines.push_back(folly::dynamic::object(
+        "inputPipeline", pipeline.inputPipeline)(
+        "outputPipeline", pipeline.outputPipeline)(
+        "operators", std::move(operators)));
+  }
+
+  return folly::dynamic::object("version", kTaskProfileVersion)(
+      "taskId", taskId)("uuid", uuid)("state", stateName(state))(
+      "error", error)("numTotalSplits", stats.numTotalSplits)(
+      "numFinishedSplits", stats.numFinishedSplits)(
+      "executionStartTimeMs", stats.executionStartTimeMs)(
+      "executionEndTimeMs", stats.executionEndTimeMs)(
+      "firstSplitStartTimeMs", stats.firstSplitStartTimeMs)(
+      "lastSplitStartTimeMs", stats.lastSplitStartTimeMs)(
+      "endTimeMs", stats.endTimeMs)(
+      "numDriverExecutorRuns", stats.numDriverExecutorRuns)(
+      "numDriverMigrations", stats.numDriverMigrations)(
+      "numDriverCrossNodeMigrations", stats.numDriverCrossNodeMigrations)(
+      "numDriverTimeSliceYields", stats.numDriverTimeSliceYields)(
+      "pipelines", std::move(pipelines))("memory", toJson(memory));
+}
+
+// static
+TaskProfileStore& TaskProfileStore::instance() {
+  static TaskProfileStore store;
+  return store;
+}
+
+void TaskProfileStore::configure(
+    std::chrono::milliseconds ttl,
+    size_t maxProfiles) {
+  std::lock_guard<std::mutex> l(mutex_);
+  ttl_ = ttl;
+  maxProfiles_ = maxProfiles;
+  expireLocked(Clock::now());
+}
+
+void TaskProfileStore::add(const std::string& taskId, std::string profile) {
+  const auto now = Clock::now();
+  std::lock_guard<std::mutex> l(mutex_);
+  const auto sequence = nextSequence_++;
+  profiles_[taskId] = Entry{std::move(profile), now, sequence};
+  addOrder_.emplace_back(taskId, sequence);
+  expireLocked(now);
+}
+
+std::optional<std::string> TaskProfileStore::get(const std::string& taskId) {
+  std::lock_guard<std::mutex> l(mutex_);
+  expireLocked(Clock::now());
+  auto it = profiles_.find(taskId);
+  if (it == profiles_.end()) {
+    return std::nullopt;
+  }
+  return it->second.profile;
+}
+
+void TaskProfileStore::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  profiles_.clear();
+  addOrder_.clear();
+}
+
+size_t TaskProfileStore::size() {
+  std::lock_guard<std::mutex> l(mutex_);
+  expireLocked(Clock::now());
+  return profiles_.size();
+}
+
+void TaskProfileStore::expireLocked(Clock::time_point now) {
+  while (!addOrder_.empty()) {
+    const auto& [taskId, sequence] = addOrder_.front();
+    auto it = profiles_.find(taskId);
+    const bool stale =
+        it == profiles_.end() || it->second.sequence != sequence;
+    if (!stale && it->second.addTime + ttl_ > now &&
+        profiles_.size() <= maxProfiles_) {
+      break;
+    }
+    if (!stale) {
+      profiles_.erase(it);
+    }
+    addOrder_.pop_front();
+  }
+}
+
+} // namespace facebook::velox::exec
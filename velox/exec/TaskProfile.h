@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+#include <folly/dynamic.h>
+
+#include "velox/common/memory/MemoryUsageTracker.h"
+#include "velox/exec/TaskStats.h"
+#include "velox/exec/TaskStructs.h"
+
+namespace facebook::velox::exec {
+
+/// Version of the layout of the profiles returned by makeTaskProfile().
+/// Fields may be added within a version. Renaming or removing a field bumps
+/// the version.
+constexpr int32_t kTaskProfileVersion = 1;
+
+/// Returns the profile of a Task as a JSON object with:
+///  - version, taskId, uuid, state and error;
+///  - the split counts, the execution and split start times and the
+///    DriverExecutor counters of 'stats';
+///  - per pipeline, the OperatorStats of each operator: rows, bytes, CPU and
+///    wall timings, blocked time with its p50, p99 and p999, perf event
+///    counts, memory peaks, spill by directory and the runtime stats with
+///    their quantiles if they have a histogram. The cache hits of scans are
+///    the storageReadBytes, localReadBytes and ramReadBytes runtime stats;
+///  - 'memory', the current and peak bytes of the memory pools of the Task
+///    by pipeline and operator, see Task::memoryUsageSnapshot().
+folly::dynamic makeTaskProfile(
+    const std::string& taskId,
+    const std::string& uuid,
+    TaskState state,
+    const std::string& error,
+    const TaskStats& stats,
+    const memory::MemoryUsageSnapshot& memory);
+
+/// Keeps the serialized profiles of completed Tasks for 'ttl' after their
+/// completion so that they can be fetched after the Task is gone, e.g. by a
+/// coordinator that polls the worker. Tasks add their profile on completion
+/// if the task_profile_enabled query config is set. There are at most
+/// 'maxProfiles' profiles. The oldest are dropped first. Thread safe.
+class TaskProfileStore {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr std::chrono::milliseconds kDefaultTtl{10 * 60 * 1'000};
+  static constexpr size_t kDefaultMaxProfiles = 1'000;
+
+  TaskProfileStore(
+      std::chrono::milliseconds ttl = kDefaultTtl,
+      size_t maxProfiles = kDefaultMaxProfiles)
+      : ttl_(ttl), maxProfiles_(maxProfiles) {}
+
+  /// The process-wide store Tasks add their profiles to.
+  static TaskProfileStore& instance();
+
+  /// Changes the TTL and the maximum number of profiles. Applies to the
+  /// profiles already in 'this'.
+  void configure(std::chrono::milliseconds ttl, size_t maxProfiles);
+
+  /// Adds or replaces the profile of 'taskId'.
+  void add(const std::string& taskId, std::string profile);
+
+  /// Returns the profile of 'taskId' or std::nullopt if there is none or it
+  /// has expired.
+  std::optional<std::string> get(const std::string& taskId);
+
+  /// Removes all profiles.
+  void clear();
+
+  /// Returns the number of profiles that have not expired.
+  size_t size();
+
+ private:
+  struct Entry {
+    std::string profile;
+    Clock::time_point addTime;
+    // Distinguishes the adds of the same task.
+    uint64_t sequence;
+  };
+
+  // Drops the expired profiles and the oldest ones above 'maxProfiles_'.
+  void expireLocked(Clock::time_point now);
+
+  std::mutex mutex_;
+  std::chrono::milliseconds ttl_;
+  size_t maxProfiles_;
+  uint64_t nextSequence_{0};
+  std::unordered_map<std::string, Entry> profiles_;
+  // Task ids and sequence numbers in add order. An element is stale if the
+  // profile of the task was replaced after it was added.
+  std::deque<std::pair<std::string, uint64_t>> addOrder_;
+};
+
+} // namespace facebook::velox::exec
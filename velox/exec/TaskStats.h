@@ -44,6 +44,9 @@ struct TaskStats {
   int32_t numFinishedSplits{0};
   int32_t numRunningSplits{0};
   int32_t numQueuedSplits{0};
+  // Number of splits made by dividing table scan splits. These are included
+  // in the above. See QueryConfig::kTableScanSplitChunkBytes.
+  int32_t numDividedSplits{0};
   std::unordered_set<int32_t> completedSplitGroups;
 
   // The subscript is given by each Operator's
@@ -67,5 +70,20 @@ struct TaskStats {
   // Epoch time (ms) when the task completed, e.g. all splits were processed and
   // results have been consumed.
   uint64_t endTimeMs{0};
+
+  // Number of times a Driver of the task started running on a DriverExecutor
+  // worker.
+  uint64_t numDriverExecutorRuns{0};
+
+  // Number of those runs on a different worker than the previous run of the
+  // same Driver.
+  uint64_t numDriverMigrations{0};
+
+  // Number of migrations to a worker on a different NUMA node.
+  uint64_t numDriverCrossNodeMigrations{0};
+
+  // Number of times a Driver of the task yielded its thread at the end of its
+  // CPU time slice.
+  uint64_t numDriverTimeSliceYields{0};
 };
 } // namespace facebook::velox::exec
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <atomic>
 #include <limits>
 #include <unordered_set>
 #include <vector>
@@ -45,6 +46,8 @@ struct SplitsStore {
   bool noMoreSplits{false};
   /// Blocking promises given out when out of splits to distribute.
   std::vector<ContinuePromise> splitPromises;
+  /// True once a split has been given out.
+  bool splitsTaken{false};
 };
 
 /// Structure contains the current info on splits for a particular plan node.
@@ -90,6 +93,11 @@ struct SplitGroupState {
   /// Map of local exchanges keyed on LocalPartition plan node ID.
   std::unordered_map<core::PlanNodeId, LocalExchangeState> localExchanges;
 
+  /// Rows still to produce by all drivers of a partial Limit, keyed on
+  /// LimitNode plan node ID.
+  std::unordered_map<core::PlanNodeId, std::shared_ptr<std::atomic<int64_t>>>
+      limits;
+
   /// Drivers created and still running for this split group.
   /// The split group is finished when this numbers reaches zero.
   uint32_t numRunningDrivers{0};
@@ -108,6 +116,7 @@ struct SplitGroupState {
     localMergeSources.clear();
     mergeJoinSources.clear();
     localExchanges.clear();
+    limits.clear();
   }
 };
 
@@ -16,8 +16,28 @@
 #include "velox/exec/TopN.h"
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/vector/FlatVector.h"
+#include "velox/vector/LazyVector.h"
 
 namespace facebook::velox::exec {
+namespace {
+// Calls 'func' with a value of the native type of the integer 'kind'.
+template <typename F>
+void dispatchIntegerKind(TypeKind kind, F func) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return func(int8_t{});
+    case TypeKind::SMALLINT:
+      return func(int16_t{});
+    case TypeKind::INTEGER:
+      return func(int32_t{});
+    case TypeKind::BIGINT:
+      return func(int64_t{});
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+} // namespace
+
 TopN::TopN(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -37,8 +57,26 @@ TopN::TopN(
           topNNode->sortingKeys(),
           topNNode->sortingOrders(),
           data_.get()),
-      topRows_(comparator_),
-      decodedVectors_(outputType_->children().size()) {}
+      decodedVectors_(outputType_->children().size()),
+      isKey_(outputType_->size(), false) {
+  const auto& keyInfo = comparator_.keyInfo();
+  for (const auto& key : keyInfo) {
+    isKey_[key.first] = true;
+  }
+  if (!keyInfo.empty()) {
+    auto kind = outputType_->childAt(keyInfo[0].first)->kind();
+    switch (kind) {
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+        cutoffKind_ = kind;
+        break;
+      default:
+        break;
+    }
+  }
+}
 
 TopN::Comparator::Comparator(
     const std::shared_ptr<const RowType>& type,
@@ -57,25 +95,147 @@ TopN::Comparator::Comparator(
   }
 }
 
+std::vector<PrefixSort::SortKey> TopN::Comparator::sortKeys() const {
+  std::vector<PrefixSort::SortKey> keys;
+  keys.reserve(keyInfo_.size());
+  for (const auto& [channel, order] : keyInfo_) {
+    keys.emplace_back(
+        channel,
+        CompareFlags{order.isNullsFirst(), order.isAscending(), false});
+  }
+  return keys;
+}
+
+template <typename T>
+void TopN::applyCutoff(SelectivityVector& rows) {
+  const auto& [channel, order] = comparator_.keyInfo()[0];
+  const auto column = data_->columnAt(channel);
+  const char* topRow = topRows_.front();
+  const auto& decoded = decodedVectors_[channel];
+  const auto numRows = rows.size();
+
+  if (RowContainer::isNullAt(topRow, column.nullByte(), column.nullMask())) {
+    // Only nulls can replace a null heap top if nulls sort first. If nulls
+    // sort last, all rows can.
+    if (order.isNullsFirst()) {
+      for (auto row = 0; row < numRows; ++row) {
+        rows.setValid(row, decoded.isNullAt(row));
+      }
+      rows.updateBounds();
+    }
+    return;
+  }
+
+  const T cutoff = RowContainer::valueAt<T>(topRow, column.offset());
+  const bool ascending = order.isAscending();
+  if (decoded.isConstantMapping()) {
+    const bool pass = decoded.isNullAt(0)
+        ? order.isNullsFirst()
+        : (ascending ? decoded.valueAt<T>(0) <= cutoff
+                     : decoded.valueAt<T>(0) >= cutoff);
+    if (!pass) {
+      rows.clearAll();
+    }
+    return;
+  }
+
+  // Rows that tie with the heap top stay and are compared on all keys.
+  auto* bits = rows.asMutableRange().bits();
+  auto filter = [&](auto passes) {
+    for (vector_size_t i = 0; i < numRows; i += 64) {
+      const auto end = std::min<vector_size_t>(64, numRows - i);
+      uint64_t word = 0;
+      for (auto j = 0; j < end; ++j) {
+        word |= static_cast<uint64_t>(passes(decoded.valueAt<T>(i + j))) << j;
+      }
+      bits[i / 64] &= word;
+    }
+  };
+  if (ascending) {
+    filter([cutoff](T value) { return value <= cutoff; });
+  } else {
+    filter([cutoff](T value) { return value >= cutoff; });
+  }
+  if (decoded.mayHaveNulls()) {
+    for (auto row = 0; row < numRows; ++row) {
+      if (decoded.isNullAt(row)) {
+        rows.setValid(row, order.isNullsFirst());
+      }
+    }
+  }
+  rows.updateBounds();
+}
+
+template <typename T>
+void TopN::pushdownCutoff() {
+  const auto& [channel, order] = comparator_.keyInfo()[0];
+  const auto column = data_->columnAt(channel);
+  const char* topRow = topRows_.front();
+  if (RowContainer::isNullAt(topRow, column.nullByte(), column.nullMask())) {
+    return;
+  }
+  const int64_t cutoff = RowContainer::valueAt<T>(topRow, column.offset());
+  if (pushedCutoff_ == cutoff) {
+    return;
+  }
+  pushedCutoff_ = cutoff;
+  // Nulls pass if they sort first. The filter is merged with the ones pushed
+  // down before, which are all wider.
+  dynamicFilters_[channel] = order.isAscending()
+      ? std::make_shared<common::BigintRange>(
+            std::numeric_limits<int64_t>::min(), cutoff, order.isNullsFirst())
+      : std::make_shared<common::BigintRange>(
+            cutoff, std::numeric_limits<int64_t>::max(), order.isNullsFirst());
+}
+
 void TopN::addInput(RowVectorPtr input) {
-  SelectivityVector allRows(input->size());
+  const auto numInput = input->size();
+  SelectivityVector allRows(numInput);
 
-  // TODO Decode keys first, then decode the rest only for passing positions
+  // Decode the keys first, then the rest only for the rows that pass the
+  // cutoff.
   for (int col = 0; col < input->childrenSize(); ++col) {
-    decodedVectors_[col].decode(*input->childAt(col), allRows);
+    if (isKey_[col]) {
+      decodedVectors_[col].decode(*input->childAt(col), allRows);
+    }
   }
 
-  for (int row = 0; row < input->size(); ++row) {
+  candidates_.resizeFill(numInput, true);
+  const bool heapFull = !topRows_.empty() && topRows_.size() >= count_;
+  if (heapFull && cutoffKind_.has_value()) {
+    dispatchIntegerKind(*cutoffKind_, [&](auto value) {
+      applyCutoff<decltype(value)>(candidates_);
+    });
+    const auto numCandidates = candidates_.countSelected();
+    if (numCandidates < numInput) {
+      stats().addRuntimeStat(
+          "numCutoffRows", RuntimeCounter(numInput - numCandidates));
+    }
+    if (numCandidates == 0) {
+      return;
+    }
+  }
+
+  for (int col = 0; col < input->childrenSize(); ++col) {
+    if (!isKey_[col]) {
+      // Loads LazyVectors only for the rows that passed the cutoff.
+      LazyVector::ensureLoadedRows(input->childAt(col), candidates_);
+      decodedVectors_[col].decode(*input->childAt(col), candidates_);
+    }
+  }
+
+  candidates_.applyToSelected([&](auto row) {
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
       newRow = data_->newRow();
     } else {
-      char* topRow = topRows_.top();
+      char* topRow = topRows_.front();
 
       if (comparator_(topRow, decodedVectors_, row)) {
-        continue;
+        return;
       }
-      topRows_.pop();
+      std::pop_heap(topRows_.begin(), topRows_.end(), std::ref(comparator_));
+      topRows_.pop_back();
       // Reuse the topRow's memory.
       newRow = data_->initializeRow(topRow, true /* reuse */);
     }
@@ -84,7 +244,23 @@ void TopN::addInput(RowVectorPtr input) {
       data_->store(decodedVectors_[col], row, newRow, col);
     }
 
-    topRows_.push(newRow);
+    topRows_.push_back(newRow);
+    std::push_heap(topRows_.begin(), topRows_.end(), std::ref(comparator_));
+  });
+
+  if (cutoffKind_.has_value() && !topRows_.empty() &&
+      topRows_.size() >= count_) {
+    if (!canPushdownCutoff_.has_value()) {
+      auto* driver = operatorCtx_->driverCtx()->driver;
+      canPushdownCutoff_ =
+          !driver->canPushdownFilters(this, {comparator_.keyInfo()[0].first})
+               .empty();
+    }
+    if (canPushdownCutoff_.value()) {
+      dispatchIntegerKind(*cutoffKind_, [&](auto value) {
+        pushdownCutoff<decltype(value)>();
+      });
+    }
   }
 }
 
@@ -118,11 +294,11 @@ void TopN::noMoreInput() {
     finished_ = true;
     return;
   }
-  rows_.resize(topRows_.size());
-  for (int i = rows_.size(); i > 0; --i) {
-    rows_[i - 1] = topRows_.top();
-    topRows_.pop();
-  }
+  rows_ = std::move(topRows_);
+  PrefixSort::sort(
+      *data_,
+      comparator_.sortKeys(),
+      folly::Range<char**>(rows_.data(), rows_.size()));
 }
 
 bool TopN::isFinished() {
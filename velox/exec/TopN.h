@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/exec/Operator.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/RowContainer.h"
 
 namespace facebook::velox::exec {
@@ -89,6 +90,14 @@ class TopN : public Operator {
       return false;
     }
 
+    // Returns the sort keys for PrefixSort.
+    std::vector<PrefixSort::SortKey> sortKeys() const;
+
+    const std::vector<std::pair<column_index_t, core::SortOrder>>& keyInfo()
+        const {
+      return keyInfo_;
+    }
+
    private:
     std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
     RowContainer* rowContainer_;
@@ -99,20 +108,49 @@ class TopN : public Operator {
   bool finished_ = false;
   uint32_t numRowsReturned_ = 0;
 
-  // As the inputs are added to TopN operator, we use topRows_ (a priority
-  // queue) to keep track of the pointers to rows stored in the
-  // RowContainer (data_). We only update the RowContainer if a row is a
-  // candidate for top rows. Otherwise, we will discard the row.
-  // Since we use a priority queue for TopN, we perform
-  // O(total_rows * logN) comparisons and require O(N) space.
-  // Once all inputs are available, we copy the final set of rows to the
-  // vector (rows_) in correct order. We use this vector along with the
-  // RowContainer to generate the TopN's output.
+  // As the inputs are added to TopN operator, we use topRows_ (a max heap)
+  // to keep track of the pointers to rows stored in the RowContainer
+  // (data_). We only update the RowContainer if a row is a candidate for top
+  // rows. Otherwise, we will discard the row.
+  // Since we use a heap for TopN, we perform O(total_rows * logN)
+  // comparisons and require O(N) space.
+  // Once all inputs are available, we move the final set of rows to the
+  // vector (rows_) and sort them with PrefixSort. We use this vector along
+  // with the RowContainer to generate the TopN's output.
   std::unique_ptr<RowContainer> data_;
   Comparator comparator_;
-  std::priority_queue<char*, std::vector<char*>, Comparator> topRows_;
+  std::vector<char*> topRows_;
   std::vector<char*> rows_;
 
+  // Deselects from 'rows' the rows of the input whose first sorting key
+  // sorts after the first key of the heap top. These cannot enter the heap.
+  // T is the type of the first key.
+  template <typename T>
+  void applyCutoff(SelectivityVector& rows);
+
+  // Sets a dynamic filter on the first key that passes the values that are
+  // not cut off with the current heap top. Called when the heap is full.
+  template <typename T>
+  void pushdownCutoff();
+
   std::vector<DecodedVector> decodedVectors_;
+
+  // True for the columns that are sorting keys. These are decoded for all
+  // input rows, the other columns only for the rows that pass the cutoff.
+  std::vector<bool> isKey_;
+
+  // Kind of the first sorting key if it is an integer, in which case input
+  // rows are compared with the heap top on this key in a vectorized loop
+  // before being compared row by row. Otherwise, std::nullopt.
+  std::optional<TypeKind> cutoffKind_;
+
+  // True if the cutoff can be pushed down as a dynamic filter into the source
+  // of the pipeline, e.g. TableScan. Set the first time the heap is full.
+  std::optional<bool> canPushdownCutoff_;
+
+  // The first key of the heap top when the cutoff was pushed down last.
+  std::optional<int64_t> pushedCutoff_;
+
+  SelectivityVector candidates_;
 };
 } // namespace facebook::velox::exec
@@ -140,6 +140,33 @@ class TreeOfLosers {
     ;
   }
 
+  // Returns the stream with the lowest first element like next() and the
+  // runner-up, the stream with the lowest first element among the others,
+  // or nullptr if the others are at end. The caller may pop off all the
+  // elements of the first stream that are not greater than the first element
+  // of the runner-up before calling this again, e.g. copy a run of rows that
+  // does not overlap the other streams at once. next() and
+  // nextWithRunnerUp() may be mixed. Returns {nullptr, nullptr} when all
+  // streams are at end.
+  std::pair<Stream*, Stream*> nextWithRunnerUp() {
+    auto* stream = next();
+    if (!stream) {
+      return {nullptr, nullptr};
+    }
+    // The runner-up lost to the winner in one of the nodes on the path from
+    // the winner's leaf to the root.
+    auto runnerUp = kEmpty;
+    for (auto node = firstStream_ + lastIndex_; node != 0;) {
+      node = parent(node);
+      const auto loser = values_[node];
+      if (loser != kEmpty &&
+          (runnerUp == kEmpty || *streams_[loser] < *streams_[runnerUp])) {
+        runnerUp = loser;
+      }
+    }
+    return {stream, runnerUp == kEmpty ? nullptr : streams_[runnerUp].get()};
+  }
+
  private:
   static constexpr TIndex kEmpty = std::numeric_limits<TIndex>::max();
 
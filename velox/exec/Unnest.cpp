@@ -30,6 +30,7 @@ Unnest::Unnest(
           operatorId,
           unnestNode->id(),
           "Unnest"),
+      outputBatchSize_(outputBatchRows()),
       withOrdinality_(unnestNode->withOrdinality()) {
   const auto& inputType = unnestNode->sources()[0]->outputType();
   const auto& unnestVariables = unnestNode->unnestVariables();
@@ -41,6 +42,9 @@ Unnest::Unnest(
   }
 
   unnestDecoded_.resize(unnestVariables.size());
+  rawSizes_.resize(unnestVariables.size());
+  rawOffsets_.resize(unnestVariables.size());
+  rawIndices_.resize(unnestVariables.size());
 
   if (withOrdinality_) {
     VELOX_CHECK_EQ(
@@ -58,69 +62,83 @@ Unnest::Unnest(
 
 void Unnest::addInput(RowVectorPtr input) {
   input_ = std::move(input);
-}
-
-RowVectorPtr Unnest::getOutput() {
-  if (!input_) {
-    return nullptr;
-  }
+  nextInputRow_ = 0;
+  nextElement_ = 0;
 
   auto size = input_->size();
   inputRows_.resize(size);
 
-  // The max number of elements at each row across all unnested columns.
-  auto maxSizes = AlignedBuffer::allocate<int64_t>(size, pool(), 0);
-  auto rawMaxSizes = maxSizes->asMutable<int64_t>();
-
-  std::vector<const vector_size_t*> rawSizes;
-  std::vector<const vector_size_t*> rawOffsets;
-  std::vector<const vector_size_t*> rawIndices;
-
-  rawSizes.resize(unnestChannels_.size());
-  rawOffsets.resize(unnestChannels_.size());
-  rawIndices.resize(unnestChannels_.size());
+  maxSizes_ = AlignedBuffer::allocate<vector_size_t>(size, pool(), 0);
+  rawMaxSizes_ = maxSizes_->asMutable<vector_size_t>();
 
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     const auto& unnestVector = input_->childAt(unnestChannels_[channel]);
     unnestDecoded_[channel].decode(*unnestVector, inputRows_);
 
     auto& currentDecoded = unnestDecoded_[channel];
-    rawIndices[channel] = currentDecoded.indices();
+    rawIndices_[channel] = currentDecoded.indices();
 
-    const ArrayVector* unnestBaseArray;
-    const MapVector* unnestBaseMap;
     if (unnestVector->typeKind() == TypeKind::ARRAY) {
-      unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      rawSizes[channel] = unnestBaseArray->rawSizes();
-      rawOffsets[channel] = unnestBaseArray->rawOffsets();
+      auto unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
+      rawSizes_[channel] = unnestBaseArray->rawSizes();
+      rawOffsets_[channel] = unnestBaseArray->rawOffsets();
     } else {
       VELOX_CHECK(unnestVector->typeKind() == TypeKind::MAP);
-      unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      rawSizes[channel] = unnestBaseMap->rawSizes();
-      rawOffsets[channel] = unnestBaseMap->rawOffsets();
+      auto unnestBaseMap = currentDecoded.base()->as<MapVector>();
+      rawSizes_[channel] = unnestBaseMap->rawSizes();
+      rawOffsets_[channel] = unnestBaseMap->rawOffsets();
     }
 
     // Count max number of elements per row.
-    auto currentSizes = rawSizes[channel];
-    auto currentIndices = rawIndices[channel];
+    auto currentSizes = rawSizes_[channel];
+    auto currentIndices = rawIndices_[channel];
     for (auto row = 0; row < size; ++row) {
       if (!currentDecoded.isNullAt(row)) {
         auto unnestSize = currentSizes[currentIndices[row]];
-        if (rawMaxSizes[row] < unnestSize) {
-          rawMaxSizes[row] = unnestSize;
+        if (rawMaxSizes_[row] < unnestSize) {
+          rawMaxSizes_[row] = unnestSize;
         }
       }
     }
   }
+}
+
+std::pair<vector_size_t, vector_size_t> Unnest::elementRange(
+    vector_size_t row,
+    vector_size_t endRow,
+    vector_size_t endElement) const {
+  return {
+      row == nextInputRow_ ? nextElement_ : 0,
+      row == endRow ? endElement : rawMaxSizes_[row]};
+}
+
+RowVectorPtr Unnest::getOutput() {
+  if (!input_) {
+    return nullptr;
+  }
+
+  auto size = input_->size();
 
-  // Calculate the number of rows in the unnest result.
-  int numElements = 0;
-  for (auto row = 0; row < size; ++row) {
-    numElements += rawMaxSizes[row];
+  // Find the end of the output batch. It ends before element 'endElement' of
+  // row 'endRow'.
+  vector_size_t numElements = 0;
+  auto endRow = nextInputRow_;
+  auto endElement = nextElement_;
+  while (endRow < size && numElements < outputBatchSize_) {
+    auto numRowElements = std::min(
+        rawMaxSizes_[endRow] - endElement, outputBatchSize_ - numElements);
+    numElements += numRowElements;
+    endElement += numRowElements;
+    if (endElement == rawMaxSizes_[endRow]) {
+      ++endRow;
+      endElement = 0;
+    }
   }
+  // The last row with elements in the output batch.
+  auto lastRow = endElement > 0 ? endRow : endRow - 1;
 
   if (numElements == 0) {
-    // All arrays/maps are null or empty.
+    // All remaining arrays/maps are null or empty.
     input_ = nullptr;
     return nullptr;
   }
@@ -130,10 +148,13 @@ RowVectorPtr Unnest::getOutput() {
   auto repeatedIndices = allocateIndices(numElements, pool());
   auto* rawRepeatedIndices = repeatedIndices->asMutable<vector_size_t>();
   vector_size_t index = 0;
-  for (auto row = 0; row < size; ++row) {
-    for (auto i = 0; i < rawMaxSizes[row]; i++) {
-      rawRepeatedIndices[index++] = row;
-    }
+  for (auto row = nextInputRow_; row <= lastRow; ++row) {
+    auto [begin, end] = elementRange(row, endRow, endElement);
+    std::fill(
+        rawRepeatedIndices + index,
+        rawRepeatedIndices + index + end - begin,
+        row);
+    index += end - begin;
   }
 
   // Wrap "replicated" columns in a dictionary using 'repeatedIndices'.
@@ -147,9 +168,9 @@ RowVectorPtr Unnest::getOutput() {
   vector_size_t outputsIndex = identityProjections_.size();
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     auto& currentDecoded = unnestDecoded_[channel];
-    auto currentSizes = rawSizes[channel];
-    auto currentOffsets = rawOffsets[channel];
-    auto currentIndices = rawIndices[channel];
+    auto currentSizes = rawSizes_[channel];
+    auto currentOffsets = rawOffsets_[channel];
+    auto currentIndices = rawIndices_[channel];
 
     BufferPtr elementIndices = allocateIndices(numElements, pool());
     auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
@@ -158,59 +179,54 @@ RowVectorPtr Unnest::getOutput() {
         AlignedBuffer::allocate<bool>(numElements, pool(), bits::kNotNull);
     auto rawNulls = nulls->asMutable<uint64_t>();
 
-    // Make dictionary index for elements column since they may be out of order.
+    // Make dictionary index for elements column since they may be out of
+    // order. If the batch starts at the first element and has no gaps, the
+    // elements are returned as is.
     index = 0;
     bool identityMapping = true;
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
+    for (auto row = nextInputRow_; row <= lastRow; ++row) {
+      auto [begin, end] = elementRange(row, endRow, endElement);
 
       if (!currentDecoded.isNullAt(row)) {
         auto offset = currentOffsets[currentIndices[row]];
         auto unnestSize = currentSizes[currentIndices[row]];
 
-        if (index != offset || unnestSize < maxSize) {
+        if (index != offset + begin || unnestSize < end) {
           identityMapping = false;
         }
 
-        for (auto i = 0; i < unnestSize; i++) {
+        for (auto i = begin; i < std::min(unnestSize, end); i++) {
           rawElementIndices[index++] = offset + i;
         }
 
-        for (auto i = unnestSize; i < maxSize; ++i) {
+        for (auto i = std::max(unnestSize, begin); i < end; ++i) {
           bits::setNull(rawNulls, index++, true);
         }
-      } else if (maxSize > 0) {
+      } else if (end > begin) {
         identityMapping = false;
 
-        for (auto i = 0; i < maxSize; ++i) {
+        for (auto i = begin; i < end; ++i) {
           bits::setNull(rawNulls, index++, true);
         }
       }
     }
 
+    auto wrapElements = [&](const VectorPtr& elements) {
+      return identityMapping
+          ? elements
+          : wrapChild(numElements, elementIndices, elements, nulls);
+    };
     if (currentDecoded.base()->typeKind() == TypeKind::ARRAY) {
       // Construct unnest column using Array elements wrapped using above
       // created dictionary.
       auto unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseArray->elements()
-          : wrapChild(
-                numElements,
-                elementIndices,
-                unnestBaseArray->elements(),
-                nulls);
+      outputs[outputsIndex++] = wrapElements(unnestBaseArray->elements());
     } else {
       // Construct two unnest columns for Map keys and values vectors wrapped
       // using above created dictionary.
       auto unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapKeys()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapKeys(), nulls);
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapValues()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapValues(), nulls);
+      outputs[outputsIndex++] = wrapElements(unnestBaseMap->mapKeys());
+      outputs[outputsIndex++] = wrapElements(unnestBaseMap->mapValues());
     }
   }
 
@@ -221,19 +237,25 @@ RowVectorPtr Unnest::getOutput() {
     // Set the ordinality at each result row to be the index of the element in
     // the original array (or map) plus one.
     auto rawOrdinality = ordinalityVector->mutableRawValues();
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
-      std::iota(rawOrdinality, rawOrdinality + maxSize, 1);
-      rawOrdinality += maxSize;
+    for (auto row = nextInputRow_; row <= lastRow; ++row) {
+      auto [begin, end] = elementRange(row, endRow, endElement);
+      std::iota(rawOrdinality, rawOrdinality + end - begin, begin + 1);
+      rawOrdinality += end - begin;
     }
 
     // Ordinality column is always at the end.
     outputs.back() = std::move(ordinalityVector);
   }
 
-  input_ = nullptr;
-  return std::make_shared<RowVector>(
+  nextInputRow_ = endRow;
+  nextElement_ = endElement;
+  if (nextInputRow_ == size) {
+    input_ = nullptr;
+  }
+  auto output = std::make_shared<RowVector>(
       pool(), outputType_, BufferPtr(nullptr), numElements, std::move(outputs));
+  outputBatchSize_ = outputBatchRows(averageRowSize(*output));
+  return output;
 }
 
 bool Unnest::isFinished() {
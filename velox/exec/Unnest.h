@@ -29,21 +29,50 @@ class Unnest : public Operator {
   }
 
   bool needsInput() const override {
-    return true;
+    return !input_;
   }
 
   void addInput(RowVectorPtr input) override;
 
+  // Returns up to 'outputBatchSize_' rows. The elements of one input row may
+  // be split across output batches.
   RowVectorPtr getOutput() override;
 
   bool isFinished() override;
 
  private:
+  // Returns the range of elements of 'row' in the output batch that ends
+  // before element 'endElement' of 'endRow'.
+  std::pair<vector_size_t, vector_size_t> elementRange(
+      vector_size_t row,
+      vector_size_t endRow,
+      vector_size_t endElement) const;
+
+  // Max number of output rows per batch. Adapted to the width of the output
+  // rows after each batch.
+  vector_size_t outputBatchSize_;
+
   std::vector<column_index_t> unnestChannels_;
 
   SelectivityVector inputRows_;
   std::vector<DecodedVector> unnestDecoded_;
 
   const bool withOrdinality_;
+
+  // The sizes, offsets and decoded indices of the arrays or maps of each
+  // unnested column of 'input_'.
+  std::vector<const vector_size_t*> rawSizes_;
+  std::vector<const vector_size_t*> rawOffsets_;
+  std::vector<const vector_size_t*> rawIndices_;
+
+  // The max number of elements at each row of 'input_' across all unnested
+  // columns.
+  BufferPtr maxSizes_;
+  vector_size_t* rawMaxSizes_{nullptr};
+
+  // The row of 'input_' and the element in the row to start the next output
+  // batch at.
+  vector_size_t nextInputRow_{0};
+  vector_size_t nextElement_{0};
 };
 } // namespace facebook::velox::exec
@@ -68,6 +68,31 @@ uint64_t hashOne(DecodedVector& decoded, vector_size_t index) {
   using T = typename KindToFlatVector<Kind>::HashRowType;
   return folly::hasher<T>()(decoded.valueAt<T>(index));
 }
+
+// Returns true if 'values' is a dictionary over the same base vector as at
+// the previous call with 'dictionary'. Otherwise sets 'dictionary' to the
+// base of 'values' and returns false. 'decoded' is 'values' decoded. The
+// reference in 'dictionary' keeps the producer of 'values' from reusing the
+// base in place.
+bool sameDictionary(
+    const BaseVector& values,
+    const DecodedVector& decoded,
+    VectorPtr& dictionary) {
+  if (values.encoding() != VectorEncoding::Simple::DICTIONARY) {
+    dictionary = nullptr;
+    return false;
+  }
+  auto base = values.valueVector();
+  if (base.get() != decoded.base()) {
+    dictionary = nullptr;
+    return false;
+  }
+  if (base == dictionary) {
+    return true;
+  }
+  dictionary = base;
+  return false;
+}
 } // namespace
 
 template <TypeKind Kind>
@@ -93,8 +118,6 @@ void VectorHasher::hashValues(
       result[row] = mix ? bits::hashMix(result[row], hash) : hash;
     });
   } else {
-    cachedHashes_.resize(decoded_.base()->size());
-    std::fill(cachedHashes_.begin(), cachedHashes_.end(), kNullHash);
     rows.applyToSelected([&](vector_size_t row) {
       if (decoded_.isNullAt(row)) {
         result[row] = mix ? bits::hashMix(result[row], kNullHash) : kNullHash;
@@ -246,9 +269,6 @@ template <typename T, bool mayHaveNulls>
 bool VectorHasher::makeValueIdsDecoded(
     const SelectivityVector& rows,
     uint64_t* result) {
-  cachedHashes_.resize(decoded_.base()->size());
-  std::fill(cachedHashes_.begin(), cachedHashes_.end(), 0);
-
   auto indices = decoded_.indices();
   auto values = decoded_.data<T>();
 
@@ -263,7 +283,7 @@ bool VectorHasher::makeValueIdsDecoded(
       }
     }
     auto baseIndex = indices[row];
-    uint64_t id = cachedHashes_[baseIndex];
+    uint64_t id = dictionaryIds_[baseIndex];
     if (id == 0) {
       T value = values[baseIndex];
 
@@ -279,7 +299,7 @@ bool VectorHasher::makeValueIdsDecoded(
         success = false;
         return;
       }
-      cachedHashes_[baseIndex] = id;
+      dictionaryIds_[baseIndex] = id;
     }
     result[row] = multiplier_ == 1 ? id : result[row] + multiplier_ * id;
   });
@@ -328,6 +348,11 @@ bool VectorHasher::computeValueIds(
     const SelectivityVector& rows,
     raw_vector<uint64_t>& result) {
   decoded_.decode(values, rows);
+  if (!decoded_.isIdentityMapping() && !decoded_.isConstantMapping() &&
+      !sameDictionary(values, decoded_, idsDictionary_)) {
+    dictionaryIds_.resize(decoded_.base()->size());
+    std::fill(dictionaryIds_.begin(), dictionaryIds_.end(), 0);
+  }
   return VALUE_ID_TYPE_DISPATCH(makeValueIds, typeKind_, rows, result.data());
 }
 
@@ -417,8 +442,7 @@ void VectorHasher::lookupValueIdsTyped(
     });
     rows.updateBounds();
   } else {
-    hashes.resize(decoded.base()->size());
-    std::fill(hashes.begin(), hashes.end(), 0);
+    // 'hashes' has kUnmappable for the values known to miss.
     rows.applyToSelected([&](vector_size_t row) INLINE_LAMBDA {
       if (decoded.isNullAt(row)) {
         if (multiplier_ == 1) {
@@ -431,12 +455,12 @@ void VectorHasher::lookupValueIdsTyped(
       if (id == 0) {
         T value = decoded.valueAt<T>(row);
         id = lookupValueId(value);
-        if (id == kUnmappable) {
-          rows.setValid(row, false);
-          return;
-        }
         hashes[baseIndex] = id;
       }
+      if (id == kUnmappable) {
+        rows.setValid(row, false);
+        return;
+      }
       result[row] = multiplier_ == 1 ? id : result[row] + multiplier_ * id;
     });
     rows.updateBounds();
@@ -448,7 +472,15 @@ void VectorHasher::lookupValueIds(
     SelectivityVector& rows,
     ScratchMemory& scratchMemory,
     raw_vector<uint64_t>& result) const {
-  scratchMemory.decoded.decode(values, rows);
+  auto& decoded = scratchMemory.decoded;
+  decoded.decode(values, rows);
+  if (!decoded.isIdentityMapping() && !decoded.isConstantMapping() &&
+      (!sameDictionary(values, decoded, scratchMemory.dictionary) ||
+       scratchMemory.hasher != this)) {
+    scratchMemory.hasher = this;
+    scratchMemory.hashes.resize(decoded.base()->size());
+    std::fill(scratchMemory.hashes.begin(), scratchMemory.hashes.end(), 0);
+  }
   VALUE_ID_TYPE_DISPATCH(
       lookupValueIdsTyped,
       typeKind_,
@@ -464,6 +496,11 @@ void VectorHasher::hash(
     bool mix,
     raw_vector<uint64_t>& result) {
   decoded_.decode(values, rows);
+  if (!decoded_.isIdentityMapping() && !decoded_.isConstantMapping() &&
+      !sameDictionary(values, decoded_, hashesDictionary_)) {
+    cachedHashes_.resize(decoded_.base()->size());
+    std::fill(cachedHashes_.begin(), cachedHashes_.end(), kNullHash);
+  }
   VELOX_DYNAMIC_TYPE_DISPATCH(hashValues, typeKind_, rows, mix, result.data());
 }
 
@@ -693,6 +730,7 @@ uint64_t VectorHasher::enableValueIds(uint64_t multiplier, int32_t reservePct) {
   multiplier_ = multiplier;
   rangeSize_ = addIdReserve(uniqueValues_.size(), reservePct) + 1;
   isRange_ = false;
+  idsDictionary_ = nullptr;
   uint64_t result;
   if (__builtin_mul_overflow(multiplier_, rangeSize_, &result)) {
     return kRangeTooLarge;
@@ -708,6 +746,7 @@ uint64_t VectorHasher::enableValueRange(
   VELOX_CHECK(hasRange_);
   extendRange(type_->kind(), reservePct, min_, max_);
   isRange_ = true;
+  idsDictionary_ = nullptr;
   // No overflow because max range is under 63 bits.
   if (typeKind_ == TypeKind::BOOLEAN) {
     rangeSize_ = 3;
@@ -729,6 +768,7 @@ void VectorHasher::copyStatsFrom(const VectorHasher& other) {
   min_ = other.min_;
   max_ = other.max_;
   uniqueValues_ = other.uniqueValues_;
+  idsDictionary_ = nullptr;
 }
 
 void VectorHasher::merge(const VectorHasher& other) {
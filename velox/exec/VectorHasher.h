@@ -220,6 +220,11 @@ class VectorHasher {
   struct ScratchMemory {
     DecodedVector decoded;
     raw_vector<uint64_t> hashes;
+    // Dictionary and hasher the ids in 'hashes' are for. The ids are kept
+    // between calls with inputs over the same dictionary, e.g. the batches
+    // of a stripe of a dictionary encoded string column.
+    VectorPtr dictionary;
+    const VectorHasher* hasher{nullptr};
   };
 
   // Updates the value id in 'result' for 'rows' in 'values'. If some value does
@@ -228,7 +233,8 @@ class VectorHasher {
   // have a miss if any of the keys has a value that is not represented.
   //
   // This method can be called concurrently from multiple threads. To allow for
-  // that the caller must provide 'scratchMemory'.
+  // that the caller must provide 'scratchMemory'. A 'scratchMemory' should
+  // be used with a single hasher while the hasher is alive.
   void lookupValueIds(
       const BaseVector& values,
       SelectivityVector& rows,
@@ -240,6 +246,11 @@ class VectorHasher {
     return hasRange_ || !distinctOverflow_;
   }
 
+  // Returns true if there are too many distinct values to keep track of.
+  bool distinctOverflow() const {
+    return distinctOverflow_;
+  }
+
   // Returns an instance of the filter corresponding to a set of unique values.
   // Returns null if distinctOverflow_ is true.
   std::unique_ptr<common::Filter> getFilter(bool nullAllowed) const;
@@ -533,7 +544,17 @@ class VectorHasher {
   const TypeKind typeKind_;
 
   DecodedVector decoded_;
+
+  // Hashes of the values of 'hashesDictionary_', kNullHash if not computed.
   raw_vector<uint64_t> cachedHashes_;
+  VectorPtr hashesDictionary_;
+
+  // Value ids of the values of 'idsDictionary_', 0 if not computed. The ids
+  // are kept for consecutive batches over the same dictionary, so that each
+  // distinct value of a dictionary encoded column is mapped once. Reset when
+  // the mapping changes.
+  raw_vector<uint64_t> dictionaryIds_;
+  VectorPtr idsDictionary_;
 
   // Single precomputed hash for constant partition keys.
   uint64_t precomputedHash_{0};
@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/Window.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+int64_t frameOffset(const core::TypedExprPtr& expr) {
+  VELOX_USER_CHECK_NOT_NULL(
+      expr, "Window frame PRECEDING and FOLLOWING bounds require an offset");
+  auto constant =
+      std::dynamic_pointer_cast<const core::ConstantTypedExpr>(expr);
+  VELOX_USER_CHECK_NOT_NULL(
+      constant, "Window frame offset must be a constant: {}", expr->toString());
+  VELOX_USER_CHECK(
+      !constant->hasValueVector() && !constant->value().isNull(),
+      "Window frame offset must be a non-null integer: {}",
+      expr->toString());
+
+  int64_t offset;
+  const auto& value = constant->value();
+  switch (value.kind()) {
+    case TypeKind::TINYINT:
+      offset = value.value<int8_t>();
+      break;
+    case TypeKind::SMALLINT:
+      offset = value.value<int16_t>();
+      break;
+    case TypeKind::INTEGER:
+      offset = value.value<int32_t>();
+      break;
+    case TypeKind::BIGINT:
+      offset = value.value<int64_t>();
+      break;
+    default:
+      VELOX_USER_FAIL(
+          "Window frame offset must be an integer: {}", expr->toString());
+  }
+  VELOX_USER_CHECK_GE(offset, 0, "Window frame offset must not be negative");
+  return offset;
+}
+
+bool hasOffset(core::WindowNode::BoundType boundType) {
+  return boundType == core::WindowNode::BoundType::kPreceding ||
+      boundType == core::WindowNode::BoundType::kFollowing;
+}
+} // namespace
+
+Window::Window(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::WindowNode>& windowNode)
+    : Operator(
+          driverCtx,
+          windowNode->outputType(),
+          operatorId,
+          windowNode->id(),
+          "Window"),
+      numInputColumns_(windowNode->sources()[0]->outputType()->size()),
+      data_(std::make_unique<RowContainer>(
+          windowNode->sources()[0]->outputType()->children(),
+          operatorCtx_->mappedMemory())) {
+  const auto& inputType = windowNode->sources()[0]->outputType();
+  for (const auto& key : windowNode->partitionKeys()) {
+    auto channel = exprToChannel(key.get(), inputType);
+    VELOX_CHECK(
+        channel != kConstantChannel,
+        "Window doesn't allow constant partition keys");
+    partitionKeyInfo_.emplace_back(channel, core::kAscNullsLast);
+  }
+  for (auto i = 0; i < windowNode->sortingKeys().size(); ++i) {
+    auto channel =
+        exprToChannel(windowNode->sortingKeys()[i].get(), inputType);
+    VELOX_CHECK(
+        channel != kConstantChannel,
+        "Window doesn't allow constant sorting keys");
+    sortKeyInfo_.emplace_back(channel, windowNode->sortingOrders()[i]);
+  }
+
+  windowPartition_ = std::make_unique<WindowPartition>(data_.get());
+  createWindowFunctions(windowNode);
+}
+
+void Window::createWindowFunctions(
+    const std::shared_ptr<const core::WindowNode>& windowNode) {
+  const auto& inputType = windowNode->sources()[0]->outputType();
+  for (const auto& windowFunction : windowNode->windowFunctions()) {
+    std::vector<WindowFunctionArg> args;
+    for (const auto& input : windowFunction.functionCall->inputs()) {
+      if (auto constant =
+              std::dynamic_pointer_cast<const core::ConstantTypedExpr>(
+                  input)) {
+        auto value = constant->hasValueVector()
+            ? constant->valueVector()
+            : BaseVector::createConstant(
+                  constant->value(), 1, operatorCtx_->pool());
+        args.push_back({input->type(), value, std::nullopt});
+      } else {
+        auto channel = exprToChannel(input.get(), inputType);
+        VELOX_CHECK(
+            channel != kConstantChannel,
+            "Window function arguments must be columns or constants: {}",
+            input->toString());
+        args.push_back({input->type(), nullptr, channel});
+      }
+    }
+
+    windowFunctions_.push_back(WindowFunction::create(
+        windowFunction.functionCall->name(),
+        args,
+        windowFunction.functionCall->type(),
+        operatorCtx_->pool(),
+        &data_->stringAllocator()));
+
+    const auto& frame = windowFunction.frame;
+    VELOX_USER_CHECK(
+        frame.type == core::WindowNode::WindowType::kRows ||
+            (!hasOffset(frame.startType) && !hasOffset(frame.endType)),
+        "RANGE window frames with PRECEDING or FOLLOWING offsets are not supported");
+    VELOX_USER_CHECK(
+        frame.startType != core::WindowNode::BoundType::kUnboundedFollowing,
+        "Window frame start cannot be UNBOUNDED FOLLOWING");
+    VELOX_USER_CHECK(
+        frame.endType != core::WindowNode::BoundType::kUnboundedPreceding,
+        "Window frame end cannot be UNBOUNDED PRECEDING");
+    windowFrames_.push_back(
+        {frame.type,
+         frame.startType,
+         hasOffset(frame.startType) ? frameOffset(frame.startValue) : 0,
+         frame.endType,
+         hasOffset(frame.endType) ? frameOffset(frame.endValue) : 0});
+  }
+  frameStartBuffers_.resize(windowFunctions_.size());
+  frameEndBuffers_.resize(windowFunctions_.size());
+}
+
+void Window::addInput(RowVectorPtr input) {
+  SelectivityVector allRows(input->size());
+  std::vector<char*> rows(input->size());
+  for (int row = 0; row < input->size(); ++row) {
+    rows[row] = data_->newRow();
+  }
+  for (auto col = 0; col < input->childrenSize(); ++col) {
+    DecodedVector decoded(*input->childAt(col), allRows);
+    for (int i = 0; i < input->size(); ++i) {
+      data_->store(decoded, i, rows[i], col);
+    }
+  }
+
+  numRows_ += allRows.size();
+}
+
+void Window::noMoreInput() {
+  Operator::noMoreInput();
+
+  // No data.
+  if (numRows_ == 0) {
+    finished_ = true;
+    return;
+  }
+
+  sortPartitions();
+  startPartition();
+}
+
+int32_t Window::compareRows(
+    const char* left,
+    const char* right,
+    const std::vector<std::pair<column_index_t, core::SortOrder>>& keys) {
+  for (auto& [channelIndex, sortOrder] : keys) {
+    if (auto result = data_->compare(
+            left,
+            right,
+            channelIndex,
+            {sortOrder.isNullsFirst(), sortOrder.isAscending(), false})) {
+      return result;
+    }
+  }
+  return 0;
+}
+
+void Window::sortPartitions() {
+  // Sort the pointers to the rows in RowContainer (data_) instead of sorting
+  // the rows.
+  sortedRows_.resize(numRows_);
+  RowContainerIterator iter;
+  data_->listRows(&iter, numRows_, sortedRows_.data());
+
+  std::sort(
+      sortedRows_.begin(),
+      sortedRows_.end(),
+      [this](const char* leftRow, const char* rightRow) {
+        if (auto result = compareRows(leftRow, rightRow, partitionKeyInfo_)) {
+          return result < 0;
+        }
+        return compareRows(leftRow, rightRow, sortKeyInfo_) < 0;
+      });
+
+  partitionStartRows_.push_back(0);
+  if (!partitionKeyInfo_.empty()) {
+    for (auto i = 1; i < sortedRows_.size(); ++i) {
+      if (compareRows(sortedRows_[i - 1], sortedRows_[i], partitionKeyInfo_)) {
+        partitionStartRows_.push_back(i);
+      }
+    }
+  }
+  partitionStartRows_.push_back(sortedRows_.size());
+}
+
+void Window::startPartition() {
+  auto partitionStart = partitionStartRows_[currentPartition_];
+  auto partitionSize =
+      partitionStartRows_[currentPartition_ + 1] - partitionStart;
+  windowPartition_->resetPartition(folly::Range<char**>(
+      sortedRows_.data() + partitionStart, partitionSize));
+  for (auto& windowFunction : windowFunctions_) {
+    windowFunction->resetPartition(windowPartition_.get());
+  }
+  partitionOffset_ = 0;
+  peerStart_ = 0;
+  peerEnd_ = 0;
+}
+
+void Window::ensureBufferSize(BufferPtr& buffer, vector_size_t numRows) {
+  auto numBytes = numRows * sizeof(vector_size_t);
+  if (!buffer || buffer->capacity() < numBytes) {
+    buffer = AlignedBuffer::allocate<vector_size_t>(
+        numRows, operatorCtx_->pool());
+  }
+  buffer->setSize(numBytes);
+}
+
+void Window::computePeerBuffers(vector_size_t numRows) {
+  ensureBufferSize(peerStartBuffer_, numRows);
+  ensureBufferSize(peerEndBuffer_, numRows);
+  auto rawPeerStarts = peerStartBuffer_->asMutable<vector_size_t>();
+  auto rawPeerEnds = peerEndBuffer_->asMutable<vector_size_t>();
+
+  auto partitionSize = windowPartition_->numRows();
+  auto partitionRows =
+      sortedRows_.data() + partitionStartRows_[currentPartition_];
+  for (auto i = 0; i < numRows; ++i) {
+    auto row = partitionOffset_ + i;
+    if (row >= peerEnd_) {
+      peerStart_ = row;
+      peerEnd_ = row + 1;
+      while (peerEnd_ < partitionSize &&
+             compareRows(
+                 partitionRows[peerStart_],
+                 partitionRows[peerEnd_],
+                 sortKeyInfo_) == 0) {
+        ++peerEnd_;
+      }
+    }
+    rawPeerStarts[i] = peerStart_;
+    rawPeerEnds[i] = peerEnd_ - 1;
+  }
+}
+
+vector_size_t Window::frameBound(
+    core::WindowNode::WindowType windowType,
+    core::WindowNode::BoundType boundType,
+    int64_t offset,
+    bool isStart,
+    vector_size_t partitionOffset,
+    vector_size_t peerStart,
+    vector_size_t peerEnd) const {
+  int64_t numRows = windowPartition_->numRows();
+  int64_t bound;
+  switch (boundType) {
+    case core::WindowNode::BoundType::kUnboundedPreceding:
+      bound = 0;
+      break;
+    case core::WindowNode::BoundType::kPreceding:
+      bound = partitionOffset - offset;
+      break;
+    case core::WindowNode::BoundType::kCurrentRow:
+      if (windowType == core::WindowNode::WindowType::kRange) {
+        bound = isStart ? peerStart : peerEnd;
+      } else {
+        bound = partitionOffset;
+      }
+      break;
+    case core::WindowNode::BoundType::kFollowing:
+      bound = partitionOffset + offset;
+      break;
+    case core::WindowNode::BoundType::kUnboundedFollowing:
+      bound = numRows - 1;
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+
+  // Frames that fall outside of the partition are clamped so that an empty
+  // frame always has its end before its start.
+  if (isStart) {
+    return std::clamp<int64_t>(bound, 0, numRows);
+  }
+  return std::clamp<int64_t>(bound, -1, numRows - 1);
+}
+
+void Window::computeFrameBuffers(
+    const WindowFrame& frame,
+    vector_size_t numRows,
+    const BufferPtr& frameStarts,
+    const BufferPtr& frameEnds) {
+  auto rawFrameStarts = frameStarts->asMutable<vector_size_t>();
+  auto rawFrameEnds = frameEnds->asMutable<vector_size_t>();
+  auto rawPeerStarts = peerStartBuffer_->as<vector_size_t>();
+  auto rawPeerEnds = peerEndBuffer_->as<vector_size_t>();
+  for (auto i = 0; i < numRows; ++i) {
+    auto row = partitionOffset_ + i;
+    rawFrameStarts[i] = frameBound(
+        frame.type,
+        frame.startType,
+        frame.startOffset,
+        true,
+        row,
+        rawPeerStarts[i],
+        rawPeerEnds[i]);
+    rawFrameEnds[i] = frameBound(
+        frame.type,
+        frame.endType,
+        frame.endOffset,
+        false,
+        row,
+        rawPeerStarts[i],
+        rawPeerEnds[i]);
+  }
+}
+
+RowVectorPtr Window::getOutput() {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+
+  auto numRowsPerBatch = data_->estimatedNumRowsPerBatch(kBatchSizeInBytes);
+  vector_size_t numOutputRows =
+      std::min<size_t>(numRowsPerBatch, numRows_ - numRowsReturned_);
+  VELOX_CHECK_GT(numOutputRows, 0);
+
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, numOutputRows, operatorCtx_->pool()));
+
+  for (auto i = 0; i < numInputColumns_; ++i) {
+    data_->extractColumn(
+        sortedRows_.data() + numRowsReturned_,
+        numOutputRows,
+        i,
+        result->childAt(i));
+  }
+
+  // A batch may span several partitions. The window functions are invoked
+  // once per partition for the rows of the batch that fall into it.
+  vector_size_t resultOffset = 0;
+  while (resultOffset < numOutputRows) {
+    if (partitionOffset_ == windowPartition_->numRows()) {
+      ++currentPartition_;
+      startPartition();
+    }
+
+    vector_size_t numRows = std::min(
+        windowPartition_->numRows() - partitionOffset_,
+        numOutputRows - resultOffset);
+    computePeerBuffers(numRows);
+    for (auto i = 0; i < windowFunctions_.size(); ++i) {
+      ensureBufferSize(frameStartBuffers_[i], numRows);
+      ensureBufferSize(frameEndBuffers_[i], numRows);
+      computeFrameBuffers(
+          windowFrames_[i],
+          numRows,
+          frameStartBuffers_[i],
+          frameEndBuffers_[i]);
+      windowFunctions_[i]->apply(
+          peerStartBuffer_,
+          peerEndBuffer_,
+          frameStartBuffers_[i],
+          frameEndBuffers_[i],
+          resultOffset,
+          result->childAt(numInputColumns_ + i));
+    }
+
+    resultOffset += numRows;
+    partitionOffset_ += numRows;
+  }
+
+  numRowsReturned_ += numOutputRows;
+  finished_ = (numRowsReturned_ == numRows_);
+
+  return result;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/WindowFunction.h"
+#include "velox/exec/WindowPartition.h"
+
+namespace facebook::velox::exec {
+
+/// Window operator implementation: Window stores all its inputs in a
+/// RowContainer as the inputs are added. Once all inputs are available, it
+/// sorts pointers to the rows on the partition keys followed by the ORDER BY
+/// keys. The output is produced one partition at a time: for each block of
+/// output rows the operator computes the peer group and the frame bounds of
+/// every row and passes them to the WindowFunctions, which write their results
+/// directly into the output vector. Output rows are the input columns followed
+/// by one column per window function.
+/// Limitations:
+/// * RANGE frames with PRECEDING or FOLLOWING offsets are not supported.
+/// * Frame offsets must be constant.
+/// * It does not support spilling.
+class Window : public Operator {
+ public:
+  Window(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::WindowNode>& windowNode);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  void noMoreInput() override;
+
+  RowVectorPtr getOutput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+ private:
+  static const int32_t kBatchSizeInBytes{2 * 1024 * 1024};
+
+  // Frame of a window function with offsets resolved to constants.
+  struct WindowFrame {
+    core::WindowNode::WindowType type;
+    core::WindowNode::BoundType startType;
+    int64_t startOffset;
+    core::WindowNode::BoundType endType;
+    int64_t endOffset;
+  };
+
+  void createWindowFunctions(
+      const std::shared_ptr<const core::WindowNode>& windowNode);
+
+  // Sorts 'sortedRows_' and computes 'partitionStartRows_'.
+  void sortPartitions();
+
+  // Compares 'left' and 'right' on 'keys'. Returns 0 if equal.
+  int32_t compareRows(
+      const char* left,
+      const char* right,
+      const std::vector<std::pair<column_index_t, core::SortOrder>>& keys);
+
+  // Makes 'currentPartition_' the partition whose rows are fed to the window
+  // functions.
+  void startPartition();
+
+  // Computes the peer group bounds for 'numRows' rows of the current
+  // partition starting at 'partitionOffset_'.
+  void computePeerBuffers(vector_size_t numRows);
+
+  // Computes the bounds of 'frame' for 'numRows' rows of the current
+  // partition starting at 'partitionOffset_'. Must be called after
+  // computePeerBuffers().
+  void computeFrameBuffers(
+      const WindowFrame& frame,
+      vector_size_t numRows,
+      const BufferPtr& frameStarts,
+      const BufferPtr& frameEnds);
+
+  // Returns the frame bound for the row at 'partitionOffset'. 'peerStart' and
+  // 'peerEnd' are the bounds of the peer group of that row.
+  vector_size_t frameBound(
+      core::WindowNode::WindowType windowType,
+      core::WindowNode::BoundType boundType,
+      int64_t offset,
+      bool isStart,
+      vector_size_t partitionOffset,
+      vector_size_t peerStart,
+      vector_size_t peerEnd) const;
+
+  void ensureBufferSize(BufferPtr& buffer, vector_size_t numRows);
+
+  const vector_size_t numInputColumns_;
+
+  std::unique_ptr<RowContainer> data_;
+
+  // Partition keys and ORDER BY keys of the window as pairs of column index in
+  // 'data_' and sort order. The sort order of partition keys doesn't matter.
+  std::vector<std::pair<column_index_t, core::SortOrder>> partitionKeyInfo_;
+  std::vector<std::pair<column_index_t, core::SortOrder>> sortKeyInfo_;
+
+  std::vector<std::unique_ptr<WindowFunction>> windowFunctions_;
+  std::vector<WindowFrame> windowFrames_;
+
+  size_t numRows_{0};
+  size_t numRowsReturned_{0};
+
+  // Input rows sorted on partition and ORDER BY keys.
+  std::vector<char*> sortedRows_;
+
+  // Offsets into 'sortedRows_' of the first row of each partition, followed by
+  // the total number of rows.
+  std::vector<vector_size_t> partitionStartRows_;
+
+  // Index into 'partitionStartRows_' of the partition being output.
+  vector_size_t currentPartition_{0};
+
+  // Offset in the current partition of the next row to output.
+  vector_size_t partitionOffset_{0};
+
+  // Bounds of the peer group of the last row processed in the current
+  // partition. 'peerEnd_' is exclusive.
+  vector_size_t peerStart_{0};
+  vector_size_t peerEnd_{0};
+
+  std::unique_ptr<WindowPartition> windowPartition_;
+
+  // Peer group and frame bounds for the block of rows being output. There is
+  // one pair of frame buffers per window function.
+  BufferPtr peerStartBuffer_;
+  BufferPtr peerEndBuffer_;
+  std::vector<BufferPtr> frameStartBuffers_;
+  std::vector<BufferPtr> frameEndBuffers_;
+
+  bool finished_{false};
+};
+
+} // namespace facebook::velox::exec
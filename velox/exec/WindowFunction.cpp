@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/WindowFunction.h"
+#include "velox/exec/Aggregate.h"
+#include "velox/exec/AggregateFunctionRegistry.h"
+#include "velox/expression/SignatureBinder.h"
+
+namespace facebook::velox::exec {
+
+WindowFunctionMap& windowFunctions() {
+  static WindowFunctionMap functions;
+  return functions;
+}
+
+namespace {
+std::optional<const WindowFunctionEntry*> getWindowFunctionEntry(
+    const std::string& name) {
+  auto sanitizedName = sanitizeFunctionName(name);
+
+  auto& functionsMap = windowFunctions();
+  auto it = functionsMap.find(sanitizedName);
+  if (it != functionsMap.end()) {
+    return &it->second;
+  }
+
+  return std::nullopt;
+}
+
+// Evaluates an aggregate function over window frames. The aggregate keeps a
+// single accumulator. When the frame of the next row starts at the same row as
+// the frame of the previous one and ends at or after it, only the new rows are
+// added to the accumulator. This makes running aggregates (the default frame)
+// and whole-partition aggregates linear in the partition size.
+//
+// Other frames, e.g. sliding frames of ROWS n PRECEDING, are assembled from a
+// segment tree of partial accumulators over blocks of kLeafSize rows, made
+// with extractAccumulators() when the first such frame of a partition is
+// seen. A frame then takes its rows up to the first whole block and after the
+// last whole block as raw input and O(log(frame size)) tree nodes as
+// intermediate results, in row order. Short frames are computed from the raw
+// rows.
+class AggregateWindowFunction : public WindowFunction {
+ public:
+  AggregateWindowFunction(
+      const std::string& name,
+      const std::vector<WindowFunctionArg>& args,
+      const TypePtr& resultType,
+      memory::MemoryPool* pool,
+      HashStringAllocator* stringAllocator)
+      : WindowFunction(resultType, pool), args_(args) {
+    std::vector<TypePtr> argTypes;
+    argTypes.reserve(args_.size());
+    for (const auto& arg : args_) {
+      argTypes.push_back(arg.type);
+    }
+    aggregate_ = Aggregate::create(
+        name, core::AggregationNode::Step::kSingle, argTypes, resultType);
+    // The tree nodes have their own aggregate, so that their null count does
+    // not mix with the one of 'group_'.
+    treeAggregate_ = Aggregate::create(
+        name, core::AggregationNode::Step::kSingle, argTypes, resultType);
+    intermediateType_ = Aggregate::intermediateType(name, argTypes);
+    incremental_ = aggregate_->canAddInputAfterFinalize();
+
+    // A group row has the null flag in the first byte, a 32-bit row size at
+    // offset kRowSizeOffset for variable width accumulators and the
+    // accumulator at 'accumulatorOffset_', aligned as the aggregate needs.
+    const auto alignment = aggregate_->accumulatorAlignmentSize();
+    VELOX_CHECK(bits::isPowerOfTwo(alignment));
+    VELOX_CHECK_LE(alignment, AlignedBuffer::kAlignment);
+    accumulatorOffset_ =
+        bits::roundUp(kRowSizeOffset + sizeof(uint32_t), alignment);
+    groupSize_ = bits::roundUp(
+        accumulatorOffset_ + aggregate_->accumulatorFixedWidthSize(),
+        alignment);
+    for (auto* aggregate : {aggregate_.get(), treeAggregate_.get()}) {
+      aggregate->setAllocator(stringAllocator);
+      aggregate->setOffsets(accumulatorOffset_, 0, 1, kRowSizeOffset);
+    }
+    groupBuffer_ = AlignedBuffer::allocate<char>(groupSize_, pool);
+    group_ = groupBuffer_->asMutable<char>();
+
+    argVectors_.resize(args_.size());
+    singleResult_ = BaseVector::create(resultType, 1, pool);
+  }
+
+  ~AggregateWindowFunction() override {
+    if (initialized_) {
+      aggregate_->destroy(folly::Range<char**>(&group_, 1));
+    }
+  }
+
+  void resetPartition(const WindowPartition* partition) override {
+    partition_ = partition;
+    auto numRows = partition_->numRows();
+    for (auto i = 0; i < args_.size(); ++i) {
+      const auto& arg = args_[i];
+      if (arg.constantValue) {
+        argVectors_[i] =
+            BaseVector::wrapInConstant(numRows, 0, arg.constantValue);
+      } else {
+        VELOX_CHECK(arg.index.has_value());
+        if (!argVectors_[i]) {
+          argVectors_[i] = BaseVector::create(arg.type, numRows, pool_);
+        }
+        partition_->extractColumn(
+            arg.index.value(), 0, numRows, argVectors_[i]);
+      }
+    }
+    rows_.resize(numRows);
+    tree_.clear();
+    frameStart_ = 0;
+    frameEnd_ = -1;
+    resetAccumulator();
+  }
+
+  void apply(
+      const BufferPtr& /*peerGroupStarts*/,
+      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& frameStarts,
+      const BufferPtr& frameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) override {
+    auto rawFrameStarts = frameStarts->as<vector_size_t>();
+    auto rawFrameEnds = frameEnds->as<vector_size_t>();
+    auto numRows = frameStarts->size() / sizeof(vector_size_t);
+    for (auto i = 0; i < numRows; ++i) {
+      auto start = rawFrameStarts[i];
+      auto end = rawFrameEnds[i];
+      if (start != frameStart_ || end != frameEnd_) {
+        updateFrame(start, end);
+        extractResult();
+      } else if (!hasResult_) {
+        extractResult();
+      }
+      result->copy(singleResult_.get(), resultOffset + i, 0, 1);
+    }
+  }
+
+ private:
+  static constexpr int32_t kRowSizeOffset = 4;
+  // Rows in a leaf of the segment tree.
+  static constexpr int32_t kLeafSize = 16;
+
+  void resetAccumulator() {
+    if (initialized_) {
+      aggregate_->destroy(folly::Range<char**>(&group_, 1));
+    }
+    aggregate_->clear();
+    std::memset(group_, 0, groupSize_);
+    std::vector<vector_size_t> index{0};
+    aggregate_->initializeNewGroups(
+        &group_, folly::Range<const vector_size_t*>(index.data(), 1));
+    initialized_ = true;
+    hasResult_ = false;
+  }
+
+  // Adds rows [begin, end] of the partition to the accumulator.
+  void addRows(vector_size_t begin, vector_size_t end) {
+    if (end < begin) {
+      return;
+    }
+    rows_.clearAll();
+    rows_.setValidRange(begin, end + 1, true);
+    rows_.updateBounds();
+    aggregate_->addSingleGroupRawInput(group_, rows_, argVectors_, false);
+  }
+
+  void updateFrame(vector_size_t start, vector_size_t end) {
+    bool canExtend = incremental_ && start == frameStart_ &&
+        end >= frameEnd_ && frameEnd_ >= frameStart_;
+    if (canExtend) {
+      addRows(frameEnd_ + 1, end);
+    } else {
+      resetAccumulator();
+      if (end - start + 1 >= 4 * kLeafSize) {
+        addTreeFrame(start, end);
+      } else {
+        addRows(start, end);
+      }
+    }
+    frameStart_ = start;
+    frameEnd_ = end;
+    hasResult_ = false;
+  }
+
+  // Initializes 'numGroups' group rows in 'nodeGroups_' for 'treeAggregate_'
+  // and returns pointers to them.
+  std::vector<char*> makeNodeGroups(vector_size_t numGroups) {
+    nodeGroups_ = AlignedBuffer::allocate<char>(numGroups * groupSize_, pool_);
+    auto* data = nodeGroups_->asMutable<char>();
+    std::memset(data, 0, numGroups * groupSize_);
+    std::vector<char*> groups(numGroups);
+    std::vector<vector_size_t> indices(numGroups);
+    for (auto i = 0; i < numGroups; ++i) {
+      groups[i] = data + i * groupSize_;
+      indices[i] = i;
+    }
+    treeAggregate_->clear();
+    treeAggregate_->initializeNewGroups(
+        groups.data(),
+        folly::Range<const vector_size_t*>(indices.data(), numGroups));
+    return groups;
+  }
+
+  // Makes the intermediate results of 'groups' into a new level of 'tree_'
+  // and frees the groups.
+  void addTreeLevel(std::vector<char*>& groups) {
+    const auto numGroups = groups.size();
+    treeAggregate_->finalize(groups.data(), numGroups);
+    auto level = BaseVector::create(intermediateType_, numGroups, pool_);
+    treeAggregate_->extractAccumulators(groups.data(), numGroups, &level);
+    treeAggregate_->destroy(folly::Range<char**>(groups.data(), numGroups));
+    nodeGroups_ = nullptr;
+    tree_.push_back(std::move(level));
+  }
+
+  // Makes 'tree_'. Level 0 has the partial accumulators of the whole blocks
+  // of kLeafSize rows. Node 'i' of level 'l + 1' merges nodes 2 * i and 2 * i
+  // + 1 of level 'l'.
+  void buildTree() {
+    const auto numLeaves = partition_->numRows() / kLeafSize;
+    const auto numLeafRows = numLeaves * kLeafSize;
+    auto nodes = makeNodeGroups(numLeaves);
+    std::vector<char*> groups(numLeafRows);
+    for (auto i = 0; i < numLeafRows; ++i) {
+      groups[i] = nodes[i / kLeafSize];
+    }
+    SelectivityVector rows(numLeafRows);
+    treeAggregate_->addRawInput(groups.data(), rows, argVectors_, false);
+    addTreeLevel(nodes);
+
+    while (tree_.back()->size() > 1) {
+      const auto numChildren = tree_.back()->size();
+      nodes = makeNodeGroups((numChildren + 1) / 2);
+      groups.resize(numChildren);
+      for (auto i = 0; i < numChildren; ++i) {
+        groups[i] = nodes[i / 2];
+      }
+      rows.resize(numChildren);
+      rows.setAll();
+      treeAggregate_->addIntermediateResults(
+          groups.data(), rows, {tree_.back()}, false);
+      addTreeLevel(nodes);
+    }
+  }
+
+  void addTreeNode(int32_t level, vector_size_t index) {
+    nodeRows_.resize(index + 1);
+    nodeRows_.clearAll();
+    nodeRows_.setValid(index, true);
+    nodeRows_.updateBounds();
+    aggregate_->addSingleGroupIntermediateResults(
+        group_, nodeRows_, {tree_[level]}, false);
+  }
+
+  // Adds rows [start, end] to the accumulator with whole blocks taken from
+  // 'tree_'. The parts are added in row order, so that order sensitive
+  // aggregates see the same sequence as with raw input.
+  void addTreeFrame(vector_size_t start, vector_size_t end) {
+    if (tree_.empty()) {
+      buildTree();
+    }
+    auto firstLeaf = bits::roundUp(start, kLeafSize) / kLeafSize;
+    auto endLeaf = (end + 1) / kLeafSize;
+    VELOX_DCHECK_LT(firstLeaf, endLeaf);
+    addRows(start, firstLeaf * kLeafSize - 1);
+
+    // Walks up the tree from the leaves, taking the nodes at the edges of
+    // the range. The nodes at the end of the range are added in reverse.
+    std::vector<std::pair<int32_t, vector_size_t>> endNodes;
+    auto begin = firstLeaf;
+    for (int32_t level = 0; begin < endLeaf; ++level) {
+      if (begin & 1) {
+        addTreeNode(level, begin++);
+      }
+      if (endLeaf & 1) {
+        endNodes.emplace_back(level, --endLeaf);
+      }
+      begin /= 2;
+      endLeaf /= 2;
+    }
+    for (auto it = endNodes.rbegin(); it != endNodes.rend(); ++it) {
+      addTreeNode(it->first, it->second);
+    }
+
+    addRows((end + 1) / kLeafSize * kLeafSize, end);
+  }
+
+  void extractResult() {
+    aggregate_->finalize(&group_, 1);
+    aggregate_->extractValues(&group_, 1, &singleResult_);
+    hasResult_ = true;
+  }
+
+  const std::vector<WindowFunctionArg> args_;
+  std::unique_ptr<Aggregate> aggregate_;
+
+  // Aggregate for the nodes of 'tree_'.
+  std::unique_ptr<Aggregate> treeAggregate_;
+  TypePtr intermediateType_;
+
+  // True if 'aggregate_' allows growing the frame without recomputing it.
+  bool incremental_;
+
+  // Offset of the accumulator and size of a group row.
+  int32_t accumulatorOffset_;
+  int32_t groupSize_;
+
+  BufferPtr groupBuffer_;
+  char* group_;
+  bool initialized_{false};
+
+  const WindowPartition* partition_{nullptr};
+
+  // Values of the arguments for all rows of the current partition.
+  std::vector<VectorPtr> argVectors_;
+
+  // Reusable selection of the rows added to the accumulator.
+  SelectivityVector rows_;
+
+  // Segment tree of intermediate results for the current partition, one
+  // vector per level. Empty until a frame needs it.
+  std::vector<VectorPtr> tree_;
+
+  // Group rows of the tree nodes being made.
+  BufferPtr nodeGroups_;
+
+  // Reusable selection of a tree node.
+  SelectivityVector nodeRows_;
+
+  // Frame currently accumulated in 'group_'. An empty frame has 'frameEnd_' <
+  // 'frameStart_'.
+  vector_size_t frameStart_{0};
+  vector_size_t frameEnd_{-1};
+
+  // Result for the current frame. Valid if 'hasResult_' is true.
+  VectorPtr singleResult_;
+  bool hasResult_{false};
+};
+} // namespace
+
+bool registerWindowFunction(
+    const std::string& name,
+    std::vector<FunctionSignaturePtr> signatures,
+    WindowFunctionFactory factory) {
+  auto sanitizedName = sanitizeFunctionName(name);
+
+  windowFunctions()[sanitizedName] = {
+      std::move(signatures), std::move(factory)};
+  return true;
+}
+
+std::optional<std::vector<FunctionSignaturePtr>> getWindowFunctionSignatures(
+    const std::string& name) {
+  if (auto func = getWindowFunctionEntry(name)) {
+    return func.value()->signatures;
+  }
+
+  return std::nullopt;
+}
+
+std::unique_ptr<WindowFunction> WindowFunction::create(
+    const std::string& name,
+    const std::vector<WindowFunctionArg>& args,
+    const TypePtr& resultType,
+    memory::MemoryPool* pool,
+    HashStringAllocator* stringAllocator) {
+  if (auto func = getWindowFunctionEntry(name)) {
+    return func.value()->factory(args, resultType, pool, stringAllocator);
+  }
+
+  if (getAggregateFunctionSignatures(name).has_value()) {
+    return std::make_unique<AggregateWindowFunction>(
+        name, args, resultType, pool, stringAllocator);
+  }
+
+  VELOX_USER_FAIL("Window function not registered: {}", name);
+}
+
+TypePtr resolveWindowFunction(
+    const std::string& functionName,
+    const std::vector<TypePtr>& argTypes) {
+  if (auto signatures = getWindowFunctionSignatures(functionName)) {
+    for (const auto& signature : signatures.value()) {
+      SignatureBinder binder(*signature, argTypes);
+      if (binder.tryBind()) {
+        return binder.tryResolveReturnType();
+      }
+    }
+    return nullptr;
+  }
+
+  return resolveAggregateFunction(functionName, argTypes).first;
+}
+
+} // namespace facebook::velox::exec
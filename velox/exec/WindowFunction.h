@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/memory/HashStringAllocator.h"
+#include "velox/exec/WindowPartition.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox::exec {
+
+/// Describes an argument of a window function. Arguments are either input
+/// columns, identified by their index in the WindowPartition, or constants.
+struct WindowFunctionArg {
+  TypePtr type;
+  VectorPtr constantValue;
+  std::optional<column_index_t> index;
+};
+
+/// Base class for window functions. A Window operator creates one instance per
+/// window function per driver and feeds it one partition at a time. All rows of
+/// a partition are sorted on the window ORDER BY keys and are accessible
+/// through the WindowPartition. Results are produced in blocks of consecutive
+/// partition rows, so a function can carry state from one block to the next
+/// within the same partition.
+class WindowFunction {
+ public:
+  explicit WindowFunction(TypePtr resultType, memory::MemoryPool* pool)
+      : resultType_(std::move(resultType)), pool_(pool) {}
+
+  virtual ~WindowFunction() = default;
+
+  const TypePtr& resultType() const {
+    return resultType_;
+  }
+
+  memory::MemoryPool* pool() const {
+    return pool_;
+  }
+
+  /// Called at the start of each partition. 'partition' stays valid until the
+  /// next call to resetPartition().
+  virtual void resetPartition(const WindowPartition* partition) = 0;
+
+  /// Computes the function for a block of consecutive rows of the current
+  /// partition and writes results into 'result' starting at 'resultOffset'.
+  /// The buffers hold one vector_size_t per row of the block. All values are
+  /// offsets into the partition.
+  /// @param peerGroupStarts First row of the peer group of each row. Peers are
+  /// rows that compare equal on the ORDER BY keys.
+  /// @param peerGroupEnds Last row of the peer group of each row.
+  /// @param frameStarts First row of the frame of each row.
+  /// @param frameEnds Last row of the frame of each row. A frame end that is
+  /// less than the frame start denotes an empty frame.
+  virtual void apply(
+      const BufferPtr& peerGroupStarts,
+      const BufferPtr& peerGroupEnds,
+      const BufferPtr& frameStarts,
+      const BufferPtr& frameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) = 0;
+
+  /// Creates a window function with the specified name. Functions registered
+  /// with registerWindowFunction() take precedence. Falls back to wrapping an
+  /// aggregate function registered with registerAggregateFunction().
+  /// @param stringAllocator Allocator for variable width accumulator state of
+  /// aggregates used as window functions.
+  static std::unique_ptr<WindowFunction> create(
+      const std::string& name,
+      const std::vector<WindowFunctionArg>& args,
+      const TypePtr& resultType,
+      memory::MemoryPool* pool,
+      HashStringAllocator* stringAllocator);
+
+ protected:
+  const TypePtr resultType_;
+  memory::MemoryPool* const pool_;
+};
+
+using WindowFunctionFactory = std::function<std::unique_ptr<WindowFunction>(
+    const std::vector<WindowFunctionArg>& args,
+    const TypePtr& resultType,
+    memory::MemoryPool* pool,
+    HashStringAllocator* stringAllocator)>;
+
+/// Register a window function with the specified name and signatures.
+/// Signatures of window functions use the same representation as scalar
+/// functions.
+bool registerWindowFunction(
+    const std::string& name,
+    std::vector<FunctionSignaturePtr> signatures,
+    WindowFunctionFactory factory);
+
+/// Returns signatures of the window function with the specified name.
+/// Returns empty std::optional if function with that name is not found.
+std::optional<std::vector<FunctionSignaturePtr>> getWindowFunctionSignatures(
+    const std::string& name);
+
+struct WindowFunctionEntry {
+  std::vector<FunctionSignaturePtr> signatures;
+  WindowFunctionFactory factory;
+};
+
+using WindowFunctionMap = std::unordered_map<std::string, WindowFunctionEntry>;
+
+WindowFunctionMap& windowFunctions();
+
+/// Given a name of window function and argument types, returns the return type
+/// if the function exists. Aggregate functions are resolved using their final
+/// result type. Returns nullptr otherwise.
+TypePtr resolveWindowFunction(
+    const std::string& functionName,
+    const std::vector<TypePtr>& argTypes);
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// A view over the rows of a single window partition. The rows are stored in
+/// the Window operator's RowContainer and are sorted on the ORDER BY keys of
+/// the window. WindowFunctions use this to read the values of their arguments.
+class WindowPartition {
+ public:
+  /// @param data RowContainer holding the input rows. Column indices used in
+  /// extractColumn() are the column indices of 'data'.
+  explicit WindowPartition(RowContainer* data) : data_(data) {}
+
+  /// Replaces the rows of the partition. 'rows' must stay valid until the
+  /// next call.
+  void resetPartition(folly::Range<char**> rows) {
+    rows_ = rows;
+  }
+
+  vector_size_t numRows() const {
+    return rows_.size();
+  }
+
+  /// Copies 'numRows' values of 'columnIndex' starting at 'partitionOffset'
+  /// into 'result' starting at row 0. Resizes 'result' to 'numRows'.
+  void extractColumn(
+      int32_t columnIndex,
+      vector_size_t partitionOffset,
+      vector_size_t numRows,
+      const VectorPtr& result) const {
+    VELOX_CHECK_LE(partitionOffset + numRows, rows_.size());
+    data_->extractColumn(
+        rows_.data() + partitionOffset, numRows, columnIndex, result);
+  }
+
+ private:
+  RowContainer* const data_;
+
+  folly::Range<char**> rows_;
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/exec/DriverExecutor.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+DEFINE_int32(
+    num_threads,
+    0,
+    "Threads of the executors. 0 means one per hardware thread");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
+
+// Measures the fixed costs of running queries, with the Drivers on a folly
+// CPUThreadPoolExecutor and on a DriverExecutor:
+//
+//  task_<n>: Creates, starts and destroys a Task of <n> Drivers that each
+//            produce one row. iters/s is Tasks/s.
+//  resume:   One Driver whose source blocks on a realized future before
+//            each of 10K batches. Each block goes through
+//            BlockingState::setResume(), Driver::enqueue() and Driver::run().
+//            iters/s is round trips/s.
+//  small_query: A filter, project and aggregation over 1K rows with one and
+//            with 4 Drivers. iters/s is queries/s.
+namespace {
+constexpr int32_t kNumBlocks = 10'000;
+
+// A source that blocks on a realized future before each batch.
+class BlockingSourceNode : public core::PlanNode {
+ public:
+  BlockingSourceNode(const core::PlanNodeId& id, RowVectorPtr batch)
+      : PlanNode(id), batch_(std::move(batch)) {}
+
+  const RowTypePtr& outputType() const override {
+    return asRowType(batch_->type());
+  }
+
+  const std::vector<core::PlanNodePtr>& sources() const override {
+    static const std::vector<core::PlanNodePtr> kNoSources;
+    return kNoSources;
+  }
+
+  std::string_view name() const override {
+    return "BlockingSource";
+  }
+
+  const RowVectorPtr& batch() const {
+    return batch_;
+  }
+
+ private:
+  void addDetails(std::stringstream& /* stream */) const override {}
+
+  const RowVectorPtr batch_;
+};
+
+class BlockingSource : public Operator {
+ public:
+  BlockingSource(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const BlockingSourceNode>& node)
+      : Operator(
+            driverCtx,
+            node->outputType(),
+            operatorId,
+            node->id(),
+            "BlockingSource"),
+        batch_(node->batch()) {}
+
+  bool needsInput() const override {
+    return false;
+  }
+
+  void addInput(RowVectorPtr /* input */) override {
+    VELOX_UNREACHABLE();
+  }
+
+  BlockingReason isBlocked(ContinueFuture* future) override {
+    if (resumed_ || isFinished()) {
+      return BlockingReason::kNotBlocked;
+    }
+    resumed_ = true;
+    *future = folly::makeSemiFuture();
+    return BlockingReason::kWaitForConnector;
+  }
+
+  RowVectorPtr getOutput() override {
+    if (!resumed_ || isFinished()) {
+      return nullptr;
+    }
+    resumed_ = false;
+    ++numBatches_;
+    return batch_;
+  }
+
+  bool isFinished() override {
+    return numBatches_ >= kNumBlocks;
+  }
+
+ private:
+  const RowVectorPtr batch_;
+  bool resumed_{false};
+  int32_t numBatches_{0};
+};
+
+class BlockingSourceTranslator : public Operator::PlanNodeTranslator {
+ public:
+  std::unique_ptr<Operator>
+  toOperator(DriverCtx* ctx, int32_t id, const core::PlanNodePtr& node)
+      override {
+    if (auto sourceNode =
+            std::dynamic_pointer_cast<const BlockingSourceNode>(node)) {
+      return std::make_unique<BlockingSource>(id, ctx, sourceNode);
+    }
+    return nullptr;
+  }
+};
+
+class DriverBenchmark {
+ public:
+  DriverBenchmark() {
+    const auto numThreads = FLAGS_num_threads
+        ? FLAGS_num_threads
+        : static_cast<int32_t>(std::thread::hardware_concurrency());
+    cpuExecutor_ =
+        std::make_shared<folly::CPUThreadPoolExecutor>(numThreads);
+    DriverExecutor::Options options;
+    options.numThreads = numThreads;
+    driverExecutor_ = std::make_shared<DriverExecutor>(options);
+
+    row_ = vectorMaker_.rowVector(
+        {vectorMaker_.flatVector<int64_t>(std::vector<int64_t>{1})});
+    smallInput_ = vectorMaker_.rowVector(
+        {vectorMaker_.flatVector<int64_t>(
+             1'000, [](auto row) { return row % 17; }),
+         vectorMaker_.flatVector<double>(
+             1'000, [](auto row) { return row * 0.1; })});
+  }
+
+  // Runs a Task of 'numDrivers' Drivers over a one row Values node.
+  void task(bool driverExecutor, int32_t numDrivers) {
+    folly::BenchmarkSuspender suspender;
+    auto plan = PlanBuilder().values({row_}, true).planFragment();
+    suspender.dismiss();
+    runTask(std::move(plan), driverExecutor, numDrivers);
+  }
+
+  // Runs one Driver that blocks kNumBlocks times. Returns kNumBlocks.
+  unsigned resume(bool driverExecutor) {
+    folly::BenchmarkSuspender suspender;
+    auto plan = PlanBuilder()
+                    .addNode([&](std::string id, core::PlanNodePtr) {
+                      return std::make_shared<BlockingSourceNode>(id, row_);
+                    })
+                    .planFragment();
+    suspender.dismiss();
+    runTask(std::move(plan), driverExecutor, 1);
+    return kNumBlocks;
+  }
+
+  void smallQuery(bool driverExecutor, int32_t numDrivers) {
+    auto plan = PlanBuilder()
+                    .values({smallInput_}, true)
+                    .filter("c1 > 10.0")
+                    .project({"c0", "c1 * 2.0 AS d"})
+                    .partialAggregation({"c0"}, {"sum(d)"})
+                    .localPartition({"c0"})
+                    .finalAggregation()
+                    .planFragment();
+    runTask(std::move(plan), driverExecutor, numDrivers);
+  }
+
+ private:
+  void runTask(
+      core::PlanFragment plan,
+      bool driverExecutor,
+      int32_t numDrivers) {
+    std::shared_ptr<folly::Executor> executor = driverExecutor
+        ? std::static_pointer_cast<folly::Executor>(driverExecutor_)
+        : cpuExecutor_;
+    int64_t numRows = 0;
+    auto task = std::make_shared<Task>(
+        fmt::format("t{}", numTasks_++),
+        std::move(plan),
+        0,
+        core::QueryCtx::createForTest(
+            std::make_shared<core::MemConfig>(), std::move(executor)),
+        [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+          if (vector) {
+            numRows += vector->size();
+          }
+          return BlockingReason::kNotBlocked;
+        });
+    Task::start(task, numDrivers);
+    auto& waitExecutor = folly::QueuedImmediateExecutor::instance();
+    while (task->isRunning()) {
+      task->stateChangeFuture(1'000'000).via(&waitExecutor).wait();
+    }
+    VELOX_CHECK(task->state() == TaskState::kFinished);
+    folly::doNotOptimizeAway(numRows);
+  }
+
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::shared_ptr<folly::CPUThreadPoolExecutor> cpuExecutor_;
+  std::shared_ptr<DriverExecutor> driverExecutor_;
+  RowVectorPtr row_;
+  RowVectorPtr smallInput_;
+  int32_t numTasks_{0};
+};
+
+std::unique_ptr<DriverBenchmark> benchmark;
+
+void task(uint32_t iterations, bool driverExecutor, int32_t numDrivers) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->task(driverExecutor, numDrivers);
+  }
+}
+
+unsigned resume(uint32_t /*iterations*/, bool driverExecutor) {
+  return benchmark->resume(driverExecutor);
+}
+
+void smallQuery(uint32_t iterations, bool driverExecutor, int32_t numDrivers) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->smallQuery(driverExecutor, numDrivers);
+  }
+}
+
+#define EXECUTOR_BENCHMARKS(name, func, numDrivers)                     \
+  BENCHMARK_NAMED_PARAM(func, name##_cpu_executor, false, numDrivers);   \
+  BENCHMARK_RELATIVE_NAMED_PARAM(                                       \
+      func, name##_driver_executor, true, numDrivers)
+
+EXECUTOR_BENCHMARKS(1, task, 1);
+EXECUTOR_BENCHMARKS(4, task, 4);
+EXECUTOR_BENCHMARKS(16, task, 16);
+EXECUTOR_BENCHMARKS(64, task, 64);
+EXECUTOR_BENCHMARKS(256, task, 256);
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM_MULTI(resume, cpu_executor, false);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(resume, driver_executor, true);
+BENCHMARK_DRAW_LINE();
+
+EXECUTOR_BENCHMARKS(1_driver, smallQuery, 1);
+EXECUTOR_BENCHMARKS(4_drivers, smallQuery, 4);
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  functions::prestosql::registerAllScalarFunctions();
+  Operator::registerOperator(std::make_unique<BlockingSourceTranslator>());
+  benchmark = std::make_unique<DriverBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <iostream>
+#include <map>
+#include <thread>
+
+#include "velox/exec/Exchange.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+DEFINE_int32(num_rows, 1'000'000, "Number of rows shuffled end to end");
+DEFINE_int32(num_producer_drivers, 4, "Drivers of the PartitionedOutput task");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+// Measures the shuffle path. The serialize* and deserialize* cases run the
+// registered VectorSerde over 10K rows of one column of a type and encoding
+// and count kilobytes of the serialized page, so that folly's iters/s is
+// KB/s. Kilobytes keep the count of a run within 32 bits. The shuffle* cases
+// run a task with a PartitionedOutput to N consumer tasks with an Exchange
+// and count rows. The high-water marks of
+// the query memory and of the mapped memory of the shuffle cases are printed
+// after the results.
+namespace {
+constexpr int32_t kBatchSize = 10'000;
+
+enum class Encoding { kFlat, kDictionary, kConstant };
+
+class ExchangeBenchmark {
+ public:
+  ExchangeBenchmark() {
+    VectorFuzzer::Options opts;
+    opts.vectorSize = kBatchSize;
+    opts.nullRatio = 0.1;
+    opts.stringVariableLength = true;
+    opts.stringLength = 20;
+    opts.containerLength = 5;
+    VectorFuzzer fuzzer(opts, pool_.get(), 1);
+    auto rowType = ROW({"c0", "c1", "c2"}, {BIGINT(), DOUBLE(), VARCHAR()});
+    for (auto i = 0; i < FLAGS_num_rows; i += kBatchSize) {
+      shuffleInput_.push_back(fuzzer.fuzzRow(rowType));
+    }
+    fuzzer_ = std::make_unique<VectorFuzzer>(opts, pool_.get(), 1);
+  }
+
+  // Returns a one column RowVector of 'type' and 'encoding'.
+  RowVectorPtr makeColumn(const TypePtr& type, Encoding encoding) {
+    VectorPtr column;
+    switch (encoding) {
+      case Encoding::kFlat:
+        column = fuzzer_->fuzzFlat(type);
+        break;
+      case Encoding::kDictionary:
+        column = fuzzer_->fuzzDictionary(fuzzer_->fuzzFlat(type));
+        break;
+      case Encoding::kConstant:
+        column = fuzzer_->fuzzConstant(type);
+        break;
+    }
+    return std::make_shared<RowVector>(
+        pool_.get(),
+        ROW({"c0"}, {type}),
+        nullptr,
+        column->size(),
+        std::vector<VectorPtr>{column});
+  }
+
+  std::string serialize(const RowVectorPtr& vector) {
+    VectorStreamGroup group(memory::MappedMemory::getInstance());
+    group.createStreamTree(asRowType(vector->type()), vector->size());
+    IndexRange range{0, vector->size()};
+    group.append(vector, folly::Range(&range, 1));
+    std::ostringstream out;
+    OStreamOutputStream output(&out);
+    group.flush(&output);
+    return out.str();
+  }
+
+  RowVectorPtr deserialize(const RowTypePtr& type, const std::string& page) {
+    ByteStream input;
+    input.resetInput({ByteRange{
+        reinterpret_cast<uint8_t*>(const_cast<char*>(page.data())),
+        static_cast<int32_t>(page.size()),
+        0}});
+    RowVectorPtr result;
+    VectorStreamGroup::read(&input, pool_.get(), type, &result);
+    return result;
+  }
+
+  // Runs a PartitionedOutput to 'numDestinations' Exchanges. Returns the
+  // number of rows.
+  int64_t shuffle(int32_t numDestinations) {
+    auto queryCtx = core::QueryCtx::createForTest();
+    const auto producerId = fmt::format("local://producer-{}", numTasks_++);
+    auto producerPlan =
+        PlanBuilder()
+            .values(shuffleInput_, true)
+            .partitionedOutput({"c0"}, numDestinations)
+            .planNode();
+    auto producer = std::make_shared<Task>(
+        producerId, core::PlanFragment{producerPlan}, 0, queryCtx);
+
+    std::atomic<int64_t> numRows{0};
+    std::vector<std::shared_ptr<Task>> consumers;
+    for (auto i = 0; i < numDestinations; ++i) {
+      auto consumerPlan = PlanBuilder()
+                              .exchange(asRowType(shuffleInput_[0]->type()))
+                              .planNode();
+      consumers.push_back(std::make_shared<Task>(
+          fmt::format("local://consumer-{}", numTasks_++),
+          core::PlanFragment{consumerPlan},
+          i,
+          queryCtx,
+          [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+            if (vector) {
+              numRows += vector->size();
+            }
+            return BlockingReason::kNotBlocked;
+          }));
+    }
+
+    memory::MachinePageCount peakPages = 0;
+    std::atomic<bool> done{false};
+    std::thread sampler([&]() {
+      while (!done) {
+        peakPages = std::max(
+            peakPages, memory::MappedMemory::getInstance()->numAllocated());
+        // sleep override
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+
+    Task::start(producer, FLAGS_num_producer_drivers);
+    for (auto& consumer : consumers) {
+      Task::start(consumer, 1);
+      consumer->addSplit(
+          "0", Split(std::make_shared<RemoteConnectorSplit>(producerId)));
+      consumer->noMoreSplits("0");
+    }
+    for (auto& consumer : consumers) {
+      waitForFinished(consumer.get());
+    }
+    waitForFinished(producer.get());
+    done = true;
+    sampler.join();
+
+    auto& peak = peaks_[numDestinations];
+    peak.queryBytes =
+        std::max(peak.queryBytes, queryCtx->pool()->getMaxBytes());
+    peak.mappedBytes = std::max<int64_t>(
+        peak.mappedBytes, peakPages * memory::MappedMemory::kPageSize);
+    return numRows;
+  }
+
+  void printPeaks() const {
+    std::cout << "Shuffle memory high-water marks" << std::endl;
+    for (auto& [numDestinations, peak] : peaks_) {
+      std::cout << fmt::format(
+                       "{:>5} destinations: query memory {} MB, mapped "
+                       "memory {} MB",
+                       numDestinations,
+                       peak.queryBytes >> 20,
+                       peak.mappedBytes >> 20)
+                << std::endl;
+    }
+  }
+
+ private:
+  struct Peak {
+    int64_t queryBytes{0};
+    int64_t mappedBytes{0};
+  };
+
+  static void waitForFinished(Task* task) {
+    auto& executor = folly::QueuedImmediateExecutor::instance();
+    while (task->isRunning()) {
+      task->stateChangeFuture(1'000'000).via(&executor).wait();
+    }
+  }
+
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  std::unique_ptr<VectorFuzzer> fuzzer_;
+  std::vector<RowVectorPtr> shuffleInput_;
+  int32_t numTasks_{0};
+  // Keyed on the number of destinations.
+  std::map<int32_t, Peak> peaks_;
+};
+
+std::unique_ptr<ExchangeBenchmark> benchmark;
+
+unsigned serialize(unsigned iters, TypePtr type, Encoding encoding) {
+  folly::BenchmarkSuspender suspender;
+  auto vector = benchmark->makeColumn(type, encoding);
+  suspender.dismiss();
+  size_t numBytes = 0;
+  for (auto i = 0; i < iters; ++i) {
+    numBytes += benchmark->serialize(vector).size();
+  }
+  return numBytes >> 10;
+}
+
+unsigned deserialize(unsigned iters, TypePtr type, Encoding encoding) {
+  folly::BenchmarkSuspender suspender;
+  auto vector = benchmark->makeColumn(type, encoding);
+  auto page = benchmark->serialize(vector);
+  auto rowType = asRowType(vector->type());
+  suspender.dismiss();
+  for (auto i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(benchmark->deserialize(rowType, page));
+  }
+  return (iters * page.size()) >> 10;
+}
+
+unsigned shuffle(unsigned /*iters*/, int32_t numDestinations) {
+  return benchmark->shuffle(numDestinations);
+}
+
+#define SERDE_BENCHMARKS(name, type)                                      \
+  BENCHMARK_NAMED_PARAM_MULTI(                                            \
+      serialize, name##_flat, type, Encoding::kFlat);                     \
+  BENCHMARK_NAMED_PARAM_MULTI(                                            \
+      serialize, name##_dictionary, type, Encoding::kDictionary);         \
+  BENCHMARK_NAMED_PARAM_MULTI(                                            \
+      serialize, name##_constant, type, Encoding::kConstant);             \
+  BENCHMARK_NAMED_PARAM_MULTI(                                            \
+      deserialize, name##_flat, type, Encoding::kFlat);                   \
+  BENCHMARK_NAMED_PARAM_MULTI(                                            \
+      deserialize, name##_dictionary, type, Encoding::kDictionary);       \
+  BENCHMARK_NAMED_PARAM_MULTI(                                            \
+      deserialize, name##_constant, type, Encoding::kConstant);           \
+  BENCHMARK_DRAW_LINE()
+
+SERDE_BENCHMARKS(bigint, BIGINT());
+SERDE_BENCHMARKS(double, DOUBLE());
+SERDE_BENCHMARKS(varchar, VARCHAR());
+SERDE_BENCHMARKS(array, ARRAY(BIGINT()));
+SERDE_BENCHMARKS(map, MAP(BIGINT(), VARCHAR()));
+SERDE_BENCHMARKS(row, ROW({BIGINT(), VARCHAR()}));
+
+BENCHMARK_NAMED_PARAM_MULTI(shuffle, 1, 1);
+BENCHMARK_NAMED_PARAM_MULTI(shuffle, 4, 4);
+BENCHMARK_NAMED_PARAM_MULTI(shuffle, 16, 16);
+BENCHMARK_NAMED_PARAM_MULTI(shuffle, 64, 64);
+BENCHMARK_NAMED_PARAM_MULTI(shuffle, 256, 256);
+BENCHMARK_NAMED_PARAM_MULTI(shuffle, 1024, 1024);
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  ExchangeSource::registerFactory();
+  serializer::presto::PrestoVectorSerde::registerVectorSerde();
+  benchmark = std::make_unique<ExchangeBenchmark>();
+  folly::runBenchmarks();
+  benchmark->printPeaks();
+  benchmark.reset();
+  return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+// Measures TableScan + FilterProject with the projections computed by a
+// ValueHook while the columns are read, relative to the same query with
+// materialized columns.
+namespace {
+constexpr int32_t kNumVectors = 100;
+constexpr int32_t kRowsPerVector = 10'000;
+
+class FilterProjectBenchmark : public HiveConnectorTestBase {
+ public:
+  FilterProjectBenchmark() {
+    HiveConnectorTestBase::SetUp();
+
+    inputType_ = ROW(
+        {"i32", "i64", "f64", "f64_halfnull"},
+        {INTEGER(), BIGINT(), DOUBLE(), DOUBLE()});
+    VectorFuzzer::Options opts;
+    opts.vectorSize = kRowsPerVector;
+    opts.nullRatio = 0;
+    VectorFuzzer fuzzer(opts, pool(), 1);
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < kNumVectors; ++i) {
+      std::vector<VectorPtr> children;
+      children.push_back(fuzzer.fuzzFlat(INTEGER()));
+      children.push_back(fuzzer.fuzzFlat(BIGINT()));
+      children.push_back(fuzzer.fuzzFlat(DOUBLE()));
+      opts.nullRatio = 0.5;
+      fuzzer.setOptions(opts);
+      children.push_back(fuzzer.fuzzFlat(DOUBLE()));
+      opts.nullRatio = 0;
+      fuzzer.setOptions(opts);
+      vectors.push_back(makeRowVector(inputType_->names(), children));
+    }
+    filePath_ = TempFilePath::create();
+    writeToFile(filePath_->path, vectors);
+  }
+
+  ~FilterProjectBenchmark() override {
+    HiveConnectorTestBase::TearDown();
+  }
+
+  void TestBody() override {}
+
+  void run(
+      const std::string& filter,
+      const std::string& projection,
+      bool pushdown) {
+    folly::BenchmarkSuspender suspender;
+    PlanBuilder builder;
+    builder.tableScan(inputType_);
+    if (!filter.empty()) {
+      builder.filter(filter);
+    }
+    auto plan = builder.project({projection}).planFragment();
+
+    vector_size_t numResultRows = 0;
+    auto task = std::make_shared<Task>(
+        "t",
+        std::move(plan),
+        0,
+        core::QueryCtx::createForTest(std::make_shared<core::MemConfig>(
+            std::unordered_map<std::string, std::string>{
+                {core::QueryConfig::kProjectionPushdown,
+                 pushdown ? "true" : "false"}})),
+        [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+          if (vector) {
+            numResultRows += vector->size();
+          }
+          return BlockingReason::kNotBlocked;
+        });
+    task->addSplit("0", Split(makeHiveConnectorSplit(filePath_->path)));
+    task->noMoreSplits("0");
+    suspender.dismiss();
+
+    Task::start(task, 1);
+    auto& executor = folly::QueuedImmediateExecutor::instance();
+    task->stateChangeFuture(60'000'000).via(&executor).wait();
+    folly::doNotOptimizeAway(numResultRows);
+  }
+
+ private:
+  RowTypePtr inputType_;
+  std::shared_ptr<TempFilePath> filePath_;
+};
+
+std::unique_ptr<FilterProjectBenchmark> benchmark;
+
+void materialized(
+    uint32_t,
+    const std::string& filter,
+    const std::string& projection) {
+  benchmark->run(filter, projection, false);
+}
+
+void pushdown(
+    uint32_t,
+    const std::string& filter,
+    const std::string& projection) {
+  benchmark->run(filter, projection, true);
+}
+
+#define PROJECTION_BENCHMARKS(name, filter, projection)                      \
+  BENCHMARK_NAMED_PARAM(materialized, name, filter, projection);             \
+  BENCHMARK_RELATIVE_NAMED_PARAM(pushdown, name, filter, projection);        \
+  BENCHMARK_DRAW_LINE()
+
+PROJECTION_BENCHMARKS(lt_bigint, "", "i64 < 0");
+PROJECTION_BENCHMARKS(multiply_double, "", "f64 * 2.0");
+PROJECTION_BENCHMARKS(multiply_double_nulls, "", "f64_halfnull * 2.0");
+PROJECTION_BENCHMARKS(filter_lt_bigint, "i32 % 2 = 0", "i64 < 0");
+PROJECTION_BENCHMARKS(filter_plus_double, "i32 % 10 = 0", "f64 + 1.5");
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  functions::prestosql::registerAllScalarFunctions();
+  benchmark = std::make_unique<FilterProjectBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
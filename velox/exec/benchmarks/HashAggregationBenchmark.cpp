@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+DEFINE_int64(
+    max_groups,
+    10'000'000,
+    "Largest number of groups. The counts are powers of 10 from 1K up to 1B");
+DEFINE_int32(input_rows, 10'000'000, "Number of input rows");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
+
+// Measures HashAggregation and its GroupingSet end to end in a Task with
+// one Driver. The input has 'input_rows' rows with a grouping key and a
+// BIGINT that is summed and counted. folly's iters/s is input rows/s. The
+// key types and the hash modes they get past 100K groups are:
+//
+//  bigint: dense BIGINT. kArray up to 1M groups, kNormalizedKey above.
+//  sparse: BIGINT spread over 48 bits. kNormalizedKey.
+//  multi:  two BIGINTs spread over 40 bits each. kHash.
+//  varchar: 20 character strings. kHash.
+//
+// Fewer groups are kArray of value ids with any key type. Each case runs
+// as a single aggregation and as a partial aggregation followed by a final
+// one.
+namespace {
+constexpr int32_t kBatchSize = 10'000;
+
+enum class KeyType { kBigint, kSparse, kMulti, kVarchar };
+
+uint64_t hashId(int64_t id) {
+  return folly::hasher<int64_t>()(id);
+}
+
+class HashAggregationBenchmark {
+ public:
+  // Groups the input by 'numGroups' keys of 'keyType'. Returns the number
+  // of input rows.
+  unsigned run(KeyType keyType, int64_t numGroups, bool partial) {
+    folly::BenchmarkSuspender suspender;
+    makeData(keyType, numGroups);
+    auto keys = keyNames(keyType);
+    PlanBuilder builder;
+    builder.values(input_);
+    if (partial) {
+      builder.partialAggregation(keys, {"sum(v)", "count(v)"})
+          .finalAggregation();
+    } else {
+      builder.singleAggregation(keys, {"sum(v)", "count(v)"});
+    }
+    auto plan = builder.planFragment();
+
+    int64_t numResultRows = 0;
+    auto task = std::make_shared<Task>(
+        fmt::format("aggregation-{}", numTasks_++),
+        std::move(plan),
+        0,
+        core::QueryCtx::createForTest(),
+        [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+          if (vector) {
+            numResultRows += vector->size();
+          }
+          return BlockingReason::kNotBlocked;
+        });
+    suspender.dismiss();
+
+    Task::start(task, 1);
+    auto& executor = folly::QueuedImmediateExecutor::instance();
+    while (task->isRunning()) {
+      task->stateChangeFuture(1'000'000).via(&executor).wait();
+    }
+    folly::doNotOptimizeAway(numResultRows);
+    return FLAGS_input_rows;
+  }
+
+ private:
+  static std::vector<std::string> keyNames(KeyType keyType) {
+    if (keyType == KeyType::kMulti) {
+      return {"k0", "k1"};
+    }
+    return {"k"};
+  }
+
+  // Returns the key columns for the keys of 'ids'.
+  std::vector<VectorPtr> makeKeys(
+      KeyType keyType,
+      const std::function<int64_t(vector_size_t)>& ids,
+      vector_size_t size) {
+    switch (keyType) {
+      case KeyType::kBigint:
+        return {vectorMaker_.flatVector<int64_t>(size, ids)};
+      case KeyType::kSparse:
+        return {vectorMaker_.flatVector<int64_t>(size, [&](auto row) {
+          return static_cast<int64_t>(hashId(ids(row)) & ((1L << 48) - 1));
+        })};
+      case KeyType::kMulti:
+        return {
+            vectorMaker_.flatVector<int64_t>(
+                size,
+                [&](auto row) {
+                  return static_cast<int64_t>(
+                      hashId(ids(row)) & ((1L << 40) - 1));
+                }),
+            vectorMaker_.flatVector<int64_t>(size, [&](auto row) {
+              return static_cast<int64_t>(hashId(ids(row)) >> 24);
+            })};
+      case KeyType::kVarchar: {
+        std::vector<std::string> strings(size);
+        for (auto i = 0; i < size; ++i) {
+          strings[i] = fmt::format("{:020}", hashId(ids(i)) % 100'000'000'000);
+        }
+        return {vectorMaker_.flatVector(strings)};
+      }
+    }
+    VELOX_UNREACHABLE();
+  }
+
+  // Makes the input with the keys of ids below 'numGroups' in a scattered
+  // order.
+  void makeData(KeyType keyType, int64_t numGroups) {
+    if (keyType == keyType_ && numGroups == numGroups_) {
+      return;
+    }
+    input_.clear();
+    auto names = keyNames(keyType);
+    names.push_back("v");
+    for (int64_t i = 0; i < FLAGS_input_rows; i += kBatchSize) {
+      const auto size = std::min<int64_t>(kBatchSize, FLAGS_input_rows - i);
+      auto children = makeKeys(
+          keyType,
+          [&](auto row) { return (i + row) * 7919 % numGroups; },
+          size);
+      children.push_back(vectorMaker_.flatVector<int64_t>(
+          size, [&](auto row) { return i + row; }));
+      input_.push_back(vectorMaker_.rowVector(names, children));
+    }
+    keyType_ = keyType;
+    numGroups_ = numGroups;
+  }
+
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::vector<RowVectorPtr> input_;
+  // The parameters 'input_' is made for.
+  KeyType keyType_{KeyType::kBigint};
+  int64_t numGroups_{0};
+  int32_t numTasks_{0};
+};
+
+std::unique_ptr<HashAggregationBenchmark> benchmark;
+
+void registerBenchmarks() {
+  const std::vector<std::pair<const char*, KeyType>> keyTypes = {
+      {"bigint", KeyType::kBigint},
+      {"sparse", KeyType::kSparse},
+      {"multi", KeyType::kMulti},
+      {"varchar", KeyType::kVarchar}};
+  for (const auto& [keyName, keyType] : keyTypes) {
+    for (int64_t numGroups = 1'000; numGroups <= FLAGS_max_groups;
+         numGroups *= 10) {
+      folly::addBenchmark(
+          __FILE__,
+          fmt::format("single_{}_{}", keyName, numGroups),
+          [keyType = keyType, numGroups](unsigned /*iters*/) {
+            return benchmark->run(keyType, numGroups, false);
+          });
+      folly::addBenchmark(
+          __FILE__,
+          fmt::format("%partial_final_{}_{}", keyName, numGroups),
+          [keyType = keyType, numGroups](unsigned /*iters*/) {
+            return benchmark->run(keyType, numGroups, true);
+          });
+    }
+    folly::addBenchmark(__FILE__, "-", []() -> unsigned { return 0; });
+  }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<HashAggregationBenchmark>();
+  registerBenchmarks();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
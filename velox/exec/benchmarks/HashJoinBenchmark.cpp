@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/String.h>
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+DEFINE_int64(
+    max_build_rows,
+    10'000'000,
+    "Largest build side. The sizes are powers of 10 from 1K up to 1B");
+DEFINE_int32(probe_rows, 10'000'000, "Number of probe side rows");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
+
+// Measures HashBuild + HashProbe end to end in a Task with one Driver per
+// pipeline. folly's iters/s is probe rows/s. The build side has a key and
+// a BIGINT payload. The key types and the hash modes they get for builds
+// past 100K rows are:
+//
+//  bigint: dense BIGINT. kArray up to 1M rows, kNormalizedKey above.
+//  sparse: BIGINT spread over 48 bits. kNormalizedKey.
+//  multi:  two BIGINTs spread over 40 bits each. kHash.
+//  varchar: 20 character strings. kHash.
+//
+// Smaller builds have few enough distinct keys to be kArray of value ids
+// with any key type. A probe row hits with the probability of the hit rate.
+// The cases are: every key type and build size with an inner join and a 50%
+// hit rate, hit rates from 1% to 100% for a 1M row sparse build, and the
+// join types for a 1M row sparse build with a 50% hit rate.
+namespace {
+constexpr int32_t kBatchSize = 10'000;
+
+enum class KeyType { kBigint, kSparse, kMulti, kVarchar };
+
+uint64_t hashId(int64_t id) {
+  return folly::hasher<int64_t>()(id);
+}
+
+class HashJoinBenchmark {
+ public:
+  // Runs a 'joinType' join of 'numBuildRows' build rows with 'keyType'
+  // keys and a probe side with 'hitPct' percent hits. Returns the number of
+  // probe rows.
+  unsigned run(
+      KeyType keyType,
+      int64_t numBuildRows,
+      int32_t hitPct,
+      core::JoinType joinType) {
+    folly::BenchmarkSuspender suspender;
+    makeData(keyType, numBuildRows, hitPct);
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    std::vector<std::string> outputLayout = {"p_v"};
+    if (joinType != core::JoinType::kLeftSemi &&
+        joinType != core::JoinType::kAnti) {
+      outputLayout.push_back("b_v");
+    }
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probe_)
+                    .hashJoin(
+                        keyNames("p_", keyType),
+                        keyNames("b_", keyType),
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(build_)
+                            .planNode(),
+                        "",
+                        outputLayout,
+                        joinType)
+                    .planFragment();
+
+    int64_t numResultRows = 0;
+    auto task = std::make_shared<Task>(
+        fmt::format("join-{}", numTasks_++),
+        std::move(plan),
+        0,
+        core::QueryCtx::createForTest(),
+        [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+          if (vector) {
+            numResultRows += vector->size();
+          }
+          return BlockingReason::kNotBlocked;
+        });
+    suspender.dismiss();
+
+    Task::start(task, 1);
+    auto& executor = folly::QueuedImmediateExecutor::instance();
+    while (task->isRunning()) {
+      task->stateChangeFuture(1'000'000).via(&executor).wait();
+    }
+    folly::doNotOptimizeAway(numResultRows);
+    return FLAGS_probe_rows;
+  }
+
+ private:
+  static std::vector<std::string> keyNames(
+      const std::string& prefix,
+      KeyType keyType) {
+    if (keyType == KeyType::kMulti) {
+      return {prefix + "k0", prefix + "k1"};
+    }
+    return {prefix + "k"};
+  }
+
+  // Returns the key columns for the keys of 'ids'.
+  std::vector<VectorPtr> makeKeys(
+      KeyType keyType,
+      const std::function<int64_t(vector_size_t)>& ids,
+      vector_size_t size) {
+    switch (keyType) {
+      case KeyType::kBigint:
+        return {vectorMaker_.flatVector<int64_t>(size, ids)};
+      case KeyType::kSparse:
+        return {vectorMaker_.flatVector<int64_t>(size, [&](auto row) {
+          return static_cast<int64_t>(hashId(ids(row)) & ((1L << 48) - 1));
+        })};
+      case KeyType::kMulti:
+        return {
+            vectorMaker_.flatVector<int64_t>(
+                size,
+                [&](auto row) {
+                  return static_cast<int64_t>(
+                      hashId(ids(row)) & ((1L << 40) - 1));
+                }),
+            vectorMaker_.flatVector<int64_t>(size, [&](auto row) {
+              return static_cast<int64_t>(hashId(ids(row)) >> 24);
+            })};
+      case KeyType::kVarchar: {
+        std::vector<std::string> strings(size);
+        for (auto i = 0; i < size; ++i) {
+          strings[i] = fmt::format("{:020}", hashId(ids(i)) % 100'000'000'000);
+        }
+        return {vectorMaker_.flatVector(strings)};
+      }
+    }
+    VELOX_UNREACHABLE();
+  }
+
+  std::vector<std::string> columnNames(
+      const std::string& prefix,
+      KeyType keyType) {
+    auto names = keyNames(prefix, keyType);
+    names.push_back(prefix + "v");
+    return names;
+  }
+
+  // Makes the build side with the keys of the even ids below 2 *
+  // 'numBuildRows' and the probe side with hits for 'hitPct' percent of the
+  // rows. The misses are odd ids.
+  void makeData(KeyType keyType, int64_t numBuildRows, int32_t hitPct) {
+    if (keyType == keyType_ && numBuildRows == numBuildRows_ &&
+        hitPct == hitPct_) {
+      return;
+    }
+    build_.clear();
+    probe_.clear();
+    for (int64_t i = 0; i < numBuildRows; i += kBatchSize) {
+      const auto size = std::min<int64_t>(kBatchSize, numBuildRows - i);
+      auto children = makeKeys(
+          keyType, [&](auto row) { return (i + row) * 2; }, size);
+      children.push_back(vectorMaker_.flatVector<int64_t>(
+          size, [&](auto row) { return i + row; }));
+      build_.push_back(
+          vectorMaker_.rowVector(columnNames("b_", keyType), children));
+    }
+    for (int64_t i = 0; i < FLAGS_probe_rows; i += kBatchSize) {
+      const auto size = std::min<int64_t>(kBatchSize, FLAGS_probe_rows - i);
+      auto children = makeKeys(
+          keyType,
+          [&](auto row) -> int64_t {
+            const auto id = (i + row) * 7919 % numBuildRows * 2;
+            return (i + row) % 100 < hitPct ? id : id + 1;
+          },
+          size);
+      children.push_back(vectorMaker_.flatVector<int64_t>(
+          size, [&](auto row) { return i + row; }));
+      probe_.push_back(
+          vectorMaker_.rowVector(columnNames("p_", keyType), children));
+    }
+    keyType_ = keyType;
+    numBuildRows_ = numBuildRows;
+    hitPct_ = hitPct;
+  }
+
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::vector<RowVectorPtr> build_;
+  std::vector<RowVectorPtr> probe_;
+  // The parameters 'build_' and 'probe_' are made for.
+  KeyType keyType_{KeyType::kBigint};
+  int64_t numBuildRows_{0};
+  int32_t hitPct_{0};
+  int32_t numTasks_{0};
+};
+
+std::unique_ptr<HashJoinBenchmark> benchmark;
+
+void registerBenchmarks() {
+  const std::vector<std::pair<const char*, KeyType>> keyTypes = {
+      {"bigint", KeyType::kBigint},
+      {"sparse", KeyType::kSparse},
+      {"multi", KeyType::kMulti},
+      {"varchar", KeyType::kVarchar}};
+  for (const auto& [keyName, keyType] : keyTypes) {
+    for (int64_t numBuildRows = 1'000; numBuildRows <= FLAGS_max_build_rows;
+         numBuildRows *= 10) {
+      folly::addBenchmark(
+          __FILE__,
+          fmt::format("inner_{}_{}", keyName, numBuildRows),
+          [keyType = keyType, numBuildRows](unsigned /*iters*/) {
+            return benchmark->run(
+                keyType, numBuildRows, 50, core::JoinType::kInner);
+          });
+    }
+    folly::addBenchmark(__FILE__, "-", []() -> unsigned { return 0; });
+  }
+
+  const int64_t kBuildRows = std::min<int64_t>(1'000'000, FLAGS_max_build_rows);
+  for (auto hitPct : {1, 10, 50, 100}) {
+    folly::addBenchmark(
+        __FILE__,
+        fmt::format("inner_sparse_{}pct_hits", hitPct),
+        [kBuildRows, hitPct](unsigned /*iters*/) {
+          return benchmark->run(
+              KeyType::kSparse, kBuildRows, hitPct, core::JoinType::kInner);
+        });
+  }
+  folly::addBenchmark(__FILE__, "-", []() -> unsigned { return 0; });
+
+  for (auto joinType :
+       {core::JoinType::kInner,
+        core::JoinType::kLeft,
+        core::JoinType::kRight,
+        core::JoinType::kFull,
+        core::JoinType::kLeftSemi,
+        core::JoinType::kAnti}) {
+    std::string joinName = core::joinTypeName(joinType);
+    folly::toLowerAscii(joinName);
+    folly::addBenchmark(
+        __FILE__,
+        fmt::format("{}_sparse", joinName),
+        [kBuildRows, joinType](unsigned /*iters*/) {
+          return benchmark->run(KeyType::kSparse, kBuildRows, 50, joinType);
+        });
+  }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<HashJoinBenchmark>();
+  registerBenchmarks();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/exec/HashBuild.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+DEFINE_int32(build_rows, 10'000'000, "Number of build side rows");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+// Measures the time for combining the tables of the HashBuild Drivers into
+// one join table in HashTable::prepareJoinTable(). The build side has
+// 'build_rows' rows with a sparse BIGINT key and a BIGINT payload and is
+// split evenly between the Drivers, each filling its own table as HashBuild
+// does. The serial cases insert all rows on one thread. The parallel cases
+// use one thread per Driver.
+namespace {
+constexpr int32_t kBatchSize = 10'000;
+
+class HashJoinBuildBenchmark {
+ public:
+  HashJoinBuildBenchmark() {
+    for (auto i = 0; i < FLAGS_build_rows; i += kBatchSize) {
+      batches_.push_back(vectorMaker_.rowVector({
+          vectorMaker_.flatVector<int64_t>(
+              kBatchSize,
+              [i](auto row) {
+                return folly::hasher<int64_t>()(i + row) & ((1L << 48) - 1);
+              }),
+          vectorMaker_.flatVector<int64_t>(
+              kBatchSize, [i](auto row) { return i + row; }),
+      }));
+    }
+  }
+
+  void run(int32_t numDrivers, bool parallel) {
+    std::vector<std::unique_ptr<BaseHashTable>> tables;
+    std::unique_ptr<folly::CPUThreadPoolExecutor> executor;
+    BENCHMARK_SUSPEND {
+      for (auto i = 0; i < numDrivers; ++i) {
+        tables.push_back(makeTable());
+      }
+      for (auto i = 0; i < batches_.size(); ++i) {
+        addBatch(*batches_[i], *tables[i % numDrivers]);
+      }
+      if (parallel) {
+        executor = std::make_unique<folly::CPUThreadPoolExecutor>(numDrivers);
+      }
+    }
+    auto table = std::move(tables[0]);
+    tables.erase(tables.begin());
+    table->prepareJoinTable(std::move(tables), executor.get());
+    folly::doNotOptimizeAway(table->numDistinct());
+    BENCHMARK_SUSPEND {
+      table.reset();
+      executor.reset();
+    }
+  }
+
+ private:
+  std::unique_ptr<BaseHashTable> makeTable() {
+    std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+    keyHashers.push_back(std::make_unique<VectorHasher>(BIGINT(), 0));
+    return HashTable<true>::createForJoin(
+        std::move(keyHashers), {BIGINT()}, true, false, mappedMemory_);
+  }
+
+  void addBatch(const RowVector& batch, BaseHashTable& table) {
+    SelectivityVector rows(batch.size());
+    bool analyzeKeys = false;
+    storeJoinBuildRows(
+        table, batch, rows, {1}, decoders_, analyzeKeys, hashes_);
+  }
+
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  memory::MappedMemory* mappedMemory_{memory::MappedMemory::getInstance()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::vector<RowVectorPtr> batches_;
+  std::vector<std::unique_ptr<DecodedVector>> decoders_{
+      std::make_unique<DecodedVector>()};
+  raw_vector<uint64_t> hashes_;
+};
+
+std::unique_ptr<HashJoinBuildBenchmark> benchmark;
+
+void serialBuild(uint32_t iterations, int32_t numDrivers) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run(numDrivers, false);
+  }
+}
+
+void parallelBuild(uint32_t iterations, int32_t numDrivers) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run(numDrivers, true);
+  }
+}
+} // namespace
+
+BENCHMARK_NAMED_PARAM(serialBuild, 1_driver, 1);
+BENCHMARK_NAMED_PARAM(serialBuild, 2_drivers, 2);
+BENCHMARK_RELATIVE_NAMED_PARAM(parallelBuild, 2_drivers, 2);
+BENCHMARK_NAMED_PARAM(serialBuild, 4_drivers, 4);
+BENCHMARK_RELATIVE_NAMED_PARAM(parallelBuild, 4_drivers, 4);
+BENCHMARK_NAMED_PARAM(serialBuild, 8_drivers, 8);
+BENCHMARK_RELATIVE_NAMED_PARAM(parallelBuild, 8_drivers, 8);
+BENCHMARK_NAMED_PARAM(serialBuild, 16_drivers, 16);
+BENCHMARK_RELATIVE_NAMED_PARAM(parallelBuild, 16_drivers, 16);
+BENCHMARK_NAMED_PARAM(serialBuild, 32_drivers, 32);
+BENCHMARK_RELATIVE_NAMED_PARAM(parallelBuild, 32_drivers, 32);
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<HashJoinBuildBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
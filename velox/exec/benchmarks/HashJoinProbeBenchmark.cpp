@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/exec/HashBuild.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+DEFINE_int32(probe_rows, 10'000'000, "Number of probe side rows");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+// Measures HashTable::joinProbe() with tags and row pointers in separate
+// arrays and in interleaved buckets. The build side has a sparse BIGINT key
+// and the table is in kHash mode. Half of the 'probe_rows' probe keys hit.
+// The build side sizes range from fitting in the L2 cache to well past the
+// last level cache.
+namespace {
+constexpr int32_t kBatchSize = 10'000;
+
+int64_t sparseKey(int64_t i) {
+  return folly::hasher<int64_t>()(i) & ((1L << 48) - 1);
+}
+
+class HashJoinProbeBenchmark {
+ public:
+  void run(int32_t numBuildRows, BaseHashTable::Layout layout) {
+    std::unique_ptr<BaseHashTable> table;
+    BENCHMARK_SUSPEND {
+      table = makeTable(numBuildRows, layout);
+      makeProbeBatches(numBuildRows);
+    }
+    HashLookup lookup(table->hashers());
+    SelectivityVector rows(kBatchSize);
+    int64_t numHits = 0;
+    for (auto& batch : probeBatches_) {
+      lookup.reset(kBatchSize);
+      lookup.rows.resize(kBatchSize);
+      std::iota(lookup.rows.begin(), lookup.rows.end(), 0);
+      table->hashers()[0]->hash(*batch->childAt(0), rows, false, lookup.hashes);
+      table->joinProbe(lookup);
+      for (auto hit : lookup.hits) {
+        numHits += hit != nullptr;
+      }
+    }
+    folly::doNotOptimizeAway(numHits);
+    BENCHMARK_SUSPEND {
+      table.reset();
+    }
+  }
+
+ private:
+  // The build side has the keys for the even numbers below 2 *
+  // 'numBuildRows'. The even probe rows hit and the odd ones miss.
+  void makeProbeBatches(int32_t numBuildRows) {
+    if (numProbeBuildRows_ == numBuildRows) {
+      return;
+    }
+    probeBatches_.clear();
+    for (auto i = 0; i < FLAGS_probe_rows; i += kBatchSize) {
+      probeBatches_.push_back(vectorMaker_.rowVector({
+          vectorMaker_.flatVector<int64_t>(
+              kBatchSize,
+              [&](auto row) {
+                return sparseKey((i + row) % numBuildRows * 2 + row % 2);
+              }),
+      }));
+    }
+    numProbeBuildRows_ = numBuildRows;
+  }
+
+  std::unique_ptr<BaseHashTable> makeTable(
+      int32_t numBuildRows,
+      BaseHashTable::Layout layout) {
+    std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+    keyHashers.push_back(std::make_unique<VectorHasher>(BIGINT(), 0));
+    auto table = HashTable<true>::createForJoin(
+        std::move(keyHashers), {}, true, false, mappedMemory_, layout);
+    table->forceGenericHashMode();
+    std::vector<std::unique_ptr<DecodedVector>> decoders;
+    raw_vector<uint64_t> hashes;
+    for (auto i = 0; i < numBuildRows; i += kBatchSize) {
+      auto size = std::min(kBatchSize, numBuildRows - i);
+      auto batch = vectorMaker_.rowVector({
+          vectorMaker_.flatVector<int64_t>(
+              size, [&](auto row) { return sparseKey((i + row) * 2); }),
+      });
+      SelectivityVector rows(size);
+      bool analyzeKeys = false;
+      storeJoinBuildRows(
+          *table, *batch, rows, {}, decoders, analyzeKeys, hashes);
+    }
+    table->prepareJoinTable({});
+    return table;
+  }
+
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  memory::MappedMemory* mappedMemory_{memory::MappedMemory::getInstance()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::vector<RowVectorPtr> probeBatches_;
+  // Build side size 'probeBatches_' are made for.
+  int32_t numProbeBuildRows_{0};
+};
+
+std::unique_ptr<HashJoinProbeBenchmark> benchmark;
+
+void separate(uint32_t iterations, int32_t numBuildRows) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run(numBuildRows, BaseHashTable::Layout::kSeparate);
+  }
+}
+
+void interleaved(uint32_t iterations, int32_t numBuildRows) {
+  for (auto i = 0; i < iterations; ++i) {
+    benchmark->run(numBuildRows, BaseHashTable::Layout::kInterleaved);
+  }
+}
+} // namespace
+
+BENCHMARK_NAMED_PARAM(separate, 10K, 10'000);
+BENCHMARK_RELATIVE_NAMED_PARAM(interleaved, 10K, 10'000);
+BENCHMARK_NAMED_PARAM(separate, 100K, 100'000);
+BENCHMARK_RELATIVE_NAMED_PARAM(interleaved, 100K, 100'000);
+BENCHMARK_NAMED_PARAM(separate, 1M, 1'000'000);
+BENCHMARK_RELATIVE_NAMED_PARAM(interleaved, 1M, 1'000'000);
+BENCHMARK_NAMED_PARAM(separate, 10M, 10'000'000);
+BENCHMARK_RELATIVE_NAMED_PARAM(interleaved, 10M, 10'000'000);
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<HashJoinProbeBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
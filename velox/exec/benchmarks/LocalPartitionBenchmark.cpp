@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <thread>
+
+#include "velox/exec/LocalPartition.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+DEFINE_int32(num_rows, 1'000'000, "Number of input rows");
+DEFINE_int32(num_vectors, 100'000, "Number of vectors passed through a queue");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
+
+// Measures the scaling of local exchange. The queue* cases pass
+// --num_vectors small vectors from N producer to M consumer threads through
+// a single LocalExchangeQueue. The repartition* and aggregation* cases run a
+// LocalPartition plan with a growing number of Drivers.
+namespace {
+constexpr int32_t kBatchSize = 1'000;
+
+class LocalPartitionBenchmark {
+ public:
+  LocalPartitionBenchmark() {
+    for (auto i = 0; i < FLAGS_num_rows; i += kBatchSize) {
+      batches_.push_back(vectorMaker_.rowVector({
+          vectorMaker_.flatVector<int64_t>(
+              kBatchSize, [i](auto row) { return (i + row) % 10'000; }),
+          vectorMaker_.flatVector<double>(
+              kBatchSize, [i](auto row) { return (i + row) / 10.0; }),
+      }));
+    }
+    smallVector_ = vectorMaker_.rowVector({
+        vectorMaker_.flatVector<int64_t>(10, [](auto row) { return row; }),
+    });
+  }
+
+  void queue(int32_t numProducers, int32_t numConsumers) {
+    auto memoryManager =
+        std::make_shared<LocalExchangeMemoryManager>(32 << 20);
+    auto queue = std::make_shared<LocalExchangeQueue>(memoryManager, 0);
+    for (auto i = 0; i < numProducers; ++i) {
+      queue->addProducer();
+    }
+    queue->noMoreProducers();
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < numProducers; ++i) {
+      threads.emplace_back([&]() {
+        for (auto j = 0; j < FLAGS_num_vectors / numProducers; ++j) {
+          ContinueFuture future;
+          if (queue->enqueue(smallVector_, &future) !=
+              BlockingReason::kNotBlocked) {
+            future.wait();
+          }
+        }
+        queue->noMoreData();
+      });
+    }
+    for (auto i = 0; i < numConsumers; ++i) {
+      threads.emplace_back([&]() {
+        for (;;) {
+          ContinueFuture future;
+          RowVectorPtr data;
+          if (queue->next(&future, pool_.get(), &data) !=
+              BlockingReason::kNotBlocked) {
+            future.wait();
+          } else if (!data) {
+            return;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void repartition(int32_t numDrivers) {
+    auto plan = PlanBuilder()
+                    .values(batches_, true)
+                    .localPartition({"c0"})
+                    .singleAggregation({}, {"count(1)"})
+                    .planNode();
+    run(plan, numDrivers);
+  }
+
+  void aggregation(int32_t numDrivers) {
+    auto plan = PlanBuilder()
+                    .values(batches_, true)
+                    .partialAggregation({"c0"}, {"sum(c1)"})
+                    .localPartition({"c0"})
+                    .finalAggregation()
+                    .planNode();
+    run(plan, numDrivers);
+  }
+
+ private:
+  void run(const core::PlanNodePtr& plan, int32_t numDrivers) {
+    folly::doNotOptimizeAway(AssertQueryBuilder(plan)
+                                 .maxDrivers(numDrivers)
+                                 .copyResults(pool_.get())
+                                 ->size());
+  }
+
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::vector<RowVectorPtr> batches_;
+  RowVectorPtr smallVector_;
+};
+
+std::unique_ptr<LocalPartitionBenchmark> benchmark;
+
+void queue(uint32_t /*iters*/, int32_t numProducers, int32_t numConsumers) {
+  benchmark->queue(numProducers, numConsumers);
+}
+
+void repartition(uint32_t /*iters*/, int32_t numDrivers) {
+  benchmark->repartition(numDrivers);
+}
+
+void aggregation(uint32_t /*iters*/, int32_t numDrivers) {
+  benchmark->aggregation(numDrivers);
+}
+
+BENCHMARK_NAMED_PARAM(queue, 1x1, 1, 1);
+BENCHMARK_NAMED_PARAM(queue, 4x1, 4, 1);
+BENCHMARK_NAMED_PARAM(queue, 4x4, 4, 4);
+BENCHMARK_NAMED_PARAM(queue, 16x4, 16, 4);
+BENCHMARK_NAMED_PARAM(queue, 16x16, 16, 16);
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(repartition, 1, 1);
+BENCHMARK_NAMED_PARAM(repartition, 4, 4);
+BENCHMARK_NAMED_PARAM(repartition, 16, 16);
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(aggregation, 1, 1);
+BENCHMARK_NAMED_PARAM(aggregation, 4, 4);
+BENCHMARK_NAMED_PARAM(aggregation, 16, 16);
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<LocalPartitionBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
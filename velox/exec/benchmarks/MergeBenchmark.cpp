@@ -26,6 +26,8 @@ using namespace facebook::velox::exec::test;
 TestData narrow;
 TestData medium;
 TestData wide;
+// Non-overlapping ranges of rows, e.g. time partitioned data.
+TestData ranges;
 
 BENCHMARK(narrowTree) {
   MergeTestBase::test<TreeOfLosers<TestingStream>>(narrow, false);
@@ -43,6 +45,10 @@ BENCHMARK_RELATIVE(mediumArray) {
   MergeTestBase::test<MergeArray<TestingStream>>(medium, false);
 }
 
+BENCHMARK_RELATIVE(mediumRuns) {
+  MergeTestBase::testRuns(medium, false);
+}
+
 BENCHMARK(wideTree) {
   MergeTestBase::test<TreeOfLosers<TestingStream>>(wide, false);
 }
@@ -51,6 +57,14 @@ BENCHMARK_RELATIVE(wideArray) {
   MergeTestBase::test<MergeArray<TestingStream>>(wide, false);
 }
 
+BENCHMARK(rangesTree) {
+  MergeTestBase::test<TreeOfLosers<TestingStream>>(ranges, false);
+}
+
+BENCHMARK_RELATIVE(rangesRuns) {
+  MergeTestBase::testRuns(ranges, false);
+}
+
 int main(int argc, char* argv[]) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
   MergeTestBase test;
@@ -58,6 +72,7 @@ int main(int argc, char* argv[]) {
   narrow = test.makeTestData(100'000'000, 7);
   medium = test.makeTestData(10'000'0000, 37);
   wide = test.makeTestData(10'000'0000, 1029);
+  ranges = MergeTestBase::makeRangeTestData(100'000'000, 37, 10'000);
   folly::runBenchmarks();
   return 0;
 }
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <deque>
+
+#include "velox/exec/PrefixSort.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+DEFINE_int32(num_rows, 1'000'000, "Number of input rows");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
+
+// Measures sorting rows with single and multi-column keys of BIGINT, INTEGER,
+// DOUBLE and VARCHAR type. The *Compare cases sort pointers to rows of a
+// RowContainer with RowContainer::compareRows(), the *Prefix cases with
+// PrefixSort. The orderBy* and topN* cases run OrderBy and TopN (N = 100)
+// plans over the same data.
+namespace {
+constexpr int32_t kBatchSize = 10'000;
+
+class OrderByBenchmark {
+ public:
+  OrderByBenchmark() {
+    for (auto i = 0; i < FLAGS_num_rows; i += kBatchSize) {
+      batches_.push_back(vectorMaker_.rowVector({
+          vectorMaker_.flatVector<int64_t>(
+              kBatchSize,
+              [i](auto row) {
+                return folly::hasher<int64_t>()(i + row) % 10'000'000;
+              }),
+          vectorMaker_.flatVector<int32_t>(
+              kBatchSize, [i](auto row) { return (i + row) % 37; }),
+          vectorMaker_.flatVector<double>(
+              kBatchSize,
+              [i](auto row) { return ((i + row) * 7919 % 1'000) / 10.0; }),
+          // Strings with a common 8 character prefix, half of them longer
+          // than the inline size of StringView.
+          vectorMaker_.flatVector<StringView>(
+              kBatchSize,
+              [&, i](auto row) {
+                strings_.push_back(fmt::format(
+                    "shipment{}{}",
+                    folly::hasher<int64_t>()(i + row) % 100'000,
+                    (i + row) % 2 ? "-international" : ""));
+                return StringView(strings_.back());
+              }),
+      }));
+    }
+  }
+
+  void sort(const std::vector<PrefixSort::SortKey>& keys, bool prefix) {
+    std::unique_ptr<RowContainer> data;
+    std::vector<char*> rows;
+    BENCHMARK_SUSPEND {
+      data = makeRowContainer();
+      rows.resize(data->numRows());
+      RowContainerIterator iter;
+      data->listRows(&iter, rows.size(), rows.data());
+    }
+    if (prefix) {
+      PrefixSort::sort(
+          *data, keys, folly::Range<char**>(rows.data(), rows.size()));
+    } else {
+      std::sort(
+          rows.begin(), rows.end(), [&](const char* left, const char* right) {
+            for (const auto& key : keys) {
+              if (auto result =
+                      data->compare(left, right, key.first, key.second)) {
+                return result < 0;
+              }
+            }
+            return false;
+          });
+    }
+    folly::doNotOptimizeAway(rows.front());
+    BENCHMARK_SUSPEND {
+      data.reset();
+    }
+  }
+
+  void orderBy(const std::vector<std::string>& keys) {
+    auto plan = PlanBuilder().values(batches_).orderBy(keys, false).planNode();
+    folly::doNotOptimizeAway(
+        AssertQueryBuilder(plan).copyResults(pool_.get())->size());
+  }
+
+  void topN(const std::vector<std::string>& keys) {
+    auto plan =
+        PlanBuilder().values(batches_).topN(keys, 100, false).planNode();
+    folly::doNotOptimizeAway(
+        AssertQueryBuilder(plan).copyResults(pool_.get())->size());
+  }
+
+ private:
+  std::unique_ptr<RowContainer> makeRowContainer() {
+    auto type = batches_[0]->type()->as<TypeKind::ROW>().children();
+    auto data = std::make_unique<RowContainer>(type, mappedMemory_);
+    SelectivityVector allRows(kBatchSize);
+    std::vector<char*> rows(kBatchSize);
+    for (const auto& batch : batches_) {
+      for (auto i = 0; i < batch->size(); ++i) {
+        rows[i] = data->newRow();
+      }
+      for (auto column = 0; column < batch->childrenSize(); ++column) {
+        decoded_.decode(*batch->childAt(column), allRows);
+        for (auto i = 0; i < batch->size(); ++i) {
+          data->store(decoded_, i, rows[i], column);
+        }
+      }
+    }
+    return data;
+  }
+
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  memory::MappedMemory* mappedMemory_{memory::MappedMemory::getInstance()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::deque<std::string> strings_;
+  std::vector<RowVectorPtr> batches_;
+  DecodedVector decoded_;
+};
+
+std::unique_ptr<OrderByBenchmark> benchmark;
+
+const std::vector<PrefixSort::SortKey> kBigint = {{0, {}}};
+const std::vector<PrefixSort::SortKey> kMultiColumn = {
+    {1, {}},
+    {2, {true, false, false}},
+    {0, {}}};
+const std::vector<PrefixSort::SortKey> kVarchar = {{3, {}}};
+const std::vector<PrefixSort::SortKey> kVarcharBigint = {{3, {}}, {0, {}}};
+
+BENCHMARK(bigintCompare) {
+  benchmark->sort(kBigint, false);
+}
+
+BENCHMARK_RELATIVE(bigintPrefix) {
+  benchmark->sort(kBigint, true);
+}
+
+BENCHMARK(multiColumnCompare) {
+  benchmark->sort(kMultiColumn, false);
+}
+
+BENCHMARK_RELATIVE(multiColumnPrefix) {
+  benchmark->sort(kMultiColumn, true);
+}
+
+BENCHMARK(varcharCompare) {
+  benchmark->sort(kVarchar, false);
+}
+
+BENCHMARK_RELATIVE(varcharPrefix) {
+  benchmark->sort(kVarchar, true);
+}
+
+BENCHMARK(varcharBigintCompare) {
+  benchmark->sort(kVarcharBigint, false);
+}
+
+BENCHMARK_RELATIVE(varcharBigintPrefix) {
+  benchmark->sort(kVarcharBigint, true);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(orderByBigint) {
+  benchmark->orderBy({"c0"});
+}
+
+BENCHMARK(orderByMultiColumn) {
+  benchmark->orderBy({"c1", "c2 DESC", "c0"});
+}
+
+BENCHMARK(orderByVarchar) {
+  benchmark->orderBy({"c3"});
+}
+
+BENCHMARK(orderByVarcharBigint) {
+  benchmark->orderBy({"c3", "c0"});
+}
+
+BENCHMARK(topNBigint) {
+  benchmark->topN({"c0"});
+}
+
+BENCHMARK(topNMultiColumn) {
+  benchmark->topN({"c1", "c2 DESC", "c0"});
+}
+
+BENCHMARK(topNVarchar) {
+  benchmark->topN({"c3"});
+}
+
+BENCHMARK(topNVarcharBigint) {
+  benchmark->topN({"c3", "c0"});
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<OrderByBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <dirent.h>
+#include <fcntl.h>
+#include <folly/Benchmark.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <unistd.h>
+#include <iostream>
+#include <thread>
+
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/caching/SsdCache.h"
+#include "velox/common/memory/MmapAllocator.h"
+#include "velox/common/time/Timer.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#ifdef VELOX_ENABLE_PARQUET
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/parquet/RegisterParquetReader.h"
+#include "velox/dwio/parquet/writer/Writer.h"
+#endif
+
+DEFINE_int32(num_rows, 1'000'000, "Number of rows of each file");
+DEFINE_int64(ram_cache_mb, 4096, "Size of the AsyncDataCache");
+DEFINE_int64(ssd_cache_mb, 4096, "Size of the SSD cache");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+// Measures TableScan over the Hive connector for each file format, cache
+// state, filter selectivity and number of columns. The file has kMaxColumns
+// columns of BIGINT, DOUBLE and VARCHAR. c0 is the row number modulo 1000
+// and is filtered on with a range filter that passes 100%, 10% or 1% of the
+// rows. The cache states are:
+//
+//  cold: The AsyncDataCache and the SSD cache are empty and the file is
+//        dropped from the OS page cache before each run.
+//  ram:  The columns are in the AsyncDataCache.
+//  ssd:  The columns are in the SSD cache and not in RAM. The SSD cache
+//        files are dropped from the OS page cache before each run.
+//
+// folly's iters/s is rows/s. The bytes/s and CPU time per row of the scan
+// and the bytes read from each tier are printed after the results. The
+// DuckDB Parquet reader does not read through the AsyncDataCache, so
+// Parquet runs cold only.
+namespace {
+constexpr int32_t kMaxColumns = 16;
+constexpr int32_t kRowsPerVector = 10'000;
+
+enum class CacheState { kCold, kRam, kSsd };
+
+const char* cacheStateName(CacheState state) {
+  switch (state) {
+    case CacheState::kCold:
+      return "cold";
+    case CacheState::kRam:
+      return "ram";
+    case CacheState::kSsd:
+      return "ssd";
+  }
+  VELOX_UNREACHABLE();
+}
+
+// Drops the clean pages of 'path' from the OS page cache.
+void dropFromPageCache(const std::string& path) {
+  auto fd = open(path.c_str(), O_RDONLY);
+  VELOX_CHECK_GE(fd, 0, "Cannot open {}", path);
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+class ScanBenchmark : public HiveConnectorTestBase {
+ public:
+  struct Result {
+    uint64_t numRows{0};
+    uint64_t rawInputBytes{0};
+    uint64_t cpuNanos{0};
+    uint64_t wallMicros{0};
+    uint64_t storageReadBytes{0};
+    uint64_t ssdReadBytes{0};
+    uint64_t ramReadBytes{0};
+  };
+
+  ScanBenchmark() {
+    HiveConnectorTestBase::SetUp();
+    initializeCache();
+
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < kMaxColumns; ++i) {
+      names.push_back(fmt::format("c{}", i));
+      types.push_back(
+          i % 3 == 0 ? BIGINT() : (i % 3 == 1 ? DOUBLE() : VARCHAR()));
+    }
+    rowType_ = ROW(std::move(names), std::move(types));
+
+    VectorFuzzer::Options opts;
+    opts.vectorSize = kRowsPerVector;
+    opts.nullRatio = 0.1;
+    opts.stringLength = 20;
+    opts.stringVariableLength = true;
+    VectorFuzzer fuzzer(opts, pool(), 1);
+    std::vector<RowVectorPtr> vectors;
+    for (auto row = 0; row < FLAGS_num_rows; row += kRowsPerVector) {
+      std::vector<VectorPtr> children;
+      children.push_back(makeFlatVector<int64_t>(
+          kRowsPerVector, [&](auto i) { return (row + i) % 1000; }));
+      for (auto i = 1; i < kMaxColumns; ++i) {
+        children.push_back(fuzzer.fuzzFlat(rowType_->childAt(i)));
+      }
+      vectors.push_back(makeRowVector(rowType_->names(), children));
+    }
+
+    dwrfFile_ = TempFilePath::create();
+    writeToFile(dwrfFile_->path, vectors);
+#ifdef VELOX_ENABLE_PARQUET
+    parquet::registerParquetReaderFactory();
+    parquetFile_ = TempFilePath::create();
+    parquet::Writer writer(
+        std::make_unique<dwio::common::FileSink>(parquetFile_->path),
+        parquet::WriterOptions{},
+        *pool(),
+        rowType_);
+    for (auto& vector : vectors) {
+      writer.write(vector);
+    }
+    writer.close();
+#endif
+  }
+
+  ~ScanBenchmark() override {
+    cache_->ssdCache()->deleteFiles();
+    memory::MappedMemory::setDefaultInstance(nullptr);
+#ifdef VELOX_ENABLE_PARQUET
+    parquet::unregisterParquetReaderFactory();
+#endif
+    HiveConnectorTestBase::TearDown();
+  }
+
+  void TestBody() override {}
+
+  static bool hasParquet() {
+#ifdef VELOX_ENABLE_PARQUET
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // Scans 'numColumns' columns of the file of 'format' with 'filter' on c0
+  // after bringing the caches to 'state'. Adds the statistics of the scan to
+  // the results of 'name' and returns the number of result rows.
+  unsigned run(
+      const std::string& name,
+      dwio::common::FileFormat format,
+      CacheState state,
+      const std::string& filter,
+      int32_t numColumns) {
+    folly::BenchmarkSuspender suspender;
+    const auto& path = format == dwio::common::FileFormat::DWRF
+        ? dwrfFile_->path
+        : parquetFile_->path;
+    std::vector<std::string> names(
+        rowType_->names().begin(), rowType_->names().begin() + numColumns);
+    std::vector<TypePtr> types(
+        rowType_->children().begin(),
+        rowType_->children().begin() + numColumns);
+    auto outputType = ROW(std::move(names), std::move(types));
+    std::vector<std::string> filters;
+    if (!filter.empty()) {
+      filters.push_back(filter);
+    }
+    auto plan = PlanBuilder().tableScan(outputType, filters).planFragment();
+
+    prepareCache(path, format, state);
+    suspender.dismiss();
+    auto result = runScan(plan, path, format);
+    suspender.rehire();
+
+    auto& total = results_[name];
+    total.numRows += result.numRows;
+    total.rawInputBytes += result.rawInputBytes;
+    total.cpuNanos += result.cpuNanos;
+    total.wallMicros += result.wallMicros;
+    total.storageReadBytes += result.storageReadBytes;
+    total.ssdReadBytes += result.ssdReadBytes;
+    total.ramReadBytes += result.ramReadBytes;
+    return result.numRows;
+  }
+
+  void printResults() const {
+    std::cout << fmt::format(
+                     "{:<36}{:>12}{:>14}{:>12}{:>12}{:>12}",
+                     "Scan",
+                     "MB/s",
+                     "CPU ns/row",
+                     "storage MB",
+                     "SSD MB",
+                     "RAM MB")
+              << std::endl;
+    for (const auto& [name, result] : results_) {
+      if (result.numRows == 0 || result.wallMicros == 0) {
+        continue;
+      }
+      std::cout << fmt::format(
+                       "{:<36}{:>12.1f}{:>14.1f}{:>12}{:>12}{:>12}",
+                       name,
+                       static_cast<double>(result.rawInputBytes) /
+                           result.wallMicros,
+                       static_cast<double>(result.cpuNanos) / result.numRows,
+                       result.storageReadBytes >> 20,
+                       result.ssdReadBytes >> 20,
+                       result.ramReadBytes >> 20)
+                << std::endl;
+    }
+  }
+
+ private:
+  void initializeCache() {
+    // tmpfs does not support O_DIRECT.
+    FLAGS_ssd_odirect = false;
+    ssdExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(4);
+    ssdDirectory_ = TempDirectoryPath::create();
+    auto ssdCache = std::make_unique<cache::SsdCache>(
+        fmt::format("{}/cache", ssdDirectory_->path),
+        FLAGS_ssd_cache_mb << 20,
+        4,
+        ssdExecutor_.get());
+    memory::MmapAllocatorOptions options = {
+        static_cast<uint64_t>(FLAGS_ram_cache_mb) << 20};
+    cache_ = std::make_shared<cache::AsyncDataCache>(
+        std::make_shared<memory::MmapAllocator>(options),
+        FLAGS_ram_cache_mb << 20,
+        std::move(ssdCache));
+    memory::MappedMemory::setDefaultInstance(cache_.get());
+  }
+
+  void dropSsdFromPageCache() {
+    auto* dir = opendir(ssdDirectory_->path.c_str());
+    VELOX_CHECK_NOT_NULL(dir);
+    while (auto* entry = readdir(dir)) {
+      if (entry->d_type == DT_REG) {
+        dropFromPageCache(
+            fmt::format("{}/{}", ssdDirectory_->path, entry->d_name));
+      }
+    }
+    closedir(dir);
+  }
+
+  void waitForSsdWrite() {
+    auto* ssdCache = cache_->ssdCache();
+    while (ssdCache->writeInProgress()) {
+      // sleep override
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  // Brings the caches to 'state' for a scan of 'path'. A state persists
+  // across runs, so that reading all columns once warms the cache for all
+  // cases.
+  void prepareCache(
+      const std::string& path,
+      dwio::common::FileFormat format,
+      CacheState state) {
+    auto* ssdCache = cache_->ssdCache();
+    switch (state) {
+      case CacheState::kCold:
+        waitForSsdWrite();
+        cache_->clear();
+        ssdCache->clear();
+        dropFromPageCache(path);
+        warmPath_.clear();
+        break;
+      case CacheState::kRam:
+        if (warmPath_ != path || warmState_ != CacheState::kRam) {
+          runScan(
+              PlanBuilder().tableScan(rowType_).planFragment(), path, format);
+          warmPath_ = path;
+          warmState_ = CacheState::kRam;
+        }
+        break;
+      case CacheState::kSsd:
+        if (warmPath_ != path || warmState_ != CacheState::kSsd) {
+          waitForSsdWrite();
+          cache_->clear();
+          ssdCache->clear();
+          runScan(
+              PlanBuilder().tableScan(rowType_).planFragment(), path, format);
+          waitForSsdWrite();
+          VELOX_CHECK(ssdCache->startWrite());
+          cache_->saveToSsd();
+          waitForSsdWrite();
+          warmPath_ = path;
+          warmState_ = CacheState::kSsd;
+        }
+        // The previous run brought the columns back to RAM.
+        cache_->clear();
+        dropSsdFromPageCache();
+        break;
+    }
+  }
+
+  Result runScan(
+      core::PlanFragment plan,
+      const std::string& path,
+      dwio::common::FileFormat format) {
+    Result result;
+    auto task = std::make_shared<Task>(
+        fmt::format("scan-{}", numTasks_++),
+        std::move(plan),
+        0,
+        core::QueryCtx::createForTest(),
+        [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+          if (vector) {
+            result.numRows += vector->size();
+          }
+          return BlockingReason::kNotBlocked;
+        });
+    task->addSplit(
+        "0",
+        Split(HiveConnectorSplitBuilder(path).fileFormat(format).build()));
+    task->noMoreSplits("0");
+    {
+      MicrosecondTimer timer(&result.wallMicros);
+      Task::start(task, 1);
+      auto& executor = folly::QueuedImmediateExecutor::instance();
+      while (task->isRunning()) {
+        task->stateChangeFuture(60'000'000).via(&executor).wait();
+      }
+    }
+    VELOX_CHECK(task->state() == TaskState::kFinished);
+
+    const auto planStats = toPlanStats(task->taskStats());
+    const auto& stats = planStats.at("0");
+    result.rawInputBytes = stats.rawInputBytes;
+    result.cpuNanos = stats.cpuWallTiming.cpuNanos;
+    auto customStat = [&](const std::string& name) -> uint64_t {
+      auto it = stats.customStats.find(name);
+      return it == stats.customStats.end() ? 0 : it->second.sum;
+    };
+    result.storageReadBytes = customStat("storageReadBytes");
+    result.ssdReadBytes = customStat("localReadBytes");
+    result.ramReadBytes = customStat("ramReadBytes");
+    return result;
+  }
+
+  RowTypePtr rowType_;
+  std::shared_ptr<TempFilePath> dwrfFile_;
+  std::shared_ptr<TempFilePath> parquetFile_;
+  std::unique_ptr<folly::IOThreadPoolExecutor> ssdExecutor_;
+  std::shared_ptr<TempDirectoryPath> ssdDirectory_;
+  std::shared_ptr<cache::AsyncDataCache> cache_;
+  // The file whose columns are in the cache tier of 'warmState_'.
+  std::string warmPath_;
+  CacheState warmState_{CacheState::kCold};
+  int32_t numTasks_{0};
+  // Keyed on the benchmark case.
+  std::map<std::string, Result> results_;
+};
+
+std::unique_ptr<ScanBenchmark> benchmark;
+
+// Registers a benchmark for each combination of the parameters. The cases
+// of a cache state are next to each other, so that the cache is warmed once
+// per state.
+void registerBenchmarks() {
+  std::vector<std::pair<dwio::common::FileFormat, std::vector<CacheState>>>
+      formats = {
+          {dwio::common::FileFormat::DWRF,
+           {CacheState::kCold, CacheState::kRam, CacheState::kSsd}}};
+  if (ScanBenchmark::hasParquet()) {
+    formats.push_back({dwio::common::FileFormat::PARQUET, {CacheState::kCold}});
+  }
+  const std::vector<std::pair<std::string, std::string>> filters = {
+      {"all", ""}, {"10pct", "c0 < 100"}, {"1pct", "c0 < 10"}};
+  for (const auto& [format, states] : formats) {
+    for (auto state : states) {
+      for (const auto& [filterName, filter] : filters) {
+        for (auto numColumns : {1, 4, kMaxColumns}) {
+          auto name = fmt::format(
+              "{}_{}_{}_{}cols",
+              toString(format),
+              cacheStateName(state),
+              filterName,
+              numColumns);
+          folly::addBenchmark(
+              __FILE__,
+              name,
+              [name, format = format, state, filter = filter, numColumns](
+                  unsigned /*iters*/) {
+                return benchmark->run(name, format, state, filter, numColumns);
+              });
+        }
+      }
+      folly::addBenchmark(__FILE__, "-", []() -> unsigned { return 0; });
+    }
+  }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  functions::prestosql::registerAllScalarFunctions();
+  benchmark = std::make_unique<ScanBenchmark>();
+  registerBenchmarks();
+  folly::runBenchmarks();
+  benchmark->printResults();
+  benchmark.reset();
+  return 0;
+}
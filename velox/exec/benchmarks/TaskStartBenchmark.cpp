@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/exec/LocalPlanner.h"
+#include "velox/exec/Task.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+DEFINE_int32(max_drivers, 4, "Drivers per pipeline of the benchmark tasks");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
+
+// Measures the latency of a point query from Task creation to completion,
+// with the pipelines planned by Task::start() for each Task and taken from
+// a LocalPlan made once.
+namespace {
+
+class TaskStartBenchmark {
+ public:
+  TaskStartBenchmark() {
+    // A join with a filter, projections and an aggregation on a few rows.
+    auto probe = vectorMaker_.rowVector(
+        {"c0", "c1"},
+        {vectorMaker_.flatVector<int64_t>(10, [](auto row) { return row; }),
+         vectorMaker_.flatVector<int64_t>(
+             10, [](auto row) { return row * 3; })});
+    auto build = vectorMaker_.rowVector(
+        {"u_c0", "u_c1"},
+        {vectorMaker_.flatVector<int64_t>(
+             5, [](auto row) { return row * 2; }),
+         vectorMaker_.flatVector<int64_t>(
+             5, [](auto row) { return row + 7; })});
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    plan_ = PlanBuilder(planNodeIdGenerator)
+                .values({probe}, true)
+                .filter("c1 % 2 = 0")
+                .project({"c0", "c1 * 2 + 1 AS c1"})
+                .hashJoin(
+                    {"c0"},
+                    {"u_c0"},
+                    PlanBuilder(planNodeIdGenerator)
+                        .values({build}, true)
+                        .planNode(),
+                    "c1 > u_c1",
+                    {"c0", "c1", "u_c1"})
+                .project({"c0", "c1 + u_c1 AS s"})
+                .partialAggregation({"c0"}, {"sum(s)", "max(s)"})
+                .planFragment();
+    localPlan_ = std::make_unique<LocalPlan>(plan_, FLAGS_max_drivers);
+  }
+
+  void run(bool useLocalPlan) {
+    auto task = std::make_shared<Task>(
+        fmt::format("local://task-start-{}", numTasks_++),
+        plan_,
+        0,
+        std::make_shared<core::QueryCtx>(executor_.get()),
+        [](RowVectorPtr /*vector*/, ContinueFuture* /*future*/) {
+          return BlockingReason::kNotBlocked;
+        });
+    if (useLocalPlan) {
+      Task::start(task, *localPlan_);
+    } else {
+      Task::start(task, FLAGS_max_drivers);
+    }
+    auto& executor = folly::QueuedImmediateExecutor::instance();
+    while (task->isRunning()) {
+      task->stateChangeFuture(1'000'000).via(&executor).wait();
+    }
+  }
+
+ private:
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::shared_ptr<folly::Executor> executor_{
+      std::make_shared<folly::CPUThreadPoolExecutor>(FLAGS_max_drivers)};
+  core::PlanFragment plan_;
+  std::unique_ptr<LocalPlan> localPlan_;
+  int64_t numTasks_{0};
+};
+
+std::unique_ptr<TaskStartBenchmark> benchmark;
+
+BENCHMARK(start) {
+  benchmark->run(false);
+}
+
+BENCHMARK_RELATIVE(startFromLocalPlan) {
+  benchmark->run(true);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  functions::prestosql::registerAllScalarFunctions();
+  benchmark = std::make_unique<TaskStartBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/dwio/dwrf/test/utils/BatchMaker.h"
 #include "velox/exec/Aggregate.h"
@@ -783,6 +784,296 @@ TEST_F(AggregationTest, partialAggregationMemoryLimit) {
       0);
 }
 
+TEST_F(AggregationTest, abandonPartialAggregation) {
+  // Nearly unique keys. The last batch repeats the keys of the first one.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return (i * 1'000 + row) % 9'000; }),
+        makeFlatVector<int32_t>(
+            1'000, [](auto row) { return row % 17; }, nullEvery(7)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto abandonedCount = [](const std::shared_ptr<Task>& task,
+                           const core::PlanNodeId& nodeId) -> int64_t {
+    const auto& stats = toPlanStats(task->taskStats()).at(nodeId).customStats;
+    auto it = stats.find("abandonedPartialAggregation");
+    return it == stats.end() ? 0 : it->second.count;
+  };
+
+  core::PlanNodeId aggNodeId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(core::QueryConfig::kAbandonPartialAggregationMinRows, "100")
+          .config(core::QueryConfig::kAbandonPartialAggregationMinPct, "80")
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .partialAggregation(
+                        {"c0"}, {"count(1)", "sum(c1)", "max(c1)", "avg(c1)"})
+                    .capturePlanNodeId(aggNodeId)
+                    .finalAggregation()
+                    .planNode())
+          .assertResults(
+              "SELECT c0, count(1), sum(c1), max(c1), avg(c1) FROM tmp "
+              "GROUP BY 1");
+  EXPECT_GT(abandonedCount(task, aggNodeId), 0);
+
+  // Distinct aggregation.
+  task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(core::QueryConfig::kAbandonPartialAggregationMinRows, "100")
+          .config(core::QueryConfig::kAbandonPartialAggregationMinPct, "80")
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .partialAggregation({"c0"}, {})
+                    .capturePlanNodeId(aggNodeId)
+                    .finalAggregation()
+                    .planNode())
+          .assertResults("SELECT distinct c0 FROM tmp");
+  EXPECT_GT(abandonedCount(task, aggNodeId), 0);
+
+  // A percentage above 100 disables abandoning.
+  task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(core::QueryConfig::kAbandonPartialAggregationMinRows, "100")
+          .config(core::QueryConfig::kAbandonPartialAggregationMinPct, "101")
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .partialAggregation({"c0"}, {"count(1)"})
+                    .capturePlanNodeId(aggNodeId)
+                    .finalAggregation()
+                    .planNode())
+          .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+  EXPECT_EQ(abandonedCount(task, aggNodeId), 0);
+
+  // Few distinct keys keep the partial aggregation.
+  task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(core::QueryConfig::kAbandonPartialAggregationMinRows, "100")
+          .config(core::QueryConfig::kAbandonPartialAggregationMinPct, "80")
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .partialAggregation({"c1"}, {"count(1)"})
+                    .capturePlanNodeId(aggNodeId)
+                    .finalAggregation()
+                    .planNode())
+          .assertResults("SELECT c1, count(1) FROM tmp GROUP BY 1");
+  EXPECT_EQ(abandonedCount(task, aggNodeId), 0);
+}
+
+TEST_F(AggregationTest, abandonPartialAggregationThreshold) {
+  // Each batch has 1'000 rows with 500 distinct keys, the same in all
+  // batches.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 4; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 500; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto abandonedCount = [&](const std::string& minRows,
+                            const std::string& minPct) -> int64_t {
+    core::PlanNodeId aggNodeId;
+    auto task =
+        AssertQueryBuilder(duckDbQueryRunner_)
+            .config(
+                core::QueryConfig::kAbandonPartialAggregationMinRows, minRows)
+            .config(core::QueryConfig::kAbandonPartialAggregationMinPct, minPct)
+            .plan(PlanBuilder()
+                      .values(vectors)
+                      .partialAggregation({"c0"}, {"count(1)"})
+                      .capturePlanNodeId(aggNodeId)
+                      .finalAggregation()
+                      .planNode())
+            .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+    const auto& stats =
+        toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+    auto it = stats.find("abandonedPartialAggregation");
+    return it == stats.end() ? 0 : it->second.count;
+  };
+
+  // The first batch has exactly 50% distinct keys. Its groups count for the
+  // check on the batch that reaches the minimum number of rows.
+  EXPECT_EQ(1, abandonedCount("1000", "50"));
+  EXPECT_EQ(0, abandonedCount("1000", "51"));
+  // Once the second batch is in, the ratio is 25%.
+  EXPECT_EQ(0, abandonedCount("1001", "50"));
+  EXPECT_EQ(1, abandonedCount("2000", "25"));
+}
+
+TEST_F(AggregationTest, columnarAccumulators) {
+  // 2'500 groups. The values of c1 and c2 have nulls.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return (i * 1'000 + row) % 2'500; }),
+        makeFlatVector<int64_t>(
+            1'000,
+            [i](auto row) { return i * 1'000 + row; },
+            [](auto row) { return row % 7 == 0 || row % 13 == 0; }),
+        makeFlatVector<double>(
+            1'000, [](auto row) { return row * 0.1; }, nullEvery(11)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  const std::vector<std::string> aggregates = {
+      "sum(c1)", "min(c1)", "max(c2)", "count(1)", "sum(c2)", "avg(c1)"};
+  const std::string sql =
+      "SELECT c0, sum(c1), min(c1), max(c2), count(1), sum(c2), avg(c1) "
+      "FROM tmp GROUP BY 1";
+
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(core::QueryConfig::kAggregationColumnarAccumulators, "true")
+      .plan(PlanBuilder()
+                .values(vectors)
+                .singleAggregation({"c0"}, aggregates)
+                .planNode())
+      .assertResults(sql);
+
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(core::QueryConfig::kAggregationColumnarAccumulators, "true")
+      .plan(PlanBuilder()
+                .values(vectors)
+                .partialAggregation({"c0"}, aggregates)
+                .finalAggregation()
+                .planNode())
+      .assertResults(sql);
+
+  // Flushing the partial aggregation reuses the group numbers.
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(core::QueryConfig::kAggregationColumnarAccumulators, "true")
+      .config(core::QueryConfig::kMaxPartialAggregationMemory, "100")
+      .plan(PlanBuilder()
+                .values(vectors)
+                .partialAggregation({"c0"}, aggregates)
+                .finalAggregation()
+                .planNode())
+      .assertResults(sql);
+
+  // An abandoned partial aggregation makes a group per input row.
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(core::QueryConfig::kAggregationColumnarAccumulators, "true")
+      .config(core::QueryConfig::kAbandonPartialAggregationMinRows, "100")
+      .config(core::QueryConfig::kAbandonPartialAggregationMinPct, "10")
+      .plan(PlanBuilder()
+                .values(vectors)
+                .partialAggregation({"c0"}, aggregates)
+                .finalAggregation()
+                .planNode())
+      .assertResults(sql);
+}
+
+TEST_F(AggregationTest, distinctAggregates) {
+  // The strings of c2 are longer than inline StringViews.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 100; }),
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return (i + row) % 37; }, nullEvery(7)),
+        makeFlatVector<StringView>(
+            1'000,
+            [i](auto row) {
+              return StringView(fmt::format(
+                  "distinct value {}", (i * 1'000 + row) % 51));
+            }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  const std::vector<std::string> aggregates = {
+      "count(DISTINCT c1)",
+      "sum(DISTINCT c1)",
+      "sum(c1)",
+      "count(DISTINCT c2)",
+      "max(DISTINCT c2)"};
+  const std::string selection =
+      "count(DISTINCT c1), sum(DISTINCT c1), sum(c1), count(DISTINCT c2), "
+      "max(DISTINCT c2)";
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation({"c0"}, aggregates)
+                  .planNode();
+  assertQuery(plan, "SELECT c0, " + selection + " FROM tmp GROUP BY 1");
+
+  plan = PlanBuilder()
+             .values(vectors)
+             .singleAggregation({}, aggregates)
+             .planNode();
+  assertQuery(plan, "SELECT " + selection + " FROM tmp");
+
+  // The sets of the distinct values are spilled and merged.
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto queryCtx = core::QueryCtx::createForTest();
+  queryCtx->pool()->setMemoryUsageTracker(
+      velox::memory::MemoryUsageTracker::create(1LL << 30, 0, 1LL << 30));
+  plan = PlanBuilder()
+             .values(vectors)
+             .singleAggregation({"c0"}, aggregates)
+             .planNode();
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .plan(plan)
+          .queryCtx(queryCtx)
+          .config(core::QueryConfig::kSpillPath, tempDirectory->path)
+          .config(core::QueryConfig::kTestingSpillPct, "100")
+          .assertResults("SELECT c0, " + selection + " FROM tmp GROUP BY 1");
+  EXPECT_LT(0, task->taskStats().pipelineStats[0].operatorStats[1].spilledRows);
+
+  // Streaming aggregation over input clustered on the key.
+  std::vector<RowVectorPtr> sorted = {makeRowVector({
+      makeFlatVector<int64_t>({1, 1, 1, 2, 2, 3}),
+      makeFlatVector<int64_t>({5, 5, 6, 7, 7, 7}),
+  })};
+  plan = PlanBuilder()
+             .values(sorted)
+             .streamingAggregation(
+                 {"c0"},
+                 {"count(DISTINCT c1)", "sum(DISTINCT c1)"},
+                 {},
+                 core::AggregationNode::Step::kSingle,
+                 false)
+             .planNode();
+  assertQuery(plan, "VALUES (1, 2, 11), (2, 1, 7), (3, 1, 7)");
+
+  VELOX_ASSERT_THROW(
+      PlanBuilder()
+          .values(vectors)
+          .partialAggregation({"c0"}, {"count(DISTINCT c1)"})
+          .planNode(),
+      "Distinct aggregates are supported only in single aggregation");
+}
+
+TEST_F(AggregationTest, distinctAggregatesOfNaN) {
+  // All NaNs are one distinct value, whatever their bits.
+  auto nan = std::numeric_limits<double>::quiet_NaN();
+  auto otherNan = -std::nan("1");
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>({1, 1, 1, 1, 2, 2, 2}),
+      makeFlatVector<double>({nan, otherNan, 1.5, nan, otherNan, 2.0, 2.0}),
+      makeFlatVector<float>(
+          {std::nanf(""), 1.5, std::nanf("2"), 1.5, 2.0, 3.0, 2.0}),
+  });
+
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .singleAggregation(
+                      {"c0"}, {"count(DISTINCT c1)", "count(DISTINCT c2)"})
+                  .planNode();
+  AssertQueryBuilder(plan).assertResults(makeRowVector({
+      makeFlatVector<int64_t>({1, 2}),
+      makeFlatVector<int64_t>({2, 2}),
+      makeFlatVector<int64_t>({2, 2}),
+  }));
+}
+
 // Validates partial aggregate output types for SUM/MIN/MAX.
 TEST_F(AggregationTest, validatePartialTypes) {
   auto vectors = makeVectors(rowType_, 10, 1);
@@ -904,6 +1195,79 @@ TEST_F(AggregationTest, spill) {
 
   // Over 20MB spilled.
   EXPECT_LT(20 << 20, stats[0].operatorStats[1].spilledBytes);
+  auto& partitionBytes =
+      stats[0].operatorStats[1].runtimeStats["spilledPartitionBytes"];
+  EXPECT_LT(0, partitionBytes.count);
+  EXPECT_EQ(stats[0].operatorStats[1].spilledBytes, partitionBytes.sum);
+
+  // Merging at most 2 spill files at a time makes the partitions with more
+  // files be repartitioned before they are read.
+  queryCtx = core::QueryCtx::createForTest();
+  queryCtx->pool()->setMemoryUsageTracker(
+      velox::memory::MemoryUsageTracker::create(kMaxBytes, 0, kMaxBytes));
+  task =
+      AssertQueryBuilder(PlanBuilder()
+                             .values(batches)
+                             .singleAggregation({"c0", "c1"}, {"array_agg(c2)"})
+                             .planNode())
+          .queryCtx(queryCtx)
+          .config(QueryConfig::kSpillPath, tempDirectory->path)
+          .config(QueryConfig::kMaxSpillMergeFanIn, "2")
+          .assertResults(results);
+  stats = task->taskStats().pipelineStats;
+  EXPECT_LT(
+      0, stats[0].operatorStats[1].runtimeStats["spillRepartitions"].sum);
+}
+
+TEST_F(AggregationTest, releaseOutputMemory) {
+  // Enough groups for the rows to take many allocations. The strings are not
+  // inlined, so that max(c2) keeps its accumulators in external memory.
+  constexpr int32_t kNumGroups = 100'000;
+  std::vector<std::string> strings(kNumGroups);
+  for (auto i = 0; i < kNumGroups; ++i) {
+    strings[i] = fmt::format("payload string {}", i);
+  }
+  std::vector<RowVectorPtr> data;
+  for (auto i = 0; i < 3; ++i) {
+    data.push_back(makeRowVector({
+        makeFlatVector<int64_t>(kNumGroups, [](auto row) { return row; }),
+        makeFlatVector<int64_t>(kNumGroups, [i](auto row) { return row * i; }),
+        makeFlatVector<StringView>(
+            kNumGroups,
+            [&](auto row) { return StringView(strings[(row * 7) % 1000]); }),
+    }));
+  }
+  createDuckDbTable(data);
+
+  auto plan = PlanBuilder()
+                  .values(data)
+                  .singleAggregation({"c0"}, {"sum(c1)", "max(c2)"})
+                  .planNode();
+  auto task =
+      assertQuery(plan, "SELECT c0, sum(c1), max(c2) FROM tmp GROUP BY 1");
+
+  // The hash table and the groups already returned are freed while producing
+  // the output. The peak memory is reported in the memory stats.
+  auto aggStats = task->taskStats().pipelineStats[0].operatorStats[1];
+  auto releasedBytes = aggStats.runtimeStats["outputReleasedBytes"].sum;
+  EXPECT_LT(1 << 20, releasedBytes);
+  EXPECT_LT(
+      releasedBytes,
+      static_cast<int64_t>(aggStats.memoryStats.peakTotalMemoryReservation));
+
+  // Partial aggregation keeps its memory for the next flush.
+  plan = PlanBuilder()
+             .values(data)
+             .partialAggregation({"c0"}, {"sum(c1)"})
+             .finalAggregation()
+             .planNode();
+  task = assertQuery(plan, "SELECT c0, sum(c1) FROM tmp GROUP BY 1");
+  EXPECT_EQ(
+      0,
+      task->taskStats()
+          .pipelineStats[0]
+          .operatorStats[1]
+          .runtimeStats.count("outputReleasedBytes"));
 }
 
 /// Verify number of memory allocations in the HashAggregation operator.
@@ -1041,5 +1405,102 @@ TEST_F(AggregationTest, groupingSets) {
       "SELECT k1, k2, count(1), sum(a), max(b) FROM tmp GROUP BY ROLLUP (k1, k2)");
 }
 
+TEST_F(AggregationTest, groupingSetsFusion) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector(
+        {"k1", "k2", "k3", "a", "b"},
+        {
+            makeFlatVector<int64_t>(1'000, [](auto row) { return row % 11; }),
+            makeFlatVector<int32_t>(
+                1'000, [](auto row) { return row % 7; }, nullEvery(13)),
+            makeFlatVector<StringView>(
+                1'000,
+                [](auto row) {
+                  return StringView(std::string(row % 5, 'x'));
+                }),
+            makeFlatVector<int64_t>(
+                1'000, [i](auto row) { return i * 1'000 + row; }, nullEvery(9)),
+            makeFlatVector<double>(1'000, [](auto row) { return row * 0.1; }),
+        }));
+  }
+  createDuckDbTable(vectors);
+
+  const std::vector<std::string> aggregates = {
+      "count(1) as count_1", "sum(a) as sum_a", "max(b) as max_b"};
+  const std::string sql =
+      "SELECT k1, k2, k3, count(1), sum(a), max(b) FROM tmp "
+      "GROUP BY CUBE (k1, k2, k3)";
+
+  core::PlanNodeId aggNodeId;
+  auto planBuilder = [&](bool partial) {
+    auto builder = PlanBuilder().values(vectors).groupId(
+        {{"k1", "k2", "k3"},
+         {"k1", "k2"},
+         {"k1", "k3"},
+         {"k2", "k3"},
+         {"k1"},
+         {"k2"},
+         {"k3"},
+         {}},
+        {"a", "b"});
+    if (partial) {
+      builder.partialAggregation({"k1", "k2", "k3", "group_id"}, aggregates)
+          .capturePlanNodeId(aggNodeId)
+          .finalAggregation();
+    } else {
+      builder.singleAggregation({"k1", "k2", "k3", "group_id"}, aggregates)
+          .capturePlanNodeId(aggNodeId);
+    }
+    return builder.project({"k1", "k2", "k3", "count_1", "sum_a", "max_b"})
+        .planNode();
+  };
+  auto rolledUp = [&](const std::shared_ptr<Task>& task) -> int64_t {
+    const auto& stats =
+        toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+    auto it = stats.find("rolledUpGroupingSets");
+    return it == stats.end() ? 0 : it->second.sum;
+  };
+
+  for (auto partial : {false, true}) {
+    SCOPED_TRACE(fmt::format("partial: {}", partial));
+    // All sets but the one on all keys are rolled up.
+    auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                    .plan(planBuilder(partial))
+                    .assertResults(sql);
+    EXPECT_EQ(7, rolledUp(task));
+
+    task = AssertQueryBuilder(duckDbQueryRunner_)
+               .config(core::QueryConfig::kGroupingSetsFusion, "false")
+               .plan(planBuilder(partial))
+               .assertResults(sql);
+    EXPECT_EQ(0, rolledUp(task));
+  }
+
+  // Flushing the partial aggregation rolls up each flush.
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(core::QueryConfig::kMaxPartialAggregationMemory, "100")
+      .plan(planBuilder(true))
+      .assertResults(sql);
+
+  // An aggregation that may spill does not roll up.
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .config(core::QueryConfig::kSpillPath, tempDirectory->path)
+                  .plan(planBuilder(false))
+                  .assertResults(sql);
+  EXPECT_EQ(0, rolledUp(task));
+
+  // The global aggregation of a grouping set with no keys has no result
+  // without input, as with the aggregation over GroupId.
+  auto plan = PlanBuilder()
+                  .values({vectors[0]})
+                  .filter("k1 < 0")
+                  .groupId({{"k1"}, {}}, {"a"})
+                  .singleAggregation({"k1", "group_id"}, {"sum(a)"})
+                  .planNode();
+  EXPECT_EQ(0, AssertQueryBuilder(plan).copyResults(pool())->size());
+}
+
 } // namespace
 } // namespace facebook::velox::exec::test
@@ -13,8 +13,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/connectors/AsyncDataSource.h"
 #include "velox/connectors/Connector.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/QueryAssertions.h"
@@ -30,11 +32,21 @@ const std::string kTestConnectorId = "test";
 
 class TestTableHandle : public connector::ConnectorTableHandle {
  public:
-  TestTableHandle() : connector::ConnectorTableHandle(kTestConnectorId) {}
+  // If 'async' is true, the scan uses a TestAsyncDataSource and takes
+  // TestBatchSplits.
+  explicit TestTableHandle(bool async = false)
+      : connector::ConnectorTableHandle(kTestConnectorId), async_{async} {}
 
   std::string toString() const override {
     VELOX_NYI();
   }
+
+  bool async() const {
+    return async_;
+  }
+
+ private:
+  const bool async_;
 };
 
 class TestSplit : public connector::ConnectorSplit {
@@ -129,6 +141,113 @@ class TestDataSource : public connector::DataSource {
   ContinueFuture future_{ContinueFuture::makeEmpty()};
 };
 
+// A split of 'numBatches' batches of 100 rows. Column 'a' of batch 'i' is
+// 100 * i to 100 * i + 99.
+class TestBatchSplit : public connector::ConnectorSplit {
+ public:
+  explicit TestBatchSplit(int32_t numBatches)
+      : connector::ConnectorSplit(kTestConnectorId), numBatches_{numBatches} {}
+
+  int32_t numBatches() const {
+    return numBatches_;
+  }
+
+ private:
+  const int32_t numBatches_;
+};
+
+// Completes the requests for batches after a delay that is shorter for
+// later batches of each window of 4, so that they complete out of order.
+class TestAsyncDataSource : public connector::AsyncDataSource {
+ public:
+  static constexpr int32_t kBatchRows = 100;
+
+  explicit TestAsyncDataSource(
+      const connector::ConnectorQueryCtx& connectorQueryCtx)
+      : connector::AsyncDataSource(connectorQueryCtx),
+        pool_{connectorQueryCtx.memoryPool()} {
+    scheduler_.start();
+  }
+
+  ~TestAsyncDataSource() override {
+    scheduler_.shutdown();
+  }
+
+  static int32_t maxPendingBatches() {
+    return maxPendingSeen_;
+  }
+
+  static void resetMaxPendingBatches() {
+    maxPendingSeen_ = 0;
+  }
+
+  void addDynamicFilter(
+      column_index_t /* outputChannel */,
+      const std::shared_ptr<common::Filter>& /* filter */) override {
+    VELOX_NYI();
+  }
+
+  uint64_t getCompletedBytes() override {
+    return 0;
+  }
+
+  uint64_t getCompletedRows() override {
+    return 0;
+  }
+
+  std::unordered_map<std::string, RuntimeCounter> runtimeStats() override {
+    return {};
+  }
+
+ protected:
+  void startSplit(std::shared_ptr<connector::ConnectorSplit> split) override {
+    auto batchSplit = std::dynamic_pointer_cast<TestBatchSplit>(split);
+    VELOX_CHECK_NOT_NULL(batchSplit);
+    numBatches_ = batchSplit->numBatches();
+    nextBatch_ = 0;
+  }
+
+  std::optional<folly::SemiFuture<RowVectorPtr>> fetchBatch(
+      uint64_t /* size */) override {
+    if (nextBatch_ == numBatches_) {
+      return std::nullopt;
+    }
+    const auto batch = nextBatch_++;
+    maxPendingSeen_ = std::max(maxPendingSeen_, numPendingBatches() + 1);
+    auto data = makeBatch(batch);
+    auto [promise, future] = folly::makePromiseContract<RowVectorPtr>();
+    scheduler_.addFunctionOnce(
+        [promise = std::move(promise), data]() mutable {
+          promise.setValue(data);
+        },
+        fmt::format("batch{}", batch),
+        std::chrono::milliseconds(1 + 20 * (3 - batch % 4)));
+    return std::move(future);
+  }
+
+ private:
+  RowVectorPtr makeBatch(int32_t batch) {
+    auto data = std::dynamic_pointer_cast<FlatVector<int64_t>>(
+        BaseVector::create(BIGINT(), kBatchRows, pool_));
+    for (auto i = 0; i < kBatchRows; i++) {
+      data->set(i, batch * kBatchRows + i);
+    }
+    return std::make_shared<RowVector>(
+        pool_,
+        ROW({"a"}, {BIGINT()}),
+        nullptr,
+        kBatchRows,
+        std::vector<VectorPtr>{data});
+  }
+
+  static inline int32_t maxPendingSeen_{0};
+
+  memory::MemoryPool* const pool_;
+  folly::FunctionScheduler scheduler_;
+  int32_t numBatches_{0};
+  int32_t nextBatch_{0};
+};
+
 class TestConnector : public connector::Connector {
  public:
   TestConnector(const std::string& id, std::shared_ptr<const Config> properties)
@@ -136,11 +255,14 @@ class TestConnector : public connector::Connector {
 
   std::shared_ptr<connector::DataSource> createDataSource(
       const RowTypePtr& /* outputType */,
-      const std::shared_ptr<connector::ConnectorTableHandle>& /* tableHandle */,
+      const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
       const std::unordered_map<
           std::string,
           std::shared_ptr<connector::ColumnHandle>>& /* columnHandles */,
       connector::ConnectorQueryCtx* connectorQueryCtx) override {
+    if (std::dynamic_pointer_cast<TestTableHandle>(tableHandle)->async()) {
+      return std::make_shared<TestAsyncDataSource>(*connectorQueryCtx);
+    }
     return std::make_shared<TestDataSource>(connectorQueryCtx->memoryPool());
   }
 
@@ -213,4 +335,53 @@ TEST_F(AsyncConnectorTest, basic) {
   }
 }
 
+TEST_F(AsyncConnectorTest, pendingBatches) {
+  auto plan = PlanBuilder()
+                  .tableScan(
+                      ROW({"a"}, {BIGINT()}),
+                      std::make_shared<TestTableHandle>(true),
+                      {})
+                  .planNode();
+  const int32_t numBatches = 16;
+  const auto numRows = numBatches * TestAsyncDataSource::kBatchRows;
+
+  // The batches come in request order with up to 4 requests in flight.
+  TestAsyncDataSource::resetMaxPendingBatches();
+  auto result = AssertQueryBuilder(plan)
+                    .split(std::make_shared<TestBatchSplit>(numBatches))
+                    .copyResults(pool());
+  ASSERT_EQ(numRows, result->size());
+  auto values = result->childAt(0)->asFlatVector<int64_t>();
+  for (auto i = 0; i < numRows; ++i) {
+    ASSERT_EQ(i, values->valueAt(i));
+  }
+  EXPECT_EQ(4, TestAsyncDataSource::maxPendingBatches());
+
+  TestAsyncDataSource::resetMaxPendingBatches();
+  result = AssertQueryBuilder(plan)
+               .config(core::QueryConfig::kMaxPendingConnectorBatches, "8")
+               .split(std::make_shared<TestBatchSplit>(numBatches))
+               .copyResults(pool());
+  ASSERT_EQ(numRows, result->size());
+  EXPECT_EQ(8, TestAsyncDataSource::maxPendingBatches());
+
+  // The batches come as they complete. The last of each window of 4
+  // requests completes first.
+  result = AssertQueryBuilder(plan)
+               .config(core::QueryConfig::kPreserveConnectorBatchOrder, "false")
+               .split(std::make_shared<TestBatchSplit>(numBatches))
+               .copyResults(pool());
+  ASSERT_EQ(numRows, result->size());
+  values = result->childAt(0)->asFlatVector<int64_t>();
+  std::vector<int64_t> sorted;
+  for (auto i = 0; i < numRows; ++i) {
+    sorted.push_back(values->valueAt(i));
+  }
+  EXPECT_NE(0, sorted[0]);
+  std::sort(sorted.begin(), sorted.end());
+  for (auto i = 0; i < numRows; ++i) {
+    ASSERT_EQ(i, sorted[i]);
+  }
+}
+
 } // namespace facebook::velox::exec::test
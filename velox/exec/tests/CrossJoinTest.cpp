@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -258,3 +259,86 @@ TEST_F(CrossJoinTest, parallelism) {
 
   OperatorTestBase::assertQuery(params, "VALUES (30), (30), (30), (30), (30)");
 }
+
+TEST_F(CrossJoinTest, filter) {
+  auto leftVectors = {
+      makeRowVector({sequence<int32_t>(10)}),
+      makeRowVector({sequence<int32_t>(2'000, 10)}),
+  };
+
+  // Build vectors larger and smaller than the output batch size.
+  auto rightVectors = {
+      makeRowVector({"u_c0"}, {sequence<int32_t>(3'000)}),
+      makeRowVector({"u_c0"}, {sequence<int32_t>(10, 5'000)}),
+      makeRowVector({"u_c0"}, {sequence<int32_t>(7, 6'000)}),
+  };
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto op = PlanBuilder(planNodeIdGenerator)
+                .values({leftVectors})
+                .crossJoin(
+                    PlanBuilder(planNodeIdGenerator)
+                        .values({rightVectors})
+                        .planNode(),
+                    {"c0", "u_c0"},
+                    "c0 * 3 > u_c0 AND (c0 + u_c0) % 7 = 0")
+                .planNode();
+
+  assertQuery(
+      op,
+      "SELECT * FROM t, u WHERE t.c0 * 3 > u.u_c0 AND (t.c0 + u.u_c0) % 7 = 0");
+
+  // Only the build side in the filter. No pair passes.
+  planNodeIdGenerator->reset();
+  op = PlanBuilder(planNodeIdGenerator)
+           .values({leftVectors})
+           .crossJoin(
+               PlanBuilder(planNodeIdGenerator)
+                   .values({rightVectors})
+                   .planNode(),
+               {"c0"},
+               "u_c0 < 0")
+           .planNode();
+
+  assertQueryReturnsEmptyResult(op);
+}
+
+TEST_F(CrossJoinTest, outputBatchSize) {
+  // 100 build vectors of 5 rows each are paired with the probe rows in
+  // batches of 'kBatchSize' rows.
+  constexpr int32_t kBatchSize = 1'000;
+  std::vector<RowVectorPtr> rightVectors;
+  for (auto i = 0; i < 100; ++i) {
+    rightVectors.push_back(
+        makeRowVector({"u_c0"}, {sequence<int32_t>(5, i * 5)}));
+  }
+  auto leftVectors = {makeRowVector({sequence<int32_t>(1'000)})};
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId joinNodeId;
+  CursorParameters params;
+  params.planNode = PlanBuilder(planNodeIdGenerator)
+                        .values({leftVectors})
+                        .crossJoin(
+                            PlanBuilder(planNodeIdGenerator)
+                                .values({rightVectors})
+                                .planNode(),
+                            {"c0", "u_c0"})
+                        .capturePlanNodeId(joinNodeId)
+                        .planNode();
+  params.queryCtx = core::QueryCtx::createForTest();
+  params.queryCtx->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kPreferredOutputBatchSize,
+        std::to_string(kBatchSize)}});
+
+  auto task = OperatorTestBase::assertQuery(params, "SELECT * FROM t, u");
+  auto stats = toPlanStats(task->taskStats()).at(joinNodeId);
+  EXPECT_EQ(500'000, stats.outputRows);
+  EXPECT_EQ(500, stats.outputVectors);
+}
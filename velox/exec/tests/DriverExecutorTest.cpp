@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverExecutor.h"
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class DriverExecutorTest : public OperatorTestBase {
+ protected:
+  static DriverExecutor::Options options(int32_t numThreads) {
+    DriverExecutor::Options options;
+    options.numThreads = numThreads;
+    options.pinThreads = false;
+    return options;
+  }
+};
+
+TEST_F(DriverExecutorTest, runAll) {
+  constexpr int32_t kNumFuncs = 10'000;
+  std::atomic<int32_t> numRun{0};
+  folly::Baton<> done;
+  {
+    DriverExecutor executor(options(4));
+    EXPECT_EQ(4, executor.numWorkers());
+    EXPECT_EQ(1, executor.numNumaNodes());
+    EXPECT_EQ(nullptr, DriverExecutor::current());
+    EXPECT_EQ(-1, DriverExecutor::currentWorker());
+
+    std::atomic<bool> onWorker{true};
+    for (auto i = 0; i < kNumFuncs; ++i) {
+      // All functions go to worker 0. The other workers steal.
+      executor.addWithAffinity(
+          [&]() {
+            if (DriverExecutor::current() != &executor ||
+                DriverExecutor::currentWorker() < 0 ||
+                DriverExecutor::currentWorker() >= 4) {
+              onWorker = false;
+            }
+            if (++numRun == kNumFuncs) {
+              done.post();
+            }
+          },
+          0);
+    }
+    done.wait();
+    EXPECT_TRUE(onWorker);
+  }
+  EXPECT_EQ(kNumFuncs, numRun);
+}
+
+TEST_F(DriverExecutorTest, affinity) {
+  // Declared before 'executor' to outlive the workers.
+  std::atomic<bool> released{false};
+  folly::Baton<> done;
+  std::atomic<int32_t> numBusy{0};
+  std::atomic<bool> busy[4] = {false, false, false, false};
+  int32_t runOn = -1;
+
+  DriverExecutor executor(options(4));
+
+  // Keep three workers busy so that they do not steal. A busy function may
+  // be stolen by another idle worker, so the idle worker is the one left.
+  for (auto i = 0; i < 3; ++i) {
+    executor.addWithAffinity(
+        [&]() {
+          busy[DriverExecutor::currentWorker()] = true;
+          ++numBusy;
+          while (!released) {
+            std::this_thread::yield();
+          }
+        },
+        i);
+  }
+  while (numBusy < 3) {
+    std::this_thread::yield();
+  }
+  int32_t idle = 0;
+  while (busy[idle]) {
+    ++idle;
+  }
+
+  executor.addWithAffinity(
+      [&]() {
+        runOn = DriverExecutor::currentWorker();
+        done.post();
+      },
+      idle);
+  done.wait();
+  EXPECT_EQ(idle, runOn);
+  released = true;
+}
+
+TEST_F(DriverExecutorTest, destroyRunsQueued) {
+  std::atomic<int32_t> numRun{0};
+  {
+    DriverExecutor executor(options(2));
+    for (auto i = 0; i < 1'000; ++i) {
+      executor.add([&]() { ++numRun; });
+    }
+  }
+  EXPECT_EQ(1'000, numRun);
+}
+
+TEST_F(DriverExecutorTest, query) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 31; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto executor = std::make_shared<DriverExecutor>(options(4));
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .values(vectors)
+                        .partialAggregation({"c0"}, {"sum(c1)"})
+                        .localPartition({"c0"})
+                        .finalAggregation()
+                        .planNode();
+  params.maxDrivers = 4;
+  params.queryCtx = core::QueryCtx::createForTest(
+      std::make_shared<core::MemConfig>(), executor);
+  auto task = assertQuery(params, "SELECT c0, sum(c1) FROM tmp GROUP BY 1");
+
+  auto stats = task->taskStats();
+  EXPECT_GT(stats.numDriverExecutorRuns, 0);
+  EXPECT_LE(stats.numDriverMigrations, stats.numDriverExecutorRuns);
+  EXPECT_EQ(0, stats.numDriverCrossNodeMigrations);
+  EXPECT_GE(executor->stats().numRun, stats.numDriverExecutorRuns);
+}
+
+TEST_F(DriverExecutorTest, priority) {
+  // Declared before 'executor' to outlive the worker.
+  folly::Baton<> started;
+  folly::Baton<> release;
+  std::vector<int32_t> order;
+
+  DriverExecutor executor(options(1));
+  executor.add([&]() {
+    started.post();
+    release.wait();
+  });
+  started.wait();
+
+  // Priority 3 gets 8 times the share of priority 0. The low priority work
+  // runs after the high priority work.
+  for (auto i = 0; i < 4; ++i) {
+    executor.add([&]() { order.push_back(0); });
+    executor.addWithAffinity([&]() { order.push_back(3); }, -1, 3);
+  }
+  folly::Baton<> done;
+  executor.add([&]() { done.post(); });
+  release.post();
+  done.wait();
+  EXPECT_EQ((std::vector<int32_t>{3, 3, 3, 3, 0, 0, 0, 0}), order);
+}
+
+TEST_F(DriverExecutorTest, timeSlice) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 100; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 31; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto executor = std::make_shared<DriverExecutor>(options(2));
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .values(vectors)
+                        .project({"c0", "c1 * 2 + c0 AS c1"})
+                        .partialAggregation({"c0"}, {"sum(c1)"})
+                        .localPartition({"c0"})
+                        .finalAggregation()
+                        .planNode();
+  params.maxDrivers = 2;
+  // A time slice of 1ms makes the Drivers yield many times.
+  params.queryCtx = core::QueryCtx::createForTest(
+      std::make_shared<core::MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {core::QueryConfig::kDriverCpuTimeSliceMs, "1"},
+              {core::QueryConfig::kDriverPriority, "2"}}),
+      executor);
+  auto task = assertQuery(
+      params, "SELECT c0, sum(c1 * 2 + c0) FROM tmp GROUP BY 1");
+  EXPECT_GT(task->taskStats().numDriverTimeSliceYields, 0);
+}
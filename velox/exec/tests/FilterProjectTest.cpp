@@ -15,6 +15,7 @@
  */
 #include "velox/dwio/dwrf/test/utils/BatchMaker.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -308,3 +309,42 @@ TEST_F(FilterProjectTest, filterProjectFused) {
       plan,
       "SELECT c0, c1, c0 %100 + c1 % 50, c0 % 100 FROM tmp WHERE c0 % 10 < 5");
 }
+
+TEST_F(FilterProjectTest, compaction) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    auto vector = std::dynamic_pointer_cast<RowVector>(
+        BatchMaker::createBatch(rowType_, 1'000, *pool_));
+    vectors.push_back(vector);
+  }
+  createDuckDbTable(vectors);
+
+  // About 2% of the rows pass, so the passing rows are copied before the
+  // projections unless compaction is disabled.
+  core::PlanNodeId projectNodeId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .filter("c0 % 50 = 7")
+                  .project({"c1", "c0 + c2 AS e0", "c3 * 2.0 AS e1"})
+                  .capturePlanNodeId(projectNodeId)
+                  .planNode();
+  const auto sql = "SELECT c1, c0 + c2, c3 * 2.0 FROM tmp WHERE c0 % 50 = 7";
+
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_).assertResults(sql);
+  EXPECT_LT(
+      0,
+      toPlanStats(task->taskStats())
+          .at(projectNodeId)
+          .customStats.at("compactedBatches")
+          .sum);
+
+  task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .config(core::QueryConfig::kFilterProjectCompactionSelectivity, "0")
+          .assertResults(sql);
+  EXPECT_EQ(
+      0,
+      toPlanStats(task->taskStats())
+          .at(projectNodeId)
+          .customStats.count("compactedBatches"));
+}
@@ -14,12 +14,19 @@
  * limitations under the License.
  */
 
+#include <folly/json.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/dwrf/test/utils/BatchMaker.h"
+#include "velox/exec/DynamicFilters.h"
+#include "velox/exec/HashTableCache.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/SharedHashTables.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 
 using namespace facebook::velox;
@@ -128,6 +135,40 @@ class HashJoinTest : public HiveConnectorTestBase {
     return stats[operatorIndex].runtimeStats["replacedWithDynamicFilterRows"];
   }
 
+  // Returns the sum of spilled bytes of the operators of type
+  // 'operatorType'.
+  static uint64_t getSpilledBytes(
+      const std::shared_ptr<Task>& task,
+      const std::string& operatorType) {
+    uint64_t spilledBytes = 0;
+    for (const auto& pipeline : task->taskStats().pipelineStats) {
+      for (const auto& op : pipeline.operatorStats) {
+        if (op.operatorType == operatorType) {
+          spilledBytes += op.spilledBytes;
+        }
+      }
+    }
+    return spilledBytes;
+  }
+
+  // Returns the sum of the runtime stat 'name' of the operators of type
+  // 'operatorType'.
+  static int64_t getRuntimeStatSum(
+      const std::shared_ptr<Task>& task,
+      const std::string& operatorType,
+      const std::string& name) {
+    int64_t sum = 0;
+    for (const auto& pipeline : task->taskStats().pipelineStats) {
+      for (const auto& op : pipeline.operatorStats) {
+        auto it = op.runtimeStats.find(name);
+        if (op.operatorType == operatorType && it != op.runtimeStats.end()) {
+          sum += it->second.sum;
+        }
+      }
+    }
+    return sum;
+  }
+
   static uint64_t getInputPositions(
       const std::shared_ptr<Task>& task,
       int operatorIndex) {
@@ -658,6 +699,71 @@ TEST_F(HashJoinTest, antiJoin) {
   assertQuery(op, "SELECT t.c1 FROM t WHERE t.c0 NOT IN (SELECT c0 FROM u)");
 }
 
+TEST_F(HashJoinTest, keyOnlySemiAndAntiJoin) {
+  auto probeVectors = makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 300; }),
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row; }),
+  });
+  // 10K build rows with 100 distinct keys and a payload that is not needed
+  // unless it is in the output.
+  std::string payload(100, 'x');
+  auto buildVectors = makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int32_t>(10'000, [](auto row) { return row % 100; }),
+       makeFlatVector<StringView>(
+           10'000, [&](auto /*row*/) { return StringView(payload); })});
+
+  createDuckDbTable("t", {probeVectors});
+  createDuckDbTable("u", {buildVectors});
+
+  auto makePlan = [&](core::JoinType joinType,
+                      const std::vector<std::string>& output) {
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    return PlanBuilder(planNodeIdGenerator)
+        .values({probeVectors})
+        .hashJoin(
+            {"c0"},
+            {"u_c0"},
+            PlanBuilder(planNodeIdGenerator).values({buildVectors}).planNode(),
+            "",
+            output,
+            joinType)
+        .planNode();
+  };
+  auto buildPeakMemory = [](const std::shared_ptr<Task>& task) {
+    auto planStats = toPlanStats(task->taskStats());
+    for (auto& [id, stats] : planStats) {
+      if (stats.operatorStats.count("HashBuild")) {
+        return stats.operatorStats.at("HashBuild")->peakMemoryBytes;
+      }
+    }
+    return uint64_t(0);
+  };
+
+  auto semiPlan = makePlan(core::JoinType::kLeftSemi, {"c1"});
+  ASSERT_TRUE(isKeyOnlyJoin(
+      *std::dynamic_pointer_cast<const core::HashJoinNode>(semiPlan)));
+  auto keyOnlyTask = assertQuery(
+      semiPlan, "SELECT t.c1 FROM t WHERE t.c0 IN (SELECT u_c0 FROM u)");
+
+  auto antiPlan = makePlan(core::JoinType::kAnti, {"c1"});
+  ASSERT_TRUE(isKeyOnlyJoin(
+      *std::dynamic_pointer_cast<const core::HashJoinNode>(antiPlan)));
+  assertQuery(
+      antiPlan, "SELECT t.c1 FROM t WHERE t.c0 NOT IN (SELECT u_c0 FROM u)");
+
+  // The payload in the output needs the build side rows.
+  auto payloadPlan = makePlan(core::JoinType::kLeftSemi, {"c1", "u_c1"});
+  ASSERT_FALSE(isKeyOnlyJoin(
+      *std::dynamic_pointer_cast<const core::HashJoinNode>(payloadPlan)));
+  auto payloadTask = assertQuery(
+      payloadPlan,
+      fmt::format(
+          "SELECT t.c1, '{}' FROM t WHERE t.c0 IN (SELECT u_c0 FROM u)",
+          payload));
+  EXPECT_LT(2 * buildPeakMemory(keyOnlyTask), buildPeakMemory(payloadTask));
+}
+
 TEST_F(HashJoinTest, antiJoinWithFilter) {
   auto leftVectors = makeRowVector(
       {"t0", "t1"},
@@ -1005,6 +1111,231 @@ TEST_F(HashJoinTest, dynamicFilters) {
   }
 }
 
+TEST_F(HashJoinTest, bloomFilterDynamicFilters) {
+  const int32_t numSplits = 10;
+  const int32_t numRowsProbe = 2'048;
+  // More distinct keys than VectorHasher keeps track of. The join keys get
+  // BloomFilters instead of exact dynamic filters.
+  const int32_t numRowsBuild = 150'000;
+
+  // Probe side keys are in [0, 20480).
+  std::vector<RowVectorPtr> leftVectors;
+  leftVectors.reserve(numSplits);
+  auto leftFiles = makeFilePaths(numSplits);
+  for (int i = 0; i < numSplits; i++) {
+    auto rowVector = makeRowVector({
+        makeFlatVector<int64_t>(
+            numRowsProbe, [&](auto row) { return i * numRowsProbe + row; }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    });
+    leftVectors.push_back(rowVector);
+    writeToFile(leftFiles[i]->path, rowVector);
+  }
+
+  // Build side keys are the even numbers in [0, 300000). Only the even probe
+  // side keys have a match.
+  auto rightVectors = {makeRowVector({
+      makeFlatVector<int64_t>(numRowsBuild, [](auto row) { return row * 2; }),
+      makeFlatVector<int64_t>(numRowsBuild, [](auto row) { return row; }),
+  })};
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  auto probeType = ROW({"c0", "c1"}, {BIGINT(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto buildSide = PlanBuilder(planNodeIdGenerator)
+                       .values(rightVectors)
+                       .project({"c0 AS u_c0", "c1 AS u_c1"})
+                       .planNode();
+
+  // Single key.
+  {
+    core::PlanNodeId leftScanId;
+    auto op = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(probeType)
+                  .capturePlanNodeId(leftScanId)
+                  .hashJoin({"c0"}, {"u_c0"}, buildSide, "", {"c1", "u_c1"})
+                  .planNode();
+
+    auto task =
+        AssertQueryBuilder(op, duckDbQueryRunner_)
+            .splits(leftScanId, makeHiveConnectorSplits(leftFiles))
+            .assertResults("SELECT t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0");
+    EXPECT_EQ(1, getFiltersProduced(task, 1).sum);
+    EXPECT_EQ(1, getFiltersAccepted(task, 0).sum);
+    // A BloomFilter passes false positives and cannot replace the join.
+    EXPECT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+    EXPECT_LT(getInputPositions(task, 1), numRowsProbe * numSplits * 3 / 4);
+
+    // Left semi join.
+    op = PlanBuilder(planNodeIdGenerator)
+             .tableScan(probeType)
+             .capturePlanNodeId(leftScanId)
+             .hashJoin(
+                 {"c0"},
+                 {"u_c0"},
+                 buildSide,
+                 "",
+                 {"c0", "c1"},
+                 core::JoinType::kLeftSemi)
+             .planNode();
+
+    task = AssertQueryBuilder(op, duckDbQueryRunner_)
+               .splits(leftScanId, makeHiveConnectorSplits(leftFiles))
+               .assertResults(
+                   "SELECT t.c0, t.c1 FROM t WHERE t.c0 IN (SELECT c0 FROM u)");
+    EXPECT_EQ(1, getFiltersProduced(task, 1).sum);
+    EXPECT_EQ(1, getFiltersAccepted(task, 0).sum);
+    EXPECT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+    EXPECT_LT(getInputPositions(task, 1), numRowsProbe * numSplits * 3 / 4);
+  }
+
+  // Multi-column key. Each key column gets its own filter.
+  {
+    core::PlanNodeId leftScanId;
+    auto op = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(probeType)
+                  .capturePlanNodeId(leftScanId)
+                  .hashJoin(
+                      {"c0", "c1"}, {"u_c0", "u_c1"}, buildSide, "", {"c0"})
+                  .planNode();
+
+    auto task =
+        AssertQueryBuilder(op, duckDbQueryRunner_)
+            .splits(leftScanId, makeHiveConnectorSplits(leftFiles))
+            .assertResults(
+                "SELECT t.c0 FROM t, u WHERE t.c0 = u.c0 AND t.c1 = u.c1");
+    EXPECT_EQ(2, getFiltersProduced(task, 1).sum);
+    EXPECT_EQ(2, getFiltersAccepted(task, 0).sum);
+    EXPECT_LT(getInputPositions(task, 1), numRowsProbe * numSplits * 3 / 4);
+  }
+
+  // No BloomFilters for a left join.
+  {
+    core::PlanNodeId leftScanId;
+    auto op = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(probeType)
+                  .capturePlanNodeId(leftScanId)
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      buildSide,
+                      "",
+                      {"c1", "u_c1"},
+                      core::JoinType::kLeft)
+                  .planNode();
+
+    auto task =
+        AssertQueryBuilder(op, duckDbQueryRunner_)
+            .splits(leftScanId, makeHiveConnectorSplits(leftFiles))
+            .assertResults(
+                "SELECT t.c1, u.c1 FROM t LEFT JOIN u ON t.c0 = u.c0");
+    EXPECT_EQ(0, getFiltersProduced(task, 1).sum);
+    EXPECT_EQ(numRowsProbe * numSplits, getInputPositions(task, 1));
+  }
+}
+
+TEST_F(HashJoinTest, remoteDynamicFilters) {
+  const int32_t numSplits = 10;
+  const int32_t numRowsProbe = 1'024;
+  std::vector<RowVectorPtr> probeVectors;
+  auto probeFiles = makeFilePaths(numSplits);
+  for (int i = 0; i < numSplits; i++) {
+    probeVectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            numRowsProbe, [&](auto row) { return row - i * 10; }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    }));
+    writeToFile(probeFiles[i]->path, probeVectors.back());
+  }
+  // 100 key values in [35, 233] range.
+  auto buildVectors = makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int32_t>(100, [](auto row) { return 35 + row * 2; }),
+       makeFlatVector<int64_t>(100, [](auto row) { return row; })});
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", {buildVectors});
+  auto probeType = ROW({"c0", "c1"}, {INTEGER(), BIGINT()});
+
+  // The join runs in one Task. Its probe side waits for splits once the
+  // build is finished.
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId joinScanId;
+  core::PlanNodeId joinId;
+  auto joinPlan = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(probeType)
+                      .capturePlanNodeId(joinScanId)
+                      .hashJoin(
+                          {"c0"},
+                          {"u_c0"},
+                          PlanBuilder(planNodeIdGenerator)
+                              .values({buildVectors})
+                              .planNode(),
+                          "",
+                          {"c1", "u_c1"})
+                      .capturePlanNodeId(joinId)
+                      .planNode();
+  auto joinTask = std::make_shared<Task>(
+      "local://join.0.0.0",
+      core::PlanFragment{joinPlan},
+      0,
+      core::QueryCtx::createForTest(),
+      [](RowVectorPtr /*vector*/, ContinueFuture* /*future*/) {
+        return BlockingReason::kNotBlocked;
+      });
+  Task::start(joinTask, 1);
+  std::optional<std::string> filters;
+  while (!(filters = joinTask->joinDynamicFilters(joinId)).has_value()) {
+    // sleep override
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  auto parsed = folly::parseJson(filters.value());
+  ASSERT_EQ(1, parsed.size());
+  auto filter = deserializeDynamicFilter(parsed["c0"]);
+  EXPECT_TRUE(filter->testInt64(35));
+  EXPECT_FALSE(filter->testInt64(36));
+  joinTask->noMoreSplits(joinScanId);
+  ASSERT_TRUE(waitForTaskCompletion(joinTask.get()));
+
+  // The probe side scan of another Task reads only the rows that pass.
+  planNodeIdGenerator->reset();
+  core::PlanNodeId scanId;
+  auto scanPlan = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(probeType)
+                      .capturePlanNodeId(scanId)
+                      .planNode();
+  std::vector<RowVectorPtr> results;
+  auto scanTask = std::make_shared<Task>(
+      "local://scan.0.0.0",
+      core::PlanFragment{scanPlan},
+      0,
+      core::QueryCtx::createForTest(),
+      [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+        if (vector) {
+          results.push_back(vector);
+        }
+        return BlockingReason::kNotBlocked;
+      });
+  scanTask->addDynamicFilters(scanId, filters.value());
+  for (auto& split : makeHiveConnectorSplits(probeFiles)) {
+    scanTask->addSplit(scanId, exec::Split(std::move(split)));
+  }
+  scanTask->noMoreSplits(scanId);
+  Task::start(scanTask, 1);
+  ASSERT_TRUE(waitForTaskCompletion(scanTask.get()));
+  assertResults(
+      results,
+      probeType,
+      "SELECT * FROM t WHERE c0 IN (SELECT u_c0 FROM u)",
+      duckDbQueryRunner_);
+  EXPECT_EQ(1, getFiltersAccepted(scanTask, 0).sum);
+
+  VELOX_ASSERT_THROW(
+      scanTask->addDynamicFilters(scanId, R"({"c2": {}})"),
+      "Dynamic filter on a column not read by TableScan");
+}
+
 TEST_F(HashJoinTest, leftJoin) {
   // Left side keys are [0, 1, 2,..10].
   // Use 3-rd column as row number to allow for asserting the order of results.
@@ -1538,3 +1869,301 @@ TEST_F(HashJoinTest, smallOutputBatchSize) {
       .config(core::QueryConfig::kPreferredOutputBatchSize, std::to_string(10))
       .assertResults("SELECT c0, u_c1 FROM t, u WHERE c0 = u_c0 AND c1 < u_c1");
 }
+
+TEST_F(HashJoinTest, spill) {
+  std::vector<RowVectorPtr> probeData;
+  std::vector<RowVectorPtr> buildData;
+  for (auto i = 0; i < 10; ++i) {
+    probeData.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            10'000,
+            [i](auto row) { return (row * 7 + i) % 20'000; },
+            nullEvery(97)),
+        makeFlatVector<int64_t>(10'000, [](auto row) { return row; }),
+    }));
+    buildData.push_back(makeRowVector(
+        {"u_c0", "u_c1"},
+        {
+            makeFlatVector<int32_t>(
+                5'000, [i](auto row) { return row * 3 + i; }, nullEvery(101)),
+            makeFlatVector<StringView>(
+                5'000,
+                [](auto row) {
+                  return StringView(std::string(row % 30, 'x'));
+                }),
+        }));
+  }
+
+  createDuckDbTable("t", probeData);
+  createDuckDbTable("u", buildData);
+
+  auto tempDirectory = TempDirectoryPath::create();
+  for (auto joinType : {core::JoinType::kInner, core::JoinType::kLeft}) {
+    SCOPED_TRACE(core::joinTypeName(joinType));
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeData, true)
+                    .hashJoin(
+                        {"c0"},
+                        {"u_c0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildData, true)
+                            .planNode(),
+                        "",
+                        {"c0", "c1", "u_c1"},
+                        joinType)
+                    .planNode();
+
+    // The probe side spill files and the repartitioned files of both sides
+    // use the configured codec.
+    for (const auto* codec : {"none", "zstd"}) {
+      SCOPED_TRACE(codec);
+      auto task =
+          AssertQueryBuilder(plan, duckDbQueryRunner_)
+              .maxDrivers(4)
+              .config(core::QueryConfig::kSpillPath, tempDirectory->path)
+              .config(core::QueryConfig::kTestingSpillPct, "100")
+              .config(core::QueryConfig::kSpillCompressionCodec, codec)
+              .assertResults(fmt::format(
+                  "SELECT c0, c1, u_c1 FROM t {} JOIN u ON c0 = u_c0",
+                  joinType == core::JoinType::kInner ? "INNER" : "LEFT"));
+
+      EXPECT_LT(0, getSpilledBytes(task, "HashBuild"));
+      EXPECT_LT(0, getSpilledBytes(task, "HashProbe"));
+    }
+  }
+}
+
+TEST_F(HashJoinTest, adaptiveSwap) {
+  // A small probe side and a much larger build side. Each of the 2 Drivers of
+  // each side produces all of its data, hence the DuckDB tables have it
+  // twice.
+  auto probeData = makeRowVector({
+      makeFlatVector<int32_t>(
+          100, [](auto row) { return row % 50; }, nullEvery(13)),
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+  });
+  std::vector<RowVectorPtr> buildData;
+  for (auto i = 0; i < 10; ++i) {
+    buildData.push_back(makeRowVector(
+        {"u_c0", "u_c1"},
+        {
+            makeFlatVector<int32_t>(
+                1'000,
+                [i](auto row) { return (row + i) % 200; },
+                nullEvery(11)),
+            makeFlatVector<StringView>(
+                1'000,
+                [](auto row) {
+                  return StringView(std::string(row % 30, 'x'));
+                }),
+        }));
+  }
+  createDuckDbTable("t", {probeData, probeData});
+  auto duplicatedBuildData = buildData;
+  duplicatedBuildData.insert(
+      duplicatedBuildData.end(), buildData.begin(), buildData.end());
+  createDuckDbTable("u", duplicatedBuildData);
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values({probeData}, true)
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(buildData, true)
+                          .planNode(),
+                      "",
+                      {"c1", "u_c1", "c0"})
+                  .planNode();
+
+  struct {
+    bool enabled;
+    std::string maxProbeRows;
+    int64_t numSwapped;
+  } testSettings[] = {
+      {false, "100000", 0}, {true, "100000", 2}, {true, "50", 0}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(fmt::format(
+        "enabled: {}, maxProbeRows: {}",
+        testData.enabled,
+        testData.maxProbeRows));
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .maxDrivers(2)
+            .config(
+                core::QueryConfig::kHashJoinAdaptiveSwapEnabled,
+                testData.enabled ? "true" : "false")
+            .config(
+                core::QueryConfig::kHashJoinSwapMaxProbeRows,
+                testData.maxProbeRows)
+            .assertResults("SELECT c1, u_c1, c0 FROM t, u WHERE c0 = u_c0");
+    EXPECT_EQ(
+        testData.numSwapped,
+        getRuntimeStatSum(task, "HashProbe", "hashJoinSwapped"));
+  }
+
+  // A TableScan probe side accepts dynamic filters from the build side, so
+  // the join is not swapped. The 2 splits give the scan the probe data
+  // twice.
+  auto probeFile = TempFilePath::create();
+  writeToFile(probeFile->path, {probeData});
+  core::PlanNodeId probeScanId;
+  plan = PlanBuilder(planNodeIdGenerator)
+             .tableScan(asRowType(probeData->type()))
+             .capturePlanNodeId(probeScanId)
+             .hashJoin(
+                 {"c0"},
+                 {"u_c0"},
+                 PlanBuilder(planNodeIdGenerator)
+                     .values(buildData, true)
+                     .planNode(),
+                 "",
+                 {"c1", "u_c1", "c0"})
+             .planNode();
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .maxDrivers(2)
+          .split(probeScanId, makeHiveConnectorSplit(probeFile->path))
+          .split(probeScanId, makeHiveConnectorSplit(probeFile->path))
+          .config(core::QueryConfig::kHashJoinAdaptiveSwapEnabled, "true")
+          .config(core::QueryConfig::kHashJoinSwapMaxProbeRows, "100000")
+          .assertResults("SELECT c1, u_c1, c0 FROM t, u WHERE c0 = u_c0");
+  EXPECT_EQ(0, getRuntimeStatSum(task, "HashProbe", "hashJoinSwapped"));
+}
+
+TEST_F(HashJoinTest, sharedHashTable) {
+  auto probeData = makeRowVector({
+      makeFlatVector<int32_t>(
+          1'000, [](auto row) { return row % 100; }, nullEvery(13)),
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  });
+  auto buildData = makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int32_t>(300, [](auto row) { return row % 150; }),
+       makeFlatVector<int64_t>(300, [](auto row) { return row * 10; })});
+  createDuckDbTable("t", {probeData});
+  createDuckDbTable("u", {buildData});
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId joinId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values({probeData})
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values({buildData})
+                          .planNode(),
+                      "",
+                      {"c1", "u_c1"})
+                  .capturePlanNodeId(joinId)
+                  .planNode();
+
+  auto queryCtx = core::QueryCtx::createForTest();
+  queryCtx->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kSharedHashTableJoinIds, joinId}});
+
+  // The tasks of stage 1 share the table. The task of stage 2 builds its
+  // own.
+  std::vector<std::string> taskIds = {
+      "local://shared.1.0.0", "local://shared.1.0.1", "local://shared.2.0.0"};
+  std::vector<std::shared_ptr<Task>> tasks;
+  std::vector<std::vector<RowVectorPtr>> results(taskIds.size());
+  for (auto i = 0; i < taskIds.size(); ++i) {
+    tasks.push_back(std::make_shared<Task>(
+        taskIds[i],
+        core::PlanFragment{plan},
+        0,
+        queryCtx,
+        [&results, i](RowVectorPtr vector, ContinueFuture* /*future*/) {
+          if (vector) {
+            results[i].push_back(vector);
+          }
+          return BlockingReason::kNotBlocked;
+        }));
+    Task::start(tasks.back(), 1);
+    ASSERT_TRUE(waitForTaskCompletion(tasks.back().get()));
+  }
+  EXPECT_EQ(2, SharedHashTables::instance().size());
+
+  for (auto i = 0; i < tasks.size(); ++i) {
+    assertResults(
+        results[i],
+        asRowType(plan->outputType()),
+        "SELECT c1, u_c1 FROM t, u WHERE c0 = u_c0",
+        duckDbQueryRunner_);
+    EXPECT_EQ(
+        i == 1 ? 1 : 0,
+        getRuntimeStatSum(tasks[i], "HashBuild", "sharedHashTable"));
+  }
+
+  // The tables go with the last tasks that probe them.
+  tasks.clear();
+  EXPECT_EQ(0, SharedHashTables::instance().size());
+}
+
+TEST_F(HashJoinTest, hashTableCache) {
+  auto probeData = makeRowVector({
+      makeFlatVector<int32_t>(
+          1'000, [](auto row) { return row % 100; }, nullEvery(13)),
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  });
+  auto buildData = makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int32_t>(300, [](auto row) { return row % 150; }),
+       makeFlatVector<int64_t>(300, [](auto row) { return row * 10; })});
+  auto buildFile = TempFilePath::create();
+  writeToFile(buildFile->path, {buildData});
+  createDuckDbTable("t", {probeData});
+  createDuckDbTable("u", {buildData});
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId buildScanId;
+  core::PlanNodeId joinId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values({probeData})
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .tableScan(asRowType(buildData->type()))
+                          .capturePlanNodeId(buildScanId)
+                          .planNode(),
+                      "",
+                      {"c1", "u_c1"})
+                  .capturePlanNodeId(joinId)
+                  .planNode();
+
+  auto runQuery = [&](const std::string& fileVersion) {
+    auto split = makeHiveConnectorSplit(buildFile->path);
+    std::dynamic_pointer_cast<connector::hive::HiveConnectorSplit>(split)
+        ->fileVersion = fileVersion;
+    return AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kHashTableCacheJoinIds, joinId)
+        .split(buildScanId, split)
+        .assertResults("SELECT c1, u_c1 FROM t, u WHERE c0 = u_c0");
+  };
+
+  auto& cache = HashTableCache::instance();
+  cache.clear();
+  auto task = runQuery("v1");
+  EXPECT_EQ(0, getRuntimeStatSum(task, "HashBuild", "hashTableCacheHit"));
+  EXPECT_EQ(1, cache.size());
+
+  task = runQuery("v1");
+  EXPECT_EQ(1, getRuntimeStatSum(task, "HashBuild", "hashTableCacheHit"));
+  EXPECT_EQ(0, toPlanStats(task->taskStats()).at(buildScanId).rawInputRows);
+
+  // A new version of the file is not in the cache.
+  task = runQuery("v2");
+  EXPECT_EQ(0, getRuntimeStatSum(task, "HashBuild", "hashTableCacheHit"));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_LT(0, cache.tracker()->getCurrentTotalBytes());
+
+  cache.setCapacity(0);
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(0, cache.tracker()->getCurrentTotalBytes());
+  cache.setCapacity(HashTableCache::kDefaultCapacity);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/HashPartitionFunction.h"
+#include <gtest/gtest.h>
+#include "velox/vector/tests/VectorMaker.h"
+
+using namespace facebook::velox;
+
+// Constant and dictionary encoded keys are partitioned from their distinct
+// values. The partitions must be those of the flat copies of the keys.
+TEST(HashPartitionFunctionTest, encodings) {
+  auto pool = memory::getDefaultScopedMemoryPool();
+  test::VectorMaker vm(pool.get());
+
+  const vector_size_t size = 1'000;
+  auto base = vm.flatVectorNullable<int64_t>(
+      {1, std::nullopt, 123'456'789'012LL, -7, 42});
+  auto indices = AlignedBuffer::allocate<vector_size_t>(size, pool.get());
+  auto nulls = AlignedBuffer::allocate<bool>(size, pool.get());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  auto* rawNulls = nulls->asMutable<uint64_t>();
+  for (auto i = 0; i < size; ++i) {
+    rawIndices[i] = (i * 7) % base->size();
+    bits::setNull(rawNulls, i, i % 11 == 0);
+  }
+  auto dictionary = BaseVector::wrapInDictionary(nulls, indices, size, base);
+  auto constant = BaseVector::wrapInConstant(size, 2, base);
+
+  for (auto& key : {dictionary, constant}) {
+    auto flat = BaseVector::create(key->type(), size, pool.get());
+    flat->copy(key.get(), 0, 0, size);
+    auto rowType = ROW({"c0"}, {BIGINT()});
+    exec::HashPartitionFunction partitionFunction(100, rowType, {0});
+
+    std::vector<uint32_t> expected;
+    partitionFunction.partition(*vm.rowVector({flat}), expected);
+    std::vector<uint32_t> partitions;
+    partitionFunction.partition(*vm.rowVector({key}), partitions);
+    EXPECT_EQ(expected, partitions) << key->toString();
+  }
+
+  // A constant key channel.
+  auto rowType = ROW({"c0"}, {BIGINT()});
+  exec::HashPartitionFunction constantChannel(
+      100, rowType, {kConstantChannel}, {vm.flatVector<int64_t>({42})});
+  exec::HashPartitionFunction flatChannel(100, rowType, {0});
+  std::vector<uint32_t> expected;
+  flatChannel.partition(
+      *vm.rowVector({BaseVector::wrapInConstant(size, 4, base)}), expected);
+  std::vector<uint32_t> partitions;
+  constantChannel.partition(*vm.rowVector({base}), partitions);
+  EXPECT_EQ(std::vector<uint32_t>(base->size(), expected[0]), partitions);
+}
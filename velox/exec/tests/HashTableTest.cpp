@@ -19,6 +19,7 @@
 #include "velox/exec/VectorHasher.h"
 #include "velox/vector/tests/VectorMaker.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <memory>
 
@@ -68,7 +69,12 @@ class HashTableTest : public testing::Test {
             buildType->childAt(channel), channel));
       }
       auto table = HashTable<true>::createForJoin(
-          std::move(keyHashers), dependentTypes, true, false, mappedMemory_);
+          std::move(keyHashers),
+          dependentTypes,
+          true,
+          false,
+          mappedMemory_,
+          layout_);
 
       makeRows(size, 1, sequence, buildType, batches);
       copyVectorsToTable(batches, startOffset, table.get());
@@ -81,8 +87,9 @@ class HashTableTest : public testing::Test {
       batches_.insert(batches_.end(), batches.begin(), batches.end());
       startOffset += size;
     }
-    topTable_->prepareJoinTable(std::move(otherTables));
+    topTable_->prepareJoinTable(std::move(otherTables), executor_.get());
     EXPECT_EQ(topTable_->hashMode(), mode);
+    EXPECT_EQ(topTable_->layout(), layout_);
     LOG(INFO) << "Made table " << describeTable();
     testProbe();
     testEraseEveryN(3);
@@ -142,7 +149,7 @@ class HashTableTest : public testing::Test {
     }
     static std::vector<std::unique_ptr<Aggregate>> empty;
     return HashTable<false>::createForAggregation(
-        std::move(keyHashers), empty, mappedMemory_);
+        std::move(keyHashers), empty, mappedMemory_, layout_);
   }
 
   void insertGroups(
@@ -201,6 +208,9 @@ class HashTableTest : public testing::Test {
       }
       out << ") ";
     }
+    if (topTable_->layout() == BaseHashTable::Layout::kInterleaved) {
+      out << "interleaved ";
+    }
     out << topTable_->numDistinct() << " entries";
     return out.str();
   }
@@ -442,6 +452,11 @@ class HashTableTest : public testing::Test {
   // Spacing between consecutive generated keys. Affects whether
   // Vectorhashers make ranges or ids of distinct values.
   int32_t keySpacing_ = 1;
+  // Executor for building the join table in parallel. Serial build if
+  // nullptr.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+  // Layout of the tables made by the test.
+  BaseHashTable::Layout layout_ = BaseHashTable::Layout::kSeparate;
 };
 
 TEST_F(HashTableTest, int2DenseArray) {
@@ -493,6 +508,113 @@ TEST_F(HashTableTest, mixed6Sparse) {
   testCycle(BaseHashTable::HashMode::kHash, 1000000, 2, type, 6);
 }
 
+TEST_F(HashTableTest, int2SparseNormalizedParallel) {
+  auto type = ROW({"k1", "k2"}, {BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  testCycle(BaseHashTable::HashMode::kNormalizedKey, 50000, 4, type, 2);
+}
+
+TEST_F(HashTableTest, mixed6SparseParallel) {
+  auto type =
+      ROW({"k1", "k2", "k3", "k4", "k5", "k6"},
+          {BIGINT(), BIGINT(), BIGINT(), BIGINT(), BIGINT(), VARCHAR()});
+  keySpacing_ = 1000;
+  executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  testCycle(BaseHashTable::HashMode::kHash, 100000, 6, type, 6);
+}
+
+// The interleaved cases repeat the cases above with the tags and row pointers
+// in buckets. The probe time per row is logged for comparison.
+TEST_F(HashTableTest, int2SparseNormalizedInterleaved) {
+  auto type = ROW({"k1", "k2"}, {BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  layout_ = BaseHashTable::Layout::kInterleaved;
+  testCycle(BaseHashTable::HashMode::kNormalizedKey, 10000, 2, type, 2);
+}
+
+TEST_F(HashTableTest, int2SparseNormalizedMostMissInterleaved) {
+  auto type = ROW({"k1", "k2"}, {BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  insertPct_ = 10;
+  layout_ = BaseHashTable::Layout::kInterleaved;
+  testCycle(BaseHashTable::HashMode::kNormalizedKey, 100000, 2, type, 2);
+}
+
+TEST_F(HashTableTest, mixed6SparseInterleaved) {
+  auto type =
+      ROW({"k1", "k2", "k3", "k4", "k5", "k6"},
+          {BIGINT(), BIGINT(), BIGINT(), BIGINT(), BIGINT(), VARCHAR()});
+  keySpacing_ = 1000;
+  layout_ = BaseHashTable::Layout::kInterleaved;
+  testCycle(BaseHashTable::HashMode::kHash, 1000000, 2, type, 6);
+}
+
+TEST_F(HashTableTest, mixed6SparseParallelInterleaved) {
+  auto type =
+      ROW({"k1", "k2", "k3", "k4", "k5", "k6"},
+          {BIGINT(), BIGINT(), BIGINT(), BIGINT(), BIGINT(), VARCHAR()});
+  keySpacing_ = 1000;
+  executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  layout_ = BaseHashTable::Layout::kInterleaved;
+  testCycle(BaseHashTable::HashMode::kHash, 100000, 6, type, 6);
+}
+
+TEST_F(HashTableTest, interleavedSize) {
+  // The same keys take 8 instead of 9 bytes per slot in buckets.
+  auto type = ROW({"k1"}, {VARCHAR()});
+  std::vector<RowVectorPtr> batches;
+  makeRows(10'000, 1, 0, type, batches);
+  std::vector<int64_t> tableBytes;
+  for (auto layout :
+       {BaseHashTable::Layout::kSeparate,
+        BaseHashTable::Layout::kInterleaved}) {
+    layout_ = layout;
+    auto table = createHashTableForAggregation(type, 1);
+    table->forceGenericHashMode();
+    HashLookup lookup(table->hashers());
+    insertGroups(*batches[0], lookup, *table);
+    EXPECT_EQ(10'000, table->numDistinct());
+    // All keys are found again.
+    std::vector<char*> hits(lookup.hits.begin(), lookup.hits.end());
+    insertGroups(*batches[0], lookup, *table);
+    EXPECT_EQ(10'000, table->numDistinct());
+    for (auto i = 0; i < hits.size(); ++i) {
+      ASSERT_EQ(hits[i], lookup.hits[i]);
+    }
+    tableBytes.push_back(
+        table->allocatedBytes() - table->rows()->allocatedBytes());
+  }
+  EXPECT_EQ(tableBytes[0] / 9, tableBytes[1] / 8);
+}
+
+TEST_F(HashTableTest, duplicateKeysInProbeGroup) {
+  // Keys repeat within the rows of a probe group. A key inserted by one row
+  // of a group is found by the following rows of the group.
+  auto type = ROW({"k1"}, {VARCHAR()});
+  for (auto layout :
+       {BaseHashTable::Layout::kSeparate,
+        BaseHashTable::Layout::kInterleaved}) {
+    layout_ = layout;
+    auto table = createHashTableForAggregation(type, 1);
+    table->forceGenericHashMode();
+    HashLookup lookup(table->hashers());
+    std::vector<std::string> keys;
+    for (auto i = 0; i < 7; ++i) {
+      keys.push_back(std::string(20, 'x') + std::to_string(i));
+    }
+    auto data = vectorMaker_->rowVector({
+        vectorMaker_->flatVector<StringView>(
+            1'000, [&](auto row) { return StringView(keys[row % 7]); }),
+    });
+    insertGroups(*data, lookup, *table);
+    EXPECT_EQ(7, table->numDistinct());
+    for (auto i = 7; i < data->size(); ++i) {
+      ASSERT_EQ(lookup.hits[i % 7], lookup.hits[i]);
+    }
+  }
+}
+
 // It should be safe to call clear() before we insert any data into HashTable
 TEST_F(HashTableTest, clear) {
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
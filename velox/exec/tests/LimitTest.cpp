@@ -13,11 +13,14 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
 
 class LimitTest : public HiveConnectorTestBase {};
 
@@ -97,3 +100,99 @@ TEST_F(LimitTest, limitOverLocalExchange) {
   ASSERT_EQ(20, numRead);
   ASSERT_TRUE(waitForTaskCompletion(cursor.task().get()));
 }
+
+TEST_F(LimitTest, lazyColumns) {
+  // Filtering on c0 makes the scan return c1 and c2 as LazyVectors. The
+  // limit must produce correct values when only its first rows get loaded.
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(10'000, [](auto row) { return row; }),
+      makeFlatVector<int32_t>(10'000, [](auto row) { return row % 101; }),
+      makeFlatVector<double>(
+          10'000, [](auto row) { return row * 0.1; }, nullEvery(7)),
+  });
+  auto file = TempFilePath::create();
+  writeToFile(file->path, {data});
+  createDuckDbTable({data});
+
+  auto plan = PlanBuilder()
+                  .tableScan(asRowType(data->type()), {"c0 >= 1234"})
+                  .limit(0, 17, false)
+                  .planNode();
+  assertQuery(plan, {file}, "SELECT * FROM tmp WHERE c0 >= 1234 LIMIT 17");
+}
+
+TEST_F(LimitTest, lazyColumnsLoadedRows) {
+  // A LazyVector whose loader records the rows it is asked for. Limit must
+  // ask only for the rows it returns.
+  constexpr vector_size_t kSize = 10'000;
+  constexpr int32_t kLimit = 17;
+  auto values = makeFlatVector<int64_t>(kSize, [](auto row) { return row; });
+  std::vector<vector_size_t> loadedRows;
+  auto lazy = std::make_shared<LazyVector>(
+      pool(),
+      BIGINT(),
+      kSize,
+      std::make_unique<SimpleVectorLoader>([&](RowSet rows) {
+        loadedRows.insert(loadedRows.end(), rows.begin(), rows.end());
+        return values;
+      }));
+
+  auto plan = PlanBuilder()
+                  .values({makeRowVector({lazy})})
+                  .limit(0, kLimit, false)
+                  .planNode();
+  AssertQueryBuilder(plan).assertResults(makeRowVector(
+      {makeFlatVector<int64_t>(kLimit, [](auto row) { return row; })}));
+
+  ASSERT_EQ(kLimit, loadedRows.size());
+  for (auto i = 0; i < kLimit; ++i) {
+    EXPECT_EQ(i, loadedRows[i]);
+  }
+}
+
+TEST_F(LimitTest, sharedPartialLimit) {
+  // The partial Limit directly over the scan caps each scan at 100 rows and
+  // its drivers take their rows from a count shared by all of them, so that
+  // no driver reads more than one split and the partial Limit produces 100
+  // rows in total.
+  auto data = makeRowVector(
+      {makeFlatVector<int32_t>(1'000, [](auto row) { return row; })});
+  std::vector<std::shared_ptr<TempFilePath>> files;
+  for (auto i = 0; i < 10; ++i) {
+    files.push_back(TempFilePath::create());
+    writeToFile(files.back()->path, {data});
+  }
+
+  core::PlanNodeId scanNodeId;
+  core::PlanNodeId partialLimitNodeId;
+
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .tableScan(asRowType(data->type()))
+                        .capturePlanNodeId(scanNodeId)
+                        .limit(0, 100, true)
+                        .capturePlanNodeId(partialLimitNodeId)
+                        .localPartition({})
+                        .limit(0, 100, false)
+                        .planNode();
+  params.maxDrivers = 4;
+
+  TaskCursor cursor(params);
+  for (const auto& file : files) {
+    cursor.task()->addSplit(
+        scanNodeId, exec::Split(makeHiveConnectorSplit(file->path)));
+  }
+  cursor.task()->noMoreSplits(scanNodeId);
+
+  int32_t numRead = 0;
+  while (cursor.moveNext()) {
+    numRead += cursor.current()->size();
+  }
+  ASSERT_EQ(100, numRead);
+  ASSERT_TRUE(waitForTaskCompletion(cursor.task().get()));
+
+  auto planStats = toPlanStats(cursor.task()->taskStats());
+  EXPECT_EQ(100, planStats.at(partialLimitNodeId).outputRows);
+  EXPECT_LE(planStats.at(scanNodeId).outputRows, 4 * 100);
+  EXPECT_LE(planStats.at(scanNodeId).numSplits, 4);
+}
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/LocalPartition.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -656,3 +657,60 @@ TEST_F(LocalPartitionTest, unionAllLocalExchange) {
       "SELECT * from (VALUES ('y')) as T2 (c0)"
       ");");
 }
+
+// Passes data from many producer to many consumer threads directly through a
+// LocalExchangeQueue with a small buffer, so that both sides block often.
+TEST_F(LocalPartitionTest, concurrentQueue) {
+  constexpr int32_t kNumProducers = 8;
+  constexpr int32_t kNumConsumers = 4;
+  constexpr int32_t kVectorsPerProducer = 2'000;
+
+  auto data = makeRowVector({makeFlatSequence<int64_t>(0, 10)});
+  auto memoryManager =
+      std::make_shared<exec::LocalExchangeMemoryManager>(data->retainedSize());
+  auto queue = std::make_shared<exec::LocalExchangeQueue>(memoryManager, 0);
+  for (auto i = 0; i < kNumProducers; ++i) {
+    queue->addProducer();
+  }
+  queue->noMoreProducers();
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kNumProducers; ++i) {
+    threads.emplace_back([&]() {
+      for (auto j = 0; j < kVectorsPerProducer; ++j) {
+        ContinueFuture future;
+        if (queue->enqueue(data, &future) !=
+            exec::BlockingReason::kNotBlocked) {
+          future.wait();
+        }
+      }
+      queue->noMoreData();
+      ContinueFuture future;
+      if (queue->isFinished(&future) != exec::BlockingReason::kNotBlocked) {
+        future.wait();
+      }
+    });
+  }
+  std::atomic<int32_t> numReceived{0};
+  for (auto i = 0; i < kNumConsumers; ++i) {
+    threads.emplace_back([&]() {
+      for (;;) {
+        ContinueFuture future;
+        RowVectorPtr received;
+        if (queue->next(&future, pool(), &received) !=
+            exec::BlockingReason::kNotBlocked) {
+          future.wait();
+        } else if (received) {
+          ++numReceived;
+        } else {
+          return;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(kNumProducers * kVectorsPerProducer, numReceived);
+  EXPECT_TRUE(queue->isFinished());
+}
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/MemoryArbitrator.h"
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/Cursor.h"
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class MemoryArbitratorTest : public HiveConnectorTestBase {
+ protected:
+  static constexpr int64_t kMB = 1 << 20;
+
+  static MemoryArbitrator::Options options(int64_t capacity) {
+    MemoryArbitrator::Options options;
+    options.capacity = capacity;
+    options.initialQueryCapacity = kMB;
+    options.minGrowBytes = kMB;
+    return options;
+  }
+
+  std::shared_ptr<core::QueryCtx> makeQueryCtx(
+      std::unordered_map<std::string, std::string> config = {}) {
+    return core::QueryCtx::createForTest(
+        std::make_shared<core::MemConfig>(std::move(config)));
+  }
+
+  std::unique_ptr<TaskCursor> makeCursor(
+      const core::PlanNodePtr& plan,
+      const std::shared_ptr<core::QueryCtx>& queryCtx,
+      MemoryArbitrator& arbitrator) {
+    CursorParameters params;
+    params.planNode = plan;
+    params.queryCtx = queryCtx;
+    auto cursor = std::make_unique<TaskCursor>(params);
+    arbitrator.addTask(cursor->task());
+    return cursor;
+  }
+
+  static std::vector<RowVectorPtr> readAll(TaskCursor& cursor) {
+    std::vector<RowVectorPtr> results;
+    while (cursor.moveNext()) {
+      results.push_back(cursor.current());
+    }
+    return results;
+  }
+
+  // Returns 'numBatches' batches of 'batchSize' rows with distinct BIGINT
+  // keys in c0 and c0 modulo 7 in c1.
+  std::vector<RowVectorPtr> makeDistinctKeys(
+      int32_t numBatches,
+      int32_t batchSize) {
+    std::vector<RowVectorPtr> batches;
+    for (auto i = 0; i < numBatches; ++i) {
+      batches.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              batchSize, [&](auto row) { return i * batchSize + row; }),
+          makeFlatVector<int64_t>(
+              batchSize, [&](auto row) { return (i * batchSize + row) % 7; }),
+      }));
+    }
+    return batches;
+  }
+
+  // Plan counting the groups of 'input' by c0 and summing their sums of c1.
+  static core::PlanNodePtr makeAggregation(
+      const std::vector<RowVectorPtr>& input) {
+    return PlanBuilder()
+        .values(input)
+        .singleAggregation({"c0"}, {"sum(c1)"})
+        .singleAggregation({}, {"count(1)", "sum(a0)"})
+        .planNode();
+  }
+
+  // Expected result of makeAggregation() over 'numRows' distinct keys.
+  RowVectorPtr expectedAggregation(int64_t numRows) {
+    int64_t sum = 0;
+    for (auto i = 0; i < numRows; ++i) {
+      sum += i % 7;
+    }
+    return makeRowVector({
+        makeFlatVector<int64_t>(std::vector<int64_t>{numRows}),
+        makeFlatVector<int64_t>(std::vector<int64_t>{sum}),
+    });
+  }
+};
+
+TEST_F(MemoryArbitratorTest, growFromFreeCapacity) {
+  MemoryArbitrator arbitrator(options(1L << 30));
+  auto input = makeDistinctKeys(10, 10'000);
+  auto queryCtx = makeQueryCtx();
+  auto cursor = makeCursor(makeAggregation(input), queryCtx, arbitrator);
+  EXPECT_EQ((1L << 30) - kMB, arbitrator.freeCapacity());
+
+  assertEqualResults({expectedAggregation(100'000)}, readAll(*cursor));
+  auto stats = arbitrator.stats();
+  EXPECT_GT(stats.numRequests, 0);
+  EXPECT_EQ(0, stats.numFailures);
+  EXPECT_EQ(0, stats.numReclaims);
+  EXPECT_GT(queryCtx->pool()->getMemoryUsageTracker()->maxTotalBytes(), kMB);
+}
+
+TEST_F(MemoryArbitratorTest, failWithoutReclaimableMemory) {
+  // Without a spill path nothing can be reclaimed.
+  MemoryArbitrator arbitrator(options(2 * kMB));
+  auto input = makeDistinctKeys(100, 10'000);
+  auto cursor = makeCursor(makeAggregation(input), makeQueryCtx(), arbitrator);
+  VELOX_ASSERT_THROW(readAll(*cursor), "Exceeded memory cap");
+  EXPECT_GT(arbitrator.stats().numFailures, 0);
+}
+
+TEST_F(MemoryArbitratorTest, reclaimFromPausedQuery) {
+  constexpr int32_t kNumFiles = 10;
+  constexpr int32_t kRowsPerFile = 10'000;
+  constexpr int32_t kNumRows = kNumFiles * kRowsPerFile;
+  auto filePaths = makeFilePaths(kNumFiles);
+  auto makeString = [](auto key) {
+    return StringView(fmt::format("{}-abcdefghijklmnopqrstuvwxyz", key));
+  };
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < kNumFiles; ++i) {
+    // A permutation of 0..kNumRows - 1.
+    auto keys = makeFlatVector<int64_t>(kRowsPerFile, [&](auto row) {
+      return (i * kRowsPerFile + row) * 7919L % kNumRows;
+    });
+    vectors.push_back(makeRowVector({
+        keys,
+        makeFlatVector<StringView>(
+            kRowsPerFile,
+            [&](auto row) { return makeString(keys->valueAt(row)); }),
+    }));
+    writeToFile(filePaths[i]->path, vectors.back());
+  }
+  auto rowType = asRowType(vectors[0]->type());
+
+  MemoryArbitrator arbitrator(options(32 * kMB));
+  auto spillDirectory = TempDirectoryPath::create();
+  const std::unordered_map<std::string, std::string> spillConfig{
+      {core::QueryConfig::kSpillPath, spillDirectory->path}};
+
+  // The first query buffers its input in an OrderBy and waits for more
+  // splits.
+  core::PlanNodeId scanNodeId;
+  auto orderByPlan = PlanBuilder()
+                         .tableScan(rowType)
+                         .capturePlanNodeId(scanNodeId)
+                         .orderBy({"c0"}, false)
+                         .planNode();
+  auto orderByCursor =
+      makeCursor(orderByPlan, makeQueryCtx(spillConfig), arbitrator);
+  auto orderByTask = orderByCursor->task();
+  orderByCursor->start();
+  for (const auto& filePath : filePaths) {
+    orderByTask->addSplit(
+        scanNodeId, exec::Split(makeHiveConnectorSplit(filePath->path)));
+  }
+  while (orderByTask->taskStats().numFinishedSplits < kNumFiles) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // The second query needs more than the whole capacity. It takes the memory
+  // of the first query, which spills, and then spills itself.
+  auto input = makeDistinctKeys(200, 10'000);
+  auto aggregationCursor = makeCursor(
+      makeAggregation(input), makeQueryCtx(spillConfig), arbitrator);
+  assertEqualResults(
+      {expectedAggregation(2'000'000)}, readAll(*aggregationCursor));
+
+  auto stats = arbitrator.stats();
+  EXPECT_GT(stats.numReclaims, 0);
+  EXPECT_GT(stats.reclaimedBytes, 0);
+  // Returns the capacity of the second query.
+  aggregationCursor.reset();
+
+  // The first query finishes from its spilled run.
+  orderByTask->noMoreSplits(scanNodeId);
+  auto expected = makeRowVector({
+      makeFlatVector<int64_t>(kNumRows, [](auto row) { return row; }),
+      makeFlatVector<StringView>(kNumRows, makeString),
+  });
+  assertEqualResults({expected}, readAll(*orderByCursor));
+  auto orderByStats = orderByTask->taskStats().pipelineStats[0];
+  EXPECT_GT(orderByStats.operatorStats[1].spilledBytes, 0);
+}
+
+TEST_F(MemoryArbitratorTest, preemptAndResume) {
+  constexpr int32_t kNumFiles = 4;
+  constexpr int32_t kRowsPerFile = 10'000;
+  constexpr int32_t kNumRows = kNumFiles * kRowsPerFile;
+  auto filePaths = makeFilePaths(kNumFiles);
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < kNumFiles; ++i) {
+    // A permutation of 0..kNumRows - 1.
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        kRowsPerFile, [&](auto row) {
+          return (i * kRowsPerFile + row) * 7919L % kNumRows;
+        })}));
+    writeToFile(filePaths[i]->path, vectors.back());
+  }
+
+  MemoryArbitrator arbitrator(options(1L << 30));
+  auto spillDirectory = TempDirectoryPath::create();
+  auto queryCtx =
+      makeQueryCtx({{core::QueryConfig::kSpillPath, spillDirectory->path}});
+  core::PlanNodeId scanNodeId;
+  auto plan = PlanBuilder()
+                  .tableScan(asRowType(vectors[0]->type()))
+                  .capturePlanNodeId(scanNodeId)
+                  .orderBy({"c0"}, false)
+                  .planNode();
+  auto cursor = makeCursor(plan, queryCtx, arbitrator);
+  auto task = cursor->task();
+  cursor->start();
+  for (const auto& filePath : filePaths) {
+    task->addSplit(
+        scanNodeId, exec::Split(makeHiveConnectorSplit(filePath->path)));
+  }
+  while (task->taskStats().numFinishedSplits < kNumFiles) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // The OrderBy waits for more splits. Preempting spills its rows.
+  auto* tracker = queryCtx->pool()->getMemoryUsageTracker().get();
+  const auto bytesBefore = tracker->getCurrentTotalBytes();
+  ASSERT_TRUE(Task::preempt(task, 1'000));
+  EXPECT_TRUE(task->pauseRequested());
+  EXPECT_LT(tracker->getCurrentTotalBytes(), bytesBefore);
+
+  Task::resume(task);
+  task->noMoreSplits(scanNodeId);
+  assertEqualResults(
+      {makeRowVector(
+          {makeFlatVector<int64_t>(kNumRows, [](auto row) { return row; })})},
+      readAll(*cursor));
+  auto stats = task->taskStats().pipelineStats[0];
+  EXPECT_GT(stats.operatorStats[1].spilledBytes, 0);
+}
+
+TEST_F(MemoryArbitratorTest, preemptHashBuild) {
+  constexpr int32_t kNumFiles = 4;
+  constexpr int32_t kRowsPerFile = 10'000;
+  constexpr int32_t kNumRows = kNumFiles * kRowsPerFile;
+  auto filePaths = makeFilePaths(kNumFiles);
+  std::vector<RowVectorPtr> buildVectors;
+  for (auto i = 0; i < kNumFiles; ++i) {
+    buildVectors.push_back(makeRowVector(
+        {"u0"}, {makeFlatVector<int64_t>(kRowsPerFile, [&](auto row) {
+          return i * kRowsPerFile + row;
+        })}));
+    writeToFile(filePaths[i]->path, buildVectors.back());
+  }
+  // Every third build key has a probe row.
+  auto probe = makeRowVector(
+      {"t0"}, {makeFlatVector<int64_t>(kNumRows / 3, [](auto row) {
+        return row * 3;
+      })});
+
+  MemoryArbitrator arbitrator(options(1L << 30));
+  auto spillDirectory = TempDirectoryPath::create();
+  auto queryCtx =
+      makeQueryCtx({{core::QueryConfig::kSpillPath, spillDirectory->path}});
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId scanNodeId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values({probe})
+                  .hashJoin(
+                      {"t0"},
+                      {"u0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .tableScan(asRowType(buildVectors[0]->type()))
+                          .capturePlanNodeId(scanNodeId)
+                          .planNode(),
+                      "",
+                      {"t0", "u0"})
+                  .planNode();
+  auto cursor = makeCursor(plan, queryCtx, arbitrator);
+  auto task = cursor->task();
+  cursor->start();
+  for (const auto& filePath : filePaths) {
+    task->addSplit(
+        scanNodeId, exec::Split(makeHiveConnectorSplit(filePath->path)));
+  }
+  while (task->taskStats().numFinishedSplits < kNumFiles) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // The HashBuild waits for more splits. Preempting spills the build side.
+  auto* tracker = queryCtx->pool()->getMemoryUsageTracker().get();
+  const auto bytesBefore = tracker->getCurrentTotalBytes();
+  ASSERT_TRUE(Task::preempt(task, 1'000));
+  EXPECT_LT(tracker->getCurrentTotalBytes(), bytesBefore);
+
+  Task::resume(task);
+  task->noMoreSplits(scanNodeId);
+  auto keys = makeFlatVector<int64_t>(
+      kNumRows / 3, [](auto row) { return row * 3; });
+  assertEqualResults(
+      {makeRowVector({"t0", "u0"}, {keys, keys})}, readAll(*cursor));
+  uint64_t spilledBytes = 0;
+  for (const auto& pipelineStats : task->taskStats().pipelineStats) {
+    for (const auto& operatorStats : pipelineStats.operatorStats) {
+      if (operatorStats.operatorType == "HashBuild") {
+        spilledBytes += operatorStats.spilledBytes;
+      }
+    }
+  }
+  EXPECT_GT(spilledBytes, 0);
+}
@@ -203,6 +203,18 @@ TEST_F(MergeJoinTest, duplicateMatch) {
       [](auto row) { return row / 2; }, [](auto row) { return row / 3; });
 }
 
+TEST_F(MergeJoinTest, bigintKeys) {
+  // Long runs of equal keys on both sides.
+  testJoin<int64_t>(
+      [](auto row) { return row / 7; }, [](auto row) { return row / 3; });
+}
+
+TEST_F(MergeJoinTest, varcharKeys) {
+  testJoin<StringView>(
+      [](auto row) { return StringView(fmt::format("{:06}", row / 2)); },
+      [](auto row) { return StringView(fmt::format("{:06}", row * 2)); });
+}
+
 TEST_F(MergeJoinTest, allRowsMatch) {
   std::vector<VectorPtr> leftKeys = {
       makeFlatVector<int32_t>(2, [](auto /* row */) { return 5; }),
@@ -499,3 +511,66 @@ TEST_F(MergeJoinTest, lazyVectors) {
       .assertResults(
           "SELECT c0, rc0, c1, rc1, c2, c3  FROM t, u WHERE t.c0 = u.rc0 and c1 + rc1 < 30");
 }
+
+TEST_F(MergeJoinTest, dictionaryOutput) {
+  // Runs of 10 equal keys spread over two batches on the left and runs of 3
+  // keys for the even keys below 60 on the right.
+  std::vector<RowVectorPtr> left;
+  for (auto i = 0; i < 2; ++i) {
+    left.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            500, [i](auto row) { return (i * 500 + row) / 10; }),
+        makeFlatVector<int32_t>(500, [i](auto row) { return i * 500 + row; }),
+    }));
+  }
+  auto right = makeRowVector(
+      {"u_c0", "u_c1"},
+      {
+          makeFlatVector<int64_t>(90, [](auto row) { return row / 3 * 2; }),
+          makeFlatVector<int32_t>(90, [](auto row) { return row; }),
+      });
+  createDuckDbTable("t", left);
+  createDuckDbTable("u", {right});
+
+  for (auto joinType : {core::JoinType::kInner, core::JoinType::kLeft}) {
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    auto plan =
+        PlanBuilder(planNodeIdGenerator)
+            .values(left)
+            .mergeJoin(
+                {"c0"},
+                {"u_c0"},
+                PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                "",
+                {"c0", "c1", "u_c0", "u_c1"},
+                joinType)
+            .planNode();
+
+    auto [cursor, results] =
+        readCursor(makeCursorParameters(plan, 64), [](auto /*task*/) {});
+    for (const auto& result : results) {
+      ASSERT_LE(result->size(), 64);
+      // The output refers to the input instead of copying it. Right-side
+      // columns of left-side rows past the end of the right side are null
+      // constants.
+      for (auto i = 0; i < 2; ++i) {
+        ASSERT_EQ(
+            VectorEncoding::Simple::DICTIONARY,
+            result->childAt(i)->encoding());
+      }
+      for (auto i = 2; i < 4; ++i) {
+        ASSERT_TRUE(
+            result->childAt(i)->encoding() ==
+                VectorEncoding::Simple::DICTIONARY ||
+            result->childAt(i)->isConstantEncoding());
+      }
+    }
+    assertResults(
+        results,
+        asRowType(plan->outputType()),
+        joinType == core::JoinType::kInner
+            ? "SELECT * FROM t, u WHERE t.c0 = u.u_c0"
+            : "SELECT * FROM t LEFT JOIN u ON t.c0 = u.u_c0",
+        duckDbQueryRunner_);
+  }
+}
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/RowContainer.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -180,3 +181,93 @@ TEST_F(MergeTest, offByOne) {
       {{core::QueryConfig::kPreferredOutputBatchSize, "6"}});
   assertQueryOrdered(params, "VALUES (0), (1), (2), (3), (4), (5), (10)", {0});
 }
+
+TEST_F(MergeTest, rangeMerge) {
+  vector_size_t batchSize = 1000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    auto c0 = makeFlatVector<int64_t>(
+        batchSize,
+        [&](auto row) { return (row * 7919 + i) % 300; },
+        nullEvery(7));
+    auto c1 = makeFlatVector<StringView>(batchSize, [&](auto row) {
+      return StringView(std::to_string(batchSize * i + row));
+    });
+    vectors.push_back(makeRowVector({c0, c1}));
+  }
+  createDuckDbTable(vectors);
+
+  // The OrderBy runs on 4 Drivers and each one merges a range of the sorted
+  // rows of all Drivers. LocalMerge concatenates the ranges.
+  for (const auto& keys : std::vector<std::vector<std::string>>{
+           {"c0 NULLS LAST"},
+           {"c0 DESC NULLS FIRST"},
+           {"c0 NULLS FIRST", "c1 DESC NULLS LAST"},
+           {"c1 NULLS LAST"}}) {
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .localMerge(
+                        keys,
+                        {PlanBuilder(planNodeIdGenerator)
+                             .values(vectors, true)
+                             .orderBy(keys, true)
+                             .planNode()})
+                    .planNode();
+
+    CursorParameters params;
+    params.planNode = plan;
+    params.maxDrivers = 4;
+    params.queryCtx = core::QueryCtx::createForTest();
+    params.queryCtx->setConfigOverridesUnsafe(
+        {{core::QueryConfig::kOrderByRangeMerge, "true"}});
+    std::vector<uint32_t> keyIndices;
+    std::string orderBySql;
+    for (const auto& key : keys) {
+      keyIndices.push_back(key.substr(0, 2) == "c0" ? 0 : 1);
+      orderBySql += (orderBySql.empty() ? "" : ", ") + key;
+    }
+    assertQueryOrdered(
+        params,
+        fmt::format(
+            "SELECT * FROM (SELECT * FROM tmp UNION ALL SELECT * FROM tmp "
+            "UNION ALL SELECT * FROM tmp UNION ALL SELECT * FROM tmp) "
+            "ORDER BY {}",
+            orderBySql),
+        keyIndices);
+  }
+}
+
+TEST_F(MergeTest, rangeMergeOfFullBatches) {
+  // OrderBy returns batches of 2MB of rows.
+  exec::RowContainer data(
+      {BIGINT()}, std::vector<TypePtr>{}, memory::MappedMemory::getInstance());
+  const auto batchSize = data.estimatedNumRowsPerBatch(2 * 1024 * 1024);
+
+  // All keys are equal, so all rows go to the range of the last Driver and
+  // it holds 4 full batches.
+  std::vector<RowVectorPtr> vectors = {makeRowVector(
+      {makeFlatVector<int64_t>(batchSize, [](auto /*row*/) { return 1; })})};
+  createDuckDbTable(vectors);
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localMerge(
+                      {"c0"},
+                      {PlanBuilder(planNodeIdGenerator)
+                           .values(vectors, true)
+                           .orderBy({"c0"}, true)
+                           .planNode()})
+                  .planNode();
+
+  CursorParameters params;
+  params.planNode = plan;
+  params.maxDrivers = 4;
+  params.queryCtx = core::QueryCtx::createForTest();
+  params.queryCtx->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kOrderByRangeMerge, "true"}});
+  assertQueryOrdered(
+      params,
+      "SELECT * FROM tmp UNION ALL SELECT * FROM tmp "
+      "UNION ALL SELECT * FROM tmp UNION ALL SELECT * FROM tmp",
+      {0});
+}
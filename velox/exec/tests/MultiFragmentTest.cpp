@@ -13,11 +13,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/dwio/common/DataSink.h"
 #include "velox/dwio/dwrf/test/utils/BatchMaker.h"
 #include "velox/exec/Exchange.h"
+#include "velox/exec/PartitionedOutput.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -204,6 +206,43 @@ TEST_F(MultiFragmentTest, aggregationMultiKey) {
       "SELECT c0 % 10, c1 % 2, sum(c2) FROM tmp GROUP BY 1, 2");
 }
 
+TEST_F(MultiFragmentTest, localExchangeVectors) {
+  setupSources(10, 1000);
+  configSettings_[core::QueryConfig::kLocalExchangeVectors] = "true";
+  std::vector<std::shared_ptr<Task>> tasks;
+  auto leafTaskId = makeTaskId("leaf", 0);
+  auto leafPlan = PlanBuilder()
+                      .tableScan(rowType_)
+                      .project({"c0 % 10 AS c0", "c1", "c5"})
+                      .partitionedOutput({"c0"}, 3)
+                      .planNode();
+  auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+  tasks.push_back(leafTask);
+  Task::start(leafTask, 4);
+  addHiveSplits(leafTask, filePaths_);
+
+  // The leaf task slices its input by partition and the intermediate tasks
+  // pass their whole input to a single destination.
+  core::PlanNodePtr middlePlan;
+  std::vector<std::string> middleTaskIds;
+  for (int i = 0; i < 3; i++) {
+    middlePlan = PlanBuilder()
+                     .exchange(leafPlan->outputType())
+                     .partitionedOutput({}, 1)
+                     .planNode();
+
+    middleTaskIds.push_back(makeTaskId("middle", i));
+    auto task = makeTask(middleTaskIds.back(), middlePlan, i);
+    tasks.push_back(task);
+    Task::start(task, 1);
+    addRemoteSplits(task, {leafTaskId});
+  }
+  configSettings_.clear();
+
+  auto op = PlanBuilder().exchange(middlePlan->outputType()).planNode();
+  assertQuery(op, middleTaskIds, "SELECT c0 % 10, c1, c5 FROM tmp");
+}
+
 TEST_F(MultiFragmentTest, distributedTableScan) {
   setupSources(10, 1000);
   // Run the table scan several times to test the caching.
@@ -398,6 +437,16 @@ TEST_F(MultiFragmentTest, broadcast) {
   auto op = PlanBuilder().exchange(finalAggPlan->outputType()).planNode();
 
   assertQuery(op, finalAggTaskIds, "SELECT UNNEST(array[1000, 1000, 1000])");
+
+  // The Exchange of each consumer reports its flow control.
+  for (int i = 1; i < tasks.size(); ++i) {
+    ASSERT_TRUE(waitForTaskCompletion(tasks[i].get()));
+    auto exchangeStats =
+        tasks[i]->taskStats().pipelineStats[0].operatorStats.front();
+    auto& runtimeStats = exchangeStats.runtimeStats;
+    EXPECT_LE(1, runtimeStats["exchangeRequests"].sum);
+    EXPECT_LE(1, runtimeStats["exchangeRequestedBytes"].sum);
+  }
 }
 
 TEST_F(MultiFragmentTest, replicateNullsAndAny) {
@@ -454,7 +503,137 @@ TEST_F(MultiFragmentTest, replicateNullsAndAny) {
       "SELECT 3 * ceil(1000.0 / 7) /* number of null rows */, 1000 + 2 * ceil(1000.0 / 7) /* total number of rows */");
 }
 
+TEST_F(MultiFragmentTest, skewedJoin) {
+  // Over half of the probe rows have key 7.
+  auto probe = makeRowVector({
+      makeFlatVector<int64_t>(
+          10'000, [](auto row) { return row % 2 == 0 ? 7 : row % 100; }),
+      makeFlatVector<int32_t>(10'000, [](auto row) { return row; }),
+  });
+  auto build = makeRowVector(
+      {"u0", "u1"},
+      {
+          makeFlatVector<int64_t>(300, [](auto row) { return row % 100; }),
+          makeFlatVector<int32_t>(300, [](auto row) { return row; }),
+      });
+  createDuckDbTable("t", {probe});
+  createDuckDbTable("u", {build});
+
+  constexpr int32_t kFanout = 3;
+  auto hotKeyHashes = PartitionedOutput::hashKeys(
+      *makeRowVector({makeFlatVector<int64_t>(std::vector<int64_t>{7})}), {0});
+
+  // The probe side finds key 7 to be hot.
+  configSettings_[core::QueryConfig::kPartitionedOutputHotKeyFraction] = "0.2";
+  std::vector<std::shared_ptr<Task>> leafTasks;
+  auto probeTaskId = makeTaskId("probe", 0);
+  auto probePlan = PlanBuilder()
+                       .values({probe})
+                       .partitionedOutput(
+                           {"c0"},
+                           kFanout,
+                           core::PartitionedOutputNode::SkewMode::kSplit,
+                           hotKeyHashes)
+                       .planNode();
+  leafTasks.push_back(makeTask(probeTaskId, probePlan, 0));
+  Task::start(leafTasks.back(), 1);
+
+  auto buildTaskId = makeTaskId("build", 0);
+  auto buildPlan = PlanBuilder()
+                       .values({build})
+                       .partitionedOutput(
+                           {"u0"},
+                           kFanout,
+                           core::PartitionedOutputNode::SkewMode::kReplicate,
+                           hotKeyHashes)
+                       .planNode();
+  leafTasks.push_back(makeTask(buildTaskId, buildPlan, 0));
+  Task::start(leafTasks.back(), 1);
+  configSettings_.clear();
+
+  // Each join task gets a third of the hot probe rows and all the build rows
+  // with the hot key.
+  std::vector<std::string> joinTaskIds;
+  core::PlanNodePtr joinPlan;
+  for (auto i = 0; i < kFanout; ++i) {
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    core::PlanNodeId probeExchangeId;
+    core::PlanNodeId buildExchangeId;
+    joinPlan = PlanBuilder(planNodeIdGenerator)
+                   .exchange(probePlan->outputType())
+                   .capturePlanNodeId(probeExchangeId)
+                   .hashJoin(
+                       {"c0"},
+                       {"u0"},
+                       PlanBuilder(planNodeIdGenerator)
+                           .exchange(buildPlan->outputType())
+                           .capturePlanNodeId(buildExchangeId)
+                           .planNode(),
+                       "",
+                       {"c0", "c1", "u1"})
+                   .partitionedOutput({}, 1)
+                   .planNode();
+    joinTaskIds.push_back(makeTaskId("join", i));
+    auto task = makeTask(joinTaskIds.back(), joinPlan, i);
+    Task::start(task, 1);
+    task->addSplit(
+        probeExchangeId,
+        exec::Split(std::make_shared<RemoteConnectorSplit>(probeTaskId)));
+    task->noMoreSplits(probeExchangeId);
+    task->addSplit(
+        buildExchangeId,
+        exec::Split(std::make_shared<RemoteConnectorSplit>(buildTaskId)));
+    task->noMoreSplits(buildExchangeId);
+  }
+
+  auto op = PlanBuilder().exchange(joinPlan->outputType()).planNode();
+  assertQuery(op, joinTaskIds, "SELECT c0, c1, u1 FROM t, u WHERE c0 = u0");
+
+  for (const auto& task : leafTasks) {
+    ASSERT_TRUE(waitForTaskCompletion(task.get()));
+  }
+  auto probeStats =
+      leafTasks[0]->taskStats().pipelineStats[0].operatorStats.back();
+  EXPECT_EQ(1, probeStats.runtimeStats["numHotKeys"].sum);
+  EXPECT_EQ(5'100, probeStats.runtimeStats["numHotKeyRows"].sum);
+  auto buildStats =
+      leafTasks[1]->taskStats().pipelineStats[0].operatorStats.back();
+  EXPECT_EQ(3, buildStats.runtimeStats["numHotKeyRows"].sum);
+}
+
 // Test query finishing before all splits have been scheduled.
+
+TEST_F(MultiFragmentTest, skewedOuterJoinBuildSide) {
+  // Replicating build rows to all destinations of a right, full or anti
+  // join would produce the unmatched build rows more than once.
+  auto build = makeRowVector({makeFlatVector<int64_t>({1, 2, 3})});
+  std::vector<uint64_t> hotKeyHashes = {123};
+  for (auto joinType :
+       {core::JoinType::kRight, core::JoinType::kFull, core::JoinType::kAnti}) {
+    VELOX_ASSERT_THROW(
+        PlanBuilder().values({build}).partitionedOutput(
+            {"c0"},
+            3,
+            core::PartitionedOutputNode::SkewMode::kReplicate,
+            hotKeyHashes,
+            joinType),
+        "Hot key replication is not supported for the build side of");
+  }
+
+  // The probe side of these joins can be split.
+  PlanBuilder().values({build}).partitionedOutput(
+      {"c0"},
+      3,
+      core::PartitionedOutputNode::SkewMode::kSplit,
+      hotKeyHashes,
+      core::JoinType::kFull);
+  PlanBuilder().values({build}).partitionedOutput(
+      {"c0"},
+      3,
+      core::PartitionedOutputNode::SkewMode::kReplicate,
+      hotKeyHashes,
+      core::JoinType::kLeft);
+}
 TEST_F(MultiFragmentTest, limit) {
   auto data = makeRowVector({makeFlatVector<int32_t>(
       1'000, [](auto row) { return row; }, nullEvery(7))});
@@ -13,8 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/file/FileSystems.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/vector/tests/VectorMaker.h"
 
 using namespace facebook::velox;
@@ -22,6 +25,11 @@ using namespace facebook::velox::exec::test;
 
 class OrderByTest : public OperatorTestBase {
  protected:
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    filesystems::registerLocalFileSystem();
+  }
+
   void testSingleKey(
       const std::vector<RowVectorPtr>& input,
       const std::string& key) {
@@ -264,3 +272,49 @@ TEST_F(OrderByTest, unknown) {
   assertQueryOrdered(
       plan, "SELECT *, null FROM tmp ORDER BY c0 DESC NULLS LAST", {0});
 }
+
+TEST_F(OrderByTest, spill) {
+  using core::QueryConfig;
+  constexpr int64_t kMaxBytes = 8LL << 20; // 8 MB
+  vector_size_t batchSize = 10'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 20; ++i) {
+    auto c0 = makeFlatVector<int64_t>(
+        batchSize,
+        [&](vector_size_t row) { return (row * 7919 + i * 31) % 1'000; },
+        nullEvery(13));
+    auto c1 = makeFlatVector<StringView>(
+        batchSize,
+        [&](vector_size_t row) {
+          return StringView(fmt::format(
+              "{}-{}-abcdefghijklmnopqrstuvwxyz", row % 97, batchSize * i));
+        },
+        nullEvery(17));
+    auto c2 = makeFlatVector<double>(
+        batchSize, [](vector_size_t row) { return row * 0.1; });
+    vectors.push_back(makeRowVector({c0, c1, c2}));
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .orderBy({"c0 ASC NULLS LAST", "c1 DESC NULLS FIRST"}, false)
+                  .planNode();
+
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto queryCtx = core::QueryCtx::createForTest();
+  queryCtx->pool()->setMemoryUsageTracker(
+      velox::memory::MemoryUsageTracker::create(kMaxBytes, 0, kMaxBytes));
+
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .queryCtx(queryCtx)
+          .config(QueryConfig::kSpillPath, tempDirectory->path)
+          .assertResults(
+              "SELECT * FROM tmp ORDER BY c0 NULLS LAST, c1 DESC NULLS FIRST",
+              {{0, 1}});
+
+  auto stats = task->taskStats().pipelineStats;
+  EXPECT_LT(0, stats[0].operatorStats[1].spilledBytes);
+  EXPECT_LT(0, stats[0].operatorStats[1].spilledRows);
+}
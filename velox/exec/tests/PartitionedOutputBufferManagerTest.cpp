@@ -45,7 +45,9 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
       const std::string& taskId,
       const RowTypePtr& rowType,
       int numDestinations,
-      int numDrivers) {
+      int numDrivers,
+      bool broadcast = false,
+      std::unordered_map<std::string, std::string> config = {}) {
     bufferManager_->removeTask(taskId);
 
     auto planFragment = exec::test::PlanBuilder()
@@ -53,9 +55,14 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
                                 BatchMaker::createBatch(rowType, 100, *pool_))})
                             .planFragment();
     auto task = std::make_shared<Task>(
-        taskId, std::move(planFragment), 0, core::QueryCtx::createForTest());
+        taskId,
+        std::move(planFragment),
+        0,
+        core::QueryCtx::createForTest(
+            std::make_shared<core::MemConfig>(std::move(config))));
 
-    bufferManager_->initializeTask(task, false, numDestinations, numDrivers);
+    bufferManager_->initializeTask(
+        task, broadcast, numDestinations, numDrivers);
     return task;
   }
 
@@ -358,6 +365,81 @@ TEST_F(PartitionedOutputBufferManagerTest, outOfOrderAcks) {
   bufferManager_->removeTask(taskId);
 }
 
+TEST_F(PartitionedOutputBufferManagerTest, destinationBytesAndHotKeys) {
+  std::vector<std::string> names = {"c0", "c1"};
+  std::vector<TypePtr> types = {BIGINT(), VARCHAR()};
+  auto rowType = ROW(std::move(names), std::move(types));
+
+  std::string taskId = "t0";
+  auto task = initializeTask(taskId, rowType, 3, 1);
+
+  for (int i = 0; i < 4; i++) {
+    enqueue(taskId, 1, rowType, 100);
+  }
+  enqueue(taskId, 2, rowType, 100);
+
+  auto bytes = bufferManager_->destinationBytes(taskId);
+  ASSERT_EQ(3, bytes.size());
+  EXPECT_EQ(0, bytes[0]);
+  EXPECT_GT(bytes[2], 0);
+  EXPECT_EQ(4 * bytes[2], bytes[1]);
+
+  // Acknowledged data still counts.
+  fetchOneAndAck(taskId, 1, 0);
+  EXPECT_EQ(bytes, bufferManager_->destinationBytes(taskId));
+
+  EXPECT_TRUE(bufferManager_->hotKeys(taskId).empty());
+  bufferManager_->addHotKeys(taskId, {30, 10});
+  bufferManager_->addHotKeys(taskId, {20, 10});
+  EXPECT_EQ(
+      std::vector<uint64_t>({10, 20, 30}), bufferManager_->hotKeys(taskId));
+
+  task->requestCancel();
+  bufferManager_->removeTask(taskId);
+}
+
+TEST_F(PartitionedOutputBufferManagerTest, broadcast) {
+  std::vector<std::string> names = {"c0", "c1"};
+  std::vector<TypePtr> types = {BIGINT(), VARCHAR()};
+  auto rowType = ROW(std::move(names), std::move(types));
+
+  // Every enqueue blocks until the page is acknowledged.
+  std::string taskId = "t0";
+  auto task = initializeTask(
+      taskId,
+      rowType,
+      1,
+      1,
+      true,
+      {{core::QueryConfig::kMaxPartitionedOutputBufferSize, "1"}});
+
+  ContinueFuture future;
+  EXPECT_EQ(
+      BlockingReason::kWaitForConsumer,
+      bufferManager_->enqueue(
+          taskId, 0, makeSerializedPage(rowType, 100), &future));
+  bufferManager_->updateBroadcastOutputBuffers(taskId, 3, true);
+
+  // The page is shared by the destinations and counted once.
+  auto bytes = bufferManager_->destinationBytes(taskId);
+  ASSERT_EQ(3, bytes.size());
+  EXPECT_EQ(bytes[0], bytes[1]);
+  EXPECT_EQ(bytes[0], bytes[2]);
+
+  // The producer continues when the last destination acknowledges.
+  fetchOneAndAck(taskId, 1, 0);
+  fetchOneAndAck(taskId, 0, 0);
+  EXPECT_FALSE(future.isReady());
+  fetchOneAndAck(taskId, 2, 0);
+  EXPECT_TRUE(future.isReady());
+
+  noMoreData(taskId);
+  for (int destination = 0; destination < 3; destination++) {
+    fetchEndMarker(taskId, destination, 1);
+  }
+  EXPECT_TRUE(task->isFinished());
+}
+
 TEST_F(PartitionedOutputBufferManagerTest, errorInQueue) {
   auto queue = std::make_shared<ExchangeQueue>(1 << 20);
   auto page = std::make_unique<SerializedPage>(folly::IOBuf::copyBuffer("", 0));
@@ -288,6 +288,22 @@ TEST_F(PlanNodeToStringTest, crossJoin) {
   ASSERT_EQ(
       "-- CrossJoin[] -> t_c0:SMALLINT, t_c1:INTEGER, u_c1:INTEGER\n",
       plan->toString(true, false));
+
+  plan = PlanBuilder()
+             .values({data_})
+             .project({"c0 as t_c0", "c1 as t_c1"})
+             .crossJoin(
+                 PlanBuilder()
+                     .values({data_})
+                     .project({"c0 as u_c0", "c1 as u_c1"})
+                     .planNode(),
+                 {"t_c0", "t_c1", "u_c1"},
+                 "t_c1 > u_c1")
+             .planNode();
+
+  ASSERT_EQ(
+      "-- CrossJoin[filter: gt(ROW[\"t_c1\"],ROW[\"u_c1\"])] -> t_c0:SMALLINT, t_c1:INTEGER, u_c1:INTEGER\n",
+      plan->toString(true, false));
 }
 
 TEST_F(PlanNodeToStringTest, orderBy) {
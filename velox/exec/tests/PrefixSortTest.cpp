@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+#include <gtest/gtest.h>
+#include "velox/vector/tests/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+class PrefixSortTest : public testing::Test,
+                       public velox::test::VectorTestBase {
+ protected:
+  // Stores 'data' in a RowContainer with all columns as keys, sorts the rows
+  // with PrefixSort on 'keys' and checks the order with
+  // RowContainer::compare(). Checks all combinations of ascending and nulls
+  // first for the first key.
+  void testSort(
+      const RowVectorPtr& data,
+      std::vector<PrefixSort::SortKey> keys) {
+    auto container = std::make_unique<RowContainer>(
+        data->type()->as<TypeKind::ROW>().children(),
+        memory::MappedMemory::getInstance());
+    std::vector<char*> rows(data->size());
+    SelectivityVector allRows(data->size());
+    for (auto i = 0; i < data->size(); ++i) {
+      rows[i] = container->newRow();
+    }
+    for (auto column = 0; column < data->childrenSize(); ++column) {
+      DecodedVector decoded(*data->childAt(column), allRows);
+      for (auto i = 0; i < data->size(); ++i) {
+        container->store(decoded, i, rows[i], column);
+      }
+    }
+
+    for (auto ascending : {true, false}) {
+      for (auto nullsFirst : {true, false}) {
+        keys[0].second.ascending = ascending;
+        keys[0].second.nullsFirst = nullsFirst;
+        auto sorted = rows;
+        PrefixSort::sort(
+            *container,
+            keys,
+            folly::Range<char**>(sorted.data(), sorted.size()));
+
+        auto expected = rows;
+        std::sort(expected.begin(), expected.end());
+        auto actual = sorted;
+        std::sort(actual.begin(), actual.end());
+        ASSERT_EQ(expected, actual);
+
+        for (auto i = 1; i < sorted.size(); ++i) {
+          ASSERT_LE(compare(*container, keys, sorted[i - 1], sorted[i]), 0)
+              << "at " << i << ", ascending " << ascending << ", nullsFirst "
+              << nullsFirst;
+        }
+      }
+    }
+  }
+
+  static int32_t compare(
+      RowContainer& container,
+      const std::vector<PrefixSort::SortKey>& keys,
+      const char* left,
+      const char* right) {
+    for (const auto& key : keys) {
+      if (auto result = container.compare(left, right, key.first, key.second)) {
+        return result;
+      }
+    }
+    return 0;
+  }
+};
+
+TEST_F(PrefixSortTest, integers) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(
+          1'000,
+          [](auto row) { return (row % 2 ? -1 : 1) * (row * 7919 % 101); },
+          nullEvery(11)),
+      makeFlatVector<int32_t>(
+          1'000, [](auto row) { return row % 13 - 6; }, nullEvery(17)),
+      makeFlatVector<int16_t>(1'000, [](auto row) { return row % 5 - 2; }),
+      makeFlatVector<int8_t>(1'000, [](auto row) { return row % 3 - 1; }),
+      makeFlatVector<bool>(1'000, [](auto row) { return row % 4 == 0; }),
+  });
+  testSort(data, PrefixSort::leadingColumns(5));
+  testSort(data, {{3, {}}, {4, {}}, {1, {}}, {0, {}}});
+  testSort(data, {{1, {}}, {2, {true, false, false}}});
+}
+
+TEST_F(PrefixSortTest, floats) {
+  auto doubles = std::vector<double>{
+      0.0,
+      -0.0,
+      1.5,
+      -1.5,
+      std::numeric_limits<double>::infinity(),
+      -std::numeric_limits<double>::infinity(),
+      std::numeric_limits<double>::quiet_NaN(),
+      -std::numeric_limits<double>::quiet_NaN(),
+      std::numeric_limits<double>::max(),
+      std::numeric_limits<double>::lowest(),
+      std::numeric_limits<double>::min(),
+  };
+  auto data = makeRowVector({
+      makeFlatVector<double>(
+          1'000,
+          [&](auto row) { return doubles[row % doubles.size()]; },
+          nullEvery(13)),
+      makeFlatVector<float>(
+          1'000, [&](auto row) { return doubles[row % 7] * (row % 3); }),
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row % 19; }),
+  });
+  testSort(data, PrefixSort::leadingColumns(3));
+  testSort(data, {{1, {}}, {2, {}}});
+}
+
+TEST_F(PrefixSortTest, signedZeros) {
+  // -0.0 and 0.0 are equal, so the second key breaks the tie. The second key
+  // is larger for -0.0 than for 0.0.
+  auto data = makeRowVector({
+      makeFlatVector<double>(
+          100, [](auto row) { return row % 2 ? -0.0 : 0.0; }),
+      makeFlatVector<float>(
+          100, [](auto row) { return row % 2 ? -0.0f : 0.0f; }),
+      makeFlatVector<int64_t>(
+          100, [](auto row) { return (row % 2) * 100 + row; }),
+  });
+  testSort(data, {{0, {}}, {2, {}}});
+  testSort(data, {{1, {}}, {2, {}}});
+}
+
+TEST_F(PrefixSortTest, strings) {
+  // Short inline strings, long strings sharing a prefix longer than the
+  // prefix and strings of zero bytes.
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 1'000; ++i) {
+    switch (i % 4) {
+      case 0:
+        strings.push_back(std::to_string(i % 37));
+        break;
+      case 1:
+        strings.push_back(std::string(40, 'x') + std::to_string(i % 23));
+        break;
+      case 2:
+        strings.push_back(std::string(i % 5, '\0'));
+        break;
+      default:
+        strings.push_back("");
+    }
+  }
+  auto data = makeRowVector({
+      makeFlatVector<StringView>(
+          strings.size(),
+          [&](auto row) { return StringView(strings[row]); },
+          nullEvery(7)),
+      makeFlatVector<int64_t>(
+          strings.size(), [](auto row) { return row % 11; }),
+  });
+  testSort(data, PrefixSort::leadingColumns(2));
+  testSort(data, {{1, {}}, {0, {}}});
+}
+
+TEST_F(PrefixSortTest, manyKeys) {
+  // The prefix ends before the fourth key.
+  std::vector<VectorPtr> children;
+  for (auto i = 0; i < 5; ++i) {
+    children.push_back(makeFlatVector<int64_t>(
+        1'000, [i](auto row) { return row % (i + 2); }, nullEvery(i + 3)));
+  }
+  auto data = makeRowVector(children);
+  testSort(data, PrefixSort::leadingColumns(5));
+}
+
+TEST_F(PrefixSortTest, unsupportedKeys) {
+  // Rows are sorted with RowContainer::compare() if the first key cannot be
+  // encoded.
+  auto data = makeRowVector({
+      makeFlatVector<Timestamp>(
+          1'000,
+          [](auto row) { return Timestamp(row % 17, row % 3); },
+          nullEvery(5)),
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 7; }),
+  });
+  testSort(data, PrefixSort::leadingColumns(2));
+  testSort(data, {{1, {}}, {0, {}}});
+}
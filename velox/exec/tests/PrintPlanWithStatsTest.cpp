@@ -146,6 +146,7 @@ TEST_F(PrintPlanWithStatsTest, innerJoinWithTableScan) {
       "        queuedWallNanos           sum: .+, count: 1, min: .+, max: .+\n"
       "    -- TableScan\\[table: hive_table\\] -> c0:INTEGER, c1:BIGINT\n"
       "       Input: 2000 rows \\(.+\\), Raw Input: 20480 rows \\(.+\\), Output: 2000 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 1\\.00MB, Memory allocations: .+, Threads: 1, Splits: 20\n"
+      "          coalescedGapBytes         sum: .+, count: 1, min: .+, max: .+\n"
       "          dataSourceWallNanos       sum: .+, count: 40, min: .+, max: .+\n"
       "          dynamicFiltersAccepted    sum: 1, count: 1, min: 1, max: 1\n"
       "          localReadBytes            sum: 0B, count: 1, min: 0B, max: 0B\n"
@@ -154,10 +155,12 @@ TEST_F(PrintPlanWithStatsTest, innerJoinWithTableScan) {
       "          numRamRead                sum: 0, count: 1, min: 0, max: 0\n"
       "          numStorageRead            sum: .+, count: 1, min: .+, max: .+\n"
       "          prefetchBytes             sum: .+, count: 1, min: .+, max: .+\n"
+      "          prunedSplits              sum: 0, count: 1, min: 0, max: 0\n"
       "          ramReadBytes              sum: 0B, count: 1, min: 0B, max: 0B\n"
       "          skippedSplitBytes         sum: 0B, count: 1, min: 0B, max: 0B\n"
       "          skippedSplits             sum: 0, count: 1, min: 0, max: 0\n"
       "          skippedStrides            sum: 0, count: 1, min: 0, max: 0\n"
+      "          splitLoadWallNanos        sum: .+, count: 20, min: .+, max: .+\n"
       "          storageReadBytes          sum: .+, count: 1, min: .+, max: .+\n"
       "    -- Project\\[expressions: \\(u_c0:INTEGER, ROW\\[\"c0\"\\]\\), \\(u_c1:BIGINT, ROW\\[\"c1\"\\]\\)\\] -> u_c0:INTEGER, u_c1:BIGINT\n"
       "       Output: 100 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 0B, Memory allocations: .+, Threads: 1\n"
@@ -202,6 +205,7 @@ TEST_F(PrintPlanWithStatsTest, partialAggregateWithTableScan) {
       "   Output: .+, Cpu time: .+, Blocked wall time: .+, Peak memory: 1\\.00MB, Memory allocations: .+, Threads: 1\n"
       "  -- TableScan\\[table: hive_table\\] -> c0:BIGINT, c1:INTEGER, c2:SMALLINT, c3:REAL, c4:DOUBLE, c5:VARCHAR\n"
       "     Input: 10000 rows \\(.+\\), Output: 10000 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 1\\.00MB, Memory allocations: .+, Threads: 1, Splits: 1\n"
+      "        coalescedGapBytes          sum: .+, count: 1, min: .+, max: .+\n"
       "        dataSourceLazyWallNanos    sum: .+, count: 7, min: .+, max: .+\n"
       "        dataSourceWallNanos        sum: .+, count: 2, min: .+, max: .+\n"
       "        loadedToValueHook          sum: 50000, count: 5, min: 10000, max: 10000\n"
@@ -211,9 +215,27 @@ TEST_F(PrintPlanWithStatsTest, partialAggregateWithTableScan) {
       "        numRamRead                 sum: 0, count: 1, min: 0, max: 0\n"
       "        numStorageRead             sum: .+, count: 1, min: .+, max: .+\n"
       "        prefetchBytes              sum: .+, count: 1, min: .+, max: .+\n"
+      "        prunedSplits               sum: 0, count: 1, min: 0, max: 0\n"
       "        ramReadBytes               sum: 0B, count: 1, min: 0B, max: 0B\n"
       "        skippedSplitBytes          sum: 0B, count: 1, min: 0B, max: 0B\n"
       "        skippedSplits              sum: 0, count: 1, min: 0, max: 0\n"
       "        skippedStrides             sum: 0, count: 1, min: 0, max: 0\n"
+      "        splitLoadWallNanos         sum: .+, count: 1, min: .+, max: .+\n"
       "        storageReadBytes           sum: .+, count: 1, min: .+, max: .+\n");
 }
+
+TEST_F(PrintPlanWithStatsTest, perfEventCounts) {
+  exec::OperatorStats stats(0, 0, "0", "FilterProject");
+  exec::PlanNodeStats nodeStats;
+  nodeStats.add(stats);
+  EXPECT_EQ(std::string::npos, nodeStats.toString().find("Cycles"));
+
+  stats.perfEventCounts = {1'000, 2'500, 10, 20, 30};
+  nodeStats.add(stats);
+  nodeStats.add(stats);
+  EXPECT_THAT(
+      nodeStats.toString(),
+      ::testing::EndsWith(
+          ", Cycles: 2000, Instructions: 5000 (IPC 2.50), LLC misses: 20, "
+          "Branch misses: 40, dTLB misses: 60"));
+}
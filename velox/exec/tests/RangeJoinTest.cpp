@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class RangeJoinTest : public OperatorTestBase {
+ protected:
+  // Returns 'numBatches' batches of probe keys in column 'c0' with a null
+  // every 11 rows and a payload in column 'c1'.
+  std::vector<RowVectorPtr> makeProbe(int32_t numBatches, int32_t batchSize) {
+    std::vector<RowVectorPtr> batches;
+    for (auto i = 0; i < numBatches; ++i) {
+      batches.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              batchSize,
+              [&](auto row) { return (i * batchSize + row) * 7 % 1'000; },
+              nullEvery(11)),
+          makeFlatVector<int32_t>(
+              batchSize, [&](auto row) { return i * batchSize + row; }),
+      }));
+    }
+    return batches;
+  }
+
+  // Returns ranges of different widths in 'lo' and 'hi'. Some ranges have
+  // null bounds or are empty.
+  std::vector<RowVectorPtr> makeRanges(int32_t numBatches, int32_t batchSize) {
+    std::vector<RowVectorPtr> batches;
+    for (auto i = 0; i < numBatches; ++i) {
+      auto lo = makeFlatVector<int64_t>(
+          batchSize,
+          [&](auto row) { return (i * batchSize + row) * 13 % 1'000; },
+          nullEvery(17));
+      batches.push_back(makeRowVector(
+          {"lo", "hi", "id"},
+          {
+              lo,
+              makeFlatVector<int64_t>(
+                  batchSize,
+                  [&](auto row) {
+                    return lo->valueAt(row) + (row % 7) * (row % 5) - 3;
+                  },
+                  nullEvery(19)),
+              makeFlatVector<int32_t>(
+                  batchSize, [&](auto row) { return i * batchSize + row; }),
+          }));
+    }
+    return batches;
+  }
+
+  core::PlanNodePtr makePlan(
+      const std::vector<RowVectorPtr>& probe,
+      const std::vector<RowVectorPtr>& build,
+      const std::string& filter,
+      bool parallel = false) {
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    return PlanBuilder(planNodeIdGenerator)
+        .values(probe, parallel)
+        .rangeJoin(
+            "c0",
+            "lo",
+            "hi",
+            PlanBuilder(planNodeIdGenerator).values(build, parallel).planNode(),
+            filter,
+            {"c0", "c1", "lo", "hi", "id"})
+        .planNode();
+  }
+};
+
+TEST_F(RangeJoinTest, basic) {
+  auto probe = makeProbe(5, 1'000);
+  auto build = makeRanges(3, 500);
+  createDuckDbTable("t", probe);
+  createDuckDbTable("u", build);
+
+  assertQuery(
+      makePlan(probe, build, ""),
+      "SELECT c0, c1, lo, hi, id FROM t, u WHERE c0 BETWEEN lo AND hi");
+
+  assertQuery(
+      makePlan(probe, build, "(c1 + id) % 3 = 0"),
+      "SELECT c0, c1, lo, hi, id FROM t, u "
+      "WHERE c0 BETWEEN lo AND hi AND (c1 + id) % 3 = 0");
+
+  CursorParameters params;
+  params.planNode = makePlan(probe, build, "", true);
+  params.maxDrivers = 4;
+  OperatorTestBase::assertQuery(
+      params,
+      "SELECT c0, c1, lo, hi, id FROM "
+      "(SELECT * FROM t UNION ALL SELECT * FROM t UNION ALL "
+      "SELECT * FROM t UNION ALL SELECT * FROM t) t, "
+      "(SELECT * FROM u UNION ALL SELECT * FROM u UNION ALL "
+      "SELECT * FROM u UNION ALL SELECT * FROM u) u "
+      "WHERE c0 BETWEEN lo AND hi");
+}
+
+TEST_F(RangeJoinTest, manyMatches) {
+  // Every probe row matches all 3'000 ranges, more than an output batch.
+  auto probe = {makeRowVector({
+      makeFlatVector<int64_t>({10, 20, 30}),
+      makeFlatVector<int32_t>({1, 2, 3}),
+  })};
+  auto build = {makeRowVector(
+      {"lo", "hi", "id"},
+      {
+          makeFlatVector<int64_t>(3'000, [](auto row) { return -row; }),
+          makeFlatVector<int64_t>(3'000, [](auto row) { return 100 + row; }),
+          makeFlatVector<int32_t>(3'000, [](auto row) { return row; }),
+      })};
+  createDuckDbTable("t", probe);
+  createDuckDbTable("u", build);
+
+  assertQuery(
+      makePlan(probe, build, ""),
+      "SELECT c0, c1, lo, hi, id FROM t, u WHERE c0 BETWEEN lo AND hi");
+}
+
+TEST_F(RangeJoinTest, emptyBuild) {
+  auto probe = makeProbe(2, 100);
+  auto build = {makeRowVector(
+      {"lo", "hi", "id"},
+      {
+          makeFlatVector<int64_t>({10, 20}),
+          makeFlatVector<int64_t>({5, 15}),
+          makeFlatVector<int32_t>({1, 2}),
+      })};
+
+  // All ranges are empty.
+  assertQueryReturnsEmptyResult(makePlan(probe, build, ""));
+}
+
+TEST_F(RangeJoinTest, varchar) {
+  auto probe = {makeRowVector({
+      makeFlatVector<StringView>({"apple", "melon", "zebra", "kiwi"}),
+      makeFlatVector<int32_t>({1, 2, 3, 4}),
+  })};
+  auto build = {makeRowVector(
+      {"lo", "hi", "id"},
+      {
+          makeFlatVector<StringView>({"a", "k", "l", "t"}),
+          makeFlatVector<StringView>({"b", "m", "n", "z"}),
+          makeFlatVector<int32_t>({1, 2, 3, 4}),
+      })};
+  createDuckDbTable("t", probe);
+  createDuckDbTable("u", build);
+
+  assertQuery(
+      makePlan(probe, build, ""),
+      "SELECT c0, c1, lo, hi, id FROM t, u WHERE c0 BETWEEN lo AND hi");
+}
+
+TEST_F(RangeJoinTest, nanBounds) {
+  // Ranges with a NaN bound and NaN probe keys match nothing.
+  constexpr double kNan = std::numeric_limits<double>::quiet_NaN();
+  auto probe = {makeRowVector({
+      makeFlatVector<double>({1.0, kNan, 5.0, 12.0, kNan}),
+      makeFlatVector<int32_t>({1, 2, 3, 4, 5}),
+  })};
+  auto build = {makeRowVector(
+      {"lo", "hi", "id"},
+      {
+          makeFlatVector<double>({kNan, 0.0, kNan, 4.0, 10.0, kNan}),
+          makeFlatVector<double>({6.0, 2.0, kNan, kNan, 20.0, 30.0}),
+          makeFlatVector<int32_t>({1, 2, 3, 4, 5, 6}),
+      })};
+
+  auto expected = makeRowVector(
+      {"c0", "c1", "lo", "hi", "id"},
+      {
+          makeFlatVector<double>({1.0, 12.0}),
+          makeFlatVector<int32_t>({1, 4}),
+          makeFlatVector<double>({0.0, 10.0}),
+          makeFlatVector<double>({2.0, 20.0}),
+          makeFlatVector<int32_t>({2, 5}),
+      });
+  AssertQueryBuilder(makePlan(probe, build, "")).assertResults(expected);
+}
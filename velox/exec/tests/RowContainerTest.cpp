@@ -221,6 +221,55 @@ TEST_F(RowContainerTest, storeExtractArrayOfVarchar) {
   roundTrip(input);
 }
 
+TEST_F(RowContainerTest, extractFixedWidth) {
+  // More than 64 rows and not a multiple of 64 so that the word at a time
+  // null handling covers a partial word.
+  constexpr int32_t kNumRows = 1'000;
+  facebook::velox::test::VectorMaker vectorMaker{pool_.get()};
+  std::vector<VectorPtr> columns{
+      vectorMaker.flatVector<int64_t>(
+          kNumRows, [](auto row) { return row * 1'000'000'000L; }),
+      vectorMaker.flatVector<int64_t>(
+          kNumRows, [](auto row) { return row; }, VectorMaker::nullEvery(7)),
+      vectorMaker.flatVector<double>(
+          kNumRows,
+          [](auto row) { return row * 0.5; },
+          VectorMaker::nullEvery(5)),
+      vectorMaker.flatVector<int32_t>(
+          kNumRows, [](auto row) { return row; }, VectorMaker::nullEvery(3)),
+      vectorMaker.flatVector<bool>(
+          kNumRows,
+          [](auto row) { return row % 3 == 0; },
+          VectorMaker::nullEvery(11))};
+  // The key is not nullable.
+  auto data = makeRowContainer(
+      {BIGINT()}, {BIGINT(), DOUBLE(), INTEGER(), BOOLEAN()});
+  SelectivityVector allRows(kNumRows);
+  std::vector<char*> rows(kNumRows);
+  for (auto i = 0; i < kNumRows; ++i) {
+    rows[i] = data->newRow();
+  }
+  for (auto column = 0; column < columns.size(); ++column) {
+    DecodedVector decoded(*columns[column], allRows);
+    for (auto i = 0; i < kNumRows; ++i) {
+      data->store(decoded, i, rows[i], column);
+    }
+  }
+  for (auto column = 0; column < columns.size(); ++column) {
+    testExtractColumnForAllRows(*data, rows, column, columns[column]);
+    testExtractColumnForOddRows(*data, rows, column, columns[column]);
+  }
+
+  // A result with nulls from a previous extract gets its nulls cleared.
+  std::vector<char*> someRows(rows);
+  someRows[70] = nullptr;
+  auto result = BaseVector::create(BIGINT(), kNumRows, pool_.get());
+  data->extractColumn(someRows.data(), kNumRows, 0, result);
+  EXPECT_TRUE(result->isNullAt(70));
+  data->extractColumn(rows.data(), kNumRows, 0, result);
+  assertEqualVectors(columns[0], result);
+}
+
 TEST_F(RowContainerTest, types) {
   constexpr int32_t kNumRows = 100;
   auto batch = makeDataset(
@@ -419,6 +468,76 @@ TEST_F(RowContainerTest, erase) {
   data->checkConsistency();
 }
 
+TEST_F(RowContainerTest, compactStringAllocator) {
+  constexpr int32_t kNumRows = 10'000;
+  auto data = makeRowContainer({BIGINT()}, {VARCHAR(), ARRAY(BIGINT())});
+  facebook::velox::test::VectorMaker vectorMaker{pool_.get()};
+  std::vector<std::string> strings(kNumRows);
+  for (auto i = 0; i < kNumRows; ++i) {
+    makeLargeString(20 + (i % 10) * 100, strings[i]);
+  }
+  auto batch = vectorMaker.rowVector({
+      vectorMaker.flatVector<int64_t>(
+          kNumRows, [](vector_size_t row) { return row; }),
+      vectorMaker.flatVector<StringView>(
+          kNumRows,
+          [&](vector_size_t row) { return StringView(strings[row]); },
+          [](vector_size_t row) { return row % 11 == 0; }),
+      vectorMaker.arrayVector<int64_t>(
+          kNumRows,
+          [](vector_size_t row) { return row % 30; },
+          [](vector_size_t index) { return index; }),
+  });
+
+  SelectivityVector allRows(kNumRows);
+  std::vector<char*> rows(kNumRows);
+  for (auto column = 0; column < batch->childrenSize(); ++column) {
+    DecodedVector decoded(*batch->childAt(column), allRows);
+    for (auto i = 0; i < kNumRows; ++i) {
+      if (column == 0) {
+        rows[i] = data->newRow();
+      }
+      data->store(decoded, i, rows[i], column);
+    }
+  }
+
+  // Erases 3 of 4 rows. The variable length data of the remaining rows is
+  // spread over the whole HashStringAllocator.
+  std::vector<char*> erased;
+  std::vector<char*> remaining;
+  std::vector<vector_size_t> remainingIndices;
+  for (auto i = 0; i < kNumRows; ++i) {
+    if (i % 4 == 0) {
+      remaining.push_back(rows[i]);
+      remainingIndices.push_back(i);
+    } else {
+      erased.push_back(rows[i]);
+    }
+  }
+  data->eraseRows(folly::Range<char**>(erased.data(), erased.size()));
+  auto allocatedBytes = data->allocatedBytes();
+
+  auto freedBytes = data->compactStringAllocator();
+  EXPECT_LT(0, freedBytes);
+  EXPECT_EQ(allocatedBytes - freedBytes, data->allocatedBytes());
+  data->stringAllocator().checkConsistency();
+  data->checkConsistency();
+
+  auto indices = allocateIndices(remaining.size(), pool_.get());
+  std::copy(
+      remainingIndices.begin(),
+      remainingIndices.end(),
+      indices->asMutable<vector_size_t>());
+  for (auto column = 0; column < batch->childrenSize(); ++column) {
+    auto expected = BaseVector::wrapInDictionary(
+        nullptr, indices, remaining.size(), batch->childAt(column));
+    auto result = BaseVector::create(
+        batch->childAt(column)->type(), remaining.size(), pool_.get());
+    data->extractColumn(remaining.data(), remaining.size(), column, result);
+    assertEqualVectors(expected, result);
+  }
+}
+
 TEST_F(RowContainerTest, initialNulls) {
   std::vector<TypePtr> keys{INTEGER()};
   std::vector<TypePtr> dependent{INTEGER()};
@@ -494,3 +613,58 @@ TEST_F(RowContainerTest, compareDouble) {
   // Verify descending order
   testCompareFloats<double>(DOUBLE(), false);
 }
+
+TEST_F(RowContainerTest, complexTypeSerdeCompare) {
+  constexpr int32_t kNumRows = 1'000;
+  auto rowType =
+      ROW({"a", "m"}, {ARRAY(INTEGER()), MAP(VARCHAR(), ARRAY(BIGINT()))});
+  auto batch = makeDataset(rowType, kNumRows, nullptr);
+  const auto& serde = ContainerRowSerde::instance();
+  HashStringAllocator allocator(mappedMemory_);
+
+  for (auto column = 0; column < rowType->size(); ++column) {
+    auto vector = batch->childAt(column);
+    std::vector<vector_size_t> nonNullRows;
+    for (auto row = 0; row < kNumRows; ++row) {
+      if (!vector->isNullAt(row)) {
+        nonNullRows.push_back(row);
+      }
+    }
+    auto numValues = nonNullRows.size();
+    std::vector<HashStringAllocator::Position> positions;
+    for (auto row : nonNullRows) {
+      ByteStream stream(&allocator, false, false);
+      positions.push_back(allocator.newWrite(stream));
+      serde.serialize(*vector, row, stream);
+      allocator.finishWrite(stream, 0);
+    }
+
+    // Each value is equal to the value it was serialized from and comparing
+    // two serialized values agrees with comparing a serialized value with the
+    // vector.
+    SelectivityVector allRows(kNumRows);
+    DecodedVector decoded(*vector, allRows);
+    CompareFlags descending{true, false};
+    auto sign = [](int32_t result) { return result < 0 ? -1 : result > 0; };
+    for (auto i = 0; i < numValues; ++i) {
+      auto row = nonNullRows[i];
+      auto next = (i + 1) % numValues;
+      ByteStream stream;
+      HashStringAllocator::prepareRead(positions[i].header, stream);
+      EXPECT_EQ(0, serde.compare(stream, decoded, row, CompareFlags()))
+          << "at " << row;
+
+      HashStringAllocator::prepareRead(positions[i].header, stream);
+      auto expected =
+          sign(serde.compare(stream, decoded, nonNullRows[next], descending));
+      ByteStream left;
+      ByteStream right;
+      HashStringAllocator::prepareRead(positions[i].header, left);
+      HashStringAllocator::prepareRead(positions[next].header, right);
+      EXPECT_EQ(
+          expected,
+          sign(serde.compare(left, right, vector->type().get(), descending)))
+          << "at " << row;
+    }
+  }
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/Spill.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <array>
@@ -37,63 +38,171 @@ class SpillTest : public testing::Test,
     filesystems::registerLocalFileSystem();
   }
 
-  memory::MappedMemory* mappedMemory_;
-};
-
-TEST_F(SpillTest, spillState) {
-  auto tempDirectory = exec::test::TempDirectoryPath::create();
   // We make a state that has 2 partitions, each with its own file
   // list. We write 10 sorted vectors in each partition. The vectors
   // have the ith element = i * 20 + sequence, where sequence is the
   // sequence number of the vector in the partition. When read back,
   // both partitions produce an ascending sequence of integers without
-  // gaps.
-  SpillState state(
-      tempDirectory->path + "/test",
-      2,
-      1,
-      10000, // small target file size. Makes a new file for each batch.
-      *pool(),
-      *mappedMemory_);
+  // gaps. The spill files are compressed with 'compression' and written and
+  // read ahead on 'executor' if given. Sets 'spilledBytes' to the size of
+  // the spill files.
+  void testSpillState(
+      folly::io::CodecType compression,
+      folly::Executor* executor,
+      int64_t& spilledBytes) {
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    SpillState state(
+        tempDirectory->path + "/test",
+        2,
+        1,
+        10000, // small target file size. Makes a new file for each batch.
+        *pool(),
+        *mappedMemory_,
+        {},
+        compression,
+        executor);
 
-  EXPECT_EQ(2, state.maxPartitions());
-  state.setNumPartitions(2);
-  for (auto partition = 0; partition < state.maxPartitions(); ++partition) {
-    for (auto batch = 0; batch < 10; ++batch) {
-      // We add a sorted run in two pieces: 1, 11, 21,,, followed by 100001 ,
-      // 100011, 100021   etc. where the last digit is the batch number. Each
-      // sorted run has 20000 rows.
-      state.appendToPartition(
-          partition,
-          makeRowVector({makeFlatVector<int64_t>(
-              10000, [&](auto row) { return row * 10 + batch; })}));
+    EXPECT_EQ(2, state.maxPartitions());
+    state.setNumPartitions(2);
+    for (auto partition = 0; partition < state.maxPartitions(); ++partition) {
+      for (auto batch = 0; batch < 10; ++batch) {
+        // We add a sorted run in two pieces: 1, 11, 21,,, followed by 100001
+        // , 100011, 100021   etc. where the last digit is the batch number.
+        // Each sorted run has 20000 rows.
+        state.appendToPartition(
+            partition,
+            makeRowVector({makeFlatVector<int64_t>(
+                10000, [&](auto row) { return row * 10 + batch; })}));
 
-      state.appendToPartition(
-          partition,
-          makeRowVector({makeFlatVector<int64_t>(
-              10000, [&](auto row) { return row * 10 + batch + 100000; })}));
-      // Indicates that the next additions to 'partition' are not sorted with
-      // respect to the values added so far.
-      state.finishWrite(partition);
+        state.appendToPartition(
+            partition,
+            makeRowVector({makeFlatVector<int64_t>(10000, [&](auto row) {
+              return row * 10 + batch + 100000;
+            })}));
+        // Indicates that the next additions to 'partition' are not sorted
+        // with respect to the values added so far.
+        state.finishWrite(partition);
+      }
+    }
+    spilledBytes = state.spilledBytes();
+    for (auto partition = 0; partition < state.maxPartitions(); ++partition) {
+      auto merge = state.startMerge(partition, nullptr);
+      // We expect 10 * 20000 rows in dense increasing order.
+      for (auto i = 0; i < 200000; ++i) {
+        auto stream = merge->next();
+        ASSERT_NE(nullptr, stream);
+        EXPECT_EQ(
+            i,
+            stream->current()
+                .childAt(0)
+                ->asUnchecked<FlatVector<int64_t>>()
+                ->valueAt(stream->currentIndex()));
+        EXPECT_EQ(
+            i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+
+        stream->pop();
+      }
+      ASSERT_EQ(nullptr, merge->next());
     }
   }
-  EXPECT_LT(200'000 * sizeof(int64_t), state.spilledBytes());
-  for (auto partition = 0; partition < state.maxPartitions(); ++partition) {
-    auto merge = state.startMerge(partition, nullptr);
-    // We expect 10 * 20000 rows in dense increasing order.
-    for (auto i = 0; i < 200000; ++i) {
-      auto stream = merge->next();
-      ASSERT_NE(nullptr, stream);
-      EXPECT_EQ(
-          i,
-          stream->current()
-              .childAt(0)
-              ->asUnchecked<FlatVector<int64_t>>()
-              ->valueAt(stream->currentIndex()));
-      EXPECT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
 
-      stream->pop();
+  memory::MappedMemory* mappedMemory_;
+};
+
+TEST_F(SpillTest, spillState) {
+  int64_t spilledBytes;
+  testSpillState(folly::io::CodecType::NO_COMPRESSION, nullptr, spilledBytes);
+  EXPECT_LT(200'000 * sizeof(int64_t), spilledBytes);
+}
+
+TEST_F(SpillTest, compressedAsync) {
+  int64_t uncompressedBytes;
+  testSpillState(
+      folly::io::CodecType::NO_COMPRESSION, nullptr, uncompressedBytes);
+  folly::CPUThreadPoolExecutor executor(2);
+  int64_t spilledBytes;
+  testSpillState(
+      folly::io::CodecType::NO_COMPRESSION, &executor, spilledBytes);
+  EXPECT_EQ(uncompressedBytes, spilledBytes);
+  for (auto codec : {"lz4", "zstd"}) {
+    auto type = spillCodecType(codec);
+    if (!folly::io::hasCodec(type)) {
+      continue;
     }
-    ASSERT_EQ(nullptr, merge->next());
+    SCOPED_TRACE(codec);
+    testSpillState(type, nullptr, spilledBytes);
+    EXPECT_LT(spilledBytes, uncompressedBytes);
+    testSpillState(type, &executor, spilledBytes);
+    EXPECT_LT(spilledBytes, uncompressedBytes);
+  }
+  EXPECT_THROW(spillCodecType("snappy"), VeloxUserError);
+}
+
+TEST_F(SpillTest, directories) {
+  auto directories =
+      SpillDirectory::parse("/spillTest/a,/spillTest/b:1000,file:/spillTest/c");
+  ASSERT_EQ(3, directories.size());
+  EXPECT_EQ("/spillTest/a", directories[0]->path());
+  EXPECT_EQ(std::numeric_limits<int64_t>::max(), directories[0]->freeBytes());
+  EXPECT_EQ("/spillTest/b", directories[1]->path());
+  EXPECT_EQ(1000, directories[1]->freeBytes());
+  EXPECT_EQ("file:/spillTest/c", directories[2]->path());
+  // The same path maps to the same directory. The first capacity stays.
+  EXPECT_EQ(directories[1], SpillDirectory::parse("/spillTest/b:10")[0]);
+  EXPECT_EQ(1000, directories[1]->freeBytes());
+
+  SpillDirectory small("small", 1000);
+  SpillDirectory large("large", 0);
+  // Equal number of writers. The one with more free space wins.
+  EXPECT_EQ(&large, SpillDirectory::pick({&small, &large}, 500));
+  large.addWriter();
+  EXPECT_EQ(&small, SpillDirectory::pick({&small, &large}, 500));
+  small.addUsedBytes(800);
+  EXPECT_EQ(&large, SpillDirectory::pick({&small, &large}, 500));
+  // If nothing has space, the one with the most free space is used.
+  EXPECT_EQ(&small, SpillDirectory::pick({&small}, 500));
+  large.removeWriter();
+
+  auto first = exec::test::TempDirectoryPath::create();
+  auto second = exec::test::TempDirectoryPath::create();
+  auto stripes = SpillDirectory::parse(first->path + "," + second->path);
+  SpillState state(
+      "test",
+      1,
+      1,
+      10000, // Makes a new file for each batch.
+      *pool(),
+      *mappedMemory_,
+      {},
+      folly::io::CodecType::NO_COMPRESSION,
+      nullptr,
+      stripes);
+  state.setNumPartitions(1);
+  for (auto batch = 0; batch < 4; ++batch) {
+    state.appendToPartition(
+        0,
+        makeRowVector({makeFlatVector<int64_t>(
+            10000, [&](auto row) { return row * 4 + batch; })}));
+    state.finishWrite(0);
+  }
+  auto stats = state.directoryStats();
+  ASSERT_EQ(2, stats.size());
+  EXPECT_EQ(
+      state.spilledBytes(),
+      stats[first->path].writtenBytes + stats[second->path].writtenBytes);
+  EXPECT_LT(0, stats[first->path].writtenBytes);
+  EXPECT_LT(0, stats[second->path].writtenBytes);
+
+  auto merge = state.startMerge(0, nullptr);
+  for (auto i = 0; i < 40000; ++i) {
+    auto stream = merge->next();
+    ASSERT_NE(nullptr, stream);
+    EXPECT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+    stream->pop();
+  }
+  ASSERT_EQ(nullptr, merge->next());
+  stats = state.directoryStats();
+  for (const auto& directory : {first->path, second->path}) {
+    EXPECT_EQ(stats[directory].writtenBytes, stats[directory].readBytes);
   }
 }
@@ -202,3 +202,75 @@ TEST_F(SpillerTest, spillAll) {
 TEST_F(SpillerTest, error) {
   testSpill(100, true);
 }
+
+TEST_F(SpillerTest, numPartitionBits) {
+  // Spilling all needs no more than the minimum.
+  EXPECT_EQ(2, Spiller::numPartitionBits(1000, 0, 2, 4));
+  // A quarter must go.
+  EXPECT_EQ(2, Spiller::numPartitionBits(1000, 750, 2, 4));
+  EXPECT_EQ(3, Spiller::numPartitionBits(1000, 800, 2, 4));
+  // A few bytes must go. Capped at the maximum.
+  EXPECT_EQ(4, Spiller::numPartitionBits(1000, 999, 2, 4));
+  EXPECT_EQ(4, Spiller::numPartitionBits(1000, 2000, 2, 4));
+}
+
+TEST_F(SpillerTest, repartition) {
+  constexpr int32_t kNumRows = 20000;
+  std::vector<char*> rows(kNumRows);
+  RowVectorPtr batch;
+  auto data = makeSpillData(kNumRows, rows, batch);
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  // A small target file size makes many files per partition.
+  Spiller spiller(
+      *data,
+      [&](folly::Range<char**> rows) { data->eraseRows(rows); },
+      std::static_pointer_cast<const RowType>(batch->type()),
+      HashBitRange(0, 1),
+      data->keyTypes().size(),
+      tempDirectory->path,
+      20000,
+      *pool_,
+      executor());
+  RowContainerIterator iter;
+  auto initialRows = data->numRows();
+  auto initialBytes = data->allocatedBytes();
+  for (int32_t pct = 10; pct <= 90; pct += 10) {
+    spiller.spill(
+        initialRows - (initialRows * pct / 100),
+        initialBytes - (initialBytes * pct / 100),
+        iter);
+  }
+  auto unspilledRows = spiller.finishSpill();
+
+  // Merging 3 streams at a time repartitions the partitions with more
+  // files. Each merge is sorted and the merges together have all rows once.
+  std::vector<bool> seen(kNumRows, false);
+  int32_t numRows = 0;
+  auto previous = BaseVector::create<RowVector>(batch->type(), 1, pool_.get());
+  while (auto merge = spiller.nextMerge(3)) {
+    bool first = true;
+    while (auto stream = merge->next()) {
+      const auto& current = stream->current();
+      const auto index = stream->currentIndex();
+      if (!first) {
+        EXPECT_LE(0, current.compare(previous.get(), index, 0, {}).value());
+      }
+      first = false;
+      previous->copy(&current, 0, index, 1);
+      auto ordinal =
+          current.childAt(5)->asUnchecked<FlatVector<int64_t>>()->valueAt(
+              index);
+      EXPECT_FALSE(seen[ordinal]);
+      seen[ordinal] = true;
+      ++numRows;
+      stream->pop();
+    }
+  }
+  EXPECT_EQ(kNumRows, numRows + unspilledRows.size());
+  EXPECT_LT(0, spiller.numRepartitions());
+  auto partitionBytes = spiller.spilledPartitionBytes();
+  EXPECT_EQ(2, partitionBytes.size());
+  EXPECT_EQ(
+      spiller.spilledBytesAndRows().first,
+      partitionBytes[0] + partitionBytes[1]);
+}
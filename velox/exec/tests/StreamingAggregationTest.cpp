@@ -237,6 +237,43 @@ TEST_F(StreamingAggregationTest, uniqueKeys) {
   testAggregation(keys, 100);
 }
 
+TEST_F(StreamingAggregationTest, longRuns) {
+  // Runs of 100 rows are aggregated once per run. The runs span batches.
+  auto size = 1'024;
+  std::vector<VectorPtr> keys;
+  for (auto i = 0; i < 4; ++i) {
+    keys.push_back(makeFlatVector<int64_t>(
+        size, [&](auto row) { return (i * size + row) / 100; }));
+  }
+  testAggregation(keys);
+  testAggregation(keys, 3);
+
+  // Null keys and string keys.
+  keys.clear();
+  for (auto i = 0; i < 4; ++i) {
+    keys.push_back(makeFlatVector<StringView>(
+        size,
+        [&](auto row) {
+          return StringView(
+              fmt::format("key-{:08}", (i * size + row) / 100));
+        },
+        [&](auto row) { return (i * size + row) / 100 % 3 == 0; }));
+  }
+  testAggregation(keys);
+
+  // Dictionary-encoded keys.
+  keys.clear();
+  for (auto i = 0; i < 4; ++i) {
+    auto indices = makeIndices(size, [](auto row) { return row; });
+    keys.push_back(wrapInDictionary(
+        indices,
+        size,
+        makeFlatVector<int32_t>(
+            size, [&](auto row) { return (i * size + row) / 300; })));
+  }
+  testAggregation(keys);
+}
+
 TEST_F(StreamingAggregationTest, partialStreaming) {
   auto size = 1'024;
 
@@ -21,6 +21,7 @@
 #include "velox/dwio/dwrf/test/utils/DataFiles.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -495,6 +496,123 @@ TEST_F(TableScanTest, multipleSplits) {
   assertQuery(tableScanNode(), filePaths, "SELECT * FROM tmp");
 }
 
+// Splits queued behind the current one are opened in the background.
+// Checks that preloaded splits, some of which are skipped on file stats,
+// produce the same result as reading them in the foreground.
+TEST_F(TableScanTest, preloadSplits) {
+  auto filePaths = makeFilePaths(10);
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < filePaths.size(); i++) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000, [i](auto row) { return i * 1'000 + row; })}));
+    writeToFile(filePaths[i]->path, vectors.back());
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .tableScan(ROW({"c0"}, {BIGINT()}), {"c0 < 3000"})
+                  .planNode();
+  auto task = assertQuery(
+      plan,
+      filePaths,
+      "SELECT c0 FROM tmp WHERE c0 < 3000");
+  EXPECT_EQ(3'000, getTableScanStats(task).rawInputRows);
+  EXPECT_EQ(7, getSkippedSplitsStat(task));
+}
+
+TEST_F(TableScanTest, aggregationPushdownIntoDataSource) {
+  auto filePaths = makeFilePaths(10);
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < filePaths.size(); i++) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             1'000, [i](auto row) { return i * 1'000 + row; }),
+         makeFlatVector<double>(
+             1'000, [i](auto row) { return i - row * 0.1; }, nullEvery(7))}));
+    writeToFile(filePaths[i]->path, vectors.back());
+  }
+  createDuckDbTable(vectors);
+
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), DOUBLE()});
+  auto makePlan = [&](const std::vector<std::string>& subfieldFilters,
+                      const std::string& remainingFilter) {
+    return PlanBuilder()
+        .tableScan(rowType, subfieldFilters, remainingFilter)
+        .pushdownAggregates(
+            {"count(1)", "min(c0)", "max(c0)", "count(c1)", "min(c1)"})
+        .finalAggregation(
+            {},
+            {"count(a0)", "min(a1)", "max(a2)", "count(a3)", "min(a4)"},
+            {BIGINT(), BIGINT(), BIGINT(), BIGINT(), DOUBLE()})
+        .planNode();
+  };
+  auto getAggregatedFiles = [](const std::shared_ptr<Task>& task) {
+    return getTableScanRuntimeStats(task)["aggregatedFiles"].sum;
+  };
+  const std::string sql =
+      "SELECT count(*), min(c0), max(c0), count(c1), min(c1) FROM tmp";
+
+  // All rows of the files that are not skipped pass the filter, so that
+  // none is read.
+  auto task = assertQuery(
+      makePlan({"c0 >= 2000"}, ""), filePaths, sql + " WHERE c0 >= 2000");
+  EXPECT_EQ(8, getAggregatedFiles(task));
+  EXPECT_EQ(0, getTableScanStats(task).rawInputRows);
+
+  // One file is read and aggregated with ValueHooks.
+  task = assertQuery(
+      makePlan({"c0 >= 2500"}, ""), filePaths, sql + " WHERE c0 >= 2500");
+  EXPECT_EQ(7, getAggregatedFiles(task));
+  EXPECT_EQ(1'000, getTableScanStats(task).rawInputRows);
+
+  // A remaining filter needs the rows.
+  task = assertQuery(
+      makePlan({}, "c0 % 3 = 0"), filePaths, sql + " WHERE c0 % 3 = 0");
+  EXPECT_EQ(0, getAggregatedFiles(task));
+
+  // No row passes.
+  assertQuery(
+      makePlan({"c0 > 100000"}, ""), filePaths, sql + " WHERE c0 > 100000");
+}
+
+TEST_F(TableScanTest, groupedSplit) {
+  auto filePaths = makeFilePaths(5);
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < filePaths.size(); i++) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000, [i](auto row) { return i * 1'000 + row; })}));
+    writeToFile(filePaths[i]->path, vectors.back());
+  }
+  createDuckDbTable(vectors);
+
+  auto makeGroupedSplit = [&]() {
+    auto split = std::dynamic_pointer_cast<HiveConnectorSplit>(
+        makeHiveConnectorSplit(filePaths[0]->path));
+    for (int32_t i = 1; i < filePaths.size(); i++) {
+      split->groupedSplits.push_back(
+          std::dynamic_pointer_cast<HiveConnectorSplit>(
+              makeHiveConnectorSplit(filePaths[i]->path)));
+    }
+    return split;
+  };
+
+  auto rowType = ROW({"c0"}, {BIGINT()});
+  auto task = assertQuery(
+      tableScanNode(rowType), makeGroupedSplit(), "SELECT * FROM tmp");
+  EXPECT_EQ(5'000, getTableScanStats(task).rawInputRows);
+  EXPECT_EQ(1, getTableScanStats(task).numSplits);
+
+  // The files in the middle are skipped on their stats.
+  auto plan =
+      PlanBuilder().tableScan(rowType, {"c0 < 1000 or c0 >= 4000"}).planNode();
+  task = assertQuery(
+      plan,
+      makeGroupedSplit(),
+      "SELECT c0 FROM tmp WHERE c0 < 1000 or c0 >= 4000");
+  EXPECT_EQ(2'000, getTableScanStats(task).rawInputRows);
+  EXPECT_EQ(3, getSkippedSplitsStat(task));
+}
+
 TEST_F(TableScanTest, waitForSplit) {
   auto filePaths = makeFilePaths(10);
   auto vectors = makeVectors(10, 1'000);
@@ -536,6 +654,30 @@ TEST_F(TableScanTest, splitOffsetAndLength) {
       "SELECT * FROM tmp LIMIT 0");
 }
 
+// A split larger than the chunk size is divided when a Driver takes it. The
+// byte ranges read the stripes that start in them.
+TEST_F(TableScanTest, divideSplits) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  auto config = std::make_shared<dwrf::Config>();
+  config->set<uint64_t>(dwrf::Config::STRIPE_SIZE, 1'024);
+  writeToFile(filePath->path, vectors, config);
+  createDuckDbTable(vectors);
+
+  const auto fileSize = fs::file_size(filePath->path);
+  auto task =
+      AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+          .maxDrivers(4)
+          .split(makeHiveConnectorSplit(filePath->path, 0, fileSize))
+          .config(
+              core::QueryConfig::kTableScanSplitChunkBytes,
+              std::to_string(fileSize / 4 + 1))
+          .assertResults("SELECT * FROM tmp");
+  EXPECT_EQ(3, task->taskStats().numDividedSplits);
+  EXPECT_EQ(4, task->taskStats().numFinishedSplits);
+  EXPECT_EQ(4, getTableScanStats(task).numSplits);
+}
+
 TEST_F(TableScanTest, fileNotFound) {
   CursorParameters params;
   params.planNode = tableScanNode();
@@ -724,6 +866,35 @@ TEST_F(TableScanTest, statsBasedSkippingDouble) {
   EXPECT_EQ(3, getSkippedStridesStat(task));
 }
 
+TEST_F(TableScanTest, statsBasedSkippingFromCachedStats) {
+  auto filePaths = makeFilePaths(1);
+  auto rowVector = makeRowVector(
+      {makeFlatVector<int64_t>(10'000, [](auto row) { return row; })});
+  writeToFile(filePaths[0]->path, rowVector);
+  createDuckDbTable({rowVector});
+
+  auto assertQuery = [&](const std::string& filter) {
+    return TableScanTest::assertQuery(
+        PlanBuilder().tableScan(ROW({"c0"}, {BIGINT()}), {filter}).planNode(),
+        filePaths,
+        "SELECT c0 FROM tmp WHERE " + filter);
+  };
+  auto getPrunedSplitsStat = [](const std::shared_ptr<Task>& task) {
+    return getTableScanRuntimeStats(task)["prunedSplits"].sum;
+  };
+
+  // The first scan of the file reads its footer and caches the statistics.
+  auto task = assertQuery("c0 >= 5000");
+  EXPECT_EQ(0, getSkippedSplitsStat(task));
+  EXPECT_EQ(0, getPrunedSplitsStat(task));
+
+  // Later scans drop the split based on the cached statistics.
+  task = assertQuery("c0 > 20000");
+  EXPECT_EQ(1, getSkippedSplitsStat(task));
+  EXPECT_EQ(1, getPrunedSplitsStat(task));
+  EXPECT_EQ(0, getTableScanStats(task).rawInputRows);
+}
+
 TEST_F(TableScanTest, statsBasedSkippingFloat) {
   auto filePaths = makeFilePaths(1);
   auto size = 31'234;
@@ -1650,6 +1821,65 @@ TEST_F(TableScanTest, remainingFilterConstantResult) {
       "SELECT * FROM tmp WHERE c0 < 100 AND c1::bigint % 23 > 10");
 }
 
+TEST_F(TableScanTest, filterOrderAcrossSplits) {
+  // The filter on c0 drops one row per file and the one on c1 all but one.
+  // Without statistics the integer filter on c0 goes first.
+  auto filePaths = makeFilePaths(2);
+  for (auto& filePath : filePaths) {
+    writeToFile(
+        filePath->path,
+        makeRowVector({
+            makeFlatVector<int64_t>(10'000, [](auto row) { return row; }),
+            makeFlatVector<StringView>(
+                10'000,
+                [](auto row) { return StringView(fmt::format("s{}", row)); }),
+        }));
+  }
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+  auto tableHandle = makeTableHandle(SubfieldFiltersBuilder()
+                                         .add("c0", between(1, 10'000))
+                                         .add("c1", equal("s7"))
+                                         .build());
+  auto connector = connector::getConnector(kHiveConnectorId);
+
+  // Reads the files as consecutive splits of one data source. Checks that
+  // each split adds to the filter statistics of the previous ones and
+  // returns the final filter order.
+  auto readSplits = [&](bool adaptiveFilterReordering) {
+    auto config = std::make_shared<core::MemConfig>();
+    connector::ConnectorQueryCtx queryCtx(
+        pool_.get(),
+        config.get(),
+        nullptr,
+        mappedMemory(),
+        "scan",
+        adaptiveFilterReordering);
+    auto dataSource = std::dynamic_pointer_cast<HiveDataSource>(
+        connector->createDataSource(
+            rowType, tableHandle, allRegularColumns(rowType), &queryCtx));
+    auto& scanSpec = dataSource->scanSpec();
+    uint64_t numIn = 0;
+    for (auto& filePath : filePaths) {
+      dataSource->addSplit(makeHiveConnectorSplit(filePath->path));
+      ContinueFuture future;
+      while (dataSource->next(1'000, future).value()) {
+      }
+      auto splitNumIn = scanSpec.childByName("c0")->selectivity().numIn() +
+          scanSpec.childByName("c1")->selectivity().numIn();
+      EXPECT_GT(splitNumIn, numIn);
+      numIn = splitNumIn;
+    }
+    std::vector<std::string> names;
+    for (auto& child : scanSpec.children()) {
+      names.push_back(child->fieldName());
+    }
+    return names;
+  };
+
+  EXPECT_EQ(readSplits(true), (std::vector<std::string>{"c1", "c0"}));
+  EXPECT_EQ(readSplits(false), (std::vector<std::string>{"c0", "c1"}));
+}
+
 TEST_F(TableScanTest, aggregationPushdown) {
   auto vectors = makeVectors(10, 1'000);
   auto filePath = TempFilePath::create();
@@ -1766,6 +1996,49 @@ TEST_F(TableScanTest, aggregationPushdown) {
   EXPECT_EQ(0, loadedToValueHook(task));
 }
 
+TEST_F(TableScanTest, projectionPushdown) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  // Returns the number of values the project operator got via a ValueHook.
+  auto loadedToValueHook = [](const std::shared_ptr<Task> task) {
+    auto stats =
+        task->taskStats().pipelineStats[0].operatorStats[1].runtimeStats;
+    auto it = stats.find("loadedToValueHook");
+    return it != stats.end() ? it->second.sum : 0;
+  };
+
+  auto op = PlanBuilder()
+                .tableScan(rowType_)
+                .project({"c0 < 5000", "c4 * 2.0", "c1"})
+                .planNode();
+  auto task =
+      assertQuery(op, {filePath}, "SELECT c0 < 5000, c4 * 2.0, c1 FROM tmp");
+  EXPECT_EQ(2 * 10'000, loadedToValueHook(task));
+
+  // Only the rows that pass the filter are loaded.
+  op = PlanBuilder()
+           .tableScan(rowType_)
+           .filter("c1 % 2 = 0")
+           .project({"c0 >= 100", "c4 - 1.5"})
+           .planNode();
+  task = assertQuery(
+      op, {filePath}, "SELECT c0 >= 100, c4 - 1.5 FROM tmp WHERE c1 % 2 = 0");
+  EXPECT_GT(loadedToValueHook(task), 0);
+  EXPECT_LT(loadedToValueHook(task), 2 * 10'000);
+
+  // No pushdown if the column has another use.
+  op = PlanBuilder()
+           .tableScan(rowType_)
+           .project({"c0 < 5000", "c0", "c4 * 2.0", "c4 + 1.0"})
+           .planNode();
+  task = assertQuery(
+      op, {filePath}, "SELECT c0 < 5000, c0, c4 * 2.0, c4 + 1.0 FROM tmp");
+  EXPECT_EQ(0, loadedToValueHook(task));
+}
+
 TEST_F(TableScanTest, bitwiseAggregationPushdown) {
   auto vectors = makeVectors(10, 1'000);
   auto filePath = TempFilePath::create();
@@ -2048,6 +2321,45 @@ TEST_F(TableScanTest, groupedExecution) {
   EXPECT_EQ(numRead, numSplits * 10'000);
 }
 
+// The FilterProjects of a split group take the expressions of the ones of
+// the split group before.
+TEST_F(TableScanTest, groupedExecutionReusesExpressions) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .tableScan(rowType_)
+                        .filter("c0 % 2 = 0")
+                        .project({"c0 + 1"})
+                        .planNode();
+  params.maxDrivers = 2;
+  params.executionStrategy = core::ExecutionStrategy::kGrouped;
+  params.numSplitGroups = 3;
+  params.numConcurrentSplitGroups = 1;
+
+  auto cursor = std::make_unique<TaskCursor>(params);
+  auto task = cursor->task();
+  for (auto group : {1, 5, 8}) {
+    task->addSplit("0", makeHiveSplitWithGroup(filePath->path, group));
+    task->noMoreSplitsForGroup("0", group);
+  }
+  task->noMoreSplits("0");
+  cursor->start();
+
+  while (cursor->moveNext()) {
+  }
+  EXPECT_EQ(TaskState::kFinished, task->state());
+  EXPECT_EQ(
+      std::unordered_set<int32_t>({1, 5, 8}), getCompletedSplitGroups(task));
+
+  // The second and third split groups compile no expressions.
+  auto& filterProjectStats =
+      task->taskStats().pipelineStats[0].operatorStats[1];
+  EXPECT_EQ(4, filterProjectStats.runtimeStats["reusedExprSet"].sum);
+}
+
 TEST_F(TableScanTest, addSplitsToFailedTask) {
   auto data = makeRowVector(
       {makeFlatVector<int32_t>(12'000, [](auto row) { return row % 5; })});
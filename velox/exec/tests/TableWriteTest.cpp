@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/dwio/common/DataSink.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -237,3 +238,145 @@ TEST_F(TableWriteTest, writeEmptyFile) {
   execute(plan, queryCtx);
   ASSERT_TRUE(fs::exists(outputFile->path));
 }
+
+// Writes the rows sorted on the sorting keys, spilling the sorted runs, and
+// records the order in the file metadata.
+TEST_F(TableWriteTest, sortedWrite) {
+  auto vectors = makeVectors(rowType_, 10, 1'000);
+  createDuckDbTable(vectors);
+
+  auto outputFile = TempFilePath::create();
+  auto spillDirectory = TempDirectoryPath::create();
+  auto plan =
+      PlanBuilder()
+          .values(vectors)
+          .sortedTableWrite(
+              rowType_->names(),
+              {"c1 DESC NULLS FIRST", "c0"},
+              std::make_shared<core::InsertTableHandle>(
+                  kHiveConnectorId,
+                  std::make_shared<HiveInsertTableHandle>(outputFile->path)),
+              "rows")
+          .project({"rows"})
+          .planNode();
+
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(core::QueryConfig::kSpillPath, spillDirectory->path)
+                  .config(core::QueryConfig::kTestingSpillPct, "100")
+                  .assertResults("SELECT count(*) FROM tmp");
+  auto stats = task->taskStats().pipelineStats;
+  EXPECT_LT(0, stats[0].operatorStats[1].spilledRows);
+
+  auto scan = PlanBuilder().tableScan(rowType_).planNode();
+  AssertQueryBuilder(scan, duckDbQueryRunner_)
+      .split(makeHiveConnectorSplit(outputFile->path))
+      .assertResults(
+          "SELECT * FROM tmp ORDER BY c1 DESC NULLS FIRST, c0 NULLS LAST",
+          {{1, 0}});
+
+  dwio::common::ReaderOptions readerOptions;
+  auto reader = dwrf::DwrfReader::create(
+      std::make_unique<dwio::common::FileInputStream>(outputFile->path),
+      readerOptions);
+  EXPECT_EQ(
+      reader->getMetadataValue(HiveDataSink::kSortOrderMetadataKey),
+      "c1 DESC NULLS FIRST,c0 ASC NULLS LAST");
+}
+
+// Writes a directory per partition with a file per bucket. A small memory
+// budget makes the writers flush stripes on every batch.
+TEST_F(TableWriteTest, partitionedBucketedWrite) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector(
+        {"c0", "c1", "p"},
+        {makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return i * 1'000 + row; }),
+         makeFlatVector<int32_t>(1'000, [](auto row) { return row % 7; }),
+         makeFlatVector<StringView>(
+             1'000,
+             [](auto row) { return row % 3 == 0 ? "a/b" : "c"; },
+             nullEvery(11))}));
+  }
+  createDuckDbTable(vectors);
+
+  auto outputDirectory = TempDirectoryPath::create();
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .tableWrite(
+                      {"c0", "c1", "p"},
+                      std::make_shared<core::InsertTableHandle>(
+                          kHiveConnectorId,
+                          std::make_shared<HiveInsertTableHandle>(
+                              outputDirectory->path,
+                              dwio::common::FileFormat::DWRF,
+                              std::vector<std::string>{"p"},
+                              HiveBucketProperty{4, {"c0"}},
+                              0,
+                              1)),
+                      "rows")
+                  .project({"rows"})
+                  .planNode();
+  assertQuery(plan, "SELECT count(*) FROM tmp");
+
+  std::map<std::string, std::vector<std::string>> files;
+  for (const auto& entry :
+       fs::recursive_directory_iterator(outputDirectory->path)) {
+    if (entry.is_regular_file()) {
+      files[entry.path().parent_path().filename()].push_back(
+          entry.path().filename());
+    }
+  }
+  const std::vector<std::string> bucketFiles = {
+      "000000_0", "000001_0", "000002_0", "000003_0"};
+  ASSERT_EQ(3, files.size());
+  for (auto& [partition, names] : files) {
+    std::sort(names.begin(), names.end());
+    EXPECT_EQ(bucketFiles, names) << partition;
+  }
+  EXPECT_EQ(1, files.count("p=a%2Fb"));
+  EXPECT_EQ(1, files.count("p=c"));
+  EXPECT_EQ(1, files.count("p=__HIVE_DEFAULT_PARTITION__"));
+
+  // The Hive hash of a small non-negative bigint is the value.
+  auto scan =
+      PlanBuilder().tableScan(ROW({"c0", "c1"}, {BIGINT(), INTEGER()}));
+  AssertQueryBuilder(scan.planNode(), duckDbQueryRunner_)
+      .split(makeHiveConnectorSplit(
+          fmt::format("{}/p=c/000002_0", outputDirectory->path)))
+      .assertResults("SELECT c0, c1 FROM tmp WHERE p = 'c' AND c0 % 4 = 2");
+}
+
+// Starts a new file once a file reaches the target size.
+TEST_F(TableWriteTest, rollFiles) {
+  auto vectors = makeVectors(rowType_, 5, 1'000);
+  createDuckDbTable(vectors);
+
+  auto outputDirectory = TempDirectoryPath::create();
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .tableWrite(
+                      rowType_->names(),
+                      std::make_shared<core::InsertTableHandle>(
+                          kHiveConnectorId,
+                          std::make_shared<HiveInsertTableHandle>(
+                              outputDirectory->path,
+                              dwio::common::FileFormat::DWRF,
+                              std::vector<std::string>{},
+                              std::nullopt,
+                              1)),
+                      "rows")
+                  .project({"rows"})
+                  .planNode();
+  assertQuery(plan, "SELECT count(*) FROM tmp");
+
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+  for (const auto& entry : fs::directory_iterator(outputDirectory->path)) {
+    splits.push_back(makeHiveConnectorSplit(entry.path()));
+  }
+  EXPECT_LT(1, splits.size());
+  AssertQueryBuilder(
+      PlanBuilder().tableScan(rowType_).planNode(), duckDbQueryRunner_)
+      .splits(splits)
+      .assertResults("SELECT * FROM tmp");
+}
@@ -14,8 +14,12 @@
  * limitations under the License.
  */
 #include "velox/exec/Task.h"
+#include "velox/exec/TaskProfile.h"
+#include <folly/json.h>
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/exec/LocalPlanner.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -497,6 +501,40 @@ TEST_F(TaskTest, singleThreadedExecution) {
   VELOX_ASSERT_THROW(executeSingleThreaded(plan), "division by zero");
 }
 
+TEST_F(TaskTest, memoryUsageSnapshot) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(
+          10'000, [](auto row) { return row * 7 % 10'000; }),
+  });
+  core::PlanNodeId orderById;
+  auto plan = PlanBuilder()
+                  .values({data, data})
+                  .orderBy({"c0"}, false)
+                  .capturePlanNodeId(orderById)
+                  .planFragment();
+  auto task = std::make_shared<exec::Task>(
+      "memory.snapshot.task.0", plan, 0, std::make_shared<core::QueryCtx>());
+
+  // The OrderBy holds all rows while producing the first batch.
+  ASSERT_TRUE(task->next() != nullptr);
+  auto snapshot = task->memoryUsageSnapshot();
+  EXPECT_EQ("memory.snapshot.task.0", snapshot.name);
+  ASSERT_EQ(1, snapshot.children.size());
+  EXPECT_EQ("pipeline.0", snapshot.children[0].name);
+  EXPECT_GT(snapshot.allocatedBytes, 0);
+  auto top = snapshot.topConsumers(1);
+  ASSERT_EQ(1, top.size());
+  EXPECT_EQ(
+      fmt::format("memory.snapshot.task.0/pipeline.0/{}.OrderBy", orderById),
+      top[0].first);
+  EXPECT_GT(top[0].second->currentBytes, 0);
+  EXPECT_LE(top[0].second->currentBytes, snapshot.currentBytes);
+
+  while (task->next()) {
+  }
+  ASSERT_TRUE(waitForTaskCompletion(task.get()));
+}
+
 TEST_F(TaskTest, singleThreadedHashJoin) {
   auto left = makeRowVector(
       {"t_c0", "t_c1"},
@@ -546,6 +584,96 @@ TEST_F(TaskTest, singleThreadedHashJoin) {
   }
 }
 
+TEST_F(TaskTest, startFromLocalPlan) {
+  auto left = makeRowVector(
+      {"t_c0", "t_c1"},
+      {
+          makeFlatVector<int64_t>({1, 2, 3, 4}),
+          makeFlatVector<int64_t>({10, 20, 30, 40}),
+      });
+  auto otherLeft = makeRowVector(
+      {"t_c0", "t_c1"},
+      {
+          makeFlatVector<int64_t>({5, 6}),
+          makeFlatVector<int64_t>({50, 60}),
+      });
+  auto right = makeRowVector({"u_c0"}, {makeFlatVector<int64_t>({1, 3, 5})});
+  auto leftPath = TempFilePath::create();
+  writeToFile(leftPath->path, {left});
+  auto otherLeftPath = TempFilePath::create();
+  writeToFile(otherLeftPath->path, {otherLeft});
+  auto rightPath = TempFilePath::create();
+  writeToFile(rightPath->path, {right});
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId leftScanId;
+  core::PlanNodeId rightScanId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(asRowType(left->type()))
+                  .capturePlanNodeId(leftScanId)
+                  .hashJoin(
+                      {"t_c0"},
+                      {"u_c0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .tableScan(asRowType(right->type()))
+                          .capturePlanNodeId(rightScanId)
+                          .planNode(),
+                      "",
+                      {"t_c0", "t_c1"})
+                  .planFragment();
+  LocalPlan localPlan(plan, 2);
+
+  // Two Tasks with their own splits and QueryCtxs run the same LocalPlan.
+  auto run = [&](const std::string& taskId, const std::string& leftFile) {
+    std::mutex mutex;
+    std::vector<RowVectorPtr> results;
+    auto task = std::make_shared<exec::Task>(
+        taskId,
+        plan,
+        0,
+        core::QueryCtx::createForTest(),
+        [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+          if (vector) {
+            std::lock_guard<std::mutex> l(mutex);
+            results.push_back(vector);
+          }
+          return BlockingReason::kNotBlocked;
+        });
+    Task::start(task, localPlan);
+    task->addSplit(leftScanId, exec::Split(makeHiveConnectorSplit(leftFile)));
+    task->noMoreSplits(leftScanId);
+    task->addSplit(
+        rightScanId, exec::Split(makeHiveConnectorSplit(rightPath->path)));
+    task->noMoreSplits(rightScanId);
+    EXPECT_TRUE(waitForTaskCompletion(task.get()));
+    EXPECT_EQ(2, task->taskStats().pipelineStats.size());
+    return results;
+  };
+
+  assertEqualResults(
+      {makeRowVector({
+          makeFlatVector<int64_t>({1, 3}),
+          makeFlatVector<int64_t>({10, 30}),
+      })},
+      run("local.plan.task.0", leftPath->path));
+  assertEqualResults(
+      {makeRowVector({
+          makeFlatVector<int64_t>({5}),
+          makeFlatVector<int64_t>({50}),
+      })},
+      run("local.plan.task.1", otherLeftPath->path));
+
+  // The LocalPlan must be for the fragment of the Task.
+  auto otherTask = std::make_shared<exec::Task>(
+      "local.plan.task.2",
+      PlanBuilder().values({left}).planFragment(),
+      0,
+      core::QueryCtx::createForTest());
+  VELOX_ASSERT_THROW(
+      Task::start(otherTask, localPlan),
+      "LocalPlan is not made for the plan fragment of task local.plan.task.2");
+}
+
 TEST_F(TaskTest, singleThreadedCrossJoin) {
   auto left = makeRowVector({"t_c0"}, {makeFlatVector<int64_t>({1, 2, 3})});
   auto leftPath = TempFilePath::create();
@@ -596,4 +724,89 @@ TEST_F(TaskTest, supportsSingleThreadedExecution) {
   // task doesn't support it either.
   ASSERT_FALSE(task->supportsSingleThreadedExecution());
 }
+
+TEST_F(TaskTest, eventTrace) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  });
+  auto plan = PlanBuilder()
+                  .values({data, data})
+                  .filter("c0 < 100")
+                  .singleAggregation({}, {"count(1)"})
+                  .planNode();
+  auto expected = makeRowVector({makeFlatVector<int64_t>({200})});
+
+  auto task = AssertQueryBuilder(plan).assertResults(expected);
+  EXPECT_EQ(0, task->traceId());
+  VELOX_ASSERT_THROW(task->toChromeTrace(), "Set event_trace_enabled");
+
+  task = AssertQueryBuilder(plan)
+             .config(core::QueryConfig::kEventTraceEnabled, "true")
+             .assertResults(expected);
+  EXPECT_NE(0, task->traceId());
+  auto trace = folly::parseJson(task->toChromeTrace());
+  std::unordered_map<std::string, int32_t> numSpans;
+  for (const auto& event : trace["traceEvents"]) {
+    if (event["ph"] == "X") {
+      ++numSpans[event["name"].asString()];
+    }
+  }
+  EXPECT_GE(numSpans["Values.0.getOutput"], 2);
+  EXPECT_EQ(2, numSpans["FilterProject.1.addInput"]);
+  EXPECT_EQ(2, numSpans["Aggregation.2.addInput"]);
+  EXPECT_EQ(1, numSpans["Aggregation.2.noMoreInput"]);
+}
+
+TEST_F(TaskTest, profile) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  });
+  auto plan = PlanBuilder()
+                  .values({data, data})
+                  .filter("c0 < 100")
+                  .singleAggregation({}, {"count(1)"})
+                  .planNode();
+  auto expected = makeRowVector({makeFlatVector<int64_t>({200})});
+
+  auto& store = TaskProfileStore::instance();
+  store.clear();
+  auto task = AssertQueryBuilder(plan).assertResults(expected);
+  EXPECT_FALSE(store.get(task->taskId()).has_value());
+
+  task = AssertQueryBuilder(plan)
+             .config(core::QueryConfig::kTaskProfileEnabled, "true")
+             .assertResults(expected);
+  auto json = store.get(task->taskId());
+  ASSERT_TRUE(json.has_value());
+  auto profile = folly::parseJson(json.value());
+  EXPECT_EQ(kTaskProfileVersion, profile["version"].asInt());
+  EXPECT_EQ(task->taskId(), profile["taskId"].asString());
+  EXPECT_EQ("finished", profile["state"].asString());
+  ASSERT_EQ(1, profile["pipelines"].size());
+  const auto& operators = profile["pipelines"][0]["operators"];
+  ASSERT_EQ(3, operators.size());
+  EXPECT_EQ("FilterProject", operators[1]["operatorType"].asString());
+  EXPECT_EQ(2'000, operators[1]["inputPositions"].asInt());
+  EXPECT_EQ(200, operators[1]["outputPositions"].asInt());
+  EXPECT_TRUE(operators[2]["memoryStats"].isObject());
+  EXPECT_TRUE(operators[2]["runtimeStats"].isObject());
+  EXPECT_EQ(task->taskId(), profile["memory"]["name"].asString());
+
+  // Profiles expire after the TTL and the oldest are dropped above the
+  // maximum count.
+  TaskProfileStore shortLived(std::chrono::milliseconds(0), 10);
+  shortLived.add("a", "{}");
+  EXPECT_FALSE(shortLived.get("a").has_value());
+  TaskProfileStore small(std::chrono::milliseconds(60'000), 2);
+  small.add("a", "1");
+  small.add("b", "2");
+  small.add("a", "3");
+  small.add("c", "4");
+  EXPECT_EQ(2, small.size());
+  EXPECT_FALSE(small.get("b").has_value());
+  EXPECT_EQ("3", small.get("a").value());
+  EXPECT_EQ("4", small.get("c").value());
+  store.clear();
+}
+
 } // namespace facebook::velox::exec::test
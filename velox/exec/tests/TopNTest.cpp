@@ -13,13 +13,14 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
 
-class TopNTest : public OperatorTestBase {
+class TopNTest : public HiveConnectorTestBase {
  protected:
   static std::vector<std::string> getSortOrderSqls() {
     return {"NULLS LAST", "NULLS FIRST", "DESC NULLS FIRST", "DESC NULLS LAST"};
@@ -245,3 +246,64 @@ TEST_F(TopNTest, empty) {
 
   testSingleKey(vectors, "c0", "c0 < 0");
 }
+
+TEST_F(TopNTest, cutoff) {
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    auto c0 = makeFlatVector<int32_t>(
+        batchSize,
+        [&](vector_size_t row) { return (batchSize * i + row) * 7919 % 9973; },
+        nullEvery(7));
+    auto c1 = makeFlatVector<int64_t>(
+        batchSize, [&](vector_size_t row) { return batchSize * i + row; });
+    auto c2 = makeConstant<int32_t>(i, batchSize);
+    vectors.push_back(makeRowVector({c0, c1, c2}));
+  }
+  createDuckDbTable(vectors);
+
+  // c1 is unique, so that there are no ties at the cutoff.
+  testTwoKeys(vectors, "c0", "c1", 10);
+  testTwoKeys(vectors, "c2", "c1", 10);
+
+  // Most rows lose to the heap top on the first key.
+  auto plan =
+      PlanBuilder().values(vectors).topN({"c0", "c1"}, 10, false).planNode();
+  auto task = assertQueryOrdered(
+      plan, "SELECT * FROM tmp ORDER BY c0 NULLS LAST, c1 LIMIT 10", {0, 1});
+  auto stats = task->taskStats().pipelineStats[0].operatorStats[1];
+  EXPECT_GT(stats.runtimeStats["numCutoffRows"].sum, batchSize * 8);
+}
+
+TEST_F(TopNTest, cutoffPushdown) {
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    auto c0 = makeFlatVector<int64_t>(
+        batchSize, [&](vector_size_t row) { return batchSize * i + row; });
+    auto c1 = makeFlatVector<StringView>(batchSize, [](vector_size_t row) {
+      return StringView(std::to_string(row));
+    });
+    vectors.push_back(makeRowVector({c0, c1}));
+  }
+  auto filePaths = makeFilePaths(vectors.size());
+  for (auto i = 0; i < vectors.size(); ++i) {
+    // Decreasing values, so that each file is cut off by the previous ones.
+    writeToFile(filePaths[i]->path, vectors[vectors.size() - 1 - i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto rowType = asRowType(vectors[0]->type());
+  auto plan = PlanBuilder()
+                  .tableScan(rowType)
+                  .topN({"c0 DESC"}, 10, false)
+                  .planNode();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .splits(makeHiveConnectorSplits(filePaths))
+                  .assertResults("SELECT * FROM tmp ORDER BY c0 DESC LIMIT 10");
+
+  auto stats = task->taskStats().pipelineStats[0].operatorStats;
+  EXPECT_GT(stats[0].runtimeStats["dynamicFiltersAccepted"].sum, 0);
+  // The scan returns only the rows of the first file.
+  EXPECT_EQ(batchSize, stats[0].outputPositions);
+}
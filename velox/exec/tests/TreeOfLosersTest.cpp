@@ -79,3 +79,18 @@ TEST_F(TreeOfLosersTest, nextWithEquals) {
     result.first->pop();
   }
 }
+
+TEST_F(TreeOfLosersTest, nextWithRunnerUp) {
+  testRuns(makeTestData(11, 2), true);
+  testRuns(makeTestData(16, 32), true);
+  testRuns(makeTestData(0, 9), true);
+  testRuns(makeTestData(100000, 37), true);
+  // Non-overlapping ranges of different lengths, including a single stream.
+  testRuns(makeRangeTestData(100000, 7, 1000), true);
+  testRuns(makeRangeTestData(100000, 12, 1), true);
+  testRuns(makeRangeTestData(1000, 1, 10), true);
+
+  // The ranges are also merged correctly one value at a time.
+  auto testData = makeRangeTestData(10000, 5, 100);
+  test<TreeOfLosers<TestingStream>>(testData, true);
+}
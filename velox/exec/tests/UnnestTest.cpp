@@ -403,3 +403,101 @@ TEST_F(UnnestTest, allEmptyOrNullMaps) {
            .planNode();
   assertQueryReturnsEmptyResult(op);
 }
+
+TEST_F(UnnestTest, outputBatchSize) {
+  // Arrays of up to 1'000 elements, to be split across output batches of 100
+  // rows, and a shorter second array padded with nulls.
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(20, [](auto row) { return row; }),
+      makeArrayVector<int32_t>(
+          20,
+          [](auto row) { return row % 7 == 3 ? 1'000 : row % 4; },
+          [](auto row, auto index) { return row * 10'000 + index; },
+          nullEvery(6)),
+      makeArrayVector<int64_t>(
+          20,
+          [](auto row) { return row % 3; },
+          [](auto row, auto index) { return -row * 10 - index; }),
+  });
+  createDuckDbTable({vector});
+
+  auto makeParams = [&](const core::PlanNodePtr& plan) {
+    CursorParameters params;
+    params.planNode = plan;
+    params.queryCtx = core::QueryCtx::createForTest();
+    params.queryCtx->setConfigOverridesUnsafe(
+        {{core::QueryConfig::kPreferredOutputBatchSize, "100"}});
+    return params;
+  };
+
+  auto op =
+      PlanBuilder().values({vector}).unnest({"c0"}, {"c1", "c2"}).planNode();
+  assertQuery(makeParams(op), "SELECT c0, UNNEST(c1), UNNEST(c2) FROM tmp");
+
+  // The ordinality continues across the batches of one row.
+  op = PlanBuilder()
+           .values({vector})
+           .unnest({}, {"c1"}, "ordinal")
+           .singleAggregation({}, {"count(1)", "max(ordinal)", "sum(ordinal)"})
+           .planNode();
+  assertQuery(makeParams(op), "SELECT 3020, 1000, 1501534");
+
+  auto [cursor, batches] = readCursor(
+      makeParams(
+          PlanBuilder().values({vector}).unnest({"c0"}, {"c1"}).planNode()),
+      [](auto /*task*/) {});
+  int64_t numRows = 0;
+  for (const auto& batch : batches) {
+    EXPECT_LE(batch->size(), 100);
+    numRows += batch->size();
+  }
+  EXPECT_EQ(3'020, numRows);
+}
+
+TEST_F(UnnestTest, outputBatchBytes) {
+  auto readBatches = [&](const RowVectorPtr& vector,
+                         const std::string& batchBytes) {
+    CursorParameters params;
+    params.planNode =
+        PlanBuilder().values({vector}).unnest({"c0"}, {"c1"}).planNode();
+    params.queryCtx = core::QueryCtx::createForTest();
+    params.queryCtx->setConfigOverridesUnsafe(
+        {{core::QueryConfig::kPreferredOutputBatchBytes, batchBytes},
+         {core::QueryConfig::kMaxOutputBatchRows, "5000"}});
+    return readCursor(params, [](auto /*task*/) {}).second;
+  };
+
+  // Batches of wide rows get fewer rows after the first batch.
+  std::string longString(100, 'x');
+  auto wide = makeRowVector({
+      makeFlatVector<int64_t>(20, [](auto row) { return row; }),
+      makeArrayVector<StringView>(
+          20,
+          [](auto /*row*/) { return 1'000; },
+          [&](auto /*row*/, auto /*index*/) { return StringView(longString); }),
+  });
+  auto batches = readBatches(wide, "10000");
+  int64_t numRows = 0;
+  for (auto i = 0; i < batches.size(); ++i) {
+    if (i == 0) {
+      EXPECT_EQ(1024, batches[i]->size());
+    } else if (i < batches.size() - 1) {
+      EXPECT_LT(batches[i]->size(), 100);
+    }
+    numRows += batches[i]->size();
+  }
+  EXPECT_EQ(20'000, numRows);
+
+  // Batches of narrow rows grow up to the max output batch rows.
+  auto narrow = makeRowVector({
+      makeFlatVector<int64_t>(20, [](auto row) { return row; }),
+      makeArrayVector<int32_t>(
+          20,
+          [](auto /*row*/) { return 1'000; },
+          [](auto row, auto index) { return row + index; }),
+  });
+  batches = readBatches(narrow, "1000000");
+  ASSERT_EQ(5, batches.size());
+  EXPECT_EQ(1024, batches[0]->size());
+  EXPECT_EQ(5'000, batches[1]->size());
+}
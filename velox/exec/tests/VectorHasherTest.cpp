@@ -695,6 +695,81 @@ TEST_F(VectorHasherTest, computeValueIdsStrings) {
   ASSERT_LE(uniqueValues.size(), multiplier);
 }
 
+TEST_F(VectorHasherTest, dictionaryIdsAcrossBatches) {
+  // The batches wrap the same dictionary, like the batches of a stripe of a
+  // dictionary encoded column. The ids of the dictionary values are kept
+  // between the batches and must follow the changes of the mapping.
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 100; ++i) {
+    strings.push_back("dictionary value " + std::to_string(i));
+  }
+  auto base = vectorMaker_->flatVector(strings);
+  vector_size_t size = 1'000;
+  SelectivityVector allRows(size);
+  // Returns a batch with the values from 'first' to 'first' + 49.
+  auto makeBatch = [&](int32_t step, int32_t first) {
+    return BaseVector::wrapInDictionary(
+        BufferPtr(nullptr),
+        makeIndices(size, [&](auto row) { return first + (row * step) % 50; }),
+        size,
+        base);
+  };
+
+  std::unordered_map<uint64_t, StringView> idToValue;
+  auto checkIds = [&](const VectorPtr& batch, const raw_vector<uint64_t>& ids) {
+    auto* values = batch->as<SimpleVector<StringView>>();
+    for (auto i = 0; i < size; ++i) {
+      auto value = values->valueAt(i);
+      auto pair = idToValue.insert({ids[i], value});
+      ASSERT_EQ(pair.first->second, value) << "at " << i;
+    }
+  };
+
+  auto hasher = exec::VectorHasher::create(VARCHAR(), 0);
+  raw_vector<uint64_t> ids(size);
+  ASSERT_FALSE(hasher->computeValueIds(*makeBatch(1, 0), allRows, ids));
+  hasher->enableValueIds(1, 0);
+  for (auto step : {1, 7, 13}) {
+    auto batch = makeBatch(step, 0);
+    ASSERT_TRUE(hasher->computeValueIds(*batch, allRows, ids));
+    checkIds(batch, ids);
+  }
+
+  // The values from 50 up are new. The ids change with the new mapping.
+  ASSERT_FALSE(hasher->computeValueIds(*makeBatch(1, 50), allRows, ids));
+  hasher->enableValueIds(1, 0);
+  idToValue.clear();
+  for (auto first : {0, 50, 0}) {
+    auto batch = makeBatch(3, first);
+    ASSERT_TRUE(hasher->computeValueIds(*batch, allRows, ids));
+    checkIds(batch, ids);
+  }
+  EXPECT_EQ(100, idToValue.size());
+
+  // A probe with the same scratch memory finds the same ids for the values
+  // seen before and misses the others.
+  auto probeHasher = exec::VectorHasher::create(VARCHAR(), 0);
+  ASSERT_FALSE(probeHasher->computeValueIds(*makeBatch(1, 0), allRows, ids));
+  probeHasher->enableValueIds(1, 0);
+  VectorHasher::ScratchMemory scratchMemory;
+  auto probe = BaseVector::wrapInDictionary(
+      BufferPtr(nullptr),
+      makeIndices(size, [](auto row) { return row % 100; }),
+      size,
+      base);
+  for (auto i = 0; i < 2; ++i) {
+    SelectivityVector rows(size);
+    raw_vector<uint64_t> probeIds(size);
+    probeHasher->lookupValueIds(*probe, rows, scratchMemory, probeIds);
+    EXPECT_EQ(size / 2, rows.countSelected());
+    rows.applyToSelected([&](auto row) { EXPECT_LT(row % 100, 50); });
+    // Another hasher does not use the ids of 'probeHasher'.
+    rows.setAll();
+    hasher->lookupValueIds(*probe, rows, scratchMemory, probeIds);
+    EXPECT_EQ(size, rows.countSelected());
+  }
+}
+
 namespace {
 
 // enum for marking special values to be tested in a type.
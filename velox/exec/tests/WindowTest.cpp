@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/window/WindowFunctionsRegistration.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+class WindowTest : public OperatorTestBase {
+ protected:
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    window::registerAllWindowFunctions();
+  }
+
+  // Makes 'numBatches' batches of (c0 INTEGER, c1 BIGINT, c2 BIGINT). c0 has
+  // 'numPartitions' distinct values, c1 has many duplicates and c2 is unique.
+  std::vector<RowVectorPtr> makeVectors(
+      int32_t numBatches,
+      vector_size_t batchSize,
+      int32_t numPartitions) {
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < numBatches; ++i) {
+      auto offset = i * batchSize;
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int32_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) % numPartitions; },
+              nullEvery(17)),
+          makeFlatVector<int64_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) % 7; },
+              nullEvery(11)),
+          makeFlatVector<int64_t>(
+              batchSize, [&](auto row) { return offset + row; }),
+      }));
+    }
+    return vectors;
+  }
+};
+
+TEST_F(WindowTest, rankingFunctions) {
+  auto vectors = makeVectors(5, 1'000, 13);
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .window(
+                      {"c0"},
+                      {"c1", "c2"},
+                      {"row_number() as rn",
+                       "rank() as r",
+                       "dense_rank() as dr"})
+                  .planNode();
+  std::string over = "over (PARTITION BY c0 ORDER BY c1 NULLS LAST, c2)";
+  assertQuery(
+      plan,
+      fmt::format(
+          "SELECT *, row_number() {0}, rank() {0}, dense_rank() {0} FROM tmp",
+          over));
+
+  // Ties on c1 make rank() and dense_rank() differ from row_number().
+  plan =
+      PlanBuilder()
+          .values(vectors)
+          .window({"c0"}, {"c1 DESC NULLS FIRST"}, {"rank()", "dense_rank()"})
+          .planNode();
+  over = "over (PARTITION BY c0 ORDER BY c1 DESC NULLS FIRST)";
+  assertQuery(
+      plan,
+      fmt::format("SELECT *, rank() {0}, dense_rank() {0} FROM tmp", over));
+}
+
+TEST_F(WindowTest, noPartitionKeys) {
+  auto vectors = makeVectors(3, 1'000, 5);
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .window({}, {"c2"}, {"row_number()", "sum(c1)"})
+                  .planNode();
+  assertQuery(
+      plan,
+      "SELECT *, row_number() over (ORDER BY c2), sum(c1) over (ORDER BY c2) "
+      "FROM tmp");
+}
+
+TEST_F(WindowTest, aggregates) {
+  auto vectors = makeVectors(5, 1'000, 13);
+  createDuckDbTable(vectors);
+
+  // Running aggregates over the default RANGE frame. Peers of the current row
+  // are part of the frame.
+  auto plan =
+      PlanBuilder()
+          .values(vectors)
+          .window(
+              {"c0"},
+              {"c1"},
+              {"sum(c2)", "count(c2)", "min(c2)", "max(c2)", "avg(c2)"})
+          .planNode();
+  std::string over = "over (PARTITION BY c0 ORDER BY c1 NULLS LAST)";
+  assertQuery(
+      plan,
+      fmt::format(
+          "SELECT *, sum(c2) {0}, count(c2) {0}, min(c2) {0}, max(c2) {0}, "
+          "avg(c2) {0} FROM tmp",
+          over));
+
+  // Without ORDER BY all rows of a partition are peers.
+  plan = PlanBuilder()
+             .values(vectors)
+             .window({"c0"}, {}, {"sum(c2)", "count(1)"})
+             .planNode();
+  assertQuery(
+      plan,
+      "SELECT *, sum(c2) over (PARTITION BY c0), "
+      "count(1) over (PARTITION BY c0) FROM tmp");
+}
+
+TEST_F(WindowTest, rowsFrames) {
+  auto vectors = makeVectors(5, 1'000, 13);
+  createDuckDbTable(vectors);
+
+  auto rowsFrame = [](core::WindowNode::BoundType startType,
+                      int64_t startOffset,
+                      core::WindowNode::BoundType endType,
+                      int64_t endOffset) {
+    return core::WindowNode::Frame{
+        core::WindowNode::WindowType::kRows,
+        startType,
+        std::make_shared<core::ConstantTypedExpr>(startOffset),
+        endType,
+        std::make_shared<core::ConstantTypedExpr>(endOffset)};
+  };
+
+  struct {
+    core::WindowNode::Frame frame;
+    std::string sql;
+  } testSettings[] = {
+      {rowsFrame(
+           core::WindowNode::BoundType::kPreceding,
+           2,
+           core::WindowNode::BoundType::kFollowing,
+           3),
+       "ROWS BETWEEN 2 PRECEDING AND 3 FOLLOWING"},
+      {rowsFrame(
+           core::WindowNode::BoundType::kUnboundedPreceding,
+           0,
+           core::WindowNode::BoundType::kCurrentRow,
+           0),
+       "ROWS BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW"},
+      {rowsFrame(
+           core::WindowNode::BoundType::kCurrentRow,
+           0,
+           core::WindowNode::BoundType::kUnboundedFollowing,
+           0),
+       "ROWS BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING"},
+      {rowsFrame(
+           core::WindowNode::BoundType::kFollowing,
+           1,
+           core::WindowNode::BoundType::kFollowing,
+           5),
+       "ROWS BETWEEN 1 FOLLOWING AND 5 FOLLOWING"},
+      {rowsFrame(
+           core::WindowNode::BoundType::kPreceding,
+           5,
+           core::WindowNode::BoundType::kPreceding,
+           2),
+       "ROWS BETWEEN 5 PRECEDING AND 2 PRECEDING"},
+  };
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.sql);
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .window(
+                        {"c0"},
+                        {"c2"},
+                        {"sum(c1)", "count(c1)", "max(c1)"},
+                        testData.frame)
+                    .planNode();
+    auto over =
+        fmt::format("over (PARTITION BY c0 ORDER BY c2 {})", testData.sql);
+    assertQuery(
+        plan,
+        fmt::format(
+            "SELECT *, sum(c1) {0}, count(c1) {0}, max(c1) {0} FROM tmp",
+            over));
+  }
+}
+
+TEST_F(WindowTest, slidingFrames) {
+  // About 400 rows per partition. Frames of 64 rows or more are assembled
+  // from partial accumulators over blocks of rows.
+  auto vectors = makeVectors(5, 1'000, 13);
+  createDuckDbTable(vectors);
+
+  auto rowsFrame = [](core::WindowNode::BoundType startType,
+                      int64_t startOffset,
+                      core::WindowNode::BoundType endType,
+                      int64_t endOffset) {
+    return core::WindowNode::Frame{
+        core::WindowNode::WindowType::kRows,
+        startType,
+        std::make_shared<core::ConstantTypedExpr>(startOffset),
+        endType,
+        std::make_shared<core::ConstantTypedExpr>(endOffset)};
+  };
+
+  struct {
+    core::WindowNode::Frame frame;
+    std::string sql;
+  } testSettings[] = {
+      {rowsFrame(
+           core::WindowNode::BoundType::kPreceding,
+           100,
+           core::WindowNode::BoundType::kFollowing,
+           50),
+       "ROWS BETWEEN 100 PRECEDING AND 50 FOLLOWING"},
+      {rowsFrame(
+           core::WindowNode::BoundType::kPreceding,
+           200,
+           core::WindowNode::BoundType::kPreceding,
+           70),
+       "ROWS BETWEEN 200 PRECEDING AND 70 PRECEDING"},
+      {rowsFrame(
+           core::WindowNode::BoundType::kFollowing,
+           3,
+           core::WindowNode::BoundType::kUnboundedFollowing,
+           0),
+       "ROWS BETWEEN 3 FOLLOWING AND UNBOUNDED FOLLOWING"},
+  };
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.sql);
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .window(
+                        {"c0"},
+                        {"c2"},
+                        {"sum(c1)", "count(c1)", "max(c1)", "avg(c2)"},
+                        testData.frame)
+                    .planNode();
+    auto over =
+        fmt::format("over (PARTITION BY c0 ORDER BY c2 {})", testData.sql);
+    assertQuery(
+        plan,
+        fmt::format(
+            "SELECT *, sum(c1) {0}, count(c1) {0}, max(c1) {0}, avg(c2) {0} "
+            "FROM tmp",
+            over));
+  }
+}
+
+TEST_F(WindowTest, unsupportedFrame) {
+  auto vectors = makeVectors(1, 10, 2);
+
+  core::WindowNode::Frame frame{
+      core::WindowNode::WindowType::kRange,
+      core::WindowNode::BoundType::kPreceding,
+      std::make_shared<core::ConstantTypedExpr>(int64_t{1}),
+      core::WindowNode::BoundType::kCurrentRow,
+      nullptr};
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .window({"c0"}, {"c2"}, {"sum(c1)"}, frame)
+                  .planNode();
+  VELOX_ASSERT_THROW(
+      assertQuery(plan, "SELECT 1"),
+      "RANGE window frames with PRECEDING or FOLLOWING offsets are not supported");
+}
@@ -106,7 +106,8 @@ bool TaskQueue::hasNext() {
 std::atomic<int32_t> TaskCursor::serial_;
 
 TaskCursor::TaskCursor(const CursorParameters& params)
-    : maxDrivers_{params.maxDrivers},
+    : outputType_{params.planNode->outputType()},
+      maxDrivers_{params.maxDrivers},
       numConcurrentSplitGroups_{params.numConcurrentSplitGroups},
       numSplitGroups_{params.numSplitGroups} {
   std::shared_ptr<core::QueryCtx> queryCtx;
@@ -197,4 +198,16 @@ bool RowCursor::hasNext() {
   return currentRow_ < numRows_ || cursor_->hasNext();
 }
 
+void exportToArrow(
+    std::shared_ptr<TaskCursor> cursor,
+    ArrowArrayStream& arrowStream) {
+  auto type = cursor->outputType();
+  velox::exportToArrow(
+      type,
+      [cursor = std::move(cursor)]() -> RowVectorPtr {
+        return cursor->moveNext() ? cursor->current() : nullptr;
+      },
+      arrowStream);
+}
+
 } // namespace facebook::velox::exec::test
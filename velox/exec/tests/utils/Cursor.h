@@ -17,6 +17,7 @@
 #include <velox/exec/Driver.h>
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Task.h"
+#include "velox/vector/arrow/Bridge.h"
 
 namespace facebook::velox::exec::test {
 
@@ -126,7 +127,12 @@ class TaskCursor {
     return task_;
   }
 
+  const RowTypePtr& outputType() const {
+    return outputType_;
+  }
+
  private:
+  const RowTypePtr outputType_;
   const int32_t maxDrivers_;
   const int32_t numConcurrentSplitGroups_;
   const int32_t numSplitGroups_;
@@ -176,4 +182,11 @@ class RowCursor {
   vector_size_t numRows_ = 0;
 };
 
+/// Exports the results of 'cursor' as an ArrowArrayStream. The stream keeps
+/// 'cursor' alive. The arrays from the stream reference the memory of
+/// 'cursor' and must be released before the stream.
+void exportToArrow(
+    std::shared_ptr<TaskCursor> cursor,
+    ArrowArrayStream& arrowStream);
+
 } // namespace facebook::velox::exec::test
@@ -23,6 +23,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <limits>
 #include <optional>
 
 namespace facebook::velox::exec::test {
@@ -146,6 +147,25 @@ class MergeTestBase {
     return data;
   }
 
+  // Makes 'numRuns' sorted streams of the values 0 to 'numValues' - 1. The
+  // values are dealt to the streams in ranges of 'rangeSize' consecutive
+  // values, like rows of time partitioned data.
+  static TestData
+  makeRangeTestData(int32_t numValues, int32_t numRuns, int32_t rangeSize) {
+    TestData data;
+    data.data.reserve(numValues);
+    std::vector<std::vector<uint32_t>> runs(numRuns);
+    for (auto i = 0; i < numValues; ++i) {
+      data.data.push_back(i);
+      runs[(i / rangeSize) % numRuns].push_back(i);
+    }
+    for (auto& run : runs) {
+      std::reverse(run.begin(), run.end());
+      data.sources.push_back(std::make_unique<TestingStream>(std::move(run)));
+    }
+    return data;
+  }
+
   // Reads the data in 'testData.runs' using the merging class MergeType. Checks
   // that the results match the globally sorted data in 'testData' if check is
   // true.
@@ -175,6 +195,36 @@ class MergeTestBase {
     }
   }
 
+  // Like test() with TreeOfLosers but pops all the values of the winner up to
+  // the first value of the runner-up returned by nextWithRunnerUp() at once.
+  static void testRuns(const TestData& testData, bool check) {
+    std::vector<std::unique_ptr<TestingStream>> sources;
+    for (auto& source : testData.sources) {
+      sources.push_back(std::make_unique<TestingStream>(*source));
+    }
+    TreeOfLosers<TestingStream> merge(std::move(sources));
+    size_t numValues = 0;
+    for (;;) {
+      auto [source, runnerUp] = merge.nextWithRunnerUp();
+      if (!source) {
+        break;
+      }
+      const auto limit = runnerUp ? runnerUp->current()->value()
+                                  : std::numeric_limits<uint32_t>::max();
+      do {
+        if (check) {
+          ASSERT_LT(numValues, testData.data.size());
+          ASSERT_EQ(testData.data[numValues], source->current()->value());
+        }
+        ++numValues;
+        source->pop();
+      } while (source->hasData() && source->current()->value() <= limit);
+    }
+    if (check) {
+      ASSERT_EQ(testData.data.size(), numValues);
+    }
+  }
+
  protected:
   folly::Random::DefaultGenerator rng_;
 };
@@ -19,11 +19,13 @@
 #include <velox/type/Filter.h>
 #include "velox/common/memory/Memory.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/connectors/tpcds/TpcdsConnector.h"
 #include "velox/connectors/tpch/TpchConnector.h"
 #include "velox/duckdb/conversion/DuckParser.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/RoundRobinPartitionFunction.h"
+#include "velox/exec/WindowFunction.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 #include "velox/expression/SignatureBinder.h"
 #include "velox/parse/Expressions.h"
@@ -38,6 +40,7 @@ namespace {
 // TODO Avoid duplication.
 static const std::string kHiveConnectorId = "test-hive";
 static const std::string kTpchConnectorId = "test-tpch";
+static const std::string kTpcdsConnectorId = "test-tpcds";
 
 core::TypedExprPtr parseExpr(
     const std::string& text,
@@ -132,10 +135,66 @@ PlanBuilder& PlanBuilder::tableScan(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::pushdownAggregates(
+    const std::vector<std::string>& aggregates) {
+  auto scanNode =
+      std::dynamic_pointer_cast<const core::TableScanNode>(planNode_);
+  VELOX_CHECK_NOT_NULL(
+      scanNode, "Aggregates can only be pushed down into a TableScan");
+  VELOX_CHECK(scanNode->aggregates().empty(), "Aggregates already pushed down");
+  const auto& scanType = scanNode->outputType();
+
+  std::vector<connector::PushdownAggregate> pushdownAggregates;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (const auto& aggregate : aggregates) {
+    const auto open = aggregate.find('(');
+    VELOX_CHECK(
+        open != std::string::npos && aggregate.back() == ')',
+        "Bad aggregate: {}",
+        aggregate);
+    const auto name = aggregate.substr(0, open);
+    const auto argument =
+        aggregate.substr(open + 1, aggregate.size() - open - 2);
+
+    connector::PushdownAggregate pushdownAggregate;
+    if (name == "count") {
+      pushdownAggregate.kind = connector::PushdownAggregate::Kind::kCount;
+    } else if (name == "min") {
+      pushdownAggregate.kind = connector::PushdownAggregate::Kind::kMin;
+    } else if (name == "max") {
+      pushdownAggregate.kind = connector::PushdownAggregate::Kind::kMax;
+    } else {
+      VELOX_UNSUPPORTED("Aggregate cannot be pushed down: {}", aggregate);
+    }
+    if (argument == "1" || argument == "*") {
+      VELOX_CHECK(
+          name == "count", "Aggregate needs a column argument: {}", aggregate);
+      types.push_back(BIGINT());
+    } else {
+      pushdownAggregate.channel = scanType->getChildIdx(argument);
+      types.push_back(
+          name == "count" ? BIGINT()
+                          : scanType->childAt(*pushdownAggregate.channel));
+    }
+    names.push_back(fmt::format("a{}", names.size()));
+    pushdownAggregates.push_back(pushdownAggregate);
+  }
+  planNode_ = std::make_shared<core::TableScanNode>(
+      scanNode->id(),
+      ROW(std::move(names), std::move(types)),
+      scanNode->tableHandle(),
+      scanNode->assignments(),
+      scanType,
+      std::move(pushdownAggregates));
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::tableScan(
     tpch::Table table,
     std::vector<std::string>&& columnNames,
-    size_t scaleFactor) {
+    size_t scaleFactor,
+    const std::vector<std::string>& subfieldFilters) {
   std::unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
       assignmentsMap;
   std::vector<TypePtr> outputTypes;
@@ -149,11 +208,47 @@ PlanBuilder& PlanBuilder::tableScan(
         std::make_shared<connector::tpch::TpchColumnHandle>(columnName));
     outputTypes.emplace_back(resolveTpchColumn(table, columnName));
   }
+  connector::tpch::TpchColumnFilters filters;
+  for (const auto& filter : subfieldFilters) {
+    auto filterExpr = parseExpr(filter, tpch::getTableSchema(table), pool_);
+    auto [subfield, subfieldFilter] = exec::toSubfieldFilter(filterExpr);
+    VELOX_CHECK_EQ(
+        filters.count(subfield.toString()),
+        0,
+        "Duplicate subfield: {}",
+        subfield.toString());
+    filters[subfield.toString()] = std::move(subfieldFilter);
+  }
   auto rowType = ROW(std::move(columnNames), std::move(outputTypes));
   return tableScan(
       rowType,
       std::make_shared<connector::tpch::TpchTableHandle>(
-          kTpchConnectorId, table, scaleFactor),
+          kTpchConnectorId, table, scaleFactor, std::move(filters)),
+      assignmentsMap);
+}
+
+PlanBuilder& PlanBuilder::tableScan(
+    tpcds::Table table,
+    std::vector<std::string>&& columnNames,
+    size_t scaleFactor) {
+  std::unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
+      assignmentsMap;
+  std::vector<TypePtr> outputTypes;
+
+  assignmentsMap.reserve(columnNames.size());
+  outputTypes.reserve(columnNames.size());
+
+  for (const auto& columnName : columnNames) {
+    assignmentsMap.emplace(
+        columnName,
+        std::make_shared<connector::tpcds::TpcdsColumnHandle>(columnName));
+    outputTypes.emplace_back(resolveTpcdsColumn(table, columnName));
+  }
+  auto rowType = ROW(std::move(columnNames), std::move(outputTypes));
+  return tableScan(
+      rowType,
+      std::make_shared<connector::tpcds::TpcdsTableHandle>(
+          kTpcdsConnectorId, table, scaleFactor),
       assignmentsMap);
 }
 
@@ -272,6 +367,28 @@ PlanBuilder& PlanBuilder::tableWrite(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::sortedTableWrite(
+    const std::vector<std::string>& columnNames,
+    const std::vector<std::string>& sortingKeys,
+    const std::shared_ptr<core::InsertTableHandle>& insertHandle,
+    const std::string& rowCountColumnName) {
+  const auto& inputColumns = planNode_->outputType();
+  auto [keys, orders] = parseOrderByClauses(sortingKeys, inputColumns, pool_);
+  auto outputType =
+      ROW({rowCountColumnName, "fragments", "commitcontext"},
+          {BIGINT(), VARBINARY(), VARBINARY()});
+  planNode_ = std::make_shared<core::TableWriteNode>(
+      nextPlanNodeId(),
+      inputColumns,
+      columnNames,
+      insertHandle,
+      outputType,
+      planNode_,
+      keys,
+      orders);
+  return *this;
+}
+
 namespace {
 
 std::string throwAggregateFunctionDoesntExist(const std::string& name) {
@@ -515,15 +632,19 @@ PlanBuilder::createAggregateExpressionsAndNames(
   AggregateTypeResolver resolver(step);
   std::vector<std::shared_ptr<const core::CallTypedExpr>> exprs;
   std::vector<std::string> names;
+  std::vector<bool> distincts;
   exprs.reserve(aggregates.size());
   names.reserve(aggregates.size());
+  distincts.reserve(aggregates.size());
   for (auto i = 0; i < aggregates.size(); i++) {
     auto& agg = aggregates[i];
     if (i < resultTypes.size()) {
       resolver.setResultType(resultTypes[i]);
     }
 
-    auto untypedExpr = duckdb::parseExpr(agg);
+    auto aggregateExpr = duckdb::parseAggregateExpr(agg);
+    auto& untypedExpr = aggregateExpr.expr;
+    distincts.push_back(aggregateExpr.distinct);
 
     auto expr = std::dynamic_pointer_cast<const core::CallTypedExpr>(
         inferTypes(untypedExpr));
@@ -535,8 +656,13 @@ PlanBuilder::createAggregateExpressionsAndNames(
       names.push_back(fmt::format("a{}", i));
     }
   }
+  if (std::none_of(distincts.begin(), distincts.end(), [](bool distinct) {
+        return distinct;
+      })) {
+    distincts.clear();
+  }
 
-  return {exprs, names};
+  return {exprs, names, distincts};
 }
 
 std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>
@@ -578,6 +704,7 @@ PlanBuilder& PlanBuilder::aggregation(
       aggregatesAndNames.names,
       aggregatesAndNames.aggregates,
       createAggregateMasks(numAggregates, masks),
+      aggregatesAndNames.distincts,
       ignoreNullKeys,
       planNode_);
   return *this;
@@ -601,6 +728,7 @@ PlanBuilder& PlanBuilder::streamingAggregation(
       aggregatesAndNames.names,
       aggregatesAndNames.aggregates,
       createAggregateMasks(numAggregates, masks),
+      aggregatesAndNames.distincts,
       ignoreNullKeys,
       planNode_);
   return *this;
@@ -679,6 +807,103 @@ PlanBuilder& PlanBuilder::topN(
   return *this;
 }
 
+namespace {
+class WindowTypeResolver {
+ public:
+  WindowTypeResolver()
+      : previousHook_(core::Expressions::getResolverHook()) {
+    core::Expressions::setTypeResolverHook(
+        [&](const auto& inputs, const auto& expr, bool nullOnFailure) {
+          return resolveType(inputs, expr, nullOnFailure);
+        });
+  }
+
+  ~WindowTypeResolver() {
+    core::Expressions::setTypeResolverHook(previousHook_);
+  }
+
+ private:
+  TypePtr resolveType(
+      const std::vector<core::TypedExprPtr>& inputs,
+      const std::shared_ptr<const core::CallExpr>& expr,
+      bool nullOnFailure) const {
+    std::vector<TypePtr> types;
+    for (auto& input : inputs) {
+      types.push_back(input->type());
+    }
+
+    auto functionName = expr->getFunctionName();
+    if (auto type = exec::resolveWindowFunction(functionName, types)) {
+      return type;
+    }
+
+    if (!nullOnFailure) {
+      VELOX_USER_FAIL(
+          "Cannot resolve window function return type: {}", functionName);
+    }
+    return nullptr;
+  }
+
+  const core::Expressions::TypeResolverHook previousHook_;
+};
+} // namespace
+
+PlanBuilder& PlanBuilder::window(
+    const std::vector<std::string>& partitionKeys,
+    const std::vector<std::string>& sortingKeys,
+    const std::vector<std::string>& windowFunctions) {
+  return window(
+      partitionKeys,
+      sortingKeys,
+      windowFunctions,
+      {core::WindowNode::WindowType::kRange,
+       core::WindowNode::BoundType::kUnboundedPreceding,
+       nullptr,
+       core::WindowNode::BoundType::kCurrentRow,
+       nullptr});
+}
+
+PlanBuilder& PlanBuilder::window(
+    const std::vector<std::string>& partitionKeys,
+    const std::vector<std::string>& sortingKeys,
+    const std::vector<std::string>& windowFunctions,
+    const core::WindowNode::Frame& frame) {
+  auto [sortingKeyExprs, sortingOrders] =
+      parseOrderByClauses(sortingKeys, planNode_->outputType(), pool_);
+
+  WindowTypeResolver resolver;
+  std::vector<core::WindowNode::Function> functions;
+  std::vector<std::string> names;
+  functions.reserve(windowFunctions.size());
+  names.reserve(windowFunctions.size());
+  for (auto i = 0; i < windowFunctions.size(); ++i) {
+    auto untypedExpr = duckdb::parseExpr(windowFunctions[i]);
+    auto callExpr = std::dynamic_pointer_cast<const core::CallTypedExpr>(
+        inferTypes(untypedExpr));
+    VELOX_CHECK_NOT_NULL(
+        callExpr,
+        "Window function must be a function call: {}",
+        windowFunctions[i]);
+    functions.push_back({callExpr, frame, false});
+
+    if (untypedExpr->alias().has_value()) {
+      names.push_back(untypedExpr->alias().value());
+    } else {
+      names.push_back(fmt::format("w{}", i));
+    }
+  }
+
+  planNode_ = std::make_shared<core::WindowNode>(
+      nextPlanNodeId(),
+      fields(partitionKeys),
+      sortingKeyExprs,
+      sortingOrders,
+      std::move(names),
+      std::move(functions),
+      planNode_);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::limit(int32_t offset, int32_t count, bool isPartial) {
   planNode_ = std::make_shared<core::LimitNode>(
       nextPlanNodeId(), offset, count, isPartial, planNode_);
@@ -847,6 +1072,33 @@ PlanBuilder& PlanBuilder::partitionedOutput(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::partitionedOutput(
+    const std::vector<std::string>& keys,
+    int numPartitions,
+    core::PartitionedOutputNode::SkewMode skewMode,
+    std::vector<uint64_t> hotKeyHashes,
+    core::JoinType skewedJoinType,
+    const std::vector<std::string>& outputLayout) {
+  auto outputType = outputLayout.empty()
+      ? planNode_->outputType()
+      : extract(planNode_->outputType(), outputLayout);
+  auto partitionFunctionFactory =
+      createPartitionFunctionFactory(planNode_->outputType(), keys);
+  planNode_ = std::make_shared<core::PartitionedOutputNode>(
+      nextPlanNodeId(),
+      exprs(keys),
+      numPartitions,
+      false,
+      false,
+      std::move(partitionFunctionFactory),
+      outputType,
+      planNode_,
+      skewMode,
+      std::move(hotKeyHashes),
+      skewedJoinType);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::partitionedOutputBroadcast(
     const std::vector<std::string>& outputLayout) {
   auto outputType = outputLayout.empty()
@@ -963,12 +1215,50 @@ PlanBuilder& PlanBuilder::mergeJoin(
 
 PlanBuilder& PlanBuilder::crossJoin(
     const core::PlanNodePtr& right,
-    const std::vector<std::string>& outputLayout) {
+    const std::vector<std::string>& outputLayout,
+    const std::string& filter) {
   auto resultType = concat(planNode_->outputType(), right->outputType());
   auto outputType = extract(resultType, outputLayout);
 
+  core::TypedExprPtr filterExpr;
+  if (!filter.empty()) {
+    filterExpr = parseExpr(filter, resultType, pool_);
+  }
+
   planNode_ = std::make_shared<core::CrossJoinNode>(
-      nextPlanNodeId(), std::move(planNode_), right, outputType);
+      nextPlanNodeId(),
+      std::move(planNode_),
+      right,
+      outputType,
+      std::move(filterExpr));
+  return *this;
+}
+
+PlanBuilder& PlanBuilder::rangeJoin(
+    const std::string& probeKey,
+    const std::string& lowerKey,
+    const std::string& upperKey,
+    const core::PlanNodePtr& build,
+    const std::string& filter,
+    const std::vector<std::string>& outputLayout) {
+  auto leftType = planNode_->outputType();
+  auto rightType = build->outputType();
+  auto resultType = concat(leftType, rightType);
+  core::TypedExprPtr filterExpr;
+  if (!filter.empty()) {
+    filterExpr = parseExpr(filter, resultType, pool_);
+  }
+  auto outputType = extract(resultType, outputLayout);
+
+  planNode_ = std::make_shared<core::RangeJoinNode>(
+      nextPlanNodeId(),
+      field(leftType, probeKey),
+      field(rightType, lowerKey),
+      field(rightType, upperKey),
+      std::move(filterExpr),
+      std::move(planNode_),
+      build,
+      outputType);
   return *this;
 }
 
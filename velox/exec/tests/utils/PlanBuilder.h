@@ -28,6 +28,10 @@ namespace facebook::velox::tpch {
 enum class Table : uint8_t;
 }
 
+namespace facebook::velox::tpcds {
+enum class Table : uint8_t;
+}
+
 namespace facebook::velox::exec::test {
 
 /// Generates unique sequential plan node IDs starting with zero or specified
@@ -161,15 +165,37 @@ class PlanBuilder {
           std::string,
           std::shared_ptr<connector::ColumnHandle>>& assignments);
 
+  /// Replaces the TableScanNode at the top of the plan with one that
+  /// returns a row per split with the partial results of 'aggregates' over
+  /// the scanned columns, e.g. {"count(1)", "min(c0)", "max(c1)"}. Supports
+  /// count(1), count, min and max. The output columns are named a0, a1,...
+  /// Follow with a final aggregation to combine the rows of the splits.
+  PlanBuilder& pushdownAggregates(const std::vector<std::string>& aggregates);
+
   /// Add a TableScanNode to scan a TPC-H table.
   ///
   /// @param tpchTableHandle The handle that specifies the target TPC-H table
   /// and scale factor.
   /// @param columnNames The columns to be returned from that table.
   /// @param scaleFactor The TPC-H scale factor.
+  /// @param subfieldFilters Filters on columns of the table, e.g.
+  /// "l_shipdate < '1995-01-01'::DATE" or "n_regionkey = 1". The columns
+  /// need not be in 'columnNames'. The rows that fail the filters are dropped
+  /// by the connector.
   PlanBuilder& tableScan(
       tpch::Table table,
       std::vector<std::string>&& columnNames,
+      size_t scaleFactor = 1,
+      const std::vector<std::string>& subfieldFilters = {});
+
+  /// Add a TableScanNode to scan a TPC-DS table.
+  ///
+  /// @param table The target TPC-DS table.
+  /// @param columnNames The columns to be returned from that table.
+  /// @param scaleFactor The TPC-DS scale factor.
+  PlanBuilder& tableScan(
+      tpcds::Table table,
+      std::vector<std::string>&& columnNames,
       size_t scaleFactor = 1);
 
   /// Add a ValuesNode using specified data.
@@ -255,6 +281,21 @@ class PlanBuilder {
       const std::shared_ptr<core::InsertTableHandle>& insertHandle,
       const std::string& rowCountColumnName = "rowCount");
 
+  /// Add a TableWriteNode that sorts the rows before writing them. Input
+  /// column names must match column names in the target table.
+  ///
+  /// @param columnNames A subset of input columns to write.
+  /// @param sortingKeys ORDER BY clauses over 'columnNames', e.g. {"a", "b
+  /// DESC NULLS FIRST"}.
+  /// @param insertHandle Connector-specific table handle.
+  /// @param rowCountColumnName The name of the output column containing the
+  /// number of rows written.
+  PlanBuilder& sortedTableWrite(
+      const std::vector<std::string>& columnNames,
+      const std::vector<std::string>& sortingKeys,
+      const std::shared_ptr<core::InsertTableHandle>& insertHandle,
+      const std::string& rowCountColumnName = "rowCount");
+
   /// Add an AggregationNode representing partial aggregation with the
   /// specified grouping keys, aggregates and optional masks.
   ///
@@ -273,6 +314,8 @@ class PlanBuilder {
   ///
   /// will produce output columns k1, k2, min_a and a1, assuming the names of
   /// the first two input columns are k1 and k2.
+  ///
+  /// Single aggregations may have DISTINCT aggregates, e.g. count(DISTINCT a).
   PlanBuilder& partialAggregation(
       const std::vector<std::string>& groupingKeys,
       const std::vector<std::string>& aggregates,
@@ -478,6 +521,28 @@ class PlanBuilder {
   PlanBuilder&
   topN(const std::vector<std::string>& keys, int32_t count, bool isPartial);
 
+  /// Add a WindowNode using specified PARTITION BY keys, ORDER BY clauses
+  /// and window function calls. All window functions use the default frame:
+  /// RANGE BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW.
+  ///
+  /// For example,
+  ///
+  ///     .window({"a"}, {"b DESC"}, {"row_number() as rn", "sum(c) as s"})
+  ///
+  /// Window functions without an alias are named w0, w1, etc. Aggregate
+  /// functions can be used as window functions.
+  PlanBuilder& window(
+      const std::vector<std::string>& partitionKeys,
+      const std::vector<std::string>& sortingKeys,
+      const std::vector<std::string>& windowFunctions);
+
+  /// Same as above, but uses the specified frame for all window functions.
+  PlanBuilder& window(
+      const std::vector<std::string>& partitionKeys,
+      const std::vector<std::string>& sortingKeys,
+      const std::vector<std::string>& windowFunctions,
+      const core::WindowNode::Frame& frame);
+
   /// Add a LimitNode.
   ///
   /// @param offset Offset, i.e. number of rows of input to skip.
@@ -531,6 +596,18 @@ class PlanBuilder {
       int numPartitions,
       const std::vector<std::string>& outputLayout = {});
 
+  /// Same as above, but routes the rows whose keys hash to one of
+  /// 'hotKeyHashes' according to 'skewMode'. See
+  /// exec::PartitionedOutput::hashKeys() for the hashes. 'skewedJoinType' is
+  /// the type of the join that consumes the output.
+  PlanBuilder& partitionedOutput(
+      const std::vector<std::string>& keys,
+      int numPartitions,
+      core::PartitionedOutputNode::SkewMode skewMode,
+      std::vector<uint64_t> hotKeyHashes,
+      core::JoinType skewedJoinType = core::JoinType::kInner,
+      const std::vector<std::string>& outputLayout = {});
+
   /// Add a PartitionedOutputNode to broadcast the input data.
   ///
   /// @param outputLayout Optional output layout in case it is different then
@@ -622,8 +699,30 @@ class PlanBuilder {
   /// smaller input is placed on the right-side.
   /// @param outputLayout Output layout consisting of columns from left and
   /// right sides.
+  /// @param filter Optional SQL expression over the columns of both sides.
+  /// Only the pairs of rows that pass it are returned.
   PlanBuilder& crossJoin(
       const core::PlanNodePtr& right,
+      const std::vector<std::string>& outputLayout,
+      const std::string& filter = "");
+
+  /// Add a RangeJoinNode to join the preceding plan node with 'build' on
+  /// 'lowerKey <= probeKey <= upperKey'.
+  ///
+  /// @param probeKey Column of the left side.
+  /// @param lowerKey Column of 'build' with the inclusive lower bound.
+  /// @param upperKey Column of 'build' with the inclusive upper bound.
+  /// @param build Right-side input with the ranges.
+  /// @param filter Optional SQL expression for the additional join filter.
+  /// Can use columns from both probe and build sides of the join.
+  /// @param outputLayout Output layout consisting of columns from probe and
+  /// build sides.
+  PlanBuilder& rangeJoin(
+      const std::string& probeKey,
+      const std::string& lowerKey,
+      const std::string& upperKey,
+      const core::PlanNodePtr& build,
+      const std::string& filter,
       const std::vector<std::string>& outputLayout);
 
   /// Add an UnnestNode to unnest one or more columns of type array or map.
@@ -720,6 +819,8 @@ class PlanBuilder {
   struct AggregateExpressionsAndNames {
     std::vector<std::shared_ptr<const core::CallTypedExpr>> aggregates;
     std::vector<std::string> names;
+    // Empty if no aggregate is DISTINCT.
+    std::vector<bool> distincts;
   };
 
   AggregateExpressionsAndNames createAggregateExpressionsAndNames(
@@ -54,6 +54,17 @@ std::string formatDateFilter(
   VELOX_FAIL(
       "Date range check expression must have either a lower or an upper bound");
 }
+
+/// DWRF does not support Date type and Varchar is used.
+/// Return the expression for the year of the date as per data format.
+std::string formatYear(
+    const std::string& stringDate,
+    const RowTypePtr& rowType) {
+  if (rowType->findChild(stringDate)->isVarchar()) {
+    return fmt::format("cast(substr({}, 1, 4) as integer)", stringDate);
+  }
+  return fmt::format("year({})", stringDate);
+}
 } // namespace
 
 void TpchQueryBuilder::initialize(const std::string& dataPath) {
@@ -109,18 +120,48 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
   switch (queryId) {
     case 1:
       return getQ1Plan();
+    case 2:
+      return getQ2Plan();
     case 3:
       return getQ3Plan();
+    case 4:
+      return getQ4Plan();
     case 5:
       return getQ5Plan();
     case 6:
       return getQ6Plan();
+    case 7:
+      return getQ7Plan();
+    case 8:
+      return getQ8Plan();
+    case 9:
+      return getQ9Plan();
     case 10:
       return getQ10Plan();
+    case 11:
+      return getQ11Plan();
+    case 12:
+      return getQ12Plan();
     case 13:
       return getQ13Plan();
+    case 14:
+      return getQ14Plan();
+    case 15:
+      return getQ15Plan();
+    case 16:
+      return getQ16Plan();
+    case 17:
+      return getQ17Plan();
     case 18:
       return getQ18Plan();
+    case 19:
+      return getQ19Plan();
+    case 20:
+      return getQ20Plan();
+    case 21:
+      return getQ21Plan();
+    case 22:
+      return getQ22Plan();
     default:
       VELOX_NYI("TPC-H query {} is not supported yet", queryId);
   }
@@ -179,6 +220,171 @@ TpchPlan TpchQueryBuilder::getQ1Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ2Plan() const {
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_mfgr", "p_type", "p_size"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_supplycost"};
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey",
+      "s_name",
+      "s_address",
+      "s_nationkey",
+      "s_phone",
+      "s_acctbal",
+      "s_comment"};
+  std::vector<std::string> nationColumns = {
+      "n_nationkey", "n_name", "n_regionkey"};
+  std::vector<std::string> regionColumns = {"r_regionkey", "r_name"};
+
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  const auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  const auto regionSelectedRowType = getRowType(kRegion, regionColumns);
+  const auto& regionFileColumns = getFileColumnNames(kRegion);
+
+  const auto regionNameFilter = "r_name = 'EUROPE'";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId regionScanNodeId;
+  core::PlanNodeId minCostPartsuppScanNodeId;
+  core::PlanNodeId minCostSupplierScanNodeId;
+  core::PlanNodeId minCostNationScanNodeId;
+  core::PlanNodeId minCostRegionScanNodeId;
+
+  // Suppliers in the region, with their nation names.
+  auto europeanSuppliers =
+      [&](const std::vector<std::string>& outputLayout,
+          core::PlanNodeId& supplierScanId,
+          core::PlanNodeId& nationScanId,
+          core::PlanNodeId& regionScanId) {
+        auto region = PlanBuilder(planNodeIdGenerator)
+                          .tableScan(
+                              kRegion,
+                              regionSelectedRowType,
+                              regionFileColumns,
+                              {regionNameFilter})
+                          .capturePlanNodeId(regionScanId)
+                          .planNode();
+        auto nation =
+            PlanBuilder(planNodeIdGenerator)
+                .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+                .capturePlanNodeId(nationScanId)
+                .hashJoin(
+                    {"n_regionkey"},
+                    {"r_regionkey"},
+                    region,
+                    "",
+                    {"n_nationkey", "n_name"})
+                .planNode();
+        return PlanBuilder(planNodeIdGenerator)
+            .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+            .capturePlanNodeId(supplierScanId)
+            .hashJoin(
+                {"s_nationkey"}, {"n_nationkey"}, nation, "", outputLayout)
+            .planNode();
+      };
+
+  // The minimum supply cost of each part among the suppliers in the region.
+  auto minCost =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(minCostPartsuppScanNodeId)
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              europeanSuppliers(
+                  {"s_suppkey"},
+                  minCostSupplierScanNodeId,
+                  minCostNationScanNodeId,
+                  minCostRegionScanNodeId),
+              "",
+              {"ps_partkey", "ps_supplycost"})
+          .partialAggregation(
+              {"ps_partkey"}, {"min(ps_supplycost) AS min_supplycost"})
+          .localPartition({"ps_partkey"})
+          .finalAggregation()
+          .project({"ps_partkey AS min_partkey", "min_supplycost"})
+          .planNode();
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {"p_size = 15"},
+                      "p_type like '%BRASS'")
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"p_partkey", "p_mfgr", "ps_suppkey", "ps_supplycost"})
+          .hashJoin(
+              {"p_partkey"},
+              {"min_partkey"},
+              minCost,
+              "ps_supplycost = min_supplycost",
+              {"p_partkey", "p_mfgr", "ps_suppkey"})
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              europeanSuppliers(
+                  {"s_suppkey",
+                   "s_name",
+                   "s_address",
+                   "s_phone",
+                   "s_acctbal",
+                   "s_comment",
+                   "n_name"},
+                  supplierScanNodeId,
+                  nationScanNodeId,
+                  regionScanNodeId),
+              "",
+              {"s_acctbal",
+               "s_name",
+               "n_name",
+               "p_partkey",
+               "p_mfgr",
+               "s_address",
+               "s_phone",
+               "s_comment"})
+          .localPartition({})
+          .orderBy({"s_acctbal DESC", "n_name", "s_name", "p_partkey"}, false)
+          .limit(0, 100, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[regionScanNodeId] = getTableFilePaths(kRegion);
+  context.dataFiles[minCostPartsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[minCostSupplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[minCostNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[minCostRegionScanNodeId] = getTableFilePaths(kRegion);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ3Plan() const {
   std::vector<std::string> lineitemColumns = {
       "l_shipdate", "l_orderkey", "l_extendedprice", "l_discount"};
@@ -267,6 +473,64 @@ TpchPlan TpchQueryBuilder::getQ3Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ4Plan() const {
+  std::vector<std::string> ordersColumns = {
+      "o_orderkey", "o_orderdate", "o_orderpriority"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_commitdate", "l_receiptdate"};
+
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const auto orderDate = "o_orderdate";
+  auto orderDateFilter = formatDateFilter(
+      orderDate, ordersSelectedRowType, "'1993-07-01'", "'1993-09-30'");
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+
+  auto lateLineitems = PlanBuilder(planNodeIdGenerator)
+                           .tableScan(
+                               kLineitem,
+                               lineitemSelectedRowType,
+                               lineitemFileColumns,
+                               {},
+                               "l_commitdate < l_receiptdate")
+                           .capturePlanNodeId(lineitemScanNodeId)
+                           .planNode();
+
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kOrders,
+                      ordersSelectedRowType,
+                      ordersFileColumns,
+                      {orderDateFilter})
+                  .capturePlanNodeId(ordersScanNodeId)
+                  .hashJoin(
+                      {"o_orderkey"},
+                      {"l_orderkey"},
+                      lateLineitems,
+                      "",
+                      {"o_orderpriority"},
+                      core::JoinType::kLeftSemi)
+                  .partialAggregation(
+                      {"o_orderpriority"}, {"count(0) AS order_count"})
+                  .localPartition({})
+                  .finalAggregation()
+                  .orderBy({"o_orderpriority"}, false)
+                  .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ5Plan() const {
   std::vector<std::string> customerColumns = {"c_custkey", "c_nationkey"};
   std::vector<std::string> ordersColumns = {
@@ -430,184 +694,1088 @@ TpchPlan TpchQueryBuilder::getQ6Plan() const {
   return context;
 }
 
-TpchPlan TpchQueryBuilder::getQ10Plan() const {
-  std::vector<std::string> customerColumns = {
-      "c_nationkey",
-      "c_custkey",
-      "c_acctbal",
-      "c_name",
-      "c_address",
-      "c_phone",
-      "c_comment"};
-  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+TpchPlan TpchQueryBuilder::getQ7Plan() const {
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
   std::vector<std::string> lineitemColumns = {
-      "l_orderkey", "l_returnflag", "l_extendedprice", "l_discount"};
-  std::vector<std::string> ordersColumns = {
-      "o_orderdate", "o_orderkey", "o_custkey"};
+      "l_orderkey", "l_suppkey", "l_extendedprice", "l_discount", "l_shipdate"};
+  std::vector<std::string> ordersColumns = {"o_orderkey", "o_custkey"};
+  std::vector<std::string> customerColumns = {"c_custkey", "c_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
 
-  const auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
-  const auto& customerFileColumns = getFileColumnNames(kCustomer);
-  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
-  const auto& nationFileColumns = getFileColumnNames(kNation);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
   const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
   const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
   const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
   const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  const auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
+  const auto& customerFileColumns = getFileColumnNames(kCustomer);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
 
-  const auto lineitemReturnFlagFilter = "l_returnflag = 'R'";
-  const auto orderDate = "o_orderdate";
-  auto orderDateFilter = formatDateFilter(
-      orderDate, ordersSelectedRowType, "'1993-10-01'", "'1993-12-31'");
-
-  std::vector<std::string> customerOutputColumns = {
-      "c_name", "c_acctbal", "c_phone", "c_address", "c_custkey", "c_comment"};
-
-  auto mergeColumnNames = [](std::vector<std::string>& v1,
-                             const std::vector<std::string>& v2) {
-    v1.insert(v1.end(), v2.begin(), v2.end());
-    return v1;
-  };
+  const auto nationNameFilter = "n_name in ('FRANCE', 'GERMANY')";
+  const auto shipDate = "l_shipdate";
+  auto shipDateFilter = formatDateFilter(
+      shipDate, lineitemSelectedRowType, "'1995-01-01'", "'1996-12-31'");
 
   auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
-  core::PlanNodeId customerScanNodeId;
-  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
   core::PlanNodeId lineitemScanNodeId;
   core::PlanNodeId ordersScanNodeId;
-
-  auto nation =
+  core::PlanNodeId customerScanNodeId;
+  core::PlanNodeId supplierNationScanNodeId;
+  core::PlanNodeId customerNationScanNodeId;
+
+  auto supplierNation = PlanBuilder(planNodeIdGenerator)
+                            .tableScan(
+                                kNation,
+                                nationSelectedRowType,
+                                nationFileColumns,
+                                {nationNameFilter})
+                            .capturePlanNodeId(supplierNationScanNodeId)
+                            .planNode();
+
+  auto suppliers =
       PlanBuilder(planNodeIdGenerator)
-          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
-          .capturePlanNodeId(nationScanNodeId)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              supplierNation,
+              "",
+              {"s_suppkey", "n_name"})
+          .project({"s_suppkey", "n_name AS supp_nation"})
           .planNode();
 
-  auto orders = PlanBuilder(planNodeIdGenerator)
-                    .tableScan(
-                        kOrders,
-                        ordersSelectedRowType,
-                        ordersFileColumns,
-                        {orderDateFilter})
-                    .capturePlanNodeId(ordersScanNodeId)
-                    .planNode();
+  auto customerNation = PlanBuilder(planNodeIdGenerator)
+                            .tableScan(
+                                kNation,
+                                nationSelectedRowType,
+                                nationFileColumns,
+                                {nationNameFilter})
+                            .capturePlanNodeId(customerNationScanNodeId)
+                            .planNode();
 
-  auto partialPlan =
+  auto customers =
       PlanBuilder(planNodeIdGenerator)
           .tableScan(kCustomer, customerSelectedRowType, customerFileColumns)
           .capturePlanNodeId(customerScanNodeId)
-          .hashJoin(
-              {"c_custkey"},
-              {"o_custkey"},
-              orders,
-              "",
-              mergeColumnNames(
-                  customerOutputColumns, {"c_nationkey", "o_orderkey"}))
           .hashJoin(
               {"c_nationkey"},
               {"n_nationkey"},
-              nation,
+              customerNation,
               "",
-              mergeColumnNames(customerOutputColumns, {"n_name", "o_orderkey"}))
+              {"c_custkey", "n_name"})
+          .project({"c_custkey", "n_name AS cust_nation"})
           .planNode();
 
-  auto plan = PlanBuilder(planNodeIdGenerator)
-                  .tableScan(
-                      kLineitem,
-                      lineitemSelectedRowType,
-                      lineitemFileColumns,
-                      {lineitemReturnFlagFilter})
-                  .capturePlanNodeId(lineitemScanNodeId)
-                  .project(
-                      {"l_extendedprice * (1.0 - l_discount) AS part_revenue",
-                       "l_orderkey"})
-                  .hashJoin(
-                      {"l_orderkey"},
-                      {"o_orderkey"},
-                      partialPlan,
-                      "",
-                      mergeColumnNames(
-                          customerOutputColumns, {"part_revenue", "n_name"}))
-                  .partialAggregation(
-                      {"c_custkey",
-                       "c_name",
-                       "c_acctbal",
-                       "n_name",
-                       "c_address",
-                       "c_phone",
-                       "c_comment"},
-                      {"sum(part_revenue) as revenue"})
-                  .localPartition({})
-                  .finalAggregation()
-                  .orderBy({"revenue DESC"}, false)
-                  .project(
-                      {"c_custkey",
-                       "c_name",
-                       "revenue",
-                       "c_acctbal",
-                       "n_name",
-                       "c_address",
-                       "c_phone",
-                       "c_comment"})
-                  .limit(0, 20, false)
-                  .planNode();
+  auto orders =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kOrders, ordersSelectedRowType, ordersFileColumns)
+          .capturePlanNodeId(ordersScanNodeId)
+          .hashJoin(
+              {"o_custkey"},
+              {"c_custkey"},
+              customers,
+              "",
+              {"o_orderkey", "cust_nation"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipDateFilter})
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_suppkey"},
+              {"s_suppkey"},
+              suppliers,
+              "",
+              {"l_orderkey",
+               "l_extendedprice",
+               "l_discount",
+               "l_shipdate",
+               "supp_nation"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"o_orderkey"},
+              orders,
+              "(supp_nation = 'FRANCE' AND cust_nation = 'GERMANY') OR "
+              "(supp_nation = 'GERMANY' AND cust_nation = 'FRANCE')",
+              {"supp_nation",
+               "cust_nation",
+               "l_extendedprice",
+               "l_discount",
+               "l_shipdate"})
+          .project(
+              {"supp_nation",
+               "cust_nation",
+               formatYear(shipDate, lineitemSelectedRowType) + " AS l_year",
+               "l_extendedprice * (1.0 - l_discount) AS volume"})
+          .partialAggregation(
+              {"supp_nation", "cust_nation", "l_year"},
+              {"sum(volume) AS revenue"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy({"supp_nation", "cust_nation", "l_year"}, false)
+          .planNode();
 
   TpchPlan context;
   context.plan = std::move(plan);
-  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
-  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
   context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
   context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFiles[supplierNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[customerNationScanNodeId] = getTableFilePaths(kNation);
   context.dataFileFormat = format_;
   return context;
 }
 
-TpchPlan TpchQueryBuilder::getQ13Plan() const {
+TpchPlan TpchQueryBuilder::getQ8Plan() const {
+  std::vector<std::string> partColumns = {"p_partkey", "p_type"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_partkey", "l_suppkey", "l_extendedprice", "l_discount"};
   std::vector<std::string> ordersColumns = {
-      "o_custkey", "o_comment", "o_orderkey"};
-  std::vector<std::string> customerColumns = {"c_custkey"};
+      "o_orderkey", "o_custkey", "o_orderdate"};
+  std::vector<std::string> customerColumns = {"c_custkey", "c_nationkey"};
+  std::vector<std::string> nationColumns = {
+      "n_nationkey", "n_name", "n_regionkey"};
+  std::vector<std::string> regionColumns = {"r_regionkey", "r_name"};
 
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
   const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
   const auto& ordersFileColumns = getFileColumnNames(kOrders);
-
   const auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
   const auto& customerFileColumns = getFileColumnNames(kCustomer);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  const auto regionSelectedRowType = getRowType(kRegion, regionColumns);
+  const auto& regionFileColumns = getFileColumnNames(kRegion);
+
+  const auto partTypeFilter = "p_type = 'ECONOMY ANODIZED STEEL'";
+  const auto regionNameFilter = "r_name = 'AMERICA'";
+  const auto orderDate = "o_orderdate";
+  auto orderDateFilter = formatDateFilter(
+      orderDate, ordersSelectedRowType, "'1995-01-01'", "'1996-12-31'");
 
   auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
-  core::PlanNodeId customerScanNodeId;
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
   core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId customerScanNodeId;
+  core::PlanNodeId customerNationScanNodeId;
+  core::PlanNodeId supplierNationScanNodeId;
+  core::PlanNodeId regionScanNodeId;
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {partTypeFilter})
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto region = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kRegion,
+                        regionSelectedRowType,
+                        regionFileColumns,
+                        {regionNameFilter})
+                    .capturePlanNodeId(regionScanNodeId)
+                    .planNode();
+
+  auto customerNation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(customerNationScanNodeId)
+          .hashJoin(
+              {"n_regionkey"}, {"r_regionkey"}, region, "", {"n_nationkey"})
+          .planNode();
+
+  auto customers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kCustomer, customerSelectedRowType, customerFileColumns)
+          .capturePlanNodeId(customerScanNodeId)
+          .hashJoin(
+              {"c_nationkey"},
+              {"n_nationkey"},
+              customerNation,
+              "",
+              {"c_custkey"})
+          .planNode();
+
+  auto orders = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kOrders,
+                        ordersSelectedRowType,
+                        ordersFileColumns,
+                        {orderDateFilter})
+                    .capturePlanNodeId(ordersScanNodeId)
+                    .hashJoin(
+                        {"o_custkey"},
+                        {"c_custkey"},
+                        customers,
+                        "",
+                        {"o_orderkey", "o_orderdate"})
+                    .planNode();
+
+  auto supplierNation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(supplierNationScanNodeId)
+          .planNode();
+
+  auto suppliers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              supplierNation,
+              "",
+              {"s_suppkey", "n_name"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"l_orderkey", "l_suppkey", "l_extendedprice", "l_discount"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"o_orderkey"},
+              orders,
+              "",
+              {"l_suppkey", "l_extendedprice", "l_discount", "o_orderdate"})
+          .hashJoin(
+              {"l_suppkey"},
+              {"s_suppkey"},
+              suppliers,
+              "",
+              {"l_extendedprice", "l_discount", "o_orderdate", "n_name"})
+          .project(
+              {formatYear(orderDate, ordersSelectedRowType) + " AS o_year",
+               "l_extendedprice * (1.0 - l_discount) AS volume",
+               "if(n_name = 'BRAZIL', l_extendedprice * (1.0 - l_discount), "
+               "0.0) AS brazil_volume"})
+          .partialAggregation(
+              {"o_year"},
+              {"sum(brazil_volume) AS total_brazil_volume",
+               "sum(volume) AS total_volume"})
+          .localPartition({})
+          .finalAggregation()
+          .project(
+              {"o_year", "total_brazil_volume / total_volume AS mkt_share"})
+          .orderBy({"o_year"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFiles[customerNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[supplierNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[regionScanNodeId] = getTableFilePaths(kRegion);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ9Plan() const {
+  std::vector<std::string> partColumns = {"p_partkey", "p_name"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey",
+      "l_partkey",
+      "l_suppkey",
+      "l_quantity",
+      "l_extendedprice",
+      "l_discount"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_supplycost"};
+  std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderdate"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  const auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+
+  const auto orderDate = "o_orderdate";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {},
+                      "p_name like '%green%'")
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto greenPartsupp =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"ps_partkey", "ps_suppkey", "ps_supplycost"})
+          .planNode();
+
+  auto nation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(nationScanNodeId)
+          .planNode();
+
+  auto suppliers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              nation,
+              "",
+              {"s_suppkey", "n_name"})
+          .planNode();
+
+  auto orders =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kOrders, ordersSelectedRowType, ordersFileColumns)
+          .capturePlanNodeId(ordersScanNodeId)
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_partkey", "l_suppkey"},
+              {"ps_partkey", "ps_suppkey"},
+              greenPartsupp,
+              "",
+              {"l_orderkey",
+               "l_suppkey",
+               "l_quantity",
+               "l_extendedprice",
+               "l_discount",
+               "ps_supplycost"})
+          .hashJoin(
+              {"l_suppkey"},
+              {"s_suppkey"},
+              suppliers,
+              "",
+              {"l_orderkey",
+               "l_quantity",
+               "l_extendedprice",
+               "l_discount",
+               "ps_supplycost",
+               "n_name"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"o_orderkey"},
+              orders,
+              "",
+              {"l_quantity",
+               "l_extendedprice",
+               "l_discount",
+               "ps_supplycost",
+               "n_name",
+               "o_orderdate"})
+          .project(
+              {"n_name AS nation",
+               formatYear(orderDate, ordersSelectedRowType) + " AS o_year",
+               "l_extendedprice * (1.0 - l_discount) - "
+               "ps_supplycost * l_quantity AS amount"})
+          .partialAggregation(
+              {"nation", "o_year"}, {"sum(amount) AS sum_profit"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy({"nation", "o_year DESC"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ10Plan() const {
+  std::vector<std::string> customerColumns = {
+      "c_nationkey",
+      "c_custkey",
+      "c_acctbal",
+      "c_name",
+      "c_address",
+      "c_phone",
+      "c_comment"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_returnflag", "l_extendedprice", "l_discount"};
+  std::vector<std::string> ordersColumns = {
+      "o_orderdate", "o_orderkey", "o_custkey"};
+
+  const auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
+  const auto& customerFileColumns = getFileColumnNames(kCustomer);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+
+  const auto lineitemReturnFlagFilter = "l_returnflag = 'R'";
+  const auto orderDate = "o_orderdate";
+  auto orderDateFilter = formatDateFilter(
+      orderDate, ordersSelectedRowType, "'1993-10-01'", "'1993-12-31'");
+
+  std::vector<std::string> customerOutputColumns = {
+      "c_name", "c_acctbal", "c_phone", "c_address", "c_custkey", "c_comment"};
+
+  auto mergeColumnNames = [](std::vector<std::string>& v1,
+                             const std::vector<std::string>& v2) {
+    v1.insert(v1.end(), v2.begin(), v2.end());
+    return v1;
+  };
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId customerScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+
+  auto nation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(nationScanNodeId)
+          .planNode();
+
+  auto orders = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kOrders,
+                        ordersSelectedRowType,
+                        ordersFileColumns,
+                        {orderDateFilter})
+                    .capturePlanNodeId(ordersScanNodeId)
+                    .planNode();
+
+  auto partialPlan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kCustomer, customerSelectedRowType, customerFileColumns)
+          .capturePlanNodeId(customerScanNodeId)
+          .hashJoin(
+              {"c_custkey"},
+              {"o_custkey"},
+              orders,
+              "",
+              mergeColumnNames(
+                  customerOutputColumns, {"c_nationkey", "o_orderkey"}))
+          .hashJoin(
+              {"c_nationkey"},
+              {"n_nationkey"},
+              nation,
+              "",
+              mergeColumnNames(customerOutputColumns, {"n_name", "o_orderkey"}))
+          .planNode();
+
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kLineitem,
+                      lineitemSelectedRowType,
+                      lineitemFileColumns,
+                      {lineitemReturnFlagFilter})
+                  .capturePlanNodeId(lineitemScanNodeId)
+                  .project(
+                      {"l_extendedprice * (1.0 - l_discount) AS part_revenue",
+                       "l_orderkey"})
+                  .hashJoin(
+                      {"l_orderkey"},
+                      {"o_orderkey"},
+                      partialPlan,
+                      "",
+                      mergeColumnNames(
+                          customerOutputColumns, {"part_revenue", "n_name"}))
+                  .partialAggregation(
+                      {"c_custkey",
+                       "c_name",
+                       "c_acctbal",
+                       "n_name",
+                       "c_address",
+                       "c_phone",
+                       "c_comment"},
+                      {"sum(part_revenue) as revenue"})
+                  .localPartition({})
+                  .finalAggregation()
+                  .orderBy({"revenue DESC"}, false)
+                  .project(
+                      {"c_custkey",
+                       "c_name",
+                       "revenue",
+                       "c_acctbal",
+                       "n_name",
+                       "c_address",
+                       "c_phone",
+                       "c_comment"})
+                  .limit(0, 20, false)
+                  .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ11Plan() const {
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_availqty", "ps_supplycost"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+
+  const auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+
+  const auto nationNameFilter = "n_name = 'GERMANY'";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId totalPartsuppScanNodeId;
+  core::PlanNodeId totalSupplierScanNodeId;
+  core::PlanNodeId totalNationScanNodeId;
+
+  // The value of each partsupp row of the suppliers in the nation.
+  auto germanPartsupp = [&](core::PlanNodeId& partsuppScanId,
+                            core::PlanNodeId& supplierScanId,
+                            core::PlanNodeId& nationScanId) {
+    auto nation = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(
+                          kNation,
+                          nationSelectedRowType,
+                          nationFileColumns,
+                          {nationNameFilter})
+                      .capturePlanNodeId(nationScanId)
+                      .planNode();
+    auto suppliers =
+        PlanBuilder(planNodeIdGenerator)
+            .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+            .capturePlanNodeId(supplierScanId)
+            .hashJoin(
+                {"s_nationkey"}, {"n_nationkey"}, nation, "", {"s_suppkey"})
+            .planNode();
+    return PlanBuilder(planNodeIdGenerator)
+        .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+        .capturePlanNodeId(partsuppScanId)
+        .hashJoin(
+            {"ps_suppkey"},
+            {"s_suppkey"},
+            suppliers,
+            "",
+            {"ps_partkey", "ps_availqty", "ps_supplycost"})
+        .project(
+            {"ps_partkey",
+             "ps_supplycost * cast(ps_availqty as double) AS part_value"});
+  };
+
+  auto threshold = germanPartsupp(
+                       totalPartsuppScanNodeId,
+                       totalSupplierScanNodeId,
+                       totalNationScanNodeId)
+                       .partialAggregation({}, {"sum(part_value) AS total"})
+                       .localPartition({})
+                       .finalAggregation()
+                       .project({"total * 0.0001 AS threshold"})
+                       .planNode();
+
+  auto plan =
+      germanPartsupp(partsuppScanNodeId, supplierScanNodeId, nationScanNodeId)
+          .partialAggregation({"ps_partkey"}, {"sum(part_value) AS value"})
+          .localPartition({"ps_partkey"})
+          .finalAggregation()
+          .crossJoin(threshold, {"ps_partkey", "value"}, "value > threshold")
+          .localPartition({})
+          .orderBy({"value DESC"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[totalPartsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[totalSupplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[totalNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ12Plan() const {
+  std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderpriority"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey",
+      "l_shipdate",
+      "l_commitdate",
+      "l_receiptdate",
+      "l_shipmode"};
+
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const auto shipModeFilter = "l_shipmode in ('MAIL', 'SHIP')";
+  const auto receiptDate = "l_receiptdate";
+  auto receiptDateFilter = formatDateFilter(
+      receiptDate, lineitemSelectedRowType, "'1994-01-01'", "'1994-12-31'");
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+
+  auto orders =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kOrders, ordersSelectedRowType, ordersFileColumns)
+          .capturePlanNodeId(ordersScanNodeId)
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipModeFilter, receiptDateFilter},
+              "l_commitdate < l_receiptdate AND l_shipdate < l_commitdate")
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_orderkey"},
+              {"o_orderkey"},
+              orders,
+              "",
+              {"l_shipmode", "o_orderpriority"})
+          .project(
+              {"l_shipmode",
+               "if(o_orderpriority = '1-URGENT' OR o_orderpriority = '2-HIGH', "
+               "1, 0) AS high_line",
+               "if(o_orderpriority = '1-URGENT' OR o_orderpriority = '2-HIGH', "
+               "0, 1) AS low_line"})
+          .partialAggregation(
+              {"l_shipmode"},
+              {"sum(high_line) AS high_line_count",
+               "sum(low_line) AS low_line_count"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy({"l_shipmode"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ13Plan() const {
+  std::vector<std::string> ordersColumns = {
+      "o_custkey", "o_comment", "o_orderkey"};
+  std::vector<std::string> customerColumns = {"c_custkey"};
+
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+
+  const auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
+  const auto& customerFileColumns = getFileColumnNames(kCustomer);
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId customerScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+
+  auto customers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kCustomer, customerSelectedRowType, customerFileColumns)
+          .capturePlanNodeId(customerScanNodeId)
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kOrders,
+              ordersSelectedRowType,
+              ordersFileColumns,
+              {},
+              "o_comment not like '%special%requests%'")
+          .capturePlanNodeId(ordersScanNodeId)
+          .hashJoin(
+              {"o_custkey"},
+              {"c_custkey"},
+              customers,
+              "",
+              {"c_custkey", "o_orderkey"},
+              core::JoinType::kRight)
+          .partialAggregation({"c_custkey"}, {"count(o_orderkey) as pc_count"})
+          .localPartition({})
+          .finalAggregation(
+              {"c_custkey"}, {"count(pc_count) as c_count"}, {BIGINT()})
+          .singleAggregation({"c_count"}, {"count(0) as custdist"})
+          .orderBy({"custdist DESC", "c_count DESC"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ14Plan() const {
+  std::vector<std::string> lineitemColumns = {
+      "l_partkey", "l_extendedprice", "l_discount", "l_shipdate"};
+  std::vector<std::string> partColumns = {"p_partkey", "p_type"};
+
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+
+  const auto shipDate = "l_shipdate";
+  auto shipDateFilter = formatDateFilter(
+      shipDate, lineitemSelectedRowType, "'1995-09-01'", "'1995-09-30'");
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId partScanNodeId;
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(kPart, partSelectedRowType, partFileColumns)
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipDateFilter})
+          .capturePlanNodeId(lineitemScanNodeId)
+          .project(
+              {"l_partkey",
+               "l_extendedprice * (1.0 - l_discount) AS part_revenue"})
+          .hashJoin(
+              {"l_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"part_revenue", "p_type"})
+          .project(
+              {"if(p_type like 'PROMO%', part_revenue, 0.0) AS promo_revenue",
+               "part_revenue"})
+          .partialAggregation(
+              {},
+              {"sum(promo_revenue) AS total_promo_revenue",
+               "sum(part_revenue) AS total_revenue"})
+          .localPartition({})
+          .finalAggregation()
+          .project(
+              {"100.0 * total_promo_revenue / total_revenue AS promo_revenue"})
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ15Plan() const {
+  std::vector<std::string> lineitemColumns = {
+      "l_suppkey", "l_extendedprice", "l_discount", "l_shipdate"};
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey", "s_name", "s_address", "s_phone"};
+
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+
+  const auto shipDate = "l_shipdate";
+  auto shipDateFilter = formatDateFilter(
+      shipDate, lineitemSelectedRowType, "'1996-01-01'", "'1996-03-31'");
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+
+  // The revenue of all suppliers is computed once. A window over all the
+  // suppliers adds the maximum revenue to each row. The maximum is one of the
+  // revenues, so that the equality below holds for floating point values.
+  auto topSuppliers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipDateFilter})
+          .capturePlanNodeId(lineitemScanNodeId)
+          .project(
+              {"l_suppkey AS supplier_no",
+               "l_extendedprice * (1.0 - l_discount) AS part_revenue"})
+          .partialAggregation(
+              {"supplier_no"}, {"sum(part_revenue) AS total_revenue"})
+          .localPartition({})
+          .finalAggregation()
+          .window(
+              {},
+              {},
+              {"max(total_revenue) AS max_revenue"},
+              {core::WindowNode::WindowType::kRows,
+               core::WindowNode::BoundType::kUnboundedPreceding,
+               nullptr,
+               core::WindowNode::BoundType::kUnboundedFollowing,
+               nullptr})
+          .filter("total_revenue = max_revenue")
+          .project({"supplier_no", "total_revenue"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_suppkey"},
+              {"supplier_no"},
+              topSuppliers,
+              "",
+              {"s_suppkey", "s_name", "s_address", "s_phone", "total_revenue"})
+          .localPartition({})
+          .orderBy({"s_suppkey"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ16Plan() const {
+  std::vector<std::string> partsuppColumns = {"ps_partkey", "ps_suppkey"};
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_brand", "p_type", "p_size"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_comment"};
+
+  const auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+
+  const auto partSizeFilter = "p_size in (49, 14, 23, 45, 19, 3, 36, 9)";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+
+  auto part =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kPart,
+              partSelectedRowType,
+              partFileColumns,
+              {partSizeFilter},
+              "p_brand <> 'Brand#45' AND p_type not like 'MEDIUM POLISHED%'")
+          .capturePlanNodeId(partScanNodeId)
+          .planNode();
+
+  auto complaints = PlanBuilder(planNodeIdGenerator)
+                        .tableScan(
+                            kSupplier,
+                            supplierSelectedRowType,
+                            supplierFileColumns,
+                            {},
+                            "s_comment like '%Customer%Complaints%'")
+                        .capturePlanNodeId(supplierScanNodeId)
+                        .planNode();
+
+  // count(distinct ps_suppkey) is a distinct aggregation on all the keys
+  // followed by a count. Both run after partitioning on the grouping keys.
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"ps_suppkey", "p_brand", "p_type", "p_size"})
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              complaints,
+              "",
+              {"ps_suppkey", "p_brand", "p_type", "p_size"},
+              core::JoinType::kAnti)
+          .partialAggregation({"p_brand", "p_type", "p_size", "ps_suppkey"}, {})
+          .localPartition({"p_brand", "p_type", "p_size"})
+          .finalAggregation()
+          .singleAggregation(
+              {"p_brand", "p_type", "p_size"}, {"count(0) AS supplier_cnt"})
+          .localPartition({})
+          .orderBy({"supplier_cnt DESC", "p_brand", "p_type", "p_size"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ17Plan() const {
+  std::vector<std::string> lineitemColumns = {
+      "l_partkey", "l_quantity", "l_extendedprice"};
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_brand", "p_container"};
+
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+
+  const std::vector<std::string> partFilters = {
+      "p_brand = 'Brand#23'", "p_container = 'MED BOX'"};
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId avgLineitemScanNodeId;
+  core::PlanNodeId avgPartScanNodeId;
+
+  auto avgPart =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPart, partSelectedRowType, partFileColumns, partFilters)
+          .capturePlanNodeId(avgPartScanNodeId)
+          .planNode();
+
+  // 20% of the average quantity of each of the parts.
+  auto quantityThresholds =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(avgLineitemScanNodeId)
+          .hashJoin(
+              {"l_partkey"},
+              {"p_partkey"},
+              avgPart,
+              "",
+              {"l_partkey", "l_quantity"},
+              core::JoinType::kLeftSemi)
+          .partialAggregation(
+              {"l_partkey"}, {"avg(l_quantity) AS avg_quantity"})
+          .localPartition({"l_partkey"})
+          .finalAggregation()
+          .project(
+              {"l_partkey AS avg_partkey",
+               "0.2 * avg_quantity AS quantity_threshold"})
+          .planNode();
 
-  auto customers =
+  auto part =
       PlanBuilder(planNodeIdGenerator)
-          .tableScan(kCustomer, customerSelectedRowType, customerFileColumns)
-          .capturePlanNodeId(customerScanNodeId)
+          .tableScan(kPart, partSelectedRowType, partFileColumns, partFilters)
+          .capturePlanNodeId(partScanNodeId)
           .planNode();
 
   auto plan =
       PlanBuilder(planNodeIdGenerator)
-          .tableScan(
-              kOrders,
-              ordersSelectedRowType,
-              ordersFileColumns,
-              {},
-              "o_comment not like '%special%requests%'")
-          .capturePlanNodeId(ordersScanNodeId)
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(lineitemScanNodeId)
           .hashJoin(
-              {"o_custkey"},
-              {"c_custkey"},
-              customers,
+              {"l_partkey"},
+              {"p_partkey"},
+              part,
               "",
-              {"c_custkey", "o_orderkey"},
-              core::JoinType::kRight)
-          .partialAggregation({"c_custkey"}, {"count(o_orderkey) as pc_count"})
+              {"l_partkey", "l_quantity", "l_extendedprice"})
+          .hashJoin(
+              {"l_partkey"},
+              {"avg_partkey"},
+              quantityThresholds,
+              "l_quantity < quantity_threshold",
+              {"l_extendedprice"})
+          .partialAggregation({}, {"sum(l_extendedprice) AS total_price"})
           .localPartition({})
-          .finalAggregation(
-              {"c_custkey"}, {"count(pc_count) as c_count"}, {BIGINT()})
-          .singleAggregation({"c_count"}, {"count(0) as custdist"})
-          .orderBy({"custdist DESC", "c_count DESC"}, false)
+          .finalAggregation()
+          .project({"total_price / 7.0 AS avg_yearly"})
           .planNode();
 
   TpchPlan context;
   context.plan = std::move(plan);
-  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
-  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[avgLineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[avgPartScanNodeId] = getTableFilePaths(kPart);
   context.dataFileFormat = format_;
   return context;
 }
@@ -688,8 +1856,432 @@ TpchPlan TpchQueryBuilder::getQ18Plan() const {
   return context;
 }
 
-const std::vector<std::string> TpchQueryBuilder::kTableNames_ =
-    {kLineitem, kOrders, kCustomer, kNation, kRegion, kSupplier};
+TpchPlan TpchQueryBuilder::getQ19Plan() const {
+  std::vector<std::string> lineitemColumns = {
+      "l_partkey",
+      "l_quantity",
+      "l_extendedprice",
+      "l_discount",
+      "l_shipinstruct",
+      "l_shipmode"};
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_brand", "p_size", "p_container"};
+
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+
+  // The filters common to all the disjuncts are pushed into the scans.
+  const std::vector<std::string> lineitemFilters = {
+      "l_shipmode in ('AIR', 'AIR REG')",
+      "l_shipinstruct = 'DELIVER IN PERSON'",
+      "l_quantity between 1.0 and 30.0"};
+  const std::vector<std::string> partFilters = {
+      "p_brand in ('Brand#12', 'Brand#23', 'Brand#34')",
+      "p_size between 1 and 15"};
+  const auto joinFilter =
+      "(p_brand = 'Brand#12' AND "
+      "p_container in ('SM CASE', 'SM BOX', 'SM PACK', 'SM PKG') AND "
+      "l_quantity between 1.0 and 11.0 AND p_size between 1 and 5) OR "
+      "(p_brand = 'Brand#23' AND "
+      "p_container in ('MED BAG', 'MED BOX', 'MED PKG', 'MED PACK') AND "
+      "l_quantity between 10.0 and 20.0 AND p_size between 1 and 10) OR "
+      "(p_brand = 'Brand#34' AND "
+      "p_container in ('LG CASE', 'LG BOX', 'LG PACK', 'LG PKG') AND "
+      "l_quantity between 20.0 and 30.0 AND p_size between 1 and 15)";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId partScanNodeId;
+
+  // The size is compared with BIGINT literals in the join filter.
+  auto part =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPart, partSelectedRowType, partFileColumns, partFilters)
+          .capturePlanNodeId(partScanNodeId)
+          .project(
+              {"p_partkey",
+               "p_brand",
+               "cast(p_size as bigint) AS p_size",
+               "p_container"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              lineitemFilters)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .project(
+              {"l_partkey",
+               "l_quantity",
+               "l_extendedprice * (1.0 - l_discount) AS part_revenue"})
+          .hashJoin(
+              {"l_partkey"}, {"p_partkey"}, part, joinFilter, {"part_revenue"})
+          .partialAggregation({}, {"sum(part_revenue) AS revenue"})
+          .localPartition({})
+          .finalAggregation()
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ20Plan() const {
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey", "s_name", "s_address", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_availqty"};
+  std::vector<std::string> partColumns = {"p_partkey", "p_name"};
+  std::vector<std::string> lineitemColumns = {
+      "l_partkey", "l_suppkey", "l_quantity", "l_shipdate"};
+
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  const auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const auto nationNameFilter = "n_name = 'CANADA'";
+  const auto partNameFilter = "p_name like 'forest%'";
+  const auto shipDate = "l_shipdate";
+  auto shipDateFilter = formatDateFilter(
+      shipDate, lineitemSelectedRowType, "'1994-01-01'", "'1994-12-31'");
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId lineitemPartScanNodeId;
+
+  auto forestParts = [&](core::PlanNodeId& partScanId) {
+    return PlanBuilder(planNodeIdGenerator)
+        .tableScan(
+            kPart, partSelectedRowType, partFileColumns, {}, partNameFilter)
+        .capturePlanNodeId(partScanId)
+        .planNode();
+  };
+
+  // Half of the quantity shipped in the year for each forest part and
+  // supplier.
+  auto shippedQuantities =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipDateFilter})
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_partkey"},
+              {"p_partkey"},
+              forestParts(lineitemPartScanNodeId),
+              "",
+              {"l_partkey", "l_suppkey", "l_quantity"},
+              core::JoinType::kLeftSemi)
+          .partialAggregation(
+              {"l_partkey", "l_suppkey"}, {"sum(l_quantity) AS sum_quantity"})
+          .localPartition({"l_partkey", "l_suppkey"})
+          .finalAggregation()
+          .project(
+              {"l_partkey", "l_suppkey", "0.5 * sum_quantity AS half_quantity"})
+          .planNode();
+
+  auto excessSuppliers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              forestParts(partScanNodeId),
+              "",
+              {"ps_partkey", "ps_suppkey", "ps_availqty"},
+              core::JoinType::kLeftSemi)
+          .hashJoin(
+              {"ps_partkey", "ps_suppkey"},
+              {"l_partkey", "l_suppkey"},
+              shippedQuantities,
+              "cast(ps_availqty as double) > half_quantity",
+              {"ps_suppkey"},
+              core::JoinType::kLeftSemi)
+          .planNode();
+
+  auto nation = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kNation,
+                        nationSelectedRowType,
+                        nationFileColumns,
+                        {nationNameFilter})
+                    .capturePlanNodeId(nationScanNodeId)
+                    .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              nation,
+              "",
+              {"s_suppkey", "s_name", "s_address"})
+          .hashJoin(
+              {"s_suppkey"},
+              {"ps_suppkey"},
+              excessSuppliers,
+              "",
+              {"s_name", "s_address"},
+              core::JoinType::kLeftSemi)
+          .localPartition({})
+          .orderBy({"s_name"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[lineitemPartScanNodeId] = getTableFilePaths(kPart);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ21Plan() const {
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey", "s_name", "s_nationkey"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_suppkey", "l_commitdate", "l_receiptdate"};
+  std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderstatus"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+
+  const auto nationNameFilter = "n_name = 'SAUDI ARABIA'";
+  const auto orderStatusFilter = "o_orderstatus = 'F'";
+  const auto lateFilter = "l_receiptdate > l_commitdate";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId otherLineitemScanNodeId;
+  core::PlanNodeId otherLateLineitemScanNodeId;
+
+  auto nation = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kNation,
+                        nationSelectedRowType,
+                        nationFileColumns,
+                        {nationNameFilter})
+                    .capturePlanNodeId(nationScanNodeId)
+                    .planNode();
+
+  auto suppliers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              nation,
+              "",
+              {"s_suppkey", "s_name"})
+          .planNode();
+
+  auto orders = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kOrders,
+                        ordersSelectedRowType,
+                        ordersFileColumns,
+                        {orderStatusFilter})
+                    .capturePlanNodeId(ordersScanNodeId)
+                    .planNode();
+
+  // The lineitems of the exists and the not exists subqueries.
+  auto otherLineitems =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(otherLineitemScanNodeId)
+          .project({"l_orderkey AS l2_orderkey", "l_suppkey AS l2_suppkey"})
+          .planNode();
+
+  auto otherLateLineitems =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {},
+              lateFilter)
+          .capturePlanNodeId(otherLateLineitemScanNodeId)
+          .project({"l_orderkey AS l3_orderkey", "l_suppkey AS l3_suppkey"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {},
+              lateFilter)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_suppkey"},
+              {"s_suppkey"},
+              suppliers,
+              "",
+              {"l_orderkey", "l_suppkey", "s_name"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"o_orderkey"},
+              orders,
+              "",
+              {"l_orderkey", "l_suppkey", "s_name"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"l2_orderkey"},
+              otherLineitems,
+              "l2_suppkey <> l_suppkey",
+              {"l_orderkey", "l_suppkey", "s_name"},
+              core::JoinType::kLeftSemi)
+          .hashJoin(
+              {"l_orderkey"},
+              {"l3_orderkey"},
+              otherLateLineitems,
+              "l3_suppkey <> l_suppkey",
+              {"s_name"},
+              core::JoinType::kAnti)
+          .partialAggregation({"s_name"}, {"count(0) AS numwait"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy({"numwait DESC", "s_name"}, false)
+          .limit(0, 100, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[otherLineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[otherLateLineitemScanNodeId] =
+      getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ22Plan() const {
+  std::vector<std::string> customerColumns = {
+      "c_custkey", "c_phone", "c_acctbal"};
+  std::vector<std::string> ordersColumns = {"o_custkey"};
+
+  const auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
+  const auto& customerFileColumns = getFileColumnNames(kCustomer);
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+
+  const auto countryCodeFilter =
+      "substr(c_phone, 1, 2) in ('13', '31', '23', '29', '30', '18', '17')";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId customerScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId avgCustomerScanNodeId;
+
+  auto avgAccountBalance = PlanBuilder(planNodeIdGenerator)
+                               .tableScan(
+                                   kCustomer,
+                                   customerSelectedRowType,
+                                   customerFileColumns,
+                                   {"c_acctbal > 0.0"},
+                                   countryCodeFilter)
+                               .capturePlanNodeId(avgCustomerScanNodeId)
+                               .partialAggregation(
+                                   {}, {"avg(c_acctbal) AS avg_acctbal"})
+                               .localPartition({})
+                               .finalAggregation()
+                               .planNode();
+
+  auto orders =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kOrders, ordersSelectedRowType, ordersFileColumns)
+          .capturePlanNodeId(ordersScanNodeId)
+          .planNode();
+
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kCustomer,
+                      customerSelectedRowType,
+                      customerFileColumns,
+                      {},
+                      countryCodeFilter)
+                  .capturePlanNodeId(customerScanNodeId)
+                  .crossJoin(
+                      avgAccountBalance,
+                      {"c_custkey", "c_phone", "c_acctbal"},
+                      "c_acctbal > avg_acctbal")
+                  .hashJoin(
+                      {"c_custkey"},
+                      {"o_custkey"},
+                      orders,
+                      "",
+                      {"c_phone", "c_acctbal"},
+                      core::JoinType::kAnti)
+                  .project({"substr(c_phone, 1, 2) AS cntrycode", "c_acctbal"})
+                  .partialAggregation(
+                      {"cntrycode"},
+                      {"count(0) AS numcust", "sum(c_acctbal) AS totacctbal"})
+                  .localPartition({})
+                  .finalAggregation()
+                  .orderBy({"cntrycode"}, false)
+                  .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[avgCustomerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+const std::vector<std::string> TpchQueryBuilder::kTableNames_ = {
+    kLineitem,
+    kOrders,
+    kCustomer,
+    kNation,
+    kRegion,
+    kPart,
+    kSupplier,
+    kPartsupp};
 
 const std::unordered_map<std::string, std::vector<std::string>>
     TpchQueryBuilder::kTables_ = {
@@ -708,8 +2300,14 @@ const std::unordered_map<std::string, std::vector<std::string>>
         std::make_pair(
             "region",
             tpch::getTableSchema(tpch::Table::TBL_REGION)->names()),
+        std::make_pair(
+            "part",
+            tpch::getTableSchema(tpch::Table::TBL_PART)->names()),
         std::make_pair(
             "supplier",
-            tpch::getTableSchema(tpch::Table::TBL_SUPPLIER)->names())};
+            tpch::getTableSchema(tpch::Table::TBL_SUPPLIER)->names()),
+        std::make_pair(
+            "partsupp",
+            tpch::getTableSchema(tpch::Table::TBL_PARTSUPP)->names())};
 
 } // namespace facebook::velox::exec::test
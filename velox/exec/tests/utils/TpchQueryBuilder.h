@@ -77,12 +77,27 @@ class TpchQueryBuilder {
 
  private:
   TpchPlan getQ1Plan() const;
+  TpchPlan getQ2Plan() const;
   TpchPlan getQ3Plan() const;
+  TpchPlan getQ4Plan() const;
   TpchPlan getQ5Plan() const;
   TpchPlan getQ6Plan() const;
+  TpchPlan getQ7Plan() const;
+  TpchPlan getQ8Plan() const;
+  TpchPlan getQ9Plan() const;
   TpchPlan getQ10Plan() const;
+  TpchPlan getQ11Plan() const;
+  TpchPlan getQ12Plan() const;
   TpchPlan getQ13Plan() const;
+  TpchPlan getQ14Plan() const;
+  TpchPlan getQ15Plan() const;
+  TpchPlan getQ16Plan() const;
+  TpchPlan getQ17Plan() const;
   TpchPlan getQ18Plan() const;
+  TpchPlan getQ19Plan() const;
+  TpchPlan getQ20Plan() const;
+  TpchPlan getQ21Plan() const;
+  TpchPlan getQ22Plan() const;
 
   const std::vector<std::string>& getTableFilePaths(
       const std::string& tableName) const {
@@ -114,6 +129,8 @@ class TpchQueryBuilder {
   static constexpr const char* kNation = "nation";
   static constexpr const char* kRegion = "region";
   static constexpr const char* kSupplier = "supplier";
+  static constexpr const char* kPart = "part";
+  static constexpr const char* kPartsupp = "partsupp";
 };
 
 } // namespace facebook::velox::exec::test
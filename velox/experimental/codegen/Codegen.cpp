@@ -39,6 +39,7 @@ bool Codegen::initialize(
         proto::CodegenOptionsProto>::loadProtoFromJson(codegenOptionsJson);
 
     useSymbolsForArithmetic_ = codegenOptionsProto.usesymbolsforarithmetic();
+    asyncCompilation_ = codegenOptionsProto.asynccompilation();
     initializeCodeManager(codegenOptionsProto.compileroptions());
     initializeUDFManager();
     initializeTransform();
@@ -100,6 +101,9 @@ bool Codegen::initializeTransform() {
           *udfManager_,
           useSymbolsForArithmetic_,
           *std::static_pointer_cast<DefaultEventSequence>(eventSequence_)));
+  auto flags = transform_->transformFlags();
+  flags.asyncCompilation = asyncCompilation_;
+  transform_->setTransformFlags(flags);
   return true;
 }
 
@@ -62,6 +62,10 @@ class Codegen {
   // Follows Velox, defaults to false
   bool useSymbolsForArithmetic_ = false;
 
+  // Compile in the background, interpreting the expressions until the
+  // compiled code is loaded. Defaults to false.
+  bool asyncCompilation_ = false;
+
   bool initializeCodeManager(
       const proto::CompilerOptionsProto& compilerOptionsProto);
 
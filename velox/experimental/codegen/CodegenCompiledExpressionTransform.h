@@ -23,6 +23,7 @@
 #include "velox/core/PlanNode.h"
 #include "velox/experimental/codegen/CompiledExpressionAnalysis.h"
 #include "velox/experimental/codegen/code_generator/ExprCodeGenerator.h"
+#include "velox/experimental/codegen/compiler_utils/BackgroundCompiler.h"
 #include "velox/experimental/codegen/compiler_utils/CodeManager.h"
 #include "velox/experimental/codegen/compiler_utils/ICompiledCall.h"
 #include "velox/experimental/codegen/transform/PlanNodeTransform.h"
@@ -44,11 +45,13 @@ class CompiledExpressionTransformVisitor {
       const CompilerOptions& options,
       DefaultScopedTimer::EventSequence& eventSequence,
       bool compileFilter = true,
-      bool mergeFilter = true)
+      bool mergeFilter = true,
+      bool asyncCompilation = false)
       : codeManager_(options, eventSequence),
         compiledExprAnalysisResult_(compiledExprAnalysisResult),
         compileFilter_(compileFilter),
-        mergeFilter_(mergeFilter) {}
+        mergeFilter_(mergeFilter),
+        asyncCompilation_(asyncCompilation) {}
 
   template <typename Children>
   std::shared_ptr<core::PlanNode> visit(
@@ -108,6 +111,7 @@ class CompiledExpressionTransformVisitor {
 
   bool compileFilter_;
   bool mergeFilter_;
+  bool asyncCompilation_;
 
   std::optional<std::reference_wrapper<const GeneratedExpressionStruct>>
   getGeneratedCode(const std::shared_ptr<const ITypedExpr>& expression) {
@@ -405,22 +409,41 @@ class CompiledExpressionTransformVisitor {
   /// into                    {PlusExpr,MinusExpr}
   /// [   -> FieldsAccess(c) -> CompiledEpr{c,d}  -> FieldsAccess(b) ->
   /// InputExpr({a,b},{DOUBLE,DOUBLE}) [   -> FieldsAccess(d) / \
-  /// FieldsAccess(a) / \param dynamicObjectPath  compiled code path \param
+  /// FieldsAccess(a) / \param fileString  generated code \param
   /// callOutputType compiled expression output row type \param callInputType
   /// compiled expression input  row type \param projectionInputType input type
-  /// of the original projection \return
+  /// of the original projection \param fallbackFilter \param
+  /// fallbackProjections original expressions, interpreted until the code is
+  /// compiled when compiling in the background \return
   std::vector<std::shared_ptr<const ITypedExpr>> buildCompiledCallExpr(
-      const std::filesystem::path& dynamicObjectPath,
+      const std::string& fileString,
       const std::shared_ptr<const RowType>& callOutputType,
       const std::shared_ptr<const RowType>& callInputType,
-      const std::shared_ptr<const RowType>& projectionInputType) {
+      const std::shared_ptr<const RowType>& projectionInputType,
+      const std::shared_ptr<const ITypedExpr>& fallbackFilter,
+      const std::vector<std::shared_ptr<const ITypedExpr>>&
+          fallbackProjections) {
     // Create the input FieldAccess expression node to the read input data
     // Note we could reuse the one already existing in the current expressions.
     auto inputFieldAccessVector = buildFieldAccessor(*callInputType);
 
     // Create ICompiledExpression
-    auto compiledExpression = std::make_shared<codegen::ICompiledCall>(
-        dynamicObjectPath, inputFieldAccessVector, callOutputType);
+    std::shared_ptr<codegen::ICompiledCall> compiledExpression;
+    if (asyncCompilation_) {
+      auto library = compiler_utils::BackgroundCompiler::getDefault().compile(
+          codeManager_.compiler().compilerOptions(), fileString);
+      compiledExpression = std::make_shared<codegen::ICompiledCall>(
+          std::move(library),
+          fallbackFilter,
+          fallbackProjections,
+          inputFieldAccessVector,
+          callOutputType);
+    } else {
+      compiledExpression = std::make_shared<codegen::ICompiledCall>(
+          codeManager_.compiler().compileAndLink(fileString),
+          inputFieldAccessVector,
+          callOutputType);
+    }
 
     // Create the field accessor to read the output of the compiled call
     auto outputFieldAccessVector =
@@ -486,14 +509,16 @@ class CompiledExpressionTransformVisitor {
             fmt::arg(
                 "isDefaultNullStrict",
                 isDefaultNullStrict(filter.id()) ? "true" : "false")));
-    auto compiledObject = codeManager_.compiler().compileString({}, fileString);
-    auto dynamicObject = codeManager_.compiler().link({}, {compiledObject});
-
     // Extract the row input expression from the current filter
     const auto inputType = filter.sources()[0]->outputType();
 
     std::shared_ptr<const ITypedExpr> newFilter = buildCompiledCallExpr(
-        dynamicObject, concatOutputType, concatInputType, inputType)[0];
+        fileString,
+        concatOutputType,
+        concatInputType,
+        inputType,
+        nullptr,
+        {filter.filter()})[0];
 
     // Build new filter node with newly generated expressions
     return utils::adapter::FilterCopy::copyWith(
@@ -585,16 +610,23 @@ class CompiledExpressionTransformVisitor {
                 "isDefaultNullStrict",
                 isDefaultNullStrict ? "true" : "false")));
 
-    auto compiledObject = codeManager_.compiler().compileString({}, fileString);
-    auto dynamicObject = codeManager_.compiler().link({}, {compiledObject});
     std::vector<std::shared_ptr<const ITypedExpr>> newProjections;
 
     // Extract the row input expression from the current projection
     const auto inputType = projection.sources()[0]->outputType();
 
+    std::vector<std::shared_ptr<const ITypedExpr>> fallbackProjections;
+    for (const auto& [columnIndex, expressionStruct] : generatedColumns) {
+      fallbackProjections.push_back(projection.projections()[columnIndex]);
+    }
     std::vector<std::shared_ptr<const ITypedExpr>> newExpressions =
         buildCompiledCallExpr(
-            dynamicObject, concatOutputType, concatInputType, inputType);
+            fileString,
+            concatOutputType,
+            concatInputType,
+            inputType,
+            filterExpr ? filterNode->filter() : nullptr,
+            fallbackProjections);
 
     // oldToNewExpressionColumnMap[Index] in the new projection list maps to
     // projection.projections()[Index] in the old;
@@ -644,6 +676,10 @@ union TransformFlags {
     // invalid if enableDefaultNullOpt not set
     bool enableFilterDefaultNull : 1;
 
+    // compile in the background and interpret the expressions until the
+    // compiled code is loaded
+    bool asyncCompilation : 1;
+
     // up for more flags in the future
   };
 
@@ -685,7 +721,8 @@ class CodegenCompiledExpressionTransform final : PlanNodeTransform {
         compilerOptions_,
         eventSequence_,
         flags_.compileFilter,
-        flags_.mergeFilter);
+        flags_.mergeFilter,
+        flags_.asyncCompilation);
 
     auto nodeTransformer = [&visitor](
                                auto& node, const auto& transformedChildren) {
@@ -701,6 +738,10 @@ class CodegenCompiledExpressionTransform final : PlanNodeTransform {
     flags_ = flags;
   }
 
+  const TransformFlags& transformFlags() const {
+    return flags_;
+  }
+
  private:
   CompilerOptions compilerOptions_;
   const UDFManager& udfManager_;
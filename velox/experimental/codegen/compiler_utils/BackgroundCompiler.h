@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include "velox/experimental/codegen/compiler_utils/Compiler.h"
+
+namespace facebook::velox::codegen::compiler_utils {
+
+/// The library of a background compilation. Shared by all the expressions
+/// waiting for the same code.
+class AsyncLibrary {
+ public:
+  /// Returns the path of the library once compiled. Returns std::nullopt
+  /// while compiling and if the compilation failed.
+  std::optional<std::filesystem::path> tryGet() const {
+    if (!ready_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    return path_;
+  }
+
+  /// True if the compilation finished with an error.
+  bool failed() const {
+    return ready_.load(std::memory_order_acquire) && !path_.has_value();
+  }
+
+  /// Waits for the compilation and returns the path of the library. Throws
+  /// if the compilation failed.
+  std::filesystem::path get() const {
+    std::unique_lock<std::mutex> l(mutex_);
+    finished_.wait(l, [&]() { return ready_.load(); });
+    VELOX_CHECK(path_.has_value(), "Compilation failed: {}", error_);
+    return path_.value();
+  }
+
+  const std::string& error() const {
+    return error_;
+  }
+
+  void setPath(std::filesystem::path path) {
+    finish([&]() { path_ = std::move(path); });
+  }
+
+  void setError(std::string error) {
+    finish([&]() { error_ = std::move(error); });
+  }
+
+ private:
+  template <typename F>
+  void finish(F set) {
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      VELOX_CHECK(!ready_, "AsyncLibrary is set twice");
+      set();
+      ready_.store(true, std::memory_order_release);
+    }
+    finished_.notify_all();
+  }
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable finished_;
+  std::atomic<bool> ready_{false};
+  std::optional<std::filesystem::path> path_;
+  std::string error_;
+};
+
+/// Compiles and links generated code on a thread pool, so that the
+/// transformation of a plan does not wait for the compiler. Each compilation
+/// uses its own Compiler, whose timers do not share the event sequence of
+/// the caller. The libraries are kept for the life of the process and code
+/// that was compiled before, or is being compiled, is not compiled again.
+/// With a cache directory in the options, libraries compiled by earlier
+/// processes are found there.
+class BackgroundCompiler {
+ public:
+  explicit BackgroundCompiler(size_t numThreads)
+      : executor_(std::max<size_t>(1, numThreads)) {}
+
+  static BackgroundCompiler& getDefault() {
+    static BackgroundCompiler compiler(
+        std::thread::hardware_concurrency() / 4);
+    return compiler;
+  }
+
+  /// Starts compiling 'cppContent' with 'options' unless the same code is
+  /// compiled already. Returns the library being compiled.
+  std::shared_ptr<const AsyncLibrary> compile(
+      const CompilerOptions& options,
+      const std::string& cppContent) {
+    DefaultScopedTimer::EventSequence eventSequence;
+    const auto key = Compiler(options, eventSequence).fingerprint(cppContent);
+    std::shared_ptr<AsyncLibrary> library;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      auto& entry = libraries_[key];
+      if (entry && !entry->failed()) {
+        return entry;
+      }
+      entry = std::make_shared<AsyncLibrary>();
+      library = entry;
+    }
+    executor_.add([library, options, cppContent]() {
+      DefaultScopedTimer::EventSequence eventSequence;
+      Compiler compiler(options, eventSequence);
+      try {
+        library->setPath(compiler.compileAndLink(cppContent));
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Codegen: background compilation failed: " << e.what();
+        library->setError(e.what());
+      }
+    });
+    return library;
+  }
+
+ private:
+  folly::CPUThreadPoolExecutor executor_;
+  std::mutex mutex_;
+  // Keyed on Compiler::fingerprint().
+  std::unordered_map<uint64_t, std::shared_ptr<AsyncLibrary>> libraries_;
+};
+} // namespace facebook::velox::codegen::compiler_utils
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unistd.h>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <thread>
+#include "fmt/format.h"
+
+namespace facebook::velox::codegen::compiler_utils {
+
+/// Persistent cache of the dynamic libraries of generated code. A library is
+/// stored as <directory>/<fingerprint>.so, where the fingerprint covers the
+/// source and the compile and link commands (see Compiler::fingerprint()).
+/// The libraries survive restarts and are shared by the processes using the
+/// same directory.
+class CompiledLibraryCache {
+ public:
+  explicit CompiledLibraryCache(std::filesystem::path directory)
+      : directory_(std::move(directory)) {
+    std::filesystem::create_directories(directory_);
+  }
+
+  std::filesystem::path pathOf(uint64_t fingerprint) const {
+    return directory_ / fmt::format("{:016x}.so", fingerprint);
+  }
+
+  /// Returns the cached library of 'fingerprint' or std::nullopt.
+  std::optional<std::filesystem::path> find(uint64_t fingerprint) const {
+    auto path = pathOf(fingerprint);
+    if (std::filesystem::exists(path)) {
+      return path;
+    }
+    return std::nullopt;
+  }
+
+  /// Copies 'library' into the cache and returns the cached path. The copy
+  /// is renamed into place, so that concurrent inserts of the same
+  /// fingerprint by several threads or processes never expose a partly
+  /// written library.
+  std::filesystem::path insert(
+      uint64_t fingerprint,
+      const std::filesystem::path& library) {
+    auto path = pathOf(fingerprint);
+    auto tempPath = path;
+    tempPath += fmt::format(
+        ".{}.{}.tmp",
+        getpid(),
+        std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::filesystem::copy_file(
+        library, tempPath, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::rename(tempPath, path);
+    return path;
+  }
+
+ private:
+  const std::filesystem::path directory_;
+};
+} // namespace facebook::velox::codegen::compiler_utils
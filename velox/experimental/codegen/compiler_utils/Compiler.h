@@ -14,8 +14,10 @@
  * limitations under the License.
  */
 #pragma once
+#include <folly/hash/Hash.h>
 #include "glog/logging.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/experimental/codegen/compiler_utils/CompiledLibraryCache.h"
 #include "velox/experimental/codegen/compiler_utils/CompilerOptions.h"
 #include "velox/experimental/codegen/external_process/Command.h"
 #include "velox/experimental/codegen/external_process/subprocess.h"
@@ -189,6 +191,32 @@ class Compiler {
     return dynamicLibPath;
   }
 
+  /// Returns a fingerprint of the library of 'cppContent' compiled and
+  /// linked by this compiler. Libraries with the same fingerprint are
+  /// interchangeable.
+  uint64_t fingerprint(const std::string& cppContent) {
+    auto compile = compileCommand({}, "", "");
+    auto link = linkCommand({}, {}, "");
+    return folly::hash::fnv64(fmt::format(
+        "{}\n{}\n{}", compile.toString(" "), link.toString(" "), cppContent));
+  }
+
+  /// Compiles and links 'cppContent' into a dynamic library and returns its
+  /// path. If the options have a cache directory, the library is looked up
+  /// there first and stored there after linking.
+  std::filesystem::path compileAndLink(const std::string& cppContent) {
+    if (!compilerOptions_.cacheDirectory.has_value()) {
+      return link({}, {compileString({}, cppContent)});
+    }
+    CompiledLibraryCache cache(compilerOptions_.cacheDirectory.value());
+    const auto key = fingerprint(cppContent);
+    if (auto cached = cache.find(key)) {
+      LOG(INFO) << "Codegen: using cached library " << cached->string();
+      return cached.value();
+    }
+    return cache.insert(key, link({}, {compileString({}, cppContent)}));
+  }
+
   /// Construct a command object which execution would compile the give files.
   /// \param additionalLibraries
   /// \param cppFile
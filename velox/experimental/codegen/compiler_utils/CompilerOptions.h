@@ -39,6 +39,7 @@ struct CompilerOptions {
   std::optional<std::filesystem::path> linker;
   std::optional<std::filesystem::path> formatterPath;
   std::filesystem::path tempDirectory;
+  std::optional<std::filesystem::path> cacheDirectory;
 
   /// Converts a CompilerOptionsProto to a CompilerOptions
   static CompilerOptions fromProto(
@@ -74,6 +75,9 @@ struct CompilerOptions {
     if (!compilerOptionsProto.formatterpath().empty()) {
       compilerOptions.withFormatterPath(compilerOptionsProto.formatterpath());
     }
+    if (!compilerOptionsProto.cachedirectory().empty()) {
+      compilerOptions.withCacheDirectory(compilerOptionsProto.cachedirectory());
+    }
     return compilerOptions;
   }
 
@@ -135,6 +139,8 @@ struct CompilerOptions {
     compilerOptionsProto.set_formatterpath(
         compilerOptions.formatterPath.value_or(""));
     compilerOptionsProto.set_tempdirectory(compilerOptions.tempDirectory);
+    compilerOptionsProto.set_cachedirectory(
+        compilerOptions.cacheDirectory.value_or(""));
 
     return compilerOptionsProto;
   }
@@ -202,5 +208,10 @@ struct CompilerOptions {
     formatterPath = path;
     return *this;
   }
+
+  CompilerOptions& withCacheDirectory(const std::filesystem::path& path) {
+    cacheDirectory = path;
+    return *this;
+  }
 };
 } // namespace facebook::velox::codegen::compiler_utils
@@ -17,7 +17,9 @@
 
 #include "velox/core/Expressions.h"
 #include "velox/core/ITypedExpr.h"
+#include "velox/experimental/codegen/compiler_utils/BackgroundCompiler.h"
 #include "velox/experimental/codegen/vector_function/GeneratedVectorFunction-inl.h"
+#include "velox/experimental/codegen/vector_function/HotSwapVectorFunction.h"
 
 namespace facebook {
 namespace velox {
@@ -30,15 +32,28 @@ namespace codegen {
 /// this object represent
 class ICompiledCall : public core::CallTypedExpr {
  public:
-  using NewInstanceSignature =
-      std::unique_ptr<GeneratedVectorFunctionBase> (*)();
-
   ICompiledCall(
       const std::filesystem::path& dynamicLibPath,
       const std::vector<std::shared_ptr<const ITypedExpr>>& inputs,
       const std::shared_ptr<const RowType>& rowType)
       : core::CallTypedExpr(rowType, inputs, ""),
         dynamicLibPath_{dynamicLibPath} {}
+
+  /// A call whose library is compiled in the background. 'fallbackFilter'
+  /// (nullptr if none) and 'fallbackProjections' are the expressions of the
+  /// generated code over the columns of the inputs. They are interpreted
+  /// until 'library' is ready. See HotSwapVectorFunction.
+  ICompiledCall(
+      std::shared_ptr<const compiler_utils::AsyncLibrary> library,
+      core::TypedExprPtr fallbackFilter,
+      std::vector<core::TypedExprPtr> fallbackProjections,
+      const std::vector<std::shared_ptr<const ITypedExpr>>& inputs,
+      const std::shared_ptr<const RowType>& rowType)
+      : core::CallTypedExpr(rowType, inputs, ""),
+        library_{std::move(library)},
+        fallbackFilter_{std::move(fallbackFilter)},
+        fallbackProjections_{std::move(fallbackProjections)} {}
+
   ICompiledCall(const ICompiledCall&) = delete;
   ICompiledCall(ICompiledCall&&) = delete;
 
@@ -66,16 +81,27 @@ class ICompiledCall : public core::CallTypedExpr {
     return name_.value();
   }
 
+  /// Returns the generated function. For a call compiled in the background,
+  /// returns a function that interprets the expressions until the compiled
+  /// code is ready.
   std::unique_ptr<GeneratedVectorFunctionBase> newInstance() const {
-    if (!newInstanceFunction_.has_value()) {
-      auto& loader = native_loader::NativeLibraryLoader::getDefaultLoader();
-      auto loadedLibrary = loader.loadLibrary(dynamicLibPath_, nullptr);
-      auto newInstance = loader.getFunction<NewInstanceSignature>(
-          "newInstance", loadedLibrary);
-      newInstanceFunction_ = newInstance;
+    if (library_) {
+      std::vector<std::string> names;
+      std::vector<TypePtr> types;
+      for (auto& input : inputs()) {
+        auto field =
+            std::dynamic_pointer_cast<const core::FieldAccessTypedExpr>(input);
+        VELOX_CHECK_NOT_NULL(field);
+        names.push_back(field->name());
+        types.push_back(field->type());
+      }
+      return std::make_unique<HotSwapVectorFunction>(
+          library_,
+          ROW(std::move(names), std::move(types)),
+          fallbackFilter_,
+          fallbackProjections_);
     }
-    auto generatedVectorFunction = newInstanceFunction_.value()();
-    return generatedVectorFunction;
+    return loadGeneratedFunction(dynamicLibPath_);
   }
 
  private:
@@ -118,8 +144,11 @@ class ICompiledCall : public core::CallTypedExpr {
   };
 
   std::filesystem::path dynamicLibPath_;
+  // Set instead of 'dynamicLibPath_' for a call compiled in the background.
+  const std::shared_ptr<const compiler_utils::AsyncLibrary> library_;
+  const core::TypedExprPtr fallbackFilter_;
+  const std::vector<core::TypedExprPtr> fallbackProjections_;
   mutable std::optional<std::string> name_;
-  mutable std::optional<NewInstanceSignature> newInstanceFunction_;
 };
 } // namespace codegen
 } // namespace velox
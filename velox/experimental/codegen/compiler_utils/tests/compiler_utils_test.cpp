@@ -20,6 +20,7 @@
 #include <iostream>
 #include <regex>
 #include "boost/filesystem.hpp"
+#include "velox/experimental/codegen/compiler_utils/BackgroundCompiler.h"
 #include "velox/experimental/codegen/compiler_utils/Compiler.h"
 #include "velox/experimental/codegen/compiler_utils/tests/definitions.h"
 #include "velox/experimental/codegen/external_process/Filesystem.h"
@@ -290,4 +291,67 @@ TEST(Compiler, CompileAndLink) {
   ASSERT_EQ(dlerror(), nullptr);
   ASSERT_EQ(f(), 24);
 };
+
+TEST(Compiler, CachedCompileAndLink) {
+  auto sourceCode = R"a(
+  extern "C" {
+  int f() {
+    return 24;
+  };
+  }
+  )a";
+
+  filesystem::PathGenerator pathGenerator;
+  auto cacheDirectory = pathGenerator.tempPath("cache", "");
+  std::filesystem::remove(cacheDirectory);
+  auto options = testCompilerOptions().withCacheDirectory(cacheDirectory);
+
+  DefaultScopedTimer::EventSequence eventSequence;
+  Compiler compiler(options, eventSequence);
+  auto sharedObject = compiler.compileAndLink(sourceCode);
+  ASSERT_EQ(cacheDirectory, sharedObject.parent_path());
+  ASSERT_GT(std::filesystem::file_size(sharedObject), 0);
+
+  // A second compiler, e.g. of a later process, finds the library.
+  Compiler otherCompiler(options, eventSequence);
+  ASSERT_EQ(sharedObject, otherCompiler.compileAndLink(sourceCode));
+  ASSERT_NE(
+      compiler.fingerprint(sourceCode),
+      compiler.fingerprint(std::string(sourceCode) + " "));
+
+  auto libraryPtr =
+      native_loader::NativeLibraryLoader::loadLibraryInternal(sharedObject);
+  auto f = (int (*)())dlsym(libraryPtr, "f");
+  ASSERT_EQ(f(), 24);
+  std::filesystem::remove_all(cacheDirectory);
+}
+
+TEST(Compiler, BackgroundCompiler) {
+  auto sourceCode = R"a(
+  extern "C" {
+  int g() {
+    return 32;
+  };
+  }
+  )a";
+
+  BackgroundCompiler backgroundCompiler(2);
+  auto options = testCompilerOptions();
+  auto library = backgroundCompiler.compile(options, sourceCode);
+  // The same code is compiled once.
+  ASSERT_EQ(library, backgroundCompiler.compile(options, sourceCode));
+
+  auto sharedObject = library->get();
+  ASSERT_EQ(sharedObject, library->tryGet());
+  ASSERT_FALSE(library->failed());
+  auto libraryPtr =
+      native_loader::NativeLibraryLoader::loadLibraryInternal(sharedObject);
+  auto g = (int (*)())dlsym(libraryPtr, "g");
+  ASSERT_EQ(g(), 32);
+
+  auto failed = backgroundCompiler.compile(options, "not c++");
+  ASSERT_THROW(failed->get(), VeloxException);
+  ASSERT_TRUE(failed->failed());
+  ASSERT_FALSE(failed->tryGet().has_value());
+}
 } // namespace facebook::velox::codegen::compiler_utils::test
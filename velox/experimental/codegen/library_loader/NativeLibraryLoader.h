@@ -126,6 +126,20 @@ class NativeLibraryLoader {
     return libraryPtr;
   }
 
+  /// Returns the library at 'path', loading it at the first call. Libraries
+  /// of the persistent cache are shared by the expressions compiled to the
+  /// same code.
+  void* getOrLoadLibrary(
+      const std::filesystem::path& path,
+      void* initArgument = nullptr) {
+    for (const auto& [libraryPtr, libraryInfo] : loadedLibraries) {
+      if (libraryInfo.path == path) {
+        return libraryPtr;
+      }
+    }
+    return loadLibrary(path, initArgument);
+  }
+
   ///
   /// \tparam Func expected funuction's ype signature
   /// \param functionName function name
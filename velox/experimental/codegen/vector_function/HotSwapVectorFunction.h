@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <mutex>
+#include "velox/experimental/codegen/compiler_utils/BackgroundCompiler.h"
+#include "velox/experimental/codegen/library_loader/NativeLibraryLoader.h"
+#include "velox/experimental/codegen/vector_function/GeneratedVectorFunction-inl.h"
+#include "velox/expression/Expr.h"
+
+namespace facebook::velox::codegen {
+
+/// Returns a new instance of the generated function of the library at
+/// 'path'. Serialized, since the default NativeLibraryLoader is not thread
+/// safe.
+inline std::unique_ptr<GeneratedVectorFunctionBase> loadGeneratedFunction(
+    const std::filesystem::path& path) {
+  using NewInstanceSignature =
+      std::unique_ptr<GeneratedVectorFunctionBase> (*)();
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> l(mutex);
+  auto& loader = native_loader::NativeLibraryLoader::getDefaultLoader();
+  auto* library = loader.getOrLoadLibrary(path, nullptr);
+  return loader.getFunction<NewInstanceSignature>("newInstance", library)();
+}
+
+/// Evaluates the expressions of a compiled call by interpretation until the
+/// background compilation of their code finishes and by the compiled code
+/// after. The swap happens at the first batch after the library is ready
+/// and is seen by all the drivers sharing the function. If the compilation
+/// fails, the expressions stay interpreted.
+///
+/// The arguments are the columns of 'inputType' and the result is a
+/// RowVector of the row type set by setRowType(), like the one of the
+/// compiled code. With a filter, the rows that pass it are projected into
+/// the leading rows of the result, as the ConcatExpression of a merged filter
+/// and projection does.
+class HotSwapVectorFunction : public GeneratedVectorFunctionBase {
+ public:
+  HotSwapVectorFunction(
+      std::shared_ptr<const compiler_utils::AsyncLibrary> library,
+      RowTypePtr inputType,
+      core::TypedExprPtr filter,
+      const std::vector<core::TypedExprPtr>& projections)
+      : library_(std::move(library)),
+        inputType_(std::move(inputType)),
+        hasFilter_(filter != nullptr) {
+    if (filter) {
+      exprs_.push_back(std::move(filter));
+    }
+    exprs_.insert(exprs_.end(), projections.begin(), projections.end());
+  }
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx* context,
+      VectorPtr* result) const override {
+    if (auto compiled = compiledFunction()) {
+      compiled->apply(rows, args, outputType, context, result);
+      return;
+    }
+    interpret(rows, args, context, result);
+  }
+
+  size_t apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx* context,
+      std::vector<VectorPtr>& results) const override {
+    if (auto compiled = compiledFunction()) {
+      return compiled->apply(rows, args, outputType, context, results);
+    }
+    VectorPtr result;
+    interpret(rows, args, context, &result);
+    auto* rowResult = result->as<RowVector>();
+    for (auto i = 0; i < rowResult->childrenSize(); ++i) {
+      results[i] = rowResult->childAt(i);
+    }
+    return result->size();
+  }
+
+  /// True once the compiled code is in use.
+  bool isCompiled() const {
+    return std::atomic_load(&compiled_) != nullptr;
+  }
+
+ private:
+  // Returns the compiled function or nullptr if its library is not ready.
+  std::shared_ptr<GeneratedVectorFunctionBase> compiledFunction() const {
+    if (auto compiled = std::atomic_load(&compiled_)) {
+      return compiled;
+    }
+    auto path = library_->tryGet();
+    if (!path.has_value()) {
+      return nullptr;
+    }
+    std::shared_ptr<GeneratedVectorFunctionBase> compiled =
+        loadGeneratedFunction(path.value());
+    compiled->setRowType(rowType_);
+    // Drivers that race here load the same library. The first one wins.
+    std::shared_ptr<GeneratedVectorFunctionBase> expected;
+    std::atomic_compare_exchange_strong(&compiled_, &expected, compiled);
+    return std::atomic_load(&compiled_);
+  }
+
+  // Evaluates 'exprs_' on a RowVector of 'args'. The ExprSet is made per
+  // batch, since a function is shared by drivers with different ExecCtxs.
+  void interpret(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      exec::EvalCtx* context,
+      VectorPtr* result) const {
+    VELOX_CHECK_NOT_NULL(rowType_);
+    auto* pool = context->pool();
+    auto input = std::make_shared<RowVector>(
+        pool, inputType_, nullptr, rows.end(), args);
+    exec::ExprSet exprSet(exprs_, context->execCtx());
+    exec::EvalCtx evalCtx(context->execCtx(), &exprSet, input.get());
+    std::vector<VectorPtr> results(exprs_.size());
+    if (!hasFilter_) {
+      exprSet.eval(rows, &evalCtx, &results);
+      *result = std::make_shared<RowVector>(
+          pool, rowType_, nullptr, rows.end(), std::move(results));
+      return;
+    }
+
+    exprSet.eval(0, 1, true, rows, &evalCtx, &results);
+    DecodedVector selected(*results[0], rows);
+    SelectivityVector passed(rows.end(), false);
+    std::vector<vector_size_t> passedRows;
+    rows.applyToSelected([&](auto row) {
+      if (!selected.isNullAt(row) && selected.valueAt<bool>(row)) {
+        passed.setValid(row, true);
+        passedRows.push_back(row);
+      }
+    });
+    passed.updateBounds();
+    const vector_size_t numPassed = passedRows.size();
+    if (numPassed > 0) {
+      exprSet.eval(1, exprs_.size(), false, passed, &evalCtx, &results);
+    }
+
+    // The columns are unique, so that the field accesses over the call can
+    // take them over.
+    const SelectivityVector targetRows(numPassed);
+    std::vector<VectorPtr> columns(exprs_.size() - 1);
+    for (auto i = 1; i < exprs_.size(); ++i) {
+      auto& column = columns[i - 1];
+      column = BaseVector::create(exprs_[i]->type(), numPassed, pool);
+      if (numPassed > 0) {
+        column->copy(results[i].get(), targetRows, passedRows.data());
+      }
+      column->setCodegenOutput();
+    }
+    *result = std::make_shared<RowVector>(
+        pool, rowType_, nullptr, numPassed, std::move(columns));
+    (*result)->setCodegenOutput();
+  }
+
+  const std::shared_ptr<const compiler_utils::AsyncLibrary> library_;
+  const RowTypePtr inputType_;
+  const bool hasFilter_;
+  // The filter, if any, followed by the projections.
+  std::vector<core::TypedExprPtr> exprs_;
+  mutable std::shared_ptr<GeneratedVectorFunctionBase> compiled_;
+};
+
+} // namespace facebook::velox::codegen
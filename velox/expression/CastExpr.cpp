@@ -16,6 +16,7 @@
 
 #include "velox/expression/CastExpr.h"
 
+#include <cmath>
 #include <stdexcept>
 
 #include <fmt/format.h>
@@ -25,6 +26,7 @@
 #include "velox/core/CoreTypeSystem.h"
 #include "velox/expression/StringWriter.h"
 #include "velox/external/date/tz.h"
+#include "velox/type/DecimalUtil.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/FunctionVector.h"
 #include "velox/vector/SelectivityVector.h"
@@ -74,6 +76,139 @@ void applyCastKernel(
   }
 }
 
+template <typename T>
+constexpr bool kIsInteger = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+// True if tryFastCast() handles casting 'From' to 'To'. Casting floating
+// point to integers is handled only without cast_to_int_by_truncate.
+template <typename To, typename From>
+constexpr bool hasFastCast() {
+  if constexpr (std::is_same_v<From, StringView>) {
+    return kIsInteger<To> || std::is_floating_point_v<To> ||
+        std::is_same_v<To, Date>;
+  } else if constexpr (kIsInteger<From>) {
+    return std::is_same_v<To, double>;
+  } else if constexpr (std::is_floating_point_v<From>) {
+    return kIsInteger<To>;
+  }
+  return false;
+}
+
+// Parses an optional '-' followed by 1 to 18 digits, which fits in int64_t.
+template <typename T>
+FOLLY_ALWAYS_INLINE bool fastStringToInt(const StringView& value, T& result) {
+  const char* data = value.data();
+  const int32_t size = value.size();
+  const bool negative = size > 0 && data[0] == '-';
+  const int32_t begin = negative ? 1 : 0;
+  if (size == begin || size - begin > 18) {
+    return false;
+  }
+  int64_t number = 0;
+  for (auto i = begin; i < size; ++i) {
+    const uint8_t digit = data[i] - '0';
+    if (digit > 9) {
+      return false;
+    }
+    number = number * 10 + digit;
+  }
+  if (negative) {
+    number = -number;
+  }
+  if (number < std::numeric_limits<T>::min() ||
+      number > std::numeric_limits<T>::max()) {
+    return false;
+  }
+  result = number;
+  return true;
+}
+
+// Parses an optional '-', digits and optionally '.' and more digits, with at
+// most 15 digits in all. The digits and the power of ten are then exact
+// doubles and their quotient is the correctly rounded value.
+FOLLY_ALWAYS_INLINE bool fastStringToDouble(
+    const StringView& value,
+    double& result) {
+  static constexpr double kPowersOfTen[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+      1e13, 1e14, 1e15};
+  const char* data = value.data();
+  const int32_t size = value.size();
+  const bool negative = size > 0 && data[0] == '-';
+  int32_t i = negative ? 1 : 0;
+  int64_t mantissa = 0;
+  int32_t numDigits = 0;
+  int32_t numFractionDigits = 0;
+  int32_t point = -1;
+  for (; i < size; ++i) {
+    const uint8_t digit = data[i] - '0';
+    if (digit <= 9) {
+      mantissa = mantissa * 10 + digit;
+      ++numDigits;
+      numFractionDigits += point >= 0;
+    } else if (data[i] == '.' && point < 0 && numDigits > 0) {
+      point = i;
+    } else {
+      return false;
+    }
+  }
+  if (numDigits == 0 || numDigits > 15 || point == size - 1) {
+    return false;
+  }
+  result = mantissa / kPowersOfTen[numFractionDigits];
+  if (negative) {
+    result = -result;
+  }
+  return true;
+}
+
+// Casts the common forms of input without exceptions. Returns false for all
+// other inputs, including all that the general path rejects, so that the
+// general path produces their result or error. A cast that returns true has
+// the same result as the general path.
+template <typename To, typename From>
+FOLLY_ALWAYS_INLINE bool tryFastCast(const From& from, To& to) {
+  if constexpr (std::is_same_v<From, StringView>) {
+    if constexpr (kIsInteger<To>) {
+      return fastStringToInt(from, to);
+    } else if constexpr (std::is_floating_point_v<To>) {
+      double value;
+      if (!fastStringToDouble(from, value)) {
+        return false;
+      }
+      to = value;
+      return true;
+    } else {
+      int32_t days;
+      if (!util::tryFromDateString(from.data(), from.size(), days)) {
+        return false;
+      }
+      to = Date(days);
+      return true;
+    }
+  } else if constexpr (kIsInteger<From>) {
+    // Integers up to 2^53 are exact doubles.
+    constexpr int64_t kMaxExact = 1LL << 53;
+    if constexpr (sizeof(From) == sizeof(int64_t)) {
+      if (from > kMaxExact || from < -kMaxExact) {
+        return false;
+      }
+    }
+    to = from;
+    return true;
+  } else {
+    // The range of To is [-2^(n-1), 2^(n-1)), whose bounds are exact doubles.
+    // NaN fails both comparisons.
+    const double rounded = std::round(from);
+    constexpr double kMin = std::numeric_limits<To>::min();
+    if (!(rounded >= kMin && rounded < -kMin)) {
+      return false;
+    }
+    to = static_cast<To>(rounded);
+    return true;
+  }
+}
+
 void populateNestedRows(
     const SelectivityVector& rows,
     const vector_size_t* rawSizes,
@@ -98,8 +233,212 @@ std::string makeErrorMessage(
       input.base()->toString(input.index(row)));
 }
 
+// Returns the unscaled value of a SHORT_DECIMAL or LONG_DECIMAL row.
+int128_t decimalValueAt(const DecodedVector& input, vector_size_t row) {
+  if (input.base()->typeKind() == TypeKind::SHORT_DECIMAL) {
+    return input.valueAt<ShortDecimal>(row).unscaledValue();
+  }
+  return input.valueAt<LongDecimal>(row).unscaledValue();
+}
+
+// Parses an optional sign, digits and optionally '.' and more digits, with at
+// most 38 digits in all, into the unscaled value of DECIMAL('precision',
+// 'scale'). Extra fractional digits are rounded half away from zero.
+int128_t parseDecimal(const StringView& value, int precision, int scale) {
+  const char* data = value.data();
+  const int32_t size = value.size();
+  int32_t i = 0;
+  bool negative = false;
+  if (i < size && (data[i] == '-' || data[i] == '+')) {
+    negative = data[i] == '-';
+    ++i;
+  }
+  int128_t unscaled = 0;
+  int32_t numDigits = 0;
+  int32_t numFractionDigits = 0;
+  bool point = false;
+  for (; i < size; ++i) {
+    if (data[i] == '.' && !point) {
+      point = true;
+      continue;
+    }
+    const uint8_t digit = data[i] - '0';
+    VELOX_USER_CHECK_LE(digit, 9, "Invalid decimal digit");
+    VELOX_USER_CHECK_LT(
+        numDigits, LongDecimalType::kMaxPrecision, "Too many decimal digits");
+    unscaled = unscaled * 10 + digit;
+    ++numDigits;
+    numFractionDigits += point;
+  }
+  VELOX_USER_CHECK_GT(numDigits, 0, "Invalid decimal");
+  return DecimalUtil::rescale(
+      negative ? -unscaled : unscaled, numFractionDigits, precision, scale);
+}
+
 } // namespace
 
+void CastExpr::applyDecimalCast(
+    const SelectivityVector& rows,
+    exec::EvalCtx& context,
+    const DecodedVector& input,
+    const TypePtr& fromType,
+    const TypePtr& toType,
+    VectorPtr& result) {
+  // Runs 'castRow' on each row. A user error is a null result with
+  // 'nullOnFailure_'.
+  auto applyRows = [&](auto castRow) {
+    context.applyToSelectedNoThrow(rows, [&](vector_size_t row) {
+      try {
+        castRow(row);
+      } catch (const VeloxUserError& ue) {
+        if (!nullOnFailure_) {
+          VELOX_USER_FAIL(
+              makeErrorMessage(input, row, toType) + " " + ue.message());
+        }
+        result->setNull(row, true);
+      }
+    });
+  };
+
+  if (isDecimalKind(toType->kind())) {
+    int toPrecision;
+    int toScale;
+    getDecimalPrecisionScale(*toType, toPrecision, toScale);
+    auto set = [&](vector_size_t row, int128_t value) {
+      if (toType->kind() == TypeKind::SHORT_DECIMAL) {
+        result->asUnchecked<FlatVector<ShortDecimal>>()->set(
+            row, ShortDecimal(static_cast<int64_t>(value)));
+      } else {
+        result->asUnchecked<FlatVector<LongDecimal>>()->set(
+            row, LongDecimal(value));
+      }
+    };
+    auto fromInteger = [&](auto type) {
+      using T = decltype(type);
+      applyRows([&](vector_size_t row) {
+        set(row,
+            DecimalUtil::rescale(
+                input.valueAt<T>(row), 0, toPrecision, toScale));
+      });
+    };
+    auto fromFloatingPoint = [&](auto type) {
+      using T = decltype(type);
+      const double limit = DecimalUtil::kPowersOfTen[toPrecision];
+      const double factor = DecimalUtil::kPowersOfTen[toScale];
+      applyRows([&](vector_size_t row) {
+        const double value = input.valueAt<T>(row);
+        VELOX_USER_CHECK(std::isfinite(value), "The value is not finite");
+        const double scaled = std::round(value * factor);
+        VELOX_USER_CHECK_LT(std::abs(scaled), limit, "Decimal overflow");
+        set(row, static_cast<int128_t>(scaled));
+      });
+    };
+    switch (fromType->kind()) {
+      case TypeKind::SHORT_DECIMAL:
+      case TypeKind::LONG_DECIMAL: {
+        int fromPrecision;
+        int fromScale;
+        getDecimalPrecisionScale(*fromType, fromPrecision, fromScale);
+        applyRows([&](vector_size_t row) {
+          set(row,
+              DecimalUtil::rescale(
+                  decimalValueAt(input, row), fromScale, toPrecision, toScale));
+        });
+        return;
+      }
+      case TypeKind::BOOLEAN:
+        return fromInteger(bool());
+      case TypeKind::TINYINT:
+        return fromInteger(int8_t());
+      case TypeKind::SMALLINT:
+        return fromInteger(int16_t());
+      case TypeKind::INTEGER:
+        return fromInteger(int32_t());
+      case TypeKind::BIGINT:
+        return fromInteger(int64_t());
+      case TypeKind::REAL:
+        return fromFloatingPoint(float());
+      case TypeKind::DOUBLE:
+        return fromFloatingPoint(double());
+      case TypeKind::VARCHAR:
+        applyRows([&](vector_size_t row) {
+          set(row,
+              parseDecimal(
+                  input.valueAt<StringView>(row), toPrecision, toScale));
+        });
+        return;
+      default:
+        VELOX_UNSUPPORTED(
+            "Cannot cast {} to {}.", fromType->toString(), toType->toString());
+    }
+  }
+
+  int fromPrecision;
+  int fromScale;
+  getDecimalPrecisionScale(*fromType, fromPrecision, fromScale);
+  const auto divisor = DecimalUtil::kPowersOfTen[fromScale];
+  auto toInteger = [&](auto type) {
+    using T = decltype(type);
+    auto* flatResult = result->asUnchecked<FlatVector<T>>();
+    applyRows([&](vector_size_t row) {
+      const auto value =
+          DecimalUtil::divideRoundHalfUp(decimalValueAt(input, row), divisor);
+      VELOX_USER_CHECK(
+          value >= std::numeric_limits<T>::min() &&
+              value <= std::numeric_limits<T>::max(),
+          "Out of bounds");
+      flatResult->set(row, static_cast<T>(value));
+    });
+  };
+  auto toFloatingPoint = [&](auto type) {
+    using T = decltype(type);
+    auto* flatResult = result->asUnchecked<FlatVector<T>>();
+    applyRows([&](vector_size_t row) {
+      flatResult->set(
+          row,
+          static_cast<T>(
+              static_cast<double>(decimalValueAt(input, row)) /
+              static_cast<double>(divisor)));
+    });
+  };
+  switch (toType->kind()) {
+    case TypeKind::BOOLEAN: {
+      auto* flatResult = result->asUnchecked<FlatVector<bool>>();
+      applyRows([&](vector_size_t row) {
+        flatResult->set(row, decimalValueAt(input, row) != 0);
+      });
+      return;
+    }
+    case TypeKind::TINYINT:
+      return toInteger(int8_t());
+    case TypeKind::SMALLINT:
+      return toInteger(int16_t());
+    case TypeKind::INTEGER:
+      return toInteger(int32_t());
+    case TypeKind::BIGINT:
+      return toInteger(int64_t());
+    case TypeKind::REAL:
+      return toFloatingPoint(float());
+    case TypeKind::DOUBLE:
+      return toFloatingPoint(double());
+    case TypeKind::VARCHAR: {
+      auto* flatResult = result->asUnchecked<FlatVector<StringView>>();
+      applyRows([&](vector_size_t row) {
+        const auto output =
+            DecimalUtil::toString(decimalValueAt(input, row), fromScale);
+        auto writer = exec::StringWriter<>(flatResult, row);
+        writer.resize(output.size());
+        std::memcpy(writer.data(), output.data(), output.size());
+        writer.finalize();
+      });
+      return;
+    }
+    default:
+      VELOX_UNSUPPORTED(
+          "Cannot cast {} to {}.", fromType->toString(), toType->toString());
+  }
+}
+
 template <typename To, typename From>
 void CastExpr::applyCastWithTry(
     const SelectivityVector& rows,
@@ -109,9 +448,30 @@ void CastExpr::applyCastWithTry(
   const auto& queryConfig = context.execCtx()->queryCtx()->config();
   auto isCastIntByTruncate = queryConfig.isCastIntByTruncate();
 
+  // Casts the rows in the common forms in one pass without exceptions. The
+  // rest, e.g. invalid, out of range or padded with spaces, take the general
+  // path below, which produces the errors or nulls.
+  LocalSelectivityVector remainingHolder(context);
+  const SelectivityVector* remainingRows = &rows;
+  if constexpr (hasFastCast<To, From>()) {
+    if (!std::is_floating_point_v<From> || !isCastIntByTruncate) {
+      auto* remaining = remainingHolder.get(rows.end(), false);
+      rows.applyToSelected([&](vector_size_t row) {
+        To value;
+        if (tryFastCast<To, From>(input.valueAt<From>(row), value)) {
+          resultFlatVector->set(row, value);
+        } else {
+          remaining->setValid(row, true);
+        }
+      });
+      remaining->updateBounds();
+      remainingRows = remaining;
+    }
+  }
+
   if (!nullOnFailure_) {
     if (!isCastIntByTruncate) {
-      context.applyToSelectedNoThrow(rows, [&](int row) {
+      context.applyToSelectedNoThrow(*remainingRows, [&](int row) {
         try {
           // Passing a false truncate flag
           bool nullOutput = false;
@@ -135,7 +495,7 @@ void CastExpr::applyCastWithTry(
         }
       });
     } else {
-      context.applyToSelectedNoThrow(rows, [&](int row) {
+      context.applyToSelectedNoThrow(*remainingRows, [&](int row) {
         try {
           // Passing a true truncate flag
           bool nullOutput = false;
@@ -161,7 +521,7 @@ void CastExpr::applyCastWithTry(
     }
   } else {
     if (!isCastIntByTruncate) {
-      rows.applyToSelected([&](int row) {
+      remainingRows->applyToSelected([&](int row) {
         // TRY_CAST implementation
         try {
           bool nullOutput = false;
@@ -175,7 +535,7 @@ void CastExpr::applyCastWithTry(
         }
       });
     } else {
-      rows.applyToSelected([&](int row) {
+      remainingRows->applyToSelected([&](int row) {
         // TRY_CAST implementation
         try {
           bool nullOutput = false;
@@ -611,16 +971,21 @@ void CastExpr::apply(
     } else {
       // Handling primitive type conversions
       BaseVector::ensureWritable(rows, toType, context.pool(), &result);
-      // Unwrapping toType pointer. VERY IMPORTANT: dynamic type pointer and
-      // static type templates in each cast must match exactly
-      VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
-          applyCast,
-          toType->kind(),
-          fromType->kind(),
-          *nonNullRows,
-          context,
-          *decoded,
-          result);
+      if (isDecimalKind(fromType->kind()) || isDecimalKind(toType->kind())) {
+        applyDecimalCast(
+            *nonNullRows, context, *decoded, fromType, toType, result);
+      } else {
+        // Unwrapping toType pointer. VERY IMPORTANT: dynamic type pointer
+        // and static type templates in each cast must match exactly
+        VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+            applyCast,
+            toType->kind(),
+            fromType->kind(),
+            *nonNullRows,
+            context,
+            *decoded,
+            result);
+      }
     }
   }
 
@@ -125,6 +125,18 @@ class CastExpr : public SpecialForm {
       const DecodedVector& input,
       VectorPtr& result);
 
+  /// Casts between decimals, from boolean, integer, floating point and
+  /// varchar to decimal and from decimal to those types. Decimals are
+  /// rescaled and rounded half away from zero. A result out of the range of
+  /// the target type is an error, or null with 'nullOnFailure_'.
+  void applyDecimalCast(
+      const SelectivityVector& rows,
+      exec::EvalCtx& context,
+      const DecodedVector& input,
+      const TypePtr& fromType,
+      const TypePtr& toType,
+      VectorPtr& result);
+
   /// Apply the cast after generating the input vectors
   /// @param rows The list of rows being processed
   /// @param input The input vector to be casted
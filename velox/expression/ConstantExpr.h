@@ -35,7 +35,11 @@ class ConstantExpr : public SpecialForm {
             std::vector<ExprPtr>(),
             "literal",
             false /* trackCpuUsage */),
-        needToSetIsAscii_{value->type()->isVarchar()} {
+        needToSetIsAscii_{
+            value->type()->isVarchar() &&
+            !value->asUnchecked<SimpleVector<StringView>>()
+                 ->isAscii(0)
+                 .has_value()} {
     VELOX_CHECK_EQ(value->encoding(), VectorEncoding::Simple::CONSTANT);
     sharedSubexprValues_ = std::move(value);
   }
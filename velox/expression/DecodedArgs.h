@@ -37,7 +37,7 @@ class DecodedArgs {
       const std::vector<VectorPtr>& args,
       exec::EvalCtx* FOLLY_NONNULL context) {
     for (auto& arg : args) {
-      holders_.emplace_back(*context, *arg.get(), rows);
+      holders_.push_back(LocalDecodedVector::shared(*context, *arg, rows));
     }
   }
 
@@ -87,6 +87,14 @@ void EvalCtx::setWrapped(
   } else if (wrapEncoding_ == VectorEncoding::Simple::CONSTANT) {
     localResult = BaseVector::wrapInConstant(
         rows.size(), constantWrapIndex_, std::move(source));
+  } else if (wrapEncoding_ == VectorEncoding::Simple::SEQUENCE) {
+    if (!source) {
+      localResult =
+          BaseVector::createNullConstant(expr->type(), rows.size(), pool());
+    } else {
+      localResult =
+          BaseVector::wrapInSequence(wrap_, rows.size(), std::move(source));
+    }
   } else {
     VELOX_FAIL("Bad expression wrap encoding {}", wrapEncoding_);
   }
@@ -152,9 +160,13 @@ void EvalCtx::restore(ContextSaver& saver) {
   nullsPruned_ = saver.nullsPruned;
   if (errors_) {
     int32_t errorSize = errors_->size();
-    // A constant wrap has no indices.
-    auto indices = wrap_ ? wrap_->as<vector_size_t>() : nullptr;
+    // A constant wrap has no indices. A sequence wrap has run lengths.
+    const bool isSequence = wrapEncoding_ == VectorEncoding::Simple::SEQUENCE;
+    auto lengths = isSequence ? wrap_->as<vector_size_t>() : nullptr;
+    auto indices = wrap_ && !isSequence ? wrap_->as<vector_size_t>() : nullptr;
     auto wrapNulls = wrapNulls_ ? wrapNulls_->as<uint64_t>() : nullptr;
+    vector_size_t run = -1;
+    vector_size_t runEnd = 0;
     SelectivityIterator iter(*saver.rows);
     vector_size_t row;
     while (iter.next(row)) {
@@ -162,7 +174,16 @@ void EvalCtx::restore(ContextSaver& saver) {
       if (wrapNulls && bits::isBitNull(wrapNulls, row)) {
         continue;
       }
-      vector_size_t innerRow = indices ? indices[row] : constantWrapIndex_;
+      vector_size_t innerRow;
+      if (lengths) {
+        // The rows are visited in ascending order.
+        while (row >= runEnd) {
+          runEnd += lengths[++run];
+        }
+        innerRow = run;
+      } else {
+        innerRow = indices ? indices[row] : constantWrapIndex_;
+      }
       if (innerRow < errorSize && !errors_->isNullAt(innerRow)) {
         addError(
             row,
@@ -208,6 +229,48 @@ const VectorPtr& EvalCtx::getField(int32_t index) const {
   return *field;
 }
 
+const VectorPtr* EvalCtx::findField(const BaseVector& vector) const {
+  if (!row_) {
+    return nullptr;
+  }
+  const auto& fields = peeledFields_.empty() ? row_->children() : peeledFields_;
+  for (auto i = 0; i < fields.size(); ++i) {
+    if (fields[i] && getField(i).get() == &vector) {
+      return &getField(i);
+    }
+  }
+  return nullptr;
+}
+
+DecodedVector* EvalCtx::sharedDecodedField(
+    const BaseVector& vector,
+    const SelectivityVector& rows) {
+  switch (vector.encoding()) {
+    case VectorEncoding::Simple::DICTIONARY:
+    case VectorEncoding::Simple::SEQUENCE:
+    case VectorEncoding::Simple::LAZY:
+      break;
+    default:
+      return nullptr;
+  }
+  for (auto& decodedField : decodedFields_) {
+    if (decodedField.field.get() == &vector && decodedField.rows == rows) {
+      return decodedField.decoded.get();
+    }
+  }
+  if (decodedFields_.size() >= kMaxDecodedFields) {
+    return nullptr;
+  }
+  auto field = findField(vector);
+  if (!field) {
+    return nullptr;
+  }
+  auto decoded = std::make_unique<DecodedVector>(vector, rows);
+  auto* rawDecoded = decoded.get();
+  decodedFields_.push_back({*field, rows, std::move(decoded)});
+  return rawDecoded;
+}
+
 void EvalCtx::ensureFieldLoaded(int32_t index, const SelectivityVector& rows) {
   auto field = getField(index);
   if (isLazyNotLoaded(*field)) {
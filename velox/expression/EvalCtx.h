@@ -187,6 +187,15 @@ class EvalCtx {
     wrapNulls_ = std::move(wrapNulls);
   }
 
+  // Sets the run lengths of a sequence as the wrap of the peeled results,
+  // so that a result evaluated once per run stays run-length encoded. The
+  // sequence must cover all the rows being evaluated.
+  void setSequenceWrap(BufferPtr lengths) {
+    wrapEncoding_ = VectorEncoding::Simple::SEQUENCE;
+    wrap_ = std::move(lengths);
+    wrapNulls_ = nullptr;
+  }
+
   // Copy "rows" of localResult into results if "result" is partially populated
   // and must be preserved. Copy localResult pointer into result otherwise.
   void moveOrCopyResult(
@@ -208,7 +217,30 @@ class EvalCtx {
     moveOrCopyResult(localResult, rows, *result);
   }
 
+  // Returns a DecodedVector of 'vector' for 'rows' that is shared by all
+  // functions of the batch that decode the same column for the same rows, so
+  // that a dictionary column referenced by many functions is decoded once.
+  // Returns nullptr if 'vector' is not a dictionary, sequence or lazy column
+  // of the input, since other encodings decode in constant time. The result
+  // must not be decoded again.
+  DecodedVector* FOLLY_NULLABLE
+  sharedDecodedField(const BaseVector& vector, const SelectivityVector& rows);
+
  private:
+  struct DecodedField {
+    // Keeps the column alive so that its address is not reused.
+    VectorPtr field;
+    SelectivityVector rows;
+    std::unique_ptr<DecodedVector> decoded;
+  };
+
+  // Bounds the memory held for shared decodings, e.g. under an IF with many
+  // distinct row sets.
+  static constexpr int32_t kMaxDecodedFields = 32;
+
+  // Returns the column of the input that is 'vector' or nullptr.
+  const VectorPtr* FOLLY_NULLABLE findField(const BaseVector& vector) const;
+
   core::ExecCtx* const FOLLY_NONNULL execCtx_;
   ExprSet* FOLLY_NULLABLE const exprSet_;
   const RowVector* FOLLY_NULLABLE row_;
@@ -238,6 +270,10 @@ class EvalCtx {
   // in a opaque flat vector, which will translate to a
   // std::shared_ptr<std::exception_ptr>.
   ErrorVectorPtr errors_;
+
+  // Decodings of input columns shared by the functions of the batch. The
+  // EvalCtx lives for one batch, so these need no invalidation.
+  std::vector<DecodedField> decodedFields_;
 };
 
 struct ContextSaver {
@@ -394,8 +430,25 @@ class LocalDecodedVector {
       bool loadLazy = true)
       : LocalDecodedVector(*context, vector, rows, loadLazy) {}
 
+  // Decodes 'vector' for 'rows' or uses the decoding shared by the other
+  // functions of the batch, see EvalCtx::sharedDecodedField. The result
+  // must not be decoded again.
+  static LocalDecodedVector shared(
+      EvalCtx& context,
+      const BaseVector& vector,
+      const SelectivityVector& rows) {
+    LocalDecodedVector holder(context);
+    holder.shared_ = context.sharedDecodedField(vector, rows);
+    if (!holder.shared_) {
+      holder.get()->decode(vector, rows);
+    }
+    return holder;
+  }
+
   LocalDecodedVector(LocalDecodedVector&& other) noexcept
-      : context_{other.context_}, vector_{std::move(other.vector_)} {}
+      : context_{other.context_},
+        vector_{std::move(other.vector_)},
+        shared_{other.shared_} {}
 
   ~LocalDecodedVector() {
     if (vector_) {
@@ -404,6 +457,9 @@ class LocalDecodedVector {
   }
 
   DecodedVector* FOLLY_NONNULL get() {
+    if (shared_) {
+      return shared_;
+    }
     if (!vector_) {
       vector_ = context_.getDecodedVector();
     }
@@ -412,28 +468,34 @@ class LocalDecodedVector {
 
   // Must either use the constructor that provides data or call get() first.
   DecodedVector& operator*() {
-    VELOX_DCHECK_NOT_NULL(vector_, "get() must be called.");
-    return *vector_;
+    return *decoded();
   }
 
   const DecodedVector& operator*() const {
-    VELOX_DCHECK_NOT_NULL(vector_, "get() must be called.");
-    return *vector_;
+    return *decoded();
   }
 
   DecodedVector* FOLLY_NONNULL operator->() {
-    VELOX_DCHECK_NOT_NULL(vector_, "get() must be called.");
-    return vector_.get();
+    return decoded();
   }
 
   const DecodedVector* FOLLY_NONNULL operator->() const {
+    return decoded();
+  }
+
+ private:
+  DecodedVector* FOLLY_NONNULL decoded() const {
+    if (shared_) {
+      return shared_;
+    }
     VELOX_DCHECK_NOT_NULL(vector_, "get() must be called.");
     return vector_.get();
   }
 
- private:
   core::ExecCtx& context_;
   std::unique_ptr<DecodedVector> vector_;
+  // Owned by the EvalCtx if set.
+  DecodedVector* FOLLY_NULLABLE shared_{nullptr};
 };
 
 } // namespace facebook::velox::exec
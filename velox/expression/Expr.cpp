@@ -425,6 +425,34 @@ void setDictionaryWrapping(
   context.setDictionaryWrap(
       std::move(wrapping.indices), std::move(wrapping.nulls));
 }
+
+// Returns true if the result of evaluating the values of 'firstWrapper' can be
+// wrapped in its run lengths. This is the case for a single null free
+// sequence that covers all of 'rows' when no enclosing conditional limits the
+// rows. Otherwise the result is wrapped in a dictionary.
+bool canWrapInSequence(
+    const SelectivityVector& rows,
+    const BaseVector& firstWrapper,
+    int numLevels,
+    const EvalCtx& context) {
+  return numLevels == 1 &&
+      firstWrapper.encoding() == VectorEncoding::Simple::SEQUENCE &&
+      !firstWrapper.rawNulls() && context.isFinalSelection() &&
+      rows.isAllSelected() && rows.size() == firstWrapper.size();
+}
+
+void setPeeledWrapping(
+    DecodedVector& decoded,
+    const SelectivityVector& rows,
+    BaseVector& firstWrapper,
+    bool wrapInSequence,
+    EvalCtx& context) {
+  if (wrapInSequence) {
+    context.setSequenceWrap(firstWrapper.wrapInfo());
+  } else {
+    setDictionaryWrapping(decoded, rows, firstWrapper, context);
+  }
+}
 } // namespace
 
 Expr::PeelEncodingsResult Expr::peelEncodings(
@@ -547,13 +575,16 @@ Expr::PeelEncodingsResult Expr::peelEncodings(
           *context.finalSelection(), *decoded, finalRowsHolder);
     }
 
+    const bool wrapInSequence =
+        canWrapInSequence(rows, *firstWrapper, numLevels, context);
     context.saveAndReset(saver, rows);
 
     if (!context.isFinalSelection()) {
       *context.mutableFinalSelection() = newFinalSelection;
     }
 
-    setDictionaryWrapping(*decoded, rowsToDecode, *firstWrapper, context);
+    setPeeledWrapping(
+        *decoded, rowsToDecode, *firstWrapper, wrapInSequence, context);
   }
   int numPeeled = 0;
   for (int i = 0; i < peeledVectors.size(); ++i) {
@@ -789,7 +820,11 @@ void Expr::evalWithMemo(
     return;
   }
   baseDictionary_ = base;
-  evalWithNulls(rows, context, result);
+  if (useValueMemo(*base)) {
+    evalWithValueMemo(rows, context, *base, result);
+  } else {
+    evalWithNulls(rows, context, result);
+  }
   dictionaryCache_ = result;
   if (!cachedDictionaryIndices_) {
     cachedDictionaryIndices_ =
@@ -799,6 +834,122 @@ void Expr::evalWithMemo(
   deselectErrors(context, *cachedDictionaryIndices_);
 }
 
+namespace {
+// Bounds of the cross-batch value memo of an Expr.
+constexpr vector_size_t kMaxValueMemoEntries = 10'000;
+constexpr int64_t kMaxValueMemoBytes = 16 << 20;
+
+// The value memo is dropped if fewer than 1/4 of this many lookups hit.
+constexpr int64_t kMinValueMemoProbes = 100'000;
+} // namespace
+
+bool Expr::useValueMemo(const BaseVector& base) {
+  if (!valueMemoEnabled_ || !vectorFunction_) {
+    return false;
+  }
+  auto kind = base.typeKind();
+  if (kind != TypeKind::VARCHAR && kind != TypeKind::VARBINARY) {
+    return false;
+  }
+  if (numValueMemoProbes_ >= kMinValueMemoProbes &&
+      numValueMemoHits_ * 4 < numValueMemoProbes_) {
+    valueMemoEnabled_ = false;
+    clearValueMemo();
+    return false;
+  }
+  return true;
+}
+
+void Expr::evalWithValueMemo(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    const BaseVector& base,
+    VectorPtr& result) {
+  LocalSelectivityVector missesHolder(context, rows);
+  auto misses = missesHolder.get();
+  assert(misses); // lint
+  std::vector<vector_size_t> memoRows;
+  const auto numRows = rows.countSelected();
+  auto numMisses = numRows;
+  if (!valueMemo_.empty()) {
+    memoRows.resize(rows.end());
+    rows.applyToSelected([&](auto row) {
+      if (base.isNullAt(row)) {
+        return;
+      }
+      ++numValueMemoProbes_;
+      auto it = valueMemo_.find(base.hashValueAt(row));
+      if (it != valueMemo_.end() &&
+          valueMemoInputs_->equalValueAt(&base, it->second, row)) {
+        memoRows[row] = it->second;
+        misses->setValid(row, false);
+      }
+    });
+    misses->updateBounds();
+    numMisses = misses->countSelected();
+    numValueMemoHits_ += numRows - numMisses;
+  } else {
+    numValueMemoProbes_ += numRows;
+  }
+
+  if (numMisses < numRows) {
+    LocalSelectivityVector hitsHolder(context, rows);
+    auto hits = hitsHolder.get();
+    assert(hits); // lint
+    hits->deselect(*misses);
+    BaseVector::ensureWritable(rows, type(), context.pool(), &result);
+    result->copy(valueMemoResults_.get(), *hits, memoRows.data());
+  }
+  if (!misses->hasSelections()) {
+    return;
+  }
+  // Fix finalSelection at "rows" if the misses are a strict subset to avoid
+  // losing the values copied from the memo.
+  bool updateFinalSelection = context.isFinalSelection() && numMisses < numRows;
+  VarSetter finalSelectionMemo(
+      context.mutableFinalSelection(), &rows, updateFinalSelection);
+  VarSetter isFinalSelectionMemo(
+      context.mutableIsFinalSelection(), false, updateFinalSelection);
+  evalWithNulls(*misses, context, result);
+  deselectErrors(context, *misses);
+  addToValueMemo(*misses, context, base, *result);
+}
+
+void Expr::addToValueMemo(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    const BaseVector& base,
+    const BaseVector& result) {
+  if (!valueMemoInputs_) {
+    valueMemoInputs_ = BaseVector::create(base.type(), 0, context.pool());
+    valueMemoResults_ = BaseVector::create(type(), 0, context.pool());
+  }
+  auto size = valueMemoInputs_->size();
+  const auto capacity = std::min<vector_size_t>(
+      kMaxValueMemoEntries, size + rows.countSelected());
+  if (size >= capacity || valueMemoBytes_ >= kMaxValueMemoBytes) {
+    return;
+  }
+  valueMemoInputs_->resize(capacity);
+  valueMemoResults_->resize(capacity);
+  auto* strings = base.asUnchecked<SimpleVector<StringView>>();
+  rows.testSelected([&](auto row) {
+    if (size >= capacity || valueMemoBytes_ >= kMaxValueMemoBytes) {
+      return false;
+    }
+    if (!base.isNullAt(row) &&
+        valueMemo_.emplace(base.hashValueAt(row), size).second) {
+      valueMemoInputs_->copy(&base, size, row, 1);
+      valueMemoResults_->copy(&result, size, row, 1);
+      valueMemoBytes_ += strings->valueAt(row).size();
+      ++size;
+    }
+    return true;
+  });
+  valueMemoInputs_->resize(size);
+  valueMemoResults_->resize(size);
+}
+
 void Expr::setAllNulls(
     const SelectivityVector& rows,
     EvalCtx& context,
@@ -1091,8 +1242,10 @@ bool Expr::applyFunctionWithPeeling(
     auto decoded = localDecoded.get();
     decoded->makeIndices(*firstWrapper, rows, numLevels);
     newRows = translateToInnerRows(applyRows, *decoded, newRowsHolder);
+    const bool wrapInSequence =
+        canWrapInSequence(applyRows, *firstWrapper, numLevels, context);
     context.saveAndReset(saver, rows);
-    setDictionaryWrapping(*decoded, rows, *firstWrapper, context);
+    setPeeledWrapping(*decoded, rows, *firstWrapper, wrapInSequence, context);
   }
 
   VectorPtr peeledResult;
@@ -125,6 +125,7 @@ class Expr {
     baseDictionary_ = nullptr;
     dictionaryCache_ = nullptr;
     cachedDictionaryIndices_ = nullptr;
+    clearValueMemo();
   }
 
   const TypePtr& type() const {
@@ -223,6 +224,33 @@ class Expr {
       EvalCtx& context,
       VectorPtr& result);
 
+  // Returns true if the results for a new dictionary base 'base' are looked
+  // up in and added to the cross-batch value memo.
+  bool useValueMemo(const BaseVector& base);
+
+  // Evaluates 'this' on 'rows' of a new dictionary base 'base'. Takes the
+  // results for values seen in earlier batches from the value memo and
+  // evaluates the rest.
+  void evalWithValueMemo(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      const BaseVector& base,
+      VectorPtr& result);
+
+  // Adds the values of 'base' and 'result' at 'rows' to the value memo.
+  void addToValueMemo(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      const BaseVector& base,
+      const BaseVector& result);
+
+  void clearValueMemo() {
+    valueMemoInputs_ = nullptr;
+    valueMemoResults_ = nullptr;
+    valueMemo_.clear();
+    valueMemoBytes_ = 0;
+  }
+
   void evalWithNulls(
       const SelectivityVector& rows,
       EvalCtx& context,
@@ -362,6 +390,28 @@ class Expr {
   // Count of times the cacheable vector is seen for a non-first time.
   int32_t numCacheableRepeats_{0};
 
+  // Cross-batch memo for a function of one VARCHAR or VARBINARY field whose
+  // dictionary base changes between batches while its values repeat, e.g. a
+  // JSON or URL column of a joined dimension table. 'valueMemoInputs_' and
+  // 'valueMemoResults_' hold up to kMaxValueMemoEntries distinct inputs and
+  // the results for these.
+  VectorPtr valueMemoInputs_;
+  VectorPtr valueMemoResults_;
+
+  // The hash of an input value to its position in 'valueMemoInputs_'. A value
+  // whose hash collides with a memoized value is not memoized.
+  folly::F14FastMap<uint64_t, vector_size_t> valueMemo_;
+
+  // Bytes of the strings in 'valueMemoInputs_'.
+  int64_t valueMemoBytes_{0};
+
+  // False after the memo is found to have too few hits.
+  bool valueMemoEnabled_{true};
+
+  // Count of non-null rows looked up in the value memo and of rows found.
+  int64_t numValueMemoProbes_{0};
+  int64_t numValueMemoHits_{0};
+
   /// Runtime statistics. CPU time, wall time and number of processed rows.
   ExprStats stats_;
 };
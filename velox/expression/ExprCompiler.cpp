@@ -74,6 +74,9 @@ struct Scope {
   // The enclosing scope, nullptr if top level scope.
   Scope* parent{nullptr};
   ExprSet* exprSet{nullptr};
+  // Folded constants shared with the other ExprSets of the query. nullptr if
+  // disabled.
+  ExprCompileCache* cache{nullptr};
 
   // Field names of an enclosing scope referenced from this or an inner scope.
   std::vector<std::string> capture;
@@ -84,8 +87,12 @@ struct Scope {
   // Deduplicatable ITypedExprs. Only applies within the one scope.
   ExprDedupMap visited;
 
-  Scope(std::vector<std::string>&& _locals, Scope* _parent, ExprSet* _exprSet)
-      : locals(_locals), parent(_parent), exprSet(_exprSet) {}
+  Scope(
+      std::vector<std::string>&& _locals,
+      Scope* _parent,
+      ExprSet* _exprSet,
+      ExprCompileCache* _cache)
+      : locals(_locals), parent(_parent), exprSet(_exprSet), cache(_cache) {}
 
   void addCapture(FieldReference* reference, const ITypedExpr* fieldAccess) {
     capture.emplace_back(reference->field());
@@ -240,7 +247,8 @@ std::shared_ptr<Expr> compileLambda(
     bool enableConstantFolding) {
   auto signature = lambda->signature();
   auto parameterNames = signature->names();
-  Scope lambdaScope(std::move(parameterNames), scope, scope->exprSet);
+  Scope lambdaScope(
+      std::move(parameterNames), scope, scope->exprSet, scope->cache);
   auto body = compileExpression(
       lambda->body(), &lambdaScope, config, pool, enableConstantFolding);
 
@@ -271,7 +279,10 @@ std::shared_ptr<Expr> compileLambda(
       config.exprTrackCpuUsage());
 }
 
-ExprPtr tryFoldIfConstant(const ExprPtr& expr, Scope* scope) {
+ExprPtr tryFoldIfConstant(
+    const TypedExprPtr& typedExpr,
+    const ExprPtr& expr,
+    Scope* scope) {
   if (expr->isDeterministic() && !expr->inputs().empty() &&
       scope->exprSet->execCtx()) {
     try {
@@ -290,6 +301,9 @@ ExprPtr tryFoldIfConstant(const ExprPtr& expr, Scope* scope) {
       SelectivityVector rows(1);
       expr->eval(rows, context, result);
       auto constantVector = BaseVector::wrapInConstant(1, 0, result);
+      if (scope->cache) {
+        constantVector = scope->cache->setConstant(typedExpr, constantVector);
+      }
 
       return std::make_shared<ConstantExpr>(constantVector);
     }
@@ -305,6 +319,9 @@ ExprPtr tryFoldIfConstant(const ExprPtr& expr, Scope* scope) {
     // instance, if other arguments are all null in a function with default null
     // behavior), the query won't fail.
     catch (const std::exception&) {
+      if (scope->cache) {
+        scope->cache->setNotFoldable(typedExpr);
+      }
     }
   }
   return expr;
@@ -341,6 +358,16 @@ ExprPtr compileExpression(
     return alreadyCompiled;
   }
 
+  // Another driver of the query may have folded 'expr' already.
+  bool notFoldable = false;
+  if (enableConstantFolding && scope->cache) {
+    if (auto constant = scope->cache->constant(expr.get(), notFoldable)) {
+      auto folded = std::make_shared<ConstantExpr>(std::move(constant));
+      scope->visited[expr.get()] = folded;
+      return folded;
+    }
+  }
+
   const bool trackCpuUsage = config.exprTrackCpuUsage();
 
   ExprPtr result;
@@ -438,20 +465,77 @@ ExprPtr compileExpression(
 
   result->computeMetadata();
 
-  auto folded =
-      enableConstantFolding ? tryFoldIfConstant(result, scope) : result;
+  auto folded = enableConstantFolding && !notFoldable
+      ? tryFoldIfConstant(expr, result, scope)
+      : result;
   scope->visited[expr.get()] = folded;
   return folded;
 }
 
 } // namespace
 
+ExprCompileCache::ExprCompileCache(memory::MemoryPool* pool)
+    : pool_(pool->addScopedChild("expr_compile_cache")) {}
+
+// static
+std::shared_ptr<ExprCompileCache> ExprCompileCache::get(
+    core::ExecCtx* execCtx) {
+  auto* queryCtx = execCtx->queryCtx();
+  if (!queryCtx->config().exprCompileCacheEnabled()) {
+    return nullptr;
+  }
+  return queryCtx->exprCompileCache([queryCtx]() {
+    return std::make_shared<ExprCompileCache>(queryCtx->pool());
+  });
+}
+
+VectorPtr ExprCompileCache::constant(
+    const core::ITypedExpr* expr,
+    bool& notFoldable) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(expr);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  ++numHits_;
+  notFoldable = it->second.constant == nullptr;
+  return it->second.constant;
+}
+
+VectorPtr ExprCompileCache::setConstant(
+    const core::TypedExprPtr& expr,
+    const VectorPtr& value) {
+  // Copies the value so that it does not reference the memory of the driver
+  // that folded it. The Exprs of many drivers share the constant, so its
+  // ASCII-ness is set here, before it is published.
+  auto copy = BaseVector::create(value->type(), 1, pool_.get());
+  copy->copy(value.get(), 0, 0, 1);
+  auto constant = BaseVector::wrapInConstant(1, 0, copy);
+  if (constant->type()->isVarchar()) {
+    auto* simple = constant->asUnchecked<SimpleVector<StringView>>();
+    simple->setAllIsAscii(simple->computeAndSetIsAscii(SelectivityVector(1)));
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& entry = entries_[expr.get()];
+  if (!entry.constant) {
+    entry.expr = expr;
+    entry.constant = std::move(constant);
+  }
+  return entry.constant;
+}
+
+void ExprCompileCache::setNotFoldable(const core::TypedExprPtr& expr) {
+  std::lock_guard<std::mutex> l(mutex_);
+  entries_.try_emplace(expr.get(), Entry{expr, nullptr});
+}
+
 std::vector<std::shared_ptr<Expr>> compileExpressions(
     std::vector<TypedExprPtr>&& sources,
     core::ExecCtx* execCtx,
     ExprSet* exprSet,
     bool enableConstantFolding) {
-  Scope scope({}, nullptr, exprSet);
+  auto cache = ExprCompileCache::get(execCtx);
+  Scope scope({}, nullptr, exprSet, cache.get());
   std::vector<std::shared_ptr<Expr>> exprs;
   exprs.reserve(sources.size());
 
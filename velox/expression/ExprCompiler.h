@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include <folly/container/F14Map.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include "velox/core/Expressions.h"
 #include "velox/core/QueryCtx.h"
 
@@ -25,6 +28,46 @@ namespace facebook::velox::exec {
 class Expr;
 class ExprSet;
 
+// Results of constant folding shared by the ExprSets of one query. The
+// drivers of a pipeline compile the same ITypedExpr trees of the plan, so the
+// entries are keyed on the address of the ITypedExpr and keep it alive. A
+// folded constant is copied into 'pool' so that it outlives the driver that
+// folded it. Expressions whose folding throws are remembered and not folded
+// again. Enabled with QueryConfig::kExprCompileCacheEnabled. Thread-safe.
+class ExprCompileCache {
+ public:
+  explicit ExprCompileCache(memory::MemoryPool* FOLLY_NONNULL pool);
+
+  // Returns the cache of the query of 'execCtx' or nullptr if disabled.
+  static std::shared_ptr<ExprCompileCache> get(core::ExecCtx* execCtx);
+
+  // Returns the folded value of 'expr' as a constant vector of size 1 or
+  // nullptr if not known. Sets 'notFoldable' if folding 'expr' failed before.
+  VectorPtr constant(const core::ITypedExpr* expr, bool& notFoldable);
+
+  // Records 'value' as the folded value of 'expr'. Returns the copy to use in
+  // place of 'value'.
+  VectorPtr setConstant(const core::TypedExprPtr& expr, const VectorPtr& value);
+
+  void setNotFoldable(const core::TypedExprPtr& expr);
+
+  int64_t numHits() const {
+    return numHits_;
+  }
+
+ private:
+  struct Entry {
+    core::TypedExprPtr expr;
+    // Constant vector of size 1. nullptr if not foldable.
+    VectorPtr constant;
+  };
+
+  const std::unique_ptr<memory::MemoryPool> pool_;
+  std::mutex mutex_;
+  folly::F14FastMap<const core::ITypedExpr*, Entry> entries_;
+  std::atomic<int64_t> numHits_{0};
+};
+
 std::vector<std::shared_ptr<Expr>> compileExpressions(
     std::vector<core::TypedExprPtr>&& sources,
     core::ExecCtx* execCtx,
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/expression/LambdaExpr.h"
+#include <folly/ScopeGuard.h>
 #include "velox/expression/FieldReference.h"
 #include "velox/vector/FunctionVector.h"
 
@@ -45,33 +46,96 @@ class ExprCallable : public Callable {
       EvalCtx* context,
       const std::vector<VectorPtr>& args,
       VectorPtr* result) override {
-    std::vector<VectorPtr> allVectors = args;
-    for (auto index = args.size(); index < capture_->childrenSize(); ++index) {
-      auto values = capture_->childAt(index);
-      if (wrapCapture) {
-        values = BaseVector::wrapInDictionary(
-            BufferPtr(nullptr), wrapCapture, rows.end(), values);
-      }
-      allVectors.push_back(values);
-    }
-    auto row = std::make_shared<RowVector>(
-        context->pool(),
-        capture_->type(),
-        BufferPtr(nullptr),
-        rows.end(),
-        std::move(allVectors));
-    EvalCtx lambdaCtx(context->execCtx(), context->exprSet(), row.get());
+    auto* row = lambdaRow(rows, wrapCapture, args, context->pool());
+    EvalCtx lambdaCtx(context->execCtx(), context->exprSet(), row);
     if (!context->isFinalSelection()) {
       *lambdaCtx.mutableIsFinalSelection() = false;
       *lambdaCtx.mutableFinalSelection() = context->finalSelection();
     }
+    SCOPE_EXIT {
+      // Drops the references to 'args' so that the caller may reuse them.
+      if (lambdaRow_.use_count() > 1) {
+        lambdaRow_.reset();
+        return;
+      }
+      for (auto i = 0; i < args.size(); ++i) {
+        lambdaRow_->childAt(i) = nullptr;
+      }
+    };
     body_->eval(rows, lambdaCtx, *result);
   }
 
  private:
+  // Returns the input of 'body_' with 'args' followed by the captures. The
+  // dictionary wrappers of the captures and the RowVector are kept for the
+  // next call so that iterated calls with the same 'wrapCapture', e.g. the
+  // steps of reduce, do not allocate them again.
+  RowVector* lambdaRow(
+      const SelectivityVector& rows,
+      const BufferPtr& wrapCapture,
+      const std::vector<VectorPtr>& args,
+      memory::MemoryPool* pool) {
+    if (!canReuseLambdaRow(rows, wrapCapture, args)) {
+      wrappedCaptures_.clear();
+      std::vector<VectorPtr> allVectors = args;
+      for (auto index = args.size(); index < capture_->childrenSize();
+           ++index) {
+        auto values = capture_->childAt(index);
+        if (wrapCapture) {
+          values = BaseVector::wrapInDictionary(
+              BufferPtr(nullptr), wrapCapture, rows.end(), values);
+        }
+        wrappedCaptures_.push_back(values);
+        allVectors.push_back(values);
+      }
+      lambdaRow_ = std::make_shared<RowVector>(
+          pool,
+          capture_->type(),
+          BufferPtr(nullptr),
+          rows.end(),
+          std::move(allVectors));
+      lambdaRowWrap_ = wrapCapture;
+      return lambdaRow_.get();
+    }
+    for (auto i = 0; i < args.size(); ++i) {
+      lambdaRow_->childAt(i) = args[i];
+    }
+    return lambdaRow_.get();
+  }
+
+  // True if 'lambdaRow_' is not referenced from elsewhere and has the
+  // captures for 'rows' and 'wrapCapture'. The row may be larger than
+  // 'rows', as in the later steps of reduce, but not larger than 'args'. The
+  // captures are compared since loading lazy captures replaces them in the
+  // row.
+  bool canReuseLambdaRow(
+      const SelectivityVector& rows,
+      const BufferPtr& wrapCapture,
+      const std::vector<VectorPtr>& args) const {
+    if (!lambdaRow_ || lambdaRow_.use_count() > 1 ||
+        lambdaRow_->size() < rows.end() || lambdaRowWrap_ != wrapCapture) {
+      return false;
+    }
+    for (auto& arg : args) {
+      if (arg->size() < lambdaRow_->size()) {
+        return false;
+      }
+    }
+    auto numArgs = capture_->childrenSize() - wrappedCaptures_.size();
+    for (auto i = 0; i < wrappedCaptures_.size(); ++i) {
+      if (lambdaRow_->childAt(numArgs + i) != wrappedCaptures_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   std::shared_ptr<const RowType> signature_;
   RowVectorPtr capture_;
   std::shared_ptr<Expr> body_;
+  RowVectorPtr lambdaRow_;
+  BufferPtr lambdaRowWrap_;
+  std::vector<VectorPtr> wrappedCaptures_;
 };
 
 } // namespace
@@ -204,17 +204,20 @@ class SimpleFunctionAdapter : public VectorFunction {
     if constexpr (isVariadicType<arg_at<POSITION>>::value) {
       // Decode the underlying arguments of the Variadic type.
       for (int i = POSITION; i < args.size(); ++i) {
-        decodedArgs.emplace_back(context, *args[i], rows);
+        decodedArgs.push_back(
+            LocalDecodedVector::shared(*context, *args[i], rows));
       }
     } else if constexpr (isArgFlatConstantFastPathEligible<POSITION>) {
       if (decodePrimitives) {
-        decodedArgs.emplace_back(context, *args[POSITION], rows);
+        decodedArgs.push_back(
+            LocalDecodedVector::shared(*context, *args[POSITION], rows));
       } else {
         // If we're skipping decoding this argument, add a dummy value.
         decodedArgs.emplace_back(context);
       }
     } else {
-      decodedArgs.emplace_back(context, *args[POSITION], rows);
+      decodedArgs.push_back(
+          LocalDecodedVector::shared(*context, *args[POSITION], rows));
     }
 
     decodeArgs<POSITION + 1>(
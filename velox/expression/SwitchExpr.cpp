@@ -15,14 +15,197 @@
  */
 #include "velox/expression/SwitchExpr.h"
 #include "velox/expression/BooleanMix.h"
+#include "velox/expression/ConstantExpr.h"
+#include "velox/expression/FieldReference.h"
 #include "velox/expression/VarSetter.h"
 
 namespace facebook::velox::exec {
+namespace {
+
+constexpr vector_size_t kNoCase = -1;
+
+bool isLookupKeyType(const Type& type) {
+  switch (type.kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::DATE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isConstant(const ExprPtr& expr) {
+  return dynamic_cast<const ConstantExpr*>(expr.get()) != nullptr;
+}
+
+// Returns the evaluation of constant 'expr' on one row.
+VectorPtr evalConstant(const ExprPtr& expr, EvalCtx& context) {
+  LocalSelectivityVector singleRow(context);
+  VectorPtr value;
+  expr->eval(*singleRow.get(1, true), context, value);
+  return value;
+}
+} // namespace
+
+void SwitchExpr::initializeLookup() {
+  if (numCases_ < kMinLookupCases) {
+    return;
+  }
+  const FieldReference* field = nullptr;
+  for (auto i = 0; i < numCases_; ++i) {
+    auto& condition = inputs_[2 * i];
+    if (condition->name() != "eq" || condition->inputs().size() != 2 ||
+        !isConstant(inputs_[2 * i + 1])) {
+      return;
+    }
+    auto& left = condition->inputs()[0];
+    auto& right = condition->inputs()[1];
+    auto& key = isConstant(left) ? left : right;
+    auto& column = isConstant(left) ? right : left;
+    auto* reference = dynamic_cast<const FieldReference*>(column.get());
+    if (!reference || !reference->inputs().empty() || !isConstant(key) ||
+        !key->type()->equivalent(*reference->type())) {
+      return;
+    }
+    if (!field) {
+      if (!isLookupKeyType(*reference->type())) {
+        return;
+      }
+      field = reference;
+      lookupInput_ = column;
+    } else if (field->field() != reference->field()) {
+      lookupInput_ = nullptr;
+      return;
+    }
+    lookupKeys_.push_back(key);
+  }
+  for (auto i = 1; i < inputs_.size(); i += 2) {
+    if (!inputs_[i]->type()->equivalent(*type())) {
+      lookupInput_ = nullptr;
+      return;
+    }
+  }
+  if (hasElseClause_ &&
+      (!isConstant(inputs_.back()) ||
+       !inputs_.back()->type()->equivalent(*type()))) {
+    lookupInput_ = nullptr;
+  }
+}
+
+void SwitchExpr::buildLookup(EvalCtx& context) {
+  auto* pool = context.pool();
+  keys_ = BaseVector::create(lookupInput_->type(), numCases_, pool);
+  lookupResults_ = BaseVector::create(type(), numCases_ + 1, pool);
+  nextWithSameHash_.resize(numCases_, kNoCase);
+  for (auto i = 0; i < numCases_; ++i) {
+    keys_->copy(evalConstant(lookupKeys_[i], context).get(), i, 0, 1);
+    lookupResults_->copy(
+        evalConstant(inputs_[2 * i + 1], context).get(), i, 0, 1);
+  }
+  if (hasElseClause_) {
+    lookupResults_->copy(
+        evalConstant(inputs_.back(), context).get(), numCases_, 0, 1);
+  } else {
+    lookupResults_->setNull(numCases_, true);
+  }
+  // A null key never matches. Later cases with the same key are never
+  // reached, so the chains keep the cases in order and findCase returns the
+  // first equal one.
+  for (vector_size_t i = numCases_ - 1; i >= 0; --i) {
+    if (keys_->isNullAt(i)) {
+      continue;
+    }
+    auto [it, inserted] = caseByHash_.emplace(keys_->hashValueAt(i), i);
+    if (!inserted) {
+      nextWithSameHash_[i] = it->second;
+      it->second = i;
+    }
+  }
+}
+
+vector_size_t SwitchExpr::findCase(
+    const BaseVector* base,
+    vector_size_t index) const {
+  auto it = caseByHash_.find(base->hashValueAt(index));
+  if (it != caseByHash_.end()) {
+    for (auto i = it->second; i != kNoCase; i = nextWithSameHash_[i]) {
+      if (keys_->equalValueAt(base, i, index)) {
+        return i;
+      }
+    }
+  }
+  return numCases_;
+}
+
+void SwitchExpr::evalLookup(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  if (!lookupResults_) {
+    buildLookup(context);
+  }
+  VectorPtr input;
+  lookupInput_->eval(rows, context, input);
+  LocalDecodedVector decoded(context, *input, rows);
+  const auto* base = decoded->base();
+  const vector_size_t elseCase = numCases_;
+
+  if (decoded->isConstantMapping()) {
+    const auto row = rows.begin();
+    const auto matchingCase = decoded->isNullAt(row)
+        ? elseCase
+        : findCase(base, decoded->index(row));
+    context.moveOrCopyResult(
+        BaseVector::wrapInConstant(rows.end(), matchingCase, lookupResults_),
+        rows,
+        result);
+    return;
+  }
+
+  auto indices = allocateIndices(rows.end(), context.pool());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  if (!decoded->isIdentityMapping() && base->size() <= rows.countSelected()) {
+    // Looks up each distinct value of a dictionary once.
+    std::vector<vector_size_t> baseCases(base->size(), kNoCase);
+    rows.applyToSelected([&](auto row) {
+      if (decoded->isNullAt(row)) {
+        rawIndices[row] = elseCase;
+        return;
+      }
+      const auto baseIndex = decoded->index(row);
+      if (baseCases[baseIndex] == kNoCase) {
+        baseCases[baseIndex] = findCase(base, baseIndex);
+      }
+      rawIndices[row] = baseCases[baseIndex];
+    });
+  } else {
+    rows.applyToSelected([&](auto row) {
+      rawIndices[row] = decoded->isNullAt(row)
+          ? elseCase
+          : findCase(base, decoded->index(row));
+    });
+  }
+  context.moveOrCopyResult(
+      BaseVector::wrapInDictionary(
+          nullptr, std::move(indices), rows.end(), lookupResults_),
+      rows,
+      result);
+}
 
 void SwitchExpr::evalSpecialForm(
     const SelectivityVector& rows,
     EvalCtx& context,
     VectorPtr& result) {
+  if (lookupInput_) {
+    evalLookup(rows, context, result);
+    return;
+  }
+
   LocalSelectivityVector remainingRows(context, rows);
 
   LocalSelectivityVector thenRows(context);
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/expression/SpecialForm.h"
 
 namespace facebook::velox::exec {
@@ -33,6 +35,12 @@ namespace facebook::velox::exec {
 ///
 /// IF expression can be represented as a CASE expression with a single
 /// condition.
+///
+/// A simple CASE over one column with at least kMinLookupCases constant
+/// branches, i.e. all conditions are eq(column, constant) and all results and
+/// the else are constants, is evaluated as a hash lookup of the column value
+/// into the case results instead of one comparison per branch. The result is
+/// a dictionary over the constant results.
 class SwitchExpr : public SpecialForm {
  public:
   /// Inputs are concatenated conditions and results with an optional "else" at
@@ -51,8 +59,11 @@ class SwitchExpr : public SpecialForm {
       auto& condition = inputs_[i * 2];
       VELOX_CHECK_EQ(condition->type()->kind(), TypeKind::BOOLEAN);
     }
+    initializeLookup();
   }
 
+  static constexpr size_t kMinLookupCases = 4;
+
   void evalSpecialForm(
       const SelectivityVector& rows,
       EvalCtx& context,
@@ -65,8 +76,38 @@ class SwitchExpr : public SpecialForm {
   }
 
  private:
+  // Sets 'lookupInput_' and 'lookupKeys_' if the expression qualifies for
+  // the lookup, see the class comment.
+  void initializeLookup();
+
+  // Makes the flat vectors of keys and results and the hash table on the
+  // first evaluation.
+  void buildLookup(EvalCtx& context);
+
+  void evalLookup(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result);
+
+  // Returns the first case whose key is equal to 'base' at 'index' or
+  // 'numCases_', the index of the else result, if there is none.
+  vector_size_t findCase(const BaseVector* base, vector_size_t index) const;
+
   const size_t numCases_;
   const bool hasElseClause_;
   BufferPtr tempValues_;
+
+  // The column of the lookup. nullptr if the lookup does not apply.
+  ExprPtr lookupInput_;
+  // The constant key of each case.
+  std::vector<ExprPtr> lookupKeys_;
+  // Flat vectors of 'numCases_' keys and 'numCases_' + 1 results. The last
+  // result is the else result or null.
+  VectorPtr keys_;
+  VectorPtr lookupResults_;
+  // First case for each key hash. Further cases with the same hash are
+  // chained in 'nextWithSameHash_'.
+  folly::F14FastMap<uint64_t, vector_size_t> caseByHash_;
+  std::vector<vector_size_t> nextWithSameHash_;
 };
 } // namespace facebook::velox::exec
@@ -489,6 +489,66 @@ TEST_F(CastExprTest, errorHandling) {
       "tinyint", {"1", "2", "3", "100", "-100.5"}, {1, 2, 3, 100, -100}, true);
 }
 
+TEST_F(CastExprTest, fastPathFallback) {
+  // Rows in the common forms are cast without exceptions. The rest must give
+  // the same results as before.
+  testCast<std::string, int32_t>(
+      "integer",
+      {"12", "-0", " 7", "+8", "2147483648", "-2147483648", "1.5", ""},
+      {12, 0, 7, 8, std::nullopt, std::numeric_limits<int32_t>::min(),
+       std::nullopt, std::nullopt},
+      false,
+      true);
+  testCast<std::string, int64_t>(
+      "bigint",
+      {"123456789012345678",
+       "9223372036854775807",
+       "-9223372036854775808",
+       "9223372036854775808"},
+      {123456789012345678,
+       std::numeric_limits<int64_t>::max(),
+       std::numeric_limits<int64_t>::min(),
+       std::nullopt},
+      false,
+      true);
+  testCast<std::string, int8_t>(
+      "tinyint", {"1", "2", "128"}, {1, 2, std::nullopt}, true);
+
+  testCast<std::string, double>(
+      "double",
+      {"1.5", "-0.25", "007", "123456789.123456", "1e3", " 2", "1..5", ""},
+      {1.5, -0.25, 7, 123456789.123456, 1000, 2, std::nullopt, std::nullopt},
+      false,
+      true);
+  testCast<std::string, float>(
+      "real",
+      {"0.1", "-3.25", "abc"},
+      {0.1f, -3.25f, std::nullopt},
+      false,
+      true);
+
+  testCast<std::string, Date>(
+      "date",
+      {"2020-02-29", "2021-02-29", "2020-13-01", " 2020-01-05"},
+      {Date(18321), std::nullopt, std::nullopt, Date(18266)},
+      false,
+      true);
+  testCast<std::string, Date>("date", {"2020-01-01", "2021-02-29"}, {}, true);
+
+  testCast<int64_t, double>(
+      "double",
+      {1LL << 53, -(1LL << 53), (1LL << 54) + 4, 42},
+      {9007199254740992.0, -9007199254740992.0, 18014398509481988.0, 42.0});
+
+  testCast<double, int64_t>(
+      "bigint",
+      {2.5, -2.5, 9223372036854775807.0, -9223372036854775808.0, NAN},
+      {3, -3, std::nullopt, std::numeric_limits<int64_t>::min(), std::nullopt},
+      false,
+      true);
+  testCast<double, int32_t>("integer", {1.0, 2147483647.5}, {}, true);
+}
+
 constexpr vector_size_t kVectorSize = 1'000;
 
 TEST_F(CastExprTest, mapCast) {
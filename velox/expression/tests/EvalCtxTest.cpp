@@ -18,6 +18,7 @@
 
 #include "velox/common/base/Exceptions.h"
 #include "velox/expression/EvalCtx.h"
+#include "velox/expression/Expr.h"
 #include "velox/vector/tests/VectorTestBase.h"
 
 using namespace facebook::velox;
@@ -52,3 +53,37 @@ TEST_F(EvalCtxTest, selectivityVectors) {
   LocalSelectivityVector local2(context, all100);
   EXPECT_EQ(all100, *local2.get());
 }
+
+TEST_F(EvalCtxTest, sharedDecodedField) {
+  auto flat = makeFlatVector<int64_t>(100, [](auto row) { return row; });
+  auto base = makeFlatVector<int64_t>(100, [](auto row) { return row; });
+  auto dictionary = wrapInDictionary(makeIndicesInReverse(100), 100, base);
+  auto row = makeRowVector({flat, dictionary});
+  ExprSet exprSet({}, execCtx_.get());
+  EvalCtx context(execCtx_.get(), &exprSet, row.get());
+  SelectivityVector allRows(100);
+  SelectivityVector someRows(100);
+  someRows.setValidRange(0, 50, false);
+  someRows.updateBounds();
+
+  // Flat columns and vectors that are not columns are not shared.
+  EXPECT_EQ(nullptr, context.sharedDecodedField(*flat, allRows));
+  auto other = wrapInDictionary(makeIndicesInReverse(100), 100, flat);
+  EXPECT_EQ(nullptr, context.sharedDecodedField(*other, allRows));
+
+  auto* decoded = context.sharedDecodedField(*dictionary, allRows);
+  ASSERT_NE(nullptr, decoded);
+  EXPECT_EQ(decoded, context.sharedDecodedField(*dictionary, allRows));
+  EXPECT_NE(decoded, context.sharedDecodedField(*dictionary, someRows));
+  for (auto i = 0; i < 100; ++i) {
+    EXPECT_EQ(99 - i, decoded->valueAt<int64_t>(i));
+  }
+
+  auto first = LocalDecodedVector::shared(context, *dictionary, allRows);
+  auto second = LocalDecodedVector::shared(context, *dictionary, allRows);
+  EXPECT_EQ(decoded, first.get());
+  EXPECT_EQ(decoded, second.get());
+  auto local = LocalDecodedVector::shared(context, *flat, allRows);
+  EXPECT_NE(nullptr, local.get());
+  EXPECT_EQ(5, local->valueAt<int64_t>(5));
+}
@@ -1074,6 +1074,62 @@ TEST_F(ExprTest, constantFolding) {
   }
 }
 
+TEST_F(ExprTest, compileCache) {
+  auto queryCtx = core::QueryCtx::createForTest(
+      std::make_shared<core::MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {core::QueryConfig::kExprCompileCacheEnabled, "true"}}));
+  auto typedExpr = parseExpression(
+      "concat(concat(upper('abc'), 'd'), c0)", ROW({"c0"}, {VARCHAR()}));
+  auto throwing = parseExpression("codepoint('abcdef')");
+
+  // Compiles the expressions the way the drivers of a pipeline do, with one
+  // pool per driver.
+  std::vector<std::unique_ptr<memory::MemoryPool>> pools;
+  std::vector<std::unique_ptr<core::ExecCtx>> execCtxs;
+  std::vector<std::unique_ptr<exec::ExprSet>> exprSets;
+  for (auto i = 0; i < 2; ++i) {
+    pools.push_back(memory::getDefaultScopedMemoryPool());
+    execCtxs.push_back(
+        std::make_unique<core::ExecCtx>(pools.back().get(), queryCtx.get()));
+    exprSets.push_back(std::make_unique<exec::ExprSet>(
+        std::vector<core::TypedExprPtr>{typedExpr, throwing},
+        execCtxs.back().get()));
+  }
+
+  auto cache = exec::ExprCompileCache::get(execCtxs[0].get());
+  ASSERT_TRUE(cache != nullptr);
+  EXPECT_EQ(2, cache->numHits());
+
+  auto folded = [](const exec::ExprSet& exprSet) {
+    auto& input = exprSet.exprs()[0]->inputs()[0];
+    auto* constant = dynamic_cast<exec::ConstantExpr*>(input.get());
+    VELOX_CHECK_NOT_NULL(constant);
+    return constant->value();
+  };
+  // The drivers share the folded value, which does not reference the pool of
+  // the first driver.
+  EXPECT_EQ(folded(*exprSets[0]), folded(*exprSets[1]));
+  auto value = folded(*exprSets[1])->as<ConstantVector<StringView>>();
+  EXPECT_EQ("ABCd", value->valueAt(0).str());
+  auto isAscii = value->isAscii(0);
+  ASSERT_TRUE(isAscii.has_value());
+  EXPECT_TRUE(isAscii.value());
+  exprSets[0].reset();
+  execCtxs[0].reset();
+  pools[0].reset();
+
+  auto input = makeRowVector({makeFlatVector<StringView>({"x", "y"})});
+  exec::EvalCtx context(execCtxs[1].get(), exprSets[1].get(), input.get());
+  std::vector<VectorPtr> result(2);
+  SelectivityVector rows(1);
+  exprSets[1]->eval(0, 1, true, rows, &context, &result);
+  assertEqualVectors(makeFlatVector<StringView>({"ABCdx"}), result[0]);
+
+  // Without the config there is no cache.
+  EXPECT_TRUE(exec::ExprCompileCache::get(execCtx_.get()) == nullptr);
+}
+
 TEST_F(ExprTest, constantArray) {
   auto a = makeArrayVector<int32_t>(
       10, [](auto /*row*/) { return 5; }, [](auto row) { return row * 3; });
@@ -1993,6 +2049,96 @@ TEST_F(ExprTest, switchExpr) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(ExprTest, switchLookup) {
+  vector_size_t size = 1'000;
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row % 10; }, nullEvery(7)),
+      makeFlatVector<StringView>(
+          size,
+          [](auto row) {
+            static const std::vector<std::string> kNames = {
+                "apple", "banana", "a string longer than inline", "cherry"};
+            return StringView(kNames[row % kNames.size()]);
+          },
+          nullEvery(11)),
+  });
+  std::function<int64_t(vector_size_t)> expectedValueAt = [](auto row) {
+    auto value = row % 10;
+    if (row % 7 == 0 || value > 4) {
+      return 0;
+    }
+    return value + 10;
+  };
+
+  auto result = evaluate(
+      "case c0 when 1 then 11 when 2 then 12 when 3 then 13 when 4 then 14 "
+      "when 3 then 99 else 0 end",
+      vector);
+  auto expected = makeFlatVector<int64_t>(size, expectedValueAt);
+  assertEqualVectors(expected, result);
+
+  // Constant on the left.
+  result = evaluate(
+      "case when 1 = c0 then 11 when 2 = c0 then 12 when 3 = c0 then 13 "
+      "when c0 = 4 then 14 else 0 end",
+      vector);
+  assertEqualVectors(expected, result);
+
+  // No else clause.
+  result = evaluate(
+      "case c0 when 1 then 11 when 2 then 12 when 3 then 13 when 4 then 14 "
+      "end",
+      vector);
+  expected = makeFlatVector<int64_t>(size, expectedValueAt, [](auto row) {
+    return row % 7 == 0 || row % 10 == 0 || row % 10 > 4;
+  });
+  assertEqualVectors(expected, result);
+
+  // Dictionary encoded input with fewer distinct values than rows.
+  auto indices = makeIndices(size, [](auto row) { return (row * 3) % 20; });
+  auto dictionaryVector = makeRowVector(
+      {wrapInDictionary(indices, size, vector->childAt(0)),
+       vector->childAt(1)});
+  result = evaluate(
+      "case c0 when 1 then 11 when 2 then 12 when 3 then 13 when 4 then 14 "
+      "else 0 end",
+      dictionaryVector);
+  expected = makeFlatVector<int64_t>(
+      size, [&](auto row) { return expectedValueAt((row * 3) % 20); });
+  assertEqualVectors(expected, result);
+
+  // Strings.
+  result = evaluate(
+      "case c1 when 'apple' then 'A' when 'banana' then 'B' "
+      "when 'a string longer than inline' then 'a result longer than inline' "
+      "when 'date' then 'D' else 'other' end",
+      vector);
+  auto expectedStrings = makeFlatVector<StringView>(size, [](auto row) {
+    if (row % 11 == 0) {
+      return StringView("other");
+    }
+    switch (row % 4) {
+      case 0:
+        return StringView("A");
+      case 1:
+        return StringView("B");
+      case 2:
+        return StringView("a result longer than inline");
+      default:
+        return StringView("other");
+    }
+  });
+  assertEqualVectors(expectedStrings, result);
+
+  // Constant input.
+  result = evaluate(
+      "case 'banana' when 'apple' then 1 when 'banana' then 2 "
+      "when 'cherry' then 3 when 'date' then 4 else 0 end",
+      vector);
+  assertEqualVectors(makeConstant<int64_t>(2, size), result);
+}
+
 TEST_F(ExprTest, ifWithConstant) {
   vector_size_t size = 4;
 
@@ -2344,6 +2490,96 @@ TEST_F(ExprTest, memoNulls) {
   assertEqualVectors(expectedResult, result);
 }
 
+namespace {
+// Returns the length of a string and counts the rows it is evaluated on.
+class CountingLengthFunction : public exec::VectorFunction {
+ public:
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      exec::EvalCtx* context,
+      VectorPtr* result) const override {
+    exec::DecodedArgs decodedArgs(rows, args, context);
+    auto* strings = decodedArgs.at(0);
+    BaseVector::ensureWritable(rows, BIGINT(), context->pool(), result);
+    auto* flatResult = (*result)->asFlatVector<int64_t>();
+    rows.applyToSelected([&](auto row) {
+      flatResult->set(row, strings->valueAt<StringView>(row).size());
+    });
+    numRows += rows.countSelected();
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // varchar -> bigint
+    return {exec::FunctionSignatureBuilder()
+                .returnType("bigint")
+                .argumentType("varchar")
+                .build()};
+  }
+
+  static inline int64_t numRows{0};
+};
+} // namespace
+
+TEST_F(ExprTest, valueMemo) {
+  exec::registerVectorFunction(
+      "counting_length",
+      CountingLengthFunction::signatures(),
+      std::make_unique<CountingLengthFunction>());
+  auto rowType = ROW({"c0"}, {VARCHAR()});
+  auto exprSet = compileExpression("counting_length(c0)", rowType);
+
+  // Each batch is over a new copy of the same 10 distinct strings, like the
+  // build side values of a join with a small table.
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 10; ++i) {
+    strings.push_back(std::string(i + 20, 'a' + i));
+  }
+  auto makeBase = [&](vector_size_t size) {
+    return makeFlatVector<StringView>(
+        size,
+        [&](auto row) { return StringView(strings[row % 10]); },
+        nullEvery(13));
+  };
+  auto indices = makeIndices(100, [](auto row) { return (row * 7) % 30; });
+  auto expectedResult = makeFlatVector<int64_t>(
+      100,
+      [](auto row) { return (row * 7) % 30 % 10 + 20; },
+      [](auto row) { return (row * 7) % 30 % 13 == 0; });
+
+  CountingLengthFunction::numRows = 0;
+  auto result = evaluate(
+      exprSet.get(),
+      makeRowVector({wrapInDictionary(indices, 100, makeBase(30))}));
+  assertEqualVectors(expectedResult, result);
+  auto firstRows = CountingLengthFunction::numRows;
+  EXPECT_LE(firstRows, 30);
+
+  // The values of a new base are found in the memo.
+  for (auto i = 0; i < 3; ++i) {
+    result = evaluate(
+        exprSet.get(),
+        makeRowVector({wrapInDictionary(indices, 100, makeBase(30))}));
+    assertEqualVectors(expectedResult, result);
+  }
+  EXPECT_EQ(firstRows, CountingLengthFunction::numRows);
+
+  // A base with new values evaluates only these.
+  auto newBase = makeFlatVector<StringView>(
+      {"a", "aaaaaaaaaaaaaaaaaaaa", "bbbbbbbbbbbbbbbbbbbbb"});
+  result = evaluate(
+      exprSet.get(),
+      makeRowVector({wrapInDictionary(
+          makeIndices(10, [](auto row) { return row % 3; }), 10, newBase)}));
+  assertEqualVectors(
+      makeFlatVector<int64_t>(10, [](auto row) {
+        return std::vector<int64_t>{1, 20, 21}[row % 3];
+      }),
+      result);
+  EXPECT_EQ(firstRows + 1, CountingLengthFunction::numRows);
+}
+
 // This test is carefully constructed to exercise calling
 // applyFunctionWithPeeling in a situation where inputValues_ can be peeled
 // and applyRows and rows are distinct SelectivityVectors.  This test ensures
@@ -2828,3 +3064,29 @@ TEST_F(ExprTest, lambdaWithRowField) {
 
   assertEqualVectors(array, evalResult);
 }
+
+TEST_F(ExprTest, peelSequence) {
+  // Three runs over 10 rows.
+  auto lengths = AlignedBuffer::allocate<vector_size_t>(3, pool_.get());
+  auto* rawLengths = lengths->asMutable<vector_size_t>();
+  rawLengths[0] = 4;
+  rawLengths[1] = 3;
+  rawLengths[2] = 3;
+  auto input = makeRowVector({BaseVector::wrapInSequence(
+      lengths, 10, makeFlatVector<int64_t>({1, 0, 3}))});
+
+  // The function is evaluated once per run and the result keeps the runs.
+  auto result = evaluate("c0 + 10", input);
+  ASSERT_EQ(VectorEncoding::Simple::SEQUENCE, result->encoding());
+  EXPECT_EQ(3, result->valueVector()->size());
+  assertEqualVectors(
+      makeFlatVector<int64_t>({11, 11, 11, 11, 10, 10, 10, 13, 13, 13}),
+      result);
+
+  // An error in a run is reported for all the rows of the run.
+  result = evaluate("try(12 / c0)", input);
+  assertEqualVectors(
+      makeNullableFlatVector<int64_t>(
+          {12, 12, 12, 12, std::nullopt, std::nullopt, std::nullopt, 4, 4, 4}),
+      result);
+}
@@ -336,6 +336,151 @@ std::string DateTimeFormatter::format(
   return result;
 }
 
+namespace {
+
+// Milliseconds of 0000-01-01 00:00:00 and of 10000-01-01 00:00:00 UTC.
+constexpr int64_t kMinFixedMillis = -62'167'219'200'000;
+constexpr int64_t kMaxFixedMillis = 253'402'300'800'000;
+
+// Returns the number of characters 'pattern' formats to if it is the same
+// for all timestamps from year 0 to year 9999 and 0 otherwise.
+size_t fixedPatternSize(const FormatPattern& pattern) {
+  const auto digits = pattern.minRepresentDigits;
+  switch (pattern.specifier) {
+    case DateTimeFormatSpecifier::ERA:
+    case DateTimeFormatSpecifier::HALFDAY_OF_DAY:
+      return 2;
+    case DateTimeFormatSpecifier::YEAR:
+    case DateTimeFormatSpecifier::YEAR_OF_ERA:
+      return digits == 2 || digits >= 4 ? digits : 0;
+    case DateTimeFormatSpecifier::DAY_OF_YEAR:
+      return digits >= 3 ? digits : 0;
+    case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+    case DateTimeFormatSpecifier::DAY_OF_MONTH:
+    case DateTimeFormatSpecifier::HOUR_OF_HALFDAY:
+    case DateTimeFormatSpecifier::CLOCK_HOUR_OF_HALFDAY:
+    case DateTimeFormatSpecifier::HOUR_OF_DAY:
+    case DateTimeFormatSpecifier::CLOCK_HOUR_OF_DAY:
+    case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+    case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+      return digits >= 2 ? digits : 0;
+    default:
+      return 0;
+  }
+}
+
+// Writes 'value' padded with leading zeros to the 'width' characters at
+// 'out'. 'value' has at most 'width' digits.
+inline void writeDigits(int32_t value, size_t width, char* out) {
+  for (auto i = width; i > 0; --i) {
+    out[i - 1] = '0' + value % 10;
+    value /= 10;
+  }
+}
+
+} // namespace
+
+size_t DateTimeFormatter::computeFixedResultSize() const {
+  size_t size = 0;
+  for (auto& token : tokens_) {
+    if (token.type == DateTimeToken::Type::kLiteral) {
+      size += token.literal.size();
+      continue;
+    }
+    auto patternSize = fixedPatternSize(token.pattern);
+    if (patternSize == 0) {
+      return 0;
+    }
+    size += patternSize;
+  }
+  return size;
+}
+
+bool DateTimeFormatter::formatFixed(const Timestamp& timestamp, char* result)
+    const {
+  VELOX_DCHECK_GT(fixedResultSize_, 0);
+  const auto millis = timestamp.toMillis();
+  if (millis < kMinFixedMillis || millis >= kMaxFixedMillis) {
+    return false;
+  }
+  constexpr int64_t kMillisInDay = 86'400'000;
+  auto days = millis / kMillisInDay;
+  auto millisInDay = millis % kMillisInDay;
+  if (millisInDay < 0) {
+    --days;
+    millisInDay += kMillisInDay;
+  }
+  const date::sys_days daysTimePoint{date::days(days)};
+  const date::year_month_day calDate(daysTimePoint);
+  const int32_t year = static_cast<signed>(calDate.year());
+  const int32_t hour = millisInDay / 3'600'000;
+  const int32_t minute = millisInDay / 60'000 % 60;
+  const int32_t second = millisInDay / 1'000 % 60;
+
+  char* out = result;
+  for (auto& token : tokens_) {
+    if (token.type == DateTimeToken::Type::kLiteral) {
+      std::memcpy(out, token.literal.data(), token.literal.size());
+      out += token.literal.size();
+      continue;
+    }
+    const auto width = token.pattern.minRepresentDigits;
+    int32_t value;
+    switch (token.pattern.specifier) {
+      case DateTimeFormatSpecifier::ERA:
+        std::memcpy(out, year > 0 ? "AD" : "BC", 2);
+        out += 2;
+        continue;
+      case DateTimeFormatSpecifier::HALFDAY_OF_DAY:
+        std::memcpy(out, hour < 12 ? "AM" : "PM", 2);
+        out += 2;
+        continue;
+      case DateTimeFormatSpecifier::YEAR:
+        value = width == 2 ? year % 100 : year;
+        break;
+      case DateTimeFormatSpecifier::YEAR_OF_ERA:
+        // Year 0 is 1 BC.
+        value = width == 2 ? year % 100 : std::max(year, 1);
+        break;
+      case DateTimeFormatSpecifier::DAY_OF_YEAR:
+        value = (daysTimePoint -
+                 date::sys_days{calDate.year() / date::month(1) / date::day(1)})
+                    .count() +
+            1;
+        break;
+      case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+        value = static_cast<unsigned>(calDate.month());
+        break;
+      case DateTimeFormatSpecifier::DAY_OF_MONTH:
+        value = static_cast<unsigned>(calDate.day());
+        break;
+      case DateTimeFormatSpecifier::HOUR_OF_HALFDAY:
+        value = hour % 12;
+        break;
+      case DateTimeFormatSpecifier::CLOCK_HOUR_OF_HALFDAY:
+        value = (hour + 11) % 12 + 1;
+        break;
+      case DateTimeFormatSpecifier::HOUR_OF_DAY:
+        value = hour;
+        break;
+      case DateTimeFormatSpecifier::CLOCK_HOUR_OF_DAY:
+        value = (hour + 23) % 24 + 1;
+        break;
+      case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+        value = minute;
+        break;
+      case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+        value = second;
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+    writeDigits(value, width, out);
+    out += width;
+  }
+  return true;
+}
+
 std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
     const std::string_view& format) {
   // For %r we should reserve 1 extra space because it has 3 literals ':' ':'
@@ -155,7 +155,8 @@ class DateTimeFormatter {
       std::vector<DateTimeToken>&& tokens)
       : literalBuf_(std::move(literalBuf)),
         bufSize_(bufSize),
-        tokens_(std::move(tokens)) {}
+        tokens_(std::move(tokens)),
+        fixedResultSize_(computeFixedResultSize()) {}
 
   const std::unique_ptr<char[]>& literalBuf() const {
     return literalBuf_;
@@ -177,10 +178,28 @@ class DateTimeFormatter {
       const Timestamp& timestamp,
       const date::time_zone* timezone) const;
 
+  /// Returns the size of the result of format() if it is the same for all
+  /// timestamps from year 0 to year 9999, e.g. for 'yyyy-MM-dd HH:mm:ss', and
+  /// 0 otherwise. These formats consist of literals, text of fixed width and
+  /// numbers of fixed width.
+  size_t fixedResultSize() const {
+    return fixedResultSize_;
+  }
+
+  /// Writes the fixedResultSize() characters of the result of format() to
+  /// 'result' without going through the general formatting of each token.
+  /// Returns false and writes nothing if the year of 'timestamp' is not
+  /// between 0 and 9999.
+  bool formatFixed(const Timestamp& timestamp, char* result) const;
+
  private:
+  size_t computeFixedResultSize() const;
+
   std::unique_ptr<char[]> literalBuf_;
   size_t bufSize_;
   std::vector<DateTimeToken> tokens_;
+  // 0 if the format has a token of variable width.
+  const size_t fixedResultSize_;
 };
 
 std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
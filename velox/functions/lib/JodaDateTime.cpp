@@ -160,7 +160,7 @@ struct JodaDate {
   int64_t timezoneId = -1;
 };
 
-void parseFail(const std::string& input, const char* cur, const char* end) {
+void parseFail(std::string_view input, const char* cur, const char* end) {
   VELOX_USER_FAIL(
       "Invalid format: \"{}\" is malformed at \"{}\"",
       input,
@@ -277,7 +277,7 @@ std::string getSpecifierName(int enumInt) {
 
 void parseFromPattern(
     JodaFormatSpecifier curPattern,
-    const std::string& input,
+    std::string_view input,
     const char*& cur,
     const char* end,
     JodaDate& jodaDate) {
@@ -368,7 +368,7 @@ void parseFromPattern(
 
 } // namespace
 
-JodaResult JodaFormatter::parse(const std::string& input) {
+JodaResult JodaFormatter::parse(std::string_view input) {
   JodaDate jodaDate;
   const char* cur = input.data();
   const char* end = cur + input.size();
@@ -134,7 +134,7 @@ class JodaFormatter {
 
   // Parses `input` according to the format specified in the constructor. Throws
   // in case the input couldn't be parsed.
-  JodaResult parse(const std::string& input);
+  JodaResult parse(std::string_view input);
 
  private:
   void tokenize(const std::string_view&);
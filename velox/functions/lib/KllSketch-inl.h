@@ -16,8 +16,8 @@
 
 #pragma once
 
+#include <array>
 #include <cmath>
-#include <queue>
 #include <type_traits>
 #include "velox/common/base/Exceptions.h"
 
@@ -27,6 +27,10 @@ namespace detail {
 
 constexpr uint8_t kMaxLevel = 60;
 
+// Level boundaries of empty sketches. Never written, a sketch allocates
+// before its first insert.
+extern const uint32_t kEmptyLevels[2];
+
 uint32_t computeTotalCapacity(uint32_t k, uint8_t numLevels);
 
 uint32_t levelCapacity(uint32_t k, uint8_t numLevels, uint8_t height);
@@ -224,11 +228,11 @@ void write(T value, char* out, size_t& offset) {
   offset += sizeof(T);
 }
 
-template <typename T, typename A>
-void writeVector(const std::vector<T, A>& data, char* out, size_t& offset) {
-  write(data.size(), out, offset);
-  auto bytes = sizeof(T) * data.size();
-  memcpy(out + offset, data.data(), bytes);
+template <typename T>
+void writeRange(const T* data, size_t size, char* out, size_t& offset) {
+  write(size, out, offset);
+  auto bytes = sizeof(T) * size;
+  memcpy(out + offset, data, bytes);
   offset += bytes;
 }
 
@@ -255,16 +259,169 @@ KllSketch<T, A, C>::KllSketch(uint32_t k, const A& allocator, uint32_t seed)
       allocator_(allocator),
       randomBit_(seed),
       n_(0),
-      items_(allocator),
-      levels_(2, AllocU32(allocator)),
-      isLevelZeroSorted_(false) {}
+      levels_(const_cast<uint32_t*>(detail::kEmptyLevels)),
+      items_(nullptr),
+      capacity_(0),
+      levelsCapacity_(0),
+      numLevels_(1),
+      isLevelZeroSorted_(false) {
+  static_assert(std::is_trivially_copyable_v<T>);
+}
 
 template <typename T, typename A, typename C>
 KllSketch<T, A, C>::KllSketch(const A& allocator, uint32_t seed)
     : allocator_(allocator),
       randomBit_(seed),
-      items_(allocator),
-      levels_(AllocU32(allocator)) {}
+      levels_(const_cast<uint32_t*>(detail::kEmptyLevels)),
+      items_(nullptr),
+      capacity_(0),
+      levelsCapacity_(0),
+      numLevels_(1) {}
+
+template <typename T, typename A, typename C>
+KllSketch<T, A, C>::KllSketch(const KllSketch<T, A, C>& other)
+    : k_(other.k_),
+      allocator_(other.allocator_),
+      randomBit_(other.randomBit_),
+      n_(other.n_),
+      minValue_(other.minValue_),
+      maxValue_(other.maxValue_),
+      levels_(const_cast<uint32_t*>(detail::kEmptyLevels)),
+      items_(nullptr),
+      capacity_(0),
+      levelsCapacity_(0),
+      numLevels_(1),
+      isLevelZeroSorted_(other.isLevelZeroSorted_) {
+  if (other.levelsCapacity_ == 0) {
+    return;
+  }
+  allocate(other.numLevels_ + 1, other.levels_[other.numLevels_]);
+  numLevels_ = other.numLevels_;
+  std::copy(other.levels_, other.levels_ + numLevels_ + 1, levels_);
+  std::copy(
+      other.items_ + levels_[0],
+      other.items_ + levels_[numLevels_],
+      items_ + levels_[0]);
+}
+
+template <typename T, typename A, typename C>
+KllSketch<T, A, C>::KllSketch(KllSketch<T, A, C>&& other) noexcept
+    : k_(other.k_),
+      allocator_(other.allocator_),
+      randomBit_(other.randomBit_),
+      n_(other.n_),
+      minValue_(other.minValue_),
+      maxValue_(other.maxValue_),
+      levels_(other.levels_),
+      items_(other.items_),
+      capacity_(other.capacity_),
+      levelsCapacity_(other.levelsCapacity_),
+      numLevels_(other.numLevels_),
+      isLevelZeroSorted_(other.isLevelZeroSorted_) {
+  other.levels_ = const_cast<uint32_t*>(detail::kEmptyLevels);
+  other.items_ = nullptr;
+  other.capacity_ = 0;
+  other.levelsCapacity_ = 0;
+  other.numLevels_ = 1;
+  other.n_ = 0;
+}
+
+template <typename T, typename A, typename C>
+KllSketch<T, A, C>& KllSketch<T, A, C>::operator=(
+    const KllSketch<T, A, C>& other) {
+  if (this != &other) {
+    *this = KllSketch<T, A, C>(other);
+  }
+  return *this;
+}
+
+template <typename T, typename A, typename C>
+KllSketch<T, A, C>& KllSketch<T, A, C>::operator=(
+    KllSketch<T, A, C>&& other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  release();
+  k_ = other.k_;
+  allocator_ = other.allocator_;
+  randomBit_ = other.randomBit_;
+  n_ = other.n_;
+  minValue_ = other.minValue_;
+  maxValue_ = other.maxValue_;
+  std::swap(levels_, other.levels_);
+  std::swap(items_, other.items_);
+  std::swap(capacity_, other.capacity_);
+  std::swap(levelsCapacity_, other.levelsCapacity_);
+  std::swap(numLevels_, other.numLevels_);
+  isLevelZeroSorted_ = other.isLevelZeroSorted_;
+  other.n_ = 0;
+  return *this;
+}
+
+template <typename T, typename A, typename C>
+KllSketch<T, A, C>::~KllSketch() {
+  release();
+}
+
+template <typename T, typename A, typename C>
+size_t KllSketch<T, A, C>::itemsOffset(uint8_t levelsCapacity) {
+  constexpr size_t kAlignment = std::max(alignof(T), alignof(uint32_t));
+  return (levelsCapacity * sizeof(uint32_t) + kAlignment - 1) / kAlignment *
+      kAlignment;
+}
+
+template <typename T, typename A, typename C>
+size_t KllSketch<T, A, C>::blockWords(
+    uint8_t levelsCapacity,
+    uint32_t capacity) {
+  return (itemsOffset(levelsCapacity) + sizeof(T) * capacity +
+          sizeof(uint32_t) - 1) /
+      sizeof(uint32_t);
+}
+
+template <typename T, typename A, typename C>
+void KllSketch<T, A, C>::allocate(uint8_t levelsCapacity, uint32_t capacity) {
+  VELOX_DCHECK_GT(levelsCapacity, 0);
+  levels_ =
+      AllocU32(allocator_).allocate(blockWords(levelsCapacity, capacity));
+  items_ = reinterpret_cast<T*>(
+      reinterpret_cast<char*>(levels_) + itemsOffset(levelsCapacity));
+  levelsCapacity_ = levelsCapacity;
+  capacity_ = capacity;
+}
+
+template <typename T, typename A, typename C>
+void KllSketch<T, A, C>::grow(uint8_t numLevels, uint32_t capacity) {
+  VELOX_DCHECK_GE(numLevels, numLevels_);
+  VELOX_DCHECK_GE(capacity, levels_[numLevels_]);
+  auto* oldLevels = levels_;
+  auto* oldItems = items_;
+  const auto oldLevelsCapacity = levelsCapacity_;
+  const auto oldCapacity = capacity_;
+  allocate(numLevels + 1, capacity);
+  std::copy(oldLevels, oldLevels + numLevels_ + 1, levels_);
+  std::copy(
+      oldItems + oldLevels[0],
+      oldItems + oldLevels[numLevels_],
+      items_ + oldLevels[0]);
+  if (oldLevelsCapacity > 0) {
+    AllocU32(allocator_).deallocate(
+        oldLevels, blockWords(oldLevelsCapacity, oldCapacity));
+  }
+}
+
+template <typename T, typename A, typename C>
+void KllSketch<T, A, C>::release() {
+  if (levelsCapacity_ > 0) {
+    AllocU32(allocator_).deallocate(
+        levels_, blockWords(levelsCapacity_, capacity_));
+  }
+  levels_ = const_cast<uint32_t*>(detail::kEmptyLevels);
+  items_ = nullptr;
+  capacity_ = 0;
+  levelsCapacity_ = 0;
+  numLevels_ = 1;
+}
 
 template <typename T, typename A, typename C>
 void KllSketch<T, A, C>::setK(uint32_t k) {
@@ -273,7 +430,7 @@ void KllSketch<T, A, C>::setK(uint32_t k) {
   }
   VELOX_CHECK_EQ(n_, 0);
   k_ = k;
-  levels_.resize(2);
+  release();
 }
 
 template <typename T, typename A, typename C>
@@ -290,14 +447,20 @@ void KllSketch<T, A, C>::insert(T value) {
 template <typename T, typename A, typename C>
 void KllSketch<T, A, C>::doInsert(T value) {
   VELOX_DCHECK_GT(k_, 0);
-  VELOX_DCHECK_GE(levels_.size(), 2);
-  if (items_.size() < k_) {
+  VELOX_DCHECK_GE(numLevels_, 1);
+  const uint32_t size = levels_[numLevels_];
+  if (size < k_) {
     // Do not allocate all k elements in the beginning because in some group-by
     // aggregation most of the group size is small and won't use all k spaces.
-    items_.push_back(value);
+    if (size == capacity_) {
+      grow(numLevels_, std::min(k_, std::max<uint32_t>(1, 2 * capacity_)));
+    }
+    items_[size] = value;
     ++levels_[1];
   } else {
-    items_[insertPosition()] = value;
+    // insertPosition() may reallocate 'items_'.
+    const auto position = insertPosition();
+    items_[position] = value;
   }
   ++n_;
   isLevelZeroSorted_ = false;
@@ -328,14 +491,14 @@ uint32_t KllSketch<T, A, C>::insertPosition() {
     // Level zero might not be sorted, so we must sort it if we wish
     // to compact it.
     if (level == 0 && !isLevelZeroSorted_) {
-      std::sort(items_.data() + adjBeg, items_.data() + adjBeg + adjPop, C());
+      std::sort(items_ + adjBeg, items_ + adjBeg + adjPop, C());
     }
     if (popAbove == 0) {
-      detail::randomlyHalveUp(items_.data(), adjBeg, adjPop, randomBit_);
+      detail::randomlyHalveUp(items_, adjBeg, adjPop, randomBit_);
     } else {
-      detail::randomlyHalveDown(items_.data(), adjBeg, adjPop, randomBit_);
+      detail::randomlyHalveDown(items_, adjBeg, adjPop, randomBit_);
       detail::mergeOverlap(
-          items_.data(),
+          items_,
           adjBeg,
           halfAdjPop,
           rawLim,
@@ -364,9 +527,9 @@ uint32_t KllSketch<T, A, C>::insertPosition() {
     if (level > 0) {
       const uint32_t amount = rawBeg - levels_[0];
       std::move_backward(
-          items_.data() + levels_[0],
-          items_.data() + levels_[0] + amount,
-          items_.data() + levels_[0] + halfAdjPop + amount);
+          items_ + levels_[0],
+          items_ + levels_[0] + amount,
+          items_ + levels_[0] + halfAdjPop + amount);
       for (uint8_t lvl = 0; lvl < level; lvl++) {
         levels_[lvl] += halfAdjPop;
       }
@@ -378,7 +541,7 @@ uint32_t KllSketch<T, A, C>::insertPosition() {
 template <typename T, typename A, typename C>
 int KllSketch<T, A, C>::findLevelToCompact() const {
   for (int level = 0;; ++level) {
-    VELOX_DCHECK_LT(level + 1, levels_.size());
+    VELOX_DCHECK_LE(level + 1, numLevels_);
     const uint32_t pop = levels_[level + 1] - levels_[level];
     const uint32_t cap = detail::levelCapacity(k_, numLevels(), level);
     if (pop >= cap) {
@@ -389,30 +552,31 @@ int KllSketch<T, A, C>::findLevelToCompact() const {
 
 template <typename T, typename A, typename C>
 void KllSketch<T, A, C>::addEmptyTopLevelToCompletelyFullSketch() {
-  const uint32_t curTotalCap = levels_.back();
+  const uint32_t curTotalCap = levels_[numLevels_];
 
   // Make sure that we are following a certain growth scheme.
   VELOX_DCHECK_EQ(levels_[0], 0);
-  VELOX_DCHECK_EQ(items_.size(), curTotalCap);
+  VELOX_DCHECK_LE(curTotalCap, capacity_);
 
   const uint32_t deltaCap = detail::levelCapacity(k_, numLevels() + 1, 0);
   const uint32_t newTotalCap = curTotalCap + deltaCap;
-  items_.resize(newTotalCap);
-  std::move_backward(
-      items_.begin(), items_.begin() + curTotalCap, items_.end());
+  if (numLevels_ + 2 > levelsCapacity_ || newTotalCap > capacity_) {
+    grow(numLevels_ + 1, newTotalCap);
+  }
+  std::move_backward(items_, items_ + curTotalCap, items_ + newTotalCap);
 
   // This loop includes the old "extra" index at the top.
-  for (auto& lvl : levels_) {
-    lvl += deltaCap;
+  for (uint8_t lvl = 0; lvl <= numLevels_; ++lvl) {
+    levels_[lvl] += deltaCap;
   }
-  VELOX_DCHECK_EQ(levels_.back(), newTotalCap);
-  levels_.push_back(newTotalCap);
+  VELOX_DCHECK_EQ(levels_[numLevels_], newTotalCap);
+  levels_[++numLevels_] = newTotalCap;
 }
 
 template <typename T, typename A, typename C>
 void KllSketch<T, A, C>::finish() {
   if (!isLevelZeroSorted_) {
-    std::sort(items_.data() + levels_[0], items_.data() + levels_[1], C());
+    std::sort(items_ + levels_[0], items_ + levels_[1], C());
     isLevelZeroSorted_ = true;
   }
 }
@@ -445,7 +609,7 @@ void KllSketch<T, A, C>::estimateQuantiles(
   using AllocEntry =
       typename std::allocator_traits<A>::template rebind_alloc<Entry>;
   std::vector<Entry, AllocEntry> entries((AllocEntry(allocator_)));
-  entries.reserve(levels_.back());
+  entries.reserve(levels_[numLevels_]);
   for (int level = 0; level < numLevels(); ++level) {
     auto oldLen = entries.size();
     for (int i = levels_[level]; i < levels_[level + 1]; ++i) {
@@ -532,48 +696,51 @@ void KllSketch<T, A, C>::mergeViews(const folly::Range<const View*>& others) {
   if (tmpNumItems > getNumRetained()) {
     std::vector<T, A> workbuf(tmpNumItems, allocator_);
     const uint8_t ub = 1 + detail::floorLog2(newN, 1);
-    const size_t workLevelsSize = ub + 2;
-    std::vector<uint32_t, AllocU32> worklevels(
-        workLevelsSize, 0, AllocU32(allocator_));
-    std::vector<uint32_t, AllocU32> outlevels(
-        workLevelsSize, 0, AllocU32(allocator_));
+    // 'ub' is at most 64 and generalCompress() uses 'ub' + 2 boundaries.
+    std::array<uint32_t, 66> worklevels{};
+    std::array<uint32_t, 66> outlevels{};
     // Populate work arrays.
     worklevels[0] = 0;
-    std::move(
-        items_.data() + levels_[0], items_.data() + levels_[1], workbuf.data());
+    std::move(items_ + levels_[0], items_ + levels_[1], workbuf.data());
     worklevels[1] = safeLevelSize(0);
-    // Merge each level, each level in all sketches are already sorted.
+    // Merge each level, each level in all sketches are already sorted. The
+    // heap of runs is reused for all levels.
+    using Entry = std::pair<const T*, const T*>;
+    using AllocEntry =
+        typename std::allocator_traits<A>::template rebind_alloc<Entry>;
+    auto gt = [](const Entry& x, const Entry& y) {
+      return C()(*y.first, *x.first);
+    };
+    std::vector<Entry, AllocEntry> heap((AllocEntry(allocator_)));
+    heap.reserve(others.size() + 1);
     for (uint8_t lvl = 1; lvl < provisionalNumLevels; ++lvl) {
-      using Entry = std::pair<const T*, const T*>;
-      using AllocEntry =
-          typename std::allocator_traits<A>::template rebind_alloc<Entry>;
-      auto gt = [](const Entry& x, const Entry& y) {
-        return C()(*y.first, *x.first);
-      };
-      std::priority_queue<Entry, std::vector<Entry, AllocEntry>, decltype(gt)>
-          pq(gt, AllocEntry(allocator_));
       if (auto sz = safeLevelSize(lvl); sz > 0) {
-        pq.emplace(
-            items_.data() + levels_[lvl], items_.data() + levels_[lvl] + sz);
+        heap.emplace_back(items_ + levels_[lvl], items_ + levels_[lvl] + sz);
       }
       for (auto& other : others) {
         if (auto sz = other.safeLevelSize(lvl); sz > 0) {
-          pq.emplace(
+          heap.emplace_back(
               &other.items[other.levels[lvl]],
               &other.items[other.levels[lvl]] + sz);
         }
       }
+      std::make_heap(heap.begin(), heap.end(), gt);
       int outIndex = worklevels[lvl];
-      while (!pq.empty()) {
-        auto [s, t] = pq.top();
-        pq.pop();
+      while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), gt);
+        auto& [s, t] = heap.back();
         workbuf[outIndex++] = *s++;
         if (s < t) {
-          pq.emplace(s, t);
+          std::push_heap(heap.begin(), heap.end(), gt);
+        } else {
+          heap.pop_back();
         }
       }
       worklevels[lvl + 1] = outIndex;
     }
+    // All items are in 'workbuf' now, so the old block can go before the
+    // one of the result is allocated.
+    release();
     auto result = detail::generalCompress<T, C>(
         k_,
         provisionalNumLevels,
@@ -584,20 +751,20 @@ void KllSketch<T, A, C>::mergeViews(const folly::Range<const View*>& others) {
         randomBit_);
     VELOX_DCHECK_LE(result.finalNumLevels, ub);
     // Now we need to transfer the results back into "this" sketch.
-    items_.resize(result.finalCapacity);
+    allocate(result.finalNumLevels + 1, result.finalCapacity);
+    numLevels_ = result.finalNumLevels;
     const auto freeSpaceAtBottom = result.finalCapacity - result.finalNumItems;
     std::move(
         workbuf.data() + outlevels[0],
         workbuf.data() + outlevels[0] + result.finalNumItems,
-        items_.data() + freeSpaceAtBottom);
-    levels_.resize(result.finalNumLevels + 1);
+        items_ + freeSpaceAtBottom);
     const auto offset = freeSpaceAtBottom - outlevels[0];
-    for (unsigned lvl = 0; lvl < levels_.size(); ++lvl) {
+    for (unsigned lvl = 0; lvl <= numLevels_; ++lvl) {
       levels_[lvl] = outlevels[lvl] + offset;
     }
   }
   n_ = newN;
-  VELOX_DCHECK_EQ(detail::sumSampleWeights(numLevels(), levels_.data()), n_);
+  VELOX_DCHECK_EQ(detail::sumSampleWeights(numLevels(), levels_), n_);
 }
 
 template <typename T, typename A, typename C>
@@ -643,8 +810,8 @@ typename KllSketch<T, A, C>::View KllSketch<T, A, C>::toView() const {
       .n = n_,
       .minValue = minValue_,
       .maxValue = maxValue_,
-      .items = {items_},
-      .levels = {levels_},
+      .items = {items_, levels_[numLevels_]},
+      .levels = {levels_, numLevels_ + 1u},
   };
 }
 
@@ -658,18 +825,22 @@ KllSketch<T, A, C> KllSketch<T, A, C>::fromView(
   ans.n_ = view.n;
   ans.minValue_ = view.minValue;
   ans.maxValue_ = view.maxValue;
-  ans.items_.assign(view.items.begin(), view.items.end());
-  ans.levels_.assign(view.levels.begin(), view.levels.end());
+  if (!view.items.empty()) {
+    ans.allocate(view.levels.size(), view.items.size());
+    ans.numLevels_ = view.numLevels();
+    std::copy(view.levels.begin(), view.levels.end(), ans.levels_);
+    std::copy(view.items.begin(), view.items.end(), ans.items_);
+  }
   ans.isLevelZeroSorted_ = std::is_sorted(
-      &ans.items_[ans.levels_[0]], &ans.items_[ans.levels_[1]], C());
+      ans.items_ + ans.levels_[0], ans.items_ + ans.levels_[1], C());
   return ans;
 }
 
 template <typename T, typename A, typename C>
 size_t KllSketch<T, A, C>::serializedByteSize() const {
   size_t ans = sizeof k_ + sizeof n_ + sizeof minValue_ + sizeof maxValue_;
-  ans += sizeof(size_t) + sizeof(T) * items_.size();
-  ans += sizeof(size_t) + sizeof(uint32_t) * levels_.size();
+  ans += sizeof(size_t) + sizeof(T) * levels_[numLevels_];
+  ans += sizeof(size_t) + sizeof(uint32_t) * (numLevels_ + 1);
   return ans;
 }
 
@@ -680,8 +851,8 @@ void KllSketch<T, A, C>::serialize(char* out) const {
   detail::write(n_, out, i);
   detail::write(minValue_, out, i);
   detail::write(maxValue_, out, i);
-  detail::writeVector(items_, out, i);
-  detail::writeVector(levels_, out, i);
+  detail::writeRange(items_, levels_[numLevels_], out, i);
+  detail::writeRange(levels_, numLevels_ + 1, out, i);
   VELOX_DCHECK_EQ(i, serializedByteSize());
 }
 
@@ -725,14 +896,16 @@ KllSketch<T, A, C> KllSketch<T, A, C>::fromRepeatedValue(
   ans.n_ = count;
   ans.minValue_ = ans.maxValue_ = value;
   ans.isLevelZeroSorted_ = true;
-  ans.levels_.resize(numLevels + 1);
+  ans.allocate(numLevels + 1, __builtin_popcountll(count));
+  ans.numLevels_ = numLevels;
+  ans.levels_[0] = 0;
   for (int i = 1; i <= numLevels; ++i) {
     ans.levels_[i] = ans.levels_[i - 1] + (count & 1);
     count >>= 1;
   }
-  ans.items_.resize(ans.levels_.back(), value);
+  std::fill(ans.items_, ans.items_ + ans.levels_[numLevels], value);
   VELOX_DCHECK_EQ(
-      detail::sumSampleWeights(ans.numLevels(), ans.levels_.data()), ans.n_);
+      detail::sumSampleWeights(ans.numLevels(), ans.levels_), ans.n_);
   return ans;
 }
 
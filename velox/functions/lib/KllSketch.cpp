@@ -24,6 +24,8 @@ uint32_t kFromEpsilon(double eps) {
 
 namespace detail {
 
+const uint32_t kEmptyLevels[2] = {0, 0};
+
 namespace {
 
 constexpr uint8_t kMinBufferWidth = 8;
@@ -44,6 +44,11 @@ uint32_t kFromEpsilon(double epsilon);
 /// 1.33%.
 ///
 /// See https://arxiv.org/abs/1603.05346v2 for more details.
+///
+/// The level boundaries and the items live in one allocation from
+/// `Allocator`, which is grown as the sketch fills up and replaced when
+/// sketches are merged.  Compaction happens in place.  An empty sketch
+/// allocates nothing.  T must be trivially copyable.
 template <
     typename T,
     typename Allocator = std::allocator<T>,
@@ -54,6 +59,18 @@ struct KllSketch {
       const Allocator& = Allocator(),
       uint32_t seed = folly::Random::rand32());
 
+  KllSketch(const KllSketch<T, Allocator, Compare>& other);
+
+  KllSketch(KllSketch<T, Allocator, Compare>&& other) noexcept;
+
+  KllSketch<T, Allocator, Compare>& operator=(
+      const KllSketch<T, Allocator, Compare>& other);
+
+  KllSketch<T, Allocator, Compare>& operator=(
+      KllSketch<T, Allocator, Compare>&& other) noexcept;
+
+  ~KllSketch();
+
   /// Cannot be called after insert().
   void setK(uint32_t k);
 
@@ -113,6 +130,8 @@ struct KllSketch {
       uint32_t seed = folly::Random::rand32());
 
   /// Merge this sketch with values from multiple other deserialized sketches.
+  /// This compacts once for all of `sketches` and is cheaper than merging
+  /// them one at a time.
   /// @tparam Iter Iterator type dereferenceable to `const char*`, which
   ///  represents a deserialized sketch
   /// @param sketches Range of sketches to be merged to this one
@@ -134,11 +153,11 @@ struct KllSketch {
   void estimateQuantiles(const folly::Range<Iter>& fractions, T* out) const;
 
   uint8_t numLevels() const {
-    return levels_.size() - 1;
+    return numLevels_;
   }
 
   uint32_t getNumRetained() const {
-    return levels_.back() - levels_[0];
+    return levels_[numLevels_] - levels_[0];
   }
 
   uint32_t safeLevelSize(uint8_t level) const {
@@ -172,6 +191,21 @@ struct KllSketch {
   using AllocU32 = typename std::allocator_traits<
       Allocator>::template rebind_alloc<uint32_t>;
 
+  // Replaces the storage with a new block of room for 'levelsCapacity'
+  // level boundaries and 'capacity' items. The contents are not copied.
+  void allocate(uint8_t levelsCapacity, uint32_t capacity);
+
+  // Allocates a block for 'numLevels' levels and 'capacity' items and moves
+  // the levels and items to it. The items keep their positions.
+  void grow(uint8_t numLevels, uint32_t capacity);
+
+  // Frees the storage and makes this an empty sketch.
+  void release();
+
+  static size_t itemsOffset(uint8_t levelsCapacity);
+
+  static size_t blockWords(uint8_t levelsCapacity, uint32_t capacity);
+
   uint32_t k_;
   Allocator allocator_;
 
@@ -183,8 +217,17 @@ struct KllSketch {
   size_t n_;
   T minValue_;
   T maxValue_;
-  std::vector<T, Allocator> items_;
-  std::vector<uint32_t, AllocU32> levels_;
+
+  // Room for 'levelsCapacity_' level boundaries followed by room for
+  // 'capacity_' items, in a single block. Level i is items_[levels_[i]] to
+  // items_[levels_[i + 1]] and the retained items end at
+  // levels_[numLevels_], which is at most 'capacity_'. An empty sketch
+  // points 'levels_' to two shared zeros and has no block.
+  uint32_t* levels_;
+  T* items_;
+  uint32_t capacity_;
+  uint8_t levelsCapacity_;
+  uint8_t numLevels_;
   bool isLevelZeroSorted_;
 };
 
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/lib/Re2Cache.h"
+
+namespace facebook::velox::functions {
+namespace {
+
+// Upper bound for the estimated size of the cached patterns.
+constexpr int64_t kMaxCacheBytes = 64 << 20;
+
+struct Re2Generator {
+  std::unique_ptr<re2::RE2> operator()(const Re2CacheKey& key) const {
+    re2::RE2::Options options(re2::RE2::Quiet);
+    options.set_dot_nl(key.second);
+    return std::make_unique<re2::RE2>(key.first, options);
+  }
+};
+
+// ProgramSize() counts instructions. An instruction takes 8 bytes and the
+// prefilter, the parsed regexp and the lazily built DFA states roughly as
+// much again.
+struct Re2Sizer {
+  int64_t operator()(const re2::RE2& re) const {
+    return sizeof(re2::RE2) + 2 * re.pattern().size() +
+        (re.ok() ? 16 * re.ProgramSize() : 0);
+  }
+};
+
+using Re2Cache = CachedFactory<
+    Re2CacheKey,
+    re2::RE2,
+    Re2Generator,
+    Re2Sizer,
+    std::equal_to<Re2CacheKey>,
+    folly::hasher<Re2CacheKey>>;
+
+// Not destroyed at exit, since static function instances may still pin
+// entries.
+Re2Cache& re2Cache() {
+  static auto* cache = new Re2Cache(
+      std::make_unique<SimpleLRUCache<
+          Re2CacheKey,
+          re2::RE2,
+          std::equal_to<Re2CacheKey>,
+          folly::hasher<Re2CacheKey>>>(kMaxCacheBytes),
+      std::make_unique<Re2Generator>());
+  return *cache;
+}
+
+} // namespace
+
+CachedRe2 compileRe2(StringView pattern, bool dotNl) {
+  return re2Cache().generate(
+      Re2CacheKey(std::string(pattern.data(), pattern.size()), dotNl));
+}
+
+} // namespace facebook::velox::functions
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <re2/re2.h>
+#include <string>
+#include <utility>
+
+#include <folly/hash/Hash.h>
+
+#include "velox/common/caching/CachedFactory.h"
+#include "velox/type/StringView.h"
+
+namespace facebook::velox::functions {
+
+// The pattern and whether '.' matches a new line.
+using Re2CacheKey = std::pair<std::string, bool>;
+
+using CachedRe2 = CachedPtr<
+    Re2CacheKey,
+    re2::RE2,
+    std::equal_to<Re2CacheKey>,
+    folly::hasher<Re2CacheKey>>;
+
+// Returns 'pattern' compiled with RE2::Quiet from a process-wide LRU cache of
+// compiled patterns, so that queries with the same patterns do not compile
+// them again. The cache is bounded by an estimate of the memory of the
+// compiled programs. The returned RE2 is pinned in the cache until the
+// CachedRe2 is destroyed and may be used from any number of threads. Invalid
+// patterns are cached too: the caller checks ok().
+CachedRe2 compileRe2(StringView pattern, bool dotNl = false);
+
+} // namespace facebook::velox::functions
@@ -19,9 +19,13 @@
 #include <optional>
 #include <string>
 
+#include <xsimd/xsimd.hpp>
+
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
 #include "velox/functions/lib/ArrayBuilder.h"
+#include "velox/functions/lib/Re2Cache.h"
 #include "velox/type/StringView.h"
 #include "velox/vector/FlatVector.h"
 
@@ -67,6 +71,27 @@ void checkForBadPattern(const RE2& re) {
   }
 }
 
+// Compiles the patterns of the rows of a non-constant pattern argument. A row
+// with the pattern of the previous row reuses its RE2 without a lookup in the
+// process-wide cache.
+class RowPatterns {
+ public:
+  // Returns the compiled 'pattern'. Throws if the pattern is invalid.
+  const RE2& get(StringView pattern) {
+    if (!re_.get() || pattern != pattern_) {
+      auto re = compileRe2(pattern);
+      checkForBadPattern(*re);
+      re_ = std::move(re);
+      pattern_ = pattern;
+    }
+    return *re_;
+  }
+
+ private:
+  StringView pattern_;
+  CachedRe2 re_;
+};
+
 FlatVector<bool>& ensureWritableBool(
     const SelectivityVector& rows,
     velox::memory::MemoryPool* pool,
@@ -181,11 +206,230 @@ std::string likePatternToRe2(
   return regex;
 }
 
+// Kinds of LIKE patterns that are matched without RE2. A fixed pattern has
+// literal characters and '_'.
+enum class LikePatternKind {
+  // A fixed pattern.
+  kFixed,
+  // A fixed pattern followed by '%'.
+  kPrefix,
+  // '%' followed by a fixed pattern.
+  kSuffix,
+  // Literal characters between two '%'.
+  kSubstring,
+  // Any other pattern. Matched with RE2.
+  kGeneric,
+};
+
+struct LikePattern {
+  // Literal characters followed by a number of '_'.
+  struct Segment {
+    std::string literal;
+    int32_t numAnyChars{0};
+  };
+
+  LikePatternKind kind{LikePatternKind::kGeneric};
+
+  // The fixed part of the pattern, without the leading and trailing '%'.
+  std::vector<Segment> segments;
+
+  // The fixed part if it has no '_'.
+  std::optional<std::string> literal;
+};
+
+// Returns the kind and the fixed part of 'pattern'. 'validPattern' is set to
+// false if an escape character is not followed by '%', '_' or the escape
+// character, as in likePatternToRe2().
+LikePattern parseLikePattern(
+    StringView pattern,
+    std::optional<char> escapeChar,
+    bool& validPattern) {
+  // '%' is -1 and '_' is -2, literal characters are unsigned.
+  constexpr int32_t kAnyString = -1;
+  constexpr int32_t kAnyChar = -2;
+  std::vector<int32_t> tokens;
+  tokens.reserve(pattern.size());
+  validPattern = true;
+  bool escaped = false;
+  for (const char c : pattern) {
+    if (escaped) {
+      if (!(c == '%' || c == '_' || c == escapeChar)) {
+        validPattern = false;
+      }
+      tokens.push_back(static_cast<uint8_t>(c));
+      escaped = false;
+    } else if (c == escapeChar) {
+      escaped = true;
+    } else if (c == '%') {
+      tokens.push_back(kAnyString);
+    } else if (c == '_') {
+      tokens.push_back(kAnyChar);
+    } else {
+      tokens.push_back(static_cast<uint8_t>(c));
+    }
+  }
+  LikePattern result;
+  if (escaped) {
+    validPattern = false;
+  }
+  if (!validPattern) {
+    return result;
+  }
+
+  auto begin = tokens.begin();
+  auto end = tokens.end();
+  const bool leadingAny = begin != end && *begin == kAnyString;
+  while (begin != end && *begin == kAnyString) {
+    ++begin;
+  }
+  const bool trailingAny = begin != end && *(end - 1) == kAnyString;
+  while (begin != end && *(end - 1) == kAnyString) {
+    --end;
+  }
+  bool hasAnyChar = false;
+  for (auto it = begin; it != end; ++it) {
+    if (*it == kAnyString) {
+      return result;
+    }
+    if (*it == kAnyChar) {
+      hasAnyChar = true;
+      if (result.segments.empty()) {
+        result.segments.emplace_back();
+      }
+      ++result.segments.back().numAnyChars;
+    } else {
+      if (result.segments.empty() || result.segments.back().numAnyChars > 0) {
+        result.segments.emplace_back();
+      }
+      result.segments.back().literal.push_back(static_cast<char>(*it));
+    }
+  }
+  if (!hasAnyChar) {
+    result.literal = result.segments.empty() ? std::string()
+                                             : result.segments[0].literal;
+  }
+
+  if (leadingAny && (trailingAny || begin == end)) {
+    // '%' alone is a prefix pattern and matches everything.
+    if (begin == end) {
+      result.kind = LikePatternKind::kPrefix;
+    } else if (!hasAnyChar) {
+      result.kind = LikePatternKind::kSubstring;
+    }
+  } else if (leadingAny) {
+    result.kind = LikePatternKind::kSuffix;
+  } else if (trailingAny) {
+    result.kind = LikePatternKind::kPrefix;
+  } else {
+    result.kind = LikePatternKind::kFixed;
+  }
+  return result;
+}
+
+// Returns the number of bytes of the UTF-8 character starting with 'c'.
+// Bytes that do not start a character count as one character.
+inline int32_t utf8CharLength(uint8_t c) {
+  if (c < 0xc0) {
+    return 1;
+  }
+  return c < 0xe0 ? 2 : (c < 0xf0 ? 3 : 4);
+}
+
+// Matches 'segments' to the start of 'input', with '_' matching one UTF-8
+// character. Returns the number of bytes matched or -1 if there is no match.
+int64_t matchSegmentsForward(
+    const std::vector<LikePattern::Segment>& segments,
+    std::string_view input) {
+  size_t pos = 0;
+  for (const auto& segment : segments) {
+    const auto& literal = segment.literal;
+    if (input.size() - pos < literal.size() ||
+        std::memcmp(input.data() + pos, literal.data(), literal.size()) != 0) {
+      return -1;
+    }
+    pos += literal.size();
+    for (auto i = 0; i < segment.numAnyChars; ++i) {
+      if (pos >= input.size()) {
+        return -1;
+      }
+      pos += utf8CharLength(input[pos]);
+    }
+    if (pos > input.size()) {
+      return -1;
+    }
+  }
+  return pos;
+}
+
+// Matches 'segments' to the end of 'input'. Returns true on a match.
+bool matchSegmentsBackward(
+    const std::vector<LikePattern::Segment>& segments,
+    std::string_view input) {
+  auto end = input.size();
+  for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+    for (auto i = 0; i < it->numAnyChars; ++i) {
+      if (end == 0) {
+        return false;
+      }
+      --end;
+      while (end > 0 && (static_cast<uint8_t>(input[end]) & 0xc0) == 0x80) {
+        --end;
+      }
+    }
+    const auto& literal = it->literal;
+    if (end < literal.size() ||
+        std::memcmp(
+            input.data() + end - literal.size(),
+            literal.data(),
+            literal.size()) != 0) {
+      return false;
+    }
+    end -= literal.size();
+  }
+  return true;
+}
+
+// Returns true if 'input' contains 'substring'. Compares the first and the
+// last character of 'substring' to a SIMD batch of positions at a time and
+// the rest of 'substring' only at the positions where both match.
+bool simdContains(std::string_view input, std::string_view substring) {
+  const auto size = substring.size();
+  if (size == 0) {
+    return true;
+  }
+  if (input.size() < size) {
+    return false;
+  }
+  if (size == 1) {
+    return std::memchr(input.data(), substring[0], input.size()) != nullptr;
+  }
+  using Batch = xsimd::batch<uint8_t>;
+  const auto first = Batch(substring[0]);
+  const auto last = Batch(substring[size - 1]);
+  const auto* data = reinterpret_cast<const uint8_t*>(input.data());
+  size_t i = 0;
+  for (; i + size - 1 + Batch::size <= input.size(); i += Batch::size) {
+    auto candidates = static_cast<uint32_t>(simd::toBitMask(
+        (Batch::load_unaligned(data + i) == first) &
+        (Batch::load_unaligned(data + i + size - 1) == last)));
+    while (candidates) {
+      auto offset = i + __builtin_ctz(candidates);
+      if (std::memcmp(
+              input.data() + offset + 1, substring.data() + 1, size - 2) ==
+          0) {
+        return true;
+      }
+      candidates &= candidates - 1;
+    }
+  }
+  return input.substr(i).find(substring) != std::string_view::npos;
+}
+
 template <bool (*Fn)(StringView, const RE2&)>
 class Re2MatchConstantPattern final : public VectorFunction {
  public:
   explicit Re2MatchConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(compileRe2(pattern)) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -197,14 +441,14 @@ class Re2MatchConstantPattern final : public VectorFunction {
     FlatVector<bool>& result =
         ensureWritableBool(rows, context->pool(), resultRef);
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
-    checkForBadPattern(re_);
+    checkForBadPattern(*re_);
     rows.applyToSelected([&](vector_size_t i) {
-      result.set(i, Fn(toSearch->valueAt<StringView>(i), re_));
+      result.set(i, Fn(toSearch->valueAt<StringView>(i), *re_));
     });
   }
 
  private:
-  RE2 re_;
+  CachedRe2 re_;
 };
 
 template <bool (*Fn)(StringView, const RE2&)>
@@ -227,9 +471,9 @@ class Re2Match final : public VectorFunction {
         ensureWritableBool(rows, context->pool(), resultRef);
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
+    RowPatterns patterns;
     rows.applyToSelected([&](vector_size_t row) {
-      RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
-      checkForBadPattern(re);
+      const auto& re = patterns.get(pattern->valueAt<StringView>(row));
       result.set(row, Fn(toSearch->valueAt<StringView>(row), re));
     });
   }
@@ -247,7 +491,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
   explicit Re2SearchAndExtractConstantPattern(
       StringView pattern,
       bool emptyNoMatch)
-      : re_(toStringPiece(pattern), RE2::Quiet), emptyNoMatch_(emptyNoMatch) {}
+      : re_(compileRe2(pattern)), emptyNoMatch_(emptyNoMatch) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -261,7 +505,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
         ensureWritableStringView(rows, context->pool(), resultRef);
 
     // apply() will not be invoked if the selection is empty.
-    checkForBadPattern(re_);
+    checkForBadPattern(*re_);
 
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     bool mustRefSourceStrings = false;
@@ -271,7 +515,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
       groups.resize(1);
       rows.applyToSelected([&](vector_size_t i) {
         mustRefSourceStrings |=
-            re2Extract(result, i, re_, toSearch, groups, 0, emptyNoMatch_);
+            re2Extract(result, i, *re_, toSearch, groups, 0, emptyNoMatch_);
       });
       if (mustRefSourceStrings) {
         result.acquireSharedStringBuffers(toSearch->base());
@@ -280,11 +524,11 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
     }
 
     if (const auto groupId = getIfConstant<T>(*args[2])) {
-      checkForBadGroupId(*groupId, re_);
+      checkForBadGroupId(*groupId, *re_);
       groups.resize(*groupId + 1);
       rows.applyToSelected([&](vector_size_t i) {
         mustRefSourceStrings |= re2Extract(
-            result, i, re_, toSearch, groups, *groupId, emptyNoMatch_);
+            result, i, *re_, toSearch, groups, *groupId, emptyNoMatch_);
       });
       if (mustRefSourceStrings) {
         result.acquireSharedStringBuffers(toSearch->base());
@@ -300,13 +544,13 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
       maxGroupId = std::max(groupIds->valueAt<T>(i), maxGroupId);
       minGroupId = std::min(groupIds->valueAt<T>(i), minGroupId);
     });
-    checkForBadGroupId(maxGroupId, re_);
-    checkForBadGroupId(minGroupId, re_);
+    checkForBadGroupId(maxGroupId, *re_);
+    checkForBadGroupId(minGroupId, *re_);
     groups.resize(maxGroupId + 1);
     rows.applyToSelected([&](vector_size_t i) {
       T group = groupIds->valueAt<T>(i);
       mustRefSourceStrings |=
-          re2Extract(result, i, re_, toSearch, groups, group, emptyNoMatch_);
+          re2Extract(result, i, *re_, toSearch, groups, group, emptyNoMatch_);
     });
     if (mustRefSourceStrings) {
       result.acquireSharedStringBuffers(toSearch->base());
@@ -314,7 +558,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
   }
 
  private:
-  RE2 re_;
+  CachedRe2 re_;
   const bool emptyNoMatch_;
 }; // namespace
 
@@ -347,11 +591,11 @@ class Re2SearchAndExtract final : public VectorFunction {
     exec::LocalDecodedVector pattern(context, *args[1], rows);
     bool mustRefSourceStrings = false;
     FOLLY_DECLARE_REUSED(groups, std::vector<re2::StringPiece>);
+    RowPatterns patterns;
     if (args.size() == 2) {
       groups.resize(1);
       rows.applyToSelected([&](vector_size_t i) {
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(i)), RE2::Quiet);
-        checkForBadPattern(re);
+        const auto& re = patterns.get(pattern->valueAt<StringView>(i));
         mustRefSourceStrings |=
             re2Extract(result, i, re, toSearch, groups, 0, emptyNoMatch_);
       });
@@ -359,8 +603,7 @@ class Re2SearchAndExtract final : public VectorFunction {
       exec::LocalDecodedVector groupIds(context, *args[2], rows);
       rows.applyToSelected([&](vector_size_t i) {
         const auto groupId = groupIds->valueAt<T>(i);
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(i)), RE2::Quiet);
-        checkForBadPattern(re);
+        const auto& re = patterns.get(pattern->valueAt<StringView>(i));
         checkForBadGroupId(groupId, re);
         groups.resize(groupId + 1);
         mustRefSourceStrings |=
@@ -379,8 +622,14 @@ class Re2SearchAndExtract final : public VectorFunction {
 class LikeConstantPattern final : public VectorFunction {
  public:
   LikeConstantPattern(StringView pattern, std::optional<char> escapeChar)
-      : re_(toStringPiece(likePatternToRe2(pattern, escapeChar, validPattern_)),
-            RE2::Quiet) {}
+      : pattern_(parseLikePattern(pattern, escapeChar, validPattern_)) {
+    if (validPattern_ && pattern_.kind == LikePatternKind::kGeneric) {
+      // '%' and '_' match any character, also a new line.
+      re_ = compileRe2(
+          StringView(likePatternToRe2(pattern, escapeChar, validPattern_)),
+          /*dotNl=*/true);
+    }
+  }
 
   void apply(
       const SelectivityVector& rows,
@@ -398,23 +647,93 @@ class LikeConstantPattern final : public VectorFunction {
     }
 
     // apply() will not be invoked if the selection is empty.
-    checkForBadPattern(re_);
+    if (re_.get()) {
+      checkForBadPattern(*re_);
+    }
     FlatVector<bool>& result =
         ensureWritableBool(rows, context->pool(), resultRef);
 
     exec::DecodedArgs decodedArgs(rows, args, context);
     auto toSearch = decodedArgs.at(0);
-    if (toSearch->isIdentityMapping()) {
-      auto rawStrings = toSearch->data<StringView>();
+    const auto& segments = pattern_.segments;
+    if (pattern_.literal.has_value()) {
+      const std::string_view literal = *pattern_.literal;
+      switch (pattern_.kind) {
+        case LikePatternKind::kFixed:
+          applyMatch(rows, *toSearch, result, [&](std::string_view input) {
+            return input == literal;
+          });
+          return;
+        case LikePatternKind::kPrefix:
+          applyMatch(rows, *toSearch, result, [&](std::string_view input) {
+            return input.size() >= literal.size() &&
+                std::memcmp(input.data(), literal.data(), literal.size()) ==
+                0;
+          });
+          return;
+        case LikePatternKind::kSuffix:
+          applyMatch(rows, *toSearch, result, [&](std::string_view input) {
+            return input.size() >= literal.size() &&
+                std::memcmp(
+                    input.data() + input.size() - literal.size(),
+                    literal.data(),
+                    literal.size()) == 0;
+          });
+          return;
+        case LikePatternKind::kSubstring:
+          applyMatch(rows, *toSearch, result, [&](std::string_view input) {
+            return simdContains(input, literal);
+          });
+          return;
+        default:
+          break;
+      }
+    }
+    switch (pattern_.kind) {
+      case LikePatternKind::kFixed:
+        applyMatch(rows, *toSearch, result, [&](std::string_view input) {
+          return matchSegmentsForward(segments, input) ==
+              static_cast<int64_t>(input.size());
+        });
+        return;
+      case LikePatternKind::kPrefix:
+        applyMatch(rows, *toSearch, result, [&](std::string_view input) {
+          return matchSegmentsForward(segments, input) >= 0;
+        });
+        return;
+      case LikePatternKind::kSuffix:
+        applyMatch(rows, *toSearch, result, [&](std::string_view input) {
+          return matchSegmentsBackward(segments, input);
+        });
+        return;
+      default:
+        applyMatch(rows, *toSearch, result, [&](std::string_view input) {
+          return RE2::FullMatch(toStringPiece(input), *re_);
+        });
+    }
+  }
+
+ private:
+  template <typename Match>
+  static void applyMatch(
+      const SelectivityVector& rows,
+      const DecodedVector& toSearch,
+      FlatVector<bool>& result,
+      Match match) {
+    auto toStringView = [](StringView value) {
+      return std::string_view(value.data(), value.size());
+    };
+    if (toSearch.isIdentityMapping()) {
+      auto rawStrings = toSearch.data<StringView>();
       rows.applyToSelected([&](vector_size_t i) {
-        result.set(i, re2FullMatch(rawStrings[i], re_));
+        result.set(i, match(toStringView(rawStrings[i])));
       });
       return;
     }
 
-    if (toSearch->isConstantMapping()) {
-      bool match = re2FullMatch(toSearch->valueAt<StringView>(0), re_);
-      rows.applyToSelected([&](vector_size_t i) { result.set(i, match); });
+    if (toSearch.isConstantMapping()) {
+      bool matched = match(toStringView(toSearch.valueAt<StringView>(0)));
+      rows.applyToSelected([&](vector_size_t i) { result.set(i, matched); });
       return;
     }
 
@@ -424,9 +743,10 @@ class LikeConstantPattern final : public VectorFunction {
     VELOX_UNREACHABLE();
   }
 
- private:
-  RE2 re_;
   bool validPattern_;
+  const LikePattern pattern_;
+  // Set for a kGeneric pattern.
+  CachedRe2 re_;
 };
 
 void re2ExtractAll(
@@ -460,7 +780,7 @@ template <typename T>
 class Re2ExtractAllConstantPattern final : public VectorFunction {
  public:
   explicit Re2ExtractAllConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(compileRe2(pattern)) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -469,7 +789,7 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
       EvalCtx* context,
       VectorPtr* resultRef) const final {
     VELOX_CHECK(args.size() == 2 || args.size() == 3);
-    checkForBadPattern(re_);
+    checkForBadPattern(*re_);
 
     ArrayBuilder<Varchar> builder(
         rows.size(), rows.countSelected() * 3, context->pool());
@@ -481,15 +801,15 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
       //
       groups.resize(1);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        re2ExtractAll(builder, re_, inputStrs, row, groups, 0);
+        re2ExtractAll(builder, *re_, inputStrs, row, groups, 0);
       });
     } else if (const auto _groupId = getIfConstant<T>(*args[2])) {
       // Case 2: Constant groupId
       //
-      checkForBadGroupId(*_groupId, re_);
+      checkForBadGroupId(*_groupId, *re_);
       groups.resize(*_groupId + 1);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        re2ExtractAll(builder, re_, inputStrs, row, groups, *_groupId);
+        re2ExtractAll(builder, *re_, inputStrs, row, groups, *_groupId);
       });
     } else {
       // Case 3: Variable groupId, so resize the groups vector to accommodate
@@ -501,13 +821,13 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
         maxGroupId = std::max(groupIds->valueAt<T>(row), maxGroupId);
         minGroupId = std::min(groupIds->valueAt<T>(row), minGroupId);
       });
-      checkForBadGroupId(maxGroupId, re_);
-      checkForBadGroupId(minGroupId, re_);
+      checkForBadGroupId(maxGroupId, *re_);
+      checkForBadGroupId(minGroupId, *re_);
       groups.resize(maxGroupId + 1);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
         const T groupId = groupIds->valueAt<T>(row);
-        checkForBadGroupId(groupId, re_);
-        re2ExtractAll(builder, re_, inputStrs, row, groups, groupId);
+        checkForBadGroupId(groupId, *re_);
+        re2ExtractAll(builder, *re_, inputStrs, row, groups, groupId);
       });
     }
 
@@ -520,7 +840,7 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
   }
 
  private:
-  RE2 re_;
+  CachedRe2 re_;
 };
 
 template <typename T>
@@ -546,14 +866,14 @@ class Re2ExtractAll final : public VectorFunction {
     exec::LocalDecodedVector inputStrs(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
     FOLLY_DECLARE_REUSED(groups, std::vector<re2::StringPiece>);
+    RowPatterns patterns;
 
     if (args.size() == 2) {
       // Case 1: No groupId -- use 0 as the default groupId
       //
       groups.resize(1);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
-        checkForBadPattern(re);
+        const auto& re = patterns.get(pattern->valueAt<StringView>(row));
         re2ExtractAll(builder, re, inputStrs, row, groups, 0);
       });
     } else {
@@ -562,8 +882,7 @@ class Re2ExtractAll final : public VectorFunction {
       exec::LocalDecodedVector groupIds(context, *args[2], rows);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
         const T groupId = groupIds->valueAt<T>(row);
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
-        checkForBadPattern(re);
+        const auto& re = patterns.get(pattern->valueAt<StringView>(row));
         checkForBadGroupId(groupId, re);
         groups.resize(groupId + 1);
         re2ExtractAll(builder, re, inputStrs, row, groups, groupId);
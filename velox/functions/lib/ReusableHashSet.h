@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/hash/Hash.h>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "velox/common/base/BitUtil.h"
+
+namespace facebook::velox::functions {
+
+/// Open addressing hash set for building many small sets one after the
+/// other, e.g. one per array of an ArrayVector. clear() is O(1): a slot is
+/// occupied only if its generation is the current one, so clearing bumps the
+/// generation. The slots are kept across clear(), so that no memory is
+/// allocated once the capacity fits the largest set.
+///
+/// Values are compared with ==, as in std::unordered_set. StringViews are
+/// kept as is, so the strings must outlive the set. This holds for the
+/// elements of the input vectors of a function.
+template <typename T>
+class ReusableHashSet {
+ public:
+  explicit ReusableHashSet(int32_t expectedSize = 0) {
+    reserve(expectedSize);
+  }
+
+  /// Makes room for 'size' values without rehashing.
+  void reserve(int32_t size) {
+    if (size * 2 > capacity()) {
+      rehash(bits::nextPowerOfTwo(std::max(size * 2, kMinCapacity)));
+    }
+  }
+
+  /// Inserts 'value'. Returns true if 'value' was not in the set.
+  bool insert(T value) {
+    if ((size_ + 1) * 2 > capacity()) {
+      rehash(std::max(capacity() * 2, kMinCapacity));
+    }
+    auto slot = findSlot(value);
+    if (generations_[slot] == generation_) {
+      return false;
+    }
+    generations_[slot] = generation_;
+    slots_[slot] = value;
+    ++size_;
+    return true;
+  }
+
+  bool contains(T value) const {
+    if (size_ == 0) {
+      return false;
+    }
+    return generations_[findSlot(value)] == generation_;
+  }
+
+  int32_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  void clear() {
+    size_ = 0;
+    if (++generation_ == 0) {
+      std::fill(generations_.begin(), generations_.end(), 0);
+      generation_ = 1;
+    }
+  }
+
+ private:
+  static constexpr int32_t kMinCapacity = 16;
+
+  int32_t capacity() const {
+    return slots_.size();
+  }
+
+  static uint64_t hash(T value) {
+    return folly::hash::twang_mix64(std::hash<T>{}(value));
+  }
+
+  // Returns the slot of 'value' or the empty slot where it would go. There
+  // is always an empty slot since the load factor is at most 1/2.
+  int32_t findSlot(T value) const {
+    const auto mask = capacity() - 1;
+    auto slot = hash(value) & mask;
+    while (generations_[slot] == generation_ && !(slots_[slot] == value)) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  void rehash(int32_t newCapacity) {
+    std::vector<T> values;
+    values.reserve(size_);
+    for (auto i = 0; i < capacity(); ++i) {
+      if (generations_[i] == generation_) {
+        values.push_back(slots_[i]);
+      }
+    }
+    slots_.assign(newCapacity, T());
+    generations_.assign(newCapacity, 0);
+    generation_ = 1;
+    for (auto value : values) {
+      auto slot = findSlot(value);
+      generations_[slot] = generation_;
+      slots_[slot] = value;
+    }
+  }
+
+  std::vector<T> slots_;
+  // The slot 'i' is occupied if generations_[i] == generation_.
+  std::vector<uint32_t> generations_;
+  uint32_t generation_{1};
+  int32_t size_{0};
+};
+
+} // namespace facebook::velox::functions
@@ -308,41 +308,79 @@ class SubscriptImpl : public exec::VectorFunction {
 
     auto rawSizes = baseMap->rawSizes();
     auto rawOffsets = baseMap->rawOffsets();
-
-    // Lambda that does the search for a key, for each row.
-    auto processRow = [&](vector_size_t row, TKey searchKey) {
-      size_t mapIndex = mapIndices[row];
-      size_t offsetStart = rawOffsets[mapIndex];
-      size_t offsetEnd = offsetStart + rawSizes[mapIndex];
-      bool found = false;
-
-      // Sequentially check each key on this map for a match. We use a
-      // sequential scan over the keys because it's easier to express (and
-      // likely has good memory locality), but if we find that this is slow
-      // for large maps we could try to canonicalize the whole vector and binary
-      // search `searchKey`.
-      for (size_t offset = offsetStart; offset < offsetEnd; ++offset) {
+    const bool sortedKeys = baseMap->hasSortedKeys();
+
+    // Returns the offset of 'searchKey' in the map at 'mapIndex' of the base
+    // map or -1 if not found.
+    auto findKey = [&](vector_size_t mapIndex, TKey searchKey) {
+      vector_size_t offsetStart = rawOffsets[mapIndex];
+      vector_size_t offsetEnd = offsetStart + rawSizes[mapIndex];
+
+      // Maps with sorted keys, e.g. from canonicalize(), are binary searched.
+      // Otherwise the keys are scanned sequentially, which is faster for
+      // small maps.
+      if (sortedKeys) {
+        while (offsetStart < offsetEnd) {
+          auto middle = offsetStart + (offsetEnd - offsetStart) / 2;
+          if (decodedMapKeys->valueAt<TKey>(middle) < searchKey) {
+            offsetStart = middle + 1;
+          } else {
+            offsetEnd = middle;
+          }
+        }
+        if (offsetStart < rawOffsets[mapIndex] + rawSizes[mapIndex] &&
+            decodedMapKeys->valueAt<TKey>(offsetStart) == searchKey) {
+          return offsetStart;
+        }
+        return -1;
+      }
+      for (auto offset = offsetStart; offset < offsetEnd; ++offset) {
         if (decodedMapKeys->valueAt<TKey>(offset) == searchKey) {
-          rawIndices[row] = offset;
-          found = true;
-          break;
+          return offset;
         }
       }
+      return -1;
+    };
+
+    // Lambda that does the search for a key, for each row.
+    auto processRow = [&](vector_size_t row, TKey searchKey) {
+      auto offset = findKey(mapIndices[row], searchKey);
 
       // NB: We still allow non-existent map keys, even if out of bounds is
       // disabled for arrays.
 
       // Handle NULLs.
-      if (!found) {
+      if (offset == -1) {
         nullsBuilder.setNull(row);
+      } else {
+        rawIndices[row] = offset;
       }
     };
 
     // When second argument ("at") is a constant.
     if (decodedIndices->isConstantMapping()) {
       auto searchKey = decodedIndices->valueAt<TKey>(0);
-      rows.applyToSelected(
-          [&](vector_size_t row) { processRow(row, searchKey); });
+      if (decodedMap->isIdentityMapping()) {
+        rows.applyToSelected(
+            [&](vector_size_t row) { processRow(row, searchKey); });
+      } else {
+        // Rows of a dictionary or constant over the maps repeat base maps.
+        // The offset of the key is computed once per base map. kUnknown
+        // marks base maps not looked up yet.
+        constexpr vector_size_t kUnknown = -2;
+        std::vector<vector_size_t> baseOffsets(baseMap->size(), kUnknown);
+        rows.applyToSelected([&](vector_size_t row) {
+          auto& offset = baseOffsets[mapIndices[row]];
+          if (offset == kUnknown) {
+            offset = findKey(mapIndices[row], searchKey);
+          }
+          if (offset == -1) {
+            nullsBuilder.setNull(row);
+          } else {
+            rawIndices[row] = offset;
+          }
+        });
+      }
     }
     // When the second argument ("at") is also a variable vector.
     else {
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <iostream>
+#include <map>
 #include <random>
 
 #include <folly/Benchmark.h>
@@ -21,6 +23,7 @@
 #include <folly/portability/GFlags.h>
 #include <folly/stats/TDigest.h>
 
+#include "velox/common/memory/HashStringAllocator.h"
 #include "velox/functions/lib/KllSketch.h"
 
 namespace facebook::velox::functions::kll::test {
@@ -121,6 +124,77 @@ void mergeKllSketch(int iters, int maxSize, int count) {
   }
 }
 
+std::vector<std::vector<char>> serializedSketches(int maxSize, int count) {
+  std::vector<std::vector<char>> data(count);
+  std::vector<double> values;
+  for (int i = 0; i < count; ++i) {
+    populateValues(maxSize, values);
+    KllSketch<double> kll;
+    for (auto v : values) {
+      kll.insert(v);
+    }
+    data[i].resize(kll.serializedByteSize());
+    kll.serialize(data[i].data());
+    values.clear();
+  }
+  return data;
+}
+
+// Merges 'count' serialized sketches into a sketch in a HashStringAllocator
+// one at a time or in one batch, as the intermediate aggregation of
+// approx_percentile does.
+void mergeDeserializedKllSketch(int iters, int maxSize, int count, bool batch) {
+  std::vector<std::vector<char>> data;
+  std::vector<const char*> sketches;
+  BENCHMARK_SUSPEND {
+    data = serializedSketches(maxSize, count);
+    for (auto& sketch : data) {
+      sketches.push_back(sketch.data());
+    }
+  }
+  HashStringAllocator allocator(memory::MappedMemory::getInstance());
+  for (int i = 0; i < iters; ++i) {
+    KllSketch<double, StlAllocator<double>> kll(
+        kDefaultK, StlAllocator<double>(&allocator));
+    if (batch) {
+      kll.mergeDeserialized(folly::Range(sketches.begin(), sketches.end()));
+    } else {
+      for (auto* sketch : sketches) {
+        kll.mergeDeserialized(sketch);
+      }
+    }
+    folly::doNotOptimizeAway(kll.totalCount());
+  }
+}
+
+// Bytes of HashStringAllocator memory per group after insertGroups(), keyed
+// on the number of values per group.
+std::map<int, int64_t> bytesPerGroup;
+
+// Inserts 'numValues' values round robin into 'numGroups' sketches in one
+// HashStringAllocator, as a group by approx_percentile does.
+int insertGroups(int /*iters*/, int numValues, int numGroups) {
+  std::vector<double> values;
+  BENCHMARK_SUSPEND {
+    populateValues(numValues, values);
+  }
+  using Sketch = KllSketch<double, StlAllocator<double>>;
+  HashStringAllocator allocator(memory::MappedMemory::getInstance());
+  std::vector<Sketch> sketches;
+  sketches.reserve(numGroups);
+  for (int i = 0; i < numGroups; ++i) {
+    sketches.emplace_back(kDefaultK, StlAllocator<double>(&allocator));
+  }
+  for (int i = 0; i < numValues; ++i) {
+    sketches[i % numGroups].insert(values[i]);
+  }
+  BENCHMARK_SUSPEND {
+    bytesPerGroup[numValues / numGroups] =
+        (allocator.retainedSize() - allocator.freeSpace()) / numGroups;
+  }
+  return numValues;
+}
+
 #define DEFINE_WITH_TYPE(name, type)  \
   int name##_##type(int, int iters) { \
     return name<type>(iters);         \
@@ -156,6 +230,25 @@ BENCHMARK_NAMED_PARAM(mergeTDigest, 1e6x40, 1e6, 40);
 BENCHMARK_RELATIVE_NAMED_PARAM(mergeKllSketch, 1e6x40, 1e6, 40);
 BENCHMARK_NAMED_PARAM(mergeTDigest, 1e6x80, 1e6, 80);
 BENCHMARK_RELATIVE_NAMED_PARAM(mergeKllSketch, 1e6x80, 1e6, 80);
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(mergeDeserializedKllSketch, 1e5x20, 1e5, 20, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    mergeDeserializedKllSketch,
+    1e5x20_batch,
+    1e5,
+    20,
+    true);
+BENCHMARK_NAMED_PARAM(mergeDeserializedKllSketch, 1e5x200, 1e5, 200, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    mergeDeserializedKllSketch,
+    1e5x200_batch,
+    1e5,
+    200,
+    true);
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM_MULTI(insertGroups, 1e6x1e5, 1e6, 1e5);
+BENCHMARK_NAMED_PARAM_MULTI(insertGroups, 1e6x1e4, 1e6, 1e4);
+BENCHMARK_NAMED_PARAM_MULTI(insertGroups, 1e6x1e3, 1e6, 1e3);
 
 // ============================================================================
 // [...]chmarks/ApproxPercentileBenchmark.cpp     relative  time/iter   iters/s
@@ -190,5 +283,10 @@ BENCHMARK_RELATIVE_NAMED_PARAM(mergeKllSketch, 1e6x80, 1e6, 80);
 int main(int argc, char* argv[]) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
   folly::runBenchmarks();
+  std::cout << "KLL sketch memory per group" << std::endl;
+  for (auto [numValues, bytes] : facebook::velox::functions::kll::test::
+           bytesPerGroup) {
+    std::cout << numValues << " values: " << bytes << " bytes" << std::endl;
+  }
   return 0;
 }
@@ -82,6 +82,64 @@ BENCHMARK_NAMED_PARAM_MULTI(regexExtract, bs1k, 1 << 10);
 BENCHMARK_NAMED_PARAM_MULTI(regexExtract, bs10k, 10 << 10);
 BENCHMARK_NAMED_PARAM_MULTI(regexExtract, bs100k, 100 << 10);
 
+// Evaluates 'expression' over strings with 'abc' at different positions in
+// 1/4 of the rows.
+int like(int n, int blockSize, const char* expression) {
+  folly::BenchmarkSuspender kSuspender;
+  FunctionBenchmarkBase benchmarkBase;
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = blockSize;
+  opts.stringLength = 40;
+  auto fuzzed = VectorFuzzer(opts, benchmarkBase.pool()).fuzzFlat(VARCHAR());
+  auto* strings = fuzzed->asFlatVector<StringView>();
+  std::vector<std::string> values(blockSize);
+  for (auto row = 0; row < blockSize; ++row) {
+    values[row] = strings->valueAt(row).str();
+    if (row % 4 == 0) {
+      values[row].insert(row % (values[row].size() + 1), "abc");
+    }
+  }
+  auto vector = benchmarkBase.maker().flatVector<StringView>(
+      blockSize, [&](auto row) { return StringView(values[row]); });
+  const auto data = benchmarkBase.maker().rowVector({vector});
+
+  exec::ExprSet expr =
+      benchmarkBase.compileExpression(expression, data->type());
+  kSuspender.dismiss();
+  for (int i = 0; i != n; ++i) {
+    benchmarkBase.evaluate(expr, data);
+  }
+  return n * blockSize;
+}
+
+// Each LIKE pattern is followed by the RE2 it was evaluated with before.
+BENCHMARK_NAMED_PARAM_MULTI(like, prefix, 10 << 10, "like(c0, 'abc%')");
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    like,
+    prefix_re2,
+    10 << 10,
+    "re2_match(c0, '^abc.*$')");
+BENCHMARK_NAMED_PARAM_MULTI(like, suffix, 10 << 10, "like(c0, '%abc')");
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    like,
+    suffix_re2,
+    10 << 10,
+    "re2_match(c0, '^.*abc$')");
+BENCHMARK_NAMED_PARAM_MULTI(like, substring, 10 << 10, "like(c0, '%abc%')");
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    like,
+    substring_re2,
+    10 << 10,
+    "re2_match(c0, '^.*abc.*$')");
+BENCHMARK_NAMED_PARAM_MULTI(like, fixed_chars, 10 << 10, "like(c0, 'a_c__%')");
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    like,
+    fixed_chars_re2,
+    10 << 10,
+    "re2_match(c0, '^a.c...*$')");
+BENCHMARK_NAMED_PARAM_MULTI(like, generic, 10 << 10, "like(c0, '%a%c%')");
+
 } // namespace
 
 std::shared_ptr<exec::VectorFunction> makeRegexExtract(
@@ -97,6 +155,7 @@ void registerRe2Functions() {
       "re2_search", re2SearchSignatures(), makeRe2Search);
   exec::registerStatefulVectorFunction(
       "re2_extract", re2ExtractSignatures(), makeRegexExtract);
+  exec::registerStatefulVectorFunction("like", likeSignatures(), makeLike);
 }
 
 } // namespace facebook::velox::functions::test
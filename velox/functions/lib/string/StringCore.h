@@ -18,7 +18,9 @@
 #include <cstring>
 #include <string>
 #include <string_view>
+#include <xsimd/xsimd.hpp>
 #include "folly/CPortability.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/external/utf8proc/utf8procImpl.h"
 
 #if (ENABLE_VECTORIZATION > 0) && !defined(_DEBUG) && !defined(DEBUG)
@@ -46,13 +48,38 @@ namespace stringCore {
 /// Check if a given string is ascii
 static bool isAscii(const char* str, size_t length);
 
+/// ORs 4 batches at a time into an accumulator and tests its sign bits once
+/// per block, so that long non-ASCII strings stop at the first block with a
+/// non-ASCII byte.
 FOLLY_ALWAYS_INLINE bool isAscii(const char* str, size_t length) {
-  for (auto i = 0; i < length; i++) {
-    if (str[i] & 0x80) {
+  using Batch = xsimd::batch<int8_t>;
+  constexpr size_t kBlockSize = 4 * Batch::size;
+  const auto* data = reinterpret_cast<const int8_t*>(str);
+  size_t i = 0;
+  for (; i + kBlockSize <= length; i += kBlockSize) {
+    auto bits = Batch::load_unaligned(data + i) |
+        Batch::load_unaligned(data + i + Batch::size) |
+        Batch::load_unaligned(data + i + 2 * Batch::size) |
+        Batch::load_unaligned(data + i + 3 * Batch::size);
+    if (simd::toBitMask(bits < Batch(0))) {
       return false;
     }
   }
-  return true;
+  for (; i + Batch::size <= length; i += Batch::size) {
+    if (simd::toBitMask(Batch::load_unaligned(data + i) < Batch(0))) {
+      return false;
+    }
+  }
+  uint64_t word = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t next;
+    std::memcpy(&next, str + i, sizeof(next));
+    word |= next;
+  }
+  for (; i < length; ++i) {
+    word |= static_cast<uint8_t>(str[i]);
+  }
+  return (word & 0x8080808080808080ULL) == 0;
 }
 
 /// Perform reverse for ascii string input
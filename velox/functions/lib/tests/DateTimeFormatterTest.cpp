@@ -731,4 +731,49 @@ TEST_F(MysqlDateTimeTest, formatCompositeTime) {
       "23:59:59");
 }
 
+TEST_F(DateTimeFormatterTest, formatFixed) {
+  auto* timezone = date::locate_zone("GMT");
+  EXPECT_EQ(0, buildMysqlDateTimeFormatter("%c/%e")->fixedResultSize());
+  EXPECT_EQ(0, buildJodaDateTimeFormatter("yyyy-MMM-dd")->fixedResultSize());
+  EXPECT_EQ(0, buildJodaDateTimeFormatter("yyyy-MM-dd z")->fixedResultSize());
+
+  std::vector<std::shared_ptr<DateTimeFormatter>> formatters = {
+      buildMysqlDateTimeFormatter("%Y-%m-%d"),
+      buildMysqlDateTimeFormatter("%Y-%m-%d %H:%i:%s"),
+      buildMysqlDateTimeFormatter("%y%j %r"),
+      buildJodaDateTimeFormatter("yyyy-MM-dd'T'HH:mm:ss"),
+      buildJodaDateTimeFormatter("G YYYY yy kk KK hh a"),
+      buildJodaDateTimeFormatter("yyyyyy DDDD")};
+  // 0000-01-01 00:00:00, 1969-12-31 23:59:59.999, 1970-01-01 00:00:00,
+  // 2000-02-29 12:30:05 and 9999-12-31 23:59:59.
+  std::vector<Timestamp> timestamps = {
+      Timestamp(-62'167'219'200, 0),
+      Timestamp(-1, 999'000'000),
+      Timestamp(0, 0),
+      Timestamp(951'827'405, 0),
+      Timestamp(253'402'300'799, 0)};
+  for (auto i = 0; i < 1'000; ++i) {
+    timestamps.push_back(Timestamp(i * 7'777'777LL - 3'000'000'000LL, 0));
+  }
+  for (auto& formatter : formatters) {
+    auto size = formatter->fixedResultSize();
+    ASSERT_GT(size, 0);
+    for (auto& timestamp : timestamps) {
+      std::string result(size, ' ');
+      ASSERT_TRUE(formatter->formatFixed(timestamp, result.data()));
+      EXPECT_EQ(formatter->format(timestamp, timezone), result)
+          << timestamp.toString();
+    }
+  }
+
+  // Years outside of 0 to 9999 take the general path.
+  std::string result(10, ' ');
+  EXPECT_FALSE(buildMysqlDateTimeFormatter("%Y-%m-%d")
+                   ->formatFixed(
+                       Timestamp(253'402'300'800, 0), result.data()));
+  EXPECT_FALSE(buildMysqlDateTimeFormatter("%Y-%m-%d")
+                   ->formatFixed(
+                       Timestamp(-62'167'219'201, 0), result.data()));
+}
+
 } // namespace facebook::velox::functions
@@ -200,6 +200,41 @@ TEST(KllSketchTest, mergeEmpty) {
   EXPECT_EQ(kll2.estimateQuantile(0.5), 1.0);
 }
 
+TEST(KllSketchTest, copyAndMove) {
+  constexpr int N = 1e4;
+  KllSketch<double> kll(kDefaultK, {}, 0);
+  for (int i = 0; i < N; ++i) {
+    kll.insert(i);
+  }
+  auto serialize = [](const KllSketch<double>& sketch) {
+    std::vector<char> data(sketch.serializedByteSize());
+    sketch.serialize(data.data());
+    return data;
+  };
+  KllSketch<double> copy(kll);
+  EXPECT_EQ(copy.totalCount(), N);
+  KllSketch<double> moved(std::move(copy));
+  EXPECT_EQ(moved.totalCount(), N);
+  EXPECT_EQ(copy.totalCount(), 0);
+  KllSketch<double> assigned;
+  assigned.insert(-1);
+  assigned = moved;
+  // The free space below level 0 is not copied, so compare the quantiles.
+  kll.finish();
+  assigned.finish();
+  auto q = linspace(101);
+  EXPECT_EQ(
+      kll.estimateQuantiles(folly::Range(q.begin(), q.end())),
+      assigned.estimateQuantiles(folly::Range(q.begin(), q.end())));
+  EXPECT_EQ(serialize(kll).size(), serialize(assigned).size());
+
+  // A moved from sketch is empty and can be reused.
+  moved = std::move(assigned);
+  assigned.insert(1);
+  EXPECT_EQ(assigned.totalCount(), 1);
+  EXPECT_EQ(moved.totalCount(), N);
+}
+
 TEST(KllSketchTest, kFromEpsilon) {
   EXPECT_EQ(kFromEpsilon(kEpsilon), kDefaultK);
 }
@@ -280,7 +315,7 @@ TEST(KllSketchTest, memoryUsage) {
   HashStringAllocator alloc(memory::MappedMemory::getInstance());
   KllSketch<int64_t, StlAllocator<int64_t>> kll(
       1024, StlAllocator<int64_t>(&alloc));
-  EXPECT_LE(alloc.retainedSize() - alloc.freeSpace(), 64);
+  EXPECT_EQ(alloc.retainedSize() - alloc.freeSpace(), 0);
   kll.insert(0);
   EXPECT_LE(alloc.retainedSize() - alloc.freeSpace(), 64);
   for (int i = 1; i < 1024; ++i) {
@@ -293,5 +328,28 @@ TEST(KllSketchTest, memoryUsage) {
   EXPECT_LE(alloc.retainedSize() - alloc.freeSpace(), 28000);
 }
 
+// A merge leaves one block of about the capacity of the merged sketch.
+TEST(KllSketchTest, mergeDeserializedMemoryUsage) {
+  constexpr int N = 1e4;
+  constexpr int kSketchCount = 10;
+  std::vector<std::vector<char>> data(kSketchCount);
+  std::vector<const char*> sketches;
+  for (int i = 0; i < kSketchCount; ++i) {
+    KllSketch<double> kll(kDefaultK, {}, i);
+    for (int j = 0; j < N; ++j) {
+      kll.insert(j + i * N);
+    }
+    data[i].resize(kll.serializedByteSize());
+    kll.serialize(data[i].data());
+    sketches.push_back(data[i].data());
+  }
+  HashStringAllocator alloc(memory::MappedMemory::getInstance());
+  KllSketch<double, StlAllocator<double>> kll(
+      kDefaultK, StlAllocator<double>(&alloc), 0);
+  kll.mergeDeserialized(folly::Range(sketches.begin(), sketches.end()));
+  EXPECT_EQ(kll.totalCount(), N * kSketchCount);
+  EXPECT_LE(alloc.retainedSize() - alloc.freeSpace(), 8000);
+}
+
 } // namespace
 } // namespace facebook::velox::functions::kll::test
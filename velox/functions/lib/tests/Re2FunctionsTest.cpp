@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/functions/lib/Re2Functions.h"
+#include "velox/functions/lib/Re2Cache.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -207,6 +208,39 @@ TEST_F(Re2FunctionsTest, regexMatchBatch) {
   re2Match.testBatchAll();
 }
 
+TEST_F(Re2FunctionsTest, compileRe2) {
+  auto first = compileRe2(StringView("a.c"));
+  auto second = compileRe2(StringView("a.c"));
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_TRUE(re2::RE2::FullMatch("abc", *first));
+  EXPECT_FALSE(re2::RE2::FullMatch("a\nc", *first));
+
+  auto dotNl = compileRe2(StringView("a.c"), /*dotNl=*/true);
+  EXPECT_NE(first.get(), dotNl.get());
+  EXPECT_TRUE(re2::RE2::FullMatch("a\nc", *dotNl));
+
+  EXPECT_FALSE(compileRe2(StringView("*"))->ok());
+}
+
+// Non-constant patterns that repeat across rows, with an invalid pattern after
+// a run of the same valid one.
+TEST_F(Re2FunctionsTest, regexMatchRepeatedPatterns) {
+  auto input = makeRowVector({
+      makeFlatVector<StringView>({"abc", "abd", "xyz", "abc"}),
+      makeFlatVector<StringView>({"ab.", "ab.", "x.*", "ab."}),
+  });
+  auto result = evaluate<SimpleVector<bool>>("re2_match(c0, c1)", input);
+  assertEqualVectors(makeFlatVector<bool>({true, true, true, true}), result);
+
+  input = makeRowVector({
+      makeFlatVector<StringView>({"abc", "abd", "abc"}),
+      makeFlatVector<StringView>({"ab.", "ab.", "*"}),
+  });
+  EXPECT_THROW(
+      evaluate<SimpleVector<bool>>("re2_match(c0, c1)", input),
+      VeloxException);
+}
+
 template <typename F>
 void testRe2Search(F&& regexSearch) {
   // Empty string cases.
@@ -403,6 +437,51 @@ TEST_F(Re2FunctionsTest, likePatternAndEscape) {
   EXPECT_THROW(like("abcd", "a#}#+", '#'), std::exception);
 }
 
+// Covers the patterns that are matched without RE2.
+TEST_F(Re2FunctionsTest, likePatternKinds) {
+  auto like = [&](std::optional<std::string> str, const std::string& pattern) {
+    return evaluateOnce<bool>("like(c0, '" + pattern + "')", str);
+  };
+
+  // Fixed.
+  EXPECT_EQ(like("", ""), true);
+  EXPECT_EQ(like("a", ""), false);
+  EXPECT_EQ(like("abc", "a_c"), true);
+  EXPECT_EQ(like("abbc", "a_c"), false);
+  EXPECT_EQ(like("a\u7231c", "a_c"), true);
+  EXPECT_EQ(like("a\u7231c", "a___c"), false);
+
+  // Prefix.
+  EXPECT_EQ(like("", "%"), true);
+  EXPECT_EQ(like("abc", "%%"), true);
+  EXPECT_EQ(like("abc", "ab%%"), true);
+  EXPECT_EQ(like("ab", "ab_%"), false);
+  EXPECT_EQ(like("ab\u7231", "ab_%"), true);
+  EXPECT_EQ(like("ab\ncd", "ab%"), true);
+
+  // Suffix.
+  EXPECT_EQ(like("abc", "%bc"), true);
+  EXPECT_EQ(like("bc", "%abc"), false);
+  EXPECT_EQ(like("abc", "%_c"), true);
+  EXPECT_EQ(like("\u7231bc", "%_bc"), true);
+  EXPECT_EQ(like("\u7231bc", "%__bc"), false);
+
+  // Substring, also longer than a SIMD batch.
+  EXPECT_EQ(like("abc", "%b%"), true);
+  EXPECT_EQ(like("abc", "%abcd%"), false);
+  auto longString = std::string(100, 'x') + "needle" + std::string(50, 'y');
+  EXPECT_EQ(like(longString, "%needle%"), true);
+  EXPECT_EQ(like(longString, "%needlf%"), false);
+  EXPECT_EQ(like(longString, "%xn%"), true);
+  EXPECT_EQ(like(longString, "%ey%"), true);
+  EXPECT_EQ(like(longString, "%yy%"), true);
+  EXPECT_EQ(like(longString, "%yx%"), false);
+
+  // Generic patterns match new lines like the others.
+  EXPECT_EQ(like("a\nb\nc", "a%b%c"), true);
+  EXPECT_EQ(like("a\nb", "%_b%"), true);
+}
+
 template <typename T>
 void Re2FunctionsTest::testRe2ExtractAll(
     const std::vector<std::optional<std::string>>& inputs,
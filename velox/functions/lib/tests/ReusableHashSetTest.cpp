@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <unordered_set>
+
+#include "velox/functions/lib/ReusableHashSet.h"
+#include "velox/type/StringView.h"
+
+namespace facebook::velox::functions {
+namespace {
+
+TEST(ReusableHashSetTest, insertAndClear) {
+  ReusableHashSet<int64_t> set;
+  std::default_random_engine gen(0);
+  for (auto round = 0; round < 100; ++round) {
+    std::unordered_set<int64_t> expected;
+    set.clear();
+    ASSERT_TRUE(set.empty());
+    const auto numValues = round * 10;
+    for (auto i = 0; i < numValues; ++i) {
+      int64_t value = gen() % 1'000;
+      ASSERT_EQ(expected.insert(value).second, set.insert(value));
+    }
+    ASSERT_EQ(expected.size(), set.size());
+    for (int64_t value = 0; value < 1'000; ++value) {
+      ASSERT_EQ(expected.count(value) > 0, set.contains(value)) << value;
+    }
+  }
+}
+
+TEST(ReusableHashSetTest, doubles) {
+  ReusableHashSet<double> set;
+  // NaN is not equal to itself, as in std::unordered_set.
+  EXPECT_TRUE(set.insert(std::nan("")));
+  EXPECT_TRUE(set.insert(std::nan("")));
+  EXPECT_FALSE(set.contains(std::nan("")));
+  EXPECT_TRUE(set.insert(0.0));
+  EXPECT_FALSE(set.insert(-0.0));
+}
+
+TEST(ReusableHashSetTest, strings) {
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 100; ++i) {
+    strings.push_back(std::string(i, 'x'));
+  }
+  ReusableHashSet<StringView> set;
+  for (auto& string : strings) {
+    EXPECT_TRUE(set.insert(StringView(string)));
+  }
+  for (auto& string : strings) {
+    EXPECT_FALSE(set.insert(StringView(string)));
+  }
+  EXPECT_EQ(100, set.size());
+  set.clear();
+  EXPECT_FALSE(set.contains(StringView(strings[10])));
+}
+
+} // namespace
+} // namespace facebook::velox::functions
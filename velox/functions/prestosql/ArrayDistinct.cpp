@@ -14,12 +14,11 @@
  * limitations under the License.
  */
 
-#include <folly/container/F14Set.h>
-
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
+#include "velox/functions/lib/ReusableHashSet.h"
 
 namespace facebook::velox::functions {
 namespace {
@@ -74,8 +73,9 @@ class ArrayDistinctFunction : public exec::VectorFunction {
     auto* rawSizes = newLengths->asMutable<vector_size_t>();
     auto* rawOffsets = newOffsets->asMutable<vector_size_t>();
 
-    // Process the rows: store unique values in the hash table.
-    folly::F14FastSet<T> uniqueSet;
+    // Process the rows: store unique values in the hash table. The set is
+    // cleared per row and keeps its memory.
+    ReusableHashSet<T> uniqueSet;
 
     rows.applyToSelected([&](vector_size_t row) {
       auto size = arrayVector->sizeAt(row);
@@ -92,7 +92,7 @@ class ArrayDistinctFunction : public exec::VectorFunction {
         } else {
           auto value = elements->valueAt<T>(i);
 
-          if (uniqueSet.insert(value).second) {
+          if (uniqueSet.insert(value)) {
             rawNewIndices[indicesCursor++] = i;
           }
         }
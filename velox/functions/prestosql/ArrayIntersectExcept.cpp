@@ -15,22 +15,22 @@
  */
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
+#include "velox/functions/lib/ReusableHashSet.h"
 
 namespace facebook::velox::functions {
 namespace {
 template <typename T>
 
 struct SetWithNull {
-  SetWithNull(vector_size_t initialSetSize = kInitialSetSize) {
-    set.reserve(initialSetSize);
-  }
+  SetWithNull(vector_size_t initialSetSize = kInitialSetSize)
+      : set(initialSetSize) {}
 
   void reset() {
     set.clear();
     hasNull = false;
   }
 
-  std::unordered_set<T> set;
+  ReusableHashSet<T> set;
   bool hasNull{false};
   static constexpr vector_size_t kInitialSetSize{128};
 };
@@ -204,13 +204,12 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
           // (check outputSet).
           bool addValue = false;
           if constexpr (isIntersect) {
-            addValue = rightSet.set.count(val) > 0;
+            addValue = rightSet.set.contains(val);
           } else {
-            addValue = rightSet.set.count(val) == 0;
+            addValue = !rightSet.set.contains(val);
           }
           if (addValue) {
-            auto it = outputSet.set.insert(val);
-            if (it.second) {
+            if (outputSet.set.insert(val)) {
               rawNewIndices[indicesCursor++] = i;
             }
           }
@@ -239,9 +238,15 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
           decodeArrayElements(rightHolder, rightElementsHolder, rows);
       SetWithNull<T> rightSet;
       auto rightArrayVector = rightHolder.get()->base()->as<ArrayVector>();
+      // A constant right-hand side, or a run of rows with the same
+      // dictionary index, builds the set once.
+      vector_size_t lastIdx = -1;
       rows.applyToSelected([&](vector_size_t row) {
         auto idx = rightHolder.get()->index(row);
-        generateSet<T>(rightArrayVector, decodedRightElements, idx, rightSet);
+        if (idx != lastIdx) {
+          generateSet<T>(rightArrayVector, decodedRightElements, idx, rightSet);
+          lastIdx = idx;
+        }
         processRow(row, rightSet, outputSet);
       });
     }
@@ -308,7 +313,7 @@ class ArraysOverlapFunction : public exec::VectorFunction {
           hasNull = true;
           continue;
         }
-        if (rightSet.set.count(decodedLeftElements->valueAt<T>(i)) > 0) {
+        if (rightSet.set.contains(decodedLeftElements->valueAt<T>(i))) {
           // Found an overlapping element. Add to result set.
           resultBoolVector->set(row, true);
           return;
@@ -336,9 +341,15 @@ class ArraysOverlapFunction : public exec::VectorFunction {
           decodeArrayElements(rightDecoder, rightElementsDecoder, rows);
       SetWithNull<T> rightSet;
       auto baseRightArray = rightDecoder.get()->base()->as<ArrayVector>();
+      // A constant right-hand side, or a run of rows with the same
+      // dictionary index, builds the set once.
+      vector_size_t lastIdx = -1;
       rows.applyToSelected([&](vector_size_t row) {
         auto idx = rightDecoder.get()->index(row);
-        generateSet<T>(baseRightArray, decodedRightElements, idx, rightSet);
+        if (idx != lastIdx) {
+          generateSet<T>(baseRightArray, decodedRightElements, idx, rightSet);
+          lastIdx = idx;
+        }
         processRow(row, rightSet);
       });
     }
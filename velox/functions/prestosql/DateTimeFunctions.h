@@ -804,6 +804,28 @@ struct DateDiffFunction {
   }
 };
 
+// Formats 'timestamp' with 'formatter' into 'result'. The formats of fixed
+// width are written into 'result' directly.
+template <typename TResult>
+FOLLY_ALWAYS_INLINE void formatTimestamp(
+    const DateTimeFormatter& formatter,
+    const Timestamp& timestamp,
+    const date::time_zone* timeZone,
+    TResult& result) {
+  if (auto size = formatter.fixedResultSize()) {
+    result.resize(size);
+    if (formatter.formatFixed(timestamp, result.data())) {
+      return;
+    }
+  }
+  auto formattedResult = formatter.format(timestamp, timeZone);
+  auto resultSize = formattedResult.size();
+  result.resize(resultSize);
+  if (resultSize != 0) {
+    std::memcpy(result.data(), formattedResult.data(), resultSize);
+  }
+}
+
 template <typename T>
 struct DateFormatFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
@@ -811,6 +833,8 @@ struct DateFormatFunction {
   const date::time_zone* sessionTimeZone_ = nullptr;
   std::shared_ptr<DateTimeFormatter> mysqlDateTime_;
   bool isConstFormat_ = false;
+  // The format of 'mysqlDateTime_' if not constant.
+  std::string lastFormat_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
@@ -829,16 +853,15 @@ struct DateFormatFunction {
       const arg_type<Timestamp>& timestamp,
       const arg_type<Varchar>& formatString) {
     if (!isConstFormat_) {
-      mysqlDateTime_ = buildMysqlDateTimeFormatter(
-          std::string_view(formatString.data(), formatString.size()));
+      // Consecutive rows usually have the same format.
+      std::string_view format(formatString.data(), formatString.size());
+      if (!mysqlDateTime_ || format != lastFormat_) {
+        mysqlDateTime_ = buildMysqlDateTimeFormatter(format);
+        lastFormat_ = format;
+      }
     }
 
-    auto formattedResult = mysqlDateTime_->format(timestamp, sessionTimeZone_);
-    auto resultSize = formattedResult.size();
-    result.resize(resultSize);
-    if (resultSize != 0) {
-      std::memcpy(result.data(), formattedResult.data(), resultSize);
-    }
+    formatTimestamp(*mysqlDateTime_, timestamp, sessionTimeZone_, result);
     return true;
   }
 };
@@ -885,7 +908,7 @@ struct DateParseFunction {
     if (!format_.has_value()) {
       format_.emplace(correspondingJodaFormat.data());
     }
-    auto jodaResult = format_->parse(input);
+    auto jodaResult = format_->parse(std::string_view(input));
     int16_t timezoneId = sessionTzID_.value_or(0);
     jodaResult.timestamp.toGMT(timezoneId);
     result = jodaResult.timestamp;
@@ -900,6 +923,8 @@ struct FormatDateTimeFunction {
   const date::time_zone* sessionTimeZone_ = nullptr;
   std::shared_ptr<DateTimeFormatter> jodaDateTime_;
   bool isConstFormat_ = false;
+  // The format of 'jodaDateTime_' if not constant.
+  std::string lastFormat_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
@@ -918,16 +943,15 @@ struct FormatDateTimeFunction {
       const arg_type<Timestamp>& timestamp,
       const arg_type<Varchar>& formatString) {
     if (!isConstFormat_) {
-      jodaDateTime_ = buildJodaDateTimeFormatter(
-          std::string_view(formatString.data(), formatString.size()));
+      // Consecutive rows usually have the same format.
+      std::string_view format(formatString.data(), formatString.size());
+      if (!jodaDateTime_ || format != lastFormat_) {
+        jodaDateTime_ = buildJodaDateTimeFormatter(format);
+        lastFormat_ = format;
+      }
     }
 
-    auto formattedResult = jodaDateTime_->format(timestamp, sessionTimeZone_);
-    auto resultSize = formattedResult.size();
-    result.resize(resultSize);
-    if (resultSize != 0) {
-      std::memcpy(result.data(), formattedResult.data(), resultSize);
-    }
+    formatTimestamp(*jodaDateTime_, timestamp, sessionTimeZone_, result);
     return true;
   }
 };
@@ -937,6 +961,9 @@ struct ParseDateTimeFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
   std::optional<JodaFormatter> format_;
+  bool isConstFormat_ = false;
+  // The format of 'format_' if not constant.
+  std::string lastFormat_;
   std::optional<int64_t> sessionTzID_;
 
   FOLLY_ALWAYS_INLINE void initialize(
@@ -945,6 +972,7 @@ struct ParseDateTimeFunction {
       const arg_type<Varchar>* format) {
     if (format != nullptr) {
       format_.emplace(*format);
+      isConstFormat_ = true;
     }
 
     auto sessionTzName = config.sessionTimezone();
@@ -957,8 +985,15 @@ struct ParseDateTimeFunction {
       out_type<TimestampWithTimezone>& result,
       const arg_type<Varchar>& input,
       const arg_type<Varchar>& format) {
-    auto jodaResult = format_.has_value() ? format_->parse(input)
-                                          : JodaFormatter(format).parse(input);
+    if (!isConstFormat_) {
+      // Consecutive rows usually have the same format.
+      std::string_view formatString(format);
+      if (!format_ || formatString != lastFormat_) {
+        format_.emplace(format);
+        lastFormat_ = formatString;
+      }
+    }
+    auto jodaResult = format_->parse(std::string_view(input));
 
     // If timezone was not parsed, fallback to the session timezone. If there's
     // no session timezone, fallback to 0 (GMT).
@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/SimdUtil.h"
+#include "velox/expression/DecodedArgs.h"
+#include "velox/expression/VectorFunction.h"
+#include "velox/type/DecimalUtil.h"
+
+namespace facebook::velox::functions {
+namespace {
+
+// Precision and scale of the result of a decimal operation. 'capped' is true
+// if the precision of the exact result is more than 38 digits.
+struct DecimalResultType {
+  int32_t precision;
+  int32_t scale;
+  bool capped;
+};
+
+DecimalResultType makeResultType(int32_t precision, int32_t scale) {
+  return {
+      std::min(precision, LongDecimalType::kMaxPrecision),
+      scale,
+      precision > LongDecimalType::kMaxPrecision};
+}
+
+// Each operation multiplies the unscaled arguments by the powers of ten of
+// rescales() before applying the operation. apply() is for results that
+// cannot overflow the result type and applies to both values and xsimd
+// batches. applyChecked() returns false on overflow of int128_t. Division has
+// no unchecked form.
+struct DecimalAdd {
+  static constexpr bool kAlwaysChecked = false;
+
+  // Both arguments are rescaled to the larger scale. The result has one more
+  // integer digit than the larger of the arguments.
+  static DecimalResultType resultType(
+      int32_t aPrecision,
+      int32_t aScale,
+      int32_t bPrecision,
+      int32_t bScale) {
+    const auto scale = std::max(aScale, bScale);
+    return makeResultType(
+        std::max(aPrecision - aScale, bPrecision - bScale) + scale + 1, scale);
+  }
+
+  static std::pair<int32_t, int32_t>
+  rescales(int32_t aScale, int32_t bScale, int32_t resultScale) {
+    return {resultScale - aScale, resultScale - bScale};
+  }
+
+  template <typename T>
+  FOLLY_ALWAYS_INLINE static T apply(T a, T b) {
+    return a + b;
+  }
+
+  static bool applyChecked(int128_t a, int128_t b, int128_t& result) {
+    return !__builtin_add_overflow(a, b, &result);
+  }
+};
+
+struct DecimalSubtract {
+  static constexpr bool kAlwaysChecked = false;
+
+  static DecimalResultType resultType(
+      int32_t aPrecision,
+      int32_t aScale,
+      int32_t bPrecision,
+      int32_t bScale) {
+    return DecimalAdd::resultType(aPrecision, aScale, bPrecision, bScale);
+  }
+
+  static std::pair<int32_t, int32_t>
+  rescales(int32_t aScale, int32_t bScale, int32_t resultScale) {
+    return DecimalAdd::rescales(aScale, bScale, resultScale);
+  }
+
+  template <typename T>
+  FOLLY_ALWAYS_INLINE static T apply(T a, T b) {
+    return a - b;
+  }
+
+  static bool applyChecked(int128_t a, int128_t b, int128_t& result) {
+    return !__builtin_sub_overflow(a, b, &result);
+  }
+};
+
+struct DecimalMultiply {
+  static constexpr bool kAlwaysChecked = false;
+
+  static DecimalResultType resultType(
+      int32_t aPrecision,
+      int32_t aScale,
+      int32_t bPrecision,
+      int32_t bScale) {
+    VELOX_USER_CHECK_LE(
+        aScale + bScale,
+        LongDecimalType::kMaxPrecision,
+        "Scale of the decimal product exceeds the maximum precision");
+    return makeResultType(aPrecision + bPrecision, aScale + bScale);
+  }
+
+  static std::pair<int32_t, int32_t>
+  rescales(int32_t /*aScale*/, int32_t /*bScale*/, int32_t /*resultScale*/) {
+    return {0, 0};
+  }
+
+  template <typename T>
+  FOLLY_ALWAYS_INLINE static T apply(T a, T b) {
+    return a * b;
+  }
+
+  static bool applyChecked(int128_t a, int128_t b, int128_t& result) {
+    return !__builtin_mul_overflow(a, b, &result);
+  }
+};
+
+// The dividend is rescaled so that the integer quotient has the result scale
+// and the quotient is rounded half away from zero.
+struct DecimalDivide {
+  static constexpr bool kAlwaysChecked = true;
+
+  static DecimalResultType resultType(
+      int32_t aPrecision,
+      int32_t aScale,
+      int32_t bPrecision,
+      int32_t bScale) {
+    return makeResultType(
+        aPrecision + bScale + std::max(bScale - aScale, 0),
+        std::max(aScale, bScale));
+  }
+
+  static std::pair<int32_t, int32_t>
+  rescales(int32_t aScale, int32_t bScale, int32_t resultScale) {
+    return {resultScale - aScale + bScale, 0};
+  }
+
+  static bool applyChecked(int128_t a, int128_t b, int128_t& result) {
+    VELOX_USER_CHECK(b != 0, "Division by zero");
+    result = DecimalUtil::divideRoundHalfUp(a, b);
+    return true;
+  }
+};
+
+// An argument of applyUnchecked() is either the raw unscaled values of a flat
+// vector or the value of a constant one.
+template <typename T>
+FOLLY_ALWAYS_INLINE T valueAt(const T* values, vector_size_t row) {
+  return values[row];
+}
+
+template <typename T>
+FOLLY_ALWAYS_INLINE T valueAt(T value, vector_size_t /*row*/) {
+  return value;
+}
+
+template <typename T>
+FOLLY_ALWAYS_INLINE xsimd::batch<T> loadAt(const T* values, vector_size_t row) {
+  return xsimd::batch<T>::load_unaligned(values + row);
+}
+
+template <typename T>
+FOLLY_ALWAYS_INLINE xsimd::batch<T> loadAt(T value, vector_size_t /*row*/) {
+  return xsimd::batch<T>(value);
+}
+
+template <typename T>
+using UnscaledType = decltype(DecimalUtil::unscaledValue(std::declval<T>()));
+
+// Decimal arithmetic on arguments of types A and B with a result of type R,
+// each ShortDecimal or LongDecimal. Rows whose result may overflow, i.e. all
+// rows of a division or of a result whose precision was capped at 38, are
+// computed in int128_t with overflow checks and set an error on overflow.
+// Otherwise the rows are computed in the unscaled type of the result without
+// checks. Short results of flat and constant arguments with all rows selected
+// are computed a batch of int64_t at a time, which is the same code as for
+// bigint arithmetic except for the rescale multiplications.
+template <typename R, typename A, typename B, typename Operation>
+class DecimalArithmeticFunction : public exec::VectorFunction {
+ public:
+  using RU = UnscaledType<R>;
+  using AU = UnscaledType<A>;
+  using BU = UnscaledType<B>;
+
+  DecimalArithmeticFunction(
+      int32_t aRescale,
+      int32_t bRescale,
+      int32_t resultPrecision,
+      int32_t resultScale,
+      bool checked)
+      : aRescale_(DecimalUtil::kPowersOfTen[aRescale]),
+        bRescale_(DecimalUtil::kPowersOfTen[bRescale]),
+        resultPrecision_(resultPrecision),
+        resultScale_(resultScale),
+        checked_(checked) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx* context,
+      VectorPtr* result) const override {
+    VELOX_CHECK_EQ(args.size(), 2);
+    BaseVector::ensureWritable(rows, outputType, context->pool(), result);
+    auto* rawResult = reinterpret_cast<RU*>(
+        (*result)->asUnchecked<FlatVector<R>>()->mutableRawValues());
+    if constexpr (!Operation::kAlwaysChecked) {
+      if (!checked_ && applyFlat(rows, args, rawResult)) {
+        return;
+      }
+    }
+
+    exec::DecodedArgs decodedArgs(rows, args, context);
+    const auto* a = decodedArgs.at(0);
+    const auto* b = decodedArgs.at(1);
+    if constexpr (!Operation::kAlwaysChecked) {
+      if (!checked_) {
+        const RU aRescale = aRescale_;
+        const RU bRescale = bRescale_;
+        rows.applyToSelected([&](auto row) {
+          rawResult[row] = Operation::template apply<RU>(
+              RU(DecimalUtil::unscaledValue(a->valueAt<A>(row))) * aRescale,
+              RU(DecimalUtil::unscaledValue(b->valueAt<B>(row))) * bRescale);
+        });
+        return;
+      }
+    }
+    context->applyToSelectedNoThrow(rows, [&](auto row) {
+      int128_t left;
+      int128_t right;
+      int128_t value;
+      const bool ok =
+          !__builtin_mul_overflow(
+              int128_t(DecimalUtil::unscaledValue(a->valueAt<A>(row))),
+              aRescale_,
+              &left) &&
+          !__builtin_mul_overflow(
+              int128_t(DecimalUtil::unscaledValue(b->valueAt<B>(row))),
+              bRescale_,
+              &right) &&
+          Operation::applyChecked(left, right, value);
+      VELOX_USER_CHECK(
+          ok && DecimalUtil::valueInRange(value, resultPrecision_),
+          "Decimal overflow: result does not fit DECIMAL({}, {})",
+          resultPrecision_,
+          resultScale_);
+      rawResult[row] = value;
+    });
+  }
+
+ private:
+  // Computes the rows of flat and constant arguments. Returns false for other
+  // encodings.
+  bool applyFlat(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      RU* rawResult) const {
+    const auto* a = args[0].get();
+    const auto* b = args[1].get();
+    const auto aEncoding = a->encoding();
+    const auto bEncoding = b->encoding();
+    if (aEncoding == VectorEncoding::Simple::FLAT) {
+      const auto* rawA = reinterpret_cast<const AU*>(
+          a->asUnchecked<FlatVector<A>>()->rawValues());
+      if (bEncoding == VectorEncoding::Simple::FLAT) {
+        applyUnchecked(
+            rows,
+            rawA,
+            reinterpret_cast<const BU*>(
+                b->asUnchecked<FlatVector<B>>()->rawValues()),
+            rawResult);
+        return true;
+      }
+      if (bEncoding == VectorEncoding::Simple::CONSTANT) {
+        applyUnchecked(
+            rows,
+            rawA,
+            DecimalUtil::unscaledValue(
+                b->asUnchecked<ConstantVector<B>>()->valueAt(0)),
+            rawResult);
+        return true;
+      }
+    }
+    if (aEncoding == VectorEncoding::Simple::CONSTANT &&
+        bEncoding == VectorEncoding::Simple::FLAT) {
+      applyUnchecked(
+          rows,
+          DecimalUtil::unscaledValue(
+              a->asUnchecked<ConstantVector<A>>()->valueAt(0)),
+          reinterpret_cast<const BU*>(
+              b->asUnchecked<FlatVector<B>>()->rawValues()),
+          rawResult);
+      return true;
+    }
+    return false;
+  }
+
+  template <typename L, typename Rt>
+  void applyUnchecked(
+      const SelectivityVector& rows,
+      L a,
+      Rt b,
+      RU* rawResult) const {
+    const RU aRescale = aRescale_;
+    const RU bRescale = bRescale_;
+    if constexpr (
+        std::is_same_v<RU, int64_t> && std::is_same_v<AU, int64_t> &&
+        std::is_same_v<BU, int64_t>) {
+      if (rows.isAllSelected()) {
+        // The rescale multiplications are left out when the factors are 1,
+        // e.g. for multiply and for add and subtract of equal scales.
+        if (aRescale == 1 && bRescale == 1) {
+          applySimd<false>(rows.end(), a, b, rawResult);
+        } else {
+          applySimd<true>(rows.end(), a, b, rawResult);
+        }
+        return;
+      }
+    }
+    rows.applyToSelected([&](auto row) {
+      rawResult[row] = Operation::template apply<RU>(
+          RU(valueAt(a, row)) * aRescale, RU(valueAt(b, row)) * bRescale);
+    });
+  }
+
+  template <bool kRescale, typename L, typename Rt>
+  void applySimd(vector_size_t numRows, L a, Rt b, int64_t* rawResult) const {
+    using Batch = xsimd::batch<int64_t>;
+    const int64_t aRescale = aRescale_;
+    const int64_t bRescale = bRescale_;
+    const Batch aRescaleBatch(aRescale);
+    const Batch bRescaleBatch(bRescale);
+    vector_size_t row = 0;
+    for (; row + Batch::size <= numRows; row += Batch::size) {
+      auto left = loadAt<int64_t>(a, row);
+      auto right = loadAt<int64_t>(b, row);
+      if constexpr (kRescale) {
+        left *= aRescaleBatch;
+        right *= bRescaleBatch;
+      }
+      Operation::apply(left, right).store_unaligned(rawResult + row);
+    }
+    for (; row < numRows; ++row) {
+      rawResult[row] = Operation::apply(
+          valueAt<int64_t>(a, row) * aRescale,
+          valueAt<int64_t>(b, row) * bRescale);
+    }
+  }
+
+  const int128_t aRescale_;
+  const int128_t bRescale_;
+  const int32_t resultPrecision_;
+  const int32_t resultScale_;
+  const bool checked_;
+};
+
+template <typename Operation, typename A, typename B>
+std::shared_ptr<exec::VectorFunction> makeDecimalFunction(
+    const std::pair<int32_t, int32_t>& rescales,
+    const DecimalResultType& resultType) {
+  const bool checked = Operation::kAlwaysChecked || resultType.capped;
+  if (resultType.precision <= ShortDecimalType::kMaxPrecision) {
+    return std::make_shared<
+        DecimalArithmeticFunction<ShortDecimal, A, B, Operation>>(
+        rescales.first,
+        rescales.second,
+        resultType.precision,
+        resultType.scale,
+        checked);
+  }
+  return std::make_shared<
+      DecimalArithmeticFunction<LongDecimal, A, B, Operation>>(
+      rescales.first,
+      rescales.second,
+      resultType.precision,
+      resultType.scale,
+      checked);
+}
+
+template <typename Operation, typename A>
+std::shared_ptr<exec::VectorFunction> makeDecimalFunction(
+    TypeKind bKind,
+    const std::pair<int32_t, int32_t>& rescales,
+    const DecimalResultType& resultType) {
+  if (bKind == TypeKind::SHORT_DECIMAL) {
+    return makeDecimalFunction<Operation, A, ShortDecimal>(
+        rescales, resultType);
+  }
+  return makeDecimalFunction<Operation, A, LongDecimal>(rescales, resultType);
+}
+
+template <typename Operation>
+std::shared_ptr<exec::VectorFunction> makeDecimalFunction(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+  VELOX_CHECK_EQ(inputArgs.size(), 2);
+  const auto& aType = inputArgs[0].type;
+  const auto& bType = inputArgs[1].type;
+  int aPrecision;
+  int aScale;
+  int bPrecision;
+  int bScale;
+  getDecimalPrecisionScale(*aType, aPrecision, aScale);
+  getDecimalPrecisionScale(*bType, bPrecision, bScale);
+  const auto resultType =
+      Operation::resultType(aPrecision, aScale, bPrecision, bScale);
+  const auto rescales = Operation::rescales(aScale, bScale, resultType.scale);
+  VELOX_USER_CHECK_LE(
+      std::max(rescales.first, rescales.second),
+      LongDecimalType::kMaxPrecision,
+      "Rescaling the arguments of {} exceeds the maximum precision",
+      name);
+  if (aType->kind() == TypeKind::SHORT_DECIMAL) {
+    return makeDecimalFunction<Operation, ShortDecimal>(
+        bType->kind(), rescales, resultType);
+  }
+  return makeDecimalFunction<Operation, LongDecimal>(
+      bType->kind(), rescales, resultType);
+}
+
+std::vector<std::shared_ptr<exec::FunctionSignature>> makeSignatures(
+    const std::string& precision,
+    const std::string& scale) {
+  // decimal(a_precision, a_scale), decimal(b_precision, b_scale)
+  //   -> decimal(r_precision, r_scale)
+  return {exec::FunctionSignatureBuilder()
+              .returnType("DECIMAL(r_precision, r_scale)")
+              .argumentType("DECIMAL(a_precision, a_scale)")
+              .argumentType("DECIMAL(b_precision, b_scale)")
+              .variableConstraint("r_precision", precision)
+              .variableConstraint("r_scale", scale)
+              .build()};
+}
+
+std::vector<std::shared_ptr<exec::FunctionSignature>>
+decimalAddSubtractSignatures() {
+  return makeSignatures(
+      "min(38, max(a_precision - a_scale, b_precision - b_scale) + "
+      "max(a_scale, b_scale) + 1)",
+      "max(a_scale, b_scale)");
+}
+
+std::vector<std::shared_ptr<exec::FunctionSignature>>
+decimalMultiplySignatures() {
+  return makeSignatures(
+      "min(38, a_precision + b_precision)", "a_scale + b_scale");
+}
+
+std::vector<std::shared_ptr<exec::FunctionSignature>>
+decimalDivideSignatures() {
+  return makeSignatures(
+      "min(38, a_precision + b_scale + max(b_scale - a_scale, 0))",
+      "max(a_scale, b_scale)");
+}
+
+} // namespace
+
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+    udf_decimal_add,
+    decimalAddSubtractSignatures(),
+    makeDecimalFunction<DecimalAdd>);
+
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+    udf_decimal_sub,
+    decimalAddSubtractSignatures(),
+    makeDecimalFunction<DecimalSubtract>);
+
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+    udf_decimal_mul,
+    decimalMultiplySignatures(),
+    makeDecimalFunction<DecimalMultiply>);
+
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+    udf_decimal_div,
+    decimalDivideSignatures(),
+    makeDecimalFunction<DecimalDivide>);
+
+} // namespace facebook::velox::functions
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/type/Filter.h"
 
@@ -52,9 +53,16 @@ std::optional<std::pair<std::vector<T>, bool>> toValues(
       {std::move(values), nullAllowed});
 }
 
+// IN-lists of up to this many values and no null are tested by comparing
+// SIMD batches of the input to each value.
+constexpr size_t kMaxSmallInList = 16;
+
+// Sets 'smallInList' to the values of an IN-list of no more than
+// kMaxSmallInList values and no null.
 template <typename T>
 std::unique_ptr<common::Filter> createBigintValuesFilter(
-    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+    const std::vector<exec::VectorFunctionArg>& inputArgs,
+    std::vector<int64_t>& smallInList) {
   auto valuesPair = toValues<int64_t, T>(inputArgs);
   if (!valuesPair.has_value()) {
     return nullptr;
@@ -66,6 +74,9 @@ std::unique_ptr<common::Filter> createBigintValuesFilter(
   VELOX_USER_CHECK(
       !values.empty(),
       "IN predicate expects at least one non-null value in the in-list");
+  if (values.size() <= kMaxSmallInList && !nullAllowed) {
+    smallInList = values;
+  }
   if (values.size() == 1) {
     return std::make_unique<common::BigintRange>(
         values[0], values[0], nullAllowed);
@@ -97,8 +108,10 @@ std::unique_ptr<common::Filter> createBytesValuesFilter(
 
 class InPredicate : public exec::VectorFunction {
  public:
-  explicit InPredicate(std::unique_ptr<common::Filter> filter)
-      : filter_{std::move(filter)} {}
+  InPredicate(
+      std::unique_ptr<common::Filter> filter,
+      std::vector<int64_t> smallInList)
+      : filter_{std::move(filter)}, smallInList_{std::move(smallInList)} {}
 
   static std::shared_ptr<InPredicate> create(
       const std::string& /*name*/,
@@ -107,19 +120,20 @@ class InPredicate : public exec::VectorFunction {
     auto inListType = inputArgs[1].type;
     VELOX_CHECK_EQ(inListType->kind(), TypeKind::ARRAY);
     std::unique_ptr<common::Filter> filter;
+    std::vector<int64_t> smallInList;
 
     switch (inListType->childAt(0)->kind()) {
       case TypeKind::BIGINT:
-        filter = createBigintValuesFilter<int64_t>(inputArgs);
+        filter = createBigintValuesFilter<int64_t>(inputArgs, smallInList);
         break;
       case TypeKind::INTEGER:
-        filter = createBigintValuesFilter<int32_t>(inputArgs);
+        filter = createBigintValuesFilter<int32_t>(inputArgs, smallInList);
         break;
       case TypeKind::SMALLINT:
-        filter = createBigintValuesFilter<int16_t>(inputArgs);
+        filter = createBigintValuesFilter<int16_t>(inputArgs, smallInList);
         break;
       case TypeKind::TINYINT:
-        filter = createBigintValuesFilter<int8_t>(inputArgs);
+        filter = createBigintValuesFilter<int8_t>(inputArgs, smallInList);
         break;
       case TypeKind::VARCHAR:
       case TypeKind::VARBINARY:
@@ -130,7 +144,8 @@ class InPredicate : public exec::VectorFunction {
             "Unsupported in-list type for IN predicate: {}",
             inListType->toString());
     }
-    return std::make_shared<InPredicate>(std::move(filter));
+    return std::make_shared<InPredicate>(
+        std::move(filter), std::move(smallInList));
   }
 
   // x IN (2, null) returns null when x != 2 and true when x == 2.
@@ -247,6 +262,15 @@ class InPredicate : public exec::VectorFunction {
 
     auto rawResults = boolResult->mutableRawValues<uint64_t>();
 
+    // The null rows are not in 'rows' since the function has default null
+    // behavior and the small list path leaves them as they are.
+    if constexpr (std::is_integral_v<T>) {
+      if (!smallInList_.empty()) {
+        applySmallInList(rows, rawValues, rawResults);
+        return;
+      }
+    }
+
     if (flatArg->mayHaveNulls() || passOrNull) {
       rows.applyToSelected([&](auto row) {
         if (flatArg->isNullAt(row)) {
@@ -268,7 +292,55 @@ class InPredicate : public exec::VectorFunction {
     }
   }
 
+  // Sets the bits of 'rows' in 'rawResults' to whether 'rawValues' are in
+  // 'smallInList_'. Each word of 64 rows is compared a batch at a time to
+  // every value of the list broadcast to a batch and merged into the result
+  // with the selected bits of the word.
+  template <typename T>
+  void applySmallInList(
+      const SelectivityVector& rows,
+      const T* rawValues,
+      uint64_t* rawResults) const {
+    using Batch = xsimd::batch<T>;
+    const auto* rowBits = rows.asRange().bits();
+    const auto end = rows.end();
+    auto testWord = [&](int32_t idx, uint64_t mask) {
+      const auto selected = rowBits[idx] & mask;
+      if (!selected) {
+        return;
+      }
+      const vector_size_t firstRow = idx * 64;
+      const auto numRows = std::min<vector_size_t>(64, end - firstRow);
+      uint64_t word = 0;
+      vector_size_t i = 0;
+      for (; i + Batch::size <= numRows; i += Batch::size) {
+        const auto values = Batch::load_unaligned(rawValues + firstRow + i);
+        auto matches = values == Batch(static_cast<T>(smallInList_[0]));
+        for (size_t j = 1; j < smallInList_.size(); ++j) {
+          matches =
+              matches | (values == Batch(static_cast<T>(smallInList_[j])));
+        }
+        const auto bits = static_cast<uint32_t>(simd::toBitMask(matches));
+        word |= static_cast<uint64_t>(bits) << i;
+      }
+      for (; i < numRows; ++i) {
+        const int64_t value = rawValues[firstRow + i];
+        const bool pass =
+            std::find(smallInList_.begin(), smallInList_.end(), value) !=
+            smallInList_.end();
+        word |= static_cast<uint64_t>(pass) << i;
+      }
+      rawResults[idx] = (rawResults[idx] & ~selected) | (word & selected);
+    };
+    bits::forEachWord(rows.begin(), end, testWord, [&](int32_t idx) {
+      testWord(idx, ~0ULL);
+    });
+  }
+
   const std::unique_ptr<common::Filter> filter_;
+  // The values of an IN-list of integers of no more than kMaxSmallInList
+  // values and no null. Empty otherwise.
+  const std::vector<int64_t> smallInList_;
 };
 } // namespace
 
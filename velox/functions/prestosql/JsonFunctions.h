@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optional>
+
+#include "velox/functions/Macros.h"
+#include "velox/functions/UDFOutputString.h"
+#include "velox/functions/prestosql/json/OnDemandJson.h"
+
+namespace facebook::velox::functions {
+
+namespace detail {
+inline std::string_view toStringView(const StringView& value) {
+  return std::string_view(value.data(), value.size());
+}
+
+// The JsonPath of the path argument of a JSON function. Tokenized once in
+// initialize() if the argument is constant and otherwise whenever the path
+// changes from the previous row.
+class JsonPathHolder {
+ public:
+  void initialize(const StringView* path) {
+    if (path) {
+      path_.emplace(folly::StringPiece(*path));
+      isConstant_ = true;
+    }
+  }
+
+  const JsonPath& get(const StringView& path) {
+    if (!isConstant_ &&
+        (!path_.has_value() || lastPath_ != toStringView(path))) {
+      path_.emplace(folly::StringPiece(path));
+      lastPath_ = std::string(path.data(), path.size());
+    }
+    return *path_;
+  }
+
+ private:
+  std::optional<JsonPath> path_;
+  bool isConstant_{false};
+  std::string lastPath_;
+};
+
+} // namespace detail
+
+// jsonExtractScalar(json, json_path) -> varchar
+// Current implementation support UTF-8 in json, but not in json_path.
+// Like jsonExtract(), but returns the result value as a string (as opposed
+// to being encoded as JSON). The value referenced by json_path must be a scalar
+// (boolean, number or string). Numbers are returned as written.
+template <typename T>
+struct JsonExtractScalarFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE void initialize(
+      const core::QueryConfig& /*config*/,
+      const arg_type<Varchar>* /*json*/,
+      const arg_type<Varchar>* jsonPath) {
+    path_.initialize(jsonPath);
+  }
+
+  FOLLY_ALWAYS_INLINE bool call(
+      out_type<Varchar>& result,
+      const arg_type<Varchar>& json,
+      const arg_type<Varchar>& jsonPath) {
+    if (!path_.get(jsonPath).extract(detail::toStringView(json), matches_) ||
+        matches_.size() != 1) {
+      return false;
+    }
+    const auto value = matches_[0];
+    switch (jsonKind(value)) {
+      case JsonKind::kString:
+        result.resize(value.size());
+        result.resize(unescapeJsonString(value, result.data()));
+        return true;
+      case JsonKind::kNumber:
+      case JsonKind::kBool:
+        UDFOutputString::assign(result, value);
+        return true;
+      default:
+        return false;
+    }
+  }
+
+ private:
+  detail::JsonPathHolder path_;
+  std::vector<std::string_view> matches_;
+};
+
+// jsonExtract(json, json_path) -> varchar
+// Returns the JSON text of the value referenced by json_path, without
+// whitespace between tokens, or a JSON array of the values if json_path has
+// wildcards and references more than one.
+template <typename T>
+struct JsonExtractFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE void initialize(
+      const core::QueryConfig& /*config*/,
+      const arg_type<Varchar>* /*json*/,
+      const arg_type<Varchar>* jsonPath) {
+    path_.initialize(jsonPath);
+  }
+
+  FOLLY_ALWAYS_INLINE bool call(
+      out_type<Varchar>& result,
+      const arg_type<Varchar>& json,
+      const arg_type<Varchar>& jsonPath) {
+    if (!path_.get(jsonPath).extract(detail::toStringView(json), matches_) ||
+        matches_.empty()) {
+      return false;
+    }
+    if (matches_.size() == 1) {
+      result.resize(matches_[0].size());
+      result.resize(compactJson(matches_[0], result.data()));
+      return true;
+    }
+    // The brackets and the commas.
+    size_t maxSize = matches_.size() + 1;
+    for (const auto& match : matches_) {
+      maxSize += match.size();
+    }
+    result.resize(maxSize);
+    char* out = result.data();
+    *out++ = '[';
+    for (auto i = 0; i < matches_.size(); ++i) {
+      if (i > 0) {
+        *out++ = ',';
+      }
+      out += compactJson(matches_[i], out);
+    }
+    *out++ = ']';
+    result.resize(out - result.data());
+    return true;
+  }
+
+ private:
+  detail::JsonPathHolder path_;
+  std::vector<std::string_view> matches_;
+};
+
+// jsonArrayLength(json) -> bigint
+// Returns the number of elements of a JSON array, null if json is not an
+// array.
+template <typename T>
+struct JsonArrayLengthFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE bool call(
+      int64_t& result,
+      const arg_type<Varchar>& json) {
+    auto length = jsonArrayLength(detail::toStringView(json));
+    if (!length.has_value()) {
+      return false;
+    }
+    result = length.value();
+    return true;
+  }
+};
+
+// jsonArrayContains(json, value) -> boolean
+// Returns whether a JSON array has an element equal to value, null if json is
+// not an array. The value may be a bigint, double, boolean or varchar.
+template <typename T>
+struct JsonArrayContainsFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE bool
+  call(bool& result, const arg_type<Varchar>& json, const TInput& value) {
+    std::optional<bool> contains;
+    if constexpr (std::is_same_v<TInput, StringView>) {
+      contains = jsonArrayContains(
+          detail::toStringView(json), detail::toStringView(value));
+    } else {
+      contains = jsonArrayContains(detail::toStringView(json), value);
+    }
+    if (!contains.has_value()) {
+      return false;
+    }
+    result = contains.value();
+    return true;
+  }
+};
+
+} // namespace facebook::velox::functions
@@ -21,15 +21,14 @@
 namespace facebook::velox::functions {
 namespace {
 
-/// Populates indices of the n-th elements of the arrays.
-/// Selects 'row' in 'arrayRows' if corresponding array has an n-th element.
-/// Sets elementIndices[row] to the index of the n-th element in the 'elements'
-/// vector.
-/// Returns true if at least one array has n-th element.
-bool toNthElementRows(
+/// Populates indices of the first elements of the arrays.
+/// Selects 'row' in 'arrayRows' if corresponding array is not null or empty.
+/// Sets elementIndices[row] to the index of the first element in the
+/// 'elements' vector.
+/// Returns true if at least one array has an element.
+bool toFirstElementRows(
     const ArrayVectorPtr& arrayVector,
     const SelectivityVector& rows,
-    vector_size_t n,
     SelectivityVector& arrayRows,
     BufferPtr& elementIndices) {
   auto* rawSizes = arrayVector->rawSizes();
@@ -43,9 +42,9 @@ bool toNthElementRows(
 
   rows.applyToSelected([&](auto row) {
     if (!rawNulls || !bits::isBitNull(rawNulls, row)) {
-      if (n < rawSizes[row]) {
+      if (rawSizes[row] > 0) {
         arrayRows.setValid(row, true);
-        rawElementIndices[row] = rawOffsets[row] + n;
+        rawElementIndices[row] = rawOffsets[row];
       }
     }
   });
@@ -54,6 +53,39 @@ bool toNthElementRows(
   return arrayRows.hasSelections();
 }
 
+/// Advances 'arrayRows' from the arrays that have an (n-1)-th element to the
+/// arrays that have an n-th element and sets elementIndices[row] to the index
+/// of the n-th element. The arrays that ran out of elements are set in
+/// 'finishedRows'. Only the rows of the previous step are visited, so that
+/// all steps take time proportional to the number of elements instead of the
+/// number of arrays times the size of the largest array. The indices of the
+/// rows that are not selected are left as they were, which are valid indices.
+/// Returns true if at least one array has n-th element.
+bool toNextElementRows(
+    const ArrayVectorPtr& arrayVector,
+    vector_size_t n,
+    SelectivityVector& arrayRows,
+    BufferPtr& elementIndices,
+    SelectivityVector& finishedRows) {
+  auto* rawSizes = arrayVector->rawSizes();
+  auto* rawOffsets = arrayVector->rawOffsets();
+
+  auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
+
+  finishedRows.clearAll();
+  arrayRows.applyToSelected([&](auto row) {
+    if (n < rawSizes[row]) {
+      rawElementIndices[row] = rawOffsets[row] + n;
+    } else {
+      finishedRows.setValid(row, true);
+    }
+  });
+  finishedRows.updateBounds();
+  arrayRows.deselect(finishedRows);
+
+  return arrayRows.hasSelections();
+}
+
 /// See documentation at
 /// https://prestodb.io/docs/current/functions/array.html#reduce
 class ReduceFunction : public exec::VectorFunction {
@@ -113,27 +145,55 @@ class ReduceFunction : public exec::VectorFunction {
     // Then, apply input function to second elements of all arrays.
     // And so on until all elements of all arrays have been processed.
     // At each step the number of arrays being processed will get smaller as
-    // some arrays will run out of elements.
+    // some arrays will run out of elements. The state of an array is copied
+    // to 'partialResult' once, when the array runs out of elements. Each step
+    // writes the new state to a separate vector, which is the vector of two
+    // steps before if nothing else references it.
+    SelectivityVector finishedRows(flatArray->size(), false);
     while (auto entry = inputFuncIt.next()) {
+      if (!toFirstElementRows(
+              flatArray, *entry.rows, arrayRows, elementIndices)) {
+        continue;
+      }
       VectorPtr state = initialState;
+      VectorPtr spareState;
 
-      int n = 0;
+      vector_size_t n = 1;
       while (true) {
-        if (!toNthElementRows(
-                flatArray, *entry.rows, n, arrayRows, elementIndices)) {
-          break; // Ran out of elements in all arrays.
+        VectorPtr newState = std::move(spareState);
+        {
+          std::vector<VectorPtr> lambdaArgs = {
+              state,
+              BaseVector::wrapInDictionary(
+                  BufferPtr(nullptr),
+                  elementIndices,
+                  flatArray->size(),
+                  flatArray->elements())};
+          entry.callable->apply(
+              arrayRows, nullptr, context, lambdaArgs, &newState);
         }
 
-        auto nthElement = BaseVector::wrapInDictionary(
-            BufferPtr(nullptr),
-            elementIndices,
-            flatArray->size(),
-            flatArray->elements());
-
-        std::vector<VectorPtr> lambdaArgs = {state, nthElement};
-        entry.callable->apply(
-            arrayRows, nullptr, context, lambdaArgs, &partialResult);
-        state = partialResult;
+        // The result may keep the indices, e.g. if it is the n-th element.
+        if (!elementIndices->unique()) {
+          auto copy = allocateIndices(flatArray->size(), context->pool());
+          memcpy(
+              copy->asMutable<char>(),
+              elementIndices->as<char>(),
+              elementIndices->size());
+          elementIndices = std::move(copy);
+        }
+        const bool hasMore = toNextElementRows(
+            flatArray, n, arrayRows, elementIndices, finishedRows);
+        if (finishedRows.hasSelections()) {
+          partialResult->copy(newState.get(), finishedRows, nullptr);
+        }
+        if (!hasMore) {
+          break; // Ran out of elements in all arrays.
+        }
+        if (state.use_count() == 1) {
+          spareState = std::move(state);
+        }
+        state = std::move(newState);
         n++;
       }
     }
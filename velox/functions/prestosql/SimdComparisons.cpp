@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/CompareFlags.h"
+#include "velox/common/base/RawVector.h"
+#include "velox/common/base/SimdUtil.h"
+#include "velox/expression/DecodedArgs.h"
+#include "velox/expression/VectorFunction.h"
+#include "velox/type/DecimalUtil.h"
+
+namespace facebook::velox::functions {
+namespace {
+
+// The operators apply to both values and xsimd batches.
+#define VELOX_GEN_SIMD_COMPARISON(Name, Expr)    \
+  struct Name {                                  \
+    template <typename T>                        \
+    FOLLY_ALWAYS_INLINE static auto apply(       \
+        const T& lhs,                            \
+        const T& rhs) {                          \
+      return (Expr);                             \
+    }                                            \
+  };
+
+VELOX_GEN_SIMD_COMPARISON(Eq, lhs == rhs);
+VELOX_GEN_SIMD_COMPARISON(Neq, lhs != rhs);
+VELOX_GEN_SIMD_COMPARISON(Lt, lhs < rhs);
+VELOX_GEN_SIMD_COMPARISON(Gt, lhs > rhs);
+VELOX_GEN_SIMD_COMPARISON(Lte, lhs <= rhs);
+VELOX_GEN_SIMD_COMPARISON(Gte, lhs >= rhs);
+
+#undef VELOX_GEN_SIMD_COMPARISON
+
+// An argument of applySimd() is either the raw values of a flat vector or the
+// value of a constant one.
+template <typename T>
+FOLLY_ALWAYS_INLINE T valueAt(const T* values, vector_size_t row) {
+  return values[row];
+}
+
+template <typename T>
+FOLLY_ALWAYS_INLINE T valueAt(T value, vector_size_t /*row*/) {
+  return value;
+}
+
+template <typename T>
+FOLLY_ALWAYS_INLINE xsimd::batch<T> loadAt(const T* values, vector_size_t row) {
+  return xsimd::batch<T>::load_unaligned(values + row);
+}
+
+template <typename T>
+FOLLY_ALWAYS_INLINE xsimd::batch<T> loadAt(T value, vector_size_t /*row*/) {
+  return xsimd::batch<T>(value);
+}
+
+// Sets the bits of 'rows' in 'rawResult' to Op of 'left' and 'right'. Each
+// word of 64 rows is compared a batch at a time and merged into the result
+// with the selected bits of the word, so that the unselected rows, e.g. the
+// null ones, keep their bits.
+template <typename Op, typename T, typename L, typename R>
+void applySimd(
+    const SelectivityVector& rows,
+    L left,
+    R right,
+    uint64_t* rawResult) {
+  using Batch = xsimd::batch<T>;
+  const auto* rowBits = rows.asRange().bits();
+  const auto end = rows.end();
+  auto compareWord = [&](int32_t idx, uint64_t mask) {
+    const auto selected = rowBits[idx] & mask;
+    if (!selected) {
+      return;
+    }
+    const vector_size_t firstRow = idx * 64;
+    const auto numRows = std::min<vector_size_t>(64, end - firstRow);
+    uint64_t word = 0;
+    vector_size_t i = 0;
+    for (; i + Batch::size <= numRows; i += Batch::size) {
+      const auto row = firstRow + i;
+      const auto bits = static_cast<uint32_t>(simd::toBitMask(
+          Op::apply(loadAt<T>(left, row), loadAt<T>(right, row))));
+      word |= static_cast<uint64_t>(bits) << i;
+    }
+    for (; i < numRows; ++i) {
+      const auto row = firstRow + i;
+      word |= static_cast<uint64_t>(
+                  Op::apply(valueAt<T>(left, row), valueAt<T>(right, row)))
+          << i;
+    }
+    rawResult[idx] = (rawResult[idx] & ~selected) | (word & selected);
+  };
+  bits::forEachWord(rows.begin(), end, compareWord, [&](int32_t idx) {
+    compareWord(idx, ~0ULL);
+  });
+}
+
+// Comparison of numeric, decimal and timestamp values. Flat arguments and flat
+// and constant pairs are compared with SIMD one word of 64 results at a time.
+// Other encodings are decoded and compared row by row. Eq also takes the
+// other types that have no simple function, i.e. complex types, which compare
+// with null semantics:
+// eq(array[1, null], array[1, 2]) is null.
+template <typename Op>
+class ComparisonSimdFunction : public exec::VectorFunction {
+ public:
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      exec::EvalCtx* context,
+      VectorPtr* result) const override {
+    VELOX_CHECK_EQ(args.size(), 2);
+    BaseVector::ensureWritable(rows, BOOLEAN(), context->pool(), result);
+    auto* flatResult = (*result)->asUnchecked<FlatVector<bool>>();
+    flatResult->clearNulls(rows);
+    auto* rawResult = flatResult->mutableRawValues<uint64_t>();
+
+    switch (args[0]->typeKind()) {
+      case TypeKind::TINYINT:
+        applyTyped<int8_t>(rows, args, context, rawResult);
+        return;
+      case TypeKind::SMALLINT:
+        applyTyped<int16_t>(rows, args, context, rawResult);
+        return;
+      case TypeKind::INTEGER:
+        applyTyped<int32_t>(rows, args, context, rawResult);
+        return;
+      case TypeKind::BIGINT:
+        applyTyped<int64_t>(rows, args, context, rawResult);
+        return;
+      case TypeKind::REAL:
+        applyTyped<float>(rows, args, context, rawResult);
+        return;
+      case TypeKind::DOUBLE:
+        applyTyped<double>(rows, args, context, rawResult);
+        return;
+      case TypeKind::SHORT_DECIMAL:
+      case TypeKind::LONG_DECIMAL:
+        applyDecimal(rows, args, context, rawResult);
+        return;
+      case TypeKind::TIMESTAMP:
+        applyTimestamp(rows, args, context, rawResult);
+        return;
+      default:
+        if constexpr (std::is_same_v<Op, Eq>) {
+          applyComplex(rows, args, context, flatResult);
+          return;
+        }
+        VELOX_UNSUPPORTED(
+            "Unsupported input type for comparison: {}",
+            args[0]->type()->toString());
+    }
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // tinyint, tinyint | ... | timestamp, timestamp -> boolean
+    std::vector<std::shared_ptr<exec::FunctionSignature>> signatures;
+    for (const auto& type :
+         {"tinyint",
+          "smallint",
+          "integer",
+          "bigint",
+          "real",
+          "double",
+          "timestamp"}) {
+      signatures.push_back(exec::FunctionSignatureBuilder()
+                               .returnType("boolean")
+                               .argumentType(type)
+                               .argumentType(type)
+                               .build());
+    }
+    // decimal(a_precision, a_scale), decimal(b_precision, b_scale) -> boolean
+    signatures.push_back(exec::FunctionSignatureBuilder()
+                             .returnType("boolean")
+                             .argumentType("DECIMAL(a_precision, a_scale)")
+                             .argumentType("DECIMAL(b_precision, b_scale)")
+                             .build());
+    if constexpr (std::is_same_v<Op, Eq>) {
+      // T, T -> boolean
+      signatures.push_back(exec::FunctionSignatureBuilder()
+                               .typeVariable("T")
+                               .returnType("boolean")
+                               .argumentType("T")
+                               .argumentType("T")
+                               .build());
+    }
+    return signatures;
+  }
+
+ private:
+  template <typename T>
+  void applyTyped(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      exec::EvalCtx* context,
+      uint64_t* rawResult) const {
+    const auto* left = args[0].get();
+    const auto* right = args[1].get();
+    const auto leftEncoding = left->encoding();
+    const auto rightEncoding = right->encoding();
+    if (leftEncoding == VectorEncoding::Simple::FLAT) {
+      const T* rawLeft = left->asUnchecked<FlatVector<T>>()->rawValues();
+      if (rightEncoding == VectorEncoding::Simple::FLAT) {
+        const T* rawRight = right->asUnchecked<FlatVector<T>>()->rawValues();
+        applySimd<Op, T>(rows, rawLeft, rawRight, rawResult);
+        return;
+      }
+      if (rightEncoding == VectorEncoding::Simple::CONSTANT) {
+        const T constant = right->asUnchecked<ConstantVector<T>>()->valueAt(0);
+        applySimd<Op, T>(rows, rawLeft, constant, rawResult);
+        return;
+      }
+    }
+    if (leftEncoding == VectorEncoding::Simple::CONSTANT &&
+        rightEncoding == VectorEncoding::Simple::FLAT) {
+      const T constant = left->asUnchecked<ConstantVector<T>>()->valueAt(0);
+      const T* rawRight = right->asUnchecked<FlatVector<T>>()->rawValues();
+      applySimd<Op, T>(rows, constant, rawRight, rawResult);
+      return;
+    }
+
+    exec::DecodedArgs decodedArgs(rows, args, context);
+    const auto* decodedLeft = decodedArgs.at(0);
+    const auto* decodedRight = decodedArgs.at(1);
+    rows.applyToSelected([&](auto row) {
+      bits::setBit(
+          rawResult,
+          row,
+          Op::apply(
+              decodedLeft->valueAt<T>(row), decodedRight->valueAt<T>(row)));
+    });
+  }
+
+  // Short decimals of the same scale compare as their unscaled int64_t values,
+  // with SIMD for flat and constant arguments. Other decimals compare row by
+  // row at the larger of the scales.
+  void applyDecimal(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      exec::EvalCtx* context,
+      uint64_t* rawResult) const {
+    const auto* left = args[0].get();
+    const auto* right = args[1].get();
+    int leftPrecision;
+    int leftScale;
+    int rightPrecision;
+    int rightScale;
+    getDecimalPrecisionScale(*left->type(), leftPrecision, leftScale);
+    getDecimalPrecisionScale(*right->type(), rightPrecision, rightScale);
+    const bool leftShort = left->typeKind() == TypeKind::SHORT_DECIMAL;
+    const bool rightShort = right->typeKind() == TypeKind::SHORT_DECIMAL;
+
+    if (leftShort && rightShort && leftScale == rightScale) {
+      auto rawValues = [](const BaseVector* vector) {
+        return reinterpret_cast<const int64_t*>(
+            vector->asUnchecked<FlatVector<ShortDecimal>>()->rawValues());
+      };
+      auto constantValue = [](const BaseVector* vector) {
+        return vector->asUnchecked<ConstantVector<ShortDecimal>>()
+            ->valueAt(0)
+            .unscaledValue();
+      };
+      const auto leftEncoding = left->encoding();
+      const auto rightEncoding = right->encoding();
+      if (leftEncoding == VectorEncoding::Simple::FLAT) {
+        if (rightEncoding == VectorEncoding::Simple::FLAT) {
+          applySimd<Op, int64_t>(
+              rows, rawValues(left), rawValues(right), rawResult);
+          return;
+        }
+        if (rightEncoding == VectorEncoding::Simple::CONSTANT) {
+          applySimd<Op, int64_t>(
+              rows, rawValues(left), constantValue(right), rawResult);
+          return;
+        }
+      }
+      if (leftEncoding == VectorEncoding::Simple::CONSTANT &&
+          rightEncoding == VectorEncoding::Simple::FLAT) {
+        applySimd<Op, int64_t>(
+            rows, constantValue(left), rawValues(right), rawResult);
+        return;
+      }
+    }
+
+    exec::DecodedArgs decodedArgs(rows, args, context);
+    const auto* decodedLeft = decodedArgs.at(0);
+    const auto* decodedRight = decodedArgs.at(1);
+    auto unscaledValue = [](const DecodedVector* decoded,
+                            bool isShort,
+                            vector_size_t row) -> int128_t {
+      return isShort ? decoded->valueAt<ShortDecimal>(row).unscaledValue()
+                     : decoded->valueAt<LongDecimal>(row).unscaledValue();
+    };
+    rows.applyToSelected([&](auto row) {
+      const auto result = DecimalUtil::compare(
+          unscaledValue(decodedLeft, leftShort, row),
+          leftScale,
+          unscaledValue(decodedRight, rightShort, row),
+          rightScale);
+      bits::setBit(rawResult, row, Op::apply(result, 0));
+    });
+  }
+
+  // Timestamps compare as their 8 byte toNanos() values, with SIMD for flat
+  // and constant arguments. The flat arguments are converted for the selected
+  // rows first. If a value does not fit, e.g. a date past 2262, or the
+  // encodings are others, the timestamps compare row by row.
+  void applyTimestamp(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      exec::EvalCtx* context,
+      uint64_t* rawResult) const {
+    const auto* left = args[0].get();
+    const auto* right = args[1].get();
+    const auto leftEncoding = left->encoding();
+    const auto rightEncoding = right->encoding();
+    auto toNanos = [&](const BaseVector* vector, raw_vector<int64_t>& nanos) {
+      const auto* values =
+          vector->asUnchecked<FlatVector<Timestamp>>()->rawValues();
+      nanos.resize(rows.end());
+      return rows.testSelected([&](auto row) {
+        if (!values[row].fitsNanos()) {
+          return false;
+        }
+        nanos[row] = values[row].toNanos();
+        return true;
+      });
+    };
+    auto constantNanos = [](const BaseVector* vector, int64_t& nanos) {
+      auto value = vector->asUnchecked<ConstantVector<Timestamp>>()->valueAt(0);
+      if (!value.fitsNanos()) {
+        return false;
+      }
+      nanos = value.toNanos();
+      return true;
+    };
+    raw_vector<int64_t> leftNanos;
+    raw_vector<int64_t> rightNanos;
+    int64_t constant;
+    if (leftEncoding == VectorEncoding::Simple::FLAT) {
+      if (rightEncoding == VectorEncoding::Simple::FLAT &&
+          toNanos(left, leftNanos) && toNanos(right, rightNanos)) {
+        applySimd<Op, int64_t>(
+            rows, leftNanos.data(), rightNanos.data(), rawResult);
+        return;
+      }
+      if (rightEncoding == VectorEncoding::Simple::CONSTANT &&
+          constantNanos(right, constant) && toNanos(left, leftNanos)) {
+        applySimd<Op, int64_t>(rows, leftNanos.data(), constant, rawResult);
+        return;
+      }
+    }
+    if (leftEncoding == VectorEncoding::Simple::CONSTANT &&
+        rightEncoding == VectorEncoding::Simple::FLAT &&
+        constantNanos(left, constant) && toNanos(right, rightNanos)) {
+      applySimd<Op, int64_t>(rows, constant, rightNanos.data(), rawResult);
+      return;
+    }
+
+    exec::DecodedArgs decodedArgs(rows, args, context);
+    const auto* decodedLeft = decodedArgs.at(0);
+    const auto* decodedRight = decodedArgs.at(1);
+    rows.applyToSelected([&](auto row) {
+      bits::setBit(
+          rawResult,
+          row,
+          Op::apply(
+              decodedLeft->valueAt<Timestamp>(row),
+              decodedRight->valueAt<Timestamp>(row)));
+    });
+  }
+
+  void applyComplex(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      exec::EvalCtx* context,
+      FlatVector<bool>* flatResult) const {
+    static constexpr CompareFlags kFlags = {
+        false, false, /*equalsOnly*/ true, true /*stopAtNull*/};
+    exec::DecodedArgs decodedArgs(rows, args, context);
+    const auto* decodedLeft = decodedArgs.at(0);
+    const auto* decodedRight = decodedArgs.at(1);
+    rows.applyToSelected([&](auto row) {
+      auto result = decodedLeft->base()->compare(
+          decodedRight->base(),
+          decodedLeft->index(row),
+          decodedRight->index(row),
+          kFlags);
+      if (result.has_value()) {
+        flatResult->set(row, result.value() == 0);
+      } else {
+        flatResult->setNull(row, true);
+      }
+    });
+  }
+};
+
+} // namespace
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_simd_comparison_eq,
+    ComparisonSimdFunction<Eq>::signatures(),
+    std::make_unique<ComparisonSimdFunction<Eq>>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_simd_comparison_neq,
+    ComparisonSimdFunction<Neq>::signatures(),
+    std::make_unique<ComparisonSimdFunction<Neq>>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_simd_comparison_lt,
+    ComparisonSimdFunction<Lt>::signatures(),
+    std::make_unique<ComparisonSimdFunction<Lt>>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_simd_comparison_gt,
+    ComparisonSimdFunction<Gt>::signatures(),
+    std::make_unique<ComparisonSimdFunction<Gt>>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_simd_comparison_lte,
+    ComparisonSimdFunction<Lte>::signatures(),
+    std::make_unique<ComparisonSimdFunction<Lte>>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_simd_comparison_gte,
+    ComparisonSimdFunction<Gte>::signatures(),
+    std::make_unique<ComparisonSimdFunction<Gte>>());
+
+} // namespace facebook::velox::functions
@@ -15,42 +15,133 @@
  */
 
 #include "URLFunctions.h"
-#include "velox/type/Type.h"
+
+#include <algorithm>
 
 namespace facebook::velox::functions {
+namespace {
+
+bool isAlpha(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
 
-bool matchAuthorityAndPath(
-    const boost::cmatch& urlMatch,
-    boost::cmatch& authAndPathMatch,
-    boost::cmatch& authorityMatch,
-    bool& hasAuthority) {
-  static const boost::regex kAuthorityAndPathRegex("//([^/]*)(/.*)?");
-  auto authorityAndPath = submatch(urlMatch, 2);
-  if (!boost::regex_match(
-          authorityAndPath.begin(),
-          authorityAndPath.end(),
-          authAndPathMatch,
-          kAuthorityAndPathRegex)) {
-    // Does not start with //, doesn't have authority.
-    hasAuthority = false;
+bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+bool isProtocolChar(char c) {
+  return isAlpha(c) || isDigit(c) || c == '+' || c == '.' || c == '-';
+}
+
+// Matches [begin, end) against host[:port], where the host is an IP literal
+// in brackets or a run of characters other than '[' and ':' and the port is
+// a possibly empty run of digits.
+bool parseHostAndPort(
+    const char* begin,
+    const char* end,
+    StringView& host,
+    StringView& port) {
+  const char* hostEnd;
+  if (begin < end && *begin == '[') {
+    hostEnd = std::find(begin, end, ']');
+    if (hostEnd == end) {
+      return false;
+    }
+    ++hostEnd;
+  } else {
+    hostEnd = std::find_if(
+        begin, end, [](char c) { return c == '[' || c == ':'; });
+  }
+  port = StringView();
+  if (hostEnd < end) {
+    if (*hostEnd != ':' || !std::all_of(hostEnd + 1, end, isDigit)) {
+      return false;
+    }
+    port = StringView(hostEnd + 1, end - hostEnd - 1);
+  }
+  host = StringView(begin, hostEnd - begin);
+  return true;
+}
+
+// Matches [begin, end) against [user[:password]@]host[:port]. The user
+// information, if any, ends at the first '@'.
+bool parseAuthority(
+    const char* begin,
+    const char* end,
+    StringView& host,
+    StringView& port) {
+  auto at = std::find(begin, end, '@');
+  if (at != end && parseHostAndPort(at + 1, end, host, port)) {
     return true;
   }
+  return parseHostAndPort(begin, end, host, port);
+}
 
-  static const boost::regex kAuthorityRegex(
-      "(?:([^@:]*)(?::([^@]*))?@)?" // username, password.
-      "(\\[[^\\]]*\\]|[^\\[:]*)" // host (IP-literal (e.g. '['+IPv6+']',
-      // dotted-IPv4, or named host).
-      "(?::(\\d*))?"); // port.
+} // namespace
 
-  const auto authority = authAndPathMatch[1];
-  if (!boost::regex_match(
-          authority.first, authority.second, authorityMatch, kAuthorityRegex)) {
-    return false; // Invalid URI Authority.
+bool parseUrl(StringView url, ParsedUrl& parsed) {
+  const char* begin = url.data();
+  const char* end = begin + url.size();
+  auto colon = std::find(begin, end, ':');
+  if (colon == end || colon == begin || !isAlpha(*begin) ||
+      !std::all_of(begin + 1, colon, isProtocolChar)) {
+    return false;
   }
+  parsed.protocol = StringView(begin, colon - begin);
+
+  const char* authorityAndPath = colon + 1;
+  auto authorityAndPathEnd = std::find_if(
+      authorityAndPath, end, [](char c) { return c == '?' || c == '#'; });
+  parsed.authorityAndPath =
+      StringView(authorityAndPath, authorityAndPathEnd - authorityAndPath);
 
-  hasAuthority = true;
+  auto fragment = authorityAndPathEnd;
+  if (fragment < end && *fragment == '?') {
+    fragment = std::find(authorityAndPathEnd + 1, end, '#');
+    parsed.query = StringView(
+        authorityAndPathEnd + 1, fragment - authorityAndPathEnd - 1);
+  }
+  if (fragment < end) {
+    parsed.fragment = StringView(fragment + 1, end - fragment - 1);
+  }
 
+  parsed.hasAuthority = parsed.authorityAndPath.size() >= 2 &&
+      authorityAndPath[0] == '/' && authorityAndPath[1] == '/';
+  if (parsed.hasAuthority) {
+    auto authority = authorityAndPath + 2;
+    auto path = std::find(authority, authorityAndPathEnd, '/');
+    parsed.path = StringView(path, authorityAndPathEnd - path);
+    parsed.validAuthority =
+        parseAuthority(authority, path, parsed.host, parsed.port);
+  }
   return true;
 }
 
+std::optional<StringView> findQueryParameter(
+    StringView query,
+    StringView name) {
+  if (query.empty()) {
+    return std::nullopt;
+  }
+  const char* begin = query.data();
+  const char* end = begin + query.size();
+  for (;;) {
+    auto parameterEnd = std::find(begin, end, '&');
+    auto equals = std::find(begin, parameterEnd, '=');
+    if (equals == parameterEnd ||
+        std::find(equals + 1, parameterEnd, '=') == parameterEnd) {
+      StringView key(begin, equals - begin);
+      if (!key.empty() && key == name) {
+        return equals == parameterEnd
+            ? StringView()
+            : StringView(equals + 1, parameterEnd - equals - 1);
+      }
+    }
+    if (parameterEnd == end) {
+      return std::nullopt;
+    }
+    begin = parameterEnd + 1;
+  }
+}
+
 } // namespace facebook::velox::functions
@@ -15,37 +15,45 @@
  */
 #pragma once
 
-#include <boost/regex.hpp>
-#include <cctype>
+#include <optional>
+
 #include "velox/functions/Macros.h"
 
 namespace facebook::velox::functions {
 
-namespace {
-FOLLY_ALWAYS_INLINE StringView submatch(const boost::cmatch& match, int idx) {
-  const auto& sub = match[idx];
-  return StringView(sub.first, sub.length());
-}
-
-template <typename TInString>
-bool parse(const TInString& rawUrl, boost::cmatch& match) {
-  static const boost::regex kUriRegex(
-      "([a-zA-Z][a-zA-Z0-9+.-]*):" // scheme:
-      "([^?#]*)" // authority and path
-      "(?:\\?([^#]*))?" // ?query
-      "(?:#(.*))?"); // #fragment
-
-  return boost::regex_match(
-      rawUrl.data(), rawUrl.data() + rawUrl.size(), match, kUriRegex);
-}
+// The components of a URL of the form
+//
+//   protocol:authorityAndPath[?query][#fragment]
+//
+// where 'authorityAndPath' is either a path or //authority[/path] and the
+// authority is [user[:password]@]host[:port]. The components are StringViews
+// into the URL. Components that are not present are empty.
+struct ParsedUrl {
+  StringView protocol;
+  StringView authorityAndPath;
+  StringView query;
+  StringView fragment;
+  // True if 'authorityAndPath' starts with "//".
+  bool hasAuthority{false};
+  // False if 'hasAuthority' and the authority is not of the form above.
+  bool validAuthority{true};
+  // Set if 'hasAuthority' and 'validAuthority'.
+  StringView host;
+  StringView port;
+  // The part of 'authorityAndPath' after the authority. Set if
+  // 'hasAuthority'.
+  StringView path;
+};
 
-} // namespace
+// Parses 'url' into 'parsed' in a single pass over the URL. Returns false if
+// 'url' does not start with a protocol followed by ':'. The components are
+// the ones Presto gets from its URL regular expressions.
+bool parseUrl(StringView url, ParsedUrl& parsed);
 
-bool matchAuthorityAndPath(
-    const boost::cmatch& urlMatch,
-    boost::cmatch& authAndPathMatch,
-    boost::cmatch& authorityMatch,
-    bool& hasAuthority);
+// Returns the value of the first parameter named 'name' in 'query', a list
+// of name[=value] separated by '&'. A parameter with more than one '=' or an
+// empty name never matches. The value is empty for a parameter without '='.
+std::optional<StringView> findQueryParameter(StringView query, StringView name);
 
 template <typename T>
 struct UrlExtractProtocolFunction {
@@ -60,11 +68,11 @@ struct UrlExtractProtocolFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    ParsedUrl parsed;
+    if (!parseUrl(url, parsed)) {
       result.setEmpty();
     } else {
-      result.setNoCopy(submatch(match, 1));
+      result.setNoCopy(parsed.protocol);
     }
     return true;
   }
@@ -83,11 +91,11 @@ struct UrlExtractFragmentFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    ParsedUrl parsed;
+    if (!parseUrl(url, parsed)) {
       result.setEmpty();
     } else {
-      result.setNoCopy(submatch(match, 4));
+      result.setNoCopy(parsed.fragment);
     }
     return true;
   }
@@ -106,19 +114,10 @@ struct UrlExtractHostFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      result.setEmpty();
-      return true;
-    }
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
-    bool hasAuthority;
-
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority) &&
-        hasAuthority) {
-      result.setNoCopy(submatch(authorityMatch, 3));
+    ParsedUrl parsed;
+    if (parseUrl(url, parsed) && parsed.hasAuthority &&
+        parsed.validAuthority) {
+      result.setNoCopy(parsed.host);
     } else {
       result.setEmpty();
     }
@@ -131,24 +130,13 @@ struct UrlExtractPortFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
   FOLLY_ALWAYS_INLINE bool call(int64_t& result, const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      return false;
-    }
-
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
-    bool hasAuthority;
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority) &&
-        hasAuthority) {
-      auto port = submatch(authorityMatch, 4);
-      if (!port.empty()) {
-        try {
-          result = to<int64_t>(port);
-          return true;
-        } catch (folly::ConversionError const&) {
-        }
+    ParsedUrl parsed;
+    if (parseUrl(url, parsed) && parsed.hasAuthority &&
+        parsed.validAuthority && !parsed.port.empty()) {
+      try {
+        result = to<int64_t>(parsed.port);
+        return true;
+      } catch (folly::ConversionError const&) {
       }
     }
     return false;
@@ -168,23 +156,16 @@ struct UrlExtractPathFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    ParsedUrl parsed;
+    if (!parseUrl(url, parsed)) {
       result.setEmpty();
       return true;
     }
 
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
-    bool hasAuthority;
-
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority)) {
-      if (hasAuthority) {
-        result.setNoCopy(submatch(authAndPathMatch, 2));
-      } else {
-        result.setNoCopy(submatch(match, 2));
-      }
+    if (!parsed.hasAuthority) {
+      result.setNoCopy(parsed.authorityAndPath);
+    } else if (parsed.validAuthority) {
+      result.setNoCopy(parsed.path);
     }
 
     return true;
@@ -204,14 +185,13 @@ struct UrlExtractQueryFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    ParsedUrl parsed;
+    if (!parseUrl(url, parsed)) {
       result.setEmpty();
       return true;
     }
 
-    auto query = submatch(match, 3);
-    result.setNoCopy(query);
+    result.setNoCopy(parsed.query);
     return true;
   }
 };
@@ -230,39 +210,16 @@ struct UrlExtractParameterFunction {
       out_type<Varchar>& result,
       const arg_type<Varchar>& url,
       const arg_type<Varchar>& param) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    ParsedUrl parsed;
+    if (!parseUrl(url, parsed)) {
       result.setEmpty();
       return false;
     }
 
-    auto query = submatch(match, 3);
-    if (!query.empty()) {
-      // Parse query string.
-      static const boost::regex kQueryParamRegex(
-          "(^|&)" // start of query or start of parameter "&"
-          "([^=&]*)=?" // parameter name and "=" if value is expected
-          "([^=&]*)" // parameter value
-          "(?=(&|$))" // forward reference, next should be end of query or
-                      // start of next parameter
-      );
-
-      const boost::cregex_iterator begin(
-          query.data(), query.data() + query.size(), kQueryParamRegex);
-      boost::cregex_iterator end;
-
-      for (auto it = begin; it != end; ++it) {
-        if (it->length(2) != 0) { // key shouldnt be empty.
-          auto key = submatch((*it), 2);
-          if (param.compare(key) == 0) {
-            auto value = submatch((*it), 3);
-            result.setNoCopy(value);
-            return true;
-          }
-        }
-      }
+    if (auto value = findQueryParameter(parsed.query, param)) {
+      result.setNoCopy(*value);
+      return true;
     }
-
     return false;
   }
 };
@@ -48,18 +48,35 @@ struct HllAccumulator {
     }
   }
 
+  void append(const uint64_t* hashes, int32_t numHashes) {
+    int32_t i = 0;
+    for (; isSparse_ && i < numHashes; ++i) {
+      append(hashes[i]);
+    }
+    if (i < numHashes) {
+      denseHll_.insertHashes(hashes + i, numHashes - i);
+    }
+  }
+
   int64_t cardinality() const {
     return isSparse_ ? sparseHll_.cardinality() : denseHll_.cardinality();
   }
 
-  void mergeWith(StringView serialized, HashStringAllocator* allocator) {
+  // Merges a serialized HLL in place, without deserializing it into a
+  // SparseHll or DenseHll. A sparse accumulator turns dense once the merged
+  // entries reach the soft memory limit, as in Presto.
+  void mergeWith(StringView serialized) {
     auto input = serialized.data();
     if (hll::SparseHll::canDeserialize(input)) {
       if (isSparse_) {
-        sparseHll_.mergeWith(input);
+        if (indexBitLength_ < 0) {
+          setIndexBitLength(hll::SparseHll::deserializeIndexBitLength(input));
+        }
+        if (sparseHll_.mergeWith(input)) {
+          toDense();
+        }
       } else {
-        hll::SparseHll other{input, allocator};
-        other.toDense(denseHll_);
+        hll::SparseHll::toDense(input, denseHll_);
       }
     } else if (hll::DenseHll::canDeserialize(input)) {
       if (isSparse_) {
@@ -78,7 +95,12 @@ struct HllAccumulator {
     return isSparse_ ? sparseHll_.serializedSize() : denseHll_.serializedSize();
   }
 
+  // The index bit length of merged HLLs takes precedence over
+  // 'indexBitLength', which is the default of the aggregate.
   void serialize(int8_t indexBitLength, StringView& output) {
+    if (indexBitLength_ >= 0) {
+      indexBitLength = indexBitLength_;
+    }
     char* outputBuffer = const_cast<char*>(output.data());
     return isSparse_ ? sparseHll_.serialize(indexBitLength, outputBuffer)
                      : denseHll_.serialize(outputBuffer);
@@ -236,7 +258,7 @@ class ApproxDistinctAggregate : public exec::Aggregate {
       auto serialized = decodedHll_.valueAt<StringView>(row);
 
       auto accumulator = value<HllAccumulator>(group);
-      accumulator->mergeWith(serialized, allocator_);
+      accumulator->mergeWith(serialized);
     });
   }
 
@@ -251,19 +273,23 @@ class ApproxDistinctAggregate : public exec::Aggregate {
     } else {
       decodeArguments(rows, args);
 
+      // Hashes all rows before inserting them, so that a dense HLL takes them
+      // in batches.
+      hashes_.clear();
       rows.applyToSelected([&](auto row) {
-        if (decodedValue_.isNullAt(row)) {
-          return;
+        if (!decodedValue_.isNullAt(row)) {
+          hashes_.push_back(hashOne(decodedValue_.valueAt<T>(row)));
         }
-
-        auto accumulator = value<HllAccumulator>(group);
-        if (clearNull(group)) {
-          accumulator->setIndexBitLength(indexBitLength_);
-        }
-
-        auto hash = hashOne(decodedValue_.valueAt<T>(row));
-        accumulator->append(hash);
       });
+      if (hashes_.empty()) {
+        return;
+      }
+
+      auto accumulator = value<HllAccumulator>(group);
+      if (clearNull(group)) {
+        accumulator->setIndexBitLength(indexBitLength_);
+      }
+      accumulator->append(hashes_.data(), hashes_.size());
     }
   }
 
@@ -285,7 +311,7 @@ class ApproxDistinctAggregate : public exec::Aggregate {
       auto serialized = decodedHll_.valueAt<StringView>(row);
 
       auto accumulator = value<HllAccumulator>(group);
-      accumulator->mergeWith(serialized, allocator_);
+      accumulator->mergeWith(serialized);
     });
   }
 
@@ -376,6 +402,8 @@ class ApproxDistinctAggregate : public exec::Aggregate {
   DecodedVector decodedValue_;
   DecodedVector decodedMaxStandardError_;
   DecodedVector decodedHll_;
+  // Hashes of the rows of addSingleGroupRawInput().
+  std::vector<uint64_t> hashes_;
 };
 
 template <TypeKind kind>
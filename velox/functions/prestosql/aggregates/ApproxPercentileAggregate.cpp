@@ -144,6 +144,11 @@ class ApproxPercentileAggregate : public exec::Aggregate {
     }
   }
 
+  // finalize() seals the accumulated values.
+  bool canAddInputAfterFinalize() const override {
+    return false;
+  }
+
   void finalize(char** groups, int32_t numGroups) override {
     for (auto i = 0; i < numGroups; ++i) {
       value<KllSketchAccumulator<T>>(groups[i])->finalize();
@@ -231,18 +236,34 @@ class ApproxPercentileAggregate : public exec::Aggregate {
       bool /*mayPushdown*/) override {
     decodedDigest_.decode(*args[0], rows, true);
 
+    // Merges the digests of each group in one batch, so that a group is
+    // compacted once per input vector instead of once per row.
+    groupDigests_.clear();
     rows.applyToSelected([&](auto row) {
       if (decodedDigest_.isNullAt(row)) {
         return;
       }
-      auto tracker = trackRowSize(groups[row]);
-      auto accumulator = value<KllSketchAccumulator<T>>(groups[row]);
-      auto digest = getDeserializedDigest(row);
+      groupDigests_.emplace_back(groups[row], getDeserializedDigest(row));
+    });
+    std::sort(
+        groupDigests_.begin(),
+        groupDigests_.end(),
+        [](const auto& left, const auto& right) {
+          return left.first < right.first;
+        });
+    for (auto i = 0; i < groupDigests_.size();) {
+      auto group = groupDigests_[i].first;
+      digests_.clear();
+      for (; i < groupDigests_.size() && groupDigests_[i].first == group; ++i) {
+        digests_.push_back(groupDigests_[i].second);
+      }
+      auto tracker = trackRowSize(group);
+      auto accumulator = value<KllSketchAccumulator<T>>(group);
       if (accuracy_ != kMissingNormalizedValue) {
         accumulator->setAccuracy(accuracy_);
       }
-      accumulator->append(digest);
-    });
+      accumulator->append(digests_);
+    }
   }
 
   void addSingleGroupRawInput(
@@ -459,6 +480,9 @@ class ApproxPercentileAggregate : public exec::Aggregate {
   DecodedVector decodedPercentile_;
   DecodedVector decodedAccuracy_;
   DecodedVector decodedDigest_;
+  // Group and deserialized digest of the rows of addIntermediateResults().
+  std::vector<std::pair<char*, const char*>> groupDigests_;
+  std::vector<const char*> digests_;
 };
 
 bool registerApproxPercentile(const std::string& name) {
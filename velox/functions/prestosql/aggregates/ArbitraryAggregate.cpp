@@ -187,6 +187,18 @@ class NonNumericArbitrary : public exec::Aggregate {
     }
   }
 
+  bool supportsRelocation() const override {
+    return true;
+  }
+
+  void relocateAccumulators(
+      folly::Range<char**> groups,
+      const HashStringAllocator::Relocation& relocation) override {
+    for (auto group : groups) {
+      value<SingleValueAccumulator>(group)->relocate(relocation);
+    }
+  }
+
   void addRawInput(
       char** groups,
       const SelectivityVector& rows,
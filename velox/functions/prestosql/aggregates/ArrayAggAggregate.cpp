@@ -46,6 +46,11 @@ class ArrayAggAggregate : public exec::Aggregate {
     }
   }
 
+  // finalize() seals the accumulated values.
+  bool canAddInputAfterFinalize() const override {
+    return false;
+  }
+
   void finalize(char** groups, int32_t numGroups) override {
     for (auto i = 0; i < numGroups; i++) {
       value<ArrayAccumulator>(groups[i])->elements.finalize(allocator_);
@@ -161,6 +166,18 @@ class ArrayAggAggregate : public exec::Aggregate {
     }
   }
 
+  bool supportsRelocation() const override {
+    return true;
+  }
+
+  void relocateAccumulators(
+      folly::Range<char**> groups,
+      const HashStringAllocator::Relocation& relocation) override {
+    for (auto group : groups) {
+      value<ArrayAccumulator>(group)->elements.relocate(relocation);
+    }
+  }
+
  private:
   vector_size_t countElements(char** groups, int32_t numGroups) const {
     vector_size_t size = 0;
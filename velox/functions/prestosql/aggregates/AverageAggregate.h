@@ -16,6 +16,8 @@
 #include "velox/exec/Aggregate.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
+#include "velox/functions/prestosql/aggregates/DecimalAggregates.h"
+#include "velox/functions/prestosql/aggregates/SimdReductions.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
@@ -40,6 +42,10 @@ class AverageAggregate : public exec::Aggregate {
     return sizeof(SumCount);
   }
 
+  bool supportsRelocation() const override {
+    return true;
+  }
+
   void initializeNewGroups(
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
@@ -123,6 +129,22 @@ class AverageAggregate : public exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
+    if constexpr (kSimdReducible<T, double>) {
+      if (args[0]->encoding() == VectorEncoding::Simple::FLAT) {
+        vector_size_t numValues;
+        const auto sum = simdReduce(
+            args[0]->asUnchecked<FlatVector<T>>()->rawValues(),
+            rows,
+            args[0]->rawNulls(),
+            0.0,
+            SimdSum(),
+            numValues);
+        if (numValues) {
+          updateNonNullValue(group, numValues, sum);
+        }
+        return;
+      }
+    }
     decodedRaw_.decode(*args[0], rows);
 
     if (decodedRaw_.isConstantMapping()) {
@@ -305,6 +327,16 @@ bool registerAverageAggregate(const std::string& name) {
                            .intermediateType("row(double,bigint)")
                            .argumentType("real")
                            .build());
+  // decimal(p, s) -> decimal(p, s)
+  signatures.push_back(
+      exec::AggregateFunctionSignatureBuilder()
+          .returnType("DECIMAL(r_precision, r_scale)")
+          .intermediateType("row(DECIMAL(i_precision, r_scale), bigint)")
+          .argumentType("DECIMAL(a_precision, a_scale)")
+          .variableConstraint("r_precision", "a_precision")
+          .variableConstraint("r_scale", "a_scale")
+          .variableConstraint("i_precision", "38")
+          .build());
 
   exec::registerAggregateFunction(
       name,
@@ -328,6 +360,12 @@ bool registerAverageAggregate(const std::string& name) {
               return std::make_unique<AverageAggregate<float>>(resultType);
             case TypeKind::DOUBLE:
               return std::make_unique<AverageAggregate<double>>(resultType);
+            case TypeKind::SHORT_DECIMAL:
+              return std::make_unique<DecimalAverageAggregate<ShortDecimal>>(
+                  resultType);
+            case TypeKind::LONG_DECIMAL:
+              return std::make_unique<DecimalAverageAggregate<LongDecimal>>(
+                  resultType);
             default:
               VELOX_FAIL(
                   "Unknown input type for {} aggregation {}",
@@ -335,6 +373,11 @@ bool registerAverageAggregate(const std::string& name) {
                   inputType->kindName());
           }
         } else {
+          if (inputType->kind() == TypeKind::ROW &&
+              isDecimalKind(inputType->childAt(0)->kind())) {
+            return std::make_unique<DecimalAverageAggregate<LongDecimal>>(
+                resultType);
+          }
           checkSumCountRowType(
               inputType,
               "Input type for final aggregation must be (sum:double, count:bigint) struct");
@@ -98,6 +98,14 @@ class ChecksumAggregate : public exec::Aggregate {
     hasher->hash(arg, rows, hashes);
     auto rawHashes = hashes->as<int64_t>();
 
+    if (!arg->mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t row) {
+        auto group = groups[row];
+        clearNull(group);
+        computeHash(group, rawHashes[row]);
+      });
+      return;
+    }
     rows.applyToSelected([&](vector_size_t row) {
       auto group = groups[row];
       clearNull(group);
@@ -143,15 +151,22 @@ class ChecksumAggregate : public exec::Aggregate {
     auto hashes = getHashBuffer(rows.end(), arg->pool());
     hasher->hash(arg, rows, hashes);
     auto rawHashes = hashes->as<int64_t>();
+    if (!rows.hasSelections()) {
+      return;
+    }
 
-    rows.applyToSelected([&](vector_size_t row) {
-      clearNull(group);
-      if (arg->isNullAt(row)) {
-        computeHashForNull(group);
-      } else {
-        computeHash(group, rawHashes[row]);
-      }
-    });
+    // All hashes are multiplied by the same prime, so the sum of the hashes
+    // is multiplied once. A null row adds 1 * XXH_PRIME64_1.
+    uint64_t sum = 0;
+    if (arg->mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t row) {
+        sum += arg->isNullAt(row) ? 1 : rawHashes[row];
+      });
+    } else {
+      rows.applyToSelected([&](vector_size_t row) { sum += rawHashes[row]; });
+    }
+    clearNull(group);
+    *value<int64_t>(group) += sum * XXH_PRIME64_1;
   }
 
   void addSingleGroupIntermediateResults(
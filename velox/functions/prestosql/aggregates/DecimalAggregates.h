@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/Aggregate.h"
+#include "velox/type/DecimalUtil.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::aggregate {
+
+namespace detail {
+// The group rows of a RowContainer do not honor accumulatorAlignmentSize(),
+// so the int128_t sums are copied in and out.
+inline int128_t loadInt128(const char* address) {
+  int128_t value;
+  std::memcpy(&value, address, sizeof(value));
+  return value;
+}
+
+inline void storeInt128(char* address, int128_t value) {
+  std::memcpy(address, &value, sizeof(value));
+}
+
+inline int128_t checkedAdd(int128_t left, int128_t right) {
+  int128_t result;
+  VELOX_USER_CHECK(
+      !__builtin_add_overflow(left, right, &result), "Decimal overflow");
+  return result;
+}
+
+inline int128_t checkedMultiply(int128_t left, int64_t right) {
+  int128_t result;
+  VELOX_USER_CHECK(
+      !__builtin_mul_overflow(left, right, &result), "Decimal overflow");
+  return result;
+}
+
+inline LongDecimal toLongDecimal(int128_t sum) {
+  VELOX_USER_CHECK(
+      DecimalUtil::valueInRange(sum, LongDecimalType::kMaxPrecision),
+      "Decimal overflow");
+  return LongDecimal(sum);
+}
+
+// Returns the sum of the unscaled values of the non-null 'rows' of 'decoded'
+// and sets 'numValues' to their count.
+template <typename T>
+int128_t sumDecoded(
+    const DecodedVector& decoded,
+    const SelectivityVector& rows,
+    int64_t& numValues) {
+  int128_t sum = 0;
+  numValues = 0;
+  if (decoded.isConstantMapping()) {
+    if (!decoded.isNullAt(rows.begin())) {
+      numValues = rows.countSelected();
+      sum = checkedMultiply(
+          DecimalUtil::unscaledValue(decoded.valueAt<T>(rows.begin())),
+          numValues);
+    }
+    return sum;
+  }
+  rows.applyToSelected([&](vector_size_t row) {
+    if (!decoded.isNullAt(row)) {
+      sum =
+          checkedAdd(sum, DecimalUtil::unscaledValue(decoded.valueAt<T>(row)));
+      ++numValues;
+    }
+  });
+  return sum;
+}
+} // namespace detail
+
+// sum(decimal(p, s)) -> decimal(38, s). The accumulator is the int128_t
+// unscaled sum. A sum over 38 digits or over the range of int128_t is a user
+// error. The intermediate result is the same decimal(38, s). TInput is
+// ShortDecimal or LongDecimal for raw input.
+template <typename TInput>
+class DecimalSumAggregate : public exec::Aggregate {
+ public:
+  explicit DecimalSumAggregate(TypePtr resultType)
+      : exec::Aggregate(std::move(resultType)) {}
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return sizeof(int128_t);
+  }
+
+  int32_t accumulatorAlignmentSize() const override {
+    return alignof(int128_t);
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    setAllNulls(groups, indices);
+    for (auto i : indices) {
+      detail::storeInt128(value<char>(groups[i]), 0);
+    }
+  }
+
+  void finalize(char** /*groups*/, int32_t /*numGroups*/) override {}
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto* vector = (*result)->as<FlatVector<LongDecimal>>();
+    VELOX_CHECK(vector);
+    vector->resize(numGroups);
+    uint64_t* rawNulls = getRawNulls(vector);
+    auto* rawValues = vector->mutableRawValues();
+    for (auto i = 0; i < numGroups; ++i) {
+      char* group = groups[i];
+      if (isNull(group)) {
+        vector->setNull(i, true);
+      } else {
+        clearNull(rawNulls, i);
+        rawValues[i] =
+            detail::toLongDecimal(detail::loadInt128(value<char>(group)));
+      }
+    }
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    extractValues(groups, numGroups, result);
+  }
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addGroups<TInput>(groups, rows, args[0]);
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addGroups<LongDecimal>(groups, rows, args[0]);
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addOneGroup<TInput>(group, rows, args[0]);
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addOneGroup<LongDecimal>(group, rows, args[0]);
+  }
+
+ private:
+  void addToGroup(char* group, int128_t sum) {
+    clearNull(group);
+    auto* accumulator = value<char>(group);
+    detail::storeInt128(
+        accumulator, detail::checkedAdd(detail::loadInt128(accumulator), sum));
+  }
+
+  template <typename T>
+  void addGroups(
+      char** groups,
+      const SelectivityVector& rows,
+      const VectorPtr& arg) {
+    decoded_.decode(*arg, rows);
+    rows.applyToSelected([&](vector_size_t row) {
+      if (!decoded_.isNullAt(row)) {
+        addToGroup(
+            groups[row], DecimalUtil::unscaledValue(decoded_.valueAt<T>(row)));
+      }
+    });
+  }
+
+  template <typename T>
+  void addOneGroup(
+      char* group,
+      const SelectivityVector& rows,
+      const VectorPtr& arg) {
+    decoded_.decode(*arg, rows);
+    int64_t numValues;
+    const auto sum = detail::sumDecoded<T>(decoded_, rows, numValues);
+    if (numValues) {
+      addToGroup(group, sum);
+    }
+  }
+
+  DecodedVector decoded_;
+};
+
+// avg(decimal(p, s)) -> decimal(p, s). The accumulator is the int128_t
+// unscaled sum and the count, the intermediate result is row(decimal(38, s),
+// bigint) and the average is the sum divided by the count rounded half away
+// from zero. TInput is ShortDecimal or LongDecimal for raw input and is not
+// used for intermediate input.
+template <typename TInput>
+class DecimalAverageAggregate : public exec::Aggregate {
+ public:
+  explicit DecimalAverageAggregate(TypePtr resultType)
+      : exec::Aggregate(std::move(resultType)) {}
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return sizeof(int128_t) + sizeof(int64_t);
+  }
+
+  int32_t accumulatorAlignmentSize() const override {
+    return alignof(int128_t);
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    setAllNulls(groups, indices);
+    for (auto i : indices) {
+      detail::storeInt128(value<char>(groups[i]), 0);
+      *count(groups[i]) = 0;
+    }
+  }
+
+  void finalize(char** /*groups*/, int32_t /*numGroups*/) override {}
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    if (resultType_->kind() == TypeKind::SHORT_DECIMAL) {
+      extractAverages<ShortDecimal>(groups, numGroups, result);
+    } else {
+      extractAverages<LongDecimal>(groups, numGroups, result);
+    }
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto* rowVector = (*result)->as<RowVector>();
+    auto* sumVector = rowVector->childAt(0)->asFlatVector<LongDecimal>();
+    auto* countVector = rowVector->childAt(1)->asFlatVector<int64_t>();
+    rowVector->resize(numGroups);
+    sumVector->resize(numGroups);
+    countVector->resize(numGroups);
+    uint64_t* rawNulls = getRawNulls(rowVector);
+    auto* rawSums = sumVector->mutableRawValues();
+    auto* rawCounts = countVector->mutableRawValues();
+    for (auto i = 0; i < numGroups; ++i) {
+      char* group = groups[i];
+      if (isNull(group)) {
+        rowVector->setNull(i, true);
+      } else {
+        clearNull(rawNulls, i);
+        rawSums[i] =
+            detail::toLongDecimal(detail::loadInt128(value<char>(group)));
+        rawCounts[i] = *count(group);
+      }
+    }
+  }
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decoded_.decode(*args[0], rows);
+    rows.applyToSelected([&](vector_size_t row) {
+      if (!decoded_.isNullAt(row)) {
+        addToGroup(
+            groups[row],
+            DecimalUtil::unscaledValue(decoded_.valueAt<TInput>(row)),
+            1);
+      }
+    });
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addIntermediate(
+        [&](vector_size_t row) { return groups[row]; }, rows, args[0]);
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decoded_.decode(*args[0], rows);
+    int64_t numValues;
+    const auto sum = detail::sumDecoded<TInput>(decoded_, rows, numValues);
+    if (numValues) {
+      addToGroup(group, sum, numValues);
+    }
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    addIntermediate(
+        [&](vector_size_t /*row*/) { return group; }, rows, args[0]);
+  }
+
+ private:
+  template <typename GroupAt>
+  void addIntermediate(
+      GroupAt groupAt,
+      const SelectivityVector& rows,
+      const VectorPtr& arg) {
+    decoded_.decode(*arg, rows);
+    auto* baseRowVector = decoded_.base()->as<RowVector>();
+    auto* sums = baseRowVector->childAt(0)->as<SimpleVector<LongDecimal>>();
+    auto* counts = baseRowVector->childAt(1)->as<SimpleVector<int64_t>>();
+    rows.applyToSelected([&](vector_size_t row) {
+      if (!decoded_.isNullAt(row)) {
+        const auto index = decoded_.index(row);
+        addToGroup(
+            groupAt(row),
+            sums->valueAt(index).unscaledValue(),
+            counts->valueAt(index));
+      }
+    });
+  }
+
+  int64_t* count(char* group) const {
+    return reinterpret_cast<int64_t*>(value<char>(group) + sizeof(int128_t));
+  }
+
+  void addToGroup(char* group, int128_t sum, int64_t numValues) {
+    clearNull(group);
+    auto* accumulator = value<char>(group);
+    detail::storeInt128(
+        accumulator, detail::checkedAdd(detail::loadInt128(accumulator), sum));
+    *count(group) += numValues;
+  }
+
+  template <typename TResult>
+  void extractAverages(char** groups, int32_t numGroups, VectorPtr* result) {
+    auto* vector = (*result)->as<FlatVector<TResult>>();
+    VELOX_CHECK(vector);
+    vector->resize(numGroups);
+    uint64_t* rawNulls = getRawNulls(vector);
+    auto* rawValues = vector->mutableRawValues();
+    for (auto i = 0; i < numGroups; ++i) {
+      char* group = groups[i];
+      if (isNull(group)) {
+        vector->setNull(i, true);
+      } else {
+        clearNull(rawNulls, i);
+        // The average of decimal(p, s) values is a decimal(p, s).
+        const auto average = DecimalUtil::divideRoundHalfUp(
+            detail::loadInt128(value<char>(group)), *count(group));
+        rawValues[i] = TResult(
+            static_cast<decltype(DecimalUtil::unscaledValue(TResult()))>(
+                average));
+      }
+    }
+  }
+
+  DecodedVector decoded_;
+};
+
+} // namespace facebook::velox::aggregate
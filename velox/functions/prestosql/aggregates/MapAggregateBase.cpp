@@ -107,7 +107,7 @@ VectorPtr MapAggregateBase::removeDuplicates(MapVectorPtr& mapVector) const {
   };
 
   if (rawNewSizes) {
-    return std::make_shared<MapVector>(
+    auto deduplicated = std::make_shared<MapVector>(
         mapVector->pool(),
         mapVector->type(),
         mapVector->nulls(),
@@ -121,6 +121,9 @@ VectorPtr MapAggregateBase::removeDuplicates(MapVectorPtr& mapVector) const {
             elementIndices,
             numElements,
             mapVector->mapValues()));
+    // Removing duplicates keeps the keys sorted.
+    deduplicated->setSortedKeys(true);
+    return deduplicated;
   } else {
     return mapVector;
   }
@@ -46,6 +46,11 @@ class MapAggregateBase : public exec::Aggregate {
     }
   }
 
+  // finalize() seals the accumulated values.
+  bool canAddInputAfterFinalize() const override {
+    return false;
+  }
+
   void finalize(char** groups, int32_t numGroups) override {
     for (auto i = 0; i < numGroups; i++) {
       value<MapAccumulator>(groups[i])->keys.finalize(allocator_);
@@ -85,6 +90,20 @@ class MapAggregateBase : public exec::Aggregate {
     }
   }
 
+  bool supportsRelocation() const override {
+    return true;
+  }
+
+  void relocateAccumulators(
+      folly::Range<char**> groups,
+      const HashStringAllocator::Relocation& relocation) override {
+    for (auto group : groups) {
+      auto accumulator = value<MapAccumulator>(group);
+      accumulator->keys.relocate(relocation);
+      accumulator->values.relocate(relocation);
+    }
+  }
+
  protected:
   vector_size_t countElements(char** groups, int32_t numGroups) const {
     vector_size_t size = 0;
@@ -49,6 +49,10 @@ class MinMaxAggregate : public SimpleNumericAggregate<T, T, ResultType> {
     return sizeof(T);
   }
 
+  bool supportsColumnar() const override {
+    return true;
+  }
+
   void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
       override {
     BaseAggregate::doExtractValues(groups, numGroups, result, [&](char* group) {
@@ -121,6 +125,24 @@ class MaxAggregate : public MinMaxAggregate<T, ResultType> {
         mayPushdown);
   }
 
+  void addRawInputColumnar(
+      const uint32_t* groupNumbers,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if constexpr (std::is_integral_v<T>) {
+      if (BaseAggregate::template updateFewColumnarGroups<T>(
+              groupNumbers, rows, args[0], kInitialValue_, SimdMax())) {
+        return;
+      }
+    }
+    BaseAggregate::template updateColumnarGroups<T>(
+        groupNumbers, rows, args[0], [](T& result, T value) {
+          if (result < value) {
+            result = value;
+          }
+        });
+  }
+
   void addIntermediateResults(
       char** groups,
       const SelectivityVector& rows,
@@ -134,6 +156,12 @@ class MaxAggregate : public MinMaxAggregate<T, ResultType> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
+    if constexpr (std::is_integral_v<T>) {
+      if (BaseAggregate::template simdUpdateOneGroup<T>(
+              group, rows, args[0], kInitialValue_, SimdMax())) {
+        return;
+      }
+    }
     BaseAggregate::updateOneGroup(
         group,
         rows,
@@ -196,6 +224,24 @@ class MinAggregate : public MinMaxAggregate<T, ResultType> {
         mayPushdown);
   }
 
+  void addRawInputColumnar(
+      const uint32_t* groupNumbers,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if constexpr (std::is_integral_v<T>) {
+      if (BaseAggregate::template updateFewColumnarGroups<T>(
+              groupNumbers, rows, args[0], kInitialValue_, SimdMin())) {
+        return;
+      }
+    }
+    BaseAggregate::template updateColumnarGroups<T>(
+        groupNumbers, rows, args[0], [](T& result, T value) {
+          if (result > value) {
+            result = value;
+          }
+        });
+  }
+
   void addIntermediateResults(
       char** groups,
       const SelectivityVector& rows,
@@ -209,6 +255,12 @@ class MinAggregate : public MinMaxAggregate<T, ResultType> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
+    if constexpr (std::is_integral_v<T>) {
+      if (BaseAggregate::template simdUpdateOneGroup<T>(
+              group, rows, args[0], kInitialValue_, SimdMin())) {
+        return;
+      }
+    }
     BaseAggregate::updateOneGroup(
         group,
         rows,
@@ -290,6 +342,18 @@ class NonNumericMinMaxAggregateBase : public exec::Aggregate {
     }
   }
 
+  bool supportsRelocation() const override {
+    return true;
+  }
+
+  void relocateAccumulators(
+      folly::Range<char**> groups,
+      const HashStringAllocator::Relocation& relocation) override {
+    for (auto group : groups) {
+      value<SingleValueAccumulator>(group)->relocate(relocation);
+    }
+  }
+
  protected:
   template <typename TCompareTest>
   void doUpdate(
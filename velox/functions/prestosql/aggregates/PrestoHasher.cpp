@@ -58,6 +58,16 @@ FOLLY_ALWAYS_INLINE void hashIntegral(
     const DecodedVector& vector,
     const SelectivityVector& rows,
     BufferPtr& hashes) {
+  if (vector.isIdentityMapping() && !vector.mayHaveNulls()) {
+    // A loop over the values without null checks or index mapping that the
+    // compiler can vectorize.
+    VELOX_CHECK_GE(hashes->size(), rows.end())
+    auto rawHashes = hashes->asMutable<int64_t>();
+    auto values = vector.data<T>();
+    rows.applyToSelected(
+        [&](auto row) { rawHashes[row] = hashInteger<T>(values[row]); });
+    return;
+  }
   applyHashFunction(rows, vector, hashes, [&](auto row) {
     return hashInteger<T>(vector.valueAt<T>(row));
   });
@@ -79,6 +89,22 @@ safeXor(const int64_t& hash, const int64_t& a, const int64_t& b) {
   return hash + (a ^ b);
 }
 
+// Makes 'buffer' hold 'size' hashes. Reuses 'buffer' if it is not shared
+// and large enough, so that hashing a nested column does not allocate per
+// batch.
+BufferPtr& ensureHashes(
+    BufferPtr& buffer,
+    vector_size_t size,
+    memory::MemoryPool* pool) {
+  const auto bytes = size * sizeof(int64_t);
+  if (buffer && buffer->unique() && buffer->capacity() >= bytes) {
+    buffer->setSize(bytes);
+  } else {
+    buffer = AlignedBuffer::allocate<int64_t>(size, pool);
+  }
+  return buffer;
+}
+
 } // namespace
 
 template <TypeKind kind>
@@ -102,18 +128,16 @@ template <>
 FOLLY_ALWAYS_INLINE void PrestoHasher::hash<TypeKind::DATE>(
     const SelectivityVector& rows,
     BufferPtr& hashes) {
-  applyHashFunction(rows, *vector_.get(), hashes, [&](auto row) {
-    return hashInteger(vector_->valueAt<Date>(row).days());
-  });
+  static_assert(sizeof(Date) == sizeof(int32_t));
+  hashIntegral<int32_t>(*vector_.get(), rows, hashes);
 }
 
 template <>
 FOLLY_ALWAYS_INLINE void PrestoHasher::hash<TypeKind::INTERVAL_DAY_TIME>(
     const SelectivityVector& rows,
     BufferPtr& hashes) {
-  applyHashFunction(rows, *vector_.get(), hashes, [&](auto row) {
-    return hashInteger(vector_->valueAt<IntervalDayTime>(row).milliseconds());
-  });
+  static_assert(sizeof(IntervalDayTime) == sizeof(int64_t));
+  hashIntegral<int64_t>(*vector_.get(), rows, hashes);
 }
 
 template <>
@@ -166,8 +190,8 @@ void PrestoHasher::hash<TypeKind::ARRAY>(
   auto elementRows = functions::toElementRows(
       baseArray->elements()->size(), rows, baseArray, indices);
 
-  BufferPtr elementHashes =
-      AlignedBuffer::allocate<int64_t>(elementRows.end(), baseArray->pool());
+  auto& elementHashes =
+      ensureHashes(childHashes_, elementRows.end(), baseArray->pool());
 
   children_[0]->hash(baseArray->elements(), elementRows, elementHashes);
 
@@ -201,11 +225,10 @@ void PrestoHasher::hash<TypeKind::MAP>(
 
   auto elementRows = functions::toElementRows(
       baseMap->mapKeys()->size(), rows, baseMap, indices);
-  BufferPtr keyHashes =
-      AlignedBuffer::allocate<int64_t>(elementRows.end(), baseMap->pool());
-
-  BufferPtr valueHashes =
-      AlignedBuffer::allocate<int64_t>(elementRows.end(), baseMap->pool());
+  auto& keyHashes =
+      ensureHashes(childHashes_, elementRows.end(), baseMap->pool());
+  auto& valueHashes =
+      ensureHashes(valueHashes_, elementRows.end(), baseMap->pool());
 
   children_[0]->hash(baseMap->mapKeys(), elementRows, keyHashes);
   children_[1]->hash(baseMap->mapValues(), elementRows, valueHashes);
@@ -250,8 +273,8 @@ void PrestoHasher::hash<TypeKind::ROW>(
     elementRows.updateBounds();
   }
 
-  BufferPtr childHashes =
-      AlignedBuffer::allocate<int64_t>(elementRows.end(), baseRow->pool());
+  auto& childHashes =
+      ensureHashes(childHashes_, elementRows.end(), baseRow->pool());
 
   auto rawHashes = hashes->asMutable<int64_t>();
   auto rowChildHashes = childHashes->as<int64_t>();
@@ -48,6 +48,10 @@ class PrestoHasher {
   std::shared_ptr<DecodedVector> vector_{std::make_shared<DecodedVector>()};
   std::vector<std::unique_ptr<PrestoHasher>> children_;
   const TypePtr type_;
+  // Hashes of the elements, keys or fields of a complex type, and of the
+  // values of a map. Kept between calls.
+  BufferPtr childHashes_;
+  BufferPtr valueHashes_;
 };
 
 } // namespace facebook::velox::aggregate
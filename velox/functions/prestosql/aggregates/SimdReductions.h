@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+
+#include <xsimd/xsimd.hpp>
+
+#include "velox/common/base/SimdUtil.h"
+#include "velox/vector/SelectivityVector.h"
+
+namespace facebook::velox::aggregate {
+
+// Operators of simdReduce() and reduceByLanes(). Each combines two xsimd
+// batches lane by lane or two single values.
+struct SimdSum {
+  template <typename T>
+  T operator()(T x, T y) const {
+    return x + y;
+  }
+};
+
+struct SimdMin {
+  template <typename T, typename A>
+  xsimd::batch<T, A> operator()(xsimd::batch<T, A> x, xsimd::batch<T, A> y)
+      const {
+    return xsimd::min(x, y);
+  }
+
+  template <typename T>
+  T operator()(T x, T y) const {
+    return y < x ? y : x;
+  }
+};
+
+struct SimdMax {
+  template <typename T, typename A>
+  xsimd::batch<T, A> operator()(xsimd::batch<T, A> x, xsimd::batch<T, A> y)
+      const {
+    return xsimd::max(x, y);
+  }
+
+  template <typename T>
+  T operator()(T x, T y) const {
+    return x < y ? y : x;
+  }
+};
+
+namespace detail {
+template <typename TInput, typename TResult>
+constexpr bool isSimdReducible() {
+  if constexpr (
+      std::is_arithmetic_v<TInput> && !std::is_same_v<TInput, bool> &&
+      std::is_arithmetic_v<TResult> &&
+      (sizeof(TResult) == 4 || sizeof(TResult) == 8)) {
+    return xsimd::batch<TResult>::size <= 8;
+  }
+  return false;
+}
+} // namespace detail
+
+// True if simdReduce() can fold TInput values into a TResult. The masked
+// batches need simd::fromBitMask(), which exists for 4 and 8 byte lanes and
+// up to 8 lanes.
+template <typename TInput, typename TResult>
+constexpr bool kSimdReducible = detail::isSimdReducible<TInput, TResult>();
+
+// Folds the values of 'data' at the rows selected in 'rows' that are not null
+// in 'nulls' into 'identity' with 'op'. 'nulls' may be nullptr. 'identity'
+// must leave the other operand of 'op' unchanged. It fills the lanes of the
+// rows that are not selected or null. The values are widened to TResult as
+// they are loaded. Sets 'numValues' to the number of values folded.
+template <typename TResult, typename TInput, typename Op>
+TResult simdReduce(
+    const TInput* data,
+    const SelectivityVector& rows,
+    const uint64_t* nulls,
+    TResult identity,
+    Op op,
+    vector_size_t& numValues) {
+  static_assert(kSimdReducible<TInput, TResult>);
+  using Batch = xsimd::batch<TResult>;
+  constexpr int32_t kBatchSize = Batch::size;
+  static_assert(64 % kBatchSize == 0);
+  const auto end = rows.end();
+  const auto* selected = rows.asRange().bits();
+  const auto identityBatch = Batch(identity);
+  auto batch = identityBatch;
+  auto result = identity;
+  numValues = 0;
+
+  auto foldWord = [&](int32_t index, uint64_t word) {
+    if (!word) {
+      return;
+    }
+    numValues += __builtin_popcountll(word);
+    const auto firstRow = index * 64;
+    for (auto offset = 0; offset < 64; offset += kBatchSize) {
+      const auto lanes = (word >> offset) & bits::lowMask(kBatchSize);
+      const auto row = firstRow + offset;
+      if (!lanes) {
+        continue;
+      }
+      if (row + kBatchSize > end) {
+        // A load would read past the last row. This is at most the last
+        // batch.
+        bits::forEachSetBit(&lanes, 0, kBatchSize, [&](auto lane) {
+          result = op(result, static_cast<TResult>(data[row + lane]));
+        });
+        continue;
+      }
+      auto values = Batch::load_unaligned(data + row);
+      if (lanes != bits::lowMask(kBatchSize)) {
+        values = xsimd::select(
+            simd::fromBitMask<TResult>(lanes), values, identityBatch);
+      }
+      batch = op(batch, values);
+    }
+  };
+
+  bits::forEachWord(
+      rows.begin(),
+      end,
+      [&](int32_t index, uint64_t mask) {
+        foldWord(
+            index, selected[index] & mask & (nulls ? nulls[index] : ~0ULL));
+      },
+      [&](int32_t index) {
+        foldWord(index, selected[index] & (nulls ? nulls[index] : ~0ULL));
+      });
+
+  alignas(Batch::arch_type::alignment()) TResult laneValues[kBatchSize];
+  batch.store_aligned(laneValues);
+  for (auto i = 0; i < kBatchSize; ++i) {
+    result = op(result, laneValues[i]);
+  }
+  return result;
+}
+
+// Folds the values of 'data' at the selected non-null rows into 'partials'
+// by group number. Consecutive rows go to different copies of the
+// accumulators, so that rows of the same group do not wait for each other's
+// update. 'numGroups' must be at most kMaxGroups. Calls 'update(group,
+// partial)' once for each group that got a value, with the values of the
+// group folded with 'op'.
+template <typename TResult, typename TInput, typename Op, typename Update>
+void reduceByLanes(
+    const TInput* data,
+    const uint32_t* groupNumbers,
+    const SelectivityVector& rows,
+    const uint64_t* nulls,
+    int32_t numGroups,
+    TResult identity,
+    Op op,
+    Update update) {
+  constexpr int32_t kLanes = 4;
+  constexpr int32_t kMaxGroups = 256;
+  VELOX_DCHECK_LE(numGroups, kMaxGroups);
+  TResult partials[kLanes][kMaxGroups];
+  uint64_t hasValue[bits::nwords(kMaxGroups)] = {};
+  for (auto lane = 0; lane < kLanes; ++lane) {
+    std::fill(partials[lane], partials[lane] + numGroups, identity);
+  }
+  rows.applyToSelected([&](vector_size_t row) {
+    if (nulls && bits::isBitNull(nulls, row)) {
+      return;
+    }
+    const auto group = groupNumbers[row];
+    auto& partial = partials[row & (kLanes - 1)][group];
+    partial = op(partial, static_cast<TResult>(data[row]));
+    bits::setBit(hasValue, group);
+  });
+  bits::forEachSetBit(hasValue, 0, numGroups, [&](auto group) {
+    auto result = partials[0][group];
+    for (auto lane = 1; lane < kLanes; ++lane) {
+      result = op(result, partials[lane][group]);
+    }
+    update(group, result);
+  });
+}
+
+} // namespace facebook::velox::aggregate
@@ -17,6 +17,7 @@
 
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/AggregationHook.h"
+#include "velox/functions/prestosql/aggregates/SimdReductions.h"
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/LazyVector.h"
@@ -31,6 +32,10 @@ class SimpleNumericAggregate : public exec::Aggregate {
  public:
   void finalize(char** /* unused */, int32_t /* unused */) override {}
 
+  bool supportsRelocation() const override {
+    return true;
+  }
+
   void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
       override {
     extractValues(groups, numGroups, result);
@@ -125,6 +130,41 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
   }
 
+  // Updates the columnar accumulators of the groups in 'groupNumbers'. The
+  // accumulators are in one array, so that no group row is accessed.
+  template <typename TData = TAccumulator, typename UpdateSingleValue>
+  void updateColumnarGroups(
+      const uint32_t* groupNumbers,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      UpdateSingleValue updateSingleValue) {
+    DecodedVector decoded(*arg, rows);
+    auto* values = exec::Aggregate::template columnarValues<TData>();
+    auto update = [&](vector_size_t i, TInput value) INLINE_LAMBDA {
+      auto groupNumber = groupNumbers[i];
+      exec::Aggregate::clearColumnarNull(groupNumber);
+      updateSingleValue(values[groupNumber], value);
+    };
+    if (decoded.isConstantMapping()) {
+      if (!decoded.isNullAt(0)) {
+        auto value = decoded.valueAt<TInput>(0);
+        rows.applyToSelected([&](vector_size_t i) { update(i, value); });
+      }
+    } else if (decoded.mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decoded.isNullAt(i)) {
+          update(i, decoded.valueAt<TInput>(i));
+        }
+      });
+    } else if (decoded.isIdentityMapping() && !std::is_same_v<TInput, bool>) {
+      auto data = decoded.data<TInput>();
+      rows.applyToSelected([&](vector_size_t i) { update(i, data[i]); });
+    } else {
+      rows.applyToSelected(
+          [&](vector_size_t i) { update(i, decoded.valueAt<TInput>(i)); });
+    }
+  }
+
   // TData is either TAccumulator or TResult, which in most cases are the same,
   // but for sum(real) can differ.
   template <
@@ -169,6 +209,74 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
   }
 
+  // Folds the values of 'arg' at 'rows' into the accumulator of 'group' with
+  // 'op' in SIMD batches. Returns false without updating 'group' if 'arg' is
+  // not flat or TInput can not be reduced to TData this way. 'identity' is
+  // as in simdReduce().
+  template <typename TData, typename Op>
+  bool simdUpdateOneGroup(
+      char* group,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      TData identity,
+      Op op) {
+    if constexpr (!kSimdReducible<TInput, TData>) {
+      return false;
+    } else {
+      if (arg->encoding() != VectorEncoding::Simple::FLAT) {
+        return false;
+      }
+      vector_size_t numValues;
+      const auto result = simdReduce(
+          arg->asUnchecked<FlatVector<TInput>>()->rawValues(),
+          rows,
+          arg->rawNulls(),
+          identity,
+          op,
+          numValues);
+      if (numValues) {
+        exec::Aggregate::clearNull(group);
+        auto* value = exec::Aggregate::value<TData>(group);
+        *value = op(*value, result);
+      }
+      return true;
+    }
+  }
+
+  // Same as updateColumnarGroups() for a flat 'arg' and at most 256 groups.
+  // The rows are folded into per-lane partial accumulators with 'op' first.
+  // Returns false without updating if the conditions are not met.
+  template <typename TData, typename Op>
+  bool updateFewColumnarGroups(
+      const uint32_t* groupNumbers,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      TData identity,
+      Op op) {
+    if constexpr (!kSimdReducible<TInput, TData>) {
+      return false;
+    } else {
+      const auto numGroups = exec::Aggregate::numColumnarGroups();
+      if (numGroups > 256 || arg->encoding() != VectorEncoding::Simple::FLAT) {
+        return false;
+      }
+      auto* values = exec::Aggregate::template columnarValues<TData>();
+      reduceByLanes(
+          arg->asUnchecked<FlatVector<TInput>>()->rawValues(),
+          groupNumbers,
+          rows,
+          arg->rawNulls(),
+          numGroups,
+          identity,
+          op,
+          [&](uint32_t groupNumber, TData partial) {
+            exec::Aggregate::clearColumnarNull(groupNumber);
+            values[groupNumber] = op(values[groupNumber], partial);
+          });
+      return true;
+    }
+  }
+
   template <typename THook>
   void
   pushdown(char** groups, const SelectivityVector& rows, const VectorPtr& arg) {
@@ -38,6 +38,13 @@ struct SingleValueAccumulator {
 
   void destroy(HashStringAllocator* allocator);
 
+  // Updates the pointer to the value after HashStringAllocator::compact().
+  void relocate(const HashStringAllocator::Relocation& relocation) {
+    if (begin_) {
+      begin_ = relocation.newHeader(begin_);
+    }
+  }
+
  private:
   static constexpr int kInitialBytes{20};
 
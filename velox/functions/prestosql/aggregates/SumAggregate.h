@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/expression/FunctionSignature.h"
+#include "velox/functions/prestosql/aggregates/DecimalAggregates.h"
 #include "velox/functions/prestosql/aggregates/SimpleNumericAggregate.h"
 
 namespace facebook::velox::aggregate {
@@ -33,6 +34,10 @@ class SumAggregate
     return sizeof(TAccumulator);
   }
 
+  bool supportsColumnar() const override {
+    return true;
+  }
+
   void initializeNewGroups(
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
@@ -66,6 +71,21 @@ class SumAggregate
     updateInternal<TAccumulator>(groups, rows, args, mayPushdown);
   }
 
+  void addRawInputColumnar(
+      const uint32_t* groupNumbers,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if (BaseAggregate::template updateFewColumnarGroups<TAccumulator>(
+            groupNumbers, rows, args[0], 0, SimdSum())) {
+      return;
+    }
+    BaseAggregate::template updateColumnarGroups<TAccumulator>(
+        groupNumbers,
+        rows,
+        args[0],
+        [](TAccumulator& result, TInput value) { result += value; });
+  }
+
   void addIntermediateResults(
       char** groups,
       const SelectivityVector& rows,
@@ -79,6 +99,10 @@ class SumAggregate
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
+    if (BaseAggregate::template simdUpdateOneGroup<TAccumulator>(
+            group, rows, args[0], 0, SimdSum())) {
+      return;
+    }
     BaseAggregate::template updateOneGroup<TAccumulator>(
         group,
         rows,
@@ -161,6 +185,14 @@ bool registerSumAggregate(const std::string& name) {
                              .argumentType(inputType)
                              .build());
   }
+  // decimal(p, s) -> decimal(38, s)
+  signatures.push_back(exec::AggregateFunctionSignatureBuilder()
+                           .returnType("DECIMAL(r_precision, r_scale)")
+                           .intermediateType("DECIMAL(r_precision, r_scale)")
+                           .argumentType("DECIMAL(a_precision, a_scale)")
+                           .variableConstraint("r_precision", "38")
+                           .variableConstraint("r_scale", "a_scale")
+                           .build());
 
   return exec::registerAggregateFunction(
       name,
@@ -190,6 +222,12 @@ bool registerSumAggregate(const std::string& name) {
               return std::make_unique<T<double, double, float>>(resultType);
             }
             return std::make_unique<T<double, double, double>>(DOUBLE());
+          case TypeKind::SHORT_DECIMAL:
+            return std::make_unique<DecimalSumAggregate<ShortDecimal>>(
+                resultType);
+          case TypeKind::LONG_DECIMAL:
+            return std::make_unique<DecimalSumAggregate<LongDecimal>>(
+                resultType);
           default:
             VELOX_CHECK(
                 false,
@@ -67,6 +67,19 @@ class ValueList {
     }
   }
 
+  // Updates the pointers to the 'data' and 'nulls' allocations after
+  // HashStringAllocator::compact().
+  void relocate(const HashStringAllocator::Relocation& relocation) {
+    if (nullsBegin_) {
+      nullsBegin_ = relocation.newHeader(nullsBegin_);
+      relocation.update(nullsCurrent_);
+    }
+    if (dataBegin_) {
+      dataBegin_ = relocation.newHeader(dataBegin_);
+      relocation.update(dataCurrent_);
+    }
+  }
+
  private:
   // An array_agg or related begins with an allocation of 5 words and
   // 4 bytes for header. This is compact for small arrays (up to 5
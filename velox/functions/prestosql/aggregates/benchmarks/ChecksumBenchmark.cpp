@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <fmt/format.h>
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/functions/prestosql/aggregates/PrestoHasher.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+DEFINE_int64(fuzzer_seed, 99887766, "Seed for random input dataset generator");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+// Measures PrestoHasher and the checksum aggregate over flat primitives and
+// over a wide row of nested columns, the shape of tables checksummed for
+// data validation. The hash* cases hash one column of 10K rows per
+// iteration. The checksum* cases run a global checksum over 100 batches.
+namespace {
+
+constexpr int32_t kNumVectors = 100;
+constexpr int32_t kRowsPerVector = 10'000;
+
+class ChecksumBenchmark {
+ public:
+  ChecksumBenchmark() {
+    VectorFuzzer::Options opts;
+    opts.vectorSize = kRowsPerVector;
+    opts.nullRatio = 0.1;
+    opts.containerLength = 5;
+    opts.stringLength = 20;
+    VectorFuzzer fuzzer(opts, pool_.get(), FLAGS_fuzzer_seed);
+
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    const std::vector<TypePtr> nestedTypes{
+        BIGINT(),
+        VARCHAR(),
+        ARRAY(BIGINT()),
+        MAP(VARCHAR(), DOUBLE()),
+        ROW({INTEGER(), ARRAY(VARCHAR())})};
+    // 20 columns.
+    for (auto i = 0; i < 4 * nestedTypes.size(); ++i) {
+      names.push_back(fmt::format("c{}", i));
+      types.push_back(nestedTypes[i % nestedTypes.size()]);
+    }
+    wideType_ = ROW(std::move(names), std::move(types));
+    for (auto i = 0; i < kNumVectors; ++i) {
+      wideBatches_.push_back(fuzzer.fuzzRow(wideType_));
+    }
+
+    opts.nullRatio = 0;
+    fuzzer.setOptions(opts);
+    bigintBatches_.push_back(fuzzer.fuzzRow(ROW({"c0"}, {BIGINT()})));
+  }
+
+  // Hashes 'vector' 'iters' times. Returns the number of rows.
+  unsigned hash(unsigned iters, const VectorPtr& vector) {
+    folly::BenchmarkSuspender suspender;
+    aggregate::PrestoHasher hasher(vector->type());
+    SelectivityVector rows(vector->size());
+    auto hashes = AlignedBuffer::allocate<int64_t>(rows.size(), pool_.get());
+    suspender.dismiss();
+    for (auto i = 0; i < iters; ++i) {
+      hasher.hash(vector, rows, hashes);
+    }
+    return iters * rows.size();
+  }
+
+  unsigned hashBigint(unsigned iters) {
+    return hash(iters, bigintBatches_[0]->childAt(0));
+  }
+
+  unsigned hashWideRow(unsigned iters) {
+    return hash(iters, wideBatches_[0]);
+  }
+
+  // Runs checksum() over 'batches' as one row column. Returns the number
+  // of rows.
+  unsigned checksum(const std::vector<RowVectorPtr>& batches) {
+    folly::BenchmarkSuspender suspender;
+    std::vector<RowVectorPtr> input;
+    for (auto& batch : batches) {
+      input.push_back(std::make_shared<RowVector>(
+          pool_.get(),
+          ROW({"c0"}, {batch->type()}),
+          nullptr,
+          batch->size(),
+          std::vector<VectorPtr>{batch}));
+    }
+    CursorParameters params;
+    params.planNode = PlanBuilder()
+                          .values(input)
+                          .partialAggregation({}, {"checksum(c0)"})
+                          .finalAggregation()
+                          .planNode();
+    suspender.dismiss();
+    folly::doNotOptimizeAway(readCursor(params, [](auto*) {}).second);
+    return batches.size() * kRowsPerVector;
+  }
+
+  unsigned checksumWideRow() {
+    return checksum(wideBatches_);
+  }
+
+ private:
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  RowTypePtr wideType_;
+  std::vector<RowVectorPtr> wideBatches_;
+  std::vector<RowVectorPtr> bigintBatches_;
+};
+
+std::unique_ptr<ChecksumBenchmark> benchmark;
+
+BENCHMARK_MULTI(hashBigint, n) {
+  return benchmark->hashBigint(n);
+}
+
+BENCHMARK_MULTI(hashWideRow, n) {
+  return benchmark->hashWideRow(n);
+}
+
+BENCHMARK_MULTI(checksumWideRow) {
+  return benchmark->checksumWideRow();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<ChecksumBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -113,17 +113,25 @@ class SimpleAggregatesBenchmark : public HiveConnectorTestBase {
 
   void TestBody() override {}
 
-  void run(const std::string& key, const std::string& aggregate) {
+  // Aggregates by 'key' or globally if 'key' is empty.
+  void run(
+      const std::string& key,
+      const std::string& aggregate,
+      bool columnar = false) {
     folly::BenchmarkSuspender suspender;
 
+    std::vector<std::string> keys;
+    if (!key.empty()) {
+      keys.push_back(key);
+    }
     auto plan = PlanBuilder()
                     .tableScan(inputType_)
-                    .partialAggregation({key}, {aggregate})
+                    .partialAggregation(keys, {aggregate})
                     .finalAggregation()
                     .planFragment();
 
     vector_size_t numResultRows = 0;
-    auto task = makeTask(plan, numResultRows);
+    auto task = makeTask(plan, numResultRows, columnar);
 
     task->addSplit("0", exec::Split(makeHiveConnectorSplit(filePath_->path)));
     task->noMoreSplits("0");
@@ -140,12 +148,17 @@ class SimpleAggregatesBenchmark : public HiveConnectorTestBase {
 
   std::shared_ptr<exec::Task> makeTask(
       core::PlanFragment plan,
-      vector_size_t& numResultRows) {
+      vector_size_t& numResultRows,
+      bool columnar) {
+    std::unordered_map<std::string, std::string> config{
+        {core::QueryConfig::kAggregationColumnarAccumulators,
+         columnar ? "true" : "false"}};
     return std::make_shared<exec::Task>(
         "t",
         std::move(plan),
         0,
-        core::QueryCtx::createForTest(),
+        core::QueryCtx::createForTest(
+            std::make_shared<core::MemConfig>(std::move(config))),
         [&](auto vector, auto* /*future*/) {
           if (vector) {
             numResultRows += vector->size();
@@ -165,6 +178,37 @@ void doRun(uint32_t, const std::string& key, const std::string& aggregate) {
   benchmark->run(key, aggregate);
 }
 
+void doRunColumnar(
+    uint32_t,
+    const std::string& key,
+    const std::string& aggregate) {
+  benchmark->run(key, aggregate, true);
+}
+
+// Compares accumulators in the group rows to columnar accumulators.
+#define COLUMNAR_BENCHMARKS(_name_, _key_)                        \
+  BENCHMARK_NAMED_PARAM(                                          \
+      doRun,                                                      \
+      _name_##_BIGINT_row_##_key_,                                \
+      #_key_,                                                     \
+      fmt::format("{}(i64)", (#_name_)));                         \
+  BENCHMARK_RELATIVE_NAMED_PARAM(                                 \
+      doRunColumnar,                                              \
+      _name_##_BIGINT_columnar_##_key_,                           \
+      #_key_,                                                     \
+      fmt::format("{}(i64)", (#_name_)));                         \
+  BENCHMARK_NAMED_PARAM(                                          \
+      doRun,                                                      \
+      _name_##_DOUBLE_NULLS_row_##_key_,                          \
+      #_key_,                                                     \
+      fmt::format("{}(f64_halfnull)", (#_name_)));                \
+  BENCHMARK_RELATIVE_NAMED_PARAM(                                 \
+      doRunColumnar,                                              \
+      _name_##_DOUBLE_NULLS_columnar_##_key_,                     \
+      #_key_,                                                     \
+      fmt::format("{}(f64_halfnull)", (#_name_)));                \
+  BENCHMARK_DRAW_LINE();
+
 #define AGG_BENCHMARKS(_name_, _key_)              \
   BENCHMARK_NAMED_PARAM(                           \
       doRun,                                       \
@@ -210,6 +254,40 @@ void doRun(uint32_t, const std::string& key, const std::string& aggregate) {
   BENCHMARK_DRAW_LINE();                           \
   BENCHMARK_DRAW_LINE();
 
+// Global aggregation over inputs without and with nulls.
+#define GLOBAL_BENCHMARKS(_name_)                  \
+  BENCHMARK_NAMED_PARAM(                           \
+      doRun,                                       \
+      _name_##_INTEGER_global,                     \
+      "",                                          \
+      fmt::format("{}(i32)", (#_name_)));          \
+  BENCHMARK_NAMED_PARAM(                           \
+      doRun,                                       \
+      _name_##_BIGINT_global,                      \
+      "",                                          \
+      fmt::format("{}(i64)", (#_name_)));          \
+  BENCHMARK_NAMED_PARAM(                           \
+      doRun,                                       \
+      _name_##_DOUBLE_global,                      \
+      "",                                          \
+      fmt::format("{}(f64)", (#_name_)));          \
+  BENCHMARK_NAMED_PARAM(                           \
+      doRun,                                       \
+      _name_##_INTEGER_NULLS_global,               \
+      "",                                          \
+      fmt::format("{}(i32_halfnull)", (#_name_))); \
+  BENCHMARK_NAMED_PARAM(                           \
+      doRun,                                       \
+      _name_##_BIGINT_NULLS_global,                \
+      "",                                          \
+      fmt::format("{}(i64_halfnull)", (#_name_))); \
+  BENCHMARK_NAMED_PARAM(                           \
+      doRun,                                       \
+      _name_##_DOUBLE_NULLS_global,                \
+      "",                                          \
+      fmt::format("{}(f64_halfnull)", (#_name_))); \
+  BENCHMARK_DRAW_LINE();
+
 // Count(1) aggregate.
 BENCHMARK_NAMED_PARAM(doRun, count_k_array, "k_array", "count(1)");
 BENCHMARK_NAMED_PARAM(doRun, count_k_norm, "k_norm", "count(1)");
@@ -252,6 +330,24 @@ AGG_BENCHMARKS(stddev, k_norm)
 AGG_BENCHMARKS(stddev, k_hash)
 BENCHMARK_DRAW_LINE();
 
+// Global aggregates.
+GLOBAL_BENCHMARKS(sum)
+GLOBAL_BENCHMARKS(avg)
+GLOBAL_BENCHMARKS(min)
+GLOBAL_BENCHMARKS(max)
+BENCHMARK_DRAW_LINE();
+
+// Columnar accumulators. k_array has few enough groups for the per-lane
+// partial accumulators.
+COLUMNAR_BENCHMARKS(sum, k_array)
+COLUMNAR_BENCHMARKS(min, k_array)
+COLUMNAR_BENCHMARKS(max, k_array)
+COLUMNAR_BENCHMARKS(sum, k_norm)
+COLUMNAR_BENCHMARKS(sum, k_hash)
+COLUMNAR_BENCHMARKS(min, k_hash)
+COLUMNAR_BENCHMARKS(max, k_hash)
+BENCHMARK_DRAW_LINE();
+
 } // namespace
 
 int main(int argc, char** argv) {
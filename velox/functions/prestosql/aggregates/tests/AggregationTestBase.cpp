@@ -108,6 +108,52 @@ int64_t spilledBytes(const exec::Task& task) {
 }
 } // namespace
 
+void AggregationTestBase::testAggregationsWithoutDuckDb(
+    const std::vector<RowVectorPtr>& data,
+    const std::vector<std::string>& groupingKeys,
+    const std::vector<std::string>& aggregates,
+    const RowVectorPtr& expectedRows) {
+  auto assertRows = [&](const core::PlanNodePtr& plan) {
+    auto result = AssertQueryBuilder(plan).copyResults(pool());
+    ASSERT_EQ(result->size(), expectedRows->size());
+    std::vector<bool> matched(expectedRows->size(), false);
+    for (auto i = 0; i < result->size(); ++i) {
+      bool found = false;
+      for (auto j = 0; j < expectedRows->size() && !found; ++j) {
+        if (!matched[j] && result->equalValueAt(expectedRows.get(), i, j)) {
+          matched[j] = true;
+          found = true;
+        }
+      }
+      EXPECT_TRUE(found) << "Unexpected row " << result->toString(i);
+    }
+  };
+  {
+    SCOPED_TRACE("Run single");
+    assertRows(PlanBuilder()
+                   .values(data)
+                   .singleAggregation(groupingKeys, aggregates)
+                   .planNode());
+  }
+  {
+    SCOPED_TRACE("Run partial + final");
+    assertRows(PlanBuilder()
+                   .values(data)
+                   .partialAggregation(groupingKeys, aggregates)
+                   .finalAggregation()
+                   .planNode());
+  }
+  {
+    SCOPED_TRACE("Run partial + intermediate + final");
+    assertRows(PlanBuilder()
+                   .values(data)
+                   .partialAggregation(groupingKeys, aggregates)
+                   .intermediateAggregation()
+                   .finalAggregation()
+                   .planNode());
+  }
+}
+
 void AggregationTestBase::testAggregations(
     std::function<void(PlanBuilder&)> makeSource,
     const std::vector<std::string>& groupingKeys,
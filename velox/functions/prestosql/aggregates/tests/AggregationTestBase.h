@@ -99,6 +99,16 @@ class AggregationTestBase : public exec::test::OperatorTestBase {
       const std::vector<std::string>& aggregates,
       const std::vector<RowVectorPtr>& expectedResult);
 
+  /// Runs single, partial -> final and partial -> intermediate -> final
+  /// aggregations over 'data' and checks that the result rows are
+  /// 'expectedRows' in any order. For result types that the comparison with
+  /// DuckDB does not cover, e.g. decimals.
+  void testAggregationsWithoutDuckDb(
+      const std::vector<RowVectorPtr>& data,
+      const std::vector<std::string>& groupingKeys,
+      const std::vector<std::string>& aggregates,
+      const RowVectorPtr& expectedRows);
+
   // Turns off spill test. Use if the test has only one batch of input.
   void disableSpill() {
     noSpill_ = true;
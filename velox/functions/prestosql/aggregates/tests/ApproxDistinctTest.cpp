@@ -267,6 +267,42 @@ TEST_F(ApproxDistinctTest, globalAggIntegersWithError) {
   testGlobalAgg(values, 0.2, 930);
 }
 
+TEST_F(ApproxDistinctTest, merge) {
+  // Sparse sketches that merge into a dense one and dense sketches.
+  for (auto size : {1'000, 100'000}) {
+    auto data = makeRowVector(
+        {makeFlatVector<int32_t>(size, [](auto row) { return row % 10; }),
+         makeFlatVector<int32_t>(size, [](auto row) { return row; })});
+    for (const auto& error : {"", ", 0.01"}) {
+      auto op = PlanBuilder()
+                    .values({data})
+                    .singleAggregation(
+                        {}, {fmt::format("approx_distinct(c1{})", error)})
+                    .planNode();
+      auto expected = readSingleValue(op);
+
+      op = PlanBuilder()
+               .values({data})
+               .singleAggregation(
+                   {"c0"}, {fmt::format("approx_set(c1{})", error)})
+               .singleAggregation({}, {"merge(a0)"})
+               .project({"cardinality(a0)"})
+               .planNode();
+      EXPECT_EQ(readSingleValue(op), expected);
+
+      op = PlanBuilder()
+               .values({data})
+               .singleAggregation(
+                   {"c0"}, {fmt::format("approx_set(c1{})", error)})
+               .partialAggregation({}, {"merge(a0)"})
+               .finalAggregation()
+               .project({"cardinality(a0)"})
+               .planNode();
+      EXPECT_EQ(readSingleValue(op), expected);
+    }
+  }
+}
+
 TEST_F(ApproxDistinctTest, globalAggAllNulls) {
   vector_size_t size = 1'000;
   auto values = makeFlatVector<int32_t>(
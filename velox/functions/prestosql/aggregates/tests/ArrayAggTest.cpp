@@ -136,6 +136,35 @@ TEST_F(ArrayAggTest, global) {
   ASSERT_EQ(velox::variant::array(expected), value);
 }
 
+TEST_F(ArrayAggTest, groupByWithSpill) {
+  // Several batches, so that there are groups to spill before the last one.
+  // The arrays are sorted since spilling changes the order of the elements.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 4; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int32_t>(
+             100, [](vector_size_t row) { return row % 10; }),
+         makeFlatVector<int64_t>(
+             100, [i](vector_size_t row) { return 100 * i + row; })}));
+  }
+
+  auto expectedResult = {makeRowVector(
+      {makeFlatVector<int32_t>(10, [](vector_size_t row) { return row; }),
+       makeArrayVector<int64_t>(
+           10,
+           [](vector_size_t /*row*/) { return 40; },
+           [](vector_size_t row, vector_size_t index) {
+             return 100 * (index / 10) + row + 10 * (index % 10);
+           })})};
+
+  testAggregations(
+      vectors,
+      {"c0"},
+      {"array_agg(c1)"},
+      {"c0", "array_sort(a0)"},
+      expectedResult);
+}
+
 TEST_F(ArrayAggTest, globalNoData) {
   std::vector<RowVectorPtr> vectors = {
       vectorMaker_.rowVector(ROW({"c0"}, {INTEGER()}), 0)};
@@ -15,6 +15,7 @@
  */
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/functions/prestosql/aggregates/tests/AggregationTestBase.h"
+#include "velox/type/DecimalUtil.h"
 
 using namespace facebook::velox::exec::test;
 
@@ -288,6 +289,33 @@ TEST_F(AverageAggregationTest, avg) {
   }
 }
 
+// avg(decimal(p, s)) is a decimal(p, s) rounded half away from zero.
+TEST_F(AverageAggregationTest, decimal) {
+  // Group 0 averages 0.05 and -0.05 to 0.00, group 1 averages 1.00, 2.00
+  // and null to 1.50.
+  auto data = makeRowVector(
+      {makeFlatVector<int32_t>({0, 0, 1, 1, 1}),
+       makeDecimalFlatVector({5, -5, 100, 200, std::nullopt}, DECIMAL(10, 2)),
+       makeDecimalFlatVector(
+           {DecimalUtil::kPowersOfTen[25], 0, 1, 2, 4}, DECIMAL(30, 0))});
+  testAggregationsWithoutDuckDb(
+      {data, data},
+      {"c0"},
+      {"avg(c1)", "avg(c2)"},
+      makeRowVector(
+          {makeFlatVector<int32_t>({0, 1}),
+           makeDecimalFlatVector({0, 150}, DECIMAL(10, 2)),
+           makeDecimalFlatVector(
+               {DecimalUtil::kPowersOfTen[25] / 2, 2}, DECIMAL(30, 0))}));
+
+  // 1 + 0.05 - 0.05 + 1.00 + 2.00 for the global average of c1: 3.10 / 4.
+  testAggregationsWithoutDuckDb(
+      {data},
+      {},
+      {"avg(c1)"},
+      makeRowVector({makeDecimalFlatVector({75}, DECIMAL(10, 2))}));
+}
+
 TEST_F(AverageAggregationTest, partialResults) {
   auto data = makeRowVector(
       {makeFlatVector<int64_t>(100, [](auto row) { return row; })});
@@ -218,5 +218,26 @@ TEST_F(HistogramTest, globalGroupByEmpty) {
   testGlobalHistogramWithDuck(vector);
 }
 
+TEST_F(HistogramTest, groupByWithSpill) {
+  // Several batches, so that there are groups to spill before the last one.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 4; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int32_t>(
+             100, [](vector_size_t row) { return row % 7; }),
+         makeFlatVector<int64_t>(
+             100,
+             [i](vector_size_t row) { return (row + i) % 13; },
+             nullEvery(5))}));
+  }
+  createDuckDbTable(vectors);
+  noSpill_ = false;
+  testAggregations(
+      vectors,
+      {"c0"},
+      {"histogram(c1)"},
+      "SELECT c0, histogram(c1) FROM tmp GROUP BY c0");
+}
+
 } // namespace
 } // namespace facebook::velox::aggregate::test
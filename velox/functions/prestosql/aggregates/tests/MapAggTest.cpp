@@ -174,5 +174,36 @@ TEST_F(MapAggTest, globalDuplicateKeys) {
   testAggregations(vectors, {}, {"map_agg(c0, c1)"}, expectedResult);
 }
 
+TEST_F(MapAggTest, groupByWithSpill) {
+  // Several batches, so that there are groups to spill before the last one.
+  // Group k gets the distinct keys 50 * i + k + 5 * j of batch i.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 4; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int32_t>(50, [](vector_size_t row) { return row % 5; }),
+         makeFlatVector<int32_t>(
+             50, [i](vector_size_t row) { return 50 * i + row; }),
+         makeFlatVector<double>(
+             50, [i](vector_size_t row) { return 50 * i + row + 0.05; })}));
+  }
+
+  auto key = [](vector_size_t index) {
+    auto group = index / 40;
+    auto i = index % 40 / 10;
+    auto j = index % 10;
+    return 50 * i + group + 5 * j;
+  };
+  auto expectedResult = {makeRowVector(
+      {makeFlatVector<int32_t>(5, [](vector_size_t row) { return row; }),
+       makeMapVector<int32_t, double>(
+           5,
+           [](vector_size_t /*row*/) { return 40; },
+           key,
+           [&](vector_size_t index) { return key(index) + 0.05; })})};
+
+  noSpill_ = false;
+  testAggregations(vectors, {"c0"}, {"map_agg(c1, c2)"}, expectedResult);
+}
+
 } // namespace
 } // namespace facebook::velox::aggregate::test
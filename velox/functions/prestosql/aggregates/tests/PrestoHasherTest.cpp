@@ -311,6 +311,45 @@ TEST_F(PrestoHasherTest, rows) {
   assertHash(row, {7113531408683827503, -1169223928725763049});
 }
 
+TEST_F(PrestoHasherTest, reuseAcrossBatches) {
+  // A hasher keeps the buffers for the hashes of nested values between
+  // calls. A large batch followed by a small one must give the same hashes
+  // as a new hasher.
+  auto makeBatch = [&](vector_size_t size) {
+    return makeRowVector(
+        {makeArrayVector<int64_t>(
+             size,
+             [](auto row) { return row % 5; },
+             [](auto row) { return row; }),
+         makeMapVector<int64_t, double>(
+             size,
+             [](auto row) { return row % 3; },
+             [](auto row) { return row; },
+             [](auto row) { return row * 0.5; })});
+  };
+  auto large = makeBatch(1'000);
+  auto small = makeBatch(10);
+
+  auto hashAll = [&](PrestoHasher& hasher, const VectorPtr& vector) {
+    SelectivityVector rows(vector->size());
+    auto hashes = AlignedBuffer::allocate<int64_t>(rows.size(), pool());
+    hasher.hash(vector, rows, hashes);
+    auto rawHashes = hashes->as<int64_t>();
+    return std::vector<int64_t>(rawHashes, rawHashes + rows.size());
+  };
+
+  PrestoHasher hasher(large->type());
+  auto largeHashes = hashAll(hasher, large);
+  auto smallHashes = hashAll(hasher, small);
+  PrestoHasher newHasher(small->type());
+  EXPECT_EQ(hashAll(newHasher, small), smallHashes);
+  EXPECT_EQ(hashAll(hasher, large), largeHashes);
+  // The first 10 rows of both batches are the same.
+  for (auto i = 0; i < smallHashes.size(); ++i) {
+    EXPECT_EQ(largeHashes[i], smallHashes[i]) << "at " << i;
+  }
+}
+
 TEST_F(PrestoHasherTest, wrongVectorType) {
   PrestoHasher hasher(ARRAY(BIGINT()));
   auto vector = makeNullableFlatVector<StringView>({"abc"_sv});
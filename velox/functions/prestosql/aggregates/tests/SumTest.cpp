@@ -13,10 +13,14 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/exec/AggregationHook.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/functions/prestosql/aggregates/tests/AggregationTestBase.h"
+#include "velox/type/DecimalUtil.h"
 
+using facebook::velox::exec::test::AssertQueryBuilder;
 using facebook::velox::exec::test::PlanBuilder;
 
 namespace facebook::velox::aggregate::test {
@@ -247,6 +251,128 @@ TEST_F(SumTest, nulls) {
   assertQuery(plan, "SELECT a, sum(b) as sum_b FROM tmp GROUP BY 1");
 }
 
+// Global and columnar grouped aggregations over flat inputs take the SIMD
+// paths. The vector size is not a multiple of the batch size.
+TEST_F(SumTest, flatInputs) {
+  std::vector<RowVectorPtr> data;
+  for (auto i = 0; i < 5; ++i) {
+    data.push_back(makeRowVector({
+        makeFlatVector<int32_t>(1'003, [](auto row) { return row % 17; }),
+        makeFlatVector<int32_t>(
+            1'003,
+            [i](auto row) { return (row * 7'919 + i) % 10'007 - 5'000; }),
+        makeFlatVector<int64_t>(
+            1'003,
+            [i](auto row) { return (row + i) * 1'000'003; },
+            [](auto row) { return row % 5 == 0 || row % 67 == 1; }),
+        makeFlatVector<double>(
+            1'003, [](auto row) { return row * 0.25; }, nullEvery(3)),
+        makeFlatVector<bool>(1'003, [](auto row) { return row % 11 < 4; }),
+    }));
+  }
+  createDuckDbTable(data);
+
+  const std::vector<std::string> aggregates = {
+      "sum(c1)",
+      "sum(c2)",
+      "sum(c3)",
+      "min(c1)",
+      "max(c1)",
+      "min(c2)",
+      "max(c2)",
+      "avg(c1)",
+      "avg(c3)"};
+  const std::string projections =
+      "sum(c1), sum(c2), sum(c3), min(c1), max(c1), min(c2), max(c2), "
+      "avg(c1), avg(c3)";
+
+  auto plan = PlanBuilder()
+                  .values(data)
+                  .partialAggregation({}, aggregates)
+                  .finalAggregation()
+                  .planNode();
+  assertQuery(plan, fmt::format("SELECT {} FROM tmp", projections));
+
+  // The mask leaves partially selected words.
+  plan = PlanBuilder()
+             .values(data)
+             .partialAggregation(
+                 {},
+                 {"sum(c2)", "min(c1)", "max(c2)", "avg(c3)"},
+                 {"c4", "c4", "c4", "c4"})
+             .finalAggregation()
+             .planNode();
+  assertQuery(
+      plan,
+      "SELECT sum(c2) filter (where c4), min(c1) filter (where c4), "
+      "max(c2) filter (where c4), avg(c3) filter (where c4) FROM tmp");
+
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(core::QueryConfig::kAggregationColumnarAccumulators, "true")
+      .plan(PlanBuilder()
+                .values(data)
+                .singleAggregation(
+                    {"c0"}, {"sum(c1)", "sum(c2)", "min(c2)", "max(c1)"})
+                .planNode())
+      .assertResults(
+          "SELECT c0, sum(c1), sum(c2), min(c2), max(c1) FROM tmp GROUP BY 1");
+}
+
+// sum(decimal(p, s)) is a decimal(38, s) of the exact sum.
+TEST_F(SumTest, decimal) {
+  constexpr int32_t kSize = 1'000;
+  std::vector<std::optional<int128_t>> shortValues;
+  std::vector<std::optional<int128_t>> longValues;
+  int128_t shortSums[2] = {0, 0};
+  int128_t longSums[2] = {0, 0};
+  for (auto i = 0; i < kSize; ++i) {
+    if (i % 7 == 0) {
+      shortValues.push_back(std::nullopt);
+    } else {
+      shortValues.push_back(i * 100 - 30'000);
+      shortSums[i % 2] += i * 100 - 30'000;
+    }
+    longValues.push_back(DecimalUtil::kPowersOfTen[30] + i);
+    longSums[i % 2] += DecimalUtil::kPowersOfTen[30] + i;
+  }
+  auto data = makeRowVector(
+      {makeFlatVector<int32_t>(kSize, [](auto row) { return row % 2; }),
+       makeDecimalFlatVector(shortValues, DECIMAL(10, 2)),
+       makeDecimalFlatVector(longValues, DECIMAL(32, 1))});
+
+  testAggregationsWithoutDuckDb(
+      {data, data},
+      {"c0"},
+      {"sum(c1)", "sum(c2)"},
+      makeRowVector(
+          {makeFlatVector<int32_t>({0, 1}),
+           makeDecimalFlatVector(
+               {2 * shortSums[0], 2 * shortSums[1]}, DECIMAL(38, 2)),
+           makeDecimalFlatVector(
+               {2 * longSums[0], 2 * longSums[1]}, DECIMAL(38, 1))}));
+  testAggregationsWithoutDuckDb(
+      {data},
+      {},
+      {"sum(c1)", "sum(c2)"},
+      makeRowVector(
+          {makeDecimalFlatVector({shortSums[0] + shortSums[1]}, DECIMAL(38, 2)),
+           makeDecimalFlatVector(
+               {longSums[0] + longSums[1]}, DECIMAL(38, 1))}));
+
+  // A sum over 38 digits is an error.
+  auto large = makeRowVector({makeDecimalFlatVector(
+      std::vector<std::optional<int128_t>>(
+          20, DecimalUtil::kPowersOfTen[38] - 1),
+      DECIMAL(38, 0))});
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(PlanBuilder()
+                             .values({large})
+                             .singleAggregation({}, {"sum(c0)"})
+                             .planNode())
+          .copyResults(pool()),
+      "Decimal overflow");
+}
+
 struct SumRow {
   char nulls;
   int64_t sum;
@@ -48,6 +48,24 @@ class CompareBenchmark : public functions::test::FunctionBenchmarkBase {
     return doRun(exprSet, inputs);
   }
 
+  // Compares null-free flat columns of type T with each other or with a
+  // constant, which take the SIMD path of the comparison functions.
+  template <typename T>
+  size_t runNoNulls(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+    constexpr vector_size_t size = 1000;
+    auto makeColumn = [&]() {
+      return vectorMaker_.flatVector<T>(
+          size, [](auto /*row*/) { return folly::Random::rand32() % size; });
+    };
+    auto inputs = vectorMaker_.rowVector({makeColumn(), makeColumn()});
+
+    auto exprSet = compileExpression(expression, inputs->type());
+    suspender.dismiss();
+
+    return doRun(exprSet, inputs);
+  }
+
   size_t doRun(exec::ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -176,6 +194,26 @@ BENCHMARK_MULTI(Gt_Velox) {
   CompareBenchmark benchmark;
   return benchmark.run(">");
 }
+
+BENCHMARK_MULTI(Eq_BigintNoNulls) {
+  CompareBenchmark benchmark;
+  return benchmark.runNoNulls<int64_t>("c0 = c1");
+}
+
+BENCHMARK_MULTI(Lt_BigintConstant) {
+  CompareBenchmark benchmark;
+  return benchmark.runNoNulls<int64_t>("c0 < 500");
+}
+
+BENCHMARK_MULTI(Lt_IntegerConstant) {
+  CompareBenchmark benchmark;
+  return benchmark.runNoNulls<int32_t>("c0 < cast(500 as integer)");
+}
+
+BENCHMARK_MULTI(Gt_DoubleConstant) {
+  CompareBenchmark benchmark;
+  return benchmark.runNoNulls<double>("c0 > 500.0");
+}
 } // namespace
 } // namespace facebook::velox::functions::test
 
@@ -19,6 +19,7 @@
 #include "velox/external/date/tz.h"
 #include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/type/tz/TimeZoneMap.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
 
 using namespace facebook::velox;
@@ -124,6 +125,35 @@ class DateTimeBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, data);
   }
 
+  // Runs 'expression' over timestamps an hour apart from 2020 on in c0, the
+  // same timestamps as text in c1 and as timestamps with the time zone
+  // America/Los_Angeles in c2.
+  void runFormat(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+    constexpr vector_size_t size = 10'000;
+    constexpr int64_t kStart = 1'577'836'800;
+    auto timestamps = vectorMaker_.flatVector<Timestamp>(
+        size, [](auto row) { return Timestamp(kStart + row * 3'600, 0); });
+    // yyyy-MM-ddTHH:mm:ss.
+    std::vector<std::string> strings(size);
+    for (auto i = 0; i < size; ++i) {
+      strings[i] = timestamps->valueAt(i).toString().substr(0, 19);
+    }
+    auto text = vectorMaker_.flatVector<StringView>(
+        size, [&](auto row) { return StringView(strings[row]); });
+    auto laId = util::getTimeZoneID("America/Los_Angeles");
+    auto withTimeZone = vectorMaker_.rowVector(
+        {vectorMaker_.flatVector<int64_t>(
+             size, [&](auto row) { return (kStart + row * 3'600) * 1'000; }),
+         vectorMaker_.flatVector<int16_t>(
+             size, [&](auto /*row*/) { return laId; })});
+    auto data = vectorMaker_.rowVector({timestamps, text, withTimeZone});
+    auto exprSet = compileExpression(expression, data->type());
+    suspender.dismiss();
+
+    doRun(exprSet, data);
+  }
+
   void doRun(exec::ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -197,6 +227,31 @@ BENCHMARK(second) {
   DateTimeBenchmark benchmark;
   benchmark.run("second");
 }
+
+BENCHMARK(dateFormat) {
+  DateTimeBenchmark benchmark;
+  benchmark.runFormat("date_format(c0, '%Y-%m-%d %H:%i:%s')");
+}
+
+BENCHMARK(dateFormatText) {
+  DateTimeBenchmark benchmark;
+  benchmark.runFormat("date_format(c0, '%W %M %e %Y')");
+}
+
+BENCHMARK(formatDatetime) {
+  DateTimeBenchmark benchmark;
+  benchmark.runFormat("format_datetime(c0, 'yyyy-MM-dd')");
+}
+
+BENCHMARK(parseDatetime) {
+  DateTimeBenchmark benchmark;
+  benchmark.runFormat("parse_datetime(c1, 'yyyy-MM-dd''T''HH:mm:ss')");
+}
+
+BENCHMARK(hourWithTimeZone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runFormat("hour(c2)");
+}
 } // namespace
 
 int main(int /*argc*/, char** /*argv*/) {
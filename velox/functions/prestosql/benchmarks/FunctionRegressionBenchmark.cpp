@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <unordered_set>
+
+#include "velox/expression/SignatureBinder.h"
+#include "velox/functions/FunctionRegistry.h"
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+DEFINE_string(
+    only,
+    "",
+    "Comma separated list of function names to run. Runs all registered "
+    "scalar functions if empty.");
+DEFINE_int32(batch_size, 1'000, "Rows of each fuzzed input batch");
+DEFINE_string(
+    encodings,
+    "flat,dictionary,constant",
+    "Comma separated encodings of the inputs. 'constant' keeps the first "
+    "argument flat and makes the others constant.");
+DEFINE_string(
+    null_ratios,
+    "0,0.2",
+    "Comma separated null ratios of the inputs");
+DEFINE_int32(string_length, 20, "Maximum length of fuzzed strings");
+DEFINE_int32(
+    duration_ms,
+    50,
+    "Minimum time each case is evaluated for after one warm up batch");
+DEFINE_string(output, "", "If set, writes the rows/s of each case as JSON");
+DEFINE_string(
+    baseline,
+    "",
+    "JSON written by --output of an earlier run. Cases slower than the "
+    "baseline by more than --threshold are reported and make the exit "
+    "status non-zero.");
+DEFINE_double(threshold, 0.2, "Tolerated relative drop of rows/s");
+DEFINE_int64(seed, 1, "Seed of the vector fuzzer");
+
+using namespace facebook::velox;
+
+// Evaluates every registered scalar function signature of primitive types on
+// fuzzed batches of each encoding and null ratio and measures rows per
+// second. The cases are keyed on "<signature>/<encoding>/nulls=<ratio>", so
+// that a run can be compared with the JSON of an earlier run for regressions.
+// The calls are wrapped in try() so that batches with values outside of a
+// function's domain still run through the whole batch.
+namespace {
+
+enum class Encoding { kFlat, kDictionary, kConstant };
+
+Encoding encodingFromName(const std::string& name) {
+  if (name == "flat") {
+    return Encoding::kFlat;
+  }
+  if (name == "dictionary") {
+    return Encoding::kDictionary;
+  }
+  if (name == "constant") {
+    return Encoding::kConstant;
+  }
+  VELOX_USER_FAIL("Unknown encoding: {}", name);
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+  std::vector<std::string> items;
+  folly::split(',', list, items, true);
+  return items;
+}
+
+struct CallableSignature {
+  std::string name;
+  std::vector<TypePtr> args;
+
+  std::string toString() const {
+    std::vector<std::string> argNames;
+    for (auto& arg : args) {
+      argNames.push_back(arg->toString());
+    }
+    return fmt::format("{}({})", name, folly::join(",", argNames));
+  }
+};
+
+// Returns the signatures without type variables or variable arity whose
+// arguments are all primitive types, sorted so that runs are comparable.
+std::vector<CallableSignature> collectSignatures(
+    const std::unordered_set<std::string>& only) {
+  std::vector<CallableSignature> result;
+  for (auto& [name, signatures] : getFunctionSignatures()) {
+    if (!only.empty() && only.count(name) == 0) {
+      continue;
+    }
+    for (auto* signature : signatures) {
+      if (!signature->typeVariableConstants().empty() ||
+          signature->variableArity() || signature->argumentTypes().empty()) {
+        continue;
+      }
+      CallableSignature callable{name, {}};
+      for (auto& arg : signature->argumentTypes()) {
+        auto type = exec::SignatureBinder::tryResolveType(arg, {});
+        if (!type || !type->isPrimitiveType()) {
+          callable.args.clear();
+          break;
+        }
+        callable.args.push_back(type);
+      }
+      if (!callable.args.empty()) {
+        result.push_back(std::move(callable));
+      }
+    }
+  }
+  std::sort(result.begin(), result.end(), [](auto& lhs, auto& rhs) {
+    return lhs.toString() < rhs.toString();
+  });
+  return result;
+}
+
+class FunctionRegressionBenchmark
+    : public functions::test::FunctionBenchmarkBase {
+ public:
+  // Returns the rows/s of 'signature' on inputs of 'encoding' and
+  // 'nullRatio' or std::nullopt if the case does not apply or the expression
+  // cannot be compiled or evaluated, e.g. because the function needs constant
+  // arguments.
+  std::optional<double> run(
+      const CallableSignature& signature,
+      Encoding encoding,
+      double nullRatio) {
+    if (encoding == Encoding::kConstant && signature.args.size() < 2) {
+      return std::nullopt;
+    }
+    auto returnType = resolveFunction(signature.name, signature.args);
+    if (!returnType) {
+      return std::nullopt;
+    }
+
+    VectorFuzzer::Options opts;
+    opts.vectorSize = FLAGS_batch_size;
+    opts.nullRatio = nullRatio;
+    opts.stringVariableLength = true;
+    opts.stringLength = FLAGS_string_length;
+    VectorFuzzer fuzzer(opts, pool(), FLAGS_seed);
+
+    std::vector<std::string> names;
+    std::vector<VectorPtr> columns;
+    std::vector<core::TypedExprPtr> inputs;
+    for (auto i = 0; i < signature.args.size(); ++i) {
+      auto& type = signature.args[i];
+      names.push_back(fmt::format("c{}", i));
+      inputs.push_back(
+          std::make_shared<core::FieldAccessTypedExpr>(type, names.back()));
+      switch (encoding) {
+        case Encoding::kFlat:
+          columns.push_back(fuzzer.fuzzFlat(type));
+          break;
+        case Encoding::kDictionary:
+          columns.push_back(fuzzer.fuzzDictionary(fuzzer.fuzzFlat(type)));
+          break;
+        case Encoding::kConstant:
+          columns.push_back(
+              i == 0 ? fuzzer.fuzzFlat(type) : fuzzer.fuzzConstant(type));
+          break;
+      }
+    }
+    auto data = std::make_shared<RowVector>(
+        pool(),
+        ROW(std::move(names), std::vector<TypePtr>(signature.args)),
+        nullptr,
+        FLAGS_batch_size,
+        std::move(columns));
+
+    auto call = std::make_shared<core::CallTypedExpr>(
+        returnType, std::move(inputs), signature.name);
+    auto expr = std::make_shared<core::CallTypedExpr>(
+        returnType, std::vector<core::TypedExprPtr>{call}, "try");
+
+    try {
+      exec::ExprSet exprSet({expr}, &execCtx_);
+      evaluate(exprSet, data);
+
+      int64_t numRows = 0;
+      const auto start = std::chrono::steady_clock::now();
+      const auto end = start + std::chrono::milliseconds(FLAGS_duration_ms);
+      auto now = start;
+      do {
+        evaluate(exprSet, data);
+        numRows += data->size();
+        now = std::chrono::steady_clock::now();
+      } while (now < end);
+      const std::chrono::duration<double> seconds = now - start;
+      return numRows / seconds.count();
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Skipping " << signature.toString() << ": " << e.what();
+      return std::nullopt;
+    }
+  }
+};
+
+std::string encodingName(Encoding encoding) {
+  switch (encoding) {
+    case Encoding::kFlat:
+      return "flat";
+    case Encoding::kDictionary:
+      return "dictionary";
+    case Encoding::kConstant:
+      return "constant";
+  }
+  VELOX_UNREACHABLE();
+}
+
+// Prints the cases of 'results' that are slower than in 'baseline' by more
+// than FLAGS_threshold. Returns the number of such cases.
+int32_t reportRegressions(
+    const std::map<std::string, double>& results,
+    const folly::dynamic& baseline) {
+  int32_t numRegressions = 0;
+  for (auto& [name, rowsPerSecond] : results) {
+    auto* expected = baseline.get_ptr(name);
+    if (!expected) {
+      continue;
+    }
+    const auto expectedRowsPerSecond = expected->asDouble();
+    if (rowsPerSecond < expectedRowsPerSecond * (1 - FLAGS_threshold)) {
+      ++numRegressions;
+      std::cout << fmt::format(
+                       "REGRESSION {}: {:.0f} rows/s, baseline {:.0f} rows/s "
+                       "({:+.1f}%)",
+                       name,
+                       rowsPerSecond,
+                       expectedRowsPerSecond,
+                       100 * (rowsPerSecond / expectedRowsPerSecond - 1))
+                << std::endl;
+    }
+  }
+  return numRegressions;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  functions::prestosql::registerAllScalarFunctions();
+
+  auto onlyList = splitList(FLAGS_only);
+  auto signatures = collectSignatures({onlyList.begin(), onlyList.end()});
+  std::vector<Encoding> encodings;
+  for (auto& name : splitList(FLAGS_encodings)) {
+    encodings.push_back(encodingFromName(name));
+  }
+  std::vector<double> nullRatios;
+  for (auto& ratio : splitList(FLAGS_null_ratios)) {
+    nullRatios.push_back(folly::to<double>(ratio));
+  }
+
+  FunctionRegressionBenchmark benchmark;
+  std::map<std::string, double> results;
+  for (auto& signature : signatures) {
+    for (auto encoding : encodings) {
+      for (auto nullRatio : nullRatios) {
+        auto rowsPerSecond = benchmark.run(signature, encoding, nullRatio);
+        if (!rowsPerSecond.has_value()) {
+          continue;
+        }
+        auto name = fmt::format(
+            "{}/{}/nulls={}",
+            signature.toString(),
+            encodingName(encoding),
+            nullRatio);
+        std::cout << fmt::format(
+                         "{:<80} {:>14.0f} rows/s", name, *rowsPerSecond)
+                  << std::endl;
+        results[name] = *rowsPerSecond;
+      }
+    }
+  }
+
+  if (!FLAGS_output.empty()) {
+    folly::dynamic json = folly::dynamic::object;
+    for (auto& [name, rowsPerSecond] : results) {
+      json[name] = rowsPerSecond;
+    }
+    VELOX_CHECK(
+        folly::writeFile(folly::toPrettyJson(json), FLAGS_output.c_str()),
+        "Cannot write {}",
+        FLAGS_output);
+  }
+
+  if (!FLAGS_baseline.empty()) {
+    std::string text;
+    VELOX_CHECK(
+        folly::readFile(FLAGS_baseline.c_str(), text),
+        "Cannot read {}",
+        FLAGS_baseline);
+    if (reportRegressions(results, folly::parseJson(text)) > 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
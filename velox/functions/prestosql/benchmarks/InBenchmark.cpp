@@ -116,6 +116,22 @@ BENCHMARK_RELATIVE(in) {
   benchmark.run(10);
 }
 
+// 16 values are the most that are compared with SIMD. 17 use the filter.
+BENCHMARK(fastIn16) {
+  InBenchmark benchmark;
+  benchmark.runFast(16);
+}
+
+BENCHMARK_RELATIVE(in16) {
+  InBenchmark benchmark;
+  benchmark.run(16);
+}
+
+BENCHMARK_RELATIVE(in17) {
+  InBenchmark benchmark;
+  benchmark.run(17);
+}
+
 BENCHMARK(fastIn1K) {
   InBenchmark benchmark;
   benchmark.runFast(1'000);
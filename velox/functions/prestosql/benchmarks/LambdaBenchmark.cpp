@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+// Measures lambda functions over arrays of very different sizes and over
+// arrays of arrays. The reduce steps cover fewer arrays as the short arrays
+// run out of elements, and the transform of nested arrays evaluates an inner
+// reduce for each outer array.
+namespace facebook::velox::functions::test {
+namespace {
+constexpr vector_size_t kSize = 10'000;
+
+class LambdaBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  LambdaBenchmark() : FunctionBenchmarkBase() {
+    prestosql::registerAllScalarFunctions();
+
+    // One array in 100 has 200 elements, the others have up to 4.
+    auto sizeAt = [](auto row) { return row % 100 == 0 ? 200 : row % 5; };
+    auto array = vectorMaker_.arrayVector<int64_t>(
+        kSize, sizeAt, [](auto row, auto index) { return row + index; });
+
+    auto inner = vectorMaker_.arrayVector<int64_t>(
+        kSize * 4, sizeAt, [](auto row, auto index) { return row + index; });
+    std::vector<vector_size_t> offsets(kSize);
+    for (auto i = 0; i < kSize; ++i) {
+      offsets[i] = i * 4;
+    }
+    auto nested = vectorMaker_.arrayVector(offsets, inner);
+    auto factor =
+        vectorMaker_.flatVector<int64_t>(kSize, [](auto row) { return row; });
+    data_ = vectorMaker_.rowVector({array, nested, factor});
+
+    auto type = data_->type();
+    auto sumSignature = ROW({"s", "x"}, {BIGINT(), BIGINT()});
+    registerLambda("sum", sumSignature, type, "s + x");
+    registerLambda("scaled_sum", sumSignature, type, "s + x * c2");
+    registerLambda("scale", ROW({"x"}, {BIGINT()}), type, "x * c2");
+    registerLambda("identity", ROW({"s"}, {BIGINT()}), type, "s");
+    registerLambda(
+        "inner_sum",
+        ROW({"x"}, {ARRAY(BIGINT())}),
+        type,
+        "reduce(x, 0, function('sum'), function('identity'))");
+  }
+
+  size_t run(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+    auto exprSet = compileExpression(expression, data_->type());
+    suspender.dismiss();
+
+    size_t count = 0;
+    for (auto i = 0; i < 10; ++i) {
+      count += evaluate(exprSet, data_)->size();
+    }
+    return count;
+  }
+
+ private:
+  void registerLambda(
+      const std::string& name,
+      const RowTypePtr& signature,
+      const TypePtr& rowType,
+      const std::string& body) {
+    core::Expressions::registerLambda(
+        name, signature, rowType, parse::parseExpr(body), pool());
+  }
+
+  RowVectorPtr data_;
+};
+
+std::unique_ptr<LambdaBenchmark> benchmark;
+
+BENCHMARK_MULTI(reduceSum) {
+  return benchmark->run(
+      "reduce(c0, 0, function('sum'), function('identity'))");
+}
+
+BENCHMARK_MULTI(reduceSumWithCapture) {
+  return benchmark->run(
+      "reduce(c0, 0, function('scaled_sum'), function('identity'))");
+}
+
+BENCHMARK_MULTI(transformWithCapture) {
+  return benchmark->run("transform(c0, function('scale'))");
+}
+
+BENCHMARK_MULTI(transformNestedReduce) {
+  return benchmark->run("transform(c1, function('inner_sum'))");
+}
+} // namespace
+} // namespace facebook::velox::functions::test
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  facebook::velox::functions::test::benchmark =
+      std::make_unique<facebook::velox::functions::test::LambdaBenchmark>();
+  folly::runBenchmarks();
+  facebook::velox::functions::test::benchmark.reset();
+  return 0;
+}
@@ -114,6 +114,37 @@ class StringAsciiUTFFunctionBenchmark
     doRun(exprSet, rowVector);
   }
 
+  // Runs 'expression' over 100 character strings. Every 'utfEvery'th row is
+  // UTF-8 and the others are ASCII, so that the ASCII check of the batch sees
+  // its first non-ASCII string at row 'utfEvery' - 1. 0 means all ASCII.
+  void runMixed(const std::string& expression, vector_size_t utfEvery) {
+    folly::BenchmarkSuspender suspender;
+
+    VectorFuzzer::Options opts;
+    opts.stringLength = 100;
+    opts.vectorSize = 100'000;
+    VectorFuzzer asciiFuzzer(opts, execCtx_.pool());
+    auto ascii = asciiFuzzer.fuzzFlat(VARCHAR())->asFlatVector<StringView>();
+
+    opts.charEncodings = {UTF8CharList::UNICODE_CASE_SENSITIVE};
+    VectorFuzzer utfFuzzer(opts, execCtx_.pool());
+    auto utf = utfFuzzer.fuzzFlat(VARCHAR());
+    auto* flatUtf = utf->asFlatVector<StringView>();
+
+    auto vector = BaseVector::create<FlatVector<StringView>>(
+        VARCHAR(), opts.vectorSize, execCtx_.pool());
+    for (auto i = 0; i < opts.vectorSize; ++i) {
+      const bool isUtf = utfEvery > 0 && (i + 1) % utfEvery == 0;
+      vector->set(i, isUtf ? flatUtf->valueAt(i) : ascii->valueAt(i));
+    }
+
+    auto rowVector = vectorMaker_.rowVector({vector});
+    auto exprSet = compileExpression(expression, rowVector->type());
+
+    suspender.dismiss();
+    doRun(exprSet, rowVector);
+  }
+
   void doRun(ExprSet& exprSet, const RowVectorPtr& rowVector) {
     uint32_t cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -172,6 +203,35 @@ BENCHMARK_RELATIVE(aciiRPad) {
   StringAsciiUTFFunctionBenchmark benchmark;
   benchmark.runLPadRPad("rpad", false);
 }
+BENCHMARK(mixedLowerAllAscii) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("lower(c0)", 0);
+}
+
+BENCHMARK_RELATIVE(mixedLowerUtfEvery10000) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("lower(c0)", 10'000);
+}
+
+BENCHMARK_RELATIVE(mixedLowerUtfEvery10) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("lower(c0)", 10);
+}
+
+BENCHMARK(mixedSubStrAllAscii) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("substr(c0, 25)", 0);
+}
+
+BENCHMARK_RELATIVE(mixedSubStrUtfEvery10000) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("substr(c0, 25)", 10'000);
+}
+
+BENCHMARK_RELATIVE(mixedSubStrUtfEvery10) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("substr(c0, 25)", 10);
+}
 } // namespace
 
 // Preliminary release run, before ascii optimization.
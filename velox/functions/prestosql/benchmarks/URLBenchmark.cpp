@@ -186,11 +186,8 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
         Varchar>({"folly_url_extract_parameter"});
   }
 
-  void runUrlExtract(const std::string& fnName, bool isParameter = false) {
-    folly::BenchmarkSuspender suspender;
-
-    size_t size = 1000;
-    auto vectorUrls = vectorMaker_.flatVector<StringView>(
+  VectorPtr makeUrls(vector_size_t size) {
+    return vectorMaker_.flatVector<StringView>(
         size,
         [](auto row) {
           // construct some pseudo random url
@@ -201,6 +198,13 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
               row % 3));
         },
         nullptr);
+  }
+
+  void runUrlExtract(const std::string& fnName, bool isParameter = false) {
+    folly::BenchmarkSuspender suspender;
+
+    size_t size = 1000;
+    auto vectorUrls = makeUrls(size);
     auto constVector = BaseVector::createConstant("k1", size, pool());
     auto rowVector = isParameter
         ? vectorMaker_.rowVector({vectorUrls, constVector})
@@ -215,6 +219,35 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, rowVector);
   }
 
+  // Evaluates the protocol, host, path, query and fragment of the same URLs
+  // in one ExprSet. 'prefix' is "" or "folly_".
+  void runUrlExtractAll(const std::string& prefix) {
+    folly::BenchmarkSuspender suspender;
+
+    auto rowVector = vectorMaker_.rowVector({makeUrls(1000)});
+    std::vector<std::shared_ptr<const core::ITypedExpr>> expressions;
+    for (auto component : {"protocol", "host", "path", "query", "fragment"}) {
+      expressions.push_back(core::Expressions::inferTypes(
+          parse::parseExpr(
+              fmt::format("{}url_extract_{}(c0)", prefix, component)),
+          rowVector->type(),
+          pool()));
+    }
+    ExprSet exprSet(std::move(expressions), &execCtx_);
+    SelectivityVector rows(rowVector->size());
+    std::vector<VectorPtr> results(exprSet.exprs().size());
+
+    suspender.dismiss();
+
+    uint32_t cnt = 0;
+    for (auto i = 0; i < 100; i++) {
+      EvalCtx evalCtx(&execCtx_, &exprSet, rowVector.get());
+      exprSet.eval(rows, &evalCtx, &results);
+      cnt += results[0]->size();
+    }
+    folly::doNotOptimizeAway(cnt);
+  }
+
   void doRun(ExprSet& exprSet, const RowVectorPtr& rowVector) {
     uint32_t cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -294,6 +327,16 @@ BENCHMARK_RELATIVE(velox_param) {
   benchmark.runUrlExtract("url_extract_parameter", true);
 }
 
+BENCHMARK(folly_all) {
+  UrlBenchmark benchmark;
+  benchmark.runUrlExtractAll("folly_");
+}
+
+BENCHMARK_RELATIVE(velox_all) {
+  UrlBenchmark benchmark;
+  benchmark.runUrlExtractAll("");
+}
+
 } // namespace
 
 int main(int /*argc*/, char** /*argv*/) {
@@ -16,6 +16,7 @@
 #include "velox/functions/prestosql/hyperloglog/DenseHll.h"
 #include <exception>
 #include <sstream>
+#include "velox/common/base/SimdUtil.h"
 #include "velox/functions/prestosql/aggregates/IOUtils.h"
 #include "velox/functions/prestosql/hyperloglog/BiasCorrection.h"
 #include "velox/functions/prestosql/hyperloglog/HllUtils.h"
@@ -142,6 +143,22 @@ void DenseHll::insertHash(uint64_t hash) {
   insert(index, value);
 }
 
+void DenseHll::insertHashes(const uint64_t* hashes, int32_t numHashes) {
+  constexpr int32_t kBatch = 64;
+  uint32_t indices[kBatch];
+  int8_t values[kBatch];
+  for (auto start = 0; start < numHashes; start += kBatch) {
+    const auto size = std::min(kBatch, numHashes - start);
+    for (auto i = 0; i < size; ++i) {
+      indices[i] = computeIndex(hashes[start + i], indexBitLength_);
+      values[i] = computeValue(hashes[start + i], indexBitLength_);
+    }
+    for (auto i = 0; i < size; ++i) {
+      insert(indices[i], values[i]);
+    }
+  }
+}
+
 void DenseHll::insert(int32_t index, int8_t value) {
   auto delta = value - baseline_;
   auto oldDelta = getDelta(index);
@@ -201,15 +218,19 @@ struct DenseHllView {
   }
 };
 
+// Computes the estimate from the number of buckets with each delta instead
+// of visiting the buckets one at a time. Only the buckets with an overflow
+// have a value that is not baseline + delta.
 int64_t cardinalityImpl(const DenseHllView& hll) {
   auto numBuckets = 1 << hll.indexBitLength;
 
-  int32_t baselineCount = 0;
-  for (int i = 0; i < numBuckets; i++) {
-    if (hll.getDelta(i) == 0) {
-      baselineCount++;
-    }
+  int32_t deltaCounts[kMaxDelta + 1] = {};
+  const auto* deltas = reinterpret_cast<const uint8_t*>(hll.deltas);
+  for (int i = 0; i < numBuckets / 2; i++) {
+    ++deltaCounts[deltas[i] >> kBitsPerBucket];
+    ++deltaCounts[deltas[i] & kBucketMask];
   }
+  int32_t baselineCount = deltaCounts[0];
 
   // If baseline is zero, then baselineCount is the number of buckets with value
   // 0.
@@ -218,10 +239,17 @@ int64_t cardinalityImpl(const DenseHllView& hll) {
     return std::round(linearCounting(baselineCount, numBuckets));
   }
 
+  // Sums the buckets per delta, then corrects the buckets with an overflow.
   double sum = 0;
-  for (int i = 0; i < numBuckets; i++) {
-    int value = hll.getValue(i);
-    sum += 1.0 / (1L << value);
+  for (int delta = 0; delta <= kMaxDelta; delta++) {
+    sum += deltaCounts[delta] * (1.0 / (1L << (hll.baseline + delta)));
+  }
+  for (int i = 0; i < hll.overflows; i++) {
+    auto bucket = hll.overflowBuckets[i];
+    if (hll.getDelta(bucket) == kMaxDelta) {
+      sum -= 1.0 / (1L << (hll.baseline + kMaxDelta));
+      sum += 1.0 / (1L << hll.getValue(bucket));
+    }
   }
 
   double estimate = (alpha(hll.indexBitLength) * numBuckets * numBuckets) / sum;
@@ -567,51 +595,98 @@ void DenseHll::mergeWith(
     int16_t otherOverflows,
     const uint16_t* otherOverflowBuckets,
     const int8_t* otherOverflowValues) {
-  int8_t newBaseline = std::max(baseline_, otherBaseline);
-  int32_t baselineCount = 0;
-
-  int bucket = 0;
-  for (int i = 0; i < deltas_.size(); i++) {
-    int newSlot = 0;
-
-    int8_t slot1 = deltas_[i];
-    int8_t slot2 = otherDeltas[i];
-
-    for (int shift = 4; shift >= 0; shift -= 4) {
-      int8_t delta1 = (slot1 >> shift) & kBucketMask;
-      int8_t delta2 = (slot2 >> shift) & kBucketMask;
-
-      int8_t value1 = baseline_ + delta1;
-      int8_t value2 = otherBaseline + delta2;
-
-      int16_t overflowEntry = -1;
-      if (delta1 == kMaxDelta) {
-        overflowEntry = findOverflowEntry(bucket);
-        if (overflowEntry != -1) {
-          value1 += overflowValues_[overflowEntry];
-        }
-      }
-
-      if (delta2 == kMaxDelta) {
-        value2 += getOverflowImpl(
-            bucket, otherOverflows, otherOverflowBuckets, otherOverflowValues);
-      }
-
-      int8_t newValue = std::max(value1, value2);
-      int8_t newDelta = newValue - newBaseline;
-
-      if (newDelta == 0) {
-        baselineCount++;
-      }
+  const int8_t newBaseline = std::max(baseline_, otherBaseline);
+
+  // Only the buckets with an overflow in either HLL can get a new delta above
+  // kMaxDelta. They are merged before the deltas are overwritten.
+  std::vector<std::pair<uint16_t, int8_t>> overflowDeltas;
+  auto mergeBucket = [&](uint16_t bucket) {
+    const auto delta1 = getDelta(bucket);
+    int8_t value1 = baseline_ + delta1;
+    if (delta1 == kMaxDelta) {
+      value1 += getOverflow(bucket);
+    }
+    const auto delta2 = (otherDeltas[bucket >> 1] >> shiftForBucket(bucket)) &
+        kBucketMask;
+    int8_t value2 = otherBaseline + delta2;
+    if (delta2 == kMaxDelta) {
+      value2 += getOverflowImpl(
+          bucket, otherOverflows, otherOverflowBuckets, otherOverflowValues);
+    }
+    overflowDeltas.emplace_back(
+        bucket, std::max(value1, value2) - newBaseline);
+  };
+  for (auto i = 0; i < overflows_; ++i) {
+    mergeBucket(overflowBuckets_[i]);
+  }
+  for (auto i = 0; i < otherOverflows; ++i) {
+    if (findOverflowEntry(otherOverflowBuckets[i]) == -1) {
+      mergeBucket(otherOverflowBuckets[i]);
+    }
+  }
 
-      newDelta = updateOverflow(bucket, overflowEntry, newDelta);
+  // Without overflows, the merged delta of a bucket is the larger of the two
+  // deltas after each is rebased to 'newBaseline'. One of the baselines is
+  // 'newBaseline' and the deltas of the other go down by the difference.
+  // Deltas that would go below 0 lose to the delta of the other HLL.
+  const uint8_t shift1 = std::min<int32_t>(newBaseline - baseline_, kMaxDelta);
+  const uint8_t shift2 =
+      std::min<int32_t>(newBaseline - otherBaseline, kMaxDelta);
+  auto* deltas = reinterpret_cast<uint8_t*>(deltas_.data());
+  const auto* other = reinterpret_cast<const uint8_t*>(otherDeltas);
+  const int32_t numBytes = deltas_.size();
+  int32_t baselineCount = 0;
+  int32_t i = 0;
+
+  // Returns 'delta' minus 'shift' or 0 if 'shift' is larger.
+  auto rebase = [](auto delta, auto shift) {
+    return xsimd::max(delta, shift) - shift;
+  };
+  auto rebaseOne = [](uint8_t delta, uint8_t shift) -> uint8_t {
+    return std::max(delta, shift) - shift;
+  };
+
+  using Batch = xsimd::batch<uint8_t>;
+  const Batch lowMask(kBucketMask);
+  const Batch highMask(kBucketMask << kBitsPerBucket);
+  const Batch lowShift1(shift1);
+  const Batch highShift1(shift1 << kBitsPerBucket);
+  const Batch lowShift2(shift2);
+  const Batch highShift2(shift2 << kBitsPerBucket);
+  const Batch zero(0);
+  for (; i + Batch::size <= numBytes; i += Batch::size) {
+    const auto slots1 = Batch::load_unaligned(deltas + i);
+    const auto slots2 = Batch::load_unaligned(other + i);
+    const auto low = xsimd::max(
+        rebase(slots1 & lowMask, lowShift1),
+        rebase(slots2 & lowMask, lowShift2));
+    const auto high = xsimd::max(
+        rebase(slots1 & highMask, highShift1),
+        rebase(slots2 & highMask, highShift2));
+    baselineCount += __builtin_popcount(simd::toBitMask(low == zero)) +
+        __builtin_popcount(simd::toBitMask(high == zero));
+    (low | high).store_unaligned(deltas + i);
+  }
+  for (; i < numBytes; ++i) {
+    const uint8_t low = std::max(
+        rebaseOne(deltas[i] & kBucketMask, shift1),
+        rebaseOne(other[i] & kBucketMask, shift2));
+    const uint8_t high = std::max(
+        rebaseOne(deltas[i] >> kBitsPerBucket, shift1),
+        rebaseOne(other[i] >> kBitsPerBucket, shift2));
+    baselineCount += (low == 0) + (high == 0);
+    deltas[i] = low | (high << kBitsPerBucket);
+  }
 
-      newSlot <<= 4;
-      newSlot |= newDelta;
-      bucket++;
+  overflows_ = 0;
+  for (auto [bucket, delta] : overflowDeltas) {
+    baselineCount -= getDelta(bucket) == 0;
+    baselineCount += delta == 0;
+    if (delta > kMaxDelta) {
+      addOverflow(bucket, delta - kMaxDelta);
+      delta = kMaxDelta;
     }
-
-    deltas_[i] = newSlot;
+    setDelta(bucket, delta);
   }
 
   baseline_ = newBaseline;
@@ -622,23 +697,6 @@ void DenseHll::mergeWith(
   adjustBaselineIfNeeded();
 }
 
-int8_t
-DenseHll::updateOverflow(int32_t index, int overflowEntry, int8_t delta) {
-  if (delta > kMaxDelta) {
-    if (overflowEntry != -1) {
-      // update existing overflow
-      overflowValues_[overflowEntry] = delta - kMaxDelta;
-    } else {
-      addOverflow(index, delta - kMaxDelta);
-    }
-    delta = kMaxDelta;
-  } else if (overflowEntry != -1) {
-    removeOverflow(overflowEntry);
-  }
-
-  return delta;
-}
-
 void DenseHll::addOverflow(int32_t index, int8_t overflow) {
   overflowBuckets_.resize(overflows_ + 1);
   overflowValues_.resize(overflows_ + 1);
@@ -647,11 +705,4 @@ void DenseHll::addOverflow(int32_t index, int8_t overflow) {
   overflowValues_[overflows_] = overflow;
   overflows_++;
 }
-
-void DenseHll::removeOverflow(int overflowEntry) {
-  // Remove existing overflow.
-  overflowBuckets_[overflowEntry] = overflowBuckets_[overflows_ - 1];
-  overflowValues_[overflowEntry] = overflowValues_[overflows_ - 1];
-  overflows_--;
-}
 } // namespace facebook::velox::aggregate::hll
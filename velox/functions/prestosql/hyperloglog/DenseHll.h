@@ -48,6 +48,11 @@ class DenseHll {
 
   void insertHash(uint64_t hash);
 
+  /// Same as insertHash() for each of 'numHashes' hashes. The buckets and
+  /// values of a batch of hashes are computed in one loop before the
+  /// buckets are updated.
+  void insertHashes(const uint64_t* hashes, int32_t numHashes);
+
   /// Inserts pre-computed {bucket, value} pair. These value must be compatible
   /// with computeIndex and computeValue methods called with the indexBitLength
   /// value of this HLL. Used by SparseHll.toDense().
@@ -81,7 +86,9 @@ class DenseHll {
   int32_t serializedSize() const;
 
   /// Merges the state of another instance into this one.
-  /// The other HLL Must have the same value of indexBitLength.
+  /// The other HLL Must have the same value of indexBitLength. The packed
+  /// deltas are merged with SIMD. Only the buckets with overflows are merged
+  /// one at a time.
   void mergeWith(const DenseHll& other);
 
   void mergeWith(const char* serialized);
@@ -103,12 +110,8 @@ class DenseHll {
 
   void sortOverflows();
 
-  int8_t updateOverflow(int32_t index, int overflowEntry, int8_t delta);
-
   void addOverflow(int32_t index, int8_t overflow);
 
-  void removeOverflow(int overflowEntry);
-
   void mergeWith(
       int8_t otherBaseline,
       const int8_t* otherDeltas,
@@ -139,6 +139,13 @@ bool SparseHll::canDeserialize(const char* input) {
   return *reinterpret_cast<const int8_t*>(input) == kPrestoSparseV2;
 }
 
+// static
+int8_t SparseHll::deserializeIndexBitLength(const char* input) {
+  InputByteStream stream(input);
+  stream.read<int8_t>();
+  return stream.read<int8_t>();
+}
+
 int32_t SparseHll::serializedSize() const {
   return 1 /* version */
       + 1 /* indexBitLength */
@@ -161,55 +168,53 @@ SparseHll::SparseHll(const char* serialized, HashStringAllocator* allocator)
   }
 }
 
-void SparseHll::mergeWith(const SparseHll& other) {
-  mergeWith(other.entries_.size(), other.entries_.data());
+bool SparseHll::mergeWith(const SparseHll& other) {
+  return mergeWith(other.entries_.size(), other.entries_.data());
 }
 
-void SparseHll::mergeWith(const char* serialized) {
+bool SparseHll::mergeWith(const char* serialized) {
   auto stream = initializeInputStream(serialized);
 
   auto size = stream.read<int16_t>();
-  mergeWith(
+  return mergeWith(
       size, reinterpret_cast<const uint32_t*>(serialized + stream.offset()));
 }
 
-void SparseHll::mergeWith(size_t otherSize, const uint32_t* otherEntries) {
-  VELOX_CHECK_GT(otherSize, 0);
-
-  auto size = entries_.size();
-  std::vector<uint32_t> merged(size + otherSize);
-
-  int pos = 0;
-  int leftPos = 0;
-  int rightPos = 0;
-
-  while (leftPos < size && rightPos < otherSize) {
+bool SparseHll::mergeWith(size_t otherSize, const uint32_t* otherEntries) {
+  // Merges from the back into the space after the current entries, so that
+  // no entry is overwritten before it is read. Equal buckets leave a gap at
+  // the front, which is removed at the end.
+  const int64_t size = entries_.size();
+  entries_.resize(size + otherSize);
+
+  int64_t out = size + otherSize - 1;
+  int64_t leftPos = size - 1;
+  int64_t rightPos = otherSize - 1;
+  while (leftPos >= 0 && rightPos >= 0) {
     auto left = decodeIndex(entries_[leftPos]);
     auto right = decodeIndex(otherEntries[rightPos]);
-    if (left < right) {
-      merged[pos++] = entries_[leftPos++];
-    } else if (left > right) {
-      merged[pos++] = otherEntries[rightPos++];
+    if (left > right) {
+      entries_[out--] = entries_[leftPos--];
+    } else if (left < right) {
+      entries_[out--] = otherEntries[rightPos--];
     } else {
       auto value = std::max(
-          decodeValue(entries_[leftPos++]),
-          decodeValue(otherEntries[rightPos++]));
-      merged[pos++] = encode(left, value);
+          decodeValue(entries_[leftPos--]),
+          decodeValue(otherEntries[rightPos--]));
+      entries_[out--] = encode(left, value);
     }
   }
 
-  while (leftPos < size) {
-    merged[pos++] = entries_[leftPos++];
+  while (rightPos >= 0) {
+    entries_[out--] = otherEntries[rightPos--];
   }
 
-  while (rightPos < otherSize) {
-    merged[pos++] = otherEntries[rightPos++];
+  while (leftPos >= 0) {
+    entries_[out--] = entries_[leftPos--];
   }
 
-  entries_.resize(pos);
-  for (auto i = 0; i < pos; i++) {
-    entries_[i] = merged[i];
-  }
+  entries_.erase(entries_.begin(), entries_.begin() + out + 1);
+  return entries_.size() >= softNumEntriesLimit_;
 }
 
 void SparseHll::verify() const {
@@ -226,10 +231,29 @@ void SparseHll::verify() const {
 }
 
 void SparseHll::toDense(DenseHll& denseHll) const {
+  toDense(entries_.size(), entries_.data(), denseHll);
+}
+
+// static
+void SparseHll::toDense(const char* serialized, DenseHll& denseHll) {
+  auto stream = initializeInputStream(serialized);
+
+  auto size = stream.read<int16_t>();
+  toDense(
+      size,
+      reinterpret_cast<const uint32_t*>(serialized + stream.offset()),
+      denseHll);
+}
+
+// static
+void SparseHll::toDense(
+    size_t size,
+    const uint32_t* entries,
+    DenseHll& denseHll) {
   auto indexBitLength = denseHll.indexBitLength();
 
-  for (auto i = 0; i < entries_.size(); i++) {
-    auto entry = entries_[i];
+  for (auto i = 0; i < size; i++) {
+    auto entry = entries[i];
     auto index = entry >> (32 - indexBitLength);
 
     auto zeros = __builtin_clz(entry << indexBitLength);
@@ -48,18 +48,25 @@ class SparseHll {
   /// Returns true if 'input' has Presto SparseV2 format.
   static bool canDeserialize(const char* input);
 
+  static int8_t deserializeIndexBitLength(const char* input);
+
   /// Returns the size of the serialized state without serialising.
   int32_t serializedSize() const;
 
-  /// Merges the state of another instance into this one.
-  void mergeWith(const SparseHll& other);
+  /// Merges the state of another instance into this one. Returns true if
+  /// soft memory limit has been reached. False, otherwise.
+  bool mergeWith(const SparseHll& other);
 
   /// Merges the state of another instance (in serialized form) into this one.
-  void mergeWith(const char* serialized);
+  /// The entries are read in place and merged without a temporary copy.
+  bool mergeWith(const char* serialized);
 
   /// Merges state into provided instance of DenseHll.
   void toDense(DenseHll& denseHll) const;
 
+  /// Merges the serialized state into 'denseHll' without deserializing it.
+  static void toDense(const char* serialized, DenseHll& denseHll);
+
   /// Returns current memory usage.
   int32_t inMemorySize() const;
 
@@ -74,7 +81,10 @@ class SparseHll {
   void verify() const;
 
  private:
-  void mergeWith(size_t otherSize, const uint32_t* otherEntries);
+  bool mergeWith(size_t otherSize, const uint32_t* otherEntries);
+
+  static void
+  toDense(size_t size, const uint32_t* entries, DenseHll& denseHll);
 
   /// A list of observed buckets. Each entry is a 32 bit integer encoding 26-bit
   /// bucket and 6-bit value (number of zeros in the input hash after the bucket
@@ -216,6 +216,24 @@ TEST_P(DenseHllTest, mergeWith) {
   testMergeWith(indexBitLength, sequence(0, 2'000'000), sequence(0, 2'000'000));
 }
 
+TEST_P(DenseHllTest, insertHashes) {
+  int8_t indexBitLength = GetParam();
+
+  DenseHll expected{indexBitLength, &allocator_};
+  DenseHll hll{indexBitLength, &allocator_};
+  std::vector<uint64_t> hashes;
+  for (int i = 0; i < 100'000; i++) {
+    hashes.push_back(hashOne(i));
+    expected.insertHash(hashes.back());
+  }
+  // Batches of uneven sizes.
+  for (auto i = 0; i < hashes.size(); i += 1'001) {
+    hll.insertHashes(
+        hashes.data() + i, std::min<int32_t>(1'001, hashes.size() - i));
+  }
+  ASSERT_EQ(serialize(expected), serialize(hll));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     DenseHllTest,
     DenseHllTest,
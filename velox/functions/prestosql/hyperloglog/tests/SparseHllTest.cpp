@@ -159,6 +159,23 @@ TEST_F(SparseHllTest, mergeWith) {
 
   // idempotent
   testMergeWith(sequence(0, 100), sequence(0, 100));
+
+  // empty
+  testMergeWith(sequence(0, 100), std::vector<int>{});
+  testMergeWith(std::vector<int>{}, sequence(0, 100));
+}
+
+TEST_F(SparseHllTest, mergeWithSoftMemoryLimit) {
+  SparseHll sparseHll{&allocator_};
+  sparseHll.setSoftMemoryLimit(400);
+  SparseHll other{&allocator_};
+  for (int i = 0; i < 99; i++) {
+    other.insertHash(hashOne(i));
+  }
+  ASSERT_FALSE(sparseHll.mergeWith(serialize(11, other).data()));
+  other.insertHash(hashOne(99));
+  ASSERT_TRUE(sparseHll.mergeWith(other));
+  ASSERT_EQ(100, sparseHll.cardinality());
 }
 
 class SparseHllToDenseTest : public ::testing::TestWithParam<int8_t> {
@@ -189,6 +206,13 @@ TEST_P(SparseHllToDenseTest, toDense) {
   sparseHll.toDense(denseHll);
   ASSERT_EQ(denseHll.cardinality(), expectedHll.cardinality());
   ASSERT_EQ(serialize(denseHll), serialize(expectedHll));
+
+  std::string serialized;
+  serialized.resize(sparseHll.serializedSize());
+  sparseHll.serialize(11, serialized.data());
+  DenseHll fromSerialized{indexBitLength, &allocator_};
+  SparseHll::toDense(serialized.data(), fromSerialized);
+  ASSERT_EQ(serialize(fromSerialized), serialize(expectedHll));
 }
 
 INSTANTIATE_TEST_SUITE_P(
@@ -0,0 +1,574 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/prestosql/json/OnDemandJson.h"
+
+#include <cctype>
+#include <cstring>
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+#include <xsimd/xsimd.hpp>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
+#include "velox/functions/prestosql/json/JsonPathTokenizer.h"
+
+namespace facebook::velox::functions {
+
+namespace {
+
+// Nesting limit, the default recursion limit of folly::parseJson.
+constexpr int32_t kMaxDepth = 100;
+
+constexpr int32_t kWildcard = -1;
+constexpr int32_t kNoIndex = -2;
+
+inline bool isWhitespace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+inline uint32_t parseHex4(const char* hex) {
+  uint32_t value = 0;
+  for (auto i = 0; i < 4; ++i) {
+    auto c = hex[i];
+    value = value * 16 + (isDigit(c) ? c - '0' : (c | 0x20) - 'a' + 10);
+  }
+  return value;
+}
+
+// Writes the UTF-8 encoding of 'codePoint' to 'out'. Returns the number of
+// bytes written.
+inline int32_t writeUtf8(uint32_t codePoint, char* out) {
+  if (codePoint < 0x80) {
+    out[0] = codePoint;
+    return 1;
+  }
+  if (codePoint < 0x800) {
+    out[0] = 0xc0 | (codePoint >> 6);
+    out[1] = 0x80 | (codePoint & 0x3f);
+    return 2;
+  }
+  if (codePoint < 0x10000) {
+    out[0] = 0xe0 | (codePoint >> 12);
+    out[1] = 0x80 | ((codePoint >> 6) & 0x3f);
+    out[2] = 0x80 | (codePoint & 0x3f);
+    return 3;
+  }
+  out[0] = 0xf0 | (codePoint >> 18);
+  out[1] = 0x80 | ((codePoint >> 12) & 0x3f);
+  out[2] = 0x80 | ((codePoint >> 6) & 0x3f);
+  out[3] = 0x80 | (codePoint & 0x3f);
+  return 4;
+}
+
+// Returns true if the string literal 'literal' with escapes 'hasEscapes'
+// has the value 'value'.
+bool stringEquals(
+    std::string_view literal,
+    bool hasEscapes,
+    std::string_view value) {
+  if (!hasEscapes) {
+    return literal.size() == value.size() + 2 &&
+        literal.substr(1, value.size()) == value;
+  }
+  std::string unescaped(literal.size(), '\0');
+  unescaped.resize(unescapeJsonString(literal, unescaped.data()));
+  return unescaped == value;
+}
+
+} // namespace
+
+// Forward cursor over JSON text. The skip functions validate the value at the
+// cursor and move past it. They return false if the text is not valid JSON.
+class JsonScanner {
+ public:
+  explicit JsonScanner(std::string_view json)
+      : pos_(json.data()), end_(json.data() + json.size()) {}
+
+  // Skips whitespace and returns the next character or 0 at the end.
+  char peek() {
+    while (pos_ < end_ && isWhitespace(*pos_)) {
+      ++pos_;
+    }
+    return pos_ < end_ ? *pos_ : 0;
+  }
+
+  bool atEnd() {
+    peek();
+    return pos_ == end_;
+  }
+
+  const char* position() const {
+    return pos_;
+  }
+
+  void advance() {
+    ++pos_;
+  }
+
+  // Skips whitespace and 'c' if it is next. Returns true if 'c' was skipped.
+  bool consume(char c) {
+    if (peek() == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  // Skips the string literal at the cursor. Sets 'hasEscapes' if it has
+  // escape sequences.
+  bool skipString(bool& hasEscapes);
+
+  bool skipValue(int32_t depth);
+
+ private:
+  using Batch = xsimd::batch<uint8_t>;
+
+  bool skipNumber();
+
+  bool skipLiteral(std::string_view literal) {
+    if (end_ - pos_ < static_cast<int64_t>(literal.size()) ||
+        std::string_view(pos_, literal.size()) != literal) {
+      return false;
+    }
+    pos_ += literal.size();
+    return true;
+  }
+
+  // Skips a Batch of characters at a time up to the first quote, backslash or
+  // control character.
+  void skipPlainCharacters() {
+    const auto quote = Batch('"');
+    const auto backslash = Batch('\\');
+    const auto space = Batch(' ');
+    while (end_ - pos_ >= static_cast<int64_t>(Batch::size)) {
+      auto bytes =
+          Batch::load_unaligned(reinterpret_cast<const uint8_t*>(pos_));
+      auto special = simd::toBitMask(
+          (bytes == quote) | (bytes == backslash) | (bytes < space));
+      if (special) {
+        pos_ += __builtin_ctz(special);
+        return;
+      }
+      pos_ += Batch::size;
+    }
+  }
+
+  const char* pos_;
+  const char* const end_;
+};
+
+bool JsonScanner::skipString(bool& hasEscapes) {
+  hasEscapes = false;
+  ++pos_;
+  for (;;) {
+    skipPlainCharacters();
+    if (pos_ >= end_) {
+      return false;
+    }
+    const char c = *pos_++;
+    if (c == '"') {
+      return true;
+    }
+    if (static_cast<uint8_t>(c) < 0x20) {
+      return false;
+    }
+    if (c != '\\') {
+      continue;
+    }
+    hasEscapes = true;
+    if (pos_ >= end_) {
+      return false;
+    }
+    switch (*pos_++) {
+      case '"':
+      case '\\':
+      case '/':
+      case 'b':
+      case 'f':
+      case 'n':
+      case 'r':
+      case 't':
+        break;
+      case 'u':
+        if (end_ - pos_ < 4) {
+          return false;
+        }
+        for (auto i = 0; i < 4; ++i) {
+          if (!std::isxdigit(pos_[i])) {
+            return false;
+          }
+        }
+        pos_ += 4;
+        break;
+      default:
+        return false;
+    }
+  }
+}
+
+bool JsonScanner::skipNumber() {
+  if (pos_ < end_ && *pos_ == '-') {
+    ++pos_;
+  }
+  if (pos_ >= end_ || !isDigit(*pos_)) {
+    return false;
+  }
+  if (*pos_++ != '0') {
+    while (pos_ < end_ && isDigit(*pos_)) {
+      ++pos_;
+    }
+  }
+  if (pos_ < end_ && *pos_ == '.') {
+    ++pos_;
+    if (pos_ >= end_ || !isDigit(*pos_)) {
+      return false;
+    }
+    while (pos_ < end_ && isDigit(*pos_)) {
+      ++pos_;
+    }
+  }
+  if (pos_ < end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+    ++pos_;
+    if (pos_ < end_ && (*pos_ == '+' || *pos_ == '-')) {
+      ++pos_;
+    }
+    if (pos_ >= end_ || !isDigit(*pos_)) {
+      return false;
+    }
+    while (pos_ < end_ && isDigit(*pos_)) {
+      ++pos_;
+    }
+  }
+  return true;
+}
+
+bool JsonScanner::skipValue(int32_t depth) {
+  bool hasEscapes;
+  switch (peek()) {
+    case '{':
+      if (depth >= kMaxDepth) {
+        return false;
+      }
+      ++pos_;
+      if (consume('}')) {
+        return true;
+      }
+      do {
+        if (peek() != '"' || !skipString(hasEscapes) || !consume(':') ||
+            !skipValue(depth + 1)) {
+          return false;
+        }
+      } while (consume(','));
+      return consume('}');
+    case '[':
+      if (depth >= kMaxDepth) {
+        return false;
+      }
+      ++pos_;
+      if (consume(']')) {
+        return true;
+      }
+      do {
+        if (!skipValue(depth + 1)) {
+          return false;
+        }
+      } while (consume(','));
+      return consume(']');
+    case '"':
+      return skipString(hasEscapes);
+    case 't':
+      return skipLiteral("true");
+    case 'f':
+      return skipLiteral("false");
+    case 'n':
+      return skipLiteral("null");
+    default:
+      return skipNumber();
+  }
+}
+
+JsonPath::JsonPath(folly::StringPiece path) {
+  auto trimmed = folly::trimWhitespace(path);
+  JsonPathTokenizer tokenizer;
+  bool valid = tokenizer.reset(trimmed);
+  while (valid && tokenizer.hasNext()) {
+    auto token = tokenizer.getNext();
+    valid = token.hasValue();
+    if (valid) {
+      tokens_.push_back(std::move(token.value()));
+    }
+  }
+  if (!valid) {
+    VELOX_USER_FAIL("Invalid JSON path: {}", trimmed);
+  }
+  for (const auto& token : tokens_) {
+    if (token == "*") {
+      indices_.push_back(kWildcard);
+      continue;
+    }
+    auto index = folly::tryTo<int32_t>(token);
+    indices_.push_back(
+        index.hasValue() && index.value() >= 0 ? index.value() : kNoIndex);
+  }
+}
+
+bool JsonPath::extract(
+    std::string_view json,
+    std::vector<std::string_view>& matches) const {
+  matches.clear();
+  JsonScanner scanner(json);
+  return walk(scanner, 0, 0, matches) && scanner.atEnd();
+}
+
+bool JsonPath::walk(
+    JsonScanner& scanner,
+    size_t token,
+    int32_t depth,
+    std::vector<std::string_view>& matches) const {
+  const char first = scanner.peek();
+  if (token == tokens_.size() || (first != '{' && first != '[')) {
+    const char* start = scanner.position();
+    if (!scanner.skipValue(depth)) {
+      return false;
+    }
+    if (token == tokens_.size()) {
+      matches.emplace_back(start, scanner.position() - start);
+    }
+    return true;
+  }
+  if (depth >= kMaxDepth) {
+    return false;
+  }
+  scanner.advance();
+
+  if (first == '{') {
+    if (scanner.consume('}')) {
+      return true;
+    }
+    const auto numMatches = matches.size();
+    bool hasEscapes;
+    do {
+      if (scanner.peek() != '"') {
+        return false;
+      }
+      const char* keyStart = scanner.position();
+      if (!scanner.skipString(hasEscapes)) {
+        return false;
+      }
+      std::string_view key(keyStart, scanner.position() - keyStart);
+      if (!scanner.consume(':')) {
+        return false;
+      }
+      if (stringEquals(key, hasEscapes, tokens_[token])) {
+        // The last of duplicate keys replaces the earlier ones.
+        matches.resize(numMatches);
+        if (!walk(scanner, token + 1, depth + 1, matches)) {
+          return false;
+        }
+      } else if (!scanner.skipValue(depth + 1)) {
+        return false;
+      }
+    } while (scanner.consume(','));
+    return scanner.consume('}');
+  }
+
+  if (scanner.consume(']')) {
+    return true;
+  }
+  const auto index = indices_[token];
+  int32_t i = 0;
+  do {
+    bool ok = index == kWildcard || index == i
+        ? walk(scanner, token + 1, depth + 1, matches)
+        : scanner.skipValue(depth + 1);
+    if (!ok) {
+      return false;
+    }
+    ++i;
+  } while (scanner.consume(','));
+  return scanner.consume(']');
+}
+
+size_t unescapeJsonString(std::string_view literal, char* out) {
+  const char* pos = literal.data() + 1;
+  const char* end = literal.data() + literal.size() - 1;
+  char* start = out;
+  while (pos < end) {
+    auto* backslash =
+        static_cast<const char*>(std::memchr(pos, '\\', end - pos));
+    auto* plainEnd = backslash ? backslash : end;
+    std::memcpy(out, pos, plainEnd - pos);
+    out += plainEnd - pos;
+    if (!backslash) {
+      break;
+    }
+    pos = backslash + 2;
+    switch (backslash[1]) {
+      case 'b':
+        *out++ = '\b';
+        break;
+      case 'f':
+        *out++ = '\f';
+        break;
+      case 'n':
+        *out++ = '\n';
+        break;
+      case 'r':
+        *out++ = '\r';
+        break;
+      case 't':
+        *out++ = '\t';
+        break;
+      case 'u': {
+        auto codePoint = parseHex4(pos);
+        pos += 4;
+        if (codePoint >= 0xd800 && codePoint < 0xdc00 && end - pos >= 6 &&
+            pos[0] == '\\' && pos[1] == 'u') {
+          auto low = parseHex4(pos + 2);
+          if (low >= 0xdc00 && low < 0xe000) {
+            codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+            pos += 6;
+          }
+        }
+        out += writeUtf8(codePoint, out);
+        break;
+      }
+      default:
+        *out++ = backslash[1];
+    }
+  }
+  return out - start;
+}
+
+size_t compactJson(std::string_view value, char* out) {
+  char* start = out;
+  bool inString = false;
+  bool escaped = false;
+  for (char c : value) {
+    if (inString) {
+      *out++ = c;
+      if (escaped) {
+        escaped = false;
+      } else if (c == '\\') {
+        escaped = true;
+      } else if (c == '"') {
+        inString = false;
+      }
+    } else if (!isWhitespace(c)) {
+      *out++ = c;
+      inString = c == '"';
+    }
+  }
+  return out - start;
+}
+
+namespace {
+
+// Calls 'matches' on the text of the elements of the JSON array 'json' up to
+// the first one for which it returns true.
+template <typename Matches>
+std::optional<bool> arrayContains(std::string_view json, Matches matches) {
+  JsonScanner scanner(json);
+  if (scanner.peek() != '[') {
+    return std::nullopt;
+  }
+  scanner.advance();
+  if (!scanner.consume(']')) {
+    do {
+      scanner.peek();
+      const char* start = scanner.position();
+      if (!scanner.skipValue(1)) {
+        return std::nullopt;
+      }
+      if (matches(std::string_view(start, scanner.position() - start))) {
+        return true;
+      }
+    } while (scanner.consume(','));
+    if (!scanner.consume(']')) {
+      return std::nullopt;
+    }
+  }
+  if (!scanner.atEnd()) {
+    return std::nullopt;
+  }
+  return false;
+}
+
+bool isIntegerText(std::string_view number) {
+  return number.find_first_of(".eE") == std::string_view::npos;
+}
+
+} // namespace
+
+std::optional<int64_t> jsonArrayLength(std::string_view json) {
+  int64_t length = 0;
+  auto valid = arrayContains(json, [&](auto /*element*/) {
+    ++length;
+    return false;
+  });
+  if (!valid.has_value()) {
+    return std::nullopt;
+  }
+  return length;
+}
+
+std::optional<bool> jsonArrayContains(std::string_view json, int64_t value) {
+  return arrayContains(json, [&](auto element) {
+    if (jsonKind(element) != JsonKind::kNumber || !isIntegerText(element)) {
+      return false;
+    }
+    auto number = folly::tryTo<int64_t>(
+        folly::StringPiece(element.data(), element.size()));
+    return number.hasValue() && number.value() == value;
+  });
+}
+
+std::optional<bool> jsonArrayContains(std::string_view json, double value) {
+  return arrayContains(json, [&](auto element) {
+    if (jsonKind(element) != JsonKind::kNumber) {
+      return false;
+    }
+    auto number = folly::tryTo<double>(
+        folly::StringPiece(element.data(), element.size()));
+    return number.hasValue() && number.value() == value;
+  });
+}
+
+std::optional<bool> jsonArrayContains(std::string_view json, bool value) {
+  return arrayContains(json, [&](auto element) {
+    return jsonKind(element) == JsonKind::kBool &&
+        (element[0] == 't') == value;
+  });
+}
+
+std::optional<bool> jsonArrayContains(
+    std::string_view json,
+    std::string_view value) {
+  return arrayContains(json, [&](auto element) {
+    return jsonKind(element) == JsonKind::kString &&
+        stringEquals(
+               element,
+               element.find('\\') != std::string_view::npos,
+               value);
+  });
+}
+
+} // namespace facebook::velox::functions
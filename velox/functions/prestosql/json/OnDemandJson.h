@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <folly/Range.h>
+
+namespace facebook::velox::functions {
+
+enum class JsonKind { kObject, kArray, kString, kNumber, kBool, kNull };
+
+// Returns the kind of the JSON value whose text is 'value'. 'value' must be
+// valid JSON without leading whitespace, e.g. a match of JsonPath::extract().
+inline JsonKind jsonKind(std::string_view value) {
+  switch (value[0]) {
+    case '{':
+      return JsonKind::kObject;
+    case '[':
+      return JsonKind::kArray;
+    case '"':
+      return JsonKind::kString;
+    case 't':
+    case 'f':
+      return JsonKind::kBool;
+    case 'n':
+      return JsonKind::kNull;
+    default:
+      return JsonKind::kNumber;
+  }
+}
+
+class JsonScanner;
+
+// A JSON path tokenized once, e.g. for a constant path argument, and applied
+// to JSON text on demand in the manner of simdjson's On Demand API. The text
+// is scanned once without building a DOM: values off the path are validated
+// and skipped without allocation and the selected values are returned as
+// ranges of the text. See jsonExtract() for the supported paths.
+class JsonPath {
+ public:
+  // Throws VeloxUserError if 'path' is not a valid JSON path.
+  explicit JsonPath(folly::StringPiece path);
+
+  // Sets 'matches' to the text of the values 'this' selects in 'json', in
+  // document order. Of duplicate keys in an object, the last one counts.
+  // Returns false if 'json' is not valid JSON.
+  bool extract(std::string_view json, std::vector<std::string_view>& matches)
+      const;
+
+ private:
+  bool walk(
+      JsonScanner& scanner,
+      size_t token,
+      int32_t depth,
+      std::vector<std::string_view>& matches) const;
+
+  std::vector<std::string> tokens_;
+
+  // The array index selected by each of 'tokens_', kWildcard for all
+  // elements or kNoIndex if the token selects no elements.
+  std::vector<int32_t> indices_;
+};
+
+// Writes the value of the JSON string literal 'literal', including the
+// quotes, to 'out'. Returns the number of bytes written, which is at most
+// literal.size(). 'literal' must be valid.
+size_t unescapeJsonString(std::string_view literal, char* out);
+
+// Writes the valid JSON 'value' without the whitespace between tokens to
+// 'out'. Returns the number of bytes written, which is at most value.size().
+size_t compactJson(std::string_view value, char* out);
+
+// Returns the number of elements of the JSON array 'json' or std::nullopt if
+// 'json' is not a valid JSON array.
+std::optional<int64_t> jsonArrayLength(std::string_view json);
+
+// Returns whether the JSON array 'json' has an element equal to 'value' or
+// std::nullopt if 'json' is not a JSON array. The array is scanned up to the
+// first match. A BIGINT matches integer numbers, a DOUBLE any number, a
+// BOOLEAN true or false and a VARCHAR strings.
+std::optional<bool> jsonArrayContains(std::string_view json, int64_t value);
+std::optional<bool> jsonArrayContains(std::string_view json, double value);
+std::optional<bool> jsonArrayContains(std::string_view json, bool value);
+std::optional<bool> jsonArrayContains(
+    std::string_view json,
+    std::string_view value);
+
+} // namespace facebook::velox::functions
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/prestosql/json/OnDemandJson.h"
+
+#include "gtest/gtest.h"
+#include "velox/common/base/VeloxException.h"
+
+using namespace facebook::velox::functions;
+using facebook::velox::VeloxUserError;
+
+namespace {
+std::optional<std::vector<std::string>> extract(
+    const std::string& json,
+    const std::string& path) {
+  std::vector<std::string_view> matches;
+  if (!JsonPath(path).extract(json, matches)) {
+    return std::nullopt;
+  }
+  return std::vector<std::string>(matches.begin(), matches.end());
+}
+
+std::string unescape(const std::string& literal) {
+  std::string result(literal.size(), '\0');
+  result.resize(unescapeJsonString(literal, result.data()));
+  return result;
+}
+
+std::string compact(const std::string& json) {
+  std::string result(json.size(), '\0');
+  result.resize(compactJson(json, result.data()));
+  return result;
+}
+} // namespace
+
+TEST(OnDemandJsonTest, extract) {
+  using Matches = std::vector<std::string>;
+  const std::string json = R"({"store": {"fruit": [
+      {"weight": 8, "type": "apple"}, {"weight": 9, "type": "pear"}],
+      "bicycle": {"price": 19.95, "color": "red"}},
+      "email": "amy@only_for_json_udf_test.net", "owner": "amy"})";
+  EXPECT_EQ(extract(json, "$.owner"), Matches{R"("amy")"});
+  EXPECT_EQ(
+      extract(json, "$.store.fruit[0]"),
+      Matches{R"({"weight": 8, "type": "apple"})"});
+  EXPECT_EQ(
+      extract(json, "$.store.fruit[*].type"),
+      (Matches{R"("apple")", R"("pear")"}));
+  EXPECT_EQ(extract(json, "$.store.bicycle.price"), Matches{"19.95"});
+  EXPECT_EQ(
+      extract(json, "$[\"store\"][\"bicycle\"].color"), Matches{R"("red")"});
+  EXPECT_EQ(extract(json, "$.non_exist_key"), Matches{});
+  EXPECT_EQ(extract(json, "$.store.fruit[2]"), Matches{});
+  EXPECT_EQ(extract(json, "$.owner.name"), Matches{});
+  EXPECT_EQ(extract(" [1, 2] ", "$"), Matches{"[1, 2]"});
+
+  // Escaped keys and the last of duplicate keys.
+  EXPECT_EQ(extract(R"({"k\u0031": 1})", "$.k1"), Matches{"1"});
+  EXPECT_EQ(extract(R"({"a": 1, "a": [2]})", "$.a"), Matches{"[2]"});
+
+  // Invalid JSON anywhere in the text.
+  EXPECT_EQ(extract(R"({"a": 1, "b": [2,]})", "$.a"), std::nullopt);
+  EXPECT_EQ(extract(R"({"a": 1} x)", "$.a"), std::nullopt);
+  EXPECT_EQ(extract(R"({"a": 01})", "$.a"), std::nullopt);
+  EXPECT_EQ(extract(R"(["\x"])", "$[0]"), std::nullopt);
+  EXPECT_EQ(extract("", "$"), std::nullopt);
+  EXPECT_EQ(
+      extract(std::string(200, '[') + std::string(200, ']'), "$"),
+      std::nullopt);
+
+  EXPECT_THROW(JsonPath(""), VeloxUserError);
+  EXPECT_THROW(JsonPath("$[-1]"), VeloxUserError);
+  EXPECT_THROW(JsonPath("$.k1."), VeloxUserError);
+}
+
+TEST(OnDemandJsonTest, longStrings) {
+  // Strings longer than a SIMD batch, with escapes at different offsets.
+  for (auto i = 0; i < 70; ++i) {
+    std::string value(i, 'x');
+    auto literal = "\"" + value + "\\n" + value + "\"";
+    auto matches = extract("[" + literal + "]", "$[0]");
+    ASSERT_TRUE(matches.has_value());
+    ASSERT_EQ(*matches, std::vector<std::string>{literal});
+    EXPECT_EQ(unescape(literal), value + "\n" + value);
+  }
+  EXPECT_EQ(extract("[\"" + std::string(100, 'x'), "$[0]"), std::nullopt);
+}
+
+TEST(OnDemandJsonTest, unescape) {
+  EXPECT_EQ(unescape(R"("plain")"), "plain");
+  EXPECT_EQ(unescape(R"("a\"b\\c\/d\te")"), "a\"b\\c/d\te");
+  EXPECT_EQ(unescape(R"("I \u2665 UTF-8")"), "I \u2665 UTF-8");
+  EXPECT_EQ(unescape(R"("\ud834\udd1e clef")"), "\U0001D11E clef");
+}
+
+TEST(OnDemandJsonTest, compact) {
+  EXPECT_EQ(
+      compact(R"({ "a b" : [1, 2],
+          "c": "\" x " })"),
+      R"({"a b":[1,2],"c":"\" x "})");
+}
+
+TEST(OnDemandJsonTest, arrays) {
+  EXPECT_EQ(jsonArrayLength("[]"), 0);
+  EXPECT_EQ(jsonArrayLength(R"([1, "a", [2, 3], {"b": 4}])"), 4);
+  EXPECT_EQ(jsonArrayLength(R"({"a": 1})"), std::nullopt);
+  EXPECT_EQ(jsonArrayLength("[1, 2"), std::nullopt);
+
+  const std::string_view json = R"([1, 2.5, true, "a\"b", null])";
+  EXPECT_EQ(jsonArrayContains(json, int64_t(1)), true);
+  EXPECT_EQ(jsonArrayContains(json, int64_t(2)), false);
+  EXPECT_EQ(jsonArrayContains(json, 2.5), true);
+  EXPECT_EQ(jsonArrayContains(json, 1.0), true);
+  EXPECT_EQ(jsonArrayContains(json, true), true);
+  EXPECT_EQ(jsonArrayContains(json, false), false);
+  EXPECT_EQ(jsonArrayContains(json, std::string_view("a\"b")), true);
+  EXPECT_EQ(jsonArrayContains(json, std::string_view("a")), false);
+  EXPECT_EQ(jsonArrayContains("1", int64_t(1)), std::nullopt);
+  // The match is found before the invalid part of the text.
+  EXPECT_EQ(jsonArrayContains("[1, x]", int64_t(1)), true);
+  EXPECT_EQ(jsonArrayContains("[1, x]", int64_t(2)), std::nullopt);
+}
@@ -20,15 +20,35 @@
 
 namespace facebook::velox::functions {
 
+namespace {
+// Registers the comparison for the types not taken by the SIMD vector
+// function of the same name.
+template <template <class> class T>
+void registerNonNumericComparison(const std::vector<std::string>& aliases) {
+  registerFunction<T, bool, Varchar, Varchar>(aliases);
+  registerFunction<T, bool, Varbinary, Varbinary>(aliases);
+  registerFunction<T, bool, bool, bool>(aliases);
+  registerFunction<T, bool, Date, Date>(aliases);
+}
+} // namespace
+
 void registerComparisonFunctions() {
-  registerBinaryScalar<EqFunction, bool>({"eq"});
-  registerFunction<EqFunction, bool, Generic<T1>, Generic<T1>>({"eq"});
+  // Numeric, decimal and timestamp comparisons are vector functions that
+  // compare flat and constant inputs with SIMD. eq also takes the complex
+  // types. Simple functions resolve first, so there is no generic simple eq.
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_simd_comparison_eq, "eq");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_simd_comparison_neq, "neq");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_simd_comparison_lt, "lt");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_simd_comparison_gt, "gt");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_simd_comparison_lte, "lte");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_simd_comparison_gte, "gte");
 
-  registerBinaryScalar<NeqFunction, bool>({"neq"});
-  registerBinaryScalar<LtFunction, bool>({"lt"});
-  registerBinaryScalar<GtFunction, bool>({"gt"});
-  registerBinaryScalar<LteFunction, bool>({"lte"});
-  registerBinaryScalar<GteFunction, bool>({"gte"});
+  registerNonNumericComparison<EqFunction>({"eq"});
+  registerNonNumericComparison<NeqFunction>({"neq"});
+  registerNonNumericComparison<LtFunction>({"lt"});
+  registerNonNumericComparison<GtFunction>({"gt"});
+  registerNonNumericComparison<LteFunction>({"lte"});
+  registerNonNumericComparison<GteFunction>({"gte"});
   registerBinaryScalar<DistinctFromFunction, bool>({"distinct_from"});
 
   registerFunction<BetweenFunction, bool, int8_t, int8_t, int8_t>({"between"});
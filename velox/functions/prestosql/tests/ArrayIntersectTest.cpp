@@ -256,3 +256,22 @@ TEST_F(ArrayIntersectTest, constant) {
   testExpr(expected, "array_intersect(C0, ARRAY[1,NULL,4])", {array1});
   testExpr(expected, "array_intersect(ARRAY[1,NULL,4], C0)", {array1});
 }
+
+// When the right-hand side is a constant vector rather than a literal.
+TEST_F(ArrayIntersectTest, constantColumn) {
+  auto array1 = makeNullableArrayVector<int64_t>({
+      {1, 2, 3},
+      {2, 4, 2},
+      {5, std::nullopt},
+      {},
+  });
+  auto array2 = BaseVector::wrapInConstant(
+      4, 0, makeNullableArrayVector<int64_t>({{2, 5, std::nullopt}}));
+  auto expected = makeNullableArrayVector<int64_t>({
+      {2},
+      {2},
+      {5, std::nullopt},
+      {},
+  });
+  testExpr(expected, "array_intersect(C0, C1)", {array1, array2});
+}
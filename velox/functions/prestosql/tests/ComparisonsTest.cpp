@@ -95,6 +95,79 @@ TEST_F(ComparisonsTest, betweenDate) {
   }
 }
 
+TEST_F(ComparisonsTest, numericEncodings) {
+  // 1'003 rows make a partial last word and a partial last batch.
+  const vector_size_t size = 1'003;
+  auto left = makeFlatVector<int64_t>(
+      size, [](auto row) { return row % 7; }, nullEvery(11));
+  auto right = makeFlatVector<int64_t>(size, [](auto row) { return row % 5; });
+  auto data = makeRowVector(
+      {left,
+       right,
+       wrapInDictionary(
+           makeIndices(size, [&](auto row) { return size - 1 - row; }),
+           size,
+           right),
+       makeFlatVector<double>(size, [](auto row) { return row * 0.5; })});
+
+  auto test = [&](const std::string& expression, auto expectedFn) {
+    auto expected = makeFlatVector<bool>(size, expectedFn, nullEvery(11));
+    assertEqualVectors(
+        expected, evaluate<SimpleVector<bool>>(expression, data));
+  };
+
+  test("c0 = c1", [](auto row) { return row % 7 == row % 5; });
+  test("c0 <> c1", [](auto row) { return row % 7 != row % 5; });
+  test("c0 < 3", [](auto row) { return row % 7 < 3; });
+  test("3 < c0", [](auto row) { return 3 < row % 7; });
+  test("c0 >= c2", [&](auto row) { return row % 7 >= (size - 1 - row) % 5; });
+  test("c0 <= 4", [](auto row) { return row % 7 <= 4; });
+
+  // Only every 3rd row is evaluated. The others are null.
+  auto result = evaluate<SimpleVector<bool>>(
+      "if(c1 % 3 = 0, c3 > 100.0, null)", data);
+  auto expected = makeFlatVector<bool>(
+      size,
+      [](auto row) { return row * 0.5 > 100.0; },
+      [](auto row) { return row % 5 % 3 != 0; });
+  assertEqualVectors(expected, result);
+}
+
+TEST_F(ComparisonsTest, timestampEncodings) {
+  const vector_size_t size = 1'003;
+  auto millis = [](auto row) {
+    return Timestamp::fromMillis((row % 7) * 1'000 - 3'500);
+  };
+  auto left = makeFlatVector<Timestamp>(size, millis, nullEvery(11));
+  auto right = makeFlatVector<Timestamp>(
+      size, [](auto row) { return Timestamp(row % 5 - 3, 0); });
+  auto data = makeRowVector({left, right});
+
+  auto test = [&](const std::string& expression, auto expectedFn) {
+    auto expected = makeFlatVector<bool>(size, expectedFn, nullEvery(11));
+    assertEqualVectors(
+        expected, evaluate<SimpleVector<bool>>(expression, data));
+  };
+
+  test("c0 = c1", [&](auto row) {
+    return millis(row) == Timestamp(row % 5 - 3, 0);
+  });
+  test("c0 < c1", [&](auto row) {
+    return millis(row) < Timestamp(row % 5 - 3, 0);
+  });
+  test("c0 >= cast('1970-01-01 00:00:01' as timestamp)", [&](auto row) {
+    return millis(row) >= Timestamp(1, 0);
+  });
+
+  // Timestamps past 2262 do not fit in nanoseconds and compare row by row.
+  auto far = makeFlatVector<Timestamp>(size, [](auto row) {
+    return Timestamp(Timestamp::kMaxNanosSeconds + row % 3, 0);
+  });
+  data = makeRowVector({left, far});
+  test("c0 < c1", [](auto /*row*/) { return true; });
+  test("c1 > c0", [](auto /*row*/) { return true; });
+}
+
 TEST_F(ComparisonsTest, eqArray) {
   auto test =
       [&](const std::optional<std::vector<std::optional<int64_t>>>& array1,
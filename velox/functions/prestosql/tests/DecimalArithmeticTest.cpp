@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/functions/prestosql/tests/FunctionBaseTest.h"
+#include "velox/type/DecimalUtil.h"
+
+namespace facebook::velox {
+namespace {
+
+class DecimalArithmeticTest : public functions::test::FunctionBaseTest {
+ protected:
+  void testDecimalExpr(
+      const std::string& expression,
+      const std::vector<VectorPtr>& inputs,
+      const VectorPtr& expected) {
+    auto result = evaluate(expression, makeRowVector(inputs));
+    ASSERT_EQ(*result->type(), *expected->type());
+    assertEqualVectors(expected, result);
+  }
+};
+
+TEST_F(DecimalArithmeticTest, add) {
+  // decimal(10, 2) + decimal(5, 3) -> decimal(12, 3)
+  auto a =
+      makeDecimalFlatVector({100, -250, std::nullopt, 1}, DECIMAL(10, 2));
+  auto b = makeDecimalFlatVector({1, 2, 3, std::nullopt}, DECIMAL(5, 3));
+  testDecimalExpr(
+      "c0 + c1",
+      {a, b},
+      makeDecimalFlatVector(
+          {1001, -2498, std::nullopt, std::nullopt}, DECIMAL(12, 3)));
+  testDecimalExpr(
+      "c0 - c1",
+      {a, b},
+      makeDecimalFlatVector(
+          {999, -2502, std::nullopt, std::nullopt}, DECIMAL(12, 3)));
+
+  // Equal scales with enough rows for the SIMD path and its tail.
+  std::vector<std::optional<int128_t>> values;
+  std::vector<std::optional<int128_t>> sums;
+  for (auto i = 0; i < 1'003; ++i) {
+    values.push_back(i * 1'000'000 - 500'000'000);
+    sums.push_back(2 * (i * 1'000'000 - 500'000'000));
+  }
+  auto c = makeDecimalFlatVector(values, DECIMAL(17, 4));
+  testDecimalExpr("c0 + c0", {c}, makeDecimalFlatVector(sums, DECIMAL(18, 4)));
+
+  // Short + long -> long.
+  auto d =
+      makeDecimalFlatVector({DecimalUtil::kPowersOfTen[19]}, DECIMAL(20, 2));
+  auto e = makeDecimalFlatVector({5}, DECIMAL(3, 1));
+  testDecimalExpr(
+      "c0 + c1",
+      {d, e},
+      makeDecimalFlatVector(
+          {DecimalUtil::kPowersOfTen[19] + 50}, DECIMAL(21, 2)));
+}
+
+TEST_F(DecimalArithmeticTest, overflow) {
+  // decimal(38, 0) + decimal(38, 0) is capped at decimal(38, 0).
+  const auto max = DecimalUtil::kPowersOfTen[38] - 1;
+  auto a = makeDecimalFlatVector({max, 1}, DECIMAL(38, 0));
+  auto b = makeDecimalFlatVector({1, 1}, DECIMAL(38, 0));
+  VELOX_ASSERT_THROW(
+      evaluate("c0 + c1", makeRowVector({a, b})),
+      "Decimal overflow: result does not fit DECIMAL(38, 0)");
+  testDecimalExpr(
+      "c0 - c1", {a, b}, makeDecimalFlatVector({max - 1, 0}, DECIMAL(38, 0)));
+}
+
+TEST_F(DecimalArithmeticTest, multiply) {
+  // decimal(10, 2) * decimal(5, 3) -> decimal(15, 5)
+  auto a = makeDecimalFlatVector({150, -3, std::nullopt}, DECIMAL(10, 2));
+  auto b = makeDecimalFlatVector({2'000, 1'500, 1}, DECIMAL(5, 3));
+  testDecimalExpr(
+      "c0 * c1",
+      {a, b},
+      makeDecimalFlatVector({300'000, -4'500, std::nullopt}, DECIMAL(15, 5)));
+
+  // decimal(10, 0) * decimal(10, 0) -> decimal(20, 0)
+  auto c = makeDecimalFlatVector({9'999'999'999}, DECIMAL(10, 0));
+  testDecimalExpr(
+      "c0 * c0",
+      {c},
+      makeDecimalFlatVector(
+          {int128_t(9'999'999'999) * int128_t(9'999'999'999)},
+          DECIMAL(20, 0)));
+}
+
+TEST_F(DecimalArithmeticTest, divide) {
+  // decimal(5, 2) / decimal(3, 1) -> decimal(6, 2): 1.00 / 0.3 = 3.33 and
+  // 2.00 / 0.3 = 6.67.
+  auto a =
+      makeDecimalFlatVector({100, 200, -200, std::nullopt}, DECIMAL(5, 2));
+  auto b = makeDecimalFlatVector({3, 3, 3, 3}, DECIMAL(3, 1));
+  testDecimalExpr(
+      "c0 / c1",
+      {a, b},
+      makeDecimalFlatVector({333, 667, -667, std::nullopt}, DECIMAL(6, 2)));
+
+  auto zero = makeDecimalFlatVector({0, 0, 0, 0}, DECIMAL(3, 1));
+  VELOX_ASSERT_THROW(
+      evaluate("c0 / c1", makeRowVector({a, zero})), "Division by zero");
+}
+
+TEST_F(DecimalArithmeticTest, compare) {
+  auto a =
+      makeDecimalFlatVector({100, 250, -1, std::nullopt}, DECIMAL(10, 2));
+  auto b = makeDecimalFlatVector({100, 249, 1, 1}, DECIMAL(12, 2));
+  auto expectLess = makeNullableFlatVector<bool>(
+      {false, false, true, std::nullopt});
+  assertEqualVectors(expectLess, evaluate("c0 < c1", makeRowVector({a, b})));
+  assertEqualVectors(
+      makeNullableFlatVector<bool>({true, false, false, std::nullopt}),
+      evaluate("c0 = c1", makeRowVector({a, b})));
+
+  // Different scales and short with long.
+  auto c = makeDecimalFlatVector({1'000, 2'501, -10, 0}, DECIMAL(20, 3));
+  assertEqualVectors(
+      makeNullableFlatVector<bool>({true, false, true, std::nullopt}),
+      evaluate("c0 = c1", makeRowVector({a, c})));
+  assertEqualVectors(
+      makeNullableFlatVector<bool>({false, true, false, std::nullopt}),
+      evaluate("c0 < c1", makeRowVector({a, c})));
+}
+
+TEST_F(DecimalArithmeticTest, cast) {
+  auto a =
+      makeDecimalFlatVector({12'345, -12'355, std::nullopt}, DECIMAL(10, 2));
+  testDecimalExpr(
+      "cast(c0 as decimal(10, 1))",
+      {a},
+      makeDecimalFlatVector({1'235, -1'236, std::nullopt}, DECIMAL(10, 1)));
+  testDecimalExpr(
+      "cast(c0 as decimal(25, 4))",
+      {a},
+      makeDecimalFlatVector(
+          {1'234'500, -1'235'500, std::nullopt}, DECIMAL(25, 4)));
+  assertEqualVectors(
+      makeNullableFlatVector<int64_t>({123, -124, std::nullopt}),
+      evaluate("cast(c0 as bigint)", makeRowVector({a})));
+  assertEqualVectors(
+      makeNullableFlatVector<double>({123.45, -123.55, std::nullopt}),
+      evaluate("cast(c0 as double)", makeRowVector({a})));
+  assertEqualVectors(
+      makeNullableFlatVector<StringView>({"123.45", "-123.55", std::nullopt}),
+      evaluate("cast(c0 as varchar)", makeRowVector({a})));
+
+  auto integers = makeNullableFlatVector<int32_t>({7, -3, std::nullopt});
+  testDecimalExpr(
+      "cast(c0 as decimal(5, 2))",
+      {integers},
+      makeDecimalFlatVector({700, -300, std::nullopt}, DECIMAL(5, 2)));
+  auto doubles = makeFlatVector<double>({1.005, -2.5});
+  testDecimalExpr(
+      "cast(c0 as decimal(5, 1))",
+      {doubles},
+      makeDecimalFlatVector({10, -25}, DECIMAL(5, 1)));
+  auto strings = makeFlatVector<StringView>({"1.25", "-0.5", "+3"});
+  testDecimalExpr(
+      "cast(c0 as decimal(5, 1))",
+      {strings},
+      makeDecimalFlatVector({13, -5, 30}, DECIMAL(5, 1)));
+
+  VELOX_ASSERT_THROW(
+      evaluate("cast(c0 as decimal(3, 2))", makeRowVector({a})),
+      "Decimal overflow");
+  VELOX_ASSERT_THROW(
+      evaluate(
+          "cast(c0 as decimal(5, 1))",
+          makeRowVector({makeFlatVector<StringView>({"1.x"})})),
+      "Invalid decimal digit");
+  testDecimalExpr(
+      "try_cast(c0 as decimal(3, 2))",
+      {makeFlatVector<int64_t>({100, 1})},
+      makeDecimalFlatVector({std::nullopt, 100}, DECIMAL(3, 2)));
+}
+
+} // namespace
+} // namespace facebook::velox
@@ -371,6 +371,49 @@ TEST_F(ElementAtTest, variableInputMap) {
   testVariableInputMap<StringView>(); // VARCHAR
 }
 
+TEST_F(ElementAtTest, sortedKeysMap) {
+  // Even keys 0, 2, ... 98 in each map.
+  auto sizeAt = [](vector_size_t /* row */) { return 50; };
+  auto keyAt = [](vector_size_t idx) { return (idx % 50) * 2; };
+  auto valueAt = [](vector_size_t idx) { return idx; };
+  auto keys = makeFlatVector<int64_t>(
+      kVectorSize, [](vector_size_t row) { return row % 101; });
+  auto expectedValueAt = [](vector_size_t row) {
+    return row * 50 + (row % 101) / 2;
+  };
+  auto expectedNullAt = [](vector_size_t row) {
+    return (row % 101) % 2 != 0 || row % 101 == 100;
+  };
+
+  for (auto sortedKeys : {false, true}) {
+    auto mapVector =
+        makeMapVector<int64_t, int64_t>(kVectorSize, sizeAt, keyAt, valueAt);
+    mapVector->setSortedKeys(sortedKeys);
+    testElementAt<int64_t>(
+        "element_at(C0, C1)",
+        {mapVector, keys},
+        expectedValueAt,
+        expectedNullAt);
+
+    for (auto key : {-1, 0, 37, 98, 99}) {
+      testElementAt<int64_t>(
+          fmt::format("element_at(C0, {})", key),
+          {mapVector},
+          [&](vector_size_t row) { return row * 50 + key / 2; },
+          [&](vector_size_t /* row */) { return key % 2 != 0 || key > 98; });
+    }
+
+    // A constant key over a dictionary that repeats each map 3 times.
+    auto indices = makeIndices(
+        kVectorSize * 3, [](vector_size_t row) { return row / 3; });
+    auto dictionary = wrapInDictionary(indices, kVectorSize * 3, mapVector);
+    testElementAt<int64_t>(
+        "element_at(C0, 42)",
+        {dictionary},
+        [](vector_size_t row) { return (row / 3) * 50 + 21; });
+  }
+}
+
 TEST_F(ElementAtTest, variableInputArray) {
   {
     auto indicesVector = makeFlatVector<int64_t>(
@@ -183,6 +183,39 @@ TEST_F(InPredicateTest, tinyint) {
   testsIntegerConstant<int8_t>();
 }
 
+TEST_F(InPredicateTest, smallInList) {
+  // 16 values take the SIMD path and 17 the filter. Both must agree, also
+  // when only some rows are evaluated.
+  const vector_size_t size = 1'003;
+  auto data = makeRowVector({makeFlatVector<int32_t>(
+      size, [](auto row) { return row % 41; }, nullEvery(13))});
+
+  for (auto numValues : {1, 2, 16, 17}) {
+    std::vector<std::string> values;
+    for (auto i = 0; i < numValues; ++i) {
+      values.push_back(std::to_string(i * 2));
+    }
+    auto inList = folly::join(", ", values);
+    auto inListRange = [&](auto row) {
+      return row % 41 % 2 == 0 && row % 41 < 2 * numValues;
+    };
+
+    auto result = evaluate<SimpleVector<bool>>(
+        fmt::format("c0 IN ({})", inList), data);
+    assertEqualVectors(
+        makeFlatVector<bool>(size, inListRange, nullEvery(13)), result);
+
+    result = evaluate<SimpleVector<bool>>(
+        fmt::format("if(c0 % 3 = 0, c0 IN ({}), null)", inList), data);
+    assertEqualVectors(
+        makeFlatVector<bool>(
+            size,
+            inListRange,
+            [](auto row) { return row % 13 == 0 || row % 41 % 3 != 0; }),
+        result);
+  }
+}
+
 TEST_F(InPredicateTest, varchar) {
   const vector_size_t size = 1'000;
 
@@ -148,16 +148,35 @@ TEST_F(JsonExtractScalarTest, invalidPath) {
   EXPECT_THROW(json_extract_scalar(R"({"k1":"v1)", "$.k1]"), VeloxUserError);
 }
 
-// TODO: Folly tries to convert scalar integers, and in case they are large
-// enough it overflows and throws conversion error. In this case, we do out best
-// and return NULL, but in Presto java the large integer is returned as-is as a
-// string.
+// Numbers are returned as written, like in Presto java, also if they overflow
+// 64 bits.
 TEST_F(JsonExtractScalarTest, overflow) {
   EXPECT_EQ(
       json_extract_scalar(
           R"(184467440737095516151844674407370955161518446744073709551615)",
           "$"),
-      std::nullopt);
+      "184467440737095516151844674407370955161518446744073709551615");
+  EXPECT_EQ(json_extract_scalar(R"({"k1": 1.50})", "$.k1"), "1.50");
+}
+
+TEST_F(JsonExtractScalarTest, invalidJson) {
+  EXPECT_EQ(json_extract_scalar(R"({"k1":"v1")", "$.k1"), std::nullopt);
+  EXPECT_EQ(json_extract_scalar(R"({"k1":"v1"}, 2)", "$.k1"), std::nullopt);
+  EXPECT_EQ(json_extract_scalar(R"({"k1":null})", "$.k1"), std::nullopt);
+}
+
+TEST_F(JsonExtractScalarTest, constantPath) {
+  auto json = makeFlatVector<StringView>(
+      {R"({"k1":{"k2":"v1"}})", R"({"k1":{"k2":7}})", R"({"k1":[]})"});
+  auto result = evaluate<SimpleVector<StringView>>(
+      "json_extract_scalar(c0, '$.k1.k2')", makeRowVector({json}));
+  ::facebook::velox::test::assertEqualVectors(
+      makeNullableFlatVector<StringView>({"v1"_sv, "7"_sv, std::nullopt}),
+      result);
+  EXPECT_THROW(
+      evaluate<SimpleVector<StringView>>(
+          "json_extract_scalar(c0, '$.k1.')", makeRowVector({json})),
+      VeloxUserError);
 }
 
 } // namespace
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/prestosql/tests/FunctionBaseTest.h"
+
+namespace facebook::velox::functions::prestosql {
+
+namespace {
+
+class JsonFunctionsTest : public functions::test::FunctionBaseTest {
+ public:
+  std::optional<std::string> json_extract(
+      std::optional<std::string> json,
+      std::optional<std::string> path) {
+    return evaluateOnce<std::string>("json_extract(c0, c1)", json, path);
+  }
+
+  std::optional<int64_t> json_array_length(std::optional<std::string> json) {
+    return evaluateOnce<int64_t>("json_array_length(c0)", json);
+  }
+
+  template <typename T>
+  std::optional<bool> json_array_contains(
+      std::optional<std::string> json,
+      std::optional<T> value) {
+    return evaluateOnce<bool>("json_array_contains(c0, c1)", json, value);
+  }
+};
+
+TEST_F(JsonFunctionsTest, jsonExtract) {
+  EXPECT_EQ(json_extract(R"({"k1":"v1"})", "$.k1"), R"("v1")");
+  EXPECT_EQ(json_extract(R"({"k1": [1, 2]})", "$.k1"), "[1,2]");
+  EXPECT_EQ(
+      json_extract(R"({"k1": {"k2": "a b", "k3": 1.5}})", "$.k1"),
+      R"({"k2":"a b","k3":1.5})");
+  EXPECT_EQ(json_extract(R"([1, {"k1": null}])", "$[1].k1"), "null");
+  EXPECT_EQ(
+      json_extract(R"([{"k1": 1}, {"k1": [2]}, {"k2": 3}])", "$[*].k1"),
+      "[1,[2]]");
+  EXPECT_EQ(json_extract(R"({"k1":"v1"})", "$.k2"), std::nullopt);
+  EXPECT_EQ(json_extract(R"({"k1":"v1")", "$.k1"), std::nullopt);
+  EXPECT_THROW(json_extract(R"({"k1":"v1"})", "$.k1]"), VeloxUserError);
+
+  // The path is tokenized once if it is constant.
+  auto json = makeFlatVector<StringView>(
+      {R"({"k1":{"k2":[1]}})", R"({"k1":{}})", R"({"k1":{"k2":"x"}})"});
+  ::facebook::velox::test::assertEqualVectors(
+      makeNullableFlatVector<StringView>(
+          {"[1]"_sv, std::nullopt, R"("x")"_sv}),
+      evaluate<SimpleVector<StringView>>(
+          "json_extract(c0, '$.k1.k2')", makeRowVector({json})));
+}
+
+TEST_F(JsonFunctionsTest, jsonArrayLength) {
+  EXPECT_EQ(json_array_length("[]"), 0);
+  EXPECT_EQ(json_array_length(R"([1, "2", [3, 4], {"5": 6}])"), 4);
+  EXPECT_EQ(json_array_length(R"({"k1": [1]})"), std::nullopt);
+  EXPECT_EQ(json_array_length("[1, 2"), std::nullopt);
+  EXPECT_EQ(json_array_length(std::nullopt), std::nullopt);
+}
+
+TEST_F(JsonFunctionsTest, jsonArrayContains) {
+  const std::string json = R"([1, 2.5, true, "a", null])";
+  EXPECT_EQ(json_array_contains<int64_t>(json, 1), true);
+  EXPECT_EQ(json_array_contains<int64_t>(json, 3), false);
+  EXPECT_EQ(json_array_contains<double>(json, 2.5), true);
+  EXPECT_EQ(json_array_contains<double>(json, 1.5), false);
+  EXPECT_EQ(json_array_contains<bool>(json, true), true);
+  EXPECT_EQ(json_array_contains<bool>(json, false), false);
+  EXPECT_EQ(json_array_contains<std::string>(json, "a"), true);
+  EXPECT_EQ(json_array_contains<std::string>(json, "b"), false);
+  EXPECT_EQ(json_array_contains<int64_t>(R"({"k1": 1})", 1), std::nullopt);
+  EXPECT_EQ(json_array_contains<int64_t>(json, std::nullopt), std::nullopt);
+}
+
+} // namespace
+
+} // namespace facebook::velox::functions::prestosql
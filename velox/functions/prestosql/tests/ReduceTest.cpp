@@ -123,3 +123,46 @@ TEST_F(ReduceTest, conditional) {
       nullEvery(11));
   assertEqualVectors(expectedResult, result);
 }
+
+// Arrays of very different sizes, a lambda that returns the element itself
+// and a lambda with a capture. Each reduce step covers fewer arrays and the
+// state of an array is final at the step where it runs out of elements.
+TEST_F(ReduceTest, skewedSizes) {
+  vector_size_t size = 1'000;
+  auto sizeAt = [](auto row) { return row == 7 ? 300 : row % 4; };
+  auto inputArray = makeArrayVector<int64_t>(
+      size,
+      sizeAt,
+      [](auto row, auto index) { return row * 2 + index; },
+      nullEvery(13));
+  auto factor = makeFlatVector<int64_t>(size, [](auto row) { return row % 3; });
+  auto input = makeRowVector({inputArray, factor});
+  auto signature = rowType("s", BIGINT(), "x", BIGINT());
+  registerLambda("last", signature, input->type(), "x");
+  registerLambda("scaled_sum", signature, input->type(), "s + x * c1");
+  registerLambda("identity", rowType("s", BIGINT()), input->type(), "s");
+
+  auto result = evaluate<SimpleVector<int64_t>>(
+      "reduce(c0, -1, function('last'), function('identity'))", input);
+  auto expectedResult = makeFlatVector<int64_t>(
+      size,
+      [&](auto row) {
+        return sizeAt(row) == 0 ? -1 : row * 2 + sizeAt(row) - 1;
+      },
+      nullEvery(13));
+  assertEqualVectors(expectedResult, result);
+
+  result = evaluate<SimpleVector<int64_t>>(
+      "reduce(c0, 5, function('scaled_sum'), function('identity'))", input);
+  expectedResult = makeFlatVector<int64_t>(
+      size,
+      [&](auto row) {
+        int64_t sum = 5;
+        for (auto i = 0; i < sizeAt(row); i++) {
+          sum += (row * 2 + i) * (row % 3);
+        }
+        return sum;
+      },
+      nullEvery(13));
+  assertEqualVectors(expectedResult, result);
+}
@@ -98,7 +98,24 @@ TEST_F(URLFunctionsTest, validateURL) {
       "",
       "",
       std::nullopt);
+  validate(
+      "http://user:password@[::1]:8080/p.php?k1=v1#Ref1",
+      "http",
+      "[::1]",
+      "/p.php",
+      "Ref1",
+      "k1=v1",
+      8080);
+  validate(
+      "mailto:user@example.com#top",
+      "mailto",
+      "",
+      "user@example.com",
+      "top",
+      "",
+      std::nullopt);
   validate("foo", "", "", "", "", "", std::nullopt);
+  validate("1http://example.com", "", "", "", "", "", std::nullopt);
 }
 
 TEST_F(URLFunctionsTest, extractParameter) {
@@ -122,6 +139,10 @@ TEST_F(URLFunctionsTest, extractParameter) {
       extractParam(
           "http://example.com/path1/p.php?k1=v1&k2=v2&k3&k4#Ref1", "k6"),
       std::nullopt);
+  // A parameter with two '=' does not match.
+  EXPECT_EQ(
+      extractParam("http://example.com/p.php?k1=v1=x&k1=v2", "k1"), "v2");
+  EXPECT_EQ(extractParam("http://example.com/p.php?=v1&k2", ""), std::nullopt);
   EXPECT_EQ(extractParam("foo", ""), std::nullopt);
 }
 
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/WindowFunction.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::window {
+
+namespace {
+
+// Computes rank() and dense_rank(). Peer rows, i.e. rows with equal ORDER BY
+// keys, get the same rank. rank() leaves gaps after peer groups with more than
+// one row, while dense_rank() assigns consecutive ranks.
+template <bool isDense>
+class RankFunction : public exec::WindowFunction {
+ public:
+  explicit RankFunction(memory::MemoryPool* pool)
+      : WindowFunction(BIGINT(), pool) {}
+
+  void resetPartition(const exec::WindowPartition* /*partition*/) override {
+    currentPeerGroupStart_ = -1;
+    rank_ = 0;
+  }
+
+  void apply(
+      const BufferPtr& peerGroupStarts,
+      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& /*frameStarts*/,
+      const BufferPtr& /*frameEnds*/,
+      vector_size_t resultOffset,
+      const VectorPtr& result) override {
+    auto numRows = peerGroupStarts->size() / sizeof(vector_size_t);
+    auto rawPeerStarts = peerGroupStarts->as<vector_size_t>();
+    auto rawValues = result->asFlatVector<int64_t>()->mutableRawValues();
+    for (auto i = 0; i < numRows; ++i) {
+      auto peerStart = rawPeerStarts[i];
+      if (peerStart != currentPeerGroupStart_) {
+        currentPeerGroupStart_ = peerStart;
+        if constexpr (isDense) {
+          ++rank_;
+        } else {
+          rank_ = peerStart + 1;
+        }
+      }
+      rawValues[resultOffset + i] = rank_;
+    }
+  }
+
+ private:
+  // First row of the peer group of the last processed row.
+  vector_size_t currentPeerGroupStart_ = -1;
+  int64_t rank_ = 0;
+};
+
+template <bool isDense>
+void registerRankInternal(const std::string& name) {
+  std::vector<exec::FunctionSignaturePtr> signatures{
+      exec::FunctionSignatureBuilder().returnType("bigint").build(),
+  };
+
+  exec::registerWindowFunction(
+      name,
+      std::move(signatures),
+      [](
+          const std::vector<exec::WindowFunctionArg>& /*args*/,
+          const TypePtr& /*resultType*/,
+          memory::MemoryPool* pool,
+          HashStringAllocator* /*stringAllocator*/)
+          -> std::unique_ptr<exec::WindowFunction> {
+        return std::make_unique<RankFunction<isDense>>(pool);
+      });
+}
+
+} // namespace
+
+void registerRank(const std::string& name) {
+  registerRankInternal<false>(name);
+}
+
+void registerDenseRank(const std::string& name) {
+  registerRankInternal<true>(name);
+}
+
+} // namespace facebook::velox::window
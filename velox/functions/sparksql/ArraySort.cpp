@@ -17,6 +17,7 @@
 
 #include <memory>
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/RadixSort.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/VectorFunction.h"
@@ -104,6 +105,16 @@ void applyTyped(
   auto flatResults = (*resultElements)->asFlatVector<T>();
   T* resultRawValues = flatResults->mutableRawValues();
 
+  // Integers, floating point values and dates are sorted with
+  // sortFixedWidth(). Dates sort as their days.
+  constexpr bool kIsDate = std::is_same_v<T, Date>;
+  constexpr bool kFixedWidth = kIsDate ||
+      (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+       sizeof(T) <= sizeof(int64_t));
+  using SortType = std::conditional_t<kIsDate, int32_t, T>;
+  static_assert(!kIsDate || sizeof(Date) == sizeof(int32_t));
+  std::vector<SortType> scratch;
+
   auto processRow = [&](vector_size_t row) {
     auto size = inputArray->sizeAt(row);
     auto offset = inputArray->offsetAt(row);
@@ -142,6 +153,9 @@ void applyTyped(
       auto mid = ascending ? rowEnd - numSetBits : rowBegin + numSetBits;
       bits::fillBits(rawBits, rowBegin, mid, smallerValue);
       bits::fillBits(rawBits, mid, rowEnd, !smallerValue);
+    } else if constexpr (kFixedWidth) {
+      auto values = reinterpret_cast<SortType*>(resultRawValues);
+      sortFixedWidth(values + rowBegin, values + rowEnd, ascending, scratch);
     } else {
       if (ascending) {
         std::sort(
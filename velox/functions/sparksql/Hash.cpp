@@ -16,10 +16,15 @@
 #include "velox/functions/sparksql/Hash.h"
 
 #include <stdint.h>
+#include <cmath>
+#include <cstring>
 
 #include <folly/CPortability.h>
+#include <xsimd/xsimd.hpp>
 
 #include "velox/common/base/BitUtil.h"
+#define XXH_INLINE_ALL
+#include "velox/external/xxhash.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::functions::sparksql {
@@ -34,79 +39,240 @@ namespace {
 //
 // Signed integer types have been remapped to unsigned types (as in the
 // original) to avoid undefined signed integer overflow and sign extension.
+struct Murmur3Hash {
+  using SeedType = uint32_t;
 
-uint32_t mixK1(uint32_t k1) {
-  k1 *= 0xcc9e2d51;
-  k1 = bits::rotateLeft(k1, 15);
-  k1 *= 0x1b873593;
-  return k1;
-}
+  static uint32_t mixK1(uint32_t k1) {
+    k1 *= 0xcc9e2d51;
+    k1 = bits::rotateLeft(k1, 15);
+    k1 *= 0x1b873593;
+    return k1;
+  }
 
-uint32_t mixH1(uint32_t h1, uint32_t k1) {
-  h1 ^= k1;
-  h1 = bits::rotateLeft(h1, 13);
-  h1 = h1 * 5 + 0xe6546b64;
-  return h1;
-}
+  static uint32_t mixH1(uint32_t h1, uint32_t k1) {
+    h1 ^= k1;
+    h1 = bits::rotateLeft(h1, 13);
+    h1 = h1 * 5 + 0xe6546b64;
+    return h1;
+  }
 
-// Finalization mix - force all bits of a hash block to avalanche
-uint32_t fmix(uint32_t h1, uint32_t length) {
-  h1 ^= length;
-  h1 ^= h1 >> 16;
-  h1 *= 0x85ebca6b;
-  h1 ^= h1 >> 13;
-  h1 *= 0xc2b2ae35;
-  h1 ^= h1 >> 16;
-  return h1;
-}
+  // Finalization mix - force all bits of a hash block to avalanche
+  static uint32_t fmix(uint32_t h1, uint32_t length) {
+    h1 ^= length;
+    h1 ^= h1 >> 16;
+    h1 *= 0x85ebca6b;
+    h1 ^= h1 >> 13;
+    h1 *= 0xc2b2ae35;
+    h1 ^= h1 >> 16;
+    return h1;
+  }
 
-uint32_t hashInt32(int32_t input, uint32_t seed) {
-  uint32_t k1 = mixK1(input);
-  uint32_t h1 = mixH1(seed, k1);
-  return fmix(h1, 4);
-}
+  static uint32_t hashInt32(int32_t input, uint32_t seed) {
+    uint32_t k1 = mixK1(input);
+    uint32_t h1 = mixH1(seed, k1);
+    return fmix(h1, 4);
+  }
+
+  static uint32_t hashInt64(uint64_t input, uint32_t seed) {
+    uint32_t low = input;
+    uint32_t high = input >> 32;
+
+    uint32_t k1 = mixK1(low);
+    uint32_t h1 = mixH1(seed, k1);
+
+    k1 = mixK1(high);
+    h1 = mixH1(h1, k1);
+
+    return fmix(h1, 8);
+  }
+
+  // Spark also has an hashUnsafeBytes2 function, but it was not used at the
+  // time of implementation.
+  static uint32_t hashBytes(const StringView& input, uint32_t seed) {
+    const char* i = input.data();
+    const char* const end = input.data() + input.size();
+    uint32_t h1 = seed;
+    for (; end - i >= 4; i += 4) {
+      uint32_t word;
+      std::memcpy(&word, i, sizeof(word));
+      h1 = mixH1(h1, mixK1(word));
+    }
+    for (; i != end; ++i) {
+      h1 = mixH1(h1, mixK1(*i));
+    }
+    return fmix(h1, input.size());
+  }
+
+  // hashInt32() of 'values' with SIMD. 'hashes' are the seeds.
+  static void
+  hashInt32s(const int32_t* values, int32_t size, uint32_t* hashes) {
+    using Batch = xsimd::batch<uint32_t>;
+    const auto* input = reinterpret_cast<const uint32_t*>(values);
+    int32_t i = 0;
+    for (; i + Batch::size <= size; i += Batch::size) {
+      auto k1 = Batch::load_unaligned(input + i) * Batch(0xcc9e2d51);
+      k1 = (k1 << 15) | (k1 >> 17);
+      k1 = k1 * Batch(0x1b873593);
+      auto h1 = Batch::load_unaligned(hashes + i) ^ k1;
+      h1 = (h1 << 13) | (h1 >> 19);
+      h1 = h1 * Batch(5) + Batch(0xe6546b64);
+      h1 = h1 ^ Batch(4);
+      h1 = h1 ^ (h1 >> 16);
+      h1 = h1 * Batch(0x85ebca6b);
+      h1 = h1 ^ (h1 >> 13);
+      h1 = h1 * Batch(0xc2b2ae35);
+      h1 = h1 ^ (h1 >> 16);
+      h1.store_unaligned(hashes + i);
+    }
+    for (; i < size; ++i) {
+      hashes[i] = hashInt32(values[i], hashes[i]);
+    }
+  }
+};
+
+// Derived from org.apache.spark.sql.catalyst.expressions.XXH64 in Spark.
+// hashInt32() and hashInt64() are XXH64 of the 4 or 8 bytes of the value,
+// unrolled. Spark hashes bytes with the reference XXH64.
+struct XxHash64 {
+  using SeedType = uint64_t;
+
+  static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+  static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+  static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+  static constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+  static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
 
-uint32_t hashInt64(uint64_t input, uint32_t seed) {
-  uint32_t low = input;
-  uint32_t high = input >> 32;
+  static uint64_t rotateLeft(uint64_t value, int shift) {
+    return (value << shift) | (value >> (64 - shift));
+  }
+
+  static uint64_t fmix(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+  }
+
+  static uint64_t hashInt32(int32_t input, uint64_t seed) {
+    uint64_t hash = seed + kPrime5 + 4;
+    hash ^= static_cast<uint64_t>(static_cast<uint32_t>(input)) * kPrime1;
+    hash = rotateLeft(hash, 23) * kPrime2 + kPrime3;
+    return fmix(hash);
+  }
 
-  uint32_t k1 = mixK1(low);
-  uint32_t h1 = mixH1(seed, k1);
+  static uint64_t hashInt64(uint64_t input, uint64_t seed) {
+    uint64_t hash = seed + kPrime5 + 8;
+    hash ^= rotateLeft(input * kPrime2, 31) * kPrime1;
+    hash = rotateLeft(hash, 27) * kPrime1 + kPrime4;
+    return fmix(hash);
+  }
 
-  k1 = mixK1(high);
-  h1 = mixH1(h1, k1);
+  static uint64_t hashBytes(const StringView& input, uint64_t seed) {
+    return XXH64(input.data(), input.size(), seed);
+  }
+};
 
-  return fmix(h1, 8);
+// Floating point numbers are hashed as if they are integers, with -0 defined
+// to have the same output as +0 and all NaNs the same output as the canonical
+// NaN, as Java's floatToIntBits() and doubleToLongBits().
+int32_t floatBits(float input) {
+  if (input == 0) {
+    return 0;
+  }
+  if (std::isnan(input)) {
+    return 0x7fc00000;
+  }
+  int32_t bits;
+  std::memcpy(&bits, &input, sizeof(bits));
+  return bits;
 }
 
-// Spark also has an hashUnsafeBytes2 function, but it was not used at the time
-// of implementation.
-uint32_t hashBytes(const StringView& input, uint32_t seed) {
-  const char* i = input.data();
-  const char* const end = input.data() + input.size();
-  uint32_t h1 = seed;
-  for (; i <= end - 4; i += 4) {
-    h1 = mixH1(h1, mixK1(*reinterpret_cast<const uint32_t*>(i)));
+int64_t doubleBits(double input) {
+  if (input == 0) {
+    return 0;
   }
-  for (; i != end; ++i) {
-    h1 = mixH1(h1, mixK1(*i));
+  if (std::isnan(input)) {
+    return 0x7ff8000000000000LL;
   }
-  return fmix(h1, input.size());
+  int64_t bits;
+  std::memcpy(&bits, &input, sizeof(bits));
+  return bits;
 }
 
-// Floating point numbers are hashed as if they are integers, with
-// -0f defined to have the same output as +0f.
-uint32_t hashFloat(float input, uint32_t seed) {
-  return hashInt32(
-      input == -0.f ? 0 : *reinterpret_cast<uint32_t*>(&input), seed);
+// Hashes the non-null 'rows' of 'decoded' with 'hashOne'. A flat column
+// without nulls is hashed in a loop over its values without per-row checks,
+// with SIMD for Murmur3 of 32 bit integers.
+template <typename Hash, typename T, typename HashOne>
+void hashValues(
+    const DecodedVector& decoded,
+    const SelectivityVector& rows,
+    typename Hash::SeedType* hashes,
+    HashOne hashOne) {
+  if constexpr (!std::is_same_v<T, bool>) {
+    if (decoded.isIdentityMapping() && !decoded.mayHaveNulls() &&
+        rows.isAllSelected()) {
+      const auto* values = decoded.data<T>();
+      const auto begin = rows.begin();
+      const auto end = rows.end();
+      if constexpr (
+          std::is_same_v<Hash, Murmur3Hash> && std::is_same_v<T, int32_t>) {
+        Hash::hashInt32s(values + begin, end - begin, hashes + begin);
+      } else {
+        for (auto row = begin; row < end; ++row) {
+          hashes[row] = hashOne(values[row], hashes[row]);
+        }
+      }
+      return;
+    }
+  }
+  rows.applyToSelected([&](vector_size_t row) {
+    if (!decoded.isNullAt(row)) {
+      hashes[row] = hashOne(decoded.valueAt<T>(row), hashes[row]);
+    }
+  });
 }
 
-uint32_t hashDouble(double input, uint32_t seed) {
-  return hashInt64(
-      input == -0. ? 0 : *reinterpret_cast<uint64_t*>(&input), seed);
+// Derived from InterpretedHashFunction.hash:
+// https://github.com/apache/spark/blob/382b66e/sql/catalyst/src/main/scala/org/apache/spark/sql/catalyst/expressions/hash.scala#L532
+template <typename Hash>
+void hashColumn(
+    const DecodedVector& decoded,
+    const SelectivityVector& rows,
+    typename Hash::SeedType* hashes) {
+  using SeedType = typename Hash::SeedType;
+  const auto& type = decoded.base()->type();
+  switch (type->kind()) {
+#define CASE(typeEnum, inputType, hashFn)                           \
+  case TypeKind::typeEnum:                                          \
+    hashValues<Hash, inputType>(                                    \
+        decoded, rows, hashes, [](inputType value, SeedType seed) { \
+          return hashFn;                                            \
+        });                                                         \
+    break;
+    CASE(BOOLEAN, bool, Hash::hashInt32(value, seed));
+    CASE(TINYINT, int8_t, Hash::hashInt32(value, seed));
+    CASE(SMALLINT, int16_t, Hash::hashInt32(value, seed));
+    CASE(INTEGER, int32_t, Hash::hashInt32(value, seed));
+    CASE(BIGINT, int64_t, Hash::hashInt64(value, seed));
+    CASE(VARCHAR, StringView, Hash::hashBytes(value, seed));
+    CASE(VARBINARY, StringView, Hash::hashBytes(value, seed));
+    CASE(REAL, float, Hash::hashInt32(floatBits(value), seed));
+    CASE(DOUBLE, double, Hash::hashInt64(doubleBits(value), seed));
+    CASE(DATE, Date, Hash::hashInt32(value.days(), seed));
+    CASE(TIMESTAMP, Timestamp, Hash::hashInt64(value.toMicros(), seed));
+#undef CASE
+    default:
+      VELOX_NYI("Unsupported type for HASH(): {}", type->toString());
+  }
 }
 
+template <typename Hash, typename TResult>
 class HashFunction final : public exec::VectorFunction {
+ public:
+  explicit HashFunction(TResult seed) : seed_(seed) {}
+
   bool isDefaultNullBehavior() const final {
     return false;
   }
@@ -117,53 +283,41 @@ class HashFunction final : public exec::VectorFunction {
       const TypePtr& /* outputType */,
       exec::EvalCtx* context,
       VectorPtr* resultRef) const final {
-    constexpr int32_t kSeed = 42;
-
-    BaseVector::ensureWritable(rows, INTEGER(), context->pool(), resultRef);
-
-    FlatVector<int32_t>& result = *(*resultRef)->as<FlatVector<int32_t>>();
-    rows.applyToSelected([&](int row) { result.set(row, kSeed); });
+    BaseVector::ensureWritable(
+        rows, CppToType<TResult>::create(), context->pool(), resultRef);
 
-    exec::LocalSelectivityVector selectedMinusNulls(context);
+    auto* result = (*resultRef)->as<FlatVector<TResult>>();
+    result->clearNulls(rows);
+    auto* hashes = reinterpret_cast<typename Hash::SeedType*>(
+        result->mutableRawValues());
+    rows.applyToSelected([&](vector_size_t row) { hashes[row] = seed_; });
 
     for (auto& arg : args) {
       exec::LocalDecodedVector decoded(context, *arg, rows);
-      const SelectivityVector* selected = &rows;
-      if (arg->mayHaveNulls()) {
-        *selectedMinusNulls.get(rows.end()) = rows;
-        selectedMinusNulls->deselectNulls(
-            arg->flatRawNulls(rows), rows.begin(), rows.end());
-        selected = selectedMinusNulls.get();
-      }
-      switch (arg->type()->kind()) {
-#define CASE(typeEnum, hashFn, inputType)                                      \
-  case TypeKind::typeEnum:                                                     \
-    selected->applyToSelected([&](int row) {                                   \
-      result.set(                                                              \
-          row, hashFn(decoded->valueAt<inputType>(row), result.valueAt(row))); \
-    });                                                                        \
-    break;
-        // Derived from InterpretedHashFunction.hash:
-        // https://github.com/apache/spark/blob/382b66e/sql/catalyst/src/main/scala/org/apache/spark/sql/catalyst/expressions/hash.scala#L532
-        CASE(BOOLEAN, hashInt32, bool);
-        CASE(TINYINT, hashInt32, int8_t);
-        CASE(SMALLINT, hashInt32, int16_t);
-        CASE(INTEGER, hashInt32, int32_t);
-        CASE(BIGINT, hashInt64, int64_t);
-        CASE(VARCHAR, hashBytes, StringView);
-        CASE(VARBINARY, hashBytes, StringView);
-        CASE(REAL, hashFloat, float);
-        CASE(DOUBLE, hashDouble, double);
-#undef CASE
-        default:
-          VELOX_NYI("Unsupported type for HASH(): {}", arg->type()->toString());
-      }
+      hashColumn<Hash>(*decoded, rows, hashes);
     }
   }
+
+ private:
+  const TResult seed_;
 };
 
 } // namespace
 
+void murmur3Hash(
+    const DecodedVector& decoded,
+    const SelectivityVector& rows,
+    uint32_t* hashes) {
+  hashColumn<Murmur3Hash>(decoded, rows, hashes);
+}
+
+void xxHash64(
+    const DecodedVector& decoded,
+    const SelectivityVector& rows,
+    uint64_t* hashes) {
+  hashColumn<XxHash64>(decoded, rows, hashes);
+}
+
 std::vector<std::shared_ptr<exec::FunctionSignature>> hashSignatures() {
   return {exec::FunctionSignatureBuilder()
               .returnType("integer")
@@ -175,8 +329,25 @@ std::vector<std::shared_ptr<exec::FunctionSignature>> hashSignatures() {
 std::shared_ptr<exec::VectorFunction> makeHash(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs) {
-  static const auto kHashFunction = std::make_shared<HashFunction>();
+  static const auto kHashFunction =
+      std::make_shared<HashFunction<Murmur3Hash, int32_t>>(kMurmur3HashSeed);
   return kHashFunction;
 }
 
+std::vector<std::shared_ptr<exec::FunctionSignature>> xxhash64Signatures() {
+  return {exec::FunctionSignatureBuilder()
+              .returnType("bigint")
+              .argumentType("any")
+              .variableArity()
+              .build()};
+}
+
+std::shared_ptr<exec::VectorFunction> makeXxHash64(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+  static const auto kXxHash64Function =
+      std::make_shared<HashFunction<XxHash64, int64_t>>(kXxHash64Seed);
+  return kXxHash64Function;
+}
+
 } // namespace facebook::velox::functions::sparksql
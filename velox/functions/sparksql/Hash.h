@@ -14,27 +14,54 @@
  * limitations under the License.
  */
 #include "velox/expression/VectorFunction.h"
+#include "velox/vector/DecodedVector.h"
 
 namespace facebook::velox::functions::sparksql {
 
+// hash() is Spark's Murmur3Hash and xxhash64() its XxHash64. Both fold the
+// arguments left to right into a hash that starts at the seed. A null
+// argument leaves the hash unchanged.
+//
 // Supported types:
 //   - Bools
 //   - Integer types (byte, short, int, long)
 //   - String, Binary
 //   - Float, Double
+//   - Date, Timestamp
 //
 // Unsupported:
 //   - Decimal
-//   - Datetime
 //   - Structs, Arrays: hash the elements in order
 //   - Maps: iterate over map, hashing key then value. Since map ordering is
 //        unspecified, hashing logically equivalent maps may result in
 //        different hash values.
 
+constexpr int32_t kMurmur3HashSeed = 42;
+constexpr int64_t kXxHash64Seed = 42;
+
 std::vector<std::shared_ptr<exec::FunctionSignature>> hashSignatures();
 
 std::shared_ptr<exec::VectorFunction> makeHash(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs);
 
+std::vector<std::shared_ptr<exec::FunctionSignature>> xxhash64Signatures();
+
+std::shared_ptr<exec::VectorFunction> makeXxHash64(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs);
+
+// Folds the non-null 'rows' of 'decoded' into 'hashes', which hold the hash
+// of the preceding columns or the seed. Flat columns without nulls are
+// hashed in a loop over their values, with SIMD for Murmur3 of integers.
+void murmur3Hash(
+    const DecodedVector& decoded,
+    const SelectivityVector& rows,
+    uint32_t* hashes);
+
+void xxHash64(
+    const DecodedVector& decoded,
+    const SelectivityVector& rows,
+    uint64_t* hashes);
+
 } // namespace facebook::velox::functions::sparksql
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/sparksql/HashPartitionFunction.h"
+
+#include "velox/functions/sparksql/Hash.h"
+
+namespace facebook::velox::functions::sparksql {
+
+HashPartitionFunction::HashPartitionFunction(
+    int numPartitions,
+    const RowTypePtr& inputType,
+    const std::vector<column_index_t>& keyChannels)
+    : numPartitions_{numPartitions}, keyChannels_{keyChannels} {
+  VELOX_CHECK_GT(numPartitions_, 0);
+  for (const auto channel : keyChannels_) {
+    VELOX_CHECK_LT(channel, inputType->size());
+  }
+}
+
+void HashPartitionFunction::partition(
+    const RowVector& input,
+    std::vector<uint32_t>& partitions) {
+  const auto size = input.size();
+  partitions.resize(size);
+
+  rows_.resize(size);
+  rows_.setAll();
+
+  hashes_.resize(size);
+  std::fill(hashes_.begin(), hashes_.end(), kMurmur3HashSeed);
+  for (const auto channel : keyChannels_) {
+    decoded_.decode(*input.childAt(channel), rows_);
+    murmur3Hash(decoded_, rows_, hashes_.data());
+  }
+
+  // Pmod of the signed hash, as in Spark.
+  for (auto i = 0; i < size; ++i) {
+    const auto mod = static_cast<int32_t>(hashes_[i]) % numPartitions_;
+    partitions[i] = mod < 0 ? mod + numPartitions_ : mod;
+  }
+}
+
+} // namespace facebook::velox::functions::sparksql
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/core/PlanNode.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::functions::sparksql {
+
+// Spark's HashPartitioning: the partition of a row is the Murmur3 hash of the
+// keys, seeded with 42, modulo the number of partitions with a non-negative
+// result. Rows go to the same partitions as in Spark, so that Velox and Spark
+// stages can exchange data.
+class HashPartitionFunction : public core::PartitionFunction {
+ public:
+  HashPartitionFunction(
+      int numPartitions,
+      const RowTypePtr& inputType,
+      const std::vector<column_index_t>& keyChannels);
+
+  ~HashPartitionFunction() override = default;
+
+  void partition(const RowVector& input, std::vector<uint32_t>& partitions)
+      override;
+
+ private:
+  const int numPartitions_;
+  const std::vector<column_index_t> keyChannels_;
+
+  // Reusable memory.
+  SelectivityVector rows_;
+  raw_vector<uint32_t> hashes_;
+  DecodedVector decoded_;
+};
+
+} // namespace facebook::velox::functions::sparksql
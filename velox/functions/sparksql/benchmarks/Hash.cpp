@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/HashPartitionFunction.h"
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/sparksql/HashPartitionFunction.h"
+#include "velox/functions/sparksql/Register.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#include "velox/vector/tests/VectorTestBase.h"
+
+// Compares hash() and xxhash64() of flat columns without nulls, which take
+// the loops over the values, with dictionary encoded columns, which are
+// hashed row by row. The partition cases compare the Spark hash partition
+// function with the one of PartitionedOutput.
+namespace facebook::velox::functions::sparksql {
+namespace {
+
+constexpr vector_size_t kSize = 10'000;
+
+enum class Encoding { kFlat, kDictionary };
+
+class HashBenchmark : public test::FunctionBenchmarkBase {
+ public:
+  RowVectorPtr makeData(const TypePtr& type, Encoding encoding) {
+    VectorFuzzer::Options opts;
+    opts.vectorSize = kSize;
+    opts.nullRatio = 0;
+    VectorFuzzer fuzzer(opts, pool(), 1);
+    auto column = fuzzer.fuzzFlat(type);
+    if (encoding == Encoding::kDictionary) {
+      column = BaseVector::wrapInDictionary(
+          nullptr,
+          velox::test::makeIndicesInReverse(kSize, pool()),
+          kSize,
+          column);
+    }
+    return maker().rowVector({column});
+  }
+};
+
+std::unique_ptr<HashBenchmark> benchmark;
+
+unsigned hash(
+    unsigned iters,
+    const std::string& expression,
+    const TypePtr& type,
+    Encoding encoding) {
+  folly::BenchmarkSuspender suspender;
+  auto data = benchmark->makeData(type, encoding);
+  auto exprSet = benchmark->compileExpression(expression, data->type());
+  suspender.dismiss();
+  for (auto i = 0; i < iters; ++i) {
+    benchmark->evaluate(exprSet, data);
+  }
+  return iters * kSize;
+}
+
+template <typename Function>
+unsigned partition(unsigned iters, const TypePtr& type) {
+  folly::BenchmarkSuspender suspender;
+  auto data = benchmark->makeData(type, Encoding::kFlat);
+  Function function(128, asRowType(data->type()), {0});
+  std::vector<uint32_t> partitions;
+  suspender.dismiss();
+  for (auto i = 0; i < iters; ++i) {
+    function.partition(*data, partitions);
+  }
+  return iters * kSize;
+}
+
+unsigned veloxPartition(unsigned iters, const TypePtr& type) {
+  return partition<exec::HashPartitionFunction>(iters, type);
+}
+
+unsigned sparkPartition(unsigned iters, const TypePtr& type) {
+  return partition<HashPartitionFunction>(iters, type);
+}
+
+#define HASH_BENCHMARKS(name, type)                                     \
+  BENCHMARK_NAMED_PARAM_MULTI(                                          \
+      hash, murmur3_##name##_dictionary, "hash(c0)", type,              \
+      Encoding::kDictionary);                                           \
+  BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(                                 \
+      hash, murmur3_##name##_flat, "hash(c0)", type, Encoding::kFlat);  \
+  BENCHMARK_NAMED_PARAM_MULTI(                                          \
+      hash, xxhash64_##name##_dictionary, "xxhash64(c0)", type,         \
+      Encoding::kDictionary);                                           \
+  BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(                                 \
+      hash, xxhash64_##name##_flat, "xxhash64(c0)", type,               \
+      Encoding::kFlat);                                                 \
+  BENCHMARK_NAMED_PARAM_MULTI(veloxPartition, name, type);              \
+  BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(sparkPartition, name, type);     \
+  BENCHMARK_DRAW_LINE()
+
+HASH_BENCHMARKS(integer, INTEGER());
+HASH_BENCHMARKS(bigint, BIGINT());
+HASH_BENCHMARKS(double, DOUBLE());
+HASH_BENCHMARKS(varchar, VARCHAR());
+
+} // namespace
+} // namespace facebook::velox::functions::sparksql
+
+int main(int argc, char** argv) {
+  using namespace facebook::velox::functions::sparksql;
+  folly::init(&argc, &argv);
+  registerFunctions("");
+  benchmark = std::make_unique<HashBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -19,6 +19,7 @@
 #include <optional>
 
 #include "velox/functions/prestosql/tests/FunctionBaseTest.h"
+#include "velox/functions/sparksql/Comparisons.h"
 #include "velox/functions/sparksql/Register.h"
 #include "velox/functions/sparksql/tests/ArraySortTestData.h"
 #include "velox/functions/sparksql/tests/SparkFunctionBaseTest.h"
@@ -78,6 +79,45 @@ TEST_F(ArraySortTest, double) {
   testFloatingPoint<double>();
 }
 
+TEST_F(ArraySortTest, largeArrays) {
+  // Arrays above kMinRadixSortSize are radix sorted.
+  constexpr int32_t kSize = 1'000;
+  std::vector<std::vector<std::optional<double>>> doubles(2);
+  std::vector<std::vector<std::optional<int64_t>>> bigints(2);
+  for (auto i = 0; i < kSize; ++i) {
+    const auto value = static_cast<int64_t>(i * 7919L % kSize - kSize / 2);
+    bigints[0].push_back(value * 1'000'000'007L);
+    bigints[1].push_back(i % 10 == 0 ? std::nullopt : std::optional(value));
+    doubles[0].push_back(value * 0.25);
+    if (i % 100 == 0) {
+      doubles[1].push_back(std::numeric_limits<double>::quiet_NaN());
+    } else if (i % 10 == 0) {
+      doubles[1].push_back(std::nullopt);
+    } else {
+      doubles[1].push_back(value * -0.5);
+    }
+  }
+
+  auto sorted = [](auto arrays) {
+    for (auto& array : arrays) {
+      std::sort(array.begin(), array.end(), [](auto a, auto b) {
+        // Nulls last, then NaNs.
+        if (!a.has_value() || !b.has_value()) {
+          return a.has_value() && !b.has_value();
+        }
+        return Less<typename decltype(a)::value_type>()(*a, *b);
+      });
+    }
+    return arrays;
+  };
+  testArraySort(
+      makeNullableArrayVector(bigints),
+      makeNullableArrayVector(sorted(bigints)));
+  testArraySort(
+      makeNullableArrayVector(doubles),
+      makeNullableArrayVector(sorted(doubles)));
+}
+
 TEST_F(ArraySortTest, string) {
   auto input = makeNullableArrayVector(stringInput());
   auto expected = makeNullableArrayVector(stringAscNullLargest());
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/sparksql/HashPartitionFunction.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/vector/tests/VectorTestBase.h"
+
+namespace facebook::velox::functions::sparksql::test {
+namespace {
+
+class HashPartitionFunctionTest : public ::testing::Test,
+                                  public velox::test::VectorTestBase {
+ protected:
+  std::vector<uint32_t> partition(
+      const RowVectorPtr& input,
+      const std::vector<column_index_t>& keyChannels,
+      int numPartitions) {
+    HashPartitionFunction function(
+        numPartitions, asRowType(input->type()), keyChannels);
+    std::vector<uint32_t> partitions;
+    function.partition(*input, partitions);
+    return partitions;
+  }
+};
+
+// The partitions are pmod(hash(keys), numPartitions) as in Spark, with the
+// negative hashes of 1 and 3 in partition 3.
+TEST_F(HashPartitionFunctionTest, spark) {
+  auto input = makeRowVector({makeFlatVector<int32_t>({0, 1, 2, 3, 4})});
+  EXPECT_EQ((std::vector<uint32_t>{3, 3, 2, 3, 2}), partition(input, {0}, 4));
+  EXPECT_EQ((std::vector<uint32_t>{0, 0, 0, 0, 0}), partition(input, {0}, 1));
+}
+
+// Null keys leave the hash unchanged. The partitions of several keys are
+// those of the hash of all keys.
+TEST_F(HashPartitionFunctionTest, multipleKeys) {
+  auto input = makeRowVector(
+      {makeNullableFlatVector<int32_t>({0, std::nullopt, 2}),
+       makeNullableFlatVector<int64_t>({std::nullopt, std::nullopt, 7}),
+       makeFlatVector<StringView>({"a", "b", "c"})});
+  auto single = makeRowVector(
+      {makeFlatVector<int32_t>({0, 0, 0}),
+       makeFlatVector<StringView>({"a", "b", "c"})});
+  auto partitions = partition(input, {0, 1}, 1'000);
+  EXPECT_EQ(partition(single, {0}, 1'000)[0], partitions[0]);
+  // hash() of no non-null values is the seed.
+  EXPECT_EQ(42, partitions[1]);
+  EXPECT_EQ(
+      partition(input, {0, 1, 2}, 1'000)[1], partition(single, {1}, 1'000)[1]);
+}
+
+} // namespace
+} // namespace facebook::velox::functions::sparksql::test
@@ -27,6 +27,23 @@ class HashTest : public SparkFunctionBaseTest {
   std::optional<int32_t> hash(std::optional<T> arg) {
     return evaluateOnce<int32_t>("hash(c0)", arg);
   }
+
+  template <typename T>
+  std::optional<int64_t> xxhash64(std::optional<T> arg) {
+    return evaluateOnce<int64_t>("xxhash64(c0)", arg);
+  }
+
+  // Checks that the hashes of the rows of 'input' are those of each row
+  // evaluated on its own as a constant.
+  template <typename T>
+  void testBatch(const std::string& expression, const VectorPtr& input) {
+    auto result = evaluate<SimpleVector<T>>(expression, makeRowVector({input}));
+    for (auto i = 0; i < input->size(); ++i) {
+      auto row = makeRowVector({BaseVector::wrapInConstant(1, i, input)});
+      auto expected = evaluate<SimpleVector<T>>(expression, row);
+      ASSERT_EQ(expected->valueAt(0), result->valueAt(i)) << "at " << i;
+    }
+  }
 };
 
 TEST_F(HashTest, String) {
@@ -113,5 +130,82 @@ TEST_F(HashTest, Float) {
   EXPECT_EQ(hash<float>(-limits::infinity()), 427440766);
 }
 
+TEST_F(HashTest, batch) {
+  auto flat = makeFlatVector<int32_t>(1'001, [](auto row) { return row * 17; });
+  auto withNulls = makeFlatVector<int64_t>(
+      1'001, [](auto row) { return row << 20; }, nullEvery(3));
+  auto strings = makeFlatVector<StringView>(1'001, [](auto row) {
+    return StringView::makeInline(std::to_string(row));
+  });
+  auto dictionary =
+      wrapInDictionary(makeIndicesInReverse(1'001), 1'001, strings);
+  for (const auto& input : {flat, withNulls, dictionary}) {
+    testBatch<int32_t>("hash(c0)", input);
+    testBatch<int64_t>("xxhash64(c0)", input);
+  }
+  EXPECT_EQ(
+      hash<int32_t>(17),
+      evaluate<SimpleVector<int32_t>>("hash(c0)", makeRowVector({flat}))
+          ->valueAt(1));
+}
+
+TEST_F(HashTest, xxhash64String) {
+  EXPECT_EQ(xxhash64<std::string>("Spark"), -4294468057691064905);
+  EXPECT_EQ(xxhash64<std::string>(""), -7444071767201028348);
+  EXPECT_EQ(
+      xxhash64<std::string>("abcdefghijklmnopqrstuvwxyz"),
+      -3265757659154784300);
+  EXPECT_EQ(xxhash64<std::string>("12345678"), 6863040065134489090);
+  EXPECT_EQ(xxhash64<std::string>(std::nullopt), 42);
+}
+
+TEST_F(HashTest, xxhash64Int64) {
+  EXPECT_EQ(xxhash64<int64_t>(0xcafecafedeadbeef), -6259772178006417012);
+  EXPECT_EQ(xxhash64<int64_t>(0xdeadbeefcafecafe), -1700188678616701932);
+  EXPECT_EQ(xxhash64<int64_t>(INT64_MAX), -3246596055638297850);
+  EXPECT_EQ(xxhash64<int64_t>(INT64_MIN), -8619748838626508300);
+  EXPECT_EQ(xxhash64<int64_t>(1), -7001672635703045582);
+  EXPECT_EQ(xxhash64<int64_t>(0), -5252525462095825812);
+  EXPECT_EQ(xxhash64<int64_t>(-1), 3858142552250413010);
+  EXPECT_EQ(xxhash64<int64_t>(std::nullopt), 42);
+}
+
+TEST_F(HashTest, xxhash64Int32) {
+  EXPECT_EQ(xxhash64<int32_t>(0xdeadbeef), -8041005359684616715);
+  EXPECT_EQ(xxhash64<int32_t>(0xcafecafe), 3599843564351570672);
+  EXPECT_EQ(xxhash64<int32_t>(1), -6698625589789238999);
+  EXPECT_EQ(xxhash64<int32_t>(0), 3614696996920510707);
+  EXPECT_EQ(xxhash64<int32_t>(-1), 2017008487422258757);
+  EXPECT_EQ(xxhash64<int32_t>(std::nullopt), 42);
+  EXPECT_EQ(xxhash64<int8_t>(-1), 2017008487422258757);
+  EXPECT_EQ(xxhash64<bool>(true), -6698625589789238999);
+}
+
+TEST_F(HashTest, xxhash64Float) {
+  using limits = std::numeric_limits<float>;
+
+  EXPECT_EQ(xxhash64<float>(1), 700633588856507837);
+  EXPECT_EQ(xxhash64<float>(-0.0f), xxhash64<float>(0));
+  EXPECT_EQ(xxhash64<float>(limits::quiet_NaN()), 2692338816207849720);
+  EXPECT_EQ(xxhash64<float>(-limits::quiet_NaN()), 2692338816207849720);
+  EXPECT_EQ(xxhash64<double>(1), -2162451265447482029);
+  EXPECT_EQ(xxhash64<double>(-0.0), xxhash64<double>(0));
+  EXPECT_EQ(
+      xxhash64<double>(std::numeric_limits<double>::quiet_NaN()),
+      -3127944061524951246);
+  EXPECT_EQ(
+      xxhash64<double>(-std::numeric_limits<double>::quiet_NaN()),
+      -3127944061524951246);
+}
+
+TEST_F(HashTest, xxhash64StringInt32) {
+  EXPECT_EQ(
+      evaluateOnce<int64_t>(
+          "xxhash64(c0, c1)",
+          std::optional<std::string>(""),
+          std::optional<int32_t>(0)),
+      5333022629466737987);
+}
+
 } // namespace
 } // namespace facebook::velox::functions::sparksql::test
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/row/UnsafeRowDynamicSerializer.h"
+
+namespace facebook::velox::row {
+
+/// Serializes all rows of a RowVector to UnsafeRows one column at a time. The
+/// bytes of each row are the same as from UnsafeRowDynamicSerializer into a
+/// zeroed buffer. A first pass computes the size of each row so that the
+/// fixed width fields of a column can be stored at known offsets in one loop
+/// and the variable length fields can be copied in place. Complex type
+/// fields are written by UnsafeRowDynamicSerializer at their precomputed
+/// locations.
+class UnsafeRowBatchSerializer {
+ public:
+  /// Computes the serialized size of each row of 'data' into 'rowSizes'. A
+  /// null row has size 0. Returns the size of the buffer for serialize(),
+  /// where each row starts at a multiple of 8 bytes.
+  static size_t computeRowSizes(
+      const RowVectorPtr& data,
+      std::vector<size_t>& rowSizes) {
+    const auto numRows = data->size();
+    const auto numFields = data->childrenSize();
+    auto& rowType = data->type()->asRow();
+    const auto* rowNulls = data->rawNulls();
+    const size_t fixedSize = UnsafeRow::getNullLength(numFields) +
+        numFields * UnsafeRow::kFieldWidthBytes;
+    rowSizes.assign(numRows, fixedSize);
+
+    // True if a previous field may have left some size unaligned.
+    bool mayBeUnaligned = false;
+    DecodedVector decoded;
+    for (auto column = 0; column < numFields; ++column) {
+      const auto& type = rowType.childAt(column);
+      const auto& child = data->childAt(column);
+      if (type->isFixedWidth()) {
+        if (mayBeUnaligned) {
+          for (auto row = 0; row < numRows; ++row) {
+            rowSizes[row] = UnsafeRow::alignToFieldWidth(rowSizes[row]);
+          }
+          mayBeUnaligned = false;
+        }
+        continue;
+      }
+      mayBeUnaligned = true;
+      if (isString(type)) {
+        SelectivityVector allRows(numRows);
+        decoded.decode(*child, allRows);
+        for (auto row = 0; row < numRows; ++row) {
+          if (!decoded.isNullAt(row)) {
+            rowSizes[row] = UnsafeRow::alignToFieldWidth(rowSizes[row]) +
+                decoded.valueAt<StringView>(row).size();
+          }
+        }
+        continue;
+      }
+      for (auto row = 0; row < numRows; ++row) {
+        auto size = serializedSize(type, child, row);
+        if (size.has_value()) {
+          rowSizes[row] =
+              UnsafeRow::alignToFieldWidth(rowSizes[row]) + size.value();
+        }
+      }
+    }
+
+    size_t totalSize = 0;
+    for (auto row = 0; row < numRows; ++row) {
+      if (rowNulls && bits::isBitNull(rowNulls, row)) {
+        rowSizes[row] = 0;
+        continue;
+      }
+      VELOX_CHECK_LE(rowSizes[row], UINT32_MAX);
+      totalSize += UnsafeRow::alignToFieldWidth(rowSizes[row]);
+    }
+    return totalSize;
+  }
+
+  /// Serializes the rows of 'data' back to back into 'buffer'. 'rowSizes' and
+  /// the size of 'buffer' come from computeRowSizes(). Sets 'rows' to the
+  /// serialized rows, std::nullopt for a null row.
+  static void serialize(
+      const RowVectorPtr& data,
+      const std::vector<size_t>& rowSizes,
+      char* buffer,
+      std::vector<std::optional<std::string_view>>& rows) {
+    const auto numRows = data->size();
+    const auto numFields = data->childrenSize();
+    auto& rowType = data->type()->asRow();
+    const auto* rowNulls = data->rawNulls();
+    const size_t nullLength = UnsafeRow::getNullLength(numFields);
+    const size_t fixedSize =
+        nullLength + numFields * UnsafeRow::kFieldWidthBytes;
+    VELOX_CHECK_EQ(rowSizes.size(), numRows);
+
+    // Start of each row in 'buffer'. Null rows are empty.
+    std::vector<char*> starts(numRows);
+    size_t totalSize = 0;
+    rows.resize(numRows);
+    for (auto row = 0; row < numRows; ++row) {
+      starts[row] = buffer + totalSize;
+      if (rowNulls && bits::isBitNull(rowNulls, row)) {
+        rows[row] = std::nullopt;
+        continue;
+      }
+      rows[row] = std::string_view(starts[row], rowSizes[row]);
+      totalSize += UnsafeRow::alignToFieldWidth(rowSizes[row]);
+    }
+    // Null bits, unused bytes of fixed width fields and padding are 0.
+    std::memset(buffer, 0, totalSize);
+
+    // Offset of the first unwritten byte of variable length data in each row.
+    std::vector<size_t> ends(numRows, fixedSize);
+    DecodedVector decoded;
+    for (auto column = 0; column < numFields; ++column) {
+      const auto& type = rowType.childAt(column);
+      const auto& child = data->childAt(column);
+      const auto fieldOffset =
+          nullLength + column * UnsafeRow::kFieldWidthBytes;
+      if (type->isFixedWidth()) {
+        SelectivityVector allRows(numRows);
+        decoded.decode(*child, allRows);
+        switch (type->kind()) {
+#define FIXED_WIDTH(kind)                                                     \
+  case TypeKind::kind:                                                        \
+    writeFixedWidthColumn<TypeKind::kind>(                                    \
+        decoded, column, fieldOffset, rowNulls, starts);                      \
+    break;
+          FIXED_WIDTH(BOOLEAN);
+          FIXED_WIDTH(TINYINT);
+          FIXED_WIDTH(SMALLINT);
+          FIXED_WIDTH(INTEGER);
+          FIXED_WIDTH(BIGINT);
+          FIXED_WIDTH(REAL);
+          FIXED_WIDTH(DOUBLE);
+          FIXED_WIDTH(TIMESTAMP);
+          FIXED_WIDTH(DATE);
+#undef FIXED_WIDTH
+          default:
+            throw UnsafeRowDynamicSerializer::
+                UnsupportedSerializationException();
+        }
+        continue;
+      }
+      if (isString(type)) {
+        SelectivityVector allRows(numRows);
+        decoded.decode(*child, allRows);
+        writeStringColumn(decoded, column, fieldOffset, rowNulls, starts, ends);
+        continue;
+      }
+      for (auto row = 0; row < numRows; ++row) {
+        if (rowNulls && bits::isBitNull(rowNulls, row)) {
+          continue;
+        }
+        auto* start = starts[row];
+        auto end = UnsafeRow::alignToFieldWidth(ends[row]);
+        auto size = UnsafeRowDynamicSerializer::serialize(
+            type, child, start + end, row);
+        if (!size.has_value()) {
+          bits::setBit(start, column);
+          continue;
+        }
+        writeOffsetPointer(start + fieldOffset, end, size.value());
+        ends[row] = end + size.value();
+      }
+    }
+  }
+
+ private:
+  static bool isString(const TypePtr& type) {
+    return type->kind() == TypeKind::VARCHAR ||
+        type->kind() == TypeKind::VARBINARY;
+  }
+
+  static void writeOffsetPointer(char* field, size_t offset, size_t size) {
+    *reinterpret_cast<uint64_t*>(field) = offset << 32 | size;
+  }
+
+  template <TypeKind Kind>
+  static void writeFixedWidthColumn(
+      const DecodedVector& decoded,
+      int32_t column,
+      size_t fieldOffset,
+      const uint64_t* rowNulls,
+      const std::vector<char*>& starts) {
+    using T = typename TypeTraits<Kind>::NativeType;
+    const auto numRows = starts.size();
+    if (!rowNulls && !decoded.mayHaveNulls()) {
+      for (auto row = 0; row < numRows; ++row) {
+        writeFixedWidth<Kind>(
+            starts[row] + fieldOffset, decoded.valueAt<T>(row));
+      }
+      return;
+    }
+    for (auto row = 0; row < numRows; ++row) {
+      if (rowNulls && bits::isBitNull(rowNulls, row)) {
+        continue;
+      }
+      if (decoded.isNullAt(row)) {
+        bits::setBit(starts[row], column);
+      } else {
+        writeFixedWidth<Kind>(
+            starts[row] + fieldOffset, decoded.valueAt<T>(row));
+      }
+    }
+  }
+
+  template <TypeKind Kind>
+  static void writeFixedWidth(
+      char* field,
+      typename TypeTraits<Kind>::NativeType value) {
+    if constexpr (Kind == TypeKind::TIMESTAMP) {
+      *reinterpret_cast<int64_t*>(field) = value.toMicros();
+    } else {
+      *reinterpret_cast<typename TypeTraits<Kind>::NativeType*>(field) = value;
+    }
+  }
+
+  static void writeStringColumn(
+      const DecodedVector& decoded,
+      int32_t column,
+      size_t fieldOffset,
+      const uint64_t* rowNulls,
+      const std::vector<char*>& starts,
+      std::vector<size_t>& ends) {
+    const auto numRows = starts.size();
+    for (auto row = 0; row < numRows; ++row) {
+      if (rowNulls && bits::isBitNull(rowNulls, row)) {
+        continue;
+      }
+      auto* start = starts[row];
+      if (decoded.isNullAt(row)) {
+        bits::setBit(start, column);
+        continue;
+      }
+      auto value = decoded.valueAt<StringView>(row);
+      auto end = UnsafeRow::alignToFieldWidth(ends[row]);
+      std::memcpy(start + end, value.data(), value.size());
+      writeOffsetPointer(start + fieldOffset, end, value.size());
+      ends[row] = end + value.size();
+    }
+  }
+
+  // Returns the number of bytes UnsafeRowDynamicSerializer::serialize()
+  // writes for element 'idx' of 'data', std::nullopt if it is null.
+  static std::optional<size_t>
+  serializedSize(const TypePtr& type, const VectorPtr& data, size_t idx) {
+    switch (type->kind()) {
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY: {
+        const auto& simple = static_cast<const SimpleVector<StringView>&>(
+            *data->loadedVector());
+        if (simple.isNullAt(idx)) {
+          return std::nullopt;
+        }
+        return simple.valueAt(idx).size();
+      }
+      case TypeKind::ARRAY: {
+        auto* array = data->wrappedVector()->asUnchecked<ArrayVector>();
+        auto index = data->wrappedIndex(idx);
+        if (array->isNullAt(index)) {
+          return std::nullopt;
+        }
+        return arraySize(
+            type->childAt(0),
+            array->offsetAt(index),
+            array->sizeAt(index),
+            array->elements());
+      }
+      case TypeKind::MAP: {
+        auto* map = data->wrappedVector()->asUnchecked<MapVector>();
+        auto index = data->wrappedIndex(idx);
+        if (map->isNullAt(index)) {
+          return std::nullopt;
+        }
+        auto offset = map->offsetAt(index);
+        auto size = map->sizeAt(index);
+        return UnsafeRow::kFieldWidthBytes +
+            arraySize(type->childAt(0), offset, size, map->mapKeys()) +
+            arraySize(type->childAt(1), offset, size, map->mapValues());
+      }
+      case TypeKind::ROW: {
+        auto* rowVector = data->wrappedVector()->asUnchecked<RowVector>();
+        auto index = data->wrappedIndex(idx);
+        if (rowVector->isNullAt(index)) {
+          return std::nullopt;
+        }
+        const auto numFields = rowVector->childrenSize();
+        size_t size = UnsafeRow::getNullLength(numFields) +
+            numFields * UnsafeRow::kFieldWidthBytes;
+        for (auto i = 0; i < numFields; ++i) {
+          size = UnsafeRow::alignToFieldWidth(size) +
+              serializedSize(type->childAt(i), rowVector->childAt(i), index)
+                  .value_or(0);
+        }
+        return size;
+      }
+      default:
+        VELOX_CHECK(type->isFixedWidth());
+        if (data->loadedVector()->isNullAt(idx)) {
+          return std::nullopt;
+        }
+        return 0;
+    }
+  }
+
+  // Returns the size of an UnsafeRow array of 'size' elements of 'data'
+  // starting at 'offset'.
+  static size_t arraySize(
+      const TypePtr& elementType,
+      vector_size_t offset,
+      vector_size_t size,
+      const VectorPtr& data) {
+    const auto nullLength = UnsafeRow::getNullLength(size);
+    size_t valuesSize;
+    if (elementType->isFixedWidth()) {
+      // Counts the null set and the number of elements like
+      // UnsafeRowDynamicSerializer.
+      valuesSize = UnsafeRow::kFieldWidthBytes +
+          UnsafeRow::alignToFieldWidth(
+                       size * elementType->cppSizeInBytes() + nullLength);
+    } else {
+      size_t end = UnsafeRow::kFieldWidthBytes + nullLength +
+          size * UnsafeRow::kFieldWidthBytes;
+      for (auto i = 0; i < size; ++i) {
+        end = UnsafeRow::alignToFieldWidth(end) +
+            serializedSize(elementType, data, offset + i).value_or(0);
+      }
+      valuesSize =
+          UnsafeRow::alignToFieldWidth(end - UnsafeRow::kFieldWidthBytes);
+    }
+    return UnsafeRow::alignToFieldWidth(
+        UnsafeRow::kFieldWidthBytes + valuesSize);
+  }
+};
+
+} // namespace facebook::velox::row
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/row/UnsafeRowColumnarDeserializer.h"
+
+#include <xsimd/xsimd.hpp>
+
+#include "velox/row/UnsafeRowBatchDeserializer.h"
+
+namespace facebook::velox::row {
+namespace {
+
+// Decodes the offset and size of variable length data in 'field' of 'row'.
+FOLLY_ALWAYS_INLINE std::string_view variableLengthData(
+    const char* row,
+    const char* field) {
+  uint64_t offsetAndSize;
+  std::memcpy(&offsetAndSize, field, sizeof(offsetAndSize));
+  return std::string_view(
+      row + (offsetAndSize >> 32), static_cast<uint32_t>(offsetAndSize));
+}
+
+template <typename T>
+FOLLY_ALWAYS_INLINE T loadUnaligned(const char* address) {
+  T value;
+  std::memcpy(&value, address, sizeof(T));
+  return value;
+}
+
+// Gathers field 'offset' of all rows into a flat vector. 'rows' has nullptr
+// for null rows.
+template <TypeKind Kind>
+VectorPtr gatherFixedWidth(
+    const std::vector<const char*>& rows,
+    size_t offset,
+    BufferPtr nulls,
+    memory::MemoryPool* pool) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  const auto numRows = rows.size();
+  auto values = AlignedBuffer::allocate<T>(numRows, pool);
+  auto* rawValues = values->template asMutable<T>();
+  if constexpr (Kind == TypeKind::BOOLEAN) {
+    std::memset(rawValues, 0, values->size());
+  }
+  for (auto i = 0; i < numRows; ++i) {
+    const char* row = rows[i];
+    if (!row) {
+      continue;
+    }
+    const char* field = row + offset;
+    if constexpr (Kind == TypeKind::BOOLEAN) {
+      bits::setBit(rawValues, i, *field != 0);
+    } else if constexpr (Kind == TypeKind::TIMESTAMP) {
+      rawValues[i] = Timestamp::fromMicros(loadUnaligned<int64_t>(field));
+    } else {
+      rawValues[i] = loadUnaligned<T>(field);
+    }
+  }
+  return std::make_shared<FlatVector<T>>(
+      pool,
+      ScalarType<Kind>::create(),
+      std::move(nulls),
+      numRows,
+      std::move(values),
+      std::vector<BufferPtr>{});
+}
+
+// Makes StringViews of field 'offset' of all rows. The StringViews point into
+// 'data' if it is set and to copies of the strings otherwise.
+VectorPtr gatherStrings(
+    const TypePtr& type,
+    const std::vector<const char*>& rows,
+    size_t offset,
+    BufferPtr nulls,
+    memory::MemoryPool* pool,
+    const BufferPtr& data) {
+  const auto numRows = rows.size();
+  const auto* rawNulls = nulls ? nulls->as<uint64_t>() : nullptr;
+  if (!data) {
+    auto result = BaseVector::create<FlatVector<StringView>>(
+        type, numRows, pool);
+    for (auto i = 0; i < numRows; ++i) {
+      if (rawNulls && bits::isBitNull(rawNulls, i)) {
+        result->setNull(i, true);
+        continue;
+      }
+      auto value = variableLengthData(rows[i], rows[i] + offset);
+      result->set(i, StringView(value.data(), value.size()));
+    }
+    return result;
+  }
+  auto values = AlignedBuffer::allocate<StringView>(numRows, pool);
+  auto* rawValues = values->asMutable<StringView>();
+  for (auto i = 0; i < numRows; ++i) {
+    if (rawNulls && bits::isBitNull(rawNulls, i)) {
+      rawValues[i] = StringView();
+      continue;
+    }
+    auto value = variableLengthData(rows[i], rows[i] + offset);
+    rawValues[i] = StringView(value.data(), value.size());
+  }
+  return std::make_shared<FlatVector<StringView>>(
+      pool,
+      type,
+      std::move(nulls),
+      numRows,
+      std::move(values),
+      std::vector<BufferPtr>{data});
+}
+
+VectorPtr deserializeComplexField(
+    const TypePtr& type,
+    const std::vector<const char*>& rows,
+    size_t offset,
+    const BufferPtr& nulls,
+    memory::MemoryPool* pool) {
+  const auto numRows = rows.size();
+  const auto* rawNulls = nulls ? nulls->as<uint64_t>() : nullptr;
+  std::vector<std::optional<std::string_view>> fields(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    if (!rawNulls || !bits::isBitNull(rawNulls, i)) {
+      fields[i] = variableLengthData(rows[i], rows[i] + offset);
+    }
+  }
+  return UnsafeRowDynamicVectorBatchDeserializer::deserializeComplex(
+      fields, type, pool);
+}
+
+} // namespace
+
+// static
+void UnsafeRowColumnarDeserializer::transposeBits(uint64_t* words) {
+  using Batch = xsimd::batch<uint64_t>;
+  constexpr int32_t kBatchSize = Batch::size;
+  // Swaps the upper right and lower left j x j blocks of each 2j x 2j block
+  // on the diagonal.
+  uint64_t mask = 0xffffffffULL;
+  for (int32_t j = 32; j > 0; j >>= 1, mask ^= mask << j) {
+    if (j >= kBatchSize) {
+      const auto batchMask = Batch(mask);
+      for (int32_t k = 0; k < 64; k += 2 * j) {
+        for (int32_t i = k; i < k + j; i += kBatchSize) {
+          auto low = Batch::load_unaligned(words + i);
+          auto high = Batch::load_unaligned(words + i + j);
+          auto swap = ((low >> j) ^ high) & batchMask;
+          (low ^ (swap << j)).store_unaligned(words + i);
+          (high ^ swap).store_unaligned(words + i + j);
+        }
+      }
+      continue;
+    }
+    for (int32_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+      auto swap = ((words[k] >> j) ^ words[k | j]) & mask;
+      words[k] ^= swap << j;
+      words[k | j] ^= swap;
+    }
+  }
+}
+
+// static
+RowVectorPtr UnsafeRowColumnarDeserializer::deserialize(
+    const std::vector<std::optional<std::string_view>>& rows,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool,
+    const BufferPtr& data) {
+  const vector_size_t numRows = rows.size();
+  const auto numFields = type->size();
+  const auto numNullWords = bits::nwords(numFields);
+
+  // Scans the rows once. Null rows are nullptr.
+  std::vector<const char*> starts(numRows);
+  BufferPtr rowNulls;
+  for (auto i = 0; i < numRows; ++i) {
+    if (rows[i].has_value()) {
+      starts[i] = rows[i]->data();
+      continue;
+    }
+    if (!rowNulls) {
+      rowNulls = AlignedBuffer::allocate<bool>(numRows, pool, bits::kNotNull);
+    }
+    bits::setNull(rowNulls->asMutable<uint64_t>(), i);
+  }
+
+  // Transposes the null sets of 64 rows at a time. The rows are the rows of
+  // a bit matrix and after the transpose word 'i' has the null flags of field
+  // 'i' for the 64 rows. A null row is null in all fields.
+  std::vector<BufferPtr> nulls(numFields);
+  std::vector<bool> mayHaveNulls(numFields, false);
+  for (auto field = 0; field < numFields; ++field) {
+    nulls[field] = AlignedBuffer::allocate<bool>(numRows, pool);
+  }
+  uint64_t matrix[64];
+  for (auto firstRow = 0; firstRow < numRows; firstRow += 64) {
+    const auto numInGroup = std::min<int32_t>(64, numRows - firstRow);
+    for (auto word = 0; word < numNullWords; ++word) {
+      for (auto i = 0; i < 64; ++i) {
+        if (i >= numInGroup) {
+          matrix[i] = 0;
+        } else if (auto* row = starts[firstRow + i]) {
+          matrix[i] = loadUnaligned<uint64_t>(row + word * sizeof(uint64_t));
+        } else {
+          matrix[i] = ~0ULL;
+        }
+      }
+      transposeBits(matrix);
+      const auto numInWord = std::min<int32_t>(64, numFields - word * 64);
+      for (auto i = 0; i < numInWord; ++i) {
+        const auto field = word * 64 + i;
+        mayHaveNulls[field] = mayHaveNulls[field] || matrix[i] != 0;
+        nulls[field]->asMutable<uint64_t>()[firstRow / 64] = ~matrix[i];
+      }
+    }
+  }
+
+  std::vector<VectorPtr> children(numFields);
+  size_t offset = numNullWords * sizeof(uint64_t);
+  for (auto field = 0; field < numFields; ++field) {
+    auto fieldNulls = mayHaveNulls[field] ? nulls[field] : nullptr;
+    auto& fieldType = type->childAt(field);
+    switch (fieldType->kind()) {
+#define FIXED_WIDTH(kind)                                 \
+  case TypeKind::kind:                                    \
+    children[field] = gatherFixedWidth<TypeKind::kind>(   \
+        starts, offset, std::move(fieldNulls), pool);     \
+    break
+      FIXED_WIDTH(BOOLEAN);
+      FIXED_WIDTH(TINYINT);
+      FIXED_WIDTH(SMALLINT);
+      FIXED_WIDTH(INTEGER);
+      FIXED_WIDTH(BIGINT);
+      FIXED_WIDTH(REAL);
+      FIXED_WIDTH(DOUBLE);
+      FIXED_WIDTH(TIMESTAMP);
+      FIXED_WIDTH(DATE);
+#undef FIXED_WIDTH
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        children[field] = gatherStrings(
+            fieldType, starts, offset, std::move(fieldNulls), pool, data);
+        break;
+      default:
+        children[field] = deserializeComplexField(
+            fieldType, starts, offset, fieldNulls, pool);
+    }
+    offset += sizeof(uint64_t);
+  }
+  return std::make_shared<RowVector>(
+      pool, type, std::move(rowNulls), numRows, std::move(children));
+}
+
+} // namespace facebook::velox::row
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+#include "velox/type/Type.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::row {
+
+/// Deserializes a batch of UnsafeRows one column at a time. The null sets of
+/// 64 rows at a time are transposed with a bit matrix transpose into the null
+/// buffers of the columns. Fixed width fields are gathered into flat value
+/// buffers. Fields of complex type are deserialized by
+/// UnsafeRowDynamicVectorBatchDeserializer.
+class UnsafeRowColumnarDeserializer {
+ public:
+  /// Returns the rows in 'rows' as a RowVector of 'type'. A std::nullopt row
+  /// is a null row. If 'data' is set, the rows point into 'data', and the
+  /// strings of the result reference 'data' instead of being copied.
+  static RowVectorPtr deserialize(
+      const std::vector<std::optional<std::string_view>>& rows,
+      const RowTypePtr& type,
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      const BufferPtr& data = nullptr);
+
+  /// Transposes the 64 x 64 bit matrix in 'words', so that bit 'i' of
+  /// 'words[j]' becomes bit 'j' of 'words[i]'.
+  static void transposeBits(uint64_t* FOLLY_NONNULL words);
+};
+
+} // namespace facebook::velox::row
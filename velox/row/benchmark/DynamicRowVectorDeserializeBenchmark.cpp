@@ -19,6 +19,7 @@
 #include <random>
 
 #include "velox/row/UnsafeRowBatchDeserializer.h"
+#include "velox/row/UnsafeRowColumnarDeserializer.h"
 #include "velox/row/UnsafeRowDeserializer.h"
 #include "velox/row/UnsafeRowDynamicSerializer.h"
 #include "velox/type/Type.h"
@@ -72,6 +73,22 @@ class UnsaferowBatchDeserializer : public Deserializer {
       memory::getDefaultScopedMemoryPool();
 };
 
+class UnsaferowColumnarDeserializer : public Deserializer {
+ public:
+  UnsaferowColumnarDeserializer() {}
+
+  void deserialize(
+      const std::vector<std::optional<std::string_view>>& data,
+      const TypePtr& type) override {
+    UnsafeRowColumnarDeserializer::deserialize(
+        data, std::dynamic_pointer_cast<const RowType>(type), pool_.get());
+  }
+
+ private:
+  std::unique_ptr<memory::ScopedMemoryPool> pool_ =
+      memory::getDefaultScopedMemoryPool();
+};
+
 class BenchmarkHelper {
  public:
   std::tuple<std::vector<std::optional<std::string_view>>, TypePtr>
@@ -169,6 +186,13 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     true,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_10_100k_string_only,
+    10,
+    100000,
+    true,
+    std::make_unique<UnsaferowColumnarDeserializer>());
 
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
@@ -184,6 +208,13 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     true,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_100_100k_string_only,
+    100,
+    100000,
+    true,
+    std::make_unique<UnsaferowColumnarDeserializer>());
 
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
@@ -199,6 +230,13 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     false,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_10_100k_all_types,
+    10,
+    100000,
+    false,
+    std::make_unique<UnsaferowColumnarDeserializer>());
 
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
@@ -214,6 +252,13 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     false,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_100_100k_all_types,
+    100,
+    100000,
+    false,
+    std::make_unique<UnsaferowColumnarDeserializer>());
 
 } // namespace
 } // namespace facebook::spark::benchmarks
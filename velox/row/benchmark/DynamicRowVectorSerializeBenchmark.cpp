@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/row/UnsafeRowBatchSerializer.h"
+#include "velox/row/UnsafeRowDynamicSerializer.h"
+#include "velox/type/Type.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+namespace facebook::spark::benchmarks {
+namespace {
+using namespace facebook::velox;
+using namespace facebook::velox::row;
+
+class Serializer {
+ public:
+  virtual ~Serializer() = default;
+  virtual void serialize(const RowVectorPtr& data) = 0;
+};
+
+class UnsaferowSerializer : public Serializer {
+ public:
+  void serialize(const RowVectorPtr& data) override {
+    auto& rowType = data->type();
+    char* buffer = buffer_->asMutable<char>();
+    for (auto i = 0; i < data->size(); ++i) {
+      auto rowSize =
+          UnsafeRowDynamicSerializer::serialize(rowType, data, buffer, i);
+      folly::doNotOptimizeAway(rowSize);
+      // The serializer expects a zeroed buffer.
+      std::memset(buffer, 0, rowSize.value_or(0));
+    }
+  }
+
+ private:
+  std::unique_ptr<memory::ScopedMemoryPool> pool_ =
+      memory::getDefaultScopedMemoryPool();
+  BufferPtr buffer_ =
+      AlignedBuffer::allocate<char>(64 << 10, pool_.get(), char(0));
+};
+
+class UnsaferowBatchSerializer : public Serializer {
+ public:
+  void serialize(const RowVectorPtr& data) override {
+    auto totalSize = UnsafeRowBatchSerializer::computeRowSizes(data, sizes_);
+    BufferPtr bufferPtr = AlignedBuffer::allocate<char>(totalSize, pool_.get());
+    UnsafeRowBatchSerializer::serialize(
+        data, sizes_, bufferPtr->asMutable<char>(), rows_);
+    folly::doNotOptimizeAway(rows_);
+  }
+
+ private:
+  std::unique_ptr<memory::ScopedMemoryPool> pool_ =
+      memory::getDefaultScopedMemoryPool();
+  std::vector<size_t> sizes_;
+  std::vector<std::optional<std::string_view>> rows_;
+};
+
+class BenchmarkHelper {
+ public:
+  RowVectorPtr randomRowVector(int nFields, int nRows, bool stringOnly) {
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    names.reserve(nFields);
+    types.reserve(nFields);
+    for (int32_t i = 0; i < nFields; ++i) {
+      names.push_back("");
+      if (stringOnly) {
+        types.push_back(VARCHAR());
+      } else {
+        auto idx = folly::Random::rand32() % allTypes_.size();
+        types.push_back(allTypes_[idx]);
+      }
+    }
+    auto rowType =
+        TypeFactory<TypeKind::ROW>::create(std::move(names), std::move(types));
+
+    VectorFuzzer::Options opts;
+    opts.vectorSize = nRows;
+    opts.nullRatio = 0.1;
+    opts.stringVariableLength = true;
+    opts.stringLength = 20;
+    // Spark uses microseconds to store timestamp
+    opts.useMicrosecondPrecisionTimestamp = true;
+    opts.containerLength = 5;
+
+    VectorFuzzer fuzzer(opts, pool_.get(), folly::Random::rand32());
+    return fuzzer.fuzzRow(rowType);
+  }
+
+ private:
+  std::vector<TypePtr> allTypes_{
+      BOOLEAN(),
+      TINYINT(),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      REAL(),
+      DOUBLE(),
+      VARCHAR(),
+      TIMESTAMP(),
+      ARRAY(INTEGER()),
+      MAP(VARCHAR(), ARRAY(INTEGER())),
+      ROW({INTEGER()})};
+
+  std::unique_ptr<memory::ScopedMemoryPool> pool_ =
+      memory::getDefaultScopedMemoryPool();
+};
+
+int serialize(
+    int nIters,
+    int nFields,
+    int nRows,
+    bool stringOnly,
+    std::unique_ptr<Serializer> serializer) {
+  folly::BenchmarkSuspender suspender;
+  BenchmarkHelper helper;
+  auto data = helper.randomRowVector(nFields, nRows, stringOnly);
+  suspender.dismiss();
+
+  for (int i = 0; i < nIters; i++) {
+    serializer->serialize(data);
+  }
+
+  return nIters * nFields * nRows;
+}
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serialize,
+    row_10_10k_string_only,
+    10,
+    10000,
+    true,
+    std::make_unique<UnsaferowSerializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serialize,
+    batch_10_10k_string_only,
+    10,
+    10000,
+    true,
+    std::make_unique<UnsaferowBatchSerializer>());
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serialize,
+    row_10_10k_all_types,
+    10,
+    10000,
+    false,
+    std::make_unique<UnsaferowSerializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serialize,
+    batch_10_10k_all_types,
+    10,
+    10000,
+    false,
+    std::make_unique<UnsaferowBatchSerializer>());
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serialize,
+    row_50_10k_all_types,
+    50,
+    10000,
+    false,
+    std::make_unique<UnsaferowSerializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serialize,
+    batch_50_10k_all_types,
+    50,
+    10000,
+    false,
+    std::make_unique<UnsaferowBatchSerializer>());
+
+} // namespace
+} // namespace facebook::spark::benchmarks
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -20,6 +20,8 @@
 #include <folly/init/Init.h>
 
 #include "velox/row/UnsafeRowBatchDeserializer.h"
+#include "velox/row/UnsafeRowBatchSerializer.h"
+#include "velox/row/UnsafeRowColumnarDeserializer.h"
 #include "velox/row/UnsafeRowDynamicSerializer.h"
 #include "velox/type/Type.h"
 #include "velox/vector/BaseVector.h"
@@ -97,5 +99,135 @@ TEST_F(UnsafeRowFuzzTests, simpleTypeRoundTripTest) {
   }
 }
 
+TEST_F(UnsafeRowFuzzTests, batchSerializer) {
+  auto rowType = ROW(
+      {BOOLEAN(),
+       TINYINT(),
+       SMALLINT(),
+       INTEGER(),
+       BIGINT(),
+       REAL(),
+       DOUBLE(),
+       VARCHAR(),
+       TIMESTAMP(),
+       DATE(),
+       ROW({VARCHAR(), INTEGER()}),
+       ARRAY(INTEGER()),
+       ARRAY(VARCHAR()),
+       MAP(VARCHAR(), ARRAY(INTEGER())),
+       VARBINARY()});
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 100;
+  opts.nullRatio = 0.1;
+  opts.stringVariableLength = true;
+  opts.stringLength = 20;
+  opts.useMicrosecondPrecisionTimestamp = true;
+  opts.containerLength = 10;
+
+  auto seed = folly::Random::rand32();
+  LOG(INFO) << "seed: " << seed;
+  VectorFuzzer fuzzer(opts, pool_.get(), seed);
+
+  std::vector<size_t> rowSizes;
+  std::vector<std::optional<std::string_view>> rows;
+  for (auto i = 0; i < 20; ++i) {
+    auto input = fuzzer.fuzzRow(rowType);
+    auto totalSize = UnsafeRowBatchSerializer::computeRowSizes(input, rowSizes);
+    // Fills the buffer with garbage to check that padding is cleared.
+    auto batch =
+        AlignedBuffer::allocate<char>(totalSize, pool_.get(), char(0xff));
+    UnsafeRowBatchSerializer::serialize(
+        input, rowSizes, batch->asMutable<char>(), rows);
+    ASSERT_EQ(rows.size(), input->size());
+
+    for (auto row = 0; row < input->size(); ++row) {
+      clearBuffer();
+      auto expected = UnsafeRowDynamicSerializer::serialize(
+          rowType, input, buffer_, row);
+      ASSERT_EQ(expected.has_value(), rows[row].has_value())
+          << "row " << row << " (seed " << seed << ")";
+      if (!expected.has_value()) {
+        continue;
+      }
+      ASSERT_EQ(std::string_view(buffer_, expected.value()), rows[row].value())
+          << "row " << row << " (seed " << seed << ")";
+    }
+  }
+}
+
+TEST_F(UnsafeRowFuzzTests, transposeBits) {
+  uint64_t words[64];
+  for (auto i = 0; i < 64; ++i) {
+    words[i] = folly::Random::rand64();
+  }
+  uint64_t transposed[64];
+  std::memcpy(transposed, words, sizeof(words));
+  UnsafeRowColumnarDeserializer::transposeBits(transposed);
+  for (auto i = 0; i < 64; ++i) {
+    for (auto j = 0; j < 64; ++j) {
+      ASSERT_EQ(bits::isBitSet(&words[i], j), bits::isBitSet(&transposed[j], i))
+          << i << " " << j;
+    }
+  }
+}
+
+TEST_F(UnsafeRowFuzzTests, columnarDeserializer) {
+  // More than 64 fields to have more than one word of null flags.
+  std::vector<TypePtr> types{
+      BOOLEAN(),
+      TINYINT(),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      REAL(),
+      DOUBLE(),
+      VARCHAR(),
+      TIMESTAMP(),
+      DATE(),
+      ROW({VARCHAR(), INTEGER()}),
+      ARRAY(INTEGER()),
+      MAP(VARCHAR(), ARRAY(INTEGER())),
+      VARBINARY()};
+  for (auto i = 0; i < 60; ++i) {
+    types.push_back(i % 2 ? VARCHAR() : BIGINT());
+  }
+  std::vector<std::string> names;
+  for (auto i = 0; i < types.size(); ++i) {
+    names.push_back(fmt::format("c{}", i));
+  }
+  auto rowType = ROW(std::move(names), std::move(types));
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 130;
+  opts.nullRatio = 0.1;
+  opts.stringVariableLength = true;
+  opts.stringLength = 20;
+  opts.useMicrosecondPrecisionTimestamp = true;
+  opts.containerLength = 10;
+
+  auto seed = folly::Random::rand32();
+  LOG(INFO) << "seed: " << seed;
+  VectorFuzzer fuzzer(opts, pool_.get(), seed);
+
+  std::vector<size_t> rowSizes;
+  std::vector<std::optional<std::string_view>> rows;
+  for (auto i = 0; i < 10; ++i) {
+    auto input = fuzzer.fuzzRow(rowType);
+    auto totalSize = UnsafeRowBatchSerializer::computeRowSizes(input, rowSizes);
+    auto data = AlignedBuffer::allocate<char>(totalSize, pool_.get());
+    UnsafeRowBatchSerializer::serialize(
+        input, rowSizes, data->asMutable<char>(), rows);
+
+    // With and without referencing the serialized data.
+    auto output = UnsafeRowColumnarDeserializer::deserialize(
+        rows, rowType, pool_.get(), data);
+    assertEqualVectors(input, output, fmt::format(" (seed {}).", seed));
+    output =
+        UnsafeRowColumnarDeserializer::deserialize(rows, rowType, pool_.get());
+    assertEqualVectors(input, output, fmt::format(" (seed {}).", seed));
+  }
+}
+
 } // namespace
 } // namespace facebook::velox::row
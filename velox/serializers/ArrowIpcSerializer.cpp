@@ -0,0 +1,522 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/serializers/ArrowIpcSerializer.h"
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/c/bridge.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/record_batch.h>
+#include <arrow/util/compression.h>
+#include <numeric>
+
+#include "velox/common/memory/ByteStream.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+#include "velox/vector/arrow/Bridge.h"
+
+namespace facebook::velox::serializer::arrowipc {
+namespace {
+
+void checkStatus(const ::arrow::Status& status) {
+  VELOX_CHECK(status.ok(), "Arrow IPC error: {}", status.ToString());
+}
+
+template <typename T>
+T valueOrThrow(::arrow::Result<T> result) {
+  checkStatus(result.status());
+  return std::move(result).ValueUnsafe();
+}
+
+::arrow::ipc::IpcWriteOptions makeWriteOptions(
+    folly::io::CodecType compressionKind) {
+  auto options = ::arrow::ipc::IpcWriteOptions::Defaults();
+  switch (compressionKind) {
+    case folly::io::CodecType::NO_COMPRESSION:
+      break;
+    case folly::io::CodecType::LZ4:
+    case folly::io::CodecType::LZ4_FRAME:
+      options.codec = valueOrThrow(
+          ::arrow::util::Codec::Create(::arrow::Compression::LZ4_FRAME));
+      break;
+    default:
+      VELOX_USER_FAIL(
+          "Arrow IPC supports only LZ4 compression: {}",
+          static_cast<int32_t>(compressionKind));
+  }
+  return options;
+}
+
+// Writes an Arrow stream to an OutputStream.
+class ArrowOutputStream : public ::arrow::io::OutputStream {
+ public:
+  explicit ArrowOutputStream(velox::OutputStream* FOLLY_NONNULL out)
+      : out_(out) {}
+
+  ::arrow::Status Write(const void* data, int64_t nbytes) override {
+    out_->write(static_cast<const char*>(data), nbytes);
+    position_ += nbytes;
+    return ::arrow::Status::OK();
+  }
+
+  ::arrow::Status Close() override {
+    closed_ = true;
+    return ::arrow::Status::OK();
+  }
+
+  ::arrow::Result<int64_t> Tell() const override {
+    return position_;
+  }
+
+  bool closed() const override {
+    return closed_;
+  }
+
+ private:
+  velox::OutputStream* const FOLLY_NONNULL out_;
+  int64_t position_{0};
+  bool closed_{false};
+};
+
+// Reads an Arrow stream from a ByteStream. Arrow reads each message with
+// reads of exactly its size, so that the reader stops at the end of stream
+// marker and 'source' is left at the start of the next page.
+class ArrowInputStream : public ::arrow::io::InputStream {
+ public:
+  explicit ArrowInputStream(ByteStream* FOLLY_NONNULL source)
+      : source_(source) {}
+
+  ::arrow::Result<int64_t> Read(int64_t nbytes, void* out) override {
+    try {
+      source_->readBytes(static_cast<uint8_t*>(out), nbytes);
+    } catch (const std::exception& e) {
+      return ::arrow::Status::IOError(e.what());
+    }
+    position_ += nbytes;
+    return nbytes;
+  }
+
+  ::arrow::Result<std::shared_ptr<::arrow::Buffer>> Read(
+      int64_t nbytes) override {
+    ARROW_ASSIGN_OR_RAISE(auto buffer, ::arrow::AllocateBuffer(nbytes));
+    ARROW_RETURN_NOT_OK(Read(nbytes, buffer->mutable_data()).status());
+    return std::shared_ptr<::arrow::Buffer>(std::move(buffer));
+  }
+
+  ::arrow::Status Close() override {
+    closed_ = true;
+    return ::arrow::Status::OK();
+  }
+
+  ::arrow::Result<int64_t> Tell() const override {
+    return position_;
+  }
+
+  bool closed() const override {
+    return closed_;
+  }
+
+ private:
+  ByteStream* const FOLLY_NONNULL source_;
+  int64_t position_{0};
+  bool closed_{false};
+};
+
+// Converts a flat vector, or a row vector of flat vectors, with the Arrow
+// bridge.
+std::shared_ptr<::arrow::Array> toArrow(
+    const VectorPtr& vector,
+    memory::MemoryPool* pool) {
+  ArrowSchema arrowSchema;
+  ArrowArray arrowArray;
+  exportToArrow(vector->type(), arrowSchema);
+  try {
+    exportToArrow(vector, arrowArray, pool);
+  } catch (const VeloxException&) {
+    arrowSchema.release(&arrowSchema);
+    throw;
+  }
+  return valueOrThrow(::arrow::ImportArray(&arrowArray, &arrowSchema));
+}
+
+std::shared_ptr<::arrow::Array> toArrowDictionary(
+    BufferPtr nulls,
+    BufferPtr indices,
+    vector_size_t size,
+    const VectorPtr& base,
+    memory::MemoryPool* pool) {
+  auto arrowIndices = toArrow(
+      std::make_shared<FlatVector<int32_t>>(
+          pool,
+          INTEGER(),
+          std::move(nulls),
+          size,
+          std::move(indices),
+          std::vector<BufferPtr>{}),
+      pool);
+  auto dictionary = toArrow(base, pool);
+  return valueOrThrow(::arrow::DictionaryArray::FromArrays(
+      ::arrow::dictionary(::arrow::int32(), dictionary->type()),
+      arrowIndices,
+      dictionary));
+}
+
+// Returns the flat base of 'vector' if 'vector' is a dictionary over a flat
+// vector of a type Arrow has dictionaries for, nullptr otherwise.
+VectorPtr dictionaryBase(const VectorPtr& vector) {
+  if (vector->encoding() != VectorEncoding::Simple::DICTIONARY) {
+    return nullptr;
+  }
+  auto base = vector->valueVector();
+  if (base->encoding() != VectorEncoding::Simple::FLAT ||
+      !base->type()->isPrimitiveType()) {
+    return nullptr;
+  }
+  return base;
+}
+
+// Returns 'vector' if it is flat, a flat copy otherwise.
+VectorPtr flatten(const VectorPtr& vector, memory::MemoryPool* pool) {
+  if (vector->encoding() == VectorEncoding::Simple::FLAT) {
+    return vector;
+  }
+  auto flat = BaseVector::create(vector->type(), vector->size(), pool);
+  flat->copy(vector.get(), 0, 0, vector->size());
+  return flat;
+}
+
+VectorPtr toVelox(
+    const std::shared_ptr<::arrow::Array>& array,
+    memory::MemoryPool* pool) {
+  if (array->type_id() == ::arrow::Type::DICTIONARY) {
+    auto& dictionaryArray =
+        static_cast<const ::arrow::DictionaryArray&>(*array);
+    auto indices = toVelox(dictionaryArray.indices(), pool);
+    VELOX_CHECK_EQ(
+        indices->typeKind(),
+        TypeKind::INTEGER,
+        "Arrow dictionary indices must be int32");
+    return BaseVector::wrapInDictionary(
+        indices->nulls(),
+        indices->values(),
+        indices->size(),
+        toVelox(dictionaryArray.dictionary(), pool));
+  }
+  ArrowSchema arrowSchema;
+  ArrowArray arrowArray;
+  checkStatus(::arrow::ExportArray(*array, &arrowArray, &arrowSchema));
+  return importFromArrowAsOwner(arrowSchema, arrowArray, pool);
+}
+
+RowVectorPtr toVelox(
+    const ::arrow::RecordBatch& batch,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool) {
+  VELOX_CHECK_EQ(batch.num_columns(), type->size());
+  std::vector<VectorPtr> children(type->size());
+  for (auto i = 0; i < type->size(); ++i) {
+    children[i] = toVelox(batch.column(i), pool);
+  }
+  return std::make_shared<RowVector>(
+      pool, type, nullptr, batch.num_rows(), std::move(children));
+}
+
+class ArrowIpcVectorSerializer : public VectorSerializer {
+ public:
+  ArrowIpcVectorSerializer(
+      RowTypePtr type,
+      const VectorSerde::Options* options)
+      : type_(std::move(type)),
+        compressionKind_(
+            options ? options->compressionKind
+                    : folly::io::CodecType::NO_COMPRESSION) {}
+
+  void append(
+      RowVectorPtr vector,
+      const folly::Range<const IndexRange*>& ranges) override {
+    vector_size_t newRows = 0;
+    for (auto& range : ranges) {
+      newRows += range.size;
+    }
+    if (newRows == 0) {
+      return;
+    }
+    numRows_ += newRows;
+    appends_.push_back(
+        {std::move(vector),
+         std::vector<IndexRange>(ranges.begin(), ranges.end())});
+  }
+
+  void flush(OutputStream* out) override {
+    VELOX_CHECK(!appends_.empty(), "Arrow IPC page has no rows");
+    std::vector<std::shared_ptr<::arrow::Array>> columns(type_->size());
+    std::vector<std::shared_ptr<::arrow::Field>> fields(type_->size());
+    for (auto i = 0; i < type_->size(); ++i) {
+      columns[i] = columnToArrow(i);
+      fields[i] = ::arrow::field(type_->nameOf(i), columns[i]->type());
+    }
+    auto schema = ::arrow::schema(std::move(fields));
+    ArrowOutputStream sink(out);
+    auto writer = valueOrThrow(::arrow::ipc::MakeStreamWriter(
+        &sink, schema, makeWriteOptions(compressionKind_)));
+    checkStatus(writer->WriteRecordBatch(
+        *::arrow::RecordBatch::Make(schema, numRows_, std::move(columns))));
+    checkStatus(writer->Close());
+  }
+
+ private:
+  struct Append {
+    RowVectorPtr vector;
+    std::vector<IndexRange> ranges;
+  };
+
+  std::shared_ptr<::arrow::Array> columnToArrow(int32_t column) {
+    auto* pool = appends_[0].vector->pool();
+    std::vector<VectorPtr> children;
+    children.reserve(appends_.size());
+    for (auto& append : appends_) {
+      children.push_back(
+          BaseVector::loadedVectorShared(append.vector->childAt(column)));
+    }
+
+    // The rows of all appends index into the same dictionary base.
+    auto base = dictionaryBase(children[0]);
+    for (auto i = 1; base && i < children.size(); ++i) {
+      if (dictionaryBase(children[i]) != base) {
+        base = nullptr;
+      }
+    }
+    if (base && base->size() <= numRows_) {
+      auto indices = AlignedBuffer::allocate<vector_size_t>(numRows_, pool);
+      auto* rawIndices = indices->asMutable<vector_size_t>();
+      BufferPtr nulls;
+      vector_size_t offset = 0;
+      for (auto i = 0; i < appends_.size(); ++i) {
+        auto* childIndices = children[i]->wrapInfo()->as<vector_size_t>();
+        auto* childNulls = children[i]->rawNulls();
+        if (childNulls && !nulls) {
+          nulls =
+              AlignedBuffer::allocate<bool>(numRows_, pool, bits::kNotNull);
+        }
+        for (auto& range : appends_[i].ranges) {
+          std::copy(
+              childIndices + range.begin,
+              childIndices + range.begin + range.size,
+              rawIndices + offset);
+          if (childNulls) {
+            bits::copyBits(
+                childNulls,
+                range.begin,
+                nulls->asMutable<uint64_t>(),
+                offset,
+                range.size);
+          }
+          offset += range.size;
+        }
+      }
+      return toArrowDictionary(
+          std::move(nulls), std::move(indices), numRows_, base, pool);
+    }
+
+    // A single flat vector covering the page is exported without a copy.
+    auto& ranges = appends_[0].ranges;
+    if (appends_.size() == 1 && ranges.size() == 1 && ranges[0].begin == 0 &&
+        ranges[0].size == children[0]->size() &&
+        children[0]->encoding() == VectorEncoding::Simple::FLAT) {
+      return toArrow(children[0], pool);
+    }
+    auto flat = BaseVector::create(type_->childAt(column), numRows_, pool);
+    vector_size_t offset = 0;
+    for (auto i = 0; i < appends_.size(); ++i) {
+      for (auto& range : appends_[i].ranges) {
+        flat->copy(children[i].get(), offset, range.begin, range.size);
+        offset += range.size;
+      }
+    }
+    return toArrow(flat, pool);
+  }
+
+  const RowTypePtr type_;
+  const folly::io::CodecType compressionKind_;
+  std::vector<Append> appends_;
+  vector_size_t numRows_{0};
+};
+
+} // namespace
+
+void ArrowIpcVectorSerde::estimateSerializedSize(
+    std::shared_ptr<BaseVector> vector,
+    const folly::Range<const IndexRange*>& ranges,
+    vector_size_t** sizes) {
+  const auto& type = vector->type();
+  if (type->isFixedWidth()) {
+    for (auto i = 0; i < ranges.size(); ++i) {
+      *sizes[i] += ranges[i].size * type->cppSizeInBytes();
+    }
+    return;
+  }
+  if (type->kind() == TypeKind::VARCHAR ||
+      type->kind() == TypeKind::VARBINARY) {
+    SelectivityVector allRows(vector->size());
+    DecodedVector decoded(*vector, allRows);
+    for (auto i = 0; i < ranges.size(); ++i) {
+      for (auto row = ranges[i].begin; row < ranges[i].begin + ranges[i].size;
+           ++row) {
+        // The offset and the string bytes.
+        *sizes[i] += sizeof(int32_t);
+        if (!decoded.isNullAt(row)) {
+          *sizes[i] += decoded.valueAt<StringView>(row).size();
+        }
+      }
+    }
+    return;
+  }
+  // The average size of a row for nested types.
+  const auto rowSize =
+      vector->retainedSize() / std::max<vector_size_t>(1, vector->size());
+  for (auto i = 0; i < ranges.size(); ++i) {
+    *sizes[i] += ranges[i].size * rowSize;
+  }
+}
+
+std::unique_ptr<VectorSerializer> ArrowIpcVectorSerde::createSerializer(
+    std::shared_ptr<const RowType> type,
+    int32_t /*numRows*/,
+    StreamArena* /*streamArena*/,
+    Options* options) {
+  return std::make_unique<ArrowIpcVectorSerializer>(std::move(type), options);
+}
+
+void ArrowIpcVectorSerde::deserialize(
+    ByteStream* source,
+    velox::memory::MemoryPool* pool,
+    std::shared_ptr<const RowType> type,
+    std::shared_ptr<RowVector>* result,
+    const Options* /*options*/) {
+  // The codec of compressed pages is in the Arrow metadata.
+  ArrowInputStream input(source);
+  auto reader =
+      valueOrThrow(::arrow::ipc::RecordBatchStreamReader::Open(&input));
+  std::vector<RowVectorPtr> batches;
+  vector_size_t numRows = 0;
+  for (;;) {
+    std::shared_ptr<::arrow::RecordBatch> batch;
+    checkStatus(reader->ReadNext(&batch));
+    if (!batch) {
+      break;
+    }
+    batches.push_back(toVelox(*batch, type, pool));
+    numRows += batches.back()->size();
+  }
+  if (batches.size() == 1) {
+    *result = std::move(batches[0]);
+    return;
+  }
+  // Pages from other producers may have several record batches.
+  *result = std::static_pointer_cast<RowVector>(
+      BaseVector::create(type, numRows, pool));
+  vector_size_t offset = 0;
+  for (auto& batch : batches) {
+    (*result)->copy(batch.get(), offset, 0, batch->size());
+    offset += batch->size();
+  }
+}
+
+// static
+void ArrowIpcVectorSerde::registerVectorSerde() {
+  VELOX_REGISTER_VECTOR_SERDE(ArrowIpcVectorSerde);
+}
+
+VELOX_DECLARE_VECTOR_SERDE(ArrowIpcVectorSerde);
+
+ArrowIpcWriter::ArrowIpcWriter(
+    std::shared_ptr<::arrow::io::OutputStream> sink,
+    const VectorSerde::Options* options,
+    memory::MemoryPool* pool)
+    : sink_(std::move(sink)),
+      compressionKind_(
+          options ? options->compressionKind
+                  : folly::io::CodecType::NO_COMPRESSION),
+      pool_(pool) {}
+
+ArrowIpcWriter::~ArrowIpcWriter() = default;
+
+void ArrowIpcWriter::write(const RowVectorPtr& vector) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!closed_, "Write to a closed ArrowIpcWriter");
+  const auto numColumns = vector->childrenSize();
+  std::vector<VectorPtr> children(numColumns);
+  for (auto i = 0; i < numColumns; ++i) {
+    children[i] = BaseVector::loadedVectorShared(vector->childAt(i));
+  }
+  if (!writer_) {
+    isDictionary_.resize(numColumns);
+    for (auto i = 0; i < numColumns; ++i) {
+      isDictionary_[i] = dictionaryBase(children[i]) != nullptr;
+    }
+  }
+
+  std::vector<std::shared_ptr<::arrow::Array>> columns(numColumns);
+  for (auto i = 0; i < numColumns; ++i) {
+    auto& child = children[i];
+    if (!isDictionary_[i]) {
+      columns[i] = toArrow(flatten(child, pool_), pool_);
+    } else if (auto base = dictionaryBase(child)) {
+      columns[i] = toArrowDictionary(
+          child->nulls(), child->wrapInfo(), child->size(), base, pool_);
+    } else {
+      // A dictionary column gets the flat values as a dictionary.
+      auto indices =
+          AlignedBuffer::allocate<vector_size_t>(child->size(), pool_);
+      auto* rawIndices = indices->asMutable<vector_size_t>();
+      std::iota(rawIndices, rawIndices + child->size(), 0);
+      columns[i] = toArrowDictionary(
+          nullptr,
+          std::move(indices),
+          child->size(),
+          flatten(child, pool_),
+          pool_);
+    }
+  }
+
+  if (!writer_) {
+    std::vector<std::shared_ptr<::arrow::Field>> fields(numColumns);
+    auto& rowType = vector->type()->asRow();
+    for (auto i = 0; i < numColumns; ++i) {
+      fields[i] = ::arrow::field(rowType.nameOf(i), columns[i]->type());
+    }
+    schema_ = ::arrow::schema(std::move(fields));
+    writer_ = valueOrThrow(::arrow::ipc::MakeStreamWriter(
+        sink_, schema_, makeWriteOptions(compressionKind_)));
+  }
+  checkStatus(writer_->WriteRecordBatch(*::arrow::RecordBatch::Make(
+      schema_, vector->size(), std::move(columns))));
+}
+
+void ArrowIpcWriter::close() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  if (writer_) {
+    checkStatus(writer_->Close());
+  }
+}
+
+} // namespace facebook::velox::serializer::arrowipc
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <mutex>
+
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/VectorStream.h"
+
+namespace arrow {
+class Schema;
+namespace io {
+class OutputStream;
+} // namespace io
+namespace ipc {
+class RecordBatchWriter;
+} // namespace ipc
+} // namespace arrow
+
+namespace facebook::velox::serializer::arrowipc {
+
+// Serializes pages as Arrow IPC streams. Each page is a self-contained stream
+// of a schema, one record batch and the end of stream marker, so that pages
+// of a PartitionedOutput can be handed as is to Arrow Flight clients and
+// read back by Exchange when this serde is registered in place of the Presto
+// one. The columns are converted with the Arrow bridge, so the supported types
+// are those of exportToArrow().
+//
+// A column whose appended rows are all dictionary encoded over the same flat
+// base, no larger than the page, is written as an Arrow dictionary array of
+// the base's values. LZ4 in Options::compressionKind selects the LZ4 frame
+// compression of the record batch buffers. The adaptive skipping of
+// compression does not apply, since Arrow compresses all buffers.
+//
+// The serializer keeps the appended vectors until flush.
+class ArrowIpcVectorSerde : public VectorSerde {
+ public:
+  void estimateSerializedSize(
+      std::shared_ptr<BaseVector> vector,
+      const folly::Range<const IndexRange*>& ranges,
+      vector_size_t** sizes) override;
+
+  std::unique_ptr<VectorSerializer> createSerializer(
+      std::shared_ptr<const RowType> type,
+      int32_t numRows,
+      StreamArena* streamArena,
+      Options* options = nullptr) override;
+
+  void deserialize(
+      ByteStream* source,
+      velox::memory::MemoryPool* pool,
+      std::shared_ptr<const RowType> type,
+      std::shared_ptr<RowVector>* result,
+      const Options* options = nullptr) override;
+
+  static void registerVectorSerde();
+};
+
+// Writes RowVectors to 'sink' as one Arrow IPC stream, e.g. the body of a
+// Flight DoGet response. Used as the consumer of a Task, the CallbackSink at
+// the end of the plan writes the result batches directly:
+//
+//   ArrowIpcWriter writer(sink, &options, pool);
+//   auto task = std::make_shared<exec::Task>(
+//       taskId, plan, 0, queryCtx,
+//       [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+//         if (vector) {
+//           writer.write(vector);
+//         } else {
+//           writer.close();
+//         }
+//         return exec::BlockingReason::kNotBlocked;
+//       });
+//
+// The schema is fixed by the first batch. Columns that are dictionary
+// encoded in the first batch are Arrow dictionary columns and get a
+// dictionary batch whenever their dictionary changes. write() may be
+// called from several drivers.
+class ArrowIpcWriter {
+ public:
+  // 'options' may be nullptr.
+  ArrowIpcWriter(
+      std::shared_ptr<::arrow::io::OutputStream> sink,
+      const VectorSerde::Options* options,
+      memory::MemoryPool* FOLLY_NONNULL pool);
+
+  ~ArrowIpcWriter();
+
+  void write(const RowVectorPtr& vector);
+
+  // Writes the end of stream marker. Further writes are errors. Nothing is
+  // written if there were no batches, since the schema comes from the first
+  // batch.
+  void close();
+
+ private:
+  const std::shared_ptr<::arrow::io::OutputStream> sink_;
+  const folly::io::CodecType compressionKind_;
+  memory::MemoryPool* const FOLLY_NONNULL pool_;
+
+  std::mutex mutex_;
+  // True for the columns written as Arrow dictionary arrays.
+  std::vector<bool> isDictionary_;
+  std::shared_ptr<::arrow::Schema> schema_;
+  std::shared_ptr<::arrow::ipc::RecordBatchWriter> writer_;
+  bool closed_{false};
+};
+
+} // namespace facebook::velox::serializer::arrowipc
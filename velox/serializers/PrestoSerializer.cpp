@@ -14,6 +14,10 @@
  * limitations under the License.
  */
 #include "velox/serializers/PrestoSerializer.h"
+#include <folly/Random.h>
+#include <folly/io/IOBuf.h>
+#include <atomic>
+#include <sstream>
 #include "velox/common/memory/ByteStream.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/type/Date.h"
@@ -29,6 +33,14 @@ int8_t kCompressedBitMask = 1;
 int8_t kEncryptedBitMask = 2;
 int8_t kCheckSumBitMask = 4;
 
+// Block encodings that wrap another block instead of holding values of
+// the column type.
+constexpr std::string_view kRleEncoding{"RLE"};
+constexpr std::string_view kDictionaryEncoding{"DICTIONARY"};
+
+// Size of the id that follows the ids of a DICTIONARY block.
+constexpr int32_t kDictionaryIdSize = 3 * sizeof(int64_t);
+
 int64_t computeChecksum(
     PrestoOutputStreamListener* listener,
     int codecMarker,
@@ -41,15 +53,18 @@ int64_t computeChecksum(
   return result.checksum();
 }
 
+// Computes the checksum of the 'sizeInBytes' bytes of page data at the
+// position of 'source'. The data is compressed if the page is.
 int64_t computeChecksum(
     ByteStream* source,
     int codecMarker,
     int numRows,
-    int uncompressedSize) {
+    int uncompressedSize,
+    int sizeInBytes) {
   auto offset = source->tellp();
   boost::crc_32_type crc32;
 
-  auto remainingBytes = uncompressedSize;
+  auto remainingBytes = sizeInBytes;
   while (remainingBytes > 0) {
     auto data = source->nextView(remainingBytes);
     crc32.process_bytes(data.data(), data.size());
@@ -284,6 +299,43 @@ readNulls(ByteStream* source, vector_size_t size, BaseVector* result) {
   return nullCount;
 }
 
+// Keeps the input of a ByteStream alive while a BufferView references it.
+class InputOwnerReleaser {
+ public:
+  explicit InputOwnerReleaser(std::shared_ptr<void> owner)
+      : owner_(std::move(owner)) {}
+
+  void addRef() const {}
+
+  void release() const {}
+
+ private:
+  const std::shared_ptr<void> owner_;
+};
+
+// Returns a Buffer over the next 'size' bytes of 'source' without copying
+// them if 'source' has an input owner and the bytes are in one range and
+// start at a multiple of 'alignment'. Returns nullptr and reads nothing
+// otherwise.
+BufferPtr
+readBufferInPlace(ByteStream* source, int32_t size, int32_t alignment) {
+  if (!source->inputOwner() || size == 0) {
+    return nullptr;
+  }
+  auto data = source->readInPlace(size, alignment);
+  if (!data) {
+    return nullptr;
+  }
+  return BufferView<InputOwnerReleaser>::create(
+      data, size, InputOwnerReleaser(source->inputOwner()));
+}
+
+// True if the values of T have the same layout on the wire and in a
+// FlatVector, so that a column without nulls can reference the input.
+template <typename T>
+constexpr bool kReadInPlace =
+    std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
 template <typename T>
 void read(
     ByteStream* source,
@@ -291,6 +343,26 @@ void read(
     velox::memory::MemoryPool* pool,
     VectorPtr* result) {
   int32_t size = source->read<int32_t>();
+  if constexpr (kReadInPlace<T>) {
+    if (source->inputOwner()) {
+      auto position = source->tellp();
+      // A zero byte means that there are no nulls and the values follow.
+      if (source->readByte() == 0) {
+        auto values = readBufferInPlace(source, size * sizeof(T), alignof(T));
+        if (values) {
+          *result = std::make_shared<FlatVector<T>>(
+              pool,
+              type,
+              nullptr,
+              size,
+              std::move(values),
+              std::vector<BufferPtr>{});
+          return;
+        }
+      }
+      source->seekp(position);
+    }
+  }
   if (*result && result->unique()) {
     (*result)->resize(size);
   } else {
@@ -348,15 +420,17 @@ void read<StringView>(
 
   int32_t dataSize = source->read<int32_t>();
   auto& stringBuffers = flatResult->stringBuffers();
-  BufferPtr strings = findOrAllocateStringBuffer(dataSize, stringBuffers, pool);
-  auto rawStrings = strings->asMutable<uint8_t>();
+  BufferPtr strings = readBufferInPlace(source, dataSize, 1);
+  if (!strings) {
+    strings = findOrAllocateStringBuffer(dataSize, stringBuffers, pool);
+    source->readBytes(strings->asMutable<uint8_t>(), dataSize);
+  }
+  auto rawChars = strings->as<char>();
 
   stringBuffers.resize(1);
   stringBuffers[0] = std::move(strings);
 
-  source->readBytes(rawStrings, dataSize);
   int32_t previousOffset = 0;
-  auto rawChars = reinterpret_cast<char*>(rawStrings);
   for (int32_t i = 0; i < size; ++i) {
     int32_t offset = rawValues[i].size();
     rawValues[i] =
@@ -609,9 +683,39 @@ std::string readLengthPrefixedString(ByteStream* source) {
   return value;
 }
 
-void readAndCheckType(ByteStream* source, TypePtr type) {
+// Reads an RLE block of 'type' after its encoding name and returns it as
+// a ConstantVector.
+void readRleBlock(
+    ByteStream* source,
+    const TypePtr& type,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* result) {
+  auto size = source->read<int32_t>();
+  std::vector<VectorPtr> value(1);
+  readColumns(source, pool, {type}, &value);
+  VELOX_CHECK_EQ(value[0]->size(), 1, "RLE block must have one value");
+  *result = BaseVector::wrapInConstant(size, 0, value[0]);
+}
+
+// Reads a DICTIONARY block of 'type' after its encoding name and returns
+// it as a DictionaryVector over the dictionary of the block.
+void readDictionaryBlock(
+    ByteStream* source,
+    const TypePtr& type,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* result) {
+  auto size = source->read<int32_t>();
+  std::vector<VectorPtr> dictionary(1);
+  readColumns(source, pool, {type}, &dictionary);
+  auto indices = allocateIndices(size, pool);
+  source->readBytes(
+      indices->asMutable<uint8_t>(), size * sizeof(vector_size_t));
+  source->skip(kDictionaryIdSize);
+  *result = BaseVector::wrapInDictionary(nullptr, indices, size, dictionary[0]);
+}
+
+void checkEncoding(const std::string& encoding, const TypePtr& type) {
   auto kindEncoding = typeToEncodingName(type);
-  std::string encoding = readLengthPrefixedString(source);
   VELOX_CHECK(
       encoding == kindEncoding,
       "Encoding to Type mismatch {} expected {} got {}",
@@ -659,8 +763,27 @@ void readColumns(
         "Column reader for type {} is missing",
         types[i]->kindName());
 
-    readAndCheckType(source, types[i]);
-    it->second(source, types[i], pool, &(*result)[i]);
+    auto encoding = readLengthPrefixedString(source);
+    if (encoding == kRleEncoding) {
+      readRleBlock(source, types[i], pool, &(*result)[i]);
+      continue;
+    }
+    if (encoding == kDictionaryEncoding) {
+      readDictionaryBlock(source, types[i], pool, &(*result)[i]);
+      continue;
+    }
+    checkEncoding(encoding, types[i]);
+    auto& reused = (*result)[i];
+    if (reused &&
+        (reused->encoding() == VectorEncoding::Simple::CONSTANT ||
+         reused->encoding() == VectorEncoding::Simple::DICTIONARY ||
+         (reused->encoding() == VectorEncoding::Simple::FLAT &&
+          reused->values() && reused->values()->isView()))) {
+      // The previous page had an RLE or DICTIONARY block here or the
+      // values reference the previous page in place.
+      reused = nullptr;
+    }
+    it->second(source, types[i], pool, &reused);
   }
 }
 
@@ -672,6 +795,21 @@ void writeInt64(OutputStream* out, int64_t value) {
   out->write(reinterpret_cast<char*>(&value), sizeof(value));
 }
 
+void writeEncodingName(OutputStream* out, std::string_view name) {
+  writeInt32(out, name.size());
+  out->write(name.data(), name.size());
+}
+
+// Returns a new id for a DICTIONARY block. Presto takes blocks with the
+// same id to share their dictionary, so the id is unique per process
+// run and block.
+std::array<int64_t, 3> newDictionaryId() {
+  static const int64_t kMostSignificantBits = folly::Random::rand64();
+  static const int64_t kLeastSignificantBits = folly::Random::rand64();
+  static std::atomic<int64_t> sequenceId{0};
+  return {kMostSignificantBits, kLeastSignificantBits, sequenceId++};
+}
+
 // Appendable container for serialized values. To append a value at a
 // time, call appendNull or appendNonNull first. Then call
 // appendLength if the type has a length. A null value has a length of
@@ -683,6 +821,7 @@ class VectorStream {
       StreamArena* streamArena,
       int32_t initialNumRows)
       : type_(type),
+        streamArena_(streamArena),
         nulls_(streamArena, true, true),
         lengths_(streamArena),
         values_(streamArena) {
@@ -769,8 +908,22 @@ class VectorStream {
     return children_[index].get();
   }
 
+  // Adds 'ranges' of 'vector' as an RLE block if 'vector' is a constant
+  // or as a DICTIONARY block if it is a dictionary without added nulls
+  // over a base that is no larger than the added rows. Consecutive
+  // appends of the same constant value or dictionary base extend the
+  // block. Returns false if the rows must be appended flat. Rows kept
+  // encoded so far are then flattened first.
+  bool appendEncoded(
+      const VectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges);
+
   // Writes out the accumulated contents. Does not change the state.
   void flush(OutputStream* out) {
+    if (encoding_ != VectorEncoding::Simple::FLAT) {
+      flushEncoded(out);
+      return;
+    }
     out->write(reinterpret_cast<char*>(header_.buffer), header_.size);
     switch (type_->kind()) {
       case TypeKind::ROW:
@@ -849,11 +1002,48 @@ class VectorStream {
   }
 
  private:
+  void flushEncoded(OutputStream* out) {
+    if (encoding_ == VectorEncoding::Simple::CONSTANT) {
+      writeEncodingName(out, kRleEncoding);
+      writeInt32(out, numEncodedRows_);
+      encodedValues_->flush(out);
+      return;
+    }
+    writeEncodingName(out, kDictionaryEncoding);
+    writeInt32(out, numEncodedRows_);
+    encodedValues_->flush(out);
+    out->write(
+        reinterpret_cast<const char*>(ids_.data()),
+        ids_.size() * sizeof(int32_t));
+    for (auto part : dictionaryId_) {
+      writeInt64(out, part);
+    }
+  }
+
+  void appendIds(
+      const BaseVector* vector,
+      const folly::Range<const IndexRange*>& ranges);
+
+  // Appends the rows kept as an RLE or DICTIONARY block as flat values.
+  void flattenEncoded();
+
   int32_t nonNullCount_{0};
   int32_t nullCount_{0};
   int32_t totalLength_{0};
   bool hasLengths_{false};
   const TypePtr type_;
+  StreamArena* const streamArena_;
+  // CONSTANT or DICTIONARY if the rows are kept as an RLE or DICTIONARY
+  // block, FLAT otherwise.
+  VectorEncoding::Simple encoding_{VectorEncoding::Simple::FLAT};
+  // The constant of an RLE block or the base of a DICTIONARY block.
+  VectorPtr encodedVector_;
+  int32_t numEncodedRows_{0};
+  // The value of an RLE block or the dictionary of a DICTIONARY block.
+  std::unique_ptr<VectorStream> encodedValues_;
+  // Indices into 'encodedVector_' of the rows of a DICTIONARY block.
+  std::vector<int32_t> ids_;
+  std::array<int64_t, 3> dictionaryId_;
   ByteRange header_;
   ByteStream nulls_;
   ByteStream lengths_;
@@ -1160,27 +1350,41 @@ void serializeBiasVector(
     const BaseVector* vector,
     const folly::Range<const IndexRange*>& ranges,
     VectorStream* stream) {
-  auto biasVector = dynamic_cast<const BiasVector<T>*>(vector);
-  if (!vector->mayHaveNulls()) {
-    for (int32_t i = 0; i < ranges.size(); ++i) {
-      stream->appendNonNull(ranges[i].size);
-      int32_t end = ranges[i].begin + ranges[i].size;
-      for (int32_t offset = ranges[i].begin; offset < end; ++offset) {
-        stream->appendOne(biasVector->valueAtFast(offset));
+  auto biasVector = vector->asUnchecked<BiasVector<T>>();
+  const T bias = biasVector->bias();
+  const bool mayHaveNulls = vector->mayHaveNulls();
+  // The values are debiased into 'buffer' and appended in batches. The nulls
+  // go to a separate stream, so the batches may span nulls.
+  constexpr int32_t kBatchSize = 256;
+  T buffer[kBatchSize];
+  int32_t numBuffered = 0;
+  auto flush = [&]() {
+    stream->append<T>(folly::Range<const T*>(buffer, numBuffered));
+    numBuffered = 0;
+  };
+  biasVector->applyToBiasedValues([&](const auto* biasedValues) {
+    for (auto& range : ranges) {
+      if (!mayHaveNulls) {
+        stream->appendNonNull(range.size);
       }
-    }
-  } else {
-    for (int32_t i = 0; i < ranges.size(); ++i) {
-      int32_t end = ranges[i].begin + ranges[i].size;
-      for (int32_t offset = ranges[i].begin; offset < end; ++offset) {
-        if (biasVector->isNullAt(offset)) {
-          stream->appendNull();
-          continue;
+      const auto end = range.begin + range.size;
+      for (auto offset = range.begin; offset < end; ++offset) {
+        if (mayHaveNulls) {
+          if (vector->isNullAt(offset)) {
+            stream->appendNull();
+            continue;
+          }
+          stream->appendNonNull();
+        }
+        buffer[numBuffered++] = bias + biasedValues[offset];
+        if (numBuffered == kBatchSize) {
+          flush();
         }
-        stream->appendNonNull();
-        stream->appendOne(biasVector->valueAtFast(offset));
       }
     }
+  });
+  if (numBuffered) {
+    flush();
   }
 }
 
@@ -1226,6 +1430,97 @@ void serializeColumn(
   }
 }
 
+bool VectorStream::appendEncoded(
+    const VectorPtr& vector,
+    const folly::Range<const IndexRange*>& ranges) {
+  auto numRows = rangesTotalSize(ranges);
+  if (encoding_ != VectorEncoding::Simple::FLAT) {
+    if (encoding_ == VectorEncoding::Simple::CONSTANT &&
+        vector->encoding() == VectorEncoding::Simple::CONSTANT &&
+        vector->equalValueAt(encodedVector_.get(), 0, 0)) {
+      numEncodedRows_ += numRows;
+      return true;
+    }
+    if (encoding_ == VectorEncoding::Simple::DICTIONARY &&
+        vector->encoding() == VectorEncoding::Simple::DICTIONARY &&
+        !vector->nulls() && vector->valueVector() == encodedVector_) {
+      appendIds(vector.get(), ranges);
+      return true;
+    }
+    flattenEncoded();
+    return false;
+  }
+  if (nullCount_ + nonNullCount_ > 0) {
+    return false;
+  }
+  switch (vector->encoding()) {
+    case VectorEncoding::Simple::CONSTANT: {
+      if (numRows < 2) {
+        return false;
+      }
+      encodedValues_ = std::make_unique<VectorStream>(type_, streamArena_, 1);
+      IndexRange value{0, 1};
+      serializeColumn(
+          vector.get(), folly::Range(&value, 1), encodedValues_.get());
+      encodedVector_ = vector;
+      numEncodedRows_ = numRows;
+      break;
+    }
+    case VectorEncoding::Simple::DICTIONARY: {
+      auto base = vector->valueVector();
+      if (vector->nulls() || base->isLazy() || base->size() > numRows) {
+        return false;
+      }
+      encodedValues_ =
+          std::make_unique<VectorStream>(type_, streamArena_, base->size());
+      IndexRange all{0, base->size()};
+      serializeColumn(base.get(), folly::Range(&all, 1), encodedValues_.get());
+      encodedVector_ = base;
+      dictionaryId_ = newDictionaryId();
+      appendIds(vector.get(), ranges);
+      break;
+    }
+    default:
+      return false;
+  }
+  encoding_ = vector->encoding();
+  return true;
+}
+
+void VectorStream::appendIds(
+    const BaseVector* vector,
+    const folly::Range<const IndexRange*>& ranges) {
+  auto indices = vector->wrapInfo()->as<vector_size_t>();
+  for (auto& range : ranges) {
+    ids_.insert(
+        ids_.end(), indices + range.begin, indices + range.begin + range.size);
+  }
+  numEncodedRows_ += rangesTotalSize(ranges);
+}
+
+void VectorStream::flattenEncoded() {
+  auto encoding = encoding_;
+  auto vector = std::move(encodedVector_);
+  encoding_ = VectorEncoding::Simple::FLAT;
+  encodedValues_.reset();
+  if (encoding == VectorEncoding::Simple::CONSTANT) {
+    IndexRange rows{0, numEncodedRows_};
+    serializeColumn(vector.get(), folly::Range(&rows, 1), this);
+  } else {
+    std::vector<IndexRange> rows;
+    for (auto id : ids_) {
+      if (!rows.empty() && rows.back().begin + rows.back().size == id) {
+        ++rows.back().size;
+      } else {
+        rows.push_back({id, 1});
+      }
+    }
+    serializeColumn(vector.get(), folly::Range(rows.data(), rows.size()), this);
+    ids_.clear();
+  }
+  numEncodedRows_ = 0;
+}
+
 void expandRepeatedRanges(
     const BaseVector* vector,
     const vector_size_t* rawOffsets,
@@ -1492,7 +1787,15 @@ class PrestoVectorSerializer : public VectorSerializer {
   PrestoVectorSerializer(
       std::shared_ptr<const RowType> rowType,
       int32_t numRows,
-      StreamArena* streamArena) {
+      StreamArena* streamArena,
+      VectorSerde::Options* options)
+      : options_(options),
+        codec_(
+            options &&
+                    options->compressionKind !=
+                        folly::io::CodecType::NO_COMPRESSION
+                ? folly::io::getCodec(options->compressionKind)
+                : nullptr) {
     auto types = rowType->children();
     auto numTypes = types.size();
     streams_.resize(numTypes);
@@ -1509,13 +1812,36 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (newRows > 0) {
       numRows_ += newRows;
       for (int32_t i = 0; i < vector->childrenSize(); ++i) {
-        serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+        auto& child = vector->childAt(i);
+        if (!streams_[i]->appendEncoded(child, ranges)) {
+          serializeColumn(child.get(), ranges, streams_[i].get());
+        }
       }
     }
   }
 
   // Writes the contents to 'stream' in wire format
   void flush(OutputStream* out) override {
+    if (!codec_) {
+      flushUncompressed(out);
+      return;
+    }
+    if (options_->numPagesToSkip > 0) {
+      --options_->numPagesToSkip;
+      ++options_->numSkippedPages;
+      flushUncompressed(out);
+      return;
+    }
+    flushCompressed(out);
+  }
+
+ private:
+  static const int32_t kSizeInBytesOffset{4 + 1};
+  static const int32_t kChecksumOffset{kSizeInBytesOffset + 4 + 4};
+  static const int32_t kHeaderSize{kChecksumOffset + 8};
+
+  // Writes the page without copying the column streams.
+  void flushUncompressed(OutputStream* out) {
     auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
     // Reset CRC computation
     if (listener) {
@@ -1571,10 +1897,75 @@ class PrestoVectorSerializer : public VectorSerializer {
     out->seekp(offset + size);
   }
 
- private:
-  static const int32_t kSizeInBytesOffset{4 + 1};
-  static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
+  // Serializes the columns to memory and compresses them. Writes the
+  // page uncompressed and skips compressing the next pages of the
+  // stream if the compression ratio is worse than
+  // 'minCompressionRatio'.
+  void flushCompressed(OutputStream* out) {
+    std::ostringstream columns;
+    OStreamOutputStream columnsOut(&columns);
+    writeInt32(&columnsOut, streams_.size());
+    for (auto& stream : streams_) {
+      stream->flush(&columnsOut);
+    }
+    auto uncompressed = columns.str();
+    auto uncompressedBuf = folly::IOBuf::wrapBufferAsValue(
+        uncompressed.data(), uncompressed.size());
+    auto compressed = codec_->compress(&uncompressedBuf);
+    if (compressed->computeChainDataLength() >
+        uncompressed.size() * options_->minCompressionRatio) {
+      options_->numPagesToSkip = options_->nextPagesToSkip;
+      options_->nextPagesToSkip = std::min(
+          2 * options_->nextPagesToSkip,
+          VectorSerde::Options::kMaxPagesToSkip);
+      ++options_->numSkippedPages;
+      writePage(out, 0, uncompressed.size(), uncompressedBuf);
+      return;
+    }
+    options_->nextPagesToSkip = 1;
+    ++options_->numCompressedPages;
+    writePage(out, kCompressedBitMask, uncompressed.size(), *compressed);
+  }
+
+  // Writes a page of 'numRows_' rows with 'data' as its contents. 'data'
+  // is compressed if 'codecBits' has kCompressedBitMask set.
+  void writePage(
+      OutputStream* out,
+      char codecBits,
+      int32_t uncompressedSize,
+      const folly::IOBuf& data) {
+    auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
+    char codec = codecBits;
+    if (listener) {
+      listener->reset();
+      codec |= getCodecMarker();
+      listener->pause();
+    }
+    int32_t offset = out->tellp();
+    writeInt32(out, numRows_);
+    out->write(&codec, 1);
+    writeInt32(out, uncompressedSize);
+    writeInt32(out, data.computeChainDataLength());
+    writeInt64(out, 0); // Write zero checksum
 
+    if (listener) {
+      listener->resume();
+    }
+    for (auto range : data) {
+      out->write(reinterpret_cast<const char*>(range.data()), range.size());
+    }
+    if (listener) {
+      listener->pause();
+      int32_t end = out->tellp();
+      out->seekp(offset + kChecksumOffset);
+      writeInt64(
+          out, computeChecksum(listener, codec, numRows_, uncompressedSize));
+      out->seekp(end);
+    }
+  }
+
+  VectorSerde::Options* const options_;
+  const std::unique_ptr<folly::io::Codec> codec_;
   int32_t numRows_{0};
   std::vector<std::unique_ptr<VectorStream>> streams_;
 };
@@ -1590,15 +1981,18 @@ void PrestoVectorSerde::estimateSerializedSize(
 std::unique_ptr<VectorSerializer> PrestoVectorSerde::createSerializer(
     std::shared_ptr<const RowType> type,
     int32_t numRows,
-    StreamArena* streamArena) {
-  return std::make_unique<PrestoVectorSerializer>(type, numRows, streamArena);
+    StreamArena* streamArena,
+    Options* options) {
+  return std::make_unique<PrestoVectorSerializer>(
+      type, numRows, streamArena, options);
 }
 
 void PrestoVectorSerde::deserialize(
     ByteStream* source,
     velox::memory::MemoryPool* pool,
     std::shared_ptr<const RowType> type,
-    std::shared_ptr<RowVector>* result) {
+    std::shared_ptr<RowVector>* result,
+    const Options* options) {
   auto numRows = source->read<int32_t>();
   if (!(*result) || !result->unique() || (*result)->type() != type) {
     *result = std::dynamic_pointer_cast<RowVector>(
@@ -1609,25 +2003,53 @@ void PrestoVectorSerde::deserialize(
 
   auto pageCodecMarker = source->read<int8_t>();
   auto uncompressedSize = source->read<int32_t>();
-  // skip size in bytes
-  source->skip(4);
+  auto sizeInBytes = source->read<int32_t>();
   auto checksum = source->read<int64_t>();
 
   int64_t actualCheckSum = 0;
   if (isChecksumBitSet(pageCodecMarker)) {
-    actualCheckSum =
-        computeChecksum(source, pageCodecMarker, numRows, uncompressedSize);
+    actualCheckSum = computeChecksum(
+        source, pageCodecMarker, numRows, uncompressedSize, sizeInBytes);
   }
 
   VELOX_CHECK_EQ(
       checksum, actualCheckSum, "Received corrupted serialized page.");
 
-  // skip number of columns
-  source->skip(4);
-
   auto children = &(*result)->children();
   auto childTypes = type->as<TypeKind::ROW>().children();
-  readColumns(source, pool, childTypes, children);
+  if (!isCompressedBitSet(pageCodecMarker)) {
+    // skip number of columns
+    source->skip(4);
+    readColumns(source, pool, childTypes, children);
+    return;
+  }
+
+  VELOX_CHECK(
+      options &&
+          options->compressionKind != folly::io::CodecType::NO_COMPRESSION,
+      "Received a compressed page without a codec to decompress it");
+  auto compressed = folly::IOBuf::create(sizeInBytes);
+  source->readBytes(compressed->writableData(), sizeInBytes);
+  compressed->append(sizeInBytes);
+  std::shared_ptr<folly::IOBuf> uncompressed =
+      folly::io::getCodec(options->compressionKind)
+          ->uncompress(compressed.get(), uncompressedSize);
+  std::vector<ByteRange> ranges;
+  for (auto range : *uncompressed) {
+    if (range.empty()) {
+      continue;
+    }
+    ranges.push_back(
+        {const_cast<uint8_t*>(range.data()),
+         static_cast<int32_t>(range.size()),
+         0});
+  }
+  ByteStream uncompressedSource;
+  uncompressedSource.resetInput(std::move(ranges));
+  uncompressedSource.setInputOwner(std::move(uncompressed));
+  // skip number of columns
+  uncompressedSource.skip(4);
+  readColumns(&uncompressedSource, pool, childTypes, children);
 }
 
 void PrestoVectorSerde::registerVectorSerde() {
@@ -28,13 +28,17 @@ class PrestoVectorSerde : public VectorSerde {
   std::unique_ptr<VectorSerializer> createSerializer(
       std::shared_ptr<const RowType> type,
       int32_t numRows,
-      StreamArena* streamArena) override;
+      StreamArena* streamArena,
+      Options* options = nullptr) override;
 
+  // Decompresses pages that have the compressed bit set with the codec
+  // in 'options'.
   void deserialize(
       ByteStream* source,
       velox::memory::MemoryPool* pool,
       std::shared_ptr<const RowType> type,
-      std::shared_ptr<RowVector>* result) override;
+      std::shared_ptr<RowVector>* result,
+      const Options* options = nullptr) override;
 
   static void registerVectorSerde();
 };
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/serializers/ArrowIpcSerializer.h"
+
+#include <arrow/api.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/memory/ByteStream.h"
+#include "velox/vector/tests/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+
+class ArrowIpcSerializerTest : public ::testing::Test,
+                               public VectorTestBase {
+ protected:
+  // Serializes 'ranges' of each of 'vectors' into one page.
+  std::string serialize(
+      const std::vector<RowVectorPtr>& vectors,
+      const std::vector<std::vector<IndexRange>>& ranges,
+      VectorSerde::Options* options = nullptr) {
+    auto rowType = asRowType(vectors[0]->type());
+    auto arena =
+        std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
+    auto serializer = serde_.createSerializer(rowType, 0, arena.get(), options);
+    for (auto i = 0; i < vectors.size(); ++i) {
+      serializer->append(
+          vectors[i], folly::Range(ranges[i].data(), ranges[i].size()));
+    }
+    std::ostringstream out;
+    OStreamOutputStream output(&out);
+    serializer->flush(&output);
+    return out.str();
+  }
+
+  std::string serialize(
+      const RowVectorPtr& vector,
+      VectorSerde::Options* options = nullptr) {
+    return serialize({vector}, {{IndexRange{0, vector->size()}}}, options);
+  }
+
+  RowVectorPtr deserialize(const RowTypePtr& rowType, const std::string& page) {
+    ByteStream input;
+    input.resetInput({ByteRange{
+        reinterpret_cast<uint8_t*>(const_cast<char*>(page.data())),
+        static_cast<int32_t>(page.size()),
+        0}});
+    RowVectorPtr result;
+    serde_.deserialize(&input, pool(), rowType, &result);
+    EXPECT_TRUE(input.atEnd());
+    return result;
+  }
+
+  // Returns the record batches of the Arrow IPC stream in 'data'.
+  std::vector<std::shared_ptr<arrow::RecordBatch>> readArrowStream(
+      const std::string& data) {
+    arrow::io::BufferReader input(arrow::Buffer::FromString(data));
+    auto reader =
+        arrow::ipc::RecordBatchStreamReader::Open(&input).ValueOrDie();
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    for (;;) {
+      std::shared_ptr<arrow::RecordBatch> batch;
+      EXPECT_TRUE(reader->ReadNext(&batch).ok());
+      if (!batch) {
+        return batches;
+      }
+      batches.push_back(std::move(batch));
+    }
+  }
+
+  RowVectorPtr makeTestVector(vector_size_t size) {
+    std::vector<std::string> strings(20);
+    for (auto i = 0; i < strings.size(); ++i) {
+      strings[i] = std::string(i, 'x');
+    }
+    return makeRowVector(
+        {makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+         makeFlatVector<double>(
+             size, [](auto row) { return row * 0.1; }, nullEvery(7)),
+         makeFlatVector<StringView>(size, [&](auto row) {
+           return StringView(strings[row % strings.size()]);
+         })});
+  }
+
+  serializer::arrowipc::ArrowIpcVectorSerde serde_;
+};
+
+TEST_F(ArrowIpcSerializerTest, roundTrip) {
+  auto vector = makeTestVector(1'000);
+  auto page = serialize(vector);
+
+  auto batches = readArrowStream(page);
+  ASSERT_EQ(1, batches.size());
+  EXPECT_EQ(1'000, batches[0]->num_rows());
+  EXPECT_EQ(3, batches[0]->num_columns());
+
+  assertEqualVectors(vector, deserialize(asRowType(vector->type()), page));
+}
+
+TEST_F(ArrowIpcSerializerTest, ranges) {
+  auto first = makeTestVector(100);
+  auto second = makeTestVector(50);
+  auto page = serialize(
+      {first, second},
+      {{IndexRange{10, 20}, IndexRange{60, 5}}, {IndexRange{0, 50}}});
+  auto result = deserialize(asRowType(first->type()), page);
+  ASSERT_EQ(75, result->size());
+  for (auto i = 0; i < 20; ++i) {
+    EXPECT_TRUE(result->equalValueAt(first.get(), i, 10 + i));
+  }
+  for (auto i = 0; i < 5; ++i) {
+    EXPECT_TRUE(result->equalValueAt(first.get(), 20 + i, 60 + i));
+  }
+  for (auto i = 0; i < 50; ++i) {
+    EXPECT_TRUE(result->equalValueAt(second.get(), 25 + i, i));
+  }
+}
+
+TEST_F(ArrowIpcSerializerTest, dictionary) {
+  const vector_size_t size = 1'000;
+  auto base = makeFlatVector<StringView>(
+      {"apple", "banana", "a long string value", "cherry"});
+  auto vector = makeRowVector({BaseVector::wrapInDictionary(
+      makeNulls(size, nullEvery(11)),
+      makeIndices(size, [](auto row) { return row % 4; }),
+      size,
+      base)});
+  auto page = serialize(vector);
+
+  auto batches = readArrowStream(page);
+  ASSERT_EQ(1, batches.size());
+  auto& column = batches[0]->column(0);
+  ASSERT_EQ(arrow::Type::DICTIONARY, column->type_id());
+  auto& dictionaryArray = static_cast<const arrow::DictionaryArray&>(*column);
+  EXPECT_EQ(4, dictionaryArray.dictionary()->length());
+
+  auto result = deserialize(asRowType(vector->type()), page);
+  EXPECT_EQ(
+      VectorEncoding::Simple::DICTIONARY, result->childAt(0)->encoding());
+  assertEqualVectors(vector, result);
+}
+
+TEST_F(ArrowIpcSerializerTest, lz4) {
+  auto vector = makeRowVector({makeFlatVector<int64_t>(
+      10'000, [](auto row) { return row % 10; })});
+  VectorSerde::Options options;
+  options.compressionKind = folly::io::CodecType::LZ4_FRAME;
+  auto compressed = serialize(vector, &options);
+  auto plain = serialize(vector);
+  EXPECT_LT(compressed.size(), plain.size() / 2);
+  assertEqualVectors(
+      vector, deserialize(asRowType(vector->type()), compressed));
+
+  options.compressionKind = folly::io::CodecType::ZSTD;
+  VELOX_ASSERT_THROW(
+      serialize(vector, &options),
+      "Arrow IPC supports only LZ4 compression");
+}
+
+TEST_F(ArrowIpcSerializerTest, writer) {
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  serializer::arrowipc::ArrowIpcWriter writer(sink, nullptr, pool());
+
+  auto base = makeFlatVector<int32_t>({10, 20, 30});
+  auto first = makeRowVector(
+      {makeFlatVector<int64_t>({1, 2, 3, 4}),
+       wrapInDictionary(
+           makeIndices(4, [](auto row) { return row % 3; }), 4, base)});
+  // The dictionary column of the second batch is flat.
+  auto second = makeRowVector(
+      {makeFlatVector<int64_t>({5, 6}), makeFlatVector<int32_t>({7, 8})});
+  writer.write(first);
+  writer.write(second);
+  writer.close();
+
+  auto buffer = sink->Finish().ValueOrDie();
+  auto batches = readArrowStream(buffer->ToString());
+  ASSERT_EQ(2, batches.size());
+  for (auto& batch : batches) {
+    EXPECT_EQ(arrow::Type::INT64, batch->column(0)->type_id());
+    EXPECT_EQ(arrow::Type::DICTIONARY, batch->column(1)->type_id());
+  }
+  auto& dictionary =
+      static_cast<const arrow::DictionaryArray&>(*batches[1]->column(1));
+  EXPECT_EQ(
+      8,
+      static_cast<const arrow::Int32Array&>(*dictionary.dictionary()).Value(
+          dictionary.GetValueIndex(1)));
+
+  VELOX_ASSERT_THROW(writer.write(first), "Write to a closed ArrowIpcWriter");
+}
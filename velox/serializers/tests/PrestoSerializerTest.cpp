@@ -16,9 +16,11 @@
 #include "velox/serializers/PrestoSerializer.h"
 #include <folly/Random.h>
 #include <gtest/gtest.h>
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/vector/BaseVector.h"
+#include "velox/vector/BiasVector.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/tests/VectorTestBase.h"
 
@@ -45,7 +47,10 @@ class PrestoSerializerTest : public ::testing::Test {
     serde_->estimateSerializedSize(rowVector, ranges, rawRowSizes.data());
   }
 
-  void serialize(RowVectorPtr rowVector, std::ostream* output) {
+  void serialize(
+      RowVectorPtr rowVector,
+      std::ostream* output,
+      VectorSerde::Options* options = nullptr) {
     auto numRows = rowVector->size();
 
     std::vector<IndexRange> rows(numRows);
@@ -59,7 +64,8 @@ class PrestoSerializerTest : public ::testing::Test {
     auto arena =
         std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
     auto rowType = std::dynamic_pointer_cast<const RowType>(rowVector->type());
-    auto serializer = serde_->createSerializer(rowType, numRows, arena.get());
+    auto serializer =
+        serde_->createSerializer(rowType, numRows, arena.get(), options);
 
     serializer->append(rowVector, folly::Range(rows.data(), numRows));
     facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
@@ -79,11 +85,13 @@ class PrestoSerializerTest : public ::testing::Test {
 
   RowVectorPtr deserialize(
       std::shared_ptr<const RowType> rowType,
-      const std::string& input) {
+      const std::string& input,
+      const VectorSerde::Options* options = nullptr) {
     auto byteStream = toByteStream(input);
 
     RowVectorPtr result;
-    serde_->deserialize(byteStream.get(), pool_.get(), rowType, &result);
+    serde_->deserialize(
+        byteStream.get(), pool_.get(), rowType, &result, options);
     return result;
   }
 
@@ -125,6 +133,57 @@ TEST_F(PrestoSerializerTest, basic) {
   assertEqualVectors(deserialized, rowVector);
 }
 
+TEST_F(PrestoSerializerTest, compression) {
+  // The codec marker follows the row count.
+  auto isCompressed = [](const std::string& page) { return page[4] & 1; };
+  auto rowVector = makeTestVector(10'000);
+  auto rowType = std::dynamic_pointer_cast<const RowType>(rowVector->type());
+  std::ostringstream plain;
+  serialize(rowVector, &plain);
+
+  for (auto kind : {folly::io::CodecType::LZ4, folly::io::CodecType::ZSTD}) {
+    VectorSerde::Options options;
+    options.compressionKind = kind;
+    std::ostringstream out;
+    serialize(rowVector, &out, &options);
+    EXPECT_TRUE(isCompressed(out.str()));
+    EXPECT_LT(out.str().size(), plain.str().size());
+    EXPECT_EQ(1, options.numCompressedPages);
+    assertEqualVectors(deserialize(rowType, out.str(), &options), rowVector);
+    VELOX_ASSERT_THROW(
+        deserialize(rowType, out.str()),
+        "Received a compressed page without a codec to decompress it");
+  }
+
+  // Random values do not compress. Pages go out uncompressed and the
+  // next pages skip compression.
+  folly::Random::DefaultGenerator rng(1);
+  auto random = vectorMaker_->rowVector({vectorMaker_->flatVector<int64_t>(
+      10'000, [&](auto /*row*/) { return folly::Random::rand64(rng); })});
+  auto randomType = std::dynamic_pointer_cast<const RowType>(random->type());
+  VectorSerde::Options options;
+  options.compressionKind = folly::io::CodecType::LZ4;
+  std::ostringstream first;
+  serialize(random, &first, &options);
+  EXPECT_FALSE(isCompressed(first.str()));
+  EXPECT_EQ(1, options.numSkippedPages);
+  EXPECT_EQ(1, options.numPagesToSkip);
+  assertEqualVectors(deserialize(randomType, first.str(), &options), random);
+
+  std::ostringstream second;
+  serialize(random, &second, &options);
+  EXPECT_EQ(first.str(), second.str());
+  EXPECT_EQ(2, options.numSkippedPages);
+  EXPECT_EQ(0, options.numPagesToSkip);
+
+  // A page that compresses well resets the skipping.
+  std::ostringstream third;
+  serialize(rowVector, &third, &options);
+  EXPECT_TRUE(isCompressed(third.str()));
+  EXPECT_EQ(1, options.numCompressedPages);
+  EXPECT_EQ(1, options.nextPagesToSkip);
+}
+
 /// Test serialization of a dictionary vector that adds nulls to the base
 /// vector.
 TEST_F(PrestoSerializerTest, dictionaryWithExtraNulls) {
@@ -151,6 +210,135 @@ TEST_F(PrestoSerializerTest, dictionaryWithExtraNulls) {
   testRoundTrip(dictionary);
 }
 
+TEST_F(PrestoSerializerTest, encodings) {
+  vector_size_t size = 1'000;
+  auto base = vectorMaker_->flatVector<StringView>(
+      10, [](auto row) { return StringView(std::string(20, 'a' + row)); });
+  BufferPtr indices = AlignedBuffer::allocate<vector_size_t>(size, pool_.get());
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  for (auto i = 0; i < size; i++) {
+    rawIndices[i] = (i * 7) % 10;
+  }
+  auto nullConstant =
+      BaseVector::createConstant(variant(TypeKind::VARCHAR), size, pool_.get());
+  auto rowVector = vectorMaker_->rowVector(
+      {BaseVector::wrapInDictionary(nullptr, indices, size, base),
+       BaseVector::createConstant(variant(int64_t(11)), size, pool_.get()),
+       nullConstant,
+       vectorMaker_->flatVector<int32_t>(size, [](auto row) { return row; })});
+
+  std::ostringstream out;
+  serialize(rowVector, &out);
+  auto rowType = std::dynamic_pointer_cast<const RowType>(rowVector->type());
+  auto deserialized = deserialize(rowType, out.str());
+  assertEqualVectors(rowVector, deserialized);
+  EXPECT_EQ(
+      VectorEncoding::Simple::DICTIONARY,
+      deserialized->childAt(0)->encoding());
+  EXPECT_EQ(10, deserialized->childAt(0)->valueVector()->size());
+  EXPECT_EQ(
+      VectorEncoding::Simple::CONSTANT, deserialized->childAt(1)->encoding());
+  EXPECT_EQ(
+      VectorEncoding::Simple::CONSTANT, deserialized->childAt(2)->encoding());
+  EXPECT_TRUE(deserialized->childAt(2)->isNullAt(0));
+  EXPECT_EQ(
+      VectorEncoding::Simple::FLAT, deserialized->childAt(3)->encoding());
+
+  // A dictionary over a base larger than the serialized rows is flattened.
+  auto small = vectorMaker_->rowVector(
+      {BaseVector::wrapInDictionary(nullptr, indices, 5, base)});
+  std::ostringstream smallOut;
+  serialize(small, &smallOut);
+  deserialized = deserialize(
+      std::dynamic_pointer_cast<const RowType>(small->type()), smallOut.str());
+  assertEqualVectors(small, deserialized);
+  EXPECT_EQ(
+      VectorEncoding::Simple::FLAT, deserialized->childAt(0)->encoding());
+}
+
+TEST_F(PrestoSerializerTest, encodingsAcrossAppends) {
+  auto type = ROW({"c0"}, {BIGINT()});
+  auto first = vectorMaker_->rowVector(
+      {BaseVector::createConstant(variant(int64_t(1)), 100, pool_.get())});
+  auto same = vectorMaker_->rowVector(
+      {BaseVector::createConstant(variant(int64_t(1)), 50, pool_.get())});
+  auto other = vectorMaker_->rowVector(
+      {BaseVector::createConstant(variant(int64_t(2)), 50, pool_.get())});
+
+  auto serializeAll = [&](const std::vector<RowVectorPtr>& vectors) {
+    auto arena =
+        std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
+    auto serializer = serde_->createSerializer(type, 200, arena.get());
+    for (auto& vector : vectors) {
+      IndexRange all{0, vector->size()};
+      serializer->append(vector, folly::Range(&all, 1));
+    }
+    std::ostringstream out;
+    OStreamOutputStream output(&out);
+    serializer->flush(&output);
+    return deserialize(type, out.str());
+  };
+
+  // Appends of the same value extend the RLE block.
+  auto result = serializeAll({first, same});
+  ASSERT_EQ(150, result->size());
+  EXPECT_EQ(VectorEncoding::Simple::CONSTANT, result->childAt(0)->encoding());
+
+  // A different value flattens the rows.
+  result = serializeAll({first, other});
+  ASSERT_EQ(150, result->size());
+  EXPECT_EQ(VectorEncoding::Simple::FLAT, result->childAt(0)->encoding());
+  auto values = result->childAt(0)->asFlatVector<int64_t>();
+  for (auto i = 0; i < 150; ++i) {
+    EXPECT_EQ(i < 100 ? 1 : 2, values->valueAt(i));
+  }
+}
+
+TEST_F(PrestoSerializerTest, readInPlace) {
+  vector_size_t size = 1'000;
+  auto rowVector = vectorMaker_->rowVector(
+      {vectorMaker_->flatVector<int64_t>(size, [](auto row) { return row; }),
+       vectorMaker_->flatVector<StringView>(
+           size,
+           [](auto row) {
+             return StringView(std::string(row % 30, 'a' + row % 26));
+           }),
+       vectorMaker_->flatVector<int32_t>(
+           size, [](auto row) { return row; }, VectorMaker::nullEvery(7))});
+  std::ostringstream out;
+  serialize(rowVector, &out);
+  auto rowType = std::dynamic_pointer_cast<const RowType>(rowVector->type());
+
+  RowVectorPtr result;
+  {
+    // 'page' is 8 byte aligned and is kept alive by the result.
+    auto page = std::make_shared<std::vector<int64_t>>(
+        bits::roundUp(out.str().size(), 8) / 8);
+    memcpy(page->data(), out.str().data(), out.str().size());
+    ByteStream source;
+    source.resetInput({ByteRange{
+        reinterpret_cast<uint8_t*>(page->data()),
+        static_cast<int32_t>(out.str().size()),
+        0}});
+    source.setInputOwner(page);
+    serde_->deserialize(&source, pool_.get(), rowType, &result);
+  }
+  assertEqualVectors(rowVector, result);
+  EXPECT_TRUE(result->childAt(1)->asFlatVector<StringView>()
+                  ->stringBuffers()[0]
+                  ->isView());
+  // Values with nulls are copied.
+  EXPECT_FALSE(result->childAt(2)->values()->isView());
+
+  // Without an input owner everything is copied.
+  result = deserialize(rowType, out.str());
+  assertEqualVectors(rowVector, result);
+  EXPECT_FALSE(result->childAt(0)->values()->isView());
+  EXPECT_FALSE(result->childAt(1)->asFlatVector<StringView>()
+                   ->stringBuffers()[0]
+                   ->isView());
+}
+
 TEST_F(PrestoSerializerTest, emptyPage) {
   auto rowVector = vectorMaker_->rowVector(ROW({"a"}, {BIGINT()}), 0);
 
@@ -217,6 +405,21 @@ TEST_F(PrestoSerializerTest, intervalDayTime) {
   testRoundTrip(vector);
 }
 
+TEST_F(PrestoSerializerTest, biased) {
+  // More values than fit in one batch of debiased values.
+  auto vector = vectorMaker_->flatVector<int64_t>(
+      1'000,
+      [](auto row) { return 1'000'000 + row % 300; },
+      VectorMaker::nullEvery(7));
+  auto biased = makeBiasVector(*vector);
+  ASSERT_EQ(VectorEncoding::Simple::BIASED, biased->encoding());
+  testRoundTrip(biased);
+
+  vector = vectorMaker_->flatVector<int64_t>(
+      1'000, [](auto row) { return -row; });
+  testRoundTrip(makeBiasVector(*vector));
+}
+
 TEST_F(PrestoSerializerTest, unknown) {
   const vector_size_t size = 123;
   auto constantVector =
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/substrait/SubstraitPlanCache.h"
+
+#include "velox/substrait/SubstraitToVeloxPlanValidator.h"
+
+namespace facebook::velox::substrait {
+namespace {
+
+// Adds the ReadRels under 'rel' to 'reads' in the order in which
+// SubstraitVeloxPlanConverter converts them.
+void collectReadRels(
+    ::substrait::Rel& rel,
+    std::vector<::substrait::ReadRel*>& reads) {
+  if (rel.has_aggregate()) {
+    collectReadRels(*rel.mutable_aggregate()->mutable_input(), reads);
+  } else if (rel.has_project()) {
+    collectReadRels(*rel.mutable_project()->mutable_input(), reads);
+  } else if (rel.has_filter()) {
+    collectReadRels(*rel.mutable_filter()->mutable_input(), reads);
+  } else if (rel.has_join()) {
+    collectReadRels(*rel.mutable_join()->mutable_left(), reads);
+    collectReadRels(*rel.mutable_join()->mutable_right(), reads);
+  } else if (rel.has_read()) {
+    reads.push_back(rel.mutable_read());
+  }
+}
+} // namespace
+
+// static
+std::string SubstraitPlanCache::fingerprint(
+    const ::substrait::Plan& plan,
+    std::vector<std::shared_ptr<SplitInfo>>* splitInfos) {
+  auto copy = plan;
+  std::vector<::substrait::ReadRel*> reads;
+  // Only the first relation is converted.
+  for (auto& relation : *copy.mutable_relations()) {
+    if (relation.has_root()) {
+      collectReadRels(*relation.mutable_root()->mutable_input(), reads);
+      break;
+    }
+    if (relation.has_rel()) {
+      collectReadRels(*relation.mutable_rel(), reads);
+      break;
+    }
+  }
+  for (auto* read : reads) {
+    if (splitInfos && !read->has_virtual_table()) {
+      splitInfos->push_back(SubstraitVeloxPlanConverter::toSplitInfo(*read));
+    }
+    read->clear_local_files();
+  }
+  return copy.SerializeAsString();
+}
+
+core::PlanNodePtr SubstraitPlanCache::toVeloxPlan(
+    const ::substrait::Plan& plan,
+    std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>&
+        splitInfos) {
+  std::vector<std::shared_ptr<SplitInfo>> readSplitInfos;
+  auto key = fingerprint(plan, &readSplitInfos);
+  auto entry = find(key);
+  if (entry.has_value() && entry->plan) {
+    ++numHits_;
+    VELOX_CHECK_EQ(entry->scanNodeIds.size(), readSplitInfos.size());
+    splitInfos.clear();
+    for (auto i = 0; i < readSplitInfos.size(); ++i) {
+      splitInfos[entry->scanNodeIds[i]] = std::move(readSplitInfos[i]);
+    }
+    return entry->plan;
+  }
+
+  ++numMisses_;
+  SubstraitVeloxPlanConverter converter(pool_);
+  auto veloxPlan = converter.toVeloxPlan(plan);
+  splitInfos = converter.splitInfos();
+  for (const auto& [id, splitInfo] : splitInfos) {
+    if (splitInfo->isStream) {
+      return veloxPlan;
+    }
+  }
+  update(key, Entry{veloxPlan, converter.scanNodeIds(), std::nullopt});
+  return veloxPlan;
+}
+
+bool SubstraitPlanCache::validate(
+    const ::substrait::Plan& plan,
+    core::ExecCtx* execCtx) {
+  auto key = fingerprint(plan);
+  auto entry = find(key);
+  if (entry.has_value() && entry->valid.has_value()) {
+    ++numHits_;
+    return entry->valid.value();
+  }
+
+  ++numMisses_;
+  SubstraitToVeloxPlanValidator validator(pool_, execCtx);
+  const bool valid = validator.validate(plan);
+  update(key, Entry{nullptr, {}, valid});
+  return valid;
+}
+
+std::optional<SubstraitPlanCache::Entry> SubstraitPlanCache::find(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto* entry = cache_.get(key);
+  if (!entry) {
+    return std::nullopt;
+  }
+  auto copy = *entry;
+  cache_.release(key);
+  return copy;
+}
+
+void SubstraitPlanCache::update(const std::string& key, const Entry& entry) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (auto* existing = cache_.get(key)) {
+    if (entry.plan) {
+      existing->plan = entry.plan;
+      existing->scanNodeIds = entry.scanNodeIds;
+    }
+    if (entry.valid.has_value()) {
+      existing->valid = entry.valid;
+    }
+    cache_.release(key);
+    return;
+  }
+  auto newEntry = std::make_unique<Entry>(entry);
+  if (cache_.add(key, newEntry.get(), key.size())) {
+    newEntry.release();
+  }
+}
+
+} // namespace facebook::velox::substrait
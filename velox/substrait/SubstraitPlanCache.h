@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/substrait/SubstraitToVeloxPlan.h"
+
+namespace facebook::velox::substrait {
+
+/// Caches the Velox plans converted from Substrait plans that differ only in
+/// the files of their ReadRels, e.g. the plan fragments of the tasks of a
+/// stage, so that conversion and type resolution happen once per plan on a
+/// worker. The files of each plan go to its SplitInfos. The results of
+/// SubstraitToVeloxPlanValidator are cached likewise. Plans that read from
+/// input streams are not cached since these depend on the input nodes.
+///
+/// The plans are shared by the tasks and must not be modified. The
+/// ExprSets of the expressions are compiled by each operator, since these
+/// keep evaluation state. Thread-safe.
+class SubstraitPlanCache {
+ public:
+  /// 'pool' holds the vectors of the cached plans, e.g. of their Values
+  /// nodes, and must outlive 'this'. Plans are evicted in LRU order when the
+  /// size of their serialized Substrait plans exceeds 'maxBytes'.
+  SubstraitPlanCache(memory::MemoryPool* FOLLY_NONNULL pool, int64_t maxBytes)
+      : pool_(pool), cache_(maxBytes) {}
+
+  /// Returns the Velox plan for 'plan' and sets 'splitInfos' to the
+  /// SplitInfo of each TableScan.
+  core::PlanNodePtr toVeloxPlan(
+      const ::substrait::Plan& plan,
+      std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>&
+          splitInfos);
+
+  /// Returns SubstraitToVeloxPlanValidator::validate() of 'plan'.
+  bool validate(const ::substrait::Plan& plan, core::ExecCtx* execCtx);
+
+  /// Returns the key of 'plan', i.e. 'plan' serialized without the files of
+  /// its ReadRels. Sets 'splitInfos' to the SplitInfo of each ReadRel not
+  /// on a virtual table, in the order of
+  /// SubstraitVeloxPlanConverter::scanNodeIds(), if not nullptr.
+  static std::string fingerprint(
+      const ::substrait::Plan& plan,
+      std::vector<std::shared_ptr<SplitInfo>>* splitInfos = nullptr);
+
+  int64_t numHits() const {
+    return numHits_;
+  }
+
+  int64_t numMisses() const {
+    return numMisses_;
+  }
+
+ private:
+  struct Entry {
+    // nullptr if only validated.
+    core::PlanNodePtr plan;
+    std::vector<core::PlanNodeId> scanNodeIds;
+    std::optional<bool> valid;
+  };
+
+  // Returns a copy of the Entry of 'key' or std::nullopt if not found.
+  std::optional<Entry> find(const std::string& key);
+
+  // Sets the plan or the validation result that is set in 'entry' into the
+  // Entry of 'key'. Adds the Entry if not found.
+  void update(const std::string& key, const Entry& entry);
+
+  memory::MemoryPool* const FOLLY_NONNULL pool_;
+  std::mutex mutex_;
+  SimpleLRUCache<std::string, Entry> cache_;
+  std::atomic<int64_t> numHits_{0};
+  std::atomic<int64_t> numMisses_{0};
+};
+
+} // namespace facebook::velox::substrait
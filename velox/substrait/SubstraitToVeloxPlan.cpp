@@ -359,6 +359,7 @@ bool isPushDownSupportedByFormat(
           case common::FilterKind::kFloatRange:
           case common::FilterKind::kBigintMultiRange:
           case common::FilterKind::kMultiRange:
+          case common::FilterKind::kBigintBloomFilter:
           default:
             return false;
         }
@@ -415,27 +416,7 @@ std::shared_ptr<const core::PlanNode> SubstraitVeloxPlanConverter::toVeloxPlan(
   }
 
   // Parse local files and construct split info.
-  if (sRead.has_local_files()) {
-    const auto& fileList = sRead.local_files().items();
-    splitInfo->paths.reserve(fileList.size());
-    splitInfo->starts.reserve(fileList.size());
-    splitInfo->lengths.reserve(fileList.size());
-    for (const auto& file : fileList) {
-      // Expect all Partitions share the same index.
-      splitInfo->partitionIndex = file.partition_index();
-      splitInfo->paths.emplace_back(file.uri_file());
-      splitInfo->starts.emplace_back(file.start());
-      splitInfo->lengths.emplace_back(file.length());
-      auto format = file.format();
-      if (format == 2 || format == 3) {
-        splitInfo->format = dwio::common::FileFormat::DWRF;
-      } else if (format == 1) {
-        splitInfo->format = dwio::common::FileFormat::PARQUET;
-      } else {
-        splitInfo->format = dwio::common::FileFormat::UNKNOWN;
-      }
-    }
-  }
+  splitInfo = toSplitInfo(sRead);
   // Do not hard-code connector ID and allow for connectors other than Hive.
   static const std::string kHiveConnectorId = "test-hive";
 
@@ -508,10 +489,40 @@ std::shared_ptr<const core::PlanNode> SubstraitVeloxPlanConverter::toVeloxPlan(
         nextPlanNodeId(), outputType, tableHandle, assignments);
     // Set split info map.
     splitInfoMap_[tableScanNode->id()] = splitInfo;
+    scanNodeIds_.push_back(tableScanNode->id());
     return tableScanNode;
   }
 }
 
+// static
+std::shared_ptr<SplitInfo> SubstraitVeloxPlanConverter::toSplitInfo(
+    const ::substrait::ReadRel& sRead) {
+  auto splitInfo = std::make_shared<SplitInfo>();
+  if (!sRead.has_local_files()) {
+    return splitInfo;
+  }
+  const auto& fileList = sRead.local_files().items();
+  splitInfo->paths.reserve(fileList.size());
+  splitInfo->starts.reserve(fileList.size());
+  splitInfo->lengths.reserve(fileList.size());
+  for (const auto& file : fileList) {
+    // Expect all Partitions share the same index.
+    splitInfo->partitionIndex = file.partition_index();
+    splitInfo->paths.emplace_back(file.uri_file());
+    splitInfo->starts.emplace_back(file.start());
+    splitInfo->lengths.emplace_back(file.length());
+    auto format = file.format();
+    if (format == 2 || format == 3) {
+      splitInfo->format = dwio::common::FileFormat::DWRF;
+    } else if (format == 1) {
+      splitInfo->format = dwio::common::FileFormat::PARQUET;
+    } else {
+      splitInfo->format = dwio::common::FileFormat::UNKNOWN;
+    }
+  }
+  return splitInfo;
+}
+
 core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
     const ::substrait::ReadRel& readRel,
     const RowTypePtr& type) {
@@ -105,6 +105,16 @@ class SubstraitVeloxPlanConverter {
     return splitInfoMap_;
   }
 
+  /// Return the ids of the TableScan nodes in the order of their ReadRels in
+  /// a depth-first walk of the Substrait plan, left input before right.
+  const std::vector<core::PlanNodeId>& scanNodeIds() const {
+    return scanNodeIds_;
+  }
+
+  /// Used to get the files to be scanned by a ReadRel.
+  static std::shared_ptr<SplitInfo> toSplitInfo(
+      const ::substrait::ReadRel& sRead);
+
   /// Used to insert certain plan node as input. The plan node
   /// id will start from the setted one.
   void insertInputNode(
@@ -383,6 +393,9 @@ class SubstraitVeloxPlanConverter {
   std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>
       splitInfoMap_;
 
+  /// The ids of the TableScan nodes in the order they were made.
+  std::vector<core::PlanNodeId> scanNodeIds_;
+
   /// The map storing the pre-built plan nodes which can be accessed through
   /// index. This map is only used when the computation of a Substrait plan
   /// depends on other input nodes.
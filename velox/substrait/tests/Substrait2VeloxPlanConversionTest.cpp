@@ -23,6 +23,7 @@
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/substrait/SubstraitPlanCache.h"
 #include "velox/substrait/SubstraitToVeloxPlan.h"
 #include "velox/type/Type.h"
 
@@ -481,4 +482,47 @@ TEST_F(Substrait2VeloxPlanConversionTest, q1FirstStageTest) {
         rv->toString(2),
         "{R, F, 23, 94461.56, 87849.2508, 90221.880192, 23, 2, 94461.56, 2, 0.14, 2, 2}");
   }
-}
\ No newline at end of file
+}
+// Tasks of a stage get the same plan with different files. The second one
+// gets the plan converted for the first one with its own files.
+TEST_F(Substrait2VeloxPlanConversionTest, planCache) {
+  std::ifstream subJson(
+      getDataFilePath("velox/substrait/tests", "data/q6_first_stage.json"));
+  std::stringstream buffer;
+  buffer << subJson.rdbuf();
+  auto json = buffer.str();
+  ::substrait::Plan firstPlan;
+  google::protobuf::util::JsonStringToMessage(json, &firstPlan);
+  const std::string path = "/mock_lineitem.orc";
+  auto otherJson = json;
+  auto pos = otherJson.find(path);
+  ASSERT_NE(std::string::npos, pos);
+  otherJson.replace(pos, path.size(), "/other_lineitem.orc");
+  ::substrait::Plan secondPlan;
+  google::protobuf::util::JsonStringToMessage(otherJson, &secondPlan);
+
+  auto pool = memory::getDefaultScopedMemoryPool();
+  vestrait::SubstraitPlanCache cache(pool.get(), 1 << 20);
+  EXPECT_EQ(
+      vestrait::SubstraitPlanCache::fingerprint(firstPlan),
+      vestrait::SubstraitPlanCache::fingerprint(secondPlan));
+
+  std::unordered_map<core::PlanNodeId, std::shared_ptr<vestrait::SplitInfo>>
+      splitInfos;
+  auto first = cache.toVeloxPlan(firstPlan, splitInfos);
+  auto scanNodeId = *first->leafPlanNodeIds().begin();
+  ASSERT_EQ(1, splitInfos.size());
+  EXPECT_EQ(
+      std::vector<std::string>{"/mock_lineitem.orc"},
+      splitInfos.at(scanNodeId)->paths);
+
+  auto second = cache.toVeloxPlan(secondPlan, splitInfos);
+  EXPECT_EQ(first.get(), second.get());
+  ASSERT_EQ(1, splitInfos.size());
+  EXPECT_EQ(
+      std::vector<std::string>{"/other_lineitem.orc"},
+      splitInfos.at(scanNodeId)->paths);
+  EXPECT_EQ(3719, splitInfos.at(scanNodeId)->lengths[0]);
+  EXPECT_EQ(1, cache.numHits());
+  EXPECT_EQ(1, cache.numMisses());
+}
@@ -0,0 +1,969 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/tpcds/gen/TpcdsGen.h"
+
+#include <array>
+
+#include "velox/external/date/date.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::tpcds {
+
+namespace {
+
+// d_date_sk and day since epoch of the first row of date_dim, 1900-01-02.
+constexpr int64_t kFirstDateSk = 2'415'022;
+constexpr int32_t kFirstDate = -25'566;
+constexpr size_t kNumDates = 73'049;
+
+// The store sales are in the five years from 1998-01-02 to 2003-01-01.
+constexpr int64_t kFirstSaleDateSk = 2'450'816;
+constexpr int64_t kNumSaleDates = 1'826;
+
+constexpr int64_t kLinesPerTicket = 10;
+
+constexpr size_t kNumDemographics = 1'920'800;
+
+constexpr std::array<std::string_view, 10> kCategories = {
+    "Women",
+    "Men",
+    "Children",
+    "Shoes",
+    "Music",
+    "Jewelry",
+    "Home",
+    "Sports",
+    "Books",
+    "Electronics",
+};
+
+// Four classes of each category.
+constexpr std::array<std::array<std::string_view, 4>, 10> kClasses = {{
+    {"dresses", "swimwear", "maternity", "fragrances"},
+    {"shirts", "pants", "accessories", "sports-apparel"},
+    {"infants", "toddlers", "newborn", "school-uniforms"},
+    {"athletic", "mens", "womens", "kids"},
+    {"rock", "pop", "classical", "country"},
+    {"rings", "bracelets", "estate", "diamonds"},
+    {"furniture", "lighting", "kids", "bedding"},
+    {"baseball", "golf", "tennis", "fishing"},
+    {"fiction", "history", "science", "travel"},
+    {"televisions", "cameras", "audio", "monitors"},
+}};
+
+// The syllables dsdgen composes store and promotion names from.
+constexpr std::array<std::string_view, 10> kSyllables = {
+    "bar",
+    "ought",
+    "able",
+    "pri",
+    "ese",
+    "anti",
+    "cally",
+    "ation",
+    "eing",
+    "n st",
+};
+
+struct State {
+  std::string_view name;
+  double gmtOffset;
+};
+
+constexpr std::array<State, 10> kStates = {{
+    {"AL", -6},
+    {"CA", -8},
+    {"GA", -5},
+    {"IL", -6},
+    {"NY", -5},
+    {"OH", -5},
+    {"SD", -6},
+    {"TN", -6},
+    {"TX", -6},
+    {"WA", -8},
+}};
+
+constexpr std::array<std::string_view, 10> kCities = {
+    "Midway",
+    "Fairview",
+    "Oak Grove",
+    "Five Points",
+    "Pleasant Hill",
+    "Riverside",
+    "Centerville",
+    "Greenwood",
+    "Union",
+    "Mount Zion",
+};
+
+constexpr std::array<std::string_view, 10> kFirstNames = {
+    "James",
+    "Mary",
+    "John",
+    "Patricia",
+    "Robert",
+    "Linda",
+    "Michael",
+    "Barbara",
+    "William",
+    "Elizabeth",
+};
+
+constexpr std::array<std::string_view, 10> kLastNames = {
+    "Smith",
+    "Johnson",
+    "Williams",
+    "Brown",
+    "Jones",
+    "Miller",
+    "Davis",
+    "Garcia",
+    "Wilson",
+    "Moore",
+};
+
+constexpr std::array<std::string_view, 7> kDayNames = {
+    "Sunday",
+    "Monday",
+    "Tuesday",
+    "Wednesday",
+    "Thursday",
+    "Friday",
+    "Saturday",
+};
+
+constexpr std::array<std::string_view, 2> kGenders = {"M", "F"};
+constexpr std::array<std::string_view, 5> kMaritalStatuses = {
+    "M",
+    "S",
+    "D",
+    "W",
+    "U",
+};
+constexpr std::array<std::string_view, 7> kEducationStatuses = {
+    "Primary",
+    "Secondary",
+    "College",
+    "2 yr Degree",
+    "4 yr Degree",
+    "Advanced Degree",
+    "Unknown",
+};
+constexpr std::array<std::string_view, 4> kCreditRatings = {
+    "Good",
+    "High Risk",
+    "Low Risk",
+    "Unknown",
+};
+
+// Returns the row count of a table that has 'counts' rows at the official
+// scale factors 1, 10, 100 and 1000. Other scale factors get the count at SF1
+// times the scale factor if the table grows linearly, and the count of the
+// closest official scale factor below otherwise.
+size_t officialRowCount(
+    size_t scaleFactor,
+    const std::array<size_t, 4>& counts,
+    bool linear) {
+  size_t index = 0;
+  for (size_t official = 10; index < 3 && official <= scaleFactor;
+       official *= 10) {
+    ++index;
+  }
+  size_t official = 1;
+  for (auto i = 0; i < index; ++i) {
+    official *= 10;
+  }
+  if (official == scaleFactor || !linear) {
+    return counts[index];
+  }
+  return counts[0] * scaleFactor;
+}
+
+// Returns a pseudo random number that depends only on 'table', 'column' and
+// 'key', so that any row can be generated without generating the ones before
+// it. The mix is the finalizer of splitmix64.
+uint64_t random(Table table, int32_t column, uint64_t key) {
+  uint64_t x = key * 0x9e3779b97f4a7c15ULL +
+      ((static_cast<uint64_t>(table) << 8) + column + 1) *
+          0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// Returns a number in [min, max].
+int64_t
+uniform(Table table, int32_t column, uint64_t key, int64_t min, int64_t max) {
+  return min + random(table, column, key) % (max - min + 1);
+}
+
+template <typename T, size_t N>
+const T& pick(
+    const std::array<T, N>& values,
+    Table table,
+    int32_t column,
+    uint64_t key) {
+  return values[random(table, column, key) % N];
+}
+
+double centsToDouble(int64_t cents) {
+  return (double)cents * 0.01;
+}
+
+// Returns the 16 letter business key of the surrogate key 'key', e.g.
+// AAAAAAAABAAAAAAA for 1.
+std::string makeId(int64_t key) {
+  std::string id(16, 'A');
+  for (auto i = 8; i < 16 && key > 0; ++i, key >>= 4) {
+    id[i] = 'A' + (key & 15);
+  }
+  return id;
+}
+
+// Returns the name dsdgen style of 'key', one syllable per decimal digit.
+std::string makeName(int64_t key) {
+  std::string digits = std::to_string(key);
+  std::string name;
+  for (auto digit : digits) {
+    name.append(kSyllables[digit - '0']);
+  }
+  return name;
+}
+
+std::string makeZip(Table table, int32_t column, uint64_t key) {
+  return std::to_string(uniform(table, column, key, 10'000, 99'999));
+}
+
+size_t getVectorSize(size_t rowCount, size_t maxRows, size_t offset) {
+  if (offset >= rowCount) {
+    return 0;
+  }
+  return std::min(rowCount - offset, maxRows);
+}
+
+std::vector<VectorPtr> allocateVectors(
+    const RowTypePtr& type,
+    size_t vectorSize,
+    memory::MemoryPool* pool) {
+  std::vector<VectorPtr> vectors;
+  vectors.reserve(type->size());
+
+  for (const auto& childType : type->children()) {
+    vectors.emplace_back(BaseVector::create(childType, vectorSize, pool));
+  }
+  return vectors;
+}
+
+RowVectorPtr genDateDim(
+    size_t maxRows,
+    size_t offset,
+    size_t scaleFactor,
+    memory::MemoryPool* pool) {
+  auto rowType = getTableSchema(Table::TBL_DATE_DIM);
+  size_t vectorSize = getVectorSize(
+      getRowCount(Table::TBL_DATE_DIM, scaleFactor), maxRows, offset);
+  auto children = allocateVectors(rowType, vectorSize, pool);
+
+  auto dateSkVector = children[0]->asFlatVector<int64_t>();
+  auto dateIdVector = children[1]->asFlatVector<StringView>();
+  auto dateVector = children[2]->asFlatVector<Date>();
+  auto monthSeqVector = children[3]->asFlatVector<int64_t>();
+  auto weekSeqVector = children[4]->asFlatVector<int64_t>();
+  auto quarterSeqVector = children[5]->asFlatVector<int64_t>();
+  auto yearVector = children[6]->asFlatVector<int64_t>();
+  auto dowVector = children[7]->asFlatVector<int64_t>();
+  auto moyVector = children[8]->asFlatVector<int64_t>();
+  auto domVector = children[9]->asFlatVector<int64_t>();
+  auto qoyVector = children[10]->asFlatVector<int64_t>();
+  auto dayNameVector = children[11]->asFlatVector<StringView>();
+
+  for (size_t i = 0; i < vectorSize; ++i) {
+    const int64_t row = offset + i;
+    const int32_t days = kFirstDate + row;
+    const ::date::sys_days sysDays{::date::days(days)};
+    const ::date::year_month_day ymd{sysDays};
+    const int64_t year = static_cast<int32_t>(ymd.year());
+    const int64_t month = static_cast<unsigned>(ymd.month());
+    const auto dow = ::date::weekday(sysDays).c_encoding();
+
+    dateSkVector->set(i, kFirstDateSk + row);
+    dateIdVector->set(i, StringView(makeId(kFirstDateSk + row)));
+    dateVector->set(i, Date(days));
+    monthSeqVector->set(i, (year - 1900) * 12 + month - 1);
+    // Weeks start on Sunday and 1900-01-02 is a Tuesday of week 1.
+    weekSeqVector->set(i, (row + 2) / 7 + 1);
+    quarterSeqVector->set(i, (year - 1900) * 4 + (month - 1) / 3 + 1);
+    yearVector->set(i, year);
+    dowVector->set(i, dow);
+    moyVector->set(i, month);
+    domVector->set(i, static_cast<unsigned>(ymd.day()));
+    qoyVector->set(i, (month - 1) / 3 + 1);
+    dayNameVector->set(i, StringView(kDayNames[dow]));
+  }
+  return std::make_shared<RowVector>(
+      pool, rowType, BufferPtr(nullptr), vectorSize, std::move(children));
+}
+
+RowVectorPtr genItem(
+    size_t maxRows,
+    size_t offset,
+    size_t scaleFactor,
+    memory::MemoryPool* pool) {
+  constexpr auto kTable = Table::TBL_ITEM;
+  auto rowType = getTableSchema(kTable);
+  size_t vectorSize =
+      getVectorSize(getRowCount(kTable, scaleFactor), maxRows, offset);
+  auto children = allocateVectors(rowType, vectorSize, pool);
+
+  auto itemSkVector = children[0]->asFlatVector<int64_t>();
+  auto itemIdVector = children[1]->asFlatVector<StringView>();
+  auto itemDescVector = children[2]->asFlatVector<StringView>();
+  auto currentPriceVector = children[3]->asFlatVector<double>();
+  auto brandIdVector = children[4]->asFlatVector<int64_t>();
+  auto brandVector = children[5]->asFlatVector<StringView>();
+  auto classIdVector = children[6]->asFlatVector<int64_t>();
+  auto classVector = children[7]->asFlatVector<StringView>();
+  auto categoryIdVector = children[8]->asFlatVector<int64_t>();
+  auto categoryVector = children[9]->asFlatVector<StringView>();
+  auto manufactIdVector = children[10]->asFlatVector<int64_t>();
+  auto manufactVector = children[11]->asFlatVector<StringView>();
+  auto managerIdVector = children[12]->asFlatVector<int64_t>();
+
+  for (size_t i = 0; i < vectorSize; ++i) {
+    const int64_t key = offset + i + 1;
+    const auto category = uniform(kTable, 0, key, 0, kCategories.size() - 1);
+    const auto itemClass = uniform(kTable, 1, key, 0, 3);
+    const auto brandId = (category + 1) * 1'000'000 + (itemClass + 1) * 1'000 +
+        uniform(kTable, 2, key, 1, 10);
+    const auto manufactId = uniform(kTable, 3, key, 1, 1'000);
+
+    itemSkVector->set(i, key);
+    itemIdVector->set(i, StringView(makeId(key)));
+    itemDescVector->set(
+        i,
+        StringView(fmt::format(
+            "{} {} item {}",
+            kCategories[category],
+            kClasses[category][itemClass],
+            key)));
+    currentPriceVector->set(
+        i, centsToDouble(uniform(kTable, 4, key, 100, 10'000)));
+    brandIdVector->set(i, brandId);
+    brandVector->set(i, StringView(fmt::format("brand #{}", brandId)));
+    classIdVector->set(i, itemClass + 1);
+    classVector->set(i, StringView(kClasses[category][itemClass]));
+    categoryIdVector->set(i, category + 1);
+    categoryVector->set(i, StringView(kCategories[category]));
+    manufactIdVector->set(i, manufactId);
+    manufactVector->set(
+        i, StringView(fmt::format("manufact #{}", manufactId)));
+    managerIdVector->set(i, uniform(kTable, 5, key, 1, 100));
+  }
+  return std::make_shared<RowVector>(
+      pool, rowType, BufferPtr(nullptr), vectorSize, std::move(children));
+}
+
+RowVectorPtr genStore(
+    size_t maxRows,
+    size_t offset,
+    size_t scaleFactor,
+    memory::MemoryPool* pool) {
+  constexpr auto kTable = Table::TBL_STORE;
+  auto rowType = getTableSchema(kTable);
+  size_t vectorSize =
+      getVectorSize(getRowCount(kTable, scaleFactor), maxRows, offset);
+  auto children = allocateVectors(rowType, vectorSize, pool);
+
+  auto storeSkVector = children[0]->asFlatVector<int64_t>();
+  auto storeIdVector = children[1]->asFlatVector<StringView>();
+  auto storeNameVector = children[2]->asFlatVector<StringView>();
+  auto stateVector = children[3]->asFlatVector<StringView>();
+  auto zipVector = children[4]->asFlatVector<StringView>();
+  auto gmtOffsetVector = children[5]->asFlatVector<double>();
+
+  for (size_t i = 0; i < vectorSize; ++i) {
+    const int64_t key = offset + i + 1;
+    const auto& state = pick(kStates, kTable, 0, key);
+
+    storeSkVector->set(i, key);
+    storeIdVector->set(i, StringView(makeId(key)));
+    storeNameVector->set(i, StringView(makeName(key)));
+    stateVector->set(i, StringView(state.name));
+    zipVector->set(i, StringView(makeZip(kTable, 1, key)));
+    gmtOffsetVector->set(i, state.gmtOffset);
+  }
+  return std::make_shared<RowVector>(
+      pool, rowType, BufferPtr(nullptr), vectorSize, std::move(children));
+}
+
+RowVectorPtr genCustomer(
+    size_t maxRows,
+    size_t offset,
+    size_t scaleFactor,
+    memory::MemoryPool* pool) {
+  constexpr auto kTable = Table::TBL_CUSTOMER;
+  auto rowType = getTableSchema(kTable);
+  size_t vectorSize =
+      getVectorSize(getRowCount(kTable, scaleFactor), maxRows, offset);
+  auto children = allocateVectors(rowType, vectorSize, pool);
+  const int64_t numAddresses =
+      getRowCount(Table::TBL_CUSTOMER_ADDRESS, scaleFactor);
+
+  auto customerSkVector = children[0]->asFlatVector<int64_t>();
+  auto customerIdVector = children[1]->asFlatVector<StringView>();
+  auto cdemoSkVector = children[2]->asFlatVector<int64_t>();
+  auto addrSkVector = children[3]->asFlatVector<int64_t>();
+  auto firstNameVector = children[4]->asFlatVector<StringView>();
+  auto lastNameVector = children[5]->asFlatVector<StringView>();
+  auto birthYearVector = children[6]->asFlatVector<int64_t>();
+
+  for (size_t i = 0; i < vectorSize; ++i) {
+    const int64_t key = offset + i + 1;
+
+    customerSkVector->set(i, key);
+    customerIdVector->set(i, StringView(makeId(key)));
+    cdemoSkVector->set(i, uniform(kTable, 0, key, 1, kNumDemographics));
+    addrSkVector->set(i, uniform(kTable, 1, key, 1, numAddresses));
+    firstNameVector->set(i, StringView(pick(kFirstNames, kTable, 2, key)));
+    lastNameVector->set(i, StringView(pick(kLastNames, kTable, 3, key)));
+    birthYearVector->set(i, uniform(kTable, 4, key, 1924, 1992));
+  }
+  return std::make_shared<RowVector>(
+      pool, rowType, BufferPtr(nullptr), vectorSize, std::move(children));
+}
+
+RowVectorPtr genCustomerAddress(
+    size_t maxRows,
+    size_t offset,
+    size_t scaleFactor,
+    memory::MemoryPool* pool) {
+  constexpr auto kTable = Table::TBL_CUSTOMER_ADDRESS;
+  auto rowType = getTableSchema(kTable);
+  size_t vectorSize =
+      getVectorSize(getRowCount(kTable, scaleFactor), maxRows, offset);
+  auto children = allocateVectors(rowType, vectorSize, pool);
+
+  auto addressSkVector = children[0]->asFlatVector<int64_t>();
+  auto addressIdVector = children[1]->asFlatVector<StringView>();
+  auto cityVector = children[2]->asFlatVector<StringView>();
+  auto stateVector = children[3]->asFlatVector<StringView>();
+  auto zipVector = children[4]->asFlatVector<StringView>();
+  auto gmtOffsetVector = children[5]->asFlatVector<double>();
+
+  for (size_t i = 0; i < vectorSize; ++i) {
+    const int64_t key = offset + i + 1;
+    const auto& state = pick(kStates, kTable, 0, key);
+
+    addressSkVector->set(i, key);
+    addressIdVector->set(i, StringView(makeId(key)));
+    cityVector->set(i, StringView(pick(kCities, kTable, 1, key)));
+    stateVector->set(i, StringView(state.name));
+    zipVector->set(i, StringView(makeZip(kTable, 2, key)));
+    gmtOffsetVector->set(i, state.gmtOffset);
+  }
+  return std::make_shared<RowVector>(
+      pool, rowType, BufferPtr(nullptr), vectorSize, std::move(children));
+}
+
+RowVectorPtr genCustomerDemographics(
+    size_t maxRows,
+    size_t offset,
+    size_t scaleFactor,
+    memory::MemoryPool* pool) {
+  auto rowType = getTableSchema(Table::TBL_CUSTOMER_DEMOGRAPHICS);
+  size_t vectorSize = getVectorSize(
+      getRowCount(Table::TBL_CUSTOMER_DEMOGRAPHICS, scaleFactor),
+      maxRows,
+      offset);
+  auto children = allocateVectors(rowType, vectorSize, pool);
+
+  auto demoSkVector = children[0]->asFlatVector<int64_t>();
+  auto genderVector = children[1]->asFlatVector<StringView>();
+  auto maritalStatusVector = children[2]->asFlatVector<StringView>();
+  auto educationStatusVector = children[3]->asFlatVector<StringView>();
+  auto purchaseEstimateVector = children[4]->asFlatVector<int64_t>();
+  auto creditRatingVector = children[5]->asFlatVector<StringView>();
+  auto depCountVector = children[6]->asFlatVector<int64_t>();
+  auto depEmployedCountVector = children[7]->asFlatVector<int64_t>();
+  auto depCollegeCountVector = children[8]->asFlatVector<int64_t>();
+
+  // The table is the cross product of the domains of its attributes, the
+  // first one varying fastest.
+  for (size_t i = 0; i < vectorSize; ++i) {
+    size_t row = offset + i;
+    demoSkVector->set(i, row + 1);
+    genderVector->set(i, StringView(kGenders[row % kGenders.size()]));
+    row /= kGenders.size();
+    maritalStatusVector->set(
+        i, StringView(kMaritalStatuses[row % kMaritalStatuses.size()]));
+    row /= kMaritalStatuses.size();
+    educationStatusVector->set(
+        i, StringView(kEducationStatuses[row % kEducationStatuses.size()]));
+    row /= kEducationStatuses.size();
+    purchaseEstimateVector->set(i, (row % 20 + 1) * 500);
+    row /= 20;
+    creditRatingVector->set(
+        i, StringView(kCreditRatings[row % kCreditRatings.size()]));
+    row /= kCreditRatings.size();
+    depCountVector->set(i, row % 7);
+    row /= 7;
+    depEmployedCountVector->set(i, row % 7);
+    row /= 7;
+    depCollegeCountVector->set(i, row % 7);
+  }
+  return std::make_shared<RowVector>(
+      pool, rowType, BufferPtr(nullptr), vectorSize, std::move(children));
+}
+
+RowVectorPtr genPromotion(
+    size_t maxRows,
+    size_t offset,
+    size_t scaleFactor,
+    memory::MemoryPool* pool) {
+  constexpr auto kTable = Table::TBL_PROMOTION;
+  auto rowType = getTableSchema(kTable);
+  size_t vectorSize =
+      getVectorSize(getRowCount(kTable, scaleFactor), maxRows, offset);
+  auto children = allocateVectors(rowType, vectorSize, pool);
+
+  auto promoSkVector = children[0]->asFlatVector<int64_t>();
+  auto promoIdVector = children[1]->asFlatVector<StringView>();
+  auto promoNameVector = children[2]->asFlatVector<StringView>();
+  std::vector<FlatVector<StringView>*> channelVectors = {
+      children[3]->asFlatVector<StringView>(),
+      children[4]->asFlatVector<StringView>(),
+      children[5]->asFlatVector<StringView>(),
+  };
+
+  for (size_t i = 0; i < vectorSize; ++i) {
+    const int64_t key = offset + i + 1;
+
+    promoSkVector->set(i, key);
+    promoIdVector->set(i, StringView(makeId(key)));
+    promoNameVector->set(i, StringView(makeName(key)));
+    for (auto channel = 0; channel < channelVectors.size(); ++channel) {
+      channelVectors[channel]->set(
+          i, StringView(uniform(kTable, channel, key, 0, 1) ? "Y" : "N"));
+    }
+  }
+  return std::make_shared<RowVector>(
+      pool, rowType, BufferPtr(nullptr), vectorSize, std::move(children));
+}
+
+RowVectorPtr genStoreSales(
+    size_t maxRows,
+    size_t offset,
+    size_t scaleFactor,
+    memory::MemoryPool* pool) {
+  constexpr auto kTable = Table::TBL_STORE_SALES;
+  auto rowType = getTableSchema(kTable);
+  size_t vectorSize =
+      getVectorSize(getRowCount(kTable, scaleFactor), maxRows, offset);
+  auto children = allocateVectors(rowType, vectorSize, pool);
+  const int64_t numItems = getRowCount(Table::TBL_ITEM, scaleFactor);
+  const int64_t numCustomers = getRowCount(Table::TBL_CUSTOMER, scaleFactor);
+  const int64_t numAddresses =
+      getRowCount(Table::TBL_CUSTOMER_ADDRESS, scaleFactor);
+  const int64_t numStores = getRowCount(Table::TBL_STORE, scaleFactor);
+  const int64_t numPromotions = getRowCount(Table::TBL_PROMOTION, scaleFactor);
+
+  auto soldDateSkVector = children[0]->asFlatVector<int64_t>();
+  auto itemSkVector = children[1]->asFlatVector<int64_t>();
+  auto customerSkVector = children[2]->asFlatVector<int64_t>();
+  auto cdemoSkVector = children[3]->asFlatVector<int64_t>();
+  auto addrSkVector = children[4]->asFlatVector<int64_t>();
+  auto storeSkVector = children[5]->asFlatVector<int64_t>();
+  auto promoSkVector = children[6]->asFlatVector<int64_t>();
+  auto ticketNumberVector = children[7]->asFlatVector<int64_t>();
+  auto quantityVector = children[8]->asFlatVector<int64_t>();
+  auto wholesaleCostVector = children[9]->asFlatVector<double>();
+  auto listPriceVector = children[10]->asFlatVector<double>();
+  auto salesPriceVector = children[11]->asFlatVector<double>();
+  auto extSalesPriceVector = children[12]->asFlatVector<double>();
+  auto couponAmtVector = children[13]->asFlatVector<double>();
+  auto netProfitVector = children[14]->asFlatVector<double>();
+
+  for (size_t i = 0; i < vectorSize; ++i) {
+    const int64_t row = offset + i;
+    // The columns of a ticket are drawn from the ticket number and the ones
+    // of a line from the row number.
+    const int64_t ticket = row / kLinesPerTicket + 1;
+    const auto quantity = uniform(kTable, 10, row, 1, 100);
+    const auto wholesaleCost = uniform(kTable, 11, row, 100, 10'000);
+    const auto listPrice =
+        wholesaleCost * (100 + uniform(kTable, 12, row, 0, 100)) / 100;
+    const auto salesPrice =
+        listPrice * (100 - uniform(kTable, 13, row, 0, 100)) / 100;
+    const auto extSalesPrice = salesPrice * quantity;
+    // One line in five has a coupon.
+    const auto couponAmt = uniform(kTable, 14, row, 0, 4) == 0
+        ? extSalesPrice * uniform(kTable, 15, row, 0, 100) / 100
+        : 0;
+
+    soldDateSkVector->set(
+        i,
+        kFirstSaleDateSk + uniform(kTable, 0, ticket, 0, kNumSaleDates - 1));
+    itemSkVector->set(i, uniform(kTable, 16, row, 1, numItems));
+    customerSkVector->set(i, uniform(kTable, 1, ticket, 1, numCustomers));
+    cdemoSkVector->set(i, uniform(kTable, 2, ticket, 1, kNumDemographics));
+    addrSkVector->set(i, uniform(kTable, 3, ticket, 1, numAddresses));
+    storeSkVector->set(i, uniform(kTable, 4, ticket, 1, numStores));
+    promoSkVector->set(i, uniform(kTable, 5, ticket, 1, numPromotions));
+    ticketNumberVector->set(i, ticket);
+    quantityVector->set(i, quantity);
+    wholesaleCostVector->set(i, centsToDouble(wholesaleCost));
+    listPriceVector->set(i, centsToDouble(listPrice));
+    salesPriceVector->set(i, centsToDouble(salesPrice));
+    extSalesPriceVector->set(i, centsToDouble(extSalesPrice));
+    couponAmtVector->set(i, centsToDouble(couponAmt));
+    netProfitVector->set(
+        i,
+        centsToDouble(extSalesPrice - couponAmt - wholesaleCost * quantity));
+  }
+  return std::make_shared<RowVector>(
+      pool, rowType, BufferPtr(nullptr), vectorSize, std::move(children));
+}
+
+} // namespace
+
+std::string_view toTableName(Table table) {
+  switch (table) {
+    case Table::TBL_DATE_DIM:
+      return "date_dim";
+    case Table::TBL_ITEM:
+      return "item";
+    case Table::TBL_STORE:
+      return "store";
+    case Table::TBL_CUSTOMER:
+      return "customer";
+    case Table::TBL_CUSTOMER_ADDRESS:
+      return "customer_address";
+    case Table::TBL_CUSTOMER_DEMOGRAPHICS:
+      return "customer_demographics";
+    case Table::TBL_PROMOTION:
+      return "promotion";
+    case Table::TBL_STORE_SALES:
+      return "store_sales";
+  }
+  return ""; // make gcc happy.
+}
+
+Table fromTableName(std::string_view tableName) {
+  static std::unordered_map<std::string_view, Table> map{
+      {"date_dim", Table::TBL_DATE_DIM},
+      {"item", Table::TBL_ITEM},
+      {"store", Table::TBL_STORE},
+      {"customer", Table::TBL_CUSTOMER},
+      {"customer_address", Table::TBL_CUSTOMER_ADDRESS},
+      {"customer_demographics", Table::TBL_CUSTOMER_DEMOGRAPHICS},
+      {"promotion", Table::TBL_PROMOTION},
+      {"store_sales", Table::TBL_STORE_SALES},
+  };
+
+  auto it = map.find(tableName);
+  if (it != map.end()) {
+    return it->second;
+  }
+  throw std::invalid_argument(
+      fmt::format("Invalid TPC-DS table name: '{}'", tableName));
+}
+
+size_t getRowCount(Table table, size_t scaleFactor) {
+  switch (table) {
+    case Table::TBL_DATE_DIM:
+      return kNumDates;
+    case Table::TBL_ITEM:
+      return officialRowCount(
+          scaleFactor, {18'000, 102'000, 204'000, 300'000}, false);
+    case Table::TBL_STORE:
+      return officialRowCount(scaleFactor, {12, 102, 402, 1'002}, false);
+    case Table::TBL_CUSTOMER:
+      return officialRowCount(
+          scaleFactor, {100'000, 500'000, 2'000'000, 12'000'000}, false);
+    case Table::TBL_CUSTOMER_ADDRESS:
+      return officialRowCount(
+          scaleFactor, {50'000, 250'000, 1'000'000, 6'000'000}, false);
+    case Table::TBL_CUSTOMER_DEMOGRAPHICS:
+      return kNumDemographics;
+    case Table::TBL_PROMOTION:
+      return officialRowCount(scaleFactor, {300, 500, 1'000, 1'500}, false);
+    case Table::TBL_STORE_SALES:
+      return officialRowCount(
+          scaleFactor,
+          {2'880'404, 28'800'991, 287'997'024, 2'879'987'999},
+          true);
+  }
+  return 0; // make gcc happy.
+}
+
+RowTypePtr getTableSchema(Table table) {
+  switch (table) {
+    case Table::TBL_DATE_DIM: {
+      static RowTypePtr type = ROW(
+          {
+              "d_date_sk",
+              "d_date_id",
+              "d_date",
+              "d_month_seq",
+              "d_week_seq",
+              "d_quarter_seq",
+              "d_year",
+              "d_dow",
+              "d_moy",
+              "d_dom",
+              "d_qoy",
+              "d_day_name",
+          },
+          {
+              BIGINT(),
+              VARCHAR(),
+              DATE(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              VARCHAR(),
+          });
+      return type;
+    }
+
+    case Table::TBL_ITEM: {
+      static RowTypePtr type = ROW(
+          {
+              "i_item_sk",
+              "i_item_id",
+              "i_item_desc",
+              "i_current_price",
+              "i_brand_id",
+              "i_brand",
+              "i_class_id",
+              "i_class",
+              "i_category_id",
+              "i_category",
+              "i_manufact_id",
+              "i_manufact",
+              "i_manager_id",
+          },
+          {
+              BIGINT(),
+              VARCHAR(),
+              VARCHAR(),
+              DOUBLE(),
+              BIGINT(),
+              VARCHAR(),
+              BIGINT(),
+              VARCHAR(),
+              BIGINT(),
+              VARCHAR(),
+              BIGINT(),
+              VARCHAR(),
+              BIGINT(),
+          });
+      return type;
+    }
+
+    case Table::TBL_STORE: {
+      static RowTypePtr type = ROW(
+          {
+              "s_store_sk",
+              "s_store_id",
+              "s_store_name",
+              "s_state",
+              "s_zip",
+              "s_gmt_offset",
+          },
+          {
+              BIGINT(),
+              VARCHAR(),
+              VARCHAR(),
+              VARCHAR(),
+              VARCHAR(),
+              DOUBLE(),
+          });
+      return type;
+    }
+
+    case Table::TBL_CUSTOMER: {
+      static RowTypePtr type = ROW(
+          {
+              "c_customer_sk",
+              "c_customer_id",
+              "c_current_cdemo_sk",
+              "c_current_addr_sk",
+              "c_first_name",
+              "c_last_name",
+              "c_birth_year",
+          },
+          {
+              BIGINT(),
+              VARCHAR(),
+              BIGINT(),
+              BIGINT(),
+              VARCHAR(),
+              VARCHAR(),
+              BIGINT(),
+          });
+      return type;
+    }
+
+    case Table::TBL_CUSTOMER_ADDRESS: {
+      static RowTypePtr type = ROW(
+          {
+              "ca_address_sk",
+              "ca_address_id",
+              "ca_city",
+              "ca_state",
+              "ca_zip",
+              "ca_gmt_offset",
+          },
+          {
+              BIGINT(),
+              VARCHAR(),
+              VARCHAR(),
+              VARCHAR(),
+              VARCHAR(),
+              DOUBLE(),
+          });
+      return type;
+    }
+
+    case Table::TBL_CUSTOMER_DEMOGRAPHICS: {
+      static RowTypePtr type = ROW(
+          {
+              "cd_demo_sk",
+              "cd_gender",
+              "cd_marital_status",
+              "cd_education_status",
+              "cd_purchase_estimate",
+              "cd_credit_rating",
+              "cd_dep_count",
+              "cd_dep_employed_count",
+              "cd_dep_college_count",
+          },
+          {
+              BIGINT(),
+              VARCHAR(),
+              VARCHAR(),
+              VARCHAR(),
+              BIGINT(),
+              VARCHAR(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+          });
+      return type;
+    }
+
+    case Table::TBL_PROMOTION: {
+      static RowTypePtr type = ROW(
+          {
+              "p_promo_sk",
+              "p_promo_id",
+              "p_promo_name",
+              "p_channel_email",
+              "p_channel_event",
+              "p_channel_tv",
+          },
+          {
+              BIGINT(),
+              VARCHAR(),
+              VARCHAR(),
+              VARCHAR(),
+              VARCHAR(),
+              VARCHAR(),
+          });
+      return type;
+    }
+
+    case Table::TBL_STORE_SALES: {
+      static RowTypePtr type = ROW(
+          {
+              "ss_sold_date_sk",
+              "ss_item_sk",
+              "ss_customer_sk",
+              "ss_cdemo_sk",
+              "ss_addr_sk",
+              "ss_store_sk",
+              "ss_promo_sk",
+              "ss_ticket_number",
+              "ss_quantity",
+              "ss_wholesale_cost",
+              "ss_list_price",
+              "ss_sales_price",
+              "ss_ext_sales_price",
+              "ss_coupon_amt",
+              "ss_net_profit",
+          },
+          {
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              BIGINT(),
+              DOUBLE(),
+              DOUBLE(),
+              DOUBLE(),
+              DOUBLE(),
+              DOUBLE(),
+              DOUBLE(),
+          });
+      return type;
+    }
+  }
+  return nullptr; // make gcc happy.
+}
+
+TypePtr resolveTpcdsColumn(Table table, const std::string& columnName) {
+  return getTableSchema(table)->findChild(columnName);
+}
+
+RowVectorPtr genTpcdsData(
+    Table table,
+    size_t maxRows,
+    size_t offset,
+    size_t scaleFactor,
+    memory::MemoryPool* pool) {
+  switch (table) {
+    case Table::TBL_DATE_DIM:
+      return genDateDim(maxRows, offset, scaleFactor, pool);
+    case Table::TBL_ITEM:
+      return genItem(maxRows, offset, scaleFactor, pool);
+    case Table::TBL_STORE:
+      return genStore(maxRows, offset, scaleFactor, pool);
+    case Table::TBL_CUSTOMER:
+      return genCustomer(maxRows, offset, scaleFactor, pool);
+    case Table::TBL_CUSTOMER_ADDRESS:
+      return genCustomerAddress(maxRows, offset, scaleFactor, pool);
+    case Table::TBL_CUSTOMER_DEMOGRAPHICS:
+      return genCustomerDemographics(maxRows, offset, scaleFactor, pool);
+    case Table::TBL_PROMOTION:
+      return genPromotion(maxRows, offset, scaleFactor, pool);
+    case Table::TBL_STORE_SALES:
+      return genStoreSales(maxRows, offset, scaleFactor, pool);
+  }
+  return nullptr; // make gcc happy.
+}
+
+} // namespace facebook::velox::tpcds
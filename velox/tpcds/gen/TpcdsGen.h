@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/memory/Memory.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::tpcds {
+
+/// This file generates data for the store sales star schema of TPC-DS encoded
+/// using Velox Vectors. The API mirrors the one of velox/tpch/gen: the input is
+/// the table (the Table enum), the scale factor, the maximum batch size, and
+/// the offset. Every row is a function of its row number only, so that
+/// different slices of the range "[0, getRowCount(Table, scaleFactor)[" can be
+/// generated by different threads in order to generate datasets in parallel.
+///
+/// The schemas are the TPC-DS schemas restricted to the columns used by the
+/// store sales queries. Identifiers and integers are BIGINT and decimals are
+/// DOUBLE. Table sizes follow the spec for the official scale factors (1, 10,
+/// 100, 1000) and approximated otherwise. The values are drawn from the
+/// TPC-DS domains, e.g. the categories and classes of items or the attributes
+/// of customer demographics, but from uniform distributions and not from the
+/// dsdgen ones, so query results differ from those over dsdgen data.
+///
+/// If not enough records are available given a particular scale factor and
+/// offset, less than maxRows records might be returned.
+///
+/// Data is always returned in a RowVector.
+
+enum class Table : uint8_t {
+  TBL_DATE_DIM,
+  TBL_ITEM,
+  TBL_STORE,
+  TBL_CUSTOMER,
+  TBL_CUSTOMER_ADDRESS,
+  TBL_CUSTOMER_DEMOGRAPHICS,
+  TBL_PROMOTION,
+  TBL_STORE_SALES,
+};
+
+/// Returns table name as a string.
+std::string_view toTableName(Table table);
+
+/// Returns the table enum value given a table name.
+Table fromTableName(std::string_view tableName);
+
+/// Returns the row count for a particular TPC-DS table given a scale factor.
+size_t getRowCount(Table table, size_t scaleFactor);
+
+/// Returns the schema (RowType) for a particular TPC-DS table.
+RowTypePtr getTableSchema(Table table);
+
+/// Returns the type of a particular table:column pair. Throws if `columnName`
+/// does not exist in `table`.
+TypePtr resolveTpcdsColumn(Table table, const std::string& columnName);
+
+/// Returns a row vector containing at most `maxRows` rows of `table`,
+/// starting at `offset`, and given the scale factor. The row vector has the
+/// schema returned by getTableSchema(table).
+///
+/// The store sales of a ticket are consecutive rows sharing the date, store,
+/// customer and promotion. The dates of the sales are in the five years
+/// from 1998-01-02 of the spec.
+RowVectorPtr genTpcdsData(
+    Table table,
+    size_t maxRows = 10000,
+    size_t offset = 0,
+    size_t scaleFactor = 1,
+    memory::MemoryPool* pool =
+        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+
+} // namespace facebook::velox::tpcds
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "velox/tpcds/gen/TpcdsGen.h"
+#include "velox/type/StringView.h"
+#include "velox/vector/FlatVector.h"
+
+namespace {
+
+using namespace facebook::velox;
+using namespace facebook::velox::tpcds;
+
+TEST(TpcdsGenTest, rowCounts) {
+  EXPECT_EQ(73'049, getRowCount(Table::TBL_DATE_DIM, 1'000));
+  EXPECT_EQ(1'920'800, getRowCount(Table::TBL_CUSTOMER_DEMOGRAPHICS, 10));
+  EXPECT_EQ(18'000, getRowCount(Table::TBL_ITEM, 1));
+  EXPECT_EQ(204'000, getRowCount(Table::TBL_ITEM, 100));
+  // Dimensions get the count of the closest smaller official scale factor.
+  EXPECT_EQ(102, getRowCount(Table::TBL_STORE, 30));
+  EXPECT_EQ(2'880'404, getRowCount(Table::TBL_STORE_SALES, 1));
+  EXPECT_EQ(28'800'991, getRowCount(Table::TBL_STORE_SALES, 10));
+  EXPECT_EQ(3 * 2'880'404, getRowCount(Table::TBL_STORE_SALES, 3));
+}
+
+TEST(TpcdsGenTest, tableNames) {
+  for (auto table :
+       {Table::TBL_DATE_DIM,
+        Table::TBL_ITEM,
+        Table::TBL_STORE,
+        Table::TBL_CUSTOMER,
+        Table::TBL_CUSTOMER_ADDRESS,
+        Table::TBL_CUSTOMER_DEMOGRAPHICS,
+        Table::TBL_PROMOTION,
+        Table::TBL_STORE_SALES}) {
+    EXPECT_EQ(table, fromTableName(toTableName(table)));
+    auto rowVector = genTpcdsData(table, 100);
+    EXPECT_EQ(100, rowVector->size());
+    EXPECT_EQ(*getTableSchema(table), *rowVector->type());
+  }
+  EXPECT_THROW(fromTableName("web_sales"), std::invalid_argument);
+  EXPECT_EQ(BIGINT(), resolveTpcdsColumn(Table::TBL_ITEM, "i_brand_id"));
+}
+
+TEST(TpcdsGenTest, dateDim) {
+  auto rowVector = genTpcdsData(Table::TBL_DATE_DIM, 10'000, 35'790);
+  auto dateSk = rowVector->childAt(0)->asFlatVector<int64_t>();
+  auto date = rowVector->childAt(2)->asFlatVector<Date>();
+  auto year = rowVector->childAt(6)->asFlatVector<int64_t>();
+  auto dow = rowVector->childAt(7)->asFlatVector<int64_t>();
+  auto moy = rowVector->childAt(8)->asFlatVector<int64_t>();
+  auto dom = rowVector->childAt(9)->asFlatVector<int64_t>();
+  auto dayName = rowVector->childAt(11)->asFlatVector<StringView>();
+
+  // Row 35'794 is 1998-01-02, the first day of the store sales, a Friday.
+  EXPECT_EQ(2'450'816, dateSk->valueAt(4));
+  EXPECT_EQ(Date(10'228), date->valueAt(4));
+  EXPECT_EQ(1998, year->valueAt(4));
+  EXPECT_EQ(1, moy->valueAt(4));
+  EXPECT_EQ(2, dom->valueAt(4));
+  EXPECT_EQ(5, dow->valueAt(4));
+  EXPECT_EQ("Friday"_sv, dayName->valueAt(4));
+
+  auto end = genTpcdsData(Table::TBL_DATE_DIM, 10'000, 73'040);
+  EXPECT_EQ(9, end->size());
+}
+
+TEST(TpcdsGenTest, customerDemographics) {
+  auto rowVector = genTpcdsData(Table::TBL_CUSTOMER_DEMOGRAPHICS, 1'400);
+  auto gender = rowVector->childAt(1)->asFlatVector<StringView>();
+  auto maritalStatus = rowVector->childAt(2)->asFlatVector<StringView>();
+  auto education = rowVector->childAt(3)->asFlatVector<StringView>();
+  auto purchaseEstimate = rowVector->childAt(4)->asFlatVector<int64_t>();
+
+  EXPECT_EQ("M"_sv, gender->valueAt(0));
+  EXPECT_EQ("F"_sv, gender->valueAt(1));
+  EXPECT_EQ("S"_sv, maritalStatus->valueAt(2));
+  EXPECT_EQ("College"_sv, education->valueAt(20));
+  EXPECT_EQ(500, purchaseEstimate->valueAt(69));
+  EXPECT_EQ(1'000, purchaseEstimate->valueAt(70));
+  EXPECT_EQ(10'000, purchaseEstimate->valueAt(1'399));
+}
+
+// Different splits of a table produce the same rows as generating it at once.
+TEST(TpcdsGenTest, reproducible) {
+  for (auto table :
+       {Table::TBL_ITEM, Table::TBL_CUSTOMER, Table::TBL_STORE_SALES}) {
+    auto all = genTpcdsData(table, 1'000, 5'000);
+    for (auto offset = 0; offset < 1'000; offset += 250) {
+      auto part = genTpcdsData(table, 250, 5'000 + offset);
+      for (auto i = 0; i < part->size(); ++i) {
+        ASSERT_TRUE(part->equalValueAt(all.get(), i, offset + i))
+            << toTableName(table) << " " << offset + i;
+      }
+    }
+  }
+}
+
+TEST(TpcdsGenTest, storeSales) {
+  auto rowVector = genTpcdsData(Table::TBL_STORE_SALES, 1'000, 1'000, 10);
+  auto soldDateSk = rowVector->childAt(0)->asFlatVector<int64_t>();
+  auto itemSk = rowVector->childAt(1)->asFlatVector<int64_t>();
+  auto customerSk = rowVector->childAt(2)->asFlatVector<int64_t>();
+  auto storeSk = rowVector->childAt(5)->asFlatVector<int64_t>();
+  auto ticketNumber = rowVector->childAt(7)->asFlatVector<int64_t>();
+  auto quantity = rowVector->childAt(8)->asFlatVector<int64_t>();
+  auto listPrice = rowVector->childAt(10)->asFlatVector<double>();
+  auto salesPrice = rowVector->childAt(11)->asFlatVector<double>();
+  auto extSalesPrice = rowVector->childAt(12)->asFlatVector<double>();
+
+  for (auto i = 0; i < rowVector->size(); ++i) {
+    EXPECT_GE(soldDateSk->valueAt(i), 2'450'816);
+    EXPECT_LE(soldDateSk->valueAt(i), 2'452'641);
+    EXPECT_GE(itemSk->valueAt(i), 1);
+    EXPECT_LE(itemSk->valueAt(i), 102'000);
+    EXPECT_GE(storeSk->valueAt(i), 1);
+    EXPECT_LE(storeSk->valueAt(i), 102);
+    EXPECT_LE(salesPrice->valueAt(i), listPrice->valueAt(i));
+    EXPECT_NEAR(
+        salesPrice->valueAt(i) * quantity->valueAt(i),
+        extSalesPrice->valueAt(i),
+        0.001);
+    // The lines of a ticket share its date, store and customer.
+    if (i > 0 && ticketNumber->valueAt(i) == ticketNumber->valueAt(i - 1)) {
+      EXPECT_EQ(soldDateSk->valueAt(i), soldDateSk->valueAt(i - 1));
+      EXPECT_EQ(storeSk->valueAt(i), storeSk->valueAt(i - 1));
+      EXPECT_EQ(customerSk->valueAt(i), customerSk->valueAt(i - 1));
+    }
+  }
+  EXPECT_EQ(101, ticketNumber->valueAt(0));
+  EXPECT_EQ(200, ticketNumber->valueAt(999));
+}
+
+} // namespace
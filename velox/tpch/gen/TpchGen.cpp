@@ -64,19 +64,43 @@ size_t getVectorSize(size_t rowCount, size_t maxRows, size_t offset) {
   return std::min(rowCount - offset, maxRows);
 }
 
+// Allocates the children at 'columns' or all children if 'columns' is
+// nullptr. The others are nullptr.
 std::vector<VectorPtr> allocateVectors(
     const RowTypePtr& type,
     size_t vectorSize,
-    memory::MemoryPool* pool) {
-  std::vector<VectorPtr> vectors;
-  vectors.reserve(type->size());
-
-  for (const auto& childType : type->children()) {
-    vectors.emplace_back(BaseVector::create(childType, vectorSize, pool));
+    memory::MemoryPool* pool,
+    const std::vector<column_index_t>* columns) {
+  std::vector<VectorPtr> vectors(type->size());
+  if (!columns) {
+    for (auto i = 0; i < type->size(); ++i) {
+      vectors[i] = BaseVector::create(type->childAt(i), vectorSize, pool);
+    }
+    return vectors;
+  }
+  for (auto column : *columns) {
+    VELOX_CHECK_LT(column, type->size());
+    vectors[column] =
+        BaseVector::create(type->childAt(column), vectorSize, pool);
   }
   return vectors;
 }
 
+// Returns 'vector' as a FlatVector or nullptr if it was not allocated.
+template <typename T>
+FlatVector<T>* asFlat(const VectorPtr& vector) {
+  return vector ? vector->asFlatVector<T>() : nullptr;
+}
+
+// Sets 'row' of 'vector' unless the column is not generated.
+template <typename T, typename V>
+FOLLY_ALWAYS_INLINE void
+setValue(FlatVector<T>* vector, vector_size_t row, const V& value) {
+  if (vector) {
+    vector->set(row, value);
+  }
+}
+
 double decimalToDouble(int64_t value) {
   return (double)value * 0.01;
 }
@@ -353,22 +377,23 @@ RowVectorPtr genTpchOrders(
     size_t maxRows,
     size_t offset,
     size_t scaleFactor,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const std::vector<column_index_t>* columns) {
   // Create schema and allocate vectors.
   auto ordersRowType = getTableSchema(Table::TBL_ORDERS);
   size_t vectorSize = getVectorSize(
       getRowCount(Table::TBL_ORDERS, scaleFactor), maxRows, offset);
-  auto children = allocateVectors(ordersRowType, vectorSize, pool);
-
-  auto orderKeyVector = children[0]->asFlatVector<int64_t>();
-  auto custKeyVector = children[1]->asFlatVector<int64_t>();
-  auto orderStatusVector = children[2]->asFlatVector<StringView>();
-  auto totalPriceVector = children[3]->asFlatVector<double>();
-  auto orderDateVector = children[4]->asFlatVector<StringView>();
-  auto orderPriorityVector = children[5]->asFlatVector<StringView>();
-  auto clerkVector = children[6]->asFlatVector<StringView>();
-  auto shipPriorityVector = children[7]->asFlatVector<int32_t>();
-  auto commentVector = children[8]->asFlatVector<StringView>();
+  auto children = allocateVectors(ordersRowType, vectorSize, pool, columns);
+
+  auto orderKeyVector = asFlat<int64_t>(children[0]);
+  auto custKeyVector = asFlat<int64_t>(children[1]);
+  auto orderStatusVector = asFlat<StringView>(children[2]);
+  auto totalPriceVector = asFlat<double>(children[3]);
+  auto orderDateVector = asFlat<StringView>(children[4]);
+  auto orderPriorityVector = asFlat<StringView>(children[5]);
+  auto clerkVector = asFlat<StringView>(children[6]);
+  auto shipPriorityVector = asFlat<int32_t>(children[7]);
+  auto commentVector = asFlat<StringView>(children[8]);
 
   auto dbgenIt = DBGenIterator::create(scaleFactor);
   dbgenIt.initOrder(offset);
@@ -379,16 +404,18 @@ RowVectorPtr genTpchOrders(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genOrder(i + offset + 1, order);
 
-    orderKeyVector->set(i, order.okey);
-    custKeyVector->set(i, order.custkey);
-    orderStatusVector->set(i, StringView(&order.orderstatus, 1));
-    totalPriceVector->set(i, decimalToDouble(order.totalprice));
-    orderDateVector->set(i, StringView(order.odate, strlen(order.odate)));
-    orderPriorityVector->set(
-        i, StringView(order.opriority, strlen(order.opriority)));
-    clerkVector->set(i, StringView(order.clerk, strlen(order.clerk)));
-    shipPriorityVector->set(i, order.spriority);
-    commentVector->set(i, StringView(order.comment, order.clen));
+    setValue(orderKeyVector, i, order.okey);
+    setValue(custKeyVector, i, order.custkey);
+    setValue(orderStatusVector, i, StringView(&order.orderstatus, 1));
+    setValue(totalPriceVector, i, decimalToDouble(order.totalprice));
+    setValue(orderDateVector, i, StringView(order.odate, strlen(order.odate)));
+    setValue(
+        orderPriorityVector,
+        i,
+        StringView(order.opriority, strlen(order.opriority)));
+    setValue(clerkVector, i, StringView(order.clerk, strlen(order.clerk)));
+    setValue(shipPriorityVector, i, order.spriority);
+    setValue(commentVector, i, StringView(order.comment, order.clen));
   }
   return std::make_shared<RowVector>(
       pool, ordersRowType, BufferPtr(nullptr), vectorSize, std::move(children));
@@ -398,7 +425,8 @@ RowVectorPtr genTpchLineItem(
     size_t maxOrderRows,
     size_t ordersOffset,
     size_t scaleFactor,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const std::vector<column_index_t>* columns) {
   // We control the buffer size based on the orders table, then allocate the
   // underlying buffer using the worst case (orderVectorSize * 7).
   size_t orderVectorSize = getVectorSize(
@@ -407,26 +435,27 @@ RowVectorPtr genTpchLineItem(
 
   // Create schema and allocate vectors.
   auto lineItemRowType = getTableSchema(Table::TBL_LINEITEM);
-  auto children = allocateVectors(lineItemRowType, lineItemUpperBound, pool);
-
-  auto orderKeyVector = children[0]->asFlatVector<int64_t>();
-  auto partKeyVector = children[1]->asFlatVector<int64_t>();
-  auto suppKeyVector = children[2]->asFlatVector<int64_t>();
-  auto lineNumberVector = children[3]->asFlatVector<int32_t>();
-
-  auto quantityVector = children[4]->asFlatVector<double>();
-  auto extendedPriceVector = children[5]->asFlatVector<double>();
-  auto discountVector = children[6]->asFlatVector<double>();
-  auto taxVector = children[7]->asFlatVector<double>();
-
-  auto returnFlagVector = children[8]->asFlatVector<StringView>();
-  auto lineStatusVector = children[9]->asFlatVector<StringView>();
-  auto shipDateVector = children[10]->asFlatVector<StringView>();
-  auto commitDateVector = children[11]->asFlatVector<StringView>();
-  auto receiptDateVector = children[12]->asFlatVector<StringView>();
-  auto shipInstructVector = children[13]->asFlatVector<StringView>();
-  auto shipModeVector = children[14]->asFlatVector<StringView>();
-  auto commentVector = children[15]->asFlatVector<StringView>();
+  auto children =
+      allocateVectors(lineItemRowType, lineItemUpperBound, pool, columns);
+
+  auto orderKeyVector = asFlat<int64_t>(children[0]);
+  auto partKeyVector = asFlat<int64_t>(children[1]);
+  auto suppKeyVector = asFlat<int64_t>(children[2]);
+  auto lineNumberVector = asFlat<int32_t>(children[3]);
+
+  auto quantityVector = asFlat<double>(children[4]);
+  auto extendedPriceVector = asFlat<double>(children[5]);
+  auto discountVector = asFlat<double>(children[6]);
+  auto taxVector = asFlat<double>(children[7]);
+
+  auto returnFlagVector = asFlat<StringView>(children[8]);
+  auto lineStatusVector = asFlat<StringView>(children[9]);
+  auto shipDateVector = asFlat<StringView>(children[10]);
+  auto commitDateVector = asFlat<StringView>(children[11]);
+  auto receiptDateVector = asFlat<StringView>(children[12]);
+  auto shipInstructVector = asFlat<StringView>(children[13]);
+  auto shipModeVector = asFlat<StringView>(children[14]);
+  auto commentVector = asFlat<StringView>(children[15]);
 
   auto dbgenIt = DBGenIterator::create(scaleFactor);
   dbgenIt.initOrder(ordersOffset);
@@ -443,41 +472,46 @@ RowVectorPtr genTpchLineItem(
 
     for (size_t l = 0; l < order.lines; ++l) {
       const auto& line = order.l[l];
-      orderKeyVector->set(lineItemCount + l, line.okey);
-      partKeyVector->set(lineItemCount + l, line.partkey);
-      suppKeyVector->set(lineItemCount + l, line.suppkey);
-
-      lineNumberVector->set(lineItemCount + l, line.lcnt);
-
-      quantityVector->set(lineItemCount + l, decimalToDouble(line.quantity));
-      extendedPriceVector->set(lineItemCount + l, decimalToDouble(line.eprice));
-      discountVector->set(lineItemCount + l, decimalToDouble(line.discount));
-      taxVector->set(lineItemCount + l, decimalToDouble(line.tax));
-
-      returnFlagVector->set(lineItemCount + l, StringView(line.rflag, 1));
-      lineStatusVector->set(lineItemCount + l, StringView(line.lstatus, 1));
-
-      shipDateVector->set(
-          lineItemCount + l, StringView(line.sdate, strlen(line.sdate)));
-      commitDateVector->set(
-          lineItemCount + l, StringView(line.cdate, strlen(line.cdate)));
-      receiptDateVector->set(
-          lineItemCount + l, StringView(line.rdate, strlen(line.rdate)));
-
-      shipInstructVector->set(
-          lineItemCount + l,
+      const auto row = lineItemCount + l;
+      setValue(orderKeyVector, row, line.okey);
+      setValue(partKeyVector, row, line.partkey);
+      setValue(suppKeyVector, row, line.suppkey);
+
+      setValue(lineNumberVector, row, line.lcnt);
+
+      setValue(quantityVector, row, decimalToDouble(line.quantity));
+      setValue(extendedPriceVector, row, decimalToDouble(line.eprice));
+      setValue(discountVector, row, decimalToDouble(line.discount));
+      setValue(taxVector, row, decimalToDouble(line.tax));
+
+      setValue(returnFlagVector, row, StringView(line.rflag, 1));
+      setValue(lineStatusVector, row, StringView(line.lstatus, 1));
+
+      setValue(shipDateVector, row, StringView(line.sdate, strlen(line.sdate)));
+      setValue(
+          commitDateVector, row, StringView(line.cdate, strlen(line.cdate)));
+      setValue(
+          receiptDateVector, row, StringView(line.rdate, strlen(line.rdate)));
+
+      setValue(
+          shipInstructVector,
+          row,
           StringView(line.shipinstruct, strlen(line.shipinstruct)));
-      shipModeVector->set(
-          lineItemCount + l, StringView(line.shipmode, strlen(line.shipmode)));
-      commentVector->set(
-          lineItemCount + l, StringView(line.comment, strlen(line.comment)));
+      setValue(
+          shipModeVector,
+          row,
+          StringView(line.shipmode, strlen(line.shipmode)));
+      setValue(
+          commentVector, row, StringView(line.comment, strlen(line.comment)));
     }
     lineItemCount += order.lines;
   }
 
   // Resize to shrink the buffers - since we allocated based on the upper bound.
   for (auto& child : children) {
-    child->resize(lineItemCount);
+    if (child) {
+      child->resize(lineItemCount);
+    }
   }
   return std::make_shared<RowVector>(
       pool,
@@ -491,22 +525,23 @@ RowVectorPtr genTpchPart(
     size_t maxRows,
     size_t offset,
     size_t scaleFactor,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const std::vector<column_index_t>* columns) {
   // Create schema and allocate vectors.
   auto partRowType = getTableSchema(Table::TBL_PART);
   size_t vectorSize =
       getVectorSize(getRowCount(Table::TBL_PART, scaleFactor), maxRows, offset);
-  auto children = allocateVectors(partRowType, vectorSize, pool);
-
-  auto partKeyVector = children[0]->asFlatVector<int64_t>();
-  auto nameVector = children[1]->asFlatVector<StringView>();
-  auto mfgrVector = children[2]->asFlatVector<StringView>();
-  auto brandVector = children[3]->asFlatVector<StringView>();
-  auto typeVector = children[4]->asFlatVector<StringView>();
-  auto sizeVector = children[5]->asFlatVector<int32_t>();
-  auto containerVector = children[6]->asFlatVector<StringView>();
-  auto retailPriceVector = children[7]->asFlatVector<double>();
-  auto commentVector = children[8]->asFlatVector<StringView>();
+  auto children = allocateVectors(partRowType, vectorSize, pool, columns);
+
+  auto partKeyVector = asFlat<int64_t>(children[0]);
+  auto nameVector = asFlat<StringView>(children[1]);
+  auto mfgrVector = asFlat<StringView>(children[2]);
+  auto brandVector = asFlat<StringView>(children[3]);
+  auto typeVector = asFlat<StringView>(children[4]);
+  auto sizeVector = asFlat<int32_t>(children[5]);
+  auto containerVector = asFlat<StringView>(children[6]);
+  auto retailPriceVector = asFlat<double>(children[7]);
+  auto commentVector = asFlat<StringView>(children[8]);
 
   auto dbgenIt = DBGenIterator::create(scaleFactor);
   dbgenIt.initPart(offset);
@@ -517,15 +552,18 @@ RowVectorPtr genTpchPart(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genPart(i + offset + 1, part);
 
-    partKeyVector->set(i, part.partkey);
-    nameVector->set(i, StringView(part.name, strlen(part.name)));
-    mfgrVector->set(i, StringView(part.mfgr, strlen(part.mfgr)));
-    brandVector->set(i, StringView(part.brand, strlen(part.brand)));
-    typeVector->set(i, StringView(part.type, part.tlen));
-    sizeVector->set(i, part.size);
-    containerVector->set(i, StringView(part.container, strlen(part.container)));
-    retailPriceVector->set(i, decimalToDouble(part.retailprice));
-    commentVector->set(i, StringView(part.comment, part.clen));
+    setValue(partKeyVector, i, part.partkey);
+    setValue(nameVector, i, StringView(part.name, strlen(part.name)));
+    setValue(mfgrVector, i, StringView(part.mfgr, strlen(part.mfgr)));
+    setValue(brandVector, i, StringView(part.brand, strlen(part.brand)));
+    setValue(typeVector, i, StringView(part.type, part.tlen));
+    setValue(sizeVector, i, part.size);
+    setValue(
+        containerVector,
+        i,
+        StringView(part.container, strlen(part.container)));
+    setValue(retailPriceVector, i, decimalToDouble(part.retailprice));
+    setValue(commentVector, i, StringView(part.comment, part.clen));
   }
   return std::make_shared<RowVector>(
       pool, partRowType, BufferPtr(nullptr), vectorSize, std::move(children));
@@ -535,20 +573,21 @@ RowVectorPtr genTpchSupplier(
     size_t maxRows,
     size_t offset,
     size_t scaleFactor,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const std::vector<column_index_t>* columns) {
   // Create schema and allocate vectors.
   auto supplierRowType = getTableSchema(Table::TBL_SUPPLIER);
   size_t vectorSize = getVectorSize(
       getRowCount(Table::TBL_SUPPLIER, scaleFactor), maxRows, offset);
-  auto children = allocateVectors(supplierRowType, vectorSize, pool);
+  auto children = allocateVectors(supplierRowType, vectorSize, pool, columns);
 
-  auto suppKeyVector = children[0]->asFlatVector<int64_t>();
-  auto nameVector = children[1]->asFlatVector<StringView>();
-  auto addressVector = children[2]->asFlatVector<StringView>();
-  auto nationKeyVector = children[3]->asFlatVector<int64_t>();
-  auto phoneVector = children[4]->asFlatVector<StringView>();
-  auto acctbalVector = children[5]->asFlatVector<double>();
-  auto commentVector = children[6]->asFlatVector<StringView>();
+  auto suppKeyVector = asFlat<int64_t>(children[0]);
+  auto nameVector = asFlat<StringView>(children[1]);
+  auto addressVector = asFlat<StringView>(children[2]);
+  auto nationKeyVector = asFlat<int64_t>(children[3]);
+  auto phoneVector = asFlat<StringView>(children[4]);
+  auto acctbalVector = asFlat<double>(children[5]);
+  auto commentVector = asFlat<StringView>(children[6]);
 
   auto dbgenIt = DBGenIterator::create(scaleFactor);
   dbgenIt.initSupplier(offset);
@@ -559,13 +598,13 @@ RowVectorPtr genTpchSupplier(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genSupplier(i + offset + 1, supp);
 
-    suppKeyVector->set(i, supp.suppkey);
-    nameVector->set(i, StringView(supp.name, strlen(supp.name)));
-    addressVector->set(i, StringView(supp.address, supp.alen));
-    nationKeyVector->set(i, supp.nation_code);
-    phoneVector->set(i, StringView(supp.phone, strlen(supp.phone)));
-    acctbalVector->set(i, decimalToDouble(supp.acctbal));
-    commentVector->set(i, StringView(supp.comment, supp.clen));
+    setValue(suppKeyVector, i, supp.suppkey);
+    setValue(nameVector, i, StringView(supp.name, strlen(supp.name)));
+    setValue(addressVector, i, StringView(supp.address, supp.alen));
+    setValue(nationKeyVector, i, supp.nation_code);
+    setValue(phoneVector, i, StringView(supp.phone, strlen(supp.phone)));
+    setValue(acctbalVector, i, decimalToDouble(supp.acctbal));
+    setValue(commentVector, i, StringView(supp.comment, supp.clen));
   }
   return std::make_shared<RowVector>(
       pool,
@@ -579,18 +618,19 @@ RowVectorPtr genTpchPartSupp(
     size_t maxRows,
     size_t offset,
     size_t scaleFactor,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const std::vector<column_index_t>* columns) {
   // Create schema and allocate vectors.
   auto partSuppRowType = getTableSchema(Table::TBL_PARTSUPP);
   size_t vectorSize = getVectorSize(
       getRowCount(Table::TBL_PARTSUPP, scaleFactor), maxRows, offset);
-  auto children = allocateVectors(partSuppRowType, vectorSize, pool);
+  auto children = allocateVectors(partSuppRowType, vectorSize, pool, columns);
 
-  auto partKeyVector = children[0]->asFlatVector<int64_t>();
-  auto suppKeyVector = children[1]->asFlatVector<int64_t>();
-  auto availQtyVector = children[2]->asFlatVector<int32_t>();
-  auto supplyCostVector = children[3]->asFlatVector<double>();
-  auto commentVector = children[4]->asFlatVector<StringView>();
+  auto partKeyVector = asFlat<int64_t>(children[0]);
+  auto suppKeyVector = asFlat<int64_t>(children[1]);
+  auto availQtyVector = asFlat<int32_t>(children[2]);
+  auto supplyCostVector = asFlat<double>(children[3]);
+  auto commentVector = asFlat<StringView>(children[4]);
 
   auto dbgenIt = DBGenIterator::create(scaleFactor);
   part_t part;
@@ -611,12 +651,15 @@ RowVectorPtr genTpchPartSupp(
     while ((partSuppIdx < SUPP_PER_PART) && (partSuppCount < vectorSize)) {
       const auto& partSupp = part.s[partSuppIdx];
 
-      partKeyVector->set(partSuppCount, partSupp.partkey);
-      suppKeyVector->set(partSuppCount, partSupp.suppkey);
-      availQtyVector->set(partSuppCount, partSupp.qty);
-      supplyCostVector->set(partSuppCount, decimalToDouble(partSupp.scost));
-      commentVector->set(
-          partSuppCount, StringView(partSupp.comment, partSupp.clen));
+      setValue(partKeyVector, partSuppCount, partSupp.partkey);
+      setValue(suppKeyVector, partSuppCount, partSupp.suppkey);
+      setValue(availQtyVector, partSuppCount, partSupp.qty);
+      setValue(
+          supplyCostVector, partSuppCount, decimalToDouble(partSupp.scost));
+      setValue(
+          commentVector,
+          partSuppCount,
+          StringView(partSupp.comment, partSupp.clen));
 
       ++partSuppIdx;
       ++partSuppCount;
@@ -639,21 +682,22 @@ RowVectorPtr genTpchCustomer(
     size_t maxRows,
     size_t offset,
     size_t scaleFactor,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const std::vector<column_index_t>* columns) {
   // Create schema and allocate vectors.
   auto customerRowType = getTableSchema(Table::TBL_CUSTOMER);
   size_t vectorSize = getVectorSize(
       getRowCount(Table::TBL_CUSTOMER, scaleFactor), maxRows, offset);
-  auto children = allocateVectors(customerRowType, vectorSize, pool);
+  auto children = allocateVectors(customerRowType, vectorSize, pool, columns);
 
-  auto custKeyVector = children[0]->asFlatVector<int64_t>();
-  auto nameVector = children[1]->asFlatVector<StringView>();
-  auto addressVector = children[2]->asFlatVector<StringView>();
-  auto nationKeyVector = children[3]->asFlatVector<int64_t>();
-  auto phoneVector = children[4]->asFlatVector<StringView>();
-  auto acctBalVector = children[5]->asFlatVector<double>();
-  auto mktSegmentVector = children[6]->asFlatVector<StringView>();
-  auto commentVector = children[7]->asFlatVector<StringView>();
+  auto custKeyVector = asFlat<int64_t>(children[0]);
+  auto nameVector = asFlat<StringView>(children[1]);
+  auto addressVector = asFlat<StringView>(children[2]);
+  auto nationKeyVector = asFlat<int64_t>(children[3]);
+  auto phoneVector = asFlat<StringView>(children[4]);
+  auto acctBalVector = asFlat<double>(children[5]);
+  auto mktSegmentVector = asFlat<StringView>(children[6]);
+  auto commentVector = asFlat<StringView>(children[7]);
 
   auto dbgenIt = DBGenIterator::create(scaleFactor);
   dbgenIt.initCustomer(offset);
@@ -664,15 +708,17 @@ RowVectorPtr genTpchCustomer(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genCustomer(i + offset + 1, cust);
 
-    custKeyVector->set(i, cust.custkey);
-    nameVector->set(i, StringView(cust.name, strlen(cust.name)));
-    addressVector->set(i, StringView(cust.address, cust.alen));
-    nationKeyVector->set(i, cust.nation_code);
-    phoneVector->set(i, StringView(cust.phone, strlen(cust.phone)));
-    acctBalVector->set(i, decimalToDouble(cust.acctbal));
-    mktSegmentVector->set(
-        i, StringView(cust.mktsegment, strlen(cust.mktsegment)));
-    commentVector->set(i, StringView(cust.comment, cust.clen));
+    setValue(custKeyVector, i, cust.custkey);
+    setValue(nameVector, i, StringView(cust.name, strlen(cust.name)));
+    setValue(addressVector, i, StringView(cust.address, cust.alen));
+    setValue(nationKeyVector, i, cust.nation_code);
+    setValue(phoneVector, i, StringView(cust.phone, strlen(cust.phone)));
+    setValue(acctBalVector, i, decimalToDouble(cust.acctbal));
+    setValue(
+        mktSegmentVector,
+        i,
+        StringView(cust.mktsegment, strlen(cust.mktsegment)));
+    setValue(commentVector, i, StringView(cust.comment, cust.clen));
   }
   return std::make_shared<RowVector>(
       pool,
@@ -686,17 +732,18 @@ RowVectorPtr genTpchNation(
     size_t maxRows,
     size_t offset,
     size_t scaleFactor,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const std::vector<column_index_t>* columns) {
   // Create schema and allocate vectors.
   auto nationRowType = getTableSchema(Table::TBL_NATION);
   size_t vectorSize = getVectorSize(
       getRowCount(Table::TBL_NATION, scaleFactor), maxRows, offset);
-  auto children = allocateVectors(nationRowType, vectorSize, pool);
+  auto children = allocateVectors(nationRowType, vectorSize, pool, columns);
 
-  auto nationKeyVector = children[0]->asFlatVector<int64_t>();
-  auto nameVector = children[1]->asFlatVector<StringView>();
-  auto regionKeyVector = children[2]->asFlatVector<int64_t>();
-  auto commentVector = children[3]->asFlatVector<StringView>();
+  auto nationKeyVector = asFlat<int64_t>(children[0]);
+  auto nameVector = asFlat<StringView>(children[1]);
+  auto regionKeyVector = asFlat<int64_t>(children[2]);
+  auto commentVector = asFlat<StringView>(children[3]);
 
   auto dbgenIt = DBGenIterator::create(scaleFactor);
   dbgenIt.initNation(offset);
@@ -707,10 +754,10 @@ RowVectorPtr genTpchNation(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genNation(i + offset + 1, code);
 
-    nationKeyVector->set(i, code.code);
-    nameVector->set(i, StringView(code.text, strlen(code.text)));
-    regionKeyVector->set(i, code.join);
-    commentVector->set(i, StringView(code.comment, code.clen));
+    setValue(nationKeyVector, i, code.code);
+    setValue(nameVector, i, StringView(code.text, strlen(code.text)));
+    setValue(regionKeyVector, i, code.join);
+    setValue(commentVector, i, StringView(code.comment, code.clen));
   }
   return std::make_shared<RowVector>(
       pool, nationRowType, BufferPtr(nullptr), vectorSize, std::move(children));
@@ -720,16 +767,17 @@ RowVectorPtr genTpchRegion(
     size_t maxRows,
     size_t offset,
     size_t scaleFactor,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const std::vector<column_index_t>* columns) {
   // Create schema and allocate vectors.
   auto regionRowType = getTableSchema(Table::TBL_REGION);
   size_t vectorSize = getVectorSize(
       getRowCount(Table::TBL_REGION, scaleFactor), maxRows, offset);
-  auto children = allocateVectors(regionRowType, vectorSize, pool);
+  auto children = allocateVectors(regionRowType, vectorSize, pool, columns);
 
-  auto regionKeyVector = children[0]->asFlatVector<int64_t>();
-  auto nameVector = children[1]->asFlatVector<StringView>();
-  auto commentVector = children[2]->asFlatVector<StringView>();
+  auto regionKeyVector = asFlat<int64_t>(children[0]);
+  auto nameVector = asFlat<StringView>(children[1]);
+  auto commentVector = asFlat<StringView>(children[2]);
 
   auto dbgenIt = DBGenIterator::create(scaleFactor);
   dbgenIt.initRegion(offset);
@@ -740,9 +788,9 @@ RowVectorPtr genTpchRegion(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genRegion(i + offset + 1, code);
 
-    regionKeyVector->set(i, code.code);
-    nameVector->set(i, StringView(code.text, strlen(code.text)));
-    commentVector->set(i, StringView(code.comment, code.clen));
+    setValue(regionKeyVector, i, code.code);
+    setValue(nameVector, i, StringView(code.text, strlen(code.text)));
+    setValue(commentVector, i, StringView(code.comment, code.clen));
   }
   return std::make_shared<RowVector>(
       pool, regionRowType, BufferPtr(nullptr), vectorSize, std::move(children));
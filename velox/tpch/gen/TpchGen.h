@@ -33,7 +33,11 @@ namespace facebook::velox::tpch {
 /// If not enough records are available given a particular scale factor and
 /// offset, less than maxRows records might be returned.
 ///
-/// Data is always returned in a RowVector.
+/// Data is always returned in a RowVector. If 'columns' is set, only the
+/// children at these indices of the table schema are filled in and the
+/// others are nullptr. DBGEN still generates complete rows, since the values
+/// of a row depend on the random numbers drawn for the previous columns, but
+/// the values of the other columns are not copied into vectors.
 
 enum class Table : uint8_t {
   TBL_PART,
@@ -84,7 +88,8 @@ RowVectorPtr genTpchOrders(
     size_t offset = 0,
     size_t scaleFactor = 1,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const std::vector<column_index_t>* columns = nullptr);
 
 /// NOTE: This function's parameters have different semantic from the function
 /// above. Dbgen does not provide deterministic random access to lineitem
@@ -123,7 +128,8 @@ RowVectorPtr genTpchLineItem(
     size_t ordersOffset = 0,
     size_t scaleFactor = 1,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const std::vector<column_index_t>* columns = nullptr);
 
 /// Returns a row vector containing at most `maxRows` rows of the "part"
 /// table, starting at `offset`, and given the scale factor. The row vector
@@ -144,7 +150,8 @@ RowVectorPtr genTpchPart(
     size_t offset = 0,
     size_t scaleFactor = 1,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const std::vector<column_index_t>* columns = nullptr);
 
 /// Returns a row vector containing at most `maxRows` rows of the "supplier"
 /// table, starting at `offset`, and given the scale factor. The row vector
@@ -163,7 +170,8 @@ RowVectorPtr genTpchSupplier(
     size_t offset = 0,
     size_t scaleFactor = 1,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const std::vector<column_index_t>* columns = nullptr);
 
 /// Returns a row vector containing at most `maxRows` rows of the "partsupp"
 /// table, starting at `offset`, and given the scale factor. The row vector
@@ -180,7 +188,8 @@ RowVectorPtr genTpchPartSupp(
     size_t offset = 0,
     size_t scaleFactor = 1,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const std::vector<column_index_t>* columns = nullptr);
 
 /// Returns a row vector containing at most `maxRows` rows of the "customer"
 /// table, starting at `offset`, and given the scale factor. The row vector
@@ -200,7 +209,8 @@ RowVectorPtr genTpchCustomer(
     size_t offset = 0,
     size_t scaleFactor = 1,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const std::vector<column_index_t>* columns = nullptr);
 
 /// Returns a row vector containing at most `maxRows` rows of the "nation"
 /// table, starting at `offset`, and given the scale factor. The row vector
@@ -216,7 +226,8 @@ RowVectorPtr genTpchNation(
     size_t offset = 0,
     size_t scaleFactor = 1,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const std::vector<column_index_t>* columns = nullptr);
 
 /// Returns a row vector containing at most `maxRows` rows of the "region"
 /// table, starting at `offset`, and given the scale factor. The row vector
@@ -231,6 +242,7 @@ RowVectorPtr genTpchRegion(
     size_t offset = 0,
     size_t scaleFactor = 1,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const std::vector<column_index_t>* columns = nullptr);
 
 } // namespace facebook::velox::tpch
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/type/DecimalUtil.h"
+
+namespace facebook::velox {
+
+// static
+int128_t DecimalUtil::rescale(
+    int128_t value,
+    int32_t fromScale,
+    int32_t toPrecision,
+    int32_t toScale) {
+  int128_t result;
+  bool overflow = false;
+  if (toScale >= fromScale) {
+    overflow = __builtin_mul_overflow(
+        value, kPowersOfTen[toScale - fromScale], &result);
+  } else {
+    result = divideRoundHalfUp(value, kPowersOfTen[fromScale - toScale]);
+  }
+  VELOX_USER_CHECK(
+      !overflow && valueInRange(result, toPrecision),
+      "Decimal overflow: {} does not fit DECIMAL({}, {})",
+      toString(value, fromScale),
+      toPrecision,
+      toScale);
+  return result;
+}
+
+// static
+int32_t DecimalUtil::compare(
+    int128_t left,
+    int32_t leftScale,
+    int128_t right,
+    int32_t rightScale) {
+  // A value that overflows when rescaled is larger in magnitude than any
+  // decimal of the other scale.
+  if (leftScale < rightScale) {
+    const bool negative = left < 0;
+    if (__builtin_mul_overflow(
+            left, kPowersOfTen[rightScale - leftScale], &left)) {
+      return negative ? -1 : 1;
+    }
+  } else if (rightScale < leftScale) {
+    const bool negative = right < 0;
+    if (__builtin_mul_overflow(
+            right, kPowersOfTen[leftScale - rightScale], &right)) {
+      return negative ? 1 : -1;
+    }
+  }
+  return left < right ? -1 : (left == right ? 0 : 1);
+}
+
+// static
+std::string DecimalUtil::toString(int128_t unscaled, int32_t scale) {
+  auto digits = std::to_string(unscaled < 0 ? -unscaled : unscaled);
+  if (scale > 0) {
+    const int32_t numDigits = digits.size();
+    if (numDigits <= scale) {
+      digits.insert(0, scale - numDigits + 1, '0');
+    }
+    digits.insert(digits.size() - scale, ".");
+  }
+  return unscaled < 0 ? "-" + digits : digits;
+}
+
+} // namespace facebook::velox
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "velox/type/Type.h"
+
+namespace facebook::velox {
+
+namespace detail {
+constexpr std::array<int128_t, LongDecimalType::kMaxPrecision + 1>
+makePowersOfTen() {
+  std::array<int128_t, LongDecimalType::kMaxPrecision + 1> powers{};
+  powers[0] = 1;
+  for (size_t i = 1; i < powers.size(); ++i) {
+    powers[i] = powers[i - 1] * 10;
+  }
+  return powers;
+}
+} // namespace detail
+
+/// Helpers for the unscaled values of decimals. A DECIMAL(p, s) value v is
+/// stored as the integer v * 10^s, an int64_t for a short decimal and an
+/// int128_t for a long decimal.
+class DecimalUtil {
+ public:
+  static constexpr auto kPowersOfTen = detail::makePowersOfTen();
+
+  static int64_t unscaledValue(ShortDecimal value) {
+    return value.unscaledValue();
+  }
+
+  static int128_t unscaledValue(LongDecimal value) {
+    return value.unscaledValue();
+  }
+
+  /// Returns true if 'value' has at most 'precision' digits.
+  static bool valueInRange(int128_t value, int32_t precision) {
+    return value < kPowersOfTen[precision] && value > -kPowersOfTen[precision];
+  }
+
+  /// Returns 'dividend' / 'divisor' rounded half away from zero. 'divisor' is
+  /// not 0.
+  static int128_t divideRoundHalfUp(int128_t dividend, int128_t divisor) {
+    const auto quotient = dividend / divisor;
+    const auto remainder = dividend % divisor;
+    const auto absRemainder = remainder < 0 ? -remainder : remainder;
+    const auto absDivisor = divisor < 0 ? -divisor : divisor;
+    if (absRemainder >= absDivisor - absRemainder) {
+      return (dividend < 0) != (divisor < 0) ? quotient - 1 : quotient + 1;
+    }
+    return quotient;
+  }
+
+  /// Returns the unscaled value of 'value' of 'fromScale' at 'toScale'. The
+  /// value is rounded half away from zero if 'toScale' is less than
+  /// 'fromScale'. Throws a user error if the result has more than
+  /// 'toPrecision' digits.
+  static int128_t rescale(
+      int128_t value,
+      int32_t fromScale,
+      int32_t toPrecision,
+      int32_t toScale);
+
+  /// Returns a negative number, 0 or a positive number if 'left' of
+  /// 'leftScale' is less than, equal to or greater than 'right' of
+  /// 'rightScale'.
+  static int32_t compare(
+      int128_t left,
+      int32_t leftScale,
+      int128_t right,
+      int32_t rightScale);
+
+  /// Returns 'unscaled' with 'scale' fractional digits, e.g. -1.50 for -150
+  /// of scale 2.
+  static std::string toString(int128_t unscaled, int32_t scale);
+};
+
+} // namespace facebook::velox
@@ -21,6 +21,8 @@
 #include <set>
 #include <string>
 
+#include <folly/lang/Bits.h>
+
 #include "velox/common/base/Exceptions.h"
 #include "velox/type/Filter.h"
 
@@ -83,6 +85,9 @@ std::string Filter::toString() const {
     case FilterKind::kMultiRange:
       strKind = "MultiRange";
       break;
+    case FilterKind::kBigintBloomFilter:
+      strKind = "BigintBloomFilter";
+      break;
   };
 
   return fmt::format(
@@ -92,6 +97,94 @@ std::string Filter::toString() const {
       nullAllowed_ ? "null allowed" : "null not allowed");
 }
 
+namespace {
+using SizeAndPrefixBatch = xsimd::batch<int64_t>;
+using PrefixBatch = xsimd::batch<int32_t>;
+
+// Returns the first word of 'value', i.e. the size and the inline prefix. The
+// prefix of a string shorter than StringView::kPrefixSize is padded with
+// zeros, so equal words mean equal strings for these.
+int64_t sizeAndPrefix(const StringView& value) {
+  static_assert(sizeof(StringView) == 2 * sizeof(int64_t));
+  return reinterpret_cast<const int64_t*>(&value)[0];
+}
+
+// Loads the size and prefix words of SizeAndPrefixBatch::size consecutive
+// StringViews.
+SizeAndPrefixBatch loadSizeAndPrefixes(const StringView* values) {
+  static const int32_t kWordIndices[] = {0, 2, 4, 6, 8, 10, 12, 14};
+  static_assert(SizeAndPrefixBatch::size <= 8);
+  return simd::gather<int64_t, int32_t>(
+      reinterpret_cast<const int64_t*>(values), kWordIndices);
+}
+
+// Returns the prefix of 'value' as an int32_t that orders like the unsigned
+// bytes of the prefix. If the prefixes of two strings differ, they order the
+// strings, since the prefixes of strings shorter than
+// StringView::kPrefixSize are padded with zeros.
+int32_t orderedPrefix(const StringView& value) {
+  uint32_t prefix;
+  memcpy(
+      &prefix,
+      reinterpret_cast<const char*>(&value) + sizeof(uint32_t),
+      sizeof(prefix));
+  return folly::Endian::big(prefix) ^ (1U << 31);
+}
+
+// Sets the bits of 'passed' for 'numValues' StringViews. 'testBatch' returns
+// the bits of kWidth values starting at its argument and 'testOne' tests the
+// values after the last full batch. kWidth divides 64, so that a batch does
+// not straddle words.
+template <int32_t kWidth, typename TestBatch, typename TestOne>
+void testStringViewBatches(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed,
+    TestBatch testBatch,
+    TestOne testOne) {
+  static_assert(64 % kWidth == 0);
+  std::fill(passed, passed + bits::nwords(numValues), 0);
+  int32_t i = 0;
+  for (; i + kWidth <= numValues; i += kWidth) {
+    passed[i / 64] |= static_cast<uint64_t>(testBatch(values + i)) << (i % 64);
+  }
+  for (; i < numValues; ++i) {
+    if (testOne(values[i])) {
+      bits::setBit(passed, i);
+    }
+  }
+}
+
+// Returns the bits of 'candidates' of the values of 'batch' that pass
+// 'filter'. The candidates match a value of 'filter' on the size and prefix,
+// which decides strings no longer than the prefix.
+uint64_t testCandidates(
+    const Filter& filter,
+    const StringView* batch,
+    uint64_t candidates) {
+  auto result = candidates;
+  while (candidates) {
+    const auto lane = __builtin_ctzll(candidates);
+    candidates &= candidates - 1;
+    const auto& value = batch[lane];
+    if (value.size() > StringView::kPrefixSize &&
+        !filter.testBytes(value.data(), value.size())) {
+      result &= ~(1ULL << lane);
+    }
+  }
+  return result;
+}
+} // namespace
+
+void Filter::testStringViews(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed) const {
+  for (auto i = 0; i < numValues; ++i) {
+    bits::setBit(passed, i, testBytes(values[i].data(), values[i].size()));
+  }
+}
+
 BigintValuesUsingBitmask::BigintValuesUsingBitmask(
     int64_t min,
     int64_t max,
@@ -230,6 +323,29 @@ bool DoubleValues::testDouble(double value) const {
   return bitmask_[toInt64(value) - toInt64(min_)];
 }
 
+xsimd::batch_bool<double> DoubleValues::testValues(
+    xsimd::batch<double> x) const {
+  constexpr int32_t N = decltype(x)::size;
+  const auto inRange = (x >= xsimd::broadcast<double>(min_)) &
+      (x <= xsimd::broadcast<double>(max_));
+  auto candidates = simd::toBitMask(inRange);
+  if (!candidates) {
+    return inRange;
+  }
+  alignas(decltype(x)::arch_type::alignment()) double data[N];
+  x.store_aligned(data);
+  const auto offset = toInt64(min_);
+  auto result = candidates;
+  while (candidates) {
+    const auto lane = __builtin_ctz(candidates);
+    candidates &= candidates - 1;
+    if (!bitmask_[toInt64(data[lane]) - offset]) {
+      result &= ~(1 << lane);
+    }
+  }
+  return simd::fromBitMask<double>(result);
+}
+
 std::vector<double> DoubleValues::values() const {
   std::vector<double> values;
   for (int i = 0; i < bitmask_.size(); i++) {
@@ -657,6 +773,70 @@ bool BytesRange::testBytes(const char* value, int32_t length) const {
   return true;
 }
 
+void BytesRange::testStringViews(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed) const {
+  auto testOne = [&](const StringView& value) {
+    return testBytes(value.data(), value.size());
+  };
+  if (singleValue_) {
+    const auto word =
+        xsimd::broadcast<int64_t>(sizeAndPrefix(StringView(lower_)));
+    testStringViewBatches<SizeAndPrefixBatch::size>(
+        values,
+        numValues,
+        passed,
+        [&](const StringView* batch) {
+          return testCandidates(
+              *this,
+              batch,
+              simd::toBitMask(loadSizeAndPrefixes(batch) == word));
+        },
+        testOne);
+    return;
+  }
+  // A value whose prefix is below the lower or above the upper bound's fails.
+  // A value whose prefix equals a bound's is decided by testBytes.
+  const auto lower = xsimd::broadcast<int32_t>(
+      lowerUnbounded_ ? 0 : orderedPrefix(StringView(lower_)));
+  const auto upper = xsimd::broadcast<int32_t>(
+      upperUnbounded_ ? 0 : orderedPrefix(StringView(upper_)));
+  testStringViewBatches<PrefixBatch::size>(
+      values,
+      numValues,
+      passed,
+      [&](const StringView* batch) {
+        alignas(PrefixBatch::arch_type::alignment())
+            int32_t prefixes[PrefixBatch::size];
+        for (auto i = 0; i < PrefixBatch::size; ++i) {
+          prefixes[i] = orderedPrefix(batch[i]);
+        }
+        const auto prefix = PrefixBatch::load_aligned(prefixes);
+        uint64_t failed = 0;
+        uint64_t undecided = 0;
+        if (!lowerUnbounded_) {
+          failed |= simd::toBitMask(prefix < lower);
+          undecided |= simd::toBitMask(prefix == lower);
+        }
+        if (!upperUnbounded_) {
+          failed |= simd::toBitMask(prefix > upper);
+          undecided |= simd::toBitMask(prefix == upper);
+        }
+        undecided &= ~failed;
+        auto result = bits::lowMask(PrefixBatch::size) & ~failed & ~undecided;
+        while (undecided) {
+          const auto lane = __builtin_ctzll(undecided);
+          undecided &= undecided - 1;
+          if (testOne(batch[lane])) {
+            result |= 1ULL << lane;
+          }
+        }
+        return result;
+      },
+      testOne);
+}
+
 bool BytesRange::testBytesRange(
     std::optional<std::string_view> min,
     std::optional<std::string_view> max,
@@ -695,6 +875,45 @@ bool BytesRange::testBytesRange(
   return true;
 }
 
+void BytesValues::initSizeAndPrefixes() {
+  for (const auto& value : values_) {
+    sizeAndPrefixSet_.insert(sizeAndPrefix(StringView(value)));
+  }
+  sizeAndPrefixes_.assign(sizeAndPrefixSet_.begin(), sizeAndPrefixSet_.end());
+}
+
+void BytesValues::testStringViews(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed) const {
+  testStringViewBatches<SizeAndPrefixBatch::size>(
+      values,
+      numValues,
+      passed,
+      [&](const StringView* batch) {
+        uint64_t candidates = 0;
+        if (sizeAndPrefixes_.size() <= kMaxSimdValues) {
+          const auto words = loadSizeAndPrefixes(batch);
+          for (auto word : sizeAndPrefixes_) {
+            candidates |=
+                simd::toBitMask(words == xsimd::broadcast<int64_t>(word));
+          }
+        } else {
+          for (auto i = 0; i < SizeAndPrefixBatch::size; ++i) {
+            if (sizeAndPrefixSet_.contains(sizeAndPrefix(batch[i]))) {
+              candidates |= 1ULL << i;
+            }
+          }
+        }
+        return testCandidates(*this, batch, candidates);
+      },
+      [&](const StringView& value) {
+        return sizeAndPrefixSet_.contains(sizeAndPrefix(value)) &&
+            (value.size() <= StringView::kPrefixSize ||
+             testBytes(value.data(), value.size()));
+      });
+}
+
 bool BytesValues::testBytesRange(
     std::optional<std::string_view> min,
     std::optional<std::string_view> max,
@@ -832,6 +1051,28 @@ bool MultiRange::testFloat(float value) const {
   return false;
 }
 
+xsimd::batch_bool<double> MultiRange::testValues(
+    xsimd::batch<double> x) const {
+  // NaNs are not passed to the contained filters.
+  const auto isNan = x != x;
+  x = xsimd::select(isNan, xsimd::broadcast<double>(0), x);
+  auto result = filters_[0]->testValues(x);
+  for (auto i = 1; i < filters_.size(); ++i) {
+    result = result | filters_[i]->testValues(x);
+  }
+  return nanAllowed_ ? result | isNan : result & ~isNan;
+}
+
+xsimd::batch_bool<float> MultiRange::testValues(xsimd::batch<float> x) const {
+  const auto isNan = x != x;
+  x = xsimd::select(isNan, xsimd::broadcast<float>(0), x);
+  auto result = filters_[0]->testValues(x);
+  for (auto i = 1; i < filters_.size(); ++i) {
+    result = result | filters_[i]->testValues(x);
+  }
+  return nanAllowed_ ? result | isNan : result & ~isNan;
+}
+
 bool MultiRange::testBytes(const char* value, int32_t length) const {
   for (const auto& filter : filters_) {
     if (filter->testBytes(value, length)) {
@@ -841,6 +1082,18 @@ bool MultiRange::testBytes(const char* value, int32_t length) const {
   return false;
 }
 
+void MultiRange::testStringViews(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed) const {
+  filters_[0]->testStringViews(values, numValues, passed);
+  std::vector<uint64_t> filterPassed(bits::nwords(numValues));
+  for (auto i = 1; i < filters_.size(); ++i) {
+    filters_[i]->testStringViews(values, numValues, filterPassed.data());
+    bits::orBits(passed, filterPassed.data(), 0, numValues);
+  }
+}
+
 bool MultiRange::testLength(int32_t length) const {
   for (const auto& filter : filters_) {
     if (filter->testLength(length)) {
@@ -1138,6 +1391,7 @@ std::unique_ptr<Filter> BigintRange::mergeWith(const Filter* other) const {
     }
     case FilterKind::kBigintValuesUsingBitmask:
     case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kBigintMultiRange: {
       auto otherMultiRange = dynamic_cast<const BigintMultiRange*>(other);
@@ -1204,6 +1458,7 @@ std::unique_ptr<Filter> BigintValuesUsingHashTable::mergeWith(
       return mergeWith(min, max, other);
     }
     case FilterKind::kBigintValuesUsingBitmask:
+    case FilterKind::kBigintBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kBigintMultiRange: {
       auto otherMultiRange = dynamic_cast<const BigintMultiRange*>(other);
@@ -1303,6 +1558,8 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
 
       return mergeWith(min, max, other);
     }
+    case FilterKind::kBigintBloomFilter:
+      return other->mergeWith(this);
     case FilterKind::kBigintMultiRange: {
       auto otherMultiRange = dynamic_cast<const BigintMultiRange*>(other);
 
@@ -1364,7 +1621,8 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
     case FilterKind::kBigintValuesUsingHashTable:
     case FilterKind::kBigintValuesUsingBitmask:
     case FilterKind::kBigintRange:
-    case FilterKind::kBigintMultiRange: {
+    case FilterKind::kBigintMultiRange:
+    case FilterKind::kBigintBloomFilter: {
       return other->mergeWith(this);
     }
     case FilterKind::kNegatedBigintValuesUsingHashTable: {
@@ -1405,7 +1663,8 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingBitmask::mergeWith(
     case FilterKind::kBigintValuesUsingHashTable:
     case FilterKind::kBigintValuesUsingBitmask:
     case FilterKind::kBigintRange:
-    case FilterKind::kBigintMultiRange: {
+    case FilterKind::kBigintMultiRange:
+    case FilterKind::kBigintBloomFilter: {
       return other->mergeWith(this);
     }
     case FilterKind::kNegatedBigintValuesUsingHashTable: {
@@ -1444,7 +1703,8 @@ std::unique_ptr<Filter> BigintMultiRange::mergeWith(const Filter* other) const {
     }
     case FilterKind::kBigintRange:
     case FilterKind::kBigintValuesUsingBitmask:
-    case FilterKind::kBigintValuesUsingHashTable: {
+    case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintBloomFilter: {
       return other->mergeWith(this);
     }
     case FilterKind::kBigintMultiRange: {
@@ -1500,6 +1760,117 @@ std::unique_ptr<Filter> BigintMultiRange::mergeWith(const Filter* other) const {
   }
 }
 
+xsimd::batch_bool<int64_t> BigintBloomFilter::testValues(
+    xsimd::batch<int64_t> x) const {
+  auto outOfRange = (x < xsimd::broadcast<int64_t>(min_)) |
+      (x > xsimd::broadcast<int64_t>(max_));
+  uint16_t candidates =
+      simd::allSetBitMask<int64_t>() ^ simd::toBitMask(outOfRange);
+  if (!candidates) {
+    return xsimd::batch_bool<int64_t>(false);
+  }
+  // Only the lanes in range are looked up in the BloomFilter.
+  constexpr int kAlign = xsimd::default_arch::alignment();
+  constexpr int kArraySize = xsimd::batch<int64_t>::size;
+  alignas(kAlign) int64_t valuesArray[kArraySize];
+  x.store_aligned(valuesArray);
+  uint16_t hits = 0;
+  while (candidates) {
+    auto lane = bits::getAndClearLastSetBit(candidates);
+    if (bloomFilter_->mayContain(valuesArray[lane])) {
+      hits |= 1 << lane;
+    }
+  }
+  return simd::fromBitMask<int64_t>(hits);
+}
+
+xsimd::batch_bool<int32_t> BigintBloomFilter::testValues(
+    xsimd::batch<int32_t> x) const {
+  auto first = simd::toBitMask(testValues(simd::getHalf<int64_t, 0>(x)));
+  auto second = simd::toBitMask(testValues(simd::getHalf<int64_t, 1>(x)));
+  return simd::fromBitMask<int32_t>(
+      first | (second << xsimd::batch<int64_t>::size));
+}
+
+std::unique_ptr<Filter> BigintBloomFilter::mergeWith(
+    const Filter* other) const {
+  switch (other->kind()) {
+    case FilterKind::kAlwaysTrue:
+    case FilterKind::kAlwaysFalse:
+    case FilterKind::kIsNull:
+      return other->mergeWith(this);
+    case FilterKind::kIsNotNull:
+      return std::make_unique<BigintBloomFilter>(*this, false);
+    case FilterKind::kBigintRange: {
+      auto otherRange = static_cast<const BigintRange*>(other);
+      auto min = std::max(min_, otherRange->lower());
+      auto max = std::min(max_, otherRange->upper());
+
+      return mergeWith(min, max, other);
+    }
+    case FilterKind::kBigintBloomFilter: {
+      // Keeps only the BloomFilter of 'this'.
+      auto otherBloom = static_cast<const BigintBloomFilter*>(other);
+      auto min = std::max(min_, otherBloom->min_);
+      auto max = std::min(max_, otherBloom->max_);
+
+      return mergeWith(min, max, other);
+    }
+    case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBitmask: {
+      std::vector<int64_t> values;
+      if (other->kind() == FilterKind::kBigintValuesUsingHashTable) {
+        auto otherValues =
+            static_cast<const BigintValuesUsingHashTable*>(other);
+        values = otherValues->values();
+      } else {
+        auto otherValues = static_cast<const BigintValuesUsingBitmask*>(other);
+        values = otherValues->values();
+      }
+      std::vector<int64_t> valuesToKeep;
+      valuesToKeep.reserve(values.size());
+      for (auto value : values) {
+        if (testInt64(value)) {
+          valuesToKeep.push_back(value);
+        }
+      }
+
+      bool bothNullAllowed = nullAllowed_ && other->testNull();
+      return createBigintValues(valuesToKeep, bothNullAllowed);
+    }
+    case FilterKind::kBigintMultiRange:
+    case FilterKind::kNegatedBigintValuesUsingHashTable:
+    case FilterKind::kNegatedBigintValuesUsingBitmask:
+      // These do not combine with a BloomFilter. 'other' passes a superset of
+      // the values passing both filters.
+      return other->clone(nullAllowed_ && other->testNull());
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+std::unique_ptr<Filter> BigintBloomFilter::mergeWith(
+    int64_t min,
+    int64_t max,
+    const Filter* other) const {
+  bool bothNullAllowed = nullAllowed_ && other->testNull();
+
+  if (max < min) {
+    return nullOrFalse(bothNullAllowed);
+  }
+
+  if (max == min) {
+    if (testInt64(min) && other->testInt64(min)) {
+      return std::make_unique<BigintRange>(min, min, bothNullAllowed);
+    }
+
+    return nullOrFalse(bothNullAllowed);
+  }
+
+  return std::make_unique<BigintBloomFilter>(
+      min, max, bloomFilter_, bothNullAllowed);
+}
+
 namespace {
 // compareResult = left < right for upper, right < left for lower
 bool mergeExclusive(int compareResult, bool left, bool right) {
@@ -24,6 +24,7 @@
 #include <folly/Range.h>
 #include <folly/container/F14Set.h>
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/type/StringView.h"
@@ -49,6 +50,7 @@ enum class FilterKind {
   kNegatedBytesValues,
   kBigintMultiRange,
   kMultiRange,
+  kBigintBloomFilter,
 };
 
 /**
@@ -164,6 +166,15 @@ class Filter {
     VELOX_UNSUPPORTED("{}: testBytes() is not supported.", toString());
   }
 
+  // Tests 'numValues' strings at a time. Sets bit 'i' of 'passed' if
+  // 'values[i]' passes and clears it otherwise. The string filters decide
+  // most values on the size and the inline prefix of the StringView and
+  // compare the full string only for the remaining candidates.
+  virtual void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const;
+
   // Returns true if it is useful to call testLength before other
   // tests. This should be true for string IN and equals because it is
   // possible to fail these based on the length alone. This would
@@ -779,6 +790,99 @@ class BigintValuesUsingBitmask final : public Filter {
   const int64_t max_;
 };
 
+/// Approximate IN-list filter for integral data types. Passes all the values
+/// inserted into the BloomFilter and, with a small false positive rate, some
+/// other values between 'min' and 'max'. Used for dynamic filters made from
+/// the build side of a hash join, where the join itself drops the false
+/// positives. The BloomFilter is shared between copies of the filter.
+class BigintBloomFilter final : public Filter {
+ public:
+  /// @param min Minimum value.
+  /// @param max Maximum value.
+  /// @param bloomFilter Contains all values that pass the filter.
+  /// @param nullAllowed Null values are passing the filter if true.
+  BigintBloomFilter(
+      int64_t min,
+      int64_t max,
+      std::shared_ptr<const BloomFilter<>> bloomFilter,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBigintBloomFilter),
+        min_(min),
+        max_(max),
+        bloomFilter_(std::move(bloomFilter)) {
+    VELOX_CHECK_LE(min_, max_);
+    VELOX_CHECK_NOT_NULL(bloomFilter_);
+  }
+
+  BigintBloomFilter(const BigintBloomFilter& other, bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBigintBloomFilter),
+        min_(other.min_),
+        max_(other.max_),
+        bloomFilter_(other.bloomFilter_) {}
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    if (nullAllowed) {
+      return std::make_unique<BigintBloomFilter>(*this, nullAllowed.value());
+    } else {
+      return std::make_unique<BigintBloomFilter>(*this);
+    }
+  }
+
+  bool testInt64(int64_t value) const final {
+    return value >= min_ && value <= max_ && bloomFilter_->mayContain(value);
+  }
+
+  xsimd::batch_bool<int64_t> testValues(xsimd::batch<int64_t> x) const final;
+  xsimd::batch_bool<int32_t> testValues(xsimd::batch<int32_t> x) const final;
+  xsimd::batch_bool<int16_t> testValues(xsimd::batch<int16_t> x) const final {
+    return Filter::testValues(x);
+  }
+
+  bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final {
+    if (hasNull && nullAllowed_) {
+      return true;
+    }
+    if (min == max) {
+      return testInt64(min);
+    }
+    return !(min > max_ || max < min_);
+  }
+
+  /// The result passes all the values that pass both filters. Unless 'other'
+  /// is a range, an IN-list or an IS [NOT] NULL filter, the result may pass
+  /// some more values that pass 'other' but not 'this'.
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  int64_t min() const {
+    return min_;
+  }
+
+  int64_t max() const {
+    return max_;
+  }
+
+  const std::shared_ptr<const BloomFilter<>>& bloomFilter() const {
+    return bloomFilter_;
+  }
+
+  std::string toString() const final {
+    return fmt::format(
+        "BigintBloomFilter: [{}, {}] {}",
+        min_,
+        max_,
+        nullAllowed_ ? "with nulls" : "no nulls");
+  }
+
+ private:
+  std::unique_ptr<Filter>
+  mergeWith(int64_t min, int64_t max, const Filter* other) const;
+
+  const int64_t min_;
+  const int64_t max_;
+  const std::shared_ptr<const BloomFilter<>> bloomFilter_;
+};
+
 // NOT IN-list filter for integral data types. Implemented as a hash table. Good
 // for large number of rejected values that do not fit within a small range.
 class NegatedBigintValuesUsingHashTable final : public Filter {
@@ -935,6 +1039,8 @@ class DoubleValues final : public Filter {
 
   bool testDouble(double value) const final;
 
+  xsimd::batch_bool<double> testValues(xsimd::batch<double> x) const final;
+
   bool testDoubleRange(double min, double max, bool hasNull) const final;
 
   std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
@@ -1318,6 +1424,11 @@ class BytesRange final : public AbstractRange {
 
   bool testBytes(const char* value, int32_t length) const final;
 
+  void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const final;
+
   bool testBytesRange(
       std::optional<std::string_view> min,
       std::optional<std::string_view> max,
@@ -1382,6 +1493,7 @@ class BytesValues final : public Filter {
 
     lower_ = *std::min_element(values_.begin(), values_.end());
     upper_ = *std::max_element(values_.begin(), values_.end());
+    initSizeAndPrefixes();
   }
 
   BytesValues(const BytesValues& other, bool nullAllowed)
@@ -1389,7 +1501,9 @@ class BytesValues final : public Filter {
         lower_(other.lower_),
         upper_(other.upper_),
         values_(other.values_),
-        lengths_(other.lengths_) {}
+        lengths_(other.lengths_),
+        sizeAndPrefixes_(other.sizeAndPrefixes_),
+        sizeAndPrefixSet_(other.sizeAndPrefixSet_) {}
 
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
@@ -1409,6 +1523,11 @@ class BytesValues final : public Filter {
         values_.contains(std::string(value, length));
   }
 
+  void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const final;
+
   bool testBytesRange(
       std::optional<std::string_view> min,
       std::optional<std::string_view> max,
@@ -1421,10 +1540,20 @@ class BytesValues final : public Filter {
   }
 
  private:
+  // Up to this many values, testStringViews compares the size and prefix
+  // words with SIMD instead of looking them up in 'sizeAndPrefixSet_'.
+  static constexpr int32_t kMaxSimdValues = 8;
+
+  void initSizeAndPrefixes();
+
   std::string lower_;
   std::string upper_;
   folly::F14FastSet<std::string> values_;
   folly::F14FastSet<uint32_t> lengths_;
+  // The distinct first words of the StringViews of 'values_', i.e. the size
+  // and the first StringView::kPrefixSize bytes.
+  std::vector<int64_t> sizeAndPrefixes_;
+  folly::F14FastSet<int64_t> sizeAndPrefixSet_;
 };
 
 /// Represents a combination of two of more range filters on integral types with
@@ -1501,6 +1630,14 @@ class NegatedBytesValues final : public Filter {
     return !nonNegated_->testBytes(value, length);
   }
 
+  void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const final {
+    nonNegated_->testStringViews(values, numValues, passed);
+    bits::negate(reinterpret_cast<char*>(passed), numValues);
+  }
+
   bool testBytesRange(
       std::optional<std::string_view> min,
       std::optional<std::string_view> max,
@@ -1548,8 +1685,19 @@ class MultiRange final : public Filter {
 
   bool testFloat(float value) const final;
 
+  // The batch methods make one virtual call per contained filter and batch
+  // and OR the results.
+  xsimd::batch_bool<double> testValues(xsimd::batch<double> x) const final;
+
+  xsimd::batch_bool<float> testValues(xsimd::batch<float> x) const final;
+
   bool testBytes(const char* value, int32_t length) const final;
 
+  void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const final;
+
   bool testLength(int32_t length) const final;
 
   bool testBytesRange(
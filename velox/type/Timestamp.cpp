@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 #include "velox/type/Timestamp.h"
+#include <atomic>
 #include <chrono>
+#include <vector>
 #include "velox/common/base/Exceptions.h"
 #include "velox/external/date/tz.h"
 #include "velox/type/tz/TimeZoneMap.h"
@@ -22,13 +24,49 @@
 namespace facebook::velox {
 namespace {
 
+// The UTC offset of a time zone between two of its transitions.
+struct ZoneOffset {
+  const date::time_zone* zone{nullptr};
+  int64_t begin{0};
+  int64_t end{0};
+  int64_t offset{0};
+};
+
 inline int64_t deltaWithTimezone(const date::time_zone& zone, int64_t seconds) {
-  auto tp = std::chrono::time_point<std::chrono::system_clock>(
-      std::chrono::seconds(seconds));
-  auto epoch = zone.to_local(tp).time_since_epoch();
-  int64_t delta =
-      seconds - std::chrono::duration_cast<std::chrono::seconds>(epoch).count();
-  return delta;
+  // The timestamps converted one after the other are usually in the same
+  // zone and between the same transitions, so that the offset of the
+  // previous conversion on the thread applies. Otherwise the transitions of
+  // the zone are searched.
+  thread_local ZoneOffset cached;
+  if (cached.zone != &zone || seconds < cached.begin ||
+      seconds >= cached.end) {
+    auto info = zone.get_info(
+        date::sys_time<std::chrono::seconds>(std::chrono::seconds(seconds)));
+    cached.zone = &zone;
+    cached.begin = info.begin.time_since_epoch().count();
+    cached.end = info.end.time_since_epoch().count();
+    cached.offset = info.offset.count();
+  }
+  return -cached.offset;
+}
+
+// Returns the zone of a time zone ID above 1680. The zones are looked up by
+// name on first use and kept, since locate_zone() searches all zones by
+// name. The IDs of the time zone database are below kNumCachedZones.
+const date::time_zone& zoneOf(int16_t tzID) {
+  constexpr int16_t kNumCachedZones = 4096;
+  if (tzID < 0 || tzID >= kNumCachedZones) {
+    return *date::locate_zone(util::getTimeZoneName(tzID));
+  }
+  static std::vector<std::atomic<const date::time_zone*>> zones(
+      kNumCachedZones);
+  auto& entry = zones[tzID];
+  auto* zone = entry.load(std::memory_order_acquire);
+  if (zone == nullptr) {
+    zone = date::locate_zone(util::getTimeZoneName(tzID));
+    entry.store(zone, std::memory_order_release);
+  }
+  return *zone;
 }
 
 // Assuming tzID is in [1, 1680] range.
@@ -65,7 +103,7 @@ void Timestamp::toGMT(int16_t tzID) {
     seconds_ -= getPrestoTZOffsetInSeconds(tzID);
   } else {
     // Other ids go this path.
-    toGMT(*date::locate_zone(util::getTimeZoneName(tzID)));
+    toGMT(zoneOf(tzID));
   }
 }
 
@@ -80,7 +118,7 @@ void Timestamp::toTimezone(int16_t tzID) {
     seconds_ += getPrestoTZOffsetInSeconds(tzID);
   } else {
     // Other ids go this path.
-    toTimezone(*date::locate_zone(util::getTimeZoneName(tzID)));
+    toTimezone(zoneOf(tzID));
   }
 }
 
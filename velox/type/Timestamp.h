@@ -51,6 +51,21 @@ struct Timestamp {
     return seconds_ * 1'000'000 + nanos_ / 1'000;
   }
 
+  // Range of the seconds of the timestamps that toNanos() can represent,
+  // about 292 years around the epoch.
+  static constexpr int64_t kMinNanosSeconds = -9'223'372'036;
+  static constexpr int64_t kMaxNanosSeconds = 9'223'372'035;
+
+  bool fitsNanos() const {
+    return seconds_ >= kMinNanosSeconds && seconds_ <= kMaxNanosSeconds;
+  }
+
+  // Returns the nanoseconds since the epoch in one int64_t, which orders the
+  // same as the timestamp. Requires fitsNanos().
+  int64_t toNanos() const {
+    return seconds_ * 1'000'000'000 + static_cast<int64_t>(nanos_);
+  }
+
   static Timestamp fromMillis(int64_t millis) {
     if (millis >= 0 || millis % 1'000 == 0) {
       return Timestamp(millis / 1'000, (millis % 1'000) * 1'000'000);
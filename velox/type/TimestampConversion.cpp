@@ -145,12 +145,15 @@ bool isValidDate(int32_t year, int32_t month, int32_t day) {
   return isLeapYear(year) ? day <= kLeapDays[month] : day <= kNormalDays[month];
 }
 
+// Returns false if 'buf' is not a date. Throws if it is a date out of range
+// unless 'checkDate' is true, in which case it returns false.
 bool tryParseDateString(
     const char* buf,
     size_t len,
     size_t& pos,
     int32_t& daysSinceEpoch,
-    bool strict) {
+    bool strict,
+    bool checkDate = false) {
   pos = 0;
   if (len == 0) {
     return false;
@@ -258,6 +261,9 @@ bool tryParseDateString(
     }
   }
 
+  if (checkDate && !isValidDate(year, month, day)) {
+    return false;
+  }
   daysSinceEpoch = fromDate(year, month, day);
   return true;
 }
@@ -453,6 +459,11 @@ int32_t fromDateString(const char* str, size_t len) {
   return daysSinceEpoch;
 }
 
+bool tryFromDateString(const char* str, size_t len, int32_t& daysSinceEpoch) {
+  size_t pos = 0;
+  return tryParseDateString(str, len, pos, daysSinceEpoch, true, true);
+}
+
 int64_t
 fromTime(int32_t hour, int32_t minute, int32_t second, int32_t microseconds) {
   int64_t result;
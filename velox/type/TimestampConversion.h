@@ -58,6 +58,10 @@ inline int32_t fromDateString(const StringView& str) {
   return fromDateString(str.data(), str.size());
 }
 
+/// Same as fromDateString() but returns false instead of throwing if the
+/// format or date is invalid.
+bool tryFromDateString(const char* buf, size_t len, int32_t& daysSinceEpoch);
+
 /// Time conversions.
 
 /// Returns the cumulative number of microseconds.
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/type/DecimalUtil.h"
 #include "velox/type/LongDecimal.h"
 
 namespace facebook::velox {
@@ -38,5 +40,48 @@ TEST(DecimalTest, toString) {
       std::to_string(-kMax - 1), "-170141183460469231731687303715884105728");
 }
 
+TEST(DecimalTest, rescale) {
+  EXPECT_EQ(DecimalUtil::rescale(123, 1, 10, 3), 12300);
+  // Rounds half away from zero.
+  EXPECT_EQ(DecimalUtil::rescale(125, 2, 10, 1), 13);
+  EXPECT_EQ(DecimalUtil::rescale(-125, 2, 10, 1), -13);
+  EXPECT_EQ(DecimalUtil::rescale(124, 2, 10, 1), 12);
+  EXPECT_EQ(DecimalUtil::rescale(-149, 2, 10, 0), -1);
+
+  VELOX_ASSERT_THROW(
+      DecimalUtil::rescale(12345, 2, 4, 2),
+      "Decimal overflow: 123.45 does not fit DECIMAL(4, 2)");
+  VELOX_ASSERT_THROW(
+      DecimalUtil::rescale(DecimalUtil::kPowersOfTen[37], 0, 38, 2),
+      "Decimal overflow");
+}
+
+TEST(DecimalTest, compare) {
+  EXPECT_EQ(DecimalUtil::compare(150, 2, 15, 1), 0);
+  EXPECT_LT(DecimalUtil::compare(149, 2, 15, 1), 0);
+  EXPECT_GT(DecimalUtil::compare(-14, 1, -150, 2), 0);
+  // The rescaled left side overflows int128_t.
+  const auto large = DecimalUtil::kPowersOfTen[37];
+  EXPECT_GT(DecimalUtil::compare(large, 0, 1, 10), 0);
+  EXPECT_LT(DecimalUtil::compare(-large, 0, 1, 10), 0);
+  EXPECT_LT(DecimalUtil::compare(1, 10, large, 0), 0);
+  EXPECT_GT(DecimalUtil::compare(1, 10, -large, 0), 0);
+}
+
+TEST(DecimalTest, divideRoundHalfUp) {
+  EXPECT_EQ(DecimalUtil::divideRoundHalfUp(7, 2), 4);
+  EXPECT_EQ(DecimalUtil::divideRoundHalfUp(-7, 2), -4);
+  EXPECT_EQ(DecimalUtil::divideRoundHalfUp(7, -2), -4);
+  EXPECT_EQ(DecimalUtil::divideRoundHalfUp(10, 3), 3);
+  EXPECT_EQ(DecimalUtil::divideRoundHalfUp(-10, 3), -3);
+}
+
+TEST(DecimalTest, unscaledToString) {
+  EXPECT_EQ(DecimalUtil::toString(-150, 2), "-1.50");
+  EXPECT_EQ(DecimalUtil::toString(5, 3), "0.005");
+  EXPECT_EQ(DecimalUtil::toString(-5, 1), "-0.5");
+  EXPECT_EQ(DecimalUtil::toString(42, 0), "42");
+}
+
 } // namespace
 } // namespace facebook::velox
@@ -507,6 +507,53 @@ TEST(FilterTest, bigintMultiRange) {
   EXPECT_FALSE(filter->testInt64Range(15, 45, true));
 }
 
+TEST(FilterTest, bigintBloomFilter) {
+  std::vector<int64_t> numbers;
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(1000);
+  for (auto i = 0; i < 1000; ++i) {
+    numbers.push_back(i * 7);
+    bloomFilter->insert(i * 7);
+  }
+  auto filter =
+      std::make_unique<BigintBloomFilter>(0, 999 * 7, bloomFilter, false);
+
+  for (auto number : numbers) {
+    EXPECT_TRUE(filter->testInt64(number));
+  }
+  EXPECT_FALSE(filter->testNull());
+  EXPECT_FALSE(filter->testInt64(-7));
+  EXPECT_FALSE(filter->testInt64(1000 * 7));
+
+  // Few of the values in range that were not inserted pass.
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < 999 * 7; ++i) {
+    if (i % 7 != 0 && filter->testInt64(i)) {
+      ++numFalsePositives;
+    }
+  }
+  EXPECT_LT(numFalsePositives, 999 * 6 / 20);
+
+  EXPECT_TRUE(filter->testInt64Range(-10, 10, false));
+  EXPECT_TRUE(filter->testInt64Range(7, 7, false));
+  EXPECT_FALSE(filter->testInt64Range(-10, -1, false));
+  EXPECT_FALSE(filter->testInt64Range(7000, 8000, true));
+
+  auto verify = [&](int64_t x) { return filter->testInt64(x); };
+  int64_t outOfRange[] = {-100, -20000, 0x10000000, 0x20000000};
+  checkSimd(filter.get(), outOfRange, verify);
+  applySimdTestToVector(numbers, *filter, verify);
+  std::vector<int32_t> numbers32(numbers.begin(), numbers.end());
+  applySimdTestToVector(numbers32, *filter, verify);
+
+  auto clone = filter->clone(true);
+  EXPECT_TRUE(clone->testNull());
+  for (auto number : numbers) {
+    EXPECT_TRUE(clone->testInt64(number));
+  }
+  EXPECT_EQ("BigintBloomFilter: [0, 6993] no nulls", filter->toString());
+}
+
 TEST(FilterTest, boolValue) {
   auto boolValueTrue = boolEqual(true);
   EXPECT_TRUE(boolValueTrue->testBool(true));
@@ -957,6 +1004,94 @@ TEST(FilterTest, multiRangeWithNaNs) {
   EXPECT_TRUE(filter->testDouble(1.3));
 }
 
+TEST(FilterTest, multiRangeSimd) {
+  double doubles[] = {1.1, 1.2, std::nan("nan"), 1.3};
+  float floats[] = {
+      1.1, 1.2, std::nanf("nan"), 1.3, 1.0, std::nanf("nan"), 1.2, 5};
+  for (auto nanAllowed : {false, true}) {
+    auto filter = orFilter(
+        lessThanDouble(1.2), greaterThanDouble(1.2), false, nanAllowed);
+    checkSimd(filter.get(), doubles, [&](double x) {
+      return filter->testDouble(x);
+    });
+    filter = orFilter(
+        lessThanFloat(1.2), greaterThanFloat(1.2), false, nanAllowed);
+    checkSimd(
+        filter.get(), floats, [&](float x) { return filter->testFloat(x); });
+  }
+}
+
+TEST(FilterTest, doubleValuesSimd) {
+  DoubleValues filter(1, 10, {1, 5, 10}, false);
+  double values[] = {0, 1, 4, 5, 7, 10, 11, -3, 1.2};
+  checkSimd(&filter, values, [&](double x) { return filter.testDouble(x); });
+  checkSimd(
+      &filter, values + 4, [&](double x) { return filter.testDouble(x); });
+}
+
+TEST(FilterTest, testStringViews) {
+  std::vector<std::string> strings = {
+      "",
+      "a",
+      "ab",
+      "abc",
+      "abcd",
+      "abce",
+      "abcde",
+      "abcdefghijkl",
+      "abcdefghijklm",
+      "abcdefghijklmnopq",
+      "abcdefghijklmnopr",
+      std::string("ab\0", 3),
+      "b",
+      "dragon",
+      "dragonfly",
+      "\xff\xfe",
+      "zzzzzzzzzzzzzzzz"};
+  std::vector<StringView> views;
+  for (auto i = 0; i < 50; ++i) {
+    auto& string = strings[(i * 7) % strings.size()];
+    views.emplace_back(string.data(), string.size());
+  }
+
+  auto verify = [&](const Filter& filter) {
+    for (auto numValues : {0, 3, 8, 33, 50}) {
+      std::vector<uint64_t> passed(bits::nwords(numValues), ~0ULL);
+      filter.testStringViews(views.data(), numValues, passed.data());
+      for (auto i = 0; i < numValues; ++i) {
+        EXPECT_EQ(
+            filter.testBytes(views[i].data(), views[i].size()),
+            bits::isBitSet(passed.data(), i))
+            << filter.toString() << " '" << views[i].str() << "'";
+      }
+    }
+  };
+
+  verify(*equal("abcd"));
+  verify(*equal("abcdefghijklmnopq"));
+  verify(*equal(""));
+  verify(*between("abcd", "abcd"));
+  verify(*between("ab", "ab"));
+  verify(*between("abcdefghijklmnopq", "abcdefghijklmnopq"));
+  verify(*between("ab", "abcdefghijklm"));
+  verify(*between("abc", "abcd"));
+  verify(*lessThan("abcd"));
+  verify(*lessThanOrEqual("abcd"));
+  verify(*greaterThan("abc"));
+  verify(*greaterThanOrEqual(""));
+  verify(*greaterThan(""));
+  verify(*lessThan("\xff\xff"));
+  verify(*in({"a", "abcd", "abcdefghijklmnopq", "dragon"}));
+  std::vector<std::string> manyValues = strings;
+  for (auto i = 0; i < 20; ++i) {
+    manyValues.push_back(fmt::format("abcd{}", i));
+  }
+  manyValues.erase(manyValues.begin() + 7);
+  verify(*in(manyValues));
+  verify(*notIn({"a", "abcde", "abcdefghijklmnopr"}));
+  verify(*orFilter(between("abc", "abcd"), greaterThanOrEqual("dragon")));
+}
+
 TEST(FilterTest, createBigintValues) {
   // Small number of values from a very large range.
   {
@@ -1201,6 +1336,58 @@ TEST(FilterTest, mergeWithBigint) {
   }
 }
 
+TEST(FilterTest, mergeWithBigintBloomFilter) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(100);
+  for (auto i = -50; i < 50; ++i) {
+    bloomFilter->insert(i * 3);
+  }
+  std::vector<std::unique_ptr<Filter>> bloomFilters;
+  bloomFilters.push_back(
+      std::make_unique<BigintBloomFilter>(-150, 147, bloomFilter, false));
+  bloomFilters.push_back(
+      std::make_unique<BigintBloomFilter>(-150, 147, bloomFilter, true));
+  bloomFilters.push_back(
+      std::make_unique<BigintBloomFilter>(-30, 30, bloomFilter, false));
+
+  std::vector<std::unique_ptr<Filter>> filters;
+  addUntypedFilters(filters);
+  filters.push_back(equal(123));
+  filters.push_back(equal(-3, true));
+  filters.push_back(between(-7, 13));
+  filters.push_back(between(-7, 13, true));
+  filters.push_back(between(150, 500));
+  filters.push_back(in({1, 2, 3, 67'000'000'000, 134}));
+  filters.push_back(in({-9, -6, -5, 12, 13}, true));
+  filters.push_back(in({1, 2, 3, 67, 10'134}));
+
+  // Merging with a range, an IN-list or an IS [NOT] NULL filter is exact.
+  for (const auto& left : bloomFilters) {
+    for (const auto& right : filters) {
+      testMergeWithBigint(left.get(), right.get());
+      testMergeWithBigint(right.get(), left.get());
+    }
+    for (const auto& right : bloomFilters) {
+      testMergeWithBigint(left.get(), right.get());
+    }
+  }
+
+  // Other filters are kept as is.
+  std::vector<std::unique_ptr<Filter>> otherFilters;
+  otherFilters.push_back(notIn({3, 6, 9}));
+  otherFilters.push_back(bigintOr(between(1, 10), between(100, 120)));
+  for (const auto& other : otherFilters) {
+    auto merged = bloomFilters[0]->mergeWith(other.get());
+    for (int64_t i = -1'000; i <= 1'000; i++) {
+      ASSERT_EQ(merged->testInt64(i), other->testInt64(i));
+    }
+    merged = other->mergeWith(bloomFilters[0].get());
+    for (int64_t i = -1'000; i <= 1'000; i++) {
+      ASSERT_EQ(merged->testInt64(i), other->testInt64(i));
+    }
+  }
+}
+
 TEST(FilterTest, mergeWithDouble) {
   std::vector<std::unique_ptr<Filter>> filters;
   addUntypedFilters(filters);
@@ -259,6 +259,31 @@ TEST(DateTimeUtilTest, toTimezone) {
   EXPECT_EQ(ts, fromTimestampString("2021-03-14 17:00:00"));
 }
 
+// Converts timestamps an hour apart over a year, alternating between two
+// zones, so that the conversions cross transitions and switch zones.
+TEST(DateTimeUtilTest, toTimezoneAcrossTransitions) {
+  auto laId = util::getTimeZoneID("America/Los_Angeles");
+  auto* laZone = date::locate_zone("America/Los_Angeles");
+  auto* moscowZone = date::locate_zone("Europe/Moscow");
+  auto start = fromTimestampString("2011-01-01 00:00:00").getSeconds();
+  for (auto hour = 0; hour < 365 * 24; ++hour) {
+    auto seconds = start + hour * 3'600;
+    auto* zone = hour % 5 == 0 ? moscowZone : laZone;
+    std::chrono::seconds localSeconds =
+        zone->to_local(date::sys_seconds(std::chrono::seconds(seconds)))
+            .time_since_epoch();
+
+    Timestamp ts(seconds, 0);
+    ts.toTimezone(*zone);
+    ASSERT_EQ(localSeconds.count(), ts.getSeconds()) << seconds;
+    if (zone == laZone) {
+      Timestamp fromId(seconds, 0);
+      fromId.toTimezone(laId);
+      ASSERT_EQ(ts, fromId);
+    }
+  }
+}
+
 TEST(DateTimeUtilTest, toGMTFromID) {
   // The GMT time when LA gets to "1970-01-01 00:00:00" (8h ahead).
   auto ts = fromTimestampString("1970-01-01 00:00:00");
@@ -49,5 +49,22 @@ TEST(TimestampTest, fromMillisAndMicros) {
   EXPECT_EQ(ts3, Timestamp::fromMicros(ts3.toMicros()));
 }
 
+TEST(TimestampTest, toNanos) {
+  EXPECT_EQ(0, Timestamp(0, 0).toNanos());
+  EXPECT_EQ(1'000'000'001, Timestamp(1, 1).toNanos());
+  EXPECT_EQ(-999'999'999, Timestamp(-1, 1).toNanos());
+
+  Timestamp max(Timestamp::kMaxNanosSeconds, 999'999'999);
+  EXPECT_TRUE(max.fitsNanos());
+  EXPECT_EQ(9'223'372'035'999'999'999, max.toNanos());
+  Timestamp min(Timestamp::kMinNanosSeconds, 0);
+  EXPECT_TRUE(min.fitsNanos());
+  EXPECT_EQ(-9'223'372'036'000'000'000, min.toNanos());
+  EXPECT_FALSE(Timestamp(Timestamp::kMaxNanosSeconds + 1, 0).fitsNanos());
+  EXPECT_FALSE(Timestamp(Timestamp::kMinNanosSeconds - 1, 0).fitsNanos());
+
+  EXPECT_LT(Timestamp(-2, 999'999'999).toNanos(), Timestamp(-1, 0).toNanos());
+}
+
 } // namespace
 } // namespace facebook::velox
@@ -15,6 +15,9 @@
  */
 
 #include "velox/vector/BaseVector.h"
+
+#include <folly/container/F14Set.h>
+
 #include "velox/type/StringView.h"
 #include "velox/type/Type.h"
 #include "velox/type/Variant.h"
@@ -714,6 +717,109 @@ uint64_t BaseVector::estimateFlatSize() const {
   return length_ * avgRowSize;
 }
 
+uint64_t BaseVector::estimateFlatSize(const SelectivityVector& rows) const {
+  if (length_ == 0) {
+    return 0;
+  }
+  auto numRows = rows.countSelected();
+  if (numRows == length_) {
+    return estimateFlatSize();
+  }
+  return estimateFlatSize() * numRows / length_;
+}
+
+namespace {
+// Adds the capacity of the buffers of 'vector' and its children that are not
+// in 'seen' to 'size' and adds the buffers to 'seen'.
+void addUniqueRetainedSize(
+    const BaseVector& vector,
+    folly::F14FastSet<const Buffer*>& seen,
+    uint64_t& size) {
+  auto add = [&](const BufferPtr& buffer) {
+    if (buffer && seen.insert(buffer.get()).second) {
+      size += buffer->capacity();
+    }
+  };
+  switch (vector.encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      add(vector.nulls());
+      add(vector.values());
+      if (vector.typeKind() == TypeKind::VARCHAR ||
+          vector.typeKind() == TypeKind::VARBINARY) {
+        for (auto& buffer :
+             vector.asUnchecked<FlatVector<StringView>>()->stringBuffers()) {
+          add(buffer);
+        }
+      }
+      break;
+    case VectorEncoding::Simple::BIASED:
+      add(vector.nulls());
+      add(vector.values());
+      break;
+    case VectorEncoding::Simple::DICTIONARY:
+    case VectorEncoding::Simple::SEQUENCE:
+      add(vector.nulls());
+      add(vector.wrapInfo());
+      addUniqueRetainedSize(*vector.valueVector(), seen, size);
+      break;
+    case VectorEncoding::Simple::CONSTANT:
+      if (vector.valueVector()) {
+        addUniqueRetainedSize(*vector.valueVector(), seen, size);
+      } else {
+        size += vector.retainedSize();
+      }
+      break;
+    case VectorEncoding::Simple::LAZY:
+      if (isLazyNotLoaded(vector)) {
+        add(vector.nulls());
+      } else {
+        addUniqueRetainedSize(*vector.loadedVector(), seen, size);
+      }
+      break;
+    case VectorEncoding::Simple::ROW:
+      add(vector.nulls());
+      for (auto& child : vector.asUnchecked<RowVector>()->children()) {
+        if (child) {
+          addUniqueRetainedSize(*child, seen, size);
+        }
+      }
+      break;
+    case VectorEncoding::Simple::ARRAY: {
+      auto array = vector.asUnchecked<ArrayVector>();
+      add(vector.nulls());
+      add(array->offsets());
+      add(array->sizes());
+      addUniqueRetainedSize(*array->elements(), seen, size);
+      break;
+    }
+    case VectorEncoding::Simple::MAP: {
+      auto map = vector.asUnchecked<MapVector>();
+      add(vector.nulls());
+      add(map->offsets());
+      add(map->sizes());
+      addUniqueRetainedSize(*map->mapKeys(), seen, size);
+      addUniqueRetainedSize(*map->mapValues(), seen, size);
+      break;
+    }
+    default:
+      size += vector.retainedSize();
+  }
+}
+} // namespace
+
+// static
+uint64_t BaseVector::uniqueRetainedSize(
+    const std::vector<VectorPtr>& vectors) {
+  folly::F14FastSet<const Buffer*> seen;
+  uint64_t size = 0;
+  for (const auto& vector : vectors) {
+    if (vector) {
+      addUniqueRetainedSize(*vector, seen, size);
+    }
+  }
+  return size;
+}
+
 namespace {
 bool isReusableEncoding(VectorEncoding::Simple encoding) {
   return encoding == VectorEncoding::Simple::FLAT ||
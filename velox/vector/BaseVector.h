@@ -607,6 +607,19 @@ class BaseVector {
   /// hasn't been loaded yet.
   virtual uint64_t estimateFlatSize() const;
 
+  /// Returns an estimate of the 'retainedSize' of a flat representation of
+  /// 'rows' of this vector. Assumes that the rows are of the average size, so
+  /// the cost does not depend on the number of rows.
+  uint64_t estimateFlatSize(const SelectivityVector& rows) const;
+
+  /// Returns the bytes kept live by 'vectors', counting each buffer once.
+  /// Buffers are shared e.g. by the dictionary encoded columns of a join
+  /// output, which have the same indices, or by a string column and its
+  /// substrings. The cost is linear in the number of vectors and buffers, not
+  /// in the number of rows.
+  static uint64_t uniqueRetainedSize(
+      const std::vector<std::shared_ptr<BaseVector>>& vectors);
+
   // Returns true if 'vector' is a unique reference to a flat vector
   // and nulls and values are uniquely referenced.
   static bool isReusableFlatVector(const std::shared_ptr<BaseVector>& vector);
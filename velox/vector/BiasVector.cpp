@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/vector/BiasVector.h"
+
+namespace facebook::velox {
+namespace {
+
+template <typename T, typename U>
+BufferPtr biasValues(
+    const T* values,
+    const uint64_t* nulls,
+    vector_size_t size,
+    T bias,
+    memory::MemoryPool* pool) {
+  auto buffer = AlignedBuffer::allocate<U>(size, pool);
+  auto* rawBuffer = buffer->asMutable<U>();
+  for (auto i = 0; i < size; ++i) {
+    rawBuffer[i] = nulls && bits::isBitNull(nulls, i)
+        ? 0
+        : static_cast<U>(values[i] - bias);
+  }
+  return buffer;
+}
+
+template <typename T>
+VectorPtr makeBiasVectorTyped(const FlatVector<T>& vector) {
+  const auto size = vector.size();
+  const auto* values = vector.rawValues();
+  const auto* nulls = vector.rawNulls();
+  T min = std::numeric_limits<T>::max();
+  T max = std::numeric_limits<T>::min();
+  bool anyValue = false;
+  for (auto i = 0; i < size; ++i) {
+    if (nulls && bits::isBitNull(nulls, i)) {
+      continue;
+    }
+    min = std::min(min, values[i]);
+    max = std::max(max, values[i]);
+    anyValue = true;
+  }
+  if (!anyValue) {
+    return nullptr;
+  }
+  // The difference is exact in unsigned arithmetic since 'max' >= 'min'.
+  const uint64_t delta =
+      static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+  if (!deltaAllowsBias<T>(delta)) {
+    return nullptr;
+  }
+  // See the bias formula in BiasVector.h.
+  const T bias = min + static_cast<T>((delta + 1) / 2);
+  BufferPtr biased;
+  TypeKind valueType;
+  if (delta <= std::numeric_limits<uint8_t>::max()) {
+    biased = biasValues<T, int8_t>(values, nulls, size, bias, vector.pool());
+    valueType = TypeKind::TINYINT;
+  } else if (delta <= std::numeric_limits<uint16_t>::max()) {
+    biased = biasValues<T, int16_t>(values, nulls, size, bias, vector.pool());
+    valueType = TypeKind::SMALLINT;
+  } else {
+    biased = biasValues<T, int32_t>(values, nulls, size, bias, vector.pool());
+    valueType = TypeKind::INTEGER;
+  }
+  return std::make_shared<BiasVector<T>>(
+      vector.pool(),
+      vector.nulls(),
+      size,
+      valueType,
+      std::move(biased),
+      bias,
+      SimpleVectorStats<T>{min, max},
+      std::nullopt,
+      vector.getNullCount());
+}
+} // namespace
+
+VectorPtr makeBiasVector(const BaseVector& vector) {
+  if (vector.encoding() != VectorEncoding::Simple::FLAT) {
+    return nullptr;
+  }
+  switch (vector.type()->kind()) {
+    case TypeKind::SMALLINT:
+      return makeBiasVectorTyped(*vector.asUnchecked<FlatVector<int16_t>>());
+    case TypeKind::INTEGER:
+      return makeBiasVectorTyped(*vector.asUnchecked<FlatVector<int32_t>>());
+    case TypeKind::BIGINT:
+      return makeBiasVectorTyped(*vector.asUnchecked<FlatVector<int64_t>>());
+    default:
+      return nullptr;
+  }
+}
+
+} // namespace facebook::velox
@@ -138,6 +138,25 @@ class BiasVector : public SimpleVector<T> {
     return valueType_;
   }
 
+  // Calls 'func' with a pointer to the biased values, typed by valueType().
+  // The value of a row is bias() plus its biased value.
+  template <typename Func>
+  void applyToBiasedValues(Func func) const {
+    switch (valueType_) {
+      case TypeKind::INTEGER:
+        func(reinterpret_cast<const int32_t*>(rawValues_));
+        break;
+      case TypeKind::SMALLINT:
+        func(reinterpret_cast<const int16_t*>(rawValues_));
+        break;
+      case TypeKind::TINYINT:
+        func(reinterpret_cast<const int8_t*>(rawValues_));
+        break;
+      default:
+        VELOX_UNSUPPORTED("Invalid type");
+    }
+  }
+
   uint64_t retainedSize() const override {
     return BaseVector::retainedSize() + values_->capacity();
   }
@@ -182,6 +201,12 @@ class BiasVector : public SimpleVector<T> {
 template <typename T>
 using BiasVectorPtr = std::shared_ptr<BiasVector<T>>;
 
+// Returns the values of a flat SMALLINT, INTEGER or BIGINT 'vector' as a
+// BiasVector if the difference of the largest and smallest non-null values
+// fits in a narrower type. Returns nullptr otherwise. The BiasVector has the
+// min and max as stats.
+VectorPtr makeBiasVector(const BaseVector& vector);
+
 } // namespace facebook::velox
 
 #include "velox/vector/BiasVector-inl.h"
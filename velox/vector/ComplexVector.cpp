@@ -20,6 +20,7 @@
 #include "velox/common/base/Exceptions.h"
 #include "velox/vector/BaseVector.h"
 #include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
 #include "velox/vector/SimpleVector.h"
 
 namespace facebook {
@@ -133,27 +134,41 @@ void RowVector::appendToChildren(
   }
 }
 
-void RowVector::copy(
-    const BaseVector* source,
+namespace {
+// Returns 'rows' and the source rows of a copy of 'count' rows from
+// 'sourceIndex' to 'targetIndex'. Leaves 'toSourceRow' nullptr if the rows
+// are the same.
+SelectivityVector rowsForRangeCopy(
     vector_size_t targetIndex,
     vector_size_t sourceIndex,
-    vector_size_t count) {
+    vector_size_t count,
+    memory::MemoryPool* pool,
+    BufferPtr& indices,
+    vector_size_t*& toSourceRow) {
   SelectivityVector rows(targetIndex + count);
   rows.setValidRange(0, targetIndex, false);
   rows.updateBounds();
-
-  BufferPtr indices;
-  vector_size_t* toSourceRow = nullptr;
   if (sourceIndex != targetIndex) {
-    indices =
-        AlignedBuffer::allocate<vector_size_t>(targetIndex + count, pool_);
+    indices = AlignedBuffer::allocate<vector_size_t>(targetIndex + count, pool);
     toSourceRow = indices->asMutable<vector_size_t>();
     std::iota(
         toSourceRow + targetIndex,
         toSourceRow + targetIndex + count,
         sourceIndex);
   }
+  return rows;
+}
+} // namespace
 
+void RowVector::copy(
+    const BaseVector* source,
+    vector_size_t targetIndex,
+    vector_size_t sourceIndex,
+    vector_size_t count) {
+  BufferPtr indices;
+  vector_size_t* toSourceRow = nullptr;
+  auto rows = rowsForRangeCopy(
+      targetIndex, sourceIndex, count, pool_, indices, toSourceRow);
   copy(source, rows, toSourceRow);
 }
 
@@ -440,58 +455,122 @@ std::unique_ptr<SimpleVector<uint64_t>> ArrayVector::hashAll() const {
   VELOX_NYI();
 }
 
+namespace {
+// A run of elements, or keys and values, copied with one call to copy().
+struct ChildRange {
+  vector_size_t sourceOffset;
+  vector_size_t targetOffset;
+  vector_size_t size;
+};
+
+// Sets the nulls, offsets and sizes of 'rows' of 'target' from the arrays or
+// maps of 'source' at 'toSourceRow[row]', or 'row' if 'toSourceRow' is
+// nullptr. 'source' is decoded once. The children of the copied rows go one
+// after the other from 'childSize', which is updated to the child size after
+// the copy. Returns the child rows to copy from the base of 'source'. Rows
+// whose children are adjacent in the base are merged into one range, so that
+// e.g. copying a flat vector copies the children in one call. If 'fixedWidth'
+// is not 0, checks that all copied rows have this size.
+template <typename TVector>
+std::vector<ChildRange> copyNullsOffsetsAndSizes(
+    TVector& target,
+    const BaseVector& source,
+    const SelectivityVector& rows,
+    const vector_size_t* toSourceRow,
+    vector_size_t fixedWidth,
+    vector_size_t& childSize) {
+  DecodedVector decoded(
+      source, toSourceRow ? SelectivityVector(source.size()) : rows);
+  auto base = decoded.base()->template asUnchecked<TVector>();
+  uint64_t* rawNulls = decoded.mayHaveNulls() || target.mayHaveNulls()
+      ? target.mutableRawNulls()
+      : nullptr;
+  auto rawOffsets = target.mutableOffsets(target.size())
+                        ->template asMutable<vector_size_t>();
+  auto rawSizes =
+      target.mutableSizes(target.size())->template asMutable<vector_size_t>();
+  std::vector<ChildRange> ranges;
+  rows.applyToSelected([&](vector_size_t row) {
+    auto sourceRow = toSourceRow ? toSourceRow[row] : row;
+    rawOffsets[row] = childSize;
+    if (decoded.isNullAt(sourceRow)) {
+      bits::setNull(rawNulls, row);
+      rawSizes[row] = 0;
+      return;
+    }
+    if (rawNulls) {
+      bits::clearNull(rawNulls, row);
+    }
+    auto wrappedIndex = decoded.index(sourceRow);
+    auto offset = base->offsetAt(wrappedIndex);
+    auto size = base->sizeAt(wrappedIndex);
+    rawSizes[row] = size;
+    if (size == 0) {
+      return;
+    }
+    if (fixedWidth != 0) {
+      VELOX_CHECK_EQ(
+          size,
+          fixedWidth,
+          "Invalid length element at index {}, wrappedIndex {}",
+          sourceRow,
+          wrappedIndex);
+    }
+    if (!ranges.empty() &&
+        ranges.back().sourceOffset + ranges.back().size == offset) {
+      ranges.back().size += size;
+    } else {
+      ranges.push_back({offset, childSize, size});
+    }
+    childSize += size;
+  });
+  return ranges;
+}
+} // namespace
+
 void ArrayVector::copy(
     const BaseVector* source,
     vector_size_t targetIndex,
     vector_size_t sourceIndex,
     vector_size_t count) {
+  if (count == 0) {
+    return;
+  }
+  BufferPtr indices;
+  vector_size_t* toSourceRow = nullptr;
+  auto rows = rowsForRangeCopy(
+      targetIndex, sourceIndex, count, pool(), indices, toSourceRow);
+  copy(source, rows, toSourceRow);
+}
+
+void ArrayVector::copy(
+    const BaseVector* source,
+    const SelectivityVector& rows,
+    const vector_size_t* toSourceRow) {
   auto sourceValue = source->wrappedVector();
   if (sourceValue->isConstantEncoding()) {
     // A null constant does not have a value vector, so wrappedVector
     // returns the constant.
     VELOX_CHECK(sourceValue->isNullAt(0));
-    for (auto i = 0; i < count; ++i) {
-      setNull(targetIndex + i, true);
-    }
+    rows.applyToSelected([&](vector_size_t row) { setNull(row, true); });
     return;
   }
   VELOX_CHECK_EQ(sourceValue->encoding(), VectorEncoding::Simple::ARRAY);
   auto sourceArray = sourceValue->asUnchecked<ArrayVector>();
-  VELOX_DCHECK(BaseVector::length_ >= targetIndex + count);
+  VELOX_DCHECK(BaseVector::length_ >= rows.end());
   BaseVector::ensureWritable(
       SelectivityVector::empty(), elements_->type(), pool(), &elements_);
-  auto setNotNulls = mayHaveNulls() || source->mayHaveNulls();
   auto wantWidth = type()->isFixedWidth() ? type()->fixedElementsWidth() : 0;
-  for (int32_t i = 0; i < count; ++i) {
-    if (source->isNullAt(sourceIndex + i)) {
-      setNull(targetIndex + i, true);
-    } else {
-      if (setNotNulls) {
-        setNull(targetIndex + i, false);
-      }
-      vector_size_t wrappedIndex = source->wrappedIndex(sourceIndex + i);
-      vector_size_t copySize = sourceArray->sizeAt(wrappedIndex);
-      vector_size_t childSize = elements_->size();
-      if (copySize > 0) {
-        // If we are populating a FixedSizeArray we validate here that
-        // the entries we are populating are the correct sizes.
-        if (wantWidth != 0) {
-          VELOX_CHECK_EQ(
-              copySize,
-              wantWidth,
-              "Invalid length element at index {}, wrappedIndex {}",
-              i,
-              wrappedIndex);
-        }
-        elements_->resize(childSize + copySize);
-        elements_->copy(
-            sourceArray->elements_.get(),
-            childSize,
-            sourceArray->offsetAt(wrappedIndex),
-            copySize);
-      }
-      setOffsetAndSize(targetIndex + i, childSize, copySize);
-    }
+  vector_size_t childSize = elements_->size();
+  auto ranges = copyNullsOffsetsAndSizes(
+      *this, *source, rows, toSourceRow, wantWidth, childSize);
+  elements_->resize(childSize);
+  for (const auto& range : ranges) {
+    elements_->copy(
+        sourceArray->elements_.get(),
+        range.targetOffset,
+        range.sourceOffset,
+        range.size);
   }
 }
 
@@ -680,52 +759,59 @@ void MapVector::copy(
     vector_size_t targetIndex,
     vector_size_t sourceIndex,
     vector_size_t count) {
+  if (count == 0) {
+    return;
+  }
+  BufferPtr indices;
+  vector_size_t* toSourceRow = nullptr;
+  auto rows = rowsForRangeCopy(
+      targetIndex, sourceIndex, count, pool(), indices, toSourceRow);
+  copy(source, rows, toSourceRow);
+}
+
+void MapVector::copy(
+    const BaseVector* source,
+    const SelectivityVector& rows,
+    const vector_size_t* toSourceRow) {
   auto sourceValue = source->wrappedVector();
   if (sourceValue->isConstantEncoding()) {
     // A null constant does not have a value vector, so wrappedVector
     // returns the constant.
     VELOX_CHECK(sourceValue->isNullAt(0));
-    for (auto i = 0; i < count; ++i) {
-      setNull(targetIndex + i, true);
-    }
+    rows.applyToSelected([&](vector_size_t row) { setNull(row, true); });
     return;
   }
   VELOX_CHECK_EQ(sourceValue->encoding(), VectorEncoding::Simple::MAP);
-  VELOX_DCHECK(BaseVector::length_ >= targetIndex + count);
+  VELOX_DCHECK(BaseVector::length_ >= rows.end());
   auto sourceMap = sourceValue->asUnchecked<MapVector>();
+  sortedKeys_ = sortedKeys_ && sourceMap->sortedKeys_;
   BaseVector::ensureWritable(
       SelectivityVector::empty(), keys_->type(), pool(), &keys_);
-  auto setNotNulls = mayHaveNulls() || source->mayHaveNulls();
-  for (int32_t i = 0; i < count; ++i) {
-    if (source->isNullAt(sourceIndex + i)) {
-      setNull(targetIndex + i, true);
-    } else {
-      if (setNotNulls) {
-        setNull(targetIndex + i, false);
-      }
-      vector_size_t wrappedIndex = source->wrappedIndex(sourceIndex + i);
-      vector_size_t copySize = sourceMap->sizeAt(wrappedIndex);
-      // Call reserveMap also for 0 size, since this writes the offset/size.
-      vector_size_t childSize = reserveMap(targetIndex + i, copySize);
-      if (copySize > 0) {
-        keys_->copy(
-            sourceMap->keys_.get(),
-            childSize,
-            sourceMap->offsetAt(wrappedIndex),
-            copySize);
-        values_->copy(
-            sourceMap->values_.get(),
-            childSize,
-            sourceMap->offsetAt(wrappedIndex),
-            copySize);
-      }
-    }
+  BaseVector::ensureWritable(
+      SelectivityVector::empty(), values_->type(), pool(), &values_);
+  vector_size_t childSize = keys_->size();
+  auto ranges = copyNullsOffsetsAndSizes(
+      *this, *source, rows, toSourceRow, 0, childSize);
+  keys_->resize(childSize);
+  values_->resize(childSize);
+  for (const auto& range : ranges) {
+    keys_->copy(
+        sourceMap->keys_.get(),
+        range.targetOffset,
+        range.sourceOffset,
+        range.size);
+    values_->copy(
+        sourceMap->values_.get(),
+        range.targetOffset,
+        range.sourceOffset,
+        range.size);
   }
 }
 
 void MapVector::move(vector_size_t source, vector_size_t target) {
   VELOX_CHECK_LT(source, size());
   VELOX_CHECK_LT(target, size());
+  // The keys are not changed, only which map points to them.
   if (source != target) {
     if (isNullAt(source)) {
       setNull(target, true);
@@ -838,6 +924,8 @@ std::string MapVector::toString(vector_size_t index) const {
 }
 
 void MapVector::ensureWritable(const SelectivityVector& rows) {
+  // The caller may overwrite the maps at 'rows'.
+  sortedKeys_ = false;
   auto newSize = std::max<vector_size_t>(rows.size(), BaseVector::length_);
   if (offsets_ && !offsets_->unique()) {
     BufferPtr newOffsets =
@@ -892,6 +980,7 @@ uint64_t MapVector::estimateFlatSize() const {
 
 void MapVector::prepareForReuse() {
   BaseVector::prepareForReuse();
+  sortedKeys_ = false;
 
   if (!(offsets_->unique() && offsets_->isMutable())) {
     offsets_ = nullptr;
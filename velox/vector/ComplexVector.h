@@ -130,18 +130,15 @@ class RowVector : public BaseVector {
 
   void move(vector_size_t source, vector_size_t target) override;
 
+  /// Counts buffers shared by several children once, e.g. the indices of
+  /// dictionary encoded columns that are wrapped together.
   uint64_t retainedSize() const override {
-    auto size = BaseVector::retainedSize();
-    for (auto& child : children_) {
-      if (child) {
-        size += child->retainedSize();
-      }
-    }
-    return size;
+    return BaseVector::retainedSize() + uniqueRetainedSize(children_);
   }
 
   uint64_t estimateFlatSize() const override;
 
+  using BaseVector::estimateFlatSize;
   using BaseVector::toString;
 
   std::string toString(vector_size_t index) const override;
@@ -359,6 +356,11 @@ class ArrayVector : public BaseVector {
       vector_size_t sourceIndex,
       vector_size_t count) override;
 
+  void copy(
+      const BaseVector* source,
+      const SelectivityVector& rows,
+      const vector_size_t* toSourceRow) override;
+
   void move(vector_size_t source, vector_size_t target) override;
 
   uint64_t retainedSize() const override {
@@ -368,6 +370,7 @@ class ArrayVector : public BaseVector {
 
   uint64_t estimateFlatSize() const override;
 
+  using BaseVector::estimateFlatSize;
   using BaseVector::toString;
 
   std::string toString(vector_size_t index) const override;
@@ -482,6 +485,7 @@ class MapVector : public BaseVector {
   setOffsetAndSize(vector_size_t i, vector_size_t offset, vector_size_t size) {
     offsets_->asMutable<vector_size_t>()[i] = offset;
     sizes_->asMutable<vector_size_t>()[i] = size;
+    sortedKeys_ = false;
   }
 
   const BufferPtr& offsets() const {
@@ -513,9 +517,11 @@ class MapVector : public BaseVector {
         std::move(keys), type()->childAt(0), pool_);
     values_ = BaseVector::getOrCreateEmpty(
         std::move(values), type()->childAt(1), pool_);
+    sortedKeys_ = false;
   }
 
   BufferPtr mutableOffsets(size_t size) {
+    sortedKeys_ = false;
     if (offsets_ && offsets_->capacity() >= size * sizeof(vector_size_t)) {
       return offsets_;
     }
@@ -524,6 +530,7 @@ class MapVector : public BaseVector {
   }
 
   BufferPtr mutableSizes(size_t size) {
+    sortedKeys_ = false;
     if (sizes_ && sizes_->capacity() >= size * sizeof(vector_size_t)) {
       return sizes_;
     }
@@ -537,6 +544,11 @@ class MapVector : public BaseVector {
       vector_size_t sourceIndex,
       vector_size_t count) override;
 
+  void copy(
+      const BaseVector* source,
+      const SelectivityVector& rows,
+      const vector_size_t* toSourceRow) override;
+
   void move(vector_size_t source, vector_size_t target) override;
 
   uint64_t retainedSize() const override {
@@ -546,6 +558,7 @@ class MapVector : public BaseVector {
 
   uint64_t estimateFlatSize() const override;
 
+  using BaseVector::estimateFlatSize;
   using BaseVector::toString;
 
   std::string toString(vector_size_t index) const override;
@@ -559,6 +572,20 @@ class MapVector : public BaseVector {
       const std::shared_ptr<MapVector>& map,
       bool useStableSort = false);
 
+  // Returns true if the keys of each map are sorted smallest first, as after
+  // canonicalize(). Lookups by key, e.g. subscript, binary search such maps.
+  bool hasSortedKeys() const {
+    return sortedKeys_;
+  }
+
+  // Declares that the keys of each map are sorted smallest first in the
+  // order of BaseVector::compare(), e.g. by a producer that writes them in
+  // order. Setting offsets, sizes or keys through this class clears the
+  // flag. Code that changes the keys through mapKeys() must clear it.
+  void setSortedKeys(bool sortedKeys) {
+    sortedKeys_ = sortedKeys;
+  }
+
   // Returns indices into the map at 'index' such
   // that keys[indices[i]] < keys[indices[i + 1]].
   std::vector<vector_size_t> sortedKeyIndices(vector_size_t index) const;
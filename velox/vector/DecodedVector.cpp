@@ -313,8 +313,19 @@ void DecodedVector::decodeBiased(
       bits::roundUp(size_, sizeof(int64_t)) / (sizeof(int64_t) / sizeof(T));
   tempSpace_.resize(numInt64);
   T* data = reinterpret_cast<T*>(&tempSpace_[0]); // NOLINT
-  rows.applyToSelected(
-      [data, biased](vector_size_t row) { data[row] = biased->valueAt(row); });
+  const T bias = biased->bias();
+  // Dispatches on the width of the biased values once, not per row.
+  biased->applyToBiasedValues([&](const auto* biasedValues) {
+    if (rows.isAllSelected()) {
+      for (auto row = 0; row < rows.size(); ++row) {
+        data[row] = bias + biasedValues[row];
+      }
+    } else {
+      rows.applyToSelected([&](vector_size_t row) {
+        data[row] = bias + biasedValues[row];
+      });
+    }
+  });
   data_ = data;
 }
 
@@ -20,6 +20,7 @@
 #include "velox/common/base/SimdUtil.h"
 #include "velox/vector/BuilderTypeUtils.h"
 #include "velox/vector/ConstantVector.h"
+#include "velox/vector/DecodedVector.h"
 #include "velox/vector/TypeAliases.h"
 
 namespace facebook {
@@ -135,6 +136,30 @@ bool FlatVector<T>::useSimdEquality(size_t numCmpVals) const {
   }
 }
 
+namespace detail {
+// Sets 'target[i]' to 'base[indices[i]]' for 'count' consecutive 'i'. Uses a
+// SIMD gather for 4 and 8 byte numbers. All indices must be valid.
+template <typename T>
+void gatherValues(
+    const T* base,
+    const vector_size_t* indices,
+    vector_size_t count,
+    T* target) {
+  vector_size_t i = 0;
+  if constexpr (
+      std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+      std::is_same_v<T, float> || std::is_same_v<T, double>) {
+    constexpr int32_t kBatchSize = xsimd::batch<T>::size;
+    for (; i + kBatchSize <= count; i += kBatchSize) {
+      simd::gather(base, indices + i).store_unaligned(target + i);
+    }
+  }
+  for (; i < count; ++i) {
+    target[i] = base[indices[i]];
+  }
+}
+} // namespace detail
+
 template <typename T>
 void FlatVector<T>::copyValuesAndNulls(
     const BaseVector* source,
@@ -196,16 +221,31 @@ void FlatVector<T>::copyValuesAndNulls(
     T value = constant->valueAt(0);
     rows.applyToSelected([&](int32_t row) { rawValues_[row] = value; });
     rows.clearNulls(rawNulls);
-  } else {
-    auto sourceVector = source->typeKind() != TypeKind::UNKNOWN
-        ? source->asUnchecked<SimpleVector<T>>()
-        : nullptr;
+  } else if (source->typeKind() != TypeKind::UNKNOWN) {
+    // Decodes dictionaries once and reads the flat base instead of calling
+    // the virtual isNullAt() and valueAt() for each row.
+    DecodedVector decoded(
+        *source, toSourceRow ? SelectivityVector(source->size()) : rows);
+    if (decoded.base()->isFlatEncoding()) {
+      copyDecodedValuesAndNulls(decoded, rows, toSourceRow, rawNulls);
+      return;
+    }
+    auto sourceVector = source->asUnchecked<SimpleVector<T>>();
     while (iter.next(row)) {
       auto sourceRow = toSourceRow ? toSourceRow[row] : row;
       if (!source->isNullAt(sourceRow)) {
-        if (sourceVector) {
-          rawValues_[row] = sourceVector->valueAt(sourceRow);
+        rawValues_[row] = sourceVector->valueAt(sourceRow);
+        if (rawNulls) {
+          bits::clearNull(rawNulls, row);
         }
+      } else {
+        bits::setNull(rawNulls, row);
+      }
+    }
+  } else {
+    while (iter.next(row)) {
+      auto sourceRow = toSourceRow ? toSourceRow[row] : row;
+      if (!source->isNullAt(sourceRow)) {
         if (rawNulls) {
           bits::clearNull(rawNulls, row);
         }
@@ -216,6 +256,38 @@ void FlatVector<T>::copyValuesAndNulls(
   }
 }
 
+template <typename T>
+void FlatVector<T>::copyDecodedValuesAndNulls(
+    DecodedVector& decoded,
+    const SelectivityVector& rows,
+    const vector_size_t* toSourceRow,
+    uint64_t* rawNulls) {
+  const T* baseValues = decoded.data<T>();
+  if (!decoded.mayHaveNulls()) {
+    if (!toSourceRow && rows.isAllSelected()) {
+      detail::gatherValues(
+          baseValues, decoded.indices(), rows.size(), rawValues_);
+    } else {
+      rows.applyToSelected([&](vector_size_t row) {
+        rawValues_[row] =
+            baseValues[decoded.index(toSourceRow ? toSourceRow[row] : row)];
+      });
+    }
+    rows.clearNulls(rawNulls);
+    return;
+  }
+  rawNulls = BaseVector::mutableRawNulls();
+  rows.applyToSelected([&](vector_size_t row) {
+    auto sourceRow = toSourceRow ? toSourceRow[row] : row;
+    if (decoded.isNullAt(sourceRow)) {
+      bits::setNull(rawNulls, row);
+      return;
+    }
+    rawValues_[row] = baseValues[decoded.index(sourceRow)];
+    bits::clearNull(rawNulls, row);
+  });
+}
+
 template <typename T>
 void FlatVector<T>::copyValuesAndNulls(
     const BaseVector* source,
@@ -282,6 +354,40 @@ void FlatVector<T>::copyValuesAndNulls(
           rawNulls, targetIndex, targetIndex + count, bits::kNotNull);
     }
   } else {
+    if (count > 0 && source->typeKind() != TypeKind::UNKNOWN) {
+      // Decodes dictionaries once and reads the flat base instead of calling
+      // the virtual isNullAt() and valueAt() for each row.
+      SelectivityVector sourceRows(sourceIndex + count, false);
+      sourceRows.setValidRange(sourceIndex, sourceIndex + count, true);
+      sourceRows.updateBounds();
+      DecodedVector decoded(*source, sourceRows);
+      if (decoded.base()->isFlatEncoding()) {
+        const T* baseValues = decoded.data<T>();
+        if (!decoded.mayHaveNulls()) {
+          detail::gatherValues(
+              baseValues,
+              decoded.indices() + sourceIndex,
+              count,
+              rawValues_ + targetIndex);
+          if (rawNulls) {
+            bits::fillBits(
+                rawNulls, targetIndex, targetIndex + count, bits::kNotNull);
+          }
+          return;
+        }
+        rawNulls = BaseVector::mutableRawNulls();
+        for (auto i = 0; i < count; ++i) {
+          if (decoded.isNullAt(sourceIndex + i)) {
+            bits::setNull(rawNulls, targetIndex + i);
+          } else {
+            rawValues_[targetIndex + i] =
+                baseValues[decoded.index(sourceIndex + i)];
+            bits::clearNull(rawNulls, targetIndex + i);
+          }
+        }
+        return;
+      }
+    }
     auto sourceVector = source->asUnchecked<SimpleVector<T>>();
     for (int32_t i = 0; i < count; ++i) {
       if (!source->isNullAt(sourceIndex + i)) {
@@ -205,14 +205,78 @@ Buffer* FlatVector<StringView>::getBufferWithSpace(vector_size_t size) {
     return buffer;
   }
 
-  // Allocate a new buffer.
-  int32_t newSize = std::max(kInitialStringSize, size);
+  // Allocate a new buffer twice the size of the last one.
+  int32_t newSize = kInitialStringSize;
+  if (buffer) {
+    newSize = std::max<int64_t>(
+        newSize,
+        std::min<int64_t>(2 * buffer->capacity(), kMaxStringSizeForReuse));
+  }
+  newSize = std::max(newSize, size);
   BufferPtr newBuffer = AlignedBuffer::allocate<char>(newSize, pool());
   newBuffer->setSize(0);
   stringBuffers_.push_back(newBuffer);
   return stringBuffers_.back().get();
 }
 
+template <>
+bool FlatVector<StringView>::compactStringBuffers() {
+  // Strings are considered garbage if less than 1 / kMinUsedFraction of the
+  // buffers is referenced. Small buffers are not worth copying.
+  constexpr int32_t kMinUsedFraction = 2;
+  constexpr int64_t kMinCompactBytes = 64 << 10;
+  if (stringBuffers_.empty() || !rawValues_ ||
+      !(values_->unique() && values_->isMutable())) {
+    return false;
+  }
+  int64_t bufferBytes = 0;
+  for (auto& buffer : stringBuffers_) {
+    bufferBytes += buffer->capacity();
+  }
+  if (bufferBytes < kMinCompactBytes) {
+    return false;
+  }
+  const uint64_t* rawNulls = BaseVector::rawNulls_;
+  int64_t usedBytes = 0;
+  for (auto i = 0; i < BaseVector::length_; ++i) {
+    if ((!rawNulls || !bits::isBitNull(rawNulls, i)) &&
+        !rawValues_[i].isInline()) {
+      usedBytes += rawValues_[i].size();
+    }
+  }
+  if (usedBytes * kMinUsedFraction >= bufferBytes) {
+    return false;
+  }
+  // Keeps the old buffers until the strings are copied.
+  auto oldBuffers = std::move(stringBuffers_);
+  stringBuffers_.clear();
+  BufferPtr newBuffer;
+  char* rawBuffer = nullptr;
+  if (usedBytes > 0) {
+    newBuffer = AlignedBuffer::allocate<char>(usedBytes, pool());
+    rawBuffer = newBuffer->asMutable<char>();
+  }
+  int64_t offset = 0;
+  for (auto i = 0; i < BaseVector::length_; ++i) {
+    if (rawNulls && bits::isBitNull(rawNulls, i)) {
+      // Null rows must not reference the old buffers.
+      rawValues_[i] = StringView();
+      continue;
+    }
+    if (rawValues_[i].isInline()) {
+      continue;
+    }
+    const auto size = rawValues_[i].size();
+    std::memcpy(rawBuffer + offset, rawValues_[i].data(), size);
+    rawValues_[i] = StringView(rawBuffer + offset, size);
+    offset += size;
+  }
+  if (newBuffer) {
+    stringBuffers_.push_back(std::move(newBuffer));
+  }
+  return true;
+}
+
 template <>
 void FlatVector<StringView>::prepareForReuse() {
   BaseVector::prepareForReuse();
@@ -224,16 +288,21 @@ void FlatVector<StringView>::prepareForReuse() {
     rawValues_ = nullptr;
   }
 
-  // Check string buffers. Keep at most one singly-referenced buffer if it is
+  // Check string buffers. Keep the largest singly-referenced buffer that is
   // not too large.
   if (!stringBuffers_.empty()) {
-    auto& firstBuffer = stringBuffers_.front();
-    if (firstBuffer->unique() && firstBuffer->isMutable() &&
-        firstBuffer->capacity() <= kMaxStringSizeForReuse) {
-      firstBuffer->setSize(0);
-      stringBuffers_.resize(1);
-    } else {
-      stringBuffers_.clear();
+    BufferPtr reusable;
+    for (auto& buffer : stringBuffers_) {
+      if (buffer->unique() && buffer->isMutable() &&
+          buffer->capacity() <= kMaxStringSizeForReuse &&
+          (!reusable || buffer->capacity() > reusable->capacity())) {
+        reusable = buffer;
+      }
+    }
+    stringBuffers_.clear();
+    if (reusable) {
+      reusable->setSize(0);
+      stringBuffers_.push_back(std::move(reusable));
     }
   }
 
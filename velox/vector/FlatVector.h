@@ -28,6 +28,8 @@
 namespace facebook {
 namespace velox {
 
+class DecodedVector;
+
 // FlatVector is marked final to allow for inlining on virtual methods called
 // on a pointer that has the static type FlatVector<T>; this can be a
 // significant performance win when these methods are called in loops.
@@ -47,7 +49,8 @@ class FlatVector final : public SimpleVector<T> {
   static constexpr vector_size_t kInitialStringSize =
       (32 * 1024) - sizeof(AlignedBuffer);
   /// Maximum size of a string buffer to re-use (see
-  /// BaseVector::prepareForReuse): 1MB.
+  /// BaseVector::prepareForReuse): 1MB. New string buffers double in size up
+  /// to this, so that a vector of many strings has a few large buffers.
   static constexpr vector_size_t kMaxStringSizeForReuse =
       (1 << 20) - sizeof(AlignedBuffer);
 
@@ -320,6 +323,15 @@ class FlatVector final : public SimpleVector<T> {
     return nullptr;
   }
 
+  /// Copies the strings referenced by 'this' into one new buffer if the string
+  /// buffers are mostly unreferenced, e.g. if 'this' has substrings of large
+  /// input strings. Lets a vector that is retained, such as the build side of
+  /// a join, free the input buffers. Returns true if the strings were copied.
+  /// Does nothing if the StringViews are shared with other vectors.
+  bool compactStringBuffers() {
+    return false;
+  }
+
   void ensureWritable(const SelectivityVector& rows) override;
 
   /// Calls BaseVector::prapareForReuse() to check and reset nulls buffer if
@@ -340,6 +352,14 @@ class FlatVector final : public SimpleVector<T> {
       vector_size_t sourceIndex,
       vector_size_t count);
 
+  // Copies the rows of 'decoded' over a flat base. 'rawNulls' is the nulls of
+  // 'this' or nullptr if 'this' has no nulls.
+  void copyDecodedValuesAndNulls(
+      DecodedVector& decoded,
+      const SelectivityVector& rows,
+      const vector_size_t* toSourceRow,
+      uint64_t* rawNulls);
+
   // Contiguous values.
   // If strings, these are velox::StringViews into memory held by
   // 'stringBuffers_'
@@ -402,6 +422,9 @@ void FlatVector<bool>::copyValuesAndNulls(
 template <>
 Buffer* FlatVector<StringView>::getBufferWithSpace(vector_size_t size);
 
+template <>
+bool FlatVector<StringView>::compactStringBuffers();
+
 template <>
 void FlatVector<StringView>::prepareForReuse();
 
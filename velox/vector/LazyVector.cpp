@@ -30,6 +30,14 @@ void setRunTimeStatWriter(std::unique_ptr<BaseRuntimeStatWriter>&& ptr) {
   sRunTimeStatWriters.reset(std::move(ptr));
 }
 
+void addThreadLocalRuntimeStat(
+    const std::string& name,
+    const RuntimeCounter& value) {
+  if (BaseRuntimeStatWriter* pWriter = sRunTimeStatWriters.get()) {
+    pWriter->addRuntimeStat(name, value);
+  }
+}
+
 static void writeIOWallTimeStat(size_t ioTimeStartMicros) {
   if (BaseRuntimeStatWriter* pWriter = sRunTimeStatWriters.get()) {
     pWriter->addRuntimeStat(
@@ -114,6 +114,12 @@ class BaseRuntimeStatWriter {
 // vectors will add time spent on loading data using that writer.
 void setRunTimeStatWriter(std::unique_ptr<BaseRuntimeStatWriter>&& ptr);
 
+// Adds 'value' to the runtime stats of the operator running on the thread, if
+// a writer is set. Used by code deeper in the stack, e.g. IO and spilling.
+void addThreadLocalRuntimeStat(
+    const std::string& name,
+    const RuntimeCounter& value);
+
 // Vector class which produces values on first use. This is used for
 // loading columns on demand. This allows eliding load of
 // columns which have all values filtered out by e.g. joins or which
@@ -260,6 +266,8 @@ class LazyVector : public BaseVector {
     return isLoaded() ? loadedVector()->estimateFlatSize() : 0;
   }
 
+  using BaseVector::estimateFlatSize;
+
   std::string toString(vector_size_t index) const override {
     return loadedVector()->toString(index);
   }
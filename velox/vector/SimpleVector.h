@@ -233,7 +233,9 @@ class SimpleVector : public BaseVector {
   }
 
   /// Computes and saves is-ascii flag for a given set of rows if not already
-  /// present. Returns computed value.
+  /// present. Returns computed value. The scan stops at the first non-ASCII
+  /// string. Flat vectors are scanned over their raw values and nulls, so that
+  /// the check costs a SIMD pass over the string bytes and no virtual calls.
   template <typename U = T>
   typename std::enable_if<std::is_same<U, StringView>::value, bool>::type
   computeAndSetIsAscii(const SelectivityVector& rows) {
@@ -241,14 +243,24 @@ class SimpleVector : public BaseVector {
       return isAllAscii_;
     }
     ensureIsAsciiCapacity(rows.end());
-    bool isAllAscii = true;
-    rows.template applyToSelected([&](auto row) {
-      if (!isNullAt(row)) {
+    bool isAllAscii;
+    if (encoding() == VectorEncoding::Simple::FLAT) {
+      const auto* rawValues = static_cast<const StringView*>(valuesAsVoid());
+      const auto* rawNulls = this->rawNulls();
+      isAllAscii = rows.template testSelected([&](auto row) {
+        return (rawNulls && bits::isBitNull(rawNulls, row)) ||
+            functions::stringCore::isAscii(
+                   rawValues[row].data(), rawValues[row].size());
+      });
+    } else {
+      isAllAscii = rows.template testSelected([&](auto row) {
+        if (isNullAt(row)) {
+          return true;
+        }
         auto string = valueAt(row);
-        isAllAscii &=
-            functions::stringCore::isAscii(string.data(), string.size());
-      }
-    });
+        return functions::stringCore::isAscii(string.data(), string.size());
+      });
+    }
 
     // Set isAllAscii flag, it will unset if we encounter any utf.
     if (!asciiSetRows_.hasSelections()) {
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/vector/VectorPool.h"
+
+namespace facebook::velox {
+
+VectorPtr VectorPool::get(const TypePtr& type, vector_size_t size) {
+  const auto kind = static_cast<int32_t>(type->kind());
+  if (kind < kNumScalarKinds) {
+    auto& vectors = vectors_[kind];
+    for (auto i = 0; i < vectors.size(); ++i) {
+      // Skips vectors still referenced by a consumer. Decimal types of one
+      // kind may differ in precision and scale.
+      if (!vectors[i].unique() || !vectors[i]->type()->equivalent(*type)) {
+        continue;
+      }
+      auto vector = std::move(vectors[i]);
+      vectors.erase(vectors.begin() + i);
+      --i;
+      // The buffers of 'vector' may have been shared while it was in use.
+      if (!BaseVector::isReusableFlatVector(vector)) {
+        continue;
+      }
+      BaseVector::prepareForReuse(vector, size);
+      ++numReused_;
+      return vector;
+    }
+  }
+  ++numCreated_;
+  return BaseVector::create(type, size, pool_);
+}
+
+bool VectorPool::release(VectorPtr vector) {
+  if (!vector || !vector->isFlatEncoding()) {
+    return false;
+  }
+  const auto kind = static_cast<int32_t>(vector->typeKind());
+  if (kind >= kNumScalarKinds || vectors_[kind].size() >= kMaxVectorsPerKind) {
+    return false;
+  }
+  vectors_[kind].push_back(std::move(vector));
+  return true;
+}
+
+} // namespace facebook::velox
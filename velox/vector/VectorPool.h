@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox {
+
+/// Recycles flat vectors of scalar types across batches. An operator passes
+/// the vectors it produces to release(), which keeps a reference to each.
+/// When all other references are gone, e.g. the consumer is done with a
+/// batch, get() returns the vector with its buffers for the next batch. This
+/// saves allocating and page faulting the buffers for every batch. Not
+/// thread-safe.
+class VectorPool {
+ public:
+  explicit VectorPool(memory::MemoryPool* FOLLY_NONNULL pool) : pool_(pool) {}
+
+  /// Returns a flat vector of 'type' and 'size'. Reuses a released vector of
+  /// 'type' that is no longer referenced elsewhere if there is one. The
+  /// contents of a reused vector are as after BaseVector::prepareForReuse.
+  VectorPtr get(const TypePtr& type, vector_size_t size);
+
+  /// Keeps 'vector' for reuse by get() once the other references to it are
+  /// gone. Returns false if 'vector' is not a flat vector of a scalar type or
+  /// if there are already kMaxVectorsPerKind vectors of its kind.
+  bool release(VectorPtr vector);
+
+  /// Number of vectors returned by get() that were reused.
+  int64_t numReused() const {
+    return numReused_;
+  }
+
+  /// Number of vectors returned by get() that were newly made.
+  int64_t numCreated() const {
+    return numCreated_;
+  }
+
+ private:
+  static constexpr int32_t kMaxVectorsPerKind = 8;
+
+  // Number of scalar TypeKinds. The complex type kinds come after these.
+  static constexpr int32_t kNumScalarKinds =
+      static_cast<int32_t>(TypeKind::LONG_DECIMAL) + 1;
+
+  memory::MemoryPool* FOLLY_NONNULL const pool_;
+
+  // Released vectors for each scalar TypeKind. Some may still be referenced
+  // by consumers.
+  std::array<std::vector<VectorPtr>, kNumScalarKinds> vectors_;
+
+  int64_t numReused_{0};
+  int64_t numCreated_{0};
+};
+
+} // namespace facebook::velox
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <folly/compression/Compression.h>
+
 #include "velox/buffer/Buffer.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/common/memory/MappedMemory.h"
@@ -48,6 +50,33 @@ class VectorSerializer {
 
 class VectorSerde {
  public:
+  // Options for serializing a stream of pages. The same options apply to
+  // the consecutive pages of one stream, e.g. to one exchange
+  // destination, and are passed to the deserializer of the stream.
+  struct Options {
+    virtual ~Options() = default;
+
+    // Codec for compressing pages. The deserializer must be given the
+    // same codec.
+    folly::io::CodecType compressionKind{
+        folly::io::CodecType::NO_COMPRESSION};
+
+    // A page that does not compress to this fraction of its size is sent
+    // uncompressed.
+    double minCompressionRatio{0.8};
+
+    // Adaptation of compression to the stream, maintained by the
+    // serializer. After a page compresses poorly, the next
+    // 'numPagesToSkip' pages are not compressed. The skip doubles with
+    // each further poor page, up to 'kMaxPagesToSkip', and is reset by a
+    // page that compresses well.
+    static constexpr int32_t kMaxPagesToSkip = 64;
+    int32_t numPagesToSkip{0};
+    int32_t nextPagesToSkip{1};
+    int64_t numCompressedPages{0};
+    int64_t numSkippedPages{0};
+  };
+
   virtual ~VectorSerde() = default;
 
   virtual void estimateSerializedSize(
@@ -55,16 +84,20 @@ class VectorSerde {
       const folly::Range<const IndexRange*>& ranges,
       vector_size_t** sizes) = 0;
 
+  // 'options' may be nullptr. Otherwise it must outlive the serializer,
+  // which updates the adaptation state in it.
   virtual std::unique_ptr<VectorSerializer> createSerializer(
       std::shared_ptr<const RowType> type,
       int32_t numRows,
-      StreamArena* streamArena) = 0;
+      StreamArena* streamArena,
+      Options* options = nullptr) = 0;
 
   virtual void deserialize(
       ByteStream* source,
       velox::memory::MemoryPool* pool,
       std::shared_ptr<const RowType> type,
-      std::shared_ptr<RowVector>* result) = 0;
+      std::shared_ptr<RowVector>* result,
+      const Options* options = nullptr) = 0;
 };
 
 bool registerVectorSerde(std::unique_ptr<VectorSerde> serde);
@@ -89,7 +122,10 @@ class VectorStreamGroup : public StreamArena {
   explicit VectorStreamGroup(memory::MappedMemory* mappedMemory)
       : StreamArena(mappedMemory) {}
 
-  void createStreamTree(std::shared_ptr<const RowType> type, int32_t numRows);
+  void createStreamTree(
+      std::shared_ptr<const RowType> type,
+      int32_t numRows,
+      VectorSerde::Options* options = nullptr);
 
   static void estimateSerializedSize(
       std::shared_ptr<BaseVector> vector,
@@ -108,7 +144,8 @@ class VectorStreamGroup : public StreamArena {
       ByteStream* source,
       velox::memory::MemoryPool* pool,
       std::shared_ptr<const RowType> type,
-      std::shared_ptr<RowVector>* result);
+      std::shared_ptr<RowVector>* result,
+      const VectorSerde::Options* options = nullptr);
 
  private:
   std::unique_ptr<VectorSerializer> serializer_;
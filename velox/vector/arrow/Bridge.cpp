@@ -15,6 +15,10 @@
  */
 
 #include "velox/vector/arrow/Bridge.h"
+
+#include <cerrno>
+#include <limits>
+
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
@@ -47,6 +51,13 @@ class VeloxToArrowBridgeHolder {
     }
   }
 
+  // Acquires `buffer` and exports `data`, which points into `buffer`, at
+  // index `idx`.
+  void setBuffer(size_t idx, const BufferPtr& buffer, const void* data) {
+    bufferPtrs_[idx] = buffer;
+    buffers_[idx] = data;
+  }
+
   template <typename T>
   T* getBufferAs(size_t idx) {
     return bufferPtrs_[idx]->asMutable<T>();
@@ -179,6 +190,43 @@ static void bridgeSchemaRelease(ArrowSchema* arrowSchema) {
   arrowSchema->private_data = nullptr;
 }
 
+// Returns the string buffer of `vector` that holds the non-inlined strings
+// back to back in row order, nullptr if there is no such buffer or some
+// non-null string is inlined. Then the strings can be exported without a copy.
+template <typename TOffset>
+BufferPtr findContiguousStrings(const FlatVector<StringView>* vector) {
+  const char* first = nullptr;
+  const char* end = nullptr;
+  for (vector_size_t i = 0; i < vector->size(); ++i) {
+    if (vector->isNullAt(i)) {
+      continue;
+    }
+    const StringView& sv = vector->valueAtFast(i);
+    if (sv.isInline()) {
+      if (sv.size() == 0) {
+        continue;
+      }
+      return nullptr;
+    }
+    if (!first) {
+      first = sv.data();
+    } else if (sv.data() != end) {
+      return nullptr;
+    }
+    end = sv.data() + sv.size();
+  }
+  if (!first || end - first > std::numeric_limits<TOffset>::max()) {
+    return nullptr;
+  }
+  for (auto& buffer : vector->stringBuffers()) {
+    auto* begin = buffer->as<char>();
+    if (first >= begin && end <= begin + buffer->size()) {
+      return buffer;
+    }
+  }
+  return nullptr;
+}
+
 template <typename TOffset>
 void exportFlatStringVector(
     FlatVector<StringView>* vector,
@@ -186,35 +234,85 @@ void exportFlatStringVector(
     VeloxToArrowBridgeHolder& bridgeHolder,
     memory::MemoryPool* pool) {
   VELOX_CHECK_NOT_NULL(vector);
+  const auto size = vector->size();
+
+  // Allocate offset buffer. Null values are empty.
+  bridgeHolder.setBuffer(
+      1, AlignedBuffer::allocate<TOffset>(size + 1, pool));
+  TOffset* rawOffsets = bridgeHolder.getBufferAs<TOffset>(1);
+
+  // If the long strings are back to back in a string buffer, the offsets
+  // point into the Velox buffer and no string is copied.
+  if (auto stringBuffer = findContiguousStrings<TOffset>(vector)) {
+    const char* base = nullptr;
+    TOffset offset = 0;
+    for (vector_size_t i = 0; i < size; ++i) {
+      rawOffsets[i] = offset;
+      if (vector->isNullAt(i)) {
+        continue;
+      }
+      const StringView& sv = vector->valueAtFast(i);
+      if (sv.size() == 0) {
+        continue;
+      }
+      if (!base) {
+        base = sv.data();
+      }
+      offset = sv.data() + sv.size() - base;
+    }
+    rawOffsets[size] = offset;
+    bridgeHolder.setBuffer(2, stringBuffer, base);
+    return;
+  }
 
-  // Quick first pass to calculate the buffer size for a single allocation.
+  // First pass computes the offsets, which gives the size for a single
+  // allocation.
   size_t bufferSize = 0;
-  for (size_t i = 0; i < vector->size(); i++) {
-    bufferSize += vector->valueAtFast(i).size();
+  for (vector_size_t i = 0; i < size; ++i) {
+    rawOffsets[i] = bufferSize;
+    if (!vector->isNullAt(i)) {
+      bufferSize += vector->valueAtFast(i).size();
+    }
   }
+  VELOX_CHECK_LE(bufferSize, std::numeric_limits<TOffset>::max());
+  rawOffsets[size] = bufferSize;
 
   // Allocate raw string buffer.
   bridgeHolder.setBuffer(2, AlignedBuffer::allocate<char>(bufferSize, pool));
   char* rawBuffer = bridgeHolder.getBufferAs<char>(2);
 
-  // Allocate offset buffer.
-  bridgeHolder.setBuffer(
-      1, AlignedBuffer::allocate<TOffset>(vector->size() + 1, pool));
-  TOffset* rawOffsets = bridgeHolder.getBufferAs<TOffset>(1);
-  *rawOffsets = 0;
-
-  // Second pass to actually copy the string data and set offsets.
-  for (size_t i = 0; i < vector->size(); i++) {
-    // Copy string content.
+  // Second pass copies the string data. Inlined strings are copied as a
+  // whole inline part, the excess is overwritten by the next string or falls
+  // in the padding after the buffer. Runs of long strings that are back to
+  // back in the Velox buffers are copied with one memcpy.
+  const char* run = nullptr;
+  size_t runSize = 0;
+  char* runTarget = nullptr;
+  for (vector_size_t i = 0; i < size; ++i) {
+    if (vector->isNullAt(i)) {
+      continue;
+    }
     const StringView& sv = vector->valueAtFast(i);
-    std::memcpy(rawBuffer, sv.data(), sv.size());
-    rawBuffer += sv.size();
-
-    // Set offset.
-    *(rawOffsets + 1) = *rawOffsets + sv.size();
-    ++rawOffsets;
+    if (sv.isInline()) {
+      std::memcpy(
+          rawBuffer + rawOffsets[i], sv.data(), StringView::kInlineSize);
+      continue;
+    }
+    if (run && sv.data() == run + runSize &&
+        runTarget + runSize == rawBuffer + rawOffsets[i]) {
+      runSize += sv.size();
+      continue;
+    }
+    if (run) {
+      std::memcpy(runTarget, run, runSize);
+    }
+    run = sv.data();
+    runSize = sv.size();
+    runTarget = rawBuffer + rawOffsets[i];
+  }
+  if (run) {
+    std::memcpy(runTarget, run, runSize);
   }
-  VELOX_CHECK_EQ(bufferSize, *rawOffsets);
 }
 
 void exportFlatVector(
@@ -444,6 +542,100 @@ void exportToArrow(const TypePtr& type, ArrowSchema& arrowSchema) {
   arrowSchema.private_data = bridgeHolder.release();
 }
 
+namespace {
+
+// Holds the state of an ArrowArrayStream exported from Velox. This is
+// opaquely carried by ArrowArrayStream.private_data.
+struct VeloxToArrowStreamBridgeHolder {
+  RowTypePtr type;
+  std::function<RowVectorPtr()> next;
+  memory::MemoryPool* pool;
+  std::string lastError;
+};
+
+VeloxToArrowStreamBridgeHolder* streamHolder(ArrowArrayStream* arrowStream) {
+  return static_cast<VeloxToArrowStreamBridgeHolder*>(
+      arrowStream->private_data);
+}
+
+int bridgeStreamGetSchema(
+    ArrowArrayStream* arrowStream,
+    ArrowSchema* arrowSchema) {
+  auto* holder = streamHolder(arrowStream);
+  try {
+    exportToArrow(holder->type, *arrowSchema);
+  } catch (const std::exception& e) {
+    holder->lastError = e.what();
+    return EINVAL;
+  }
+  return 0;
+}
+
+int bridgeStreamGetNext(ArrowArrayStream* arrowStream, ArrowArray* arrowArray) {
+  auto* holder = streamHolder(arrowStream);
+  try {
+    auto vector = holder->next();
+    if (!vector) {
+      // End of stream.
+      arrowArray->release = nullptr;
+      return 0;
+    }
+    // Only flat and row vectors can be exported. The output of an operator
+    // is often lazy or dictionary encoded.
+    std::vector<VectorPtr> children;
+    children.reserve(vector->childrenSize());
+    for (auto& child : vector->children()) {
+      auto loaded = BaseVector::loadedVectorShared(child);
+      if (loaded->encoding() != VectorEncoding::Simple::FLAT) {
+        BaseVector::flattenVector(&loaded, vector->size());
+      }
+      children.push_back(std::move(loaded));
+    }
+    exportToArrow(
+        std::make_shared<RowVector>(
+            vector->pool(),
+            vector->type(),
+            vector->nulls(),
+            vector->size(),
+            std::move(children)),
+        *arrowArray,
+        holder->pool);
+  } catch (const std::exception& e) {
+    holder->lastError = e.what();
+    return EIO;
+  }
+  return 0;
+}
+
+const char* bridgeStreamGetLastError(ArrowArrayStream* arrowStream) {
+  auto* holder = streamHolder(arrowStream);
+  return holder->lastError.empty() ? nullptr : holder->lastError.c_str();
+}
+
+void bridgeStreamRelease(ArrowArrayStream* arrowStream) {
+  if (!arrowStream || !arrowStream->release) {
+    return;
+  }
+  delete streamHolder(arrowStream);
+  arrowStream->release = nullptr;
+  arrowStream->private_data = nullptr;
+}
+
+} // namespace
+
+void exportToArrow(
+    const RowTypePtr& type,
+    std::function<RowVectorPtr()> next,
+    ArrowArrayStream& arrowStream,
+    memory::MemoryPool* pool) {
+  arrowStream.get_schema = bridgeStreamGetSchema;
+  arrowStream.get_next = bridgeStreamGetNext;
+  arrowStream.get_last_error = bridgeStreamGetLastError;
+  arrowStream.release = bridgeStreamRelease;
+  arrowStream.private_data = new VeloxToArrowStreamBridgeHolder{
+      type, std::move(next), pool, std::string()};
+}
+
 TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
   const char* format = arrowSchema.format;
   VELOX_CHECK_NOT_NULL(format);
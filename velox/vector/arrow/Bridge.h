@@ -19,7 +19,7 @@
 #include <arrow/c/abi.h>
 #endif
 #include "velox/common/memory/Memory.h"
-#include "velox/vector/BaseVector.h"
+#include "velox/vector/ComplexVector.h"
 
 namespace facebook::velox {
 
@@ -75,6 +75,36 @@ void exportToArrow(
 ///
 void exportToArrow(const TypePtr& type, ArrowSchema& arrowSchema);
 
+/// Export the RowVectors produced by `next` as an ArrowArrayStream of `type`,
+/// as defined by Arrow's C stream interface:
+///
+///   https://arrow.apache.org/docs/format/CStreamInterface.html
+///
+/// `next` returns nullptr at the end of the stream. It is called from
+/// get_next() of the stream, which exports each vector like the
+/// VectorPtr->ArrowArray export function above. Lazy and encoded columns are
+/// flattened first. The client must call the release() function of the
+/// stream after usage.
+///
+/// Example usage:
+///
+///   ArrowArrayStream arrowStream;
+///   exportToArrow(
+///       rowType,
+///       [&]() { return cursor->moveNext() ? cursor->current() : nullptr; },
+///       arrowStream);
+///
+///   (use arrowStream)
+///
+///   arrowStream.release(&arrowStream);
+///
+void exportToArrow(
+    const RowTypePtr& type,
+    std::function<RowVectorPtr()> next,
+    ArrowArrayStream& arrowStream,
+    memory::MemoryPool* pool =
+        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+
 /// Import an ArrowSchema into a Velox Type object.
 ///
 /// This function does the exact opposite of the function above. TypePtr carries
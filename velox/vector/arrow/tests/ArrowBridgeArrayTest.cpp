@@ -424,6 +424,89 @@ TEST_F(ArrowBridgeArrayExportTest, unsupported) {
   EXPECT_THROW(exportToArrow(vector, arrowArray, pool_.get()), VeloxException);
 }
 
+TEST_F(ArrowBridgeArrayExportTest, flatStringNoCopy) {
+  // The long strings are back to back in one string buffer, so the values
+  // buffer of the Arrow array points there.
+  std::vector<std::optional<std::string>> inputData = {
+      "a long string that is not inlined",
+      std::nullopt,
+      "",
+      "another string that is too long to be inlined",
+  };
+  auto flatVector = vectorMaker_.flatVectorNullable(inputData);
+  ArrowArray arrowArray;
+  exportToArrow(flatVector, arrowArray, pool_.get());
+  validateStringArray(inputData, arrowArray);
+
+  auto& stringBuffers = flatVector->stringBuffers();
+  ASSERT_EQ(1, stringBuffers.size());
+  auto* values = static_cast<const char*>(arrowArray.buffers[2]);
+  EXPECT_GE(values, stringBuffers[0]->as<char>());
+  EXPECT_LT(values, stringBuffers[0]->as<char>() + stringBuffers[0]->size());
+
+  // Releasing the vector leaves the strings referenced by the Arrow array.
+  flatVector.reset();
+  validateStringArray(inputData, arrowArray);
+  arrowArray.release(&arrowArray);
+}
+
+TEST_F(ArrowBridgeArrayExportTest, stream) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    // The second column is dictionary encoded and gets flattened.
+    BufferPtr indices = allocateIndices(4, pool_.get());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    for (auto j = 0; j < 4; ++j) {
+      rawIndices[j] = 3 - j;
+    }
+    vectors.push_back(vectorMaker_.rowVector({
+        vectorMaker_.flatVector<int64_t>({i, i + 1, i + 2, i + 3}),
+        BaseVector::wrapInDictionary(
+            BufferPtr(),
+            indices,
+            4,
+            vectorMaker_.flatVector<std::string>(
+                {"a", "bb", "a string that is not inlined", ""})),
+    }));
+  }
+  auto rowType = std::dynamic_pointer_cast<const RowType>(vectors[0]->type());
+
+  size_t nextVector = 0;
+  ArrowArrayStream arrowStream;
+  exportToArrow(
+      rowType,
+      [&]() -> RowVectorPtr {
+        return nextVector < vectors.size() ? vectors[nextVector++] : nullptr;
+      },
+      arrowStream,
+      pool_.get());
+
+  ArrowSchema arrowSchema;
+  ASSERT_EQ(0, arrowStream.get_schema(&arrowStream, &arrowSchema));
+  EXPECT_EQ(*rowType, *importFromArrow(arrowSchema));
+
+  for (auto i = 0;; ++i) {
+    ArrowArray arrowArray;
+    ASSERT_EQ(0, arrowStream.get_next(&arrowStream, &arrowArray));
+    if (!arrowArray.release) {
+      EXPECT_EQ(vectors.size(), i);
+      break;
+    }
+    auto result = importFromArrowAsViewer(arrowSchema, arrowArray, pool_.get());
+    ASSERT_EQ(vectors[i]->size(), result->size());
+    for (auto row = 0; row < result->size(); ++row) {
+      EXPECT_TRUE(vectors[i]->equalValueAt(result.get(), row, row));
+    }
+    result.reset();
+    arrowArray.release(&arrowArray);
+  }
+  EXPECT_EQ(nullptr, arrowStream.get_last_error(&arrowStream));
+
+  arrowSchema.release(&arrowSchema);
+  arrowStream.release(&arrowStream);
+  EXPECT_EQ(nullptr, arrowStream.release);
+}
+
 class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
  protected:
   // Used by this base test class to import Arrow data and create Velox Vector.
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/vector/tests/VectorMaker.h"
+
+// Measures BaseVector::copy() of dictionary encoded vectors of 10K rows over
+// a base of the same size with random indices. The 'range' cases copy all
+// rows with copy(source, targetIndex, sourceIndex, count) and the 'rows'
+// cases copy every other row with copy(source, rows, toSourceRow), as the
+// output of a join does. Counts rows copied, so that folly's iters/s is
+// rows/s.
+namespace facebook::velox::test {
+namespace {
+constexpr vector_size_t kSize = 10'000;
+
+class CopyBenchmark {
+ public:
+  CopyBenchmark() {
+    folly::Random::DefaultGenerator rng(1);
+    indices_ = AlignedBuffer::allocate<vector_size_t>(kSize, pool_.get());
+    auto rawIndices = indices_->asMutable<vector_size_t>();
+    for (auto i = 0; i < kSize; ++i) {
+      rawIndices[i] = folly::Random::rand32(kSize, rng);
+    }
+    toSourceRow_.resize(kSize);
+    for (auto i = 0; i < kSize; ++i) {
+      toSourceRow_[i] = kSize - 1 - i;
+    }
+    rows_.resize(kSize);
+    for (auto i = 1; i < kSize; i += 2) {
+      rows_.setValid(i, false);
+    }
+    rows_.updateBounds();
+  }
+
+  VectorPtr makeBase(const TypePtr& type, bool withNulls) {
+    auto isNullAt = withNulls ? VectorMaker::nullEvery(7) : nullptr;
+    switch (type->kind()) {
+      case TypeKind::BIGINT:
+        return maker_.flatVector<int64_t>(
+            kSize, [](auto row) { return row; }, isNullAt);
+      case TypeKind::DOUBLE:
+        return maker_.flatVector<double>(
+            kSize, [](auto row) { return row * 0.1; }, isNullAt);
+      case TypeKind::VARCHAR:
+        return maker_.flatVector<StringView>(
+            kSize,
+            [](auto row) {
+              return StringView(
+                  row % 2 ? "a string that is not inlined" : "inlined");
+            },
+            isNullAt);
+      case TypeKind::ARRAY:
+        return maker_.arrayVector<int64_t>(
+            kSize,
+            [](auto row) { return row % 5; },
+            [](auto index) { return index; },
+            isNullAt);
+      case TypeKind::MAP:
+        return maker_.mapVector<int32_t, double>(
+            kSize,
+            [](auto row) { return row % 5; },
+            [](auto index) { return index; },
+            [](auto index) { return index * 0.1; },
+            isNullAt);
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+
+  VectorPtr makeDictionary(const TypePtr& type, bool withNulls) {
+    return BaseVector::wrapInDictionary(
+        nullptr, indices_, kSize, makeBase(type, withNulls));
+  }
+
+  VectorPtr makeTarget(const TypePtr& type) {
+    return BaseVector::create(type, kSize, pool_.get());
+  }
+
+  const SelectivityVector& rows() const {
+    return rows_;
+  }
+
+  const vector_size_t* toSourceRow() const {
+    return toSourceRow_.data();
+  }
+
+ private:
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  VectorMaker maker_{pool_.get()};
+  BufferPtr indices_;
+  std::vector<vector_size_t> toSourceRow_;
+  SelectivityVector rows_;
+};
+
+std::unique_ptr<CopyBenchmark> benchmark;
+
+unsigned copyRange(unsigned iters, TypePtr type, bool withNulls) {
+  folly::BenchmarkSuspender suspender;
+  auto source = benchmark->makeDictionary(type, withNulls);
+  suspender.dismiss();
+  for (auto i = 0; i < iters; ++i) {
+    suspender.rehire();
+    auto target = benchmark->makeTarget(type);
+    suspender.dismiss();
+    target->copy(source.get(), 0, 0, kSize);
+    folly::doNotOptimizeAway(target);
+  }
+  return iters * kSize;
+}
+
+unsigned copyRows(unsigned iters, TypePtr type, bool withNulls) {
+  folly::BenchmarkSuspender suspender;
+  auto source = benchmark->makeDictionary(type, withNulls);
+  suspender.dismiss();
+  for (auto i = 0; i < iters; ++i) {
+    suspender.rehire();
+    auto target = benchmark->makeTarget(type);
+    suspender.dismiss();
+    target->copy(source.get(), benchmark->rows(), benchmark->toSourceRow());
+    folly::doNotOptimizeAway(target);
+  }
+  return iters * kSize / 2;
+}
+
+#define COPY_BENCHMARKS(name, type)                                          \
+  BENCHMARK_NAMED_PARAM_MULTI(copyRange, name, type, false);                 \
+  BENCHMARK_NAMED_PARAM_MULTI(copyRange, name##_nulls, type, true);          \
+  BENCHMARK_NAMED_PARAM_MULTI(copyRows, name, type, false);                  \
+  BENCHMARK_NAMED_PARAM_MULTI(copyRows, name##_nulls, type, true);           \
+  BENCHMARK_DRAW_LINE()
+
+COPY_BENCHMARKS(bigint, BIGINT());
+COPY_BENCHMARKS(double, DOUBLE());
+COPY_BENCHMARKS(varchar, VARCHAR());
+COPY_BENCHMARKS(array, ARRAY(BIGINT()));
+COPY_BENCHMARKS(map, MAP(INTEGER(), DOUBLE()));
+} // namespace
+} // namespace facebook::velox::test
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  facebook::velox::test::benchmark =
+      std::make_unique<facebook::velox::test::CopyBenchmark>();
+  folly::runBenchmarks();
+  facebook::velox::test::benchmark.reset();
+  return 0;
+}
@@ -300,6 +300,105 @@ BENCHMARK_PARAM(BM_operatorEquals, 1000000);
 BENCHMARK_PARAM(BM_operatorEquals, 10000000);
 BENCHMARK_DRAW_LINE();
 
+// Sparse and dense masks. A sparse mask selects every 64th row, so most
+// words are empty. A dense mask selects all but every 8th row, so no word is
+// full.
+
+enum class Density { kSparse, kDense };
+
+bool isSelected(size_t row, Density density) {
+  return density == Density::kSparse ? row % 64 == 0 : row % 8 != 0;
+}
+
+SelectivityVector makeMask(size_t numEntries, Density density) {
+  SelectivityVector vector(numEntries, false);
+  for (size_t i = 0; i < numEntries; ++i) {
+    vector.setValid(i, isSelected(i, density));
+  }
+  vector.updateBounds();
+  return vector;
+}
+
+void BM_intersectMask(uint32_t iterations, size_t numEntries, Density density) {
+  folly::BenchmarkSuspender suspender;
+  SelectivityVector vectorA(numEntries);
+  auto vectorB = makeMask(numEntries, density);
+  suspender.dismiss();
+
+  for (uint32_t i = 0; i < iterations; ++i) {
+    vectorA.intersect(vectorB);
+  }
+
+  folly::doNotOptimizeAway(vectorA);
+  suspender.rehire();
+}
+
+void BM_deselectNullsMask(
+    uint32_t iterations,
+    size_t numEntries,
+    Density density) {
+  folly::BenchmarkSuspender suspender;
+  SelectivityVector vector(numEntries);
+  // Set bits are not null.
+  std::vector<uint64_t> nulls(bits::nwords(numEntries));
+  for (size_t i = 0; i < numEntries; ++i) {
+    bits::setBit(nulls.data(), i, isSelected(i, density));
+  }
+  suspender.dismiss();
+
+  for (uint32_t i = 0; i < iterations; ++i) {
+    vector.deselectNulls(nulls.data(), 0, numEntries);
+  }
+
+  folly::doNotOptimizeAway(vector);
+  suspender.rehire();
+}
+
+void BM_updateBoundsMask(
+    uint32_t iterations,
+    size_t numEntries,
+    Density density) {
+  folly::BenchmarkSuspender suspender;
+  auto vector = makeMask(numEntries, density);
+  suspender.dismiss();
+
+  for (uint32_t i = 0; i < iterations; ++i) {
+    vector.updateBounds();
+  }
+
+  folly::doNotOptimizeAway(vector);
+  suspender.rehire();
+}
+
+void BM_applyToSelectedMask(
+    uint32_t iterations,
+    size_t numEntries,
+    Density density) {
+  folly::BenchmarkSuspender suspender;
+  auto vector = makeMask(numEntries, density);
+  suspender.dismiss();
+
+  for (uint32_t i = 0; i < iterations; ++i) {
+    int64_t sum = 0;
+    vector.applyToSelected([&](auto row) { sum += row; });
+    folly::doNotOptimizeAway(sum);
+  }
+
+  suspender.rehire();
+}
+
+#define MASK_BENCHMARKS(name)                                             \
+  BENCHMARK_NAMED_PARAM(name, sparse_1000, 1000, Density::kSparse);       \
+  BENCHMARK_NAMED_PARAM(name, dense_1000, 1000, Density::kDense);         \
+  BENCHMARK_NAMED_PARAM(name, sparse_1000000, 1000000, Density::kSparse); \
+  BENCHMARK_NAMED_PARAM(name, dense_1000000, 1000000, Density::kDense);   \
+  BENCHMARK_DRAW_LINE()
+
+MASK_BENCHMARKS(BM_intersectMask);
+MASK_BENCHMARKS(BM_deselectNullsMask);
+MASK_BENCHMARKS(BM_updateBoundsMask);
+MASK_BENCHMARKS(BM_applyToSelectedMask);
+
 } // namespace test
 } // namespace velox
 } // namespace facebook
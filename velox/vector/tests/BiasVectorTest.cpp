@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/vector/BiasVector.h"
 #include "velox/vector/SimpleVector.h"
 #include "velox/vector/tests/VectorMaker.h"
 
@@ -153,4 +154,32 @@ TYPED_TEST(BiasVectorOverflowTest, minOverflowTest_delta_int32) {
   this->runMinOverflowTest(delta);
 }
 
+TEST_F(BiasVectorTestBase, makeBiasVector) {
+  std::vector<std::optional<int64_t>> data = {
+      1'000'000, 1'000'200, std::nullopt, 1'000'100, 1'000'000};
+  auto flat = vectorMaker_.flatVectorNullable(data);
+  auto biased = makeBiasVector(*flat);
+  ASSERT_TRUE(biased != nullptr);
+  ASSERT_EQ(VectorEncoding::Simple::BIASED, biased->encoding());
+  auto* biasVector = biased->as<BiasVector<int64_t>>();
+  EXPECT_EQ(TypeKind::TINYINT, biasVector->valueType());
+  EXPECT_EQ(1'000'000, biasVector->getMin());
+  EXPECT_EQ(1'000'200, biasVector->getMax());
+  for (auto i = 0; i < data.size(); ++i) {
+    if (data[i].has_value()) {
+      EXPECT_EQ(data[i].value(), biasVector->valueAt(i));
+    } else {
+      EXPECT_TRUE(biasVector->isNullAt(i));
+    }
+  }
+
+  // The range of a SMALLINT vector fits in 8 bits or not at all.
+  auto wide = vectorMaker_.flatVector<int16_t>({-1000, 1000});
+  EXPECT_TRUE(makeBiasVector(*wide) == nullptr);
+  auto narrow = vectorMaker_.flatVector<int32_t>({-1000, 1000});
+  EXPECT_EQ(
+      TypeKind::SMALLINT,
+      makeBiasVector(*narrow)->as<BiasVector<int32_t>>()->valueType());
+}
+
 } // namespace facebook::velox::test
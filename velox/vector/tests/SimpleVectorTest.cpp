@@ -228,6 +228,34 @@ TEST_F(SimpleVectorNonParameterizedTest, computeAscii) {
   }
 }
 
+TEST_F(SimpleVectorNonParameterizedTest, computeAsciiLongStrings) {
+  // Strings across the block, batch and word tails of the SIMD check, with
+  // a non-ASCII character at every position of the longest one.
+  std::vector<std::string> strings;
+  for (auto size : {1, 7, 8, 13, 31, 64, 65, 100, 129}) {
+    strings.push_back(std::string(size, 'a'));
+  }
+  for (auto encoding : kAsciiEncodings) {
+    for (auto position = -1; position < 129; ++position) {
+      auto nonAscii = strings;
+      if (position >= 0) {
+        nonAscii.back().replace(position, 1, "\xc3");
+      }
+      ExpectedData<StringView> data;
+      for (auto& string : nonAscii) {
+        data.push_back(StringView(string));
+      }
+      data.push_back(std::nullopt);
+
+      auto vector = maker_.encodedVector(encoding, data);
+      SelectivityVector all(data.size());
+      ASSERT_EQ(position < 0, vector->computeAndSetIsAscii(all))
+          << encoding << " " << position;
+      assertIsAscii(vector, all, position < 0);
+    }
+  }
+}
+
 TEST_F(SimpleVectorNonParameterizedTest, isAscii) {
   for (auto encoding : kAsciiEncodings) {
     LOG(INFO) << "Running:" << encoding;
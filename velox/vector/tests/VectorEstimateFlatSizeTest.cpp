@@ -501,7 +501,59 @@ TEST_F(VectorEstimateFlatSizeTest, structs) {
       {makeDict(row->childAt(0)),
        makeDict(row->childAt(1)),
        makeDict(row->childAt(2))});
-  EXPECT_EQ(29632, row->retainedSize());
+  // The fields share the indices, which are counted once.
+  EXPECT_EQ(28800, row->retainedSize());
   EXPECT_EQ(2837, row->estimateFlatSize());
   EXPECT_EQ(3295, flatten(row)->estimateFlatSize());
 }
+
+TEST_F(VectorEstimateFlatSizeTest, rows) {
+  auto flat = makeFlatVector<int64_t>(1'000, int64At);
+  SelectivityVector rows(1'000);
+  EXPECT_EQ(flat->estimateFlatSize(), flat->estimateFlatSize(rows));
+
+  rows.setValidRange(0, 750, false);
+  rows.updateBounds();
+  EXPECT_EQ(flat->estimateFlatSize() / 4, flat->estimateFlatSize(rows));
+
+  auto row = makeRowVector({flat});
+  EXPECT_EQ(row->estimateFlatSize() / 4, row->estimateFlatSize(rows));
+
+  rows.clearAll();
+  EXPECT_EQ(0, row->estimateFlatSize(rows));
+}
+
+TEST_F(VectorEstimateFlatSizeTest, uniqueRetainedSize) {
+  auto longStringAt = [&](auto row) {
+    return StringView(longStrings_[row % 3]);
+  };
+  auto strings = makeFlatVector<StringView>(1'000, longStringAt);
+  auto numbers = makeFlatVector<int64_t>(1'000, int64At);
+  EXPECT_EQ(
+      strings->retainedSize() + numbers->retainedSize(),
+      BaseVector::uniqueRetainedSize({strings, numbers}));
+
+  // A column that shares the string buffers of 'strings'.
+  auto shared = BaseVector::create<FlatVector<StringView>>(
+      VARCHAR(), 1'000, pool());
+  shared->copy(strings.get(), 0, 0, 1'000);
+  ASSERT_EQ(strings->stringBuffers(), shared->stringBuffers());
+  uint64_t stringBytes = 0;
+  for (auto& buffer : strings->stringBuffers()) {
+    stringBytes += buffer->capacity();
+  }
+  EXPECT_EQ(
+      strings->retainedSize() + shared->retainedSize() - stringBytes,
+      BaseVector::uniqueRetainedSize({strings, shared}));
+  EXPECT_EQ(
+      strings->retainedSize() + shared->retainedSize() - stringBytes,
+      makeRowVector({strings, shared})->retainedSize());
+
+  // Dictionaries over the same base with the same indices.
+  auto indices = makeIndices(100, [](auto row) { return row * 2; });
+  auto first = wrapInDictionary(indices, 100, numbers);
+  auto second = wrapInDictionary(indices, 100, numbers);
+  EXPECT_EQ(first->retainedSize(), BaseVector::uniqueRetainedSize({first}));
+  EXPECT_EQ(
+      first->retainedSize(), BaseVector::uniqueRetainedSize({first, second}));
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "velox/vector/VectorPool.h"
+#include "velox/vector/tests/VectorTestBase.h"
+
+using namespace facebook::velox;
+
+class VectorPoolTest : public testing::Test, public test::VectorTestBase {};
+
+TEST_F(VectorPoolTest, reuse) {
+  VectorPool vectorPool(pool());
+  auto vector = vectorPool.get(BIGINT(), 1'000);
+  EXPECT_EQ(1'000, vector->size());
+  auto* rawValues = vector->values()->as<int64_t>();
+  EXPECT_TRUE(vectorPool.release(vector));
+
+  // 'vector' is still referenced, so a new vector is made.
+  auto other = vectorPool.get(BIGINT(), 1'000);
+  EXPECT_NE(vector.get(), other.get());
+  EXPECT_EQ(2, vectorPool.numCreated());
+
+  // After the consumer drops 'vector', its buffers are reused.
+  auto* address = vector.get();
+  vector.reset();
+  auto reused = vectorPool.get(BIGINT(), 500);
+  EXPECT_EQ(address, reused.get());
+  EXPECT_EQ(500, reused->size());
+  EXPECT_EQ(rawValues, reused->values()->as<int64_t>());
+  EXPECT_EQ(1, vectorPool.numReused());
+
+  // A vector of another type is not reused.
+  EXPECT_TRUE(vectorPool.release(reused));
+  reused.reset();
+  EXPECT_NE(address, vectorPool.get(INTEGER(), 500).get());
+  EXPECT_EQ(address, vectorPool.get(BIGINT(), 100).get());
+}
+
+TEST_F(VectorPoolTest, sharedBuffers) {
+  VectorPool vectorPool(pool());
+  auto vector = vectorPool.get(VARCHAR(), 10);
+  auto values = vector->values();
+  EXPECT_TRUE(vectorPool.release(std::move(vector)));
+
+  // The values buffer is still shared, hence the vector is dropped.
+  auto other = vectorPool.get(VARCHAR(), 10);
+  EXPECT_NE(values, other->values());
+  EXPECT_EQ(0, vectorPool.numReused());
+}
+
+TEST_F(VectorPoolTest, notReleased) {
+  VectorPool vectorPool(pool());
+  EXPECT_FALSE(vectorPool.release(nullptr));
+  EXPECT_FALSE(vectorPool.release(makeArrayVector<int64_t>({{1, 2}, {3}})));
+  EXPECT_FALSE(vectorPool.release(makeConstant<int64_t>(1, 10)));
+  std::vector<VectorPtr> vectors;
+  for (auto i = 0; i < 8; ++i) {
+    vectors.push_back(makeFlatVector<int32_t>({1, 2, 3}));
+    EXPECT_TRUE(vectorPool.release(vectors.back()));
+  }
+  // The pool is full.
+  EXPECT_FALSE(vectorPool.release(makeFlatVector<int32_t>({1, 2, 3})));
+}
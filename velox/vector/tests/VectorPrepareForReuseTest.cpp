@@ -111,7 +111,7 @@ TEST_F(VectorPrepareForReuseTest, strings) {
     ASSERT_TRUE(allocationChecker.assertAtLeastOne());
   }
 
-  // Verify that only one string buffer is kept for re-use.
+  // Verify that only the largest string buffer is kept for re-use.
   {
     std::vector<std::string> extraLargeStrings = {
         std::string(200, '.'),
@@ -133,11 +133,13 @@ TEST_F(VectorPrepareForReuseTest, strings) {
     ASSERT_EQ(originalExtraLargeVector, extraLargeVector.get());
     ASSERT_GT(originalExtraLargeBytes, extraLargeVector->retainedSize());
     ASSERT_EQ(1, getStringBuffers(extraLargeVector).size());
+    auto reusedBytes = extraLargeVector->retainedSize();
+    ASSERT_LT(originalBytes, reusedBytes);
 
     for (auto i = 0; i < extraLargeVector->size(); i++) {
       extraLargeVector->asFlatVector<StringView>()->set(i, stringAt(i));
     }
-    ASSERT_EQ(originalBytes, extraLargeVector->retainedSize());
+    ASSERT_EQ(reusedBytes, extraLargeVector->retainedSize());
   }
 }
 
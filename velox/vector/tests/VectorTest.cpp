@@ -1150,6 +1150,45 @@ TEST_F(VectorTest, setFlatVectorStringView) {
   EXPECT_EQ(newString.size(), flatCopy->stringBuffers()[1]->size());
 }
 
+TEST_F(VectorTest, compactStringBuffers) {
+  // 100 substrings of 20 bytes each of a 1MB input buffer.
+  const int32_t kInputSize = 1 << 20;
+  auto input = AlignedBuffer::allocate<char>(kInputSize, pool_.get());
+  auto* rawInput = input->asMutable<char>();
+  for (auto i = 0; i < kInputSize; ++i) {
+    rawInput[i] = 'a' + i % 26;
+  }
+  auto vector = std::dynamic_pointer_cast<FlatVector<StringView>>(
+      BaseVector::create(VARCHAR(), 100, pool_.get()));
+  vector->setStringBuffers({input});
+  std::vector<std::string> expected(100);
+  for (auto i = 0; i < 100; ++i) {
+    if (i % 10 == 0) {
+      vector->setNull(i, true);
+      continue;
+    }
+    // Every 7th string is short enough to be inlined.
+    const auto size = i % 7 == 0 ? 5 : 20;
+    vector->setNoCopy(i, StringView(rawInput + i * 1000, size));
+    expected[i] = std::string(rawInput + i * 1000, size);
+  }
+
+  ASSERT_TRUE(vector->compactStringBuffers());
+  input.reset();
+  ASSERT_EQ(1, vector->stringBuffers().size());
+  EXPECT_GT(2'000, vector->stringBuffers()[0]->capacity());
+  for (auto i = 0; i < 100; ++i) {
+    if (i % 10 == 0) {
+      EXPECT_TRUE(vector->isNullAt(i));
+    } else {
+      EXPECT_EQ(expected[i], vector->valueAt(i).str());
+    }
+  }
+
+  // The strings are now dense.
+  EXPECT_FALSE(vector->compactStringBuffers());
+}
+
 TEST_F(VectorTest, resizeAtConstruction) {
   using T = int64_t;
   const size_t realSize = 10;
@@ -1255,6 +1294,71 @@ TEST_F(VectorTest, copyAscii) {
   ASSERT_FALSE(ascii.value());
 }
 
+TEST_F(VectorTest, copyDictionary) {
+  const vector_size_t size = 1'000;
+  auto indices = makeIndices(size, [](auto row) { return (row * 7) % 1'000; });
+  auto dictionaryNulls = makeNulls(size, nullEvery(11));
+  std::vector<std::string> strings(20);
+  for (auto i = 0; i < strings.size(); ++i) {
+    strings[i] = std::string(i, 'x');
+  }
+  std::vector<VectorPtr> bases = {
+      makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row; }, nullEvery(7)),
+      makeFlatVector<double>(size, [](auto row) { return row * 0.5; }),
+      makeFlatVector<StringView>(
+          size,
+          [&](auto row) { return StringView(strings[row % strings.size()]); },
+          nullEvery(5)),
+      makeArrayVector<int64_t>(
+          size,
+          [](auto row) { return row % 4; },
+          [](auto row, auto index) { return row + index; },
+          nullEvery(13)),
+      makeMapVector<int32_t, double>(
+          size,
+          [](auto row) { return row % 3; },
+          [](auto index) { return index; },
+          [](auto index) { return index * 0.1; },
+          nullEvery(9))};
+
+  for (auto& base : bases) {
+    for (auto& source :
+         {wrapInDictionary(indices, size, base),
+          BaseVector::wrapInDictionary(dictionaryNulls, indices, size, base)}) {
+      SCOPED_TRACE(source->toString());
+      // Copies a range to a different position.
+      auto target = BaseVector::create(base->type(), size + 10, pool());
+      target->copy(source.get(), 10, 0, size);
+      for (auto i = 0; i < size; ++i) {
+        ASSERT_TRUE(target->equalValueAt(source.get(), i + 10, i));
+      }
+
+      // Copies every other row through a mapping.
+      target = BaseVector::create(base->type(), size, pool());
+      SelectivityVector rows(size);
+      for (auto i = 1; i < size; i += 2) {
+        rows.setValid(i, false);
+      }
+      rows.updateBounds();
+      std::vector<vector_size_t> toSourceRow(size);
+      for (auto i = 0; i < size; ++i) {
+        toSourceRow[i] = size - 1 - i;
+      }
+      target->copy(source.get(), rows, toSourceRow.data());
+      rows.applyToSelected([&](auto row) {
+        ASSERT_TRUE(target->equalValueAt(source.get(), row, toSourceRow[row]));
+      });
+
+      // Copies all rows.
+      target = BaseVector::create(base->type(), size, pool());
+      target->copy(source.get(), SelectivityVector(size), nullptr);
+      assertEqualVectors(source, target);
+    }
+  }
+}
+
 TEST_F(VectorTest, compareNan) {
   auto vectorMaker = std::make_unique<test::VectorMaker>(pool_.get());
 
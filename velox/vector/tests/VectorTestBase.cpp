@@ -36,6 +36,24 @@ VectorPtr VectorTestBase::wrapInDictionary(
       BufferPtr(nullptr), indices, size, vector);
 }
 
+VectorPtr VectorTestBase::makeDecimalFlatVector(
+    const std::vector<std::optional<int128_t>>& values,
+    const TypePtr& type) {
+  auto vector = BaseVector::create(type, values.size(), pool());
+  for (auto i = 0; i < values.size(); ++i) {
+    if (!values[i].has_value()) {
+      vector->setNull(i, true);
+    } else if (type->kind() == TypeKind::SHORT_DECIMAL) {
+      vector->asFlatVector<ShortDecimal>()->set(
+          i, ShortDecimal(static_cast<int64_t>(values[i].value())));
+    } else {
+      vector->asFlatVector<LongDecimal>()->set(
+          i, LongDecimal(values[i].value()));
+    }
+  }
+  return vector;
+}
+
 BufferPtr VectorTestBase::makeOddIndices(vector_size_t size) {
   return makeIndices(size, [](vector_size_t i) { return 2 * i + 1; });
 }
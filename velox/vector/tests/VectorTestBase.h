@@ -166,6 +166,12 @@ class VectorTestBase {
     return vectorMaker_.flatVector<T>(size, type);
   }
 
+  // Returns a flat vector of the SHORT_DECIMAL or LONG_DECIMAL 'type' with
+  // the unscaled 'values'.
+  VectorPtr makeDecimalFlatVector(
+      const std::vector<std::optional<int128_t>>& values,
+      const TypePtr& type);
+
   // Convenience function to create arrayVectors (vector of arrays) based on
   // input values from nested std::vectors. The underlying elements are
   // non-nullable.